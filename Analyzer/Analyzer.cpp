@@ -126,7 +126,7 @@ std::shared_ptr<Analyzer::Expr> KeyForStringExpr::deep_copy() const {
 }
 
 std::shared_ptr<Analyzer::Expr> SampleRatioExpr::deep_copy() const {
-  return makeExpr<SampleRatioExpr>(arg->deep_copy());
+  return makeExpr<SampleRatioExpr>(arg->deep_copy(), per_fragment);
 }
 
 std::shared_ptr<Analyzer::Expr> LowerExpr::deep_copy() const {
@@ -159,7 +159,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::deep_copy() const {
                            aggtype,
                            arg == nullptr ? nullptr : arg->deep_copy(),
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> CaseExpr::deep_copy() const {
@@ -199,7 +199,7 @@ std::shared_ptr<Analyzer::Expr> OffsetInFragment::deep_copy() const {
 
 std::shared_ptr<Analyzer::Expr> WindowFunction::deep_copy() const {
   return makeExpr<WindowFunction>(
-      type_info, kind_, args_, partition_keys_, order_keys_, collation_);
+      type_info, kind_, args_, partition_keys_, order_keys_, collation_, rows_frame_);
 }
 
 ExpressionPtr ArrayExpr::deep_copy() const {
@@ -1879,7 +1879,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_with_child_targetlist(
                            aggtype,
                            arg ? arg->rewrite_with_child_targetlist(tlist) : nullptr,
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_agg_to_var(
@@ -2160,7 +2160,7 @@ bool SampleRatioExpr::operator==(const Expr& rhs) const {
     return false;
   }
   const SampleRatioExpr& rhs_cl = dynamic_cast<const SampleRatioExpr&>(rhs);
-  if (!(*arg == *rhs_cl.get_arg())) {
+  if (!(*arg == *rhs_cl.get_arg()) || per_fragment != rhs_cl.isPerFragment()) {
     return false;
   }
   return true;
@@ -2265,6 +2265,11 @@ bool AggExpr::operator==(const Expr& rhs) const {
   if (aggtype != rhs_ae.get_aggtype() || is_distinct != rhs_ae.get_is_distinct()) {
     return false;
   }
+  if (arg1 || rhs_ae.get_arg1()) {
+    if (!arg1 || !rhs_ae.get_arg1() || !(*arg1 == *rhs_ae.get_arg1())) {
+      return false;
+    }
+  }
   if (arg.get() == rhs_ae.get_arg()) {
     return true;
   }
@@ -2345,6 +2350,10 @@ bool WindowFunction::operator==(const Expr& rhs) const {
       order_keys_.size() != rhs_window->order_keys_.size()) {
     return false;
   }
+  if (!rows_frame_ != !rhs_window->rows_frame_ ||
+      (rows_frame_ && !(*rows_frame_ == *rhs_window->rows_frame_))) {
+    return false;
+  }
   return expr_list_match(args_, rhs_window->args_) &&
          expr_list_match(partition_keys_, rhs_window->partition_keys_) &&
          expr_list_match(order_keys_, rhs_window->order_keys_);
@@ -2587,7 +2596,7 @@ std::string KeyForStringExpr::toString() const {
 }
 
 std::string SampleRatioExpr::toString() const {
-  std::string str{"SAMPLE_RATIO("};
+  std::string str{per_fragment ? "SAMPLE_FRAGMENTS(" : "SAMPLE_RATIO("};
   str += arg->toString();
   str += ") ";
   return str;
@@ -2659,6 +2668,9 @@ std::string AggExpr::toString() const {
     case kSAMPLE:
       agg = "SAMPLE";
       break;
+    case kAPPROX_QUANTILE:
+      agg = "APPROX_QUANTILE";
+      break;
   }
   std::string str{"(" + agg};
   if (is_distinct) {
@@ -2716,6 +2728,15 @@ std::string WindowFunction::toString() const {
   for (const auto& arg : args_) {
     result += " " + arg->toString();
   }
+  if (rows_frame_) {
+    const auto bound_to_string = [](const bool unbounded, const int64_t offset) {
+      return unbounded ? std::string("UNBOUNDED") : std::to_string(offset);
+    };
+    result += " ROWS " +
+              bound_to_string(rows_frame_->lower_unbounded, rows_frame_->lower_offset) +
+              " " +
+              bound_to_string(rows_frame_->upper_unbounded, rows_frame_->upper_offset);
+  }
   return result + ") ";
 }
 
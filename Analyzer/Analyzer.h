@@ -741,14 +741,18 @@ class KeyForStringExpr : public Expr {
 /*
  * @type SampleRatioExpr
  * @brief expression for the SAMPLE_RATIO expression. Argument range is expected to be
- * between 0 and 1.
+ * between 0 and 1. Keeps the rows by a hash of their position, or all the rows of the
+ * outer fragments kept by a hash of their first row id for SAMPLE_FRAGMENTS.
  */
 class SampleRatioExpr : public Expr {
  public:
-  SampleRatioExpr(std::shared_ptr<Analyzer::Expr> a)
-      : Expr(kBOOLEAN, a->get_type_info().get_notnull()), arg(a) {}
+  SampleRatioExpr(std::shared_ptr<Analyzer::Expr> a, const bool per_fragment = false)
+      : Expr(kBOOLEAN, a->get_type_info().get_notnull())
+      , arg(a)
+      , per_fragment(per_fragment) {}
   const Expr* get_arg() const { return arg.get(); }
   const std::shared_ptr<Analyzer::Expr> get_own_arg() const { return arg; }
+  bool isPerFragment() const { return per_fragment; }
   std::shared_ptr<Analyzer::Expr> deep_copy() const override;
   void group_predicates(std::list<const Expr*>& scan_predicates,
                         std::list<const Expr*>& join_predicates,
@@ -764,15 +768,16 @@ class SampleRatioExpr : public Expr {
   }
   std::shared_ptr<Analyzer::Expr> rewrite_with_targetlist(
       const std::vector<std::shared_ptr<TargetEntry>>& tlist) const override {
-    return makeExpr<SampleRatioExpr>(arg->rewrite_with_targetlist(tlist));
+    return makeExpr<SampleRatioExpr>(arg->rewrite_with_targetlist(tlist), per_fragment);
   }
   std::shared_ptr<Analyzer::Expr> rewrite_with_child_targetlist(
       const std::vector<std::shared_ptr<TargetEntry>>& tlist) const override {
-    return makeExpr<SampleRatioExpr>(arg->rewrite_with_child_targetlist(tlist));
+    return makeExpr<SampleRatioExpr>(arg->rewrite_with_child_targetlist(tlist),
+                                     per_fragment);
   }
   std::shared_ptr<Analyzer::Expr> rewrite_agg_to_var(
       const std::vector<std::shared_ptr<TargetEntry>>& tlist) const override {
-    return makeExpr<SampleRatioExpr>(arg->rewrite_agg_to_var(tlist));
+    return makeExpr<SampleRatioExpr>(arg->rewrite_agg_to_var(tlist), per_fragment);
   }
   bool operator==(const Expr& rhs) const override;
   std::string toString() const override;
@@ -781,6 +786,7 @@ class SampleRatioExpr : public Expr {
 
  private:
   std::shared_ptr<Analyzer::Expr> arg;
+  bool per_fragment;
 };
 
 /**
@@ -1080,7 +1086,7 @@ class AggExpr : public Expr {
           std::shared_ptr<Analyzer::Expr> g,
           bool d,
           std::shared_ptr<Analyzer::Constant> e)
-      : Expr(ti, true), aggtype(a), arg(g), is_distinct(d), error_rate(e) {}
+      : Expr(ti, true), aggtype(a), arg(g), is_distinct(d), arg1(e) {}
   AggExpr(SQLTypes t,
           SQLAgg a,
           Expr* g,
@@ -1091,12 +1097,12 @@ class AggExpr : public Expr {
       , aggtype(a)
       , arg(g)
       , is_distinct(d)
-      , error_rate(e) {}
+      , arg1(e) {}
   SQLAgg get_aggtype() const { return aggtype; }
   Expr* get_arg() const { return arg.get(); }
   std::shared_ptr<Analyzer::Expr> get_own_arg() const { return arg; }
   bool get_is_distinct() const { return is_distinct; }
-  std::shared_ptr<Analyzer::Constant> get_error_rate() const { return error_rate; }
+  std::shared_ptr<Analyzer::Constant> get_arg1() const { return arg1; }
   std::shared_ptr<Analyzer::Expr> deep_copy() const override;
   void group_predicates(std::list<const Expr*>& scan_predicates,
                         std::list<const Expr*>& join_predicates,
@@ -1129,7 +1135,8 @@ class AggExpr : public Expr {
   SQLAgg aggtype;                       // aggregate type: kAVG, kMIN, kMAX, kSUM, kCOUNT
   std::shared_ptr<Analyzer::Expr> arg;  // argument to aggregate
   bool is_distinct;                     // true only if it is for COUNT(DISTINCT x)
-  std::shared_ptr<Analyzer::Constant> error_rate;  // error rate of kAPPROX_COUNT_DISTINCT
+  // 2nd arg of kAPPROX_COUNT_DISTINCT (error rate) or kAPPROX_QUANTILE (quantile)
+  std::shared_ptr<Analyzer::Constant> arg1;
 };
 
 /*
@@ -1420,6 +1427,24 @@ struct OrderEntry {
   bool nulls_first; /* true if nulls are ordered first.  otherwise last. */
 };
 
+/*
+ * @type RowsFrame
+ * @brief The ROWS BETWEEN frame of an aggregate window function. The bounds are row
+ * offsets from the current row, negative for preceding rows.
+ */
+struct RowsFrame {
+  bool lower_unbounded;
+  int64_t lower_offset;
+  bool upper_unbounded;
+  int64_t upper_offset;
+
+  bool operator==(const RowsFrame& rhs) const {
+    return lower_unbounded == rhs.lower_unbounded &&
+           lower_offset == rhs.lower_offset &&
+           upper_unbounded == rhs.upper_unbounded && upper_offset == rhs.upper_offset;
+  }
+};
+
 /*
  * @type WindowFunction
  * @brief A window function.
@@ -1431,13 +1456,15 @@ class WindowFunction : public Expr {
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& args,
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& partition_keys,
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& order_keys,
-                 const std::vector<OrderEntry>& collation)
+                 const std::vector<OrderEntry>& collation,
+                 const std::shared_ptr<const RowsFrame>& rows_frame = nullptr)
       : Expr(ti)
       , kind_(kind)
       , args_(args)
       , partition_keys_(partition_keys)
       , order_keys_(order_keys)
-      , collation_(collation){};
+      , collation_(collation)
+      , rows_frame_(rows_frame){};
 
   std::shared_ptr<Analyzer::Expr> deep_copy() const override;
 
@@ -1458,12 +1485,16 @@ class WindowFunction : public Expr {
 
   const std::vector<OrderEntry>& getCollation() const { return collation_; }
 
+  // The ROWS frame of an aggregate, nullptr for the default RANGE frame.
+  const std::shared_ptr<const RowsFrame>& getRowsFrame() const { return rows_frame_; }
+
  private:
   const SqlWindowFunctionKind kind_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> args_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> partition_keys_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> order_keys_;
   const std::vector<OrderEntry> collation_;
+  const std::shared_ptr<const RowsFrame> rows_frame_;
 };
 
 /*
@@ -18,20 +18,77 @@
 
 #include <aws/core/Aws.h>
 #include <aws/core/auth/AWSCredentialsProvider.h>
+#include <aws/s3/model/DeleteObjectRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/ListObjectsV2Request.h>
 #include <aws/s3/model/Object.h>
+#include <aws/s3/model/PutObjectRequest.h>
 #include <atomic>
 #include <boost/filesystem.hpp>
 #include <fstream>
 #include <memory>
 
+#include "DataMgr/PersistentStorageMgr/ColdStorage.h"
 #include "Logger/Logger.h"
 
 int S3Archive::awsapi_count;
 std::mutex S3Archive::awsapi_mtx;
 Aws::SDKOptions S3Archive::awsapi_options;
 
+void S3Archive::init_aws_api() {
+  std::unique_lock<std::mutex> lck(awsapi_mtx);
+  if (0 == awsapi_count++) {
+    Aws::InitAPI(awsapi_options);
+  }
+}
+
+void S3Archive::shutdown_aws_api() {
+  std::unique_lock<std::mutex> lck(awsapi_mtx);
+  if (0 == --awsapi_count) {
+    Aws::ShutdownAPI(awsapi_options);
+  }
+}
+
+Aws::Client::ClientConfiguration S3Archive::get_client_config(
+    const std::string& s3_region,
+    const std::string& s3_endpoint) {
+  Aws::Client::ClientConfiguration config;
+  config.region = s3_region.size() ? s3_region : Aws::Region::US_EAST_1;
+  config.endpointOverride = s3_endpoint;
+
+  /*
+     Fix a wrong ca path established at building libcurl on Centos being carried to
+     Ubuntu. To fix the issue, this is this sequence of locating ca file: 1) if
+     `SSL_CERT_DIR` or `SSL_CERT_FILE` is set, set it to S3 ClientConfiguration. 2) if
+     none ^ is set, omnisci_server searches a list of known ca file paths. 3) if 2)
+     finds nothing, it is users' call to set correct SSL_CERT_DIR or SSL_CERT_FILE. S3
+     c++ sdk: "we only want to override the default path if someone has explicitly told
+     us to."
+   */
+  std::list<std::string> v_known_ca_paths({
+      "/etc/ssl/certs/ca-certificates.crt",
+      "/etc/pki/tls/certs/ca-bundle.crt",
+      "/usr/share/ssl/certs/ca-bundle.crt",
+      "/usr/local/share/certs/ca-root.crt",
+      "/etc/ssl/cert.pem",
+      "/etc/ssl/ca-bundle.pem",
+  });
+  char* env;
+  if (nullptr != (env = getenv("SSL_CERT_DIR"))) {
+    config.caPath = env;
+  }
+  if (nullptr != (env = getenv("SSL_CERT_FILE"))) {
+    v_known_ca_paths.push_front(env);
+  }
+  for (const auto& known_ca_path : v_known_ca_paths) {
+    if (boost::filesystem::exists(known_ca_path)) {
+      config.caFile = known_ca_path;
+      break;
+    }
+  }
+  return config;
+}
+
 void S3Archive::init_for_read() {
   boost::filesystem::create_directories(s3_temp_dir);
   if (!boost::filesystem::is_directory(s3_temp_dir)) {
@@ -59,40 +116,7 @@ void S3Archive::init_for_read() {
     // credentials are configured *globally* while different users with private
     // s3 resources may need separate credentials to access.in that case, use
     // WITH s3_access_key/s3_secret_key parameters.
-    Aws::Client::ClientConfiguration s3_config;
-    s3_config.region = s3_region.size() ? s3_region : Aws::Region::US_EAST_1;
-    s3_config.endpointOverride = s3_endpoint;
-
-    /*
-       Fix a wrong ca path established at building libcurl on Centos being carried to
-       Ubuntu. To fix the issue, this is this sequence of locating ca file: 1) if
-       `SSL_CERT_DIR` or `SSL_CERT_FILE` is set, set it to S3 ClientConfiguration. 2) if
-       none ^ is set, omnisci_server searches a list of known ca file paths. 3) if 2)
-       finds nothing, it is users' call to set correct SSL_CERT_DIR or SSL_CERT_FILE. S3
-       c++ sdk: "we only want to override the default path if someone has explicitly told
-       us to."
-     */
-    std::list<std::string> v_known_ca_paths({
-        "/etc/ssl/certs/ca-certificates.crt",
-        "/etc/pki/tls/certs/ca-bundle.crt",
-        "/usr/share/ssl/certs/ca-bundle.crt",
-        "/usr/local/share/certs/ca-root.crt",
-        "/etc/ssl/cert.pem",
-        "/etc/ssl/ca-bundle.pem",
-    });
-    char* env;
-    if (nullptr != (env = getenv("SSL_CERT_DIR"))) {
-      s3_config.caPath = env;
-    }
-    if (nullptr != (env = getenv("SSL_CERT_FILE"))) {
-      v_known_ca_paths.push_front(env);
-    }
-    for (const auto& known_ca_path : v_known_ca_paths) {
-      if (boost::filesystem::exists(known_ca_path)) {
-        s3_config.caFile = known_ca_path;
-        break;
-      }
-    }
+    auto s3_config = get_client_config(s3_region, s3_endpoint);
 
     if (!s3_access_key.empty() && !s3_secret_key.empty()) {
       s3_client.reset(new Aws::S3::S3Client(
@@ -301,3 +325,96 @@ void S3Archive::vacuum(const std::string& objkey) {
   boost::filesystem::remove(it->second);
   file_paths.erase(it);
 }
+
+namespace {
+
+// Keeps the cold chunks of the PersistentStorageMgr as the objects under an s3 url,
+// with the credentials and the region of the server environment.
+class S3ColdObjectStore : public Data_Namespace::ColdObjectStore {
+ public:
+  S3ColdObjectStore(const std::string& url) {
+    std::map<int, std::string> url_parts;
+    Archive::parse_url(url, url_parts);
+    bucket_name_ = url_parts[4];
+    prefix_name_ = url_parts[5];
+    if (prefix_name_.size() && '/' == prefix_name_.front()) {
+      prefix_name_ = prefix_name_.substr(1);
+    }
+    if (prefix_name_.size() && '/' != prefix_name_.back()) {
+      prefix_name_ += '/';
+    }
+    if (bucket_name_.empty()) {
+      throw std::runtime_error("Cold storage url '" + url + "' has no bucket.");
+    }
+    S3Archive::init_aws_api();
+    const auto env_region = getenv("AWS_REGION");
+    const auto env_endpoint = getenv("AWS_ENDPOINT");
+    s3_client_ = std::make_unique<Aws::S3::S3Client>(S3Archive::get_client_config(
+        env_region ? env_region : "", env_endpoint ? env_endpoint : ""));
+  }
+
+  ~S3ColdObjectStore() override {
+    s3_client_.reset();
+    S3Archive::shutdown_aws_api();
+  }
+
+  void putObject(const std::string& name,
+                 const int8_t* data,
+                 const size_t num_bytes) override {
+    Aws::S3::Model::PutObjectRequest object_request;
+    object_request.WithBucket(bucket_name_).WithKey(prefix_name_ + name);
+    const auto body = Aws::MakeShared<Aws::StringStream>("S3ColdObjectStore");
+    body->write(reinterpret_cast<const char*>(data), num_bytes);
+    object_request.SetBody(body);
+    object_request.SetContentLength(num_bytes);
+    const auto put_object_outcome = s3_client_->PutObject(object_request);
+    if (!put_object_outcome.IsSuccess()) {
+      throw std::runtime_error("failed to put object '" + prefix_name_ + name +
+                               "' of s3 bucket '" + bucket_name_ + "': " +
+                               put_object_outcome.GetError().GetMessage());
+    }
+  }
+
+  void getObject(const std::string& name,
+                 int8_t* data,
+                 const size_t num_bytes) override {
+    CHECK_GT(num_bytes, size_t(0));
+    Aws::S3::Model::GetObjectRequest object_request;
+    object_request.WithBucket(bucket_name_).WithKey(prefix_name_ + name);
+    object_request.SetRange("bytes=0-" + std::to_string(num_bytes - 1));
+    auto get_object_outcome = s3_client_->GetObject(object_request);
+    if (!get_object_outcome.IsSuccess()) {
+      throw std::runtime_error("failed to get object '" + prefix_name_ + name +
+                               "' of s3 bucket '" + bucket_name_ + "': " +
+                               get_object_outcome.GetError().GetMessage());
+    }
+    auto& body = get_object_outcome.GetResult().GetBody();
+    body.read(reinterpret_cast<char*>(data), num_bytes);
+    if (static_cast<size_t>(body.gcount()) != num_bytes) {
+      throw std::runtime_error("short read of object '" + prefix_name_ + name +
+                               "' of s3 bucket '" + bucket_name_ + "'");
+    }
+  }
+
+  void deleteObject(const std::string& name) override {
+    Aws::S3::Model::DeleteObjectRequest object_request;
+    object_request.WithBucket(bucket_name_).WithKey(prefix_name_ + name);
+    const auto delete_object_outcome = s3_client_->DeleteObject(object_request);
+    if (!delete_object_outcome.IsSuccess()) {
+      LOG(WARNING) << "failed to delete object '" << prefix_name_ << name
+                   << "' of s3 bucket '" << bucket_name_
+                   << "': " << delete_object_outcome.GetError().GetMessage();
+    }
+  }
+
+ private:
+  std::string bucket_name_;
+  std::string prefix_name_;
+  std::unique_ptr<Aws::S3::S3Client> s3_client_;
+};
+
+const bool s3_cold_object_store_registered = Data_Namespace::register_cold_object_store(
+    "s3",
+    [](const std::string& url) { return std::make_unique<S3ColdObjectStore>(url); });
+
+}  // namespace
@@ -42,12 +42,7 @@ class S3Archive : public Archive {
 // it's bad to call Aws::InitAPI and Aws::ShutdownAPI
 // multiple times.
 #ifdef HAVE_AWS_S3
-    {
-      std::unique_lock<std::mutex> lck(awsapi_mtx);
-      if (0 == awsapi_count++) {
-        Aws::InitAPI(awsapi_options);
-      }
-    }
+    init_aws_api();
 #endif  // HAVE_AWS_S3
 
     // these envs are on server side so are global settings
@@ -92,10 +87,7 @@ class S3Archive : public Archive {
         thread.join();
       }
     }
-    std::unique_lock<std::mutex> lck(awsapi_mtx);
-    if (0 == --awsapi_count) {
-      Aws::ShutdownAPI(awsapi_options);
-    }
+    shutdown_aws_api();
 #endif  // HAVE_AWS_S3
   }
 
@@ -118,6 +110,15 @@ class S3Archive : public Archive {
 #endif  // HAVE_AWS_S3
   size_t get_total_file_size() const { return total_file_size; }
 
+#ifdef HAVE_AWS_S3
+  // reference counted, for the other users of the aws api such as the cold storage
+  static void init_aws_api();
+  static void shutdown_aws_api();
+  static Aws::Client::ClientConfiguration get_client_config(
+      const std::string& s3_region,
+      const std::string& s3_endpoint);
+#endif  // HAVE_AWS_S3
+
  private:
 #ifdef HAVE_AWS_S3
   static int awsapi_count;
@@ -22,6 +22,7 @@
  */
 
 #include "Calcite.h"
+#include "Calcite/CalcitePlanCache.h"
 #include "Catalog/Catalog.h"
 #include "Logger/Logger.h"
 #include "OSDependent/omnisci_path.h"
@@ -30,6 +31,7 @@
 #include "Shared/fixautotools.h"
 #include "Shared/mapd_shared_ptr.h"
 #include "Shared/measure.h"
+#include "Shared/scope.h"
 #include "ThriftHandler/QueryState.h"
 
 #include <thrift/protocol/TBinaryProtocol.h>
@@ -45,6 +47,7 @@
 
 #include "rapidjson/document.h"
 
+#include <algorithm>
 #include <utility>
 
 using namespace rapidjson;
@@ -280,7 +283,7 @@ void Calcite::runServer(const int db_port,
   LOG(INFO) << "Running Calcite server as a daemon";
 
   // ping server to see if for any reason there is an orphaned one
-  int ping_time = ping();
+  int ping_time = ping(port);
   if (ping_time > -1) {
     // we have an orphaned server shut it down
     LOG(ERROR)
@@ -288,7 +291,7 @@ void Calcite::runServer(const int db_port,
     LOG(ERROR) << "Please check that you are not trying to run two servers on same port";
     LOG(ERROR) << "Attempting to shutdown orphaned Calcite server";
     try {
-      auto clientP = getClient(remote_calcite_port_);
+      auto clientP = getClient(port);
       clientP.first->shutdown();
       clientP.second->close();
       LOG(ERROR) << "orphaned Calcite server shutdown";
@@ -315,7 +318,7 @@ void Calcite::runServer(const int db_port,
   std::this_thread::sleep_for(std::chrono::milliseconds(200));
   int retry_max = 300;
   for (int i = 2; i <= retry_max; i++) {
-    int ping_time = ping(i, retry_max);
+    int ping_time = ping(port, i, retry_max);
     if (ping_time > -1) {
       LOG(INFO) << "Calcite server start took " << i * 100 << " ms ";
       LOG(INFO) << "ping took " << ping_time << " ms ";
@@ -334,10 +337,10 @@ void Calcite::runServer(const int db_port,
 // ping existing server
 // return -1 if no ping response
 // params set to default values in header
-int Calcite::ping(int retry_num, int max_retry) {
+int Calcite::ping(int port, int retry_num, int max_retry) {
   try {
     auto ms = measure<>::execution([&]() {
-      auto clientP = getClient(remote_calcite_port_);
+      auto clientP = getClient(port);
       clientP.first->ping();
       clientP.second->close();
     });
@@ -368,9 +371,12 @@ void Calcite::init(const int db_port,
                    const int calcite_port,
                    const std::string& data_dir,
                    const size_t calcite_max_mem,
-                   const std::string& udf_filename) {
+                   const std::string& udf_filename,
+                   const size_t num_servers) {
   LOG(INFO) << "Creating Calcite Handler,  Calcite Port is " << calcite_port
             << " base data dir is " << data_dir;
+  num_servers_ = std::max(num_servers, size_t(1));
+  server_requests_ = std::vector<std::atomic<size_t>>(num_servers_);
   connMgr_ = std::make_shared<ThriftClientConnection>();
   if (calcite_port < 0) {
     CHECK(false) << "JNI mode no longer supported.";
@@ -381,7 +387,10 @@ void Calcite::init(const int db_port,
     server_available_ = false;
   } else {
     remote_calcite_port_ = calcite_port;
-    runServer(db_port, calcite_port, data_dir, calcite_max_mem, udf_filename);
+    for (size_t server = 0; server < num_servers_; ++server) {
+      runServer(
+          db_port, getServerPort(server), data_dir, calcite_max_mem, udf_filename);
+    }
     server_available_ = true;
   }
 }
@@ -402,16 +411,38 @@ Calcite::Calcite(const SystemParameters& system_parameters,
        system_parameters.calcite_port,
        data_dir,
        system_parameters.calcite_max_mem,
-       udf_filename);
+       udf_filename,
+       system_parameters.calcite_servers);
+  CalcitePlanCache::instance().setMaxSize(system_parameters.calcite_plan_cache_size);
+}
+
+size_t Calcite::acquireServer() {
+  size_t server = 0;
+  for (size_t i = 1; i < num_servers_; ++i) {
+    if (server_requests_[i].load(std::memory_order_relaxed) <
+        server_requests_[server].load(std::memory_order_relaxed)) {
+      server = i;
+    }
+  }
+  server_requests_[server].fetch_add(1, std::memory_order_relaxed);
+  return server;
+}
+
+void Calcite::releaseServer(const size_t server) {
+  server_requests_[server].fetch_sub(1, std::memory_order_relaxed);
 }
 
 void Calcite::updateMetadata(std::string catalog, std::string table) {
   if (server_available_) {
+    // every server caches the metadata
     auto ms = measure<>::execution([&]() {
-      auto clientP = getClient(remote_calcite_port_);
-      clientP.first->updateMetadata(catalog, table);
-      clientP.second->close();
+      for (size_t server = 0; server < num_servers_; ++server) {
+        auto clientP = getClient(getServerPort(server));
+        clientP.first->updateMetadata(catalog, table);
+        clientP.second->close();
+      }
     });
+    DdlTriggeredCacheInvalidator::invalidateCaches();
     LOG(INFO) << "Time to updateMetadata " << ms << " (ms)";
   } else {
     LOG(INFO) << "Not routing to Calcite, server is not up";
@@ -463,13 +494,33 @@ TPlanResult Calcite::process(
     const bool is_view_optimize,
     const bool check_privileges,
     const std::string& calcite_session_id) {
-  TPlanResult result = processImpl(query_state_proxy,
-                                   std::move(sql_string),
-                                   filter_push_down_info,
-                                   legacy_syntax,
-                                   is_explain,
-                                   is_view_optimize,
-                                   calcite_session_id);
+  auto& plan_cache = CalcitePlanCache::instance();
+  std::optional<plan_template::NormalizedSql> normalized_sql;
+  std::string plan_cache_context;
+  if (plan_cache.isEnabled() && filter_push_down_info.empty() && !is_explain) {
+    normalized_sql = plan_template::normalize_sql(sql_string);
+    const auto& session_info = query_state_proxy.getQueryState().getConstSessionInfo();
+    // the user matters for views and tables resolved through the default schema
+    plan_cache_context = session_info->getCatalog().getCurrentDB().dbName + '\n' +
+                         session_info->get_currentUser().userName + '\n' +
+                         std::to_string(legacy_syntax) +
+                         std::to_string(is_view_optimize);
+  }
+  TPlanResult result;
+  if (normalized_sql && plan_cache.get(plan_cache_context, *normalized_sql, result)) {
+    VLOG(1) << "Calcite plan cache hit";
+  } else {
+    result = processImpl(query_state_proxy,
+                         std::move(sql_string),
+                         filter_push_down_info,
+                         legacy_syntax,
+                         is_explain,
+                         is_view_optimize,
+                         calcite_session_id);
+    if (normalized_sql) {
+      plan_cache.put(plan_cache_context, *normalized_sql, result);
+    }
+  }
   if (check_privileges && !is_explain) {
     checkAccessedObjectsPrivileges(query_state_proxy, result);
   }
@@ -558,8 +609,10 @@ TPlanResult Calcite::processImpl(
       // calcite_session_id would be an empty string when accessed by internal resources
       // that would not access `process` through handler instance, like for eg: Unit
       // Tests. In these cases we would use the session_id from query state.
+      const auto server = acquireServer();
+      ScopeGuard release_server = [this, server] { releaseServer(server); };
       auto ms = measure<>::execution([&]() {
-        auto clientP = getClient(remote_calcite_port_);
+        auto clientP = getClient(getServerPort(server));
         clientP.first->process(ret,
                                user,
                                calcite_session_id.empty()
@@ -637,16 +690,18 @@ void Calcite::close_calcite_server(bool log) {
 void Calcite::inner_close_calcite_server(bool log) {
   if (server_available_) {
     LOG_IF(INFO, log) << "Shutting down Calcite server";
-    try {
-      auto clientP = getClient(remote_calcite_port_);
-      clientP.first->shutdown();
-      clientP.second->close();
-    } catch (const std::exception& e) {
-      if (std::string(e.what()) != "connect() failed: Connection refused" &&
-          std::string(e.what()) != "socket open() error: Connection refused" &&
-          std::string(e.what()) != "No more data to read.") {
-        std::cerr << "Error shutting down Calcite server: " << e.what() << std::endl;
-      }  // else Calcite already shut down
+    for (size_t server = 0; server < num_servers_; ++server) {
+      try {
+        auto clientP = getClient(getServerPort(server));
+        clientP.first->shutdown();
+        clientP.second->close();
+      } catch (const std::exception& e) {
+        if (std::string(e.what()) != "connect() failed: Connection refused" &&
+            std::string(e.what()) != "socket open() error: Connection refused" &&
+            std::string(e.what()) != "No more data to read.") {
+          std::cerr << "Error shutting down Calcite server: " << e.what() << std::endl;
+        }  // else Calcite already shut down
+      }
     }
     LOG_IF(INFO, log) << "shut down Calcite";
     server_available_ = false;
@@ -678,9 +733,12 @@ void Calcite::setRuntimeExtensionFunctions(
     const std::vector<TUserDefinedFunction>& udfs,
     const std::vector<TUserDefinedTableFunction>& udtfs) {
   if (server_available_) {
-    auto clientP = getClient(remote_calcite_port_);
-    clientP.first->setRuntimeExtensionFunctions(udfs, udtfs);
-    clientP.second->close();
+    for (size_t server = 0; server < num_servers_; ++server) {
+      auto clientP = getClient(getServerPort(server));
+      clientP.first->setRuntimeExtensionFunctions(udfs, udtfs);
+      clientP.second->close();
+    }
+    DdlTriggeredCacheInvalidator::invalidateCaches();
   } else {
     LOG(FATAL) << "Not routing to Calcite, server is not up";
   }
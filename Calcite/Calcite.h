@@ -28,6 +28,7 @@
 
 #include <thrift/transport/TTransport.h>
 
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -102,7 +103,8 @@ class Calcite final {
             const int port,
             const std::string& data_dir,
             const size_t calcite_max_mem,
-            const std::string& udf_filename);
+            const std::string& udf_filename,
+            const size_t num_servers = 1);
   void runServer(const int db_port,
                  const int port,
                  const std::string& data_dir,
@@ -120,13 +122,24 @@ class Calcite final {
   std::pair<mapd::shared_ptr<CalciteServerClient>, mapd::shared_ptr<TTransport>>
   getClient(int port);
 
-  int ping(int retry_num = 0, int max_retry = 50);
+  int ping(int port, int retry_num = 0, int max_retry = 50);
+
+  // The index of the server with the fewest planning requests in flight, which counts
+  // one more until released.
+  size_t acquireServer();
+  void releaseServer(const size_t server);
+  int getServerPort(const size_t server) const {
+    return remote_calcite_port_ + static_cast<int>(server);
+  }
 
   mapd::shared_ptr<ThriftClientConnection> connMgr_;
   bool server_available_;
   size_t service_timeout_;
   bool service_keepalive_ = true;
+  // the servers listen on consecutive ports from remote_calcite_port_
   int remote_calcite_port_ = -1;
+  size_t num_servers_ = 1;
+  std::vector<std::atomic<size_t>> server_requests_;
   std::string ssl_trust_store_;
   std::string ssl_trust_password_;
   std::string ssl_key_file_;
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Calcite/CalcitePlanCache.h"
+
+#include "Logger/Logger.h"
+
+#include "gen-cpp/CalciteServer.h"
+
+namespace {
+
+// Keeps exact and template entries of the same query apart.
+std::string make_key(const std::string& context,
+                     const std::string& query_key,
+                     const bool is_template) {
+  return context + (is_template ? "\nT\n" : "\nE\n") + query_key;
+}
+
+}  // namespace
+
+CalcitePlanCache& CalcitePlanCache::instance() {
+  static CalcitePlanCache cache;
+  return cache;
+}
+
+void CalcitePlanCache::setMaxSize(const size_t max_size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (max_size) {
+    cache_ = std::make_unique<LruCache<std::string, Entry>>(max_size);
+  } else {
+    cache_.reset();
+  }
+}
+
+bool CalcitePlanCache::isEnabled() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cache_ != nullptr;
+}
+
+bool CalcitePlanCache::get(const std::string& context,
+                           const plan_template::NormalizedSql& sql,
+                           TPlanResult& plan) {
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!cache_) {
+      return false;
+    }
+    auto cached = cache_->get(make_key(context, sql.exact_key, false));
+    if (!cached && !sql.literals.empty()) {
+      cached = cache_->get(make_key(context, sql.template_key, true));
+    }
+    if (!cached) {
+      return false;
+    }
+    entry = *cached;
+  }
+  plan = *entry.plan;
+  if (!entry.literal_nodes.empty()) {
+    plan.plan_result =
+        plan_template::instantiate_plan(plan.plan_result, entry.literal_nodes, sql);
+  }
+  plan.execution_time_ms = 0;
+  return true;
+}
+
+void CalcitePlanCache::put(const std::string& context,
+                           const plan_template::NormalizedSql& sql,
+                           const TPlanResult& plan) {
+  Entry entry{std::make_shared<const TPlanResult>(plan), {}};
+  bool is_template{false};
+  if (!sql.literals.empty()) {
+    auto literal_nodes = plan_template::find_literal_nodes(plan.plan_result, sql);
+    if (literal_nodes) {
+      entry.literal_nodes = std::move(*literal_nodes);
+      is_template = true;
+    } else {
+      VLOG(1) << "Caching plan without parameterizing its literals";
+    }
+  }
+  const auto key =
+      make_key(context, is_template ? sql.template_key : sql.exact_key, is_template);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (cache_) {
+    cache_->put(key, std::move(entry));
+  }
+}
+
+void CalcitePlanCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (cache_) {
+    VLOG(1) << "Invalidating Calcite plan cache";
+    cache_->clear();
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CalcitePlanCache.h
+ * @brief   Cache of relational algebra plans returned by Calcite, keyed by the
+ *          normalized query text.
+ *
+ * Entries are looked up by their exact normalized text first and by their literal
+ * template second, see PlanTemplate.h. Any DDL clears the cache.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Calcite/PlanTemplate.h"
+#include "QueryEngine/CacheInvalidator.h"
+#include "StringDictionary/LruCache.hpp"
+
+class TPlanResult;
+
+class CalcitePlanCache {
+ public:
+  static CalcitePlanCache& instance();
+
+  // A size of 0 disables the cache.
+  void setMaxSize(const size_t max_size);
+
+  bool isEnabled() const;
+
+  /**
+   * Looks up the plan of `sql` in `context`, which must capture everything besides the
+   * query text the plan depends on (database, user, parser options).
+   */
+  bool get(const std::string& context,
+           const plan_template::NormalizedSql& sql,
+           TPlanResult& plan);
+
+  void put(const std::string& context,
+           const plan_template::NormalizedSql& sql,
+           const TPlanResult& plan);
+
+  void clear();
+
+  static auto yieldCacheInvalidator() -> std::function<void()> {
+    return []() -> void { CalcitePlanCache::instance().clear(); };
+  }
+
+ private:
+  CalcitePlanCache() = default;
+
+  struct Entry {
+    std::shared_ptr<const TPlanResult> plan;
+    // empty for exact entries
+    std::vector<std::string> literal_nodes;
+  };
+
+  mutable std::mutex mutex_;
+  std::unique_ptr<LruCache<std::string, Entry>> cache_;
+};
+
+using DdlTriggeredCacheInvalidator = CacheInvalidator<CalcitePlanCache>;
@@ -0,0 +1,382 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Calcite/PlanTemplate.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/pointer.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+
+#include "Logger/Logger.h"
+
+namespace plan_template {
+
+namespace {
+
+// Cannot appear in a query outside of literals, so placeholders never alias query text.
+constexpr char kPlaceholder{'\x01'};
+
+// Literals following these keywords are kept verbatim, Calcite folds or validates them.
+const std::unordered_set<std::string> kVerbatimNumberContexts{
+    "LIMIT", "OFFSET", "FETCH", "FIRST", "NEXT", "TOP"};
+const std::unordered_set<std::string> kVerbatimStringContexts{
+    "DATE", "TIME", "TIMESTAMP", "INTERVAL"};
+
+// Beyond 9 digits an integer literal can be typed as BIGINT instead of INTEGER.
+constexpr int64_t kMaxNumberPrecision{9};
+
+bool is_identifier_char(const char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+std::optional<SqlLiteral> parse_number(const std::string& text) {
+  if (text.find_first_of("eE") != std::string::npos || text.back() == '.') {
+    return std::nullopt;
+  }
+  const auto dot_pos = text.find('.');
+  const int64_t scale =
+      dot_pos == std::string::npos ? 0 : static_cast<int64_t>(text.size() - dot_pos - 1);
+  auto digits = text;
+  if (dot_pos != std::string::npos) {
+    digits.erase(dot_pos, 1);
+  }
+  const auto first_significant = digits.find_first_not_of('0');
+  digits =
+      first_significant == std::string::npos ? "0" : digits.substr(first_significant);
+  const auto precision = static_cast<int64_t>(digits.size());
+  if (precision > kMaxNumberPrecision) {
+    return std::nullopt;
+  }
+  return SqlLiteral{SqlLiteral::Type::Number, "", std::stoll(digits), precision, scale};
+}
+
+std::optional<SqlLiteral> parse_string(const std::string& value) {
+  if (value.empty()) {
+    return std::nullopt;
+  }
+  for (const auto c : value) {
+    // the plan types strings by their length in characters
+    if (static_cast<unsigned char>(c) >= 0x80) {
+      return std::nullopt;
+    }
+  }
+  return SqlLiteral{
+      SqlLiteral::Type::String, value, 0, static_cast<int64_t>(value.size()), 0};
+}
+
+std::string to_placeholder(const SqlLiteral& literal) {
+  std::string placeholder(1, kPlaceholder);
+  if (literal.type == SqlLiteral::Type::String) {
+    return placeholder + "s" + std::to_string(literal.precision);
+  }
+  return placeholder + "n" + std::to_string(literal.precision) + "," +
+         std::to_string(literal.scale);
+}
+
+class Normalizer {
+ public:
+  explicit Normalizer(const std::string& sql) : sql_(sql) {}
+
+  NormalizedSql run() {
+    size_t pos = 0;
+    while (pos < sql_.size()) {
+      const char c = sql_[pos];
+      if (std::isspace(static_cast<unsigned char>(c))) {
+        pending_space_ = true;
+        ++pos;
+      } else if (c == '-' && pos + 1 < sql_.size() && sql_[pos + 1] == '-') {
+        pos = sql_.find('\n', pos);
+        pos = pos == std::string::npos ? sql_.size() : pos;
+        pending_space_ = true;
+      } else if (c == '/' && pos + 1 < sql_.size() && sql_[pos + 1] == '*') {
+        // block comments may carry query hints, keep them
+        auto end = sql_.find("*/", pos + 2);
+        end = end == std::string::npos ? sql_.size() : end + 2;
+        emitVerbatim(sql_.substr(pos, end - pos));
+        pos = end;
+      } else if (c == '\'') {
+        pos = readString(pos);
+      } else if (c == '"' || c == '`') {
+        auto end = sql_.find(c, pos + 1);
+        end = end == std::string::npos ? sql_.size() : end + 1;
+        emitVerbatim(sql_.substr(pos, end - pos));
+        pos = end;
+      } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                 (c == '.' && pos + 1 < sql_.size() &&
+                  std::isdigit(static_cast<unsigned char>(sql_[pos + 1])))) {
+        pos = readNumber(pos);
+      } else if (is_identifier_char(c)) {
+        auto end = pos;
+        while (end < sql_.size() && is_identifier_char(sql_[end])) {
+          ++end;
+        }
+        const auto word = sql_.substr(pos, end - pos);
+        emitVerbatim(word);
+        last_word_ = boost::algorithm::to_upper_copy(word);
+        pos = end;
+      } else {
+        emitVerbatim(std::string(1, c));
+        pos++;
+      }
+    }
+    return std::move(result_);
+  }
+
+ private:
+  size_t readString(const size_t begin) {
+    const bool prefixed = begin > 0 && is_identifier_char(sql_[begin - 1]);
+    std::string value;
+    size_t pos = begin + 1;
+    while (pos < sql_.size()) {
+      if (sql_[pos] == '\'') {
+        if (pos + 1 < sql_.size() && sql_[pos + 1] == '\'') {
+          value += '\'';
+          pos += 2;
+          continue;
+        }
+        ++pos;
+        break;
+      }
+      value += sql_[pos++];
+    }
+    const auto text = sql_.substr(begin, pos - begin);
+    std::optional<SqlLiteral> literal;
+    if (!prefixed && !last_word_context(kVerbatimStringContexts)) {
+      literal = parse_string(value);
+    }
+    emitLiteral(text, literal);
+    return pos;
+  }
+
+  size_t readNumber(const size_t begin) {
+    auto pos = begin;
+    while (pos < sql_.size() && (std::isdigit(static_cast<unsigned char>(sql_[pos])) ||
+                                 sql_[pos] == '.')) {
+      ++pos;
+    }
+    if (pos < sql_.size() && (sql_[pos] == 'e' || sql_[pos] == 'E')) {
+      ++pos;
+      if (pos < sql_.size() && (sql_[pos] == '+' || sql_[pos] == '-')) {
+        ++pos;
+      }
+      while (pos < sql_.size() && std::isdigit(static_cast<unsigned char>(sql_[pos]))) {
+        ++pos;
+      }
+    }
+    const auto text = sql_.substr(begin, pos - begin);
+    if (pos < sql_.size() && is_identifier_char(sql_[pos])) {
+      // not a literal, e.g. part of an identifier like 1st_column
+      emitVerbatim(text);
+      return pos;
+    }
+    std::optional<SqlLiteral> literal;
+    if (std::count(text.begin(), text.end(), '.') <= 1 &&
+        !last_word_context(kVerbatimNumberContexts)) {
+      literal = parse_number(text);
+    }
+    emitLiteral(text, literal);
+    return pos;
+  }
+
+  bool last_word_context(const std::unordered_set<std::string>& contexts) const {
+    return last_token_was_word_ && contexts.count(last_word_);
+  }
+
+  void emitSpace() {
+    if (pending_space_ && !result_.exact_key.empty()) {
+      result_.exact_key += ' ';
+      result_.template_key += ' ';
+    }
+    pending_space_ = false;
+  }
+
+  void emitVerbatim(const std::string& text) {
+    emitSpace();
+    result_.exact_key += text;
+    result_.template_key += text;
+    last_token_was_word_ = is_identifier_char(text.front());
+  }
+
+  void emitLiteral(const std::string& text, const std::optional<SqlLiteral>& literal) {
+    if (!literal) {
+      emitVerbatim(text);
+      return;
+    }
+    emitSpace();
+    result_.exact_key += text;
+    result_.template_key += to_placeholder(*literal);
+    result_.literals.push_back(*literal);
+    last_token_was_word_ = false;
+  }
+
+  const std::string& sql_;
+  NormalizedSql result_;
+  bool pending_space_{false};
+  bool last_token_was_word_{false};
+  std::string last_word_;
+};
+
+struct PlanLiteral {
+  std::string pointer;
+  const rapidjson::Value* node;
+};
+
+std::string escape_pointer_token(const std::string& token) {
+  std::string escaped;
+  for (const auto c : token) {
+    if (c == '~') {
+      escaped += "~0";
+    } else if (c == '/') {
+      escaped += "~1";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+void collect_plan_literals(const rapidjson::Value& value,
+                           const std::string& pointer,
+                           std::vector<PlanLiteral>& literals) {
+  if (value.IsArray()) {
+    for (rapidjson::SizeType i = 0; i < value.Size(); ++i) {
+      collect_plan_literals(value[i], pointer + "/" + std::to_string(i), literals);
+    }
+    return;
+  }
+  if (!value.IsObject()) {
+    return;
+  }
+  if (value.HasMember("literal") && value.HasMember("type")) {
+    literals.push_back({pointer, &value});
+    return;
+  }
+  for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+    collect_plan_literals(
+        it->value,
+        pointer + "/" + escape_pointer_token(it->name.GetString()),
+        literals);
+  }
+}
+
+bool matches(const SqlLiteral& sql_literal, const rapidjson::Value& plan_literal) {
+  const auto& value = plan_literal["literal"];
+  const auto& type = plan_literal["type"];
+  if (!type.IsString() || !plan_literal.HasMember("scale") ||
+      !plan_literal.HasMember("precision") || !plan_literal["scale"].IsInt64() ||
+      !plan_literal["precision"].IsInt64()) {
+    return false;
+  }
+  if (plan_literal["scale"].GetInt64() != sql_literal.scale &&
+      sql_literal.type == SqlLiteral::Type::Number) {
+    return false;
+  }
+  if (plan_literal["precision"].GetInt64() != sql_literal.precision) {
+    return false;
+  }
+  switch (sql_literal.type) {
+    case SqlLiteral::Type::String:
+      return type.GetString() == std::string("CHAR") && value.IsString() &&
+             value.GetString() == sql_literal.string_value;
+    case SqlLiteral::Type::Number:
+      return type.GetString() == std::string("DECIMAL") && value.IsInt64() &&
+             value.GetInt64() == sql_literal.unscaled_value;
+  }
+  return false;
+}
+
+}  // namespace
+
+std::optional<NormalizedSql> normalize_sql(const std::string& sql) {
+  auto normalized = Normalizer(sql).run();
+  const auto first_space = normalized.exact_key.find_first_of(" (");
+  const auto first_word =
+      boost::algorithm::to_upper_copy(normalized.exact_key.substr(0, first_space));
+  if (first_word != "SELECT" && first_word != "WITH") {
+    return std::nullopt;
+  }
+  return normalized;
+}
+
+std::optional<std::vector<std::string>> find_literal_nodes(const std::string& ra_json,
+                                                           const NormalizedSql& sql) {
+  rapidjson::Document plan;
+  plan.Parse(ra_json.c_str());
+  if (plan.HasParseError()) {
+    return std::nullopt;
+  }
+  std::vector<PlanLiteral> plan_literals;
+  collect_plan_literals(plan, "", plan_literals);
+
+  std::vector<std::string> literal_nodes;
+  std::unordered_set<size_t> used_plan_literals;
+  for (const auto& sql_literal : sql.literals) {
+    std::optional<size_t> match;
+    for (size_t i = 0; i < plan_literals.size(); ++i) {
+      if (matches(sql_literal, *plan_literals[i].node)) {
+        if (match) {
+          // ambiguous, the placeholder could stand for either node
+          return std::nullopt;
+        }
+        match = i;
+      }
+    }
+    if (!match || !used_plan_literals.insert(*match).second) {
+      return std::nullopt;
+    }
+    literal_nodes.push_back(plan_literals[*match].pointer);
+  }
+  return literal_nodes;
+}
+
+std::string instantiate_plan(const std::string& ra_json,
+                             const std::vector<std::string>& literal_nodes,
+                             const NormalizedSql& sql) {
+  rapidjson::Document plan;
+  plan.Parse(ra_json.c_str());
+  CHECK(!plan.HasParseError());
+  CHECK_EQ(literal_nodes.size(), sql.literals.size());
+  auto& allocator = plan.GetAllocator();
+  for (size_t i = 0; i < literal_nodes.size(); ++i) {
+    auto node = rapidjson::Pointer(literal_nodes[i].c_str()).Get(plan);
+    CHECK(node && node->IsObject());
+    auto& value = (*node)["literal"];
+    const auto& literal = sql.literals[i];
+    switch (literal.type) {
+      case SqlLiteral::Type::String:
+        value.SetString(literal.string_value.c_str(),
+                        static_cast<rapidjson::SizeType>(literal.string_value.size()),
+                        allocator);
+        break;
+      case SqlLiteral::Type::Number:
+        value.SetInt64(literal.unscaled_value);
+        break;
+    }
+  }
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  plan.Accept(writer);
+  return buffer.GetString();
+}
+
+}  // namespace plan_template
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PlanTemplate.h
+ * @brief   SQL normalization and literal parameterization of relational algebra plans,
+ *          used by the Calcite plan cache.
+ *
+ * A query is normalized into a template where every parameterizable literal is replaced
+ * by a placeholder encoding its shape (string length, or decimal precision and scale).
+ * Two queries with the same template get the same literal types from Calcite, so the
+ * plan of one can be turned into the plan of the other by substituting the literal
+ * values, provided that every literal of the query maps to exactly one literal node of
+ * the plan. Literals whose value Calcite transforms (typed literals, intervals, LIMIT
+ * and OFFSET counts, ...) are kept verbatim in the template instead.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace plan_template {
+
+struct SqlLiteral {
+  enum class Type { String, Number };
+
+  Type type;
+  std::string string_value;  // decoded value, for strings
+  int64_t unscaled_value;    // for numbers, i.e. 150 for 1.50
+  int64_t precision;         // string length or number of significant digits
+  int64_t scale;
+};
+
+struct NormalizedSql {
+  std::string exact_key;  // normalized query text, literals included
+  std::string template_key;
+  std::vector<SqlLiteral> literals;  // in the order of the template placeholders
+};
+
+/**
+ * Returns the normalized form of a SELECT (or WITH) statement. Line comments are dropped
+ * and whitespace outside of literals and quoted identifiers is collapsed. Returns
+ * nullopt for other statements.
+ */
+std::optional<NormalizedSql> normalize_sql(const std::string& sql);
+
+/**
+ * Returns the JSON pointer of the plan literal node of every template literal, or
+ * nullopt if the plan cannot be parameterized by those literals.
+ */
+std::optional<std::vector<std::string>> find_literal_nodes(const std::string& ra_json,
+                                                           const NormalizedSql& sql);
+
+/**
+ * Substitutes the literals of `sql` into a plan produced for the same template.
+ */
+std::string instantiate_plan(const std::string& ra_json,
+                             const std::vector<std::string>& literal_nodes,
+                             const NormalizedSql& sql);
+
+}  // namespace plan_template
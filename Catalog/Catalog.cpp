@@ -25,6 +25,7 @@
 #include "Catalog/Catalog.h"
 
 #include <algorithm>
+#include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/range/adaptor/map.hpp>
@@ -94,6 +95,7 @@ extern bool g_cache_string_hash;
 // Serialize temp tables to a json file in the Catalogs directory for Calcite parsing
 // under unit testing.
 bool g_serialize_temp_tables{false};
+bool g_enable_catalog_snapshot_reads{true};
 
 namespace Catalog_Namespace {
 
@@ -105,14 +107,28 @@ const int MAPD_TEMP_DICT_START_ID =
 
 const std::string Catalog::physicalTableNameTag_("_shard_#");
 std::map<std::string, std::shared_ptr<Catalog>> Catalog::mapd_cat_map_;
+std::mutex Catalog::mapd_cat_map_mutex_;
+std::map<std::string, std::shared_ptr<std::mutex>> Catalog::mapd_cat_load_mutexes_;
 
 thread_local bool Catalog::thread_holds_read_lock = false;
 
 using sys_read_lock = read_lock<SysCatalog>;
 using cat_read_lock = read_lock<Catalog>;
-using cat_write_lock = write_lock<Catalog>;
 using cat_sqlite_lock = sqlite_lock<Catalog>;
 
+namespace {
+
+// Every change to the catalog maps is made under the write lock, which makes it the
+// place to drop the snapshot of them.
+class cat_write_lock : public write_lock<Catalog> {
+ public:
+  cat_write_lock(const Catalog* cat) : write_lock<Catalog>(cat) {
+    cat->resetMetadataSnapshot();
+  }
+};
+
+}  // namespace
+
 // migration will be done as two step process this release
 // will create and use new table
 // next release will remove old table, doing this to have fall back path
@@ -156,6 +172,38 @@ inline auto table_json_filepath(const std::string& base_path,
                                  "_temp_tables.json");
 }
 
+// The z-order column ids are stored as a comma separated list.
+std::string serialize_column_ids(const std::vector<int>& column_ids) {
+  std::vector<std::string> column_id_strs;
+  for (const auto column_id : column_ids) {
+    column_id_strs.push_back(std::to_string(column_id));
+  }
+  return boost::algorithm::join(column_id_strs, ",");
+}
+
+std::vector<int> deserialize_column_ids(const std::string& column_ids_str) {
+  std::vector<int> column_ids;
+  if (column_ids_str.empty()) {
+    return column_ids;
+  }
+  std::vector<std::string> column_id_strs;
+  boost::split(column_id_strs, column_ids_str, boost::is_any_of(","));
+  for (const auto& column_id_str : column_id_strs) {
+    column_ids.push_back(std::stoi(column_id_str));
+  }
+  return column_ids;
+}
+
+std::string zorder_column_names(const Catalog& cat, const TableDescriptor* td) {
+  std::vector<std::string> column_names;
+  for (const auto column_id : td->zorderColumnIds) {
+    const auto cd = cat.getMetadataForColumn(td->tableId, column_id);
+    CHECK(cd);
+    column_names.push_back(cd->columnName);
+  }
+  return boost::algorithm::join(column_names, ", ");
+}
+
 }  // namespace
 
 Catalog::Catalog(const string& basePath,
@@ -180,6 +228,7 @@ Catalog::Catalog(const string& basePath,
     CheckAndExecuteMigrations();
   }
   buildMaps();
+  buildColumnStatisticsMap();
   if (!is_new_db) {
     CheckAndExecuteMigrationsPostBuildMaps();
   }
@@ -262,6 +311,11 @@ void Catalog::updateTableDescriptorSchema() {
       string queryString("ALTER TABLE mapd_tables ADD storage_type TEXT DEFAULT ''");
       sqliteConnector_.query(queryString);
     }
+    if (std::find(cols.begin(), cols.end(), std::string("zorder_column_ids")) ==
+        cols.end()) {
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD zorder_column_ids TEXT DEFAULT ''");
+    }
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
     throw;
@@ -606,6 +660,18 @@ void Catalog::updateDictionarySchema() {
   sqliteConnector_.query("END TRANSACTION");
 }
 
+void Catalog::updateColumnStatisticsSchema() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    sqliteConnector_.query(getColumnStatisticsSchema(true));
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+}
+
 void Catalog::createFsiSchemasAndDefaultServers() {
   cat_sqlite_lock sqlite_lock(this);
   sqliteConnector_.query("BEGIN TRANSACTION");
@@ -677,6 +743,13 @@ const std::string Catalog::getForeignServerSchema(bool if_not_exists) {
          "options text)";
 }
 
+const std::string Catalog::getColumnStatisticsSchema(bool if_not_exists) {
+  return "CREATE TABLE " + (if_not_exists ? std::string{"IF NOT EXISTS "} : "") +
+         "omnisci_column_statistics(table_id integer, column_id integer, " +
+         "row_count bigint, null_count bigint, ndv_sketch text, histogram text, " +
+         "PRIMARY KEY(table_id, column_id))";
+}
+
 const std::string Catalog::getForeignTableSchema(bool if_not_exists) {
   return "CREATE TABLE " + (if_not_exists ? std::string{"IF NOT EXISTS "} : "") +
          "omnisci_foreign_tables(table_id integer unique, server_id integer, " +
@@ -897,6 +970,7 @@ void Catalog::CheckAndExecuteMigrations() {
   updateDictionaryNames();
   updateLogicalToPhysicalTableLinkSchema();
   updateDictionarySchema();
+  updateColumnStatisticsSchema();
   updatePageSize();
   updateDeletedColumnIndicator();
   updateFrontendViewsToDashboards();
@@ -951,7 +1025,7 @@ void Catalog::buildMaps() {
       "SELECT tableid, name, ncolumns, isview, fragments, frag_type, max_frag_rows, "
       "max_chunk_size, frag_page_size, "
       "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid, "
-      "sort_column_id, storage_type "
+      "sort_column_id, storage_type, zorder_column_ids "
       "from mapd_tables");
   sqliteConnector_.query(tableQuery);
   numRows = sqliteConnector_.getNumRows();
@@ -994,6 +1068,8 @@ void Catalog::buildMaps() {
     td->userId = sqliteConnector_.getData<int>(r, 15);
     td->sortedColumnId =
         sqliteConnector_.isNull(r, 16) ? 0 : sqliteConnector_.getData<int>(r, 16);
+    td->zorderColumnIds = deserialize_column_ids(
+        sqliteConnector_.isNull(r, 18) ? "" : sqliteConnector_.getData<string>(r, 18));
     if (!td->isView) {
       td->fragmenter = nullptr;
     }
@@ -1377,7 +1453,7 @@ void Catalog::instantiateFragmenter(TableDescriptor* td) const {
     getAllColumnMetadataForTableImpl(td, columnDescs, true, false, true);
     Chunk::translateColumnDescriptorsToChunkVec(columnDescs, chunkVec);
     ChunkKey chunkKeyPrefix = {currentDB_.dbId, td->tableId};
-    if (td->sortedColumnId > 0) {
+    if (td->sortedColumnId > 0 || !td->zorderColumnIds.empty()) {
       td->fragmenter = std::make_shared<SortedOrderFragmenter>(chunkKeyPrefix,
                                                                chunkVec,
                                                                dataMgr_.get(),
@@ -1453,6 +1529,23 @@ const TableDescriptor* Catalog::getMetadataForTableImpl(
 
 const TableDescriptor* Catalog::getMetadataForTable(int tableId,
                                                     bool populateFragmenter) const {
+  if (const auto snapshot = getMetadataSnapshot()) {
+    const auto tableDescIt = snapshot->tables.find(tableId);
+    if (tableDescIt == snapshot->tables.end()) {
+      return nullptr;
+    }
+    TableDescriptor* td = tableDescIt->second;
+    if (!populateFragmenter || td->isView) {
+      return td;
+    }
+    {
+      std::unique_lock<std::mutex> td_lock(*td->mutex_.get());
+      if (td->fragmenter) {
+        return td;
+      }
+    }
+    // instantiating the fragmenter reads the catalog under its lock
+  }
   cat_read_lock read_lock(this);
   return getMetadataForTableImpl(tableId, populateFragmenter);
 }
@@ -1502,6 +1595,21 @@ const std::vector<LeafHostInfo>& Catalog::getStringDictionaryHosts() const {
   return string_dict_hosts_;
 }
 
+std::map<int, size_t> Catalog::getLoadedDictionarySizes() const {
+  std::map<int, size_t> dict_sizes;
+  if (!string_dict_hosts_.empty()) {
+    return dict_sizes;
+  }
+  cat_read_lock read_lock(this);
+  for (const auto& [dict_ref, dd] : dictDescriptorMapByRef_) {
+    std::lock_guard string_dict_lock(*dd->string_dict_mutex);
+    if (dd->stringDict) {
+      dict_sizes[dict_ref.dictId] = dd->stringDict->storageEntryCount();
+    }
+  }
+  return dict_sizes;
+}
+
 const ColumnDescriptor* Catalog::getMetadataForColumn(int tableId,
                                                       const string& columnName) const {
   cat_read_lock read_lock(this);
@@ -1516,10 +1624,39 @@ const ColumnDescriptor* Catalog::getMetadataForColumn(int tableId,
 }
 
 const ColumnDescriptor* Catalog::getMetadataForColumn(int table_id, int column_id) const {
+  if (const auto snapshot = getMetadataSnapshot()) {
+    const auto colDescIt = snapshot->columns.find(ColumnIdKey(table_id, column_id));
+    return colDescIt == snapshot->columns.end() ? nullptr : colDescIt->second;
+  }
   cat_read_lock read_lock(this);
   return getMetadataForColumnUnlocked(table_id, column_id);
 }
 
+std::shared_ptr<const Catalog::MetadataSnapshot> Catalog::getMetadataSnapshot() const {
+  if (!g_enable_catalog_snapshot_reads) {
+    return nullptr;
+  }
+  if (auto snapshot = std::atomic_load(&metadataSnapshot_)) {
+    return snapshot;
+  }
+  // the maps are mid-change in the thread holding the write lock
+  if (thread_holding_write_lock == std::this_thread::get_id()) {
+    return nullptr;
+  }
+  cat_read_lock read_lock(this);
+  auto snapshot = std::atomic_load(&metadataSnapshot_);
+  if (!snapshot) {
+    snapshot = std::make_shared<const MetadataSnapshot>(
+        MetadataSnapshot{tableDescriptorMapById_, columnDescriptorMapById_});
+    std::atomic_store(&metadataSnapshot_, snapshot);
+  }
+  return snapshot;
+}
+
+void Catalog::resetMetadataSnapshot() const {
+  std::atomic_store(&metadataSnapshot_, std::shared_ptr<const MetadataSnapshot>());
+}
+
 const ColumnDescriptor* Catalog::getMetadataForColumnUnlocked(int tableId,
                                                               int columnId) const {
   ColumnIdKey columnIdKey(tableId, columnId);
@@ -1933,6 +2070,14 @@ void Catalog::dropColumn(const TableDescriptor& td, const ColumnDescriptor& cd)
       "UPDATE mapd_tables SET ncolumns = ncolumns - 1 WHERE tableid = ?",
       std::vector<std::string>{std::to_string(td.tableId)});
 
+  sqliteConnector_.query_with_text_params(
+      "DELETE FROM omnisci_column_statistics WHERE table_id = ? AND column_id = ?",
+      std::vector<std::string>{std::to_string(td.tableId), std::to_string(cd.columnId)});
+  {
+    std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+    columnStatisticsMap_.erase({td.tableId, cd.columnId});
+  }
+
   ColumnDescriptorMap::iterator columnDescIt =
       columnDescriptorMap_.find(ColumnKey(cd.tableId, to_upper(cd.columnName)));
   CHECK(columnDescIt != columnDescriptorMap_.end());
@@ -2216,7 +2361,7 @@ void Catalog::createTable(
   if (td.persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
     try {
       sqliteConnector_.query_with_text_params(
-          R"(INSERT INTO mapd_tables (name, userid, ncolumns, isview, fragments, frag_type, max_frag_rows, max_chunk_size, frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, sort_column_id, storage_type, key_metainfo) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))",
+          R"(INSERT INTO mapd_tables (name, userid, ncolumns, isview, fragments, frag_type, max_frag_rows, max_chunk_size, frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, sort_column_id, storage_type, key_metainfo, zorder_column_ids) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))",
           std::vector<std::string>{td.tableName,
                                    std::to_string(td.userId),
                                    std::to_string(td.nColumns),
@@ -2233,7 +2378,8 @@ void Catalog::createTable(
                                    std::to_string(td.nShards),
                                    std::to_string(td.sortedColumnId),
                                    td.storageType,
-                                   td.keyMetainfo});
+                                   td.keyMetainfo,
+                                   serialize_column_ids(td.zorderColumnIds)});
 
       // now get the auto generated tableid
       sqliteConnector_.query_with_text_param(
@@ -3148,6 +3294,7 @@ void Catalog::createShardedTable(
 
 void Catalog::truncateTable(const TableDescriptor* td) {
   cat_write_lock write_lock(this);
+  removeColumnStatistics(td->tableId);
 
   const auto physicalTableIt = logicalToPhysicalTableMapById_.find(td->tableId);
   if (physicalTableIt != logicalToPhysicalTableMapById_.end()) {
@@ -3246,6 +3393,135 @@ void Catalog::removeFragmenterForTable(const int table_id) {
 }
 
 // used by rollback_table_epoch to clean up in memory artifacts after a rollback
+void Catalog::buildColumnStatisticsMap() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query(
+      "SELECT table_id, column_id, row_count, null_count, ndv_sketch, histogram FROM "
+      "omnisci_column_statistics");
+  std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+  for (size_t r = 0; r < sqliteConnector_.getNumRows(); ++r) {
+    auto statistics = std::make_shared<ColumnStatistics>();
+    statistics->row_count = sqliteConnector_.getData<int64_t>(r, 2);
+    statistics->null_count = sqliteConnector_.getData<int64_t>(r, 3);
+    statistics->deserializeSketch(sqliteConnector_.getData<std::string>(r, 4));
+    statistics->deserializeHistogram(sqliteConnector_.getData<std::string>(r, 5));
+    columnStatisticsMap_[{sqliteConnector_.getData<int>(r, 0),
+                          sqliteConnector_.getData<int>(r, 1)}] = statistics;
+  }
+}
+
+void Catalog::writeColumnStatisticsUnlocked(const int table_id,
+                                            const int column_id,
+                                            const ColumnStatistics& statistics) {
+  sqliteConnector_.query_with_text_params(
+      "INSERT OR REPLACE INTO omnisci_column_statistics (table_id, column_id, row_count, "
+      "null_count, ndv_sketch, histogram) VALUES (?, ?, ?, ?, ?, ?)",
+      std::vector<std::string>{std::to_string(table_id),
+                               std::to_string(column_id),
+                               std::to_string(statistics.row_count),
+                               std::to_string(statistics.null_count),
+                               statistics.serializeSketch(),
+                               statistics.serializeHistogram()});
+}
+
+void Catalog::setColumnStatistics(const int table_id,
+                                  const std::map<int, ColumnStatistics>& statistics) {
+  cat_sqlite_lock sqlite_lock(this);
+  std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    sqliteConnector_.query_with_text_param(
+        "DELETE FROM omnisci_column_statistics WHERE table_id = ?",
+        std::to_string(table_id));
+    for (const auto& [column_id, column_statistics] : statistics) {
+      writeColumnStatisticsUnlocked(table_id, column_id, column_statistics);
+    }
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+  columnStatisticsMap_.erase(columnStatisticsMap_.lower_bound({table_id, 0}),
+                             columnStatisticsMap_.lower_bound({table_id + 1, 0}));
+  for (const auto& [column_id, column_statistics] : statistics) {
+    columnStatisticsMap_[{table_id, column_id}] =
+        std::make_shared<ColumnStatistics>(column_statistics);
+  }
+}
+
+std::shared_ptr<const ColumnStatistics> Catalog::getColumnStatistics(
+    const int table_id,
+    const int column_id) const {
+  std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+  const auto it = columnStatisticsMap_.find({table_id, column_id});
+  return it == columnStatisticsMap_.end() ? nullptr : it->second;
+}
+
+void Catalog::addToColumnStatistics(const int table_id,
+                                    const std::vector<int>& column_ids,
+                                    const std::vector<DataBlockPtr>& data,
+                                    const size_t num_rows) {
+  CHECK_EQ(column_ids.size(), data.size());
+  std::vector<size_t> analyzed_columns;
+  {
+    std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+    for (size_t i = 0; i < column_ids.size(); ++i) {
+      if (columnStatisticsMap_.count({table_id, column_ids[i]})) {
+        analyzed_columns.push_back(i);
+      }
+    }
+  }
+  if (analyzed_columns.empty()) {
+    return;
+  }
+  // Look the columns up before taking the sqlite lock, which is taken after the
+  // catalog lock elsewhere.
+  std::vector<const ColumnDescriptor*> column_descriptors;
+  for (const auto i : analyzed_columns) {
+    column_descriptors.push_back(getMetadataForColumn(table_id, column_ids[i]));
+    CHECK(column_descriptors.back());
+  }
+  cat_sqlite_lock sqlite_lock(this);
+  std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+  std::vector<std::pair<int, std::shared_ptr<ColumnStatistics>>> updated_statistics;
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    for (size_t k = 0; k < analyzed_columns.size(); ++k) {
+      const auto i = analyzed_columns[k];
+      const auto it = columnStatisticsMap_.find({table_id, column_ids[i]});
+      if (it == columnStatisticsMap_.end()) {
+        continue;
+      }
+      auto statistics = std::make_shared<ColumnStatistics>(*it->second);
+      statistics->addInsertValues(
+          column_descriptors[k]->columnType, data[i].numbersPtr, num_rows);
+      writeColumnStatisticsUnlocked(table_id, column_ids[i], *statistics);
+      updated_statistics.emplace_back(column_ids[i], statistics);
+    }
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+  for (const auto& [column_id, statistics] : updated_statistics) {
+    columnStatisticsMap_[{table_id, column_id}] = statistics;
+  }
+}
+
+void Catalog::removeColumnStatistics(const int table_id) {
+  cat_sqlite_lock sqlite_lock(this);
+  std::lock_guard<std::mutex> lock(columnStatisticsMutex_);
+  const auto begin = columnStatisticsMap_.lower_bound({table_id, 0});
+  const auto end = columnStatisticsMap_.lower_bound({table_id + 1, 0});
+  if (begin == end) {
+    return;
+  }
+  sqliteConnector_.query_with_text_param(
+      "DELETE FROM omnisci_column_statistics WHERE table_id = ?",
+      std::to_string(table_id));
+  columnStatisticsMap_.erase(begin, end);
+}
+
 void Catalog::removeChunks(const int table_id) {
   auto td = getMetadataForTable(table_id);
   CHECK(td);
@@ -3292,6 +3568,7 @@ void Catalog::dropTable(const TableDescriptor* td) {
           std::to_string(td->tableId));
       logicalToPhysicalTableMapById_.erase(td->tableId);
     }
+    removeColumnStatistics(td->tableId);
     doDropTable(td);
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
@@ -3823,10 +4100,12 @@ std::string Catalog::generatePhysicalTableName(const std::string& logicalTableNa
 }
 
 void Catalog::set(const std::string& dbName, std::shared_ptr<Catalog> cat) {
+  std::lock_guard<std::mutex> map_lock(mapd_cat_map_mutex_);
   mapd_cat_map_[dbName] = cat;
 }
 
 std::shared_ptr<Catalog> Catalog::get(const std::string& dbName) {
+  std::lock_guard<std::mutex> map_lock(mapd_cat_map_mutex_);
   auto cat_it = mapd_cat_map_.find(dbName);
   if (cat_it != mapd_cat_map_.end()) {
     return cat_it->second;
@@ -3835,6 +4114,7 @@ std::shared_ptr<Catalog> Catalog::get(const std::string& dbName) {
 }
 
 std::shared_ptr<Catalog> Catalog::get(const int32_t db_id) {
+  std::lock_guard<std::mutex> map_lock(mapd_cat_map_mutex_);
   for (const auto& entry : mapd_cat_map_) {
     if (entry.second->currentDB_.dbId == db_id) {
       return entry.second;
@@ -3849,6 +4129,15 @@ std::shared_ptr<Catalog> Catalog::checkedGet(const int32_t db_id) {
   return catalog;
 }
 
+std::vector<std::shared_ptr<Catalog>> Catalog::getLoadedCatalogs() {
+  std::lock_guard<std::mutex> map_lock(mapd_cat_map_mutex_);
+  std::vector<std::shared_ptr<Catalog>> catalogs;
+  for (const auto& entry : mapd_cat_map_) {
+    catalogs.push_back(entry.second);
+  }
+  return catalogs;
+}
+
 std::shared_ptr<Catalog> Catalog::get(const string& basePath,
                                       const DBMetadata& curDB,
                                       std::shared_ptr<Data_Namespace::DataMgr> dataMgr,
@@ -3856,19 +4145,35 @@ std::shared_ptr<Catalog> Catalog::get(const string& basePath,
                                       std::shared_ptr<Calcite> calcite,
                                       bool is_new_db) {
   auto cat = Catalog::get(curDB.dbName);
-
   if (cat) {
     return cat;
-  } else {
-    cat = std::make_shared<Catalog>(
-        basePath, curDB, dataMgr, string_dict_hosts, calcite, is_new_db);
-    Catalog::set(curDB.dbName, cat);
+  }
+  // The catalogs of different databases load side by side, the map lock isn't held while
+  // one reads its sqlite file.
+  std::shared_ptr<std::mutex> load_mutex;
+  {
+    std::lock_guard<std::mutex> map_lock(mapd_cat_map_mutex_);
+    auto& db_load_mutex = mapd_cat_load_mutexes_[curDB.dbName];
+    if (!db_load_mutex) {
+      db_load_mutex = std::make_shared<std::mutex>();
+    }
+    load_mutex = db_load_mutex;
+  }
+  std::lock_guard<std::mutex> load_lock(*load_mutex);
+  cat = Catalog::get(curDB.dbName);
+  if (cat) {
     return cat;
   }
+  cat = std::make_shared<Catalog>(
+      basePath, curDB, dataMgr, string_dict_hosts, calcite, is_new_db);
+  Catalog::set(curDB.dbName, cat);
+  return cat;
 }
 
 void Catalog::remove(const std::string& dbName) {
+  std::lock_guard<std::mutex> map_lock(mapd_cat_map_mutex_);
   mapd_cat_map_.erase(dbName);
+  mapd_cat_load_mutexes_.erase(dbName);
 }
 
 void Catalog::vacuumDeletedRows(const int logicalTableId) const {
@@ -3916,6 +4221,26 @@ void Catalog::vacuumDeletedRows(const TableDescriptor* td) const {
   }
 }
 
+void Catalog::replaceDictionaryStorage(const int dict_id,
+                                       const std::string& new_dict_folder,
+                                       const std::string& replaced_dict_folder) const {
+  cat_write_lock write_lock(this);
+  const DictRef dict_ref(currentDB_.dbId, dict_id);
+  const auto dictIt = dictDescriptorMapByRef_.find(dict_ref);
+  CHECK(dictIt != dictDescriptorMapByRef_.end());
+  const auto& dd = dictIt->second;
+  CHECK(!dd->dictIsTemp);
+  CHECK(!boost::filesystem::exists(replaced_dict_folder));
+  {
+    // close the dictionary
+    std::lock_guard string_dict_lock(*dd->string_dict_mutex);
+    dd->stringDict.reset();
+  }
+  boost::filesystem::rename(dd->dictFolderPath, replaced_dict_folder);
+  boost::filesystem::rename(new_dict_folder, dd->dictFolderPath);
+  getMetadataForDictUnlocked(dict_id, true);
+}
+
 void Catalog::buildForeignServerMap() {
   sqliteConnector_.query(
       "SELECT id, name, data_wrapper_type, options, owner_user_id, creation_time FROM "
@@ -4152,6 +4477,9 @@ std::string Catalog::dumpSchema(const TableDescriptor* td) const {
     CHECK(sort_cd);
     with_options.push_back("SORT_COLUMN='" + sort_cd->columnName + "'");
   }
+  if (!td->zorderColumnIds.empty()) {
+    with_options.push_back("ZORDER_COLUMNS='" + zorder_column_names(*this, td) + "'");
+  }
   os << ") WITH (" + boost::algorithm::join(with_options, ", ") + ");";
   return os.str();
 }
@@ -4354,6 +4682,9 @@ std::string Catalog::dumpCreateTable(const TableDescriptor* td,
     CHECK(sort_cd);
     with_options.push_back("SORT_COLUMN='" + sort_cd->columnName + "'");
   }
+  if (!foreign_table && !td->zorderColumnIds.empty()) {
+    with_options.push_back("ZORDER_COLUMNS='" + zorder_column_names(*this, td) + "'");
+  }
 
   if (!with_options.empty()) {
     if (!multiline_formatting) {
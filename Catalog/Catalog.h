@@ -41,6 +41,7 @@
 
 #include "Calcite/Calcite.h"
 #include "Catalog/ColumnDescriptor.h"
+#include "Catalog/ColumnStatistics.h"
 #include "Catalog/DashboardDescriptor.h"
 #include "Catalog/DictDescriptor.h"
 #include "Catalog/ForeignServer.h"
@@ -217,6 +218,10 @@ class Catalog final {
 
   const std::vector<LeafHostInfo>& getStringDictionaryHosts() const;
 
+  // Number of strings of each dictionary of this database loaded in memory, by dictionary
+  // id. Dictionaries served by a string dictionary server aren't reported.
+  std::map<int, size_t> getLoadedDictionarySizes() const;
+
   const ColumnDescriptor* getShardColumnMetadataForTable(const TableDescriptor* td) const;
 
   std::vector<const TableDescriptor*> getPhysicalTablesDescriptors(
@@ -257,6 +262,7 @@ class Catalog final {
   static std::shared_ptr<Catalog> get(const std::string& dbName);
   static std::shared_ptr<Catalog> get(const int32_t db_id);
   static std::shared_ptr<Catalog> checkedGet(const int32_t db_id);
+  static std::vector<std::shared_ptr<Catalog>> getLoadedCatalogs();
   static std::shared_ptr<Catalog> get(const std::string& basePath,
                                       const DBMetadata& curDB,
                                       std::shared_ptr<Data_Namespace::DataMgr> dataMgr,
@@ -279,8 +285,28 @@ class Catalog final {
   void eraseTablePhysicalData(const TableDescriptor* td);
   void vacuumDeletedRows(const TableDescriptor* td) const;
   void vacuumDeletedRows(const int logicalTableId) const;
+  // Moves the storage of a dictionary to replaced_dict_folder, which mustn't exist, and
+  // the dictionary in new_dict_folder in its place.
+  void replaceDictionaryStorage(const int dict_id,
+                                const std::string& new_dict_folder,
+                                const std::string& replaced_dict_folder) const;
   void setForReload(const int32_t tableId);
 
+  // Replaces the statistics of the columns of a logical table by the ones computed by
+  // ANALYZE TABLE, keyed by column id.
+  void setColumnStatistics(const int table_id,
+                           const std::map<int, ColumnStatistics>& statistics);
+  // Returns null if the column of the logical table has no statistics.
+  std::shared_ptr<const ColumnStatistics> getColumnStatistics(const int table_id,
+                                                              const int column_id) const;
+  // Adds the values inserted into the columns of a logical table to their statistics.
+  void addToColumnStatistics(const int table_id,
+                             const std::vector<int>& column_ids,
+                             const std::vector<DataBlockPtr>& data,
+                             const size_t num_rows);
+  // Drops the statistics of a logical table, e.g. when its rows are updated.
+  void removeColumnStatistics(const int table_id);
+
   std::vector<std::string> getTableDataDirectories(const TableDescriptor* td) const;
   std::vector<std::string> getTableDictDirectories(const TableDescriptor* td) const;
   std::string getColumnDictDirectory(const ColumnDescriptor* cd) const;
@@ -307,6 +333,15 @@ class Catalog final {
    */
   static const std::string getForeignServerSchema(bool if_not_exists = false);
 
+  /**
+   * Gets the DDL statement used to create the column statistics schema.
+   *
+   * @param if_not_exists - flag that indicates whether or not to include
+   * the "IF NOT EXISTS" phrase in the DDL statement
+   * @return string containing DDL statement
+   */
+  static const std::string getColumnStatisticsSchema(bool if_not_exists = false);
+
   /**
    * Creates a new foreign server DB object.
    *
@@ -466,6 +501,7 @@ class Catalog final {
   void updateLogicalToPhysicalTableLinkSchema();
   void updateLogicalToPhysicalTableMap(const int32_t logical_tb_id);
   void updateDictionarySchema();
+  void updateColumnStatisticsSchema();
   void updatePageSize();
   void updateDeletedColumnIndicator();
   void updateFrontendViewsToDashboards();
@@ -475,6 +511,10 @@ class Catalog final {
   void checkDateInDaysColumnMigration();
   void createDashboardSystemRoles();
   void buildMaps();
+  void buildColumnStatisticsMap();
+  void writeColumnStatisticsUnlocked(const int table_id,
+                                     const int column_id,
+                                     const ColumnStatistics& statistics);
   void addTableToMap(const TableDescriptor* td,
                      const std::list<ColumnDescriptor>& columns,
                      const std::list<DictDescriptor>& dicts);
@@ -534,6 +574,16 @@ class Catalog final {
   ForeignServerMap foreignServerMap_;
   ForeignServerMapById foreignServerMapById_;
 
+  // Copy of the tables and columns by id read without sharedMutex_. Dropped by every
+  // write lock and copied again by the first lookup after it, under the read lock.
+  // Accessed through std::atomic_load / std::atomic_store.
+  struct MetadataSnapshot {
+    TableDescriptorMapById tables;
+    ColumnDescriptorMapById columns;
+  };
+  mutable std::shared_ptr<const MetadataSnapshot> metadataSnapshot_;
+  std::shared_ptr<const MetadataSnapshot> getMetadataSnapshot() const;
+
   SqliteConnector sqliteConnector_;
   DBMetadata currentDB_;
   std::shared_ptr<Data_Namespace::DataMgr> dataMgr_;
@@ -555,8 +605,18 @@ class Catalog final {
       std::vector<std::pair<ColumnDescriptor*, ColumnDescriptor*>>;
   ColumnDescriptorsForRoll columnDescriptorsForRoll;
 
+  // Statistics of the columns of the logical tables keyed by table id and column id.
+  // Updates replace the statistics of a column so readers can keep the ones they got.
+  std::map<std::pair<int, int>, std::shared_ptr<const ColumnStatistics>>
+      columnStatisticsMap_;
+  mutable std::mutex columnStatisticsMutex_;
+
  private:
   static std::map<std::string, std::shared_ptr<Catalog>> mapd_cat_map_;
+  // guards mapd_cat_map_ and mapd_cat_load_mutexes_, held only for lookups
+  static std::mutex mapd_cat_map_mutex_;
+  // one catalog is built per database even when several threads ask for it at once
+  static std::map<std::string, std::shared_ptr<std::mutex>> mapd_cat_load_mutexes_;
   DeletedColumnPerTableMap deletedColumnPerTable_;
   void adjustAlteredTableFiles(
       const std::string& temp_data_dir,
@@ -593,6 +653,9 @@ class Catalog final {
   mutable std::atomic<std::thread::id> thread_holding_write_lock;
   // assuming that you never call into a catalog from another catalog via the same thread
   static thread_local bool thread_holds_read_lock;
+
+  // called with the write lock held, before the maps change
+  void resetMetadataSnapshot() const;
 };
 
 }  // namespace Catalog_Namespace
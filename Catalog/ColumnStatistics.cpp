@@ -0,0 +1,305 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ColumnStatistics.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/ExtractFromTime.h"
+#include "QueryEngine/HyperLogLog.h"
+#include "QueryEngine/HyperLogLogRank.h"
+#include "QueryEngine/MurmurHash.h"
+#include "Shared/InlineNullValues.h"
+
+namespace {
+
+constexpr size_t kSampleSize{1 << 16};
+
+// How the values of a column are laid out in a buffer.
+struct ValueLayout {
+  size_t width;
+  bool is_fp;
+  bool is_unsigned;
+  int64_t null_val;
+  int64_t multiplier;
+};
+
+// Layout of the values in the chunks of a column.
+ValueLayout get_chunk_layout(const SQLTypeInfo& ti) {
+  if (ti.is_fp()) {
+    return {static_cast<size_t>(ti.get_size()), true, false, 0, 1};
+  }
+  switch (ti.get_compression()) {
+    case kENCODING_DICT:
+      return {static_cast<size_t>(ti.get_size()),
+              false,
+              ti.get_size() < 4,
+              inline_fixed_encoding_null_val(ti),
+              1};
+    case kENCODING_DATE_IN_DAYS:
+      return {ti.get_comp_param() == 16 ? size_t(2) : size_t(4),
+              false,
+              false,
+              inline_fixed_encoding_null_val(ti),
+              kSecsPerDay};
+    case kENCODING_FIXED:
+      return {static_cast<size_t>(ti.get_comp_param() / 8),
+              false,
+              false,
+              inline_fixed_encoding_null_val(ti),
+              1};
+    default:
+      return {
+          static_cast<size_t>(ti.get_size()), false, false, inline_int_null_val(ti), 1};
+  }
+}
+
+// Layout of the values in the insert data blocks of a column, which are encoded by the
+// chunks but dictionary encoded strings.
+ValueLayout get_insert_layout(const SQLTypeInfo& ti) {
+  if (ti.is_fp() || ti.get_compression() == kENCODING_DICT) {
+    return get_chunk_layout(ti);
+  }
+  const auto logical_ti = get_logical_type_info(ti);
+  return {static_cast<size_t>(logical_ti.get_size()),
+          false,
+          false,
+          inline_int_null_val(logical_ti),
+          1};
+}
+
+template <typename T>
+T read_value(const int8_t* data, const size_t idx) {
+  T value;
+  std::memcpy(&value, data + idx * sizeof(T), sizeof(T));
+  return value;
+}
+
+int64_t read_int_value(const int8_t* data, const size_t idx, const ValueLayout& layout) {
+  switch (layout.width) {
+    case 1:
+      return layout.is_unsigned ? read_value<uint8_t>(data, idx)
+                                : read_value<int8_t>(data, idx);
+    case 2:
+      return layout.is_unsigned ? read_value<uint16_t>(data, idx)
+                                : read_value<int16_t>(data, idx);
+    case 4:
+      return read_value<int32_t>(data, idx);
+    case 8:
+      return read_value<int64_t>(data, idx);
+    default:
+      UNREACHABLE() << "Unexpected value width " << layout.width;
+  }
+  return 0;
+}
+
+// Calls visitor with the hash and the value of the non null values, returns the number
+// of nulls.
+template <typename VISITOR>
+size_t visit_values(const int8_t* data,
+                    const size_t count,
+                    const int8_t* deleted,
+                    const ValueLayout& layout,
+                    VISITOR visitor) {
+  size_t null_count{0};
+  for (size_t i = 0; i < count; ++i) {
+    if (deleted && deleted[i]) {
+      continue;
+    }
+    if (layout.is_fp) {
+      const double value = layout.width == sizeof(float)
+                               ? read_value<float>(data, i)
+                               : read_value<double>(data, i);
+      if (layout.width == sizeof(float) ? value == inline_fp_null_value<float>()
+                                        : value == inline_fp_null_value<double>()) {
+        ++null_count;
+        continue;
+      }
+      visitor(MurmurHash64A(&value, sizeof(value), 0), value);
+      continue;
+    }
+    const auto encoded_value = read_int_value(data, i, layout);
+    if (encoded_value == layout.null_val) {
+      ++null_count;
+      continue;
+    }
+    const int64_t value = encoded_value * layout.multiplier;
+    visitor(MurmurHash64A(&value, sizeof(value), 0), static_cast<double>(value));
+  }
+  return null_count;
+}
+
+void add_to_sketch(std::vector<uint8_t>& sketch, const uint64_t hash) {
+  constexpr auto b = ColumnStatistics::kSketchBits;
+  const uint32_t index = hash >> (64 - b);
+  const uint8_t rank = get_rank(hash << b, 64 - b);
+  sketch[index] = std::max(sketch[index], rank);
+}
+
+}  // namespace
+
+bool ColumnStatistics::isSupported(const SQLTypeInfo& ti) {
+  if (ti.is_string()) {
+    return ti.get_compression() == kENCODING_DICT;
+  }
+  return ti.is_integer() || ti.is_decimal() || ti.is_time() || ti.is_boolean() ||
+         ti.is_fp();
+}
+
+size_t ColumnStatistics::getNdv() const {
+  if (ndv_sketch.empty() || row_count == null_count) {
+    return 0;
+  }
+  const auto ndv = hll_size(ndv_sketch.data(), kSketchBits);
+  return std::min(std::max(ndv, size_t(1)), static_cast<size_t>(row_count - null_count));
+}
+
+double ColumnStatistics::getNullFraction() const {
+  return row_count ? static_cast<double>(null_count) / row_count : 0.;
+}
+
+double ColumnStatistics::getFractionBelow(const double value) const {
+  if (histogram_bounds.size() < 2) {
+    return 0.5;
+  }
+  if (value <= histogram_bounds.front()) {
+    return 0.;
+  }
+  if (value > histogram_bounds.back()) {
+    return 1.;
+  }
+  const auto it =
+      std::lower_bound(histogram_bounds.begin(), histogram_bounds.end(), value);
+  CHECK(it != histogram_bounds.begin() && it != histogram_bounds.end());
+  const size_t bucket = it - histogram_bounds.begin() - 1;
+  const auto lower = *(it - 1);
+  const auto upper = *it;
+  const double in_bucket = upper > lower ? (value - lower) / (upper - lower) : 0.;
+  return (bucket + in_bucket) / (histogram_bounds.size() - 1);
+}
+
+void ColumnStatistics::addInsertValues(const SQLTypeInfo& ti,
+                                       const int8_t* data,
+                                       const size_t count) {
+  if (ndv_sketch.empty()) {
+    ndv_sketch.resize(size_t(1) << kSketchBits);
+  }
+  const auto inserted_null_count = visit_values(
+      data, count, nullptr, get_insert_layout(ti), [this](uint64_t hash, double value) {
+        add_to_sketch(ndv_sketch, hash);
+        if (histogram_bounds.empty()) {
+          histogram_bounds.assign(kHistogramBuckets + 1, value);
+        }
+        histogram_bounds.front() = std::min(histogram_bounds.front(), value);
+        histogram_bounds.back() = std::max(histogram_bounds.back(), value);
+      });
+  row_count += count;
+  null_count += inserted_null_count;
+}
+
+std::string ColumnStatistics::serializeSketch() const {
+  std::ostringstream oss;
+  oss << std::hex << std::setfill('0');
+  for (const auto reg : ndv_sketch) {
+    oss << std::setw(2) << static_cast<int>(reg);
+  }
+  return oss.str();
+}
+
+std::string ColumnStatistics::serializeHistogram() const {
+  std::ostringstream oss;
+  oss << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for (size_t i = 0; i < histogram_bounds.size(); ++i) {
+    oss << (i ? "," : "") << histogram_bounds[i];
+  }
+  return oss.str();
+}
+
+void ColumnStatistics::deserializeSketch(const std::string& str) {
+  CHECK_EQ(str.size() % 2, size_t(0));
+  ndv_sketch.clear();
+  for (size_t i = 0; i < str.size(); i += 2) {
+    ndv_sketch.push_back(std::stoi(str.substr(i, 2), nullptr, 16));
+  }
+}
+
+void ColumnStatistics::deserializeHistogram(const std::string& str) {
+  histogram_bounds.clear();
+  if (str.empty()) {
+    return;
+  }
+  std::vector<std::string> bounds;
+  boost::split(bounds, str, boost::is_any_of(","));
+  for (const auto& bound : bounds) {
+    histogram_bounds.push_back(std::stod(bound));
+  }
+}
+
+ColumnStatisticsBuilder::ColumnStatisticsBuilder(const SQLTypeInfo& ti)
+    : ti_(ti)
+    , min_(std::numeric_limits<double>::max())
+    , max_(std::numeric_limits<double>::lowest())
+    , generator_(0) {
+  CHECK(ColumnStatistics::isSupported(ti));
+  statistics_.ndv_sketch.resize(size_t(1) << ColumnStatistics::kSketchBits);
+}
+
+void ColumnStatisticsBuilder::addChunkValues(const int8_t* data,
+                                             const size_t count,
+                                             const int8_t* deleted) {
+  size_t deleted_count{0};
+  if (deleted) {
+    deleted_count = std::count_if(deleted, deleted + count, [](int8_t d) { return d; });
+  }
+  const auto null_count = visit_values(
+      data, count, deleted, get_chunk_layout(ti_), [this](uint64_t hash, double value) {
+        add_to_sketch(statistics_.ndv_sketch, hash);
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+        ++sampled_count_;
+        if (sample_.size() < kSampleSize) {
+          sample_.push_back(value);
+          return;
+        }
+        const auto idx = generator_() % sampled_count_;
+        if (idx < kSampleSize) {
+          sample_[idx] = value;
+        }
+      });
+  statistics_.row_count += count - deleted_count;
+  statistics_.null_count += null_count;
+}
+
+ColumnStatistics ColumnStatisticsBuilder::build() {
+  if (!sample_.empty()) {
+    std::sort(sample_.begin(), sample_.end());
+    constexpr auto buckets = ColumnStatistics::kHistogramBuckets;
+    auto& bounds = statistics_.histogram_bounds;
+    bounds.push_back(min_);
+    for (size_t i = 1; i < buckets; ++i) {
+      bounds.push_back(sample_[i * sample_.size() / buckets]);
+    }
+    bounds.push_back(max_);
+  }
+  return statistics_;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Shared/sqltypes.h"
+
+/**
+ * Statistics of the values of a column computed by ANALYZE TABLE: the number of rows and
+ * nulls, a HyperLogLog sketch of the distinct values and the bounds of an equi-depth
+ * histogram. Only columns of fixed width numeric, time, boolean and dictionary encoded
+ * string types have statistics. Values are in the representation of the chunk
+ * statistics, e.g. seconds for dates, unscaled integers for decimals and string ids.
+ *
+ * Inserts add their values to the counts and the sketch and widen the first and last
+ * buckets of the histogram to the new values, the inner bounds are only recomputed by
+ * ANALYZE TABLE.
+ */
+struct ColumnStatistics {
+  static constexpr size_t kSketchBits{11};
+  static constexpr size_t kHistogramBuckets{64};
+
+  int64_t row_count{0};
+  int64_t null_count{0};
+  // HyperLogLog registers of the non null values.
+  std::vector<uint8_t> ndv_sketch;
+  // kHistogramBuckets + 1 bounds, each bucket between two consecutive bounds holds the
+  // same number of non null values. Empty if all the values are null.
+  std::vector<double> histogram_bounds;
+
+  static bool isSupported(const SQLTypeInfo& ti);
+
+  size_t getNdv() const;
+
+  double getNullFraction() const;
+
+  // Estimated fraction of the non null values less than value.
+  double getFractionBelow(const double value) const;
+
+  // Adds the values of an insert data block of a column of type ti.
+  void addInsertValues(const SQLTypeInfo& ti, const int8_t* data, const size_t count);
+
+  std::string serializeSketch() const;
+  std::string serializeHistogram() const;
+  void deserializeSketch(const std::string& str);
+  void deserializeHistogram(const std::string& str);
+};
+
+// Computes the statistics of a column of type ti from the values of its chunks.
+class ColumnStatisticsBuilder {
+ public:
+  ColumnStatisticsBuilder(const SQLTypeInfo& ti);
+
+  // Adds the values of a chunk, skipping the rows set in deleted if not null.
+  void addChunkValues(const int8_t* data, const size_t count, const int8_t* deleted);
+
+  ColumnStatistics build();
+
+ private:
+  const SQLTypeInfo ti_;
+  ColumnStatistics statistics_;
+  double min_;
+  double max_;
+  // Reservoir sample of the non null values the histogram is built from.
+  std::vector<double> sample_;
+  size_t sampled_count_{0};
+  std::mt19937_64 generator_;
+};
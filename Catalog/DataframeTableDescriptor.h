@@ -56,6 +56,7 @@ struct DataframeTableDescriptor : TableDescriptor {
     nShards = td.nShards;
     shardedColumnId = td.shardedColumnId;
     sortedColumnId = td.sortedColumnId;
+    zorderColumnIds = td.zorderColumnIds;
     persistenceLevel = td.persistenceLevel;
     hasDeletedCol = td.hasDeletedCol;
     columnIdBySpi_ = td.columnIdBySpi_;
@@ -138,6 +138,24 @@ bool DdlCommandExecutor::isShowQueries() {
   return (ddl_command == "SHOW_QUERIES");
 }
 
+bool DdlCommandExecutor::isShowCodeCache() {
+  const auto& payload = ddl_query_["payload"].GetObject();
+  const auto& ddl_command = std::string_view(payload["command"].GetString());
+  return (ddl_command == "SHOW_CODE_CACHE");
+}
+
+bool DdlCommandExecutor::isShowQueryHistory() {
+  const auto& payload = ddl_query_["payload"].GetObject();
+  const auto& ddl_command = std::string_view(payload["command"].GetString());
+  return (ddl_command == "SHOW_QUERY_HISTORY");
+}
+
+bool DdlCommandExecutor::isShowLockContention() {
+  const auto& payload = ddl_query_["payload"].GetObject();
+  const auto& ddl_command = std::string_view(payload["command"].GetString());
+  return (ddl_command == "SHOW_LOCK_CONTENTION");
+}
+
 bool DdlCommandExecutor::isKillQuery() {
   const auto& payload = ddl_query_["payload"].GetObject();
   const auto& ddl_command = std::string_view(payload["command"].GetString());
@@ -200,6 +200,21 @@ class DdlCommandExecutor {
    */
   bool isShowQueries();
 
+  /**
+   * Returns true if this command is SHOW CODE CACHE
+   */
+  bool isShowCodeCache();
+
+  /**
+   * Returns true if this command is SHOW QUERY HISTORY
+   */
+  bool isShowQueryHistory();
+
+  /**
+   * Returns true if this command is SHOW LOCK CONTENTION
+   */
+  bool isShowLockContention();
+
   /**
    * Returns true if this command is KILL QUERY
    */
@@ -17,10 +17,31 @@
 #ifndef RW_LOCKS_H
 #define RW_LOCKS_H
 
+#include <string>
+#include <type_traits>
+
+#include "../Shared/LockContention.h"
 #include "../Shared/mapd_shared_mutex.h"
 
 namespace Catalog_Namespace {
 
+class SysCatalog;
+
+// The locks are profiled per catalog class, not per database.
+template <typename T>
+lock_contention::LockProfile& shared_mutex_profile() {
+  static auto& profile = lock_contention::get_profile(
+      std::is_same<T, SysCatalog>::value ? "syscatalog" : "catalog");
+  return profile;
+}
+
+template <typename T>
+lock_contention::LockProfile& sqlite_mutex_profile() {
+  static auto& profile = lock_contention::get_profile(
+      std::is_same<T, SysCatalog>::value ? "syscatalog_sqlite" : "catalog_sqlite");
+  return profile;
+}
+
 /*
  *  The locking sequence for the locks below is as follows:
  *
@@ -37,6 +58,7 @@ template <typename T>
 class read_lock {
   const T* catalog;
   mapd_shared_lock<mapd_shared_mutex> lock;
+  lock_contention::HoldTimer hold_timer;
   bool holds_lock;
 
   template <typename inner_type>
@@ -44,7 +66,8 @@ class read_lock {
     std::thread::id tid = std::this_thread::get_id();
 
     if (cat->thread_holding_write_lock != tid && !inner_type::thread_holds_read_lock) {
-      lock = mapd_shared_lock<mapd_shared_mutex>(cat->sharedMutex_);
+      lock = mapd_shared_lock<mapd_shared_mutex>(cat->sharedMutex_, std::defer_lock);
+      lock_contention::lock(lock, shared_mutex_profile<inner_type>(), hold_timer);
       inner_type::thread_holds_read_lock = true;
       holds_lock = true;
     }
@@ -58,6 +81,7 @@ class read_lock {
   void unlock() {
     if (holds_lock) {
       T::thread_holds_read_lock = false;
+      hold_timer.stop();
       lock.unlock();
       holds_lock = false;
     }
@@ -71,6 +95,7 @@ class sqlite_lock {
   read_lock<T> cat_read_lock;
   const T* catalog;
   std::unique_lock<std::mutex> lock;
+  lock_contention::HoldTimer hold_timer;
   bool holds_lock;
 
   template <typename inner_type>
@@ -78,7 +103,8 @@ class sqlite_lock {
     std::thread::id tid = std::this_thread::get_id();
 
     if (cat->thread_holding_sqlite_lock != tid) {
-      lock = std::unique_lock<std::mutex>(cat->sqliteMutex_);
+      lock = std::unique_lock<std::mutex>(cat->sqliteMutex_, std::defer_lock);
+      lock_contention::lock(lock, sqlite_mutex_profile<inner_type>(), hold_timer);
       cat->thread_holding_sqlite_lock = tid;
       holds_lock = true;
     }
@@ -95,6 +121,7 @@ class sqlite_lock {
     if (holds_lock) {
       std::thread::id no_thread;
       catalog->thread_holding_sqlite_lock = no_thread;
+      hold_timer.stop();
       lock.unlock();
       cat_read_lock.unlock();
       holds_lock = false;
@@ -106,6 +133,7 @@ template <typename T>
 class write_lock {
   const T* catalog;
   mapd_unique_lock<mapd_shared_mutex> lock;
+  lock_contention::HoldTimer hold_timer;
   bool holds_lock;
 
   template <typename inner_type>
@@ -113,7 +141,8 @@ class write_lock {
     std::thread::id tid = std::this_thread::get_id();
 
     if (cat->thread_holding_write_lock != tid) {
-      lock = mapd_unique_lock<mapd_shared_mutex>(cat->sharedMutex_);
+      lock = mapd_unique_lock<mapd_shared_mutex>(cat->sharedMutex_, std::defer_lock);
+      lock_contention::lock(lock, shared_mutex_profile<inner_type>(), hold_timer);
       cat->thread_holding_write_lock = tid;
       holds_lock = true;
     }
@@ -128,6 +157,7 @@ class write_lock {
     if (holds_lock) {
       std::thread::id no_thread;
       catalog->thread_holding_write_lock = no_thread;
+      hold_timer.stop();
       lock.unlock();
       holds_lock = false;
     }
@@ -60,6 +60,7 @@ class SessionInfo {
       : catalog_(s.catalog_)
       , currentUser_(s.currentUser_)
       , executor_device_type_(static_cast<ExecutorDeviceType>(s.executor_device_type_))
+      , compressed_columns_(static_cast<bool>(s.compressed_columns_))
       , session_id_(s.session_id_)
       , public_session_id_(s.public_session_id_) {}
   Catalog& getCatalog() const { return *catalog_; }
@@ -70,6 +71,8 @@ class SessionInfo {
     return executor_device_type_;
   }
   void set_executor_device_type(ExecutorDeviceType t) { executor_device_type_ = t; }
+  bool get_compressed_columns() const { return compressed_columns_; }
+  void set_compressed_columns(const bool compressed) { compressed_columns_ = compressed; }
   std::string get_session_id() const { return session_id_; }
   time_t get_last_used_time() const { return last_used_time_; }
   void update_last_used_time() { last_used_time_ = time(0); }
@@ -88,6 +91,8 @@ class SessionInfo {
   std::shared_ptr<Catalog> catalog_;
   UserMetadata currentUser_;
   std::atomic<ExecutorDeviceType> executor_device_type_;
+  // whether columnar results are sent as compressed buffers rather than thrift columns
+  std::atomic<bool> compressed_columns_{false};
   const std::string session_id_;
   std::atomic<time_t> last_used_time_;  // for tracking active session duration
   std::atomic<time_t> start_time_;      // for invalidating session after tolerance period
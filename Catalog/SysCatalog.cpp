@@ -24,8 +24,10 @@
 
 #include "SysCatalog.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <exception>
+#include <future>
 #include <list>
 #include <memory>
 #include <random>
@@ -45,6 +47,7 @@
 #include "../Shared/File.h"
 #include "../Shared/StringTransform.h"
 #include "../Shared/measure.h"
+#include "../Shared/thread_count.h"
 #include "MapDRelease.h"
 #include "RWLocks.h"
 #include "bcrypt.h"
@@ -59,6 +62,7 @@ using std::vector;
 using namespace std::string_literals;
 
 extern bool g_enable_fsi;
+bool g_enable_parallel_catalog_loading{true};
 
 namespace {
 
@@ -872,11 +876,29 @@ void SysCatalog::dropUser(const string& name) {
 }
 
 std::vector<std::shared_ptr<Catalog>> SysCatalog::getCatalogsForAllDbs() {
-  std::vector<std::shared_ptr<Catalog>> catalogs{};
-  const auto& db_metadata_list = getAllDBMetadata();
-  for (const auto& db_metadata : db_metadata_list) {
-    catalogs.emplace_back(Catalog::get(
-        basePath_, db_metadata, dataMgr_, string_dict_hosts_, calciteMgr_, false));
+  const auto db_metadata_list = getAllDBMetadata();
+  const std::vector<DBMetadata> dbs(db_metadata_list.begin(), db_metadata_list.end());
+  std::vector<std::shared_ptr<Catalog>> catalogs(dbs.size());
+  // Each catalog not loaded yet reads its own sqlite file, which is the bulk of the time
+  // on a server with many databases.
+  std::atomic<size_t> next_db{0};
+  auto load_catalogs = [&]() {
+    for (size_t i = next_db++; i < dbs.size(); i = next_db++) {
+      catalogs[i] = Catalog::get(
+          basePath_, dbs[i], dataMgr_, string_dict_hosts_, calciteMgr_, false);
+    }
+  };
+  const size_t thread_count =
+      g_enable_parallel_catalog_loading
+          ? std::min(dbs.size(), static_cast<size_t>(cpu_threads()))
+          : size_t(1);
+  std::vector<std::future<void>> loaders;
+  for (size_t i = 1; i < thread_count; ++i) {
+    loaders.emplace_back(std::async(std::launch::async, load_catalogs));
+  }
+  load_catalogs();
+  for (auto& loader : loaders) {
+    loader.get();
   }
   return catalogs;
 }
@@ -1079,6 +1101,7 @@ void SysCatalog::createDatabase(const string& name, int owner) {
         "frag_page_size integer, "
         "max_rows bigint, partitions text, shard_column_id integer, shard integer, "
         "sort_column_id integer default 0, storage_type text default '',"
+        "zorder_column_ids text default '',"
         "num_shards integer, key_metainfo TEXT, version_num "
         "BIGINT DEFAULT 1) ");
     dbConn->query(
@@ -1110,6 +1133,7 @@ void SysCatalog::createDatabase(const string& name, int owner) {
         "physical_table_id "
         "integer)");
     dbConn->query("CREATE TABLE mapd_record_ownership_marker (dummy integer)");
+    dbConn->query(Catalog::getColumnStatisticsSchema());
     dbConn->query_with_text_params(
         "INSERT INTO mapd_record_ownership_marker (dummy) VALUES (?1)",
         std::vector<std::string>{std::to_string(owner)});
@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "DataMgr/MemoryLevel.h"
 #include "Fragmenter/AbstractFragmenter.h"
@@ -65,6 +66,7 @@ struct TableDescriptor {
       nShards;  // # of shards, i.e. physical tables for this logical table (default: 0)
   int shardedColumnId;  // Id of the column to be sharded on
   int sortedColumnId;   // Id of the column to be sorted on
+  std::vector<int> zorderColumnIds;  // Ids of the columns the rows are z-ordered on
   Data_Namespace::MemoryLevel persistenceLevel;
   bool hasDeletedCol;  // Does table has a delete col, Yes (VACUUM = DELAYED)
                        //                              No  (VACUUM = IMMEDIATE)
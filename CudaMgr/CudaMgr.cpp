@@ -20,13 +20,123 @@
 #include <algorithm>
 #include <boost/stacktrace.hpp>
 #include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
 
 #include "Logger/Logger.h"
 
+size_t g_pinned_host_staging_pool_mb{0};
+bool g_enable_gpu_kernel_timing{false};
+
 namespace CudaMgr_Namespace {
 
+namespace {
+
+// Size of the pieces staged, large enough for the copies to run at full bandwidth.
+constexpr size_t kStagingBufferBytes{8 * 1024 * 1024};
+// The smaller copies are direct, staging them would cost more than it would save.
+constexpr size_t kMinStagedCopyBytes{1024 * 1024};
+
+struct PendingGpuWork {
+  GpuWorkType work_type;
+  CUevent start;
+  CUevent stop;
+};
+
+thread_local GpuTimings thread_gpu_timings;
+// the work timed by the thread the device may not be done with yet
+thread_local std::vector<PendingGpuWork> thread_pending_gpu_work;
+
+// The copies are timed on the host: they return once the host buffer can be reused,
+// which for the copies to and from pageable memory is once they are done.
+template <typename COPY>
+void time_copy(size_t GpuTimings::*bytes,
+               double GpuTimings::*ms,
+               const size_t num_bytes,
+               COPY copy) {
+  if (!g_enable_gpu_kernel_timing) {
+    copy();
+    return;
+  }
+  const auto clock_begin = std::chrono::steady_clock::now();
+  copy();
+  thread_gpu_timings.*bytes += num_bytes;
+  thread_gpu_timings.*ms += std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - clock_begin)
+                                .count();
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const GpuTimings& timings) {
+  return os << std::fixed << std::setprecision(3) << "init " << timings.init_ms
+            << " ms (" << timings.init_launches << "), kernels " << timings.kernel_ms
+            << " ms (" << timings.kernel_launches << "), reduction "
+            << timings.reduction_ms << " ms (" << timings.reduction_launches
+            << "), to device " << timings.host_to_device_bytes << " B in "
+            << timings.host_to_device_ms << " ms, to host "
+            << timings.device_to_host_bytes << " B in " << timings.device_to_host_ms
+            << " ms, between devices " << timings.device_to_device_bytes << " B in "
+            << timings.device_to_device_ms << " ms, copying "
+            << std::setprecision(0) << timings.copyFraction() * 100 << "%"
+            << std::defaultfloat;
+}
+
+GpuTimings read_thread_gpu_timings() {
+  for (const auto& work : thread_pending_gpu_work) {
+    float elapsed_ms{0};
+    if (cuEventSynchronize(work.stop) == CUDA_SUCCESS &&
+        cuEventElapsedTime(&elapsed_ms, work.start, work.stop) == CUDA_SUCCESS) {
+      switch (work.work_type) {
+        case GpuWorkType::Init:
+          ++thread_gpu_timings.init_launches;
+          thread_gpu_timings.init_ms += elapsed_ms;
+          break;
+        case GpuWorkType::Kernel:
+          ++thread_gpu_timings.kernel_launches;
+          thread_gpu_timings.kernel_ms += elapsed_ms;
+          break;
+        case GpuWorkType::Reduction:
+          ++thread_gpu_timings.reduction_launches;
+          thread_gpu_timings.reduction_ms += elapsed_ms;
+          break;
+      }
+    }
+    cuEventDestroy(work.start);
+    cuEventDestroy(work.stop);
+  }
+  thread_pending_gpu_work.clear();
+  return thread_gpu_timings;
+}
+
+GpuWorkTimer::GpuWorkTimer(const GpuWorkType work_type, CUstream stream)
+    : work_type_(work_type), stream_(stream) {
+  if (!g_enable_gpu_kernel_timing) {
+    return;
+  }
+  if (cuEventCreate(&start_, CU_EVENT_DEFAULT) != CUDA_SUCCESS) {
+    start_ = nullptr;
+    return;
+  }
+  cuEventRecord(start_, stream_);
+}
+
+GpuWorkTimer::~GpuWorkTimer() {
+  if (!start_) {
+    return;
+  }
+  CUevent stop;
+  if (cuEventCreate(&stop, CU_EVENT_DEFAULT) != CUDA_SUCCESS) {
+    cuEventDestroy(start_);
+    return;
+  }
+  cuEventRecord(stop, stream_);
+  thread_pending_gpu_work.push_back({work_type_, start_, stop});
+}
+
 CudaErrorException::CudaErrorException(CUresult status)
     : std::runtime_error(errorMessage(status)), status_(status) {
   // cuda already de-initialized can occur during system shutdown. avoid making calls to
@@ -85,6 +195,7 @@ CudaMgr::~CudaMgr() {
     std::lock_guard<std::mutex> gpu_lock(device_cleanup_mutex_);
 
     synchronizeDevices();
+    destroyStagingPool();
     for (int d = 0; d < device_count_; ++d) {
       checkError(cuCtxDestroy(device_contexts_[d]));
     }
@@ -110,18 +221,134 @@ void CudaMgr::copyHostToDevice(int8_t* device_ptr,
                                const int8_t* host_ptr,
                                const size_t num_bytes,
                                const int device_num) {
-  setContext(device_num);
-  checkError(
-      cuMemcpyHtoD(reinterpret_cast<CUdeviceptr>(device_ptr), host_ptr, num_bytes));
+  time_copy(&GpuTimings::host_to_device_bytes,
+            &GpuTimings::host_to_device_ms,
+            num_bytes,
+            [&] {
+              if (g_pinned_host_staging_pool_mb && num_bytes >= kMinStagedCopyBytes &&
+                  !isPinnedHostMem(host_ptr, num_bytes)) {
+                copyHostToDeviceStaged(device_ptr, host_ptr, num_bytes, device_num);
+                return;
+              }
+              setContext(device_num);
+              checkError(cuMemcpyHtoD(
+                  reinterpret_cast<CUdeviceptr>(device_ptr), host_ptr, num_bytes));
+            });
+}
+
+bool CudaMgr::isPinnedHostMem(const int8_t* host_ptr, const size_t num_bytes) const {
+  std::lock_guard<std::mutex> pinned_host_mem_lock(pinned_host_mem_mutex_);
+  auto it = pinned_host_mem_.upper_bound(host_ptr);
+  if (it == pinned_host_mem_.begin()) {
+    return false;
+  }
+  --it;
+  return host_ptr + num_bytes <= it->first + it->second;
+}
+
+// The copy of a piece to the device overlaps with the copy of the next piece to the
+// other staging buffer, a staging buffer is only reused once the stream it was copied
+// on is done with it.
+void CudaMgr::copyHostToDeviceStaged(int8_t* device_ptr,
+                                     const int8_t* host_ptr,
+                                     const size_t num_bytes,
+                                     const int device_num) {
+  const auto buffer_ids = acquireStagingBuffers();
+  std::vector<CUstream> streams;
+  try {
+    setContext(device_num);
+    for (const auto buffer_id : buffer_ids) {
+      auto& stream = staging_buffers_[buffer_id].streams[device_num];
+      if (!stream) {
+        checkError(cuStreamCreate(&stream, CU_STREAM_DEFAULT));
+      }
+      streams.push_back(stream);
+    }
+    for (size_t offset = 0, piece = 0; offset < num_bytes;
+         offset += kStagingBufferBytes, ++piece) {
+      const auto piece_bytes = std::min(kStagingBufferBytes, num_bytes - offset);
+      const auto buffer_idx = piece % buffer_ids.size();
+      const auto staging_ptr = staging_buffers_[buffer_ids[buffer_idx]].host_ptr;
+      checkError(cuStreamSynchronize(streams[buffer_idx]));
+      std::memcpy(staging_ptr, host_ptr + offset, piece_bytes);
+      checkError(cuMemcpyHtoDAsync(reinterpret_cast<CUdeviceptr>(device_ptr + offset),
+                                   staging_ptr,
+                                   piece_bytes,
+                                   streams[buffer_idx]));
+    }
+    for (const auto stream : streams) {
+      checkError(cuStreamSynchronize(stream));
+    }
+  } catch (...) {
+    for (const auto stream : streams) {
+      cuStreamSynchronize(stream);
+    }
+    releaseStagingBuffers(buffer_ids);
+    throw;
+  }
+  releaseStagingBuffers(buffer_ids);
+}
+
+// Takes two staging buffers, or one when the others are in use, waiting for one when
+// they all are. The pool is allocated by the first copy staged.
+std::vector<size_t> CudaMgr::acquireStagingBuffers() {
+  std::unique_lock<std::mutex> staging_pool_lock(staging_pool_mutex_);
+  if (staging_buffers_.empty()) {
+    const auto num_buffers = std::max(
+        size_t(2), g_pinned_host_staging_pool_mb * 1024 * 1024 / kStagingBufferBytes);
+    for (size_t i = 0; i < num_buffers; ++i) {
+      staging_buffers_.push_back(
+          {allocatePinnedHostMem(kStagingBufferBytes),
+           std::vector<CUstream>(static_cast<size_t>(device_count_), nullptr)});
+      free_staging_buffers_.push_back(i);
+    }
+    LOG(INFO) << "Allocated a pinned host staging pool of " << num_buffers
+              << " buffers of " << kStagingBufferBytes / (1024 * 1024) << " MB";
+  }
+  staging_pool_cv_.wait(staging_pool_lock,
+                        [this] { return !free_staging_buffers_.empty(); });
+  std::vector<size_t> buffer_ids;
+  while (buffer_ids.size() < 2 && !free_staging_buffers_.empty()) {
+    buffer_ids.push_back(free_staging_buffers_.back());
+    free_staging_buffers_.pop_back();
+  }
+  return buffer_ids;
+}
+
+void CudaMgr::releaseStagingBuffers(const std::vector<size_t>& buffer_ids) {
+  {
+    std::lock_guard<std::mutex> staging_pool_lock(staging_pool_mutex_);
+    free_staging_buffers_.insert(
+        free_staging_buffers_.end(), buffer_ids.begin(), buffer_ids.end());
+  }
+  staging_pool_cv_.notify_all();
+}
+
+void CudaMgr::destroyStagingPool() {
+  std::lock_guard<std::mutex> staging_pool_lock(staging_pool_mutex_);
+  for (auto& staging_buffer : staging_buffers_) {
+    for (int d = 0; d < device_count_; ++d) {
+      if (staging_buffer.streams[d]) {
+        setContext(d);
+        checkError(cuStreamDestroy(staging_buffer.streams[d]));
+      }
+    }
+    freePinnedHostMem(staging_buffer.host_ptr);
+  }
+  staging_buffers_.clear();
+  free_staging_buffers_.clear();
 }
 
 void CudaMgr::copyDeviceToHost(int8_t* host_ptr,
                                const int8_t* device_ptr,
                                const size_t num_bytes,
                                const int device_num) {
-  setContext(device_num);
-  checkError(
-      cuMemcpyDtoH(host_ptr, reinterpret_cast<const CUdeviceptr>(device_ptr), num_bytes));
+  time_copy(
+      &GpuTimings::device_to_host_bytes, &GpuTimings::device_to_host_ms, num_bytes, [&] {
+        setContext(device_num);
+        checkError(cuMemcpyDtoH(
+            host_ptr, reinterpret_cast<const CUdeviceptr>(device_ptr), num_bytes));
+      });
 }
 
 void CudaMgr::copyDeviceToDevice(int8_t* dest_ptr,
@@ -131,18 +358,24 @@ void CudaMgr::copyDeviceToDevice(int8_t* dest_ptr,
                                  const int src_device_num) {
   // dest_device_num and src_device_num are the device numbers relative to start_gpu_
   // (real_device_num - start_gpu_)
-  if (src_device_num == dest_device_num) {
-    setContext(src_device_num);
-    checkError(cuMemcpy(reinterpret_cast<CUdeviceptr>(dest_ptr),
-                        reinterpret_cast<CUdeviceptr>(src_ptr),
-                        num_bytes));
-  } else {
-    checkError(cuMemcpyPeer(reinterpret_cast<CUdeviceptr>(dest_ptr),
-                            device_contexts_[dest_device_num],
-                            reinterpret_cast<CUdeviceptr>(src_ptr),
-                            device_contexts_[src_device_num],
-                            num_bytes));  // will we always have peer?
-  }
+  time_copy(&GpuTimings::device_to_device_bytes,
+            &GpuTimings::device_to_device_ms,
+            num_bytes,
+            [&] {
+              if (src_device_num == dest_device_num) {
+                setContext(src_device_num);
+                checkError(cuMemcpy(reinterpret_cast<CUdeviceptr>(dest_ptr),
+                                    reinterpret_cast<CUdeviceptr>(src_ptr),
+                                    num_bytes));
+              } else {
+                checkError(
+                    cuMemcpyPeer(reinterpret_cast<CUdeviceptr>(dest_ptr),
+                                 device_contexts_[dest_device_num],
+                                 reinterpret_cast<CUdeviceptr>(src_ptr),
+                                 device_contexts_[src_device_num],
+                                 num_bytes));  // will we always have peer?
+              }
+            });
 }
 
 void CudaMgr::loadGpuModuleData(CUmodule* module,
@@ -247,6 +480,8 @@ int8_t* CudaMgr::allocatePinnedHostMem(const size_t num_bytes) {
   setContext(0);
   void* host_ptr;
   checkError(cuMemHostAlloc(&host_ptr, num_bytes, CU_MEMHOSTALLOC_PORTABLE));
+  std::lock_guard<std::mutex> pinned_host_mem_lock(pinned_host_mem_mutex_);
+  pinned_host_mem_[reinterpret_cast<int8_t*>(host_ptr)] = num_bytes;
   return reinterpret_cast<int8_t*>(host_ptr);
 }
 
@@ -257,10 +492,43 @@ int8_t* CudaMgr::allocateDeviceMem(const size_t num_bytes, const int device_num)
   return reinterpret_cast<int8_t*>(device_ptr);
 }
 
+int8_t* CudaMgr::allocateManagedMem(const size_t num_bytes, const int device_num) {
+  setContext(device_num);
+  const auto device = getDeviceProperties(device_num)->device;
+  CUdeviceptr managed_ptr;
+  checkError(cuMemAllocManaged(&managed_ptr, num_bytes, CU_MEM_ATTACH_GLOBAL));
+  checkError(cuMemAdvise(
+      managed_ptr, num_bytes, CU_MEM_ADVISE_SET_PREFERRED_LOCATION, device));
+  checkError(cuMemAdvise(managed_ptr, num_bytes, CU_MEM_ADVISE_SET_ACCESSED_BY, device));
+  // the pages which don't fit are left on the host and migrated on access
+  checkError(cuMemPrefetchAsync(managed_ptr, num_bytes, device, 0));
+  return reinterpret_cast<int8_t*>(managed_ptr);
+}
+
 void CudaMgr::freePinnedHostMem(int8_t* host_ptr) {
+  {
+    std::lock_guard<std::mutex> pinned_host_mem_lock(pinned_host_mem_mutex_);
+    pinned_host_mem_.erase(host_ptr);
+  }
   checkError(cuMemFreeHost(reinterpret_cast<void*>(host_ptr)));
 }
 
+void CudaMgr::registerHostMem(int8_t* host_ptr, const size_t num_bytes) {
+  setContext(0);
+  checkError(cuMemHostRegister(host_ptr, num_bytes, CU_MEMHOSTREGISTER_PORTABLE));
+  std::lock_guard<std::mutex> pinned_host_mem_lock(pinned_host_mem_mutex_);
+  pinned_host_mem_[host_ptr] = num_bytes;
+}
+
+void CudaMgr::unregisterHostMem(int8_t* host_ptr) {
+  {
+    std::lock_guard<std::mutex> pinned_host_mem_lock(pinned_host_mem_mutex_);
+    pinned_host_mem_.erase(host_ptr);
+  }
+  setContext(0);
+  checkError(cuMemHostUnregister(host_ptr));
+}
+
 void CudaMgr::freeDeviceMem(int8_t* device_ptr) {
   std::lock_guard<std::mutex> gpu_lock(device_cleanup_mutex_);
 
@@ -359,6 +627,41 @@ void CudaMgr::createDeviceContexts() {
   }
 }
 
+size_t CudaMgr::enablePeerAccess() {
+  size_t num_pairs{0};
+  peer_access_.assign(device_count_, std::vector<bool>(device_count_, false));
+  for (int d = 0; d < device_count_; ++d) {
+    for (int peer = 0; peer < device_count_; ++peer) {
+      if (peer == d) {
+        continue;
+      }
+      int can_access_peer{0};
+      checkError(cuDeviceCanAccessPeer(&can_access_peer,
+                                       device_properties_[d].device,
+                                       device_properties_[peer].device));
+      if (!can_access_peer) {
+        continue;
+      }
+      setContext(d);
+      const auto status = cuCtxEnablePeerAccess(device_contexts_[peer], 0);
+      if (status != CUDA_SUCCESS && status != CUDA_ERROR_PEER_ACCESS_ALREADY_ENABLED) {
+        LOG(WARNING) << "Could not enable the peer access of device " << d
+                     << " to device " << peer << ": " << errorMessage(status);
+        continue;
+      }
+      peer_access_[d][peer] = true;
+      ++num_pairs;
+    }
+  }
+  LOG(INFO) << "Enabled peer access between " << num_pairs << " pairs of GPUs";
+  return num_pairs;
+}
+
+bool CudaMgr::canAccessPeer(const int device_num, const int peer_device_num) const {
+  return static_cast<size_t>(device_num) < peer_access_.size() &&
+         peer_access_[device_num][peer_device_num];
+}
+
 void CudaMgr::setContext(const int device_num) const {
   // deviceNum is the device number relative to startGpu (realDeviceNum - startGpu_)
   CHECK_LT(device_num, device_count_);
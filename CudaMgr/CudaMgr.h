@@ -15,8 +15,11 @@
  */
 #pragma once
 
+#include <condition_variable>
 #include <cstdlib>
+#include <map>
 #include <mutex>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -29,6 +32,9 @@
 #include "Shared/nocuda.h"
 #endif  // HAVE_CUDA
 
+extern size_t g_pinned_host_staging_pool_mb;
+extern bool g_enable_gpu_kernel_timing;
+
 namespace CudaMgr_Namespace {
 
 enum class NvidiaDeviceArch {
@@ -77,6 +83,92 @@ struct DeviceProperties {
   int numCore;
 };
 
+// The device time of the kernels a thread launched, measured with CUDA events, and the
+// copies it made, with g_enable_gpu_kernel_timing.
+struct GpuTimings {
+  // group by buffer initialization
+  size_t init_launches{0};
+  double init_ms{0};
+  // query kernels
+  size_t kernel_launches{0};
+  double kernel_ms{0};
+  // reduction of the group by buffers of the devices
+  size_t reduction_launches{0};
+  double reduction_ms{0};
+  size_t host_to_device_bytes{0};
+  double host_to_device_ms{0};
+  size_t device_to_host_bytes{0};
+  double device_to_host_ms{0};
+  size_t device_to_device_bytes{0};
+  double device_to_device_ms{0};
+
+  GpuTimings& operator+=(const GpuTimings& other) {
+    init_launches += other.init_launches;
+    init_ms += other.init_ms;
+    kernel_launches += other.kernel_launches;
+    kernel_ms += other.kernel_ms;
+    reduction_launches += other.reduction_launches;
+    reduction_ms += other.reduction_ms;
+    host_to_device_bytes += other.host_to_device_bytes;
+    host_to_device_ms += other.host_to_device_ms;
+    device_to_host_bytes += other.device_to_host_bytes;
+    device_to_host_ms += other.device_to_host_ms;
+    device_to_device_bytes += other.device_to_device_bytes;
+    device_to_device_ms += other.device_to_device_ms;
+    return *this;
+  }
+
+  GpuTimings operator-(const GpuTimings& other) const {
+    GpuTimings difference;
+    difference.init_launches = init_launches - other.init_launches;
+    difference.init_ms = init_ms - other.init_ms;
+    difference.kernel_launches = kernel_launches - other.kernel_launches;
+    difference.kernel_ms = kernel_ms - other.kernel_ms;
+    difference.reduction_launches = reduction_launches - other.reduction_launches;
+    difference.reduction_ms = reduction_ms - other.reduction_ms;
+    difference.host_to_device_bytes = host_to_device_bytes - other.host_to_device_bytes;
+    difference.host_to_device_ms = host_to_device_ms - other.host_to_device_ms;
+    difference.device_to_host_bytes = device_to_host_bytes - other.device_to_host_bytes;
+    difference.device_to_host_ms = device_to_host_ms - other.device_to_host_ms;
+    difference.device_to_device_bytes =
+        device_to_device_bytes - other.device_to_device_bytes;
+    difference.device_to_device_ms = device_to_device_ms - other.device_to_device_ms;
+    return difference;
+  }
+
+  // Time spent copying over all the time on the device, high for the queries bound by
+  // the transfers rather than by the kernels.
+  double copyFraction() const {
+    const auto copy_ms = host_to_device_ms + device_to_host_ms + device_to_device_ms;
+    const auto total_ms = copy_ms + init_ms + kernel_ms + reduction_ms;
+    return total_ms > 0 ? copy_ms / total_ms : 0;
+  }
+};
+
+std::ostream& operator<<(std::ostream& os, const GpuTimings& timings);
+
+// The timings of the calling thread since it started, once the device is done with the
+// work it timed.
+GpuTimings read_thread_gpu_timings();
+
+enum class GpuWorkType { Init, Kernel, Reduction };
+
+#ifdef HAVE_CUDA
+// Records CUDA events on `stream` around the work queued on it in the scope, with
+// g_enable_gpu_kernel_timing. The events are only waited for when the timings of the
+// thread are read, so timing doesn't synchronize the stream.
+class GpuWorkTimer {
+ public:
+  GpuWorkTimer(const GpuWorkType work_type, CUstream stream);
+  ~GpuWorkTimer();
+
+ private:
+  const GpuWorkType work_type_;
+  CUstream stream_;
+  CUevent start_{nullptr};
+};
+#endif
+
 class CudaMgr {
  public:
   CudaMgr(const int num_gpus, const int start_gpu = 0);
@@ -87,6 +179,8 @@ class CudaMgr {
   int getStartGpu() const { return start_gpu_; }
   const omnisci::DeviceGroup& getDeviceGroup() const { return device_group_; }
 
+  // Copies from pageable host memory go through the pinned staging pool when it is
+  // enabled, the copies from pinned or registered host memory are direct.
   void copyHostToDevice(int8_t* device_ptr,
                         const int8_t* host_ptr,
                         const size_t num_bytes,
@@ -101,9 +195,20 @@ class CudaMgr {
                           const int dest_device_num,
                           const int src_device_num);
 
+  // Lets every device read and copy from the memory of the devices it can reach
+  // directly, through NVLink or PCIe, and returns the number of pairs enabled.
+  size_t enablePeerAccess();
+  bool canAccessPeer(const int device_num, const int peer_device_num) const;
+
   int8_t* allocatePinnedHostMem(const size_t num_bytes);
   int8_t* allocateDeviceMem(const size_t num_bytes, const int device_num);
+  // Unified memory the device can oversubscribe, preferably resident on it and
+  // prefetched there. Freed by freeDeviceMem.
+  int8_t* allocateManagedMem(const size_t num_bytes, const int device_num);
   void freePinnedHostMem(int8_t* host_ptr);
+  // Pins host memory allocated elsewhere, it is unregistered before it is freed.
+  void registerHostMem(int8_t* host_ptr, const size_t num_bytes);
+  void unregisterHostMem(int8_t* host_ptr);
   void freeDeviceMem(int8_t* device_ptr);
   void zeroDeviceMem(int8_t* device_ptr, const size_t num_bytes, const int device_num);
   void setDeviceMem(int8_t* device_ptr,
@@ -230,9 +335,37 @@ class CudaMgr {
   size_t computeMinNumMPsForAllDevices() const;
   void checkError(CUresult cu_result) const;
 
+  bool isPinnedHostMem(const int8_t* host_ptr, const size_t num_bytes) const;
+  void copyHostToDeviceStaged(int8_t* device_ptr,
+                              const int8_t* host_ptr,
+                              const size_t num_bytes,
+                              const int device_num);
+  std::vector<size_t> acquireStagingBuffers();
+  void releaseStagingBuffers(const std::vector<size_t>& buffer_ids);
+  void destroyStagingPool();
+
   int gpu_driver_version_;
+
+  // A pinned host buffer the pageable host memory is copied to, piece by piece, before
+  // it is copied to a device on the stream of the buffer for the device.
+  struct StagingBuffer {
+    int8_t* host_ptr;
+    std::vector<CUstream> streams;
+  };
+
+  std::mutex staging_pool_mutex_;
+  std::condition_variable staging_pool_cv_;
+  std::vector<StagingBuffer> staging_buffers_;
+  std::vector<size_t> free_staging_buffers_;
+
+  // the host memory allocated pinned or registered, by start address
+  mutable std::mutex pinned_host_mem_mutex_;
+  std::map<const int8_t*, size_t> pinned_host_mem_;
 #endif
 
+  // the devices each device has peer access to, filled by enablePeerAccess()
+  std::vector<std::vector<bool>> peer_access_;
+
   int device_count_;
   int start_gpu_;
   size_t min_shared_memory_per_block_for_all_devices;
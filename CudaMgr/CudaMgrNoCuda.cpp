@@ -17,8 +17,19 @@
 #include "CudaMgr.h"
 #include "Logger/Logger.h"
 
+size_t g_pinned_host_staging_pool_mb{0};
+bool g_enable_gpu_kernel_timing{false};
+
 namespace CudaMgr_Namespace {
 
+std::ostream& operator<<(std::ostream& os, const GpuTimings& timings) {
+  return os;
+}
+
+GpuTimings read_thread_gpu_timings() {
+  return {};
+}
+
 CudaMgr::CudaMgr(const int, const int) : device_count_(-1), start_gpu_(-1) {
   CHECK(false);
 }
@@ -49,6 +60,15 @@ void CudaMgr::copyDeviceToDevice(int8_t* dest_ptr,
   CHECK(false);
 }
 
+size_t CudaMgr::enablePeerAccess() {
+  CHECK(false);
+  return 0;
+}
+bool CudaMgr::canAccessPeer(const int device_num, const int peer_device_num) const {
+  CHECK(false);
+  return false;
+}
+
 int8_t* CudaMgr::allocatePinnedHostMem(const size_t num_bytes) {
   CHECK(false);
   return nullptr;
@@ -57,9 +77,19 @@ int8_t* CudaMgr::allocateDeviceMem(const size_t num_bytes, const int device_num)
   CHECK(false);
   return nullptr;
 }
+int8_t* CudaMgr::allocateManagedMem(const size_t num_bytes, const int device_num) {
+  CHECK(false);
+  return nullptr;
+}
 void CudaMgr::freePinnedHostMem(int8_t* host_ptr) {
   CHECK(false);
 }
+void CudaMgr::registerHostMem(int8_t* host_ptr, const size_t num_bytes) {
+  CHECK(false);
+}
+void CudaMgr::unregisterHostMem(int8_t* host_ptr) {
+  CHECK(false);
+}
 void CudaMgr::freeDeviceMem(int8_t* device_ptr) {
   CHECK(false);
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "DataMgr/DataMgr.h"
+#include "Shared/HugePages.h"
 #include "Shared/checked_alloc.h"
 
 template <class T>
@@ -32,9 +33,19 @@ class SysAllocator {
   template <class U>
   constexpr SysAllocator(const SysAllocator<U>&) noexcept {}
 
-  [[nodiscard]] T* allocate(size_t count) { return checked_malloc(count); }
+  // The large blocks, such as buffer pool slabs, are backed by huge pages if enabled.
+  [[nodiscard]] T* allocate(size_t count) {
+    if (auto ptr = huge_pages::allocate(count)) {
+      return ptr;
+    }
+    return checked_malloc(count);
+  }
 
-  void deallocate(T* p, size_t /* count */) { free(p); }
+  void deallocate(T* p, size_t /* count */) {
+    if (!huge_pages::deallocate(p)) {
+      free(p);
+    }
+  }
 
   friend bool operator==(Self const&, Self const&) noexcept { return true; }
   friend bool operator!=(Self const&, Self const&) noexcept { return false; }
@@ -31,8 +31,41 @@
 
 using namespace std;
 
+bool g_enable_buffer_pool_compaction{false};
+
 namespace Buffer_Namespace {
 
+const BufferMgr::PoolMetrics& BufferMgr::getPoolMetrics() {
+  std::call_once(pool_metrics_flag_, [this] {
+    auto& registry = metrics::Registry::instance();
+    const metrics::Labels labels{{"level", getStringMgrType()},
+                                 {"device", std::to_string(device_id_)}};
+    pool_metrics_.slab_allocations =
+        &registry.counter("omnisci_buffer_pool_slab_allocations_total",
+                          "Slabs allocated by the buffer pool.",
+                          labels);
+    pool_metrics_.allocations = &registry.counter(
+        "omnisci_buffer_pool_allocations_total", "Buffers created in the pool.", labels);
+    pool_metrics_.hits =
+        &registry.counter("omnisci_buffer_pool_hits_total",
+                          "Chunks requested from the pool which were resident.",
+                          labels);
+    pool_metrics_.misses =
+        &registry.counter("omnisci_buffer_pool_misses_total",
+                          "Chunks requested from the pool which had to be fetched.",
+                          labels);
+    pool_metrics_.pins = &registry.counter(
+        "omnisci_buffer_pool_pins_total", "Pins taken on resident buffers.", labels);
+    pool_metrics_.evictions = &registry.counter(
+        "omnisci_buffer_pool_evictions_total", "Chunks evicted from the pool.", labels);
+    pool_metrics_.evicted_bytes =
+        &registry.counter("omnisci_buffer_pool_evicted_bytes_total",
+                          "Bytes of the chunks evicted from the pool.",
+                          labels);
+  });
+  return pool_metrics_;
+}
+
 std::string BufferMgr::keyToString(const ChunkKey& key) {
   std::ostringstream oss;
 
@@ -59,7 +92,8 @@ BufferMgr::BufferMgr(const int device_id,
     , allocations_capped_(false)
     , parent_mgr_(parent_mgr)
     , max_buffer_id_(0)
-    , buffer_epoch_(0) {
+    , buffer_epoch_(0)
+    , eviction_policy_(create_eviction_policy(g_buffer_eviction_policy)) {
   CHECK(max_buffer_pool_size_ > 0);
   CHECK(page_size_ > 0);
   // TODO change checks on run-time configurable slab size variables to exceptions
@@ -101,6 +135,7 @@ void BufferMgr::clear() {
   chunk_index_.clear();
   slabs_.clear();
   slab_segments_.clear();
+  slab_numa_nodes_.clear();
   unsized_segs_.clear();
   buffer_epoch_ = 0;
 }
@@ -128,6 +163,7 @@ AbstractBuffer* BufferMgr::createBuffer(const ChunkKey& chunk_key,
                   1);  // need to do this before allocating Buffer because doing so could
                        // change the segment used
   }
+  getPoolMetrics().allocations->inc();
   // following should be safe outside the lock b/c first thing Buffer
   // constructor does is pin (and its still in unsized segs at this point
   // so can't be evicted)
@@ -163,6 +199,17 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evict_start,
     }
     num_pages += evict_it->num_pages;
     if (evict_it->mem_status == USED && evict_it->chunk_key.size() > 0) {
+      const auto& chunk_key = evict_it->chunk_key;
+      if (chunk_key.size() > CHUNK_KEY_TABLE_IDX && chunk_key[CHUNK_KEY_DB_IDX] != -1) {
+        auto& counts = table_eviction_counts_[{chunk_key[CHUNK_KEY_DB_IDX],
+                                               chunk_key[CHUNK_KEY_TABLE_IDX]}];
+        ++counts.num_chunks;
+        counts.num_bytes += evict_it->num_pages * page_size_;
+      }
+      const auto& pool_metrics = getPoolMetrics();
+      pool_metrics.evictions->inc();
+      pool_metrics.evicted_bytes->inc(evict_it->num_pages * page_size_);
+      onBufferEvicted(chunk_key, evict_it->buffer);
       chunk_index_.erase(evict_it->chunk_key);
     }
     evict_it = slab_segments_[slab_num].erase(
@@ -173,6 +220,7 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evict_start,
       start_page, num_pages_requested, USED, buffer_epoch_++);  // until we can
   // data_seg.pinCount++;
   data_seg.slab_num = slab_num;
+  data_seg.touch_count = 1;
   auto data_seg_it =
       slab_segments_[slab_num].insert(evict_it, data_seg);  // Will insert before evict_it
   if (num_pages_requested < num_pages) {
@@ -216,7 +264,12 @@ BufferList::iterator BufferMgr::reserveBuffer(
   }
   // If we're here then we couldn't keep buffer in existing slot
   // need to find new segment, copy data over, and then delete old
-  auto new_seg_it = findFreeBuffer(num_bytes);
+  auto new_seg_it = findFreeBuffer(num_bytes, getNumaNodeForChunk(seg_it->chunk_key));
+  if (slab_num >= 0) {
+    // the chunk keeps its touch history when it moves to grow
+    new_seg_it->prev_touched = seg_it->prev_touched;
+    new_seg_it->touch_count = seg_it->touch_count;
+  }
 
   // Below should be in copy constructor for BufferSeg?
   new_seg_it->buffer = seg_it->buffer;
@@ -254,7 +307,8 @@ BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slab_num,
       size_t excess_pages = buffer_it->num_pages - num_pages_requested;
       buffer_it->num_pages = num_pages_requested;
       buffer_it->mem_status = USED;
-      buffer_it->last_touched = buffer_epoch_++;
+      buffer_it->touch_count = 0;
+      touchSegment(*buffer_it);
       buffer_it->slab_num = slab_num;
       if (excess_pages > 0) {
         BufferSeg free_seg(
@@ -272,15 +326,22 @@ BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slab_num,
   return slab_segments_[slab_num].end();
 }
 
-BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
+BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes, const int numa_node) {
   size_t num_pages_requested = (num_bytes + page_size_ - 1) / page_size_;
   if (num_pages_requested > max_num_pages_per_slab_) {
     throw TooBigForSlab(num_bytes);
   }
 
   size_t num_slabs = slab_segments_.size();
+  CHECK_EQ(num_slabs, slab_numa_nodes_.size());
+  auto slab_on_numa_node = [this, numa_node](const size_t slab_num) {
+    return numa_node < 0 || slab_numa_nodes_[slab_num] == numa_node;
+  };
 
   for (size_t slab_num = 0; slab_num != num_slabs; ++slab_num) {
+    if (!slab_on_numa_node(slab_num)) {
+      continue;
+    }
     auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
     if (seg_it != slab_segments_[slab_num].end()) {
       return seg_it;
@@ -299,10 +360,14 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
           current_max_slab_page_size_) {  // don't try to allocate if the
                                           // new slab won't be big enough
         auto alloc_ms = measure<>::execution(
-            [&]() { addSlab(current_max_slab_page_size_ * page_size_); });
+            [&]() { addSlab(current_max_slab_page_size_ * page_size_, numa_node); });
+        slab_numa_nodes_.push_back(numa_node);
+        getPoolMetrics().slab_allocations->inc();
         LOG(INFO) << "ALLOCATION slab of " << current_max_slab_page_size_ << " pages ("
                   << current_max_slab_page_size_ * page_size_ << "B) created in "
-                  << alloc_ms << " ms " << getStringMgrType() << ":" << device_id_;
+                  << alloc_ms << " ms " << getStringMgrType() << ":" << device_id_
+                  << (numa_node >= 0 ? " on NUMA node " + std::to_string(numa_node)
+                                     : std::string());
       } else {
         break;
       }
@@ -342,19 +407,44 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
     throw FailedToCreateFirstSlab(num_bytes);
   }
 
+  // No room on the preferred NUMA node, fall back to free space on the other nodes
+  // before evicting anything
+  if (numa_node >= 0) {
+    for (size_t slab_num = 0; slab_num != num_slabs; ++slab_num) {
+      if (slab_on_numa_node(slab_num)) {
+        continue;
+      }
+      auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
+      if (seg_it != slab_segments_[slab_num].end()) {
+        return seg_it;
+      }
+    }
+  }
+
+  // Free pages may be scattered over the slabs, gather them before evicting anything
+  if (g_enable_buffer_pool_compaction) {
+    if (const auto seg_it = findFreeBufferByCompaction(num_pages_requested)) {
+      return *seg_it;
+    }
+  }
+
   // If here then we can't add a slab - so we need to evict
 
-  size_t min_score = std::numeric_limits<size_t>::max();
+  std::lock_guard<std::mutex> eviction_lock(eviction_mutex_);
+  double min_score = std::numeric_limits<double>::max();
   // We're going for lowest score here, like golf
-  // This is because score is the sum of the lastTouched score for all pages evicted.
-  // Evicting fewer pages and older pages will lower the score
+  // This is because score is the highest eviction policy score of the pages evicted.
+  // Evicting older pages will lower the score
   BufferList::iterator best_eviction_start = slab_segments_[0].end();
   int best_eviction_start_slab = -1;
   int slab_num = 0;
 
   for (auto slab_it = slab_segments_.begin(); slab_it != slab_segments_.end();
        ++slab_it, ++slab_num) {
-    for (auto buffer_it = slab_it->begin(); buffer_it != slab_it->end(); ++buffer_it) {
+    const auto seg_scores = getEvictionScores(*slab_it);
+    size_t seg_num = 0;
+    for (auto buffer_it = slab_it->begin(); buffer_it != slab_it->end();
+         ++buffer_it, ++seg_num) {
       // Note there are some shortcuts we could take here - like we should never consider
       // a USED buffer coming after a free buffer as we would have used the FREE buffer,
       // but we won't worry about this for now
@@ -363,10 +453,11 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
 
       // if (buffer_it->mem_status == FREE || buffer_it->buffer->getPinCount() == 0) {
       size_t page_count = 0;
-      size_t score = 0;
+      double score = std::numeric_limits<double>::lowest();
       bool solution_found = false;
       auto evict_it = buffer_it;
-      for (; evict_it != slab_segments_[slab_num].end(); ++evict_it) {
+      auto evict_seg_num = seg_num;
+      for (; evict_it != slab_segments_[slab_num].end(); ++evict_it, ++evict_seg_num) {
         // pinCount should never go up - only down because we have
         // global lock on buffer pool and pin count only increments
         // on getChunk
@@ -382,7 +473,7 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
           // chunk score was larger than one large chunk so it always would evict a large
           // chunk so under memory pressure a query would evict its own current chunks and
           // cause reloads rather than evict several smaller unused older chunks.
-          score = std::max(score, static_cast<size_t>(evict_it->last_touched));
+          score = std::max(score, seg_scores[evict_seg_num]);
         }
         if (page_count >= num_pages_requested) {
           solution_found = true;
@@ -421,6 +512,185 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
   return best_eviction_start;
 }
 
+size_t BufferMgr::compactSlabs() {
+  std::lock_guard<std::mutex> lock(global_mutex_);  // no buffer gets pinned meanwhile
+  std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
+  size_t num_moved{0};
+  for (size_t slab_num = 0; slab_num != slab_segments_.size(); ++slab_num) {
+    num_moved += compactSlab(slab_num);
+  }
+  if (num_moved) {
+    LOG(INFO) << "ALLOCATION compacted slabs, moved " << num_moved << " buffers "
+              << getStringMgrType() << ":" << device_id_;
+  }
+  return num_moved;
+}
+
+size_t BufferMgr::compactSlab(const size_t slab_num) {
+  auto& segs = slab_segments_[slab_num];
+  size_t num_moved{0};
+  auto seg_it = segs.begin();
+  while (seg_it != segs.end()) {
+    auto next_it = std::next(seg_it);
+    if (seg_it->mem_status != FREE || next_it == segs.end()) {
+      seg_it = next_it;
+      continue;
+    }
+    if (next_it->mem_status == FREE) {
+      seg_it->num_pages += next_it->num_pages;
+      segs.erase(next_it);
+      continue;
+    }
+    if (!next_it->buffer || next_it->buffer->getPinCount() > 0) {
+      // pinned buffers stay, and so do the free pages before them
+      seg_it = next_it;
+      continue;
+    }
+    // the buffer swaps places with the free pages before it, its list node is kept so
+    // that the chunk index and the buffer still point to it
+    relocateBuffer(*next_it, slabs_[slab_num] + seg_it->start_page * page_size_);
+    next_it->start_page = seg_it->start_page;
+    seg_it->start_page = next_it->start_page + next_it->num_pages;
+    segs.splice(seg_it, segs, next_it);
+    ++num_moved;
+  }
+  return num_moved;
+}
+
+void BufferMgr::relocateBuffer(BufferSeg& seg, int8_t* new_mem) {
+  auto buffer = seg.buffer;
+  CHECK(buffer);
+  int8_t* old_mem = buffer->mem_;
+  buffer->mem_ = new_mem;
+  const size_t num_bytes = buffer->size();
+  if (!old_mem || old_mem == new_mem || !num_bytes) {
+    return;
+  }
+  // Buffers only move down within a slab. When the old and new pages overlap, the data
+  // is copied in pieces no longer than the move so that a piece never overwrites data
+  // still to be copied.
+  const bool overlap = new_mem < old_mem + num_bytes && old_mem < new_mem + num_bytes;
+  CHECK(!overlap || new_mem < old_mem);
+  const size_t piece_size = overlap ? static_cast<size_t>(old_mem - new_mem) : num_bytes;
+  for (size_t offset = 0; offset < num_bytes; offset += piece_size) {
+    buffer->writeData(old_mem + offset,
+                      std::min(piece_size, num_bytes - offset),
+                      offset,
+                      buffer->getType(),
+                      device_id_);
+  }
+}
+
+size_t BufferMgr::evacuateSlab(const size_t slab_num, const size_t num_pages_requested) {
+  auto& segs = slab_segments_[slab_num];
+  size_t num_free_pages{0};
+  for (const auto& seg : segs) {
+    if (seg.mem_status == FREE) {
+      num_free_pages += seg.num_pages;
+    }
+  }
+  size_t num_moved{0};
+  auto seg_it = segs.begin();
+  while (seg_it != segs.end() && num_free_pages < num_pages_requested) {
+    if (seg_it->mem_status == FREE || !seg_it->buffer ||
+        seg_it->buffer->getPinCount() > 0) {
+      ++seg_it;
+      continue;
+    }
+    bool moved{false};
+    for (size_t dest_slab_num = 0; dest_slab_num != slab_segments_.size() && !moved;
+         ++dest_slab_num) {
+      if (dest_slab_num == slab_num ||
+          slab_numa_nodes_[dest_slab_num] != slab_numa_nodes_[slab_num]) {
+        continue;
+      }
+      auto& dest_segs = slab_segments_[dest_slab_num];
+      for (auto free_it = dest_segs.begin(); free_it != dest_segs.end(); ++free_it) {
+        if (free_it->mem_status != FREE || free_it->num_pages < seg_it->num_pages) {
+          continue;
+        }
+        auto moved_it = seg_it++;
+        segs.insert(moved_it, BufferSeg(moved_it->start_page, moved_it->num_pages, FREE));
+        relocateBuffer(*moved_it,
+                       slabs_[dest_slab_num] + free_it->start_page * page_size_);
+        moved_it->start_page = free_it->start_page;
+        moved_it->slab_num = dest_slab_num;
+        // moves the list node, which the chunk index and the buffer point to
+        dest_segs.splice(free_it, segs, moved_it);
+        free_it->start_page += moved_it->num_pages;
+        free_it->num_pages -= moved_it->num_pages;
+        if (!free_it->num_pages) {
+          dest_segs.erase(free_it);
+        }
+        num_free_pages += moved_it->num_pages;
+        ++num_moved;
+        moved = true;
+        break;
+      }
+    }
+    if (!moved) {
+      ++seg_it;
+    }
+  }
+  return num_moved;
+}
+
+std::optional<BufferList::iterator> BufferMgr::findFreeBufferByCompaction(
+    const size_t num_pages_requested) {
+  // {free pages, slab}, the slabs with the most free pages first
+  std::vector<std::pair<size_t, size_t>> slab_free_pages;
+  for (size_t slab_num = 0; slab_num != slab_segments_.size(); ++slab_num) {
+    size_t num_free_pages{0};
+    for (const auto& seg : slab_segments_[slab_num]) {
+      if (seg.mem_status == FREE) {
+        num_free_pages += seg.num_pages;
+      }
+    }
+    slab_free_pages.emplace_back(num_free_pages, slab_num);
+  }
+  std::sort(slab_free_pages.rbegin(), slab_free_pages.rend());
+
+  auto find_in_slab = [&](const size_t slab_num,
+                          const size_t num_moved) -> std::optional<BufferList::iterator> {
+    auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
+    if (seg_it == slab_segments_[slab_num].end()) {
+      return std::nullopt;
+    }
+    LOG(INFO) << "ALLOCATION found " << num_pages_requested * page_size_
+              << "B free in slab " << slab_num << " after moving " << num_moved
+              << " buffers " << getStringMgrType() << ":" << device_id_;
+    return seg_it;
+  };
+  for (const auto& [num_free_pages, slab_num] : slab_free_pages) {
+    if (num_free_pages < num_pages_requested) {
+      break;
+    }
+    const auto num_moved = compactSlab(slab_num);
+    if (const auto seg_it = find_in_slab(slab_num, num_moved)) {
+      return seg_it;
+    }
+  }
+
+  // no slab has enough free pages on its own, move buffers out of the slab with the most
+  if (!slab_free_pages.empty() && slab_free_pages.front().first < num_pages_requested) {
+    const auto slab_num = slab_free_pages.front().second;
+    size_t num_node_free_pages{0};
+    for (const auto& [num_free_pages, other_slab_num] : slab_free_pages) {
+      if (slab_numa_nodes_[other_slab_num] == slab_numa_nodes_[slab_num]) {
+        num_node_free_pages += num_free_pages;
+      }
+    }
+    if (num_node_free_pages >= num_pages_requested) {
+      auto num_moved = evacuateSlab(slab_num, num_pages_requested);
+      num_moved += compactSlab(slab_num);
+      if (const auto seg_it = find_in_slab(slab_num, num_moved)) {
+        return seg_it;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
 std::string BufferMgr::printSlab(size_t slab_num) {
   std::ostringstream tss;
   // size_t lastEnd = 0;
@@ -499,6 +769,123 @@ bool BufferMgr::isAllocationCapped() {
   return allocations_capped_;
 }
 
+bool BufferMgr::reserveQueryMemory(const size_t num_bytes,
+                                   const std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> reservation_lock(query_reservation_mutex_);
+  const auto max_size = getMaxSize();
+  const bool granted =
+      query_reservation_cv_.wait_for(reservation_lock, timeout, [&] {
+        return reserved_query_bytes_ == 0 || reserved_query_bytes_ + num_bytes <= max_size;
+      });
+  if (!granted) {
+    LOG(INFO) << "Timed out reserving " << num_bytes << " bytes on device " << device_id_
+              << ", " << reserved_query_bytes_ << " of " << max_size
+              << " bytes are reserved by running queries";
+    return false;
+  }
+  reserved_query_bytes_ += num_bytes;
+  return true;
+}
+
+void BufferMgr::releaseQueryMemory(const size_t num_bytes) {
+  {
+    std::lock_guard<std::mutex> reservation_lock(query_reservation_mutex_);
+    CHECK_LE(num_bytes, reserved_query_bytes_);
+    reserved_query_bytes_ -= num_bytes;
+  }
+  query_reservation_cv_.notify_all();
+}
+
+void BufferMgr::setEvictionPolicy(std::unique_ptr<EvictionPolicy> eviction_policy) {
+  CHECK(eviction_policy);
+  std::lock_guard<std::mutex> eviction_lock(eviction_mutex_);
+  eviction_policy_ = std::move(eviction_policy);
+}
+
+std::string BufferMgr::getEvictionPolicyName() {
+  std::lock_guard<std::mutex> eviction_lock(eviction_mutex_);
+  return eviction_policy_->getName();
+}
+
+std::map<ChunkKey, EvictionCounts> BufferMgr::getTableEvictionCounts() {
+  std::lock_guard<std::mutex> eviction_lock(eviction_mutex_);
+  return table_eviction_counts_;
+}
+
+std::vector<ChunkKey> BufferMgr::getHotChunkKeys() {
+  std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
+  std::lock_guard<std::mutex> eviction_lock(eviction_mutex_);
+  std::vector<std::pair<double, ChunkKey>> scored_keys;
+  for (const auto& slab_segs : slab_segments_) {
+    const auto seg_scores = getEvictionScores(slab_segs);
+    size_t seg_num = 0;
+    for (const auto& seg : slab_segs) {
+      const auto& chunk_key = seg.chunk_key;
+      if (seg.mem_status == USED && chunk_key.size() > CHUNK_KEY_TABLE_IDX &&
+          chunk_key[CHUNK_KEY_DB_IDX] != -1) {
+        scored_keys.emplace_back(seg_scores[seg_num], chunk_key);
+      }
+      ++seg_num;
+    }
+  }
+  std::stable_sort(
+      scored_keys.begin(), scored_keys.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+      });
+  std::vector<ChunkKey> chunk_keys;
+  chunk_keys.reserve(scored_keys.size());
+  for (auto& scored_key : scored_keys) {
+    chunk_keys.push_back(std::move(scored_key.second));
+  }
+  return chunk_keys;
+}
+
+void BufferMgr::touchSegment(BufferSeg& seg) {
+  seg.prev_touched = seg.last_touched;
+  seg.last_touched = buffer_epoch_++;
+  ++seg.touch_count;
+}
+
+double BufferMgr::getRefetchCost(const ChunkKey& chunk_key) {
+  if (parent_mgr_ && parent_mgr_->getMgrType() == CPU_MGR &&
+      parent_mgr_->isBufferOnDevice(chunk_key)) {
+    return 1.0;
+  }
+  return g_buffer_eviction_disk_refetch_cost;
+}
+
+std::vector<double> BufferMgr::getEvictionScores(const BufferList& slab_segs) {
+  std::vector<double> scores;
+  scores.reserve(slab_segs.size());
+  const bool has_refetch_costs = hasRefetchCosts();
+  for (const auto& seg : slab_segs) {
+    if (seg.mem_status != USED) {
+      scores.push_back(0);
+      continue;
+    }
+    // the costlier a chunk is to fetch back, the younger it looks, and the larger, the
+    // older
+    double age_weight = 1.0 + g_buffer_eviction_size_weight * seg.num_pages /
+                                  max_num_pages_per_slab_;
+    if (has_refetch_costs && seg.chunk_key.size() > 0 &&
+        seg.chunk_key[CHUNK_KEY_DB_IDX] != -1) {
+      age_weight /= std::max(getRefetchCost(seg.chunk_key), 1e-3);
+    }
+    scores.push_back(eviction_policy_->getScore(seg, buffer_epoch_, age_weight));
+  }
+  return scores;
+}
+
+int BufferMgr::getSlabNumaNode(const size_t slab_num) {
+  CHECK_LT(slab_num, slab_numa_nodes_.size());
+  return slab_numa_nodes_[slab_num];
+}
+
+size_t BufferMgr::getReservedQueryMemory() {
+  std::lock_guard<std::mutex> reservation_lock(query_reservation_mutex_);
+  return reserved_query_bytes_;
+}
+
 size_t BufferMgr::getPageSize() {
   return page_size_;
 }
@@ -723,8 +1110,11 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
     CHECK(buffer_it->second->buffer);
     buffer_it->second->buffer->pin();
     sized_segs_lock.unlock();
+    const auto& pool_metrics = getPoolMetrics();
+    pool_metrics.hits->inc();
+    pool_metrics.pins->inc();
 
-    buffer_it->second->last_touched = buffer_epoch_++;  // race
+    touchSegment(*buffer_it->second);  // race
 
     if (buffer_it->second->buffer->size() < num_bytes) {
       // need to fetch part of buffer we don't have - up to numBytes
@@ -733,10 +1123,11 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
     return buffer_it->second->buffer;
   } else {  // If wasn't in pool then we need to fetch it
     sized_segs_lock.unlock();
+    getPoolMetrics().misses->inc();
     // createChunk pins for us
     AbstractBuffer* buffer = createBuffer(key, page_size_, num_bytes);
     try {
-      parent_mgr_->fetchBuffer(
+      fetchMissingBuffer(
           key, buffer, num_bytes);  // this should put buffer in a BufferSegment
     } catch (std::runtime_error& error) {
       LOG(FATAL) << "Get chunk - Could not find chunk " << keyToString(key)
@@ -759,16 +1150,20 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   AbstractBuffer* buffer;
   if (!found_buffer) {
     sized_segs_lock.unlock();
+    getPoolMetrics().misses->inc();
     CHECK(parent_mgr_ != 0);
     buffer = createBuffer(key, page_size_, num_bytes);  // will pin buffer
     try {
-      parent_mgr_->fetchBuffer(key, buffer, num_bytes);
+      fetchMissingBuffer(key, buffer, num_bytes);
     } catch (std::runtime_error& error) {
       LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
     }
   } else {
     buffer = buffer_it->second->buffer;
     buffer->pin();
+    const auto& pool_metrics = getPoolMetrics();
+    pool_metrics.hits->inc();
+    pool_metrics.pins->inc();
     if (num_bytes > buffer->size()) {
       try {
         parent_mgr_->fetchBuffer(key, buffer, num_bytes);
@@ -783,6 +1178,42 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   buffer->unPin();
 }
 
+bool BufferMgr::copyResidentBuffer(const ChunkKey& key,
+                                   AbstractBuffer* dest_buffer,
+                                   const size_t num_bytes) {
+  // the pool of a peer may be waiting on this one, so it is never waited for
+  std::unique_lock<std::mutex> lock(global_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return false;
+  }
+  auto buffer = pinResidentBuffer(key);
+  if (!buffer) {
+    return false;
+  }
+  lock.unlock();
+  if (buffer->size() < num_bytes || buffer->isDirty()) {
+    buffer->unPin();
+    return false;
+  }
+  buffer->copyTo(dest_buffer, num_bytes);
+  buffer->unPin();
+  return true;
+}
+
+AbstractBuffer* BufferMgr::pinResidentBuffer(const ChunkKey& key) {
+  std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
+  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  auto buffer_it = chunk_index_.find(key);
+  if (buffer_it == chunk_index_.end()) {
+    return nullptr;
+  }
+  auto buffer = buffer_it->second->buffer;
+  CHECK(buffer);
+  buffer->pin();
+  getPoolMetrics().pins->inc();
+  return buffer;
+}
+
 AbstractBuffer* BufferMgr::putBuffer(const ChunkKey& key,
                                      AbstractBuffer* src_buffer,
                                      const size_t num_bytes) {
@@ -26,16 +26,21 @@
 
 #define BOOST_STACKTRACE_GNU_SOURCE_NOT_REQUIRED 1
 
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <list>
 #include <map>
 #include <mutex>
+#include <optional>
 
 #include <boost/stacktrace.hpp>
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/AbstractBufferMgr.h"
 #include "DataMgr/BufferMgr/BufferSeg.h"
+#include "DataMgr/BufferMgr/EvictionPolicy.h"
+#include "Shared/Metrics.h"
 #include "Shared/types.h"
 
 class OutOfMemory : public std::runtime_error {
@@ -83,10 +88,17 @@ class TooBigForSlab : public OutOfMemory {
   TooBigForSlab(size_t num_bytes) : OutOfMemory("TooBigForSlab", num_bytes) {}
 };
 
+extern bool g_enable_buffer_pool_compaction;
+
 using namespace Data_Namespace;
 
 namespace Buffer_Namespace {
 
+struct EvictionCounts {
+  size_t num_chunks{0};
+  size_t num_bytes{0};
+};
+
 /**
  * @class   BufferMgr
  * @brief
@@ -127,6 +139,40 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   bool isAllocationCapped() override;
   const std::vector<BufferList>& getSlabSegments();
 
+  /**
+   * @brief Reserves num_bytes of the buffer pool for a query which is about to execute.
+   *
+   * Blocks until outstanding reservations leave enough room for num_bytes or the timeout
+   * expires. A reservation is always granted when no other reservation is outstanding,
+   * so requests larger than the pool do not wait forever.
+   *
+   * @return true if the reservation was granted, false on timeout
+   */
+  bool reserveQueryMemory(const size_t num_bytes, const std::chrono::milliseconds timeout);
+  /// Returns memory previously granted by reserveQueryMemory.
+  void releaseQueryMemory(const size_t num_bytes);
+  size_t getReservedQueryMemory();
+
+  /// NUMA node a slab is homed on, or -1 if its placement was left to the OS.
+  int getSlabNumaNode(const size_t slab_num);
+
+  /// Replaces the policy ranking the buffers for eviction, see g_buffer_eviction_policy.
+  void setEvictionPolicy(std::unique_ptr<EvictionPolicy> eviction_policy);
+  std::string getEvictionPolicyName();
+  /// Chunks evicted since startup by {db id, table id}.
+  std::map<ChunkKey, EvictionCounts> getTableEvictionCounts();
+  /// Keys of the chunks the pool holds, the ones the eviction policy would keep the
+  /// longest first.
+  std::vector<ChunkKey> getHotChunkKeys();
+
+  /**
+   * @brief Moves the unpinned buffers of each slab to its start, so that its free pages
+   * are contiguous, save for pinned buffers.
+   *
+   * @return the number of buffers moved
+   */
+  size_t compactSlabs();
+
   /// Creates a chunk with the specified key and page size.
   AbstractBuffer* createBuffer(const ChunkKey& key,
                                const size_t page_size = 0,
@@ -153,6 +199,12 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   AbstractBuffer* putBuffer(const ChunkKey& key,
                             AbstractBuffer* d,
                             const size_t num_bytes = 0) override;
+  /// Copies the first num_bytes of a chunk the pool holds into dest_buffer. Unlike
+  /// fetchBuffer(), the chunk is never fetched and the pool is not waited for: returns
+  /// false when the pool is busy or does not hold that much of the chunk.
+  bool copyResidentBuffer(const ChunkKey& key,
+                          AbstractBuffer* dest_buffer,
+                          const size_t num_bytes);
   void checkpoint() override;
   void checkpoint(const int db_id, const int tb_id) override;
   void removeTableRelatedDS(const int db_id, const int table_id) override;
@@ -181,6 +233,34 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   std::vector<int8_t*> slabs_;  /// vector of beginning memory addresses for each
                                 /// allocation of the buffer pool
   std::vector<BufferList> slab_segments_;
+  std::vector<int> slab_numa_nodes_;  /// NUMA node of each slab, -1 if not homed
+
+  /// NUMA node the pages of a chunk should be homed on, -1 for no preference.
+  virtual int getNumaNodeForChunk(const ChunkKey& chunk_key) { return -1; }
+
+  /// Relative cost of fetching the chunk back once evicted: 1 when the parent is a CPU
+  /// buffer pool which still holds it, g_buffer_eviction_disk_refetch_cost otherwise.
+  virtual double getRefetchCost(const ChunkKey& chunk_key);
+  /// Whether the eviction scores are weighted by getRefetchCost().
+  virtual bool hasRefetchCosts() const {
+    return g_buffer_eviction_disk_refetch_cost != 1.0;
+  }
+
+  /// Fills a buffer just created for a chunk missing from the pool, from the parent.
+  virtual void fetchMissingBuffer(const ChunkKey& key,
+                                  AbstractBuffer* dest_buffer,
+                                  const size_t num_bytes) {
+    parent_mgr_->fetchBuffer(key, dest_buffer, num_bytes);
+  }
+
+  /// Called with each chunk evicted from the pool, while its buffer still holds it.
+  virtual void onBufferEvicted(const ChunkKey& key, AbstractBuffer* buffer) {}
+
+  /// Pins and returns the buffer of a chunk the pool holds, nullptr if it does not.
+  /// Neither waits for the pool nor fetches the chunk.
+  AbstractBuffer* pinResidentBuffer(const ChunkKey& key);
+
+  AbstractBufferMgr* getParentMgr() const { return parent_mgr_; }
 
  private:
   BufferMgr(const BufferMgr&);             // private copy constructor
@@ -189,7 +269,7 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   BufferList::iterator findFreeBufferInSlab(const size_t slab_num,
                                             const size_t num_pages_requested);
   int getBufferId();
-  virtual void addSlab(const size_t slab_size) = 0;
+  virtual void addSlab(const size_t slab_size, const int numa_node) = 0;
   virtual void freeAllMem() = 0;
   virtual void allocateBuffer(BufferList::iterator seg_it,
                               const size_t page_size,
@@ -199,6 +279,10 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   std::mutex unsized_segs_mutex_;
   std::mutex buffer_id_mutex_;
   std::mutex global_mutex_;
+  std::mutex query_reservation_mutex_;
+  std::mutex eviction_mutex_;  // guards eviction_policy_ and table_eviction_counts_
+  std::condition_variable query_reservation_cv_;
+  size_t reserved_query_bytes_{0};
 
   std::map<ChunkKey, BufferList::iterator> chunk_index_;
   size_t max_buffer_pool_num_pages_;  // max number of pages for buffer pool
@@ -210,9 +294,41 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   AbstractBufferMgr* parent_mgr_;
   int max_buffer_id_;
   unsigned int buffer_epoch_;
+  std::unique_ptr<EvictionPolicy> eviction_policy_;
+  std::map<ChunkKey, EvictionCounts> table_eviction_counts_;
+
+  // Counters of the metrics endpoint, labeled with the level and device of the pool.
+  struct PoolMetrics {
+    metrics::Counter* slab_allocations;
+    metrics::Counter* allocations;
+    metrics::Counter* hits;
+    metrics::Counter* misses;
+    metrics::Counter* pins;
+    metrics::Counter* evictions;
+    metrics::Counter* evicted_bytes;
+  };
+  // The level is only known once the derived manager is constructed, the counters are
+  // looked up on first use.
+  const PoolMetrics& getPoolMetrics();
+  std::once_flag pool_metrics_flag_;
+  PoolMetrics pool_metrics_;
 
   BufferList unsized_segs_;
 
+  void touchSegment(BufferSeg& seg);
+  // Eviction scores of the used segments of the slab, in the order of the segments.
+  std::vector<double> getEvictionScores(const BufferList& slab_segs);
+
+  size_t compactSlab(const size_t slab_num);
+  // Copies the data of the buffer of the segment to new_mem, in the same or another slab.
+  void relocateBuffer(BufferSeg& seg, int8_t* new_mem);
+  // Moves the unpinned buffers of the slab to free segments of the slabs on the same NUMA
+  // node, until it has num_pages_requested free pages.
+  size_t evacuateSlab(const size_t slab_num, const size_t num_pages_requested);
+  // Compacts the slabs with enough free pages in total for the request, else evacuates
+  // the slab with the most free pages, without evicting anything.
+  std::optional<BufferList::iterator> findFreeBufferByCompaction(
+      const size_t num_pages_requested);
   BufferList::iterator evict(BufferList::iterator& evict_start,
                              const size_t num_pages_requested,
                              const int slab_num);
@@ -228,8 +344,10 @@ class BufferMgr : public AbstractBufferMgr {  // implements
    * buffer won't be evicted by PINNING it - caller should change this to
    * USED if applicable
    *
+   * Slabs homed on numa_node, if any, are searched first and new slabs are homed on it.
+   *
    */
-  BufferList::iterator findFreeBuffer(size_t num_bytes);
+  BufferList::iterator findFreeBuffer(size_t num_bytes, const int numa_node = -1);
 };
 
 }  // namespace Buffer_Namespace
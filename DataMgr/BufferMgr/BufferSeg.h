@@ -36,6 +36,8 @@ struct BufferSeg {
   unsigned int pin_count;
   int slab_num;
   unsigned int last_touched;
+  unsigned int prev_touched{0};  // touch before the last one, if touch_count > 1
+  unsigned int touch_count{0};
 
   BufferSeg()
       : mem_status(FREE), buffer(0), pin_count(0), slab_num(-1), last_touched(0) {}
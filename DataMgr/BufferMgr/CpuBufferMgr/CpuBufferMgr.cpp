@@ -19,10 +19,43 @@
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/Allocators/ArenaAllocator.h"
 #include "DataMgr/BufferMgr/CpuBufferMgr/CpuBuffer.h"
+#include "Shared/Compressor.h"
+#include "Shared/NumaUtils.h"
+
+#include <algorithm>
+
+bool g_enable_pinned_cpu_buffer_pool{false};
+size_t g_cpu_compressed_chunk_cache_bytes{0};
 
 namespace Buffer_Namespace {
 
-void CpuBufferMgr::addSlab(const size_t slab_size) {
+namespace {
+
+// The chunks which don't compress to this fraction of their size are not kept, they
+// would hardly be cheaper to fetch back than from disk.
+constexpr size_t kMinCompressionRatio{2};
+
+// The bytes of the values of the fixed width types are shuffled by significance.
+size_t get_shuffle_type_size(const SQLTypeInfo& ti) {
+  if (ti.is_array() || ti.is_varlen()) {
+    return 1;
+  }
+  const auto byte_width = ti.get_size();
+  return byte_width == 2 || byte_width == 4 || byte_width == 8 ? byte_width : 1;
+}
+
+}  // namespace
+
+CpuBufferMgr::~CpuBufferMgr() {
+  // the destruction of the allocator automatically frees all memory
+  try {
+    unregisterSlabs();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to unregister the CPU buffer pool slabs: " << e.what();
+  }
+}
+
+void CpuBufferMgr::addSlab(const size_t slab_size, const int numa_node) {
   CHECK(allocator_);
   slabs_.resize(slabs_.size() + 1);
   try {
@@ -31,13 +64,180 @@ void CpuBufferMgr::addSlab(const size_t slab_size) {
     slabs_.resize(slabs_.size() - 1);
     throw FailedToCreateSlab(slab_size);
   }
+  if (numa_node >= 0) {
+    // the slab pages have not been touched yet, so they are placed on first use
+    numa::bind_memory_to_node(slabs_.back(), slab_size, numa_node);
+  }
+  if (g_enable_pinned_cpu_buffer_pool && cuda_mgr_) {
+    // pinning faults the pages in, after the NUMA binding so they land on the node
+    cuda_mgr_->registerHostMem(slabs_.back(), slab_size);
+    registered_slabs_.push_back(slabs_.back());
+  }
   slab_segments_.resize(slab_segments_.size() + 1);
   slab_segments_[slab_segments_.size() - 1].push_back(
       BufferSeg(0, slab_size / page_size_));
 }
 
+void CpuBufferMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
+  BufferMgr::deleteBuffer(key, purge);
+  std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+  const auto it = compressed_chunks_.find(key);
+  if (it != compressed_chunks_.end()) {
+    eraseCompressedChunk(it);
+  }
+}
+
+void CpuBufferMgr::deleteBuffersWithPrefix(const ChunkKey& key_prefix,
+                                           const bool purge) {
+  BufferMgr::deleteBuffersWithPrefix(key_prefix, purge);
+  std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+  auto it = compressed_chunks_.lower_bound(key_prefix);
+  while (it != compressed_chunks_.end() && it->first.size() >= key_prefix.size() &&
+         std::equal(key_prefix.begin(), key_prefix.end(), it->first.begin())) {
+    eraseCompressedChunk(it++);
+  }
+}
+
+void CpuBufferMgr::clearSlabs() {
+  BufferMgr::clearSlabs();
+  std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+  compressed_chunks_.clear();
+  compressed_chunks_lru_.clear();
+  compressed_chunks_bytes_ = 0;
+}
+
+size_t CpuBufferMgr::getCompressedChunkCacheSize() {
+  std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+  return compressed_chunks_bytes_;
+}
+
+void CpuBufferMgr::fetchMissingBuffer(const ChunkKey& key,
+                                      AbstractBuffer* dest_buffer,
+                                      const size_t num_bytes) {
+  if (fetchBufferFromCompressedChunk(key, dest_buffer, num_bytes)) {
+    return;
+  }
+  BufferMgr::fetchMissingBuffer(key, dest_buffer, num_bytes);
+}
+
+bool CpuBufferMgr::fetchBufferFromCompressedChunk(const ChunkKey& key,
+                                                  AbstractBuffer* dest_buffer,
+                                                  const size_t num_bytes) {
+  CompressedChunk compressed_chunk;
+  {
+    std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+    const auto it = compressed_chunks_.find(key);
+    if (it == compressed_chunks_.end()) {
+      return false;
+    }
+    compressed_chunk = eraseCompressedChunk(it);
+  }
+  // the copy is dropped either way, the chunk is back in the pool or has grown since
+  if (compressed_chunk.num_bytes < num_bytes) {
+    return false;
+  }
+  dest_buffer->reserve(compressed_chunk.num_bytes);
+  try {
+    BloscCompressor::getCompressor()->decompressFast(
+        compressed_chunk.data.data(),
+        reinterpret_cast<uint8_t*>(dest_buffer->getMemoryPtr()),
+        compressed_chunk.num_bytes);
+  } catch (const CompressionFailedError& e) {
+    LOG(WARNING) << "Failed to decompress chunk " << keyToString(key) << ": " << e.what();
+    return false;
+  }
+  dest_buffer->setSize(compressed_chunk.num_bytes);
+  if (compressed_chunk.encoder) {
+    if (!dest_buffer->hasEncoder()) {
+      dest_buffer->initEncoder(compressed_chunk.sql_type);
+    }
+    dest_buffer->getEncoder()->copyMetadata(compressed_chunk.encoder.get());
+  }
+  return true;
+}
+
+// The chunk is compressed on the evicting thread, its pages are reused once evicted.
+void CpuBufferMgr::onBufferEvicted(const ChunkKey& key, AbstractBuffer* buffer) {
+  if (!g_cpu_compressed_chunk_cache_bytes || !getParentMgr() || !buffer ||
+      buffer->isDirty() || key.size() <= CHUNK_KEY_TABLE_IDX ||
+      key[CHUNK_KEY_DB_IDX] == -1) {
+    return;
+  }
+  const auto num_bytes = buffer->size();
+  const auto max_compressed_bytes = num_bytes / kMinCompressionRatio;
+  if (!num_bytes || max_compressed_bytes > g_cpu_compressed_chunk_cache_bytes) {
+    return;
+  }
+  CompressedChunk compressed_chunk;
+  compressed_chunk.data.resize(max_compressed_bytes);
+  int64_t compressed_len{0};
+  try {
+    compressed_len = BloscCompressor::getCompressor()->compressFast(
+        reinterpret_cast<const uint8_t*>(buffer->getMemoryPtr()),
+        num_bytes,
+        compressed_chunk.data.data(),
+        max_compressed_bytes,
+        get_shuffle_type_size(buffer->getSqlType()));
+  } catch (const CompressionFailedError& e) {
+    LOG(WARNING) << "Failed to compress chunk " << keyToString(key) << ": " << e.what();
+    return;
+  }
+  if (!compressed_len) {
+    return;
+  }
+  compressed_chunk.data.resize(compressed_len);
+  compressed_chunk.data.shrink_to_fit();
+  compressed_chunk.num_bytes = num_bytes;
+  compressed_chunk.sql_type = buffer->getSqlType();
+  if (buffer->hasEncoder()) {
+    compressed_chunk.encoder.reset(Encoder::Create(nullptr, compressed_chunk.sql_type));
+    compressed_chunk.encoder->copyMetadata(buffer->getEncoder());
+  }
+
+  std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+  const auto it = compressed_chunks_.find(key);
+  if (it != compressed_chunks_.end()) {
+    eraseCompressedChunk(it);
+  }
+  while (!compressed_chunks_lru_.empty() &&
+         compressed_chunks_bytes_ + compressed_chunk.data.size() >
+             g_cpu_compressed_chunk_cache_bytes) {
+    eraseCompressedChunk(compressed_chunks_.find(compressed_chunks_lru_.front()));
+  }
+  compressed_chunks_bytes_ += compressed_chunk.data.size();
+  compressed_chunks_lru_.push_back(key);
+  compressed_chunk.lru_it = std::prev(compressed_chunks_lru_.end());
+  compressed_chunks_.emplace(key, std::move(compressed_chunk));
+}
+
+CpuBufferMgr::CompressedChunk CpuBufferMgr::eraseCompressedChunk(
+    CompressedChunkMap::iterator it) {
+  CHECK(it != compressed_chunks_.end());
+  CHECK_GE(compressed_chunks_bytes_, it->second.data.size());
+  compressed_chunks_bytes_ -= it->second.data.size();
+  compressed_chunks_lru_.erase(it->second.lru_it);
+  auto compressed_chunk = std::move(it->second);
+  compressed_chunks_.erase(it);
+  return compressed_chunk;
+}
+
+int CpuBufferMgr::getNumaNodeForChunk(const ChunkKey& chunk_key) {
+  if (chunk_key.size() <= CHUNK_KEY_FRAGMENT_IDX) {
+    return -1;
+  }
+  return numa::get_node_for_fragment(chunk_key[CHUNK_KEY_FRAGMENT_IDX]);
+}
+
+void CpuBufferMgr::unregisterSlabs() {
+  for (const auto slab : registered_slabs_) {
+    cuda_mgr_->unregisterHostMem(slab);
+  }
+  registered_slabs_.clear();
+}
+
 void CpuBufferMgr::freeAllMem() {
   CHECK(allocator_);
+  unregisterSlabs();
   allocator_.reset(new Arena(max_slab_size_ + kArenaBlockOverhead));
 }
 
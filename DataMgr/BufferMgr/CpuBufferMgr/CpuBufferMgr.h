@@ -20,6 +20,17 @@
 
 #include "DataMgr/Allocators/ArenaAllocator.h"
 
+#include <list>
+#include <map>
+#include <mutex>
+
+// Registers the slabs of the CPU buffer pool with CUDA, the chunks they hold are then
+// copied to the GPUs at full bandwidth, without going through the staging pool.
+extern bool g_enable_pinned_cpu_buffer_pool;
+// Bytes of memory holding an LZ4 compressed copy of the chunks evicted from the CPU
+// buffer pool, which are then fetched back from it rather than from disk. 0 disables it.
+extern size_t g_cpu_compressed_chunk_cache_bytes;
+
 namespace CudaMgr_Namespace {
 class CudaMgr;
 }
@@ -45,22 +56,62 @@ class CpuBufferMgr : public BufferMgr {
       , allocator_(std::make_unique<Arena>(/*min_block_size=*/max_slab_size +
                                            kArenaBlockOverhead)) {}
 
-  ~CpuBufferMgr() {
-    /* the destruction of the allocator automatically frees all memory */
-  }
+  ~CpuBufferMgr() override;
 
   inline MgrType getMgrType() override { return CPU_MGR; }
   inline std::string getStringMgrType() override { return ToString(CPU_MGR); }
 
+  void deleteBuffer(const ChunkKey& key, const bool purge = true) override;
+  void deleteBuffersWithPrefix(const ChunkKey& key_prefix,
+                               const bool purge = true) override;
+  void clearSlabs() override;
+
+  /// Bytes held by the compressed copies of the evicted chunks.
+  size_t getCompressedChunkCacheSize();
+
+ protected:
+  // Chunks are homed on NUMA nodes by fragment id, so that the kernel processing a
+  // fragment can be run on the node which owns all of its chunks.
+  int getNumaNodeForChunk(const ChunkKey& chunk_key) override;
+
+  void fetchMissingBuffer(const ChunkKey& key,
+                          AbstractBuffer* dest_buffer,
+                          const size_t num_bytes) override;
+  void onBufferEvicted(const ChunkKey& key, AbstractBuffer* buffer) override;
+
  private:
-  void addSlab(const size_t slab_size) override;
+  struct CompressedChunk {
+    std::vector<uint8_t> data;
+    size_t num_bytes{0};  // decompressed
+    SQLTypeInfo sql_type;
+    std::unique_ptr<Encoder> encoder;  // copy of the metadata, nullptr for none
+    std::list<ChunkKey>::iterator lru_it;
+  };
+  using CompressedChunkMap = std::map<ChunkKey, CompressedChunk>;
+
+  bool fetchBufferFromCompressedChunk(const ChunkKey& key,
+                                      AbstractBuffer* dest_buffer,
+                                      const size_t num_bytes);
+  // requires compressed_chunks_mutex_, returns the chunk erased
+  CompressedChunk eraseCompressedChunk(CompressedChunkMap::iterator it);
+
+
+  void addSlab(const size_t slab_size, const int numa_node) override;
   void freeAllMem() override;
+  void unregisterSlabs();
   void allocateBuffer(BufferList::iterator segment_iter,
                       const size_t page_size,
                       const size_t initial_size) override;
 
   CudaMgr_Namespace::CudaMgr* cuda_mgr_;
   std::unique_ptr<Arena> allocator_;
+  std::vector<int8_t*> registered_slabs_;
+
+  // the compressed copies of the evicted chunks, a copy is dropped once fetched back
+  std::mutex compressed_chunks_mutex_;
+  CompressedChunkMap compressed_chunks_;
+  std::list<ChunkKey> compressed_chunks_lru_;  // least recently evicted first
+  size_t compressed_chunks_bytes_{0};
 };
 
 }  // namespace Buffer_Namespace
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/BufferMgr/EvictionPolicy.h"
+
+#include <stdexcept>
+
+std::string g_buffer_eviction_policy{"lru"};
+float g_buffer_eviction_disk_refetch_cost{1.0};
+float g_buffer_eviction_size_weight{0.0};
+
+namespace Buffer_Namespace {
+
+namespace {
+
+class LruEvictionPolicy : public EvictionPolicy {
+ public:
+  std::string getName() const override { return "lru"; }
+
+  double getScore(const BufferSeg& seg,
+                  const unsigned int buffer_epoch,
+                  const double age_weight) const override {
+    return getTouchScore(seg.last_touched, buffer_epoch, age_weight);
+  }
+};
+
+class Lru2EvictionPolicy : public EvictionPolicy {
+ public:
+  std::string getName() const override { return "lru2"; }
+
+  double getScore(const BufferSeg& seg,
+                  const unsigned int buffer_epoch,
+                  const double age_weight) const override {
+    if (seg.touch_count < 2) {
+      return getTouchScore(seg.last_touched, buffer_epoch, age_weight);
+    }
+    return kReusedSegmentScore +
+           getTouchScore(seg.prev_touched, buffer_epoch, age_weight);
+  }
+};
+
+class TwoQueueEvictionPolicy : public EvictionPolicy {
+ public:
+  std::string getName() const override { return "2q"; }
+
+  double getScore(const BufferSeg& seg,
+                  const unsigned int buffer_epoch,
+                  const double age_weight) const override {
+    // the last touch of a segment touched once is when it was loaded
+    const auto score = getTouchScore(seg.last_touched, buffer_epoch, age_weight);
+    return seg.touch_count < 2 ? score : kReusedSegmentScore + score;
+  }
+};
+
+}  // namespace
+
+std::unique_ptr<EvictionPolicy> create_eviction_policy(const std::string& name) {
+  if (name == "lru") {
+    return std::make_unique<LruEvictionPolicy>();
+  }
+  if (name == "lru2") {
+    return std::make_unique<Lru2EvictionPolicy>();
+  }
+  if (name == "2q") {
+    return std::make_unique<TwoQueueEvictionPolicy>();
+  }
+  throw std::runtime_error("Unknown buffer eviction policy " + name +
+                           ", expected lru, lru2 or 2q.");
+}
+
+}  // namespace Buffer_Namespace
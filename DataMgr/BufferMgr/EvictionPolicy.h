@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    EvictionPolicy.h
+ * @brief   Ranking of the unpinned buffers of a BufferMgr for eviction.
+ *
+ * The BufferMgr evicts the contiguous run of unpinned segments whose highest score is
+ * the lowest. The policy scores a segment from its touch history, the age it is given
+ * is first weighted by the BufferMgr for the cost of fetching the chunk back and for its
+ * size.
+ */
+
+#pragma once
+
+#include "DataMgr/BufferMgr/BufferSeg.h"
+
+#include <memory>
+#include <string>
+
+extern std::string g_buffer_eviction_policy;
+extern float g_buffer_eviction_disk_refetch_cost;
+extern float g_buffer_eviction_size_weight;
+
+namespace Buffer_Namespace {
+
+class EvictionPolicy {
+ public:
+  virtual ~EvictionPolicy() = default;
+
+  virtual std::string getName() const = 0;
+
+  /**
+   * @brief Scores an unpinned used segment, the lower the sooner it is evicted.
+   *
+   * @param age_weight - multiplies the ages, in buffer epochs, of the touches of the
+   * segment: over 1 makes it look older than it is, under 1 younger.
+   */
+  virtual double getScore(const BufferSeg& seg,
+                          const unsigned int buffer_epoch,
+                          const double age_weight) const = 0;
+
+ protected:
+  // Score of a touch `age_weight` times as old as it is, increasing with the touch.
+  static double getTouchScore(const unsigned int touch,
+                              const unsigned int buffer_epoch,
+                              const double age_weight) {
+    // the unsigned difference stays right when the epoch wraps around
+    return -static_cast<double>(static_cast<unsigned int>(buffer_epoch - touch)) *
+           age_weight;
+  }
+
+  // Offset of the scores of the segments touched more than once, they are only evicted
+  // when no run of segments touched once is large enough.
+  static constexpr double kReusedSegmentScore = 1e15;
+};
+
+/**
+ * @brief Creates the policy with the name:
+ *   lru: least recently touched first, the default.
+ *   lru2: LRU-K with K = 2, the segments touched once go first by their last touch, then
+ *         the others by their second to last touch.
+ *   2q: the segments touched once go first, as a FIFO, then the others least recently
+ *       touched first.
+ * lru2 and 2q are scan resistant: the chunks of a one-off scan of a large table are
+ * evicted before the chunks queries keep coming back to.
+ */
+std::unique_ptr<EvictionPolicy> create_eviction_policy(const std::string& name);
+
+}  // namespace Buffer_Namespace
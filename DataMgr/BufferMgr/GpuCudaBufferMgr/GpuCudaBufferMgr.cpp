@@ -18,10 +18,65 @@
 
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/BufferMgr/GpuCudaBufferMgr/GpuCudaBuffer.h"
+#include "DataMgr/BufferMgr/GpuCudaBufferMgr/ManagedCudaBuffer.h"
 #include "Logger/Logger.h"
+#include "Shared/scope.h"
+
+#include <cstring>
+#include <limits>
+
+bool g_enable_gpu_compressed_chunks{false};
+float g_gpu_compressed_chunk_max_ratio{0.5};
+bool g_enable_gpu_managed_memory_fallback{false};
 
 namespace Buffer_Namespace {
 
+namespace {
+
+// Last component of the key of a compressed copy, after the key of its chunk.
+constexpr int kCompressedChunkKeyMarker{-1};
+// Relative cost of decoding a chunk from its compressed copy on the device.
+constexpr double kDecodeRefetchCost{0.1};
+// The smaller chunks are not worth the compressed copy.
+constexpr size_t kMinCompressedChunkBytes{64 * 1024};
+
+// The byte width of the chunks of the type which can be kept compressed, 0 for none:
+// the integer types stored as signed values of 1, 2, 4 or 8 bytes.
+size_t get_compressible_byte_width(const SQLTypeInfo& ti) {
+  if (ti.is_array() || ti.is_varlen()) {
+    return 0;
+  }
+  const auto byte_width = static_cast<size_t>(ti.get_size());
+  if (byte_width != 1 && byte_width != 2 && byte_width != 4 && byte_width != 8) {
+    return 0;
+  }
+  if (ti.is_integer() || ti.is_decimal() || ti.is_time() || ti.is_boolean()) {
+    return byte_width;
+  }
+  // the narrower dictionary ids are unsigned
+  return ti.is_dict_encoded_string() && byte_width == 4 ? byte_width : 0;
+}
+
+int64_t read_signed(const int8_t* data, const size_t byte_width, const size_t pos) {
+  switch (byte_width) {
+    case 1:
+      return data[pos];
+    case 2:
+      return reinterpret_cast<const int16_t*>(data)[pos];
+    case 4:
+      return reinterpret_cast<const int32_t*>(data)[pos];
+    case 8:
+      return reinterpret_cast<const int64_t*>(data)[pos];
+    default:
+      UNREACHABLE();
+  }
+  return 0;
+}
+
+}  // namespace
+
+GpuCudaBufferMgr::ChunkDecoder GpuCudaBufferMgr::chunk_decoder_;
+
 GpuCudaBufferMgr::GpuCudaBufferMgr(const int device_id,
                                    const size_t max_buffer_pool_size,
                                    CudaMgr_Namespace::CudaMgr* cuda_mgr,
@@ -40,6 +95,9 @@ GpuCudaBufferMgr::GpuCudaBufferMgr(const int device_id,
 GpuCudaBufferMgr::~GpuCudaBufferMgr() {
   try {
     cuda_mgr_->synchronizeDevices();
+    for (auto buffer : managed_buffers_) {
+      delete buffer;
+    }
     freeAllMem();
 #ifdef HAVE_CUDA
   } catch (const CudaMgr_Namespace::CudaErrorException& e) {
@@ -53,7 +111,215 @@ GpuCudaBufferMgr::~GpuCudaBufferMgr() {
   }
 }
 
-void GpuCudaBufferMgr::addSlab(const size_t slab_size) {
+void GpuCudaBufferMgr::setChunkDecoder(ChunkDecoder chunk_decoder) {
+  chunk_decoder_ = std::move(chunk_decoder);
+}
+
+void GpuCudaBufferMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
+  BufferMgr::deleteBuffer(key, purge);
+  if (key.size() && key.back() == kCompressedChunkKeyMarker) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+    if (!compressed_chunks_.erase(key)) {
+      return;
+    }
+  }
+  const auto compressed_key = getCompressedChunkKey(key);
+  if (isBufferOnDevice(compressed_key)) {
+    BufferMgr::deleteBuffer(compressed_key, purge);
+  }
+}
+
+AbstractBuffer* GpuCudaBufferMgr::alloc(const size_t num_bytes) {
+  try {
+    return BufferMgr::alloc(num_bytes);
+  } catch (const OutOfMemory& e) {
+    if (!g_enable_gpu_managed_memory_fallback || !num_bytes) {
+      throw;
+    }
+    std::lock_guard<std::mutex> managed_buffers_lock(managed_buffers_mutex_);
+    // past as much again as the pool, the pages would mostly move back and forth and
+    // running on the CPU is faster
+    if (managed_bytes_ + num_bytes > max_buffer_pool_size_) {
+      throw;
+    }
+    AbstractBuffer* buffer{nullptr};
+    try {
+      buffer = new ManagedCudaBuffer(device_id_, cuda_mgr_, num_bytes);
+    } catch (const std::runtime_error& managed_error) {
+      LOG(WARNING) << "Failed to allocate " << num_bytes
+                   << " bytes of managed memory on device " << device_id_ << ": "
+                   << managed_error.what();
+      throw e;
+    }
+    LOG(INFO) << "Allocated " << num_bytes << " bytes of managed memory on device "
+              << device_id_ << ", the buffer pool is out of memory";
+    managed_buffers_.insert(buffer);
+    managed_bytes_ += num_bytes;
+    return buffer;
+  }
+}
+
+void GpuCudaBufferMgr::free(AbstractBuffer* buffer) {
+  {
+    std::lock_guard<std::mutex> managed_buffers_lock(managed_buffers_mutex_);
+    if (managed_buffers_.erase(buffer)) {
+      managed_bytes_ -= buffer->reservedSize();
+      delete buffer;
+      return;
+    }
+  }
+  BufferMgr::free(buffer);
+}
+
+ChunkKey GpuCudaBufferMgr::getCompressedChunkKey(const ChunkKey& key) {
+  auto compressed_key = key;
+  compressed_key.push_back(kCompressedChunkKeyMarker);
+  return compressed_key;
+}
+
+void GpuCudaBufferMgr::fetchMissingBuffer(const ChunkKey& key,
+                                          AbstractBuffer* dest_buffer,
+                                          const size_t num_bytes) {
+  if (fetchBufferFromPeer(key, dest_buffer, num_bytes) ||
+      fetchBufferFromCompressedCopy(key, dest_buffer, num_bytes)) {
+    return;
+  }
+  BufferMgr::fetchMissingBuffer(key, dest_buffer, num_bytes);
+  addCompressedCopy(key, dest_buffer, num_bytes);
+}
+
+// A chunk with a compressed copy is cheap to bring back, it goes before the others.
+double GpuCudaBufferMgr::getRefetchCost(const ChunkKey& chunk_key) {
+  if (g_enable_gpu_compressed_chunks) {
+    if (chunk_key.size() && chunk_key.back() == kCompressedChunkKeyMarker) {
+      return BufferMgr::getRefetchCost(
+          ChunkKey(chunk_key.begin(), std::prev(chunk_key.end())));
+    }
+    std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+    if (compressed_chunks_.count(chunk_key)) {
+      return kDecodeRefetchCost;
+    }
+  }
+  return BufferMgr::getRefetchCost(chunk_key);
+}
+
+bool GpuCudaBufferMgr::hasRefetchCosts() const {
+  return BufferMgr::hasRefetchCosts() || g_enable_gpu_compressed_chunks;
+}
+
+bool GpuCudaBufferMgr::fetchBufferFromCompressedCopy(const ChunkKey& key,
+                                                     AbstractBuffer* dest_buffer,
+                                                     const size_t num_bytes) {
+  if (!g_enable_gpu_compressed_chunks || !chunk_decoder_ || !num_bytes) {
+    return false;
+  }
+  CompressedChunk compressed_chunk;
+  {
+    std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+    const auto it = compressed_chunks_.find(key);
+    if (it == compressed_chunks_.end() || it->second.num_bytes < num_bytes) {
+      return false;
+    }
+    compressed_chunk = it->second;
+  }
+  auto compressed_buffer = pinResidentBuffer(getCompressedChunkKey(key));
+  if (!compressed_buffer) {
+    return false;
+  }
+  ScopeGuard unpin = [compressed_buffer] { compressed_buffer->unPin(); };
+  dest_buffer->reserve(num_bytes);
+  cuda_mgr_->setContext(device_id_);
+  chunk_decoder_(dest_buffer->getMemoryPtr(),
+                 compressed_buffer->getMemoryPtr(),
+                 compressed_chunk.codec,
+                 compressed_chunk.byte_width,
+                 num_bytes / compressed_chunk.byte_width,
+                 compressed_chunk.null_val);
+  dest_buffer->setSize(num_bytes);
+  dest_buffer->syncEncoder(compressed_buffer);
+  return true;
+}
+
+// The chunk is encoded on the host, from the copy the parent just fetched it from.
+void GpuCudaBufferMgr::addCompressedCopy(const ChunkKey& key,
+                                         AbstractBuffer* buffer,
+                                         const size_t num_bytes) {
+  if (!g_enable_gpu_compressed_chunks || !chunk_decoder_ ||
+      num_bytes < kMinCompressedChunkBytes || key.size() != 4 ||
+      getParentMgr()->getMgrType() != CPU_MGR) {
+    return;
+  }
+  const auto byte_width = get_compressible_byte_width(buffer->getSqlType());
+  if (!byte_width || num_bytes % byte_width) {
+    return;
+  }
+  const auto compressed_key = getCompressedChunkKey(key);
+  if (isBufferOnDevice(compressed_key)) {
+    BufferMgr::deleteBuffer(compressed_key);
+  }
+
+  const auto num_elems = num_bytes / byte_width;
+  std::vector<int64_t> values(num_elems);
+  {
+    auto host_buffer = getParentMgr()->getBuffer(key, num_bytes);
+    ScopeGuard unpin = [host_buffer] { host_buffer->unPin(); };
+    const auto data = host_buffer->getMemoryPtr();
+    for (size_t pos = 0; pos < num_elems; ++pos) {
+      values[pos] = read_signed(data, byte_width, pos);
+    }
+  }
+  // the narrowest value, which is the null sentinel of the integer types, comes back
+  // as it was whichever codec is chosen
+  const auto null_val =
+      byte_width == 8 ? std::numeric_limits<int64_t>::min()
+                      : -(int64_t(1) << (8 * byte_width - 1));
+  const auto codec = integer_codecs::choose_codec(values, null_val);
+  if (integer_codecs::encoded_size(codec, values, null_val) >
+      num_bytes * g_gpu_compressed_chunk_max_ratio) {
+    return;
+  }
+  auto stream = integer_codecs::encode(codec, values, null_val);
+  AbstractBuffer* compressed_buffer{nullptr};
+  try {
+    compressed_buffer = createBuffer(compressed_key, page_size_, stream.size());
+    compressed_buffer->write(stream.data(), stream.size(), 0, CPU_LEVEL, -1);
+  } catch (const OutOfMemory&) {
+    if (compressed_buffer) {
+      compressed_buffer->unPin();
+      BufferMgr::deleteBuffer(compressed_key);
+    }
+    return;
+  }
+  compressed_buffer->syncEncoder(buffer);
+  compressed_buffer->clearDirtyBits();
+  compressed_buffer->unPin();
+  std::lock_guard<std::mutex> compressed_chunks_lock(compressed_chunks_mutex_);
+  compressed_chunks_[key] = {codec, byte_width, num_bytes, null_val};
+}
+
+bool GpuCudaBufferMgr::fetchBufferFromPeer(const ChunkKey& key,
+                                           AbstractBuffer* dest_buffer,
+                                           const size_t num_bytes) {
+  // without a size, a peer cannot tell whether it holds all of the chunk
+  if (!num_bytes) {
+    return false;
+  }
+  for (const auto peer_mgr : peer_mgrs_) {
+    if (peer_mgr->copyResidentBuffer(key, dest_buffer, num_bytes)) {
+      VLOG(2) << "Fetched chunk " << keyToString(key) << " to GPU " << device_id_
+              << " from GPU " << peer_mgr->getDeviceId();
+      return true;
+    }
+  }
+  return false;
+}
+
+void GpuCudaBufferMgr::addSlab(const size_t slab_size, const int numa_node) {
+  // device memory is not homed on host NUMA nodes
+  CHECK_LT(numa_node, 0);
   slabs_.resize(slabs_.size() + 1);
   try {
     slabs_.back() = cuda_mgr_->allocateDeviceMem(slab_size, device_id_);
@@ -17,6 +17,21 @@
 #pragma once
 
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DataMgr/IntegerCodecs.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+
+// Keeps a compressed copy of the integer chunks promoted to the GPUs, the chunk is
+// decoded from it on the device once evicted instead of being copied from the host.
+extern bool g_enable_gpu_compressed_chunks;
+// Largest compressed to decoded size ratio of the chunks kept compressed.
+extern float g_gpu_compressed_chunk_max_ratio;
+// Allocates the buffers which aren't chunks, such as join hash tables and group by
+// buffers, in CUDA managed memory when they don't fit in the buffer pool.
+extern bool g_enable_gpu_managed_memory_fallback;
 
 namespace CudaMgr_Namespace {
 class CudaMgr;
@@ -37,13 +52,71 @@ class GpuCudaBufferMgr : public BufferMgr {
   inline std::string getStringMgrType() override { return ToString(GPU_MGR); }
   ~GpuCudaBufferMgr() override;
 
+  // The pools of the GPUs this GPU has peer access to, a chunk missing from this pool
+  // is copied from one of them when it holds it rather than from the host.
+  void setPeerMgrs(const std::vector<BufferMgr*>& peer_mgrs) { peer_mgrs_ = peer_mgrs; }
+
+  void deleteBuffer(const ChunkKey& key, const bool purge = true) override;
+
+  // Falls back to managed memory when the pool is out of memory, if enabled.
+  AbstractBuffer* alloc(const size_t num_bytes = 0) override;
+  void free(AbstractBuffer* buffer) override;
+
+  // Decodes `num_elems` values of `byte_width` bytes from the integer codec stream
+  // `src` to `dst`, both in the memory of the current device.
+  using ChunkDecoder = std::function<void(int8_t* dst,
+                                          const int8_t* src,
+                                          const integer_codecs::IntegerCodec codec,
+                                          const size_t byte_width,
+                                          const size_t num_elems,
+                                          const int64_t null_val)>;
+  // The decoder is a CUDA kernel of the QueryEngine, the chunks are not compressed
+  // until it is set.
+  static void setChunkDecoder(ChunkDecoder chunk_decoder);
+
+ protected:
+  void fetchMissingBuffer(const ChunkKey& key,
+                          AbstractBuffer* dest_buffer,
+                          const size_t num_bytes) override;
+  double getRefetchCost(const ChunkKey& chunk_key) override;
+  bool hasRefetchCosts() const override;
+
  private:
-  void addSlab(const size_t slab_size) override;
+  struct CompressedChunk {
+    integer_codecs::IntegerCodec codec;
+    size_t byte_width;
+    size_t num_bytes;  // decoded
+    int64_t null_val;
+  };
+
+  static ChunkKey getCompressedChunkKey(const ChunkKey& key);
+  bool fetchBufferFromPeer(const ChunkKey& key,
+                           AbstractBuffer* dest_buffer,
+                           const size_t num_bytes);
+  bool fetchBufferFromCompressedCopy(const ChunkKey& key,
+                                     AbstractBuffer* dest_buffer,
+                                     const size_t num_bytes);
+  void addCompressedCopy(const ChunkKey& key,
+                         AbstractBuffer* buffer,
+                         const size_t num_bytes);
+
+  void addSlab(const size_t slab_size, const int numa_node) override;
   void freeAllMem() override;
   void allocateBuffer(BufferList::iterator seg_it,
                       const size_t page_size,
                       const size_t initial_size) override;
   CudaMgr_Namespace::CudaMgr* cuda_mgr_;
+  std::vector<BufferMgr*> peer_mgrs_;
+
+  // the compressed copies by the key of their chunk, an entry can outlive its copy
+  std::mutex compressed_chunks_mutex_;
+  std::map<ChunkKey, CompressedChunk> compressed_chunks_;
+
+  std::mutex managed_buffers_mutex_;
+  std::unordered_set<AbstractBuffer*> managed_buffers_;
+  size_t managed_bytes_{0};
+
+  static ChunkDecoder chunk_decoder_;
 };
 
 }  // namespace Buffer_Namespace
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/BufferMgr/GpuCudaBufferMgr/ManagedCudaBuffer.h"
+
+#include <algorithm>
+
+#include "CudaMgr/CudaMgr.h"
+#include "Logger/Logger.h"
+
+namespace Buffer_Namespace {
+
+ManagedCudaBuffer::ManagedCudaBuffer(const int device_id,
+                                     CudaMgr_Namespace::CudaMgr* cuda_mgr,
+                                     const size_t num_bytes)
+    : AbstractBuffer(device_id)
+    , cuda_mgr_(cuda_mgr)
+    , mem_(cuda_mgr->allocateManagedMem(num_bytes, device_id))
+    , reserved_size_(num_bytes) {}
+
+ManagedCudaBuffer::~ManagedCudaBuffer() {
+  cuda_mgr_->freeDeviceMem(mem_);
+}
+
+void ManagedCudaBuffer::read(int8_t* const dst,
+                             const size_t num_bytes,
+                             const size_t offset,
+                             const Data_Namespace::MemoryLevel dst_buffer_type,
+                             const int dst_device_id) {
+  CHECK_LE(offset + num_bytes, reserved_size_);
+  if (dst_buffer_type == Data_Namespace::CPU_LEVEL) {
+    cuda_mgr_->copyDeviceToHost(dst, mem_ + offset, num_bytes, device_id_);
+  } else if (dst_buffer_type == Data_Namespace::GPU_LEVEL) {
+    cuda_mgr_->copyDeviceToDevice(
+        dst, mem_ + offset, num_bytes, dst_device_id, device_id_);
+  } else {
+    LOG(FATAL) << "Unsupported buffer type";
+  }
+}
+
+void ManagedCudaBuffer::write(int8_t* src,
+                              const size_t num_bytes,
+                              const size_t offset,
+                              const Data_Namespace::MemoryLevel src_buffer_type,
+                              const int src_device_id) {
+  CHECK_LE(offset + num_bytes, reserved_size_);
+  if (src_buffer_type == Data_Namespace::CPU_LEVEL) {
+    cuda_mgr_->copyHostToDevice(mem_ + offset, src, num_bytes, device_id_);
+  } else if (src_buffer_type == Data_Namespace::GPU_LEVEL) {
+    CHECK_GE(src_device_id, 0);
+    cuda_mgr_->copyDeviceToDevice(
+        mem_ + offset, src, num_bytes, device_id_, src_device_id);
+  } else {
+    LOG(FATAL) << "Unsupported buffer type";
+  }
+  setSize(std::max(size_, offset + num_bytes));
+  setUpdated();
+}
+
+void ManagedCudaBuffer::reserve(size_t num_bytes) {
+  // the managed buffers are allocated once, at their final size
+  CHECK_LE(num_bytes, reserved_size_);
+}
+
+void ManagedCudaBuffer::append(int8_t* src,
+                               const size_t num_bytes,
+                               const Data_Namespace::MemoryLevel src_buffer_type,
+                               const int device_id) {
+  write(src, num_bytes, size_, src_buffer_type, device_id);
+  setAppended();
+}
+
+}  // namespace Buffer_Namespace
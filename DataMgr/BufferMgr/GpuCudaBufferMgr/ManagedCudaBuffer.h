@@ -0,0 +1,72 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "DataMgr/AbstractBuffer.h"
+
+namespace CudaMgr_Namespace {
+class CudaMgr;
+}
+
+namespace Buffer_Namespace {
+
+// A GPU buffer of a fixed size outside of the buffer pool, in CUDA managed memory the
+// device can oversubscribe. Allocated by the GPU buffer manager when the pool can't fit
+// a buffer which isn't a chunk.
+class ManagedCudaBuffer : public Data_Namespace::AbstractBuffer {
+ public:
+  ManagedCudaBuffer(const int device_id,
+                    CudaMgr_Namespace::CudaMgr* cuda_mgr,
+                    const size_t num_bytes);
+  ~ManagedCudaBuffer() override;
+
+  void read(int8_t* const dst,
+            const size_t num_bytes,
+            const size_t offset = 0,
+            const Data_Namespace::MemoryLevel dst_buffer_type = Data_Namespace::CPU_LEVEL,
+            const int dst_device_id = -1) override;
+  void write(int8_t* src,
+             const size_t num_bytes,
+             const size_t offset = 0,
+             const Data_Namespace::MemoryLevel src_buffer_type = Data_Namespace::CPU_LEVEL,
+             const int src_device_id = -1) override;
+  void reserve(size_t num_bytes) override;
+  void append(int8_t* src,
+              const size_t num_bytes,
+              const Data_Namespace::MemoryLevel src_buffer_type = Data_Namespace::CPU_LEVEL,
+              const int device_id = -1) override;
+
+  int8_t* getMemoryPtr() override { return mem_; }
+  size_t pageCount() const override { return 1; }
+  size_t pageSize() const override { return reserved_size_; }
+  size_t reservedSize() const override { return reserved_size_; }
+  Data_Namespace::MemoryLevel getType() const override {
+    return Data_Namespace::GPU_LEVEL;
+  }
+
+  int pin() override { return ++pin_count_; }
+  int unPin() override { return --pin_count_; }
+  int getPinCount() override { return pin_count_; }
+
+ private:
+  CudaMgr_Namespace::CudaMgr* cuda_mgr_;
+  int8_t* mem_;
+  const size_t reserved_size_;
+  int pin_count_{1};
+};
+
+}  // namespace Buffer_Namespace
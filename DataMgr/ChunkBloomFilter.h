@@ -0,0 +1,85 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ChunkBloomFilter.h
+ * @brief   Bloom filter over the integer values of a chunk.
+ *
+ * Built by the integer and dictionary encoded string encoders as values are appended
+ * and attached to the chunk metadata, so that a fragment can be skipped when none of
+ * the values an equality or IN filter looks for may be in it. Unlike min / max, the
+ * filter does help with point lookups on columns whose values are spread over every
+ * fragment, such as dictionary ids. A filter which has seen many distinct values just
+ * stops excluding any, it is never wrong.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+extern bool g_enable_chunk_bloom_filters;
+
+class ChunkBloomFilter {
+ public:
+  ChunkBloomFilter() : words_(kBitCount / 64, 0), value_count_(0) {}
+
+  void add(const int64_t val) {
+    auto h1 = hash(val);
+    const auto h2 = (h1 >> 32) | 1;
+    for (size_t i = 0; i < kHashCount; ++i, h1 += h2) {
+      const auto bit = h1 & (kBitCount - 1);
+      words_[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    ++value_count_;
+  }
+
+  // False only if `val` has never been added.
+  bool mayContain(const int64_t val) const {
+    auto h1 = hash(val);
+    const auto h2 = (h1 >> 32) | 1;
+    for (size_t i = 0; i < kHashCount; ++i, h1 += h2) {
+      const auto bit = h1 & (kBitCount - 1);
+      if (!(words_[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The number of values added, including repeated ones.
+  size_t valueCount() const { return value_count_; }
+
+ private:
+  static uint64_t hash(const int64_t val) {
+    // finalizer of MurmurHash3
+    auto h = static_cast<uint64_t>(val);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb3f99be8fc81ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  // 64KB per chunk, about 1% false positives with 50K distinct values
+  static constexpr size_t kBitCount{size_t(1) << 19};
+  static constexpr size_t kHashCount{4};
+
+  std::vector<uint64_t> words_;
+  size_t value_count_;
+};
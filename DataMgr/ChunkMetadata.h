@@ -16,8 +16,14 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <memory>
+#include <optional>
 #include "../Shared/sqltypes.h"
+#include "ChunkBloomFilter.h"
+#include "GeoGridChunkIndex.h"
+#include "SortedChunkIndex.h"
 #include "Shared/types.h"
 
 #include "Logger/Logger.h"
@@ -33,6 +39,15 @@ struct ChunkMetadata {
   size_t numBytes;
   size_t numElements;
   ChunkStats chunkStats;
+  // the values of the chunk, if its encoder has seen all of them
+  std::shared_ptr<const ChunkBloomFilter> bloomFilter;
+  // built by the first query which needs it, accessed with std::atomic_load / store
+  std::shared_ptr<const SortedChunkIndex> sortedIndex;
+  // of a chunk of geo bounds, accessed like sortedIndex
+  std::shared_ptr<const GeoGridChunkIndex> geoGridIndex;
+  // xmin, ymin, xmax, ymax of the boxes of a chunk of geo bounds, if its encoder has seen
+  // all of them
+  std::optional<std::array<double, 4>> geoBounds;
 
   std::string dump() {
     return "numBytes: " + to_string(numBytes) + " numElements " + to_string(numElements) +
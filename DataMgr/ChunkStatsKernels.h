@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ChunkStatsKernels.h
+ * @brief   Min, max and nulls of a block of appended values.
+ *
+ * The loops have no branch and no early exit: nulls are replaced by the neutral value of
+ * the min and of the max and counted, so that the compiler vectorizes them for every
+ * element type. The encoders run them over the whole appended block, then fold the
+ * block stats into the chunk stats.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace chunk_stats {
+
+template <typename T>
+struct BlockStats {
+  T min{std::numeric_limits<T>::max()};
+  T max{std::numeric_limits<T>::lowest()};
+  bool has_nulls{false};
+
+  // false if every value of the block is null
+  bool hasValues() const { return min <= max; }
+};
+
+template <typename T>
+BlockStats<T> compute_block_stats(const T* data,
+                                  const size_t num_elems,
+                                  const T null_val) {
+  constexpr T neutral_min = std::numeric_limits<T>::max();
+  constexpr T neutral_max = std::numeric_limits<T>::lowest();
+  T min = neutral_min;
+  T max = neutral_max;
+  size_t null_count = 0;
+  for (size_t i = 0; i < num_elems; ++i) {
+    const T val = data[i];
+    const bool is_null = val == null_val;
+    null_count += is_null;
+    min = std::min(min, is_null ? neutral_min : val);
+    max = std::max(max, is_null ? neutral_max : val);
+  }
+  return {min, max, null_count > 0};
+}
+
+/**
+ * Narrows `src` into `dst` and computes the stats of the block, with the minimum of V as
+ * the null sentinel. Returns false if a value doesn't fit in V, in which case the stats
+ * are not meaningful and the caller falls back to encoding element by element.
+ */
+template <typename T, typename V>
+bool encode_block(const T* src, V* dst, const size_t num_elems, BlockStats<T>& stats) {
+  constexpr T neutral_min = std::numeric_limits<T>::max();
+  constexpr T neutral_max = std::numeric_limits<T>::lowest();
+  constexpr T null_val = static_cast<T>(std::numeric_limits<V>::min());
+  T min = neutral_min;
+  T max = neutral_max;
+  size_t null_count = 0;
+  size_t overflow_count = 0;
+  for (size_t i = 0; i < num_elems; ++i) {
+    const T val = src[i];
+    const V encoded = static_cast<V>(val);
+    dst[i] = encoded;
+    overflow_count += static_cast<T>(encoded) != val;
+    const bool is_null = val == null_val;
+    null_count += is_null;
+    min = std::min(min, is_null ? neutral_min : val);
+    max = std::max(max, is_null ? neutral_max : val);
+  }
+  stats = {min, max, null_count > 0};
+  return overflow_count == 0;
+}
+
+}  // namespace chunk_stats
@@ -24,8 +24,10 @@
 #include "BufferMgr/GpuCudaBufferMgr/GpuCudaBufferMgr.h"
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/ForeignStorage/ForeignStorageCache.h"
+#include "DataMgr/ForeignStorage/ForeignStorageInterface.h"
 #include "FileMgr/GlobalFileMgr.h"
 #include "PersistentStorageMgr/PersistentStorageMgr.h"
+#include "Shared/HugePages.h"
 
 #ifdef __APPLE__
 #include <sys/sysctl.h>
@@ -39,6 +41,8 @@
 
 extern bool g_enable_fsi;
 
+bool g_enable_gpu_peer_access{false};
+
 namespace Data_Namespace {
 
 DataMgr::DataMgr(const std::string& dataDir,
@@ -242,6 +246,19 @@ void DataMgr::populateMgrs(const SystemParameters& system_parameters,
                                                                       bufferMgrs_[1][0]));
     }
     levelSizes_.push_back(numGpus);
+    if (g_enable_gpu_peer_access && numGpus > 1 && cudaMgr_->enablePeerAccess()) {
+      for (int gpuNum = 0; gpuNum < numGpus; ++gpuNum) {
+        std::vector<Buffer_Namespace::BufferMgr*> peer_mgrs;
+        for (int peerNum = 0; peerNum < numGpus; ++peerNum) {
+          if (cudaMgr_->canAccessPeer(gpuNum, peerNum)) {
+            peer_mgrs.push_back(
+                static_cast<Buffer_Namespace::BufferMgr*>(bufferMgrs_[2][peerNum]));
+          }
+        }
+        static_cast<Buffer_Namespace::GpuCudaBufferMgr*>(bufferMgrs_[2][gpuNum])
+            ->setPeerMgrs(peer_mgrs);
+      }
+    }
   } else {
     bufferMgrs_[1].push_back(new Buffer_Namespace::CpuBufferMgr(0,
                                                                 cpuBufferSize,
@@ -316,9 +333,15 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
     mi.maxNumPages = cpu_buffer->getMaxSize() / mi.pageSize;
     mi.isAllocationCapped = cpu_buffer->isAllocationCapped();
     mi.numPageAllocated = cpu_buffer->getAllocated() / mi.pageSize;
+    mi.evictionPolicy = cpu_buffer->getEvictionPolicyName();
+    mi.tableEvictionCounts = cpu_buffer->getTableEvictionCounts();
+    mi.hugePageMode = g_huge_pages;
+    const auto huge_page_stats = huge_pages::get_stats();
+    mi.hugePageBytes = huge_page_stats.transparent_bytes + huge_page_stats.hugetlb_bytes;
 
     const auto& slab_segments = cpu_buffer->getSlabSegments();
     for (size_t slab_num = 0; slab_num < slab_segments.size(); ++slab_num) {
+      const auto numa_node = cpu_buffer->getSlabNumaNode(slab_num);
       for (auto segment : slab_segments[slab_num]) {
         MemoryData md;
         md.slabNum = slab_num;
@@ -326,9 +349,16 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
         md.numPages = segment.num_pages;
         md.touch = segment.last_touched;
         md.memStatus = segment.mem_status;
+        md.numaNode = numa_node;
         md.chunk_key.insert(
             md.chunk_key.end(), segment.chunk_key.begin(), segment.chunk_key.end());
         mi.nodeMemoryData.push_back(md);
+        if (numa_node >= 0) {
+          if (mi.numaNodeNumPagesAllocated.size() <= static_cast<size_t>(numa_node)) {
+            mi.numaNodeNumPagesAllocated.resize(numa_node + 1, 0);
+          }
+          mi.numaNodeNumPagesAllocated[numa_node] += segment.num_pages;
+        }
       }
     }
     mem_info.push_back(mi);
@@ -345,6 +375,8 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
       mi.maxNumPages = gpu_buffer->getMaxSize() / mi.pageSize;
       mi.isAllocationCapped = gpu_buffer->isAllocationCapped();
       mi.numPageAllocated = gpu_buffer->getAllocated() / mi.pageSize;
+      mi.evictionPolicy = gpu_buffer->getEvictionPolicyName();
+      mi.tableEvictionCounts = gpu_buffer->getTableEvictionCounts();
 
       const auto& slab_segments = gpu_buffer->getSlabSegments();
       for (size_t slab_num = 0; slab_num < slab_segments.size(); ++slab_num) {
@@ -401,6 +433,60 @@ void DataMgr::clearMemory(const MemoryLevel memLevel) {
   }
 }
 
+size_t DataMgr::compactMemory(const MemoryLevel memLevel) {
+  std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
+  CHECK(memLevel == MemoryLevel::CPU_LEVEL || memLevel == MemoryLevel::GPU_LEVEL);
+  size_t num_moved{0};
+  if (static_cast<size_t>(memLevel) >= levelSizes_.size()) {
+    return num_moved;
+  }
+  for (int device = 0; device < levelSizes_[memLevel]; ++device) {
+    auto buffer_mgr =
+        dynamic_cast<Buffer_Namespace::BufferMgr*>(bufferMgrs_[memLevel][device]);
+    CHECK(buffer_mgr);
+    num_moved += buffer_mgr->compactSlabs();
+  }
+  return num_moved;
+}
+
+std::vector<ChunkKey> DataMgr::getHotChunkKeys(const MemoryLevel memLevel,
+                                               const int deviceId) {
+  return getBufferMgr(memLevel, deviceId)->getHotChunkKeys();
+}
+
+size_t DataMgr::getFreeBufferPoolBytes(const MemoryLevel memLevel, const int deviceId) {
+  auto buffer_mgr = getBufferMgr(memLevel, deviceId);
+  const auto in_use_bytes = buffer_mgr->getInUseSize();
+  const auto max_bytes = buffer_mgr->getMaxSize();
+  return max_bytes > in_use_bytes ? max_bytes - in_use_bytes : 0;
+}
+
+Buffer_Namespace::BufferMgr* DataMgr::getBufferMgr(const MemoryLevel memLevel,
+                                                   const int deviceId) {
+  std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
+  CHECK_LT(static_cast<size_t>(memLevel), bufferMgrs_.size());
+  CHECK_LT(static_cast<size_t>(deviceId), bufferMgrs_[memLevel].size());
+  auto buffer_mgr =
+      dynamic_cast<Buffer_Namespace::BufferMgr*>(bufferMgrs_[memLevel][deviceId]);
+  CHECK(buffer_mgr);
+  return buffer_mgr;
+}
+
+bool DataMgr::reserveQueryMemory(const MemoryLevel memLevel,
+                                 const int deviceId,
+                                 const size_t numBytes,
+                                 const std::chrono::milliseconds timeout) {
+  CHECK(memLevel == MemoryLevel::CPU_LEVEL || memLevel == MemoryLevel::GPU_LEVEL);
+  // do not hold the buffer access mutex while waiting for other queries to finish
+  return getBufferMgr(memLevel, deviceId)->reserveQueryMemory(numBytes, timeout);
+}
+
+void DataMgr::releaseQueryMemory(const MemoryLevel memLevel,
+                                 const int deviceId,
+                                 const size_t numBytes) {
+  getBufferMgr(memLevel, deviceId)->releaseQueryMemory(numBytes);
+}
+
 bool DataMgr::isBufferOnDevice(const ChunkKey& key,
                                const MemoryLevel memLevel,
                                const int deviceId) {
@@ -430,6 +516,21 @@ AbstractBuffer* DataMgr::getChunkBuffer(const ChunkKey& key,
   const auto level = static_cast<size_t>(memoryLevel);
   CHECK_LT(level, levelSizes_.size());     // make sure we have a legit buffermgr
   CHECK_LT(deviceId, levelSizes_[level]);  // make sure we have a legit buffermgr
+  if (memoryLevel == CPU_LEVEL && key.size() == 4) {
+    // the chunks of tables registered with a foreign storage are used in place if the
+    // storage already keeps them in memory, rather than copied into the CPU buffer pool
+    auto foreign_buffer_mgr =
+        ForeignStorageInterface::lookupBufferManager(key[CHUNK_KEY_DB_IDX],
+                                                     key[CHUNK_KEY_TABLE_IDX]);
+    if (foreign_buffer_mgr) {
+      auto foreign_buffer =
+          dynamic_cast<ForeignStorageBuffer*>(foreign_buffer_mgr->getBuffer(key));
+      if (foreign_buffer && (!numBytes || numBytes == foreign_buffer->size()) &&
+          foreign_buffer->tryZeroCopy(foreign_buffer->size())) {
+        return foreign_buffer;
+      }
+    }
+  }
   return bufferMgrs_[level][deviceId]->getBuffer(key, numBytes);
 }
 
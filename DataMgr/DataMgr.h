@@ -55,6 +55,7 @@ struct MemoryData {
   uint32_t touch;
   std::vector<int32_t> chunk_key;
   Buffer_Namespace::MemStatus memStatus;
+  int32_t numaNode{-1};  // NUMA node of the slab, -1 if not homed
 };
 
 struct MemoryInfo {
@@ -63,6 +64,13 @@ struct MemoryInfo {
   size_t numPageAllocated;
   bool isAllocationCapped;
   std::vector<MemoryData> nodeMemoryData;
+  std::vector<size_t> numaNodeNumPagesAllocated;  // slab pages homed on each NUMA node
+  std::string evictionPolicy;
+  // chunks evicted since startup by {db id, table id}
+  std::map<std::vector<int32_t>, Buffer_Namespace::EvictionCounts> tableEvictionCounts;
+  // CPU memory of the slabs and query arenas backed by huge pages, see g_huge_pages
+  std::string hugePageMode;
+  size_t hugePageBytes{0};
 };
 
 //! Parse /proc/meminfo into key/value pairs.
@@ -192,6 +200,20 @@ class DataMgr {
   std::vector<MemoryInfo> getMemoryInfo(const MemoryLevel memLevel);
   std::string dumpLevel(const MemoryLevel memLevel);
   void clearMemory(const MemoryLevel memLevel);
+  // Compacts the slabs of the buffer pools of the level, returns how many buffers moved.
+  size_t compactMemory(const MemoryLevel memLevel);
+  // Keys of the chunks held by the buffer pool of a device, the ones its eviction policy
+  // would keep the longest first.
+  std::vector<ChunkKey> getHotChunkKeys(const MemoryLevel memLevel, const int deviceId);
+  // Bytes of the buffer pool of a device which no buffer holds, slabs to come included.
+  size_t getFreeBufferPoolBytes(const MemoryLevel memLevel, const int deviceId);
+  bool reserveQueryMemory(const MemoryLevel memLevel,
+                          const int deviceId,
+                          const size_t numBytes,
+                          const std::chrono::milliseconds timeout);
+  void releaseQueryMemory(const MemoryLevel memLevel,
+                          const int deviceId,
+                          const size_t numBytes);
 
   const std::map<ChunkKey, File_Namespace::FileBuffer*>& getChunkMap();
   void checkpoint(const int db_id,
@@ -240,6 +262,9 @@ class DataMgr {
   std::string dataDir_;
   bool hasGpus_;
   size_t reservedGpuMem_;
+  Buffer_Namespace::BufferMgr* getBufferMgr(const MemoryLevel memLevel,
+                                            const int deviceId);
+
   std::mutex buffer_access_mutex_;
 };
 
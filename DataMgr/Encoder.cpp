@@ -23,6 +23,8 @@
 #include "NoneEncoder.h"
 #include "StringNoneEncoder.h"
 
+bool g_enable_chunk_bloom_filters{false};
+
 Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
                          const SQLTypeInfo sqlType) {
   switch (sqlType.get_compression()) {
@@ -228,4 +230,24 @@ void Encoder::getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) {
   chunkMetadata->sqlType = buffer_->getSqlType();
   chunkMetadata->numBytes = buffer_->size();
   chunkMetadata->numElements = num_elems_;
+  // a filter which missed some of the values, for example of a chunk whose metadata
+  // was read from disk, would exclude values which are there
+  chunkMetadata->bloomFilter = bloom_filter_ && bloom_filter_->valueCount() == num_elems_
+                                   ? bloom_filter_
+                                   : nullptr;
+  // the values may have changed since the index was built
+  std::atomic_store(&chunkMetadata->sortedIndex,
+                    std::shared_ptr<const SortedChunkIndex>());
+  std::atomic_store(&chunkMetadata->geoGridIndex,
+                    std::shared_ptr<const GeoGridChunkIndex>());
+}
+
+void Encoder::initBloomFilter() {
+  if (!g_enable_chunk_bloom_filters || !buffer_) {
+    return;
+  }
+  const auto& ti = buffer_->getSqlType();
+  if (ti.is_integer() || ti.is_time() || ti.is_dict_encoded_string()) {
+    bloom_filter_ = std::make_shared<ChunkBloomFilter>();
+  }
 }
@@ -20,6 +20,7 @@
 #include "../Shared/DateConverters.h"
 #include "../Shared/sqltypes.h"
 #include "../Shared/types.h"
+#include "ChunkBloomFilter.h"
 #include "ChunkMetadata.h"
 
 #include <cmath>
@@ -226,12 +227,43 @@ class Encoder {
   void setNumElems(const size_t num_elems) { num_elems_ = num_elems; }
 
  protected:
+  // Starts a Bloom filter of the appended values if enabled for the type of the chunk.
+  void initBloomFilter();
+
+  // Called before adding the values of an append, the metadata handed out so far keeps
+  // the filter it has seen.
+  void detachBloomFilter() {
+    if (bloom_filter_.use_count() > 1) {
+      bloom_filter_ = std::make_shared<ChunkBloomFilter>(*bloom_filter_);
+    }
+  }
+
+  void addToBloomFilter(const int64_t val) {
+    if (bloom_filter_) {
+      bloom_filter_->add(val);
+    }
+  }
+
+  template <typename T>
+  void addToBloomFilter(const T* vals, const size_t num_vals) {
+    if (bloom_filter_) {
+      for (size_t i = 0; i < num_vals; ++i) {
+        bloom_filter_->add(static_cast<int64_t>(vals[i]));
+      }
+    }
+  }
+
+  // The chunk is modified other than by appends, its filter can't be trusted anymore.
+  void invalidateBloomFilter() { bloom_filter_ = nullptr; }
+
   size_t num_elems_;
 
   Data_Namespace::AbstractBuffer* buffer_;
 
   DecimalOverflowValidator decimal_overflow_validator_;
   DateDaysOverflowValidator date_days_overflow_validator_;
+
+  std::shared_ptr<ChunkBloomFilter> bloom_filter_;
 };
 
 #endif  // Encoder_h
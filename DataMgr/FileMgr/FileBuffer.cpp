@@ -22,21 +22,63 @@
 
 #include "DataMgr/FileMgr/FileBuffer.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <future>
 #include <map>
 #include <thread>
 
 #include "DataMgr/FileMgr/FileMgr.h"
+#include "Shared/Compressor.h"
 #include "Shared/File.h"
 #include "Shared/checked_alloc.h"
+#include "Shared/scope.h"
 
 #define METADATA_PAGE_SIZE 4096
 
 using namespace std;
 
+bool g_enable_varlen_page_compression{false};
+
 namespace File_Namespace {
 size_t FileBuffer::headerBufferOffset_ = 32;
 
+namespace {
+
+// The page sizes of the compressed pages, as fractions of the buffer page size, from the
+// smallest. Pages of the data of the varlen columns are of several MB, so the smallest
+// compressed pages still are far larger than a block of the file system.
+constexpr size_t kCompressedPageSizeDivisors[]{16, 8, 4, 2};
+
+// Layout of the pages in the header index: version count, then file id, epoch and page
+// number of every version.
+void write_page_versions(FILE* f, const MultiPage& multiPage) {
+  int numVersions = multiPage.pageVersions.size();
+  fwrite((int8_t*)&numVersions, sizeof(int), 1, f);
+  for (int i = 0; i < numVersions; ++i) {
+    const auto& page = multiPage.pageVersions[i];
+    int version[2] = {page.fileId, multiPage.epochs[i]};
+    fwrite((int8_t*)version, sizeof(int), 2, f);
+    fwrite((int8_t*)&page.pageNum, sizeof(size_t), 1, f);
+  }
+}
+
+void read_page_versions(FILE* f, MultiPage& multiPage) {
+  int numVersions;
+  CHECK_EQ(fread((int8_t*)&numVersions, sizeof(int), 1, f), 1U);
+  for (int i = 0; i < numVersions; ++i) {
+    int version[2];
+    Page page;
+    CHECK_EQ(fread((int8_t*)version, sizeof(int), 2, f), 2U);
+    CHECK_EQ(fread((int8_t*)&page.pageNum, sizeof(size_t), 1, f), 1U);
+    page.fileId = version[0];
+    multiPage.push(page, version[1]);
+  }
+}
+
+}  // namespace
+
 FileBuffer::FileBuffer(FileMgr* fm,
                        const size_t pageSize,
                        const ChunkKey& chunkKey,
@@ -133,6 +175,25 @@ FileBuffer::FileBuffer(FileMgr* fm,
   // size_ = lastHeaderIt->chunkSize;
 }
 
+FileBuffer::FileBuffer(FileMgr* fm, const ChunkKey& chunkKey, FILE* headerIndexFile)
+    : AbstractBuffer(fm->getDeviceId())
+    , fm_(fm)
+    , metadataPages_(METADATA_PAGE_SIZE)
+    , pageSize_(0)
+    , chunkKey_(chunkKey) {
+  CHECK(fm_);
+  calcHeaderBuffer();
+  readMetadataFields(headerIndexFile);
+  pageDataSize_ = pageSize_ - reservedHeaderSize_;
+  read_page_versions(headerIndexFile, metadataPages_);
+  size_t numMultiPages;
+  CHECK_EQ(fread((int8_t*)&numMultiPages, sizeof(size_t), 1, headerIndexFile), 1U);
+  multiPages_.resize(numMultiPages, MultiPage(pageSize_));
+  for (auto& multiPage : multiPages_) {
+    read_page_versions(headerIndexFile, multiPage);
+  }
+}
+
 FileBuffer::~FileBuffer() {
   // need to free pages
   // NOP
@@ -212,6 +273,52 @@ static size_t readForThread(FileBuffer* fileBuffer, const readThreadDS threadDS)
   size_t totalBytesRead = 0;
   bool isFirstPage = threadDS.t_isFirstPage;
 
+  if (g_enable_direct_file_reads) {
+    // Pages which follow each other in a file as well as in the buffer are read at once,
+    // up to a bounded size which the direct reads go through.
+    constexpr size_t kMaxPagesPerRead{16};
+    for (size_t pageNum = startPage; pageNum < endPage;) {
+      CHECK(threadDS.multiPages[pageNum].pageSize == fileBuffer->pageSize());
+      const Page page = threadDS.multiPages[pageNum].current();
+      if (fileBuffer->isCompressedPage(page)) {
+        const auto bytesRead = fileBuffer->readCompressedPage(
+            page, isFirstPage ? threadDS.t_startPageOffset : 0, bytesLeft, curPtr);
+        isFirstPage = false;
+        curPtr += bytesRead;
+        bytesLeft -= bytesRead;
+        totalBytesRead += bytesRead;
+        ++pageNum;
+        continue;
+      }
+      // compressed pages are in files of another page size, and end the run
+      size_t numPages = 1;
+      while (pageNum + numPages < endPage && numPages < kMaxPagesPerRead) {
+        const Page nextPage = threadDS.multiPages[pageNum + numPages].current();
+        if (nextPage.fileId != page.fileId ||
+            nextPage.pageNum != page.pageNum + numPages) {
+          break;
+        }
+        ++numPages;
+      }
+      FileInfo* fileInfo = threadDS.t_fm->getFileInfoForFileId(page.fileId);
+      CHECK(fileInfo);
+      const auto bytesRead =
+          fileInfo->readPages(page.pageNum,
+                              numPages,
+                              fileBuffer->reservedHeaderSize(),
+                              isFirstPage ? threadDS.t_startPageOffset : 0,
+                              bytesLeft,
+                              curPtr);
+      isFirstPage = false;
+      curPtr += bytesRead;
+      bytesLeft -= bytesRead;
+      totalBytesRead += bytesRead;
+      pageNum += numPages;
+    }
+    CHECK(bytesLeft == 0);
+    return totalBytesRead;
+  }
+
   // Traverse the logical pages
   for (size_t pageNum = startPage; pageNum < endPage; ++pageNum) {
     CHECK(threadDS.multiPages[pageNum].pageSize == fileBuffer->pageSize());
@@ -223,7 +330,11 @@ static size_t readForThread(FileBuffer* fileBuffer, const readThreadDS threadDS)
     // Read the page into the destination (dst) buffer at its
     // current (cur) location
     size_t bytesRead = 0;
-    if (isFirstPage) {
+    if (fileBuffer->isCompressedPage(page)) {
+      bytesRead = fileBuffer->readCompressedPage(
+          page, isFirstPage ? threadDS.t_startPageOffset : 0, bytesLeft, curPtr);
+      isFirstPage = false;
+    } else if (isFirstPage) {
       bytesRead = fileInfo->read(
           page.pageNum * fileBuffer->pageSize() + threadDS.t_startPageOffset +
               fileBuffer->reservedHeaderSize(),
@@ -354,13 +465,18 @@ void FileBuffer::copyPage(Page& srcPage,
                           const size_t offset) {
   // FILE *srcFile = fm_->files_[srcPage.fileId]->f;
   // FILE *destFile = fm_->files_[destPage.fileId]->f;
-  CHECK(offset + numBytes < pageDataSize_);
+  CHECK(offset + numBytes <= pageDataSize_);
   FileInfo* srcFileInfo = fm_->getFileInfoForFileId(srcPage.fileId);
   FileInfo* destFileInfo = fm_->getFileInfoForFileId(destPage.fileId);
 
   int8_t* buffer = reinterpret_cast<int8_t*>(checked_malloc(numBytes));
-  size_t bytesRead = srcFileInfo->read(
-      srcPage.pageNum * pageSize_ + offset + reservedHeaderSize_, numBytes, buffer);
+  size_t bytesRead;
+  if (isCompressedPage(srcPage)) {
+    bytesRead = readCompressedPage(srcPage, offset, numBytes, buffer);
+  } else {
+    bytesRead = srcFileInfo->read(
+        srcPage.pageNum * pageSize_ + offset + reservedHeaderSize_, numBytes, buffer);
+  }
   CHECK(bytesRead == numBytes);
   size_t bytesWritten = destFileInfo->write(
       destPage.pageNum * pageSize_ + offset + reservedHeaderSize_, numBytes, buffer);
@@ -368,6 +484,115 @@ void FileBuffer::copyPage(Page& srcPage,
   free(buffer);
 }
 
+bool FileBuffer::isCompressedPage(const Page& page) const {
+  return fm_->getFileInfoForFileId(page.fileId)->pageSize != pageSize_;
+}
+
+size_t FileBuffer::readCompressedPage(const Page& page,
+                                      const size_t pageOffset,
+                                      const size_t numBytes,
+                                      int8_t* dst) {
+  CHECK_LT(pageOffset, pageDataSize_);
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  std::vector<uint8_t> compressed(fileInfo->pageSize - reservedHeaderSize_);
+  CHECK_EQ(fileInfo->read(page.pageNum * fileInfo->pageSize + reservedHeaderSize_,
+                          compressed.size(),
+                          reinterpret_cast<int8_t*>(compressed.data())),
+           compressed.size());
+  const auto bytesRead = std::min(pageDataSize_ - pageOffset, numBytes);
+  if (bytesRead == pageDataSize_) {
+    BloscCompressor::getCompressor()->decompressFast(
+        compressed.data(), reinterpret_cast<uint8_t*>(dst), pageDataSize_);
+    return bytesRead;
+  }
+  std::vector<uint8_t> data(pageDataSize_);
+  BloscCompressor::getCompressor()->decompressFast(
+      compressed.data(), data.data(), pageDataSize_);
+  std::memcpy(dst, data.data() + pageOffset, bytesRead);
+  return bytesRead;
+}
+
+bool FileBuffer::isCompressible() const {
+  return g_enable_varlen_page_compression && hasEncoder() &&
+         sql_type_.is_varlen_indeed();
+}
+
+bool FileBuffer::writeCompressedPage(const size_t pageNum,
+                                     const int8_t* data,
+                                     const int epoch) {
+  CHECK_LE(pageNum, multiPages_.size());
+  std::vector<uint8_t> compressed(pageSize_ / 2 - reservedHeaderSize_);
+  const auto compressedSize = BloscCompressor::getCompressor()->compressFast(
+      reinterpret_cast<const uint8_t*>(data),
+      pageDataSize_,
+      compressed.data(),
+      compressed.size(),
+      1);
+  if (compressedSize <= 0) {
+    return false;
+  }
+  size_t compressedPageSize{0};
+  for (const auto divisor : kCompressedPageSizeDivisors) {
+    const auto candidatePageSize = pageSize_ / divisor;
+    if (pageSize_ % divisor == 0 && candidatePageSize >= METADATA_PAGE_SIZE &&
+        candidatePageSize >= reservedHeaderSize_ + compressedSize) {
+      compressedPageSize = candidatePageSize;
+      break;
+    }
+  }
+  if (!compressedPageSize) {
+    return false;
+  }
+  Page page = fm_->requestFreePage(compressedPageSize, false);
+  writeHeader(page, pageNum, epoch);
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  CHECK_EQ(fileInfo->write(page.pageNum * compressedPageSize + reservedHeaderSize_,
+                           compressedSize,
+                           reinterpret_cast<int8_t*>(compressed.data())),
+           static_cast<size_t>(compressedSize));
+  if (pageNum == multiPages_.size()) {
+    MultiPage multiPage(pageSize_);
+    multiPage.push(page, epoch);
+    multiPages_.push_back(multiPage);
+  } else if (multiPages_[pageNum].epochs.back() < epoch) {
+    // the version of the last checkpoint is kept
+    multiPages_[pageNum].push(page, epoch);
+  } else {
+    const Page uncompressedPage = multiPages_[pageNum].current();
+    multiPages_[pageNum].pageVersions.back() = page;
+    fm_->getFileInfoForFileId(uncompressedPage.fileId)
+        ->freePage(uncompressedPage.pageNum);
+  }
+  return true;
+}
+
+void FileBuffer::compressPage(const size_t pageNum, const int epoch) {
+  CHECK_LT(pageNum, multiPages_.size());
+  const Page page = multiPages_[pageNum].current();
+  if (isCompressedPage(page)) {
+    return;
+  }
+  std::vector<int8_t> data(pageDataSize_);
+  FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+  CHECK_EQ(fileInfo->read(page.pageNum * pageSize_ + reservedHeaderSize_,
+                          pageDataSize_,
+                          data.data()),
+           pageDataSize_);
+  writeCompressedPage(pageNum, data.data(), epoch);
+}
+
+Page FileBuffer::uncompressPage(const size_t pageNum, const int epoch) {
+  CHECK_LT(pageNum, multiPages_.size());
+  CHECK_EQ(multiPages_[pageNum].epochs.back(), epoch);
+  Page compressedPage = multiPages_[pageNum].current();
+  Page page = fm_->requestFreePage(pageSize_, false);
+  copyPage(compressedPage, page, pageDataSize_, 0);
+  writeHeader(page, pageNum, epoch);
+  multiPages_[pageNum].pageVersions.back() = page;
+  fm_->getFileInfoForFileId(compressedPage.fileId)->freePage(compressedPage.pageNum);
+  return page;
+}
+
 Page FileBuffer::addNewMultiPage(const int epoch) {
   Page page = fm_->requestFreePage(pageSize_, false);
   MultiPage multiPage(pageSize_);
@@ -377,10 +602,7 @@ Page FileBuffer::addNewMultiPage(const int epoch) {
   return page;
 }
 
-void FileBuffer::writeHeader(Page& page,
-                             const int pageId,
-                             const int epoch,
-                             const bool writeMetadata) {
+vector<int> FileBuffer::getHeader(const int pageId, const int epoch) const {
   int intHeaderSize = chunkKey_.size() + 3;  // does not include chunkSize
   vector<int> header(intHeaderSize);
   // in addition to chunkkey we need size of header, pageId, version
@@ -390,15 +612,28 @@ void FileBuffer::writeHeader(Page& page,
   std::copy(chunkKey_.begin(), chunkKey_.end(), header.begin() + 1);
   header[intHeaderSize - 2] = pageId;
   header[intHeaderSize - 1] = epoch;
+  return header;
+}
+
+void FileBuffer::writeHeader(Page& page,
+                             const int pageId,
+                             const int epoch,
+                             const bool writeMetadata) {
+  const auto header = getHeader(pageId, epoch);
   FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
-  size_t pageSize = writeMetadata ? METADATA_PAGE_SIZE : pageSize_;
+  // the file of a compressed page has a smaller page size than the buffer
+  size_t pageSize = writeMetadata ? METADATA_PAGE_SIZE : fileInfo->pageSize;
   fileInfo->write(
-      page.pageNum * pageSize, (intHeaderSize) * sizeof(int), (int8_t*)&header[0]);
+      page.pageNum * pageSize, header.size() * sizeof(int), (int8_t*)&header[0]);
 }
 
 void FileBuffer::readMetadata(const Page& page) {
   FILE* f = fm_->getFileForFileId(page.fileId);
   fseek(f, page.pageNum * METADATA_PAGE_SIZE + reservedHeaderSize_, SEEK_SET);
+  readMetadataFields(f);
+}
+
+void FileBuffer::readMetadataFields(FILE* f) {
   fread((int8_t*)&pageSize_, sizeof(size_t), 1, f);
   fread((int8_t*)&size_, sizeof(size_t), 1, f);
   vector<int> typeData(NUM_METADATA);  // assumes we will encode hasEncoder, bufferType,
@@ -428,6 +663,32 @@ void FileBuffer::writeMetadata(const int epoch) {
   writeHeader(page, -1, epoch, true);
   FILE* f = fm_->getFileForFileId(page.fileId);
   fseek(f, page.pageNum * METADATA_PAGE_SIZE + reservedHeaderSize_, SEEK_SET);
+  writeMetadataFields(f);
+  metadataPages_.epochs.push_back(epoch);
+  metadataPages_.pageVersions.push_back(page);
+}
+
+vector<int8_t> FileBuffer::writeMetadataToImage(const int epoch, Page& page) {
+  page = fm_->requestFreePage(METADATA_PAGE_SIZE, true);
+  vector<int8_t> image(METADATA_PAGE_SIZE);
+  const auto header = getHeader(-1, epoch);
+  std::memcpy(image.data(), header.data(), header.size() * sizeof(int));
+  // the encoders write their metadata to a stream
+  char* fields{nullptr};
+  size_t fieldsSize{0};
+  FILE* f = open_memstream(&fields, &fieldsSize);
+  CHECK(f);
+  writeMetadataFields(f);
+  fclose(f);
+  ScopeGuard freeFields = [fields] { free(fields); };
+  CHECK_LE(reservedHeaderSize_ + fieldsSize, image.size());
+  std::memcpy(image.data() + reservedHeaderSize_, fields, fieldsSize);
+  metadataPages_.epochs.push_back(epoch);
+  metadataPages_.pageVersions.push_back(page);
+  return image;
+}
+
+void FileBuffer::writeMetadataFields(FILE* f) {
   fwrite((int8_t*)&pageSize_, sizeof(size_t), 1, f);
   fwrite((int8_t*)&size_, sizeof(size_t), 1, f);
   vector<int> typeData(NUM_METADATA);  // assumes we will encode hasEncoder, bufferType,
@@ -448,8 +709,17 @@ void FileBuffer::writeMetadata(const int epoch) {
   if (hasEncoder()) {  // redundant
     encoder_->writeMetadata(f);
   }
-  metadataPages_.epochs.push_back(epoch);
-  metadataPages_.pageVersions.push_back(page);
+}
+
+void FileBuffer::writeHeaderIndexEntry(FILE* f) {
+  CHECK(!metadataPages_.pageVersions.empty());
+  writeMetadataFields(f);
+  write_page_versions(f, metadataPages_);
+  size_t numMultiPages = multiPages_.size();
+  fwrite((int8_t*)&numMultiPages, sizeof(size_t), 1, f);
+  for (const auto& multiPage : multiPages_) {
+    write_page_versions(f, multiPage);
+  }
 }
 
 void FileBuffer::append(int8_t* src,
@@ -467,15 +737,25 @@ void FileBuffer::append(int8_t* src,
   size_t initialNumPages = multiPages_.size();
   size_ = size_ + numBytes;
   int epoch = fm_->epoch();
+  const bool compress = isCompressible();
   for (size_t pageNum = startPage; pageNum < startPage + numPagesToWrite; ++pageNum) {
     Page page;
     if (pageNum >= initialNumPages) {
+      // the new pages filled up are written compressed right away
+      if (compress && bytesLeft >= pageDataSize_ &&
+          writeCompressedPage(pageNum, curPtr, epoch)) {
+        curPtr += pageDataSize_;
+        bytesLeft -= pageDataSize_;
+        continue;
+      }
       page = addNewMultiPage(epoch);
       writeHeader(page, pageNum, epoch);
     } else {
       // we already have a new page at current
       // epoch for this page - just grab this page
       page = multiPages_[pageNum].current();
+      // only full pages are compressed, and this one is appended to
+      CHECK(!isCompressedPage(page));
     }
     CHECK(page.fileId >= 0);  // make sure page was initialized
     FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
@@ -494,6 +774,14 @@ void FileBuffer::append(int8_t* src,
     bytesLeft -= bytesWritten;
   }
   CHECK(bytesLeft == 0);
+  if (compress) {
+    // the pages there were before the append and got filled up
+    const auto numFullPages = size_ / pageDataSize_;
+    for (size_t pageNum = startPage; pageNum < std::min(initialNumPages, numFullPages);
+         ++pageNum) {
+      compressPage(pageNum, epoch);
+    }
+  }
 }
 
 void FileBuffer::write(int8_t* src,
@@ -546,20 +834,27 @@ void FileBuffer::write(int8_t* src,
       page = fm_->requestFreePage(pageSize_, false);
       multiPages_[pageNum].epochs.push_back(epoch);
       multiPages_[pageNum].pageVersions.push_back(page);
-      if (pageNum == startPage && startPageOffset > 0) {
-        // copyPage takes care of header offset so don't worry
-        // about it
-        copyPage(lastPage, page, startPageOffset, 0);
-      }
-      if (pageNum == startPage + numPagesToWrite &&
-          bytesLeft > 0) {  // bytesLeft should always > 0
-        copyPage(lastPage,
-                 page,
-                 pageDataSize_ - bytesLeft,
-                 bytesLeft);  // these would be empty if we're appending but we won't
-                              // worry about it right now
+      if (isCompressedPage(lastPage)) {
+        // a compressed page is full, the data around the written bytes is kept
+        copyPage(lastPage, page, pageDataSize_, 0);
+      } else {
+        if (pageNum == startPage && startPageOffset > 0) {
+          // copyPage takes care of header offset so don't worry
+          // about it
+          copyPage(lastPage, page, startPageOffset, 0);
+        }
+        if (pageNum == startPage + numPagesToWrite &&
+            bytesLeft > 0) {  // bytesLeft should always > 0
+          copyPage(lastPage,
+                   page,
+                   pageDataSize_ - bytesLeft,
+                   bytesLeft);  // these would be empty if we're appending but we won't
+                                // worry about it right now
+        }
       }
       writeHeader(page, pageNum, epoch);
+    } else if (isCompressedPage(multiPages_[pageNum].current())) {
+      page = uncompressPage(pageNum, epoch);
     } else {
       // we already have a new page at current
       // epoch for this page - just grab this page
@@ -587,6 +882,15 @@ void FileBuffer::write(int8_t* src,
     }
   }
   CHECK(bytesLeft == 0);
+  if (isCompressible()) {
+    // the pages written to are compressed again, or for the first time, once full
+    const auto numFullPages = size_ / pageDataSize_;
+    for (size_t pageNum = startPage;
+         pageNum < std::min(startPage + numPagesToWrite, numFullPages);
+         ++pageNum) {
+      compressPage(pageNum, epoch);
+    }
+  }
 }
 
 }  // namespace File_Namespace
@@ -35,6 +35,8 @@ using namespace Data_Namespace;
 #define NUM_METADATA 10
 #define METADATA_VERSION 0
 
+extern bool g_enable_varlen_page_compression;
+
 namespace File_Namespace {
 
 class FileMgr;  // forward declaration
@@ -50,6 +52,13 @@ class FileMgr;  // forward declaration
  *
  * Note that a "Chunk" is brought into a FileBuffer by the FileMgr.
  *
+ * With g_enable_varlen_page_compression, the full pages of the data of none encoded
+ * strings and of arrays are compressed, each page on its own, into a page of a
+ * smaller page size: a half, a quarter, an eighth or a sixteenth of the page size of
+ * the buffer. A page is compressed if its file has a smaller page size than the buffer,
+ * so reading a range of the buffer only decompresses the pages it overlaps. A compressed
+ * page written to is decompressed into a page of the buffer page size first.
+ *
  * Note(s): Forbid Copying Idiom 4.1
  */
 class FileBuffer : public AbstractBuffer {
@@ -75,6 +84,9 @@ class FileBuffer : public AbstractBuffer {
              const std::vector<HeaderInfo>::const_iterator& headerStartIt,
              const std::vector<HeaderInfo>::const_iterator& headerEndIt);
 
+  /// Reads back a FileBuffer saved by writeHeaderIndexEntry from the header index file
+  FileBuffer(FileMgr* fm, const ChunkKey& chunkKey, FILE* headerIndexFile);
+
   /// Destructor
   ~FileBuffer() override;
 
@@ -122,6 +134,16 @@ class FileBuffer : public AbstractBuffer {
     return nullptr;  // satisfy return-type warning
   }
 
+  /// Whether the page is compressed, see the class comment.
+  bool isCompressedPage(const Page& page) const;
+
+  /// Decompresses the compressed page and copies `numBytes` of its data from
+  /// `pageOffset` on to `dst`, or less at the end of the page. Returns the bytes copied.
+  size_t readCompressedPage(const Page& page,
+                            const size_t pageOffset,
+                            const size_t numBytes,
+                            int8_t* dst);
+
   /// Returns the number of pages in the FileBuffer.
   inline size_t pageCount() const override { return multiPages_.size(); }
 
@@ -156,10 +178,29 @@ class FileBuffer : public AbstractBuffer {
                    const int pageId,
                    const int epoch,
                    const bool writeMetadata = false);
+  std::vector<int> getHeader(const int pageId, const int epoch) const;
   void writeMetadata(const int epoch);
+  /// Same as writeMetadata(), into the image of the new metadata page rather than its
+  /// file, so that the pages of many buffers can be written together.
+  std::vector<int8_t> writeMetadataToImage(const int epoch, Page& page);
   void readMetadata(const Page& page);
+  void writeMetadataFields(FILE* f);
+  void readMetadataFields(FILE* f);
+  /// Writes the metadata and the versions of every page, as of the last checkpoint
+  void writeHeaderIndexEntry(FILE* f);
   void calcHeaderBuffer();
 
+  bool isCompressible() const;
+  /// Compresses the page data in `data` into the current version of page `pageNum`, or
+  /// into its first one if the buffer has `pageNum` pages. Returns false, writing
+  /// nothing, if the data doesn't compress to half of the page size.
+  bool writeCompressedPage(const size_t pageNum, const int8_t* data, const int epoch);
+  /// Compresses the current version of page `pageNum` if it isn't already.
+  void compressPage(const size_t pageNum, const int epoch);
+  /// Replaces the current version of page `pageNum`, compressed and at `epoch`, by its
+  /// decompressed data in a page of the buffer page size.
+  Page uncompressPage(const size_t pageNum, const int epoch);
+
   FileMgr* fm_;  // a reference to FileMgr is needed for writing to new pages in available
                  // files
   static size_t headerBufferOffset_;
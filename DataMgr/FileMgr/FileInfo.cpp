@@ -20,9 +20,13 @@
 #include "FileMgr.h"
 #include "Page.h"
 
+#include <algorithm>
+#include <memory>
 #include <utility>
 using namespace std;
 
+bool g_enable_direct_file_reads{false};
+
 namespace File_Namespace {
 
 FileInfo::FileInfo(FileMgr* fileMgr,
@@ -31,7 +35,13 @@ FileInfo::FileInfo(FileMgr* fileMgr,
                    const size_t pageSize,
                    size_t numPages,
                    bool init)
-    : fileMgr(fileMgr), fileId(fileId), f(f), pageSize(pageSize), numPages(numPages) {
+    : fileMgr(fileMgr)
+    , fileId(fileId)
+    , f(f)
+    , pageSize(pageSize)
+    , numPages(numPages)
+    , readFd_(-1)
+    , readFdIsDirect_(false) {
   if (init) {
     initNewFile();
   }
@@ -42,6 +52,9 @@ FileInfo::~FileInfo() {
   if (f) {
     close(f);
   }
+  if (readFd_ >= 0) {
+    omnisci::close(readFd_);
+  }
 }
 
 void FileInfo::initNewFile() {
@@ -66,6 +79,91 @@ size_t FileInfo::read(const size_t offset, const size_t size, int8_t* buf) {
   return File_Namespace::read(f, offset, size, buf);
 }
 
+size_t FileInfo::readPages(const size_t firstPageNum,
+                           const size_t numPages,
+                           const size_t headerSize,
+                           const size_t startPageOffset,
+                           const size_t numBytes,
+                           int8_t* buf) {
+  CHECK_GT(numPages, size_t(0));
+  CHECK_LT(headerSize, pageSize);
+  const auto pageDataSize = pageSize - headerSize;
+  CHECK_LT(startPageOffset, pageDataSize);
+  const auto bytesToRead = min(numBytes, numPages * pageDataSize - startPageOffset);
+  if (!bytesToRead) {
+    return 0;
+  }
+  {
+    std::lock_guard<std::mutex> lock(readWriteMutex_);
+    // the writes still buffered by the file stream aren't visible to the descriptor
+    if (fflush(f) != 0) {
+      LOG(FATAL) << "Error trying to flush file " << fileId
+                 << " before reading it, the error was: " << std::strerror(errno);
+    }
+    if (readFd_ < 0) {
+      const auto path =
+          get_data_file_path(fileMgr->getFileMgrBasePath(), fileId, pageSize);
+      readFd_ = omnisci::open_for_direct_reads(path.c_str(), readFdIsDirect_);
+    }
+  }
+  // the file offset of a position in the data of the pages, counted from the first page
+  const auto fileOffset = [this, firstPageNum, headerSize, pageDataSize](
+                              const size_t dataPos) {
+    return (firstPageNum + dataPos / pageDataSize) * pageSize + headerSize +
+           dataPos % pageDataSize;
+  };
+  if (readFd_ < 0) {
+    size_t bytesRead = 0;
+    while (bytesRead < bytesToRead) {
+      const auto dataPos = startPageOffset + bytesRead;
+      const auto readSize =
+          min(pageDataSize - dataPos % pageDataSize, bytesToRead - bytesRead);
+      bytesRead += read(fileOffset(dataPos), readSize, buf + bytesRead);
+    }
+    return bytesRead;
+  }
+
+  // O_DIRECT requires the offset, size and buffer of the read to be aligned
+  constexpr size_t kDirectReadAlignment{4096};
+  const size_t alignment = readFdIsDirect_ ? kDirectReadAlignment : 1;
+  const auto begin = fileOffset(startPageOffset) / alignment * alignment;
+  const auto end =
+      (fileOffset(startPageOffset + bytesToRead - 1) + alignment) / alignment * alignment;
+  std::unique_ptr<int8_t[]> spanOwner(new int8_t[end - begin + alignment]);
+  void* spanPtr = spanOwner.get();
+  size_t spanSpace = end - begin + alignment;
+  CHECK(std::align(alignment, end - begin, spanPtr, spanSpace));
+  auto span = static_cast<int8_t*>(spanPtr);
+  size_t spanBytesRead = 0;
+  while (begin + spanBytesRead < end) {
+    const auto bytesRead = omnisci::pread(readFd_,
+                                          span + spanBytesRead,
+                                          end - begin - spanBytesRead,
+                                          begin + spanBytesRead);
+    if (bytesRead < 0) {
+      LOG(FATAL) << "Error trying to read pages " << firstPageNum << " to "
+                 << firstPageNum + numPages - 1 << " of file " << fileId
+                 << ", the error was: " << std::strerror(errno);
+    }
+    if (bytesRead == 0) {
+      // the last page ends the file, which isn't aligned
+      break;
+    }
+    spanBytesRead += bytesRead;
+  }
+  CHECK_GE(begin + spanBytesRead, fileOffset(startPageOffset + bytesToRead - 1) + 1);
+
+  size_t bytesCopied = 0;
+  while (bytesCopied < bytesToRead) {
+    const auto dataPos = startPageOffset + bytesCopied;
+    const auto copySize =
+        min(pageDataSize - dataPos % pageDataSize, bytesToRead - bytesCopied);
+    memcpy(buf + bytesCopied, span + (fileOffset(dataPos) - begin), copySize);
+    bytesCopied += copySize;
+  }
+  return bytesCopied;
+}
+
 void FileInfo::openExistingFile(std::vector<HeaderInfo>& headerVec,
                                 const int fileMgrEpoch) {
   // HeaderInfo is defined in Page.h
@@ -32,6 +32,8 @@
 #include "OSDependent/omnisci_fs.h"
 #include "Page.h"
 
+extern bool g_enable_direct_file_reads;
+
 namespace File_Namespace {
 
 struct Page;
@@ -64,6 +66,8 @@ struct FileInfo {
   std::set<size_t> freePages;  /// set of page numbers of free pages
   std::mutex freePagesMutex_;
   std::mutex readWriteMutex_;
+  int readFd_;            /// positional reads only descriptor, opened by readPages
+  bool readFdIsDirect_;   /// whether readFd_ bypasses the page cache
 
   /// Constructor
   FileInfo(FileMgr* fileMgr,
@@ -86,6 +90,20 @@ struct FileInfo {
   size_t write(const size_t offset, const size_t size, int8_t* buf);
   size_t read(const size_t offset, const size_t size, int8_t* buf);
 
+  /**
+   * @brief Reads the data of up to `numPages` consecutive pages, skipping their headers
+   *
+   * Starts `startPageOffset` bytes into the data of page `firstPageNum` and copies at
+   * most `numBytes` to `buf`. The pages are read with a single request, which bypasses
+   * the page cache where possible, instead of one buffered read per page.
+   */
+  size_t readPages(const size_t firstPageNum,
+                   const size_t numPages,
+                   const size_t headerSize,
+                   const size_t startPageOffset,
+                   const size_t numBytes,
+                   int8_t* buf);
+
   void openExistingFile(std::vector<HeaderInfo>& headerVec, const int fileMgrEpoch);
   /// Prints a summary of the file to stdout
   void print(bool pagesummary);
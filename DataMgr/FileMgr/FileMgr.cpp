@@ -24,7 +24,10 @@
 
 #include <fcntl.h>
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <future>
+#include <map>
 #include <string>
 #include <thread>
 #include <utility>
@@ -38,14 +41,113 @@
 #include "Shared/File.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/measure.h"
+#include "Shared/scope.h"
 
 #define EPOCH_FILENAME "epoch"
 #define DB_META_FILENAME "dbmeta"
+#define HEADER_INDEX_FILENAME "header_index"
+#define HEADER_INDEX_VERSION 1
 
 using namespace std;
 
+bool g_enable_header_index_file{false};
+bool g_enable_parallel_checkpoint{false};
+
 namespace File_Namespace {
 
+namespace {
+
+struct DataFile {
+  std::string path;
+  int fileId;
+  size_t pageSize;
+  size_t numPages;
+};
+
+// The data files of a table directory, with the page size and count of each
+std::vector<DataFile> get_data_files(const std::string& path) {
+  std::vector<DataFile> dataFiles;
+  boost::filesystem::directory_iterator
+      endItr;  // default construction yields past-the-end
+  for (boost::filesystem::directory_iterator fileIt(path); fileIt != endItr; ++fileIt) {
+    if (boost::filesystem::is_regular_file(fileIt->status())) {
+      // note that boost::filesystem leaves preceding dot on
+      // extension - hence MAPD_FILE_EXT is ".mapd"
+      std::string extension(fileIt->path().extension().string());
+
+      if (extension == MAPD_FILE_EXT) {
+        std::string fileStem(fileIt->path().stem().string());
+        // remove trailing dot if any
+        if (fileStem.size() > 0 && fileStem.back() == '.') {
+          fileStem = fileStem.substr(0, fileStem.size() - 1);
+        }
+        size_t dotPos = fileStem.find_last_of(".");  // should only be one
+        if (dotPos == std::string::npos) {
+          LOG(FATAL) << "File `" << fileIt->path()
+                     << "` does not carry page size information in the filename.";
+        }
+        int fileId = boost::lexical_cast<int>(fileStem.substr(0, dotPos));
+        size_t pageSize =
+            boost::lexical_cast<size_t>(fileStem.substr(dotPos + 1, fileStem.size()));
+        std::string filePath(fileIt->path().string());
+        size_t fileSize = boost::filesystem::file_size(filePath);
+        CHECK_EQ(fileSize % pageSize, size_t(0));  // should be no partial pages
+        size_t numPages = fileSize / pageSize;
+
+        VLOG(4) << "File id: " << fileId << " Page size: " << pageSize
+                << " Num pages: " << numPages;
+        dataFiles.push_back({filePath, fileId, pageSize, numPages});
+      }
+    }
+  }
+  return dataFiles;
+}
+
+template <typename T>
+bool read_values(FILE* f, T* values, const size_t count) {
+  return fread((int8_t*)values, sizeof(T), count, f) == count;
+}
+
+template <typename T>
+void write_values(FILE* f, const T* values, const size_t count) {
+  CHECK_EQ(fwrite((int8_t*)values, sizeof(T), count, f), count);
+}
+
+void sync_to_disk(FILE* f, const std::string& path) {
+  int status = fflush(f);
+  if (status == 0) {
+#ifdef __APPLE__
+    status = fcntl(fileno(f), 51);
+#else
+    status = omnisci::fsync(fileno(f));
+#endif
+  }
+  if (status != 0) {
+    LOG(FATAL) << "Could not sync file '" << path
+               << "' to disk, the error was: " << std::strerror(errno);
+  }
+}
+
+// Runs the tasks on as many threads as there are cores at most, waits for all of them.
+void run_in_parallel(const std::vector<std::function<void()>>& tasks) {
+  const size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<std::future<void>> futures;
+  for (const auto& task : tasks) {
+    futures.emplace_back(std::async(std::launch::async, task));
+    if (futures.size() == threadCount) {
+      for (auto& future : futures) {
+        future.get();
+      }
+      futures.clear();
+    }
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+}  // namespace
+
 bool headerCompare(const HeaderInfo& firstElem, const HeaderInfo& secondElem) {
   // HeaderInfo.first is a pair of Chunk key with a vector containing
   // pageId and version
@@ -90,11 +192,7 @@ FileMgr::FileMgr(const int deviceId,
     , defaultPageSize_(0)
     , nextFileId_(0)
     , epoch_(0) {
-  const std::string fileMgrDirPrefix("table");
-  const std::string FileMgrDirDelim("_");
-  fileMgrBasePath_ = (gfm_->getBasePath() + fileMgrDirPrefix + FileMgrDirDelim +
-                      std::to_string(fileMgrKey_.first) +                     // db_id
-                      FileMgrDirDelim + std::to_string(fileMgrKey_.second));  // tb_id
+  fileMgrBasePath_ = getFileMgrBasePath(gfm_->getBasePath(), fileMgrKey_);
   epochFile_ = nullptr;
   files_.clear();
 }
@@ -134,19 +232,39 @@ FileMgr::~FileMgr() {
   }
 }
 
-void FileMgr::init(const size_t num_reader_threads) {
-  // if epoch = -1 this means open from epoch file
+std::string FileMgr::getFileMgrBasePath(
+    const std::string& basePath,
+    const std::pair<const int, const int> fileMgrKey) {
   const std::string fileMgrDirPrefix("table");
   const std::string FileMgrDirDelim("_");
-  fileMgrBasePath_ = (gfm_->getBasePath() + fileMgrDirPrefix + FileMgrDirDelim +
-                      std::to_string(fileMgrKey_.first) +                     // db_id
-                      FileMgrDirDelim + std::to_string(fileMgrKey_.second));  // tb_id
+  return basePath + fileMgrDirPrefix + FileMgrDirDelim +
+         std::to_string(fileMgrKey.first) +                    // db_id
+         FileMgrDirDelim + std::to_string(fileMgrKey.second);  // tb_id
+}
+
+std::optional<int> FileMgr::readCheckpointedEpoch(const std::string& fileMgrBasePath) {
+  std::string epochFilePath(fileMgrBasePath + "/" + EPOCH_FILENAME);
+  if (!boost::filesystem::is_regular_file(epochFilePath) ||
+      boost::filesystem::file_size(epochFilePath) < sizeof(int)) {
+    return std::nullopt;
+  }
+  FILE* epochFile = open(epochFilePath);
+  int epoch;
+  read(epochFile, 0, sizeof(int), (int8_t*)&epoch);
+  close(epochFile);
+  return epoch;
+}
+
+void FileMgr::init(const size_t num_reader_threads) {
+  // if epoch = -1 this means open from epoch file
+  fileMgrBasePath_ = getFileMgrBasePath(gfm_->getBasePath(), fileMgrKey_);
   boost::filesystem::path path(fileMgrBasePath_);
   if (boost::filesystem::exists(path)) {
     if (!boost::filesystem::is_directory(path)) {
       LOG(FATAL) << "Specified path '" << fileMgrBasePath_
                  << "' for table data is not a directory.";
     }
+    const bool atLastCheckpoint = epoch_ == -1;
     if (epoch_ != -1) {  // if opening at previous epoch
       int epochCopy = epoch_;
       openEpochFile(EPOCH_FILENAME);
@@ -155,122 +273,9 @@ void FileMgr::init(const size_t num_reader_threads) {
       openEpochFile(EPOCH_FILENAME);
     }
 
-    auto clock_begin = timer_start();
-
-    boost::filesystem::directory_iterator
-        endItr;  // default construction yields past-the-end
-    int maxFileId = -1;
-    int fileCount = 0;
-    int threadCount = std::thread::hardware_concurrency();
-    std::vector<HeaderInfo> headerVec;
-    std::vector<std::future<std::vector<HeaderInfo>>> file_futures;
-    for (boost::filesystem::directory_iterator fileIt(path); fileIt != endItr; ++fileIt) {
-      if (boost::filesystem::is_regular_file(fileIt->status())) {
-        // note that boost::filesystem leaves preceding dot on
-        // extension - hence MAPD_FILE_EXT is ".mapd"
-        std::string extension(fileIt->path().extension().string());
-
-        if (extension == MAPD_FILE_EXT) {
-          std::string fileStem(fileIt->path().stem().string());
-          // remove trailing dot if any
-          if (fileStem.size() > 0 && fileStem.back() == '.') {
-            fileStem = fileStem.substr(0, fileStem.size() - 1);
-          }
-          size_t dotPos = fileStem.find_last_of(".");  // should only be one
-          if (dotPos == std::string::npos) {
-            LOG(FATAL) << "File `" << fileIt->path()
-                       << "` does not carry page size information in the filename.";
-          }
-          int fileId = boost::lexical_cast<int>(fileStem.substr(0, dotPos));
-          if (fileId > maxFileId) {
-            maxFileId = fileId;
-          }
-          size_t pageSize =
-              boost::lexical_cast<size_t>(fileStem.substr(dotPos + 1, fileStem.size()));
-          std::string filePath(fileIt->path().string());
-          size_t fileSize = boost::filesystem::file_size(filePath);
-          CHECK_EQ(fileSize % pageSize, size_t(0));  // should be no partial pages
-          size_t numPages = fileSize / pageSize;
-
-          VLOG(4) << "File id: " << fileId << " Page size: " << pageSize
-                  << " Num pages: " << numPages;
-
-          file_futures.emplace_back(std::async(
-              std::launch::async, [filePath, fileId, pageSize, numPages, this] {
-                std::vector<HeaderInfo> tempHeaderVec;
-                openExistingFile(filePath, fileId, pageSize, numPages, tempHeaderVec);
-                return tempHeaderVec;
-              }));
-          fileCount++;
-          if (fileCount % threadCount == 0) {
-            processFileFutures(file_futures, headerVec);
-          }
-        }
-      }
-    }
-
-    if (file_futures.size() > 0) {
-      processFileFutures(file_futures, headerVec);
+    if (!atLastCheckpoint || !g_enable_header_index_file || !readHeaderIndex()) {
+      readFileHeaders();
     }
-    int64_t queue_time_ms = timer_stop(clock_begin);
-
-    LOG(INFO) << "Completed Reading table's file metadata, Elapsed time : "
-              << queue_time_ms << "ms Epoch: " << epoch_ << " files read: " << fileCount
-              << " table location: '" << fileMgrBasePath_ << "'";
-
-    /* Sort headerVec so that all HeaderInfos
-     * from a chunk will be grouped together
-     * and in order of increasing PageId
-     * - Version Epoch */
-
-    std::sort(headerVec.begin(), headerVec.end(), headerCompare);
-
-    /* Goal of next section is to find sequences in the
-     * sorted headerVec of the same ChunkId, which we
-     * can then initiate a FileBuffer with */
-
-    VLOG(4) << "Number of Headers in Vector: " << headerVec.size();
-    if (headerVec.size() > 0) {
-      ChunkKey lastChunkKey = headerVec.begin()->chunkKey;
-      auto startIt = headerVec.begin();
-
-      for (auto headerIt = headerVec.begin() + 1; headerIt != headerVec.end();
-           ++headerIt) {
-        // for (auto chunkIt = headerIt->chunkKey.begin(); chunkIt !=
-        // headerIt->chunkKey.end(); ++chunkIt) {
-        //    std::cout << *chunkIt << " ";
-        //}
-
-        if (headerIt->chunkKey != lastChunkKey) {
-          chunkIndex_[lastChunkKey] =
-              new FileBuffer(this, /*pageSize,*/ lastChunkKey, startIt, headerIt);
-          /*
-          if (startIt->versionEpoch != -1) {
-              cout << "not skipping bc version != -1" << endl;
-              // -1 means that chunk was deleted
-              // lets not read it in
-              chunkIndex_[lastChunkKey] = new FileBuffer
-          (this,/lastChunkKey,startIt,headerIt);
-
-          }
-          else {
-              cout << "Skipping bc version == -1" << endl;
-          }
-          */
-          lastChunkKey = headerIt->chunkKey;
-          startIt = headerIt;
-        }
-      }
-      // now need to insert last Chunk
-      // size_t pageSize = files_[startIt->page.fileId]->pageSize;
-      // cout << "Inserting last chunk" << endl;
-      // if (startIt->versionEpoch != -1) {
-      chunkIndex_[lastChunkKey] =
-          new FileBuffer(this, /*pageSize,*/ lastChunkKey, startIt, headerVec.end());
-      //}
-    }
-    nextFileId_ = maxFileId + 1;
-    // std::cout << "next file id: " << nextFileId_ << std::endl;
   } else {
     if (!boost::filesystem::create_directory(path)) {
       LOG(FATAL) << "Could not create data directory: " << path;
@@ -293,6 +298,100 @@ void FileMgr::init(const size_t num_reader_threads) {
   }
 }
 
+void FileMgr::readFileHeaders() {
+  // an index left from an earlier run may describe pages which the scan is about to
+  // free, or whose checkpoint is rolled back
+  if (boost::filesystem::exists(getHeaderIndexPath())) {
+    headerIndexOnDisk_ = true;
+    invalidateHeaderIndex();
+  }
+
+  auto clock_begin = timer_start();
+
+  int maxFileId = -1;
+  int fileCount = 0;
+  int threadCount = std::thread::hardware_concurrency();
+  std::vector<HeaderInfo> headerVec;
+  std::vector<std::future<std::vector<HeaderInfo>>> file_futures;
+  for (const auto& dataFile : get_data_files(fileMgrBasePath_)) {
+    maxFileId = std::max(maxFileId, dataFile.fileId);
+    file_futures.emplace_back(std::async(std::launch::async, [dataFile, this] {
+      std::vector<HeaderInfo> tempHeaderVec;
+      openExistingFile(dataFile.path,
+                       dataFile.fileId,
+                       dataFile.pageSize,
+                       dataFile.numPages,
+                       tempHeaderVec);
+      return tempHeaderVec;
+    }));
+    fileCount++;
+    if (fileCount % threadCount == 0) {
+      processFileFutures(file_futures, headerVec);
+    }
+  }
+
+  if (file_futures.size() > 0) {
+    processFileFutures(file_futures, headerVec);
+  }
+  int64_t queue_time_ms = timer_stop(clock_begin);
+
+  LOG(INFO) << "Completed Reading table's file metadata, Elapsed time : "
+            << queue_time_ms << "ms Epoch: " << epoch_ << " files read: " << fileCount
+            << " table location: '" << fileMgrBasePath_ << "'";
+
+  /* Sort headerVec so that all HeaderInfos
+   * from a chunk will be grouped together
+   * and in order of increasing PageId
+   * - Version Epoch */
+
+  std::sort(headerVec.begin(), headerVec.end(), headerCompare);
+
+  /* Goal of next section is to find sequences in the
+   * sorted headerVec of the same ChunkId, which we
+   * can then initiate a FileBuffer with */
+
+  VLOG(4) << "Number of Headers in Vector: " << headerVec.size();
+  if (headerVec.size() > 0) {
+    ChunkKey lastChunkKey = headerVec.begin()->chunkKey;
+    auto startIt = headerVec.begin();
+
+    for (auto headerIt = headerVec.begin() + 1; headerIt != headerVec.end(); ++headerIt) {
+      // for (auto chunkIt = headerIt->chunkKey.begin(); chunkIt !=
+      // headerIt->chunkKey.end(); ++chunkIt) {
+      //    std::cout << *chunkIt << " ";
+      //}
+
+      if (headerIt->chunkKey != lastChunkKey) {
+        chunkIndex_[lastChunkKey] =
+            new FileBuffer(this, /*pageSize,*/ lastChunkKey, startIt, headerIt);
+        /*
+        if (startIt->versionEpoch != -1) {
+            cout << "not skipping bc version != -1" << endl;
+            // -1 means that chunk was deleted
+            // lets not read it in
+            chunkIndex_[lastChunkKey] = new FileBuffer
+        (this,/lastChunkKey,startIt,headerIt);
+
+        }
+        else {
+            cout << "Skipping bc version == -1" << endl;
+        }
+        */
+        lastChunkKey = headerIt->chunkKey;
+        startIt = headerIt;
+      }
+    }
+    // now need to insert last Chunk
+    // size_t pageSize = files_[startIt->page.fileId]->pageSize;
+    // cout << "Inserting last chunk" << endl;
+    // if (startIt->versionEpoch != -1) {
+    chunkIndex_[lastChunkKey] =
+        new FileBuffer(this, /*pageSize,*/ lastChunkKey, startIt, headerVec.end());
+    //}
+  }
+  nextFileId_ = maxFileId + 1;
+}
+
 void FileMgr::processFileFutures(
     std::vector<std::future<std::vector<HeaderInfo>>>& file_futures,
     std::vector<HeaderInfo>& headerVec) {
@@ -589,25 +688,218 @@ void FileMgr::writeAndSyncDBMetaToDisk() {
   }
 }
 
-void FileMgr::checkpoint() {
-  VLOG(2) << "Checkpointing epoch: " << epoch_;
-  mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(chunkIndexMutex_);
-  for (auto chunkIt = chunkIndex_.begin(); chunkIt != chunkIndex_.end(); ++chunkIt) {
-    if (chunkIt->second->isDirty()) {
-      chunkIt->second->writeMetadata(epoch_);
-      chunkIt->second->clearDirtyBits();
+std::string FileMgr::getHeaderIndexPath() const {
+  return fileMgrBasePath_ + "/" + HEADER_INDEX_FILENAME;
+}
+
+bool FileMgr::readHeaderIndex() {
+  const auto headerIndexPath = getHeaderIndexPath();
+  if (!boost::filesystem::exists(headerIndexPath)) {
+    return false;
+  }
+  auto clock_begin = timer_start();
+  FILE* f = open(headerIndexPath);
+  ScopeGuard closeHeaderIndex = [f] { close(f); };
+
+  int header[2];  // version, epoch
+  size_t indexSize;
+  if (!read_values(f, header, 2) || !read_values(f, &indexSize, 1) ||
+      header[0] != HEADER_INDEX_VERSION || header[1] != epoch_ - 1 ||
+      indexSize != boost::filesystem::file_size(headerIndexPath)) {
+    LOG(INFO) << "Header index of table location '" << fileMgrBasePath_
+              << "' is out of date, reading the page headers";
+    return false;
+  }
+  // the data files on disk must be the ones the index was written for
+  auto dataFiles = get_data_files(fileMgrBasePath_);
+  std::sort(
+      dataFiles.begin(), dataFiles.end(), [](const DataFile& lhs, const DataFile& rhs) {
+        return lhs.fileId < rhs.fileId;
+      });
+  size_t numFiles;
+  CHECK(read_values(f, &numFiles, 1));
+  if (numFiles != dataFiles.size()) {
+    LOG(INFO) << "Header index of table location '" << fileMgrBasePath_
+              << "' doesn't match the data files, reading the page headers";
+    return false;
+  }
+  for (const auto& dataFile : dataFiles) {
+    int fileId;
+    size_t pageInfo[2];  // page size, page count
+    CHECK(read_values(f, &fileId, 1) && read_values(f, pageInfo, 2));
+    if (fileId != dataFile.fileId || pageInfo[0] != dataFile.pageSize ||
+        pageInfo[1] != dataFile.numPages) {
+      LOG(INFO) << "Header index of table location '" << fileMgrBasePath_
+                << "' doesn't match the data files, reading the page headers";
+      return false;
     }
   }
-  chunkIndexWriteLock.unlock();
 
-  mapd_shared_lock<mapd_shared_mutex> read_lock(files_rw_mutex_);
-  for (auto fileIt = files_.begin(); fileIt != files_.end(); ++fileIt) {
-    int status = (*fileIt)->syncToDisk();
-    if (status != 0) {
-      LOG(FATAL) << "Could not sync file to disk";
+  int maxFileId = -1;
+  std::map<int, std::vector<bool>> usedPages;
+  for (const auto& dataFile : dataFiles) {
+    openExistingFile(
+        dataFile.path, dataFile.fileId, dataFile.pageSize, dataFile.numPages);
+    usedPages[dataFile.fileId].resize(dataFile.numPages, false);
+    maxFileId = std::max(maxFileId, dataFile.fileId);
+  }
+  const auto markUsed = [&usedPages](const MultiPage& multiPage) {
+    for (const auto& page : multiPage.pageVersions) {
+      auto& filePages = usedPages.at(page.fileId);
+      CHECK_LT(page.pageNum, filePages.size());
+      filePages[page.pageNum] = true;
+    }
+  };
+  size_t numChunks;
+  CHECK(read_values(f, &numChunks, 1));
+  for (size_t i = 0; i < numChunks; ++i) {
+    size_t keySize;
+    CHECK(read_values(f, &keySize, 1));
+    ChunkKey chunkKey(keySize);
+    CHECK(read_values(f, chunkKey.data(), keySize));
+    // always derive dbid/tbid from FileMgr
+    chunkKey[0] = fileMgrKey_.first;
+    chunkKey[1] = fileMgrKey_.second;
+    auto buffer = new FileBuffer(this, chunkKey, f);
+    chunkIndex_[chunkKey] = buffer;
+    markUsed(buffer->metadataPages_);
+    for (const auto& multiPage : buffer->multiPages_) {
+      markUsed(multiPage);
+    }
+  }
+  for (const auto& [fileId, filePages] : usedPages) {
+    auto fileInfo = files_[fileId];
+    for (size_t pageNum = 0; pageNum < filePages.size(); ++pageNum) {
+      if (!filePages[pageNum]) {
+        fileInfo->freePages.insert(pageNum);
+      }
     }
   }
+  nextFileId_ = maxFileId + 1;
+  headerIndexOnDisk_ = true;
+  int64_t queue_time_ms = timer_stop(clock_begin);
+
+  LOG(INFO) << "Completed Reading table's header index, Elapsed time : "
+            << queue_time_ms << "ms Epoch: " << epoch_ << " files: " << numFiles
+            << " chunks: " << numChunks << " table location: '" << fileMgrBasePath_
+            << "'";
+  return true;
+}
 
+void FileMgr::writeHeaderIndex() {
+  // the table is locked against writes across checkpoints, so the chunks are the ones
+  // just checkpointed
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  mapd_shared_lock<mapd_shared_mutex> filesReadLock(files_rw_mutex_);
+
+  // Only write an index which accounts for every page with a header. The pages of the
+  // chunks deleted without purge keep theirs, are neither free nor used and need the
+  // scan to come back.
+  std::vector<size_t> usedPageCounts(files_.size(), 0);
+  bool checkpointed{true};
+  const auto countUsed = [&usedPageCounts, &checkpointed, this](
+                             const MultiPage& multiPage) {
+    for (size_t i = 0; i < multiPage.pageVersions.size(); ++i) {
+      ++usedPageCounts[multiPage.pageVersions[i].fileId];
+      checkpointed = checkpointed && multiPage.epochs[i] < epoch_;
+    }
+  };
+  size_t numChunks{0};
+  for (const auto& [chunkKey, buffer] : chunkIndex_) {
+    if (buffer->metadataPages_.pageVersions.empty()) {
+      if (!buffer->multiPages_.empty()) {
+        return;
+      }
+      continue;
+    }
+    ++numChunks;
+    countUsed(buffer->metadataPages_);
+    for (const auto& multiPage : buffer->multiPages_) {
+      countUsed(multiPage);
+    }
+  }
+  if (!checkpointed) {
+    return;
+  }
+  size_t numFiles{0};
+  for (const auto fileInfo : files_) {
+    if (fileInfo) {
+      if (usedPageCounts[fileInfo->fileId] + fileInfo->numFreePages() !=
+          fileInfo->numPages) {
+        VLOG(1) << "Not writing the header index of table location '" << fileMgrBasePath_
+                << "', file " << fileInfo->fileId << " has pages of deleted chunks";
+        return;
+      }
+      ++numFiles;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(headerIndexMutex_);
+  const auto headerIndexPath = getHeaderIndexPath();
+  const auto tempPath = headerIndexPath + ".tmp";
+  FILE* f = omnisci::fopen(tempPath.c_str(), "wb");
+  if (f == nullptr) {
+    LOG(FATAL) << "Error trying to create file '" << tempPath
+               << "', the error was: " << std::strerror(errno);
+  }
+  int header[2] = {HEADER_INDEX_VERSION, epoch_ - 1};  // the epoch just checkpointed
+  size_t indexSize{0};                                  // written last
+  write_values(f, header, 2);
+  write_values(f, &indexSize, 1);
+  write_values(f, &numFiles, 1);
+  for (const auto fileInfo : files_) {
+    if (fileInfo) {
+      size_t pageInfo[2] = {fileInfo->pageSize, fileInfo->numPages};
+      write_values(f, &fileInfo->fileId, 1);
+      write_values(f, pageInfo, 2);
+    }
+  }
+  write_values(f, &numChunks, 1);
+  for (const auto& [chunkKey, buffer] : chunkIndex_) {
+    if (!buffer->metadataPages_.pageVersions.empty()) {
+      size_t keySize = chunkKey.size();
+      write_values(f, &keySize, 1);
+      write_values(f, chunkKey.data(), keySize);
+      buffer->writeHeaderIndexEntry(f);
+    }
+  }
+  indexSize = ftell(f);
+  CHECK_EQ(fseek(f, sizeof(header), SEEK_SET), 0);
+  write_values(f, &indexSize, 1);
+  sync_to_disk(f, tempPath);
+  CHECK_EQ(fclose(f), 0);
+  boost::filesystem::rename(tempPath, headerIndexPath);
+  headerIndexOnDisk_ = true;
+}
+
+void FileMgr::invalidateHeaderIndex() {
+  if (!headerIndexOnDisk_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(headerIndexMutex_);
+  if (!headerIndexOnDisk_) {
+    return;
+  }
+  // no checkpoint has a negative epoch, synced before the page change it guards against
+  // reaches the disk
+  const auto headerIndexPath = getHeaderIndexPath();
+  FILE* f = open(headerIndexPath);
+  int invalidEpoch{-1};
+  write(f, sizeof(int), sizeof(int), (int8_t*)&invalidEpoch);
+  sync_to_disk(f, headerIndexPath);
+  close(f);
+  headerIndexOnDisk_ = false;
+}
+
+void FileMgr::checkpoint() {
+  VLOG(2) << "Checkpointing epoch: " << epoch_;
+  mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(chunkIndexMutex_);
+  writeDirtyMetadataPages();
+  chunkIndexWriteLock.unlock();
+
+  syncFilesToDisk();
+
+  // only once all the pages of the epoch are on disk
   writeAndSyncEpochToDisk();
 
   mapd_unique_lock<mapd_shared_mutex> freePagesWriteLock(mutex_free_page);
@@ -615,6 +907,73 @@ void FileMgr::checkpoint() {
     free_page.first->freePageDeferred(free_page.second);
   }
   free_pages.clear();
+  freePagesWriteLock.unlock();
+
+  if (g_enable_header_index_file) {
+    writeHeaderIndex();
+  }
+}
+
+void FileMgr::writeDirtyMetadataPages() {
+  if (!g_enable_parallel_checkpoint) {
+    for (auto chunkIt = chunkIndex_.begin(); chunkIt != chunkIndex_.end(); ++chunkIt) {
+      if (chunkIt->second->isDirty()) {
+        chunkIt->second->writeMetadata(epoch_);
+        chunkIt->second->clearDirtyBits();
+      }
+    }
+    return;
+  }
+  // the images of the pages by file, then by page number
+  std::map<int, std::map<size_t, std::vector<int8_t>>> filePages;
+  for (auto chunkIt = chunkIndex_.begin(); chunkIt != chunkIndex_.end(); ++chunkIt) {
+    if (chunkIt->second->isDirty()) {
+      Page page;
+      auto image = chunkIt->second->writeMetadataToImage(epoch_, page);
+      filePages[page.fileId].emplace(page.pageNum, std::move(image));
+      chunkIt->second->clearDirtyBits();
+    }
+  }
+  // the runs of consecutive pages of a file are written at once
+  std::vector<std::function<void()>> fileWrites;
+  for (const auto& [fileId, pages] : filePages) {
+    fileWrites.emplace_back([fileInfo = getFileInfoForFileId(fileId), &pages = pages] {
+      std::vector<int8_t> run;
+      size_t runStartPage{0};
+      for (const auto& [pageNum, image] : pages) {
+        if (!run.empty() && runStartPage + run.size() / fileInfo->pageSize != pageNum) {
+          fileInfo->write(runStartPage * fileInfo->pageSize, run.size(), run.data());
+          run.clear();
+        }
+        if (run.empty()) {
+          runStartPage = pageNum;
+        }
+        run.insert(run.end(), image.begin(), image.end());
+      }
+      fileInfo->write(runStartPage * fileInfo->pageSize, run.size(), run.data());
+    });
+  }
+  run_in_parallel(fileWrites);
+}
+
+void FileMgr::syncFilesToDisk() {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(files_rw_mutex_);
+  std::vector<std::function<void()>> fileSyncs;
+  for (auto fileIt = files_.begin(); fileIt != files_.end(); ++fileIt) {
+    fileSyncs.emplace_back([fileInfo = *fileIt] {
+      int status = fileInfo->syncToDisk();
+      if (status != 0) {
+        LOG(FATAL) << "Could not sync file to disk";
+      }
+    });
+  }
+  if (g_enable_parallel_checkpoint) {
+    run_in_parallel(fileSyncs);
+  } else {
+    for (const auto& fileSync : fileSyncs) {
+      fileSync();
+    }
+  }
 }
 
 FileBuffer* FileMgr::createBuffer(const ChunkKey& key,
@@ -799,6 +1158,7 @@ void FileMgr::free(AbstractBuffer* buffer) {
 }
 
 Page FileMgr::requestFreePage(size_t pageSize, const bool isMetadata) {
+  invalidateHeaderIndex();
   std::lock_guard<std::mutex> lock(getPageMutex_);
 
   auto candidateFiles = fileIndex_.equal_range(pageSize);
@@ -828,6 +1188,7 @@ void FileMgr::requestFreePages(size_t numPagesRequested,
                                const bool isMetadata) {
   // not used currently
   // @todo add method to FileInfo to get more than one page
+  invalidateHeaderIndex();
   std::lock_guard<std::mutex> lock(getPageMutex_);
   auto candidateFiles = fileIndex_.equal_range(pageSize);
   size_t numPagesNeeded = numPagesRequested;
@@ -872,11 +1233,19 @@ FileInfo* FileMgr::openExistingFile(const std::string& path,
                                     const size_t pageSize,
                                     const size_t numPages,
                                     std::vector<HeaderInfo>& headerVec) {
+  FileInfo* fInfo = openExistingFile(path, fileId, pageSize, numPages);
+  fInfo->openExistingFile(headerVec, epoch_);
+  return fInfo;
+}
+
+FileInfo* FileMgr::openExistingFile(const std::string& path,
+                                    const int fileId,
+                                    const size_t pageSize,
+                                    const size_t numPages) {
   FILE* f = open(path);
   FileInfo* fInfo = new FileInfo(
       this, fileId, f, pageSize, numPages, false);  // false means don't init file
 
-  fInfo->openExistingFile(headerVec, epoch_);
   mapd_unique_lock<mapd_shared_mutex> write_lock(files_rw_mutex_);
   if (fileId >= static_cast<int>(files_.size())) {
     files_.resize(fileId + 1);
@@ -964,11 +1333,13 @@ void FileMgr::createTopLevelMetadata() {
 }
 
 void FileMgr::setEpoch(int epoch) {
+  invalidateHeaderIndex();
   epoch_ = epoch;
   writeAndSyncEpochToDisk();
 }
 
 void FileMgr::free_page(std::pair<FileInfo*, int>&& page) {
+  invalidateHeaderIndex();
   std::unique_lock<mapd_shared_mutex> lock(mutex_free_page);
   free_pages.push_back(page);
 }
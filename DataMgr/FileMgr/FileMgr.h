@@ -25,10 +25,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <future>
 #include <iostream>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -41,6 +43,11 @@
 
 using namespace Data_Namespace;
 
+extern bool g_enable_header_index_file;
+// Writes the metadata pages of the dirty chunks and syncs the files of a table from
+// several threads at checkpoints.
+extern bool g_enable_parallel_checkpoint;
+
 namespace File_Namespace {
 
 class GlobalFileMgr;  // forward declaration
@@ -225,6 +232,10 @@ class FileMgr : public AbstractBufferMgr {  // implements
   bool getDBConvert() const;
   void createTopLevelMetadata();  // create metadata shared by all tables of all DBs
   std::string getFileMgrBasePath() const { return fileMgrBasePath_; }
+  static std::string getFileMgrBasePath(const std::string& basePath,
+                                        const std::pair<const int, const int> fileMgrKey);
+  /// Returns the epoch of the last checkpoint from the epoch file, if there is one
+  static std::optional<int> readCheckpointedEpoch(const std::string& fileMgrBasePath);
   void closeRemovePhysical();
 
   void removeTableRelatedDS(const int db_id, const int table_id) override;
@@ -259,6 +270,16 @@ class FileMgr : public AbstractBufferMgr {  // implements
   mutable mapd_shared_mutex mutex_free_page;
   std::vector<std::pair<FileInfo*, int>> free_pages;
 
+  /**
+   * The header index file holds the page versions and the metadata of every chunk, and
+   * the page count of every data file, as of the last checkpoint. When it matches the
+   * epoch and the data files at startup, it replaces the scan of every page header. It
+   * is rewritten at every checkpoint and marked invalid before the first page is
+   * allocated or freed past it, so that it never describes pages which aren't on disk.
+   */
+  std::atomic<bool> headerIndexOnDisk_{false};  /// whether the index file is valid
+  std::mutex headerIndexMutex_;
+
   /**
    * @brief Adds a file to the file manager repository.
    *
@@ -281,9 +302,22 @@ class FileMgr : public AbstractBufferMgr {  // implements
                              const size_t pageSize,
                              const size_t numPages,
                              std::vector<HeaderInfo>& headerVec);
+  FileInfo* openExistingFile(const std::string& path,
+                             const int fileId,
+                             const size_t pageSize,
+                             const size_t numPages);
+  void readFileHeaders();
+  std::string getHeaderIndexPath() const;
+  /// Returns false, without side effects, if the index can't be used
+  bool readHeaderIndex();
+  void writeHeaderIndex();
+  void invalidateHeaderIndex();
   void createEpochFile(const std::string& epochFileName);
   void openEpochFile(const std::string& epochFileName);
   void writeAndSyncEpochToDisk();
+  /// Writes the metadata pages of the dirty chunks, requires chunkIndexMutex_
+  void writeDirtyMetadataPages();
+  void syncFilesToDisk();
   void createDBMetaFile(const std::string& DBMetaFileName);
   bool openDBMetaFile(const std::string& DBMetaFileName);
   void writeAndSyncDBMetaToDisk();
@@ -125,6 +125,7 @@ void GlobalFileMgr::deleteFileMgr(const int db_id, const int tb_id) {
   if (auto it = allFileMgrs_.find(file_mgr_key); it != allFileMgrs_.end()) {
     allFileMgrs_.erase(it);
   }
+  fileMgrOpenMutexes_.erase(file_mgr_key);
 }
 
 AbstractBufferMgr* GlobalFileMgr::getFileMgr(const int db_id, const int tb_id) {
@@ -136,27 +137,45 @@ AbstractBufferMgr* GlobalFileMgr::getFileMgr(const int db_id, const int tb_id) {
     }
   }
 
-  {  // create new FileMgr for (db_id, tb_id)
+  const auto file_mgr_key = std::make_pair(db_id, tb_id);
+  std::shared_ptr<std::mutex> open_mutex;
+  {
     mapd_unique_lock<mapd_shared_mutex> write_lock(fileMgrs_mutex_);
     AbstractBufferMgr* fm = findFileMgr(db_id, tb_id);
     if (fm) {
       return fm;  // mgr was added between the read lock and the write lock
     }
-    const auto file_mgr_key = std::make_pair(db_id, tb_id);
     const auto foreign_buffer_manager =
         ForeignStorageInterface::lookupBufferManager(db_id, tb_id);
     if (foreign_buffer_manager) {
       CHECK(allFileMgrs_.insert(std::make_pair(file_mgr_key, foreign_buffer_manager))
                 .second);
       return foreign_buffer_manager;
-    } else {
-      auto s = std::make_shared<FileMgr>(
-          0, this, file_mgr_key, num_reader_threads_, epoch_, defaultPageSize_);
-      CHECK(ownedFileMgrs_.insert(std::make_pair(file_mgr_key, s)).second);
-      CHECK(allFileMgrs_.insert(std::make_pair(file_mgr_key, s.get())).second);
-      return s.get();
     }
+    auto& table_open_mutex = fileMgrOpenMutexes_[file_mgr_key];
+    if (!table_open_mutex) {
+      table_open_mutex = std::make_shared<std::mutex>();
+    }
+    open_mutex = table_open_mutex;
   }
+
+  // Opening a table reads the metadata of all its chunks, only the threads which need
+  // the same table wait for it. The open tables stay available and the others can open
+  // at the same time.
+  std::lock_guard<std::mutex> open_lock(*open_mutex);
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+    AbstractBufferMgr* fm = findFileMgr(db_id, tb_id);
+    if (fm) {
+      return fm;  // opened by the thread we waited for
+    }
+  }
+  auto s = std::make_shared<FileMgr>(
+      0, this, file_mgr_key, num_reader_threads_, epoch_, defaultPageSize_);
+  mapd_unique_lock<mapd_shared_mutex> write_lock(fileMgrs_mutex_);
+  CHECK(ownedFileMgrs_.insert(std::make_pair(file_mgr_key, s)).second);
+  CHECK(allFileMgrs_.insert(std::make_pair(file_mgr_key, s.get())).second);
+  return s.get();
 }
 
 // For testing purposes only
@@ -232,6 +251,18 @@ void GlobalFileMgr::setTableEpoch(const int db_id,
 }
 
 size_t GlobalFileMgr::getTableEpoch(const int db_id, const int tb_id) {
+  if (epoch_ == -1) {
+    // A table which isn't open yet resumes past the epoch of its last checkpoint, no
+    // need to read the metadata of its chunks to find it.
+    mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+    if (!findFileMgr(db_id, tb_id)) {
+      const auto epoch = FileMgr::readCheckpointedEpoch(
+          FileMgr::getFileMgrBasePath(basePath_, std::make_pair(db_id, tb_id)));
+      if (epoch) {
+        return *epoch + 1;
+      }
+    }
+  }
   auto fm = dynamic_cast<FileMgr*>(getFileMgr(db_id, tb_id));
   CHECK(fm);
   return fm->epoch_;
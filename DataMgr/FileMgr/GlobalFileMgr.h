@@ -189,6 +189,8 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
 
   std::map<std::pair<int, int>, std::shared_ptr<FileMgr>> ownedFileMgrs_;
   std::map<std::pair<int, int>, AbstractBufferMgr*> allFileMgrs_;
+  /// held while a table is opened by getFileMgr, the other tables stay available
+  std::map<std::pair<int, int>, std::shared_ptr<std::mutex>> fileMgrOpenMutexes_;
 
   mapd_shared_mutex fileMgrs_mutex_;
 };
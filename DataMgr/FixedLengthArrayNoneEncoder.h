@@ -26,8 +26,10 @@
 
 #include "Logger/Logger.h"
 
+#include <array>
 #include <cassert>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -41,7 +43,16 @@ using Data_Namespace::AbstractBuffer;
 class FixedLengthArrayNoneEncoder : public Encoder {
  public:
   FixedLengthArrayNoneEncoder(AbstractBuffer* buffer, size_t as)
-      : Encoder(buffer), has_nulls(false), initialized(false), array_size(as) {}
+      : Encoder(buffer), has_nulls(false), initialized(false), array_size(as) {
+    if (buffer_ && buffer_->getSqlType().get_subtype() == kDOUBLE &&
+        array_size == sizeof(GeoBounds)) {
+      // the bounds of geo columns, start from an empty box
+      geo_bounds_ = GeoBounds{std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::lowest(),
+                              std::numeric_limits<double>::lowest()};
+    }
+  }
 
   size_t getNumElemsForBytesInsertData(const std::vector<ArrayDatum>* srcData,
                                        const int start_idx,
@@ -98,6 +109,7 @@ class FixedLengthArrayNoneEncoder : public Encoder {
   void getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) override {
     Encoder::getMetadata(chunkMetadata);  // call on parent class
     chunkMetadata->fillChunkStats(elem_min, elem_max, has_nulls);
+    chunkMetadata->geoBounds = geo_bounds_;
   }
 
   // Only called from the executor for synthesized meta-information.
@@ -147,6 +159,8 @@ class FixedLengthArrayNoneEncoder : public Encoder {
     fread((int8_t*)&elem_max, sizeof(Datum), 1, f);
     fread((int8_t*)&has_nulls, sizeof(bool), 1, f);
     fread((int8_t*)&initialized, sizeof(bool), 1, f);
+    // not part of the metadata on disk
+    geo_bounds_.reset();
   }
 
   void copyMetadata(const Encoder* copyFromEncoder) override {
@@ -157,6 +171,7 @@ class FixedLengthArrayNoneEncoder : public Encoder {
     elem_max = array_encoder->elem_max;
     has_nulls = array_encoder->has_nulls;
     initialized = array_encoder->initialized;
+    geo_bounds_ = array_encoder->geo_bounds_;
   }
 
   void updateMetadata(int8_t* array) {
@@ -223,15 +238,36 @@ class FixedLengthArrayNoneEncoder : public Encoder {
   bool initialized;
 
  private:
+  using GeoBounds = std::array<double, 4>;
+
   std::mutex EncoderMutex_;
   size_t array_size;
+  // The union of the boxes of the arrays of four doubles, for the fragments to be skipped
+  // by geo filters. Any value it hasn't seen could be outside of it, so it is dropped
+  // when the stats are read from disk.
+  std::optional<GeoBounds> geo_bounds_;
 
   bool is_null(int8_t* array) { return is_null(buffer_->getSqlType(), array); }
 
+  void update_geo_bounds(const ArrayDatum& array) {
+    if (!geo_bounds_ || array.is_null) {
+      return;
+    }
+    CHECK_EQ(array.length, sizeof(GeoBounds));
+    GeoBounds box;
+    std::memcpy(box.data(), array.pointer, sizeof(GeoBounds));
+    auto& bounds = *geo_bounds_;
+    bounds[0] = std::min(bounds[0], box[0]);
+    bounds[1] = std::min(bounds[1], box[1]);
+    bounds[2] = std::max(bounds[2], box[2]);
+    bounds[3] = std::max(bounds[3], box[3]);
+  }
+
   void update_elem_stats(const ArrayDatum& array) {
     if (array.is_null) {
       has_nulls = true;
     }
+    update_geo_bounds(array);
     switch (buffer_->getSqlType().get_subtype()) {
       case kBOOLEAN: {
         if (!initialized) {
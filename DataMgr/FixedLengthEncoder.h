@@ -22,6 +22,7 @@
 #include <memory>
 #include <stdexcept>
 #include "AbstractBuffer.h"
+#include "ChunkStatsKernels.h"
 #include "Encoder.h"
 
 #include <Shared/DatumFetchers.h>
@@ -36,7 +37,9 @@ class FixedLengthEncoder : public Encoder {
       : Encoder(buffer)
       , dataMin(std::numeric_limits<T>::max())
       , dataMax(std::numeric_limits<T>::min())
-      , has_nulls(false) {}
+      , has_nulls(false) {
+    initBloomFilter();
+  }
 
   std::shared_ptr<ChunkMetadata> appendData(int8_t*& src_data,
                                             const size_t num_elems_to_append,
@@ -45,9 +48,16 @@ class FixedLengthEncoder : public Encoder {
                                             const int64_t offset = -1) override {
     T* unencoded_data = reinterpret_cast<T*>(src_data);
     auto encoded_data = std::make_unique<V[]>(num_elems_to_append);
-    for (size_t i = 0; i < num_elems_to_append; ++i) {
-      size_t ri = replicating ? 0 : i;
-      encoded_data.get()[i] = encodeDataAndUpdateStats(unencoded_data[ri]);
+    detachBloomFilter();
+    if (!replicating && encodeBlockAndUpdateStats(
+                            unencoded_data, encoded_data.get(), num_elems_to_append)) {
+      addToBloomFilter(encoded_data.get(), num_elems_to_append);
+    } else {
+      for (size_t i = 0; i < num_elems_to_append; ++i) {
+        size_t ri = replicating ? 0 : i;
+        encoded_data.get()[i] = encodeDataAndUpdateStats(unencoded_data[ri]);
+        addToBloomFilter(static_cast<int64_t>(encoded_data.get()[i]));
+      }
     }
 
     // assume always CPU_BUFFER?
@@ -60,6 +70,7 @@ class FixedLengthEncoder : public Encoder {
       }
     } else {
       num_elems_ = offset + num_elems_to_append;
+      invalidateBloomFilter();
       CHECK(!replicating);
       CHECK_GE(offset, 0);
       buffer_->write(reinterpret_cast<int8_t*>(encoded_data.get()),
@@ -85,6 +96,7 @@ class FixedLengthEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const int64_t val, const bool is_null) override {
+    invalidateBloomFilter();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -96,6 +108,7 @@ class FixedLengthEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const double val, const bool is_null) override {
+    invalidateBloomFilter();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -106,7 +119,12 @@ class FixedLengthEncoder : public Encoder {
   }
 
   void updateStats(const int8_t* const src_data, const size_t num_elements) override {
+    invalidateBloomFilter();
     const T* unencoded_data = reinterpret_cast<const T*>(src_data);
+    std::vector<V> encoded_data(num_elements);
+    if (encodeBlockAndUpdateStats(unencoded_data, encoded_data.data(), num_elements)) {
+      return;
+    }
     for (size_t i = 0; i < num_elements; ++i) {
       encodeDataAndUpdateStats(unencoded_data[i]);
     }
@@ -114,6 +132,7 @@ class FixedLengthEncoder : public Encoder {
 
   void updateStatsEncoded(const int8_t* const dst_data,
                           const size_t num_elements) override {
+    invalidateBloomFilter();
     const V* data = reinterpret_cast<const V*>(dst_data);
 
     std::tie(dataMin, dataMax, has_nulls) = tbb::parallel_reduce(
@@ -155,6 +174,7 @@ class FixedLengthEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void reduceStats(const Encoder& that) override {
+    invalidateBloomFilter();
     const auto that_typed = static_cast<const FixedLengthEncoder<T, V>&>(that);
     if (that_typed.has_nulls) {
       has_nulls = true;
@@ -170,6 +190,7 @@ class FixedLengthEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    bloom_filter_ = castedEncoder->bloom_filter_;
   }
 
   void writeMetadata(FILE* f) override {
@@ -186,6 +207,7 @@ class FixedLengthEncoder : public Encoder {
     fread((int8_t*)&dataMin, 1, sizeof(T), f);
     fread((int8_t*)&dataMax, 1, sizeof(T), f);
     fread((int8_t*)&has_nulls, 1, sizeof(bool), f);
+    invalidateBloomFilter();
   }
 
   bool resetChunkStats(const ChunkStats& stats) override {
@@ -199,6 +221,7 @@ class FixedLengthEncoder : public Encoder {
     dataMin = new_min;
     dataMax = new_max;
     has_nulls = stats.has_nulls;
+    invalidateBloomFilter();
     return true;
   }
 
@@ -226,6 +249,28 @@ class FixedLengthEncoder : public Encoder {
     }
     return encoded_data;
   }
+
+  // Leaves the stats untouched if a value doesn't fit in V, to be encoded element by
+  // element for the failures to be logged.
+  bool encodeBlockAndUpdateStats(const T* unencoded_data,
+                                 V* encoded_data,
+                                 const size_t num_elems) {
+    chunk_stats::BlockStats<T> block_stats;
+    if (!chunk_stats::encode_block(
+            unencoded_data, encoded_data, num_elems, block_stats)) {
+      return false;
+    }
+    if (block_stats.has_nulls) {
+      has_nulls = true;
+    }
+    if (block_stats.hasValues()) {
+      decimal_overflow_validator_.validate(block_stats.min);
+      decimal_overflow_validator_.validate(block_stats.max);
+      dataMin = std::min(dataMin, block_stats.min);
+      dataMax = std::max(dataMax, block_stats.max);
+    }
+    return true;
+  }
 };  // FixedLengthEncoder
 
 #endif  // FIXED_LENGTH_ENCODER_H
@@ -56,6 +56,10 @@ class ArrowForeignStorageBase : public PersistentForeignStorageInterface {
             int8_t* dest,
             const size_t numBytes) override;
 
+  int8_t* getZeroCopyPtr(const ChunkKey& chunk_key,
+                         const SQLTypeInfo& sql_type,
+                         const size_t numBytes) override;
+
   void parseArrowTable(Catalog_Namespace::Catalog* catalog,
                        std::pair<int, int> table_key,
                        const std::string& type,
@@ -463,6 +467,40 @@ void ArrowForeignStorageBase::append(
   CHECK(false);
 }
 
+int8_t* ArrowForeignStorageBase::getZeroCopyPtr(const ChunkKey& chunk_key,
+                                                const SQLTypeInfo& sql_type,
+                                                const size_t numBytes) {
+  // the buffers of varlen columns are merged and rebased by read
+  if (chunk_key.size() != 4) {
+    return nullptr;
+  }
+  std::array<int, 3> col_key{chunk_key[0], chunk_key[1], chunk_key[2]};
+  auto& frag = m_columns.at(col_key).at(chunk_key[3]);
+  // a fragment spanning several arrow chunks has to be copied into a contiguous buffer
+  if (frag.chunks.size() != 1) {
+    return nullptr;
+  }
+  const auto& array_data = frag.chunks.front();
+  // all null chunks have no values buffer, read generates their sentinels
+  if (!sql_type.is_dict_encoded_string() &&
+      array_data->null_count == array_data->length) {
+    return nullptr;
+  }
+  auto fixed_type = dynamic_cast<arrow::FixedWidthType*>(array_data->type.get());
+  if (!fixed_type || fixed_type->bit_width() % 8 || array_data->buffers.size() < 2 ||
+      !array_data->buffers[1]) {
+    return nullptr;
+  }
+  const size_t width = fixed_type->bit_width() / 8;
+  if (static_cast<size_t>(frag.sz) * width != numBytes) {
+    return nullptr;
+  }
+  // the null sentinels were written into the arrow buffers when the table was registered,
+  // and m_columns keeps them alive as long as the table
+  return const_cast<int8_t*>(reinterpret_cast<const int8_t*>(
+      array_data->buffers[1]->data() + (array_data->offset + frag.offset) * width));
+}
+
 void ArrowForeignStorageBase::read(const ChunkKey& chunk_key,
                                    const SQLTypeInfo& sql_type,
                                    int8_t* dest,
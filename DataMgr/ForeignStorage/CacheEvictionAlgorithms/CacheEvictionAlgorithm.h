@@ -41,4 +41,5 @@ class CacheEvictionAlgorithm {
   virtual const ChunkKey evictNextChunk() = 0;
   virtual void touchChunk(const ChunkKey&) = 0;
   virtual void removeChunk(const ChunkKey&) = 0;
+  virtual std::string dumpEvictionQueue() = 0;
 };
@@ -45,7 +45,7 @@ class LRUEvictionAlgorithm : public CacheEvictionAlgorithm {
   // Removes a chunk from the eviction queue if present.
   void removeChunk(const ChunkKey&) override;
   // Used for debugging.
-  std::string dumpEvictionQueue();
+  std::string dumpEvictionQueue() override;
 
  private:
   std::list<ChunkKey> cache_items_list_;
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TwoQueueEvictionAlgorithm.h"
+
+const ChunkKey TwoQueueEvictionAlgorithm::evictNextChunk() {
+  const size_t cached_count = in_queue_.size() + main_queue_.size();
+  if (cached_count < 1) {
+    throw NoEntryFoundException();
+  }
+  if (main_queue_.empty() || in_queue_.size() * 100 > cached_count * kInQueuePercent) {
+    const ChunkKey ret = popBack(Queue::in);
+    pushFront(ret, Queue::ghost);
+    while (ghost_queue_.size() > cached_count - 1) {
+      popBack(Queue::ghost);
+    }
+    return ret;
+  }
+  return popBack(Queue::main);
+}
+
+void TwoQueueEvictionAlgorithm::touchChunk(const ChunkKey& key) {
+  auto it = cache_items_map_.find(key);
+  if (it == cache_items_map_.end()) {
+    pushFront(key, Queue::in);
+    return;
+  }
+  auto [queue, list_it] = it->second;
+  if (queue == Queue::in) {
+    // Repeated uses of a chunk soon after it was cached do not tell it apart from a scan
+    return;
+  }
+  getQueue(queue).erase(list_it);
+  cache_items_map_.erase(it);
+  pushFront(key, Queue::main);
+}
+
+void TwoQueueEvictionAlgorithm::removeChunk(const ChunkKey& key) {
+  auto it = cache_items_map_.find(key);
+  if (it == cache_items_map_.end()) {
+    return;
+  }
+  getQueue(it->second.first).erase(it->second.second);
+  cache_items_map_.erase(it);
+}
+
+std::string TwoQueueEvictionAlgorithm::dumpEvictionQueue() {
+  std::string ret = "Eviction queues:\n";
+  for (const auto& [name, queue] : {std::make_pair("in", &in_queue_),
+                                    std::make_pair("main", &main_queue_),
+                                    std::make_pair("ghost", &ghost_queue_)}) {
+    ret += std::string(name) + ": {";
+    for (const auto& chunk : *queue) {
+      ret += show_chunk(chunk) + ", ";
+    }
+    ret += "}\n";
+  }
+  return ret;
+}
+
+std::list<ChunkKey>& TwoQueueEvictionAlgorithm::getQueue(const Queue queue) {
+  switch (queue) {
+    case Queue::in:
+      return in_queue_;
+    case Queue::main:
+      return main_queue_;
+    case Queue::ghost:
+      return ghost_queue_;
+  }
+  UNREACHABLE();
+  return in_queue_;
+}
+
+void TwoQueueEvictionAlgorithm::pushFront(const ChunkKey& key, const Queue queue) {
+  auto& list = getQueue(queue);
+  list.emplace_front(key);
+  cache_items_map_[key] = {queue, list.begin()};
+}
+
+const ChunkKey TwoQueueEvictionAlgorithm::popBack(const Queue queue) {
+  auto& list = getQueue(queue);
+  CHECK(!list.empty());
+  const ChunkKey ret = list.back();
+  cache_items_map_.erase(ret);
+  list.pop_back();
+  return ret;
+}
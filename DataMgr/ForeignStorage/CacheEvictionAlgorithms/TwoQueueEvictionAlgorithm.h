@@ -0,0 +1,65 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file	TwoQueueEvictionAlgorithm.h
+ *
+ * This file includes the class specification for the 2Q cache eviction algorithm used by
+ * the Foreign Storage Interface (FSI).
+ *
+ * Chunks cached for the first time enter a FIFO queue, which evicts them in order while
+ * it holds more than its share of the cached chunks. The keys of the chunks it evicted
+ * are remembered in a ghost queue for a while. A chunk cached again while its key is
+ * remembered enters the main LRU queue, which only gives up chunks when the FIFO queue
+ * is within its share. A scan that touches every chunk of a table once then only cycles
+ * through the FIFO queue, rather than evicting the chunks that are used repeatedly.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include "CacheEvictionAlgorithm.h"
+
+class TwoQueueEvictionAlgorithm : public CacheEvictionAlgorithm {
+ public:
+  ~TwoQueueEvictionAlgorithm() override {}
+  // Returns the next chunk to evict.
+  const ChunkKey evictNextChunk() override;
+  // Update the algorithm knowing that this chunk was recently touched by the system.
+  void touchChunk(const ChunkKey&) override;
+  // Removes a chunk from the eviction queues, and forgets it, if present.
+  void removeChunk(const ChunkKey&) override;
+  // Used for debugging.
+  std::string dumpEvictionQueue() override;
+
+ private:
+  enum class Queue { in, main, ghost };
+
+  std::list<ChunkKey>& getQueue(const Queue queue);
+  void pushFront(const ChunkKey& key, const Queue queue);
+  const ChunkKey popBack(const Queue queue);
+
+  // Share of the cached chunks, in percent, beyond which the FIFO queue evicts first.
+  static constexpr size_t kInQueuePercent{25};
+
+  std::list<ChunkKey> in_queue_;
+  std::list<ChunkKey> main_queue_;
+  // Keys of the chunks evicted from in_queue_, no more than there are cached chunks.
+  std::list<ChunkKey> ghost_queue_;
+  std::map<const ChunkKey, std::pair<Queue, std::list<ChunkKey>::iterator>>
+      cache_items_map_;
+};
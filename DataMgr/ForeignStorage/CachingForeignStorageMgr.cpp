@@ -124,6 +124,13 @@ void CachingForeignStorageMgr::refreshAppendTableInCache(
 
   ChunkMetadataVector storage_metadata;
   getChunkMetadataVecForKeyPrefix(storage_metadata, table_key);
+  refreshAppendedChunksInCache(storage_metadata, old_chunk_keys, last_frag_id);
+}
+
+void CachingForeignStorageMgr::refreshAppendedChunksInCache(
+    const ChunkMetadataVector& storage_metadata,
+    const std::vector<ChunkKey>& old_chunk_keys,
+    const int last_frag_id) {
   try {
     disk_cache_->cacheMetadataWithFragIdGreaterOrEqualTo(storage_metadata, last_frag_id);
     refreshChunksInCacheByFragment(old_chunk_keys, last_frag_id);
@@ -136,12 +143,22 @@ void CachingForeignStorageMgr::refreshNonAppendTableInCache(
     const ChunkKey& table_key,
     const std::vector<ChunkKey>& old_chunk_keys) {
   CHECK(is_table_key(table_key));
+  // The recovered data wrapper knows which data it scanned before, so that it can tell
+  // whether the data was only appended to since.
+  createOrRecoverDataWrapperIfNotExists(table_key);
+  int last_frag_id = getHighestCachedFragId(table_key);
+
   // Getting metadata from (foreign) storage could throw if we have lost our connnection.
   // Therefore we only want clear the cache and refresh after we have confirmed that we
   // can get new data from storage, if we can't reach storage then throwing here will
   // leave the cache unchanged.
   ChunkMetadataVector storage_metadata;
   getChunkMetadataVecForKeyPrefix(storage_metadata, table_key);
+  if (getDataWrapper(table_key)->isLastScanAppendOnly()) {
+    // Only new files were scanned, the cached chunks of the other fragments are valid
+    refreshAppendedChunksInCache(storage_metadata, old_chunk_keys, last_frag_id);
+    return;
+  }
   disk_cache_->clearForTablePrefix(table_key);
   try {
     disk_cache_->cacheMetadataVec(storage_metadata);
@@ -43,6 +43,9 @@ class CachingForeignStorageMgr : public ForeignStorageMgr {
   int getHighestCachedFragId(const ChunkKey& table_key);
   void refreshAppendTableInCache(const ChunkKey& table_key,
                                  const std::vector<ChunkKey>& old_chunk_keys);
+  void refreshAppendedChunksInCache(const ChunkMetadataVector& storage_metadata,
+                                    const std::vector<ChunkKey>& old_chunk_keys,
+                                    const int last_frag_id);
   void refreshNonAppendTableInCache(const ChunkKey& table_key,
                                     const std::vector<ChunkKey>& old_chunk_keys);
   void refreshChunksInCacheByFragment(const std::vector<ChunkKey>& old_chunk_keys,
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <condition_variable>
+#include <future>
 #include <mutex>
 
 #include <rapidjson/document.h>
@@ -33,10 +34,18 @@
 
 namespace foreign_storage {
 CsvDataWrapper::CsvDataWrapper(const int db_id, const ForeignTable* foreign_table)
-    : db_id_(db_id), foreign_table_(foreign_table), is_restored_(false) {}
+    : db_id_(db_id)
+    , foreign_table_(foreign_table)
+    , is_restored_(false)
+    , is_last_scan_append_only_(false) {}
 
 CsvDataWrapper::CsvDataWrapper(const ForeignTable* foreign_table)
-    : db_id_(-1), foreign_table_(foreign_table), is_restored_(false) {}
+    : db_id_(-1)
+    , foreign_table_(foreign_table)
+    , is_restored_(false)
+    , is_last_scan_append_only_(false) {}
+
+CsvDataWrapper::~CsvDataWrapper() {}
 
 void CsvDataWrapper::validateOptions(const ForeignTable* foreign_table) {
   CsvDataWrapper data_wrapper{foreign_table};
@@ -268,7 +277,10 @@ ParseFileRegionResult parse_file_regions(
     CHECK(file_regions[i].region_size <= parse_file_request.buffer_size);
     size_t read_size;
     {
-      std::lock_guard<std::mutex> lock(file_access_mutex);
+      std::unique_lock<std::mutex> lock(file_access_mutex, std::defer_lock);
+      if (!csv_reader.isConcurrentRegionReadSupported()) {
+        lock.lock();
+      }
       read_size = csv_reader.readRegion(parse_file_request.buffer.get(),
                                         file_regions[i].first_row_file_offset,
                                         file_regions[i].region_size);
@@ -345,12 +357,31 @@ size_t get_thread_count(const import_export::CopyParams& copy_params,
   return thread_count;
 }
 
-void CsvDataWrapper::populateChunks(
-    std::map<int, Chunk_NS::Chunk>& column_id_to_chunk_map,
-    int fragment_id) {
+/**
+ * File regions of a fragment being parsed on other threads. The data blocks of the
+ * results point into the import buffers of the requests.
+ */
+struct FragmentParse {
+  int fragment_id;
+  std::set<int> column_ids;
+  std::vector<csv_file_buffer_parser::ParseBufferRequest> parse_file_requests;
+  std::vector<std::future<ParseFileRegionResult>> futures;
+
+  ~FragmentParse() {
+    // the requests must outlive the threads parsing into them
+    for (auto& future : futures) {
+      if (future.valid()) {
+        future.wait();
+      }
+    }
+  }
+};
+
+std::unique_ptr<FragmentParse> CsvDataWrapper::parseFragmentAsync(
+    const int fragment_id,
+    const std::set<int>& column_ids) {
   const auto copy_params = validateAndGetCopyParams();
 
-  CHECK(!column_id_to_chunk_map.empty());
   const auto& file_regions = fragment_id_to_file_regions_map_[fragment_id];
   CHECK(!file_regions.empty());
 
@@ -359,32 +390,62 @@ void CsvDataWrapper::populateChunks(
 
   const int batch_size = (file_regions.size() + thread_count - 1) / thread_count;
 
-  std::vector<csv_file_buffer_parser::ParseBufferRequest> parse_file_requests{};
+  auto fragment_parse = std::make_unique<FragmentParse>();
+  fragment_parse->fragment_id = fragment_id;
+  fragment_parse->column_ids = column_ids;
+  auto& parse_file_requests = fragment_parse->parse_file_requests;
   parse_file_requests.reserve(thread_count);
-  std::vector<std::future<ParseFileRegionResult>> futures{};
-  std::set<int> column_filter_set;
-  for (const auto& pair : column_id_to_chunk_map) {
-    column_filter_set.insert(pair.first);
-  }
   for (size_t i = 0; i < file_regions.size(); i += batch_size) {
     parse_file_requests.emplace_back(
-        buffer_size, copy_params, db_id_, foreign_table_, column_filter_set);
+        buffer_size, copy_params, db_id_, foreign_table_, column_ids);
     auto start_index = i;
     auto end_index =
         std::min<size_t>(start_index + batch_size - 1, file_regions.size() - 1);
-    futures.emplace_back(std::async(std::launch::async,
-                                    parse_file_regions,
-                                    std::ref(file_regions),
-                                    start_index,
-                                    end_index,
-                                    std::ref((*csv_reader_)),
-                                    std::ref(file_access_mutex_),
-                                    std::ref(parse_file_requests.back()),
-                                    std::ref(column_id_to_chunk_map)));
+    fragment_parse->futures.emplace_back(std::async(std::launch::async,
+                                                    parse_file_regions,
+                                                    std::ref(file_regions),
+                                                    start_index,
+                                                    end_index,
+                                                    std::ref((*csv_reader_)),
+                                                    std::ref(file_access_mutex_),
+                                                    std::ref(parse_file_requests.back()),
+                                                    std::map<int, Chunk_NS::Chunk>{}));
+  }
+  return fragment_parse;
+}
+
+void CsvDataWrapper::populateChunks(
+    std::map<int, Chunk_NS::Chunk>& column_id_to_chunk_map,
+    int fragment_id) {
+  CHECK(!column_id_to_chunk_map.empty());
+  std::set<int> column_filter_set;
+  for (const auto& pair : column_id_to_chunk_map) {
+    column_filter_set.insert(pair.first);
+  }
+
+  std::unique_ptr<FragmentParse> fragment_parse;
+  std::unique_ptr<FragmentParse> stale_prefetched_fragment;
+  {
+    std::lock_guard<std::mutex> prefetch_lock(prefetched_fragment_mutex_);
+    if (prefetched_fragment_ && prefetched_fragment_->fragment_id == fragment_id &&
+        prefetched_fragment_->column_ids == column_filter_set) {
+      fragment_parse = std::move(prefetched_fragment_);
+    } else {
+      fragment_parse = parseFragmentAsync(fragment_id, column_filter_set);
+    }
+    // scans request the fragments in order, so the next one is parsed while this one
+    // is consumed, one fragment ahead at most to bound the memory used
+    const auto next_fragment_id = fragment_id + 1;
+    if ((!prefetched_fragment_ || prefetched_fragment_->fragment_id < fragment_id) &&
+        fragment_id_to_file_regions_map_.find(next_fragment_id) !=
+            fragment_id_to_file_regions_map_.end()) {
+      stale_prefetched_fragment = std::move(prefetched_fragment_);
+      prefetched_fragment_ = parseFragmentAsync(next_fragment_id, column_filter_set);
+    }
   }
 
   std::set<ParseFileRegionResult> load_file_region_results{};
-  for (auto& future : futures) {
+  for (auto& future : fragment_parse->futures) {
     future.wait();
     load_file_region_results.emplace(future.get());
   }
@@ -777,13 +838,23 @@ void dispatch_metadata_scan_requests(
  */
 void CsvDataWrapper::populateChunkMetadata(ChunkMetadataVector& chunk_metadata_vector) {
   auto timer = DEBUG_TIMER(__func__);
+  {
+    // the file regions and the reader of a prefetched fragment are about to change
+    std::lock_guard<std::mutex> prefetch_lock(prefetched_fragment_mutex_);
+    prefetched_fragment_.reset();
+  }
   chunk_metadata_map_.clear();
 
   const auto copy_params = validateAndGetCopyParams();
   const auto file_path = foreign_table_->getFilePath();
   auto catalog = Catalog_Namespace::Catalog::checkedGet(db_id_);
   auto& server_options = foreign_table_->foreign_server->options;
-  if (foreign_table_->isAppendMode() && csv_reader_ != nullptr) {
+  // Without append mode, the files scanned before are only skipped if none of them
+  // changed since, the files added to the directory are then scanned like appended rows
+  is_last_scan_append_only_ =
+      csv_reader_ != nullptr &&
+      (foreign_table_->isAppendMode() || csv_reader_->areScannedFilesUnchanged());
+  if (is_last_scan_append_only_) {
     if (server_options.find(ForeignServer::STORAGE_TYPE_KEY)->second ==
         ForeignServer::LOCAL_FILE_STORAGE_TYPE) {
       csv_reader_->checkForMoreRows(append_start_offset_);
@@ -811,7 +882,7 @@ void CsvDataWrapper::populateChunkMetadata(ChunkMetadataVector& chunk_metadata_v
   MetadataScanMultiThreadingParams multi_threading_params;
 
   // Restore previous chunk data
-  if (foreign_table_->isAppendMode()) {
+  if (is_last_scan_append_only_) {
     multi_threading_params.chunk_byte_count = chunk_byte_count_;
     multi_threading_params.chunk_encoder_buffers = std::move(chunk_encoder_buffers_);
   }
@@ -872,10 +943,8 @@ void CsvDataWrapper::populateChunkMetadata(ChunkMetadataVector& chunk_metadata_v
   }
 
   // Save chunk data
-  if (foreign_table_->isAppendMode()) {
-    chunk_byte_count_ = multi_threading_params.chunk_byte_count;
-    chunk_encoder_buffers_ = std::move(multi_threading_params.chunk_encoder_buffers);
-  }
+  chunk_byte_count_ = multi_threading_params.chunk_byte_count;
+  chunk_encoder_buffers_ = std::move(multi_threading_params.chunk_encoder_buffers);
 
   for (auto& entry : fragment_id_to_file_regions_map_) {
     std::sort(entry.second.begin(), entry.second.end());
@@ -962,18 +1031,17 @@ void CsvDataWrapper::restoreDataWrapperInternals(
   for (auto& pair : chunk_metadata) {
     chunk_metadata_map_[pair.first] = pair.second;
 
-    if (foreign_table_->isAppendMode()) {
-      // Restore encoder state for append mode
-      chunk_encoder_buffers_[pair.first] = std::make_unique<ForeignStorageBuffer>();
-      chunk_encoder_buffers_[pair.first]->initEncoder(pair.second->sqlType);
-      chunk_encoder_buffers_[pair.first]->setSize(pair.second->numBytes);
-      chunk_encoder_buffers_[pair.first]->getEncoder()->setNumElems(
-          pair.second->numElements);
-      chunk_encoder_buffers_[pair.first]->getEncoder()->resetChunkStats(
-          pair.second->chunkStats);
-      chunk_encoder_buffers_[pair.first]->setUpdated();
-      chunk_byte_count_[pair.first] = pair.second->numBytes;
-    }
+    // Restore encoder state for appends, which a refresh without append mode also does
+    // when only new files were added
+    chunk_encoder_buffers_[pair.first] = std::make_unique<ForeignStorageBuffer>();
+    chunk_encoder_buffers_[pair.first]->initEncoder(pair.second->sqlType);
+    chunk_encoder_buffers_[pair.first]->setSize(pair.second->numBytes);
+    chunk_encoder_buffers_[pair.first]->getEncoder()->setNumElems(
+        pair.second->numElements);
+    chunk_encoder_buffers_[pair.first]->getEncoder()->resetChunkStats(
+        pair.second->chunkStats);
+    chunk_encoder_buffers_[pair.first]->setUpdated();
+    chunk_byte_count_[pair.first] = pair.second->numBytes;
   }
   is_restored_ = true;
 }
@@ -982,4 +1050,8 @@ bool CsvDataWrapper::isRestored() const {
   return is_restored_;
 }
 
+bool CsvDataWrapper::isLastScanAppendOnly() const {
+  return is_last_scan_append_only_;
+}
+
 }  // namespace foreign_storage
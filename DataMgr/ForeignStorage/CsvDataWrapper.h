@@ -63,10 +63,14 @@ struct FileRegion {
 
 using FileRegions = std::vector<FileRegion>;
 
+struct FragmentParse;
+
 class CsvDataWrapper : public ForeignDataWrapper {
  public:
   CsvDataWrapper(const int db_id, const ForeignTable* foreign_table);
 
+  ~CsvDataWrapper() override;
+
   void populateChunkMetadata(ChunkMetadataVector& chunk_metadata_vector) override;
 
   void populateChunkBuffers(
@@ -82,6 +86,7 @@ class CsvDataWrapper : public ForeignDataWrapper {
   void restoreDataWrapperInternals(const std::string& file_path,
                                    const ChunkMetadataVector& chunk_metadata) override;
   bool isRestored() const override;
+  bool isLastScanAppendOnly() const override;
 
  private:
   CsvDataWrapper(const ForeignTable* foreign_table);
@@ -96,6 +101,17 @@ class CsvDataWrapper : public ForeignDataWrapper {
   void populateChunks(std::map<int, Chunk_NS::Chunk>& column_id_to_chunk_map,
                       int fragment_id);
 
+  /**
+   * Starts parsing the file regions of a fragment for the given columns on other
+   * threads.
+   *
+   * @param fragment_id - fragment id of the file regions to parse
+   * @param column_ids - ids of the columns to parse
+   * @return the parse in progress, whose results are valid as long as it is alive
+   */
+  std::unique_ptr<FragmentParse> parseFragmentAsync(const int fragment_id,
+                                                    const std::set<int>& column_ids);
+
   std::string getFilePath();
   import_export::CopyParams validateAndGetCopyParams();
   void validateFilePath();
@@ -147,6 +163,12 @@ class CsvDataWrapper : public ForeignDataWrapper {
   size_t append_start_offset_;
   // Is this datawrapper restored from disk
   bool is_restored_;
+  // Did the last metadata scan only read the rows appended since the one before
+  bool is_last_scan_append_only_;
+  std::mutex prefetched_fragment_mutex_;
+  // The fragment after the last one populated, parsed ahead of its request for the
+  // same columns. Declared last, so that the parse ends before the reader goes away.
+  std::unique_ptr<FragmentParse> prefetched_fragment_;
   static constexpr std::array<char const*, 11> supported_options_{"ARRAY_DELIMITER",
                                                                   "ARRAY_MARKER",
                                                                   "BUFFER_SIZE",
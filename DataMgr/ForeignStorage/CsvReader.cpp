@@ -15,6 +15,10 @@
  */
 
 #include "DataMgr/ForeignStorage/CsvReader.h"
+
+#include <algorithm>
+#include <ctime>
+
 #include "ForeignDataWrapperShared.h"
 #include "FsiJsonUtils.h"
 
@@ -485,6 +489,13 @@ MultiFileReader::MultiFileReader(const std::string& file_path,
   json_utils::get_value_from_object(value, cumulative_sizes_, "cumulative_sizes");
   json_utils::get_value_from_object(value, current_offset_, "current_offset");
   json_utils::get_value_from_object(value, current_index_, "current_index");
+  // the metadata of older versions has no file fingerprints, all of their files count as
+  // changed
+  if (value.HasMember("file_sizes")) {
+    json_utils::get_value_from_object(value, file_sizes_, "file_sizes");
+    json_utils::get_value_from_object(
+        value, file_modification_times_, "file_modification_times");
+  }
 
   // Validate files_metadata here, but objects will be recreated by child class
   CHECK(value.HasMember("files_metadata"));
@@ -499,6 +510,9 @@ void MultiFileReader::serialize(rapidjson::Value& value,
       value, cumulative_sizes_, "cumulative_sizes", allocator);
   json_utils::add_value_to_object(value, current_offset_, "current_offset", allocator);
   json_utils::add_value_to_object(value, current_index_, "current_index", allocator);
+  json_utils::add_value_to_object(value, file_sizes_, "file_sizes", allocator);
+  json_utils::add_value_to_object(
+      value, file_modification_times_, "file_modification_times", allocator);
 
   // Serialize metadata from all files
   rapidjson::Value files_metadata(rapidjson::kArrayType);
@@ -597,7 +611,42 @@ void LocalMultiFileReader::insertFile(std::string location) {
     files_.pop_back();
   } else {
     file_locations_.push_back(location);
+    recordFileFingerprint(file_locations_.size() - 1);
+  }
+}
+
+void LocalMultiFileReader::recordFileFingerprint(const size_t index) {
+  CHECK_LT(index, file_locations_.size());
+  file_sizes_.resize(file_locations_.size());
+  file_modification_times_.resize(file_locations_.size());
+  file_sizes_[index] = boost::filesystem::file_size(file_locations_[index]);
+  const auto modification_time =
+      boost::filesystem::last_write_time(file_locations_[index]);
+  // A file modified within the last second can still change without changing its
+  // modification time, it counts as changed until a later scan records it again
+  file_modification_times_[index] = modification_time + 1 < std::time(nullptr)
+                                        ? static_cast<size_t>(modification_time)
+                                        : 0;
+}
+
+bool LocalMultiFileReader::areScannedFilesUnchanged() const {
+  if (file_sizes_.size() != file_locations_.size()) {
+    return false;
+  }
+  for (size_t index = 0; index < file_locations_.size(); index++) {
+    boost::system::error_code ec;
+    const auto file_size = boost::filesystem::file_size(file_locations_[index], ec);
+    if (ec || file_size != file_sizes_[index]) {
+      return false;
+    }
+    const auto modification_time =
+        boost::filesystem::last_write_time(file_locations_[index], ec);
+    if (ec || file_modification_times_[index] == 0 ||
+        static_cast<size_t>(modification_time) != file_modification_times_[index]) {
+      return false;
+    }
   }
+  return true;
 }
 
 void LocalMultiFileReader::checkForMoreRows(size_t file_offset,
@@ -637,6 +686,7 @@ void LocalMultiFileReader::checkForMoreRows(size_t file_offset,
     if (!files_[0].get()->isScanFinished()) {
       current_index_ = 0;
       cumulative_sizes_ = {};
+      recordFileFingerprint(0);
     }
   }
 }
@@ -684,4 +734,10 @@ size_t MultiFileReader::readRegion(void* buffer, size_t offset, size_t size) {
   return bytes_read;
 }
 
+bool MultiFileReader::isConcurrentRegionReadSupported() const {
+  return std::all_of(files_.begin(), files_.end(), [](const auto& file) {
+    return file->isConcurrentRegionReadSupported();
+  });
+}
+
 }  // namespace foreign_storage
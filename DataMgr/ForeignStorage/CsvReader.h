@@ -21,6 +21,7 @@
 
 #include "Archive/PosixFileArchive.h"
 #include "ImportExport/CopyParams.h"
+#include "OSDependent/omnisci_fs.h"
 
 namespace foreign_storage {
 
@@ -63,6 +64,12 @@ class CsvReader {
    */
   virtual size_t readRegion(void* buffer, size_t offset, size_t size) = 0;
 
+  /**
+   * @return true if readRegion can be called by several threads at once, so that the
+   * regions of a file are read in parallel rather than one at a time
+   */
+  virtual bool isConcurrentRegionReadSupported() const { return false; }
+
   /**
    * @return size of the CSV remaining to be read
    * */
@@ -87,6 +94,13 @@ class CsvReader {
     throw std::runtime_error{"APPEND mode not yet supported for this table."};
   }
 
+  /**
+   * @return true if the files read by the scans so far are still the same, going by
+   * their size and modification time, so that a refresh only has to scan the files
+   * added since
+   */
+  virtual bool areScannedFilesUnchanged() const { return false; }
+
   /**
    * Serialize internal state to given json object
    * This Json will later be used to restore the reader state  through a constructor
@@ -129,14 +143,29 @@ class SingleFileReader : public CsvReader {
 
   size_t readRegion(void* buffer, size_t offset, size_t size) override {
     CHECK(isScanFinished());
-    if (fseek(file_, static_cast<long int>(offset + header_offset_), SEEK_SET) != 0) {
-      throw std::runtime_error{"An error occurred when attempting to read offset " +
-                               std::to_string(offset) + " in file: \"" + file_path_ +
-                               "\". " + strerror(errno)};
+    // positional reads leave the position of the stream alone, so regions are read
+    // concurrently
+    size_t bytes_read = 0;
+    while (bytes_read < size) {
+      const auto result = omnisci::pread(fileno(file_),
+                                         static_cast<char*>(buffer) + bytes_read,
+                                         size - bytes_read,
+                                         offset + header_offset_ + bytes_read);
+      if (result < 0) {
+        throw std::runtime_error{"An error occurred when attempting to read offset " +
+                                 std::to_string(offset) + " in file: \"" + file_path_ +
+                                 "\". " + strerror(errno)};
+      }
+      if (result == 0) {
+        break;
+      }
+      bytes_read += result;
     }
-    return fread(buffer, 1, size, file_);
+    return bytes_read;
   }
 
+  bool isConcurrentRegionReadSupported() const override { return true; }
+
   bool isScanFinished() override { return scan_finished_; }
 
   size_t getRemainingSize() override { return data_size_ - total_bytes_read_; }
@@ -304,6 +333,8 @@ class MultiFileReader : public CsvReader {
 
   size_t readRegion(void* buffer, size_t offset, size_t size) override;
 
+  bool isConcurrentRegionReadSupported() const override;
+
   bool isScanFinished() override { return (current_index_ >= files_.size()); }
 
   void serialize(rapidjson::Value& value,
@@ -315,6 +346,9 @@ class MultiFileReader : public CsvReader {
 
   // Size of each file + all previous files
   std::vector<size_t> cumulative_sizes_;
+  // Size and last modification time of each file when it was added to the scan
+  std::vector<size_t> file_sizes_;
+  std::vector<size_t> file_modification_times_;
   // Current file being read
   size_t current_index_;
   // Overall number of bytes read in the directory (minus headers)
@@ -335,8 +369,11 @@ class LocalMultiFileReader : public MultiFileReader {
                         const ForeignServer* server_options,
                         const UserMapping* user_mapping) override;
 
+  bool areScannedFilesUnchanged() const override;
+
  private:
   void insertFile(std::string location);
+  void recordFileFingerprint(const size_t index);
 };
 
 }  // namespace foreign_storage
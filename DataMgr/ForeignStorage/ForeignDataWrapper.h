@@ -64,6 +64,13 @@ class ForeignDataWrapper {
   virtual void restoreDataWrapperInternals(const std::string& file_path,
                                            const ChunkMetadataVector& chunk_metadata) = 0;
 
+  /**
+   * @return true if the last populateChunkMetadata call only scanned data appended after
+   * the data of the previous call, so that the chunks of all fragments but the last one
+   * populated before are unchanged
+   */
+  virtual bool isLastScanAppendOnly() const { return false; }
+
   // For testing, is this data wrapper restored from disk
   virtual bool isRestored() const = 0;
 };
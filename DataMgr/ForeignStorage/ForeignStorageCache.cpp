@@ -52,7 +52,12 @@ void set_metadata_for_buffer(AbstractBuffer* buffer, ChunkMetadata* meta) {
 }  // namespace
 
 ForeignStorageCache::ForeignStorageCache(const DiskCacheConfig& config)
-    : num_chunks_added_(0), num_metadata_added_(0), max_cached_bytes_(config.size_limit) {
+    : num_chunks_added_(0)
+    , num_metadata_added_(0)
+    , num_chunk_hits_(0)
+    , num_chunk_misses_(0)
+    , max_cached_bytes_(config.size_limit)
+    , eviction_policy_(config.eviction_policy) {
   validatePath(config.path);
   global_file_mgr_ = std::make_unique<File_Namespace::GlobalFileMgr>(
       0, config.path, config.num_reader_threads);
@@ -115,9 +120,11 @@ AbstractBuffer* ForeignStorageCache::getCachedChunkIfExists(const ChunkKey& chun
   {
     read_lock lock(chunks_mutex_);
     if (cached_chunks_.find(chunk_key) == cached_chunks_.end()) {
+      num_chunk_misses_++;
       return nullptr;
     }
   }
+  num_chunk_hits_++;
   write_lock lock(chunks_mutex_);
   const auto& eviction_tracker_it = eviction_tracker_map_.find(get_table_key(chunk_key));
   if (eviction_tracker_it != eviction_tracker_map_.end()) {
@@ -389,8 +396,7 @@ std::string ForeignStorageCache::dumpEvictionQueue() const {
   std::string ret;
   for (auto& [key, tracker] : eviction_tracker_map_) {
     auto& [alg, num_pages] = tracker;
-    ret += "queue for table_key: " + show_chunk(key) + "\n" +
-           ((LRUEvictionAlgorithm*)alg.get())->dumpEvictionQueue();
+    ret += "queue for table_key: " + show_chunk(key) + "\n" + alg->dumpEvictionQueue();
   }
 
   return ret;
@@ -451,7 +457,7 @@ bool ForeignStorageCache::insertChunkIntoEvictionAlg(const ChunkKey& chunk_key,
 void ForeignStorageCache::createTrackerMapEntryIfNoneExists(const ChunkKey& table_key) {
   CHECK(is_table_key(table_key));
   if (eviction_tracker_map_.find(table_key) == eviction_tracker_map_.end()) {
-    eviction_tracker_map_.emplace(table_key, TableEvictionTracker{});
+    eviction_tracker_map_.emplace(table_key, TableEvictionTracker{eviction_policy_});
   }
 }
 
@@ -26,9 +26,11 @@
 #pragma once
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include "../Shared/mapd_shared_mutex.h"
 #include "CacheEvictionAlgorithms/CacheEvictionAlgorithm.h"
 #include "CacheEvictionAlgorithms/LRUEvictionAlgorithm.h"
+#include "CacheEvictionAlgorithms/TwoQueueEvictionAlgorithm.h"
 #include "DataMgr/AbstractBufferMgr.h"
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
 #include "ForeignDataWrapper.h"
@@ -39,11 +41,13 @@ class CacheTooSmallException : public std::runtime_error {
 };
 
 enum class DiskCacheLevel { none, fsi, non_fsi, all };
+enum class DiskCacheEvictionPolicy { lru, two_queue };
 struct DiskCacheConfig {
   std::string path;
   DiskCacheLevel enabled_level = DiskCacheLevel::none;
   uint64_t size_limit = 21474836480;  // 20GB default
   size_t num_reader_threads = 0;
+  DiskCacheEvictionPolicy eviction_policy = DiskCacheEvictionPolicy::lru;
   inline bool isEnabledForMutableTables() const {
     return enabled_level == DiskCacheLevel::non_fsi ||
            enabled_level == DiskCacheLevel::all;
@@ -59,9 +63,20 @@ using namespace Data_Namespace;
 namespace foreign_storage {
 
 struct TableEvictionTracker {
-  // We can swap out different eviction algorithms here.
-  std::unique_ptr<CacheEvictionAlgorithm> eviction_alg_ =
-      std::make_unique<LRUEvictionAlgorithm>();
+  TableEvictionTracker(const DiskCacheEvictionPolicy eviction_policy) {
+    // We can swap out different eviction algorithms here.
+    switch (eviction_policy) {
+      case DiskCacheEvictionPolicy::lru:
+        eviction_alg_ = std::make_unique<LRUEvictionAlgorithm>();
+        break;
+      case DiskCacheEvictionPolicy::two_queue:
+        eviction_alg_ = std::make_unique<TwoQueueEvictionAlgorithm>();
+        break;
+    }
+    CHECK(eviction_alg_);
+  }
+
+  std::unique_ptr<CacheEvictionAlgorithm> eviction_alg_;
   size_t num_pages_ = 0;
 };
 
@@ -102,6 +117,9 @@ class ForeignStorageCache {
   inline size_t getNumCachedMetadata() const { return cached_metadata_.size(); }
   size_t getNumChunksAdded() const { return num_chunks_added_; }
   size_t getNumMetadataAdded() const { return num_metadata_added_; }
+  // Lookups of chunks which were found in the cache and of the ones which were not.
+  size_t getNumChunkHits() const { return num_chunk_hits_; }
+  size_t getNumChunkMisses() const { return num_chunk_misses_; }
 
   // Useful for debugging.
   std::string dumpCachedChunkEntries() const;
@@ -141,6 +159,8 @@ class ForeignStorageCache {
   // Keeps tracks of how many times we cache chunks or metadata for testing purposes.
   size_t num_chunks_added_;
   size_t num_metadata_added_;
+  std::atomic<size_t> num_chunk_hits_;
+  std::atomic<size_t> num_chunk_misses_;
 
   // Separate mutexes for chunks/metadata.
   mutable mapd_shared_mutex chunks_mutex_;
@@ -148,5 +168,7 @@ class ForeignStorageCache {
 
   // Maximum number of chunk bytes that can be in the cache before eviction.
   uint64_t max_cached_bytes_;
+
+  const DiskCacheEvictionPolicy eviction_policy_;
 };  // ForeignStorageCache
 }  // namespace foreign_storage
@@ -34,6 +34,14 @@ void ForeignStorageBuffer::read(int8_t* const dst,
   persistent_foreign_storage_->read(chunk_key_, sql_type_, dst, numBytes);
 }
 
+bool ForeignStorageBuffer::tryZeroCopy(const size_t numBytes) {
+  if (!zero_copy_ptr_) {
+    zero_copy_ptr_ =
+        persistent_foreign_storage_->getZeroCopyPtr(chunk_key_, sql_type_, numBytes);
+  }
+  return zero_copy_ptr_ != nullptr;
+}
+
 void ForeignStorageBuffer::append(int8_t* src,
                                   const size_t numBytes,
                                   const Data_Namespace::MemoryLevel srcBufferType,
@@ -19,6 +19,7 @@
 #include "../AbstractBufferMgr.h"
 #include "Catalog/Catalog.h"
 
+#include <atomic>
 #include <unordered_map>
 
 struct ForeignStorageColumnBuffer {
@@ -36,6 +37,13 @@ class PersistentForeignStorageInterface {
                     const SQLTypeInfo& sql_type,
                     int8_t* dest,
                     const size_t num_bytes) = 0;
+  // Returns the address of the chunk in the memory of the storage if it has the layout of
+  // a chunk buffer there and stays alive as long as the table, nullptr otherwise.
+  virtual int8_t* getZeroCopyPtr(const ChunkKey& /*chunk_key*/,
+                                 const SQLTypeInfo& /*sql_type*/,
+                                 const size_t /*num_bytes*/) {
+    return nullptr;
+  }
   virtual void prepareTable(const int /*db_id*/,
                             const std::string& type,
                             TableDescriptor& /*td*/,
@@ -81,9 +89,13 @@ class ForeignStorageBuffer : public Data_Namespace::AbstractBuffer {
 
   void reserve(size_t numBytes) override { CHECK(false); }
 
+  // Points the buffer at the chunk in the memory of the foreign storage, if possible, so
+  // that it can be used as a CPU buffer without reading the chunk into another one.
+  bool tryZeroCopy(const size_t numBytes);
+
   int8_t* getMemoryPtr() override {
-    CHECK(false);
-    return nullptr;
+    CHECK(zero_copy_ptr_);
+    return zero_copy_ptr_;
   }
 
   size_t pageCount() const override {
@@ -105,6 +117,7 @@ class ForeignStorageBuffer : public Data_Namespace::AbstractBuffer {
   const ChunkKey chunk_key_;
   PersistentForeignStorageInterface* persistent_foreign_storage_;
   std::vector<int8_t> buff_;
+  std::atomic<int8_t*> zero_copy_ptr_{nullptr};
 };
 
 class ForeignStorageBufferMgr : public Data_Namespace::AbstractBufferMgr {
@@ -722,6 +722,31 @@ void resize_values_buffer(const ColumnDescriptor* omnisci_column,
   values.resize(values_size);
 }
 
+/**
+ * Gets the number of values of a column chunk that holds nulls only, per the statistics
+ * of its row group, so that the nulls can be appended without reading its pages. Returns
+ * 0 for any other column chunk, including the ones of nested (array) columns whose
+ * levels can not be inferred from the statistics.
+ */
+int64_t get_all_nulls_column_chunk_size(
+    const parquet::RowGroupMetaData* group_metadata,
+    const int parquet_column_index,
+    const parquet::ColumnDescriptor* parquet_column_descriptor) {
+  if (parquet_column_descriptor->max_repetition_level() > 0 ||
+      parquet_column_descriptor->max_definition_level() == 0) {
+    return 0;
+  }
+  auto column_metadata = group_metadata->ColumnChunk(parquet_column_index);
+  if (!column_metadata->is_stats_set()) {
+    return 0;
+  }
+  auto stats = column_metadata->statistics();
+  if (!stats || stats->null_count() != column_metadata->num_values()) {
+    return 0;
+  }
+  return column_metadata->num_values();
+}
+
 std::list<std::unique_ptr<ChunkMetadata>> append_row_groups(
     const std::vector<RowGroupInterval>& row_group_intervals,
     const int parquet_column_index,
@@ -776,6 +801,27 @@ std::list<std::unique_ptr<ChunkMetadata>> append_row_groups(
          row_group_index <= row_group_interval.end_index;
          ++row_group_index) {
       auto group_reader = parquet_reader->RowGroup(row_group_index);
+      if (auto num_nulls =
+              get_all_nulls_column_chunk_size(group_reader->metadata(),
+                                              parquet_column_index,
+                                              parquet_column_descriptor)) {
+        // the definition levels of nulls are below the maximum, no values are read
+        std::fill(def_levels.begin(), def_levels.end(), 0);
+        std::fill(rep_levels.begin(), rep_levels.end(), 0);
+        while (num_nulls > 0) {
+          const int64_t levels_read = std::min(
+              num_nulls,
+              static_cast<int64_t>(LazyParquetChunkLoader::batch_reader_num_elements));
+          num_nulls -= levels_read;
+          encoder->appendData(def_levels.data(),
+                              rep_levels.data(),
+                              0,
+                              levels_read,
+                              num_nulls == 0,
+                              values.data());
+        }
+        continue;
+      }
       std::shared_ptr<parquet::ColumnReader> col_reader =
           group_reader->Column(parquet_column_index);
 
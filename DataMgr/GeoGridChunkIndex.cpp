@@ -0,0 +1,164 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/GeoGridChunkIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include "Logger/Logger.h"
+#include "Shared/sqltypes.h"
+
+bool g_enable_geo_grid_indexes{false};
+
+namespace {
+
+// Rows per cell the grid is sized for, if the boxes were spread evenly.
+constexpr size_t kRowsPerCell{4};
+constexpr size_t kMaxCellsPerSide{256};
+// Boxes covering more cells are tested on every lookup instead.
+constexpr size_t kMaxCellsPerRow{16};
+
+bool is_null_box(const GeoGridChunkIndex::Box& box) {
+  return box[0] == NULL_ARRAY_DOUBLE ||
+         !std::all_of(box.begin(), box.end(), [](const double coord) {
+           return std::isfinite(coord);
+         }) ||
+         box[0] > box[2] || box[1] > box[3];
+}
+
+}  // namespace
+
+GeoGridChunkIndex::GeoGridChunkIndex(const int8_t* data, const size_t row_count) {
+  CHECK_LE(row_count, size_t(std::numeric_limits<uint32_t>::max()));
+  boxes_.resize(row_count);
+  if (row_count) {
+    std::memcpy(boxes_.data(), data, row_count * sizeof(Box));
+  }
+  extent_ = {std::numeric_limits<double>::max(),
+             std::numeric_limits<double>::max(),
+             std::numeric_limits<double>::lowest(),
+             std::numeric_limits<double>::lowest()};
+  size_t non_null_count{0};
+  for (auto& box : boxes_) {
+    if (is_null_box(box)) {
+      // an empty box, which intersects nothing
+      box = {1., 1., 0., 0.};
+      continue;
+    }
+    extent_[0] = std::min(extent_[0], box[0]);
+    extent_[1] = std::min(extent_[1], box[1]);
+    extent_[2] = std::max(extent_[2], box[2]);
+    extent_[3] = std::max(extent_[3], box[3]);
+    ++non_null_count;
+  }
+  if (!non_null_count) {
+    return;
+  }
+  cells_per_side_ = std::clamp(
+      static_cast<size_t>(std::ceil(std::sqrt(double(non_null_count) / kRowsPerCell))),
+      size_t(1),
+      kMaxCellsPerSide);
+  // The rows of each cell are counted first, then listed in row order.
+  std::vector<uint32_t> cell_counts(cells_per_side_ * cells_per_side_ + 1, 0);
+  auto for_each_cell = [this](const Box& box, auto&& func) {
+    const auto [x_first, x_last] = getCellRange(box[0], box[2], 0);
+    const auto [y_first, y_last] = getCellRange(box[1], box[3], 1);
+    for (auto y = y_first; y <= y_last; ++y) {
+      for (auto x = x_first; x <= x_last; ++x) {
+        func(y * cells_per_side_ + x);
+      }
+    }
+  };
+  auto is_large = [this](const Box& box) {
+    const auto [x_first, x_last] = getCellRange(box[0], box[2], 0);
+    const auto [y_first, y_last] = getCellRange(box[1], box[3], 1);
+    return (x_last - x_first + 1) * (y_last - y_first + 1) > kMaxCellsPerRow;
+  };
+  for (uint32_t row = 0; row < boxes_.size(); ++row) {
+    const auto& box = boxes_[row];
+    if (box[0] > box[2]) {
+      continue;
+    }
+    if (is_large(box)) {
+      large_rows_.push_back(row);
+      continue;
+    }
+    for_each_cell(box, [&cell_counts](const size_t cell) { ++cell_counts[cell + 1]; });
+  }
+  cell_offsets_.resize(cell_counts.size());
+  std::partial_sum(cell_counts.begin(), cell_counts.end(), cell_offsets_.begin());
+  cell_rows_.resize(cell_offsets_.back());
+  std::vector<uint32_t> cell_ends(cell_offsets_.begin(), cell_offsets_.end() - 1);
+  for (uint32_t row = 0; row < boxes_.size(); ++row) {
+    const auto& box = boxes_[row];
+    if (box[0] > box[2] || is_large(box)) {
+      continue;
+    }
+    for_each_cell(box, [this, &cell_ends, row](const size_t cell) {
+      cell_rows_[cell_ends[cell]++] = row;
+    });
+  }
+}
+
+std::pair<size_t, size_t> GeoGridChunkIndex::getRowRange(const Box& probe) const {
+  size_t min_row{std::numeric_limits<size_t>::max()};
+  size_t max_row{0};
+  auto add_row = [this, &probe, &min_row, &max_row](const uint32_t row) {
+    if (intersects(boxes_[row], probe)) {
+      min_row = std::min(min_row, size_t(row));
+      max_row = std::max(max_row, size_t(row));
+    }
+  };
+  if (cells_per_side_ && intersects(extent_, probe)) {
+    for (const auto row : large_rows_) {
+      add_row(row);
+    }
+    const auto [x_first, x_last] = getCellRange(probe[0], probe[2], 0);
+    const auto [y_first, y_last] = getCellRange(probe[1], probe[3], 1);
+    for (auto y = y_first; y <= y_last; ++y) {
+      for (auto x = x_first; x <= x_last; ++x) {
+        const auto cell = y * cells_per_side_ + x;
+        for (auto i = cell_offsets_[cell]; i < cell_offsets_[cell + 1]; ++i) {
+          add_row(cell_rows_[i]);
+        }
+      }
+    }
+  }
+  if (min_row > max_row) {
+    return {0, 0};
+  }
+  return {min_row, max_row + 1};
+}
+
+std::pair<size_t, size_t> GeoGridChunkIndex::getCellRange(const double lo,
+                                                          const double hi,
+                                                          const size_t axis) const {
+  CHECK_GT(cells_per_side_, size_t(0));
+  const auto extent_lo = extent_[axis];
+  const auto extent_size = extent_[axis + 2] - extent_lo;
+  auto get_cell = [this, extent_lo, extent_size](const double coord) -> size_t {
+    if (extent_size <= 0. || coord <= extent_lo) {
+      return 0;
+    }
+    const auto cell = (coord - extent_lo) / extent_size * cells_per_side_;
+    return cell >= cells_per_side_ ? cells_per_side_ - 1 : static_cast<size_t>(cell);
+  };
+  return {get_cell(lo), get_cell(hi)};
+}
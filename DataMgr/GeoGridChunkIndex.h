@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    GeoGridChunkIndex.h
+ * @brief   Uniform grid over the bounding boxes of a chunk of geo bounds.
+ *
+ * Built from the bounds column of a polygon or multipolygon column the first time a
+ * query filters a fragment with ST_Contains or ST_Intersects against a constant
+ * geometry, and kept with the chunk metadata until the chunk changes. The grid covers
+ * the extent of the boxes of the chunk, each cell lists the rows whose box overlaps it.
+ * A lookup visits the cells a probe box overlaps and tests the boxes of their rows, which
+ * gives the smallest range of rows the exact predicate has to be evaluated on.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+extern bool g_enable_geo_grid_indexes;
+
+class GeoGridChunkIndex {
+ public:
+  // xmin, ymin, xmax, ymax, as stored in the bounds columns
+  using Box = std::array<double, 4>;
+
+  // Indexes the first `row_count` boxes of a bounds chunk stored at `data`.
+  GeoGridChunkIndex(const int8_t* data, const size_t row_count);
+
+  // The smallest [begin, end) range of rows whose box intersects `probe`, an empty range
+  // if there is none. Rows with null bounds never match.
+  std::pair<size_t, size_t> getRowRange(const Box& probe) const;
+
+  size_t rowCount() const { return boxes_.size(); }
+
+  size_t cellsPerSide() const { return cells_per_side_; }
+
+ private:
+  static bool intersects(const Box& a, const Box& b) {
+    return a[0] <= b[2] && b[0] <= a[2] && a[1] <= b[3] && b[1] <= a[3];
+  }
+
+  // The [first, last] cells a coordinate range covers along an axis, clamped to the grid.
+  std::pair<size_t, size_t> getCellRange(const double lo,
+                                         const double hi,
+                                         const size_t axis) const;
+
+  std::vector<Box> boxes_;
+  // the union of the boxes of the rows which aren't null
+  Box extent_;
+  size_t cells_per_side_{0};
+  // rows of each cell, cell_offsets_[cell] to cell_offsets_[cell + 1] in cell_rows_
+  std::vector<uint32_t> cell_offsets_;
+  std::vector<uint32_t> cell_rows_;
+  // rows whose box covers too many cells to be listed in all of them, tested on every
+  // lookup
+  std::vector<uint32_t> large_rows_;
+};
@@ -0,0 +1,240 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IntegerCodecs.h"
+
+#include "Logger/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+namespace integer_codecs {
+
+namespace {
+
+int32_t bits_for(const uint64_t max_code) {
+  int32_t bit_width{0};
+  for (auto code = max_code; code; code >>= 1) {
+    ++bit_width;
+  }
+  return bit_width;
+}
+
+size_t packed_words(const size_t count, const int32_t bit_width) {
+  return (count * bit_width + 63) / 64;
+}
+
+uint64_t zig_zag(const uint64_t delta) {
+  const auto signed_delta = static_cast<int64_t>(delta);
+  return (delta << 1) ^ static_cast<uint64_t>(signed_delta >> 63);
+}
+
+// The range of the non-null values, as {base, range, has null}.
+std::tuple<int64_t, uint64_t, bool> value_range(const std::vector<int64_t>& values,
+                                                const int64_t null_val) {
+  auto min = std::numeric_limits<int64_t>::max();
+  auto max = std::numeric_limits<int64_t>::min();
+  bool has_null{false};
+  for (const auto val : values) {
+    if (val == null_val) {
+      has_null = true;
+      continue;
+    }
+    min = std::min(min, val);
+    max = std::max(max, val);
+  }
+  if (min > max) {
+    return {0, 0, has_null};
+  }
+  return {min, static_cast<uint64_t>(max) - static_cast<uint64_t>(min), has_null};
+}
+
+int32_t frame_of_reference_bit_width(const uint64_t range, const bool has_null) {
+  // the null code is the largest one, past the codes of the values
+  return bits_for(range + (has_null ? 1 : 0));
+}
+
+int32_t delta_bit_width(const std::vector<int64_t>& values) {
+  uint64_t max_code{0};
+  for (size_t i = 1; i < values.size(); ++i) {
+    if (i % kDeltaBlockSize) {
+      const auto delta =
+          static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(values[i - 1]);
+      max_code = std::max(max_code, zig_zag(delta));
+    }
+  }
+  return bits_for(max_code);
+}
+
+size_t run_count(const std::vector<int64_t>& values) {
+  size_t runs{0};
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i == 0 || values[i] != values[i - 1]) {
+      ++runs;
+    }
+  }
+  return runs;
+}
+
+template <class T>
+void write_at(std::vector<int8_t>& stream, const size_t offset, const T val) {
+  CHECK_LE(offset + sizeof(T), stream.size());
+  std::memcpy(&stream[offset], &val, sizeof(T));
+}
+
+void write_header(std::vector<int8_t>& stream,
+                  const int64_t first,
+                  const int32_t second,
+                  const int32_t third) {
+  write_at(stream, 0, first);
+  write_at(stream, sizeof(int64_t), second);
+  write_at(stream, sizeof(int64_t) + sizeof(int32_t), third);
+}
+
+void pack(std::vector<int8_t>& stream,
+          const size_t offset,
+          const std::vector<uint64_t>& codes,
+          const int32_t bit_width) {
+  if (!bit_width) {
+    return;
+  }
+  std::vector<uint64_t> words(packed_words(codes.size(), bit_width), 0);
+  for (size_t i = 0; i < codes.size(); ++i) {
+    const auto bit_pos = i * bit_width;
+    const auto word = bit_pos / 64;
+    const auto shift = bit_pos % 64;
+    words[word] |= codes[i] << shift;
+    if (shift + bit_width > 64) {
+      words[word + 1] |= codes[i] >> (64 - shift);
+    }
+  }
+  CHECK_LE(offset + words.size() * sizeof(uint64_t), stream.size());
+  std::memcpy(&stream[offset], words.data(), words.size() * sizeof(uint64_t));
+}
+
+}  // namespace
+
+std::vector<int8_t> encode_frame_of_reference(const std::vector<int64_t>& values,
+                                              const int64_t null_val) {
+  const auto [base, range, has_null] = value_range(values, null_val);
+  const auto bit_width = frame_of_reference_bit_width(range, has_null);
+  const auto null_code =
+      bit_width == 64 ? std::numeric_limits<uint64_t>::max()
+                      : (uint64_t(1) << bit_width) - 1;
+  std::vector<uint64_t> codes;
+  codes.reserve(values.size());
+  for (const auto val : values) {
+    codes.push_back(val == null_val
+                        ? null_code
+                        : static_cast<uint64_t>(val) - static_cast<uint64_t>(base));
+  }
+  std::vector<int8_t> stream(
+      encoded_size(IntegerCodec::FrameOfReference, values, null_val), 0);
+  write_header(stream, base, bit_width, has_null ? 1 : 0);
+  pack(stream, kHeaderSize, codes, bit_width);
+  return stream;
+}
+
+std::vector<int8_t> encode_delta(const std::vector<int64_t>& values) {
+  const auto bit_width = delta_bit_width(values);
+  const auto block_count = (values.size() + kDeltaBlockSize - 1) / kDeltaBlockSize;
+  std::vector<uint64_t> codes;
+  codes.reserve(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    codes.push_back(i % kDeltaBlockSize ? zig_zag(static_cast<uint64_t>(values[i]) -
+                                                  static_cast<uint64_t>(values[i - 1]))
+                                        : 0);
+  }
+  std::vector<int8_t> stream(encoded_size(IntegerCodec::Delta, values, 0), 0);
+  write_header(stream, values.size(), bit_width, 0);
+  for (size_t i = 0; i < block_count; ++i) {
+    write_at(stream, kHeaderSize + i * sizeof(int64_t), values[i * kDeltaBlockSize]);
+  }
+  pack(stream, kHeaderSize + block_count * sizeof(int64_t), codes, bit_width);
+  return stream;
+}
+
+std::vector<int8_t> encode_run_length(const std::vector<int64_t>& values) {
+  CHECK_LE(values.size(), size_t(std::numeric_limits<uint32_t>::max()));
+  const auto runs = run_count(values);
+  std::vector<int8_t> stream(encoded_size(IntegerCodec::RunLength, values, 0), 0);
+  write_header(stream, runs, 0, 0);
+  const auto ends_offset = kHeaderSize + runs * sizeof(int64_t);
+  size_t run{0};
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i + 1 == values.size() || values[i + 1] != values[i]) {
+      write_at(stream, kHeaderSize + run * sizeof(int64_t), values[i]);
+      write_at(
+          stream, ends_offset + run * sizeof(uint32_t), static_cast<uint32_t>(i + 1));
+      ++run;
+    }
+  }
+  CHECK_EQ(runs, run);
+  return stream;
+}
+
+std::vector<int8_t> encode(const IntegerCodec codec,
+                           const std::vector<int64_t>& values,
+                           const int64_t null_val) {
+  switch (codec) {
+    case IntegerCodec::FrameOfReference:
+      return encode_frame_of_reference(values, null_val);
+    case IntegerCodec::Delta:
+      return encode_delta(values);
+    case IntegerCodec::RunLength:
+      return encode_run_length(values);
+  }
+  UNREACHABLE();
+  return {};
+}
+
+IntegerCodec choose_codec(const std::vector<int64_t>& values, const int64_t null_val) {
+  auto best = IntegerCodec::FrameOfReference;
+  for (const auto codec : {IntegerCodec::Delta, IntegerCodec::RunLength}) {
+    if (encoded_size(codec, values, null_val) < encoded_size(best, values, null_val)) {
+      best = codec;
+    }
+  }
+  return best;
+}
+
+size_t encoded_size(const IntegerCodec codec,
+                    const std::vector<int64_t>& values,
+                    const int64_t null_val) {
+  switch (codec) {
+    case IntegerCodec::FrameOfReference: {
+      const auto [base, range, has_null] = value_range(values, null_val);
+      const auto bit_width = frame_of_reference_bit_width(range, has_null);
+      return kHeaderSize + packed_words(values.size(), bit_width) * sizeof(uint64_t);
+    }
+    case IntegerCodec::Delta: {
+      const auto block_count = (values.size() + kDeltaBlockSize - 1) / kDeltaBlockSize;
+      return kHeaderSize + block_count * sizeof(int64_t) +
+             packed_words(values.size(), delta_bit_width(values)) * sizeof(uint64_t);
+    }
+    case IntegerCodec::RunLength: {
+      const auto runs = run_count(values);
+      const auto ends_size = (runs * sizeof(uint32_t) + 7) / 8 * 8;
+      return kHeaderSize + runs * sizeof(int64_t) + ends_size;
+    }
+  }
+  UNREACHABLE();
+  return 0;
+}
+
+}  // namespace integer_codecs
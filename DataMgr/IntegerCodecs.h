@@ -0,0 +1,72 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    IntegerCodecs.h
+ * @brief   Lightweight compression of the integer values of a chunk.
+ *
+ * Unlike the fixed length encodings, which only narrow every value to the same smaller
+ * width, these look at the values themselves: frame of reference bit-packs the offsets
+ * from the chunk minimum, delta bit-packs the differences between consecutive values
+ * and run-length stores every run of equal values once. The encoded stream is self
+ * describing, the *_int_decode runtime functions in QueryEngine/DecodersImpl.h decode
+ * any position of it in-register, on CPU and GPU.
+ *
+ * All streams start with a 16 bytes header and are made of 8 bytes words:
+ *
+ *   frame of reference: int64 base, int32 bit width, int32 has null, then the packed
+ *                       codes; value = base + code, all one bits is the null code
+ *   delta:              int64 value count, int32 bit width, int32 unused, then one int64
+ *                       anchor per block of kDeltaBlockSize values, then the packed
+ *                       zig-zag deltas; the first delta of a block is always 0
+ *   run-length:         int64 run count, int64 unused, then the int64 value of every
+ *                       run, then the uint32 exclusive end position of every run
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace integer_codecs {
+
+enum class IntegerCodec { FrameOfReference, Delta, RunLength };
+
+constexpr size_t kHeaderSize{16};
+constexpr size_t kDeltaBlockSize{64};
+
+// `null_val` is the inline null sentinel of the column, stored in the null code by
+// frame of reference and as a regular value by the other codecs.
+std::vector<int8_t> encode_frame_of_reference(const std::vector<int64_t>& values,
+                                              const int64_t null_val);
+
+std::vector<int8_t> encode_delta(const std::vector<int64_t>& values);
+
+std::vector<int8_t> encode_run_length(const std::vector<int64_t>& values);
+
+std::vector<int8_t> encode(const IntegerCodec codec,
+                           const std::vector<int64_t>& values,
+                           const int64_t null_val);
+
+// The codec with the smallest encoded size for `values`, computed without encoding.
+IntegerCodec choose_codec(const std::vector<int64_t>& values, const int64_t null_val);
+
+size_t encoded_size(const IntegerCodec codec,
+                    const std::vector<int64_t>& values,
+                    const int64_t null_val);
+
+}  // namespace integer_codecs
@@ -18,6 +18,7 @@
 #define NONE_ENCODER_H
 
 #include "AbstractBuffer.h"
+#include "ChunkStatsKernels.h"
 #include "Encoder.h"
 
 #include <Shared/DatumFetchers.h>
@@ -39,7 +40,9 @@ class NoneEncoder : public Encoder {
       : Encoder(buffer)
       , dataMin(std::numeric_limits<T>::max())
       , dataMax(std::numeric_limits<T>::lowest())
-      , has_nulls(false) {}
+      , has_nulls(false) {
+    initBloomFilter();
+  }
 
   std::shared_ptr<ChunkMetadata> appendData(int8_t*& src_data,
                                             const size_t num_elems_to_append,
@@ -51,12 +54,16 @@ class NoneEncoder : public Encoder {
     if (replicating) {
       encoded_data.resize(num_elems_to_append);
     }
-    for (size_t i = 0; i < num_elems_to_append; ++i) {
-      size_t ri = replicating ? 0 : i;
-      T data = validateDataAndUpdateStats(unencodedData[ri]);
-      if (replicating) {
+    detachBloomFilter();
+    if (replicating) {
+      for (size_t i = 0; i < num_elems_to_append; ++i) {
+        T data = validateDataAndUpdateStats(unencodedData[0]);
+        addToBloomFilter(static_cast<int64_t>(data));
         encoded_data[i] = data;
       }
+    } else {
+      validateBlockAndUpdateStats(unencodedData, num_elems_to_append);
+      addToBloomFilter(unencodedData, num_elems_to_append);
     }
     if (offset == -1) {
       num_elems_ += num_elems_to_append;
@@ -68,6 +75,7 @@ class NoneEncoder : public Encoder {
       }
     } else {
       num_elems_ = offset + num_elems_to_append;
+      invalidateBloomFilter();
       CHECK(!replicating);
       CHECK_GE(offset, 0);
       buffer_->write(
@@ -92,6 +100,7 @@ class NoneEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const int64_t val, const bool is_null) override {
+    invalidateBloomFilter();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -103,6 +112,7 @@ class NoneEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const double val, const bool is_null) override {
+    invalidateBloomFilter();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -113,14 +123,13 @@ class NoneEncoder : public Encoder {
   }
 
   void updateStats(const int8_t* const src_data, const size_t num_elements) override {
-    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
-    for (size_t i = 0; i < num_elements; ++i) {
-      validateDataAndUpdateStats(unencoded_data[i]);
-    }
+    invalidateBloomFilter();
+    validateBlockAndUpdateStats(reinterpret_cast<const T*>(src_data), num_elements);
   }
 
   void updateStatsEncoded(const int8_t* const dst_data,
                           const size_t num_elements) override {
+    invalidateBloomFilter();
     const T* data = reinterpret_cast<const T*>(dst_data);
 
     std::tie(dataMin, dataMax, has_nulls) = tbb::parallel_reduce(
@@ -162,6 +171,7 @@ class NoneEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void reduceStats(const Encoder& that) override {
+    invalidateBloomFilter();
     const auto that_typed = static_cast<const NoneEncoder&>(that);
     if (that_typed.has_nulls) {
       has_nulls = true;
@@ -184,6 +194,7 @@ class NoneEncoder : public Encoder {
     fread((int8_t*)&dataMin, sizeof(T), 1, f);
     fread((int8_t*)&dataMax, sizeof(T), 1, f);
     fread((int8_t*)&has_nulls, sizeof(bool), 1, f);
+    invalidateBloomFilter();
   }
 
   bool resetChunkStats(const ChunkStats& stats) override {
@@ -197,6 +208,7 @@ class NoneEncoder : public Encoder {
     dataMin = new_min;
     dataMax = new_max;
     has_nulls = stats.has_nulls;
+    invalidateBloomFilter();
     return true;
   }
 
@@ -206,6 +218,7 @@ class NoneEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    bloom_filter_ = castedEncoder->bloom_filter_;
   }
 
   T dataMin;
@@ -223,6 +236,21 @@ class NoneEncoder : public Encoder {
     }
     return unencoded_data;
   }
+
+  void validateBlockAndUpdateStats(const T* unencoded_data, const size_t num_elems) {
+    const auto block_stats = chunk_stats::compute_block_stats(
+        unencoded_data, num_elems, none_encoded_null_value<T>());
+    if (block_stats.has_nulls) {
+      has_nulls = true;
+    }
+    if (block_stats.hasValues()) {
+      // the check is a range check, the extremes of the block fail it if any value does
+      decimal_overflow_validator_.validate(block_stats.min);
+      decimal_overflow_validator_.validate(block_stats.max);
+      dataMin = std::min(dataMin, block_stats.min);
+      dataMax = std::max(dataMax, block_stats.max);
+    }
+  }
 };  // class NoneEncoder
 
 #endif  // NONE_ENCODER_H
@@ -0,0 +1,394 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/PersistentStorageMgr/ColdStorage.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "Logger/Logger.h"
+#include "OSDependent/omnisci_fs.h"
+#include "Shared/scope.h"
+
+#define COLD_STORAGE_INDEX_FILENAME "cold_storage_index"
+#define COLD_STORAGE_INDEX_VERSION 1
+
+std::string g_cold_storage_url;
+
+namespace Data_Namespace {
+
+namespace {
+
+constexpr size_t kNumTypeFields{8};
+
+bool starts_with_prefix(const ChunkKey& chunk_key, const ChunkKey& key_prefix) {
+  return chunk_key.size() >= key_prefix.size() &&
+         std::equal(key_prefix.begin(), key_prefix.end(), chunk_key.begin());
+}
+
+template <typename T>
+void read_values(FILE* f, T* values, const size_t count, const std::string& path) {
+  if (fread(reinterpret_cast<int8_t*>(values), sizeof(T), count, f) != count) {
+    throw std::runtime_error("Could not read the cold storage index '" + path + "'");
+  }
+}
+
+template <typename T>
+void write_values(FILE* f, const T* values, const size_t count) {
+  CHECK_EQ(fwrite(reinterpret_cast<const int8_t*>(values), sizeof(T), count, f), count);
+}
+
+void sync_to_disk(FILE* f, const std::string& path) {
+  if (fflush(f) != 0 || omnisci::fsync(fileno(f)) != 0) {
+    LOG(FATAL) << "Could not sync file '" << path
+               << "' to disk, the error was: " << std::strerror(errno);
+  }
+}
+
+// Keeps the objects as the files of a local or mounted directory.
+class PosixColdObjectStore : public ColdObjectStore {
+ public:
+  PosixColdObjectStore(const std::string& path) : path_(path) {
+    boost::filesystem::create_directories(path_);
+    if (!boost::filesystem::is_directory(path_)) {
+      throw std::runtime_error("Cold storage path '" + path_ + "' is not a directory.");
+    }
+  }
+
+  void putObject(const std::string& name,
+                 const int8_t* data,
+                 const size_t num_bytes) override {
+    const auto object_path = getObjectPath(name);
+    const auto temp_path = object_path + ".tmp";
+    auto f = fopen(temp_path.c_str(), "wb");
+    if (!f) {
+      throw std::runtime_error("Could not create cold storage object '" + temp_path +
+                               "': " + std::strerror(errno));
+    }
+    write_values(f, data, num_bytes);
+    sync_to_disk(f, temp_path);
+    fclose(f);
+    boost::filesystem::rename(temp_path, object_path);
+  }
+
+  void getObject(const std::string& name,
+                 int8_t* data,
+                 const size_t num_bytes) override {
+    const auto object_path = getObjectPath(name);
+    std::ifstream object_file(object_path, std::ios::binary);
+    object_file.read(reinterpret_cast<char*>(data), num_bytes);
+    if (!object_file || static_cast<size_t>(object_file.gcount()) != num_bytes) {
+      throw std::runtime_error("Could not read " + std::to_string(num_bytes) +
+                               " bytes of cold storage object '" + object_path + "'");
+    }
+  }
+
+  void deleteObject(const std::string& name) override {
+    boost::system::error_code ec;
+    boost::filesystem::remove(getObjectPath(name), ec);
+    if (ec) {
+      LOG(WARNING) << "Could not delete cold storage object " << name << ": "
+                   << ec.message();
+    }
+  }
+
+ private:
+  std::string getObjectPath(const std::string& name) const {
+    return path_ + "/" + name;
+  }
+
+  const std::string path_;
+};
+
+std::map<std::string, ColdObjectStoreFactory>& get_cold_object_store_factories() {
+  static std::map<std::string, ColdObjectStoreFactory> factories;
+  return factories;
+}
+
+std::mutex cold_object_store_factories_mutex;
+
+}  // namespace
+
+bool register_cold_object_store(const std::string& scheme,
+                                ColdObjectStoreFactory factory) {
+  std::lock_guard<std::mutex> lock(cold_object_store_factories_mutex);
+  return get_cold_object_store_factories().emplace(scheme, std::move(factory)).second;
+}
+
+std::unique_ptr<ColdObjectStore> create_cold_object_store(const std::string& url) {
+  const auto scheme_end = url.find("://");
+  if (scheme_end == std::string::npos) {
+    return std::make_unique<PosixColdObjectStore>(url);
+  }
+  const auto scheme = url.substr(0, scheme_end);
+  if (scheme == "file") {
+    return std::make_unique<PosixColdObjectStore>(url.substr(scheme_end + 3));
+  }
+  std::lock_guard<std::mutex> lock(cold_object_store_factories_mutex);
+  const auto& factories = get_cold_object_store_factories();
+  const auto factory_it = factories.find(scheme);
+  if (factory_it == factories.end()) {
+    throw std::runtime_error("Cold storage url '" + url +
+                             "' has an unsupported scheme " + scheme + ".");
+  }
+  return factory_it->second(url);
+}
+
+ColdStorage::ColdStorage(const std::string& data_dir, const std::string& url)
+    : index_path_(data_dir + "/" + COLD_STORAGE_INDEX_FILENAME)
+    , object_store_(create_cold_object_store(url)) {
+  readIndex();
+  LOG(INFO) << "Cold storage at " << url << " holds " << chunks_.size() << " chunks";
+}
+
+void ColdStorage::uploadChunk(const ChunkKey& chunk_key,
+                              AbstractBuffer* buffer,
+                              const size_t page_size) {
+  CHECK(!buffer->isDirty());
+  object_store_->putObject(
+      getObjectName(chunk_key), buffer->getMemoryPtr(), buffer->size());
+  ColdChunk cold_chunk{page_size,
+                       std::make_unique<foreign_storage::ForeignStorageBuffer>()};
+  cold_chunk.metadata_buffer->syncEncoder(buffer);
+  cold_chunk.metadata_buffer->setSize(buffer->size());
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  CHECK(!chunks_.count(chunk_key));
+  uploaded_chunks_[chunk_key] = std::move(cold_chunk);
+}
+
+void ColdStorage::commitUploadedChunks() {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  if (uploaded_chunks_.empty()) {
+    return;
+  }
+  chunks_.merge(uploaded_chunks_);
+  CHECK(uploaded_chunks_.empty());
+  writeIndex();
+}
+
+void ColdStorage::discardUploadedChunks() {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  uploaded_chunks_.clear();
+}
+
+bool ColdStorage::hasChunk(const ChunkKey& chunk_key) const {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  return chunks_.count(chunk_key);
+}
+
+size_t ColdStorage::getPageSize(const ChunkKey& chunk_key) const {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  const auto chunk_it = chunks_.find(chunk_key);
+  CHECK(chunk_it != chunks_.end()) << show_chunk(chunk_key);
+  return chunk_it->second.page_size;
+}
+
+void ColdStorage::fetchChunk(const ChunkKey& chunk_key,
+                             AbstractBuffer* destination_buffer,
+                             const size_t num_bytes) {
+  size_t chunk_size;
+  {
+    std::lock_guard<std::mutex> lock(chunks_mutex_);
+    const auto chunk_it = chunks_.find(chunk_key);
+    CHECK(chunk_it != chunks_.end()) << show_chunk(chunk_key);
+    chunk_size = num_bytes ? num_bytes : chunk_it->second.metadata_buffer->size();
+    CHECK_LE(chunk_size, chunk_it->second.metadata_buffer->size());
+  }
+  destination_buffer->reserve(chunk_size);
+  if (chunk_size) {
+    object_store_->getObject(
+        getObjectName(chunk_key), destination_buffer->getMemoryPtr(), chunk_size);
+  }
+  destination_buffer->setSize(chunk_size);
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  const auto chunk_it = chunks_.find(chunk_key);
+  CHECK(chunk_it != chunks_.end()) << show_chunk(chunk_key);
+  destination_buffer->syncEncoder(chunk_it->second.metadata_buffer.get());
+}
+
+void ColdStorage::getChunkMetadataVecForKeyPrefix(ChunkMetadataVector& chunk_metadata_vec,
+                                                  const ChunkKey& key_prefix) const {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  for (auto chunk_it = chunks_.lower_bound(key_prefix);
+       chunk_it != chunks_.end() && starts_with_prefix(chunk_it->first, key_prefix);
+       ++chunk_it) {
+    const auto& metadata_buffer = chunk_it->second.metadata_buffer;
+    if (metadata_buffer->hasEncoder()) {
+      auto chunk_metadata = std::make_shared<ChunkMetadata>();
+      metadata_buffer->getEncoder()->getMetadata(chunk_metadata);
+      chunk_metadata_vec.emplace_back(chunk_it->first, chunk_metadata);
+    }
+  }
+}
+
+std::vector<ChunkKey> ColdStorage::getChunkKeysWithPrefix(
+    const ChunkKey& key_prefix) const {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  std::vector<ChunkKey> chunk_keys;
+  for (auto chunk_it = chunks_.lower_bound(key_prefix);
+       chunk_it != chunks_.end() && starts_with_prefix(chunk_it->first, key_prefix);
+       ++chunk_it) {
+    chunk_keys.push_back(chunk_it->first);
+  }
+  return chunk_keys;
+}
+
+void ColdStorage::removeChunks(const std::vector<ChunkKey>& chunk_keys) {
+  std::vector<ChunkKey> removed_keys;
+  {
+    std::lock_guard<std::mutex> lock(chunks_mutex_);
+    for (const auto& chunk_key : chunk_keys) {
+      local_chunks_.erase(chunk_key);
+      if (chunks_.erase(chunk_key)) {
+        removed_keys.push_back(chunk_key);
+      }
+    }
+    if (removed_keys.empty()) {
+      return;
+    }
+    writeIndex();
+  }
+  // an object left behind by a crash here is overwritten if its chunk is offloaded again
+  for (const auto& chunk_key : removed_keys) {
+    object_store_->deleteObject(getObjectName(chunk_key));
+  }
+}
+
+void ColdStorage::setLocal(const ChunkKey& chunk_key) {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  if (chunks_.count(chunk_key)) {
+    local_chunks_.insert(chunk_key);
+  }
+}
+
+std::vector<ChunkKey> ColdStorage::takeLocalChunks(const ChunkKey& key_prefix) {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  std::vector<ChunkKey> chunk_keys;
+  for (auto chunk_it = local_chunks_.lower_bound(key_prefix);
+       chunk_it != local_chunks_.end() && starts_with_prefix(*chunk_it, key_prefix);) {
+    chunk_keys.push_back(*chunk_it);
+    chunk_it = local_chunks_.erase(chunk_it);
+  }
+  return chunk_keys;
+}
+
+size_t ColdStorage::getNumChunks() const {
+  std::lock_guard<std::mutex> lock(chunks_mutex_);
+  return chunks_.size();
+}
+
+std::string ColdStorage::getObjectName(const ChunkKey& chunk_key) {
+  std::string name;
+  for (const auto key_part : chunk_key) {
+    name += (name.empty() ? "" : "_") + std::to_string(key_part);
+  }
+  return name;
+}
+
+// The index holds, for each chunk, its key, page size and size, then its type and the
+// metadata of its encoder as the FileBuffer metadata pages do.
+void ColdStorage::readIndex() {
+  if (!boost::filesystem::exists(index_path_)) {
+    return;
+  }
+  auto f = fopen(index_path_.c_str(), "rb");
+  if (!f) {
+    throw std::runtime_error("Could not open the cold storage index '" + index_path_ +
+                             "': " + std::strerror(errno));
+  }
+  ScopeGuard close_index = [f] { fclose(f); };
+  int version;
+  read_values(f, &version, 1, index_path_);
+  if (version != COLD_STORAGE_INDEX_VERSION) {
+    throw std::runtime_error("Unsupported version " + std::to_string(version) +
+                             " of the cold storage index '" + index_path_ + "'");
+  }
+  size_t num_chunks;
+  read_values(f, &num_chunks, 1, index_path_);
+  for (size_t i = 0; i < num_chunks; ++i) {
+    size_t key_size;
+    read_values(f, &key_size, 1, index_path_);
+    ChunkKey chunk_key(key_size);
+    read_values(f, chunk_key.data(), key_size, index_path_);
+    size_t sizes[2];
+    read_values(f, sizes, 2, index_path_);
+    int has_encoder;
+    read_values(f, &has_encoder, 1, index_path_);
+    ColdChunk cold_chunk{sizes[0],
+                         std::make_unique<foreign_storage::ForeignStorageBuffer>()};
+    if (has_encoder) {
+      int type_data[kNumTypeFields];
+      read_values(f, type_data, kNumTypeFields, index_path_);
+      SQLTypeInfo sql_type;
+      sql_type.set_type(static_cast<SQLTypes>(type_data[0]));
+      sql_type.set_subtype(static_cast<SQLTypes>(type_data[1]));
+      sql_type.set_dimension(type_data[2]);
+      sql_type.set_scale(type_data[3]);
+      sql_type.set_notnull(static_cast<bool>(type_data[4]));
+      sql_type.set_compression(static_cast<EncodingType>(type_data[5]));
+      sql_type.set_comp_param(type_data[6]);
+      sql_type.set_size(type_data[7]);
+      cold_chunk.metadata_buffer->initEncoder(sql_type);
+      cold_chunk.metadata_buffer->getEncoder()->readMetadata(f);
+    }
+    cold_chunk.metadata_buffer->setSize(sizes[1]);
+    chunks_[chunk_key] = std::move(cold_chunk);
+  }
+}
+
+void ColdStorage::writeIndex() const {
+  const auto temp_path = index_path_ + ".tmp";
+  auto f = fopen(temp_path.c_str(), "wb");
+  if (!f) {
+    throw std::runtime_error("Could not create the cold storage index '" + temp_path +
+                             "': " + std::strerror(errno));
+  }
+  const int version{COLD_STORAGE_INDEX_VERSION};
+  write_values(f, &version, 1);
+  const size_t num_chunks = chunks_.size();
+  write_values(f, &num_chunks, 1);
+  for (const auto& [chunk_key, cold_chunk] : chunks_) {
+    const size_t key_size = chunk_key.size();
+    write_values(f, &key_size, 1);
+    write_values(f, chunk_key.data(), key_size);
+    const auto& metadata_buffer = cold_chunk.metadata_buffer;
+    const size_t sizes[2]{cold_chunk.page_size, metadata_buffer->size()};
+    write_values(f, sizes, 2);
+    const int has_encoder = metadata_buffer->hasEncoder();
+    write_values(f, &has_encoder, 1);
+    if (has_encoder) {
+      const auto sql_type = metadata_buffer->getSqlType();
+      const int type_data[kNumTypeFields]{static_cast<int>(sql_type.get_type()),
+                                          static_cast<int>(sql_type.get_subtype()),
+                                          sql_type.get_dimension(),
+                                          sql_type.get_scale(),
+                                          static_cast<int>(sql_type.get_notnull()),
+                                          static_cast<int>(sql_type.get_compression()),
+                                          sql_type.get_comp_param(),
+                                          sql_type.get_size()};
+      write_values(f, type_data, kNumTypeFields);
+      metadata_buffer->getEncoder()->writeMetadata(f);
+    }
+  }
+  sync_to_disk(f, temp_path);
+  fclose(f);
+  boost::filesystem::rename(temp_path, index_path_);
+}
+
+}  // namespace Data_Namespace
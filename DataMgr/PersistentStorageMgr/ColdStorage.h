@@ -0,0 +1,121 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ColdStorage.h
+ * @brief   Tier of the persistent storage keeping chunks in an object store.
+ *
+ * The chunks of old fragments are offloaded to an object store, S3 or a directory,
+ * while only their metadata stays local, in an index in the data directory. A cold
+ * chunk is read-only: the PersistentStorageMgr reads it on demand, through the disk
+ * cache when there is one, and restores it to the local files before it is written.
+ *
+ * A chunk which is both local and cold, once restored or after a crash in the middle of
+ * an offload, is read from the local files, its cold copy is dropped at the next
+ * checkpoint of its table.
+ */
+
+#pragma once
+
+#include "DataMgr/ChunkMetadata.h"
+#include "DataMgr/ForeignStorage/ForeignStorageBuffer.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+extern std::string g_cold_storage_url;
+
+namespace Data_Namespace {
+
+class ColdObjectStore {
+ public:
+  virtual ~ColdObjectStore() = default;
+
+  virtual void putObject(const std::string& name,
+                         const int8_t* data,
+                         const size_t num_bytes) = 0;
+  // Reads the first `num_bytes` of the object.
+  virtual void getObject(const std::string& name,
+                         int8_t* data,
+                         const size_t num_bytes) = 0;
+  virtual void deleteObject(const std::string& name) = 0;
+};
+
+using ColdObjectStoreFactory =
+    std::function<std::unique_ptr<ColdObjectStore>(const std::string& url)>;
+
+// Registers the object store of the urls with the scheme, e.g. s3 for s3://bucket/path.
+// The urls without a scheme or with file:// are directories.
+bool register_cold_object_store(const std::string& scheme,
+                                ColdObjectStoreFactory factory);
+
+std::unique_ptr<ColdObjectStore> create_cold_object_store(const std::string& url);
+
+class ColdStorage {
+ public:
+  ColdStorage(const std::string& data_dir, const std::string& url);
+
+  // Uploads the chunk to the object store, it is added to the index by
+  // commitUploadedChunks().
+  void uploadChunk(const ChunkKey& chunk_key,
+                   AbstractBuffer* buffer,
+                   const size_t page_size);
+  void commitUploadedChunks();
+  void discardUploadedChunks();
+
+  bool hasChunk(const ChunkKey& chunk_key) const;
+  size_t getPageSize(const ChunkKey& chunk_key) const;
+  void fetchChunk(const ChunkKey& chunk_key,
+                  AbstractBuffer* destination_buffer,
+                  const size_t num_bytes);
+  void getChunkMetadataVecForKeyPrefix(ChunkMetadataVector& chunk_metadata_vec,
+                                       const ChunkKey& key_prefix) const;
+  std::vector<ChunkKey> getChunkKeysWithPrefix(const ChunkKey& key_prefix) const;
+  // Drops the chunks from the index, then deletes their objects.
+  void removeChunks(const std::vector<ChunkKey>& chunk_keys);
+
+  // Records that the chunk has a local copy too, the chunks with the prefix recorded
+  // since the last call are returned by takeLocalChunks().
+  void setLocal(const ChunkKey& chunk_key);
+  std::vector<ChunkKey> takeLocalChunks(const ChunkKey& key_prefix);
+
+  size_t getNumChunks() const;
+
+ private:
+  struct ColdChunk {
+    size_t page_size;
+    // holds the size, the type and the encoder metadata of the chunk, without its data
+    std::unique_ptr<foreign_storage::ForeignStorageBuffer> metadata_buffer;
+  };
+
+  static std::string getObjectName(const ChunkKey& chunk_key);
+  void readIndex();
+  void writeIndex() const;
+
+  std::string index_path_;
+  std::unique_ptr<ColdObjectStore> object_store_;
+
+  mutable std::mutex chunks_mutex_;
+  std::map<ChunkKey, ColdChunk> chunks_;
+  std::map<ChunkKey, ColdChunk> uploaded_chunks_;
+  std::set<ChunkKey> local_chunks_;
+};
+
+}  // namespace Data_Namespace
@@ -79,6 +79,7 @@ void MutableCachePersistentStorageMgr::checkpoint() {
     }
   }
   PersistentStorageMgr::global_file_mgr_->checkpoint();
+  removeRestoredColdChunks({});
 }
 
 void MutableCachePersistentStorageMgr::checkpoint(const int db_id, const int tb_id) {
@@ -95,6 +96,7 @@ void MutableCachePersistentStorageMgr::checkpoint(const int db_id, const int tb_
     }
   }
   PersistentStorageMgr::global_file_mgr_->checkpoint(db_id, tb_id);
+  removeRestoredColdChunks(chunk_prefix);
 }
 
 void MutableCachePersistentStorageMgr::removeTableRelatedDS(const int db_id,
@@ -108,3 +110,9 @@ void MutableCachePersistentStorageMgr::removeTableRelatedDS(const int db_id,
     chunk_it = cached_buffer_map_.erase(chunk_it);
   }
 }
+
+void MutableCachePersistentStorageMgr::deleteOffloadedBuffer(const ChunkKey& chunk_key) {
+  // the cached copy of the chunk stays valid, it is read-only while cold
+  cached_buffer_map_.erase(chunk_key);
+  PersistentStorageMgr::deleteOffloadedBuffer(chunk_key);
+}
@@ -39,6 +39,9 @@ class MutableCachePersistentStorageMgr : public PersistentStorageMgr {
   void checkpoint(const int db_id, const int tb_id) override;
   void removeTableRelatedDS(const int db_id, const int table_id) override;
 
+ protected:
+  void deleteOffloadedBuffer(const ChunkKey& chunk_key) override;
+
  private:
   std::map<const ChunkKey, AbstractBuffer*> cached_buffer_map_;
 };
@@ -20,6 +20,9 @@
 #include "DataMgr/ForeignStorage/ForeignStorageInterface.h"
 #include "MutableCachePersistentStorageMgr.h"
 
+#include <algorithm>
+#include <set>
+
 PersistentStorageMgr* PersistentStorageMgr::createPersistentStorageMgr(
     const std::string& data_dir,
     const size_t num_reader_threads,
@@ -48,6 +51,9 @@ PersistentStorageMgr::PersistentStorageMgr(const std::string& data_dir,
       disk_cache_config_.isEnabledForFSI()
           ? std::make_unique<foreign_storage::CachingForeignStorageMgr>(disk_cache_.get())
           : std::make_unique<foreign_storage::ForeignStorageMgr>();
+  if (!g_cold_storage_url.empty()) {
+    cold_storage_ = std::make_unique<ColdStorage>(data_dir, g_cold_storage_url);
+  }
 }
 
 AbstractBuffer* PersistentStorageMgr::createBuffer(const ChunkKey& chunk_key,
@@ -58,23 +64,53 @@ AbstractBuffer* PersistentStorageMgr::createBuffer(const ChunkKey& chunk_key,
 }
 
 void PersistentStorageMgr::deleteBuffer(const ChunkKey& chunk_key, const bool purge) {
+  if (cold_storage_) {
+    mapd_unique_lock<mapd_shared_mutex> cold_chunks_lock(cold_chunks_mutex_);
+    if (cold_storage_->hasChunk(chunk_key)) {
+      const auto is_local = global_file_mgr_->isBufferOnDevice(chunk_key);
+      cold_storage_->removeChunks({chunk_key});
+      if (disk_cache_) {
+        disk_cache_->deleteBufferIfExists(chunk_key);
+      }
+      if (!is_local) {
+        return;
+      }
+    }
+  }
   getStorageMgrForTableKey(chunk_key)->deleteBuffer(chunk_key, purge);
 }
 
 void PersistentStorageMgr::deleteBuffersWithPrefix(const ChunkKey& chunk_key_prefix,
                                                    const bool purge) {
+  removeColdChunksWithPrefix(chunk_key_prefix);
   getStorageMgrForTableKey(chunk_key_prefix)
       ->deleteBuffersWithPrefix(chunk_key_prefix, purge);
 }
 
 AbstractBuffer* PersistentStorageMgr::getBuffer(const ChunkKey& chunk_key,
                                                 const size_t num_bytes) {
+  restoreIfColdChunk(chunk_key);
   return getStorageMgrForTableKey(chunk_key)->getBuffer(chunk_key, num_bytes);
 }
 
 void PersistentStorageMgr::fetchBuffer(const ChunkKey& chunk_key,
                                        AbstractBuffer* destination_buffer,
                                        const size_t num_bytes) {
+  if (cold_storage_) {
+    mapd_shared_lock<mapd_shared_mutex> cold_chunks_lock(cold_chunks_mutex_);
+    if (isColdChunk(chunk_key)) {
+      fetchColdBuffer(chunk_key, destination_buffer, num_bytes);
+    } else {
+      fetchPersistedBuffer(chunk_key, destination_buffer, num_bytes);
+    }
+    return;
+  }
+  fetchPersistedBuffer(chunk_key, destination_buffer, num_bytes);
+}
+
+void PersistentStorageMgr::fetchPersistedBuffer(const ChunkKey& chunk_key,
+                                                AbstractBuffer* destination_buffer,
+                                                const size_t num_bytes) {
   AbstractBufferMgr* mgr = getStorageMgrForTableKey(chunk_key);
   if (isChunkPrefixCacheable(chunk_key)) {
     AbstractBuffer* buffer = disk_cache_->getCachedChunkIfExists(chunk_key);
@@ -97,6 +133,10 @@ void PersistentStorageMgr::fetchBuffer(const ChunkKey& chunk_key,
 AbstractBuffer* PersistentStorageMgr::putBuffer(const ChunkKey& chunk_key,
                                                 AbstractBuffer* source_buffer,
                                                 const size_t num_bytes) {
+  if (auto buffer = restoreIfColdChunk(chunk_key)) {
+    // the restored chunk is overwritten or appended to as if it had been checkpointed
+    buffer->clearDirtyBits();
+  }
   return getStorageMgrForTableKey(chunk_key)->putBuffer(
       chunk_key, source_buffer, num_bytes);
 }
@@ -104,6 +144,37 @@ AbstractBuffer* PersistentStorageMgr::putBuffer(const ChunkKey& chunk_key,
 void PersistentStorageMgr::getChunkMetadataVecForKeyPrefix(
     ChunkMetadataVector& chunk_metadata,
     const ChunkKey& keyPrefix) {
+  const auto first_local = chunk_metadata.size();
+  getPersistedChunkMetadataVecForKeyPrefix(chunk_metadata, keyPrefix);
+  if (!cold_storage_ || isForeignStorage(keyPrefix)) {
+    return;
+  }
+  ChunkMetadataVector cold_chunk_metadata;
+  {
+    mapd_shared_lock<mapd_shared_mutex> cold_chunks_lock(cold_chunks_mutex_);
+    cold_storage_->getChunkMetadataVecForKeyPrefix(cold_chunk_metadata, keyPrefix);
+  }
+  if (cold_chunk_metadata.empty()) {
+    return;
+  }
+  // the local copy of a chunk takes precedence
+  std::set<ChunkKey> local_keys;
+  for (size_t i = first_local; i < chunk_metadata.size(); ++i) {
+    local_keys.insert(chunk_metadata[i].first);
+  }
+  for (auto& [chunk_key, metadata] : cold_chunk_metadata) {
+    if (!local_keys.count(chunk_key)) {
+      chunk_metadata.emplace_back(chunk_key, std::move(metadata));
+    }
+  }
+  std::sort(chunk_metadata.begin() + first_local,
+            chunk_metadata.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+}
+
+void PersistentStorageMgr::getPersistedChunkMetadataVecForKeyPrefix(
+    ChunkMetadataVector& chunk_metadata,
+    const ChunkKey& keyPrefix) {
   CHECK(has_table_prefix(keyPrefix));
   // If the disk has any cached metadata for a prefix then it is guaranteed to have all
   // metadata for that table, so we can return a complete set.  If it has no metadata,
@@ -157,10 +228,12 @@ bool PersistentStorageMgr::isAllocationCapped() {
 
 void PersistentStorageMgr::checkpoint() {
   global_file_mgr_->checkpoint();
+  removeRestoredColdChunks({});
 }
 
 void PersistentStorageMgr::checkpoint(const int db_id, const int tb_id) {
   global_file_mgr_->checkpoint(db_id, tb_id);
+  removeRestoredColdChunks({db_id, tb_id});
 }
 
 AbstractBuffer* PersistentStorageMgr::alloc(const size_t num_bytes) {
@@ -192,6 +265,7 @@ void PersistentStorageMgr::removeTableRelatedDS(const int db_id, const int table
   if (isChunkPrefixCacheable(table_key)) {
     disk_cache_->clearForTablePrefix(table_key);
   }
+  removeColdChunksWithPrefix(table_key);
   getStorageMgrForTableKey(table_key)->removeTableRelatedDS(db_id, table_id);
 }
 
@@ -234,3 +308,129 @@ bool PersistentStorageMgr::isChunkPrefixCacheable(const ChunkKey& chunk_prefix)
            !isForeignStorage(chunk_prefix)) ||
           (disk_cache_config_.isEnabledForFSI() && isForeignStorage(chunk_prefix)));
 }
+
+ColdStorage* PersistentStorageMgr::getColdStorage() const {
+  return cold_storage_.get();
+}
+
+size_t PersistentStorageMgr::offloadChunks(const std::vector<ChunkKey>& chunk_keys) {
+  CHECK(cold_storage_);
+  std::vector<ChunkKey> uploaded_keys;
+  try {
+    for (const auto& chunk_key : chunk_keys) {
+      CHECK(!isForeignStorage(chunk_key));
+      // a chunk restored since it was offloaded keeps its cold copy until the checkpoint
+      if (cold_storage_->hasChunk(chunk_key) ||
+          !global_file_mgr_->isBufferOnDevice(chunk_key)) {
+        continue;
+      }
+      const auto file_buffer = global_file_mgr_->getBuffer(chunk_key);
+      if (file_buffer->isDirty() || !file_buffer->size()) {
+        continue;
+      }
+      foreign_storage::ForeignStorageBuffer buffer;
+      global_file_mgr_->fetchBuffer(chunk_key, &buffer, 0);
+      cold_storage_->uploadChunk(chunk_key, &buffer, file_buffer->pageSize());
+      uploaded_keys.push_back(chunk_key);
+    }
+  } catch (...) {
+    cold_storage_->discardUploadedChunks();
+    throw;
+  }
+  if (uploaded_keys.empty()) {
+    return 0;
+  }
+  mapd_unique_lock<mapd_shared_mutex> cold_chunks_lock(cold_chunks_mutex_);
+  cold_storage_->commitUploadedChunks();
+  for (const auto& chunk_key : uploaded_keys) {
+    deleteOffloadedBuffer(chunk_key);
+  }
+  return uploaded_keys.size();
+}
+
+bool PersistentStorageMgr::isColdChunk(const ChunkKey& chunk_key) const {
+  if (!cold_storage_->hasChunk(chunk_key)) {
+    return false;
+  }
+  if (global_file_mgr_->isBufferOnDevice(chunk_key)) {
+    // left behind by a crash in the middle of an offload or a restore
+    cold_storage_->setLocal(chunk_key);
+    return false;
+  }
+  return true;
+}
+
+void PersistentStorageMgr::fetchColdBuffer(const ChunkKey& chunk_key,
+                                           AbstractBuffer* destination_buffer,
+                                           const size_t num_bytes) {
+  if (!disk_cache_) {
+    cold_storage_->fetchChunk(chunk_key, destination_buffer, num_bytes);
+    return;
+  }
+  auto cached_buffer = disk_cache_->getCachedChunkIfExists(chunk_key);
+  if (cached_buffer) {
+    cached_buffer->copyTo(destination_buffer, num_bytes);
+    return;
+  }
+  // the whole chunk is cached, even when only its first bytes are read
+  foreign_storage::ForeignStorageBuffer buffer;
+  cold_storage_->fetchChunk(chunk_key, &buffer, 0);
+  disk_cache_->cacheChunk(chunk_key, &buffer);
+  buffer.copyTo(destination_buffer, num_bytes);
+}
+
+AbstractBuffer* PersistentStorageMgr::restoreIfColdChunk(const ChunkKey& chunk_key) {
+  if (!cold_storage_) {
+    return nullptr;
+  }
+  mapd_unique_lock<mapd_shared_mutex> cold_chunks_lock(cold_chunks_mutex_);
+  if (!isColdChunk(chunk_key)) {
+    return nullptr;
+  }
+  foreign_storage::ForeignStorageBuffer buffer;
+  cold_storage_->fetchChunk(chunk_key, &buffer, 0);
+  const auto chunk = global_file_mgr_->createBuffer(
+      chunk_key, cold_storage_->getPageSize(chunk_key), 0);
+  buffer.setAppended();
+  global_file_mgr_->putBuffer(chunk_key, &buffer, 0);
+  cold_storage_->setLocal(chunk_key);
+  if (disk_cache_) {
+    // the local copy is not read-only
+    disk_cache_->deleteBufferIfExists(chunk_key);
+  }
+  VLOG(1) << "Restored cold chunk " << show_chunk(chunk_key);
+  return chunk;
+}
+
+void PersistentStorageMgr::removeColdChunksWithPrefix(const ChunkKey& chunk_key_prefix) {
+  if (!cold_storage_) {
+    return;
+  }
+  mapd_unique_lock<mapd_shared_mutex> cold_chunks_lock(cold_chunks_mutex_);
+  const auto chunk_keys = cold_storage_->getChunkKeysWithPrefix(chunk_key_prefix);
+  cold_storage_->removeChunks(chunk_keys);
+  if (disk_cache_) {
+    for (const auto& chunk_key : chunk_keys) {
+      disk_cache_->deleteBufferIfExists(chunk_key);
+    }
+  }
+}
+
+void PersistentStorageMgr::removeRestoredColdChunks(const ChunkKey& chunk_key_prefix) {
+  if (!cold_storage_) {
+    return;
+  }
+  mapd_unique_lock<mapd_shared_mutex> cold_chunks_lock(cold_chunks_mutex_);
+  std::vector<ChunkKey> restored_keys;
+  for (const auto& chunk_key : cold_storage_->takeLocalChunks(chunk_key_prefix)) {
+    // a rollback since the restore may have dropped the local copy
+    if (global_file_mgr_->isBufferOnDevice(chunk_key)) {
+      restored_keys.push_back(chunk_key);
+    }
+  }
+  cold_storage_->removeChunks(restored_keys);
+}
+
+void PersistentStorageMgr::deleteOffloadedBuffer(const ChunkKey& chunk_key) {
+  global_file_mgr_->deleteBuffer(chunk_key, true);
+}
@@ -20,6 +20,8 @@
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
 #include "DataMgr/ForeignStorage/ForeignStorageCache.h"
 #include "DataMgr/ForeignStorage/ForeignStorageMgr.h"
+#include "DataMgr/PersistentStorageMgr/ColdStorage.h"
+#include "Shared/mapd_shared_mutex.h"
 
 using namespace Data_Namespace;
 
@@ -69,15 +71,40 @@ class PersistentStorageMgr : public AbstractBufferMgr {
   foreign_storage::ForeignStorageMgr* getForeignStorageMgr() const;
   foreign_storage::ForeignStorageCache* getDiskCache() const;
   inline const DiskCacheConfig getDiskCacheConfig() const { return disk_cache_config_; }
+  ColdStorage* getColdStorage() const;
+
+  // Moves the local chunks to the cold storage and deletes their local buffers, which
+  // the next checkpoint of their table makes durable. Returns how many were moved.
+  size_t offloadChunks(const std::vector<ChunkKey>& chunk_keys);
 
  protected:
   bool isForeignStorage(const ChunkKey& chunk_key) const;
   AbstractBufferMgr* getStorageMgrForTableKey(const ChunkKey& table_key) const;
   bool isChunkPrefixCacheable(const ChunkKey& chunk_prefix) const;
   int recoverDataWrapperIfCachedAndGetHighestFragId(const ChunkKey& table_key);
+  void fetchPersistedBuffer(const ChunkKey& chunk_key,
+                            AbstractBuffer* destination_buffer,
+                            const size_t num_bytes);
+  void getPersistedChunkMetadataVecForKeyPrefix(ChunkMetadataVector& chunk_metadata,
+                                                const ChunkKey& chunk_key_prefix);
+
+  // The cold storage methods below are called with cold_chunks_mutex_ held.
+  bool isColdChunk(const ChunkKey& chunk_key) const;
+  void fetchColdBuffer(const ChunkKey& chunk_key,
+                       AbstractBuffer* destination_buffer,
+                       const size_t num_bytes);
+  // Copies the chunk back to the local files if it is cold, returns the local buffer.
+  AbstractBuffer* restoreIfColdChunk(const ChunkKey& chunk_key);
+  void removeColdChunksWithPrefix(const ChunkKey& chunk_key_prefix);
+  // Drops the cold copies of the chunks with the prefix which were restored, once they
+  // are checkpointed.
+  void removeRestoredColdChunks(const ChunkKey& chunk_key_prefix);
+  virtual void deleteOffloadedBuffer(const ChunkKey& chunk_key);
 
   std::unique_ptr<File_Namespace::GlobalFileMgr> global_file_mgr_;
   std::unique_ptr<foreign_storage::ForeignStorageMgr> foreign_storage_mgr_;
   std::unique_ptr<foreign_storage::ForeignStorageCache> disk_cache_;
   DiskCacheConfig disk_cache_config_;
+  std::unique_ptr<ColdStorage> cold_storage_;
+  mutable mapd_shared_mutex cold_chunks_mutex_;
 };
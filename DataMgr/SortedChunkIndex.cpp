@@ -0,0 +1,93 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/SortedChunkIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "Logger/Logger.h"
+#include "Shared/sqltypes.h"
+
+bool g_enable_sorted_chunk_indexes{false};
+
+namespace {
+
+template <class T>
+void read_values(std::vector<std::pair<int64_t, uint32_t>>& entries,
+                 const int8_t* data,
+                 const size_t row_count) {
+  const auto values = reinterpret_cast<const T*>(data);
+  for (size_t row = 0; row < row_count; ++row) {
+    entries.emplace_back(values[row], row);
+  }
+}
+
+}  // namespace
+
+SortedChunkIndex::SortedChunkIndex(const int8_t* data,
+                                   const size_t row_count,
+                                   const SQLTypeInfo& ti) {
+  CHECK(canIndex(ti));
+  CHECK_LE(row_count, size_t(std::numeric_limits<uint32_t>::max()));
+  std::vector<std::pair<int64_t, uint32_t>> entries;
+  entries.reserve(row_count);
+  // the ids of small dictionaries are stored unsigned
+  const bool is_unsigned = ti.is_dict_encoded_string();
+  switch (ti.get_size()) {
+    case 1:
+      is_unsigned ? read_values<uint8_t>(entries, data, row_count)
+                  : read_values<int8_t>(entries, data, row_count);
+      break;
+    case 2:
+      is_unsigned ? read_values<uint16_t>(entries, data, row_count)
+                  : read_values<int16_t>(entries, data, row_count);
+      break;
+    case 4:
+      read_values<int32_t>(entries, data, row_count);
+      break;
+    case 8:
+      read_values<int64_t>(entries, data, row_count);
+      break;
+    default:
+      CHECK(false);
+  }
+  std::sort(entries.begin(), entries.end());
+  values_.reserve(row_count);
+  rows_.reserve(row_count);
+  for (const auto& entry : entries) {
+    values_.push_back(entry.first);
+    rows_.push_back(entry.second);
+  }
+}
+
+std::pair<size_t, size_t> SortedChunkIndex::getRowRange(const int64_t lo,
+                                                        const int64_t hi) const {
+  const auto begin = std::lower_bound(values_.begin(), values_.end(), lo);
+  const auto end = std::upper_bound(begin, values_.end(), hi);
+  if (begin >= end) {
+    return {0, 0};
+  }
+  const auto [min_row, max_row] = std::minmax_element(
+      rows_.begin() + (begin - values_.begin()), rows_.begin() + (end - values_.begin()));
+  return {*min_row, *max_row + 1};
+}
+
+bool SortedChunkIndex::canIndex(const SQLTypeInfo& ti) {
+  // dates in days are compared with constants in seconds
+  return ti.is_integer() || (ti.is_time() && !ti.is_date_in_days()) ||
+         ti.is_dict_encoded_string();
+}
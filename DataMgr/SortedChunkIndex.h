@@ -0,0 +1,56 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    SortedChunkIndex.h
+ * @brief   Rows of a chunk of fixed width integers sorted by value.
+ *
+ * Built from the stored values of an integer, time or dictionary encoded string chunk
+ * the first time a query filters on it, and kept with the chunk metadata until the
+ * chunk changes. A lookup gives the smallest range of rows holding every value of an
+ * equality or range filter, which bounds the rows a CPU kernel has to scan.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+extern bool g_enable_sorted_chunk_indexes;
+
+class SQLTypeInfo;
+
+class SortedChunkIndex {
+ public:
+  // Indexes the first `row_count` values stored at `data` for a chunk of type `ti`.
+  SortedChunkIndex(const int8_t* data, const size_t row_count, const SQLTypeInfo& ti);
+
+  // The smallest [begin, end) range of rows holding every stored value within
+  // [lo, hi], an empty range if there is none.
+  std::pair<size_t, size_t> getRowRange(const int64_t lo, const int64_t hi) const;
+
+  size_t rowCount() const { return rows_.size(); }
+
+  // Whether the stored values of a chunk of this type can be indexed.
+  static bool canIndex(const SQLTypeInfo& ti);
+
+ private:
+  std::vector<int64_t> values_;
+  // the row of each value
+  std::vector<uint32_t> rows_;
+};
@@ -18,8 +18,11 @@
 #include <boost/filesystem.hpp>
 #include <boost/variant.hpp>
 #include <iostream>
+#include <mutex>
 #include "Catalog/Catalog.h"
 #include "Logger/Logger.h"
+#include "Parser/ParserWrapper.h"
+#include "QueryEngine/ArrowResultSet.h"
 #include "QueryEngine/CompilationOptions.h"
 #include "QueryEngine/ResultSet.h"
 #include "QueryRunner/QueryRunner.h"
@@ -35,8 +38,13 @@ enum class ColumnType : uint32_t { Unknown, Integer, Double, Float, String, Arra
 class CursorImpl : public Cursor {
  public:
   CursorImpl(std::shared_ptr<ResultSet> result_set,
-             std::shared_ptr<Data_Namespace::DataMgr> data_mgr)
-      : result_set_(result_set), data_mgr_(data_mgr) {}
+             std::shared_ptr<Data_Namespace::DataMgr> data_mgr,
+             const std::vector<std::string>& col_names)
+      : result_set_(result_set), data_mgr_(data_mgr), col_names_(col_names) {
+    if (result_set_ && col_names_.size() != result_set_->colCount()) {
+      col_names_.clear();
+    }
+  }
 
   size_t getColCount() { return result_set_->colCount(); }
 
@@ -80,9 +88,46 @@ class CursorImpl : public Cursor {
     return ColumnType::Unknown;
   }
 
+  std::shared_ptr<arrow::Schema> getArrowSchema() {
+    if (!result_set_) {
+      return nullptr;
+    }
+    if (!arrow_schema_) {
+      ArrowResultSetConverter converter(result_set_, col_names_, -1);
+      arrow_schema_ = converter.getArrowSchema();
+    }
+    return arrow_schema_;
+  }
+
+  std::shared_ptr<arrow::RecordBatch> getNextArrowBatch(const size_t max_entries) {
+    if (!result_set_) {
+      return nullptr;
+    }
+    const auto entry_count = result_set_->entryCount();
+    if (next_arrow_entry_ >= entry_count) {
+      return nullptr;
+    }
+    const auto batch_entry_count =
+        max_entries ? std::min(max_entries, entry_count - next_arrow_entry_)
+                    : entry_count - next_arrow_entry_;
+    const auto schema = getArrowSchema();
+    // a converter is kept for each batch, the columnar conversion builds the arrays over
+    // its buffers and replaces them on the next conversion
+    arrow_converters_.emplace_back(
+        new ArrowResultSetConverter(result_set_, col_names_, -1));
+    auto record_batch = arrow_converters_.back()->getArrowBatch(
+        schema, next_arrow_entry_, batch_entry_count);
+    next_arrow_entry_ += batch_entry_count;
+    return record_batch;
+  }
+
  private:
   std::shared_ptr<ResultSet> result_set_;
   std::weak_ptr<Data_Namespace::DataMgr> data_mgr_;
+  std::vector<std::string> col_names_;
+  std::shared_ptr<arrow::Schema> arrow_schema_;
+  std::vector<std::unique_ptr<ArrowResultSetConverter>> arrow_converters_;
+  size_t next_arrow_entry_{0};
 };
 
 /**
@@ -111,14 +156,29 @@ class DBEngineImpl : public DBEngine {
 
   Cursor* executeDML(const std::string& query) {
     if (query_runner_ != nullptr) {
-      auto rs = query_runner_->runSQL(query, ExecutorDeviceType::CPU);
-      cursors_.emplace_back(new CursorImpl(rs, data_mgr_));
-      return cursors_.back();
+      std::shared_ptr<ResultSet> rs;
+      std::vector<std::string> col_names;
+      ParserWrapper pw{query};
+      if (pw.isCalcitePathPermissable()) {
+        // the names of the targets are the names of the arrow fields
+        const auto execution_result =
+            query_runner_->runSelectQuery(query, ExecutorDeviceType::CPU, true, true);
+        rs = execution_result->getRows();
+        for (const auto& target : execution_result->getTargetsMeta()) {
+          col_names.push_back(target.get_resname());
+        }
+      } else {
+        rs = query_runner_->runSQL(query, ExecutorDeviceType::CPU);
+      }
+      auto cursor = new CursorImpl(rs, data_mgr_, col_names);
+      std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+      cursors_.emplace_back(cursor);
+      return cursor;
     }
     return nullptr;
   }
 
-  DBEngineImpl(const std::string& base_path)
+  DBEngineImpl(const std::string& base_path, const size_t parallel_queries)
       : base_path_(base_path), query_runner_(nullptr) {
     if (!boost::filesystem::exists(base_path_)) {
       std::cerr << "Catalog basepath " + base_path_ + " does not exist.\n";
@@ -145,6 +205,10 @@ class DBEngineImpl : public DBEngine {
         auto session = std::make_unique<Catalog_Namespace::SessionInfo>(
             catalog, user_, ExecutorDeviceType::CPU, "");
         query_runner_ = QueryRunner::QueryRunner::init(session);
+        if (parallel_queries > 1) {
+          // a dispatch queue worker and an executor for each query running at once
+          query_runner_->resizeDispatchQueue(parallel_queries);
+        }
       }
     }
   }
@@ -155,6 +219,7 @@ class DBEngineImpl : public DBEngine {
   Catalog_Namespace::DBMetadata database_;
   Catalog_Namespace::UserMetadata user_;
   QueryRunner::QueryRunner* query_runner_;
+  std::mutex cursors_mutex_;
   std::vector<CursorImpl*> cursors_;
 };
 
@@ -164,9 +229,10 @@ class DBEngineImpl : public DBEngine {
  * Creates DBEngine instance
  *
  * @param sPath Path to the existing database
+ * @param parallel_queries Number of queries which can run at once
  */
-DBEngine* DBEngine::create(std::string path) {
-  return new DBEngineImpl(path);
+DBEngine* DBEngine::create(std::string path, size_t parallel_queries) {
+  return new DBEngineImpl(path, parallel_queries);
 }
 
 /** DBEngine downcasting methods */
@@ -193,6 +259,12 @@ Cursor* DBEngine::executeDML(std::string query) {
   return engine->executeDML(query);
 }
 
+std::future<Cursor*> DBEngine::executeDMLAsync(std::string query) {
+  DBEngineImpl* engine = getImpl(this);
+  return std::async(std::launch::async,
+                    [engine, query]() { return engine->executeDML(query); });
+}
+
 /********************************************* Row methods */
 
 Row::Row() {}
@@ -261,4 +333,14 @@ int Cursor::getColType(uint32_t col_num) {
   CursorImpl* cursor = getImpl(this);
   return (int)cursor->getColType(col_num);
 }
+
+std::shared_ptr<arrow::Schema> Cursor::getArrowSchema() {
+  CursorImpl* cursor = getImpl(this);
+  return cursor->getArrowSchema();
+}
+
+std::shared_ptr<arrow::RecordBatch> Cursor::getNextArrowBatch(size_t max_entries) {
+  CursorImpl* cursor = getImpl(this);
+  return cursor->getNextArrowBatch(max_entries);
+}
 }  // namespace EmbeddedDatabase
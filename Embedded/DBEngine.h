@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <future>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -23,6 +24,11 @@
 #include <vector>
 #include "QueryEngine/TargetValue.h"
 
+namespace arrow {
+class RecordBatch;
+class Schema;
+}  // namespace arrow
+
 namespace EmbeddedDatabase {
 
 class Row {
@@ -43,6 +49,15 @@ class Cursor {
   size_t getRowCount();
   Row getNextRow();
   int getColType(uint32_t col_num);
+
+  std::shared_ptr<arrow::Schema> getArrowSchema();
+
+  /**
+   * The next `max_entries` entries of the result, all the ones left if 0, as an arrow
+   * record batch, or null past the last entry. The arrays point into the buffers of the
+   * conversion instead of being copied and stay valid as long as the cursor.
+   */
+  std::shared_ptr<arrow::RecordBatch> getNextArrowBatch(size_t max_entries = 0);
 };
 
 class DBEngine {
@@ -50,7 +65,10 @@ class DBEngine {
   void reset();
   void executeDDL(std::string query);
   Cursor* executeDML(std::string query);
-  static DBEngine* create(std::string path);
+  // Runs the query on a thread of its own. The queries of different threads run
+  // concurrently up to the `parallel_queries` of the engine.
+  std::future<Cursor*> executeDMLAsync(std::string query);
+  static DBEngine* create(std::string path, size_t parallel_queries = 1);
 
  protected:
   DBEngine() {}
@@ -41,11 +41,45 @@ using Data_Namespace::AbstractBuffer;
 using Data_Namespace::DataMgr;
 
 bool g_use_table_device_offset{true};
+bool g_enable_nonblocking_fragment_drops{true};
+bool g_enable_column_page_sizing{false};
 
 using namespace std;
 
 namespace Fragmenter_Namespace {
 
+namespace {
+
+// The pages of a column are sized for the chunk of a full fragment to span about
+// kColumnPagesPerChunk of them.
+constexpr size_t kColumnPagesPerChunk{32};
+constexpr size_t kMinColumnPageSize{size_t(1) << 18};
+constexpr size_t kMaxColumnPageSize{size_t(1) << 23};
+
+// Narrow columns get smaller pages, so that the last page of their chunks is not mostly
+// empty, and wide or variable length ones larger pages, read in fewer requests. A page
+// size set on the table is kept.
+size_t get_column_page_size(const ColumnDescriptor* cd,
+                            const size_t max_fragment_rows,
+                            const size_t table_page_size) {
+  if (!g_enable_column_page_sizing || table_page_size != DEFAULT_PAGE_SIZE) {
+    return table_page_size;
+  }
+  const auto elem_size = cd->columnType.get_size();
+  if (elem_size <= 0) {
+    return kMaxColumnPageSize;
+  }
+  const size_t chunk_bytes = max_fragment_rows * elem_size;
+  size_t page_size = kMinColumnPageSize;
+  while (page_size < kMaxColumnPageSize &&
+         page_size * kColumnPagesPerChunk < chunk_bytes) {
+    page_size <<= 1;
+  }
+  return page_size;
+}
+
+}  // namespace
+
 InsertOrderFragmenter::InsertOrderFragmenter(
     const vector<int> chunkKeyPrefix,
     vector<Chunk>& chunkVec,
@@ -205,29 +239,33 @@ void InsertOrderFragmenter::dropFragmentsToSize(const size_t maxRows) {
   // b/c depends on insertLock around numTuples_
 
   // don't ever drop the only fragment!
-  if (numTuples_ == fragmentInfoVec_.back()->getPhysicalNumTuples()) {
-    return;
-  }
-
-  if (numTuples_ > maxRows) {
+  if (numTuples_ > maxRows &&
+      numTuples_ != fragmentInfoVec_.back()->getPhysicalNumTuples()) {
     size_t preNumTuples = numTuples_;
-    vector<int> dropFragIds;
     size_t targetRows = maxRows * DROP_FRAGMENT_FACTOR;
-    while (numTuples_ > targetRows) {
-      CHECK_GT(fragmentInfoVec_.size(), size_t(0));
-      size_t numFragTuples = fragmentInfoVec_[0]->getPhysicalNumTuples();
-      dropFragIds.push_back(fragmentInfoVec_[0]->fragmentId);
-      fragmentInfoVec_.pop_front();
-      CHECK_GE(numTuples_, numFragTuples);
-      numTuples_ -= numFragTuples;
+    {
+      // queries started from here on no longer see the dropped fragments, the ones
+      // already running keep them in their copy of the fragment infos
+      mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+      while (numTuples_ > targetRows) {
+        CHECK_GT(fragmentInfoVec_.size(), size_t(0));
+        size_t numFragTuples = fragmentInfoVec_[0]->getPhysicalNumTuples();
+        pendingDropFragIds_.push_back(fragmentInfoVec_[0]->fragmentId);
+        fragmentInfoVec_.pop_front();
+        CHECK_GE(numTuples_, numFragTuples);
+        numTuples_ -= numFragTuples;
+      }
     }
-    deleteFragments(dropFragIds);
     LOG(INFO) << "dropFragmentsToSize, numTuples pre: " << preNumTuples
               << " post: " << numTuples_ << " maxRows: " << maxRows;
   }
+  deleteFragments();
 }
 
-void InsertOrderFragmenter::deleteFragments(const vector<int>& dropFragIds) {
+void InsertOrderFragmenter::deleteFragments() {
+  if (pendingDropFragIds_.empty()) {
+    return;
+  }
   // Fix a verified loophole on sharded logical table which is locked using logical
   // tableId while it's its physical tables that can come here when fragments overflow
   // during COPY. Locks on a logical table and its physical tables never intersect, which
@@ -244,12 +282,25 @@ void InsertOrderFragmenter::deleteFragments(const vector<int>& dropFragIds) {
 
   // need to keep lock seq as TableLock >> fragmentInfoMutex_ or
   // SELECT and COPY may enter a deadlock
+  //
+  // The chunks may still be read by the queries which started before their fragments
+  // were dropped. Rather than have the insert, and every query queued behind its write
+  // lock, wait for those, the chunks are left to a later insert which finds the table
+  // idle.
   const auto delete_lock =
-      lockmgr::TableDataLockMgr::getWriteLockForTable(chunkKeyPrefix);
+      g_enable_nonblocking_fragment_drops
+          ? lockmgr::TableDataLockMgr::tryWriteLockForTable(chunkKeyPrefix)
+          : lockmgr::TableDataLockMgr::getWriteLockForTable(chunkKeyPrefix);
+  if (!delete_lock.ownsLock()) {
+    VLOG(1) << "Deferring the deletion of " << pendingDropFragIds_.size()
+            << " dropped fragments of table " << physicalTableId_
+            << ", the table is being read";
+    return;
+  }
 
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
 
-  for (const auto fragId : dropFragIds) {
+  for (const auto fragId : pendingDropFragIds_) {
     for (const auto& col : columnMap_) {
       int colId = col.first;
       vector<int> fragPrefix = chunkKeyPrefix_;
@@ -258,6 +309,7 @@ void InsertOrderFragmenter::deleteFragments(const vector<int>& dropFragIds) {
       dataMgr_->deleteChunksWithPrefix(fragPrefix);
     }
   }
+  pendingDropFragIds_.clear();
 }
 
 void InsertOrderFragmenter::updateColumnChunkMetadata(
@@ -688,6 +740,10 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
   }
   numTuples_ += insertDataStruct.numRows;
   dropFragmentsToSize(maxRows_);
+  catalog_->addToColumnStatistics(catalog_->getLogicalTableId(physicalTableId_),
+                                  insertDataStruct.columnIds,
+                                  insertDataStruct.data,
+                                  insertDataStruct.numRows);
 }
 
 FragmentInfo* InsertOrderFragmenter::createNewFragment(
@@ -709,15 +765,16 @@ FragmentInfo* InsertOrderFragmenter::createNewFragment(
   for (map<int, Chunk>::iterator colMapIt = columnMap_.begin();
        colMapIt != columnMap_.end();
        ++colMapIt) {
+    const auto cd = colMapIt->second.getColumnDesc();
     ChunkKey chunkKey = chunkKeyPrefix_;
-    chunkKey.push_back(colMapIt->second.getColumnDesc()->columnId);
+    chunkKey.push_back(cd->columnId);
     chunkKey.push_back(maxFragmentId_);
     colMapIt->second.createChunkBuffer(
         dataMgr_,
         chunkKey,
         memoryLevel,
         newFragmentInfo->deviceIds[static_cast<int>(memoryLevel)],
-        pageSize_);
+        get_column_page_size(cd, maxFragmentRows_, pageSize_));
     colMapIt->second.initEncoder();
   }
 
@@ -205,6 +205,9 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   bool hasMaterializedRowId_;
   int rowIdColId_;
   std::unordered_map<int, size_t> varLenColInfo_;
+  // fragments dropped by max_rows whose chunks are yet to be deleted, guarded by
+  // insertMutex_
+  std::vector<int> pendingDropFragIds_;
   std::shared_ptr<std::mutex> mutex_access_inmem_states;
 
   /**
@@ -217,7 +220,7 @@ class InsertOrderFragmenter : public AbstractFragmenter {
 
   FragmentInfo* createNewFragment(
       const Data_Namespace::MemoryLevel memory_level = Data_Namespace::DISK_LEVEL);
-  void deleteFragments(const std::vector<int>& dropFragIds);
+  void deleteFragments();
 
   void getChunkMetadata();
 
@@ -238,6 +241,17 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   auto vacuum_varlen_rows(const FragmentInfo& fragment,
                           const std::shared_ptr<Chunk_NS::Chunk>& chunk,
                           const std::vector<uint64_t>& frag_offsets);
+
+  bool updateStringsInPlace(const Catalog_Namespace::Catalog* catalog,
+                            const TableDescriptor* td,
+                            FragmentInfo& fragment,
+                            const std::vector<TargetMetaInfo>& sourceMetaInfo,
+                            const std::vector<const ColumnDescriptor*>& columnDescriptors,
+                            const RowDataProvider& sourceDataProvider,
+                            const size_t indexOffFragmentOffsetColumn,
+                            const Data_Namespace::MemoryLevel memoryLevel,
+                            UpdelRoll& updelRoll,
+                            Executor* executor);
 };
 
 }  // namespace Fragmenter_Namespace
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include <cstring>
+#include <limits>
 #include <numeric>
 
 #include "../Catalog/Catalog.h"
@@ -196,27 +197,142 @@ void sortIndexes(const ColumnDescriptor* cd,
   }
 }
 
+template <typename T>
+std::vector<uint64_t> rankRowsImpl(const size_t num_rows, const T* buffer) {
+  CHECK(buffer);
+  std::vector<size_t> indexes(num_rows);
+  std::iota(indexes.begin(), indexes.end(), 0);
+  sortIndexesImpl(indexes, buffer);
+  std::vector<uint64_t> ranks(num_rows);
+  uint64_t rank{0};
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    if (i && buffer[indexes[i - 1]] < buffer[indexes[i]]) {
+      ++rank;
+    }
+    ranks[indexes[i]] = rank;
+  }
+  return ranks;
+}
+
+// The dense rank of the value of every row, equal values have the same rank.
+std::vector<uint64_t> rankRows(const ColumnDescriptor* cd,
+                               const size_t num_rows,
+                               const DataBlockPtr& data) {
+  const auto& ti = cd->columnType;
+  switch (ti.get_type()) {
+    case kBOOLEAN:
+    case kTINYINT:
+      return rankRowsImpl(num_rows, reinterpret_cast<int8_t*>(data.numbersPtr));
+    case kSMALLINT:
+      return rankRowsImpl(num_rows, reinterpret_cast<int16_t*>(data.numbersPtr));
+    case kINT:
+      return rankRowsImpl(num_rows, reinterpret_cast<int32_t*>(data.numbersPtr));
+    case kBIGINT:
+    case kNUMERIC:
+    case kDECIMAL:
+    case kDATE:
+    case kTIME:
+    case kTIMESTAMP:
+      return rankRowsImpl(num_rows, reinterpret_cast<int64_t*>(data.numbersPtr));
+    case kFLOAT:
+      return rankRowsImpl(num_rows, reinterpret_cast<float*>(data.numbersPtr));
+    case kDOUBLE:
+      return rankRowsImpl(num_rows, reinterpret_cast<double*>(data.numbersPtr));
+    case kTEXT:
+    case kVARCHAR:
+    case kCHAR:
+      CHECK_EQ(kENCODING_DICT, ti.get_compression());
+      switch (ti.get_size()) {
+        case 1:
+          return rankRowsImpl(num_rows, reinterpret_cast<int8_t*>(data.numbersPtr));
+        case 2:
+          return rankRowsImpl(num_rows, reinterpret_cast<int16_t*>(data.numbersPtr));
+        case 4:
+          return rankRowsImpl(num_rows, reinterpret_cast<int32_t*>(data.numbersPtr));
+        default:
+          CHECK(false);
+      }
+    default:
+      CHECK(false) << "invalid type '" << ti.get_type() << "' to z-order";
+  }
+  return {};
+}
+
+// Sorts the rows on their Z-order value: the ranks of the row in every column, scaled
+// to the same number of bits, with the bits interleaved from the most significant ones.
+// Nearby rows are then close on all the columns at once, not only on the first one.
+void sortIndexesZorder(const std::vector<const ColumnDescriptor*>& cds,
+                       const std::vector<const DataBlockPtr*>& data,
+                       std::vector<size_t>& indexes) {
+  CHECK_EQ(cds.size(), data.size());
+  const auto num_rows = indexes.size();
+  const size_t bits_per_column = 64 / cds.size();
+  const auto max_code = bits_per_column == 64
+                            ? std::numeric_limits<uint64_t>::max()
+                            : (uint64_t(1) << bits_per_column) - 1;
+  std::vector<std::vector<uint64_t>> codes;
+  for (size_t i = 0; i < cds.size(); ++i) {
+    auto ranks = rankRows(cds[i], num_rows, *data[i]);
+    const auto max_rank =
+        ranks.empty() ? uint64_t(0) : *std::max_element(ranks.begin(), ranks.end());
+    for (auto& rank : ranks) {
+      rank = max_rank ? static_cast<uint64_t>(static_cast<double>(rank) / max_rank *
+                                              static_cast<double>(max_code))
+                      : 0;
+    }
+    codes.push_back(std::move(ranks));
+  }
+  std::vector<uint64_t> keys(num_rows, 0);
+  for (size_t row = 0; row < num_rows; ++row) {
+    uint64_t key{0};
+    for (size_t bit = bits_per_column; bit-- > 0;) {
+      for (const auto& column_codes : codes) {
+        key = (key << 1) | ((column_codes[row] >> bit) & 1);
+      }
+    }
+    keys[row] = key;
+  }
+  std::stable_sort(indexes.begin(), indexes.end(), [&keys](const auto a, const auto b) {
+    return keys[a] < keys[b];
+  });
+}
+
 void SortedOrderFragmenter::sortData(InsertData& insertDataStruct) {
-  // coming here table must have defined a sort_column for mini sort
+  // coming here table must have defined a sort_column or zorder_columns for mini sort
   const auto table_desc = catalog_->getMetadataForTable(physicalTableId_);
   CHECK(table_desc);
-  CHECK_GT(table_desc->sortedColumnId, 0);
-  const auto logical_cd =
-      catalog_->getMetadataForColumn(table_desc->tableId, table_desc->sortedColumnId);
-  CHECK(logical_cd);
-  const auto physical_cd = catalog_->getMetadataForColumn(
-      table_desc->tableId,
-      table_desc->sortedColumnId + (logical_cd->columnType.is_geometry() ? 1 : 0));
-  const auto it = std::find(insertDataStruct.columnIds.begin(),
-                            insertDataStruct.columnIds.end(),
-                            physical_cd->columnId);
-  CHECK(it != insertDataStruct.columnIds.end());
-  // sort row indexes of the sort column
+  const auto column_data = [&insertDataStruct](const ColumnDescriptor* cd) {
+    const auto it = std::find(insertDataStruct.columnIds.begin(),
+                              insertDataStruct.columnIds.end(),
+                              cd->columnId);
+    CHECK(it != insertDataStruct.columnIds.end());
+    const auto dist = std::distance(insertDataStruct.columnIds.begin(), it);
+    CHECK_LT(static_cast<size_t>(dist), insertDataStruct.data.size());
+    return &insertDataStruct.data[dist];
+  };
+  // sort row indexes of the sort columns
   std::vector<size_t> indexes(insertDataStruct.numRows);
   std::iota(indexes.begin(), indexes.end(), 0);
-  const auto dist = std::distance(insertDataStruct.columnIds.begin(), it);
-  CHECK_LT(static_cast<size_t>(dist), insertDataStruct.data.size());
-  sortIndexes(physical_cd, indexes, insertDataStruct.data[dist]);
+  if (!table_desc->zorderColumnIds.empty()) {
+    std::vector<const ColumnDescriptor*> cds;
+    std::vector<const DataBlockPtr*> data;
+    for (const auto column_id : table_desc->zorderColumnIds) {
+      const auto cd = catalog_->getMetadataForColumn(table_desc->tableId, column_id);
+      CHECK(cd);
+      cds.push_back(cd);
+      data.push_back(column_data(cd));
+    }
+    sortIndexesZorder(cds, data, indexes);
+  } else {
+    CHECK_GT(table_desc->sortedColumnId, 0);
+    const auto logical_cd =
+        catalog_->getMetadataForColumn(table_desc->tableId, table_desc->sortedColumnId);
+    CHECK(logical_cd);
+    const auto physical_cd = catalog_->getMetadataForColumn(
+        table_desc->tableId,
+        table_desc->sortedColumnId + (logical_cd->columnType.is_geometry() ? 1 : 0));
+    sortIndexes(physical_cd, indexes, *column_data(physical_cd));
+  }
   // shuffle rows of all columns
   for (size_t i = 0; i < insertDataStruct.columnIds.size(); ++i) {
     const auto cd = catalog_->getMetadataForColumn(table_desc->tableId,
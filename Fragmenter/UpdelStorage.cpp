@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <boost/variant.hpp>
 #include <boost/variant/get.hpp>
+#include <cstring>
 #include <limits>
 #include <mutex>
 #include <string>
@@ -36,6 +37,8 @@
 
 extern bool g_enable_experimental_string_functions;
 
+bool g_enable_inplace_string_updates{true};
+
 namespace Fragmenter_Namespace {
 
 inline void wait_cleanup_threads(std::vector<std::future<void>>& threads) {
@@ -275,7 +278,6 @@ void InsertOrderFragmenter::updateColumns(
     const Data_Namespace::MemoryLevel memoryLevel,
     UpdelRoll& updelRoll,
     Executor* executor) {
-  updelRoll.is_varlen_update = true;
   updelRoll.catalog = catalog;
   updelRoll.logicalTableId = catalog->getLogicalTableId(td->tableId);
   updelRoll.memoryLevel = memoryLevel;
@@ -288,10 +290,24 @@ void InsertOrderFragmenter::updateColumns(
     return;
   }
 
-  TargetValueConverterFactory factory;
-
   auto fragment_ptr = getFragmentInfo(fragmentId);
   auto& fragment = *fragment_ptr;
+  if (g_enable_inplace_string_updates &&
+      updateStringsInPlace(catalog,
+                           td,
+                           fragment,
+                           sourceMetaInfo,
+                           columnDescriptors,
+                           sourceDataProvider,
+                           indexOffFragmentOffsetColumn,
+                           memoryLevel,
+                           updelRoll,
+                           executor)) {
+    return;
+  }
+  updelRoll.is_varlen_update = true;
+
+  TargetValueConverterFactory factory;
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks;
   get_chunks(catalog, td, fragment, memoryLevel, chunks);
   std::vector<std::unique_ptr<TargetValueConverter>> sourceDataConverters(
@@ -568,6 +584,146 @@ void InsertOrderFragmenter::updateColumns(
   deletedChunk->getBuffer()->setUpdated();
 }
 
+/**
+ * The rows of a string column are stored back to back, each one ending where the next
+ * one starts, so a string can't grow or shrink without moving all the strings after it.
+ * When every new value of a fragment has the byte length of the value it replaces, as
+ * codes and fixed format strings usually do, the bytes are overwritten in place instead
+ * of deleting the rows and appending them again with all their columns. Returns false,
+ * having changed nothing, if some value doesn't fit or a column isn't a none encoded
+ * string.
+ */
+bool InsertOrderFragmenter::updateStringsInPlace(
+    const Catalog_Namespace::Catalog* catalog,
+    const TableDescriptor* td,
+    FragmentInfo& fragment,
+    const std::vector<TargetMetaInfo>& sourceMetaInfo,
+    const std::vector<const ColumnDescriptor*>& columnDescriptors,
+    const RowDataProvider& sourceDataProvider,
+    const size_t indexOffFragmentOffsetColumn,
+    const Data_Namespace::MemoryLevel memoryLevel,
+    UpdelRoll& updelRoll,
+    Executor* executor) {
+  for (const auto cd : columnDescriptors) {
+    if (!cd->columnType.is_string() ||
+        cd->columnType.get_compression() != kENCODING_NONE) {
+      return false;
+    }
+  }
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks;
+  for (const auto cd : columnDescriptors) {
+    const auto chunk_meta_it = fragment.getChunkMetadataMapPhysical().find(cd->columnId);
+    CHECK(chunk_meta_it != fragment.getChunkMetadataMapPhysical().end());
+    ChunkKey chunk_key{
+        catalog->getCurrentDB().dbId, td->tableId, cd->columnId, fragment.fragmentId};
+    chunks.push_back(Chunk_NS::Chunk::getChunk(cd,
+                                               &catalog->getDataMgr(),
+                                               chunk_key,
+                                               memoryLevel,
+                                               0,
+                                               chunk_meta_it->second->numBytes,
+                                               chunk_meta_it->second->numElements));
+    CHECK(chunks.back()->getIndexBuf());
+  }
+
+  // the new strings of each column, with the offsets of their rows
+  const auto num_rows = sourceDataProvider.getRowCount();
+  TargetValueConverterFactory factory;
+  std::vector<std::unique_ptr<TargetValueConverter>> converters;
+  for (size_t col_idx = 0; col_idx < columnDescriptors.size(); ++col_idx) {
+    const auto cd = columnDescriptors[col_idx];
+    const auto& source_meta_info = sourceMetaInfo[col_idx];
+    ConverterCreateParameter param{
+        num_rows,
+        *catalog,
+        source_meta_info,
+        cd,
+        cd->columnType,
+        !cd->columnType.get_notnull(),
+        sourceDataProvider.getLiteralDictionary(),
+        g_enable_experimental_string_functions
+            ? executor->getStringDictionaryProxy(
+                  source_meta_info.get_type_info().get_comp_param(),
+                  executor->getRowSetMemoryOwner(),
+                  true)
+            : nullptr};
+    converters.push_back(factory.create(param));
+  }
+  std::vector<uint64_t> frag_offsets;
+  for (size_t entry_idx = 0; entry_idx < sourceDataProvider.getEntryCount();
+       ++entry_idx) {
+    const auto row = sourceDataProvider.getEntryAt(entry_idx);
+    if (row.empty()) {
+      continue;
+    }
+    const auto offset_tv =
+        boost::get<ScalarTargetValue>(&row[indexOffFragmentOffsetColumn]);
+    CHECK(offset_tv);
+    const auto frag_offset = boost::get<int64_t>(offset_tv);
+    CHECK(frag_offset);
+    CHECK_LT(frag_offsets.size(), num_rows);
+    for (size_t col_idx = 0; col_idx < converters.size(); ++col_idx) {
+      converters[col_idx]->convertToColumnarFormat(frag_offsets.size(), &row[col_idx]);
+    }
+    frag_offsets.push_back(*frag_offset);
+  }
+  CHECK_EQ(frag_offsets.size(), num_rows);
+  // nulls are converted to empty strings, as they are stored
+  InsertData insert_data;
+  for (const auto& converter : converters) {
+    converter->addDataBlocksToInsertData(insert_data);
+  }
+  std::vector<const std::vector<std::string>*> new_strings;
+  for (const auto& data_block : insert_data.data) {
+    CHECK(data_block.stringsPtr);
+    new_strings.push_back(data_block.stringsPtr);
+  }
+
+  for (size_t col_idx = 0; col_idx < columnDescriptors.size(); ++col_idx) {
+    const auto index_array = reinterpret_cast<const StringOffsetT*>(
+        chunks[col_idx]->getIndexBuf()->getMemoryPtr());
+    for (size_t i = 0; i < frag_offsets.size(); ++i) {
+      const auto frag_offset = frag_offsets[i];
+      if (index_array[frag_offset + 1] - index_array[frag_offset] !=
+          static_cast<StringOffsetT>((*new_strings[col_idx])[i].size())) {
+        return false;
+      }
+    }
+  }
+
+  for (size_t col_idx = 0; col_idx < columnDescriptors.size(); ++col_idx) {
+    const auto cd = columnDescriptors[col_idx];
+    const auto& chunk = chunks[col_idx];
+    const auto index_array =
+        reinterpret_cast<const StringOffsetT*>(chunk->getIndexBuf()->getMemoryPtr());
+    const auto data_addr = chunk->getBuffer()->getMemoryPtr();
+    for (size_t i = 0; i < frag_offsets.size(); ++i) {
+      const auto& str = (*new_strings[col_idx])[i];
+      std::memcpy(data_addr + index_array[frag_offsets[i]], str.data(), str.size());
+    }
+    {
+      std::lock_guard<std::mutex> lck(updelRoll.mutex);
+      updelRoll.dirtyChunks[chunk.get()] = chunk;
+      updelRoll.dirtyChunkeys.insert(
+          {catalog->getCurrentDB().dbId, td->tableId, cd->columnId, fragment.fragmentId});
+    }
+    chunk->getBuffer()->getEncoder()->updateStats(
+        new_strings[col_idx], 0, new_strings[col_idx]->size());
+    chunk->getBuffer()->setUpdated();
+    updateColumnMetadata(cd,
+                         fragment,
+                         chunk,
+                         false,
+                         std::numeric_limits<double>::lowest(),
+                         std::numeric_limits<double>::max(),
+                         std::numeric_limits<int64_t>::min(),
+                         std::numeric_limits<int64_t>::max(),
+                         cd->columnType,
+                         updelRoll);
+  }
+  return true;
+}
+
 void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catalog,
                                          const TableDescriptor* td,
                                          const ColumnDescriptor* cd,
@@ -577,9 +733,13 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
                                          const SQLTypeInfo& rhs_type,
                                          const Data_Namespace::MemoryLevel memory_level,
                                          UpdelRoll& updel_roll) {
-  updel_roll.catalog = catalog;
-  updel_roll.logicalTableId = catalog->getLogicalTableId(td->tableId);
-  updel_roll.memoryLevel = memory_level;
+  {
+    // the fragments of a table can be updated concurrently
+    std::lock_guard<std::mutex> lck(updel_roll.mutex);
+    updel_roll.catalog = catalog;
+    updel_roll.logicalTableId = catalog->getLogicalTableId(td->tableId);
+    updel_roll.memoryLevel = memory_level;
+  }
 
   const size_t ncore = cpu_threads();
   const auto nrow = frag_offsets.size();
@@ -949,6 +1109,19 @@ void InsertOrderFragmenter::updateColumnMetadata(const ColumnDescriptor* cd,
              !(lhs_type.is_string() && kENCODING_DICT != lhs_type.get_compression())) {
     update_stats(min_int64t_per_chunk, max_int64t_per_chunk, has_null_per_chunk);
   }
+  if (cd->isDeletedCol && buffer->getType() == Data_Namespace::CPU_LEVEL) {
+    // The stats of the delete column are exact rather than widened, the scans skip the
+    // fragments whose rows are all deleted and don't fetch the column of the others
+    // when there is no deleted row.
+    const auto deleted = reinterpret_cast<const int8_t*>(buffer->getMemoryPtr());
+    const auto row_count = encoder->getNumElems();
+    const auto deleted_count = std::count(deleted, deleted + row_count, int8_t(1));
+    ChunkStats chunk_stats{};
+    chunk_stats.min.tinyintval = row_count && deleted_count == int64_t(row_count);
+    chunk_stats.max.tinyintval = deleted_count > 0;
+    chunk_stats.has_nulls = false;
+    encoder->resetChunkStats(chunk_stats);
+  }
   buffer->getEncoder()->getMetadata(chunkMetadata[cd->columnId]);
 }
 
@@ -1308,6 +1481,10 @@ void UpdelRoll::commitUpdate() {
     }
   }
 
+  // the statistics of the updated columns can't be updated from the new values alone
+  const_cast<Catalog_Namespace::Catalog*>(catalog)->removeColumnStatistics(
+      logicalTableId);
+
   // for each dirty fragment
   for (auto& cm : chunkMetadata) {
     cm.first.first->fragmenter->updateMetadata(catalog, cm.first, *this);
@@ -78,6 +78,8 @@ struct CopyParams {
   std::string geo_layer_name;
   bool geo_assign_render_groups;
   bool geo_explode_collections;
+  // rows whose value of this column is already in the table replace that row
+  std::string upsert_key;
 
   CopyParams()
       : delimiter(',')
@@ -22,8 +22,14 @@
 
 #include "ImportExport/DelimitedParserUtils.h"
 
+#include <cstring>
+#include <initializer_list>
 #include <string_view>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "Logger/Logger.h"
 #include "StringDictionary/StringDictionary.h"
 
@@ -32,6 +38,55 @@ inline bool is_eol(const char& c, const import_export::CopyParams& copy_params)
   return c == copy_params.line_delim || c == '\n' || c == '\r';
 }
 
+// Finds the next of the few characters the parsers act on, the delimiters, quotes and
+// escapes, comparing 16 bytes of the buffer at a time to all of them.
+class StructuralCharFinder {
+ public:
+  StructuralCharFinder(std::initializer_list<char> chars) {
+    CHECK_LE(chars.size(), kMaxChars);
+    for (const auto c : chars) {
+      chars_[num_chars_] = c;
+#ifdef __SSE2__
+      char_vecs_[num_chars_] = _mm_set1_epi8(c);
+#endif
+      ++num_chars_;
+    }
+  }
+
+  const char* find(const char* p, const char* end) const {
+#ifdef __SSE2__
+    while (end - p >= 16) {
+      const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      auto matches = _mm_cmpeq_epi8(block, char_vecs_[0]);
+      for (size_t i = 1; i < num_chars_; ++i) {
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, char_vecs_[i]));
+      }
+      const auto mask = _mm_movemask_epi8(matches);
+      if (mask) {
+        return p + __builtin_ctz(mask);
+      }
+      p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+      for (size_t i = 0; i < num_chars_; ++i) {
+        if (*p == chars_[i]) {
+          return p;
+        }
+      }
+    }
+    return end;
+  }
+
+ private:
+  static constexpr size_t kMaxChars{8};
+#ifdef __SSE2__
+  __m128i char_vecs_[kMaxChars];
+#endif
+  char chars_[kMaxChars];
+  size_t num_chars_{0};
+};
+
 inline void trim_space(const char*& field_begin, const char*& field_end) {
   while (field_begin < field_end && (*field_begin == ' ' || *field_begin == '\r')) {
     ++field_begin;
@@ -66,14 +121,10 @@ size_t find_beginning(const char* buffer,
   if (begin == 0 || (begin > 0 && buffer[begin - 1] == copy_params.line_delim)) {
     return 0;
   }
-  size_t i;
   const char* buf = buffer + begin;
-  for (i = 0; i < end - begin; i++) {
-    if (buf[i] == copy_params.line_delim) {
-      return i + 1;
-    }
-  }
-  return i;
+  const auto line_delim = static_cast<const char*>(
+      memchr(buf, static_cast<unsigned char>(copy_params.line_delim), end - begin));
+  return line_delim ? line_delim - buf + 1 : end - begin;
 }
 
 size_t find_end(const char* buffer,
@@ -85,10 +136,17 @@ size_t find_end(const char* buffer,
                 size_t offset) {
   size_t last_line_delim_pos = 0;
   const char* current = buffer + offset;
+  const char* buffer_end = buffer + size;
   if (copy_params.quoted) {
-    while (current < buffer + size) {
-      while (!in_quote && current < buffer + size) {
+    const StructuralCharFinder unquoted_chars{copy_params.line_delim, copy_params.quote};
+    const StructuralCharFinder quoted_chars{copy_params.quote, copy_params.escape};
+    while (current < buffer_end) {
+      while (!in_quote && current < buffer_end) {
         // We are outside of quotes. We have to find the last possible line delimiter.
+        current = unquoted_chars.find(current, buffer_end);
+        if (current == buffer_end) {
+          break;
+        }
         if (*current == copy_params.line_delim) {
           last_line_delim_pos = current - buffer;
           ++num_rows_this_buffer;
@@ -98,9 +156,13 @@ size_t find_end(const char* buffer,
         ++current;
       }
 
-      while (in_quote && current < buffer + size) {
+      while (in_quote && current < buffer_end) {
         // We are in a quoted field. We have to find the ending quote.
-        if ((*current == copy_params.escape) && (current < buffer + size - 1) &&
+        current = quoted_chars.find(current, buffer_end);
+        if (current == buffer_end) {
+          break;
+        }
+        if ((*current == copy_params.escape) && (current < buffer_end - 1) &&
             (*(current + 1) == copy_params.quote)) {
           ++current;
         } else if (*current == copy_params.quote) {
@@ -110,11 +172,10 @@ size_t find_end(const char* buffer,
       }
     }
   } else {
-    while (current < buffer + size) {
-      if (*current == copy_params.line_delim) {
-        last_line_delim_pos = current - buffer;
-        ++num_rows_this_buffer;
-      }
+    const StructuralCharFinder line_delims{copy_params.line_delim};
+    while ((current = line_delims.find(current, buffer_end)) < buffer_end) {
+      last_line_delim_pos = current - buffer;
+      ++num_rows_this_buffer;
       ++current;
     }
   }
@@ -212,7 +273,19 @@ const char* get_row(const char* buf,
   bool has_escape = false;
   bool strip_quotes = false;
   try_single_thread = false;
+  // the field bytes between the characters of the branches below are skipped in bulk
+  const StructuralCharFinder structural_chars{copy_params.escape,
+                                              copy_params.quote,
+                                              copy_params.array_begin,
+                                              copy_params.delimiter,
+                                              copy_params.line_delim,
+                                              '\n',
+                                              '\r'};
   for (p = buf; p < entire_buf_end; ++p) {
+    p = structural_chars.find(p, entire_buf_end);
+    if (p == entire_buf_end) {
+      break;
+    }
     if (*p == copy_params.escape && p < entire_buf_end - 1 &&
         *(p + 1) == copy_params.quote) {
       p++;
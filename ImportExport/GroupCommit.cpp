@@ -0,0 +1,292 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ImportExport/GroupCommit.h"
+
+#include "LockMgr/LockMgr.h"
+#include "Logger/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+
+size_t g_group_commit_window_ms{0};
+size_t g_group_commit_coalesce_rows{0};
+
+namespace import_export {
+
+namespace {
+
+struct Commit {
+  size_t load_count{1};
+  bool done{false};
+  std::optional<std::string> error;
+  // when coalescing, the import buffers of the leader, which the other loads append
+  // their rows to before the leader inserts them all at once
+  const std::vector<std::unique_ptr<TypedImportBuffer>>* import_buffers{nullptr};
+  std::vector<int> column_ids;
+  size_t row_count{0};
+};
+
+struct TableCommits {
+  std::mutex mutex;
+  std::condition_variable cv;
+  // the commit new loads join, its leader is still waiting for the window
+  std::shared_ptr<Commit> open;
+  // the commits which aren't done, the rows of their loads are all inserted
+  std::vector<std::shared_ptr<Commit>> pending;
+};
+
+std::mutex table_commits_mutex;
+std::map<ChunkKey, std::shared_ptr<TableCommits>> table_commits_map;
+
+std::shared_ptr<TableCommits> get_table_commits(const ChunkKey& table_key) {
+  std::lock_guard<std::mutex> lock(table_commits_mutex);
+  auto& table_commits = table_commits_map[table_key];
+  if (!table_commits) {
+    table_commits = std::make_shared<TableCommits>();
+  }
+  return table_commits;
+}
+
+// Takes all the pending commits of the table. Must be called with the insert data lock
+// of the table held, so that the rows of every load which joined them are covered by
+// the checkpoint or the rollback which completes them.
+std::vector<std::shared_ptr<Commit>> take_pending_commits(TableCommits& table_commits) {
+  table_commits.open = nullptr;
+  return std::move(table_commits.pending);
+}
+
+void complete_commits(TableCommits& table_commits,
+                      const std::vector<std::shared_ptr<Commit>>& commits,
+                      const std::optional<std::string>& error) {
+  for (const auto& commit : commits) {
+    commit->done = true;
+    commit->error = error;
+  }
+  table_commits.cv.notify_all();
+}
+
+std::vector<int> get_column_ids(const Loader& loader) {
+  std::vector<int> column_ids;
+  for (const auto cd : loader.get_column_descs()) {
+    column_ids.push_back(cd->columnId);
+  }
+  return column_ids;
+}
+
+bool can_coalesce(const Loader& loader,
+                  const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+                  const size_t row_count) {
+  if (row_count >= g_group_commit_coalesce_rows || loader.getReplicating()) {
+    return false;
+  }
+  return std::none_of(import_buffers.begin(),
+                      import_buffers.end(),
+                      [](const auto& import_buffer) {
+                        return import_buffer->get_replicate_count() > 0;
+                      });
+}
+
+// The rows of the load are appended to the open commit, whose leader inserts them
+// along with its own once the window is over or enough rows are buffered.
+bool load_coalesced(Loader& loader,
+                    const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+                    const size_t row_count,
+                    lockmgr::WriteLock&& insert_data_lock,
+                    const ChunkKey& table_key,
+                    TableCommits& table_commits) {
+  const auto td = loader.getTableDesc();
+  std::shared_ptr<Commit> commit;
+  bool leader{false};
+  {
+    const auto insert_lock = std::move(insert_data_lock);
+    auto column_ids = get_column_ids(loader);
+    std::unique_lock<std::mutex> lock(table_commits.mutex);
+    commit = table_commits.open;
+    if (commit && (!commit->import_buffers || commit->column_ids != column_ids)) {
+      // the open commit doesn't take rows or not these columns, after an ALTER TABLE
+      lock.unlock();
+      return loader.load(import_buffers, row_count);
+    }
+    if (commit) {
+      ++commit->load_count;
+      // the leader closes the commit under the insert lock, which we're holding
+      lock.unlock();
+      for (size_t col_idx = 0; col_idx < import_buffers.size(); ++col_idx) {
+        (*commit->import_buffers)[col_idx]->append(*import_buffers[col_idx]);
+      }
+      lock.lock();
+      commit->row_count += row_count;
+      if (commit->row_count >= g_group_commit_coalesce_rows) {
+        table_commits.cv.notify_all();
+      }
+    } else {
+      commit = std::make_shared<Commit>();
+      commit->import_buffers = &import_buffers;
+      commit->column_ids = std::move(column_ids);
+      commit->row_count = row_count;
+      table_commits.open = commit;
+      leader = true;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(table_commits.mutex);
+  if (!leader) {
+    table_commits.cv.wait(lock, [&commit] { return commit->done; });
+    if (commit->error) {
+      throw std::runtime_error(*commit->error);
+    }
+    return true;
+  }
+  table_commits.cv.wait_for(
+      lock, std::chrono::milliseconds(g_group_commit_window_ms), [&commit] {
+        return commit->row_count >= g_group_commit_coalesce_rows;
+      });
+  lock.unlock();
+  const auto insert_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(table_key);
+  lock.lock();
+  if (table_commits.open == commit) {
+    table_commits.open = nullptr;
+  }
+  const auto commit_row_count = commit->row_count;
+  lock.unlock();
+
+  bool loaded{false};
+  std::optional<std::string> error;
+  const auto table_epochs = loader.getTableEpochs();
+  try {
+    loaded = loader.loadNoCheckpoint(import_buffers, commit_row_count);
+  } catch (const std::exception& e) {
+    error = e.what();
+  }
+  if (!loaded) {
+    loader.setTableEpochs(table_epochs);
+    if (!error) {
+      error = "Rolled back by a failed load into table " + td->tableName;
+    }
+  } else {
+    try {
+      loader.checkpoint();
+    } catch (const std::exception& e) {
+      error = e.what();
+    }
+  }
+  VLOG(1) << "Coalesced commit of " << commit->load_count << " loads, "
+          << commit_row_count << " rows into table " << td->tableName
+          << (error ? " failed: " + *error : " done");
+  lock.lock();
+  complete_commits(table_commits, {commit}, error);
+  if (error) {
+    throw std::runtime_error(*error);
+  }
+  return true;
+}
+
+}  // namespace
+
+bool load_with_group_commit(
+    Loader& loader,
+    const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+    const size_t row_count,
+    lockmgr::WriteLock&& insert_data_lock) {
+  CHECK_GT(g_group_commit_window_ms, size_t(0));
+  const auto td = loader.getTableDesc();
+  if (td->persistenceLevel != Data_Namespace::MemoryLevel::DISK_LEVEL) {
+    return loader.load(import_buffers, row_count);
+  }
+  const ChunkKey table_key{loader.getCatalog().getCurrentDB().dbId, td->tableId};
+  const auto table_commits = get_table_commits(table_key);
+  if (g_group_commit_coalesce_rows && can_coalesce(loader, import_buffers, row_count)) {
+    return load_coalesced(loader,
+                          import_buffers,
+                          row_count,
+                          std::move(insert_data_lock),
+                          table_key,
+                          *table_commits);
+  }
+  std::shared_ptr<Commit> commit;
+  bool leader{false};
+  {
+    const auto insert_lock = std::move(insert_data_lock);
+    const auto table_epochs = loader.getTableEpochs();
+    if (!loader.loadNoCheckpoint(import_buffers, row_count)) {
+      loader.setTableEpochs(table_epochs);
+      std::lock_guard<std::mutex> lock(table_commits->mutex);
+      complete_commits(*table_commits,
+                       take_pending_commits(*table_commits),
+                       "Rolled back by a failed load into table " + td->tableName);
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(table_commits->mutex);
+    // join before releasing the insert lock, a rollback by the next load must fail us
+    commit = table_commits->open;
+    if (commit) {
+      ++commit->load_count;
+    } else {
+      commit = std::make_shared<Commit>();
+      table_commits->open = commit;
+      table_commits->pending.push_back(commit);
+      leader = true;
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(table_commits->mutex);
+  if (!leader) {
+    table_commits->cv.wait(lock, [&commit] { return commit->done; });
+  } else {
+    // a checkpoint of another commit or a rollback can complete this one early
+    table_commits->cv.wait_for(lock,
+                               std::chrono::milliseconds(g_group_commit_window_ms),
+                               [&commit] { return commit->done; });
+    if (!commit->done) {
+      if (table_commits->open == commit) {
+        table_commits->open = nullptr;
+      }
+      lock.unlock();
+      const auto insert_lock =
+          lockmgr::InsertDataLockMgr::getWriteLockForTable(table_key);
+      lock.lock();
+      if (!commit->done) {
+        const auto commits = take_pending_commits(*table_commits);
+        size_t load_count{0};
+        for (const auto& pending_commit : commits) {
+          load_count += pending_commit->load_count;
+        }
+        lock.unlock();
+        std::optional<std::string> error;
+        try {
+          loader.checkpoint();
+        } catch (const std::exception& e) {
+          error = e.what();
+        }
+        VLOG(1) << "Group commit of " << load_count << " loads into table "
+                << td->tableName << (error ? " failed: " + *error : " done");
+        lock.lock();
+        complete_commits(*table_commits, commits, error);
+      }
+    }
+  }
+  if (commit->error) {
+    throw std::runtime_error(*commit->error);
+  }
+  return true;
+}
+
+}  // namespace import_export
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    GroupCommit.h
+ * @brief   Coalesces the checkpoints of concurrent small loads into the same table.
+ *
+ * Every load into a table ends with a checkpoint, which syncs each file the load touched
+ * and then the epoch file, so with many small concurrent loads the syncs bound the
+ * ingest rate. In group commit mode a load inserts its rows without a checkpoint,
+ * releases the insert lock of the table so that the next load can go on, and joins the
+ * pending commit of the table. The first load to join a commit waits for the window,
+ * then checkpoints the table once for all the loads which joined. A load still returns
+ * only once its rows are durable.
+ *
+ * Rolling back the table discards the rows of all the pending loads, so they all fail
+ * when the checkpoint fails or when one of them fails to insert its rows.
+ *
+ * With g_group_commit_coalesce_rows, small loads don't insert their rows either: they
+ * append them to the import buffers of the first load to join the commit, which inserts
+ * them all with a single append to the tail fragments of the table once the window is
+ * over or as many rows are buffered. Many small loads then cost a single append and
+ * fragment metadata update, which readers of the table would otherwise contend with.
+ */
+
+#pragma once
+
+#include "ImportExport/Importer.h"
+#include "LockMgr/LockMgrImpl.h"
+
+extern size_t g_group_commit_window_ms;
+extern size_t g_group_commit_coalesce_rows;
+
+namespace import_export {
+
+// Loads the rows and returns once they are checkpointed. `insert_data_lock` is the write
+// lock of the table held by the caller, released before waiting for the checkpoint.
+bool load_with_group_commit(
+    Loader& loader,
+    const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+    const size_t row_count,
+    lockmgr::WriteLock&& insert_data_lock);
+
+}  // namespace import_export
@@ -33,6 +33,7 @@
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
+#include <deque>
 #include <fstream>
 #include <future>
 #include <iomanip>
@@ -40,6 +41,7 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <stack>
 #include <stdexcept>
 #include <thread>
@@ -60,7 +62,9 @@
 #include "Logger/Logger.h"
 #include "OSDependent/omnisci_glob.h"
 #include "QueryEngine/TypePunning.h"
+#include "Shared/DateConverters.h"
 #include "Shared/SqlTypesLayout.h"
+#include "Shared/UpdelRoll.h"
 #include "Shared/import_helpers.h"
 #include "Shared/measure.h"
 #include "Shared/misc.h"
@@ -72,6 +76,7 @@
 #include "gen-cpp/OmniSci.h"
 
 size_t g_archive_read_buf_size = 1 << 20;
+bool g_enable_pipelined_import{false};
 
 inline auto get_filesize(const std::string& file_path) {
   boost::filesystem::path boost_file_path{file_path};
@@ -154,6 +159,9 @@ Importer::Importer(Catalog_Namespace::Catalog& c,
 Importer::Importer(Loader* providedLoader, const std::string& f, const CopyParams& p)
     : DataStreamSink(p, f), loader(providedLoader) {
   import_id = boost::filesystem::path(file_path).filename().string();
+  if (!p.upsert_key.empty()) {
+    loader->setUpsertKey(p.upsert_key);
+  }
   file_size = 0;
   max_threads = 0;
   p_file = nullptr;
@@ -466,6 +474,51 @@ ArrayDatum TDatumToArrayDatum(const TDatum& datum, const SQLTypeInfo& ti) {
   return ArrayDatum(len, buf, false);
 }
 
+namespace {
+
+// Strings an import buffer keeps the dictionary ids of, across its batches.
+constexpr size_t kMaxCachedDictStrings{1 << 16};
+
+}  // namespace
+
+template <typename T>
+void TypedImportBuffer::getOrAddDictIds(const std::vector<std::string_view>& strings,
+                                        std::vector<T>* ids) {
+  ids->resize(strings.size());
+  // the rows of an import usually repeat a few values, each one is hashed and looked up
+  // in the dictionary, under its lock, once per batch at most
+  std::unordered_map<std::string_view, size_t> missing_string_idxs;
+  std::vector<std::string_view> missing_strings;
+  std::vector<std::pair<size_t, size_t>> missing_rows;
+  for (size_t row = 0; row < strings.size(); ++row) {
+    const auto& str = strings[row];
+    const auto cached_it = dict_id_cache_.find(str);
+    if (cached_it != dict_id_cache_.end()) {
+      (*ids)[row] = static_cast<T>(cached_it->second);
+      continue;
+    }
+    const auto it_ok = missing_string_idxs.emplace(str, missing_strings.size());
+    if (it_ok.second) {
+      missing_strings.push_back(str);
+    }
+    missing_rows.emplace_back(row, it_ok.first->second);
+  }
+  if (missing_strings.empty()) {
+    return;
+  }
+  std::vector<T> missing_ids(missing_strings.size());
+  string_dict_->getOrAddBulk(missing_strings, missing_ids.data());
+  for (const auto& [row, missing_idx] : missing_rows) {
+    (*ids)[row] = missing_ids[missing_idx];
+  }
+  for (size_t i = 0; i < missing_strings.size() &&
+                     cached_dict_strings_.size() < kMaxCachedDictStrings;
+       ++i) {
+    cached_dict_strings_.emplace_back(missing_strings[i]);
+    dict_id_cache_.emplace(cached_dict_strings_.back(), missing_ids[i]);
+  }
+}
+
 void TypedImportBuffer::addDictEncodedString(const std::vector<std::string>& string_vec) {
   CHECK(string_dict_);
   std::vector<std::string_view> string_view_vec;
@@ -478,16 +531,13 @@ void TypedImportBuffer::addDictEncodedString(const std::vector<std::string>& str
   }
   switch (column_desc_->columnType.get_size()) {
     case 1:
-      string_dict_i8_buffer_->resize(string_view_vec.size());
-      string_dict_->getOrAddBulk(string_view_vec, string_dict_i8_buffer_->data());
+      getOrAddDictIds(string_view_vec, string_dict_i8_buffer_);
       break;
     case 2:
-      string_dict_i16_buffer_->resize(string_view_vec.size());
-      string_dict_->getOrAddBulk(string_view_vec, string_dict_i16_buffer_->data());
+      getOrAddDictIds(string_view_vec, string_dict_i16_buffer_);
       break;
     case 4:
-      string_dict_i32_buffer_->resize(string_view_vec.size());
-      string_dict_->getOrAddBulk(string_view_vec, string_dict_i32_buffer_->data());
+      getOrAddDictIds(string_view_vec, string_dict_i32_buffer_);
       break;
     default:
       CHECK(false);
@@ -844,6 +894,55 @@ size_t TypedImportBuffer::convert_arrow_val_to_import_buffer(
   return buffer.size();
 }
 
+namespace {
+
+// Appends a slice of a fixed-width Arrow array whose values are those of the column
+// with a single copy, then sets the rows the validity bitmap marks null to the null
+// sentinel of the column, skipping the bytes of the bitmap with no null row.
+template <typename DATA_TYPE>
+size_t append_arrow_fixed_width_values(const Array& array,
+                                       std::vector<DATA_TYPE>& buffer,
+                                       const ArraySliceRange& slice_range,
+                                       const DATA_TYPE null_val) {
+  const auto values = array.data()->GetValues<DATA_TYPE>(1);
+  CHECK(values);
+  const auto begin = buffer.size();
+  buffer.insert(buffer.end(), values + slice_range.first, values + slice_range.second);
+  if (!array.null_count()) {
+    return buffer.size();
+  }
+  const auto validity = array.null_bitmap_data();
+  CHECK(validity);
+  const auto row_count = slice_range.second - slice_range.first;
+  auto slice_values = buffer.data() + begin;
+  // the validity bits are offset by the offset of the array into its buffers
+  size_t bit = array.offset() + slice_range.first;
+  size_t row = 0;
+  const auto set_null_if_not_valid = [&]() {
+    if (!((validity[bit / 8] >> (bit % 8)) & 1)) {
+      slice_values[row] = null_val;
+    }
+  };
+  for (; row < row_count && bit % 8; ++row, ++bit) {
+    set_null_if_not_valid();
+  }
+  for (; row + 8 <= row_count; row += 8, bit += 8) {
+    const uint8_t valid_bits = validity[bit / 8];
+    if (valid_bits == 0xFF) {
+      continue;
+    }
+    for (size_t i = 0; i < 8; ++i) {
+      slice_values[row + i] = (valid_bits >> i) & 1 ? slice_values[row + i] : null_val;
+    }
+  }
+  for (; row < row_count; ++row, ++bit) {
+    set_null_if_not_valid();
+  }
+  return buffer.size();
+}
+
+}  // namespace
+
 size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
                                            const Array& col,
                                            const bool exact_type_match,
@@ -865,18 +964,33 @@ size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
     case kTINYINT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT8, "Expected int8 type");
+        return append_arrow_fixed_width_values(
+            col,
+            *tinyint_buffer_,
+            slice_range,
+            static_cast<int8_t>(inline_fixed_encoding_null_val(cd->columnType)));
       }
       return convert_arrow_val_to_import_buffer(
           cd, col, *tinyint_buffer_, slice_range, bad_rows_tracker);
     case kSMALLINT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT16, "Expected int16 type");
+        return append_arrow_fixed_width_values(
+            col,
+            *smallint_buffer_,
+            slice_range,
+            static_cast<int16_t>(inline_fixed_encoding_null_val(cd->columnType)));
       }
       return convert_arrow_val_to_import_buffer(
           cd, col, *smallint_buffer_, slice_range, bad_rows_tracker);
     case kINT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT32, "Expected int32 type");
+        return append_arrow_fixed_width_values(
+            col,
+            *int_buffer_,
+            slice_range,
+            static_cast<int32_t>(inline_fixed_encoding_null_val(cd->columnType)));
       }
       return convert_arrow_val_to_import_buffer(
           cd, col, *int_buffer_, slice_range, bad_rows_tracker);
@@ -885,18 +999,33 @@ size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
     case kDECIMAL:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT64, "Expected int64 type");
+        return append_arrow_fixed_width_values(
+            col,
+            *bigint_buffer_,
+            slice_range,
+            static_cast<int64_t>(inline_fixed_encoding_null_val(cd->columnType)));
       }
       return convert_arrow_val_to_import_buffer(
           cd, col, *bigint_buffer_, slice_range, bad_rows_tracker);
     case kFLOAT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::FLOAT, "Expected float type");
+        return append_arrow_fixed_width_values(
+            col,
+            *float_buffer_,
+            slice_range,
+            static_cast<float>(inline_fp_null_val(cd->columnType)));
       }
       return convert_arrow_val_to_import_buffer(
           cd, col, *float_buffer_, slice_range, bad_rows_tracker);
     case kDOUBLE:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::DOUBLE, "Expected double type");
+        return append_arrow_fixed_width_values(
+            col,
+            *double_buffer_,
+            slice_range,
+            static_cast<double>(inline_fp_null_val(cd->columnType)));
       }
       return convert_arrow_val_to_import_buffer(
           cd, col, *double_buffer_, slice_range, bad_rows_tracker);
@@ -1790,11 +1919,118 @@ int64_t explode_collections_step2(
   return us;
 }
 
+// Loads the import buffers the parsing threads of a delimited import filled on a thread
+// of its own, for the threads to parse their next rows into other buffers meanwhile.
+// The buffers are taken from a pool and returned to it once loaded, the threads wait
+// when `max_pending` of them are queued for loading.
+class ImportBufferWriter {
+ public:
+  ImportBufferWriter(Importer* importer,
+                     const size_t buffer_set_count,
+                     const size_t max_pending)
+      : importer_(importer), max_pending_(max_pending) {
+    for (size_t i = 0; i < buffer_set_count; ++i) {
+      free_buffer_sets_.push(i);
+    }
+    writer_ = std::thread([this] { run(); });
+  }
+
+  ~ImportBufferWriter() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    cv_.notify_all();
+    writer_.join();
+  }
+
+  // The id of a set of import buffers not being filled or loaded, waits for one.
+  size_t acquireBufferSet() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !free_buffer_sets_.empty(); });
+    const auto buffer_set_id = free_buffer_sets_.top();
+    free_buffer_sets_.pop();
+    return buffer_set_id;
+  }
+
+  void enqueue(const size_t buffer_set_id, const size_t row_count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!row_count) {
+      free_buffer_sets_.push(buffer_set_id);
+      cv_.notify_all();
+      return;
+    }
+    cv_.wait(lock, [this] { return pending_.size() < max_pending_; });
+    pending_.emplace_back(buffer_set_id, row_count);
+    cv_.notify_all();
+  }
+
+  // Waits for the queued loads and rethrows the exception of a failed one.
+  void finish() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pending_.empty() && !loading_; });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+  bool failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_ != nullptr;
+  }
+
+  int64_t loadMs() const { return load_ms_; }
+
+ private:
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return done_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      const auto [buffer_set_id, row_count] = pending_.front();
+      pending_.pop_front();
+      loading_ = true;
+      cv_.notify_all();
+      lock.unlock();
+      // the loads after a failed one are skipped, the import is rolled back
+      if (!failed()) {
+        try {
+          load_ms_ += measure<>::execution([&] {
+            importer_->load(importer_->get_import_buffers(buffer_set_id), row_count);
+          });
+        } catch (...) {
+          std::lock_guard<std::mutex> error_lock(mutex_);
+          error_ = std::current_exception();
+        }
+      }
+      lock.lock();
+      loading_ = false;
+      free_buffer_sets_.push(buffer_set_id);
+      cv_.notify_all();
+    }
+  }
+
+  Importer* importer_;
+  const size_t max_pending_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::stack<size_t> free_buffer_sets_;
+  std::deque<std::pair<size_t, size_t>> pending_;
+  bool loading_{false};
+  bool done_{false};
+  std::exception_ptr error_;
+  std::atomic<int64_t> load_ms_{0};
+  std::thread writer_;
+};
+
 }  // namespace
 
 static ImportStatus import_thread_delimited(
     int thread_id,
     Importer* importer,
+    ImportBufferWriter* writer,
     std::unique_ptr<char[]> scratch_buffer,
     size_t begin_pos,
     size_t end_pos,
@@ -2096,11 +2332,19 @@ static ImportStatus import_thread_delimited(
       }
       total_str_to_val_time_us += us;
     }  // end thread
-    if (import_status.rows_completed > 0) {
+    if (writer) {
+      // the writer loads the buffers, waiting for it to catch up isn't parsing either
+      load_ms = measure<>::execution(
+          [&]() { writer->enqueue(thread_id, import_status.rows_completed); });
+    } else if (import_status.rows_completed > 0) {
       load_ms = measure<>::execution(
           [&]() { importer->load(import_buffers, import_status.rows_completed); });
     }
   });
+  import_status.parse_ms = ms - load_ms;
+  if (!writer) {
+    import_status.load_ms = load_ms;
+  }
   if (DEBUG_TIMING && import_status.rows_completed > 0) {
     LOG(INFO) << "Thread" << std::this_thread::get_id() << ":"
               << import_status.rows_completed << " rows inserted in "
@@ -2542,6 +2786,130 @@ double double_value_at(const TypedImportBuffer& import_buffer, const size_t inde
   return reinterpret_cast<const double*>(may_alias_ptr(values_buffer))[index];
 }
 
+void copy_row(TypedImportBuffer& output_buffer,
+              const TypedImportBuffer& input_buffer,
+              const size_t row_index) {
+  const auto& col_ti = input_buffer.getTypeInfo();
+  const auto type = col_ti.is_decimal() ? decimal_to_int_type(col_ti) : col_ti.get_type();
+  switch (type) {
+    case kBOOLEAN:
+      output_buffer.addBoolean(int_value_at(input_buffer, row_index));
+      break;
+    case kTINYINT:
+      output_buffer.addTinyint(int_value_at(input_buffer, row_index));
+      break;
+    case kSMALLINT:
+      output_buffer.addSmallint(int_value_at(input_buffer, row_index));
+      break;
+    case kINT:
+      output_buffer.addInt(int_value_at(input_buffer, row_index));
+      break;
+    case kBIGINT:
+      output_buffer.addBigint(int_value_at(input_buffer, row_index));
+      break;
+    case kFLOAT:
+      output_buffer.addFloat(float_value_at(input_buffer, row_index));
+      break;
+    case kDOUBLE:
+      output_buffer.addDouble(double_value_at(input_buffer, row_index));
+      break;
+    case kTEXT:
+    case kVARCHAR:
+    case kCHAR: {
+      CHECK_LT(row_index, input_buffer.getStringBuffer()->size());
+      output_buffer.addString((*input_buffer.getStringBuffer())[row_index]);
+      break;
+    }
+    case kTIME:
+    case kTIMESTAMP:
+    case kDATE:
+      output_buffer.addBigint(int_value_at(input_buffer, row_index));
+      break;
+    case kARRAY:
+      if (IS_STRING(col_ti.get_subtype())) {
+        CHECK(input_buffer.getStringArrayBuffer());
+        CHECK_LT(row_index, input_buffer.getStringArrayBuffer()->size());
+        const auto& input_arr = (*(input_buffer.getStringArrayBuffer()))[row_index];
+        output_buffer.addStringArray(input_arr);
+      } else {
+        output_buffer.addArray((*input_buffer.getArrayBuffer())[row_index]);
+      }
+      break;
+    case kPOINT:
+    case kLINESTRING:
+    case kPOLYGON:
+    case kMULTIPOLYGON: {
+      CHECK_LT(row_index, input_buffer.getGeoStringBuffer()->size());
+      output_buffer.addGeoString((*input_buffer.getGeoStringBuffer())[row_index]);
+      break;
+    }
+    default:
+      CHECK(false);
+  }
+}
+
+// A key as stored in a chunk or in the dictionary ids of an import buffer, nullopt if
+// it is null. Dates stored in days are returned in seconds, as the import buffers hold
+// them.
+std::optional<int64_t> get_stored_key(const int8_t* data,
+                                      const size_t index,
+                                      const SQLTypeInfo& ti) {
+  int64_t key{0};
+  switch (ti.get_size()) {
+    case 1:
+      key = ti.is_string() ? int64_t(reinterpret_cast<const uint8_t*>(data)[index])
+                           : int64_t(data[index]);
+      break;
+    case 2:
+      key = ti.is_string() ? int64_t(reinterpret_cast<const uint16_t*>(data)[index])
+                           : int64_t(reinterpret_cast<const int16_t*>(data)[index]);
+      break;
+    case 4:
+      key = reinterpret_cast<const int32_t*>(data)[index];
+      break;
+    case 8:
+      key = reinterpret_cast<const int64_t*>(data)[index];
+      break;
+    default:
+      LOG(FATAL) << "Unexpected size for upsert key: " << ti.get_size();
+  }
+  if (key == inline_fixed_encoding_null_val(ti)) {
+    return std::nullopt;
+  }
+  return ti.is_date_in_days() ? DateConverters::get_epoch_seconds_from_days(key) : key;
+}
+
+std::optional<int64_t> get_import_key(const TypedImportBuffer& import_buffer,
+                                      const size_t index) {
+  const auto& ti = import_buffer.getTypeInfo();
+  if (ti.is_string()) {
+    return get_stored_key(import_buffer.getStringDictBuffer(), index, ti);
+  }
+  const auto key = int_value_at(import_buffer, index);
+  if (key == inline_fixed_encoding_null_val(ti)) {
+    return std::nullopt;
+  }
+  return key;
+}
+
+// The value of a fixed width column, as UPDATE hands them to the fragmenter.
+ScalarTargetValue get_update_value(const TypedImportBuffer& import_buffer,
+                                   const size_t index) {
+  const auto& ti = import_buffer.getTypeInfo();
+  if (ti.is_string()) {
+    CHECK_LT(index, import_buffer.getStringBuffer()->size());
+    return NullableString((*import_buffer.getStringBuffer())[index]);
+  }
+  if (ti.get_type() == kFLOAT) {
+    return float_value_at(import_buffer, index);
+  }
+  if (ti.get_type() == kDOUBLE) {
+    return double_value_at(import_buffer, index);
+  }
+  const auto value = int_value_at(import_buffer, index);
+  return value == inline_fixed_encoding_null_val(ti) ? inline_int_null_val(ti) : value;
+}
+
 }  // namespace
 
 void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_buffers,
@@ -2602,9 +2970,6 @@ void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_b
 
     for (size_t col_idx = 0; col_idx < import_buffers.size(); ++col_idx) {
       const auto& input_buffer = import_buffers[col_idx];
-      const auto& col_ti = input_buffer->getTypeInfo();
-      const auto type =
-          col_ti.is_decimal() ? decimal_to_int_type(col_ti) : col_ti.get_type();
 
       // for a replicated (added) column, populate rows_per_shard as per-shard replicate
       // count. and, bypass non-replicated column.
@@ -2617,71 +2982,7 @@ void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_b
         }
       }
 
-      switch (type) {
-        case kBOOLEAN:
-          shard_output_buffers[col_idx]->addBoolean(
-              int_value_at(*input_buffer, row_index));
-          break;
-        case kTINYINT:
-          shard_output_buffers[col_idx]->addTinyint(
-              int_value_at(*input_buffer, row_index));
-          break;
-        case kSMALLINT:
-          shard_output_buffers[col_idx]->addSmallint(
-              int_value_at(*input_buffer, row_index));
-          break;
-        case kINT:
-          shard_output_buffers[col_idx]->addInt(int_value_at(*input_buffer, row_index));
-          break;
-        case kBIGINT:
-          shard_output_buffers[col_idx]->addBigint(
-              int_value_at(*input_buffer, row_index));
-          break;
-        case kFLOAT:
-          shard_output_buffers[col_idx]->addFloat(
-              float_value_at(*input_buffer, row_index));
-          break;
-        case kDOUBLE:
-          shard_output_buffers[col_idx]->addDouble(
-              double_value_at(*input_buffer, row_index));
-          break;
-        case kTEXT:
-        case kVARCHAR:
-        case kCHAR: {
-          CHECK_LT(row_index, input_buffer->getStringBuffer()->size());
-          shard_output_buffers[col_idx]->addString(
-              (*input_buffer->getStringBuffer())[row_index]);
-          break;
-        }
-        case kTIME:
-        case kTIMESTAMP:
-        case kDATE:
-          shard_output_buffers[col_idx]->addBigint(
-              int_value_at(*input_buffer, row_index));
-          break;
-        case kARRAY:
-          if (IS_STRING(col_ti.get_subtype())) {
-            CHECK(input_buffer->getStringArrayBuffer());
-            CHECK_LT(row_index, input_buffer->getStringArrayBuffer()->size());
-            const auto& input_arr = (*(input_buffer->getStringArrayBuffer()))[row_index];
-            shard_output_buffers[col_idx]->addStringArray(input_arr);
-          } else {
-            shard_output_buffers[col_idx]->addArray(
-                (*input_buffer->getArrayBuffer())[row_index]);
-          }
-          break;
-        case kPOINT:
-        case kLINESTRING:
-        case kPOLYGON:
-        case kMULTIPOLYGON: {
-          CHECK_LT(row_index, input_buffer->getGeoStringBuffer()->size());
-          shard_output_buffers[col_idx]->addGeoString(
-              (*input_buffer->getGeoStringBuffer())[row_index]);
-          break;
-        }
-        default:
-          CHECK(false);
-      }
+      copy_row(*shard_output_buffers[col_idx], *input_buffer, row_index);
     }
     ++all_shard_row_counts[shard];
     // when replicating a column, row count of a shard == replicate count of the column on
@@ -2700,6 +3001,9 @@ bool Loader::loadImpl(
     auto data_blocks = get_data_block_pointers(import_buffers);
     return load_callback_(import_buffers, data_blocks, row_count);
   }
+  if (upsert_key_cd_) {
+    return upsert(import_buffers, row_count, checkpoint);
+  }
   if (table_desc_->nShards) {
     std::vector<OneShardBuffers> all_shard_import_buffers;
     std::vector<size_t> all_shard_row_counts;
@@ -2827,6 +3131,203 @@ bool Loader::loadToShard(
   return success;
 }
 
+void Loader::setUpsertKey(const std::string& column_name) {
+  const auto cd = catalog_.getMetadataForColumn(table_desc_->tableId, column_name);
+  if (!cd) {
+    throw std::runtime_error("Upsert key " + column_name + " is not a column of table " +
+                             table_desc_->tableName);
+  }
+  const auto& ti = cd->columnType;
+  if (!ti.is_integer() && !ti.is_time() &&
+      !(ti.is_string() && ti.get_compression() == kENCODING_DICT)) {
+    throw std::runtime_error(
+        "Upsert key " + column_name +
+        " must be an integer, time or dictionary encoded string column");
+  }
+  // the rows of the keys found are deleted when they can't be updated in place
+  if (table_desc_->nShards || load_callback_ || !catalog_.getDeletedColumn(table_desc_)) {
+    throw std::runtime_error("Upserts into table " + table_desc_->tableName +
+                             " are not supported");
+  }
+  upsert_key_cd_ = cd;
+}
+
+/**
+ * Indexes the keys of the rows appended to the table since the last batch, reading only
+ * the tail of the fragments which grew. Deleted rows and null keys aren't indexed.
+ */
+void Loader::indexUpsertKeys() {
+  const auto deleted_cd = catalog_.getDeletedColumnIfRowsDeleted(table_desc_);
+  const auto table_info = table_desc_->fragmenter->getFragmentsForQuery();
+  for (const auto& fragment : table_info.fragments) {
+    auto& indexed_row_count = upsert_indexed_row_counts_[fragment.fragmentId];
+    const size_t row_count = fragment.getNumTuples();
+    if (row_count <= indexed_row_count) {
+      continue;
+    }
+    auto get_chunk = [this, &fragment](const ColumnDescriptor* cd) {
+      const auto& chunk_metadata = fragment.getChunkMetadataMapPhysical();
+      const auto chunk_meta_it = chunk_metadata.find(cd->columnId);
+      CHECK(chunk_meta_it != chunk_metadata.end());
+      ChunkKey chunk_key{catalog_.getCurrentDB().dbId,
+                         table_desc_->tableId,
+                         cd->columnId,
+                         fragment.fragmentId};
+      return Chunk_NS::Chunk::getChunk(cd,
+                                       &catalog_.getDataMgr(),
+                                       chunk_key,
+                                       Data_Namespace::CPU_LEVEL,
+                                       0,
+                                       chunk_meta_it->second->numBytes,
+                                       chunk_meta_it->second->numElements);
+    };
+    const auto key_chunk = get_chunk(upsert_key_cd_);
+    const auto key_data = key_chunk->getBuffer()->getMemoryPtr();
+    const auto deleted_chunk = deleted_cd ? get_chunk(deleted_cd) : nullptr;
+    const auto deleted_data =
+        deleted_chunk ? deleted_chunk->getBuffer()->getMemoryPtr() : nullptr;
+    for (size_t offset = indexed_row_count; offset < row_count; ++offset) {
+      if (deleted_data && deleted_data[offset]) {
+        continue;
+      }
+      if (const auto key = get_stored_key(key_data, offset, upsert_key_cd_->columnType)) {
+        upsert_key_rows_[*key] = {fragment.fragmentId, offset};
+      }
+    }
+    indexed_row_count = row_count;
+  }
+}
+
+/**
+ * Rows whose key is in the table overwrite the fixed width columns of that row in place,
+ * the other rows are appended. Tables with variable length columns delete the rows of
+ * the keys found instead and append all the rows, as UPDATE does for these columns. The
+ * last row of a key in a batch wins, rows with a null key are always appended.
+ */
+bool Loader::upsert(const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+                    size_t row_count,
+                    bool checkpoint) {
+  std::lock_guard<std::mutex> upsert_lock(upsert_mutex_);
+  indexUpsertKeys();
+
+  size_t key_col_idx{0};
+  bool in_place{true};
+  size_t col_idx{0};
+  for (const auto cd : column_descs_) {
+    if (cd == upsert_key_cd_) {
+      key_col_idx = col_idx;
+    }
+    if (!cd->isDeletedCol && cd->columnType.is_varlen()) {
+      in_place = false;
+    }
+    ++col_idx;
+  }
+  CHECK_LT(key_col_idx, import_buffers.size());
+  auto& key_buffer = *import_buffers[key_col_idx];
+  CHECK_EQ(key_buffer.getColumnDesc(), upsert_key_cd_);
+  if (upsert_key_cd_->columnType.is_string()) {
+    CHECK(key_buffer.getStringBuffer());
+    key_buffer.addDictEncodedString(*key_buffer.getStringBuffer());
+  }
+
+  std::unordered_map<int64_t, size_t> last_row_of_key;
+  for (size_t row = 0; row < row_count; ++row) {
+    if (const auto key = get_import_key(key_buffer, row)) {
+      last_row_of_key[*key] = row;
+    }
+  }
+  // the rows of each fragment to update, with their offsets in the fragment
+  std::map<int, std::vector<std::pair<size_t, uint64_t>>> fragment_updates;
+  std::vector<size_t> appended_rows;
+  for (size_t row = 0; row < row_count; ++row) {
+    const auto key = get_import_key(key_buffer, row);
+    if (!key) {
+      appended_rows.push_back(row);
+      continue;
+    }
+    if (last_row_of_key[*key] != row) {
+      continue;
+    }
+    const auto key_row_it = upsert_key_rows_.find(*key);
+    if (key_row_it == upsert_key_rows_.end()) {
+      appended_rows.push_back(row);
+      continue;
+    }
+    fragment_updates[key_row_it->second.first].emplace_back(row,
+                                                            key_row_it->second.second);
+    if (!in_place) {
+      appended_rows.push_back(row);
+      upsert_key_rows_.erase(key_row_it);
+    }
+  }
+
+  if (!fragment_updates.empty()) {
+    const auto deleted_cd = catalog_.getDeletedColumn(table_desc_);
+    UpdelRoll updel_roll;
+    try {
+      for (const auto& [fragment_id, rows] : fragment_updates) {
+        std::vector<uint64_t> frag_offsets;
+        for (const auto& row : rows) {
+          frag_offsets.push_back(row.second);
+        }
+        if (!in_place) {
+          table_desc_->fragmenter->updateColumn(&catalog_,
+                                                table_desc_,
+                                                deleted_cd,
+                                                fragment_id,
+                                                frag_offsets,
+                                                ScalarTargetValue(int64_t(1)),
+                                                deleted_cd->columnType,
+                                                Data_Namespace::CPU_LEVEL,
+                                                updel_roll);
+          continue;
+        }
+        col_idx = 0;
+        for (const auto cd : column_descs_) {
+          const auto& import_buffer = *import_buffers[col_idx++];
+          if (cd == upsert_key_cd_ || cd->isDeletedCol) {
+            continue;
+          }
+          std::vector<ScalarTargetValue> values;
+          values.reserve(rows.size());
+          for (const auto& row : rows) {
+            values.push_back(get_update_value(import_buffer, row.first));
+          }
+          table_desc_->fragmenter->updateColumn(&catalog_,
+                                                table_desc_,
+                                                cd,
+                                                fragment_id,
+                                                frag_offsets,
+                                                values,
+                                                cd->columnType,
+                                                Data_Namespace::CPU_LEVEL,
+                                                updel_roll);
+        }
+      }
+      updel_roll.commitUpdate();
+    } catch (std::exception& e) {
+      LOG(ERROR) << "Upsert Exception: " << e.what();
+      return false;
+    }
+  }
+
+  if (appended_rows.empty()) {
+    return true;
+  }
+  if (appended_rows.size() == row_count) {
+    return loadToShard(import_buffers, row_count, table_desc_, checkpoint);
+  }
+  OneShardBuffers appended_buffers;
+  for (const auto& import_buffer : import_buffers) {
+    appended_buffers.emplace_back(new TypedImportBuffer(
+        import_buffer->getColumnDesc(), import_buffer->getStringDictionary()));
+    for (const auto row : appended_rows) {
+      copy_row(*appended_buffers.back(), *import_buffer, row);
+    }
+  }
+  return loadToShard(appended_buffers, appended_rows.size(), table_desc_, checkpoint);
+}
+
 void Loader::dropColumns(const std::vector<int>& columnIds) {
   std::vector<const TableDescriptor*> table_descs(1, table_desc_);
   if (table_desc_->nShards) {
@@ -3334,20 +3835,22 @@ ImportStatus DataStreamSink::archivePlumber() {
 }
 
 #ifdef ENABLE_IMPORT_PARQUET
+// Opens the file and reads its schema from the footer, the row groups are read one by
+// one by the callers.
 inline auto open_parquet_table(const std::string& file_path,
                                std::shared_ptr<arrow::io::ReadableFile>& infile,
                                std::unique_ptr<parquet::arrow::FileReader>& reader,
-                               std::shared_ptr<arrow::Table>& table) {
+                               std::shared_ptr<arrow::Schema>& schema) {
   using namespace parquet::arrow;
   auto file_result = arrow::io::ReadableFile::Open(file_path);
   PARQUET_THROW_NOT_OK(file_result.status());
   infile = file_result.ValueOrDie();
 
   PARQUET_THROW_NOT_OK(OpenFile(infile, arrow::default_memory_pool(), &reader));
-  PARQUET_THROW_NOT_OK(reader->ReadTable(&table));
+  PARQUET_THROW_NOT_OK(reader->GetSchema(&schema));
   const auto num_row_groups = reader->num_row_groups();
-  const auto num_columns = table->num_columns();
-  const auto num_rows = table->num_rows();
+  const auto num_columns = schema->num_fields();
+  const auto num_rows = reader->parquet_reader()->metadata()->num_rows();
   LOG(INFO) << "File " << file_path << " has " << num_rows << " rows and " << num_columns
             << " columns in " << num_row_groups << " groups.";
   return std::make_tuple(num_row_groups, num_columns, num_rows);
@@ -3356,11 +3859,11 @@ inline auto open_parquet_table(const std::string& file_path,
 void Detector::import_local_parquet(const std::string& file_path) {
   std::shared_ptr<arrow::io::ReadableFile> infile;
   std::unique_ptr<parquet::arrow::FileReader> reader;
-  std::shared_ptr<arrow::Table> table;
+  std::shared_ptr<arrow::Schema> schema;
   int num_row_groups, num_columns;
   int64_t num_rows;
   std::tie(num_row_groups, num_columns, num_rows) =
-      open_parquet_table(file_path, infile, reader, table);
+      open_parquet_table(file_path, infile, reader, schema);
   // make up header line if not yet
   if (0 == raw_data.size()) {
     copy_params.has_header = ImportHeaderRow::HAS_HEADER;
@@ -3374,7 +3877,7 @@ void Detector::import_local_parquet(const std::string& file_path) {
       if (c) {
         raw_data += copy_params.delimiter;
       }
-      raw_data += table->ColumnNames().at(c);
+      raw_data += schema->field(c)->name();
     }
     raw_data += copy_params.line_delim;
   }
@@ -3472,11 +3975,11 @@ auto TypedImportBuffer::del_values(const SQLTypes type,
 void Importer::import_local_parquet(const std::string& file_path) {
   std::shared_ptr<arrow::io::ReadableFile> infile;
   std::unique_ptr<parquet::arrow::FileReader> reader;
-  std::shared_ptr<arrow::Table> table;
+  std::shared_ptr<arrow::Schema> schema;
   int num_row_groups, num_columns;
   int64_t nrow_in_file;
   std::tie(num_row_groups, num_columns, nrow_in_file) =
-      open_parquet_table(file_path, infile, reader, table);
+      open_parquet_table(file_path, infile, reader, schema);
   // column_list has no $deleted
   const auto& column_list = get_column_descs();
   // for now geo columns expect a wkt or wkb hex string
@@ -3506,9 +4009,26 @@ void Importer::import_local_parquet(const std::string& file_path) {
     }
     return physical_col_idx;
   };
+  // the columns of a row group are decoded in parallel by the arrow thread pool, and the
+  // next row group is decoded while the current one is converted and loaded
+  reader->set_use_threads(true);
+  const auto read_row_group = [&reader](const int row_group) {
+    std::shared_ptr<arrow::Table> row_group_table;
+    PARQUET_THROW_NOT_OK(reader->ReadRowGroup(row_group, &row_group_table));
+    return row_group_table;
+  };
   // load a file = nested iteration of row groups, row slices and logical columns
   auto ms_load_a_file = measure<>::execution([&]() {
+    std::future<std::shared_ptr<arrow::Table>> next_row_group_table;
+    if (num_row_groups) {
+      next_row_group_table = std::async(std::launch::async, read_row_group, 0);
+    }
     for (int row_group = 0; row_group < num_row_groups && !load_failed; ++row_group) {
+      const auto row_group_table = next_row_group_table.get();
+      if (row_group + 1 < num_row_groups) {
+        next_row_group_table =
+            std::async(std::launch::async, read_row_group, row_group + 1);
+      }
       // a sliced row group will be handled like a (logic) parquet file, with
       // a entirely clean set of bad_rows_tracker, import_buffers_vec, ... etc
       import_buffers_vec.resize(num_slices);
@@ -3535,22 +4055,20 @@ void Importer::import_local_parquet(const std::string& file_path) {
         bad_rows_tracker.row_group = slice;
         bad_rows_tracker.importer = this;
       }
-      // process arrow arrays to import buffers
-      for (int logic_col_idx = 0; logic_col_idx < num_columns; ++logic_col_idx) {
-        const auto physical_col_idx = get_physical_col_idx(logic_col_idx);
-        const auto cd = cds[physical_col_idx];
-        std::shared_ptr<arrow::ChunkedArray> array;
-        PARQUET_THROW_NOT_OK(
-            reader->RowGroup(row_group)->Column(logic_col_idx)->Read(&array));
-        const size_t array_size = array->length();
-        const size_t slice_size = (array_size + num_slices - 1) / num_slices;
-        ThreadController_NS::SimpleThreadController<void> thread_controller(num_slices);
-        for (int slice = 0; slice < num_slices; ++slice) {
-          thread_controller.startThread([&, slice] {
-            const auto slice_offset = slice % num_slices;
+      // process arrow arrays to import buffers, each slice of all the columns on its
+      // own thread
+      ThreadController_NS::SimpleThreadController<void> thread_controller(num_slices);
+      for (int slice = 0; slice < num_slices; ++slice) {
+        thread_controller.startThread([&, slice] {
+          for (int logic_col_idx = 0; logic_col_idx < num_columns; ++logic_col_idx) {
+            const auto physical_col_idx = get_physical_col_idx(logic_col_idx);
+            const auto cd = cds[physical_col_idx];
+            const auto array = row_group_table->column(logic_col_idx);
+            const size_t array_size = array->length();
+            const size_t slice_size = (array_size + num_slices - 1) / num_slices;
             ArraySliceRange slice_range(
-                std::min<size_t>((slice_offset + 0) * slice_size, array_size),
-                std::min<size_t>((slice_offset + 1) * slice_size, array_size));
+                std::min<size_t>((slice + 0) * slice_size, array_size),
+                std::min<size_t>((slice + 1) * slice_size, array_size));
             auto& bad_rows_tracker = bad_rows_trackers[slice];
             auto& import_buffer = import_buffers_vec[slice][physical_col_idx];
             import_buffer->import_buffers = &import_buffers_vec[slice];
@@ -3559,10 +4077,10 @@ void Importer::import_local_parquet(const std::string& file_path) {
               import_buffer->add_arrow_values(
                   cd, *chunk, false, slice_range, &bad_rows_tracker);
             }
-          });
-        }
-        thread_controller.finish();
+          }
+        });
       }
+      thread_controller.finish();
       std::vector<size_t> nrow_in_slice_raw(num_slices);
       std::vector<size_t> nrow_in_slice_successfully_loaded(num_slices);
       // trim bad rows from import buffers
@@ -3979,7 +4497,10 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
     alloc_size = file_size;
   }
 
-  for (size_t i = 0; i < max_threads; i++) {
+  // a thread parses into the next set of buffers while the writer loads its last one
+  const size_t buffer_set_count =
+      g_enable_pipelined_import ? 2 * max_threads : max_threads;
+  for (size_t i = 0; i < buffer_set_count; i++) {
     import_buffers_vec.emplace_back();
     for (const auto cd : loader->get_column_descs()) {
       import_buffers_vec[i].emplace_back(
@@ -4015,6 +4536,11 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
                        loader->getTableDesc()->tableId};
   auto table_epochs = loader->getTableEpochs();
   {
+    // outlives the parsing threads, which may be waiting for it to load their buffers
+    std::unique_ptr<ImportBufferWriter> writer;
+    if (g_enable_pipelined_import) {
+      writer = std::make_unique<ImportBufferWriter>(this, buffer_set_count, max_threads);
+    }
     std::list<std::future<ImportStatus>> threads;
 
     // use a stack to track thread_ids which must not overlap among threads
@@ -4045,15 +4571,21 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
         memcpy(unbuf.get(), scratch_buffer.get() + end_pos, nresidual);
       }
 
-      // get a thread_id not in use
-      auto thread_id = stack_thread_ids.top();
-      stack_thread_ids.pop();
+      // get a thread_id not in use, the id of a free buffer set with the writer
+      size_t thread_id;
+      if (writer) {
+        thread_id = writer->acquireBufferSet();
+      } else {
+        thread_id = stack_thread_ids.top();
+        stack_thread_ids.pop();
+      }
       // LOG(INFO) << " stack_thread_ids.pop " << thread_id << std::endl;
 
       threads.push_back(std::async(std::launch::async,
                                    import_thread_delimited,
                                    thread_id,
                                    this,
+                                   writer.get(),
                                    std::move(scratch_buffer),
                                    begin_pos,
                                    end_pos,
@@ -4082,6 +4614,9 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
           if (p.wait_for(span) == std::future_status::ready) {
             auto ret_import_status = p.get();
             import_status += ret_import_status;
+            if (writer) {
+              import_status.load_ms = writer->loadMs();
+            }
             // sum up current total file offsets
             size_t total_file_offset{0};
             if (decompressed) {
@@ -4102,8 +4637,10 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
                     << ", total_file_size " << total_file_size << ", total_file_offset "
                     << total_file_offset;
             set_import_status(import_id, import_status);
-            // recall thread_id for reuse
-            stack_thread_ids.push(ret_import_status.thread_id);
+            // recall thread_id for reuse, the writer frees the buffer sets it loaded
+            if (!writer) {
+              stack_thread_ids.push(ret_import_status.thread_id);
+            }
             threads.erase(it++);
             ++nready;
           } else {
@@ -4133,7 +4670,7 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
         LOG(ERROR) << "Maximum rows rejected exceeded. Halting load";
         break;
       }
-      if (load_failed) {
+      if (load_failed || (writer && writer->failed())) {
         load_truncated = true;
         LOG(ERROR) << "A call to the Loader::load failed, Please review the logs for "
                       "more details";
@@ -4145,6 +4682,11 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
     for (auto& p : threads) {
       p.wait();
     }
+    if (writer) {
+      writer->finish();
+      import_status.load_ms = writer->loadMs();
+      set_import_status(import_id, import_status);
+    }
   }
 
   checkpoint(table_epochs);
@@ -4809,6 +5351,37 @@ ImportStatus Importer::importGDAL(
   }
 
 #if !DISABLE_MULTI_THREADED_SHAPEFILE_IMPORT
+  // when the driver seeks to a feature index cheaply (shapefiles, geopackages), each
+  // thread reads the features of its chunk from its own handle of the dataset rather
+  // than this thread reading them all
+  std::vector<OGRDataSourceUqPtr> thread_datasets;
+  if (max_threads > 1 && layer.TestCapability(OLCFastSetNextByIndex)) {
+    for (size_t i = 0; i < max_threads; i++) {
+      OGRDataSourceUqPtr thread_dataset(openGDALDataset(file_path, copy_params));
+      if (thread_dataset == nullptr) {
+        LOG(WARNING) << "Reading the features of " << file_path << " on one thread";
+        thread_datasets.clear();
+        break;
+      }
+      thread_datasets.push_back(std::move(thread_dataset));
+    }
+  }
+  const auto read_features = [this](const OGRDataSourceUqPtr& dataset,
+                                    const size_t first_feature,
+                                    const size_t num_features) {
+    auto& thread_layer =
+        getLayerWithSpecifiedName(copy_params.geo_layer_name, dataset, file_path);
+    if (thread_layer.SetNextByIndex(first_feature) != OGRERR_NONE) {
+      throw std::runtime_error("Failed to seek to feature " +
+                               std::to_string(first_feature) + " of " + file_path);
+    }
+    FeaturePtrVector thread_features;
+    for (size_t i = 0; i < num_features; i++) {
+      thread_features.emplace_back(thread_layer.GetNextFeature());
+    }
+    return thread_features;
+  };
+
   // threads
   std::list<std::future<ImportStatus>> threads;
 
@@ -4848,8 +5421,13 @@ ImportStatus Importer::importGDAL(
 #endif
 
     // fill features buffer for new thread
-    for (size_t i = 0; i < numFeaturesThisChunk; i++) {
-      features[thread_id].emplace_back(layer.GetNextFeature());
+#if !DISABLE_MULTI_THREADED_SHAPEFILE_IMPORT
+    if (thread_datasets.empty())
+#endif
+    {
+      for (size_t i = 0; i < numFeaturesThisChunk; i++) {
+        features[thread_id].emplace_back(layer.GetNextFeature());
+      }
     }
 
 #if DISABLE_MULTI_THREADED_SHAPEFILE_IMPORT
@@ -4869,17 +5447,37 @@ ImportStatus Importer::importGDAL(
     set_import_status(import_id, import_status);
 #else
     // fire up that thread to import this geometry
-    threads.push_back(std::async(std::launch::async,
-                                 import_thread_shapefile,
-                                 thread_id,
-                                 this,
-                                 poGeographicSR.get(),
-                                 std::move(features[thread_id]),
-                                 firstFeatureThisChunk,
-                                 numFeaturesThisChunk,
-                                 fieldNameToIndexMap,
-                                 columnNameToSourceNameMap,
-                                 columnIdToRenderGroupAnalyzerMap));
+    if (!thread_datasets.empty()) {
+      threads.push_back(std::async(
+          std::launch::async,
+          [&, thread_id, firstFeatureThisChunk, numFeaturesThisChunk] {
+            // a thread id is used by one thread at a time, and so is its dataset
+            return import_thread_shapefile(
+                thread_id,
+                this,
+                poGeographicSR.get(),
+                read_features(thread_datasets[thread_id],
+                              firstFeatureThisChunk,
+                              numFeaturesThisChunk),
+                firstFeatureThisChunk,
+                numFeaturesThisChunk,
+                fieldNameToIndexMap,
+                columnNameToSourceNameMap,
+                columnIdToRenderGroupAnalyzerMap);
+          }));
+    } else {
+      threads.push_back(std::async(std::launch::async,
+                                   import_thread_shapefile,
+                                   thread_id,
+                                   this,
+                                   poGeographicSR.get(),
+                                   std::move(features[thread_id]),
+                                   firstFeatureThisChunk,
+                                   numFeaturesThisChunk,
+                                   fieldNameToIndexMap,
+                                   columnNameToSourceNameMap,
+                                   columnIdToRenderGroupAnalyzerMap));
+    }
 
     // let the threads run
     while (threads.size() > 0) {
@@ -32,6 +32,7 @@
 #include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
+#include <deque>
 #include <iostream>
 #include <list>
 #include <map>
@@ -40,6 +41,7 @@
 #include <set>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 
 #include "Catalog/Catalog.h"
@@ -56,6 +58,8 @@
 // Placing in own section to ensure it's included after iostream.
 #include <boost/geometry/index/rtree.hpp>
 
+extern bool g_enable_pipelined_import;
+
 class TDatum;
 class TColumn;
 
@@ -449,6 +453,62 @@ class TypedImportBuffer : boost::noncopyable {
     }
   }
 
+  // Appends the rows of a buffer of the same column, before any string is encoded.
+  void append(const TypedImportBuffer& other) {
+    CHECK_EQ(column_desc_->columnId, other.column_desc_->columnId);
+    const auto append_vector = [](auto* dest, const auto* src) {
+      dest->insert(dest->end(), src->begin(), src->end());
+    };
+    switch (column_desc_->columnType.get_type()) {
+      case kBOOLEAN:
+        append_vector(bool_buffer_, other.bool_buffer_);
+        break;
+      case kTINYINT:
+        append_vector(tinyint_buffer_, other.tinyint_buffer_);
+        break;
+      case kSMALLINT:
+        append_vector(smallint_buffer_, other.smallint_buffer_);
+        break;
+      case kINT:
+        append_vector(int_buffer_, other.int_buffer_);
+        break;
+      case kBIGINT:
+      case kNUMERIC:
+      case kDECIMAL:
+      case kDATE:
+      case kTIME:
+      case kTIMESTAMP:
+        append_vector(bigint_buffer_, other.bigint_buffer_);
+        break;
+      case kFLOAT:
+        append_vector(float_buffer_, other.float_buffer_);
+        break;
+      case kDOUBLE:
+        append_vector(double_buffer_, other.double_buffer_);
+        break;
+      case kTEXT:
+      case kVARCHAR:
+      case kCHAR:
+        append_vector(string_buffer_, other.string_buffer_);
+        break;
+      case kARRAY:
+        if (IS_STRING(column_desc_->columnType.get_subtype())) {
+          append_vector(string_array_buffer_, other.string_array_buffer_);
+        } else {
+          append_vector(array_buffer_, other.array_buffer_);
+        }
+        break;
+      case kPOINT:
+      case kLINESTRING:
+      case kPOLYGON:
+      case kMULTIPOLYGON:
+        append_vector(geo_string_buffer_, other.geo_string_buffer_);
+        break;
+      default:
+        CHECK(false);
+    }
+  }
+
   size_t add_values(const ColumnDescriptor* cd, const TColumn& data);
 
   size_t add_arrow_values(const ColumnDescriptor* cd,
@@ -487,6 +547,11 @@ class TypedImportBuffer : boost::noncopyable {
   size_t col_idx;
 
  private:
+  // Sets `ids` to the dictionary ids of `strings`. Only the distinct strings without an
+  // id cached by the buffer are sent to the dictionary.
+  template <typename T>
+  void getOrAddDictIds(const std::vector<std::string_view>& strings, std::vector<T>* ids);
+
   union {
     std::vector<int8_t>* bool_buffer_;
     std::vector<int8_t>* tinyint_buffer_;
@@ -509,6 +574,10 @@ class TypedImportBuffer : boost::noncopyable {
   const ColumnDescriptor* column_desc_;
   StringDictionary* string_dict_;
   size_t replicate_count_ = 0;
+  // the dictionary ids of strings encoded by the buffer, keyed by views of
+  // cached_dict_strings_, for the next batches of the thread
+  std::unordered_map<std::string_view, int32_t> dict_id_cache_;
+  std::deque<std::string> cached_dict_strings_;
 };
 
 class Loader {
@@ -566,6 +635,10 @@ class Loader {
   bool getReplicating() const { return replicating_; }
   void dropColumns(const std::vector<int>& columns);
 
+  // Loaded rows whose key is already in the table replace that row instead of being
+  // appended. The key is an integer, time or dictionary encoded string column.
+  void setUpsertKey(const std::string& column_name);
+
  protected:
   void init(const bool use_catalog_locks);
 
@@ -595,9 +668,21 @@ class Loader {
                    size_t row_count,
                    const TableDescriptor* shard_table,
                    bool checkpoint);
+  bool upsert(const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
+              size_t row_count,
+              bool checkpoint);
+  void indexUpsertKeys();
 
   bool replicating_ = false;
   std::mutex loader_mutex_;
+
+  const ColumnDescriptor* upsert_key_cd_{nullptr};
+  // fragment id and offset of the row of each key in the table
+  std::unordered_map<int64_t, std::pair<int, uint64_t>> upsert_key_rows_;
+  // rows of each fragment already in upsert_key_rows_, rows are only ever appended
+  std::unordered_map<int, size_t> upsert_indexed_row_counts_;
+  // the batches of an upsert are applied one at a time, each sees the keys of the last
+  std::mutex upsert_mutex_;
 };
 
 struct ImportStatus {
@@ -609,6 +694,10 @@ struct ImportStatus {
   std::chrono::duration<size_t, std::milli> elapsed;
   bool load_truncated;
   int thread_id;  // to recall thread_id after thread exit
+  // time spent parsing the rows into the import buffers and loading the buffers into
+  // the table, summed over the threads
+  int64_t parse_ms;
+  int64_t load_ms;
   ImportStatus()
       : start(std::chrono::steady_clock::now())
       , rows_completed(0)
@@ -616,11 +705,15 @@ struct ImportStatus {
       , rows_rejected(0)
       , elapsed(0)
       , load_truncated(0)
-      , thread_id(0) {}
+      , thread_id(0)
+      , parse_ms(0)
+      , load_ms(0) {}
 
   ImportStatus& operator+=(const ImportStatus& is) {
     rows_completed += is.rows_completed;
     rows_rejected += is.rows_rejected;
+    parse_ms += is.parse_ms;
+    load_ms += is.load_ms;
 
     return *this;
   }
@@ -22,6 +22,7 @@
  *
  **/
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/regex.hpp>
@@ -35,7 +36,9 @@
 #include "Shared/ThriftClient.h"
 #include "Shared/sqltypes.h"
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <thread>
 
 #include <boost/program_options.hpp>
@@ -47,12 +50,17 @@
 bool print_error_data = false;
 bool print_transformation = false;
 
-static bool run = true;
+// shared by the consumers of the group
+static std::atomic<bool> run{true};
 static bool exit_eof = false;
-static int eof_cnt = 0;
-static int partition_cnt = 0;
-static long msg_cnt = 0;
-static int64_t msg_bytes = 0;
+static std::atomic<int> eof_cnt{0};
+static std::atomic<int> partition_cnt{0};
+static std::atomic<long> msg_cnt{0};
+static std::atomic<int64_t> msg_bytes{0};
+
+using Transformation =
+    std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>;
+using Transformations = std::map<std::string, Transformation>;
 
 class RebalanceCb : public RdKafka::RebalanceCb {
  private:
@@ -73,21 +81,27 @@ class RebalanceCb : public RdKafka::RebalanceCb {
 
     if (err == RdKafka::ERR__ASSIGN_PARTITIONS) {
       consumer->assign(partitions);
-      partition_cnt = (int)partitions.size();
+      partition_cnt += (int)partitions.size();
     } else {
+      // the rows of the revoked partitions are loaded and committed while they're still
+      // ours, rather than consumed again by their next owner
+      if (on_revoke) {
+        on_revoke();
+      }
       consumer->unassign();
-      partition_cnt = 0;
+      partition_cnt -= (int)partitions.size();
     }
     eof_cnt = 0;
   }
+
+  std::function<void()> on_revoke;
 };
 
 bool msg_consume(RdKafka::Message* message,
                  RowToColumnLoader& row_loader,
-                 import_export::CopyParams copy_params,
-                 const std::map<std::string,
-                                std::pair<std::unique_ptr<boost::regex>,
-                                          std::unique_ptr<std::string>>>& transformations,
+                 const import_export::CopyParams& copy_params,
+                 const TRowDescriptor& row_desc,
+                 const std::vector<const Transformation*>& xforms,
                  const bool remove_quotes) {
   switch (message->err()) {
     case RdKafka::ERR__TIMED_OUT:
@@ -110,11 +124,12 @@ bool msg_consume(RdKafka::Message* message,
         VLOG(1) << "Timestamp: " << tsname << " " << ts.timestamp << std::endl;
       }
 
-      char buffer[message->len() + 1];
-      sprintf(buffer,
-              "%.*s\n",
-              static_cast<int>(message->len()),
-              static_cast<const char*>(message->payload()));
+      char buffer[message->len() + 2];
+      snprintf(buffer,
+               sizeof(buffer),
+               "%.*s\n",
+               static_cast<int>(message->len()),
+               static_cast<const char*>(message->payload()));
       VLOG(1) << "Full Message received is :'" << buffer << "'";
 
       char field[MAX_FIELD_LEN];
@@ -122,23 +137,11 @@ bool msg_consume(RdKafka::Message* message,
 
       bool backEscape = false;
 
-      auto row_desc = row_loader.get_row_descriptor();
-
-      const std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>*
-          xforms[row_desc.size()];
-      for (size_t i = 0; i < row_desc.size(); i++) {
-        auto it = transformations.find(row_desc[i].col_name);
-        if (it != transformations.end()) {
-          xforms[i] = &(it->second);
-        } else {
-          xforms[i] = nullptr;
-        }
-      }
-
       std::vector<TStringValue>
           row;  // used to store each row as we move through the stream
 
-      for (auto iit : buffer) {
+      for (size_t buffer_i = 0; buffer_i < message->len() + 1; ++buffer_i) {
+        const char iit = buffer[buffer_i];
         if (iit == copy_params.delimiter || iit == copy_params.line_delim) {
           bool end_of_field = (iit == copy_params.delimiter);
           bool end_of_row;
@@ -287,17 +290,16 @@ class EventCb : public RdKafka::EventCb {
   }
 };
 
-// reads from a kafka topic (expects delimited string input)
-void kafka_insert(
-    RowToColumnLoader& row_loader,
-    const std::map<std::string,
-                   std::pair<std::unique_ptr<boost::regex>,
-                             std::unique_ptr<std::string>>>& transformations,
-    const import_export::CopyParams& copy_params,
-    const bool remove_quotes,
-    std::string group_id,
-    std::string topic,
-    std::string brokers) {
+// reads from a kafka topic (expects delimited string input), as one of the consumers of
+// the group: the partitions of the topic are shared among them
+void kafka_insert(RowToColumnLoader& row_loader,
+                  const Transformations& transformations,
+                  const import_export::CopyParams& copy_params,
+                  const bool remove_quotes,
+                  const size_t batch_wait_ms,
+                  std::string group_id,
+                  std::string topic,
+                  std::string brokers) {
   std::string errstr;
   std::string topic_str;
   std::string mode;
@@ -428,23 +430,61 @@ void kafka_insert(
   /*
    * Consume messages
    */
+  const auto row_desc = row_loader.get_row_descriptor();
+  std::vector<const Transformation*> xforms(row_desc.size(), nullptr);
+  for (size_t i = 0; i < row_desc.size(); i++) {
+    auto it = transformations.find(row_desc[i].col_name);
+    if (it != transformations.end()) {
+      xforms[i] = &(it->second);
+    }
+  }
+
   size_t recv_rows = 0;
+  size_t pending_msgs = 0;
   int skipped = 0;
   int rows_loaded = 0;
+  const auto batch_wait = std::chrono::milliseconds(batch_wait_ms);
+  auto batch_start = std::chrono::steady_clock::now();
+  // the offsets are only committed once the rows read up to them are loaded, the rows
+  // of a consumer stopping in between are read again by the group (at least once)
+  const auto load_and_commit = [&]() {
+    if (!pending_msgs) {
+      return;
+    }
+    if (recv_rows) {
+      // exits when the retries are exhausted, without committing
+      row_loader.do_load(rows_loaded, skipped, copy_params);
+    }
+    consumer->commitSync();
+    recv_rows = 0;
+    pending_msgs = 0;
+  };
+  ex_rebalance_cb.on_revoke = load_and_commit;
+
   while (run) {
-    RdKafka::Message* msg = consumer->consume(10000);
+    // a partial batch is loaded once it has waited batch_wait for more rows
+    const auto waited = std::chrono::steady_clock::now() - batch_start;
+    if (pending_msgs && waited >= batch_wait) {
+      load_and_commit();
+    }
+    if (!pending_msgs) {
+      batch_start = std::chrono::steady_clock::now();
+    }
+    const auto timeout_ms =
+        pending_msgs ? std::chrono::duration_cast<std::chrono::milliseconds>(
+                           batch_wait - (std::chrono::steady_clock::now() - batch_start))
+                           .count()
+                     : 10000;
+    RdKafka::Message* msg = consumer->consume(std::max<int>(timeout_ms, 0));
     if (msg->err() == RdKafka::ERR_NO_ERROR) {
       if (!use_ccb) {
-        bool added =
-            msg_consume(msg, row_loader, copy_params, transformations, remove_quotes);
+        bool added = msg_consume(
+            msg, row_loader, copy_params, row_desc, xforms, remove_quotes);
+        pending_msgs++;
         if (added) {
           recv_rows++;
           if (recv_rows == copy_params.batch_size) {
-            recv_rows = 0;
-            row_loader.do_load(rows_loaded, skipped, copy_params);
-            // make sure we now commit that we are up to here to cover the mesages we just
-            // loaded
-            consumer->commitSync();
+            load_and_commit();
           }
         } else {
           // LOG(ERROR) << " messsage was skipped ";
@@ -458,11 +498,9 @@ void kafka_insert(
   /*
    * Stop consumer
    */
+  ex_rebalance_cb.on_revoke = nullptr;
   consumer->close();
   delete consumer;
-
-  LOG(INFO) << "Consumed " << msg_cnt << " messages (" << msg_bytes << " bytes)";
-  LOG(FATAL) << "Consumer shut down, probably due to an error please review logs";
 };
 
 struct stuff {
@@ -489,13 +527,13 @@ int main(int argc, char** argv) {
   std::string brokers;
   std::string delim_str(","), nulls("\\N"), line_delim_str("\n"), quoted("false");
   size_t batch_size = 10000;
+  size_t batch_wait_ms = 1000;
+  size_t num_consumers = 1;
   size_t retry_count = 10;
   size_t retry_wait = 5;
   bool remove_quotes = false;
   std::vector<std::string> xforms;
-  std::map<std::string,
-           std::pair<std::unique_ptr<boost::regex>, std::unique_ptr<std::string>>>
-      transformations;
+  Transformations transformations;
   ThriftConnectionType conn_type;
 
   namespace po = boost::program_options;
@@ -542,6 +580,14 @@ int main(int argc, char** argv) {
   desc.add_options()("batch",
                      po::value<size_t>(&batch_size)->default_value(batch_size),
                      "Insert batch size");
+  desc.add_options()("batch-wait-ms",
+                     po::value<size_t>(&batch_wait_ms)->default_value(batch_wait_ms),
+                     "Time in ms a partial batch waits for more rows before its insert");
+  desc.add_options()(
+      "consumers",
+      po::value<size_t>(&num_consumers)->default_value(num_consumers),
+      "Number of consumers in the group, each inserting the partitions it's assigned "
+      "over its own connection");
   desc.add_options()("retry_count",
                      po::value<size_t>(&retry_count)->default_value(retry_count),
                      "Number of time to retry an insert");
@@ -584,7 +630,8 @@ int main(int argc, char** argv) {
                    "<password> [{--host} "
                    "<hostname>][--port <port number>][--delim <delimiter>][--null <null "
                    "string>][--line <line "
-                   "delimiter>][--batch <batch size>][{-t|--transform} transformation "
+                   "delimiter>][--batch <batch size>][--batch-wait-ms <wait in ms>]"
+                   "[--consumers <num of consumers>][{-t|--transform} transformation "
                    "[--quoted <true|false>] "
                    "...][--retry_count <num_of_retries>] [--retry_wait <wait in "
                    "secs>][--print_error][--print_transform]\n\n";
@@ -719,17 +766,40 @@ int main(int argc, char** argv) {
             std::unique_ptr<std::string>(new std::string(fmt_str)));
   }
 
+  if (num_consumers < 1) {
+    std::cerr << "At least one consumer is required" << std::endl;
+    return 1;
+  }
+
   import_export::CopyParams copy_params(
       delim, nulls, line_delim, batch_size, retry_count, retry_wait);
-  RowToColumnLoader row_loader(
-      ThriftClientConnection(
-          server_host, port, conn_type, skip_host_verify, ca_cert_name, ca_cert_name),
-      user_name,
-      passwd,
-      db_name,
-      table_name);
-
-  kafka_insert(
-      row_loader, transformations, copy_params, remove_quotes, group_id, topic, brokers);
+
+  std::vector<std::thread> consumer_threads;
+  for (size_t i = 0; i < num_consumers; ++i) {
+    consumer_threads.emplace_back([&] {
+      RowToColumnLoader row_loader(
+          ThriftClientConnection(
+              server_host, port, conn_type, skip_host_verify, ca_cert_name, ca_cert_name),
+          user_name,
+          passwd,
+          db_name,
+          table_name);
+
+      kafka_insert(row_loader,
+                   transformations,
+                   copy_params,
+                   remove_quotes,
+                   batch_wait_ms,
+                   group_id,
+                   topic,
+                   brokers);
+    });
+  }
+  for (auto& consumer_thread : consumer_threads) {
+    consumer_thread.join();
+  }
+
+  LOG(INFO) << "Consumed " << msg_cnt << " messages (" << msg_bytes << " bytes)";
+  LOG(FATAL) << "Consumer shut down, probably due to an error please review logs";
   return 0;
 }
@@ -20,6 +20,9 @@
 
 #include <ImportExport/QueryExporterCSV.h>
 #include <ImportExport/QueryExporterGDAL.h>
+#ifdef ENABLE_IMPORT_PARQUET
+#include <ImportExport/QueryExporterParquet.h>
+#endif
 
 namespace import_export {
 
@@ -33,6 +36,12 @@ std::unique_ptr<QueryExporter> QueryExporter::create(FileType file_type) {
     case FileType::kGeoJSONL:
     case FileType::kShapefile:
       return std::make_unique<QueryExporterGDAL>(file_type);
+    case FileType::kParquet:
+#ifdef ENABLE_IMPORT_PARQUET
+      return std::make_unique<QueryExporterParquet>();
+#else
+      throw std::runtime_error("Parquet export not supported in this build");
+#endif
   }
   CHECK(false);
   return nullptr;
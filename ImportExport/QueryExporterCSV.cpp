@@ -16,14 +16,80 @@
 
 #include <ImportExport/QueryExporterCSV.h>
 
+#include <boost/iostreams/filter/gzip.hpp>
 #include <boost/variant/get.hpp>
 
+#include <charconv>
+#include <cstdio>
+#include <future>
+
 #include <QueryEngine/GroupByAndAggregate.h>
 #include <QueryEngine/ResultSet.h>
+#include "Shared/SqlTypesLayout.h"
 #include "Shared/misc.h"
+#include "Shared/thread_count.h"
 
 namespace import_export {
 
+namespace {
+
+// the entries each thread formats at once, the lines of all the threads are then written
+// in order before the next ones are formatted
+constexpr size_t kEntriesPerThread{64 * 1024};
+
+void append_int(std::string& line, const int64_t int_val) {
+  char buf[24];
+  const auto result = std::to_chars(buf, buf + sizeof(buf), int_val);
+  CHECK(result.ec == std::errc());
+  line.append(buf, result.ptr);
+}
+
+// same as the default floatfield of a stream with the given precision
+void append_fp(std::string& line, const double real_val, const int precision) {
+  char buf[64];
+  const auto len = std::snprintf(buf, sizeof(buf), "%.*g", precision, real_val);
+  CHECK_GT(len, 0);
+  CHECK_LT(static_cast<size_t>(len), sizeof(buf));
+  line.append(buf, len);
+}
+
+// whether the values of the column can be formatted straight from the result set buffer
+bool is_direct_column(const ResultSet& results,
+                      const std::vector<TargetMetaInfo>& targets,
+                      const size_t col_idx) {
+  if (!results.isPermutationBufferEmpty() ||
+      !results.isZeroCopyColumnarConversionPossible(col_idx)) {
+    return false;
+  }
+  // with one slot per target, the slot of the column is its index
+  for (auto const& target : targets) {
+    if (target.get_type_info().is_varlen() || target.get_type_info().is_geometry()) {
+      return false;
+    }
+  }
+  auto const& ti = targets[col_idx].get_type_info();
+  if (ti.get_compression() != kENCODING_NONE ||
+      results.getPaddedSlotWidthBytes(col_idx) != ti.get_size()) {
+    return false;
+  }
+  switch (ti.get_type()) {
+    case kBOOLEAN:
+    case kTINYINT:
+    case kSMALLINT:
+    case kINT:
+    case kBIGINT:
+    case kTIME:
+    case kTIMESTAMP:
+    case kFLOAT:
+    case kDOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 QueryExporterCSV::QueryExporterCSV() : QueryExporter(FileType::kCSV) {}
 
 QueryExporterCSV::~QueryExporterCSV() {}
@@ -38,16 +104,23 @@ void QueryExporterCSV::beginExport(const std::string& file_path,
 
   // compression?
   auto actual_file_path{file_path};
-  if (file_compression != FileCompression::kNone) {
-    // @TODO(se) implement post-export compression
-    throw std::runtime_error("Compression not yet supported for this file type");
+  if (file_compression == FileCompression::kZip) {
+    // @TODO(se) implement zip compression
+    throw std::runtime_error("Zip compression not yet supported for this file type");
+  } else if (file_compression == FileCompression::kGZip) {
+    actual_file_path += ".gz";
   }
 
   // open file
-  outfile_.open(actual_file_path);
+  outfile_.open(actual_file_path, std::ios_base::out | std::ios_base::binary);
   if (!outfile_) {
     throw std::runtime_error("Failed to create file '" + actual_file_path + "'");
   }
+  out_.reset();
+  if (file_compression == FileCompression::kGZip) {
+    out_.push(boost::iostreams::gzip_compressor());
+  }
+  out_.push(outfile_);
 
   // write header?
   if (copy_params.has_header == import_export::ImportHeaderRow::HAS_HEADER) {
@@ -58,148 +131,293 @@ void QueryExporterCSV::beginExport(const std::string& file_path,
       auto column_name = safeColumnName(column_info.get_resname(), column_index + 1);
       // output to header line
       if (not_first) {
-        outfile_ << copy_params.delimiter;
+        out_ << copy_params.delimiter;
       } else {
         not_first = true;
       }
-      outfile_ << column_name;
+      out_ << column_name;
       column_index++;
     }
-    outfile_ << copy_params.line_delim;
+    out_ << copy_params.line_delim;
   }
 
   // keep these
   copy_params_ = copy_params;
 }
 
+void QueryExporterCSV::appendValue(std::string& line,
+                                   const TargetValue& tv,
+                                   const SQLTypeInfo& ti) const {
+  bool is_null{false};
+  auto const scalar_tv = boost::get<ScalarTargetValue>(&tv);
+  if (copy_params_.quoted) {
+    line += copy_params_.quote;
+  }
+  if (!scalar_tv) {
+    line += datum_to_string(tv, ti, " | ");
+    if (copy_params_.quoted) {
+      line += copy_params_.quote;
+    }
+    return;
+  }
+  if (boost::get<int64_t>(scalar_tv)) {
+    auto int_val = *(boost::get<int64_t>(scalar_tv));
+    switch (ti.get_type()) {
+      case kBOOLEAN:
+        is_null = (int_val == NULL_BOOLEAN);
+        break;
+      case kTINYINT:
+        is_null = (int_val == NULL_TINYINT);
+        break;
+      case kSMALLINT:
+        is_null = (int_val == NULL_SMALLINT);
+        break;
+      case kINT:
+        is_null = (int_val == NULL_INT);
+        break;
+      case kBIGINT:
+        is_null = (int_val == NULL_BIGINT);
+        break;
+      case kTIME:
+      case kTIMESTAMP:
+      case kDATE:
+        is_null = (int_val == NULL_BIGINT);
+        break;
+      default:
+        is_null = false;
+    }
+    if (is_null) {
+      line += copy_params_.null_str;
+    } else if (ti.get_type() == kTIME) {
+      constexpr size_t buf_size = 9;
+      char buf[buf_size];
+      size_t const len = shared::formatHMS(buf, buf_size, int_val);
+      CHECK_EQ(8u, len);  // 8 == strlen("HH:MM:SS")
+      line.append(buf, len);
+    } else {
+      append_int(line, int_val);
+    }
+  } else if (boost::get<double>(scalar_tv)) {
+    auto real_val = *(boost::get<double>(scalar_tv));
+    if (ti.get_type() == kFLOAT) {
+      is_null = (real_val == NULL_FLOAT);
+    } else {
+      is_null = (real_val == NULL_DOUBLE);
+    }
+    if (is_null) {
+      line += copy_params_.null_str;
+    } else if (ti.get_type() == kNUMERIC) {
+      append_fp(line, real_val, ti.get_precision());
+    } else {
+      append_fp(line, real_val, std::numeric_limits<double>::digits10 + 1);
+    }
+  } else if (boost::get<float>(scalar_tv)) {
+    CHECK_EQ(kFLOAT, ti.get_type());
+    auto real_val = *(boost::get<float>(scalar_tv));
+    if (real_val == NULL_FLOAT) {
+      line += copy_params_.null_str;
+    } else {
+      append_fp(line, real_val, std::numeric_limits<float>::digits10 + 1);
+    }
+  } else {
+    auto s = boost::get<NullableString>(scalar_tv);
+    is_null = !s || boost::get<void*>(s);
+    if (is_null) {
+      line += copy_params_.null_str;
+    } else {
+      auto s_notnull = boost::get<std::string>(s);
+      CHECK(s_notnull);
+      if (!copy_params_.quoted) {
+        line += *s_notnull;
+      } else {
+        size_t q = s_notnull->find(copy_params_.quote);
+        if (q == std::string::npos) {
+          line += *s_notnull;
+        } else {
+          std::string str(*s_notnull);
+          while (q != std::string::npos) {
+            str.insert(q, 1, copy_params_.escape);
+            q = str.find(copy_params_.quote, q + 2);
+          }
+          line += str;
+        }
+      }
+    }
+  }
+  if (copy_params_.quoted) {
+    line += copy_params_.quote;
+  }
+}
+
+void QueryExporterCSV::appendDirectValue(std::string& line,
+                                         const int8_t* column_buffer,
+                                         const size_t entry_idx,
+                                         const SQLTypeInfo& ti) const {
+  const auto value_ptr = column_buffer + entry_idx * ti.get_size();
+  if (copy_params_.quoted) {
+    line += copy_params_.quote;
+  }
+  if (ti.get_type() == kFLOAT) {
+    const auto real_val = *reinterpret_cast<const float*>(value_ptr);
+    if (real_val == NULL_FLOAT) {
+      line += copy_params_.null_str;
+    } else {
+      append_fp(line, real_val, std::numeric_limits<float>::digits10 + 1);
+    }
+  } else if (ti.get_type() == kDOUBLE) {
+    const auto real_val = *reinterpret_cast<const double*>(value_ptr);
+    if (real_val == NULL_DOUBLE) {
+      line += copy_params_.null_str;
+    } else {
+      append_fp(line, real_val, std::numeric_limits<double>::digits10 + 1);
+    }
+  } else {
+    int64_t int_val{0};
+    switch (ti.get_size()) {
+      case 1:
+        int_val = *reinterpret_cast<const int8_t*>(value_ptr);
+        break;
+      case 2:
+        int_val = *reinterpret_cast<const int16_t*>(value_ptr);
+        break;
+      case 4:
+        int_val = *reinterpret_cast<const int32_t*>(value_ptr);
+        break;
+      case 8:
+        int_val = *reinterpret_cast<const int64_t*>(value_ptr);
+        break;
+      default:
+        CHECK(false);
+    }
+    if (int_val == inline_int_null_val(ti)) {
+      line += copy_params_.null_str;
+    } else if (ti.get_type() == kTIME) {
+      constexpr size_t buf_size = 9;
+      char buf[buf_size];
+      size_t const len = shared::formatHMS(buf, buf_size, int_val);
+      CHECK_EQ(8u, len);  // 8 == strlen("HH:MM:SS")
+      line.append(buf, len);
+    } else {
+      append_int(line, int_val);
+    }
+  }
+  if (copy_params_.quoted) {
+    line += copy_params_.quote;
+  }
+}
+
 void QueryExporterCSV::exportResults(const std::vector<AggregatedResult>& query_results) {
   for (auto& agg_result : query_results) {
     auto results = agg_result.rs;
     auto const& targets = agg_result.targets_meta;
 
+    if (!results->isTruncated()) {
+      exportResultsInParallel(*results, targets);
+      continue;
+    }
+
+    // the rows within the offset and the limit are only known to the cursor
+    std::string line;
     while (true) {
       auto const crt_row = results->getNextRow(true, true);
       if (crt_row.empty()) {
         break;
       }
-      bool not_first = false;
+      line.clear();
       for (size_t i = 0; i < results->colCount(); ++i) {
-        bool is_null{false};
-        auto const tv = crt_row[i];
-        auto const scalar_tv = boost::get<ScalarTargetValue>(&tv);
-        if (not_first) {
-          outfile_ << copy_params_.delimiter;
-        } else {
-          not_first = true;
+        if (i) {
+          line += copy_params_.delimiter;
         }
-        if (copy_params_.quoted) {
-          outfile_ << copy_params_.quote;
-        }
-        auto const& ti = targets[i].get_type_info();
-        if (!scalar_tv) {
-          outfile_ << datum_to_string(crt_row[i], ti, " | ");
-          if (copy_params_.quoted) {
-            outfile_ << copy_params_.quote;
-          }
+        appendValue(line, crt_row[i], targets[i].get_type_info());
+      }
+      line += copy_params_.line_delim;
+      out_.write(line.data(), line.size());
+    }
+  }
+}
+
+void QueryExporterCSV::exportResultsInParallel(
+    const ResultSet& results,
+    const std::vector<TargetMetaInfo>& targets) {
+  const auto col_count = results.colCount();
+  CHECK_EQ(col_count, targets.size());
+
+  // the fixed width columns are read straight from the buffer rather than as target
+  // values of the rows
+  std::vector<const int8_t*> direct_columns(col_count, nullptr);
+  std::vector<bool> targets_to_skip(col_count, false);
+  size_t direct_col_count{0};
+  for (size_t col_idx = 0; col_idx < col_count; ++col_idx) {
+    if (is_direct_column(results, targets, col_idx)) {
+      direct_columns[col_idx] = results.getColumnarBuffer(col_idx);
+      targets_to_skip[col_idx] = true;
+      ++direct_col_count;
+    }
+  }
+  if (!direct_col_count) {
+    targets_to_skip.clear();
+  }
+
+  const auto format_entries = [&](std::string& lines,
+                                  const size_t start_entry,
+                                  const size_t end_entry) {
+    lines.clear();
+    std::vector<TargetValue> row;
+    for (size_t entry_idx = start_entry; entry_idx < end_entry; ++entry_idx) {
+      if (direct_col_count < col_count) {
+        row = results.getRowAtTranslated(entry_idx, true, targets_to_skip);
+        if (row.empty()) {
           continue;
         }
-        if (boost::get<int64_t>(scalar_tv)) {
-          auto int_val = *(boost::get<int64_t>(scalar_tv));
-          switch (ti.get_type()) {
-            case kBOOLEAN:
-              is_null = (int_val == NULL_BOOLEAN);
-              break;
-            case kTINYINT:
-              is_null = (int_val == NULL_TINYINT);
-              break;
-            case kSMALLINT:
-              is_null = (int_val == NULL_SMALLINT);
-              break;
-            case kINT:
-              is_null = (int_val == NULL_INT);
-              break;
-            case kBIGINT:
-              is_null = (int_val == NULL_BIGINT);
-              break;
-            case kTIME:
-            case kTIMESTAMP:
-            case kDATE:
-              is_null = (int_val == NULL_BIGINT);
-              break;
-            default:
-              is_null = false;
-          }
-          if (is_null) {
-            outfile_ << copy_params_.null_str;
-          } else if (ti.get_type() == kTIME) {
-            constexpr size_t buf_size = 9;
-            char buf[buf_size];
-            size_t const len = shared::formatHMS(buf, buf_size, int_val);
-            CHECK_EQ(8u, len);  // 8 == strlen("HH:MM:SS")
-            outfile_ << buf;
-          } else {
-            outfile_ << int_val;
-          }
-        } else if (boost::get<double>(scalar_tv)) {
-          auto real_val = *(boost::get<double>(scalar_tv));
-          if (ti.get_type() == kFLOAT) {
-            is_null = (real_val == NULL_FLOAT);
-          } else {
-            is_null = (real_val == NULL_DOUBLE);
-          }
-          if (is_null) {
-            outfile_ << copy_params_.null_str;
-          } else if (ti.get_type() == kNUMERIC) {
-            outfile_ << std::setprecision(ti.get_precision()) << real_val;
-          } else {
-            outfile_ << std::setprecision(std::numeric_limits<double>::digits10 + 1)
-                     << real_val;
-          }
-        } else if (boost::get<float>(scalar_tv)) {
-          CHECK_EQ(kFLOAT, ti.get_type());
-          auto real_val = *(boost::get<float>(scalar_tv));
-          if (real_val == NULL_FLOAT) {
-            outfile_ << copy_params_.null_str;
-          } else {
-            outfile_ << std::setprecision(std::numeric_limits<float>::digits10 + 1)
-                     << real_val;
-          }
-        } else {
-          auto s = boost::get<NullableString>(scalar_tv);
-          is_null = !s || boost::get<void*>(s);
-          if (is_null) {
-            outfile_ << copy_params_.null_str;
-          } else {
-            auto s_notnull = boost::get<std::string>(s);
-            CHECK(s_notnull);
-            if (!copy_params_.quoted) {
-              outfile_ << *s_notnull;
-            } else {
-              size_t q = s_notnull->find(copy_params_.quote);
-              if (q == std::string::npos) {
-                outfile_ << *s_notnull;
-              } else {
-                std::string str(*s_notnull);
-                while (q != std::string::npos) {
-                  str.insert(q, 1, copy_params_.escape);
-                  q = str.find(copy_params_.quote, q + 2);
-                }
-                outfile_ << str;
-              }
-            }
-          }
+      } else if (results.isRowAtEmpty(entry_idx)) {
+        continue;
+      }
+      for (size_t col_idx = 0; col_idx < col_count; ++col_idx) {
+        if (col_idx) {
+          lines += copy_params_.delimiter;
         }
-        if (copy_params_.quoted) {
-          outfile_ << copy_params_.quote;
+        auto const& ti = targets[col_idx].get_type_info();
+        if (direct_columns[col_idx]) {
+          appendDirectValue(lines, direct_columns[col_idx], entry_idx, ti);
+        } else {
+          appendValue(lines, row[col_idx], ti);
         }
       }
-      outfile_ << copy_params_.line_delim;
+      lines += copy_params_.line_delim;
+    }
+  };
+
+  const auto entry_count = results.entryCount();
+  const size_t thread_count = cpu_threads();
+  std::vector<std::string> thread_lines(thread_count);
+  for (size_t batch_start = 0; batch_start < entry_count;
+       batch_start += thread_count * kEntriesPerThread) {
+    std::vector<std::future<void>> threads;
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      const auto start_entry = batch_start + thread_idx * kEntriesPerThread;
+      if (start_entry >= entry_count) {
+        break;
+      }
+      const auto end_entry = std::min(entry_count, start_entry + kEntriesPerThread);
+      threads.push_back(std::async(std::launch::async,
+                                   format_entries,
+                                   std::ref(thread_lines[thread_idx]),
+                                   start_entry,
+                                   end_entry));
+    }
+    for (auto& thread : threads) {
+      thread.get();
+    }
+    for (size_t thread_idx = 0; thread_idx < threads.size(); ++thread_idx) {
+      auto const& lines = thread_lines[thread_idx];
+      out_.write(lines.data(), lines.size());
     }
   }
 }
 
 void QueryExporterCSV::endExport() {
-  // just close the file
+  // flush the compressor, if any, and close the file
+  out_.reset();
   outfile_.close();
 }
 
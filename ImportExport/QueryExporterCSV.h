@@ -18,6 +18,8 @@
 
 #include <fstream>
 
+#include <boost/iostreams/filtering_stream.hpp>
+
 #include <ImportExport/QueryExporter.h>
 
 namespace import_export {
@@ -37,7 +39,19 @@ class QueryExporterCSV : public QueryExporter {
   void endExport() final;
 
  private:
+  void appendValue(std::string& line,
+                   const TargetValue& tv,
+                   const SQLTypeInfo& ti) const;
+  void appendDirectValue(std::string& line,
+                         const int8_t* column_buffer,
+                         const size_t entry_idx,
+                         const SQLTypeInfo& ti) const;
+  void exportResultsInParallel(const ResultSet& results,
+                               const std::vector<TargetMetaInfo>& targets);
+
   std::ofstream outfile_;
+  // writes to outfile_, through a gzip compressor when asked to
+  boost::iostreams::filtering_ostream out_;
   CopyParams copy_params_;
 };
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ImportExport/QueryExporterParquet.h>
+
+#include <arrow/api.h>
+
+#include <QueryEngine/ArrowResultSet.h>
+#include <QueryEngine/ResultSet.h>
+
+namespace import_export {
+
+namespace {
+
+// the rows of each row group, also the rows converted to arrow at once
+constexpr int64_t kRowGroupSize{1 << 20};
+
+}  // namespace
+
+QueryExporterParquet::QueryExporterParquet() : QueryExporter(FileType::kParquet) {}
+
+QueryExporterParquet::~QueryExporterParquet() {}
+
+void QueryExporterParquet::beginExport(const std::string& file_path,
+                                       const std::string& layer_name,
+                                       const CopyParams& copy_params,
+                                       const std::vector<TargetMetaInfo>& column_infos,
+                                       const FileCompression file_compression,
+                                       const ArrayNullHandling array_null_handling) {
+  validateFileExtensions(file_path, "Parquet", {".parquet"});
+
+  // compression is applied to the pages of the file itself
+  parquet::WriterProperties::Builder builder;
+  switch (file_compression) {
+    case FileCompression::kNone:
+      builder.compression(parquet::Compression::UNCOMPRESSED);
+      break;
+    case FileCompression::kGZip:
+      builder.compression(parquet::Compression::GZIP);
+      break;
+    case FileCompression::kZip:
+      throw std::runtime_error("Zip compression not supported for this file type");
+  }
+  builder.enable_dictionary();
+  builder.max_row_group_length(kRowGroupSize);
+  writer_properties_ = builder.build();
+
+  // open file
+  auto open_result = arrow::io::FileOutputStream::Open(file_path);
+  if (!open_result.ok()) {
+    throw std::runtime_error("Failed to create file '" + file_path +
+                             "': " + open_result.status().ToString());
+  }
+  outfile_ = open_result.ValueOrDie();
+  file_path_ = file_path;
+
+  // get names or defaults
+  column_names_.clear();
+  int column_index = 0;
+  for (auto const& column_info : column_infos) {
+    column_names_.push_back(safeColumnName(column_info.get_resname(), column_index + 1));
+    column_index++;
+  }
+}
+
+void QueryExporterParquet::exportResults(
+    const std::vector<AggregatedResult>& query_results) {
+  for (auto& agg_result : query_results) {
+    auto results = agg_result.rs;
+    CHECK(results);
+    if (results->rowCount() == 0) {
+      continue;
+    }
+
+    // the columns are converted by a thread each, the dictionary strings into arrow
+    // dictionary arrays of the ids and the strings they reference
+    ArrowResultSetConverter converter(results, column_names_, -1);
+    const auto record_batch = converter.convertToArrow();
+    CHECK(record_batch);
+
+    if (!writer_) {
+      auto status = parquet::arrow::FileWriter::Open(*record_batch->schema(),
+                                                     arrow::default_memory_pool(),
+                                                     outfile_,
+                                                     writer_properties_,
+                                                     &writer_);
+      if (!status.ok()) {
+        throw std::runtime_error("Failed to write file '" + file_path_ +
+                                 "': " + status.ToString());
+      }
+    }
+
+    std::shared_ptr<arrow::Table> table;
+    auto status = arrow::Table::FromRecordBatches({record_batch}, &table);
+    if (status.ok()) {
+      status = writer_->WriteTable(*table, kRowGroupSize);
+    }
+    if (!status.ok()) {
+      throw std::runtime_error("Failed to write file '" + file_path_ +
+                               "': " + status.ToString());
+    }
+  }
+}
+
+void QueryExporterParquet::endExport() {
+  // the footer is written on close, the file needs a schema even without rows
+  if (!writer_) {
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    for (auto const& column_name : column_names_) {
+      fields.push_back(arrow::field(column_name, arrow::null()));
+    }
+    auto status = parquet::arrow::FileWriter::Open(*arrow::schema(fields),
+                                                   arrow::default_memory_pool(),
+                                                   outfile_,
+                                                   writer_properties_,
+                                                   &writer_);
+    if (!status.ok()) {
+      throw std::runtime_error("Failed to write file '" + file_path_ +
+                               "': " + status.ToString());
+    }
+  }
+  auto status = writer_->Close();
+  if (status.ok()) {
+    status = outfile_->Close();
+  }
+  if (!status.ok()) {
+    throw std::runtime_error("Failed to close file '" + file_path_ +
+                             "': " + status.ToString());
+  }
+  writer_.reset();
+  outfile_.reset();
+}
+
+}  // namespace import_export
@@ -39,6 +39,17 @@ ChunkKey chunk_key_for_table(const Catalog_Namespace::Catalog& cat,
   }
 }
 
+std::string table_key_to_string(const ChunkKey& table_key) {
+  std::string str;
+  for (const auto key : table_key) {
+    if (!str.empty()) {
+      str += ',';
+    }
+    str += std::to_string(key);
+  }
+  return str;
+}
+
 }  // namespace helpers
 
 }  // namespace lockmgr
@@ -43,7 +43,7 @@ class TableSchemaLockMgr : public TableLockMgrImpl<TableSchemaLockMgr> {
   }
 
  private:
-  TableSchemaLockMgr() {}
+  TableSchemaLockMgr() : TableLockMgrImpl("table_schema") {}
 };
 
 /**
@@ -60,7 +60,7 @@ class InsertDataLockMgr : public TableLockMgrImpl<InsertDataLockMgr> {
   }
 
  protected:
-  InsertDataLockMgr() {}
+  InsertDataLockMgr() : TableLockMgrImpl("insert_data") {}
 };
 
 /**
@@ -79,7 +79,7 @@ class TableDataLockMgr : public TableLockMgrImpl<TableDataLockMgr> {
   }
 
  protected:
-  TableDataLockMgr() {}
+  TableDataLockMgr() : TableLockMgrImpl("table_data") {}
 };
 
 class TableLockContainerImpl {
@@ -19,10 +19,12 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <type_traits>
 
 #include "Catalog/Catalog.h"
+#include "Shared/LockContention.h"
 #include "Shared/mapd_shared_mutex.h"
 #include "Shared/types.h"
 
@@ -35,7 +37,8 @@ using ReadLockBase = mapd_shared_lock<MutexTypeBase>;
 
 class MutexTracker {
  public:
-  MutexTracker() : ref_count_(0u) {}
+  MutexTracker(lock_contention::LockProfile& profile)
+      : ref_count_(0u), profile_(profile) {}
 
   MutexTypeBase& acquire() {
     ref_count_.fetch_add(1u);
@@ -49,15 +52,26 @@ class MutexTracker {
 
   bool isAcquired() const { return ref_count_.load() > 0; }
 
+  lock_contention::LockProfile& profile() const { return profile_; }
+
  private:
   std::atomic<size_t> ref_count_;
+  lock_contention::LockProfile& profile_;
   MutexTypeBase mutex_;
 };
 
 template <typename LOCK>
 class TrackedRefLock {
  public:
-  TrackedRefLock(MutexTracker* m) : mutex_(m), lock_(mutex_->acquire()) { CHECK(mutex_); }
+  TrackedRefLock(MutexTracker* m) : mutex_(m), lock_(mutex_->acquire(), std::defer_lock) {
+    CHECK(mutex_);
+    lock_contention::lock(lock_, mutex_->profile(), hold_timer_);
+  }
+
+  TrackedRefLock(MutexTracker* m, std::try_to_lock_t try_to_lock)
+      : mutex_(m), lock_(mutex_->acquire(), try_to_lock) {
+    CHECK(mutex_);
+  }
 
   ~TrackedRefLock() {
     if (mutex_) {
@@ -68,16 +82,22 @@ class TrackedRefLock {
   }
 
   TrackedRefLock(TrackedRefLock&& other)
-      : mutex_(other.mutex_), lock_(std::move(other.lock_)) {
+      : mutex_(other.mutex_)
+      , lock_(std::move(other.lock_))
+      , hold_timer_(std::move(other.hold_timer_)) {
     other.mutex_ = nullptr;
   }
 
   TrackedRefLock(const TrackedRefLock&) = delete;
   TrackedRefLock& operator=(const TrackedRefLock&) = delete;
 
+  bool ownsLock() const { return lock_.owns_lock(); }
+
  private:
   MutexTracker* mutex_;
   LOCK lock_;
+  // destroyed before the lock is released
+  lock_contention::HoldTimer hold_timer_;
 };  // namespace lockmgr
 
 using MutexType = MutexTracker;
@@ -109,6 +129,9 @@ namespace helpers {
 ChunkKey chunk_key_for_table(const Catalog_Namespace::Catalog& cat,
                              const std::string& tableName);
 
+// "db_id,table_id"
+std::string table_key_to_string(const ChunkKey& table_key);
+
 template <typename LOCK_TYPE, typename LOCK_MGR_TYPE>
 LOCK_TYPE getLockForKeyImpl(const ChunkKey& chunk_key) {
   auto& table_lock_mgr = LOCK_MGR_TYPE::instance();
@@ -133,7 +156,10 @@ class TableLockMgrImpl {
     std::lock_guard<std::mutex> access_map_lock(map_mutex_);
     auto mutex_it = table_mutex_map_.find(table_key);
     if (mutex_it == table_mutex_map_.end()) {
-      table_mutex_map_.insert(std::make_pair(table_key, std::make_unique<MutexType>()));
+      table_mutex_map_.insert(std::make_pair(
+          table_key,
+          std::make_unique<MutexType>(lock_contention::get_profile(
+              lock_class_, helpers::table_key_to_string(table_key)))));
     } else {
       return mutex_it->second.get();
     }
@@ -160,6 +186,11 @@ class TableLockMgrImpl {
     auto& table_lock_mgr = T::instance();
     return WriteLock(table_lock_mgr.getTableMutex(table_key));
   }
+  // Doesn't wait for the lock, check ownsLock() on the returned lock.
+  static WriteLock tryWriteLockForTable(const ChunkKey table_key) {
+    auto& table_lock_mgr = T::instance();
+    return WriteLock(table_lock_mgr.getTableMutex(table_key), std::try_to_lock);
+  }
 
   static ReadLock getReadLockForTable(const Catalog_Namespace::Catalog& cat,
                                       const std::string& table_name) {
@@ -171,8 +202,10 @@ class TableLockMgrImpl {
   }
 
  protected:
-  TableLockMgrImpl() {}
+  // `lock_class` names the locks of the manager in the lock contention stats
+  TableLockMgrImpl(const std::string& lock_class) : lock_class_(lock_class) {}
 
+  const std::string lock_class_;
   mutable std::mutex map_mutex_;
   std::map<ChunkKey, std::unique_ptr<MutexType>> table_mutex_map_;
 };
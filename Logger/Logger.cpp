@@ -19,6 +19,7 @@ bool g_enable_debug_timer{false};
 #ifndef __CUDACC__
 
 #include "Logger.h"
+#include "PerfCounters.h"
 
 #include <rapidjson/document.h>
 #include <rapidjson/stringbuffer.h>
@@ -432,6 +433,9 @@ class Duration {
   DurationTree* const duration_tree_;
   Clock::time_point const start_;
   Clock::time_point stop_;
+  // only with g_enable_perf_counters, and if the counters could be read
+  bool has_perf_counters_;
+  PerfCounterValues perf_counters_;
 
  public:
   int const depth_;
@@ -452,7 +456,10 @@ class Duration {
       , severity_(severity)
       , file_(file)
       , line_(line)
-      , name_(name) {}
+      , name_(name) {
+    has_perf_counters_ =
+        g_enable_perf_counters && read_thread_perf_counters(perf_counters_);
+  }
   bool stop();
   // Start time relative to parent DurationTree::start_.
   template <typename Units = std::chrono::milliseconds>
@@ -460,6 +467,10 @@ class Duration {
   // Duration value = stop_ - start_.
   template <typename Units = std::chrono::milliseconds>
   typename Units::rep value() const;
+  // The counters of the thread between the start and the stop, if they were read.
+  PerfCounterValues const* perfCounters() const {
+    return has_perf_counters_ ? &perf_counters_ : nullptr;
+  }
 };
 
 using DurationTreeNode = boost::variant<Duration, DurationTree&>;
@@ -500,6 +511,11 @@ class DurationTree {
 /// Return true iff this Duration represents the root timer (see docs).
 bool Duration::stop() {
   stop_ = Clock::now();
+  if (has_perf_counters_) {
+    PerfCounterValues stop_counters;
+    has_perf_counters_ = read_thread_perf_counters(stop_counters);
+    perf_counters_ = stop_counters - perf_counters_;
+  }
   duration_tree_->decrementDepth();
   return depth_ == 0;
 }
@@ -540,9 +556,13 @@ Duration* newDuration(Severity severity, Ts&&... args) {
 }
 
 std::ostream& operator<<(std::ostream& os, Duration const& duration) {
-  return os << std::setw(2 * duration.depth_) << ' ' << duration.value() << "ms start("
-            << duration.relative_start_time() << "ms) " << duration.name_ << ' '
-            << filename(duration.file_) << ':' << duration.line_;
+  os << std::setw(2 * duration.depth_) << ' ' << duration.value() << "ms start("
+     << duration.relative_start_time() << "ms) " << duration.name_ << ' '
+     << filename(duration.file_) << ':' << duration.line_;
+  if (auto const perf_counters = duration.perfCounters()) {
+    os << ' ' << *perf_counters;
+  }
+  return os;
 }
 
 std::ostream& operator<<(std::ostream& os, DurationTree const& duration_tree) {
@@ -564,6 +584,9 @@ boost::log::record_ostream& operator<<(boost::log::record_ostream& os,
   auto const& root_duration = boost::get<Duration>(*itr);
   os << "DEBUG_TIMER thread_id(" << kv_pair.first << ")\n"
      << root_duration.value() << "ms total duration for " << root_duration.name_;
+  if (auto const perf_counters = root_duration.perfCounters()) {
+    os << ' ' << *perf_counters;
+  }
   for (++itr; itr != end; ++itr) {
     os << '\n' << *itr;
   }
@@ -601,9 +624,22 @@ class JsonEncoder : boost::static_visitor<rapidjson::Value> {
     retval.AddMember("name", rapidjson::StringRef(duration.name_), alloc_);
     retval.AddMember("file", filename(duration.file_), alloc_);
     retval.AddMember("line", rapidjson::Value(duration.line_), alloc_);
+    if (auto const perf_counters = duration.perfCounters()) {
+      retval.AddMember("perf_counters", perfCounters(*perf_counters), alloc_);
+    }
     retval.AddMember("children", childNodes(duration.depth_), alloc_);
     return retval;
   }
+  rapidjson::Value perfCounters(PerfCounterValues const& perf_counters) {
+    rapidjson::Value retval(rapidjson::kObjectType);
+    retval.AddMember("cycles", rapidjson::Value(perf_counters.cycles), alloc_);
+    retval.AddMember(
+        "instructions", rapidjson::Value(perf_counters.instructions), alloc_);
+    retval.AddMember("llc_misses", rapidjson::Value(perf_counters.llc_misses), alloc_);
+    retval.AddMember(
+        "branch_misses", rapidjson::Value(perf_counters.branch_misses), alloc_);
+    return retval;
+  }
   rapidjson::Value operator()(DurationTree const& duration_tree) {
     begin_ = duration_tree.durations().cbegin();
     end_ = duration_tree.durations().cend();
@@ -641,6 +677,9 @@ class JsonEncoder : boost::static_visitor<rapidjson::Value> {
       retval.AddMember(
           "total_duration_ms", rapidjson::Value(root_duration.value()), alloc_);
       retval.AddMember("name", rapidjson::StringRef(root_duration.name_), alloc_);
+      if (auto const perf_counters = root_duration.perfCounters()) {
+        retval.AddMember("perf_counters", perfCounters(*perf_counters), alloc_);
+      }
       retval.AddMember("children", childNodes(0), alloc_);
     }
     return retval;
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerfCounters.h"
+
+#include <array>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+
+bool g_enable_perf_counters{false};
+
+namespace logger {
+
+PerfCounterValues& PerfCounterValues::operator+=(const PerfCounterValues& other) {
+  cycles += other.cycles;
+  instructions += other.instructions;
+  llc_misses += other.llc_misses;
+  branch_misses += other.branch_misses;
+  return *this;
+}
+
+PerfCounterValues PerfCounterValues::operator-(const PerfCounterValues& other) const {
+  return {cycles - other.cycles,
+          instructions - other.instructions,
+          llc_misses - other.llc_misses,
+          branch_misses - other.branch_misses};
+}
+
+double PerfCounterValues::instructionsPerCycle() const {
+  return cycles ? static_cast<double>(instructions) / cycles : 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const PerfCounterValues& values) {
+  return os << "cycles(" << values.cycles << ") instructions(" << values.instructions
+            << ") ipc(" << std::fixed << std::setprecision(2)
+            << values.instructionsPerCycle() << std::defaultfloat << ") llc_misses("
+            << values.llc_misses << ") branch_misses(" << values.branch_misses << ')';
+}
+
+namespace {
+
+#ifdef __linux__
+
+// The counters are one group, scheduled on the PMU together and read with one read().
+class ThreadPerfCounters {
+ public:
+  ThreadPerfCounters() {
+    fds_.fill(-1);
+    const std::array<uint64_t, kCounterCount> events{PERF_COUNT_HW_CPU_CYCLES,
+                                                     PERF_COUNT_HW_INSTRUCTIONS,
+                                                     PERF_COUNT_HW_CACHE_MISSES,
+                                                     PERF_COUNT_HW_BRANCH_MISSES};
+    for (size_t i = 0; i < kCounterCount; ++i) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = events[i];
+      attr.read_format = PERF_FORMAT_GROUP;
+      // the leader is enabled once the group is complete
+      attr.disabled = i == 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds_[i] = ::syscall(__NR_perf_event_open, &attr, 0, -1, i ? fds_[0] : -1, 0);
+      if (fds_[i] < 0) {
+        error_ = std::strerror(errno);
+        closeAll();
+        return;
+      }
+    }
+    ::ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~ThreadPerfCounters() { closeAll(); }
+
+  bool read(PerfCounterValues& values) const {
+    if (fds_[0] < 0) {
+      return false;
+    }
+    // the number of counters, then their values in the order they were opened
+    std::array<uint64_t, 1 + kCounterCount> buffer;
+    if (::read(fds_[0], buffer.data(), sizeof(buffer)) != sizeof(buffer)) {
+      return false;
+    }
+    values = {buffer[1], buffer[2], buffer[3], buffer[4]};
+    return true;
+  }
+
+  const std::string& error() const { return error_; }
+
+ private:
+  static constexpr size_t kCounterCount{4};
+
+  void closeAll() {
+    for (auto& fd : fds_) {
+      if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+      }
+    }
+  }
+
+  std::array<int, kCounterCount> fds_;
+  std::string error_;
+};
+
+#endif  // __linux__
+
+}  // namespace
+
+bool read_thread_perf_counters(PerfCounterValues& values) {
+  static std::once_flag unavailable_logged;
+#ifdef __linux__
+  thread_local const ThreadPerfCounters thread_counters;
+  if (thread_counters.read(values)) {
+    return true;
+  }
+  std::call_once(unavailable_logged, [] {
+    LOG(WARNING) << "Hardware performance counters unavailable: "
+                 << thread_counters.error()
+                 << ". Check the kernel.perf_event_paranoid setting.";
+  });
+#else
+  std::call_once(unavailable_logged, [] {
+    LOG(WARNING) << "Hardware performance counters are only supported on Linux.";
+  });
+#endif
+  return false;
+}
+
+}  // namespace logger
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PerfCounters.h
+ * @brief   Hardware performance counters of the calling thread, through perf_event.
+ *
+ * The counters of a thread are opened on its first read and stay enabled until it exits,
+ * so that measuring a scope costs two reads. They count user space only, and only the
+ * work of the reading thread: the work a timed scope hands to other threads isn't in it.
+ */
+
+#ifndef LOGGER_PERFCOUNTERS_H
+#define LOGGER_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <ostream>
+
+extern bool g_enable_perf_counters;
+
+namespace logger {
+
+struct PerfCounterValues {
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  // last level cache misses
+  uint64_t llc_misses{0};
+  uint64_t branch_misses{0};
+
+  PerfCounterValues& operator+=(const PerfCounterValues& other);
+  PerfCounterValues operator-(const PerfCounterValues& other) const;
+
+  double instructionsPerCycle() const;
+};
+
+std::ostream& operator<<(std::ostream& os, const PerfCounterValues& values);
+
+// Returns false if the counters can't be opened, e.g. for the perf_event_paranoid
+// setting of the kernel or in a container, after logging why once.
+bool read_thread_perf_counters(PerfCounterValues& values);
+
+}  // namespace logger
+
+#endif  // LOGGER_PERFCOUNTERS_H
@@ -26,6 +26,10 @@
 #include <thrift/concurrency/ThreadManager.h>
 #include <thrift/protocol/TBinaryProtocol.h>
 #include <thrift/protocol/TJSONProtocol.h>
+#ifdef HAVE_THRIFT_NONBLOCKING_SERVER
+#include <thrift/server/TNonblockingServer.h>
+#include <thrift/transport/TNonblockingServerSocket.h>
+#endif
 #include <thrift/server/TThreadedServer.h>
 #include <thrift/transport/TBufferTransports.h>
 #include <thrift/transport/THttpServer.h>
@@ -56,11 +60,17 @@
 
 #include "MapDRelease.h"
 #include "DataMgr/ForeignStorage/ForeignTableRefresh.h"
+#include "QueryEngine/BufferPoolCompactionScheduler.h"
+#include "QueryEngine/ColdStorageScheduler.h"
+#include "QueryEngine/TableVacuumScheduler.h"
+#include "QueryEngine/WorkingSetScheduler.h"
 #include "Shared/Compressor.h"
 #include "Shared/SystemParameters.h"
 #include "Shared/file_delete.h"
 #include "Shared/mapd_shared_ptr.h"
 #include "Shared/scope.h"
+#include "ThriftHandler/MetricsEndpoint.h"
+#include "ThriftHandler/QueryHistory.h"
 
 using namespace ::apache::thrift;
 using namespace ::apache::thrift::concurrency;
@@ -76,6 +86,9 @@ std::atomic<int> g_saw_signal{-1};
 mapd_shared_mutex g_thrift_mutex;
 TThreadedServer* g_thrift_http_server{nullptr};
 TThreadedServer* g_thrift_buf_server{nullptr};
+#ifdef HAVE_THRIFT_NONBLOCKING_SERVER
+TNonblockingServer* g_thrift_nonblocking_server{nullptr};
+#endif
 
 mapd::shared_ptr<DBHandler> g_warmup_handler =
     0;  // global "g_warmup_handler" needed to avoid circular dependency
@@ -298,6 +311,12 @@ void heartbeat() {
     if (bufserv) {
       bufserv->stop();
     }
+#ifdef HAVE_THRIFT_NONBLOCKING_SERVER
+    auto nonblocking_serv = g_thrift_nonblocking_server;
+    if (nonblocking_serv) {
+      nonblocking_serv->stop();
+    }
+#endif
     // main() should return soon after this
   }
 }
@@ -379,6 +398,28 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
   if (g_enable_fsi) {
     foreign_storage::ForeignTableRefreshScheduler::start(g_running);
   }
+  if (g_enable_background_vacuum && !g_cluster) {
+    TableVacuumScheduler::start(g_running);
+  }
+  if (!g_cold_storage_url.empty() && g_cold_storage_fragment_age_days && !g_cluster) {
+    ColdStorageScheduler::start(g_running);
+  }
+  if (g_buffer_pool_compaction_interval_s) {
+    BufferPoolCompactionScheduler::setWaitDuration(g_buffer_pool_compaction_interval_s);
+    BufferPoolCompactionScheduler::start(g_running);
+  }
+  if (g_enable_working_set_snapshot && !g_cluster) {
+    WorkingSetScheduler::setWaitDuration(g_working_set_snapshot_interval_s);
+    WorkingSetScheduler::start(g_running,
+                               prog_config_opts.base_path + "/omnisci_working_set");
+  }
+  if (g_metrics_port) {
+    MetricsEndpoint::start(g_running);
+  }
+  if (g_query_history_size) {
+    QueryHistory::start(g_running,
+                        prog_config_opts.base_path + "/omnisci_query_history");
+  }
 
   mapd::shared_ptr<TServerSocket> serverSocket;
   mapd::shared_ptr<TServerSocket> httpServerSocket;
@@ -415,6 +456,9 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
   ScopeGuard pointer_to_thrift_guard = [] {
     mapd_lock_guard<mapd_shared_mutex> write_lock(g_thrift_mutex);
     g_thrift_buf_server = g_thrift_http_server = nullptr;
+#ifdef HAVE_THRIFT_NONBLOCKING_SERVER
+    g_thrift_nonblocking_server = nullptr;
+#endif
   };
 
   if (prog_config_opts.system_parameters.ha_group_id.empty()) {
@@ -436,6 +480,44 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
                           std::ref(bufServer),
                           prog_config_opts.system_parameters.omnisci_server_port);
 
+    std::thread nonblockingThread;
+#ifdef HAVE_THRIFT_NONBLOCKING_SERVER
+    // Connections of the non-blocking server are multiplexed on a few I/O threads, only
+    // the requests read in full take a worker thread, so idle clients cost a socket.
+    std::unique_ptr<TNonblockingServer> nonblockingServer;
+    if (prog_config_opts.nonblocking_port) {
+      auto thread_manager = ThreadManager::newSimpleThreadManager(
+          std::max(prog_config_opts.nonblocking_server_threads, size_t(1)));
+#ifdef HAVE_THRIFT_THREADFACTORY
+      thread_manager->threadFactory(mapd::make_shared<ThreadFactory>());
+#else
+      thread_manager->threadFactory(mapd::make_shared<PlatformThreadFactory>());
+#endif
+      thread_manager->start();
+      auto nonblocking_socket =
+          mapd::make_shared<TNonblockingServerSocket>(prog_config_opts.nonblocking_port);
+      nonblockingServer = std::make_unique<TNonblockingServer>(
+          processor, bufProtocolFactory, nonblocking_socket, thread_manager);
+      {
+        mapd_lock_guard<mapd_shared_mutex> write_lock(g_thrift_mutex);
+        g_thrift_nonblocking_server = nonblockingServer.get();
+      }
+      nonblockingThread = std::thread([&nonblockingServer, &prog_config_opts] {
+        try {
+          nonblockingServer->serve();
+        } catch (std::exception& e) {
+          LOG(ERROR) << "Exception: " << e.what() << ": port "
+                     << prog_config_opts.nonblocking_port;
+        }
+      });
+    }
+#else
+    if (prog_config_opts.nonblocking_port) {
+      LOG(WARNING) << "The non-blocking server is not available in this build, port "
+                   << prog_config_opts.nonblocking_port << " is not served.";
+    }
+#endif
+
     // TEMPORARY
     auto warmup_queries = [&prog_config_opts]() {
       // run warm up queries if any exists
@@ -468,6 +550,9 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
       warmup_queries();
       bufThread.join();
     }
+    if (nonblockingThread.joinable()) {
+      nonblockingThread.join();
+    }
   } else {  // running ha server
     LOG(FATAL) << "No High Availability module available, please contact OmniSci support";
   }
@@ -480,6 +565,24 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
   if (g_enable_fsi) {
     foreign_storage::ForeignTableRefreshScheduler::stop();
   }
+  if (g_enable_background_vacuum && !g_cluster) {
+    TableVacuumScheduler::stop();
+  }
+  if (!g_cold_storage_url.empty() && g_cold_storage_fragment_age_days && !g_cluster) {
+    ColdStorageScheduler::stop();
+  }
+  if (g_buffer_pool_compaction_interval_s) {
+    BufferPoolCompactionScheduler::stop();
+  }
+  if (g_enable_working_set_snapshot && !g_cluster) {
+    WorkingSetScheduler::stop();
+  }
+  if (g_metrics_port) {
+    MetricsEndpoint::stop();
+  }
+  if (g_query_history_size) {
+    QueryHistory::stop();
+  }
 
   int signum = g_saw_signal;
   if (signum <= 0 || signum == SIGTERM) {
@@ -19,6 +19,9 @@
 #include <sys/fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
 
 #include "Logger/Logger.h"
 
@@ -73,4 +76,25 @@ void close(const int fd) {
   return ::fopen(filename, mode);
 }
 
+int open_for_direct_reads(const char* path, bool& is_direct) {
+#ifdef O_DIRECT
+  const auto fd = ::open(path, O_RDONLY | O_DIRECT);
+  if (fd >= 0) {
+    is_direct = true;
+    return fd;
+  }
+#endif
+  // tmpfs and a few other file systems don't support O_DIRECT
+  is_direct = false;
+  return ::open(path, O_RDONLY);
+}
+
+int64_t pread(const int fd, void* buf, const size_t count, const size_t offset) {
+  ssize_t bytes_read;
+  do {
+    bytes_read = ::pread(fd, buf, count, offset);
+  } while (bytes_read < 0 && errno == EINTR);
+  return bytes_read;
+}
+
 }  // namespace omnisci
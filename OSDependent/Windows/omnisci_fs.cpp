@@ -78,6 +78,17 @@ void close(const int fd) {
   return f;
 }
 
+int open_for_direct_reads(const char* path, bool& is_direct) {
+  // no positional reads, the callers read through their FILE stream instead
+  is_direct = false;
+  return -1;
+}
+
+int64_t pread(const int fd, void* buf, const size_t count, const size_t offset) {
+  CHECK(false);
+  return -1;
+}
+
 int get_page_size() {
   return 4096;  // TODO: reasonable guess for now
 }
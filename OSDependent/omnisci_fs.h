@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 namespace omnisci {
@@ -37,6 +38,15 @@ void close(const int fd);
 
 ::FILE* fopen(const char* filename, const char* mode);
 
+// Opens `path` read only, bypassing the page cache if the OS and the file system allow
+// it, in which case `is_direct` is set and reads must be aligned. Returns -1 where
+// positional reads aren't supported.
+int open_for_direct_reads(const char* path, bool& is_direct);
+
+// Reads up to `count` bytes at `offset` without moving the file position, returns the
+// number of bytes read, 0 at the end of the file or -1 on error.
+int64_t pread(const int fd, void* buf, const size_t count, const size_t offset);
+
 int get_page_size();
 
 }  // namespace omnisci
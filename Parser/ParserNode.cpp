@@ -2121,6 +2121,9 @@ decltype(auto) get_sort_column_def(TableDescriptor& td,
                                    const NameValueAssign* p,
                                    const std::list<ColumnDescriptor>& columns) {
   return get_property_value<StringLiteral>(p, [&td, &columns](const auto sort_upper) {
+    if (!td.zorderColumnIds.empty()) {
+      throw std::runtime_error("SORT_COLUMN and ZORDER_COLUMNS are mutually exclusive");
+    }
     td.sortedColumnId = sort_column_index(sort_upper, columns);
     if (!td.sortedColumnId) {
       throw std::runtime_error("Specified sort column " + sort_upper + " doesn't exist");
@@ -2128,6 +2131,45 @@ decltype(auto) get_sort_column_def(TableDescriptor& td,
   });
 }
 
+decltype(auto) get_zorder_columns_def(TableDescriptor& td,
+                                      const NameValueAssign* p,
+                                      const std::list<ColumnDescriptor>& columns) {
+  return get_property_value<StringLiteral>(p, [&td, &columns](const auto zorder_upper) {
+    if (td.sortedColumnId) {
+      throw std::runtime_error("SORT_COLUMN and ZORDER_COLUMNS are mutually exclusive");
+    }
+    std::vector<std::string> column_names;
+    boost::split(column_names, zorder_upper, boost::is_any_of(","));
+    for (auto& column_name : column_names) {
+      boost::trim(column_name);
+      const auto cd_it = std::find_if(
+          columns.begin(), columns.end(), [&column_name](const ColumnDescriptor& cd) {
+            return boost::to_upper_copy<std::string>(cd.columnName) == column_name;
+          });
+      if (cd_it == columns.end()) {
+        throw std::runtime_error("Specified z-order column " + column_name +
+                                 " doesn't exist");
+      }
+      const auto& ti = cd_it->columnType;
+      if (!ti.is_number() && !ti.is_time() && !ti.is_boolean() &&
+          !(ti.is_string() && ti.get_compression() == kENCODING_DICT)) {
+        throw std::runtime_error("Z-order column " + column_name +
+                                 " must be a number, a date or time or a dictionary "
+                                 "encoded string");
+      }
+      const int column_id = sort_column_index(column_name, columns);
+      if (std::find(td.zorderColumnIds.begin(), td.zorderColumnIds.end(), column_id) !=
+          td.zorderColumnIds.end()) {
+        throw std::runtime_error("Z-order column " + column_name + " is repeated");
+      }
+      td.zorderColumnIds.push_back(column_id);
+    }
+    if (td.zorderColumnIds.size() < 2 || td.zorderColumnIds.size() > 8) {
+      throw std::runtime_error("ZORDER_COLUMNS must name between 2 and 8 columns");
+    }
+  });
+}
+
 static const std::map<const std::string, const TableDefFuncPtr> tableDefFuncMap = {
     {"fragment_size"s, get_frag_size_def},
     {"max_chunk_size"s, get_max_chunk_size_def},
@@ -2137,6 +2179,7 @@ static const std::map<const std::string, const TableDefFuncPtr> tableDefFuncMap
     {"shard_count"s, get_shard_count_def},
     {"vacuum"s, get_vacuum_def},
     {"sort_column"s, get_sort_column_def},
+    {"zorder_columns"s, get_zorder_columns_def},
     {"storage_type"s, get_storage_type}};
 
 void get_table_definitions(TableDescriptor& td,
@@ -2147,7 +2190,8 @@ void get_table_definitions(TableDescriptor& td,
     throw std::runtime_error(
         "Invalid CREATE TABLE option " + *p->get_name() +
         ". Should be FRAGMENT_SIZE, MAX_CHUNK_SIZE, PAGE_SIZE, MAX_ROWS, "
-        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, or STORAGE_TYPE.");
+        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, ZORDER_COLUMNS, or "
+        "STORAGE_TYPE.");
   }
   return it->second(td, p.get(), columns);
 }
@@ -2160,7 +2204,7 @@ void get_table_definitions_for_ctas(TableDescriptor& td,
     throw std::runtime_error(
         "Invalid CREATE TABLE AS option " + *p->get_name() +
         ". Should be FRAGMENT_SIZE, MAX_CHUNK_SIZE, PAGE_SIZE, MAX_ROWS, "
-        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, STORAGE_TYPE or "
+        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, ZORDER_COLUMNS, STORAGE_TYPE or "
         "USE_SHARED_DICTIONARIES.");
   }
   return it->second(td, p.get(), columns);
@@ -3481,7 +3525,7 @@ void AddColumnStmt::execute(const Catalog_Namespace::SessionInfo& session) {
           td->fragmenter)) {
     throw std::runtime_error(
         "Adding columns to a table is not supported when using the \"sort_column\" "
-        "option.");
+        "or \"zorder_columns\" options.");
   }
 
   // Do not take a data write lock, as the fragmenter may call `deleteFragments` during
@@ -4035,6 +4079,13 @@ void CopyTableStmt::execute(const Catalog_Namespace::SessionInfo& session,
           throw std::runtime_error("geo_explode_collections option must be a boolean.");
         }
         copy_params.geo_explode_collections = bool_from_string_literal(str_literal);
+      } else if (boost::iequals(*p->get_name(), "upsert_key")) {
+        const StringLiteral* str_literal =
+            dynamic_cast<const StringLiteral*>(p->get_value());
+        if (str_literal == nullptr) {
+          throw std::runtime_error("'upsert_key' option must be a string");
+        }
+        copy_params.upsert_key = *str_literal->get_stringval();
       } else {
         throw std::runtime_error("Invalid option for COPY: " + *p->get_name());
       }
@@ -4685,9 +4736,12 @@ void ExportQueryStmt::parseOptions(
           file_type = import_export::QueryExporter::FileType::kGeoJSONL;
         } else if (file_type_str == "shapefile") {
           file_type = import_export::QueryExporter::FileType::kShapefile;
+        } else if (file_type_str == "parquet") {
+          file_type = import_export::QueryExporter::FileType::kParquet;
         } else {
           throw std::runtime_error(
-              "File Type option must be 'CSV', 'GeoJSON', 'GeoJSONL' or 'Shapefile'");
+              "File Type option must be 'CSV', 'GeoJSON', 'GeoJSONL', 'Shapefile' or "
+              "'Parquet'");
         }
       } else if (boost::iequals(*p->get_name(), "layer_name")) {
         const StringLiteral* str_literal =
@@ -1193,6 +1193,15 @@ class OptimizeTableStmt : public DDLStmt {
     return false;
   }
 
+  bool shouldCompactDictionaries() const {
+    for (const auto& e : options_) {
+      if (boost::iequals(*(e->get_name()), "COMPACT_DICTIONARIES")) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   void execute(const Catalog_Namespace::SessionInfo& session) override {
     // Should pass optimize params to the table optimizer
     CHECK(false);
@@ -1203,6 +1212,21 @@ class OptimizeTableStmt : public DDLStmt {
   std::list<std::unique_ptr<NameValueAssign>> options_;
 };
 
+class AnalyzeTableStmt : public DDLStmt {
+ public:
+  AnalyzeTableStmt(std::string* table) : table_(table) { CHECK(table_); }
+
+  const std::string getTableName() const { return *(table_.get()); }
+
+  void execute(const Catalog_Namespace::SessionInfo& session) override {
+    // Should compute the column statistics with the table optimizer
+    CHECK(false);
+  }
+
+ private:
+  std::unique_ptr<std::string> table_;
+};
+
 class ValidateStmt : public DDLStmt {
  public:
   ValidateStmt(std::string* type, std::list<NameValueAssign*>* with_opts) : type_(type) {
@@ -1352,7 +1376,7 @@ class DumpRestoreTableStmtBase : public DDLStmt {
     };
     std::unique_ptr<std::list<NameValueAssign*>, decltype(options_deleter)> options_ptr(
         options, options_deleter);
-    std::vector<std::string> allowed_compression_programs{"lz4", "gzip", "none"};
+    std::vector<std::string> allowed_compression_programs{"lz4", "gzip", "zstd", "none"};
     // specialize decompressor or break on osx bsdtar...
     if (options) {
       for (const auto option : *options) {
@@ -1385,12 +1409,24 @@ class DumpRestoreTableStmtBase : public DDLStmt {
         }
       }
     }
-    if (boost::iequals(compression, "none")) {
+    boost::algorithm::to_lower(compression);
+    if (compression == "none") {
       compression.clear();
     } else {
-      std::map<std::string, std::string> decompression{{"lz4", "unlz4"},
-                                                       {"gzip", "gunzip"}};
-      const auto use_program = is_restore ? decompression[compression] : compression;
+      // the multithreaded programs write the same formats, they're used when installed
+      std::map<std::string, std::vector<std::string>> compression_programs{
+          {"lz4", {"lz4"}}, {"gzip", {"pigz", "gzip"}}, {"zstd", {"zstdmt", "zstd"}}};
+      std::map<std::string, std::vector<std::string>> decompression_programs{
+          {"lz4", {"unlz4"}}, {"gzip", {"unpigz", "gunzip"}}, {"zstd", {"unzstd"}}};
+      const auto& programs = is_restore ? decompression_programs[compression]
+                                        : compression_programs[compression];
+      auto use_program = programs.back();
+      for (const auto& program : programs) {
+        if (!boost::process::search_path(program).string().empty()) {
+          use_program = program;
+          break;
+        }
+      }
       const auto prog_path = boost::process::search_path(use_program);
       if (prog_path.string().empty()) {
         throw std::runtime_error("Compression program " + use_program + " is not found.");
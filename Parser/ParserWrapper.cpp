@@ -54,7 +54,9 @@ const std::string ParserWrapper::explain_str = {"explain"};
 const std::string ParserWrapper::calcite_explain_str = {"explain calcite"};
 const std::string ParserWrapper::optimized_explain_str = {"explain optimized"};
 const std::string ParserWrapper::plan_explain_str = {"explain plan"};
+const std::string ParserWrapper::analyze_explain_str = {"explain analyze"};
 const std::string ParserWrapper::optimize_str = {"optimize"};
+const std::string ParserWrapper::analyze_str = {"analyze"};
 const std::string ParserWrapper::validate_str = {"validate"};
 
 extern bool g_enable_fsi;
@@ -98,6 +100,18 @@ ParserWrapper::ParserWrapper(std::string query_string) {
     }
   }
 
+  if (boost::istarts_with(query_string, analyze_explain_str)) {
+    actual_query = boost::trim_copy(query_string.substr(analyze_explain_str.size()));
+    ParserWrapper inner{actual_query};
+    if (inner.is_ddl || inner.is_update_dml) {
+      explain_type_ = ExplainType::Other;
+      return;
+    } else {
+      explain_type_ = ExplainType::Analyze;
+      return;
+    }
+  }
+
   if (boost::istarts_with(query_string, explain_str)) {
     actual_query = boost::trim_copy(query_string.substr(explain_str.size()));
     ParserWrapper inner{actual_query};
@@ -116,6 +130,12 @@ ParserWrapper::ParserWrapper(std::string query_string) {
     return;
   }
 
+  if (boost::istarts_with(query_string, analyze_str)) {
+    query_type_ = QueryType::SchemaWrite;
+    is_analyze = true;
+    return;
+  }
+
   if (boost::istarts_with(query_string, validate_str)) {
     is_validate = true;
     return;
@@ -220,5 +240,6 @@ ExplainInfo ParserWrapper::getExplainInfo() const {
   return {explain_type_ == ExplainType::IR,
           explain_type_ == ExplainType::OptimizedIR,
           explain_type_ == ExplainType::ExecutionPlan,
-          explain_type_ == ExplainType::Calcite};
+          explain_type_ == ExplainType::Calcite,
+          explain_type_ == ExplainType::Analyze};
 }
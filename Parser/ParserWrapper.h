@@ -33,8 +33,11 @@ struct ExplainInfo {
   bool explain_optimized;
   bool explain_plan;
   bool calcite_explain;
+  bool explain_analyze;
 
-  static ExplainInfo defaults() { return ExplainInfo{false, false, false, false}; }
+  static ExplainInfo defaults() {
+    return ExplainInfo{false, false, false, false, false};
+  }
 
   bool justExplain() const { return explain || explain_plan || explain_optimized; }
 
@@ -46,7 +49,15 @@ class ParserWrapper {
   // HACK:  This needs to go away as calcite takes over parsing
   enum class DMLType : int { Insert = 0, Delete, Update, Upsert, NotDML };
 
-  enum class ExplainType { None, IR, OptimizedIR, Calcite, ExecutionPlan, Other };
+  enum class ExplainType {
+    None,
+    IR,
+    OptimizedIR,
+    Calcite,
+    ExecutionPlan,
+    Analyze,
+    Other
+  };
 
   enum class QueryType { Unknown, Read, Write, SchemaRead, SchemaWrite };
 
@@ -67,6 +78,7 @@ class ParserWrapper {
   bool is_copy = false;
   bool is_copy_to = false;
   bool is_optimize = false;
+  bool is_analyze = false;
   bool is_validate = false;
   std::string actual_query;
 
@@ -89,7 +101,8 @@ class ParserWrapper {
   bool isSelectExplain() const {
     return explain_type_ == ExplainType::Calcite || explain_type_ == ExplainType::IR ||
            explain_type_ == ExplainType::OptimizedIR ||
-           explain_type_ == ExplainType::ExecutionPlan;
+           explain_type_ == ExplainType::ExecutionPlan ||
+           explain_type_ == ExplainType::Analyze;
   }
 
   bool isIRExplain() const {
@@ -97,9 +110,10 @@ class ParserWrapper {
   }
 
   bool isCalcitePathPermissable(bool read_only_mode = false) {
-    return is_calcite_ddl_ || (!is_legacy_ddl_ && !is_optimize && !is_validate &&
-                               isCalcitePermissableDml(read_only_mode) &&
-                               !(explain_type_ == ExplainType::Other));
+    return is_calcite_ddl_ ||
+           (!is_legacy_ddl_ && !is_optimize && !is_analyze && !is_validate &&
+            isCalcitePermissableDml(read_only_mode) &&
+            !(explain_type_ == ExplainType::Other));
   }
 
   bool isOtherExplain() const { return explain_type_ == ExplainType::Other; }
@@ -127,7 +141,9 @@ class ParserWrapper {
   static const std::string calcite_explain_str;
   static const std::string optimized_explain_str;
   static const std::string plan_explain_str;
+  static const std::string analyze_explain_str;
   static const std::string optimize_str;
+  static const std::string analyze_str;
   static const std::string validate_str;
 
   bool is_legacy_ddl_ = false;
@@ -26,6 +26,7 @@ static std::set<std::string> reserved_keywords{
     "ACCESS",
     "ADD",  // legacy
     "AMMSC",
+    "ANALYZE",
     "ARCHIVE",
     "ASC",
     "CONTINUE",
@@ -102,7 +102,7 @@ using namespace Parser;
 
 	/* literal keyword tokens */
 
-%token ADD ALL ALTER AMMSC ANY ARCHIVE ARRAY AS ASC AUTHORIZATION BETWEEN BIGINT BOOLEAN BY
+%token ADD ALL ALTER AMMSC ANALYZE ANY ARCHIVE ARRAY AS ASC AUTHORIZATION BETWEEN BIGINT BOOLEAN BY
 %token CASE CAST CHAR_LENGTH CHARACTER CHECK CLOSE CLUSTER COLUMN COMMIT CONTINUE COPY CREATE CURRENT
 %token CURSOR DATABASE DATAFRAME DATE DATETIME DATE_TRUNC DECIMAL DECLARE DEFAULT DELETE DESC DICTIONARY DISTINCT DOUBLE DROP
 %token DUMP ELSE END EXISTS EXTRACT FETCH FIRST FLOAT FOR FOREIGN FOUND FROM
@@ -153,6 +153,7 @@ sql:		/* schema {	$<nodeval>$ = $<nodeval>1; } */
 	| revoke_privileges_statement { $<nodeval>$ = $<nodeval>1; }
 	| grant_role_statement { $<nodeval>$ = $<nodeval>1; }
 	| optimize_table_statement { $<nodeval>$ = $<nodeval>1; }
+	| analyze_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| validate_system_statement { $<nodeval>$ = $<nodeval>1; }
 	| revoke_role_statement { $<nodeval>$ = $<nodeval>1; }
 	| dump_table_statement { $<nodeval>$ = $<nodeval>1; }
@@ -426,6 +427,13 @@ optimize_table_statement:
 		}
 		;
 
+analyze_table_statement:
+		ANALYZE TABLE table
+		{
+			$<nodeval>$ = TrackedPtr<Node>::make(lexer.parsed_node_tokens_, new AnalyzeTableStmt(($<stringval>3)->release()));
+		}
+		;
+
 validate_system_statement:
 		VALIDATE CLUSTER opt_with_option_list
 		{
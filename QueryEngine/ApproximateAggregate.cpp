@@ -0,0 +1,278 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ApproximateAggregate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "QueryEngine/ExecutionKernel.h"
+#include "QueryEngine/GroupByAndAggregate.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "QueryEngine/ResultSet.h"
+#include "Shared/SqlTypesLayout.h"
+
+namespace {
+
+// Below this many sampled fragments the variance between them isn't trusted.
+constexpr size_t kMinSampledFragments{4};
+// 95% confidence intervals
+constexpr double kConfidenceZ{1.96};
+
+bool is_estimated(const TargetInfo& target_info) {
+  return target_info.agg_kind == kCOUNT || target_info.agg_kind == kSUM ||
+         target_info.agg_kind == kAVG;
+}
+
+bool is_supported_target(const TargetInfo& target_info) {
+  if (!target_info.is_agg || is_distinct_target(target_info)) {
+    return false;
+  }
+  switch (target_info.agg_kind) {
+    case kSUM:
+      // sums of floats are kept as floats in the output buffers
+      return !takes_float_argument(target_info);
+    case kCOUNT:
+    case kAVG:
+    case kMIN:
+    case kMAX:
+      return !target_info.sql_type.is_varlen();
+    default:
+      return false;
+  }
+}
+
+std::optional<double> get_value(const TargetValue& tv, const TargetInfo& target_info) {
+  const auto scalar_tv = boost::get<ScalarTargetValue>(&tv);
+  CHECK(scalar_tv);
+  if (const auto ival = boost::get<int64_t>(scalar_tv)) {
+    if (target_info.agg_kind != kCOUNT &&
+        *ival == inline_int_null_val(target_info.sql_type)) {
+      return std::nullopt;
+    }
+    return static_cast<double>(*ival);
+  }
+  if (const auto dval = boost::get<double>(scalar_tv)) {
+    return *dval == NULL_DOUBLE ? std::nullopt : std::make_optional(*dval);
+  }
+  if (const auto fval = boost::get<float>(scalar_tv)) {
+    return *fval == NULL_FLOAT ? std::nullopt : std::make_optional<double>(*fval);
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+ApproximateAggregate::ApproximateAggregate(const double max_relative_error,
+                                           std::vector<TargetInfo> targets,
+                                           std::vector<size_t> fragment_tuple_counts)
+    : max_relative_error_(max_relative_error)
+    , targets_(std::move(targets))
+    , fragment_tuple_counts_(std::move(fragment_tuple_counts)) {
+  CHECK_GT(max_relative_error_, 0.);
+}
+
+std::unique_ptr<ApproximateAggregate> ApproximateAggregate::create(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const ExecutionOptions& eo) {
+  if (eo.approximate_error <= 0. || eo.just_explain ||
+      eo.executor_type != ExecutorType::Native || !eo.outer_fragment_indices.empty() ||
+      query_mem_desc.getQueryDescriptionType() !=
+          QueryDescriptionType::NonGroupedAggregate ||
+      ra_exe_unit.union_all || ra_exe_unit.input_descs.empty() || query_infos.empty() ||
+      ra_exe_unit.input_descs.front().getSourceType() != InputSourceType::TABLE ||
+      ra_exe_unit.input_descs.front().getTableId() <= 0) {
+    return nullptr;
+  }
+  std::vector<TargetInfo> targets;
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    const auto target_info = get_target_info(target_expr, g_bigint_count);
+    if (!is_supported_target(target_info)) {
+      VLOG(1) << "Computing the exact aggregate, " << target_expr->toString()
+              << " can't be estimated from a sample";
+      return nullptr;
+    }
+    targets.push_back(target_info);
+  }
+  CHECK_EQ(query_infos.front().table_id, ra_exe_unit.input_descs.front().getTableId());
+  const auto& fragments = query_infos.front().info.fragments;
+  if (fragments.size() <= kMinSampledFragments) {
+    return nullptr;
+  }
+  std::vector<size_t> fragment_tuple_counts;
+  for (const auto& fragment : fragments) {
+    fragment_tuple_counts.push_back(fragment.getNumTuples());
+  }
+  return std::make_unique<ApproximateAggregate>(
+      eo.approximate_error, std::move(targets), std::move(fragment_tuple_counts));
+}
+
+void ApproximateAggregate::shuffleKernels(
+    std::vector<std::unique_ptr<ExecutionKernel>>& kernels) {
+  // The fragments skipped by their stats don't contribute to the aggregate.
+  population_fragment_count_ = 0;
+  population_tuple_count_ = 0;
+  for (const auto& kernel : kernels) {
+    CHECK(kernel);
+    const auto& frag_list = kernel->getFragmentList();
+    CHECK(!frag_list.empty());
+    for (const auto frag_idx : frag_list.front().fragment_ids) {
+      CHECK_LT(frag_idx, fragment_tuple_counts_.size());
+      ++population_fragment_count_;
+      population_tuple_count_ += fragment_tuple_counts_[frag_idx];
+    }
+  }
+  // The same query samples the same fragments.
+  std::mt19937_64 generator(0);
+  std::shuffle(kernels.begin(), kernels.end(), generator);
+}
+
+void ApproximateAggregate::addResult(const FragmentsList& frag_list,
+                                     const ResultSet& result) {
+  CHECK(!frag_list.empty());
+  Sample sample{0, std::vector<std::optional<double>>(targets_.size())};
+  for (const auto frag_idx : frag_list.front().fragment_ids) {
+    CHECK_LT(frag_idx, fragment_tuple_counts_.size());
+    sample.tuple_count += fragment_tuple_counts_[frag_idx];
+  }
+  const auto row =
+      result.entryCount() ? result.getRowAtNoTranslations(0) : std::vector<TargetValue>{};
+  if (row.size() == targets_.size()) {
+    for (size_t target_idx = 0; target_idx < targets_.size(); ++target_idx) {
+      sample.values[target_idx] = get_value(row[target_idx], targets_[target_idx]);
+    }
+  }
+  std::lock_guard<std::mutex> lock(samples_mutex_);
+  samples_.push_back(std::move(sample));
+  if (samples_.size() < kMinSampledFragments || isDone()) {
+    return;
+  }
+  const auto estimates = computeEstimates();
+  for (size_t target_idx = 0; target_idx < targets_.size(); ++target_idx) {
+    const auto& estimate = estimates[target_idx];
+    if (estimate.error_bound &&
+        *estimate.error_bound > max_relative_error_ * std::abs(estimate.value)) {
+      return;
+    }
+  }
+  VLOG(1) << "Approximate aggregate within " << max_relative_error_
+          << " relative error after " << samples_.size() << " of "
+          << population_fragment_count_ << " fragments";
+  done_.store(true, std::memory_order_release);
+}
+
+void ApproximateAggregate::finalize(ResultSet& result) const {
+  std::lock_guard<std::mutex> lock(samples_mutex_);
+  if (samples_.empty() || samples_.size() >= population_fragment_count_) {
+    return;
+  }
+  size_t sampled_tuple_count{0};
+  for (const auto& sample : samples_) {
+    sampled_tuple_count += sample.tuple_count;
+  }
+  const double scale =
+      sampled_tuple_count
+          ? static_cast<double>(population_tuple_count_) / sampled_tuple_count
+          : static_cast<double>(population_fragment_count_) / samples_.size();
+  result.scaleSingleEntryAggregates(scale);
+  std::vector<std::optional<double>> error_bounds;
+  for (const auto& estimate : computeEstimates()) {
+    error_bounds.push_back(estimate.error_bound);
+  }
+  result.setApproximateErrorBounds(std::move(error_bounds));
+  VLOG(1) << "Approximate aggregate of " << samples_.size() << " of "
+          << population_fragment_count_ << " fragments, scaled by " << scale;
+}
+
+/**
+ * COUNT and SUM are ratio estimates of cluster samples: the sampled aggregate per tuple
+ * times the tuples of the table, with the variance of the residuals of the fragments
+ * around the ratio. AVG is the mean of the fragments weighted by their tuple counts.
+ * Both variances are scaled by the finite population correction, so that the error
+ * bounds shrink to zero as the sample grows to all the fragments.
+ */
+std::vector<ApproximateAggregate::Estimate> ApproximateAggregate::computeEstimates()
+    const {
+  const double sampled_count = samples_.size();
+  const double population_count =
+      std::max(population_fragment_count_, samples_.size());
+  const double correction = 1. - sampled_count / population_count;
+  double sampled_tuples{0.};
+  for (const auto& sample : samples_) {
+    sampled_tuples += sample.tuple_count;
+  }
+  std::vector<Estimate> estimates(targets_.size());
+  for (size_t target_idx = 0; target_idx < targets_.size(); ++target_idx) {
+    const auto& target_info = targets_[target_idx];
+    auto& estimate = estimates[target_idx];
+    if (!is_estimated(target_info)) {
+      continue;
+    }
+    if (target_info.agg_kind == kAVG) {
+      double weight_sum{0.};
+      double weighted_sum{0.};
+      size_t non_null_count{0};
+      for (const auto& sample : samples_) {
+        if (const auto value = sample.values[target_idx]) {
+          weight_sum += sample.tuple_count;
+          weighted_sum += sample.tuple_count * *value;
+          ++non_null_count;
+        }
+      }
+      if (non_null_count < 2 || weight_sum == 0.) {
+        estimate.error_bound = std::numeric_limits<double>::infinity();
+        continue;
+      }
+      estimate.value = weighted_sum / weight_sum;
+      double squared_residuals{0.};
+      for (const auto& sample : samples_) {
+        if (const auto value = sample.values[target_idx]) {
+          const auto residual = sample.tuple_count * (*value - estimate.value);
+          squared_residuals += residual * residual;
+        }
+      }
+      const auto mean_weight = weight_sum / non_null_count;
+      const auto variance = correction * squared_residuals / (non_null_count - 1) /
+                            (non_null_count * mean_weight * mean_weight);
+      estimate.error_bound = kConfidenceZ * std::sqrt(variance);
+      continue;
+    }
+    double sum{0.};
+    for (const auto& sample : samples_) {
+      sum += sample.values[target_idx].value_or(0.);
+    }
+    const auto ratio = sampled_tuples ? sum / sampled_tuples : 0.;
+    estimate.value = ratio * population_tuple_count_;
+    if (sampled_count < 2) {
+      estimate.error_bound = std::numeric_limits<double>::infinity();
+      continue;
+    }
+    double squared_residuals{0.};
+    for (const auto& sample : samples_) {
+      const auto residual =
+          sample.values[target_idx].value_or(0.) - ratio * sample.tuple_count;
+      squared_residuals += residual * residual;
+    }
+    const auto variance = population_count * population_count * correction *
+                          squared_residuals / (sampled_count - 1) / sampled_count;
+    estimate.error_bound = kConfidenceZ * std::sqrt(variance);
+  }
+  return estimates;
+}
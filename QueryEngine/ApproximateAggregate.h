@@ -0,0 +1,105 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ApproximateAggregate.h
+ * @brief   Computes a non grouped aggregate over a growing sample of the outer fragments
+ *          until its confidence intervals are within the requested relative error.
+ *
+ * The kernels are launched in a random order, so that the fragments scanned at any time
+ * are a random sample of the fragments of the table. Each kernel adds the aggregate of
+ * its fragment to the sample, and once the 95% confidence interval of every COUNT, SUM
+ * and AVG target is within the relative error of its estimate, the kernels which haven't
+ * started yet are skipped. COUNT and SUM are extrapolated from the tuples scanned to the
+ * tuples of the table, the intervals come from the variance between the fragments.
+ * AVG, MIN and MAX are those of the sample.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/Descriptors/QueryFragmentDescriptor.h"
+#include "QueryEngine/InputMetadata.h"
+#include "Shared/TargetInfo.h"
+
+class ExecutionKernel;
+class QueryMemoryDescriptor;
+struct RelAlgExecutionUnit;
+class ResultSet;
+
+class ApproximateAggregate {
+ public:
+  ApproximateAggregate(const double max_relative_error,
+                       std::vector<TargetInfo> targets,
+                       std::vector<size_t> fragment_tuple_counts);
+
+  /**
+   * An approximate aggregate for the non grouped aggregates of non distinct COUNT, SUM,
+   * AVG, MIN and MAX on a physical outer table when the execution options ask for a
+   * relative error, nullptr for any other work unit.
+   */
+  static std::unique_ptr<ApproximateAggregate> create(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::vector<InputTableInfo>& query_infos,
+      const QueryMemoryDescriptor& query_mem_desc,
+      const ExecutionOptions& eo);
+
+  // Shuffles the kernels, whose outer fragments are the ones the sample is drawn from.
+  void shuffleKernels(std::vector<std::unique_ptr<ExecutionKernel>>& kernels);
+
+  // Whether the estimates are within the error, the kernels not started yet are skipped.
+  bool isDone() const { return done_.load(std::memory_order_acquire); }
+
+  // Adds the aggregate of the outer fragments of a kernel to the sample.
+  void addResult(const FragmentsList& frag_list, const ResultSet& result);
+
+  // Extrapolates the reduced aggregate of the sample to the table and sets its error
+  // bounds, unless all the fragments have been scanned.
+  void finalize(ResultSet& result) const;
+
+ private:
+  struct Sample {
+    size_t tuple_count;
+    // aggregate of the fragment, no value for nulls
+    std::vector<std::optional<double>> values;
+  };
+
+  struct Estimate {
+    double value{0.};
+    // half width of the confidence interval, no value for MIN and MAX
+    std::optional<double> error_bound;
+  };
+
+  std::vector<Estimate> computeEstimates() const;
+
+  const double max_relative_error_;
+  const std::vector<TargetInfo> targets_;
+  const std::vector<size_t> fragment_tuple_counts_;
+  // fragments and tuples of the kernels
+  size_t population_fragment_count_{0};
+  size_t population_tuple_count_{0};
+
+  mutable std::mutex samples_mutex_;
+  std::vector<Sample> samples_;
+  std::atomic<bool> done_{false};
+};
@@ -593,6 +593,97 @@ llvm::Value* CodeGenerator::codegenDeciDiv(const Analyzer::BinOper* bin_oper,
                     /*upscale*/ false);
 }
 
+// Whether `uoper` casts the product of two decimals down to a smaller scale, which is
+// then computed by codegenDecimalMulDownscale. CPU only, 128-bit divisions aren't
+// available on GPU.
+bool CodeGenerator::isDecimalMulDownscale(const Analyzer::UOper* uoper,
+                                          const CompilationOptions& co) {
+  if (co.device_type != ExecutorDeviceType::CPU) {
+    return false;
+  }
+  const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(uoper->get_operand());
+  if (!bin_oper || bin_oper->get_optype() != kMULTIPLY) {
+    return false;
+  }
+  const auto& ti = uoper->get_type_info();
+  const auto& product_ti = bin_oper->get_type_info();
+  return ti.is_decimal() && product_ti.is_decimal() &&
+         bin_oper->get_left_operand()->get_type_info().is_decimal() &&
+         bin_oper->get_right_operand()->get_type_info().is_decimal() &&
+         product_ti.get_scale() > ti.get_scale() &&
+         product_ti.get_scale() - ti.get_scale() <= 18;
+}
+
+// The product of two decimals cast down to the scale of `ti`. The product is computed on
+// 128 bits and rounded to the smaller scale before its range is checked, so that the
+// product of high precision decimals doesn't overflow when the result fits.
+llvm::Value* CodeGenerator::codegenDecimalMulDownscale(const Analyzer::BinOper* bin_oper,
+                                                       const SQLTypeInfo& ti,
+                                                       const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(cgen_state_);
+  const auto lhs = bin_oper->get_left_operand();
+  const auto rhs = bin_oper->get_right_operand();
+  const auto& lhs_ti = lhs->get_type_info();
+  const auto& rhs_ti = rhs->get_type_info();
+  const auto lhs_lv = codegen(lhs, true, co).front();
+  const auto rhs_lv = codegen(rhs, true, co).front();
+  auto& builder = cgen_state_->ir_builder_;
+  const auto i128_type = get_int_type(128, cgen_state_->context_);
+  const auto product_lv = builder.CreateMul(builder.CreateSExt(lhs_lv, i128_type),
+                                            builder.CreateSExt(rhs_lv, i128_type));
+  // rounded like scale_decimal_down_nullable
+  const auto scale = exp_to_scale(bin_oper->get_type_info().get_scale() - ti.get_scale());
+  const auto half_scale_lv = llvm::ConstantInt::get(i128_type, scale >> 1);
+  const auto rounded_lv =
+      builder.CreateSelect(builder.CreateICmpSGE(product_lv,
+                                                 llvm::ConstantInt::get(i128_type, 0)),
+                           builder.CreateAdd(product_lv, half_scale_lv),
+                           builder.CreateSub(product_lv, half_scale_lv));
+  const auto result_lv =
+      builder.CreateSDiv(rounded_lv, llvm::ConstantInt::get(i128_type, scale));
+
+  llvm::Value* is_null_lv{nullptr};
+  if (!lhs_ti.get_notnull()) {
+    is_null_lv = codegenIsNullNumber(lhs_lv, lhs_ti);
+  }
+  if (!rhs_ti.get_notnull()) {
+    const auto rhs_is_null_lv = codegenIsNullNumber(rhs_lv, rhs_ti);
+    is_null_lv =
+        is_null_lv ? builder.CreateOr(is_null_lv, rhs_is_null_lv) : rhs_is_null_lv;
+  }
+
+  // the minimum of the type is its null sentinel
+  llvm::Value* chosen_max{nullptr};
+  llvm::Value* chosen_min{nullptr};
+  std::tie(chosen_max, chosen_min) =
+      cgen_state_->inlineIntMaxMin(ti.get_logical_size(), true);
+  const auto max_lv = llvm::ConstantInt::get(
+      i128_type, static_cast<llvm::ConstantInt*>(chosen_max)->getSExtValue(), true);
+  const auto min_lv = llvm::ConstantInt::get(
+      i128_type, static_cast<llvm::ConstantInt*>(chosen_min)->getSExtValue(), true);
+  auto detected = builder.CreateOr(builder.CreateICmpSGT(result_lv, max_lv),
+                                   builder.CreateICmpSLE(result_lv, min_lv));
+  if (is_null_lv) {
+    detected = builder.CreateAnd(detected, builder.CreateNot(is_null_lv));
+  }
+  cgen_state_->needs_error_check_ = true;
+  auto mul_ok = llvm::BasicBlock::Create(
+      cgen_state_->context_, "mul_ok", cgen_state_->current_func_);
+  auto mul_fail = llvm::BasicBlock::Create(
+      cgen_state_->context_, "mul_fail", cgen_state_->current_func_);
+  builder.CreateCondBr(detected, mul_fail, mul_ok);
+  builder.SetInsertPoint(mul_fail);
+  builder.CreateRet(cgen_state_->llInt(Executor::ERR_OVERFLOW_OR_UNDERFLOW));
+  builder.SetInsertPoint(mul_ok);
+
+  const auto ret = builder.CreateTrunc(
+      result_lv, get_int_type(get_bit_width(ti), cgen_state_->context_));
+  if (!is_null_lv) {
+    return ret;
+  }
+  return builder.CreateSelect(is_null_lv, cgen_state_->inlineIntNull(ti), ret);
+}
+
 llvm::Value* CodeGenerator::codegenMod(llvm::Value* lhs_lv,
                                        llvm::Value* rhs_lv,
                                        const std::string& null_typename,
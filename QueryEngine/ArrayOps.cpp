@@ -124,6 +124,11 @@ VARLEN_NOTNULL_ARRAY_AT(double)
 
 #undef VARLEN_NOTNULL_ARRAY_AT
 
+// The elements are compared a block at a time, without branches within a block, so
+// that the comparisons of a block are vectorized. The first block with a match, or with
+// a mismatch for ALL, ends the loop.
+#define ARRAY_OPS_BLOCK_SIZE 16
+
 #define ARRAY_ANY(type, needle_type, oper_name, oper)                    \
   extern "C" DEVICE bool array_any_##oper_name##_##type##_##needle_type( \
       int8_t* chunk_iter_,                                               \
@@ -135,9 +140,17 @@ VARLEN_NOTNULL_ARRAY_AT(double)
     bool is_end;                                                         \
     ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                \
     const size_t elem_count = ad.length / sizeof(type);                  \
-    for (size_t i = 0; i < elem_count; ++i) {                            \
-      const needle_type val = reinterpret_cast<type*>(ad.pointer)[i];    \
-      if (val != null_val && val oper needle) {                          \
+    const type* elems = reinterpret_cast<const type*>(ad.pointer);       \
+    for (size_t i = 0; i < elem_count; i += ARRAY_OPS_BLOCK_SIZE) {      \
+      const size_t block_end = i + ARRAY_OPS_BLOCK_SIZE < elem_count     \
+                                   ? i + ARRAY_OPS_BLOCK_SIZE            \
+                                   : elem_count;                         \
+      bool any_match = false;                                            \
+      for (size_t j = i; j < block_end; ++j) {                           \
+        const needle_type val = elems[j];                                \
+        any_match |= (val != null_val) & (val oper needle);              \
+      }                                                                  \
+      if (any_match) {                                                   \
         return true;                                                     \
       }                                                                  \
     }                                                                    \
@@ -155,9 +168,17 @@ VARLEN_NOTNULL_ARRAY_AT(double)
     bool is_end;                                                         \
     ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                \
     const size_t elem_count = ad.length / sizeof(type);                  \
-    for (size_t i = 0; i < elem_count; ++i) {                            \
-      const needle_type val = reinterpret_cast<type*>(ad.pointer)[i];    \
-      if (!(val != null_val && val oper needle)) {                       \
+    const type* elems = reinterpret_cast<const type*>(ad.pointer);       \
+    for (size_t i = 0; i < elem_count; i += ARRAY_OPS_BLOCK_SIZE) {      \
+      const size_t block_end = i + ARRAY_OPS_BLOCK_SIZE < elem_count     \
+                                   ? i + ARRAY_OPS_BLOCK_SIZE            \
+                                   : elem_count;                         \
+      bool all_match = true;                                             \
+      for (size_t j = i; j < block_end; ++j) {                           \
+        const needle_type val = elems[j];                                \
+        all_match &= (val != null_val) & (val oper needle);              \
+      }                                                                  \
+      if (!all_match) {                                                  \
         return false;                                                    \
       }                                                                  \
     }                                                                    \
@@ -223,6 +244,7 @@ ARRAY_ALL_ANY_ALL_TYPES(ge, >=, double)
 #undef ARRAY_ALL_ANY_ALL_TYPES
 #undef ARRAY_ALL
 #undef ARRAY_ANY
+#undef ARRAY_OPS_BLOCK_SIZE
 
 #define ARRAY_AT_CHECKED(type)                                                    \
   extern "C" DEVICE type array_at_##type##_checked(int8_t* chunk_iter_,           \
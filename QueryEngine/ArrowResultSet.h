@@ -33,6 +33,16 @@
 
 static_assert(ARROW_VERSION >= 16000, "Apache Arrow v0.16.0 or above is required.");
 
+extern size_t g_arrow_result_batch_entries;
+
+namespace import_export {
+class QueryExporterParquet;
+}  // namespace import_export
+
+namespace EmbeddedDatabase {
+class CursorImpl;
+}  // namespace EmbeddedDatabase
+
 // TODO(wamsi): ValueArray is not optimal. Remove it and inherrit from base vector class.
 using ValueArray = boost::variant<std::vector<bool>,
                                   std::vector<int8_t>,
@@ -191,6 +201,11 @@ class ArrowResultSetConverter {
 
   ArrowResult getArrowResult() const;
 
+  // Splits the GPU result into as many partitions of consecutive entries as there are
+  // devices, serialized to the devices in order, instead of serializing it to device_id.
+  std::vector<ArrowResult> getArrowPartitions(
+      const std::vector<int32_t>& device_ids) const;
+
   // TODO(adb): Proper namespacing for this set of functionality. For now, make this
   // public and leverage the converter class as namespace
   struct ColumnBuilder {
@@ -198,6 +213,8 @@ class ArrowResultSetConverter {
     std::unique_ptr<arrow::ArrayBuilder> builder;
     SQLTypeInfo col_type;
     SQLTypes physical_type;
+    // the strings of a dictionary encoded column, in the order of their ids
+    std::shared_ptr<arrow::Array> dictionary;
   };
 
  private:
@@ -208,8 +225,18 @@ class ArrowResultSetConverter {
 
   std::shared_ptr<arrow::RecordBatch> convertToArrow() const;
 
+  std::shared_ptr<arrow::Schema> getArrowSchema() const;
+
+  size_t getEntryCount() const;
+
+  // Converts the entry_count entries of the result set from first_entry on.
   std::shared_ptr<arrow::RecordBatch> getArrowBatch(
-      const std::shared_ptr<arrow::Schema>& schema) const;
+      const std::shared_ptr<arrow::Schema>& schema,
+      const size_t first_entry,
+      const size_t entry_count) const;
+
+  ArrowResult getGpuArrowResult(const arrow::RecordBatch& record_batch,
+                                const int32_t device_id) const;
 
   std::shared_ptr<arrow::Field> makeField(const std::string name,
                                           const SQLTypeInfo& target_type) const;
@@ -245,6 +272,8 @@ class ArrowResultSetConverter {
   mutable std::vector<std::unique_ptr<uint8_t[]>> is_valid_;
 
   friend class ArrowResultSet;
+  friend class import_export::QueryExporterParquet;
+  friend class EmbeddedDatabase::CursorImpl;
 };
 
 template <typename T>
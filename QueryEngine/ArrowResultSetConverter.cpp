@@ -48,6 +48,8 @@ using key_t = size_t;
 
 #define ARROW_RECORDBATCH_MAKE arrow::RecordBatch::Make
 
+size_t g_arrow_result_batch_entries{0};
+
 using namespace arrow;
 
 namespace {
@@ -158,8 +160,10 @@ using null_type_t = typename null_type<TYPE>::type;
 template <typename C_TYPE, typename ARROW_TYPE = typename CTypeTraits<C_TYPE>::ArrowType>
 void convert_column(ResultSetPtr result,
                     size_t col,
+                    const std::shared_ptr<DataType>& type,
                     std::unique_ptr<int8_t[]>& values,
                     std::unique_ptr<uint8_t[]>& is_valid,
+                    size_t first_entry,
                     size_t entry_count,
                     std::shared_ptr<Array>& out) {
   CHECK(sizeof(C_TYPE) == result->getColType(col).get_size());
@@ -168,8 +172,9 @@ void convert_column(ResultSetPtr result,
 
   const int8_t* data_ptr;
   if (result->isZeroCopyColumnarConversionPossible(col)) {
-    data_ptr = result->getColumnarBuffer(col);
+    data_ptr = result->getColumnarBuffer(col) + first_entry * sizeof(C_TYPE);
   } else {
+    CHECK_EQ(first_entry, size_t(0));
     values.reset(new int8_t[entry_count * sizeof(C_TYPE)]);
     result->copyColumnIntoBuffer(col, values.get(), entry_count * sizeof(C_TYPE));
     data_ptr = values.get();
@@ -233,9 +238,10 @@ void convert_column(ResultSetPtr result,
   if (null_count) {
     std::shared_ptr<Buffer> null_bitmap(
         new Buffer(is_valid.get(), (entry_count + 7) / 8));
-    out.reset(new NumericArray<ARROW_TYPE>(entry_count, data, null_bitmap, null_count));
+    out.reset(
+        new NumericArray<ARROW_TYPE>(type, entry_count, data, null_bitmap, null_count));
   } else {
-    out.reset(new NumericArray<ARROW_TYPE>(entry_count, data));
+    out.reset(new NumericArray<ARROW_TYPE>(type, entry_count, data));
   }
 }
 
@@ -316,10 +322,31 @@ key_t get_and_copy_to_shm(const std::shared_ptr<Buffer>& data) {
 //! upon deserialization, and will be automatically freed when they go out of scope.
 ArrowResult ArrowResultSetConverter::getArrowResult() const {
   auto timer = DEBUG_TIMER(__func__);
-  std::shared_ptr<arrow::RecordBatch> record_batch = convertToArrow();
+  const auto entry_count = getEntryCount();
+  // results serialized on the CPU are converted and serialized a record batch at a time,
+  // so that the arrow arrays of only one batch are held at once
+  const bool batched = (device_type_ == ExecutorDeviceType::CPU ||
+                        transport_method_ == ArrowTransport::WIRE) &&
+                       g_arrow_result_batch_entries > 0 &&
+                       entry_count > g_arrow_result_batch_entries;
+  const auto schema = getArrowSchema();
+  std::shared_ptr<arrow::RecordBatch> record_batch = getArrowBatch(
+      schema, 0, batched ? g_arrow_result_batch_entries : entry_count);
 
   if (device_type_ == ExecutorDeviceType::CPU ||
       transport_method_ == ArrowTransport::WIRE) {
+    std::vector<std::shared_ptr<Buffer>> serialized_batches;
+    const auto write_records = [&](io::OutputStream* stream) {
+      if (serialized_batches.empty()) {
+        ARROW_THROW_NOT_OK(ipc::SerializeRecordBatch(
+            *record_batch, arrow::ipc::IpcWriteOptions::Defaults(), stream));
+        return;
+      }
+      for (const auto& serialized_batch : serialized_batches) {
+        ARROW_THROW_NOT_OK(stream->Write(serialized_batch));
+      }
+    };
+
     const auto getWireResult =
         [&](const int64_t schema_size,
             const int64_t dict_size,
@@ -344,8 +371,7 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
 
       io::FixedSizeBufferWriter stream(
           SliceMutableBuffer(serialized_records, schema_size + dict_size));
-      ARROW_THROW_NOT_OK(ipc::SerializeRecordBatch(
-          *record_batch, arrow::ipc::IpcWriteOptions::Defaults(), &stream));
+      write_records(&stream);
 
       return {std::vector<char>(0),
               0,
@@ -379,8 +405,7 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
 
       io::FixedSizeBufferWriter stream(
           SliceMutableBuffer(serialized_records, schema_size + dict_size));
-      ARROW_THROW_NOT_OK(ipc::SerializeRecordBatch(
-          *record_batch, arrow::ipc::IpcWriteOptions::Defaults(), &stream));
+      write_records(&stream);
       memcpy(&record_handle_buffer[0],
              reinterpret_cast<const unsigned char*>(&records_shm_key),
              sizeof(key_t));
@@ -419,7 +444,30 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
         ipc::SerializeSchema(*record_batch->schema(), nullptr, default_memory_pool()));
     schema_size = serialized_schema->size();
 
-    ARROW_THROW_NOT_OK(ipc::GetRecordBatchSize(*record_batch, &records_size));
+    if (batched) {
+      auto timer = DEBUG_TIMER("convert and serialize batches");
+      for (size_t first_entry = 0; first_entry < entry_count;
+           first_entry += g_arrow_result_batch_entries) {
+        if (!record_batch) {
+          record_batch = getArrowBatch(
+              schema,
+              first_entry,
+              std::min(g_arrow_result_batch_entries, entry_count - first_entry));
+        }
+        std::shared_ptr<Buffer> serialized_batch;
+        ARROW_ASSIGN_OR_THROW(
+            serialized_batch,
+            ipc::SerializeRecordBatch(*record_batch, ipc::IpcWriteOptions::Defaults()));
+        records_size += serialized_batch->size();
+        serialized_batches.push_back(serialized_batch);
+        // the arrays of the batch may point into the buffers of the columnar converter
+        record_batch.reset();
+        values_.clear();
+        is_valid_.clear();
+      }
+    } else {
+      ARROW_THROW_NOT_OK(ipc::GetRecordBatchSize(*record_batch, &records_size));
+    }
 
     switch (transport_method_) {
       case ArrowTransport::WIRE:
@@ -432,9 +480,38 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
         UNREACHABLE();
     }
   }
-#ifdef HAVE_CUDA
   CHECK(device_type_ == ExecutorDeviceType::GPU);
+  return getGpuArrowResult(*record_batch, device_id_);
+}
+
+std::vector<ArrowResult> ArrowResultSetConverter::getArrowPartitions(
+    const std::vector<int32_t>& device_ids) const {
+  auto timer = DEBUG_TIMER(__func__);
+  CHECK(device_type_ == ExecutorDeviceType::GPU);
+  CHECK(!device_ids.empty());
+  const auto entry_count = getEntryCount();
+  const auto schema = getArrowSchema();
+  const size_t partition_entries =
+      (entry_count + device_ids.size() - 1) / device_ids.size();
+  std::vector<ArrowResult> partitions;
+  for (size_t i = 0; i < device_ids.size(); ++i) {
+    const auto first_entry = std::min(entry_count, i * partition_entries);
+    {
+      const auto record_batch = getArrowBatch(
+          schema, first_entry, std::min(partition_entries, entry_count - first_entry));
+      partitions.push_back(getGpuArrowResult(*record_batch, device_ids[i]));
+    }
+    // the partition was copied to its device, the arrays may point into these buffers
+    values_.clear();
+    is_valid_.clear();
+  }
+  return partitions;
+}
 
+ArrowResult ArrowResultSetConverter::getGpuArrowResult(
+    const arrow::RecordBatch& record_batch,
+    const int32_t device_id) const {
+#ifdef HAVE_CUDA
   // Copy the schema to the schema handle
   auto out_stream_result = arrow::io::BufferOutputStream::Create(1024);
   ARROW_THROW_NOT_OK(out_stream_result.status());
@@ -444,7 +521,7 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
   arrow::ipc::DictionaryMemo serialized_memo;
 
   arrow::ipc::IpcPayload schema_payload;
-  ARROW_THROW_NOT_OK(arrow::ipc::GetSchemaPayload(*record_batch->schema(),
+  ARROW_THROW_NOT_OK(arrow::ipc::GetSchemaPayload(record_batch.schema(),
                                                   arrow::ipc::IpcWriteOptions::Defaults(),
                                                   &serialized_memo,
                                                   &schema_payload));
@@ -454,13 +531,13 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
                                                  out_stream.get(),
                                                  &schema_payload_length));
 
-  ARROW_THROW_NOT_OK(CollectDictionaries(*record_batch, &current_memo));
+  ARROW_THROW_NOT_OK(CollectDictionaries(record_batch, &current_memo));
 
   // now try a dictionary
   std::shared_ptr<arrow::Schema> dummy_schema;
   std::vector<std::shared_ptr<arrow::RecordBatch>> dict_batches;
-  for (int i = 0; i < record_batch->schema()->num_fields(); i++) {
-    auto field = record_batch->schema()->field(i);
+  for (int i = 0; i < record_batch.schema()->num_fields(); i++) {
+    auto field = record_batch.schema()->field(i);
     if (field->type()->id() == arrow::Type::DICTIONARY) {
       int64_t dict_id = -1;
       ARROW_THROW_NOT_OK(current_memo.GetId(field.get(), &dict_id));
@@ -497,11 +574,11 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
   arrow::cuda::CudaDeviceManager* manager;
   ARROW_ASSIGN_OR_THROW(manager, arrow::cuda::CudaDeviceManager::Instance());
   std::shared_ptr<arrow::cuda::CudaContext> context;
-  ARROW_ASSIGN_OR_THROW(context, manager->GetContext(device_id_));
+  ARROW_ASSIGN_OR_THROW(context, manager->GetContext(device_id));
 
   std::shared_ptr<arrow::cuda::CudaBuffer> device_serialized;
   ARROW_ASSIGN_OR_THROW(device_serialized,
-                        SerializeRecordBatch(*record_batch, context.get()));
+                        SerializeRecordBatch(record_batch, context.get()));
 
   std::shared_ptr<arrow::cuda::CudaIpcMemHandle> cuda_handle;
   ARROW_ASSIGN_OR_THROW(cuda_handle, device_serialized->ExportForIpc());
@@ -553,6 +630,10 @@ ArrowResultSetConverter::getSerializedArrowOutput(
 
 std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::convertToArrow() const {
   auto timer = DEBUG_TIMER(__func__);
+  return getArrowBatch(getArrowSchema(), 0, getEntryCount());
+}
+
+std::shared_ptr<arrow::Schema> ArrowResultSetConverter::getArrowSchema() const {
   const auto col_count = results_->colCount();
   std::vector<std::shared_ptr<arrow::Field>> fields;
   CHECK(col_names_.empty() || col_names_.size() == col_count);
@@ -560,16 +641,21 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::convertToArrow() co
     const auto ti = results_->getColType(i);
     fields.push_back(makeField(col_names_.empty() ? "" : col_names_[i], ti));
   }
-  return getArrowBatch(arrow::schema(fields));
+  return arrow::schema(fields);
+}
+
+size_t ArrowResultSetConverter::getEntryCount() const {
+  return top_n_ < 0 ? results_->entryCount()
+                    : std::min(size_t(top_n_), results_->entryCount());
 }
 
 std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
-    const std::shared_ptr<arrow::Schema>& schema) const {
+    const std::shared_ptr<arrow::Schema>& schema,
+    const size_t first_entry,
+    const size_t entry_count) const {
   std::vector<std::shared_ptr<arrow::Array>> result_columns;
 
-  const size_t entry_count = top_n_ < 0
-                                 ? results_->entryCount()
-                                 : std::min(size_t(top_n_), results_->entryCount());
+  CHECK_LE(first_entry + entry_count, results_->entryCount());
   if (!entry_count) {
     return ARROW_RECORDBATCH_MAKE(schema, 0, result_columns);
   }
@@ -695,45 +781,103 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
       }
 
       const auto& column = builders[col];
+      auto type = column.field->type();
+      if (type->id() == Type::DICTIONARY) {
+        // the string ids are the indices into the whole string dictionary
+        type = static_cast<const DictionaryType&>(*type).index_type();
+      }
       switch (column.physical_type) {
         case kTINYINT:
-          convert_column<int8_t>(
-              results_, col, values[col], is_valid[col], entry_count, result[col]);
+          convert_column<int8_t>(results_,
+                                 col,
+                                 type,
+                                 values[col],
+                                 is_valid[col],
+                                 first_entry,
+                                 entry_count,
+                                 result[col]);
           break;
         case kSMALLINT:
-          convert_column<int16_t>(
-              results_, col, values[col], is_valid[col], entry_count, result[col]);
+          convert_column<int16_t>(results_,
+                                  col,
+                                  type,
+                                  values[col],
+                                  is_valid[col],
+                                  first_entry,
+                                  entry_count,
+                                  result[col]);
           break;
         case kINT:
-          convert_column<int32_t>(
-              results_, col, values[col], is_valid[col], entry_count, result[col]);
+          convert_column<int32_t>(results_,
+                                  col,
+                                  type,
+                                  values[col],
+                                  is_valid[col],
+                                  first_entry,
+                                  entry_count,
+                                  result[col]);
           break;
         case kBIGINT:
-          convert_column<int64_t>(
-              results_, col, values[col], is_valid[col], entry_count, result[col]);
+          convert_column<int64_t>(results_,
+                                  col,
+                                  type,
+                                  values[col],
+                                  is_valid[col],
+                                  first_entry,
+                                  entry_count,
+                                  result[col]);
           break;
         case kFLOAT:
-          convert_column<float>(
-              results_, col, values[col], is_valid[col], entry_count, result[col]);
+          convert_column<float>(results_,
+                                col,
+                                type,
+                                values[col],
+                                is_valid[col],
+                                first_entry,
+                                entry_count,
+                                result[col]);
           break;
         case kDOUBLE:
-          convert_column<double>(
-              results_, col, values[col], is_valid[col], entry_count, result[col]);
+          convert_column<double>(results_,
+                                 col,
+                                 type,
+                                 values[col],
+                                 is_valid[col],
+                                 first_entry,
+                                 entry_count,
+                                 result[col]);
+          break;
+        case kTIMESTAMP:
+          convert_column<int64_t, TimestampType>(results_,
+                                                 col,
+                                                 type,
+                                                 values[col],
+                                                 is_valid[col],
+                                                 first_entry,
+                                                 entry_count,
+                                                 result[col]);
           break;
         default:
           throw std::runtime_error(column.col_type.get_type_name() +
                                    " is not supported in Arrow column converter.");
       }
+      if (column.field->type()->id() == Type::DICTIONARY) {
+        CHECK(column.dictionary);
+        result[col] = std::make_shared<DictionaryArray>(
+            column.field->type(), result[col], column.dictionary);
+      }
     }
   };
 
   std::vector<std::shared_ptr<ValueArray>> column_values(col_count, nullptr);
   std::vector<std::shared_ptr<std::vector<bool>>> null_bitmaps(col_count, nullptr);
   const bool multithreaded = entry_count > 10000 && !results_->isTruncated();
+  // only the columns converted without a copy can be converted for a part of the entries
+  const bool whole_result = !first_entry && entry_count == results_->entryCount();
   bool use_columnar_converter = results_->isDirectColumnarConversionPossible() &&
+                                results_->didOutputColumnar() &&
                                 results_->getQueryMemDesc().getQueryDescriptionType() ==
-                                    QueryDescriptionType::Projection &&
-                                entry_count == results_->entryCount();
+                                    QueryDescriptionType::Projection;
   std::vector<bool> non_lazy_cols;
   if (use_columnar_converter) {
     auto timer = DEBUG_TIMER("columnar converter");
@@ -752,13 +896,24 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
         case kBOOLEAN:
         case kTIME:
         case kDATE:
-        case kTIMESTAMP:
           is_lazy = true;
           break;
         default:
           break;
       }
-      if (builders[i].field->type()->id() == Type::DICTIONARY) {
+      // timestamps and string ids are wrapped as they are, so they have to be stored at
+      // the width of their arrow type
+      if ((builders[i].physical_type == kTIMESTAMP ||
+           builders[i].col_type.is_dict_encoded_string()) &&
+          static_cast<size_t>(results_->getPaddedSlotWidthBytes(i)) !=
+              builders[i].col_type.get_size()) {
+        is_lazy = true;
+      }
+      if (builders[i].col_type.is_dict_encoded_string() &&
+          builders[i].physical_type != kINT) {
+        is_lazy = true;
+      }
+      if (!whole_result && !results_->isZeroCopyColumnarConversionPossible(i)) {
         is_lazy = true;
       }
       non_lazy_cols.emplace_back(!is_lazy);
@@ -815,9 +970,10 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
       std::vector<std::vector<std::shared_ptr<std::vector<bool>>>> null_bitmap_segs(
           cpu_count, std::vector<std::shared_ptr<std::vector<bool>>>(col_count, nullptr));
       const auto stride = (entry_count + cpu_count - 1) / cpu_count;
-      for (size_t i = 0, start_entry = 0; start_entry < entry_count;
+      const auto last_entry = first_entry + entry_count;
+      for (size_t i = 0, start_entry = first_entry; start_entry < last_entry;
            ++i, start_entry += stride) {
-        const auto end_entry = std::min(entry_count, start_entry + stride);
+        const auto end_entry = std::min(last_entry, start_entry + stride);
         child_threads.push_back(std::async(std::launch::async,
                                            fetch,
                                            std::ref(column_value_segs[i]),
@@ -845,8 +1001,11 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
         }
       }
     } else {
-      row_count =
-          fetch(column_values, null_bitmaps, non_lazy_cols, size_t(0), entry_count);
+      row_count = fetch(column_values,
+                        null_bitmaps,
+                        non_lazy_cols,
+                        first_entry,
+                        first_entry + entry_count);
       {
         auto timer = DEBUG_TIMER("append rows to arrow single thread");
         for (int i = 0; i < schema->num_fields(); ++i) {
@@ -1012,6 +1171,7 @@ void ArrowResultSetConverter::initializeColumnBuilder(
     CHECK(dict_builder);
 
     ARROW_THROW_NOT_OK(dict_builder->InsertMemoValues(*string_array));
+    column_builder.dictionary = string_array;
   } else {
     ARROW_THROW_NOT_OK(
         arrow::MakeBuilder(default_memory_pool(), value_type, &column_builder.builder));
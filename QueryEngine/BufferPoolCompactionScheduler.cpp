@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BufferPoolCompactionScheduler.h"
+
+#include "Logger/Logger.h"
+#include "QueryEngine/Execute.h"
+
+size_t g_buffer_pool_compaction_interval_s{0};
+
+void BufferPoolCompactionScheduler::start(std::atomic<bool>& is_program_running) {
+  if (!is_scheduler_running_) {
+    stop_requested_ = false;
+    scheduler_thread_ = std::thread([&is_program_running]() {
+      while (is_program_running) {
+        for (const auto memory_level : {Data_Namespace::MemoryLevel::CPU_LEVEL,
+                                        Data_Namespace::MemoryLevel::GPU_LEVEL}) {
+          try {
+            Executor::compactMemoryIfIdle(memory_level);
+          } catch (std::exception& e) {
+            LOG(ERROR) << "Background compaction of the buffer pools resulted in an "
+                          "error. "
+                       << e.what();
+          }
+        }
+        if (!waitFor(thread_wait_duration_)) {
+          return;
+        }
+      }
+    });
+    is_scheduler_running_ = true;
+  }
+}
+
+void BufferPoolCompactionScheduler::stop() {
+  if (is_scheduler_running_) {
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex_);
+      stop_requested_ = true;
+    }
+    stop_cv_.notify_all();
+    scheduler_thread_.join();
+    is_scheduler_running_ = false;
+  }
+}
+
+void BufferPoolCompactionScheduler::setWaitDuration(int64_t duration_in_seconds) {
+  thread_wait_duration_ = std::chrono::seconds{duration_in_seconds};
+}
+
+bool BufferPoolCompactionScheduler::waitFor(const std::chrono::milliseconds duration) {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  return !stop_cv_.wait_for(lock, duration, [] { return stop_requested_; });
+}
+
+bool BufferPoolCompactionScheduler::is_scheduler_running_{false};
+bool BufferPoolCompactionScheduler::stop_requested_{false};
+std::mutex BufferPoolCompactionScheduler::stop_mutex_;
+std::condition_variable BufferPoolCompactionScheduler::stop_cv_;
+std::chrono::seconds BufferPoolCompactionScheduler::thread_wait_duration_{60};
+std::thread BufferPoolCompactionScheduler::scheduler_thread_;
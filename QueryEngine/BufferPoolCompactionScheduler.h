@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+extern size_t g_buffer_pool_compaction_interval_s;
+
+/**
+ * @brief Compacts the CPU and GPU buffer pools in the background while the server is
+ * idle. Every g_buffer_pool_compaction_interval_s, when no query is running, the unpinned
+ * buffers of each slab are moved to its start so that its free pages are contiguous,
+ * and a large allocation later finds room without evicting chunks. With
+ * g_enable_buffer_pool_compaction, the slabs are also compacted, and buffers moved across
+ * them, when an allocation finds no contiguous free pages.
+ */
+class BufferPoolCompactionScheduler {
+ public:
+  static void start(std::atomic<bool>& is_program_running);
+  static void stop();
+
+  // for testing
+  static void setWaitDuration(int64_t duration_in_seconds);
+
+ private:
+  // Sleeps for `duration`, returns false if the scheduler is stopped meanwhile.
+  static bool waitFor(const std::chrono::milliseconds duration);
+
+  static bool is_scheduler_running_;
+  static bool stop_requested_;
+  static std::mutex stop_mutex_;
+  static std::condition_variable stop_cv_;
+  static std::chrono::seconds thread_wait_duration_;
+  static std::thread scheduler_thread_;
+};
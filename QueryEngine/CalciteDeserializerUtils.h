@@ -116,6 +116,9 @@ inline SQLAgg to_agg_kind(const std::string& agg_name) {
   if (agg_name == std::string("SINGLE_VALUE")) {
     return kSINGLE_VALUE;
   }
+  if (agg_name == std::string("APPROX_QUANTILE")) {
+    return kAPPROX_QUANTILE;
+  }
   throw std::runtime_error("Aggregate function " + agg_name + " not supported");
 }
 
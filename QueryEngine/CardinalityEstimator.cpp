@@ -19,8 +19,13 @@
 #include "ExpressionRewrite.h"
 #include "RelAlgExecutor.h"
 
+#include <cmath>
+#include <optional>
+
 int64_t g_large_ndv_threshold = 10000000;
 size_t g_large_ndv_multiplier = 256;
+bool g_enable_ndv_sampling{false};
+size_t g_ndv_sample_fragment_count{4};
 
 namespace Analyzer {
 
@@ -30,6 +35,74 @@ size_t LargeNDVEstimator::getBufferSize() const {
 
 }  // namespace Analyzer
 
+namespace {
+
+// Upper bound of the number of groups of a group by on columns of a single analyzed
+// table, from the number of distinct values in their statistics.
+std::optional<size_t> get_ndv_from_column_statistics(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const Catalog_Namespace::Catalog& cat) {
+  if (ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.join_quals.empty()) {
+    return std::nullopt;
+  }
+  double ndv{1};
+  double row_count{0};
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(groupby_expr.get());
+    if (!col_var || col_var->get_table_id() < 0) {
+      return std::nullopt;
+    }
+    const auto statistics =
+        cat.getColumnStatistics(col_var->get_table_id(), col_var->get_column_id());
+    if (!statistics) {
+      return std::nullopt;
+    }
+    ndv *= statistics->getNdv() + (statistics->null_count ? 1 : 0);
+    row_count = statistics->row_count;
+  }
+  return std::max(static_cast<size_t>(std::min(ndv, row_count)), size_t(1));
+}
+
+// A sample estimate is kept if at most this fraction of the sampled rows are distinct:
+// the groups repeat enough for the sample to have seen most of them.
+constexpr double kMaxSampleDistinctRatio{0.1};
+
+struct NDVSample {
+  std::vector<InputTableInfo> table_infos;
+  size_t sample_row_count;
+  size_t row_count;
+};
+
+// g_ndv_sample_fragment_count fragments evenly spread over the table of a group by on a
+// single table, if it has enough fragments for the sample to be worth it.
+std::optional<NDVSample> get_ndv_sample(const RelAlgExecutionUnit& ra_exe_unit,
+                                        const std::vector<InputTableInfo>& table_infos) {
+  if (!g_enable_ndv_sampling || !g_ndv_sample_fragment_count ||
+      ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.join_quals.empty() ||
+      table_infos.size() != 1 || table_infos.front().table_id < 0) {
+    return std::nullopt;
+  }
+  const auto& fragments = table_infos.front().info.fragments;
+  if (fragments.size() < 2 * g_ndv_sample_fragment_count) {
+    return std::nullopt;
+  }
+  NDVSample sample{table_infos, 0, table_infos.front().info.getNumTuples()};
+  auto& sample_fragments = sample.table_infos.front().info.fragments;
+  sample_fragments.clear();
+  const auto stride = fragments.size() / g_ndv_sample_fragment_count;
+  for (size_t i = 0; i < g_ndv_sample_fragment_count; ++i) {
+    sample_fragments.push_back(fragments[i * stride]);
+    sample.sample_row_count += sample_fragments.back().getNumTuples();
+  }
+  if (!sample.sample_row_count) {
+    return std::nullopt;
+  }
+  sample.table_infos.front().info.setPhysicalNumTuples(sample.sample_row_count);
+  return sample;
+}
+
+}  // namespace
+
 size_t ResultSet::getNDVEstimator() const {
   CHECK(dynamic_cast<const Analyzer::NDVEstimator*>(estimator_.get()));
   CHECK(host_estimator_buffer_);
@@ -49,21 +122,51 @@ size_t RelAlgExecutor::getNDVEstimation(const WorkUnit& work_unit,
                                         const bool is_agg,
                                         const CompilationOptions& co,
                                         const ExecutionOptions& eo) {
+  if (const auto ndv = get_ndv_from_column_statistics(work_unit.exe_unit, cat_)) {
+    VLOG(1) << "Estimated " << *ndv << " groups from the column statistics";
+    return *ndv;
+  }
+  const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
+  if (const auto sample = get_ndv_sample(work_unit.exe_unit, table_infos)) {
+    const auto sample_ndv =
+        runNDVEstimator(work_unit, range, is_agg, co, eo, sample->table_infos);
+    if (sample_ndv <= kMaxSampleDistinctRatio * sample->sample_row_count) {
+      // the groups outside of the sample are unknown, scale up like the GEE estimator
+      // does for the values seen once
+      const auto scale = std::sqrt(static_cast<double>(sample->row_count) /
+                                   sample->sample_row_count);
+      const auto ndv =
+          std::min(static_cast<size_t>(sample_ndv * scale), sample->row_count);
+      VLOG(1) << "Estimated " << ndv << " groups from " << sample_ndv
+              << " in a sample of " << sample->sample_row_count << " rows";
+      return std::max(ndv, size_t(1));
+    }
+    VLOG(1) << "Sample of " << sample->sample_row_count << " rows has " << sample_ndv
+            << " groups, estimating them over the whole table";
+  }
+  return runNDVEstimator(work_unit, range, is_agg, co, eo, table_infos);
+}
+
+size_t RelAlgExecutor::runNDVEstimator(const WorkUnit& work_unit,
+                                       const int64_t range,
+                                       const bool is_agg,
+                                       const CompilationOptions& co,
+                                       const ExecutionOptions& eo,
+                                       const std::vector<InputTableInfo>& table_infos) {
   const auto estimator_exe_unit = create_ndv_execution_unit(work_unit.exe_unit, range);
   size_t one{1};
   ColumnCacheMap column_cache;
   try {
-    const auto estimator_result =
-        executor_->executeWorkUnit(one,
-                                   is_agg,
-                                   get_table_infos(work_unit.exe_unit, executor_),
-                                   estimator_exe_unit,
-                                   co,
-                                   eo,
-                                   cat_,
-                                   nullptr,
-                                   false,
-                                   column_cache);
+    const auto estimator_result = executor_->executeWorkUnit(one,
+                                                             is_agg,
+                                                             table_infos,
+                                                             estimator_exe_unit,
+                                                             co,
+                                                             eo,
+                                                             cat_,
+                                                             nullptr,
+                                                             false,
+                                                             column_cache);
     if (!estimator_result) {
       return 1;
     }
@@ -23,6 +23,10 @@ llvm::Value* CodeGenerator::codegenCast(const Analyzer::UOper* uoper,
   CHECK_EQ(uoper->get_optype(), kCAST);
   const auto& ti = uoper->get_type_info();
   const auto operand = uoper->get_operand();
+  if (isDecimalMulDownscale(uoper, co)) {
+    return codegenDecimalMulDownscale(
+        static_cast<const Analyzer::BinOper*>(operand), ti, co);
+  }
   const auto operand_as_const = dynamic_cast<const Analyzer::Constant*>(operand);
   // For dictionary encoded constants, the cast holds the dictionary id
   // information as the compression parameter; handle this case separately.
@@ -39,9 +43,58 @@ llvm::Value* CodeGenerator::codegenCast(const Analyzer::UOper* uoper,
     operand_lv = codegen(operand, true, co).front();
   }
   const auto& operand_ti = operand->get_type_info();
+  if (decodesDictOnGpu(uoper, co)) {
+    return codegenCastFromDictOnGpu(operand_lv, operand_ti);
+  }
   return codegenCast(operand_lv, operand_ti, ti, operand_as_const, co);
 }
 
+bool CodeGenerator::decodesDictOnGpu(const Analyzer::Expr* expr,
+                                     const CompilationOptions& co) {
+  if (!g_enable_gpu_dict_payload || g_cluster ||
+      co.device_type != ExecutorDeviceType::GPU) {
+    return false;
+  }
+  const auto uoper = dynamic_cast<const Analyzer::UOper*>(expr);
+  if (!uoper || uoper->get_optype() != kCAST) {
+    return false;
+  }
+  const auto& ti = uoper->get_type_info();
+  const auto& operand_ti = uoper->get_operand()->get_type_info();
+  // the ids of a column are in the dictionary, the transient ones of the string
+  // functions and the literals aren't
+  return dynamic_cast<const Analyzer::ColumnVar*>(uoper->get_operand()) &&
+         ti.is_string() && ti.get_compression() == kENCODING_NONE &&
+         operand_ti.is_string() && operand_ti.get_compression() == kENCODING_DICT &&
+         operand_ti.get_comp_param() > 0;
+}
+
+llvm::Value* CodeGenerator::codegenCastFromDictOnGpu(llvm::Value* operand_lv,
+                                                     const SQLTypeInfo& operand_ti) {
+  AUTOMATIC_IR_METADATA(cgen_state_);
+  CHECK(operand_lv->getType()->isIntegerTy(32));
+  const auto dict_id = operand_ti.get_comp_param();
+  const auto dd = executor()->getCatalog()->getMetadataForDict(dict_id);
+  CHECK(dd);
+  const auto string_dictionary_proxy = executor()->getStringDictionaryProxy(
+      dict_id, executor()->getRowSetMemoryOwner(), true);
+  CHECK(string_dictionary_proxy);
+  const auto generation = string_dictionary_proxy->getGeneration();
+  CHECK_GE(generation, 0);
+  std::shared_ptr<const GpuStringDictionaryPayload> payload;
+  try {
+    payload = GpuStringDictionaryPayload::get(
+        dd->stringDict, generation, executor()->getCatalog()->getDataMgr().getCudaMgr());
+  } catch (const std::runtime_error& e) {
+    // the CudaErrorException of a failed allocation or copy
+    LOG(WARNING) << "Could not copy dictionary " << dict_id << " to the GPUs: "
+                 << e.what();
+    throw QueryMustRunOnCpu();
+  }
+  return cgen_state_->addGpuStringDictionaryPayload(payload)->codegen(
+      operand_lv, static_cast<int32_t>(inline_int_null_val(operand_ti)), executor());
+}
+
 namespace {
 
 bool byte_array_cast(const SQLTypeInfo& operand_ti, const SQLTypeInfo& ti) {
@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include "GpuStringDictionaryPayload.h"
 #include "IRCodegenUtils.h"
 #include "InValuesBitmap.h"
+#include "InValuesHashSet.h"
 #include "InputMetadata.h"
 #include "LLVMGlobalContext.h"
 
@@ -217,6 +219,24 @@ struct CgenState {
     in_values_bitmaps_.emplace_back(std::move(in_values_bitmap));
     return in_values_bitmaps_.back().get();
   }
+
+  const InValuesHashSet* addInValuesHashSet(
+      std::unique_ptr<InValuesHashSet>& in_values_hash_set) {
+    if (in_values_hash_set->isEmpty()) {
+      return in_values_hash_set.get();
+    }
+    in_values_hash_sets_.emplace_back(std::move(in_values_hash_set));
+    return in_values_hash_sets_.back().get();
+  }
+
+  // keeps the copies a kernel reads alive until the query is done, even if the cache
+  // replaces them
+  const GpuStringDictionaryPayload* addGpuStringDictionaryPayload(
+      const std::shared_ptr<const GpuStringDictionaryPayload>& payload) {
+    gpu_dict_payloads_.push_back(payload);
+    return gpu_dict_payloads_.back().get();
+  }
+
   // look up a runtime function based on the name, return type and type of
   // the arguments and call it; x64 only, don't call from GPU codegen
   llvm::Value* emitExternalCall(
@@ -328,11 +348,14 @@ struct CgenState {
   llvm::ValueToValueMapTy vmap_;  // used for cloning the runtime module
   llvm::IRBuilder<> ir_builder_;
   std::unordered_map<int, std::vector<llvm::Value*>> fetch_cache_;
-  struct FunctionOperValue {
-    const Analyzer::FunctionOper* foper;
-    llvm::Value* lv;
+  // The values of the expensive expressions generated so far, available at the end of
+  // the block they have been generated in.
+  struct ExprValue {
+    std::shared_ptr<Analyzer::Expr> expr;
+    llvm::BasicBlock* bb;
+    std::vector<llvm::Value*> lvs;
   };
-  std::vector<FunctionOperValue> ext_call_cache_;
+  std::vector<ExprValue> expr_value_cache_;
   std::vector<llvm::Value*> group_by_expr_cache_;
   std::vector<llvm::Value*> str_constants_;
   std::vector<llvm::Value*> frag_offsets_;
@@ -341,6 +364,8 @@ struct CgenState {
   std::unordered_map<int, llvm::Value*> scan_idx_to_hash_pos_;
   InsertionOrderedMap filter_func_args_;
   std::vector<std::unique_ptr<const InValuesBitmap>> in_values_bitmaps_;
+  std::vector<std::unique_ptr<const InValuesHashSet>> in_values_hash_sets_;
+  std::vector<std::shared_ptr<const GpuStringDictionaryPayload>> gpu_dict_payloads_;
   bool needs_error_check_;
   bool needs_geos_;
 
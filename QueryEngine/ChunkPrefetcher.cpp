@@ -0,0 +1,90 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChunkPrefetcher.h"
+
+#include "Logger/Logger.h"
+
+size_t g_chunk_prefetch_window{0};
+
+ChunkPrefetcher::ChunkPrefetcher(Data_Namespace::DataMgr* data_mgr,
+                                 std::vector<std::vector<ChunkToFetch>>&& kernel_chunks,
+                                 const size_t window)
+    : data_mgr_(data_mgr)
+    , kernel_chunks_(std::move(kernel_chunks))
+    , window_(window)
+    , kernel_started_(kernel_chunks_.size(), false)
+    , started_kernel_count_(0)
+    , done_(false) {
+  CHECK(data_mgr_);
+  CHECK_GT(window_, size_t(0));
+  thread_ = std::thread([this] { prefetch(); });
+}
+
+ChunkPrefetcher::~ChunkPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void ChunkPrefetcher::kernelStarted(const size_t kernel_idx) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_LT(kernel_idx, kernel_started_.size());
+    CHECK(!kernel_started_[kernel_idx]);
+    kernel_started_[kernel_idx] = true;
+    ++started_kernel_count_;
+  }
+  cv_.notify_all();
+}
+
+void ChunkPrefetcher::prefetch() {
+  for (size_t kernel_idx = 0; kernel_idx < kernel_chunks_.size(); ++kernel_idx) {
+    for (const auto& chunk : kernel_chunks_[kernel_idx]) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this, kernel_idx] {
+          return done_ || kernel_idx < started_kernel_count_ + window_;
+        });
+        if (done_) {
+          return;
+        }
+        if (kernel_started_[kernel_idx]) {
+          // the kernel is reading its chunks already
+          break;
+        }
+      }
+      try {
+        // Only brings the chunk in the buffer pool, the kernel pins it again when it
+        // fetches it. The buffer pool reads one chunk at a time, hence a single thread.
+        Chunk_NS::Chunk::getChunk(chunk.cd,
+                                  data_mgr_,
+                                  chunk.key,
+                                  Data_Namespace::CPU_LEVEL,
+                                  0,
+                                  chunk.num_bytes,
+                                  chunk.num_elems);
+      } catch (const std::exception& e) {
+        VLOG(1) << "Stopped prefetching chunks at " << show_chunk(chunk.key) << ": "
+                << e.what();
+        return;
+      }
+    }
+  }
+}
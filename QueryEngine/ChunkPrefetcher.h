@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ChunkPrefetcher.h
+ * @brief   Reads the chunks of the upcoming kernels of a query into the CPU buffer pool.
+ *
+ * The buffer pool reads a chunk from disk the first time a kernel fetches it, so when
+ * there are more kernels than threads, a cold query waits for the I/O of every fragment
+ * in turn. The prefetcher walks the kernels in launch order on a background thread and
+ * reads the chunks of the ones which haven't started yet, at most `window` kernels past
+ * those which have, so that the reads of the next fragments overlap the compute of the
+ * current ones. Prefetching is best effort: the kernel fetches its chunks as usual and
+ * reports any error.
+ */
+
+#pragma once
+
+#include "DataMgr/Chunk/Chunk.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern size_t g_chunk_prefetch_window;
+
+class ChunkPrefetcher {
+ public:
+  struct ChunkToFetch {
+    const ColumnDescriptor* cd;
+    ChunkKey key;
+    size_t num_bytes;
+    size_t num_elems;
+  };
+
+  // `kernel_chunks` holds the chunks of every kernel, in launch order.
+  ChunkPrefetcher(Data_Namespace::DataMgr* data_mgr,
+                  std::vector<std::vector<ChunkToFetch>>&& kernel_chunks,
+                  const size_t window);
+
+  // Waits for the chunk being read, if any, and stops.
+  ~ChunkPrefetcher();
+
+  // Called by each kernel before fetching its own chunks.
+  void kernelStarted(const size_t kernel_idx);
+
+ private:
+  void prefetch();
+
+  Data_Namespace::DataMgr* data_mgr_;
+  const std::vector<std::vector<ChunkToFetch>> kernel_chunks_;
+  const size_t window_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<bool> kernel_started_;
+  size_t started_kernel_count_;
+  bool done_;
+  std::thread thread_;
+};
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/CodeCache.h"
+
+#include <algorithm>
+
+#include "Logger/Logger.h"
+
+CodeCacheValWithModule* CodeCache::get(const CodeCacheKey& key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  ++it->second.uses;
+  updatePriority(*it);
+  return &it->second.value;
+}
+
+void CodeCache::put(const CodeCacheKey& key,
+                    CodeCacheValWithModule&& value,
+                    const int64_t compilation_time_ms) {
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    evict(it);
+    --evictions_;  // replaced, not evicted
+  }
+  const auto size_bytes = getSize(key, value);
+  if (max_bytes_ && size_bytes > max_bytes_) {
+    VLOG(1) << "Not caching generated code of " << size_bytes
+            << " bytes, larger than the code cache";
+    return;
+  }
+  const auto is_full = [this, size_bytes] {
+    return entries_.size() >= max_entries_ ||
+           (max_bytes_ && resident_bytes_ + size_bytes > max_bytes_);
+  };
+  while (!entries_.empty() && is_full()) {
+    evictCheapest();
+  }
+  if (max_entries_ == 0) {
+    return;
+  }
+  it = entries_
+           .emplace(key,
+                    Entry{std::move(value),
+                          size_bytes,
+                          static_cast<double>(std::max(compilation_time_ms, int64_t(1))),
+                          1,
+                          priorities_.end()})
+           .first;
+  updatePriority(*it);
+  ++num_entries_;
+  resident_bytes_ += size_bytes;
+}
+
+void CodeCache::clear() {
+  entries_.clear();
+  priorities_.clear();
+  inflation_ = 0;
+  num_entries_ = 0;
+  resident_bytes_ = 0;
+}
+
+void CodeCache::evictFractionEntries(const float fraction) {
+  const size_t entries_to_evict =
+      std::min(std::max(static_cast<size_t>(entries_.size() * fraction), size_t(1)),
+               entries_.size());
+  for (size_t i = 0; i < entries_to_evict; ++i) {
+    evictCheapest();
+  }
+}
+
+CodeCacheStats CodeCache::getStats() const {
+  CodeCacheStats stats;
+  stats.num_entries = num_entries_;
+  stats.resident_bytes = resident_bytes_;
+  stats.max_entries = max_entries_;
+  stats.max_bytes = max_bytes_;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  return stats;
+}
+
+size_t CodeCache::getSize(const CodeCacheKey& key, const CodeCacheValWithModule& value) {
+  // The key holds the serialized IR of the query functions, a fair proxy for the module
+  // kept alive with the entry.
+  size_t size_bytes = value.first ? value.first->getCodeSize() : 0;
+  for (const auto& part : key) {
+    size_bytes += part.size();
+  }
+  return std::max(size_bytes, size_t(1));
+}
+
+void CodeCache::updatePriority(EntryMap::value_type& key_and_entry) {
+  auto& entry = key_and_entry.second;
+  if (entry.priority != priorities_.end()) {
+    priorities_.erase(entry.priority);
+  }
+  const auto priority = inflation_ + entry.uses * entry.cost / entry.size_bytes;
+  // map nodes are stable, the priority queue can point at the key they hold
+  entry.priority = priorities_.emplace(priority, &key_and_entry.first);
+}
+
+void CodeCache::evict(EntryMap::iterator it) {
+  priorities_.erase(it->second.priority);
+  resident_bytes_ -= it->second.size_bytes;
+  --num_entries_;
+  ++evictions_;
+  entries_.erase(it);
+}
+
+void CodeCache::evictCheapest() {
+  CHECK(!priorities_.empty());
+  auto cheapest = priorities_.begin();
+  inflation_ = cheapest->first;
+  auto it = entries_.find(*cheapest->second);
+  CHECK(it != entries_.end());
+  evict(it);
+}
@@ -17,13 +17,85 @@
 #pragma once
 
 #include <boost/functional/hash.hpp>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <unordered_map>
 
 #include "QueryEngine/CompilationContext.h"
-#include "StringDictionary/LruCache.hpp"
 
 using CodeCacheKey = std::vector<std::string>;
 using CodeCacheVal = std::shared_ptr<CompilationContext>;
 using CodeCacheValWithModule = std::pair<CodeCacheVal, llvm::Module*>;
-using CodeCache =
-    LruCache<CodeCacheKey, CodeCacheValWithModule, boost::hash<CodeCacheKey>>;
+
+struct CodeCacheStats {
+  size_t num_entries{0};
+  size_t resident_bytes{0};
+  size_t max_entries{0};
+  size_t max_bytes{0};
+  int64_t hits{0};
+  int64_t misses{0};
+  int64_t evictions{0};
+};
+
+/**
+ * Cache of generated code bounded by entry count and, if max_bytes is not 0, by the
+ * bytes the entries keep resident (native code plus their key).
+ *
+ * Eviction is cost aware (Greedy-Dual-Size-Frequency): an entry is worth the compilation
+ * time it saves per byte, times the number of times it was used, plus an inflation
+ * value which ages entries that stopped being used. The cheapest entry goes first.
+ *
+ * Mutations must be serialized by the caller, as with the LruCache this replaces;
+ * getStats() can be called concurrently with them.
+ */
+class CodeCache {
+ public:
+  CodeCache(const size_t max_entries, const size_t max_bytes = 0)
+      : max_entries_(max_entries), max_bytes_(max_bytes) {}
+
+  CodeCacheValWithModule* get(const CodeCacheKey& key);
+
+  void put(const CodeCacheKey& key,
+           CodeCacheValWithModule&& value,
+           const int64_t compilation_time_ms = 0);
+
+  void clear();
+
+  void evictFractionEntries(const float fraction);
+
+  CodeCacheStats getStats() const;
+
+ private:
+  using PriorityQueue = std::multimap<double, const CodeCacheKey*>;
+
+  struct Entry {
+    CodeCacheValWithModule value;
+    size_t size_bytes;
+    double cost;
+    int64_t uses;
+    PriorityQueue::iterator priority;
+  };
+
+  using EntryMap = std::unordered_map<CodeCacheKey, Entry, boost::hash<CodeCacheKey>>;
+
+  static size_t getSize(const CodeCacheKey& key, const CodeCacheValWithModule& value);
+
+  void updatePriority(EntryMap::value_type& key_and_entry);
+
+  void evict(EntryMap::iterator it);
+
+  void evictCheapest();
+
+  const size_t max_entries_;
+  const size_t max_bytes_;
+  EntryMap entries_;
+  PriorityQueue priorities_;
+  double inflation_{0};
+
+  std::atomic<size_t> num_entries_{0};
+  std::atomic<size_t> resident_bytes_{0};
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+  std::atomic<int64_t> evictions_{0};
+};
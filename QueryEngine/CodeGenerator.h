@@ -18,6 +18,8 @@
 
 #include <llvm/IR/Value.h>
 
+#include <optional>
+
 #include "../Analyzer/Analyzer.h"
 #include "Execute.h"
 
@@ -61,6 +63,13 @@ class CodeGenerator {
   // Generates the index of the current row in the context of query execution.
   llvm::Value* posArg(const Analyzer::Expr*) const;
 
+  // Generates the value of a fixed length column of the outer table at the given
+  // position instead of the current one. Returns nullptr for the columns which aren't
+  // read straight from their buffer.
+  llvm::Value* codegenColumnAt(const Analyzer::ColumnVar*,
+                               llvm::Value* pos_arg,
+                               const CompilationOptions&);
+
   llvm::Value* toBool(llvm::Value*);
 
   llvm::Value* castArrayPointer(llvm::Value* ptr, const SQLTypeInfo& elem_ti);
@@ -73,7 +82,8 @@ class CodeGenerator {
   static ExecutionEngineWrapper generateNativeCPUCode(
       llvm::Function* func,
       const std::unordered_set<llvm::Function*>& live_funcs,
-      const CompilationOptions& co);
+      const CompilationOptions& co,
+      const std::string& persistent_cache_key = "");
 
   static std::string generatePTX(const std::string& cuda_llir,
                                  llvm::TargetMachine* nvptx_target_machine,
@@ -97,7 +107,8 @@ class CodeGenerator {
       llvm::Function* wrapper_func,
       const std::unordered_set<llvm::Function*>& live_funcs,
       const CompilationOptions& co,
-      const GPUTarget& gpu_target);
+      const GPUTarget& gpu_target,
+      const std::string& persistent_cache_key = "");
 
   static void link_udf_module(const std::unique_ptr<llvm::Module>& udf_module,
                               llvm::Module& module,
@@ -297,6 +308,13 @@ class CodeGenerator {
                                      const bool operand_is_const,
                                      const CompilationOptions& co);
 
+  // Whether the kernel decodes the ids of the dictionary-encoded column `expr` casts to
+  // a none-encoded string from a copy of the dictionary on the GPU.
+  static bool decodesDictOnGpu(const Analyzer::Expr* expr, const CompilationOptions& co);
+
+  llvm::Value* codegenCastFromDictOnGpu(llvm::Value* operand_lv,
+                                        const SQLTypeInfo& operand_ti);
+
   llvm::Value* codegenCastToFp(llvm::Value* operand_lv,
                                const SQLTypeInfo& operand_ti,
                                const SQLTypeInfo& ti);
@@ -344,6 +362,12 @@ class CodeGenerator {
 
   llvm::Value* codegenDeciDiv(const Analyzer::BinOper*, const CompilationOptions&);
 
+  bool isDecimalMulDownscale(const Analyzer::UOper*, const CompilationOptions&);
+
+  llvm::Value* codegenDecimalMulDownscale(const Analyzer::BinOper*,
+                                          const SQLTypeInfo&,
+                                          const CompilationOptions&);
+
   llvm::Value* codegenMod(llvm::Value*,
                           llvm::Value*,
                           const std::string& null_typename,
@@ -414,6 +438,15 @@ class CodeGenerator {
 
   llvm::Value* resolveGroupedColumnReference(const Analyzer::ColumnVar*);
 
+  // Returns the values of an expensive expression equal to expr generated before, if
+  // they are available at the insertion point.
+  std::optional<std::vector<llvm::Value*>> findReusableExprValue(
+      const Analyzer::Expr* expr);
+
+  // Records the values of expr for reuse by equal expressions and returns them.
+  std::vector<llvm::Value*> recordReusableExprValue(const Analyzer::Expr* expr,
+                                                    const std::vector<llvm::Value*>& lvs);
+
   llvm::Value* colByteStream(const Analyzer::ColumnVar* col_var,
                              const bool fetch_column,
                              const bool hoist_literals);
@@ -424,8 +457,15 @@ class CodeGenerator {
       const Analyzer::ColumnVar* rhs,
       const Analyzer::BinOper* tautological_eq) const;
 
-  std::unique_ptr<InValuesBitmap> createInValuesBitmap(const Analyzer::InValues*,
-                                                       const CompilationOptions&);
+  // Integer or dictionary id values of an IN list of constants, if worth a set lookup.
+  std::optional<std::vector<int64_t>> getInValuesIntegers(const Analyzer::InValues*);
+
+  // Looks the needle up in a bitmap of the values, or in a hash set of them if the
+  // bitmap would be too large or too sparse.
+  llvm::Value* codegenInValuesSet(const std::vector<int64_t>& values,
+                                  const int64_t null_val,
+                                  llvm::Value* needle,
+                                  const CompilationOptions& co);
 
   bool checkExpressionRanges(const Analyzer::UOper*, int64_t, int64_t);
 
@@ -15,6 +15,7 @@
  */
 
 #include "Codec.h"
+#include "DataMgr/IntegerCodecs.h"
 #include "LLVMGlobalContext.h"
 #include "Logger/Logger.h"
 
@@ -71,6 +72,44 @@ llvm::Instruction* DiffFixedWidthInt::codegenDecode(llvm::Value* byte_stream,
   return llvm::CallInst::Create(f, args);
 }
 
+FrameOfReferenceInt::FrameOfReferenceInt(const int64_t null_val) : null_val_(null_val) {}
+
+llvm::Instruction* FrameOfReferenceInt::codegenDecode(llvm::Value* byte_stream,
+                                                      llvm::Value* pos,
+                                                      llvm::Module* module) const {
+  auto& context = getGlobalLLVMContext();
+  auto f = module->getFunction("frame_of_reference_int_decode");
+  CHECK(f);
+  llvm::Value* args[] = {
+      byte_stream,
+      llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), null_val_),
+      pos};
+  return llvm::CallInst::Create(f, args);
+}
+
+llvm::Instruction* DeltaInt::codegenDecode(llvm::Value* byte_stream,
+                                           llvm::Value* pos,
+                                           llvm::Module* module) const {
+  auto& context = getGlobalLLVMContext();
+  auto f = module->getFunction("delta_int_decode");
+  CHECK(f);
+  llvm::Value* args[] = {
+      byte_stream,
+      llvm::ConstantInt::get(llvm::Type::getInt32Ty(context),
+                             integer_codecs::kDeltaBlockSize),
+      pos};
+  return llvm::CallInst::Create(f, args);
+}
+
+llvm::Instruction* RunLengthInt::codegenDecode(llvm::Value* byte_stream,
+                                               llvm::Value* pos,
+                                               llvm::Module* module) const {
+  auto f = module->getFunction("run_length_int_decode");
+  CHECK(f);
+  llvm::Value* args[] = {byte_stream, pos};
+  return llvm::CallInst::Create(f, args);
+}
+
 FixedWidthReal::FixedWidthReal(const bool is_double) : is_double_(is_double) {}
 
 llvm::Instruction* FixedWidthReal::codegenDecode(llvm::Value* byte_stream,
@@ -65,6 +65,33 @@ class DiffFixedWidthInt : public Decoder {
   const int64_t baseline_;
 };
 
+// Decoders of the streams of DataMgr/IntegerCodecs.h, which describe themselves, so that
+// the chunks of a column don't need to agree on the parameters.
+class FrameOfReferenceInt : public Decoder {
+ public:
+  FrameOfReferenceInt(const int64_t null_val);
+  llvm::Instruction* codegenDecode(llvm::Value* byte_stream,
+                                   llvm::Value* pos,
+                                   llvm::Module* module) const override;
+
+ private:
+  const int64_t null_val_;
+};
+
+class DeltaInt : public Decoder {
+ public:
+  llvm::Instruction* codegenDecode(llvm::Value* byte_stream,
+                                   llvm::Value* pos,
+                                   llvm::Module* module) const override;
+};
+
+class RunLengthInt : public Decoder {
+ public:
+  llvm::Instruction* codegenDecode(llvm::Value* byte_stream,
+                                   llvm::Value* pos,
+                                   llvm::Module* module) const override;
+};
+
 class FixedWidthReal : public Decoder {
  public:
   FixedWidthReal(const bool is_double);
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ColdStorageScheduler.h"
+
+#include "LockMgr/LockMgr.h"
+#include "Logger/Logger.h"
+#include "QueryEngine/DateTimeUtils.h"
+
+#include <algorithm>
+#include <optional>
+
+size_t g_cold_storage_fragment_age_days{0};
+
+namespace {
+
+// Returns the maximum of the DATE or TIMESTAMP chunk in seconds, nothing if the chunk
+// has no value.
+std::optional<int64_t> get_max_epoch_seconds(const ChunkMetadata& chunk_metadata) {
+  const auto& chunk_stats = chunk_metadata.chunkStats;
+  if (!chunk_metadata.numElements ||
+      chunk_stats.min.bigintval > chunk_stats.max.bigintval) {
+    return std::nullopt;
+  }
+  const auto& ti = chunk_metadata.sqlType;
+  if (ti.get_type() == kTIMESTAMP && ti.get_dimension() > 0) {
+    const auto scale = DateTimeUtils::get_timestamp_precision_scale(ti.get_dimension());
+    return chunk_stats.max.bigintval / scale;
+  }
+  // the chunk stats of a date are in seconds, whatever its encoding
+  return chunk_stats.max.bigintval;
+}
+
+bool is_fragment_old(const Fragmenter_Namespace::FragmentInfo& fragment,
+                     const std::vector<const ColumnDescriptor*>& time_columns,
+                     const int64_t cutoff_epoch_seconds) {
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+  for (const auto cd : time_columns) {
+    const auto chunk_metadata_it = chunk_metadata_map.find(cd->columnId);
+    if (chunk_metadata_it == chunk_metadata_map.end()) {
+      return false;
+    }
+    const auto max_epoch_seconds = get_max_epoch_seconds(*chunk_metadata_it->second);
+    if (!max_epoch_seconds || *max_epoch_seconds >= cutoff_epoch_seconds) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<ChunkKey> get_fragment_chunk_keys(
+    const ChunkKey& table_key,
+    const std::list<const ColumnDescriptor*>& columns,
+    const int fragment_id) {
+  std::vector<ChunkKey> chunk_keys;
+  for (const auto cd : columns) {
+    ChunkKey chunk_key{table_key[CHUNK_KEY_DB_IDX],
+                       table_key[CHUNK_KEY_TABLE_IDX],
+                       cd->columnId,
+                       fragment_id};
+    if (cd->columnType.is_varlen() && !cd->columnType.is_fixlen_array()) {
+      for (const int varlen_key : {1, 2}) {
+        chunk_keys.push_back(chunk_key);
+        chunk_keys.back().push_back(varlen_key);
+      }
+    } else {
+      chunk_keys.push_back(chunk_key);
+    }
+  }
+  return chunk_keys;
+}
+
+}  // namespace
+
+void ColdStorageScheduler::start(std::atomic<bool>& is_program_running) {
+  if (!is_scheduler_running_) {
+    stop_requested_ = false;
+    scheduler_thread_ = std::thread([&is_program_running]() {
+      while (is_program_running) {
+        auto& sys_catalog = Catalog_Namespace::SysCatalog::instance();
+        for (const auto& catalog : sys_catalog.getCatalogsForAllDbs()) {
+          std::vector<std::string> table_names;
+          for (const auto td : catalog->getAllTableMetadata()) {
+            if (!td->isView && td->shard < 0 &&
+                td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL &&
+                td->storageType != StorageType::FOREIGN_TABLE) {
+              table_names.push_back(td->tableName);
+            }
+          }
+          for (const auto& table_name : table_names) {
+            if (!is_program_running) {
+              return;
+            }
+            try {
+              offloadTable(*catalog, table_name);
+            } catch (std::exception& e) {
+              LOG(ERROR) << "Offloading the old fragments of table \"" << table_name
+                         << "\" resulted in an error. " << e.what();
+            }
+          }
+        }
+        if (!waitFor(thread_wait_duration_)) {
+          return;
+        }
+      }
+    });
+    is_scheduler_running_ = true;
+  }
+}
+
+void ColdStorageScheduler::stop() {
+  if (is_scheduler_running_) {
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex_);
+      stop_requested_ = true;
+    }
+    stop_cv_.notify_all();
+    scheduler_thread_.join();
+    is_scheduler_running_ = false;
+  }
+}
+
+size_t ColdStorageScheduler::offloadTable(
+    const Catalog_Namespace::Catalog& catalog,
+    const std::string& table_name,
+    const std::chrono::system_clock::time_point now) {
+  CHECK_GT(g_cold_storage_fragment_age_days, size_t(0));
+  const auto persistent_storage_mgr = catalog.getDataMgr().getPersistentStorageMgr();
+  if (!persistent_storage_mgr->getColdStorage()) {
+    throw std::runtime_error("The cold storage is not enabled.");
+  }
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          catalog, table_name);
+  const auto td = td_with_lock();
+  if (!td) {
+    throw std::runtime_error("Table " + table_name + " does not exist.");
+  }
+  std::vector<const ColumnDescriptor*> time_columns;
+  for (const auto cd :
+       catalog.getAllColumnMetadataForTable(td->tableId, false, false, false)) {
+    if (cd->columnType.get_type() == kDATE || cd->columnType.get_type() == kTIMESTAMP) {
+      time_columns.push_back(cd);
+    }
+  }
+  if (time_columns.empty()) {
+    return 0;
+  }
+  const auto cutoff_epoch_seconds =
+      std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count() -
+      static_cast<int64_t>(g_cold_storage_fragment_age_days) * 24 * 60 * 60;
+  // all the physical chunks, the system and geo physical columns included
+  const auto columns =
+      catalog.getAllColumnMetadataForTable(td->tableId, true, false, true);
+  const auto db_id = catalog.getCurrentDB().dbId;
+
+  size_t offloaded_count{0};
+  for (const auto shard : catalog.getPhysicalTablesDescriptors(td)) {
+    std::vector<int> fragment_ids;
+    {
+      const auto insert_data_lock =
+          lockmgr::InsertDataLockMgr::getWriteLockForTable(catalog, table_name);
+      const auto table_info = shard->fragmenter->getFragmentsForQuery();
+      int last_fragment_id{-1};
+      for (const auto& fragment : table_info.fragments) {
+        last_fragment_id = std::max(last_fragment_id, fragment.fragmentId);
+      }
+      for (const auto& fragment : table_info.fragments) {
+        if (fragment.fragmentId != last_fragment_id &&
+            is_fragment_old(fragment, time_columns, cutoff_epoch_seconds)) {
+          fragment_ids.push_back(fragment.fragmentId);
+        }
+      }
+    }
+    for (const auto fragment_id : fragment_ids) {
+      // returns at once if the scheduler is stopped
+      if (!waitFor(std::chrono::milliseconds(0))) {
+        return offloaded_count;
+      }
+      // the fragments are offloaded one at a time, loads and queries go on in between
+      const auto insert_data_lock =
+          lockmgr::InsertDataLockMgr::getWriteLockForTable(catalog, table_name);
+      const auto data_lock =
+          lockmgr::TableDataLockMgr::getWriteLockForTable(catalog, table_name);
+      const auto chunk_keys =
+          get_fragment_chunk_keys({db_id, shard->tableId}, columns, fragment_id);
+      if (persistent_storage_mgr->offloadChunks(chunk_keys)) {
+        catalog.checkpoint(td->tableId);
+        ++offloaded_count;
+      }
+    }
+  }
+  if (offloaded_count) {
+    LOG(INFO) << "Offloaded " << offloaded_count << " fragments of table " << table_name
+              << " to the cold storage";
+  }
+  return offloaded_count;
+}
+
+void ColdStorageScheduler::setWaitDuration(int64_t duration_in_seconds) {
+  thread_wait_duration_ = std::chrono::seconds{duration_in_seconds};
+}
+
+bool ColdStorageScheduler::waitFor(const std::chrono::milliseconds duration) {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  return !stop_cv_.wait_for(lock, duration, [] { return stop_requested_; });
+}
+
+bool ColdStorageScheduler::is_scheduler_running_{false};
+bool ColdStorageScheduler::stop_requested_{false};
+std::mutex ColdStorageScheduler::stop_mutex_;
+std::condition_variable ColdStorageScheduler::stop_cv_;
+std::chrono::seconds ColdStorageScheduler::thread_wait_duration_{3600};
+std::thread ColdStorageScheduler::scheduler_thread_;
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Catalog/Catalog.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+extern size_t g_cold_storage_fragment_age_days;
+
+/**
+ * @brief Offloads the old fragments of tables to the cold storage in the background.
+ * A fragment is old once the maximum of each of its DATE and TIMESTAMP columns is more
+ * than g_cold_storage_fragment_age_days in the past, the tables without such a column
+ * and the last fragment of a table, which loads still fill, stay local. The chunks of
+ * each fragment are offloaded and checkpointed on their own under the insert lock and
+ * the data lock of the table, see ColdStorage.h.
+ */
+class ColdStorageScheduler {
+ public:
+  static void start(std::atomic<bool>& is_program_running);
+  static void stop();
+
+  // Offloads the old fragments of the table, returns how many were.
+  static size_t offloadTable(const Catalog_Namespace::Catalog& catalog,
+                             const std::string& table_name,
+                             const std::chrono::system_clock::time_point now =
+                                 std::chrono::system_clock::now());
+
+  // for testing
+  static void setWaitDuration(int64_t duration_in_seconds);
+
+ private:
+  // Sleeps for `duration`, returns false if the scheduler is stopped meanwhile.
+  static bool waitFor(const std::chrono::milliseconds duration);
+
+  static bool is_scheduler_running_;
+  static bool stop_requested_;
+  static std::mutex stop_mutex_;
+  static std::condition_variable stop_cv_;
+  static std::chrono::seconds thread_wait_duration_;
+  static std::thread scheduler_thread_;
+};
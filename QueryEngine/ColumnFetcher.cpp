@@ -202,6 +202,9 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
         memory_level == Data_Namespace::CPU_LEVEL ? 0 : device_id,
         chunk_meta_it->second->numBytes,
         chunk_meta_it->second->numElements);
+    (memory_level == Data_Namespace::GPU_LEVEL ? executor_->gpu_bytes_scanned_
+                                               : executor_->cpu_bytes_scanned_) +=
+        chunk_meta_it->second->numBytes;
     std::lock_guard<std::mutex> chunk_list_lock(chunk_list_mutex);
     chunk_holder.push_back(chunk);
   }
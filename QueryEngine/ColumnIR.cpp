@@ -223,6 +223,32 @@ std::vector<llvm::Value*> CodeGenerator::codegenColVar(const Analyzer::ColumnVar
   return {it_ok.first->second};
 }
 
+llvm::Value* CodeGenerator::codegenColumnAt(const Analyzer::ColumnVar* col_var,
+                                            llvm::Value* pos_arg,
+                                            const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(cgen_state_);
+  if (col_var->get_rte_idx() != 0 || plan_state_->isLazyFetchColumn(col_var) ||
+      WindowProjectNodeContext::getActiveWindowFunctionContext(executor())) {
+    return nullptr;
+  }
+  const auto& col_ti = col_var->get_type_info();
+  if (col_ti.is_geometry() || col_ti.is_array() ||
+      (col_ti.is_string() && col_ti.get_compression() == kENCODING_NONE)) {
+    return nullptr;
+  }
+  if (col_var->get_table_id() > 0) {
+    const auto catalog = executor()->getCatalog();
+    CHECK(catalog);
+    const auto cd = get_column_descriptor(
+        col_var->get_column_id(), col_var->get_table_id(), *catalog);
+    if (cd->isVirtualCol) {
+      return nullptr;
+    }
+  }
+  const auto col_byte_stream = colByteStream(col_var, true, co.hoist_literals);
+  return codegenFixedLengthColVar(col_var, col_byte_stream, pos_arg);
+}
+
 llvm::Value* CodeGenerator::codegenWindowPosition(
     WindowFunctionContext* window_func_context,
     llvm::Value* pos_arg) {
@@ -446,18 +472,26 @@ std::vector<llvm::Value*> CodeGenerator::codegenOuterJoinNullPlaceholder(
   const auto orig_lvs = codegenColVar(col_var, fetch_column, true, co);
   cgen_state_->ir_builder_.CreateBr(phi_bb);
   cgen_state_->ir_builder_.SetInsertPoint(outer_join_nulls_bb);
-  const auto& null_ti = col_var->get_type_info();
-  if ((null_ti.is_string() && null_ti.get_compression() == kENCODING_NONE) ||
-      null_ti.is_array() || null_ti.is_geometry()) {
-    throw std::runtime_error("Projection type " + null_ti.get_type_name() +
-                             " not supported for outer joins yet");
-  }
-  const auto null_constant = makeExpr<Analyzer::Constant>(null_ti, true, Datum{0});
-  const auto null_target_lvs =
-      codegen(null_constant.get(),
-              false,
-              CompilationOptions{
-                  ExecutorDeviceType::CPU, false, ExecutorOptLevel::Default, false});
+  std::vector<llvm::Value*> null_target_lvs;
+  if (plan_state_->isLazyFetchColumn(col_var)) {
+    // the result set reads a null value for the null row id
+    for (const auto orig_lv : orig_lvs) {
+      null_target_lvs.push_back(llvm::ConstantInt::get(orig_lv->getType(), -1, true));
+    }
+  } else {
+    const auto& null_ti = col_var->get_type_info();
+    if ((null_ti.is_string() && null_ti.get_compression() == kENCODING_NONE) ||
+        null_ti.is_array() || null_ti.is_geometry()) {
+      throw std::runtime_error("Projection type " + null_ti.get_type_name() +
+                               " not supported for outer joins yet");
+    }
+    const auto null_constant = makeExpr<Analyzer::Constant>(null_ti, true, Datum{0});
+    null_target_lvs =
+        codegen(null_constant.get(),
+                false,
+                CompilationOptions{
+                    ExecutorDeviceType::CPU, false, ExecutorOptLevel::Default, false});
+  }
   cgen_state_->ir_builder_.CreateBr(phi_bb);
   CHECK_EQ(orig_lvs.size(), null_target_lvs.size());
   cgen_state_->ir_builder_.SetInsertPoint(phi_bb);
@@ -550,6 +584,9 @@ const Analyzer::Expr* remove_cast_to_int(const Analyzer::Expr* expr) {
 std::shared_ptr<const Analyzer::Expr> CodeGenerator::hashJoinLhs(
     const Analyzer::ColumnVar* rhs) const {
   for (const auto& tautological_eq : plan_state_->join_info_.equi_join_tautologies_) {
+    if (!tautological_eq) {
+      continue;
+    }
     CHECK(IS_EQUIVALENCE(tautological_eq->get_optype()));
     if (dynamic_cast<const Analyzer::ExpressionTuple*>(
             tautological_eq->get_left_operand())) {
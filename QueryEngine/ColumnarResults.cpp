@@ -38,6 +38,19 @@ inline int64_t fixed_encoding_nullable_val(const int64_t val,
   return val;
 }
 
+// The layouts whose non-empty entries are located, then compacted into the columns.
+bool is_compacted_by_entries(const ResultSet& rows) {
+  switch (rows.getQueryDescriptionType()) {
+    case QueryDescriptionType::GroupByPerfectHash:
+    case QueryDescriptionType::GroupByBaselineHash:
+      return true;
+    case QueryDescriptionType::Projection:
+      return !rows.didOutputColumnar();
+    default:
+      return false;
+  }
+}
+
 }  // namespace
 
 ColumnarResults::ColumnarResults(std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
@@ -302,7 +315,11 @@ void ColumnarResults::materializeAllColumnsDirectly(const ResultSet& rows,
   CHECK(isDirectColumnarConversionPossible());
   switch (rows.getQueryDescriptionType()) {
     case QueryDescriptionType::Projection: {
-      materializeAllColumnsProjection(rows, num_columns);
+      if (rows.didOutputColumnar()) {
+        materializeAllColumnsProjection(rows, num_columns);
+      } else {
+        materializeAllColumnsGroupBy(rows, num_columns);
+      }
       break;
     }
     case QueryDescriptionType::GroupByPerfectHash:
@@ -461,8 +478,7 @@ void ColumnarResults::materializeAllLazyColumns(
 void ColumnarResults::materializeAllColumnsGroupBy(const ResultSet& rows,
                                                    const size_t num_columns) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_by_entries(rows));
 
   const size_t num_threads = isParallelConversion() ? cpu_threads() : 1;
   const size_t entry_count = rows.entryCount();
@@ -500,8 +516,7 @@ void ColumnarResults::locateAndCountEntries(const ResultSet& rows,
                                             const size_t num_threads,
                                             const size_t size_per_thread) const {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_by_entries(rows));
   CHECK_EQ(num_threads, non_empty_per_thread.size());
   auto locate_and_count_func =
       [&rows, &bitmap, &non_empty_per_thread](
@@ -549,8 +564,7 @@ void ColumnarResults::compactAndCopyEntries(
     const size_t num_threads,
     const size_t size_per_thread) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_by_entries(rows));
   CHECK_EQ(num_threads, non_empty_per_thread.size());
 
   // compute the exclusive scan over all non-empty totals
@@ -558,6 +572,7 @@ void ColumnarResults::compactAndCopyEntries(
   std::partial_sum(non_empty_per_thread.begin(),
                    non_empty_per_thread.end(),
                    std::next(global_offsets.begin()));
+  num_rows_ = global_offsets.back();
 
   const auto slot_idx_per_target_idx = rows.getSlotIndicesForTargetIndices();
   const auto [single_slot_targets_to_skip, num_single_slot_targets] =
@@ -607,8 +622,7 @@ void ColumnarResults::compactAndCopyEntriesWithTargetSkipping(
     const size_t num_threads,
     const size_t size_per_thread) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_by_entries(rows));
 
   const auto [write_functions, read_functions] =
       initAllConversionFunctions(rows, slot_idx_per_target_idx, targets_to_skip);
@@ -695,8 +709,7 @@ void ColumnarResults::compactAndCopyEntriesWithoutTargetSkipping(
     const size_t num_threads,
     const size_t size_per_thread) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_by_entries(rows));
 
   const auto [write_functions, read_functions] =
       initAllConversionFunctions(rows, slot_idx_per_target_idx);
@@ -761,8 +774,7 @@ std::vector<ColumnarResults::WriteFunction> ColumnarResults::initWriteFunctions(
     const ResultSet& rows,
     const std::vector<bool>& targets_to_skip) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_by_entries(rows));
 
   std::vector<WriteFunction> result;
   result.reserve(target_types_.size());
@@ -1047,12 +1059,14 @@ ColumnarResults::initAllConversionFunctions(
     const ResultSet& rows,
     const std::vector<size_t>& slot_idx_per_target_idx,
     const std::vector<bool>& targets_to_skip) {
-  CHECK(isDirectColumnarConversionPossible() &&
-        (rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-         rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash));
+  CHECK(isDirectColumnarConversionPossible() && is_compacted_by_entries(rows));
 
   const auto write_functions = initWriteFunctions(rows, targets_to_skip);
-  if (rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash) {
+  if (rows.getQueryDescriptionType() == QueryDescriptionType::Projection) {
+    return std::make_tuple(std::move(write_functions),
+                           initReadFunctions<QueryDescriptionType::Projection, false>(
+                               rows, slot_idx_per_target_idx, targets_to_skip));
+  } else if (rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash) {
     if (rows.didOutputColumnar()) {
       return std::make_tuple(
           std::move(write_functions),
@@ -232,6 +232,26 @@ llvm::Value* CodeGenerator::codegenCmp(const Analyzer::BinOper* bin_oper,
     }
   }
 
+  if (rhs_ti.is_array() && (optype == kEQ || optype == kNE) && !g_cluster) {
+    // A string literal compared with the elements of a dictionary encoded string array
+    // is translated to its id, the elements are then compared as integers, on GPU too,
+    // instead of being decoded to strings one at a time.
+    const auto lhs_constant = dynamic_cast<const Analyzer::Constant*>(lhs);
+    const auto cast_arr = dynamic_cast<const Analyzer::UOper*>(rhs);
+    const auto arr_expr = cast_arr ? cast_arr->get_operand() : rhs;
+    const auto& elem_ti = arr_expr->get_type_info().get_elem_type();
+    if (lhs_constant && !lhs_constant->get_is_null() && lhs_ti.is_string() &&
+        lhs_ti.get_compression() == kENCODING_NONE && elem_ti.is_dict_encoded_string()) {
+      const auto sdp = executor()->getStringDictionaryProxy(
+          elem_ti.get_comp_param(), executor()->getRowSetMemoryOwner(), true);
+      CHECK(sdp);
+      const auto str_id = sdp->getIdOfString(*lhs_constant->get_constval().stringval);
+      llvm::Value* str_id_lv = llvm::ConstantInt::get(
+          get_int_type(elem_ti.get_size() * 8, cgen_state_->context_), str_id, true);
+      return codegenQualifierCmp(optype, qualifier, {str_id_lv}, arr_expr, co);
+    }
+  }
+
   auto lhs_lvs = codegen(lhs, true, co);
   return codegenCmp(optype, qualifier, lhs_lvs, lhs_ti, rhs, co);
 }
@@ -22,9 +22,14 @@
 
 #include <memory>
 
+#include "Logger/Logger.h"
+
 class CompilationContext {
  public:
   virtual ~CompilationContext() {}
+
+  // bytes of native code held by this context, across all devices
+  virtual size_t getCodeSize() const { return 0; }
 };
 
 struct CompilationOptions;
@@ -53,7 +58,11 @@ class ExecutionEngineWrapper {
   llvm::ExecutionEngine* operator->() { return execution_engine_.get(); }
   const llvm::ExecutionEngine* operator->() const { return execution_engine_.get(); }
 
+  void setCodeSize(const size_t code_size) { code_size_ = code_size; }
+  size_t getCodeSize() const { return code_size_; }
+
  private:
+  size_t code_size_{0};
   std::unique_ptr<llvm::ExecutionEngine> execution_engine_;
   std::unique_ptr<llvm::JITEventListener> intel_jit_listener_;
 };
@@ -70,6 +79,8 @@ class CpuCompilationContext : public CompilationContext {
 
   void* func() const { return func_; }
 
+  size_t getCodeSize() const override { return execution_engine_.getCodeSize(); }
+
  private:
   void* func_{nullptr};
   ExecutionEngineWrapper execution_engine_;
@@ -21,7 +21,7 @@
 
 enum class ExecutorDeviceType { CPU, GPU };
 
-enum class ExecutorOptLevel { Default, LoopStrengthReduction, ReductionJIT };
+enum class ExecutorOptLevel { Default, LoopStrengthReduction, ReductionJIT, Baseline };
 
 enum class ExecutorExplainType { Default, Optimized };
 
@@ -62,7 +62,7 @@ struct CompilationOptions {
   }
 };
 
-enum class ExecutorType { Native, Extern };
+enum class ExecutorType { Native, Extern, Interpreter };
 
 struct ExecutionOptions {
   bool output_columnar_hint;
@@ -82,6 +82,10 @@ struct ExecutionOptions {
   const unsigned pending_query_interrupt_freq;
   ExecutorType executor_type = ExecutorType::Native;
   const std::vector<size_t> outer_fragment_indices{};
+  bool force_loop_joins{false};  // join with nested loops rather than hash tables
+  size_t max_kernel_parallelism{0};  // kernels of a step run at a time, 0 for no limit
+  double approximate_error{0.};  // relative error of sampled aggregates, 0 for exact ones
+  bool profile_steps{false};  // measure each step, for EXPLAIN ANALYZE
 
   static ExecutionOptions defaults() {
     return ExecutionOptions{false,
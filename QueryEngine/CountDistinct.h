@@ -27,6 +27,8 @@
 
 #include "Descriptors/CountDistinctDescriptor.h"
 #include "HyperLogLog.h"
+#include "RoaringBitmap.h"
+#include "SparseHll.h"
 
 #include <bitset>
 #include <set>
@@ -93,6 +95,12 @@ inline int64_t count_distinct_set_size(
     }
     return bitmap_set_size(set_vals, count_distinct_desc.bitmapSizeBytes());
   }
+  if (count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll) {
+    return reinterpret_cast<const SparseHll*>(set_handle)->cardinality();
+  }
+  if (count_distinct_desc.impl_type_ == CountDistinctImplType::RoaringBitmap) {
+    return reinterpret_cast<const RoaringBitmap*>(set_handle)->cardinality();
+  }
   CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
   return reinterpret_cast<std::set<int64_t>*>(set_handle)->size();
 }
@@ -141,6 +149,19 @@ inline void count_distinct_set_union(
                                       : old_count_distinct_desc.bitmapPaddedSizeBytes();
       bitmap_set_union(new_set, old_set, bitmap_byte_sz);
     }
+  } else if (new_count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll) {
+    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll);
+    // The reduction only keeps the old sketch, merging into the new one as well would
+    // make it dense for nothing.
+    CHECK(old_set_handle && new_set_handle);
+    reinterpret_cast<SparseHll*>(old_set_handle)
+        ->merge(*reinterpret_cast<const SparseHll*>(new_set_handle));
+  } else if (new_count_distinct_desc.impl_type_ == CountDistinctImplType::RoaringBitmap) {
+    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::RoaringBitmap);
+    // same as for the sparse HyperLogLog, only the old set is kept
+    CHECK(old_set_handle && new_set_handle);
+    reinterpret_cast<RoaringBitmap*>(old_set_handle)
+        ->unite(*reinterpret_cast<const RoaringBitmap*>(new_set_handle));
   } else {
     CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
     auto old_set = reinterpret_cast<std::set<int64_t>*>(old_set_handle);
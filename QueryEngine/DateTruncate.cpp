@@ -22,6 +22,7 @@
 #include "ExtractFromTime.h"
 
 #ifndef __CUDACC__
+#include <algorithm>
 #include <cstdlib>  // abort()
 #endif
 
@@ -273,6 +274,72 @@ int64_t DateTruncate(DatetruncField field, const int64_t timeval) {
   }
 }
 
+#ifndef __CUDACC__
+namespace {
+
+template <int64_t (*TRUNCATE)(int64_t)>
+void datetrunc_batch(const int64_t* timevals, int64_t* out, const size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = TRUNCATE(timevals[i]);
+  }
+}
+
+// timeval - (timeval + OFFSET) mod PERIOD
+template <int64_t PERIOD, int64_t OFFSET>
+void datetrunc_fixed_batch(const int64_t* timevals, int64_t* out, const size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = timevals[i] - unsigned_mod_branchless(timevals[i] + OFFSET, PERIOD);
+  }
+}
+
+}  // namespace
+
+void DateTruncateBatch(DatetruncField field,
+                       const int64_t* timevals,
+                       int64_t* out,
+                       const size_t count) {
+  switch (field) {
+    case dtNANOSECOND:
+    case dtMICROSECOND:
+    case dtMILLISECOND:
+    case dtSECOND:
+      std::copy(timevals, timevals + count, out);
+      return;
+    case dtMINUTE:
+      return datetrunc_fixed_batch<kSecsPerMin, 0>(timevals, out, count);
+    case dtHOUR:
+      return datetrunc_fixed_batch<kSecsPerHour, 0>(timevals, out, count);
+    case dtQUARTERDAY:
+      return datetrunc_fixed_batch<kSecsPerQuarterDay, 0>(timevals, out, count);
+    case dtDAY:
+      return datetrunc_fixed_batch<kSecsPerDay, 0>(timevals, out, count);
+    case dtWEEK:
+      return datetrunc_fixed_batch<7 * kSecsPerDay, dtMONDAY * kSecsPerDay>(
+          timevals, out, count);
+    case dtWEEK_SUNDAY:
+      return datetrunc_fixed_batch<7 * kSecsPerDay, dtSUNDAY * kSecsPerDay>(
+          timevals, out, count);
+    case dtWEEK_SATURDAY:
+      return datetrunc_fixed_batch<7 * kSecsPerDay, dtSATURDAY * kSecsPerDay>(
+          timevals, out, count);
+    case dtMONTH:
+      return datetrunc_batch<datetrunc_month>(timevals, out, count);
+    case dtQUARTER:
+      return datetrunc_batch<datetrunc_quarter>(timevals, out, count);
+    case dtYEAR:
+      return datetrunc_batch<datetrunc_year>(timevals, out, count);
+    case dtDECADE:
+      return datetrunc_batch<datetrunc_decade>(timevals, out, count);
+    case dtCENTURY:
+      return datetrunc_batch<datetrunc_century>(timevals, out, count);
+    case dtMILLENNIUM:
+      return datetrunc_batch<datetrunc_millennium>(timevals, out, count);
+    default:
+      abort();
+  }
+}
+#endif
+
 // scale is 10^{3,6,9}
 extern "C" ALWAYS_INLINE DEVICE int64_t
 DateTruncateHighPrecisionToDate(const int64_t timeval, const int64_t scale) {
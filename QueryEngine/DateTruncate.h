@@ -18,6 +18,7 @@
 #define QUERYENGINE_DATETRUNCATE_H
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 
 #include "../Shared/funcannotations.h"
@@ -71,6 +72,16 @@ static_assert(dtMICROSECOND + 1 == dtNANOSECOND, "Please keep these consecutive.
 
 int64_t DateTruncate(DatetruncField field, const int64_t timeval);
 
+#ifndef __CUDACC__
+// Truncates `count` values of seconds since the epoch at once. The loop over the values
+// is specialized by field and has no branch for the fields of a fixed length, so that
+// the compiler vectorizes it. The values must not be null sentinels.
+void DateTruncateBatch(DatetruncField field,
+                       const int64_t* timevals,
+                       int64_t* out,
+                       const size_t count);
+#endif
+
 extern "C" DEVICE int64_t DateTruncateHighPrecisionToDate(const int64_t timeval,
                                                           const int64_t scale);
 
@@ -101,6 +101,107 @@ SUFFIX(diff_fixed_width_int_decode)(const int8_t* byte_stream,
   return SUFFIX(fixed_width_int_decode)(byte_stream, byte_width, pos) + baseline;
 }
 
+// The codes of the bit-packed streams of DataMgr/IntegerCodecs.h.
+extern "C" DEVICE ALWAYS_INLINE uint64_t SUFFIX(bit_packed_code)(const int8_t* words,
+                                                                 const int32_t bit_width,
+                                                                 const int64_t pos) {
+  if (!bit_width) {
+    return 0;
+  }
+  const auto packed = reinterpret_cast<const uint64_t*>(words);
+  const uint64_t bit_pos = static_cast<uint64_t>(pos) * bit_width;
+  const auto word = bit_pos >> 6;
+  const auto shift = bit_pos & 63;
+  auto code = packed[word] >> shift;
+  if (shift + bit_width > 64) {
+    code |= packed[word + 1] << (64 - shift);
+  }
+  return bit_width == 64 ? code : code & ((uint64_t(1) << bit_width) - 1);
+}
+
+extern "C" DEVICE ALWAYS_INLINE int64_t
+SUFFIX(frame_of_reference_int_decode)(const int8_t* byte_stream,
+                                      const int64_t null_val,
+                                      const int64_t pos) {
+#ifdef WITH_DECODERS_BOUNDS_CHECKING
+  assert(pos >= 0);
+#endif  // WITH_DECODERS_BOUNDS_CHECKING
+  const auto base = *reinterpret_cast<const int64_t*>(byte_stream);
+  const auto bit_width = *reinterpret_cast<const int32_t*>(byte_stream + 8);
+  const auto has_null = *reinterpret_cast<const int32_t*>(byte_stream + 12);
+  const auto code = SUFFIX(bit_packed_code)(byte_stream + 16, bit_width, pos);
+  if (has_null &&
+      code == (bit_width == 64 ? ~uint64_t(0) : (uint64_t(1) << bit_width) - 1)) {
+    return null_val;
+  }
+  return static_cast<int64_t>(static_cast<uint64_t>(base) + code);
+}
+
+extern "C" DEVICE ALWAYS_INLINE int64_t
+SUFFIX(delta_int_decode)(const int8_t* byte_stream,
+                         const int32_t block_size,
+                         const int64_t pos) {
+#ifdef WITH_DECODERS_BOUNDS_CHECKING
+  assert(pos >= 0);
+#endif  // WITH_DECODERS_BOUNDS_CHECKING
+  const auto count = *reinterpret_cast<const int64_t*>(byte_stream);
+  const auto bit_width = *reinterpret_cast<const int32_t*>(byte_stream + 8);
+  const auto anchors = reinterpret_cast<const int64_t*>(byte_stream + 16);
+  const auto block_count = (count + block_size - 1) / block_size;
+  const auto deltas = byte_stream + 16 + block_count * 8;
+  const auto block_start = pos - pos % block_size;
+  auto val = static_cast<uint64_t>(anchors[pos / block_size]);
+  for (auto i = block_start + 1; i <= pos; ++i) {
+    const auto code = SUFFIX(bit_packed_code)(deltas, bit_width, i);
+    // undo the zig-zag encoding of the difference with the previous value
+    val += (code >> 1) ^ (~(code & 1) + 1);
+  }
+  return static_cast<int64_t>(val);
+}
+
+extern "C" DEVICE ALWAYS_INLINE int64_t SUFFIX(run_length_int_decode)(
+    const int8_t* byte_stream,
+    const int64_t pos) {
+#ifdef WITH_DECODERS_BOUNDS_CHECKING
+  assert(pos >= 0);
+#endif  // WITH_DECODERS_BOUNDS_CHECKING
+  const auto run_count = *reinterpret_cast<const int64_t*>(byte_stream);
+  const auto values = reinterpret_cast<const int64_t*>(byte_stream + 16);
+  const auto run_ends =
+      reinterpret_cast<const uint32_t*>(byte_stream + 16 + run_count * 8);
+  // the first run which ends past `pos`
+  int64_t lo{0};
+  int64_t hi{run_count - 1};
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    if (run_ends[mid] <= pos) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return values[lo];
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t
+SUFFIX(frame_of_reference_int_decode_noinline)(const int8_t* byte_stream,
+                                               const int64_t null_val,
+                                               const int64_t pos) {
+  return SUFFIX(frame_of_reference_int_decode)(byte_stream, null_val, pos);
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t
+SUFFIX(delta_int_decode_noinline)(const int8_t* byte_stream,
+                                  const int32_t block_size,
+                                  const int64_t pos) {
+  return SUFFIX(delta_int_decode)(byte_stream, block_size, pos);
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t
+SUFFIX(run_length_int_decode_noinline)(const int8_t* byte_stream, const int64_t pos) {
+  return SUFFIX(run_length_int_decode)(byte_stream, pos);
+}
+
 extern "C" DEVICE ALWAYS_INLINE float SUFFIX(
     fixed_width_float_decode)(const int8_t* byte_stream, const int64_t pos) {
 #ifdef WITH_DECODERS_BOUNDS_CHECKING
@@ -76,7 +76,8 @@ class DeepCopyVisitor : public ScalarExprVisitor<std::shared_ptr<Analyzer::Expr>
   }
 
   RetType visitSampleRatio(const Analyzer::SampleRatioExpr* expr) const override {
-    return makeExpr<Analyzer::SampleRatioExpr>(visit(expr->get_arg()));
+    return makeExpr<Analyzer::SampleRatioExpr>(visit(expr->get_arg()),
+                                                expr->isPerFragment());
   }
 
   RetType visitLower(const Analyzer::LowerExpr* expr) const override {
@@ -186,7 +187,8 @@ class DeepCopyVisitor : public ScalarExprVisitor<std::shared_ptr<Analyzer::Expr>
                                               args_copy,
                                               partition_keys_copy,
                                               order_keys_copy,
-                                              window_func->getCollation());
+                                              window_func->getCollation(),
+                                              window_func->getRowsFrame());
   }
 
   RetType visitFunctionOper(const Analyzer::FunctionOper* func_oper) const override {
@@ -234,7 +236,7 @@ class DeepCopyVisitor : public ScalarExprVisitor<std::shared_ptr<Analyzer::Expr>
                                        agg->get_aggtype(),
                                        arg,
                                        agg->get_is_distinct(),
-                                       agg->get_error_rate());
+                                       agg->get_arg1());
   }
 
   RetType visitOffsetInFragment(const Analyzer::OffsetInFragment*) const override {
@@ -38,7 +38,9 @@ inline size_t bitmap_bits_to_bytes(const size_t bitmap_sz) {
   return bitmap_byte_sz;
 }
 
-enum class CountDistinctImplType { Invalid, Bitmap, StdSet };
+// SparseHll: APPROX_COUNT_DISTINCT registers of a CPU group by, see SparseHll.h
+// RoaringBitmap: exact COUNT(DISTINCT) on CPU over a wide range, see RoaringBitmap.h
+enum class CountDistinctImplType { Invalid, Bitmap, StdSet, SparseHll, RoaringBitmap };
 
 struct CountDistinctDescriptor {
   CountDistinctImplType impl_type_;
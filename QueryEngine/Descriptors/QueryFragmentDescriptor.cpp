@@ -21,6 +21,9 @@
 #include "DataMgr/DataMgr.h"
 #include "QueryEngine/Execute.h"
 #include "Shared/misc.h"
+#include "Shared/thread_count.h"
+
+extern bool g_enable_delete_metadata_skipping;
 
 QueryFragmentDescriptor::QueryFragmentDescriptor(
     const RelAlgExecutionUnit& ra_exe_unit,
@@ -68,6 +71,7 @@ void QueryFragmentDescriptor::buildFragmentKernelMap(
     const ExecutorDeviceType& device_type,
     const bool enable_multifrag_kernels,
     const bool enable_inner_join_fragment_skipping,
+    const size_t cpu_kernel_min_rows,
     Executor* executor) {
   // For joins, only consider the cardinality of the LHS
   // columns in the bytes per row count.
@@ -80,6 +84,10 @@ void QueryFragmentDescriptor::buildFragmentKernelMap(
 
   const auto num_bytes_for_row = executor->getNumBytesForFetchedRow(lhs_table_ids);
 
+  if (enable_inner_join_fragment_skipping) {
+    join_key_range_quals_ = executor->getJoinKeyRangeQuals(ra_exe_unit);
+  }
+
   if (ra_exe_unit.union_all) {
     buildFragmentPerKernelMapForUnion(ra_exe_unit,
                                       frag_offsets,
@@ -102,6 +110,10 @@ void QueryFragmentDescriptor::buildFragmentKernelMap(
                               num_bytes_for_row,
                               device_type,
                               executor);
+    if (device_type == ExecutorDeviceType::CPU && cpu_kernel_min_rows > 0 &&
+        rowid_lookup_key_ < 0) {
+      batchCpuKernels(ra_exe_unit, cpu_kernel_min_rows);
+    }
   }
 }
 
@@ -139,6 +151,18 @@ void QueryFragmentDescriptor::buildFragmentPerKernelForTable(
     }
     return fragment.getNumTuples();
   };
+  // The rows of a fragment are all deleted when the delete column holds no false value.
+  auto is_fragment_fully_deleted = [&deleted_chunk_metadata_vec](const auto& fragment) {
+    const auto fragment_id = fragment.fragmentId;
+    CHECK_GE(fragment_id, 0);
+    if (!g_enable_delete_metadata_skipping || !fragment.getNumTuples() ||
+        static_cast<size_t>(fragment_id) >= deleted_chunk_metadata_vec.size()) {
+      return false;
+    }
+    const auto& chunk_metadata = deleted_chunk_metadata_vec[fragment_id].second;
+    return chunk_metadata->chunkStats.min.tinyintval == 1 &&
+           !chunk_metadata->chunkStats.has_nulls;
+  };
 
   for (size_t i = 0; i < fragments->size(); i++) {
     if (!allowed_outer_fragment_indices_.empty()) {
@@ -150,8 +174,22 @@ void QueryFragmentDescriptor::buildFragmentPerKernelForTable(
     }
 
     const auto& fragment = (*fragments)[i];
-    const auto skip_frag = executor->skipFragment(
+    if (is_fragment_fully_deleted(fragment)) {
+      continue;
+    }
+    auto skip_frag = executor->skipFragment(
         table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
+    if (!join_key_range_quals_.empty() && table_desc.getNestLevel() == 0 &&
+        skip_frag == std::pair<bool, int64_t>(false, -1)) {
+      skip_frag = executor->skipFragment(
+          table_desc, fragment, join_key_range_quals_, frag_offsets, i);
+    }
+    if (!skip_frag.first &&
+        (executor->skipFragmentBySampling(table_desc, frag_offsets, i, ra_exe_unit) ||
+         executor->skipFragmentByStats(table_desc, fragment, ra_exe_unit) ||
+         executor->skipFragmentByBloomFilters(table_desc, fragment, ra_exe_unit))) {
+      skip_frag = {true, -1};
+    }
     if (skip_frag.first) {
       continue;
     }
@@ -374,6 +412,21 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
       skip_frag = executor->skipFragmentInnerJoins(
           outer_table_desc, ra_exe_unit, fragment, frag_offsets, outer_frag_id);
     }
+    if (!join_key_range_quals_.empty() &&
+        skip_frag == std::pair<bool, int64_t>(false, -1)) {
+      skip_frag = executor->skipFragment(outer_table_desc,
+                                         fragment,
+                                         join_key_range_quals_,
+                                         frag_offsets,
+                                         outer_frag_id);
+    }
+    if (!skip_frag.first &&
+        (executor->skipFragmentBySampling(
+             outer_table_desc, frag_offsets, outer_frag_id, ra_exe_unit) ||
+         executor->skipFragmentByStats(outer_table_desc, fragment, ra_exe_unit) ||
+         executor->skipFragmentByBloomFilters(outer_table_desc, fragment, ra_exe_unit))) {
+      skip_frag = {true, -1};
+    }
     if (skip_frag.first) {
       continue;
     }
@@ -430,6 +483,76 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
 
 namespace {
 
+bool have_same_inner_fragments(const ExecutionKernelDescriptor& lhs,
+                               const ExecutionKernelDescriptor& rhs) {
+  if (lhs.fragments.size() != rhs.fragments.size()) {
+    return false;
+  }
+  for (size_t i = 1; i < lhs.fragments.size(); ++i) {
+    if (lhs.fragments[i].table_id != rhs.fragments[i].table_id ||
+        lhs.fragments[i].fragment_ids != rhs.fragments[i].fragment_ids) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+// Merges consecutive kernels of a device which join the same inner fragments into
+// kernels of at least min_rows_per_kernel outer rows, or of the outer rows of the device
+// spread over the CPU threads if fewer, so tables of many small fragments don't pay for
+// an output buffer, an execution context and a reduction per fragment.
+void QueryFragmentDescriptor::batchCpuKernels(const RelAlgExecutionUnit& ra_exe_unit,
+                                              const size_t min_rows_per_kernel) {
+  const auto outer_fragments =
+      selected_tables_fragments_.at(ra_exe_unit.input_descs.front().getTableId());
+  auto get_outer_row_count = [outer_fragments](const ExecutionKernelDescriptor& kernel) {
+    size_t row_count{0};
+    for (const auto frag_id : kernel.fragments.front().fragment_ids) {
+      CHECK_LT(frag_id, outer_fragments->size());
+      row_count += (*outer_fragments)[frag_id].getNumTuples();
+    }
+    return row_count;
+  };
+  const size_t thread_count = std::max(cpu_threads(), 1);
+  for (auto& device_itr : execution_kernels_per_device_) {
+    auto& kernels = device_itr.second;
+    size_t device_row_count{0};
+    for (const auto& kernel : kernels) {
+      device_row_count += get_outer_row_count(kernel);
+    }
+    const auto rows_per_kernel = std::min(
+        min_rows_per_kernel, (device_row_count + thread_count - 1) / thread_count);
+    std::vector<ExecutionKernelDescriptor> batched_kernels;
+    size_t batch_row_count{0};
+    for (auto& kernel : kernels) {
+      const auto row_count = get_outer_row_count(kernel);
+      if (!batched_kernels.empty() && batch_row_count < rows_per_kernel &&
+          have_same_inner_fragments(batched_kernels.back(), kernel)) {
+        auto& batch = batched_kernels.back();
+        auto& batch_frag_ids = batch.fragments.front().fragment_ids;
+        const auto& frag_ids = kernel.fragments.front().fragment_ids;
+        batch_frag_ids.insert(batch_frag_ids.end(), frag_ids.begin(), frag_ids.end());
+        if (batch.outer_tuple_count && kernel.outer_tuple_count) {
+          *batch.outer_tuple_count += *kernel.outer_tuple_count;
+        } else {
+          batch.outer_tuple_count = std::nullopt;
+        }
+        batch_row_count += row_count;
+        continue;
+      }
+      batched_kernels.push_back(std::move(kernel));
+      batch_row_count = row_count;
+    }
+    VLOG(1) << "Batched " << kernels.size() << " CPU kernels of device "
+            << device_itr.first << " into " << batched_kernels.size();
+    kernels = std::move(batched_kernels);
+  }
+}
+
+namespace {
+
 bool is_sample_query(const RelAlgExecutionUnit& ra_exe_unit) {
   const bool result = ra_exe_unit.input_descs.size() == 1 &&
                       ra_exe_unit.simple_quals.empty() && ra_exe_unit.quals.empty() &&
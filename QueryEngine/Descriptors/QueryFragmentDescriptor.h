@@ -24,6 +24,7 @@
 
 #include <deque>
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
@@ -36,6 +37,10 @@
 #include "Logger/Logger.h"
 #include "QueryEngine/CompilationOptions.h"
 
+namespace Analyzer {
+class Expr;
+}
+
 namespace Fragmenter_Namespace {
 class FragmentInfo;
 }
@@ -83,6 +88,7 @@ class QueryFragmentDescriptor {
                               const ExecutorDeviceType& device_type,
                               const bool enable_multifrag_kernels,
                               const bool enable_inner_join_fragment_skipping,
+                              const size_t cpu_kernel_min_rows,
                               Executor* executor);
 
   /**
@@ -146,6 +152,8 @@ class QueryFragmentDescriptor {
   std::vector<size_t> allowed_outer_fragment_indices_;
   size_t outer_fragments_size_ = 0;
   int64_t rowid_lookup_key_ = -1;
+  // range quals on the outer table implied by the inner join hash tables
+  std::list<std::shared_ptr<Analyzer::Expr>> join_key_range_quals_;
 
   std::map<int, const TableFragments*> selected_tables_fragments_;
 
@@ -190,6 +198,9 @@ class QueryFragmentDescriptor {
       const ExecutorDeviceType& device_type,
       Executor* executor);
 
+  void batchCpuKernels(const RelAlgExecutionUnit& ra_exe_unit,
+                       const size_t min_rows_per_kernel);
+
   bool terminateDispatchMaybe(size_t& tuple_count,
                               const RelAlgExecutionUnit& ra_exe_unit,
                               const ExecutionKernelDescriptor& kernel) const;
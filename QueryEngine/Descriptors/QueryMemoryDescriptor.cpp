@@ -444,6 +444,15 @@ QueryMemoryDescriptor::QueryMemoryDescriptor(
         output_columnar_ = false;
         break;
     }
+    // Only the row-wise initialization allocates the t-digests of APPROX_QUANTILE.
+    if (std::any_of(ra_exe_unit.target_exprs.begin(),
+                    ra_exe_unit.target_exprs.end(),
+                    [](const Analyzer::Expr* target_expr) {
+                      return is_approx_quantile_target(
+                          get_target_info(target_expr, g_bigint_count));
+                    })) {
+      output_columnar_ = false;
+    }
   }
 
   if (isLogicalSizedColumnsAllowed()) {
@@ -556,6 +565,9 @@ bool QueryMemoryDescriptor::operator==(const QueryMemoryDescriptor& other) const
   if (force_4byte_float_ != other.force_4byte_float_) {
     return false;
   }
+  if (packed_key_components_ != other.packed_key_components_) {
+    return false;
+  }
   if (group_col_widths_ != other.group_col_widths_) {
     return false;
   }
@@ -1122,6 +1134,7 @@ std::string QueryMemoryDescriptor::toString() const {
   str += "\tOutput Columnar: " + ::toString(output_columnar_) + "\n";
   str += "\tRender Output: " + ::toString(render_output_) + "\n";
   str += "\tUse Baseline Sort: " + ::toString(must_use_baseline_sort_) + "\n";
+  str += "\tPacked Key: " + ::toString(hasPackedKey()) + "\n";
   return str;
 }
 
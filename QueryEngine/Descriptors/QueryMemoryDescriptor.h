@@ -39,6 +39,7 @@
 #include <memory>
 #include <numeric>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <Shared/SqlTypesLayout.h>
@@ -65,6 +66,25 @@ class StreamingTopNOOM : public std::runtime_error {
                            " bytes exceeding maximum slab size.") {}
 };
 
+// A column of a multi-column baseline hash group by whose key is bit-packed into the
+// first key slot: the slot holds the sum of (value - min) << shift over the columns, with
+// nulls translated to null_key. The other key slots are only filled once the kernel is
+// done, by unpacking the first one.
+struct PackedKeyComponent {
+  int64_t min;
+  int64_t null_key;  // max + 1 if the column has nulls
+  int64_t null_val;  // the null sentinel of the column, stored in its unpacked slot
+  bool has_nulls;
+  int8_t shift;
+  int8_t bit_count;
+
+  bool operator==(const PackedKeyComponent& that) const {
+    return min == that.min && null_key == that.null_key && null_val == that.null_val &&
+           has_nulls == that.has_nulls && shift == that.shift &&
+           bit_count == that.bit_count;
+  }
+};
+
 class QueryMemoryDescriptor {
  public:
   QueryMemoryDescriptor();
@@ -275,6 +295,14 @@ class QueryMemoryDescriptor {
   bool forceFourByteFloat() const { return force_4byte_float_; }
   void setForceFourByteFloat(const bool val) { force_4byte_float_ = val; }
 
+  bool hasPackedKey() const { return !packed_key_components_.empty(); }
+  const std::vector<PackedKeyComponent>& getPackedKeyComponents() const {
+    return packed_key_components_;
+  }
+  void setPackedKeyComponents(std::vector<PackedKeyComponent> components) {
+    packed_key_components_ = std::move(components);
+  }
+
   // Getters derived from state
   size_t getGroupbyColCount() const { return group_col_widths_.size(); }
   size_t getKeyCount() const { return keyless_hash_ ? 0 : getGroupbyColCount(); }
@@ -358,6 +386,8 @@ class QueryMemoryDescriptor {
 
   bool force_4byte_float_;
 
+  std::vector<PackedKeyComponent> packed_key_components_;
+
   ColSlotContext col_slot_context_;
 
   size_t getTotalBytesOfColumnarBuffers() const;
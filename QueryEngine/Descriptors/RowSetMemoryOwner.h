@@ -17,9 +17,12 @@
 #pragma once
 
 #include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -28,28 +31,98 @@
 #include "DataMgr/Allocators/ArenaAllocator.h"
 #include "DataMgr/DataMgr.h"
 #include "Logger/Logger.h"
+#include "QueryEngine/OutputBufferPool.h"
+#include "QueryEngine/RoaringBitmap.h"
+#include "QueryEngine/SparseHll.h"
+#include "QueryEngine/TDigest.h"
 #include "StringDictionary/StringDictionaryProxy.h"
 
+extern size_t g_max_query_host_memory_bytes;
+
 class ResultSet;
 
+class QueryMemoryLimitExceeded : public std::runtime_error {
+ public:
+  QueryMemoryLimitExceeded(const size_t requested_bytes, const size_t max_bytes)
+      : std::runtime_error("Query needs more than its host memory limit of " +
+                           std::to_string(max_bytes) + " bytes, " +
+                           std::to_string(requested_bytes) + " bytes requested") {}
+};
+
 /**
  * Handles allocations and outputs for all stages in a query, either explicitly or via a
- * managed allocator object
+ * managed allocator object. Accounts the host memory the query holds, and fails the
+ * allocations past `max_bytes` if nonzero.
  */
 class RowSetMemoryOwner : boost::noncopyable {
  public:
-  RowSetMemoryOwner(const size_t arena_block_size)
+  RowSetMemoryOwner(const size_t arena_block_size, const size_t max_bytes = 0)
       : arena_block_size_(arena_block_size)
+      , max_bytes_(max_bytes)
       , allocator_(std::make_unique<Arena>(arena_block_size)) {}
 
   int8_t* allocate(const size_t num_bytes) {
     CHECK(allocator_);
+    addAllocatedBytes(num_bytes);
     std::lock_guard<std::mutex> lock(state_mutex_);
     return reinterpret_cast<int8_t*>(allocator_->allocate(num_bytes));
   }
 
+  /**
+   * Allocates an output or group by buffer, not initialized. With the output buffer pool
+   * enabled, the buffer is reused from a finished query if possible and goes back to
+   * the pool with the owner.
+   */
+  int8_t* allocateOutputBuffer(const size_t num_bytes) {
+    addAllocatedBytes(num_bytes);
+    OutputBuffer output_buffer{{}, num_bytes, false};
+    if (g_enable_output_buffer_pool) {
+      output_buffer.buffer = OutputBufferPool::instance().acquire(num_bytes);
+      output_buffer.pooled = output_buffer.buffer.ptr != nullptr;
+    }
+    if (!output_buffer.pooled) {
+      // not from the arena, so that releaseOutputBuffer() can free it
+      output_buffer.buffer.ptr =
+          reinterpret_cast<int8_t*>(SysAllocator<void>().allocate(num_bytes));
+      output_buffer.buffer.capacity = num_bytes;
+    }
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    output_buffers_.push_back(output_buffer);
+    return output_buffer.buffer.ptr;
+  }
+
+  bool hasOutputBuffer(const int8_t* ptr) const {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    return std::any_of(output_buffers_.begin(),
+                       output_buffers_.end(),
+                       [ptr](const OutputBuffer& output_buffer) {
+                         return output_buffer.buffer.ptr == ptr;
+                       });
+  }
+
+  /**
+   * Frees an output buffer of allocateOutputBuffer() before the owner goes away, once its
+   * contents have been moved elsewhere. Returns false if it is not one of its buffers.
+   */
+  bool releaseOutputBuffer(const int8_t* ptr) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    const auto it = std::find_if(output_buffers_.begin(),
+                                 output_buffers_.end(),
+                                 [ptr](const OutputBuffer& output_buffer) {
+                                   return output_buffer.buffer.ptr == ptr;
+                                 });
+    if (it == output_buffers_.end()) {
+      return false;
+    }
+    freeOutputBuffer(*it);
+    allocated_bytes_.fetch_sub(it->num_bytes);
+    output_buffers_.erase(it);
+    return true;
+  }
+
   int8_t* allocateCountDistinctBuffer(const size_t num_bytes) {
     CHECK(allocator_);
+    addAllocatedBytes(num_bytes);
     std::lock_guard<std::mutex> lock(state_mutex_);
     auto ret = reinterpret_cast<int8_t*>(allocator_->allocateAndZero(num_bytes));
     count_distinct_bitmaps_.emplace_back(
@@ -70,6 +143,24 @@ class RowSetMemoryOwner : boost::noncopyable {
     count_distinct_sets_.push_back(count_distinct_set);
   }
 
+  RoaringBitmap* addRoaringBitmap() {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    roaring_bitmaps_.emplace_back();
+    return &roaring_bitmaps_.back();
+  }
+
+  SparseHll* addSparseHll(const uint32_t bitmap_sz_bits) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    sparse_hlls_.emplace_back(bitmap_sz_bits);
+    return &sparse_hlls_.back();
+  }
+
+  TDigest* addTDigest(const double q) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    t_digests_.emplace_back(q);
+    return &t_digests_.back();
+  }
+
   void addGroupByBuffer(int64_t* group_by_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     group_by_buffers_.push_back(group_by_buffer);
@@ -92,12 +183,14 @@ class RowSetMemoryOwner : boost::noncopyable {
   }
 
   std::string* addString(const std::string& str) {
+    addAllocatedBytes(str.size());
     std::lock_guard<std::mutex> lock(state_mutex_);
     strings_.emplace_back(str);
     return &strings_.back();
   }
 
   std::vector<int64_t>* addArray(const std::vector<int64_t>& arr) {
+    addAllocatedBytes(arr.size() * sizeof(int64_t));
     std::lock_guard<std::mutex> lock(state_mutex_);
     arrays_.emplace_back(arr);
     return &arrays_.back();
@@ -160,16 +253,49 @@ class RowSetMemoryOwner : boost::noncopyable {
     for (auto col_buffer : col_buffers_) {
       free(col_buffer);
     }
+    for (const auto& output_buffer : output_buffers_) {
+      freeOutputBuffer(output_buffer);
+    }
+  }
+
+  /**
+   * Accounts host memory held for the query, including the memory allocated elsewhere
+   * on its behalf, like the join hash tables it builds. Throws QueryMemoryLimitExceeded
+   * instead if the query would hold more than its limit, the memory must not be
+   * allocated then.
+   */
+  void addAllocatedBytes(const size_t num_bytes) {
+    const auto allocated_bytes = allocated_bytes_.fetch_add(num_bytes) + num_bytes;
+    if (max_bytes_ && allocated_bytes > max_bytes_) {
+      allocated_bytes_.fetch_sub(num_bytes);
+      throw QueryMemoryLimitExceeded(allocated_bytes, max_bytes_);
+    }
   }
 
+  size_t getAllocatedBytes() const { return allocated_bytes_.load(); }
+
   std::shared_ptr<RowSetMemoryOwner> cloneStrDictDataOnly() {
-    auto rtn = std::make_shared<RowSetMemoryOwner>(arena_block_size_);
+    auto rtn = std::make_shared<RowSetMemoryOwner>(arena_block_size_, max_bytes_);
     rtn->str_dict_proxy_owned_ = str_dict_proxy_owned_;
     rtn->lit_str_dict_proxy_ = lit_str_dict_proxy_;
     return rtn;
   }
 
  private:
+  struct OutputBuffer {
+    OutputBufferPool::Buffer buffer;
+    size_t num_bytes;
+    bool pooled;
+  };
+
+  static void freeOutputBuffer(const OutputBuffer& output_buffer) {
+    if (output_buffer.pooled) {
+      OutputBufferPool::instance().release(output_buffer.buffer);
+    } else {
+      SysAllocator<void>().deallocate(output_buffer.buffer.ptr, output_buffer.num_bytes);
+    }
+  }
+
   struct CountDistinctBitmapBuffer {
     int8_t* ptr;
     const size_t size;
@@ -178,6 +304,9 @@ class RowSetMemoryOwner : boost::noncopyable {
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
   std::vector<std::set<int64_t>*> count_distinct_sets_;
+  std::list<RoaringBitmap> roaring_bitmaps_;
+  std::list<SparseHll> sparse_hlls_;
+  std::list<TDigest> t_digests_;
   std::vector<int64_t*> group_by_buffers_;
   std::vector<void*> varlen_buffers_;
   std::list<std::string> strings_;
@@ -186,8 +315,11 @@ class RowSetMemoryOwner : boost::noncopyable {
   std::shared_ptr<StringDictionaryProxy> lit_str_dict_proxy_;
   std::vector<void*> col_buffers_;
   std::vector<Data_Namespace::AbstractBuffer*> varlen_input_buffers_;
+  std::vector<OutputBuffer> output_buffers_;
 
   size_t arena_block_size_;  // for cloning
+  const size_t max_bytes_;
+  std::atomic<size_t> allocated_bytes_{0};
   std::unique_ptr<Arena> allocator_;
 
   mutable std::mutex state_mutex_;
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/DeviceCostModel.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "Catalog/Catalog.h"
+#include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "Shared/thread_count.h"
+
+bool g_enable_device_cost_model{false};
+
+namespace device_cost_model {
+
+namespace {
+
+// Rough throughputs, in bytes per millisecond, of a CPU thread scanning columns, of a
+// GPU scanning columns and of the transfers to a GPU.
+constexpr double kCpuThreadBytesPerMs{2e6};
+constexpr double kGpuBytesPerMs{1e8};
+constexpr double kTransferBytesPerMs{1e7};
+// Kernel launches, copying the output buffers back and synchronizing the devices.
+constexpr double kGpuStepOverheadMs{1.};
+
+std::atomic<int64_t> queued_work_us[2];
+
+std::atomic<int64_t>& get_queued_work(const ExecutorDeviceType device_type) {
+  return queued_work_us[device_type == ExecutorDeviceType::GPU ? 1 : 0];
+}
+
+const InputTableInfo* get_table_info(const std::vector<InputTableInfo>& table_infos,
+                                     const int table_id) {
+  for (const auto& table_info : table_infos) {
+    if (table_info.table_id == table_id) {
+      return &table_info;
+    }
+  }
+  return nullptr;
+}
+
+// The work queued on the devices of a type, spread over them.
+double get_queued_ms(const ExecutorDeviceType device_type, const int device_count) {
+  return get_queued_work_us(device_type) / 1000. / std::max(device_count, 1);
+}
+
+}  // namespace
+
+StepInputs get_step_inputs(const RelAlgExecutionUnit& ra_exe_unit,
+                           const std::vector<InputTableInfo>& table_infos,
+                           const Catalog_Namespace::Catalog& cat,
+                           const int gpu_count) {
+  StepInputs inputs;
+  if (!ra_exe_unit.input_descs.empty()) {
+    const auto outer_table_info =
+        get_table_info(table_infos, ra_exe_unit.input_descs.front().getTableId());
+    if (outer_table_info) {
+      inputs.fragment_count = outer_table_info->info.fragments.size();
+    }
+  }
+  auto& data_mgr = cat.getDataMgr();
+  const int db_id = cat.getCurrentDB().dbId;
+  for (const auto& col_desc : ra_exe_unit.input_col_descs) {
+    CHECK(col_desc);
+    const int table_id = col_desc->getScanDesc().getTableId();
+    const auto table_info = get_table_info(table_infos, table_id);
+    if (!table_info) {
+      continue;
+    }
+    if (table_id < 0) {
+      // intermediate results are in CPU memory, assume 8 bytes per value
+      inputs.input_bytes += table_info->info.getNumTuples() * sizeof(int64_t);
+      continue;
+    }
+    const auto cd = cat.getMetadataForColumn(table_id, col_desc->getColId());
+    if (!cd || cd->isVirtualCol) {
+      continue;
+    }
+    for (const auto& fragment : table_info->info.fragments) {
+      const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+      const auto chunk_metadata_it = chunk_metadata_map.find(cd->columnId);
+      if (chunk_metadata_it == chunk_metadata_map.end()) {
+        continue;
+      }
+      const size_t num_bytes = chunk_metadata_it->second->numBytes;
+      inputs.input_bytes += num_bytes;
+      if (gpu_count <= 0) {
+        continue;
+      }
+      ChunkKey chunk_key{
+          db_id, fragment.physicalTableId, cd->columnId, fragment.fragmentId};
+      if (cd->columnType.is_varlen_indeed()) {
+        chunk_key.push_back(1);
+      }
+      const int device_id =
+          (fragment.shard == -1
+               ? fragment.deviceIds[static_cast<int>(Data_Namespace::GPU_LEVEL)]
+               : fragment.shard) %
+          gpu_count;
+      if (data_mgr.isBufferOnDevice(chunk_key, Data_Namespace::GPU_LEVEL, device_id)) {
+        inputs.gpu_resident_bytes += num_bytes;
+      }
+    }
+  }
+  return inputs;
+}
+
+double estimate_step_ms(const ExecutorDeviceType device_type,
+                        const StepInputs& inputs,
+                        const int device_count) {
+  const size_t parallelism = std::max(
+      std::min(static_cast<size_t>(std::max(device_count, 1)), inputs.fragment_count),
+      size_t(1));
+  if (device_type == ExecutorDeviceType::CPU) {
+    return inputs.input_bytes / (kCpuThreadBytesPerMs * parallelism);
+  }
+  CHECK_GE(inputs.input_bytes, inputs.gpu_resident_bytes);
+  const auto transfer_bytes = inputs.input_bytes - inputs.gpu_resident_bytes;
+  return kGpuStepOverheadMs + transfer_bytes / (kTransferBytesPerMs * parallelism) +
+         inputs.input_bytes / (kGpuBytesPerMs * parallelism);
+}
+
+ExecutorDeviceType choose_device_type(const StepInputs& inputs, const int gpu_count) {
+  if (gpu_count <= 0) {
+    return ExecutorDeviceType::CPU;
+  }
+  const int cpu_count = cpu_threads();
+  const auto cpu_ms = get_queued_ms(ExecutorDeviceType::CPU, cpu_count) +
+                      estimate_step_ms(ExecutorDeviceType::CPU, inputs, cpu_count);
+  const auto gpu_ms = get_queued_ms(ExecutorDeviceType::GPU, gpu_count) +
+                      estimate_step_ms(ExecutorDeviceType::GPU, inputs, gpu_count);
+  VLOG(1) << "Estimated step time on CPU: " << cpu_ms << " ms, on GPU: " << gpu_ms
+          << " ms, input bytes: " << inputs.input_bytes
+          << ", resident on GPU: " << inputs.gpu_resident_bytes;
+  return cpu_ms < gpu_ms ? ExecutorDeviceType::CPU : ExecutorDeviceType::GPU;
+}
+
+ScopedQueuedWork::ScopedQueuedWork(const ExecutorDeviceType device_type,
+                                   const double estimated_ms)
+    : device_type_(device_type)
+    , estimated_us_(static_cast<int64_t>(estimated_ms * 1000)) {
+  get_queued_work(device_type_) += estimated_us_;
+}
+
+ScopedQueuedWork::~ScopedQueuedWork() {
+  get_queued_work(device_type_) -= estimated_us_;
+}
+
+int64_t get_queued_work_us(const ExecutorDeviceType device_type) {
+  return std::max(get_queued_work(device_type).load(), int64_t(0));
+}
+
+}  // namespace device_cost_model
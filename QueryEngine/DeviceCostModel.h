@@ -0,0 +1,86 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    DeviceCostModel.h
+ * @brief   Chooses the device a step of a query runs on when the session runs on GPU.
+ *
+ * The cost of a step on a device is the time to move the bytes of its input columns
+ * which aren't resident on the device yet, the time to scan all of them and the fixed
+ * overhead of a launch, plus the estimated work of the steps already queued on the
+ * device. Small steps run on CPU rather than paying for the transfers and the launch,
+ * big steps on columns already in GPU memory run on GPU.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "QueryEngine/CompilationOptions.h"
+
+extern bool g_enable_device_cost_model;
+
+namespace Catalog_Namespace {
+class Catalog;
+}  // namespace Catalog_Namespace
+
+struct InputTableInfo;
+struct RelAlgExecutionUnit;
+
+namespace device_cost_model {
+
+struct StepInputs {
+  // bytes of the input columns of the step
+  size_t input_bytes{0};
+  // the part of input_bytes already in GPU memory
+  size_t gpu_resident_bytes{0};
+  // number of fragments of the outer table, the kernels run in parallel up to it
+  size_t fragment_count{0};
+};
+
+StepInputs get_step_inputs(const RelAlgExecutionUnit& ra_exe_unit,
+                           const std::vector<InputTableInfo>& table_infos,
+                           const Catalog_Namespace::Catalog& cat,
+                           const int gpu_count);
+
+// Estimated time to run a step on device_count devices of a type, not counting the work
+// already queued on them.
+double estimate_step_ms(const ExecutorDeviceType device_type,
+                        const StepInputs& inputs,
+                        const int device_count);
+
+// Device type with the lowest estimated time for the step, queued work included.
+ExecutorDeviceType choose_device_type(const StepInputs& inputs, const int gpu_count);
+
+// Accounts for the estimated work of a step as queued on a device while in scope.
+class ScopedQueuedWork {
+ public:
+  ScopedQueuedWork(const ExecutorDeviceType device_type, const double estimated_ms);
+  ~ScopedQueuedWork();
+
+  ScopedQueuedWork(const ScopedQueuedWork&) = delete;
+  ScopedQueuedWork& operator=(const ScopedQueuedWork&) = delete;
+
+ private:
+  const ExecutorDeviceType device_type_;
+  const int64_t estimated_us_;
+};
+
+int64_t get_queued_work_us(const ExecutorDeviceType device_type);
+
+}  // namespace device_cost_model
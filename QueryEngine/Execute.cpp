@@ -17,6 +17,7 @@
 #include "Execute.h"
 
 #include "AggregateUtils.h"
+#include "ChunkPrefetcher.h"
 #include "CodeGenerator.h"
 #include "ColumnFetcher.h"
 #include "Descriptors/QueryCompilationDescriptor.h"
@@ -32,19 +33,24 @@
 #include "JoinHashTable/OverlapsJoinHashTable.h"
 #include "JsonAccessors.h"
 #include "OutputBufferInitialization.h"
+#include "OutputBufferPool.h"
 #include "QueryEngine/QueryDispatchQueue.h"
 #include "QueryRewrite.h"
 #include "QueryTemplateGenerator.h"
 #include "ResultSetReductionJIT.h"
 #include "RuntimeFunctions.h"
 #include "SpeculativeTopN.h"
+#include "TopKGroupPruner.h"
 
 #include "TableFunctions/TableFunctionCompilationContext.h"
 #include "TableFunctions/TableFunctionExecutionContext.h"
 
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DataMgr/BufferMgr/GpuCudaBufferMgr/GpuCudaBufferMgr.h"
+#include "Geospatial/Compression.h"
 #include "Parser/ParserNode.h"
+#include "Shared/NumaUtils.h"
 #include "Shared/SystemParameters.h"
 #include "Shared/TypedDataAccessors.h"
 #include "Shared/checked_alloc.h"
@@ -63,7 +69,9 @@
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
+#include "GpuChunkDecode.h"
 #endif  // HAVE_CUDA
+#include <array>
 #include <future>
 #include <memory>
 #include <numeric>
@@ -80,6 +88,7 @@ bool g_null_div_by_zero{false};
 unsigned g_trivial_loop_join_threshold{1000};
 bool g_from_table_reordering{true};
 bool g_inner_join_fragment_skipping{true};
+bool g_enable_expression_fragment_skipping{true};
 extern bool g_enable_smem_group_by;
 extern std::unique_ptr<llvm::Module> udf_gpu_module;
 extern std::unique_ptr<llvm::Module> udf_cpu_module;
@@ -91,11 +100,22 @@ bool g_enable_columnar_output{false};
 bool g_enable_overlaps_hashjoin{false};
 bool g_enable_hashjoin_many_to_many{false};
 size_t g_overlaps_max_table_size_bytes{1024 * 1024 * 1024};
+size_t g_overlaps_auto_tuner_sample_rows{100000};
+size_t g_hash_join_partition_threshold_bytes{size_t(64) << 20};
+size_t g_hash_join_partition_bytes{size_t(1) << 20};
+size_t g_hash_table_cache_max_bytes{0};  // no limit
+bool g_enable_join_fragment_pairing{false};
+bool g_enable_shared_gpu_hash_tables{false};
+size_t g_max_perfect_hash_entries_per_row{64};
+size_t g_hash_join_prefetch_distance{16};
+bool g_enable_tree_reduction{true};
 bool g_strip_join_covered_quals{false};
+bool g_enable_lazy_fetch_through_outer_joins{false};
 size_t g_constrained_by_in_threshold{10};
 size_t g_big_group_threshold{20000};
 bool g_enable_window_functions{true};
 bool g_enable_table_functions{false};
+size_t g_table_function_partition_rows{65536};
 size_t g_max_memory_allocation_size{2000000000};  // set to max slab size
 size_t g_min_memory_allocation_size{
     256};  // minimum memory allocation required for projection query output buffer
@@ -108,6 +128,7 @@ bool g_enable_runtime_query_interrupt{false};
 bool g_use_estimator_result_cache{true};
 unsigned g_pending_query_interrupt_freq{1000};
 double g_running_query_interrupt_freq{0.5};
+size_t g_cpu_interrupt_check_block_rows{4096};
 size_t g_gpu_smem_threshold{
     4096};  // GPU shared memory threshold (in bytes), if larger
             // buffer sizes are required we do not use GPU shared
@@ -119,10 +140,23 @@ bool g_enable_smem_grouped_non_count_agg{
 bool g_enable_smem_non_grouped_agg{
     true};  // enable optimizations for using GPU shared memory in implementation of
             // non-grouped aggregates
+bool g_enable_smem_baseline_group_by{
+    true};  // enable use of shared memory when performing baseline hash group-by
 bool g_is_test_env{false};  // operating under a unit test environment. Currently only
                             // limits the allocation for the output buffer arena
+bool g_enable_admission_control{false};
+bool g_enable_work_stealing_kernel_dispatch{false};
+bool g_enable_gpu_kernel_streams{false};
+bool g_enable_gpu_launch_graphs{false};
+bool g_enable_cpu_multifrag_kernels{false};
+bool g_enable_streaming_reduction{false};
+bool g_enable_delete_metadata_skipping{true};
+size_t g_cpu_multifrag_kernel_min_rows{1 << 20};
+size_t g_admission_control_timeout_ms{60000};
+size_t g_max_query_host_memory_bytes{0};  // 0 means no limit
 
 extern bool g_cache_string_hash;
+extern size_t g_code_cache_max_bytes;
 
 int const Executor::max_gpu_count;
 
@@ -135,8 +169,8 @@ Executor::Executor(const ExecutorId executor_id,
                    const std::string& debug_dir,
                    const std::string& debug_file)
     : cgen_state_(new CgenState({}, false))
-    , cpu_code_cache_(code_cache_size)
-    , gpu_code_cache_(code_cache_size)
+    , cpu_code_cache_(code_cache_size, g_code_cache_max_bytes)
+    , gpu_code_cache_(code_cache_size, g_code_cache_max_bytes)
     , block_size_x_(block_size_x)
     , grid_size_x_(grid_size_x)
     , max_gpu_slab_size_(max_gpu_slab_size)
@@ -145,7 +179,15 @@ Executor::Executor(const ExecutorId executor_id,
     , executor_id_(executor_id)
     , catalog_(nullptr)
     , temporary_tables_(nullptr)
-    , input_table_info_cache_(this) {}
+    , input_table_info_cache_(this) {
+#ifdef HAVE_CUDA
+  // the GPU buffer pools decode the compressed chunks with the kernel of the QueryEngine
+  static std::once_flag chunk_decoder_flag;
+  std::call_once(chunk_decoder_flag, [] {
+    Buffer_Namespace::GpuCudaBufferMgr::setChunkDecoder(decode_integer_chunk_on_device);
+  });
+#endif  // HAVE_CUDA
+}
 
 std::shared_ptr<Executor> Executor::getExecutor(
     const ExecutorId executor_id,
@@ -183,6 +225,9 @@ void Executor::clearMemory(const Data_Namespace::MemoryLevel memory_level) {
         // For now, assume the user wants to purge the hash table cache when they clear
         // CPU memory (currently used in ExecuteTest to lower memory pressure)
         JoinHashTableCacheInvalidator::invalidateCaches();
+        OutputBufferPool::instance().clear();
+      } else {
+        GpuStringDictionaryPayload::clearCache();
       }
       break;
     }
@@ -194,6 +239,41 @@ void Executor::clearMemory(const Data_Namespace::MemoryLevel memory_level) {
   }
 }
 
+size_t Executor::compactMemoryIfIdle(const Data_Namespace::MemoryLevel memory_level) {
+  mapd_unique_lock<mapd_shared_mutex> lock(execute_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return 0;
+  }
+  return Catalog_Namespace::SysCatalog::instance().getDataMgr().compactMemory(
+      memory_level);
+}
+
+bool Executor::runIfIdle(const std::function<void()>& func) {
+  {
+    mapd_unique_lock<mapd_shared_mutex> lock(execute_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      return false;
+    }
+  }
+  // the queries starting meanwhile aren't held up
+  mapd_shared_lock<mapd_shared_mutex> lock(execute_mutex_);
+  func();
+  return true;
+}
+
+std::vector<Executor::CodeCacheStatus> Executor::getCodeCacheStatus() {
+  std::vector<CodeCacheStatus> code_cache_status;
+  mapd_shared_lock<mapd_shared_mutex> lock(executors_cache_mutex_);
+  for (const auto& [id, executor] : executors_) {
+    const auto executor_id = static_cast<ExecutorId>(id);
+    code_cache_status.push_back(
+        {executor_id, ExecutorDeviceType::CPU, executor->cpu_code_cache_.getStats()});
+    code_cache_status.push_back(
+        {executor_id, ExecutorDeviceType::GPU, executor->gpu_code_cache_.getStats()});
+  }
+  return code_cache_status;
+}
+
 size_t Executor::getArenaBlockSize() {
   return g_is_test_env ? 100000000 : (1UL << 32) + kArenaBlockOverhead;
 }
@@ -958,9 +1038,37 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
   const auto reduction_code =
       get_reduction_code(results_per_device, &compilation_queue_time);
 
-  for (size_t i = 1; i < results_per_device.size(); ++i) {
-    reduced_results->getStorage()->reduce(
-        *(results_per_device[i].first->getStorage()), {}, reduction_code);
+  // Small buffers are reduced on a single thread each, merge the results of the devices
+  // pairwise instead of all into the first one so that the merges of a level of the tree
+  // run in parallel. Baseline buffers are not merged in a tree: they only fit the groups
+  // of all the devices once moved into the larger buffer above.
+  const bool use_tree_reduction =
+      g_enable_tree_reduction && results_per_device.size() > 2 &&
+      query_mem_desc.getQueryDescriptionType() !=
+          QueryDescriptionType::GroupByBaselineHash &&
+      !result_set::use_multithreaded_reduction(query_mem_desc.getEntryCount());
+  if (use_tree_reduction) {
+    for (size_t stride = 1; stride < results_per_device.size(); stride *= 2) {
+      threadpool::FuturesThreadPool<void> thread_pool;
+      for (size_t i = 0; i + stride < results_per_device.size(); i += 2 * stride) {
+        thread_pool.spawn(
+            [&results_per_device, &reduction_code](const size_t this_idx,
+                                                   const size_t that_idx) {
+              results_per_device[this_idx].first->getStorage()->reduce(
+                  *(results_per_device[that_idx].first->getStorage()),
+                  {},
+                  reduction_code);
+            },
+            i,
+            i + stride);
+      }
+      thread_pool.join();
+    }
+  } else {
+    for (size_t i = 1; i < results_per_device.size(); ++i) {
+      reduced_results->getStorage()->reduce(
+          *(results_per_device[i].first->getStorage()), {}, reduction_code);
+    }
   }
   reduced_results->addCompilationQueueTime(compilation_queue_time);
   return reduced_results;
@@ -1306,6 +1414,120 @@ RelAlgExecutionUnit replace_scan_limit(const RelAlgExecutionUnit& ra_exe_unit_in
           ra_exe_unit_in.query_state};
 }
 
+// Orders kernels by decreasing number of input rows, so the largest fragments start
+// first and the smallest ones are left over for idle workers to steal at the end.
+void sort_kernels_by_input_size(std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+                                const std::vector<InputTableInfo>& query_infos) {
+  std::unordered_map<int, const Fragmenter_Namespace::TableInfo*> table_id_to_info;
+  for (const auto& query_info : query_infos) {
+    table_id_to_info.emplace(query_info.table_id, &query_info.info);
+  }
+  auto kernel_num_rows = [&table_id_to_info](const ExecutionKernel& kernel) {
+    size_t num_rows{0};
+    for (const auto& fragments_per_table : kernel.getFragmentList()) {
+      const auto table_info_it = table_id_to_info.find(fragments_per_table.table_id);
+      if (table_info_it == table_id_to_info.end()) {
+        continue;
+      }
+      const auto& fragments = table_info_it->second->fragments;
+      for (const auto frag_id : fragments_per_table.fragment_ids) {
+        CHECK_LT(frag_id, fragments.size());
+        num_rows += fragments[frag_id].getNumTuples();
+      }
+    }
+    return num_rows;
+  };
+  std::vector<std::pair<size_t, std::unique_ptr<ExecutionKernel>>> sized_kernels;
+  sized_kernels.reserve(kernels.size());
+  for (auto& kernel : kernels) {
+    CHECK(kernel);
+    const auto num_rows = kernel_num_rows(*kernel);
+    sized_kernels.emplace_back(num_rows, std::move(kernel));
+  }
+  std::stable_sort(sized_kernels.begin(),
+                   sized_kernels.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  kernels.clear();
+  for (auto& sized_kernel : sized_kernels) {
+    kernels.push_back(std::move(sized_kernel.second));
+  }
+}
+
+// Launches the kernels from the first one starting on fragment_idx or past it, and the
+// kernels of the fragments before it last.
+void rotate_kernels_to_fragment(std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+                                const size_t fragment_idx) {
+  std::stable_partition(
+      kernels.begin(), kernels.end(), [fragment_idx](const auto& kernel) {
+        const auto& frag_list = kernel->getFragmentList();
+        return !frag_list.empty() && !frag_list.front().fragment_ids.empty() &&
+               frag_list.front().fragment_ids.front() >= fragment_idx;
+      });
+}
+
+// Holds buffer pool reservations for the kernels of a query step until the step results
+// have been collected, so concurrent query steps do not oversubscribe the buffer pools.
+class WorkUnitMemoryReservation {
+ public:
+  WorkUnitMemoryReservation(Data_Namespace::DataMgr& data_mgr) : data_mgr_(data_mgr) {}
+
+  // Reservations are taken in memory level and device order, so that two steps waiting
+  // on each other's devices cannot deadlock.
+  void reserve(const Executor::WorkUnitMemoryEstimate& estimate) {
+    const std::chrono::milliseconds timeout(g_admission_control_timeout_ms);
+    for (const auto& [memory_level_and_device, num_bytes] : estimate) {
+      if (!num_bytes) {
+        continue;
+      }
+      const auto [memory_level, device_id] = memory_level_and_device;
+      if (data_mgr_.reserveQueryMemory(memory_level, device_id, num_bytes, timeout)) {
+        reservations_.emplace_back(memory_level_and_device, num_bytes);
+      } else {
+        LOG(WARNING) << "Admitting query step without a reservation of " << num_bytes
+                     << " bytes for device " << device_id << " at memory level "
+                     << memory_level << " after waiting " << timeout.count() << " ms";
+      }
+    }
+  }
+
+  ~WorkUnitMemoryReservation() {
+    for (const auto& [memory_level_and_device, num_bytes] : reservations_) {
+      data_mgr_.releaseQueryMemory(
+          memory_level_and_device.first, memory_level_and_device.second, num_bytes);
+    }
+  }
+
+ private:
+  Data_Namespace::DataMgr& data_mgr_;
+  std::vector<std::pair<std::pair<Data_Namespace::MemoryLevel, int>, size_t>>
+      reservations_;
+};
+
+ExecutionOptions with_scan_options(const ExecutionOptions& eo,
+                                   const std::vector<size_t>& outer_fragment_indices,
+                                   const bool allow_multifrag) {
+  return {eo.output_columnar_hint,
+          eo.allow_multifrag && allow_multifrag,
+          eo.just_explain,
+          eo.allow_loop_joins,
+          eo.with_watchdog,
+          eo.jit_debug,
+          eo.just_validate,
+          eo.with_dynamic_watchdog,
+          eo.dynamic_watchdog_time_limit,
+          eo.find_push_down_candidates,
+          eo.just_calcite_explain,
+          eo.gpu_input_mem_limit_percent,
+          eo.allow_runtime_query_interrupt,
+          eo.pending_query_interrupt_freq,
+          eo.executor_type,
+          outer_fragment_indices.empty() ? eo.outer_fragment_indices
+                                         : outer_fragment_indices,
+          eo.force_loop_joins,
+          eo.max_kernel_parallelism,
+          eo.approximate_error};
+}
+
 }  // namespace
 
 ResultSetPtr Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
@@ -1326,6 +1548,8 @@ ResultSetPtr Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
     plan_state_.reset(nullptr);
     if (cgen_state_) {
       cgen_state_->in_values_bitmaps_.clear();
+      cgen_state_->in_values_hash_sets_.clear();
+      cgen_state_->gpu_dict_payloads_.clear();
     }
   };
 
@@ -1345,6 +1569,15 @@ ResultSetPtr Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
     if (result) {
       result->setKernelQueueTime(kernel_queue_time_ms_);
       result->addCompilationQueueTime(compilation_queue_time_ms_);
+      result->addCompilationTime(compilation_time_ms_);
+      result->addKernelPerfCounters(kernel_perf_counters_);
+      result->addKernelGpuTimings(kernel_gpu_timings_);
+      result->addReductionTime(reduction_time_ms_);
+      result->setMemoryUsage({cpu_bytes_scanned_,
+                              gpu_bytes_scanned_,
+                              cpu_working_set_bytes_,
+                              gpu_working_set_bytes_,
+                              row_set_mem_owner_->getAllocatedBytes()});
     }
     return result;
   } catch (const CompilationRetryNewScanLimit& e) {
@@ -1364,6 +1597,15 @@ ResultSetPtr Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
     if (result) {
       result->setKernelQueueTime(kernel_queue_time_ms_);
       result->addCompilationQueueTime(compilation_queue_time_ms_);
+      result->addCompilationTime(compilation_time_ms_);
+      result->addKernelPerfCounters(kernel_perf_counters_);
+      result->addKernelGpuTimings(kernel_gpu_timings_);
+      result->addReductionTime(reduction_time_ms_);
+      result->setMemoryUsage({cpu_bytes_scanned_,
+                              gpu_bytes_scanned_,
+                              cpu_working_set_bytes_,
+                              gpu_working_set_bytes_,
+                              row_set_mem_owner_->getAllocatedBytes()});
     }
     return result;
   }
@@ -1394,6 +1636,10 @@ ResultSetPtr Executor::executeWorkUnitImpl(
     max_groups_buffer_entry_guess = compute_buffer_entry_guess(query_infos);
   }
 
+  // The rows of an external sort are materialized in the runs.
+  const bool external_sort_candidate =
+      !render_info && ExternalSort::isCandidate(ra_exe_unit, query_infos, is_agg, eo);
+
   int8_t crt_min_byte_width{get_min_byte_width()};
   do {
     SharedKernelContext shared_context(query_infos);
@@ -1407,6 +1653,7 @@ ResultSetPtr Executor::executeWorkUnitImpl(
         std::lock_guard<std::mutex> compilation_lock(compilation_mutex_);
         compilation_queue_time_ms_ += timer_stop(clock_begin);
 
+        auto compilation_clock_begin = timer_start();
         query_mem_desc_owned =
             query_comp_desc_owned->compile(max_groups_buffer_entry_guess,
                                            crt_min_byte_width,
@@ -1419,7 +1666,8 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                                             co.hoist_literals,
                                             co.opt_level,
                                             co.with_dynamic_watchdog,
-                                            co.allow_lazy_fetch,
+                                            co.allow_lazy_fetch &&
+                                                !external_sort_candidate,
                                             co.filter_on_deleted_column,
                                             co.explain_type,
                                             co.register_intel_jit_listener},
@@ -1427,13 +1675,14 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                                            render_info,
                                            this);
         CHECK(query_mem_desc_owned);
+        compilation_time_ms_ += timer_stop(compilation_clock_begin);
         crt_min_byte_width = query_comp_desc_owned->getMinByteWidth();
       } catch (CompilationRetryNoCompaction&) {
         crt_min_byte_width = MAX_BYTE_WIDTH_SUPPORTED;
         continue;
       }
     } else {
-      plan_state_.reset(new PlanState(false, query_infos, deleted_cols_map, this));
+      plan_state_.reset(new PlanState(false, false, query_infos, deleted_cols_map, this));
       plan_state_->allocateLocalColumnIds(ra_exe_unit.input_col_descs);
       CHECK(!query_mem_desc_owned);
       query_mem_desc_owned.reset(
@@ -1447,7 +1696,52 @@ ResultSetPtr Executor::executeWorkUnitImpl(
       plan_state_->target_exprs_.push_back(target_expr);
     }
 
-    if (!eo.just_validate) {
+    // Only the outer fragments which aren't in the cached aggregate, if any, are scanned.
+    const auto incremental_aggregate =
+        is_agg && !render_info
+            ? IncrementalAggregateCache::instance().getPlan(
+                  ra_exe_unit,
+                  query_infos,
+                  *query_mem_desc_owned,
+                  query_comp_desc_owned->getDeviceType(),
+                  eo,
+                  cat)
+            : IncrementalAggregateCache::Plan{};
+    auto top_n_pruner = TopNFragmentPruner::create(
+        ra_exe_unit, query_infos, *query_mem_desc_owned, deleted_cols_map, eo);
+    const auto fragments_to_scan = top_n_pruner
+                                       ? top_n_pruner->getFragmentsToScan()
+                                       : incremental_aggregate.getFragmentsToScan();
+    shared_context.setTopNFragmentPruner(std::move(top_n_pruner));
+    auto approximate_aggregate =
+        is_agg && !render_info && !incremental_aggregate.isEnabled()
+            ? ApproximateAggregate::create(
+                  ra_exe_unit, query_infos, *query_mem_desc_owned, eo)
+            : nullptr;
+    // The sample is drawn from the outer fragments of the kernels one by one.
+    const bool use_approximate_aggregate{approximate_aggregate};
+    shared_context.setApproximateAggregate(std::move(approximate_aggregate));
+    auto external_sort = external_sort_candidate
+                             ? ExternalSort::create(ra_exe_unit,
+                                                    query_infos,
+                                                    *query_mem_desc_owned,
+                                                    is_agg,
+                                                    plan_state_->allow_lazy_fetch_,
+                                                    cat.getDataMgr(),
+                                                    eo)
+                             : nullptr;
+    // Each kernel is one run, a multi-fragment kernel would hold its device's rows.
+    const bool use_external_sort{external_sort};
+    shared_context.setExternalSort(std::move(external_sort));
+    const auto eo_scan = with_scan_options(
+        eo,
+        fragments_to_scan,
+        /*allow_multifrag=*/!use_external_sort && !use_approximate_aggregate);
+    const bool all_fragments_cached =
+        incremental_aggregate.cached && fragments_to_scan.empty();
+
+    WorkUnitMemoryReservation memory_reservation(cat.getDataMgr());
+    if (!eo.just_validate && !all_fragments_cached) {
       int available_cpus = cpu_threads();
       auto available_gpus = get_available_gpus(cat);
 
@@ -1458,7 +1752,7 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                                      ra_exe_unit,
                                      column_fetcher,
                                      query_infos,
-                                     eo,
+                                     eo_scan,
                                      is_agg,
                                      allow_single_frag_table_opt,
                                      context_count,
@@ -1467,19 +1761,80 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                                      render_info,
                                      available_gpus,
                                      available_cpus);
-        if (g_use_tbb_pool) {
+        const auto memory_estimate =
+            estimateWorkUnitMemory(kernels, query_infos, *query_mem_desc_owned);
+        if (g_enable_admission_control) {
+          memory_reservation.reserve(memory_estimate);
+        }
+        for (const auto& [memory_level_and_device, num_bytes] : memory_estimate) {
+          if (memory_level_and_device.first == Data_Namespace::GPU_LEVEL) {
+            gpu_working_set_bytes_ += num_bytes;
+          } else {
+            cpu_working_set_bytes_ += num_bytes;
+          }
+        }
+        // The cached aggregate and the top n threshold need the result of each kernel.
+        if (is_agg && query_comp_desc_owned->getDeviceType() == ExecutorDeviceType::GPU &&
+            !incremental_aggregate.isEnabled() &&
+            !shared_context.getTopNFragmentPruner() && !use_approximate_aggregate) {
+          shared_context.setMultiGpuReduction(MultiGpuReduction::create(
+              ra_exe_unit, *query_mem_desc_owned, cat, kernels.size()));
+        }
+        // The CPU kernels reduce their results into the ones already done as they finish.
+        if (g_enable_streaming_reduction && is_agg &&
+            query_comp_desc_owned->getDeviceType() == ExecutorDeviceType::CPU &&
+            !render_info && !incremental_aggregate.isEnabled() &&
+            !shared_context.getTopNFragmentPruner() && !use_approximate_aggregate &&
+            !use_external_sort && !ra_exe_unit.estimator &&
+            !use_speculative_top_n(ra_exe_unit, *query_mem_desc_owned) &&
+            (query_mem_desc_owned->getQueryDescriptionType() ==
+                 QueryDescriptionType::NonGroupedAggregate ||
+             query_mem_desc_owned->getQueryDescriptionType() ==
+                 QueryDescriptionType::GroupByPerfectHash)) {
+          shared_context.enableStreamingReduction();
+        }
+        // The kernels with the best sort values set the top n threshold early.
+        const auto top_n_pruner = shared_context.getTopNFragmentPruner();
+        if (top_n_pruner) {
+          top_n_pruner->orderKernels(kernels);
+        }
+        // The kernels launched first scan a random sample of the fragments.
+        const auto approximate_aggregate = shared_context.getApproximateAggregate();
+        if (approximate_aggregate) {
+          approximate_aggregate->shuffleKernels(kernels);
+        }
+        // Steps scanning the table at the same time start where the others are.
+        const int outer_table_id = ra_exe_unit.input_descs.front().getTableId();
+        if (g_enable_shared_scans && !top_n_pruner && !approximate_aggregate &&
+            !g_enable_work_stealing_kernel_dispatch && !ra_exe_unit.union_all &&
+            outer_table_id > 0) {
+          auto shared_scan =
+              std::make_unique<SharedScan>(cat.getCurrentDB().dbId, outer_table_id);
+          if (const auto start_fragment = shared_scan->getStartFragment()) {
+            rotate_kernels_to_fragment(kernels, *start_fragment);
+          }
+          shared_context.setSharedScan(std::move(shared_scan));
+        }
+        if (g_enable_work_stealing_kernel_dispatch) {
+          VLOG(1) << "Using work stealing thread pool for kernel dispatch.";
+          if (!top_n_pruner && !approximate_aggregate) {
+            sort_kernels_by_input_size(kernels, query_infos);
+          }
+          launchKernels<threadpool::WorkStealingThreadPool<void>>(
+              shared_context, std::move(kernels), eo.max_kernel_parallelism);
+        } else if (g_use_tbb_pool) {
 #ifdef HAVE_TBB
           VLOG(1) << "Using TBB thread pool for kernel dispatch.";
-          launchKernels<threadpool::TbbThreadPool<void>>(shared_context,
-                                                         std::move(kernels));
+          launchKernels<threadpool::TbbThreadPool<void>>(
+              shared_context, std::move(kernels), eo.max_kernel_parallelism);
 #else
           throw std::runtime_error(
               "This build is not TBB enabled. Restart the server with "
               "\"enable-modern-thread-pool\" disabled.");
 #endif
         } else {
-          launchKernels<threadpool::FuturesThreadPool<void>>(shared_context,
-                                                             std::move(kernels));
+          launchKernels<threadpool::FuturesThreadPool<void>>(
+              shared_context, std::move(kernels), eo.max_kernel_parallelism);
         }
       } catch (QueryExecutionError& e) {
         if (eo.with_dynamic_watchdog && interrupted_.load() &&
@@ -1500,12 +1855,29 @@ ResultSetPtr Executor::executeWorkUnitImpl(
       }
     }
     if (is_agg) {
+      const auto reduction_clock_begin = timer_start();
+      ScopeGuard add_reduction_time = [this, &reduction_clock_begin] {
+        reduction_time_ms_ += timer_stop(reduction_clock_begin);
+      };
       try {
-        return collectAllDeviceResults(shared_context,
-                                       ra_exe_unit,
-                                       *query_mem_desc_owned,
-                                       query_comp_desc_owned->getDeviceType(),
-                                       row_set_mem_owner);
+        if (incremental_aggregate.isEnabled()) {
+          return collectIncrementalAggregate(shared_context,
+                                             ra_exe_unit,
+                                             *query_mem_desc_owned,
+                                             query_comp_desc_owned->getDeviceType(),
+                                             incremental_aggregate,
+                                             row_set_mem_owner);
+        }
+        auto results = collectAllDeviceResults(shared_context,
+                                               ra_exe_unit,
+                                               *query_mem_desc_owned,
+                                               query_comp_desc_owned->getDeviceType(),
+                                               row_set_mem_owner);
+        if (const auto approximate_aggregate =
+                shared_context.getApproximateAggregate()) {
+          approximate_aggregate->finalize(*results);
+        }
+        return results;
       } catch (ReductionRanOutOfSlots&) {
         throw QueryExecutionError(ERR_OUT_OF_SLOTS);
       } catch (OverflowOrUnderflow&) {
@@ -1513,6 +1885,13 @@ ResultSetPtr Executor::executeWorkUnitImpl(
         continue;
       }
     }
+    if (use_external_sort) {
+      auto sorted_rows =
+          shared_context.getExternalSort()->merge(row_set_mem_owner, this);
+      if (sorted_rows) {
+        return sorted_rows;
+      }
+    }
     return resultsUnion(shared_context, ra_exe_unit);
 
   } while (static_cast<size_t>(crt_min_byte_width) <= sizeof(int64_t));
@@ -1566,32 +1945,65 @@ void Executor::executeWorkUnitPerFragment(const RelAlgExecutionUnit& ra_exe_unit
     std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
     kernel_queue_time_ms_ += timer_stop(clock_begin);
 
-    for (size_t fragment_index = 0; fragment_index < outer_fragments.size();
-         ++fragment_index) {
-      // We may want to consider in the future allowing this to execute on devices other
-      // than CPU
-      FragmentsList fragments_list{{table_id, {fragment_index}}};
-      ExecutionKernel kernel(ra_exe_unit,
-                             co.device_type,
-                             /*device_id=*/0,
-                             eo,
-                             column_fetcher,
-                             *query_comp_desc_owned,
-                             *query_mem_desc_owned,
-                             fragments_list,
-                             ExecutorDispatchMode::KernelPerFragment,
-                             /*render_info=*/nullptr,
-                             /*rowid_lookup_key=*/-1);
-      kernel.run(this, kernel_context);
+    // the fragments are scanned by cpu_threads() workers, each running the kernel of the
+    // next fragment not started yet
+    threadpool::FuturesThreadPool<void> thread_pool;
+    std::atomic<size_t> next_fragment_index{0};
+    const size_t worker_count =
+        std::min(outer_fragments.size(), static_cast<size_t>(cpu_threads()));
+    for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+      thread_pool.spawn([this,
+                         &ra_exe_unit,
+                         &co,
+                         &eo,
+                         &column_fetcher,
+                         &query_comp_desc_owned,
+                         &query_mem_desc_owned,
+                         &kernel_context,
+                         &next_fragment_index,
+                         &outer_fragments,
+                         table_id,
+                         parent_thread_id = logger::thread_id()] {
+        DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+        for (size_t fragment_index = next_fragment_index++;
+             fragment_index < outer_fragments.size();
+             fragment_index = next_fragment_index++) {
+          // We may want to consider in the future allowing this to execute on devices
+          // other than CPU
+          FragmentsList fragments_list{{table_id, {fragment_index}}};
+          ExecutionKernel kernel(ra_exe_unit,
+                                 co.device_type,
+                                 /*device_id=*/0,
+                                 eo,
+                                 column_fetcher,
+                                 *query_comp_desc_owned,
+                                 *query_mem_desc_owned,
+                                 fragments_list,
+                                 ExecutorDispatchMode::KernelPerFragment,
+                                 /*render_info=*/nullptr,
+                                 /*rowid_lookup_key=*/-1);
+          kernel.run(this, kernel_context);
+        }
+      });
     }
+    thread_pool.join();
   }
 
+  // the kernels add their results in the order they finish
   const auto& all_fragment_results = kernel_context.getFragmentResults();
+  std::vector<ResultSetPtr> results_per_fragment(outer_fragments.size());
+  for (const auto& [result, fragment_ids] : all_fragment_results) {
+    CHECK_EQ(fragment_ids.size(), size_t(1));
+    CHECK_LT(fragment_ids.front(), outer_fragments.size());
+    results_per_fragment[fragment_ids.front()] = result;
+  }
 
   for (size_t fragment_index = 0; fragment_index < outer_fragments.size();
        ++fragment_index) {
-    const auto fragment_results = all_fragment_results[fragment_index];
-    cb(fragment_results.first, outer_fragments[fragment_index]);
+    // a fragment the kernel skipped has no result
+    if (results_per_fragment[fragment_index]) {
+      cb(results_per_fragment[fragment_index], outer_fragments[fragment_index]);
+    }
   }
 }
 
@@ -1686,9 +2098,20 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_set));
         continue;
       }
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll) {
+        entry.push_back(reinterpret_cast<int64_t>(
+            row_set_mem_owner->addSparseHll(count_distinct_desc.bitmap_sz_bits)));
+        continue;
+      }
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::RoaringBitmap) {
+        entry.push_back(
+            reinterpret_cast<int64_t>(row_set_mem_owner->addRoaringBitmap()));
+        continue;
+      }
     }
     const bool float_argument_input = takes_float_argument(agg_info);
-    if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+    if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        agg_info.agg_kind == kAPPROX_QUANTILE) {
       entry.push_back(0);
     } else if (agg_info.agg_kind == kAVG) {
       entry.push_back(inline_null_val(agg_info.sql_type, float_argument_input));
@@ -1754,12 +2177,22 @@ ResultSetPtr Executor::collectAllDeviceResults(
     const ExecutorDeviceType device_type,
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner) {
   auto timer = DEBUG_TIMER(__func__);
+  shared_context.checkStreamingReduction();
   auto& result_per_device = shared_context.getFragmentResults();
   if (result_per_device.empty() && query_mem_desc.getQueryDescriptionType() ==
                                        QueryDescriptionType::NonGroupedAggregate) {
     return build_row_for_empty_input(
         ra_exe_unit.target_exprs, query_mem_desc, device_type);
   }
+  const auto multi_gpu_reduction = shared_context.getMultiGpuReduction();
+  if (multi_gpu_reduction && multi_gpu_reduction->hasResult()) {
+    // the results of the kernels are empty, the reduced buffer goes to the first one
+    CHECK(!result_per_device.empty());
+    auto& results = result_per_device.front().first;
+    CHECK(results);
+    multi_gpu_reduction->copyResultTo(*results);
+    return results;
+  }
   if (use_speculative_top_n(ra_exe_unit, query_mem_desc)) {
     try {
       return reduceSpeculativeTopN(
@@ -1776,10 +2209,62 @@ ResultSetPtr Executor::collectAllDeviceResults(
   if (shard_count && !result_per_device.empty()) {
     return collectAllDeviceShardedTopResults(shared_context, ra_exe_unit);
   }
+  top_k_groups::prune(
+      ra_exe_unit, shared_context.getQueryInfos(), this, result_per_device);
   return reduceMultiDeviceResults(
       ra_exe_unit, result_per_device, row_set_mem_owner, query_mem_desc);
 }
 
+ResultSetPtr Executor::collectIncrementalAggregate(
+    SharedKernelContext& shared_context,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const ExecutorDeviceType device_type,
+    const IncrementalAggregateCache::Plan& plan,
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner) {
+  auto timer = DEBUG_TIMER(__func__);
+  CHECK(plan.isEnabled());
+  const auto full_fragment_count = plan.full_fragments.size();
+  std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> full_results;
+  std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> other_results;
+  if (plan.cached) {
+    full_results.emplace_back(
+        IncrementalAggregateCache::toResultSet(*plan.cached, row_set_mem_owner, this),
+        std::vector<size_t>{});
+  }
+  // A multi-fragment kernel can cover both full fragments and the last one, the
+  // aggregate of the full fragments alone isn't known then.
+  bool full_fragments_separate{true};
+  for (const auto& result : shared_context.getFragmentResults()) {
+    const auto& frag_ids = result.second;
+    const auto is_full = [full_fragment_count](const size_t frag_id) {
+      return frag_id < full_fragment_count;
+    };
+    if (std::all_of(frag_ids.begin(), frag_ids.end(), is_full)) {
+      full_results.push_back(result);
+    } else {
+      full_fragments_separate = full_fragments_separate &&
+                                std::none_of(frag_ids.begin(), frag_ids.end(), is_full);
+      other_results.push_back(result);
+    }
+  }
+  if (full_fragments_separate && !full_results.empty() &&
+      full_fragment_count > plan.getCachedFragmentCount()) {
+    auto full_result = reduceMultiDeviceResults(
+        ra_exe_unit, full_results, row_set_mem_owner, query_mem_desc);
+    IncrementalAggregateCache::instance().put(
+        plan, query_mem_desc, device_type, *full_result);
+    full_results = {{full_result, {}}};
+  }
+  full_results.insert(full_results.end(), other_results.begin(), other_results.end());
+  if (full_results.empty()) {
+    return collectAllDeviceResults(
+        shared_context, ra_exe_unit, query_mem_desc, device_type, row_set_mem_owner);
+  }
+  return reduceMultiDeviceResults(
+      ra_exe_unit, full_results, row_set_mem_owner, query_mem_desc);
+}
+
 namespace {
 /**
  * This functions uses the permutation indices in "top_permutation", and permutes
@@ -1968,16 +2453,26 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
       has_lazy_fetched_columns(getColLazyFetchInfo(ra_exe_unit.target_exprs));
   const bool use_multifrag_kernel = (device_type == ExecutorDeviceType::GPU) &&
                                     eo.allow_multifrag && (!uses_lazy_fetch || is_agg);
+  // aggregates on CPU scan several small fragments per kernel into one output buffer
+  const auto query_type = query_mem_desc.getQueryDescriptionType();
+  const bool use_cpu_multifrag_kernels =
+      device_type == ExecutorDeviceType::CPU && g_enable_cpu_multifrag_kernels &&
+      eo.allow_multifrag && !ra_exe_unit.union_all && !uses_lazy_fetch &&
+      (query_type == QueryDescriptionType::NonGroupedAggregate ||
+       query_type == QueryDescriptionType::GroupByPerfectHash ||
+       query_type == QueryDescriptionType::GroupByBaselineHash);
   const auto device_count = deviceCount(device_type);
   CHECK_GT(device_count, 0);
 
-  fragment_descriptor.buildFragmentKernelMap(ra_exe_unit,
-                                             shared_context.getFragOffsets(),
-                                             device_count,
-                                             device_type,
-                                             use_multifrag_kernel,
-                                             g_inner_join_fragment_skipping,
-                                             this);
+  fragment_descriptor.buildFragmentKernelMap(
+      ra_exe_unit,
+      shared_context.getFragOffsets(),
+      device_count,
+      device_type,
+      use_multifrag_kernel,
+      g_inner_join_fragment_skipping,
+      use_cpu_multifrag_kernels ? g_cpu_multifrag_kernel_min_rows : 0,
+      this);
   if (eo.with_watchdog && fragment_descriptor.shouldCheckWorkUnitWatchdog()) {
     checkWorkUnitWatchdog(ra_exe_unit, table_infos, *catalog_, device_type, device_count);
   }
@@ -2048,6 +2543,10 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
       }
       CHECK_GE(device_id, 0);
 
+      // batched CPU kernels scan several outer fragments
+      const auto dispatch_mode = frag_list.front().fragment_ids.size() > 1
+                                     ? ExecutorDispatchMode::MultifragmentKernel
+                                     : ExecutorDispatchMode::KernelPerFragment;
       execution_kernels.emplace_back(
           std::make_unique<ExecutionKernel>(ra_exe_unit,
                                             device_type,
@@ -2057,7 +2556,7 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
                                             query_comp_desc,
                                             query_mem_desc,
                                             frag_list,
-                                            ExecutorDispatchMode::KernelPerFragment,
+                                            dispatch_mode,
                                             render_info,
                                             rowid_lookup_key));
       ++frag_list_idx;
@@ -2070,21 +2569,219 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
   return execution_kernels;
 }
 
+namespace {
+
+// Checked before starting each kernel, so that an interrupted query doesn't fetch and
+// scan the fragments of its kernels still queued.
+void throw_if_interrupted() {
+  if (g_enable_runtime_query_interrupt &&
+      check_interrupt_init(static_cast<unsigned>(INT_CHECK))) {
+    throw QueryExecutionError(Executor::ERR_INTERRUPTED);
+  }
+}
+
+// CPU kernels run on the NUMA node which owns the chunks of their first outer fragment.
+int get_kernel_numa_node(const ExecutionKernel& kernel,
+                         const std::vector<InputTableInfo>& query_infos) {
+  if (kernel.getDeviceType() != ExecutorDeviceType::CPU || numa::get_num_nodes() <= 1) {
+    return -1;
+  }
+  const auto& frag_list = kernel.getFragmentList();
+  if (frag_list.empty() || frag_list.front().fragment_ids.empty() ||
+      query_infos.empty()) {
+    return -1;
+  }
+  const auto& outer_fragments = frag_list.front();
+  const auto query_info_it = std::find_if(
+      query_infos.begin(), query_infos.end(), [&outer_fragments](const auto& query_info) {
+        return query_info.table_id == outer_fragments.table_id;
+      });
+  if (query_info_it == query_infos.end()) {
+    return -1;
+  }
+  const auto& fragments = query_info_it->info.fragments;
+  const auto frag_idx = outer_fragments.fragment_ids.front();
+  CHECK_LT(frag_idx, fragments.size());
+  return numa::get_node_for_fragment(fragments[frag_idx].fragmentId);
+}
+
+// The chunks each kernel fetches from its outer table fragments, in kernel order.
+std::vector<std::vector<ChunkPrefetcher::ChunkToFetch>> get_chunks_to_prefetch(
+    const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+    const std::vector<InputTableInfo>& query_infos,
+    const PlanState& plan_state,
+    const Catalog_Namespace::Catalog& cat) {
+  std::vector<std::vector<ChunkPrefetcher::ChunkToFetch>> kernel_chunks;
+  for (const auto& kernel : kernels) {
+    CHECK(kernel);
+    kernel_chunks.emplace_back();
+    const auto& frag_list = kernel->getFragmentList();
+    if (frag_list.empty() || frag_list.front().table_id <= 0) {
+      continue;
+    }
+    const auto& outer_fragments = frag_list.front();
+    const auto query_info_it = std::find_if(
+        query_infos.begin(), query_infos.end(), [&outer_fragments](const auto& info) {
+          return info.table_id == outer_fragments.table_id;
+        });
+    if (query_info_it == query_infos.end()) {
+      continue;
+    }
+    const auto& fragments = query_info_it->info.fragments;
+    for (const auto frag_id : outer_fragments.fragment_ids) {
+      CHECK_LT(frag_id, fragments.size());
+      const auto& fragment = fragments[frag_id];
+      if (fragment.isEmptyPhysicalFragment()) {
+        continue;
+      }
+      for (const auto& col_id_it : plan_state.global_to_local_col_ids_) {
+        const auto& col_desc = col_id_it.first;
+        const auto table_id = col_desc.getScanDesc().getTableId();
+        const auto col_id = col_desc.getColId();
+        if (table_id != outer_fragments.table_id ||
+            plan_state.columns_to_not_fetch_.count({table_id, col_id})) {
+          continue;
+        }
+        const auto cd = get_column_descriptor_maybe(col_id, table_id, cat);
+        if (!cd || cd->isVirtualCol || cd->columnType.is_geometry()) {
+          continue;
+        }
+        const auto chunk_meta_it = fragment.getChunkMetadataMap().find(col_id);
+        if (chunk_meta_it == fragment.getChunkMetadataMap().end()) {
+          continue;
+        }
+        ChunkKey chunk_key{cat.getCurrentDB().dbId,
+                           fragment.physicalTableId,
+                           col_id,
+                           fragment.fragmentId};
+        kernel_chunks.back().push_back({cd,
+                                        chunk_key,
+                                        chunk_meta_it->second->numBytes,
+                                        chunk_meta_it->second->numElements});
+      }
+    }
+  }
+  return kernel_chunks;
+}
+
+}  // namespace
+
+Executor::WorkUnitMemoryEstimate Executor::estimateWorkUnitMemory(
+    const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+    const std::vector<InputTableInfo>& table_infos,
+    const QueryMemoryDescriptor& query_mem_desc) const {
+  std::unordered_map<int, const Fragmenter_Namespace::TableInfo*> table_id_to_info;
+  for (const auto& table_info : table_infos) {
+    table_id_to_info.emplace(table_info.table_id, &table_info.info);
+  }
+  auto memory_level_for_device = [](const ExecutorDeviceType device_type) {
+    return device_type == ExecutorDeviceType::GPU ? Data_Namespace::GPU_LEVEL
+                                                  : Data_Namespace::CPU_LEVEL;
+  };
+
+  WorkUnitMemoryEstimate estimate;
+  for (const auto& kernel : kernels) {
+    CHECK(kernel);
+    const auto device_type = kernel->getDeviceType();
+    const auto device_id =
+        device_type == ExecutorDeviceType::GPU ? kernel->getDeviceId() : 0;
+    auto& num_bytes = estimate[{memory_level_for_device(device_type), device_id}];
+    for (const auto& fragments_per_table : kernel->getFragmentList()) {
+      const auto table_info_it = table_id_to_info.find(fragments_per_table.table_id);
+      if (table_info_it == table_id_to_info.end()) {
+        continue;
+      }
+      const auto& fragments = table_info_it->second->fragments;
+      const auto bytes_per_row =
+          getNumBytesForFetchedRow({fragments_per_table.table_id});
+      for (const auto frag_id : fragments_per_table.fragment_ids) {
+        CHECK_LT(frag_id, fragments.size());
+        num_bytes += fragments[frag_id].getNumTuples() * bytes_per_row;
+      }
+    }
+    num_bytes += query_mem_desc.getBufferSizeBytes(device_type);
+  }
+
+  CHECK(plan_state_);
+  for (auto& [memory_level_and_device, num_bytes] : estimate) {
+    const auto device_type = memory_level_and_device.first == Data_Namespace::GPU_LEVEL
+                                 ? ExecutorDeviceType::GPU
+                                 : ExecutorDeviceType::CPU;
+    for (const auto& hash_table : plan_state_->join_info_.join_hash_tables_) {
+      CHECK(hash_table);
+      num_bytes +=
+          hash_table->getJoinHashBufferSize(device_type, memory_level_and_device.second);
+    }
+  }
+  return estimate;
+}
+
 template <typename THREAD_POOL>
 void Executor::launchKernels(SharedKernelContext& shared_context,
-                             std::vector<std::unique_ptr<ExecutionKernel>>&& kernels) {
+                             std::vector<std::unique_ptr<ExecutionKernel>>&& kernels,
+                             const size_t max_parallel_kernels) {
   auto clock_begin = timer_start();
   std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
   kernel_queue_time_ms_ += timer_stop(clock_begin);
 
+  // outlives the thread pool, which waits for the kernels
+  std::unique_ptr<ChunkPrefetcher> chunk_prefetcher;
+  if (g_chunk_prefetch_window && kernels.size() > 1) {
+    CHECK(plan_state_);
+    chunk_prefetcher = std::make_unique<ChunkPrefetcher>(
+        &catalog_->getDataMgr(),
+        get_chunks_to_prefetch(
+            kernels, shared_context.getQueryInfos(), *plan_state_, *catalog_),
+        g_chunk_prefetch_window);
+  }
   THREAD_POOL thread_pool;
   VLOG(1) << "Launching " << kernels.size() << " kernels for query.";
-  for (auto& kernel : kernels) {
+  if (max_parallel_kernels && kernels.size() > max_parallel_kernels) {
+    VLOG(1) << "Running at most " << max_parallel_kernels << " kernels at a time.";
+    // each worker runs the next kernel not started yet until all of them are
+    std::atomic<size_t> next_kernel_idx{0};
+    for (size_t worker_idx = 0; worker_idx < max_parallel_kernels; ++worker_idx) {
+      thread_pool.spawn([this,
+                         &shared_context,
+                         &kernels,
+                         &next_kernel_idx,
+                         chunk_prefetcher = chunk_prefetcher.get(),
+                         parent_thread_id = logger::thread_id()] {
+        DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+        for (size_t kernel_idx = next_kernel_idx++; kernel_idx < kernels.size();
+             kernel_idx = next_kernel_idx++) {
+          auto& kernel = kernels[kernel_idx];
+          CHECK(kernel);
+          numa::ScopedThreadNodeBinding numa_binding(
+              get_kernel_numa_node(*kernel, shared_context.getQueryInfos()));
+          throw_if_interrupted();
+          if (chunk_prefetcher) {
+            chunk_prefetcher->kernelStarted(kernel_idx);
+          }
+          kernel->run(this, shared_context);
+        }
+      });
+    }
+    thread_pool.join();
+    return;
+  }
+  for (size_t kernel_idx = 0; kernel_idx < kernels.size(); ++kernel_idx) {
+    auto& kernel = kernels[kernel_idx];
+    const auto numa_node = get_kernel_numa_node(*kernel, shared_context.getQueryInfos());
     thread_pool.spawn(
-        [this, &shared_context, parent_thread_id = logger::thread_id()](
-            ExecutionKernel* kernel) {
+        [this,
+         &shared_context,
+         numa_node,
+         kernel_idx,
+         chunk_prefetcher = chunk_prefetcher.get(),
+         parent_thread_id = logger::thread_id()](ExecutionKernel* kernel) {
           CHECK(kernel);
           DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+          numa::ScopedThreadNodeBinding numa_binding(numa_node);
+          throw_if_interrupted();
+          if (chunk_prefetcher) {
+            chunk_prefetcher->kernelStarted(kernel_idx);
+          }
           kernel->run(this, shared_context);
         },
         kernel.get());
@@ -2203,6 +2900,21 @@ const ColumnDescriptor* try_get_column_descriptor(const InputColDescriptor* col_
   return get_column_descriptor_maybe(col_id, table_id, cat);
 }
 
+// Zeros standing for the delete column of the fragments without deleted rows. The
+// buffers are kept for the lifetime of the process, a larger one replaces the current
+// one for new fetches while the kernels still reading the smaller one run.
+const int8_t* get_live_rows_buffer(const size_t row_count) {
+  static std::mutex buffers_mutex;
+  static std::vector<std::unique_ptr<int8_t[]>> buffers;
+  static size_t buffer_size{0};
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  if (buffers.empty() || row_count > buffer_size) {
+    buffer_size = std::max(row_count, 2 * buffer_size);
+    buffers.emplace_back(new int8_t[buffer_size]());
+  }
+  return buffers.back().get();
+}
+
 }  // namespace
 
 std::map<size_t, std::vector<uint64_t>> get_table_id_to_frag_offsets(
@@ -2374,6 +3086,11 @@ FetchResult Executor::fetchChunks(
                                                         memory_level_for_column,
                                                         device_id,
                                                         device_allocator);
+        } else if (memory_level_for_column == Data_Namespace::CPU_LEVEL &&
+                   isDeletedColumnWithoutDeletes(
+                       table_id, col_id->getColId(), (*fragments)[frag_id])) {
+          frag_col_buffers[it->second] =
+              get_live_rows_buffer((*fragments)[frag_id].getNumTuples());
         } else {
           frag_col_buffers[it->second] =
               column_fetcher.getOneTableColumnFragment(table_id,
@@ -2395,6 +3112,26 @@ FetchResult Executor::fetchChunks(
   return {all_frag_col_buffers, all_num_rows, all_frag_offsets};
 }
 
+bool Executor::isDeletedColumnWithoutDeletes(
+    const int table_id,
+    const int col_id,
+    const Fragmenter_Namespace::FragmentInfo& fragment) const {
+  if (!g_enable_delete_metadata_skipping) {
+    return false;
+  }
+  const auto deleted_cd = plan_state_->getDeletedColForTable(table_id);
+  if (!deleted_cd || deleted_cd->columnId != col_id) {
+    return false;
+  }
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  const auto chunk_metadata_it = chunk_metadata_map.find(col_id);
+  if (chunk_metadata_it == chunk_metadata_map.end()) {
+    return false;
+  }
+  const auto& chunk_stats = chunk_metadata_it->second->chunkStats;
+  return chunk_stats.max.tinyintval == 0 && !chunk_stats.has_nulls;
+}
+
 // fetchChunks() is written under the assumption that multiple inputs implies a JOIN.
 // This is written under the assumption that multiple inputs implies a UNION ALL.
 FetchResult Executor::fetchUnionChunks(
@@ -2775,9 +3512,10 @@ int32_t Executor::executePlanWithoutGroupBy(
       for (int i = 0; i < num_iterations; i++) {
         int64_t val1;
         const bool float_argument_input = takes_float_argument(agg_info);
-        if (is_distinct_target(agg_info)) {
+        if (is_distinct_target(agg_info) || agg_info.agg_kind == kAPPROX_QUANTILE) {
           CHECK(agg_info.agg_kind == kCOUNT ||
-                agg_info.agg_kind == kAPPROX_COUNT_DISTINCT);
+                agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+                agg_info.agg_kind == kAPPROX_QUANTILE);
           val1 = out_vec[out_vec_idx][0];
           error_code = 0;
         } else {
@@ -3032,6 +3770,14 @@ void Executor::nukeOldState(const bool allow_lazy_fetch,
                             const RelAlgExecutionUnit* ra_exe_unit) {
   kernel_queue_time_ms_ = 0;
   compilation_queue_time_ms_ = 0;
+  compilation_time_ms_ = 0;
+  kernel_perf_counters_ = {};
+  kernel_gpu_timings_ = {};
+  reduction_time_ms_ = 0;
+  cpu_bytes_scanned_ = 0;
+  gpu_bytes_scanned_ = 0;
+  cpu_working_set_bytes_ = 0;
+  gpu_working_set_bytes_ = 0;
   const bool contains_left_deep_outer_join =
       ra_exe_unit && std::find_if(ra_exe_unit->join_quals.begin(),
                                   ra_exe_unit->join_quals.end(),
@@ -3039,10 +3785,16 @@ void Executor::nukeOldState(const bool allow_lazy_fetch,
                                     return join_condition.type == JoinType::LEFT;
                                   }) != ra_exe_unit->join_quals.end();
   cgen_state_.reset(new CgenState(query_infos.size(), contains_left_deep_outer_join));
-  plan_state_.reset(new PlanState(allow_lazy_fetch && !contains_left_deep_outer_join,
-                                  query_infos,
-                                  deleted_cols_map,
-                                  this));
+  // the rows without a match in an outer join get a null row id for the lazily fetched
+  // columns, which only the variable length ones resolve to a null value
+  const bool lazy_fetch_varlen_only =
+      contains_left_deep_outer_join && g_enable_lazy_fetch_through_outer_joins;
+  plan_state_.reset(new PlanState(
+      allow_lazy_fetch && (!contains_left_deep_outer_join || lazy_fetch_varlen_only),
+      lazy_fetch_varlen_only,
+      query_infos,
+      deleted_cols_map,
+      this));
 }
 
 void Executor::preloadFragOffsets(const std::vector<InputDescriptor>& input_descs,
@@ -3409,6 +4161,684 @@ std::pair<bool, int64_t> Executor::skipFragment(
   return {false, -1};
 }
 
+namespace {
+
+// The column, if `expr` is a column of the outer table `table_id`.
+const Analyzer::ColumnVar* get_outer_column(const Analyzer::Expr* expr,
+                                            const int table_id) {
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr);
+  if (!col_var || dynamic_cast<const Analyzer::Var*>(expr) ||
+      col_var->get_table_id() != table_id || col_var->get_rte_idx()) {
+    return nullptr;
+  }
+  return col_var;
+}
+
+// Slack around the constant geometry of a geo filter, its coordinates and those of the
+// column may have been compressed while the bounds weren't.
+constexpr double kGeoProbeTolerance{1e-6};
+
+// A geo filter can only be true for the rows whose bounds, in a column of the outer
+// table, intersect a box.
+struct GeoFilterProbe {
+  int bounds_column_id;
+  GeoGridChunkIndex::Box box;
+};
+
+/**
+ * The probe of ST_Contains(col, constant), ST_Intersects(col, constant) or
+ * ST_DWithin(col, constant point, distance) on a polygon or multipolygon column of the
+ * outer table, once translated to an ST_Contains_Polygon_Point or similar call, or to
+ * ST_Distance_Polygon_Point(...) <= distance.
+ */
+std::optional<GeoFilterProbe> get_geo_filter_probe(
+    const Analyzer::Expr* qual,
+    const int table_id,
+    const Catalog_Namespace::Catalog& cat) {
+  auto func_oper = dynamic_cast<const Analyzer::FunctionOper*>(qual);
+  // the distance within which the constant can be from the bounds
+  double distance{0.};
+  std::vector<std::string> prefixes{"ST_Contains_Polygon_",
+                                    "ST_Contains_MultiPolygon_",
+                                    "ST_Intersects_Polygon_",
+                                    "ST_Intersects_MultiPolygon_"};
+  if (const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual)) {
+    const auto distance_constant =
+        dynamic_cast<const Analyzer::Constant*>(bin_oper->get_right_operand());
+    if ((bin_oper->get_optype() != kLE && bin_oper->get_optype() != kLT) ||
+        bin_oper->get_qualifier() != kONE || !distance_constant ||
+        distance_constant->get_is_null() ||
+        distance_constant->get_type_info().get_type() != kDOUBLE) {
+      return std::nullopt;
+    }
+    func_oper = dynamic_cast<const Analyzer::FunctionOper*>(bin_oper->get_left_operand());
+    distance = distance_constant->get_constval().doubleval;
+    prefixes = {"ST_Distance_Polygon_Point", "ST_Distance_MultiPolygon_Point"};
+  }
+  if (!func_oper || !(distance >= 0.)) {
+    return std::nullopt;
+  }
+  const auto& name = func_oper->getName();
+  if (std::none_of(prefixes.begin(), prefixes.end(), [&name](const auto& prefix) {
+        return name.compare(0, prefix.size(), prefix) == 0;
+      })) {
+    return std::nullopt;
+  }
+  // the geo column, its bounds unless a distance is computed, the constant geometry, then
+  // the compression and SRID of both and the output SRID
+  const auto arity = func_oper->getArity();
+  const size_t constant_arg_idx = func_oper == qual ? 2 : 1;
+  if (arity < constant_arg_idx + 6) {
+    return std::nullopt;
+  }
+  const auto geo_col_var = get_outer_column(func_oper->getArg(0), table_id);
+  if (!geo_col_var || !geo_col_var->get_type_info().has_bounds()) {
+    return std::nullopt;
+  }
+  // the physical columns of a geo column follow it, the bounds after the coordinates
+  const auto bounds_column_id = geo_col_var->get_column_id() +
+                                geo_col_var->get_type_info().get_physical_coord_cols() +
+                                1;
+  if (constant_arg_idx == 2) {
+    const auto bounds_col_var = get_outer_column(func_oper->getArg(1), table_id);
+    if (!bounds_col_var || bounds_col_var->get_column_id() != bounds_column_id) {
+      return std::nullopt;
+    }
+  }
+  const auto bounds_cd = cat.getMetadataForColumn(table_id, bounds_column_id);
+  if (!bounds_cd || !bounds_cd->columnType.is_fixlen_array() ||
+      bounds_cd->columnType.get_subtype() != kDOUBLE) {
+    return std::nullopt;
+  }
+  auto get_int_arg = [func_oper](const size_t idx) -> std::optional<int32_t> {
+    const auto constant = dynamic_cast<const Analyzer::Constant*>(func_oper->getArg(idx));
+    if (!constant || constant->get_type_info().get_type() != kINT) {
+      return std::nullopt;
+    }
+    return constant->get_constval().intval;
+  };
+  const auto compression1 = get_int_arg(arity - 3);
+  const auto srid0 = get_int_arg(arity - 4);
+  const auto srid1 = get_int_arg(arity - 2);
+  const auto output_srid = get_int_arg(arity - 1);
+  if (!compression1 || !srid0 || !srid1 || !output_srid || *srid0 != *output_srid ||
+      *srid1 != *output_srid) {
+    // the geometries are transformed before they are compared
+    return std::nullopt;
+  }
+  // The elements of a constant array of `elem_type`, none for any other expression.
+  auto get_array_values = [](const Analyzer::Expr* expr, const SQLTypes elem_type) {
+    std::vector<Datum> values;
+    const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+    if (!constant || constant->get_is_null() ||
+        constant->get_type_info().get_type() != kARRAY ||
+        constant->get_type_info().get_subtype() != elem_type) {
+      return values;
+    }
+    for (const auto& value : constant->get_value_list()) {
+      const auto elem = dynamic_cast<const Analyzer::Constant*>(value.get());
+      if (!elem || elem->get_is_null()) {
+        return std::vector<Datum>{};
+      }
+      values.push_back(elem->get_constval());
+    }
+    return values;
+  };
+  GeoGridChunkIndex::Box box;
+  if (name.size() > 6 && name.compare(name.size() - 6, 6, "_Point") == 0) {
+    std::vector<int8_t> compressed_coords;
+    for (const auto& value :
+         get_array_values(func_oper->getArg(constant_arg_idx), kTINYINT)) {
+      compressed_coords.push_back(value.tinyintval);
+    }
+    if (compressed_coords.empty()) {
+      return std::nullopt;
+    }
+    const auto coords = Geospatial::decompress_coords<double, int32_t>(
+        *compression1, compressed_coords.data(), compressed_coords.size());
+    if (coords->size() != 2) {
+      return std::nullopt;
+    }
+    box = {(*coords)[0], (*coords)[1], (*coords)[0], (*coords)[1]};
+  } else {
+    // the bounds of a constant geometry are its only array argument of doubles
+    std::vector<Datum> bounds;
+    for (size_t i = constant_arg_idx; i < arity - 5 && bounds.empty(); ++i) {
+      bounds = get_array_values(func_oper->getArg(i), kDOUBLE);
+    }
+    if (bounds.size() != 4) {
+      return std::nullopt;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      box[i] = bounds[i].doubleval;
+    }
+  }
+  box[0] -= distance + kGeoProbeTolerance;
+  box[1] -= distance + kGeoProbeTolerance;
+  box[2] += distance + kGeoProbeTolerance;
+  box[3] += distance + kGeoProbeTolerance;
+  return GeoFilterProbe{bounds_column_id, box};
+}
+
+}  // namespace
+
+std::optional<int64_t> Executor::getStoredValue(const SQLTypeInfo& col_ti,
+                                                const Analyzer::Expr* expr) const {
+  const auto cast_expr = dynamic_cast<const Analyzer::UOper*>(expr);
+  if (cast_expr && cast_expr->get_optype() == kCAST && col_ti.is_dict_encoded_string()) {
+    // string literals are compared after a cast to the dictionary of the column
+    expr = cast_expr->get_operand();
+  }
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null()) {
+    return std::nullopt;
+  }
+  const auto& const_ti = constant->get_type_info();
+  if (col_ti.is_dict_encoded_string()) {
+    if (!const_ti.is_string() || const_ti.get_compression() != kENCODING_NONE) {
+      return std::nullopt;
+    }
+    const auto sdp =
+        getStringDictionaryProxy(col_ti.get_comp_param(), row_set_mem_owner_, false);
+    CHECK(sdp);
+    // INVALID_STR_ID if the string isn't in the dictionary, then no chunk has it
+    return sdp->getIdOfString(*constant->get_constval().stringval);
+  }
+  if (const_ti.get_type() != col_ti.get_type() ||
+      const_ti.get_dimension() != col_ti.get_dimension()) {
+    return std::nullopt;
+  }
+  return extract_from_datum(constant->get_constval(), const_ti);
+}
+
+bool Executor::skipFragmentByBloomFilters(
+    const InputDescriptor& table_desc,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const RelAlgExecutionUnit& ra_exe_unit) {
+  if (!g_enable_chunk_bloom_filters || table_desc.getNestLevel()) {
+    return false;
+  }
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  // The filter of the chunk, if `expr` is a column of the outer table which has one.
+  auto get_bloom_filter = [&](const Analyzer::Expr* expr) -> const ChunkBloomFilter* {
+    const auto col_var = get_outer_column(expr, table_desc.getTableId());
+    if (!col_var) {
+      return nullptr;
+    }
+    const auto chunk_meta_it = chunk_metadata_map.find(col_var->get_column_id());
+    return chunk_meta_it != chunk_metadata_map.end()
+               ? chunk_meta_it->second->bloomFilter.get()
+               : nullptr;
+  };
+  for (const auto quals : {&ra_exe_unit.simple_quals, &ra_exe_unit.quals}) {
+    for (const auto& qual : *quals) {
+      if (const auto comp_expr = dynamic_cast<const Analyzer::BinOper*>(qual.get())) {
+        if (comp_expr->get_optype() != kEQ || comp_expr->get_qualifier() != kONE) {
+          continue;
+        }
+        const auto lhs = comp_expr->get_left_operand();
+        const auto rhs = comp_expr->get_right_operand();
+        for (const auto& [col, val] :
+             {std::make_pair(lhs, rhs), std::make_pair(rhs, lhs)}) {
+          const auto bloom_filter = get_bloom_filter(col);
+          if (!bloom_filter) {
+            continue;
+          }
+          const auto stored_val = getStoredValue(col->get_type_info(), val);
+          if (stored_val && !bloom_filter->mayContain(*stored_val)) {
+            return true;
+          }
+        }
+      } else if (const auto in_values =
+                     dynamic_cast<const Analyzer::InValues*>(qual.get())) {
+        const auto arg = in_values->get_arg();
+        const auto bloom_filter = get_bloom_filter(arg);
+        if (!bloom_filter) {
+          continue;
+        }
+        const auto& value_list = in_values->get_value_list();
+        if (std::none_of(value_list.begin(), value_list.end(), [&](const auto& val) {
+              const auto stored_val = getStoredValue(arg->get_type_info(), val.get());
+              return !stored_val || bloom_filter->mayContain(*stored_val);
+            })) {
+          return true;
+        }
+      } else if (const auto in_integer_set =
+                     dynamic_cast<const Analyzer::InIntegerSet*>(qual.get())) {
+        // the values of a set on a dictionary encoded column are ids of its dictionary
+        const auto bloom_filter = get_bloom_filter(in_integer_set->get_arg());
+        if (!bloom_filter) {
+          continue;
+        }
+        const auto& value_list = in_integer_set->get_value_list();
+        if (std::none_of(value_list.begin(), value_list.end(), [&](const int64_t val) {
+              return bloom_filter->mayContain(val);
+            })) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+namespace {
+
+// Whether a filter can be true and whether it can be false for some row of a fragment.
+// Null is neither, a filter which can only be null for the fragment skips it.
+struct QualOutcomes {
+  bool may_be_true;
+  bool may_be_false;
+};
+
+constexpr QualOutcomes kUnknownOutcomes{true, true};
+
+template <typename T>
+QualOutcomes compare_ranges(const SQLOps optype,
+                            const T lhs_min,
+                            const T lhs_max,
+                            const T rhs_min,
+                            const T rhs_max) {
+  switch (optype) {
+    case kEQ:
+    case kNE: {
+      const QualOutcomes eq_outcomes{
+          lhs_min <= rhs_max && rhs_min <= lhs_max,
+          !(lhs_min == lhs_max && rhs_min == rhs_max && lhs_min == rhs_min)};
+      return optype == kEQ ? eq_outcomes
+                           : QualOutcomes{eq_outcomes.may_be_false,
+                                          eq_outcomes.may_be_true};
+    }
+    case kLT:
+      return {lhs_min < rhs_max, lhs_max >= rhs_min};
+    case kLE:
+      return {lhs_min <= rhs_max, lhs_max > rhs_min};
+    case kGT:
+      return {lhs_max > rhs_min, lhs_min <= rhs_max};
+    case kGE:
+      return {lhs_max >= rhs_min, lhs_min < rhs_max};
+    default:
+      break;
+  }
+  return kUnknownOutcomes;
+}
+
+QualOutcomes compare_ranges(const SQLOps optype,
+                            const ExpressionRange& lhs,
+                            const ExpressionRange& rhs) {
+  if (lhs.getType() == ExpressionRangeType::Null ||
+      rhs.getType() == ExpressionRangeType::Null) {
+    return {false, false};
+  }
+  if (lhs.getType() == ExpressionRangeType::Invalid || lhs.getType() != rhs.getType()) {
+    return kUnknownOutcomes;
+  }
+  if (lhs.getType() == ExpressionRangeType::Integer) {
+    return compare_ranges(
+        optype, lhs.getIntMin(), lhs.getIntMax(), rhs.getIntMin(), rhs.getIntMax());
+  }
+  return compare_ranges(
+      optype, lhs.getFpMin(), lhs.getFpMax(), rhs.getFpMin(), rhs.getFpMax());
+}
+
+// Whether the stored values of the operands of a comparison can be compared as such.
+bool comparable_stored_values(const SQLTypeInfo& lhs_ti,
+                              const SQLTypeInfo& rhs_ti,
+                              const SQLOps optype) {
+  if (lhs_ti.get_type() != rhs_ti.get_type() ||
+      lhs_ti.get_dimension() != rhs_ti.get_dimension() ||
+      lhs_ti.get_scale() != rhs_ti.get_scale()) {
+    return false;
+  }
+  if (lhs_ti.is_string()) {
+    // dictionary ids are only equal for equal strings of the same dictionary
+    return lhs_ti.is_dict_encoded_string() && rhs_ti.is_dict_encoded_string() &&
+           lhs_ti.get_comp_param() == rhs_ti.get_comp_param() &&
+           (optype == kEQ || optype == kNE);
+  }
+  return true;
+}
+
+QualOutcomes get_qual_outcomes(const Analyzer::Expr* qual,
+                               const int table_id,
+                               const Fragmenter_Namespace::FragmentInfo& fragment,
+                               const Executor* executor) {
+  auto get_range = [&](const Analyzer::Expr* expr) {
+    return getFragmentExpressionRange(expr, table_id, fragment, executor);
+  };
+  const auto cat = executor->getCatalog();
+  if (const auto geo_probe =
+          cat ? get_geo_filter_probe(qual, table_id, *cat) : std::nullopt) {
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+    const auto chunk_meta_it = chunk_metadata_map.find(geo_probe->bounds_column_id);
+    if (chunk_meta_it == chunk_metadata_map.end() ||
+        !chunk_meta_it->second->geoBounds) {
+      return kUnknownOutcomes;
+    }
+    const auto& bounds = *chunk_meta_it->second->geoBounds;
+    const auto& box = geo_probe->box;
+    return {bounds[0] <= box[2] && box[0] <= bounds[2] && bounds[1] <= box[3] &&
+                box[1] <= bounds[3],
+            true};
+  }
+  if (const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual)) {
+    const auto optype = bin_oper->get_optype();
+    const auto lhs = bin_oper->get_left_operand();
+    const auto rhs = bin_oper->get_right_operand();
+    if (optype == kAND || optype == kOR) {
+      const auto lhs_outcomes = get_qual_outcomes(lhs, table_id, fragment, executor);
+      const auto rhs_outcomes = get_qual_outcomes(rhs, table_id, fragment, executor);
+      return optype == kAND
+                 ? QualOutcomes{lhs_outcomes.may_be_true && rhs_outcomes.may_be_true,
+                                lhs_outcomes.may_be_false || rhs_outcomes.may_be_false}
+                 : QualOutcomes{lhs_outcomes.may_be_true || rhs_outcomes.may_be_true,
+                                lhs_outcomes.may_be_false && rhs_outcomes.may_be_false};
+    }
+    if (!IS_COMPARISON(optype) || bin_oper->get_qualifier() != kONE ||
+        !comparable_stored_values(lhs->get_type_info(), rhs->get_type_info(), optype)) {
+      return kUnknownOutcomes;
+    }
+    return compare_ranges(optype, get_range(lhs), get_range(rhs));
+  }
+  if (const auto u_oper = dynamic_cast<const Analyzer::UOper*>(qual)) {
+    if (u_oper->get_optype() == kNOT) {
+      const auto outcomes =
+          get_qual_outcomes(u_oper->get_operand(), table_id, fragment, executor);
+      return {outcomes.may_be_false, outcomes.may_be_true};
+    }
+    if (u_oper->get_optype() == kISNULL) {
+      const auto range = get_range(u_oper->get_operand());
+      switch (range.getType()) {
+        case ExpressionRangeType::Null:
+          return {true, false};
+        case ExpressionRangeType::Invalid:
+          return kUnknownOutcomes;
+        default:
+          return {range.hasNulls(), true};
+      }
+    }
+    return kUnknownOutcomes;
+  }
+  if (const auto in_values = dynamic_cast<const Analyzer::InValues*>(qual)) {
+    const auto arg = in_values->get_arg();
+    const auto arg_range = get_range(arg);
+    if (arg_range.getType() == ExpressionRangeType::Null) {
+      return {false, false};
+    }
+    QualOutcomes outcomes{false, true};
+    for (const auto& val : in_values->get_value_list()) {
+      if (!comparable_stored_values(arg->get_type_info(), val->get_type_info(), kEQ)) {
+        return kUnknownOutcomes;
+      }
+      if (compare_ranges(kEQ, arg_range, get_range(val.get())).may_be_true) {
+        outcomes.may_be_true = true;
+        break;
+      }
+    }
+    return outcomes;
+  }
+  if (const auto in_integer_set = dynamic_cast<const Analyzer::InIntegerSet*>(qual)) {
+    const auto arg_range = get_range(in_integer_set->get_arg());
+    switch (arg_range.getType()) {
+      case ExpressionRangeType::Null:
+        return {false, false};
+      case ExpressionRangeType::Integer: {
+        const auto& value_list = in_integer_set->get_value_list();
+        const bool may_be_true =
+            std::any_of(value_list.begin(), value_list.end(), [&](const int64_t val) {
+              return val >= arg_range.getIntMin() && val <= arg_range.getIntMax();
+            });
+        return {may_be_true, true};
+      }
+      default:
+        return kUnknownOutcomes;
+    }
+  }
+  if (qual->get_type_info().is_boolean()) {
+    // a boolean column or expression
+    const auto range = get_range(qual);
+    switch (range.getType()) {
+      case ExpressionRangeType::Null:
+        return {false, false};
+      case ExpressionRangeType::Integer:
+        return {range.getIntMax() > 0, range.getIntMin() <= 0};
+      default:
+        break;
+    }
+  }
+  return kUnknownOutcomes;
+}
+
+}  // namespace
+
+bool Executor::skipFragmentByStats(const InputDescriptor& table_desc,
+                                   const Fragmenter_Namespace::FragmentInfo& fragment,
+                                   const RelAlgExecutionUnit& ra_exe_unit) {
+  if (!g_enable_expression_fragment_skipping || table_desc.getNestLevel() ||
+      table_desc.getTableId() <= 0) {
+    return false;
+  }
+  for (const auto quals : {&ra_exe_unit.simple_quals, &ra_exe_unit.quals}) {
+    for (const auto& qual : *quals) {
+      if (!get_qual_outcomes(qual.get(), table_desc.getTableId(), fragment, this)
+               .may_be_true) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool Executor::skipFragmentBySampling(const InputDescriptor& table_desc,
+                                      const std::vector<uint64_t>& frag_offsets,
+                                      const size_t frag_idx,
+                                      const RelAlgExecutionUnit& ra_exe_unit) {
+  if (table_desc.getNestLevel() || ra_exe_unit.union_all) {
+    return false;
+  }
+  for (const auto& qual : ra_exe_unit.quals) {
+    const auto sample_expr = dynamic_cast<const Analyzer::SampleRatioExpr*>(qual.get());
+    if (!sample_expr || !sample_expr->isPerFragment()) {
+      continue;
+    }
+    const auto proportion =
+        dynamic_cast<const Analyzer::Constant*>(sample_expr->get_arg());
+    if (!proportion || proportion->get_is_null()) {
+      continue;
+    }
+    CHECK_EQ(proportion->get_type_info().get_type(), kDOUBLE);
+    // the fragment is kept by the row offset the generated code sees for it
+    const int64_t frag_offset =
+        frag_idx < frag_offsets.size() ? frag_offsets[frag_idx] : 0;
+    if (!sample_ratio(proportion->get_constval().doubleval, frag_offset)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::optional<std::pair<size_t, size_t>> Executor::getIndexedRowRange(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const Fragmenter_Namespace::FragmentInfo& fragment) {
+  CHECK(g_enable_sorted_chunk_indexes || g_enable_geo_grid_indexes);
+  const int table_id = ra_exe_unit.input_descs.front().getTableId();
+  if (table_id <= 0) {
+    return std::nullopt;
+  }
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  auto get_index =
+      [&](const Analyzer::ColumnVar* col_var) -> std::shared_ptr<const SortedChunkIndex> {
+    const auto chunk_meta_it = chunk_metadata_map.find(col_var->get_column_id());
+    if (chunk_meta_it == chunk_metadata_map.end() ||
+        !SortedChunkIndex::canIndex(chunk_meta_it->second->sqlType)) {
+      return nullptr;
+    }
+    const auto& chunk_meta = chunk_meta_it->second;
+    auto index = std::atomic_load(&chunk_meta->sortedIndex);
+    if (index && index->rowCount() == chunk_meta->numElements) {
+      return index;
+    }
+    const auto cd = get_column_descriptor(col_var->get_column_id(), table_id, *catalog_);
+    const ChunkKey chunk_key{
+        catalog_->getCurrentDB().dbId, table_id, cd->columnId, fragment.fragmentId};
+    const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                                 &catalog_->getDataMgr(),
+                                                 chunk_key,
+                                                 Data_Namespace::CPU_LEVEL,
+                                                 0,
+                                                 chunk_meta->numBytes,
+                                                 chunk_meta->numElements);
+    CHECK(chunk);
+    index = std::make_shared<const SortedChunkIndex>(
+        chunk->getBuffer()->getMemoryPtr(), chunk_meta->numElements, chunk_meta->sqlType);
+    std::atomic_store(&chunk_meta->sortedIndex, index);
+    return index;
+  };
+  auto get_geo_index =
+      [&](const int bounds_column_id) -> std::shared_ptr<const GeoGridChunkIndex> {
+    const auto chunk_meta_it = chunk_metadata_map.find(bounds_column_id);
+    if (chunk_meta_it == chunk_metadata_map.end()) {
+      return nullptr;
+    }
+    const auto& chunk_meta = chunk_meta_it->second;
+    auto index = std::atomic_load(&chunk_meta->geoGridIndex);
+    if (index && index->rowCount() == chunk_meta->numElements) {
+      return index;
+    }
+    const auto cd = get_column_descriptor(bounds_column_id, table_id, *catalog_);
+    const ChunkKey chunk_key{
+        catalog_->getCurrentDB().dbId, table_id, cd->columnId, fragment.fragmentId};
+    const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                                 &catalog_->getDataMgr(),
+                                                 chunk_key,
+                                                 Data_Namespace::CPU_LEVEL,
+                                                 0,
+                                                 chunk_meta->numBytes,
+                                                 chunk_meta->numElements);
+    CHECK(chunk);
+    index = std::make_shared<const GeoGridChunkIndex>(chunk->getBuffer()->getMemoryPtr(),
+                                                      chunk_meta->numElements);
+    std::atomic_store(&chunk_meta->geoGridIndex, index);
+    return index;
+  };
+  std::optional<std::pair<size_t, size_t>> row_range;
+  auto intersect = [&row_range](const std::pair<size_t, size_t>& qual_row_range) {
+    if (!row_range) {
+      row_range = qual_row_range;
+      return;
+    }
+    row_range->first = std::max(row_range->first, qual_row_range.first);
+    row_range->second = std::min(row_range->second, qual_row_range.second);
+    if (row_range->first >= row_range->second) {
+      row_range = std::make_pair(size_t(0), size_t(0));
+    }
+  };
+  for (const auto quals : {&ra_exe_unit.simple_quals, &ra_exe_unit.quals}) {
+    for (const auto& qual : *quals) {
+      const auto geo_probe = g_enable_geo_grid_indexes
+                                 ? get_geo_filter_probe(qual.get(), table_id, *catalog_)
+                                 : std::nullopt;
+      if (geo_probe) {
+        if (const auto index = get_geo_index(geo_probe->bounds_column_id)) {
+          intersect(index->getRowRange(geo_probe->box));
+        }
+        continue;
+      }
+      if (!g_enable_sorted_chunk_indexes) {
+        continue;
+      }
+      if (const auto comp_expr = dynamic_cast<const Analyzer::BinOper*>(qual.get())) {
+        if (comp_expr->get_qualifier() != kONE) {
+          continue;
+        }
+        auto optype = comp_expr->get_optype();
+        auto col_var = get_outer_column(comp_expr->get_left_operand(), table_id);
+        auto val = comp_expr->get_right_operand();
+        if (!col_var) {
+          col_var = get_outer_column(comp_expr->get_right_operand(), table_id);
+          val = comp_expr->get_left_operand();
+          optype = COMMUTE_COMPARISON(optype);
+        }
+        if (!col_var || (col_var->get_type_info().is_dict_encoded_string() &&
+                         optype != kEQ)) {
+          continue;
+        }
+        const auto stored_val = getStoredValue(col_var->get_type_info(), val);
+        if (!stored_val) {
+          continue;
+        }
+        auto lo = std::numeric_limits<int64_t>::min();
+        auto hi = std::numeric_limits<int64_t>::max();
+        switch (optype) {
+          case kEQ:
+            lo = hi = *stored_val;
+            break;
+          case kGE:
+            lo = *stored_val;
+            break;
+          case kGT:
+            if (*stored_val == hi) {
+              intersect({0, 0});
+              continue;
+            }
+            lo = *stored_val + 1;
+            break;
+          case kLE:
+            hi = *stored_val;
+            break;
+          case kLT:
+            if (*stored_val == lo) {
+              intersect({0, 0});
+              continue;
+            }
+            hi = *stored_val - 1;
+            break;
+          default:
+            continue;
+        }
+        if (const auto index = get_index(col_var)) {
+          intersect(index->getRowRange(lo, hi));
+        }
+      } else if (const auto in_values =
+                     dynamic_cast<const Analyzer::InValues*>(qual.get())) {
+        const auto col_var = get_outer_column(in_values->get_arg(), table_id);
+        if (!col_var) {
+          continue;
+        }
+        std::vector<int64_t> stored_vals;
+        for (const auto& val : in_values->get_value_list()) {
+          const auto stored_val = getStoredValue(col_var->get_type_info(), val.get());
+          if (!stored_val) {
+            break;
+          }
+          stored_vals.push_back(*stored_val);
+        }
+        const auto index = stored_vals.size() == in_values->get_value_list().size()
+                               ? get_index(col_var)
+                               : nullptr;
+        if (!index) {
+          continue;
+        }
+        // the union of the ranges of the values
+        std::pair<size_t, size_t> in_row_range{0, 0};
+        for (const auto stored_val : stored_vals) {
+          const auto val_row_range = index->getRowRange(stored_val, stored_val);
+          if (val_row_range.first >= val_row_range.second) {
+            continue;
+          }
+          in_row_range =
+              in_row_range.first < in_row_range.second
+                  ? std::make_pair(std::min(in_row_range.first, val_row_range.first),
+                                   std::max(in_row_range.second, val_row_range.second))
+                  : val_row_range;
+        }
+        intersect(in_row_range);
+      }
+    }
+  }
+  return row_range;
+}
+
 /*
  *   The skipFragmentInnerJoins process all quals stored in the execution unit's
  * join_quals and gather all the ones that meet the "simple_qual" characteristics
@@ -3466,6 +4896,72 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
   return skip_frag;
 }
 
+/*
+ *   Runtime filter derived from the hash tables built for the inner joins: the outer key
+ * of an inner equi-join must lie within the range of the inner keys, so the range is
+ * turned into simple quals on the outer column which skipFragment can evaluate against
+ * the fragment metadata. Selective filters on a small inner table thus skip the outer
+ * fragments which cannot produce a match.
+ */
+std::list<std::shared_ptr<Analyzer::Expr>> Executor::getJoinKeyRangeQuals(
+    const RelAlgExecutionUnit& ra_exe_unit) const {
+  std::list<std::shared_ptr<Analyzer::Expr>> key_range_quals;
+  if (!plan_state_ || ra_exe_unit.input_descs.empty()) {
+    return key_range_quals;
+  }
+  const auto outer_table_id = ra_exe_unit.input_descs.front().getTableId();
+  const auto& join_info = plan_state_->join_info_;
+  CHECK_EQ(join_info.equi_join_tautologies_.size(), join_info.join_hash_tables_.size());
+  const auto make_bigint_constant = [](const int64_t val) {
+    Datum d;
+    d.bigintval = val;
+    return makeExpr<Analyzer::Constant>(kBIGINT, false, d);
+  };
+  for (const auto& join_condition : ra_exe_unit.join_quals) {
+    if (join_condition.type != JoinType::INNER) {
+      continue;
+    }
+    for (const auto& qual : join_condition.quals) {
+      for (size_t i = 0; i < join_info.equi_join_tautologies_.size(); ++i) {
+        const auto& join_qual = join_info.equi_join_tautologies_[i];
+        if (join_qual != qual || join_qual->get_optype() != kEQ) {
+          continue;
+        }
+        const auto& hash_table = join_info.join_hash_tables_[i];
+        const auto key_range = hash_table->getInnerKeyRange();
+        if (!key_range) {
+          continue;
+        }
+        std::shared_ptr<Analyzer::ColumnVar> outer_col;
+        for (const auto& operand :
+             {join_qual->get_own_left_operand(), join_qual->get_own_right_operand()}) {
+          auto col = std::dynamic_pointer_cast<Analyzer::ColumnVar>(operand);
+          if (col && col->get_rte_idx() == 0 && col->get_table_id() == outer_table_id &&
+              col->get_rte_idx() != hash_table->getInnerTableRteIdx()) {
+            outer_col = col;
+          }
+        }
+        if (!outer_col || !outer_col->get_type_info().is_integer()) {
+          continue;
+        }
+        key_range_quals.push_back(
+            makeExpr<Analyzer::BinOper>(kBOOLEAN,
+                                        kGE,
+                                        kONE,
+                                        outer_col,
+                                        make_bigint_constant(key_range->first)));
+        key_range_quals.push_back(
+            makeExpr<Analyzer::BinOper>(kBOOLEAN,
+                                        kLE,
+                                        kONE,
+                                        outer_col,
+                                        make_bigint_constant(key_range->second)));
+      }
+    }
+  }
+  return key_range_quals;
+}
+
 AggregatedColRange Executor::computeColRangesCache(
     const std::unordered_set<PhysicalInput>& phys_inputs) {
   AggregatedColRange agg_col_range_cache;
@@ -3528,7 +5024,8 @@ TableGenerations Executor::computeTableGenerations(
 void Executor::setupCaching(const std::unordered_set<PhysicalInput>& phys_inputs,
                             const std::unordered_set<int>& phys_table_ids) {
   CHECK(catalog_);
-  row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+  row_set_mem_owner_ = std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize(),
+                                                           g_max_query_host_memory_bytes);
   agg_col_range_cache_ = computeColRangesCache(phys_inputs);
   string_dictionary_generations_ = computeStringDictionaryGenerations(phys_inputs);
   table_generations_ = computeTableGenerations(phys_table_ids);
@@ -27,6 +27,7 @@
 #include "ExecutionKernel.h"
 #include "GpuSharedMemoryContext.h"
 #include "GroupByAndAggregate.h"
+#include "IncrementalAggregateCache.h"
 #include "JoinHashTable/JoinHashTable.h"
 #include "LoopControlFlow/JoinLoop.h"
 #include "NvidiaKernel.h"
@@ -336,6 +337,10 @@ class Executor {
   using ExecutorId = size_t;
   static const ExecutorId UNITARY_EXECUTOR_ID = 0;
 
+  // buffer pool bytes per memory level and device
+  using WorkUnitMemoryEstimate =
+      std::map<std::pair<Data_Namespace::MemoryLevel, int>, size_t>;
+
   Executor(const ExecutorId id,
            const size_t block_size_x,
            const size_t grid_size_x,
@@ -357,6 +362,20 @@ class Executor {
   }
 
   static void clearMemory(const Data_Namespace::MemoryLevel memory_level);
+  // Compacts the buffer pools of the level unless queries are running, returns how many
+  // buffers moved.
+  static size_t compactMemoryIfIdle(const Data_Namespace::MemoryLevel memory_level);
+  // Runs `func` as a query would unless queries are running, returns false if they are.
+  static bool runIfIdle(const std::function<void()>& func);
+
+  struct CodeCacheStatus {
+    ExecutorId executor_id;
+    ExecutorDeviceType device_type;
+    CodeCacheStats stats;
+  };
+
+  // Statistics of the CPU and GPU code caches of every executor.
+  static std::vector<CodeCacheStatus> getCodeCacheStatus();
 
   static size_t getArenaBlockSize();
 
@@ -432,7 +451,8 @@ class Executor {
                      const Catalog_Namespace::Catalog& cat,
                      std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
                      const UpdateLogForFragment::Callback& cb,
-                     const bool is_agg);
+                     const bool is_agg,
+                     const bool allow_parallel_fragments);
 
  private:
   void clearMetaInfoCache();
@@ -523,6 +543,16 @@ class Executor {
       const ExecutorDeviceType device_type,
       std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner);
 
+  // Reduces the kernel results with the cached aggregate of `plan`, then caches the
+  // aggregate of all the full fragments if it covers new ones.
+  ResultSetPtr collectIncrementalAggregate(
+      SharedKernelContext& shared_context,
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const QueryMemoryDescriptor& query_mem_desc,
+      const ExecutorDeviceType device_type,
+      const IncrementalAggregateCache::Plan& plan,
+      std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner);
+
   ResultSetPtr collectAllDeviceShardedTopResults(
       SharedKernelContext& shared_context,
       const RelAlgExecutionUnit& ra_exe_unit) const;
@@ -548,13 +578,24 @@ class Executor {
       std::unordered_set<int>& available_gpus,
       int& available_cpus);
 
+  /**
+   * Estimates the buffer pool memory, per memory level and device, held by the kernels
+   * of a query step while they run: fetched input columns, output buffers and join hash
+   * tables.
+   */
+  WorkUnitMemoryEstimate estimateWorkUnitMemory(
+      const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+      const std::vector<InputTableInfo>& table_infos,
+      const QueryMemoryDescriptor& query_mem_desc) const;
+
   /**
    * Launches execution kernels created by `createKernels` asynchronously using a thread
-   * pool.
+   * pool, at most max_parallel_kernels at a time if not zero.
    */
   template <typename THREAD_POOL>
   void launchKernels(SharedKernelContext& shared_context,
-                     std::vector<std::unique_ptr<ExecutionKernel>>&& kernels);
+                     std::vector<std::unique_ptr<ExecutionKernel>>&& kernels,
+                     const size_t max_parallel_kernels);
 
   std::vector<size_t> getTableFragmentIndices(
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -595,6 +636,13 @@ class Executor {
                                std::list<std::shared_ptr<Chunk_NS::Chunk>>&,
                                DeviceAllocator* device_allocator);
 
+  // Whether a column is the delete column the query filters a table on and the chunk
+  // metadata of the fragment shows no deleted row, the column isn't fetched then.
+  bool isDeletedColumnWithoutDeletes(
+      const int table_id,
+      const int col_id,
+      const Fragmenter_Namespace::FragmentInfo& fragment) const;
+
   std::pair<std::vector<std::vector<int64_t>>, std::vector<std::vector<uint64_t>>>
   getRowCountAndOffsetForAllFrags(
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -667,7 +715,8 @@ class Executor {
   static void addCodeToCache(const CodeCacheKey&,
                              std::shared_ptr<CompilationContext>,
                              llvm::Module*,
-                             CodeCache&);
+                             CodeCache&,
+                             const int64_t compilation_time_ms = 0);
 
  private:
   ResultSetPtr resultsUnion(SharedKernelContext& shared_context,
@@ -790,7 +839,17 @@ class Executor {
       llvm::Function*,
       llvm::Function*,
       const std::unordered_set<llvm::Function*>&,
-      const CompilationOptions&);
+      const CompilationOptions&,
+      const bool allow_baseline_tier = false);
+  // Tiered compilation: returns quickly generated baseline code and schedules the
+  // optimizing compilation, which replaces the cache entry once it is done.
+  std::shared_ptr<CompilationContext> codegenCPUBaselineTier(
+      const CodeCacheKey&,
+      llvm::Function*,
+      llvm::Function*,
+      const std::unordered_set<llvm::Function*>&,
+      const CompilationOptions&,
+      const std::string& persistent_cache_key);
   std::shared_ptr<CompilationContext> optimizeAndCodegenGPU(
       llvm::Function*,
       llvm::Function*,
@@ -831,6 +890,39 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  // Whether the Bloom filters of the chunks of the fragment exclude all the values an
+  // equality or IN filter of the work unit looks for.
+  bool skipFragmentByBloomFilters(const InputDescriptor& table_desc,
+                                  const Fragmenter_Namespace::FragmentInfo& fragment,
+                                  const RelAlgExecutionUnit& ra_exe_unit);
+
+  // Whether the outer fragment frag_idx is left out by a SAMPLE_FRAGMENTS filter of the
+  // work unit, the generated code keeps all the rows of the other fragments.
+  bool skipFragmentBySampling(const InputDescriptor& table_desc,
+                              const std::vector<uint64_t>& frag_offsets,
+                              const size_t frag_idx,
+                              const RelAlgExecutionUnit& ra_exe_unit);
+
+  // Whether the stats of the chunks of the fragment show that no row passes a filter of
+  // the work unit. Evaluates the filters on the ranges of the values of their operands,
+  // so handles the AND, OR and NOT of comparisons and IN lists on expressions of the
+  // columns made of arithmetic, casts, DATE_TRUNC and EXTRACT.
+  bool skipFragmentByStats(const InputDescriptor& table_desc,
+                           const Fragmenter_Namespace::FragmentInfo& fragment,
+                           const RelAlgExecutionUnit& ra_exe_unit);
+
+  // The smallest range of rows of an outer fragment holding every row which can pass the
+  // filters of the work unit on its indexed columns, std::nullopt if there is none.
+  // Builds the sorted and geo grid indexes of the filtered chunks which don't have one
+  // yet.
+  std::optional<std::pair<size_t, size_t>> getIndexedRowRange(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const Fragmenter_Namespace::FragmentInfo& fragment);
+
+  // The value stored in a column of type `col_ti` for the constant `expr`, if known.
+  std::optional<int64_t> getStoredValue(const SQLTypeInfo& col_ti,
+                                        const Analyzer::Expr* expr) const;
+
   std::pair<bool, int64_t> skipFragmentInnerJoins(
       const InputDescriptor& table_desc,
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -838,6 +930,9 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  std::list<std::shared_ptr<Analyzer::Expr>> getJoinKeyRangeQuals(
+      const RelAlgExecutionUnit& ra_exe_unit) const;
+
   AggregatedColRange computeColRangesCache(
       const std::unordered_set<PhysicalInput>& phys_inputs);
   StringDictionaryGenerations computeStringDictionaryGenerations(
@@ -885,8 +980,7 @@ class Executor {
   CachedCardinality getCachedCardinality(const std::string& cache_key);
 
  private:
-  std::shared_ptr<CompilationContext> getCodeFromCache(const CodeCacheKey&,
-                                                       const CodeCache&);
+  std::shared_ptr<CompilationContext> getCodeFromCache(const CodeCacheKey&, CodeCache&);
 
   std::vector<int8_t> serializeLiterals(
       const std::unordered_map<int, CgenState::LiteralValues>& literals,
@@ -905,12 +999,18 @@ class Executor {
   class FetchCacheAnchor {
    public:
     FetchCacheAnchor(CgenState* cgen_state)
-        : cgen_state_(cgen_state), saved_fetch_cache(cgen_state_->fetch_cache_) {}
-    ~FetchCacheAnchor() { cgen_state_->fetch_cache_.swap(saved_fetch_cache); }
+        : cgen_state_(cgen_state)
+        , saved_fetch_cache(cgen_state_->fetch_cache_)
+        , saved_expr_value_cache(cgen_state_->expr_value_cache_) {}
+    ~FetchCacheAnchor() {
+      cgen_state_->fetch_cache_.swap(saved_fetch_cache);
+      cgen_state_->expr_value_cache_.swap(saved_expr_value_cache);
+    }
 
    private:
     CgenState* cgen_state_;
     std::unordered_map<int, std::vector<llvm::Value*>> saved_fetch_cache;
+    std::vector<CgenState::ExprValue> saved_expr_value_cache;
   };
 
   llvm::Value* spillDoubleElement(llvm::Value* elem_val, llvm::Type* elem_ty);
@@ -950,6 +1050,20 @@ class Executor {
 
   int64_t kernel_queue_time_ms_ = 0;
   int64_t compilation_queue_time_ms_ = 0;
+  int64_t compilation_time_ms_ = 0;
+  // The hardware counters of the kernel threads, with g_enable_perf_counters.
+  logger::PerfCounterValues kernel_perf_counters_;
+  std::mutex kernel_perf_counters_mutex_;
+  // The device time of the GPU kernels, with g_enable_gpu_kernel_timing.
+  CudaMgr_Namespace::GpuTimings kernel_gpu_timings_;
+  std::mutex kernel_gpu_timings_mutex_;
+  int64_t reduction_time_ms_ = 0;
+  // Bytes of the chunks the kernels of the work unit fetched, by memory level.
+  std::atomic<size_t> cpu_bytes_scanned_{0};
+  std::atomic<size_t> gpu_bytes_scanned_{0};
+  // The buffer pool bytes the kernels of the work unit need, by memory level.
+  size_t cpu_working_set_bytes_ = 0;
+  size_t gpu_working_set_bytes_ = 0;
 
   // Singleton instance used for an execution unit which is a project with window
   // functions.
@@ -997,6 +1111,7 @@ class Executor {
   static const int32_t ERR_STREAMING_TOP_N_NOT_SUPPORTED_IN_RENDER_QUERY{14};
   static const int32_t ERR_SINGLE_VALUE_FOUND_MULTIPLE_VALUES{15};
   static const int32_t ERR_GEOS{16};
+  static const int32_t ERR_QUERY_MEMORY_LIMIT{17};
 
   static std::mutex compilation_mutex_;
   static std::mutex kernel_mutex_;
@@ -1005,6 +1120,7 @@ class Executor {
   friend class CodeGenerator;
   friend class ColumnFetcher;
   friend class ExecutionKernel;
+  friend class SharedKernelContext;
   friend class OverlapsJoinHashTable;
   friend class GroupByAndAggregate;
   friend class QueryCompilationDescriptor;
@@ -1014,6 +1130,8 @@ class Executor {
   friend class QueryExecutionContext;
   friend class ResultSet;
   friend class InValuesBitmap;
+  friend class GpuStringDictionaryPayload;
+  friend class InValuesHashSet;
   friend class JoinHashTable;
   friend class LeafAggregator;
   friend class QueryRewriter;
@@ -16,11 +16,17 @@
 
 #include "QueryEngine/Execute.h"
 
+#include <atomic>
+#include <future>
+
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/Descriptors/QueryCompilationDescriptor.h"
 #include "QueryEngine/Descriptors/QueryFragmentDescriptor.h"
 #include "QueryEngine/ExecutionKernel.h"
 #include "QueryEngine/RelAlgExecutor.h"
+#include "Shared/thread_count.h"
+
+bool g_enable_parallel_fragment_updates{true};
 
 UpdateLogForFragment::UpdateLogForFragment(FragmentInfoType const& fragment_info,
                                            size_t const fragment_index,
@@ -66,7 +72,8 @@ void Executor::executeUpdate(const RelAlgExecutionUnit& ra_exe_unit_in,
                              const Catalog_Namespace::Catalog& cat,
                              std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
                              const UpdateLogForFragment::Callback& cb,
-                             const bool is_agg) {
+                             const bool is_agg,
+                             const bool allow_parallel_fragments) {
   CHECK(cb);
   VLOG(1) << "Executor " << executor_id_
           << " is executing update/delete work unit:" << ra_exe_unit_in;
@@ -128,17 +135,17 @@ void Executor::executeUpdate(const RelAlgExecutionUnit& ra_exe_unit_in,
   }
   CHECK(query_mem_desc);
 
-  for (size_t fragment_index = 0; fragment_index < outer_fragments.size();
-       ++fragment_index) {
+  auto update_fragment = [&](const size_t fragment_index) {
     const int64_t crt_fragment_tuple_count =
         outer_fragments[fragment_index].getNumTuples();
     if (crt_fragment_tuple_count == 0) {
       // nothing to update
-      continue;
+      return;
     }
 
     SharedKernelContext shared_context(table_infos);
-    fragments[0] = {table_id, {fragment_index}};
+    auto fragment_fragments = fragments;
+    fragment_fragments[0] = {table_id, {fragment_index}};
     {
       ExecutionKernel current_fragment_kernel(ra_exe_unit,
                                               ExecutorDeviceType::CPU,
@@ -147,24 +154,61 @@ void Executor::executeUpdate(const RelAlgExecutionUnit& ra_exe_unit_in,
                                               column_fetcher,
                                               *query_comp_desc,
                                               *query_mem_desc,
-                                              fragments,
+                                              fragment_fragments,
                                               ExecutorDispatchMode::KernelPerFragment,
                                               /*render_info=*/nullptr,
                                               /*rowid_lookup_key=*/-1);
-
-      auto clock_begin = timer_start();
-      std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
-      kernel_queue_time_ms_ += timer_stop(clock_begin);
-
       current_fragment_kernel.run(this, shared_context);
     }
     const auto& proj_fragment_results = shared_context.getFragmentResults();
     if (proj_fragment_results.empty()) {
-      continue;
+      return;
     }
     const auto& proj_fragment_result = proj_fragment_results[0];
     const auto proj_result_set = proj_fragment_result.first;
     CHECK(proj_result_set);
     cb({outer_fragments[fragment_index], fragment_index, proj_result_set});
+  };
+
+  auto clock_begin = timer_start();
+  std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
+  kernel_queue_time_ms_ += timer_stop(clock_begin);
+
+  // The fragments are updated by a few workers at a time, the updates of a fragment
+  // are already spread over threads.
+  const size_t max_worker_count = std::max(size_t(cpu_threads()) / 4, size_t(1));
+  const size_t worker_count =
+      g_enable_parallel_fragment_updates && allow_parallel_fragments
+          ? std::min(outer_fragments.size(), max_worker_count)
+          : 1;
+  if (worker_count <= 1) {
+    for (size_t fragment_index = 0; fragment_index < outer_fragments.size();
+         ++fragment_index) {
+      update_fragment(fragment_index);
+    }
+    return;
+  }
+  std::atomic<size_t> next_fragment_index{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::future<void>> workers;
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back(std::async(std::launch::async, [&] {
+      for (auto fragment_index = next_fragment_index++;
+           fragment_index < outer_fragments.size() && !failed;
+           fragment_index = next_fragment_index++) {
+        try {
+          update_fragment(fragment_index);
+        } catch (...) {
+          failed = true;
+          throw;
+        }
+      }
+    }));
+  }
+  for (auto& worker : workers) {
+    worker.wait();
+  }
+  for (auto& worker : workers) {
+    worker.get();
   }
 }
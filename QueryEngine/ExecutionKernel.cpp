@@ -16,15 +16,24 @@
 
 #include "QueryEngine/ExecutionKernel.h"
 
+#include <limits>
 #include <mutex>
 #include <vector>
 
+#include "CudaMgr/CudaMgr.h"
 #include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
 #include "QueryEngine/DynamicWatchdog.h"
 #include "QueryEngine/ErrorHandling.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/ExpressionInterpreter.h"
 #include "QueryEngine/ExternalExecutor.h"
+#include "QueryEngine/ResultSetReductionJIT.h"
 #include "QueryEngine/SerializeToSql.h"
+#include "Shared/Metrics.h"
+#include "Shared/measure.h"
+
+extern bool g_enable_gpu_kernel_streams;
+extern size_t g_max_memory_allocation_size;
 
 namespace {
 
@@ -40,6 +49,34 @@ inline bool query_has_inner_join(const RelAlgExecutionUnit& ra_exe_unit) {
                         }) > 0);
 }
 
+/**
+ * The bump allocator output buffer of a kernel per fragment is sized by the input rows of
+ * the fragment, which a one-to-many or a loop join can expand past. Rather than failing
+ * the whole query over to CPU, the fragment is relaunched on the GPU with twice the
+ * entries, up to the largest allocation the device takes. Returns the new entry count,
+ * or 0 if the kernel did not run out of output space or cannot grow.
+ */
+int64_t grown_bump_allocator_entry_count(const int32_t error_code,
+                                         const int64_t entry_count,
+                                         const RelAlgExecutionUnit& ra_exe_unit,
+                                         const QueryMemoryDescriptor& query_mem_desc,
+                                         const ExecutorDeviceType device_type,
+                                         const ExecutorDispatchMode dispatch_mode) {
+  if (error_code >= 0 || !ra_exe_unit.use_bump_allocator ||
+      device_type != ExecutorDeviceType::GPU ||
+      dispatch_mode != ExecutorDispatchMode::KernelPerFragment ||
+      ra_exe_unit.join_quals.empty() || entry_count <= 0) {
+    return 0;
+  }
+  const int64_t max_entry_count = std::min(
+      static_cast<int64_t>(g_max_memory_allocation_size / query_mem_desc.getRowSize()),
+      static_cast<int64_t>(std::numeric_limits<int32_t>::max()));
+  if (entry_count >= max_entry_count) {
+    return 0;
+  }
+  return std::min(2 * entry_count, max_entry_count);
+}
+
 // column is part of the target expressions, result set iteration needs it alive.
 bool need_to_hold_chunk(const Chunk_NS::Chunk* chunk,
                         const RelAlgExecutionUnit& ra_exe_unit) {
@@ -75,6 +112,18 @@ const std::vector<uint64_t>& SharedKernelContext::getFragOffsets() {
 
 void SharedKernelContext::addDeviceResults(ResultSetPtr&& device_results,
                                            std::vector<size_t> outer_table_fragment_ids) {
+  if (external_sort_) {
+    if (!needs_skip_result(device_results)) {
+      external_sort_->addRun(std::move(device_results));
+    }
+    return;
+  }
+  if (streaming_reduction_) {
+    if (!needs_skip_result(device_results)) {
+      reduceDeviceResults(std::move(device_results), std::move(outer_table_fragment_ids));
+    }
+    return;
+  }
   std::lock_guard<std::mutex> lock(reduce_mutex_);
   if (!needs_skip_result(device_results)) {
     all_fragment_results_.emplace_back(std::move(device_results),
@@ -82,16 +131,158 @@ void SharedKernelContext::addDeviceResults(ResultSetPtr&& device_results,
   }
 }
 
+/**
+ * The results kept are the ones no kernel is reducing. A kernel takes one of them and
+ * reduces it into its own results, outside of the lock, until there is none left to
+ * take. The results kept are then at most one per kernel finishing at the same time,
+ * and the threads reducing don't start new kernels, which bounds the results in memory.
+ */
+void SharedKernelContext::reduceDeviceResults(
+    ResultSetPtr&& device_results,
+    std::vector<size_t> outer_table_fragment_ids) {
+  std::pair<ResultSetPtr, std::vector<size_t>> results{
+      std::move(device_results), std::move(outer_table_fragment_ids)};
+  while (true) {
+    std::pair<ResultSetPtr, std::vector<size_t>> that_results;
+    std::shared_ptr<ReductionCode> reduction_code;
+    {
+      std::lock_guard<std::mutex> lock(reduce_mutex_);
+      if (all_fragment_results_.empty() || streaming_reduction_error_) {
+        all_fragment_results_.push_back(std::move(results));
+        return;
+      }
+      that_results = std::move(all_fragment_results_.back());
+      all_fragment_results_.pop_back();
+      if (!reduction_code_) {
+        std::lock_guard<std::mutex> compilation_lock(Executor::compilation_mutex_);
+        ResultSetReductionJIT reduction_jit(results.first->getQueryMemDesc(),
+                                            results.first->getTargetInfos(),
+                                            results.first->getTargetInitVals());
+        reduction_code_ = std::make_shared<ReductionCode>(reduction_jit.codegen());
+      }
+      reduction_code = reduction_code_;
+    }
+    try {
+      results.first->getStorage()->reduce(
+          *that_results.first->getStorage(), {}, *reduction_code);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(reduce_mutex_);
+      streaming_reduction_error_ = std::current_exception();
+      return;
+    }
+    results.second.insert(
+        results.second.end(), that_results.second.begin(), that_results.second.end());
+  }
+}
+
+void SharedKernelContext::checkStreamingReduction() const {
+  if (streaming_reduction_error_) {
+    std::rethrow_exception(streaming_reduction_error_);
+  }
+}
+
 std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>&
 SharedKernelContext::getFragmentResults() {
   return all_fragment_results_;
 }
 
+namespace {
+
+metrics::Histogram& get_kernel_latency_histogram(const ExecutorDeviceType device_type) {
+  auto get_histogram = [](const std::string& device) -> metrics::Histogram& {
+    return metrics::Registry::instance().histogram(
+        "omnisci_kernel_latency_ms",
+        "Time taken by the execution kernels, in milliseconds.",
+        metrics::latency_ms_buckets(),
+        {{"device_type", device}});
+  };
+  static auto& cpu_histogram = get_histogram("CPU");
+  static auto& gpu_histogram = get_histogram("GPU");
+  return device_type == ExecutorDeviceType::GPU ? gpu_histogram : cpu_histogram;
+}
+
+void observe_gpu_timings(const CudaMgr_Namespace::GpuTimings& timings) {
+  auto get_histogram = [](const std::string& work) -> metrics::Histogram& {
+    return metrics::Registry::instance().histogram(
+        "omnisci_gpu_device_time_ms",
+        "Time taken on the GPUs by the kernels and the copies of the execution kernels, "
+        "in milliseconds.",
+        metrics::latency_ms_buckets(),
+        {{"work", work}});
+  };
+  auto get_counter = [](const std::string& direction) -> metrics::Counter& {
+    return metrics::Registry::instance().counter(
+        "omnisci_gpu_copied_bytes_total",
+        "Bytes copied to, from and between the GPUs by the execution kernels.",
+        {{"direction", direction}});
+  };
+  static auto& init_histogram = get_histogram("init");
+  static auto& kernel_histogram = get_histogram("kernel");
+  static auto& reduction_histogram = get_histogram("reduction");
+  static auto& host_to_device_histogram = get_histogram("host_to_device");
+  static auto& device_to_host_histogram = get_histogram("device_to_host");
+  static auto& device_to_device_histogram = get_histogram("device_to_device");
+  static auto& host_to_device_counter = get_counter("host_to_device");
+  static auto& device_to_host_counter = get_counter("device_to_host");
+  static auto& device_to_device_counter = get_counter("device_to_device");
+  if (timings.init_launches) {
+    init_histogram.observe(timings.init_ms);
+  }
+  if (timings.kernel_launches) {
+    kernel_histogram.observe(timings.kernel_ms);
+  }
+  if (timings.reduction_launches) {
+    reduction_histogram.observe(timings.reduction_ms);
+  }
+  if (timings.host_to_device_bytes) {
+    host_to_device_histogram.observe(timings.host_to_device_ms);
+    host_to_device_counter.inc(timings.host_to_device_bytes);
+  }
+  if (timings.device_to_host_bytes) {
+    device_to_host_histogram.observe(timings.device_to_host_ms);
+    device_to_host_counter.inc(timings.device_to_host_bytes);
+  }
+  if (timings.device_to_device_bytes) {
+    device_to_device_histogram.observe(timings.device_to_device_ms);
+    device_to_device_counter.inc(timings.device_to_device_bytes);
+  }
+}
+
+}  // namespace
+
 void ExecutionKernel::run(Executor* executor, SharedKernelContext& shared_context) {
   DEBUG_TIMER("ExecutionKernel::run");
   INJECT_TIMER(kernel_run);
   try {
+    const auto clock_begin = timer_start();
+    logger::PerfCounterValues perf_counters_begin;
+    const bool has_perf_counters =
+        g_enable_perf_counters && logger::read_thread_perf_counters(perf_counters_begin);
+    const bool has_gpu_timings =
+        g_enable_gpu_kernel_timing && chosen_device_type == ExecutorDeviceType::GPU;
+    const auto gpu_timings_begin = has_gpu_timings
+                                       ? CudaMgr_Namespace::read_thread_gpu_timings()
+                                       : CudaMgr_Namespace::GpuTimings{};
     runImpl(executor, shared_context);
+    get_kernel_latency_histogram(chosen_device_type)
+        .observe(timer_stop<std::chrono::steady_clock::time_point,
+                            std::chrono::microseconds>(clock_begin) /
+                 1000.);
+    // for a GPU kernel, these are the counters of the host thread driving it
+    logger::PerfCounterValues perf_counters_end;
+    if (has_perf_counters && logger::read_thread_perf_counters(perf_counters_end)) {
+      std::lock_guard<std::mutex> lock(executor->kernel_perf_counters_mutex_);
+      executor->kernel_perf_counters_ += perf_counters_end - perf_counters_begin;
+    }
+    if (has_gpu_timings) {
+      const auto gpu_timings =
+          CudaMgr_Namespace::read_thread_gpu_timings() - gpu_timings_begin;
+      observe_gpu_timings(gpu_timings);
+      std::lock_guard<std::mutex> lock(executor->kernel_gpu_timings_mutex_);
+      executor->kernel_gpu_timings_ += gpu_timings;
+    }
+  } catch (const QueryMemoryLimitExceeded& e) {
+    throw QueryExecutionError(Executor::ERR_QUERY_MEMORY_LIMIT, e.what());
   } catch (const OutOfHostMemory& e) {
     throw QueryExecutionError(Executor::ERR_OUT_OF_CPU_MEM, e.what());
   } catch (const std::bad_alloc& e) {
@@ -132,6 +323,24 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
   CHECK_GE(chosen_device_id, 0);
   CHECK_LT(chosen_device_id, Executor::max_gpu_count);
 
+  auto top_n_pruner = kernel_dispatch_mode == ExecutorDispatchMode::KernelPerFragment
+                          ? shared_context.getTopNFragmentPruner()
+                          : nullptr;
+  if (top_n_pruner && top_n_pruner->canSkip(frag_list)) {
+    VLOG(1) << "Skipping outer fragments past the top n threshold";
+    return;
+  }
+  const auto approximate_aggregate = shared_context.getApproximateAggregate();
+  if (approximate_aggregate && approximate_aggregate->isDone()) {
+    VLOG(1) << "Skipping outer fragments, the sampled aggregate is within its error";
+    return;
+  }
+  if (auto shared_scan = shared_context.getSharedScan()) {
+    if (!outer_tab_frag_ids.empty()) {
+      shared_scan->fragmentStarted(outer_tab_frag_ids.front());
+    }
+  }
+
   auto catalog = executor->getCatalog();
   CHECK(catalog);
 
@@ -141,8 +350,12 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
   std::unique_ptr<std::lock_guard<std::mutex>> gpu_lock;
   std::unique_ptr<CudaAllocator> device_allocator;
   if (chosen_device_type == ExecutorDeviceType::GPU) {
-    gpu_lock.reset(
-        new std::lock_guard<std::mutex>(executor->gpu_exec_mutex_[chosen_device_id]));
+    // with a stream per kernel, the columns of a kernel are fetched while the previous
+    // kernel on the device runs, the device is only locked from the launch on
+    if (!g_enable_gpu_kernel_streams) {
+      gpu_lock.reset(
+          new std::lock_guard<std::mutex>(executor->gpu_exec_mutex_[chosen_device_id]));
+    }
     device_allocator =
         std::make_unique<CudaAllocator>(&catalog->getDataMgr(), chosen_device_id);
   }
@@ -193,6 +406,10 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
             kernel_dispatch_mode == ExecutorDispatchMode::MultifragmentKernel});
     return;
   }
+  if (chosen_device_type == ExecutorDeviceType::GPU && !gpu_lock) {
+    gpu_lock.reset(
+        new std::lock_guard<std::mutex>(executor->gpu_exec_mutex_[chosen_device_id]));
+  }
 
   if (eo.executor_type == ExecutorType::Extern) {
     if (ra_exe_unit_.input_descs.size() > 1) {
@@ -218,6 +435,49 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
     shared_context.addDeviceResults(std::move(device_results_), outer_tab_frag_ids);
     return;
   }
+  if (eo.executor_type == ExecutorType::Interpreter) {
+    GroupByAndAggregate group_by_and_aggregate(executor,
+                                               ExecutorDeviceType::CPU,
+                                               ra_exe_unit_,
+                                               shared_context.getQueryInfos(),
+                                               executor->row_set_mem_owner_,
+                                               std::nullopt);
+    const auto query_mem_desc =
+        group_by_and_aggregate.initQueryMemoryDescriptor(false, 0, 8, nullptr, false);
+    device_results_ = expression_interpreter::run_projection(ra_exe_unit_,
+                                                             fetch_result,
+                                                             executor->plan_state_.get(),
+                                                             *query_mem_desc,
+                                                             executor);
+    shared_context.addDeviceResults(std::move(device_results_), outer_tab_frag_ids);
+    return;
+  }
+  // A CPU kernel only scans the outer rows in [start_rowid, outer row count).
+  uint32_t start_rowid{0};
+  if (chosen_device_type == ExecutorDeviceType::CPU &&
+      fetch_result.num_rows.size() == 1) {
+    auto& outer_row_count = fetch_result.num_rows.front().front();
+    if (rowid_lookup_key >= 0) {
+      const auto& all_frag_row_offsets = shared_context.getFragOffsets();
+      start_rowid = rowid_lookup_key -
+                    all_frag_row_offsets[frag_list.begin()->fragment_ids.front()];
+      outer_row_count = std::min(outer_row_count, int64_t(start_rowid) + 1);
+    } else if ((g_enable_sorted_chunk_indexes || g_enable_geo_grid_indexes) &&
+               kernel_dispatch_mode == ExecutorDispatchMode::KernelPerFragment &&
+               !ra_exe_unit_.union_all && outer_tab_frag_ids.size() == 1) {
+      const auto& outer_fragments = shared_context.getQueryInfos().front().info.fragments;
+      CHECK_LT(outer_tab_frag_ids.front(), outer_fragments.size());
+      const auto row_range = executor->getIndexedRowRange(
+          ra_exe_unit_, outer_fragments[outer_tab_frag_ids.front()]);
+      if (row_range) {
+        VLOG(2) << "Scanning rows [" << row_range->first << ", " << row_range->second
+                << ") of the outer fragment";
+        start_rowid = row_range->first;
+        outer_row_count = std::min(outer_row_count, int64_t(row_range->second));
+      }
+    }
+  }
+
   const CompilationResult& compilation_result = query_comp_desc.getCompilationResult();
   std::unique_ptr<QueryExecutionContext> query_exe_context_owned;
   const bool do_render = render_info_ && render_info_->isPotentialInSituRender();
@@ -246,75 +506,86 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
     }
   }
 
-  if (eo.executor_type == ExecutorType::Native) {
-    try {
-      query_exe_context_owned =
-          query_mem_desc.getQueryExecutionContext(ra_exe_unit_,
-                                                  executor,
-                                                  chosen_device_type,
-                                                  kernel_dispatch_mode,
-                                                  chosen_device_id,
-                                                  total_num_input_rows,
-                                                  fetch_result.col_buffers,
-                                                  fetch_result.frag_offsets,
-                                                  executor->getRowSetMemoryOwner(),
-                                                  compilation_result.output_columnar,
-                                                  query_mem_desc.sortOnGpu(),
-                                                  do_render ? render_info_ : nullptr);
-    } catch (const OutOfHostMemory& e) {
-      throw QueryExecutionError(Executor::ERR_OUT_OF_CPU_MEM);
-    }
-  }
-  QueryExecutionContext* query_exe_context{query_exe_context_owned.get()};
-  CHECK(query_exe_context);
   int32_t err{0};
-  uint32_t start_rowid{0};
-  if (rowid_lookup_key >= 0) {
-    if (!frag_list.empty()) {
-      const auto& all_frag_row_offsets = shared_context.getFragOffsets();
-      start_rowid = rowid_lookup_key -
-                    all_frag_row_offsets[frag_list.begin()->fragment_ids.front()];
+  while (true) {
+    if (eo.executor_type == ExecutorType::Native) {
+      try {
+        query_exe_context_owned =
+            query_mem_desc.getQueryExecutionContext(ra_exe_unit_,
+                                                    executor,
+                                                    chosen_device_type,
+                                                    kernel_dispatch_mode,
+                                                    chosen_device_id,
+                                                    total_num_input_rows,
+                                                    fetch_result.col_buffers,
+                                                    fetch_result.frag_offsets,
+                                                    executor->getRowSetMemoryOwner(),
+                                                    compilation_result.output_columnar,
+                                                    query_mem_desc.sortOnGpu(),
+                                                    do_render ? render_info_ : nullptr);
+      } catch (const OutOfHostMemory& e) {
+        throw QueryExecutionError(Executor::ERR_OUT_OF_CPU_MEM);
+      }
+    }
+    QueryExecutionContext* query_exe_context{query_exe_context_owned.get()};
+    CHECK(query_exe_context);
+    if (chosen_device_type == ExecutorDeviceType::GPU) {
+      query_exe_context->setMultiGpuReduction(shared_context.getMultiGpuReduction());
     }
-  }
 
-  if (ra_exe_unit_.groupby_exprs.empty()) {
-    err = executor->executePlanWithoutGroupBy(ra_exe_unit_,
-                                              compilation_result,
-                                              query_comp_desc.hoistLiterals(),
-                                              device_results_,
-                                              ra_exe_unit_.target_exprs,
-                                              chosen_device_type,
-                                              fetch_result.col_buffers,
-                                              query_exe_context,
-                                              fetch_result.num_rows,
-                                              fetch_result.frag_offsets,
-                                              &catalog->getDataMgr(),
-                                              chosen_device_id,
-                                              start_rowid,
-                                              ra_exe_unit_.input_descs.size(),
-                                              do_render ? render_info_ : nullptr);
-  } else {
-    if (ra_exe_unit_.union_all) {
-      VLOG(1) << "outer_table_id=" << outer_table_id
-              << " ra_exe_unit_.scan_limit=" << ra_exe_unit_.scan_limit;
+    if (ra_exe_unit_.groupby_exprs.empty()) {
+      err = executor->executePlanWithoutGroupBy(ra_exe_unit_,
+                                                compilation_result,
+                                                query_comp_desc.hoistLiterals(),
+                                                device_results_,
+                                                ra_exe_unit_.target_exprs,
+                                                chosen_device_type,
+                                                fetch_result.col_buffers,
+                                                query_exe_context,
+                                                fetch_result.num_rows,
+                                                fetch_result.frag_offsets,
+                                                &catalog->getDataMgr(),
+                                                chosen_device_id,
+                                                start_rowid,
+                                                ra_exe_unit_.input_descs.size(),
+                                                do_render ? render_info_ : nullptr);
+    } else {
+      if (ra_exe_unit_.union_all) {
+        VLOG(1) << "outer_table_id=" << outer_table_id
+                << " ra_exe_unit_.scan_limit=" << ra_exe_unit_.scan_limit;
+      }
+      err = executor->executePlanWithGroupBy(ra_exe_unit_,
+                                             compilation_result,
+                                             query_comp_desc.hoistLiterals(),
+                                             device_results_,
+                                             chosen_device_type,
+                                             fetch_result.col_buffers,
+                                             outer_tab_frag_ids,
+                                             query_exe_context,
+                                             fetch_result.num_rows,
+                                             fetch_result.frag_offsets,
+                                             &catalog->getDataMgr(),
+                                             chosen_device_id,
+                                             outer_table_id,
+                                             ra_exe_unit_.scan_limit,
+                                             start_rowid,
+                                             ra_exe_unit_.input_descs.size(),
+                                             do_render ? render_info_ : nullptr);
+    }
+    const auto grown_entry_count =
+        grown_bump_allocator_entry_count(err,
+                                         total_num_input_rows,
+                                         ra_exe_unit_,
+                                         query_mem_desc,
+                                         chosen_device_type,
+                                         kernel_dispatch_mode);
+    if (!grown_entry_count) {
+      break;
     }
-    err = executor->executePlanWithGroupBy(ra_exe_unit_,
-                                           compilation_result,
-                                           query_comp_desc.hoistLiterals(),
-                                           device_results_,
-                                           chosen_device_type,
-                                           fetch_result.col_buffers,
-                                           outer_tab_frag_ids,
-                                           query_exe_context,
-                                           fetch_result.num_rows,
-                                           fetch_result.frag_offsets,
-                                           &catalog->getDataMgr(),
-                                           chosen_device_id,
-                                           outer_table_id,
-                                           ra_exe_unit_.scan_limit,
-                                           start_rowid,
-                                           ra_exe_unit_.input_descs.size(),
-                                           do_render ? render_info_ : nullptr);
+    VLOG(1) << "Join output overflowed the bump allocator buffer of "
+            << total_num_input_rows << " entries, relaunching the fragment with "
+            << grown_entry_count;
+    total_num_input_rows = grown_entry_count;
   }
   if (device_results_) {
     std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_to_hold;
@@ -331,5 +602,11 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
   if (err) {
     throw QueryExecutionError(err);
   }
+  if (top_n_pruner && device_results_) {
+    top_n_pruner->addResult(*device_results_);
+  }
+  if (approximate_aggregate && device_results_) {
+    approximate_aggregate->addResult(frag_list, *device_results_);
+  }
   shared_context.addDeviceResults(std::move(device_results_), outer_tab_frag_ids);
 }
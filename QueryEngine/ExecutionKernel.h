@@ -16,9 +16,18 @@
 
 #pragma once
 
+#include <exception>
+
 #include "Logger/Logger.h"
+#include "QueryEngine/ApproximateAggregate.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/Descriptors/QueryCompilationDescriptor.h"
+#include "QueryEngine/ExternalSort.h"
+#include "QueryEngine/MultiGpuReduction.h"
+#include "QueryEngine/SharedScan.h"
+#include "QueryEngine/TopNFragmentPruner.h"
+
+struct ReductionCode;
 
 class SharedKernelContext {
  public:
@@ -34,15 +43,72 @@ class SharedKernelContext {
 
   const std::vector<InputTableInfo>& getQueryInfos() const { return query_infos_; }
 
+  void setTopNFragmentPruner(std::unique_ptr<TopNFragmentPruner> top_n_pruner) {
+    top_n_pruner_ = std::move(top_n_pruner);
+  }
+
+  TopNFragmentPruner* getTopNFragmentPruner() const { return top_n_pruner_.get(); }
+
+  // The results are spilled as the runs of the external sort instead of being kept.
+  void setExternalSort(std::unique_ptr<ExternalSort> external_sort) {
+    external_sort_ = std::move(external_sort);
+  }
+
+  ExternalSort* getExternalSort() const { return external_sort_.get(); }
+
+  // The group by buffers of the GPU kernels are reduced on a GPU instead of the host.
+  void setMultiGpuReduction(std::unique_ptr<MultiGpuReduction> multi_gpu_reduction) {
+    multi_gpu_reduction_ = std::move(multi_gpu_reduction);
+  }
+
+  MultiGpuReduction* getMultiGpuReduction() const { return multi_gpu_reduction_.get(); }
+
+  // The kernels report the fragments they start on to the concurrent scans of the table.
+  void setSharedScan(std::unique_ptr<SharedScan> shared_scan) {
+    shared_scan_ = std::move(shared_scan);
+  }
+
+  SharedScan* getSharedScan() const { return shared_scan_.get(); }
+
+  // The kernels add their aggregates to the sample and stop once it's big enough.
+  void setApproximateAggregate(
+      std::unique_ptr<ApproximateAggregate> approximate_aggregate) {
+    approximate_aggregate_ = std::move(approximate_aggregate);
+  }
+
+  ApproximateAggregate* getApproximateAggregate() const {
+    return approximate_aggregate_.get();
+  }
+
+  // The results of the kernels are reduced into each other as they are added, rather than
+  // all kept until the last kernel finishes. Only for the aggregates whose results have
+  // no other use than the final reduction.
+  void enableStreamingReduction() { streaming_reduction_ = true; }
+
+  // Rethrows the error of a reduction of the results as they were added, if any.
+  void checkStreamingReduction() const;
+
   std::atomic_flag dynamic_watchdog_set = ATOMIC_FLAG_INIT;
 
  private:
+  void reduceDeviceResults(ResultSetPtr&& device_results,
+                           std::vector<size_t> outer_table_fragment_ids);
+
   std::mutex reduce_mutex_;
   std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> all_fragment_results_;
 
   std::vector<uint64_t> all_frag_row_offsets_;
   std::mutex all_frag_row_offsets_mutex_;
   const std::vector<InputTableInfo>& query_infos_;
+  std::unique_ptr<TopNFragmentPruner> top_n_pruner_;
+  std::unique_ptr<ExternalSort> external_sort_;
+  std::unique_ptr<MultiGpuReduction> multi_gpu_reduction_;
+  std::unique_ptr<SharedScan> shared_scan_;
+  std::unique_ptr<ApproximateAggregate> approximate_aggregate_;
+
+  bool streaming_reduction_{false};
+  std::shared_ptr<ReductionCode> reduction_code_;
+  std::exception_ptr streaming_reduction_error_;
 };
 
 class ExecutionKernel {
@@ -72,6 +138,10 @@ class ExecutionKernel {
 
   void run(Executor* executor, SharedKernelContext& shared_context);
 
+  const FragmentsList& getFragmentList() const { return frag_list; }
+  ExecutorDeviceType getDeviceType() const { return chosen_device_type; }
+  int getDeviceId() const { return chosen_device_id; }
+
  private:
   const RelAlgExecutionUnit& ra_exe_unit_;
   const ExecutorDeviceType chosen_device_type;
@@ -0,0 +1,998 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ExpressionInterpreter.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <string>
+
+#include "Analyzer/Analyzer.h"
+#include "Catalog/Catalog.h"
+#include "Logger/Logger.h"
+#include "QueryEngine/ColumnFetcher.h"
+#include "QueryEngine/DateTruncate.h"
+#include "QueryEngine/ErrorHandling.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/ExtractFromTime.h"
+#include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/OutputBufferInitialization.h"
+#include "QueryEngine/PlanState.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "QueryEngine/ResultSet.h"
+#include "Shared/InlineNullValues.h"
+
+bool g_enable_expression_interpreter{false};
+size_t g_expression_interpreter_max_input_rows{100000};
+
+namespace expression_interpreter {
+
+namespace {
+
+// Rows evaluated at once, the values of a batch stay in cache from one node to the next.
+constexpr int64_t kBatchSize{1024};
+
+bool is_supported_type(const SQLTypeInfo& ti) {
+  switch (ti.get_compression()) {
+    case kENCODING_NONE:
+      return ti.is_integer() || ti.is_boolean() || ti.is_fp() || ti.is_decimal() ||
+             ti.is_time();
+    case kENCODING_FIXED:
+      return ti.is_integer() || ti.is_decimal() || ti.is_time();
+    case kENCODING_DATE_IN_DAYS:
+      return ti.get_type() == kDATE;
+    case kENCODING_DICT:
+      return ti.is_string() && ti.get_comp_param() > TRANSIENT_DICT_ID;
+    default:
+      return false;
+  }
+}
+
+// The literal under the casts which only change the encoding of its type, if any.
+const Analyzer::Constant* get_literal(const Analyzer::Expr* expr) {
+  auto uoper = dynamic_cast<const Analyzer::UOper*>(expr);
+  while (uoper && uoper->get_optype() == kCAST) {
+    const auto& ti = uoper->get_type_info();
+    const auto& operand_ti = uoper->get_operand()->get_type_info();
+    if (ti.get_type() != operand_ti.get_type() &&
+        !(ti.is_string() && operand_ti.is_string())) {
+      return nullptr;
+    }
+    expr = uoper->get_operand();
+    uoper = dynamic_cast<const Analyzer::UOper*>(expr);
+  }
+  return dynamic_cast<const Analyzer::Constant*>(expr);
+}
+
+// The operands of the arithmetic and of the comparisons are held the same way.
+bool are_compatible(const SQLTypeInfo& lhs_ti, const SQLTypeInfo& rhs_ti) {
+  if (lhs_ti.is_decimal() || rhs_ti.is_decimal()) {
+    return lhs_ti.is_decimal() && rhs_ti.is_decimal() &&
+           lhs_ti.get_scale() == rhs_ti.get_scale();
+  }
+  if (lhs_ti.is_time() || rhs_ti.is_time()) {
+    return lhs_ti.get_type() == rhs_ti.get_type() &&
+           lhs_ti.get_dimension() == rhs_ti.get_dimension();
+  }
+  return (lhs_ti.is_number() || lhs_ti.is_boolean()) &&
+         (rhs_ti.is_number() || rhs_ti.is_boolean());
+}
+
+bool is_supported(const Analyzer::Expr* expr, const Catalog_Namespace::Catalog& cat);
+
+// A dictionary encoded column, or a literal looked up in the dictionary of the column it
+// is compared to.
+bool is_string_operand(const Analyzer::Expr* expr,
+                       const Catalog_Namespace::Catalog& cat) {
+  if (!expr->get_type_info().is_string()) {
+    return false;
+  }
+  return get_literal(expr) || (dynamic_cast<const Analyzer::ColumnVar*>(expr) &&
+                               is_supported(expr, cat));
+}
+
+int get_dict_id(const Analyzer::Expr* expr) {
+  const auto& ti = expr->get_type_info();
+  return ti.get_compression() == kENCODING_DICT ? ti.get_comp_param() : 0;
+}
+
+bool is_supported_string_comparison(const Analyzer::BinOper* bin_oper,
+                                    const Catalog_Namespace::Catalog& cat) {
+  const auto lhs = bin_oper->get_left_operand();
+  const auto rhs = bin_oper->get_right_operand();
+  if ((bin_oper->get_optype() != kEQ && bin_oper->get_optype() != kNE) ||
+      !is_string_operand(lhs, cat) || !is_string_operand(rhs, cat)) {
+    return false;
+  }
+  if (!dynamic_cast<const Analyzer::ColumnVar*>(lhs) &&
+      !dynamic_cast<const Analyzer::ColumnVar*>(rhs)) {
+    return false;
+  }
+  const auto lhs_dict_id = get_dict_id(lhs);
+  const auto rhs_dict_id = get_dict_id(rhs);
+  return lhs_dict_id <= 0 || rhs_dict_id <= 0 || lhs_dict_id == rhs_dict_id;
+}
+
+bool is_supported_cast(const Analyzer::UOper* uoper,
+                       const Catalog_Namespace::Catalog& cat) {
+  const auto operand = uoper->get_operand();
+  const auto& ti = uoper->get_type_info();
+  const auto& operand_ti = operand->get_type_info();
+  if (ti.is_string()) {
+    // a string literal compared to a dictionary encoded column
+    return ti.get_compression() == kENCODING_DICT && get_literal(operand);
+  }
+  if (!is_supported_type(ti) || !is_supported(operand, cat)) {
+    return false;
+  }
+  if (ti.get_type() == operand_ti.get_type()) {
+    // only changes the encoding
+    return ti.get_scale() == operand_ti.get_scale() &&
+           ti.get_dimension() == operand_ti.get_dimension();
+  }
+  if (ti.is_integer()) {
+    return operand_ti.is_integer() || operand_ti.is_boolean();
+  }
+  if (ti.is_fp()) {
+    return operand_ti.is_integer() || operand_ti.is_fp();
+  }
+  return false;
+}
+
+bool is_supported_bin_oper(const Analyzer::BinOper* bin_oper,
+                           const Catalog_Namespace::Catalog& cat) {
+  const auto optype = bin_oper->get_optype();
+  if (bin_oper->get_qualifier() != kONE) {
+    return false;
+  }
+  const auto lhs = bin_oper->get_left_operand();
+  const auto rhs = bin_oper->get_right_operand();
+  const auto& lhs_ti = lhs->get_type_info();
+  const auto& rhs_ti = rhs->get_type_info();
+  if (lhs_ti.is_string() || rhs_ti.is_string()) {
+    return is_supported_string_comparison(bin_oper, cat);
+  }
+  if (!is_supported(lhs, cat) || !is_supported(rhs, cat)) {
+    return false;
+  }
+  if (IS_LOGIC(optype)) {
+    return lhs_ti.is_boolean() && rhs_ti.is_boolean();
+  }
+  if (optype == kEQ || optype == kNE || optype == kLT || optype == kLE ||
+      optype == kGT || optype == kGE) {
+    return are_compatible(lhs_ti, rhs_ti);
+  }
+  if (!IS_ARITHMETIC(optype) || lhs_ti.is_time() || rhs_ti.is_time() ||
+      !are_compatible(lhs_ti, rhs_ti)) {
+    return false;
+  }
+  const auto& ti = bin_oper->get_type_info();
+  if (ti.is_decimal()) {
+    // the scaled values are added and subtracted as they are
+    return (optype == kPLUS || optype == kMINUS) &&
+           ti.get_scale() == lhs_ti.get_scale();
+  }
+  if (ti.is_fp()) {
+    return optype != kMODULO;
+  }
+  return ti.is_integer();
+}
+
+bool is_supported_in_values(const Analyzer::InValues* in_values,
+                            const Catalog_Namespace::Catalog& cat) {
+  const auto arg = in_values->get_arg();
+  const auto& arg_ti = arg->get_type_info();
+  if (!is_supported(arg, cat)) {
+    return false;
+  }
+  for (const auto& value : in_values->get_value_list()) {
+    if (arg_ti.is_string()) {
+      if (!dynamic_cast<const Analyzer::ColumnVar*>(arg) ||
+          !value->get_type_info().is_string() || !get_literal(value.get())) {
+        return false;
+      }
+    } else if (!dynamic_cast<const Analyzer::Constant*>(value.get()) ||
+               value->get_type_info().get_type() != arg_ti.get_type() ||
+               !are_compatible(arg_ti, value->get_type_info())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// EXTRACT and DATE_TRUNC are evaluated over seconds, not over the high precision units.
+bool is_supported_datetime_operand(const Analyzer::Expr* from_expr,
+                                   const Catalog_Namespace::Catalog& cat) {
+  const auto& ti = from_expr->get_type_info();
+  return ti.is_time() && ti.get_dimension() == 0 && is_supported(from_expr, cat);
+}
+
+bool is_supported(const Analyzer::Expr* expr, const Catalog_Namespace::Catalog& cat) {
+  if (dynamic_cast<const Analyzer::Var*>(expr)) {
+    return false;
+  }
+  if (auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+    if (col_var->get_rte_idx() > 0 || !is_supported_type(col_var->get_type_info())) {
+      return false;
+    }
+    const auto cd = get_column_descriptor_maybe(
+        col_var->get_column_id(), col_var->get_table_id(), cat);
+    return cd && !cd->isVirtualCol;
+  }
+  if (auto constant = dynamic_cast<const Analyzer::Constant*>(expr)) {
+    return is_supported_type(constant->get_type_info()) &&
+           !constant->get_type_info().is_string();
+  }
+  if (auto likelihood = dynamic_cast<const Analyzer::LikelihoodExpr*>(expr)) {
+    return is_supported(likelihood->get_arg(), cat);
+  }
+  if (auto uoper = dynamic_cast<const Analyzer::UOper*>(expr)) {
+    const auto operand = uoper->get_operand();
+    switch (uoper->get_optype()) {
+      case kNOT:
+        return operand->get_type_info().is_boolean() && is_supported(operand, cat);
+      case kISNULL:
+        return is_supported(operand, cat);
+      case kUMINUS:
+        return !operand->get_type_info().is_time() &&
+               !operand->get_type_info().is_boolean() && is_supported(operand, cat);
+      case kCAST:
+        return is_supported_cast(uoper, cat);
+      default:
+        return false;
+    }
+  }
+  if (auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr)) {
+    return is_supported_bin_oper(bin_oper, cat);
+  }
+  if (auto in_values = dynamic_cast<const Analyzer::InValues*>(expr)) {
+    return is_supported_in_values(in_values, cat);
+  }
+  if (auto extract = dynamic_cast<const Analyzer::ExtractExpr*>(expr)) {
+    return is_supported_datetime_operand(extract->get_from_expr(), cat);
+  }
+  if (auto datetrunc = dynamic_cast<const Analyzer::DatetruncExpr*>(expr)) {
+    return is_supported_datetime_operand(datetrunc->get_from_expr(), cat);
+  }
+  return false;
+}
+
+// The values of an expression over a batch of rows. Integers, booleans, decimals, times
+// and dictionary ids are held as 64-bit integers, floats and doubles as doubles.
+struct Values {
+  Values(const size_t count, const bool fp) : is_fp(fp), nulls(count, 0) {
+    if (is_fp) {
+      fps.resize(count);
+    } else {
+      ints.resize(count);
+    }
+  }
+
+  void promoteToFp() {
+    if (!is_fp) {
+      fps.assign(ints.begin(), ints.end());
+      ints.clear();
+      is_fp = true;
+    }
+  }
+
+  bool is_fp;
+  std::vector<int64_t> ints;
+  std::vector<double> fps;
+  std::vector<int8_t> nulls;
+};
+
+template <typename T>
+void read_ints(const int8_t* col_buffer,
+               const int64_t* rows,
+               const int64_t null_val,
+               Values& values) {
+  const auto col = reinterpret_cast<const T*>(col_buffer);
+  for (size_t i = 0; i < values.ints.size(); ++i) {
+    const int64_t val = col[rows[i]];
+    values.nulls[i] = val == null_val;
+    values.ints[i] = val;
+  }
+}
+
+template <typename T>
+void read_fps(const int8_t* col_buffer, const int64_t* rows, Values& values) {
+  const auto col = reinterpret_cast<const T*>(col_buffer);
+  for (size_t i = 0; i < values.fps.size(); ++i) {
+    const auto val = col[rows[i]];
+    values.nulls[i] = val == inline_fp_null_value<T>();
+    values.fps[i] = val;
+  }
+}
+
+template <typename T>
+void compare(const SQLOps optype,
+             const std::vector<T>& lhs,
+             const std::vector<T>& rhs,
+             std::vector<int64_t>& result) {
+  const auto count = result.size();
+  switch (optype) {
+    case kEQ:
+      for (size_t i = 0; i < count; ++i) {
+        result[i] = lhs[i] == rhs[i];
+      }
+      break;
+    case kNE:
+      for (size_t i = 0; i < count; ++i) {
+        result[i] = lhs[i] != rhs[i];
+      }
+      break;
+    case kLT:
+      for (size_t i = 0; i < count; ++i) {
+        result[i] = lhs[i] < rhs[i];
+      }
+      break;
+    case kLE:
+      for (size_t i = 0; i < count; ++i) {
+        result[i] = lhs[i] <= rhs[i];
+      }
+      break;
+    case kGT:
+      for (size_t i = 0; i < count; ++i) {
+        result[i] = lhs[i] > rhs[i];
+      }
+      break;
+    case kGE:
+      for (size_t i = 0; i < count; ++i) {
+        result[i] = lhs[i] >= rhs[i];
+      }
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+int64_t get_int_literal(const Analyzer::Constant* constant) {
+  const auto datum = constant->get_constval();
+  switch (constant->get_type_info().get_type()) {
+    case kBOOLEAN:
+      return datum.boolval;
+    case kTINYINT:
+      return datum.tinyintval;
+    case kSMALLINT:
+      return datum.smallintval;
+    case kINT:
+      return datum.intval;
+    default:
+      return datum.bigintval;
+  }
+}
+
+void write_slot(int8_t* slot, const int8_t width, const int64_t val) {
+  switch (width) {
+    case 1:
+      *slot = static_cast<int8_t>(val);
+      break;
+    case 2:
+      *reinterpret_cast<int16_t*>(slot) = static_cast<int16_t>(val);
+      break;
+    case 4:
+      *reinterpret_cast<int32_t*>(slot) = static_cast<int32_t>(val);
+      break;
+    case 8:
+      *reinterpret_cast<int64_t*>(slot) = val;
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+class Interpreter {
+ public:
+  Interpreter(const std::vector<const int8_t*>& col_buffers,
+              const PlanState* plan_state,
+              Executor* executor)
+      : col_buffers_(col_buffers), plan_state_(plan_state), executor_(executor) {}
+
+  Values eval(const Analyzer::Expr* expr, const int64_t* rows, const size_t count) {
+    if (auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+      return evalColumn(col_var, rows, count);
+    }
+    if (auto constant = dynamic_cast<const Analyzer::Constant*>(expr)) {
+      return evalConstant(constant, count);
+    }
+    if (auto likelihood = dynamic_cast<const Analyzer::LikelihoodExpr*>(expr)) {
+      return eval(likelihood->get_arg(), rows, count);
+    }
+    if (auto uoper = dynamic_cast<const Analyzer::UOper*>(expr)) {
+      return evalUOper(uoper, rows, count);
+    }
+    if (auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr)) {
+      return evalBinOper(bin_oper, rows, count);
+    }
+    if (auto in_values = dynamic_cast<const Analyzer::InValues*>(expr)) {
+      return evalInValues(in_values, rows, count);
+    }
+    if (auto extract = dynamic_cast<const Analyzer::ExtractExpr*>(expr)) {
+      auto values = evalDatetimeOperand(extract->get_from_expr(), rows, count);
+      ExtractFromTimeBatch(
+          extract->get_field(), values.ints.data(), values.ints.data(), count);
+      return values;
+    }
+    if (auto datetrunc = dynamic_cast<const Analyzer::DatetruncExpr*>(expr)) {
+      auto values = evalDatetimeOperand(datetrunc->get_from_expr(), rows, count);
+      DateTruncateBatch(
+          datetrunc->get_field(), values.ints.data(), values.ints.data(), count);
+      return values;
+    }
+    CHECK(false) << "Unexpected expression " << expr->toString();
+    return Values(0, false);
+  }
+
+  // Keeps the rows for which `qual` is true, or for which it isn't when `negate` is set.
+  void filter(const Analyzer::Expr* qual, std::vector<int64_t>& rows, const bool negate) {
+    const auto values = eval(qual, rows.data(), rows.size());
+    size_t kept{0};
+    for (size_t i = 0; i < rows.size(); ++i) {
+      const bool is_true = !values.nulls[i] && values.ints[i];
+      rows[kept] = rows[i];
+      kept += is_true != negate;
+    }
+    rows.resize(kept);
+  }
+
+ private:
+  Values evalColumn(const Analyzer::ColumnVar* col_var,
+                    const int64_t* rows,
+                    const size_t count) {
+    const auto& ti = col_var->get_type_info();
+    const InputColDescriptor col_desc(
+        col_var->get_column_id(), col_var->get_table_id(), 0);
+    const auto it = plan_state_->global_to_local_col_ids_.find(col_desc);
+    CHECK(it != plan_state_->global_to_local_col_ids_.end());
+    CHECK_LT(it->second, col_buffers_.size());
+    const auto col_buffer = col_buffers_[it->second];
+    Values values(count, ti.is_fp());
+    if (ti.get_type() == kFLOAT) {
+      read_fps<float>(col_buffer, rows, values);
+      return values;
+    }
+    if (ti.get_type() == kDOUBLE) {
+      read_fps<double>(col_buffer, rows, values);
+      return values;
+    }
+    const auto null_val = inline_fixed_encoding_null_val(ti);
+    if (ti.is_date_in_days()) {
+      if (ti.get_comp_param() == 16) {
+        read_ints<int16_t>(col_buffer, rows, null_val, values);
+      } else {
+        read_ints<int32_t>(col_buffer, rows, null_val, values);
+      }
+      for (auto& val : values.ints) {
+        val *= kSecsPerDay;
+      }
+      return values;
+    }
+    // dictionary ids on less than 4 bytes are unsigned
+    const bool is_unsigned = ti.is_string() && ti.get_size() < 4;
+    switch (ti.get_size()) {
+      case 1:
+        is_unsigned ? read_ints<uint8_t>(col_buffer, rows, null_val, values)
+                    : read_ints<int8_t>(col_buffer, rows, null_val, values);
+        break;
+      case 2:
+        is_unsigned ? read_ints<uint16_t>(col_buffer, rows, null_val, values)
+                    : read_ints<int16_t>(col_buffer, rows, null_val, values);
+        break;
+      case 4:
+        read_ints<int32_t>(col_buffer, rows, null_val, values);
+        break;
+      case 8:
+        read_ints<int64_t>(col_buffer, rows, null_val, values);
+        break;
+      default:
+        CHECK(false) << "Unexpected width " << ti.get_size();
+    }
+    return values;
+  }
+
+  Values evalConstant(const Analyzer::Constant* constant, const size_t count) {
+    const auto& ti = constant->get_type_info();
+    Values values(count, ti.is_fp());
+    if (constant->get_is_null()) {
+      std::fill(values.nulls.begin(), values.nulls.end(), 1);
+    } else if (ti.is_fp()) {
+      const auto datum = constant->get_constval();
+      std::fill(values.fps.begin(),
+                values.fps.end(),
+                ti.get_type() == kFLOAT ? datum.floatval : datum.doubleval);
+    } else {
+      std::fill(values.ints.begin(), values.ints.end(), get_int_literal(constant));
+    }
+    return values;
+  }
+
+  // The id of a string literal in the dictionary `dict_id`.
+  Values evalStringLiteral(const Analyzer::Expr* expr,
+                           const int dict_id,
+                           const size_t count) {
+    const auto literal = get_literal(expr);
+    CHECK(literal);
+    Values values(count, false);
+    if (literal->get_is_null()) {
+      std::fill(values.nulls.begin(), values.nulls.end(), 1);
+      return values;
+    }
+    CHECK_GT(dict_id, 0);
+    const auto& str = *literal->get_constval().stringval;
+    auto it = string_ids_.find({dict_id, str});
+    if (it == string_ids_.end()) {
+      const auto sdp = executor_->getStringDictionaryProxy(
+          dict_id, executor_->getRowSetMemoryOwner(), true);
+      CHECK(sdp);
+      it = string_ids_.emplace(std::make_pair(dict_id, str), sdp->getIdOfString(str))
+               .first;
+    }
+    std::fill(values.ints.begin(), values.ints.end(), it->second);
+    return values;
+  }
+
+  Values evalStringOperand(const Analyzer::Expr* expr,
+                           const int dict_id,
+                           const int64_t* rows,
+                           const size_t count) {
+    if (dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+      return eval(expr, rows, count);
+    }
+    return evalStringLiteral(expr, dict_id, count);
+  }
+
+  // The seconds of a time operand, with zeroes in place of the nulls for the batch
+  // kernels of ExtractFromTime and DateTruncate.
+  Values evalDatetimeOperand(const Analyzer::Expr* from_expr,
+                             const int64_t* rows,
+                             const size_t count) {
+    auto values = eval(from_expr, rows, count);
+    CHECK(!values.is_fp);
+    for (size_t i = 0; i < count; ++i) {
+      values.ints[i] = values.nulls[i] ? 0 : values.ints[i];
+    }
+    return values;
+  }
+
+  Values evalUOper(const Analyzer::UOper* uoper,
+                   const int64_t* rows,
+                   const size_t count) {
+    if (uoper->get_optype() == kCAST) {
+      return evalCast(uoper, rows, count);
+    }
+    auto values = eval(uoper->get_operand(), rows, count);
+    switch (uoper->get_optype()) {
+      case kNOT:
+        for (auto& val : values.ints) {
+          val = !val;
+        }
+        break;
+      case kUMINUS:
+        if (values.is_fp) {
+          for (auto& val : values.fps) {
+            val = -val;
+          }
+        } else {
+          // the values are past the null sentinel, their negation doesn't overflow
+          for (auto& val : values.ints) {
+            val = -val;
+          }
+        }
+        break;
+      case kISNULL: {
+        Values is_null(count, false);
+        std::copy(values.nulls.begin(), values.nulls.end(), is_null.ints.begin());
+        return is_null;
+      }
+      default:
+        CHECK(false);
+    }
+    return values;
+  }
+
+  Values evalCast(const Analyzer::UOper* uoper, const int64_t* rows, const size_t count) {
+    const auto& ti = uoper->get_type_info();
+    const auto operand = uoper->get_operand();
+    if (ti.is_string()) {
+      return evalStringLiteral(operand, ti.get_comp_param(), count);
+    }
+    auto values = eval(operand, rows, count);
+    const auto& operand_ti = operand->get_type_info();
+    if (ti.is_fp()) {
+      values.promoteToFp();
+      if (ti.get_type() == kFLOAT && operand_ti.get_type() != kFLOAT) {
+        for (auto& val : values.fps) {
+          val = static_cast<float>(val);
+        }
+      }
+    } else if (ti.get_type() != operand_ti.get_type()) {
+      checkRange(values, ti);
+    }
+    return values;
+  }
+
+  Values evalBinOper(const Analyzer::BinOper* bin_oper,
+                     const int64_t* rows,
+                     const size_t count) {
+    const auto optype = bin_oper->get_optype();
+    const auto lhs_expr = bin_oper->get_left_operand();
+    const auto rhs_expr = bin_oper->get_right_operand();
+    if (lhs_expr->get_type_info().is_string()) {
+      const auto dict_id = std::max(get_dict_id(lhs_expr), get_dict_id(rhs_expr));
+      auto lhs = evalStringOperand(lhs_expr, dict_id, rows, count);
+      auto rhs = evalStringOperand(rhs_expr, dict_id, rows, count);
+      return evalComparison(optype, lhs, rhs);
+    }
+    auto lhs = eval(lhs_expr, rows, count);
+    auto rhs = eval(rhs_expr, rows, count);
+    if (IS_LOGIC(optype)) {
+      return evalLogical(optype, lhs, rhs);
+    }
+    if (IS_ARITHMETIC(optype)) {
+      return evalArithmetic(optype, bin_oper->get_type_info(), lhs, rhs);
+    }
+    return evalComparison(optype, lhs, rhs);
+  }
+
+  Values evalComparison(const SQLOps optype, Values& lhs, Values& rhs) {
+    const auto count = lhs.nulls.size();
+    Values result(count, false);
+    for (size_t i = 0; i < count; ++i) {
+      result.nulls[i] = lhs.nulls[i] | rhs.nulls[i];
+    }
+    if (lhs.is_fp || rhs.is_fp) {
+      lhs.promoteToFp();
+      rhs.promoteToFp();
+      compare(optype, lhs.fps, rhs.fps, result.ints);
+    } else {
+      compare(optype, lhs.ints, rhs.ints, result.ints);
+    }
+    return result;
+  }
+
+  // Three-valued AND and OR: a false operand of AND or a true operand of OR decides the
+  // result even if the other operand is null.
+  Values evalLogical(const SQLOps optype, const Values& lhs, const Values& rhs) {
+    const auto count = lhs.nulls.size();
+    Values result(count, false);
+    const int64_t decisive = optype == kOR;
+    for (size_t i = 0; i < count; ++i) {
+      const bool lhs_decides = !lhs.nulls[i] && lhs.ints[i] == decisive;
+      const bool rhs_decides = !rhs.nulls[i] && rhs.ints[i] == decisive;
+      if (lhs_decides || rhs_decides) {
+        result.ints[i] = decisive;
+      } else {
+        result.nulls[i] = lhs.nulls[i] | rhs.nulls[i];
+        result.ints[i] = !decisive;
+      }
+    }
+    return result;
+  }
+
+  Values evalArithmetic(const SQLOps optype,
+                        const SQLTypeInfo& ti,
+                        Values& lhs,
+                        Values& rhs) {
+    const auto count = lhs.nulls.size();
+    Values result(count, ti.is_fp());
+    for (size_t i = 0; i < count; ++i) {
+      result.nulls[i] = lhs.nulls[i] | rhs.nulls[i];
+    }
+    if (ti.is_fp()) {
+      lhs.promoteToFp();
+      rhs.promoteToFp();
+      for (size_t i = 0; i < count; ++i) {
+        if (result.nulls[i]) {
+          continue;
+        }
+        const auto x = lhs.fps[i];
+        const auto y = rhs.fps[i];
+        switch (optype) {
+          case kPLUS:
+            result.fps[i] = x + y;
+            break;
+          case kMINUS:
+            result.fps[i] = x - y;
+            break;
+          case kMULTIPLY:
+            result.fps[i] = x * y;
+            break;
+          case kDIVIDE:
+            if (y == 0) {
+              throw QueryExecutionError(Executor::ERR_DIV_BY_ZERO);
+            }
+            result.fps[i] = x / y;
+            break;
+          default:
+            CHECK(false);
+        }
+        if (ti.get_type() == kFLOAT) {
+          result.fps[i] = static_cast<float>(result.fps[i]);
+        }
+      }
+      return result;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (result.nulls[i]) {
+        continue;
+      }
+      const auto x = lhs.ints[i];
+      const auto y = rhs.ints[i];
+      bool overflow{false};
+      switch (optype) {
+        case kPLUS:
+          overflow = __builtin_add_overflow(x, y, &result.ints[i]);
+          break;
+        case kMINUS:
+          overflow = __builtin_sub_overflow(x, y, &result.ints[i]);
+          break;
+        case kMULTIPLY:
+          overflow = __builtin_mul_overflow(x, y, &result.ints[i]);
+          break;
+        case kDIVIDE:
+        case kMODULO:
+          if (y == 0) {
+            throw QueryExecutionError(Executor::ERR_DIV_BY_ZERO);
+          }
+          overflow = x == std::numeric_limits<int64_t>::min() && y == -1;
+          if (!overflow) {
+            result.ints[i] = optype == kDIVIDE ? x / y : x % y;
+          }
+          break;
+        default:
+          CHECK(false);
+      }
+      if (overflow) {
+        throw QueryExecutionError(Executor::ERR_OVERFLOW_OR_UNDERFLOW);
+      }
+    }
+    checkRange(result, ti);
+    return result;
+  }
+
+  Values evalInValues(const Analyzer::InValues* in_values,
+                      const int64_t* rows,
+                      const size_t count) {
+    const auto arg = in_values->get_arg();
+    auto values = eval(arg, rows, count);
+    const auto dict_id = get_dict_id(arg);
+    bool has_null{false};
+    std::vector<int64_t> int_list;
+    std::vector<double> fp_list;
+    for (const auto& value_expr : in_values->get_value_list()) {
+      auto value = arg->get_type_info().is_string()
+                       ? evalStringLiteral(value_expr.get(), dict_id, 1)
+                       : eval(value_expr.get(), nullptr, 1);
+      if (value.nulls.front()) {
+        has_null = true;
+      } else if (value.is_fp) {
+        fp_list.push_back(value.fps.front());
+      } else {
+        int_list.push_back(value.ints.front());
+      }
+    }
+    Values result(count, false);
+    for (size_t i = 0; i < count; ++i) {
+      if (values.nulls[i]) {
+        result.nulls[i] = 1;
+        continue;
+      }
+      const bool found =
+          values.is_fp
+              ? std::find(fp_list.begin(), fp_list.end(), values.fps[i]) != fp_list.end()
+              : std::find(int_list.begin(), int_list.end(), values.ints[i]) !=
+                    int_list.end();
+      // without a match, x IN (..., NULL) is null
+      result.ints[i] = found;
+      result.nulls[i] = !found && has_null;
+    }
+    return result;
+  }
+
+  // Integers out of the range of their type, or on its null sentinel, overflow.
+  void checkRange(const Values& values, const SQLTypeInfo& ti) {
+    if (!ti.is_integer() && !ti.is_decimal()) {
+      return;
+    }
+    const auto limits = inline_int_max_min(get_logical_type_info(ti).get_logical_size());
+    for (size_t i = 0; i < values.ints.size(); ++i) {
+      if (!values.nulls[i] &&
+          (values.ints[i] > limits.first || values.ints[i] <= limits.second)) {
+        throw QueryExecutionError(Executor::ERR_OVERFLOW_OR_UNDERFLOW);
+      }
+    }
+  }
+
+  const std::vector<const int8_t*>& col_buffers_;
+  const PlanState* plan_state_;
+  Executor* executor_;
+  std::map<std::pair<int, std::string>, int64_t> string_ids_;
+};
+
+void write_target(int8_t* slot,
+                  const int8_t width,
+                  const SQLTypeInfo& ti,
+                  const Values& values,
+                  const size_t i,
+                  const bool logical_sized_floats) {
+  if (ti.is_fp()) {
+    if (ti.get_type() == kFLOAT && (width == sizeof(float) || logical_sized_floats)) {
+      *reinterpret_cast<float*>(slot) =
+          values.nulls[i] ? inline_fp_null_value<float>() : values.fps[i];
+    } else {
+      *reinterpret_cast<double*>(slot) =
+          values.nulls[i] ? (ti.get_type() == kFLOAT ? inline_fp_null_value<float>()
+                                                     : inline_fp_null_value<double>())
+                          : values.fps[i];
+    }
+    return;
+  }
+  write_slot(slot,
+             width,
+             values.nulls[i] ? inline_int_null_val(get_logical_type_info(ti))
+                             : values.ints[i]);
+}
+
+}  // namespace
+
+bool can_interpret(const RelAlgExecutionUnit& ra_exe_unit,
+                   const std::vector<InputTableInfo>& table_infos,
+                   const ExecutorDeviceType device_type,
+                   const Catalog_Namespace::Catalog& cat) {
+  if (!g_enable_expression_interpreter || device_type != ExecutorDeviceType::CPU) {
+    return false;
+  }
+  if (ra_exe_unit.input_descs.size() != 1 || table_infos.size() != 1 ||
+      ra_exe_unit.input_descs.front().getSourceType() != InputSourceType::TABLE ||
+      !ra_exe_unit.join_quals.empty() || ra_exe_unit.estimator ||
+      ra_exe_unit.union_all) {
+    return false;
+  }
+  // a projection, whose top n, if any, is sorted after the step
+  if (ra_exe_unit.groupby_exprs.size() != 1 || ra_exe_unit.groupby_exprs.front() ||
+      ra_exe_unit.sort_info.algorithm == SortAlgorithm::StreamingTopN) {
+    return false;
+  }
+  if (table_infos.front().info.getNumTuplesUpperBound() >
+      g_expression_interpreter_max_input_rows) {
+    return false;
+  }
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    if (!is_supported(target_expr, cat) ||
+        !is_supported_type(target_expr->get_type_info())) {
+      return false;
+    }
+  }
+  for (const auto quals : {&ra_exe_unit.simple_quals, &ra_exe_unit.quals}) {
+    for (const auto& qual : *quals) {
+      if (!qual->get_type_info().is_boolean() || !is_supported(qual.get(), cat)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<ResultSet> run_projection(const RelAlgExecutionUnit& ra_exe_unit,
+                                          const FetchResult& fetch_result,
+                                          const PlanState* plan_state,
+                                          const QueryMemoryDescriptor& query_mem_desc,
+                                          Executor* executor) {
+  CHECK(plan_state);
+  CHECK_EQ(ra_exe_unit.input_descs.size(), size_t(1));
+  CHECK(!query_mem_desc.didOutputColumnar());
+  const auto table_id = ra_exe_unit.input_descs.front().getTableId();
+  std::shared_ptr<Analyzer::ColumnVar> deleted_col;
+  const auto deleted_it = plan_state->deleted_columns_.find(table_id);
+  if (deleted_it != plan_state->deleted_columns_.end()) {
+    deleted_col = std::make_shared<Analyzer::ColumnVar>(
+        deleted_it->second->columnType, table_id, deleted_it->second->columnId, 0);
+  }
+  std::vector<const Analyzer::Expr*> quals;
+  for (const auto& qual : ra_exe_unit.simple_quals) {
+    quals.push_back(qual.get());
+  }
+  for (const auto& qual : ra_exe_unit.quals) {
+    quals.push_back(qual.get());
+  }
+
+  // the rows of each fragment which pass the filter
+  const size_t scan_limit = ra_exe_unit.scan_limit
+                                ? ra_exe_unit.scan_limit
+                                : std::numeric_limits<size_t>::max();
+  std::vector<std::vector<int64_t>> selected_rows(fetch_result.col_buffers.size());
+  size_t entry_count{0};
+  for (size_t frag_idx = 0;
+       frag_idx < fetch_result.col_buffers.size() && entry_count < scan_limit;
+       ++frag_idx) {
+    CHECK_LT(frag_idx, fetch_result.num_rows.size());
+    CHECK(!fetch_result.num_rows[frag_idx].empty());
+    const auto num_rows = fetch_result.num_rows[frag_idx].front();
+    Interpreter interpreter(fetch_result.col_buffers[frag_idx], plan_state, executor);
+    auto& selected = selected_rows[frag_idx];
+    std::vector<int64_t> batch;
+    for (int64_t begin = 0;
+         begin < num_rows && entry_count + selected.size() < scan_limit;
+         begin += kBatchSize) {
+      batch.resize(std::min(kBatchSize, num_rows - begin));
+      std::iota(batch.begin(), batch.end(), begin);
+      if (deleted_col) {
+        interpreter.filter(deleted_col.get(), batch, true);
+      }
+      for (const auto qual : quals) {
+        if (batch.empty()) {
+          break;
+        }
+        interpreter.filter(qual, batch, false);
+      }
+      const auto room = scan_limit - entry_count - selected.size();
+      selected.insert(
+          selected.end(), batch.begin(), batch.begin() + std::min(batch.size(), room));
+    }
+    entry_count += selected.size();
+  }
+
+  auto output_mem_desc = query_mem_desc;
+  output_mem_desc.setEntryCount(entry_count);
+  auto rs = std::make_unique<ResultSet>(
+      target_exprs_to_infos(ra_exe_unit.target_exprs, output_mem_desc),
+      ExecutorDeviceType::CPU,
+      output_mem_desc,
+      executor->getRowSetMemoryOwner(),
+      executor);
+  const auto storage = rs->allocateStorage();
+  auto output_buffer = storage->getUnderlyingBuffer();
+  CHECK(!entry_count || output_buffer);
+  CHECK_EQ(output_mem_desc.getSlotCount(), ra_exe_unit.target_exprs.size());
+  const auto row_size = output_mem_desc.getRowSize();
+  const bool logical_sized_floats = output_mem_desc.isLogicalSizedColumnsAllowed();
+  size_t entry_idx{0};
+  for (size_t frag_idx = 0; frag_idx < selected_rows.size(); ++frag_idx) {
+    const auto& selected = selected_rows[frag_idx];
+    Interpreter interpreter(fetch_result.col_buffers[frag_idx], plan_state, executor);
+    for (size_t begin = 0; begin < selected.size(); begin += kBatchSize) {
+      const auto count = std::min(size_t(kBatchSize), selected.size() - begin);
+      // the key of a projected row is its offset in quads, as the generated code sets it
+      for (size_t i = 0; i < count; ++i) {
+        const auto off = (entry_idx + i) * row_size;
+        *reinterpret_cast<int64_t*>(output_buffer + off) = off / sizeof(int64_t);
+      }
+      for (size_t target_idx = 0; target_idx < ra_exe_unit.target_exprs.size();
+           ++target_idx) {
+        const auto target_expr = ra_exe_unit.target_exprs[target_idx];
+        const auto values = interpreter.eval(target_expr, &selected[begin], count);
+        const auto col_off = output_mem_desc.getColOffInBytes(target_idx);
+        const auto width = output_mem_desc.getPaddedSlotWidthBytes(target_idx);
+        for (size_t i = 0; i < count; ++i) {
+          write_target(output_buffer + (entry_idx + i) * row_size + col_off,
+                       width,
+                       target_expr->get_type_info(),
+                       values,
+                       i,
+                       logical_sized_floats);
+        }
+      }
+      entry_idx += count;
+    }
+  }
+  CHECK_EQ(entry_idx, entry_count);
+  return rs;
+}
+
+}  // namespace expression_interpreter
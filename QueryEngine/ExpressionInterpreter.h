@@ -0,0 +1,69 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ExpressionInterpreter.h
+ * @brief   Runs the projections of small tables on CPU without generating code.
+ *
+ * For a step over a few thousand rows, generating and optimizing the module of the
+ * filter count and of the projection takes far longer than the scan itself. A step which
+ * only filters and projects the columns of one small table is interpreted over the
+ * fetched columns instead: the filter narrows a selection vector a batch of rows at a
+ * time, then the targets are evaluated over the rows left. Steps with expressions the
+ * interpreter doesn't know keep running the generated code.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "QueryEngine/CompilationOptions.h"
+
+extern bool g_enable_expression_interpreter;
+extern size_t g_expression_interpreter_max_input_rows;
+
+namespace Catalog_Namespace {
+class Catalog;
+}  // namespace Catalog_Namespace
+
+class Executor;
+struct FetchResult;
+struct InputTableInfo;
+struct PlanState;
+class QueryMemoryDescriptor;
+struct RelAlgExecutionUnit;
+class ResultSet;
+
+namespace expression_interpreter {
+
+// Whether the step is a projection of at most g_expression_interpreter_max_input_rows
+// rows of a table, with a filter and targets the interpreter can evaluate.
+bool can_interpret(const RelAlgExecutionUnit& ra_exe_unit,
+                   const std::vector<InputTableInfo>& table_infos,
+                   const ExecutorDeviceType device_type,
+                   const Catalog_Namespace::Catalog& cat);
+
+// Projects the rows of the fetched fragments which pass the filter of the step, up to
+// its scan limit.
+std::unique_ptr<ResultSet> run_projection(const RelAlgExecutionUnit& ra_exe_unit,
+                                          const FetchResult& fetch_result,
+                                          const PlanState* plan_state,
+                                          const QueryMemoryDescriptor& query_mem_desc,
+                                          Executor* executor);
+
+}  // namespace expression_interpreter
@@ -790,7 +790,12 @@ ExpressionRange getExpressionRange(
   }
   const auto arg_range =
       getExpressionRange(u_expr->get_operand(), query_infos, executor, simple_quals);
-  const auto& arg_ti = u_expr->get_operand()->get_type_info();
+  return getCastRange(arg_range, u_expr->get_operand()->get_type_info(), ti);
+}
+
+ExpressionRange getCastRange(const ExpressionRange& arg_range,
+                             const SQLTypeInfo& arg_ti,
+                             const SQLTypeInfo& ti) {
   // Timestamp to Date OR Date/Timestamp casts with different precision
   if ((ti.is_timestamp() && (arg_ti.get_dimension() != ti.get_dimension())) ||
       ((arg_ti.is_timestamp() && ti.is_date()))) {
@@ -860,9 +865,14 @@ ExpressionRange getExpressionRange(
     const std::vector<InputTableInfo>& query_infos,
     const Executor* executor,
     boost::optional<std::list<std::shared_ptr<Analyzer::Expr>>> simple_quals) {
-  const int32_t extract_field{extract_expr->get_field()};
   const auto arg_range = getExpressionRange(
       extract_expr->get_from_expr(), query_infos, executor, simple_quals);
+  return getExtractRange(extract_expr, arg_range);
+}
+
+ExpressionRange getExtractRange(const Analyzer::ExtractExpr* extract_expr,
+                                const ExpressionRange& arg_range) {
+  const int32_t extract_field{extract_expr->get_field()};
   const bool has_nulls =
       arg_range.getType() == ExpressionRangeType::Invalid || arg_range.hasNulls();
   const auto& extract_expr_ti = extract_expr->get_from_expr()->get_type_info();
@@ -934,6 +944,11 @@ ExpressionRange getExpressionRange(
     boost::optional<std::list<std::shared_ptr<Analyzer::Expr>>> simple_quals) {
   const auto arg_range = getExpressionRange(
       datetrunc_expr->get_from_expr(), query_infos, executor, simple_quals);
+  return getDatetruncRange(datetrunc_expr, arg_range);
+}
+
+ExpressionRange getDatetruncRange(const Analyzer::DatetruncExpr* datetrunc_expr,
+                                  const ExpressionRange& arg_range) {
   if (arg_range.getType() == ExpressionRangeType::Invalid) {
     return ExpressionRange::makeInvalidRange();
   }
@@ -951,3 +966,139 @@ ExpressionRange getExpressionRange(
 
   return ExpressionRange::makeIntRange(min_ts, max_ts, bucket, arg_range.hasNulls());
 }
+
+namespace {
+
+// The range of the values of a column in one fragment, from the stats of its chunk. A
+// null range if the chunk has no value besides nulls.
+ExpressionRange getFragmentColumnRange(
+    const Analyzer::ColumnVar* col_expr,
+    const Fragmenter_Namespace::FragmentInfo& fragment) {
+  const auto& col_phys_ti = col_expr->get_type_info();
+  if (col_phys_ti.is_array()) {
+    // the stats are those of the elements
+    return ExpressionRange::makeInvalidRange();
+  }
+  const auto col_ti = get_logical_type_info(col_phys_ti);
+  if (!ExpressionRange::typeSupportsRange(col_ti)) {
+    return ExpressionRange::makeInvalidRange();
+  }
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  const auto chunk_meta_it = chunk_metadata_map.find(col_expr->get_column_id());
+  if (chunk_meta_it == chunk_metadata_map.end()) {
+    return ExpressionRange::makeInvalidRange();
+  }
+  const auto& chunk_meta = chunk_meta_it->second;
+  const auto& stats = chunk_meta->chunkStats;
+  if (!chunk_meta->numElements) {
+    return ExpressionRange::makeNullRange();
+  }
+  if (col_ti.is_fp()) {
+    const auto min_val = extract_min_stat_double(stats, col_ti);
+    const auto max_val = extract_max_stat_double(stats, col_ti);
+    if (max_val < min_val) {
+      return ExpressionRange::makeNullRange();
+    }
+    return col_ti.get_type() == kFLOAT
+               ? ExpressionRange::makeFloatRange(min_val, max_val, stats.has_nulls)
+               : ExpressionRange::makeDoubleRange(min_val, max_val, stats.has_nulls);
+  }
+  const auto min_val = extract_min_stat(stats, col_ti);
+  const auto max_val = extract_max_stat(stats, col_ti);
+  if (max_val < min_val) {
+    return ExpressionRange::makeNullRange();
+  }
+  return ExpressionRange::makeIntRange(min_val, max_val, 0, stats.has_nulls);
+}
+
+}  // namespace
+
+ExpressionRange getFragmentExpressionRange(
+    const Analyzer::Expr* expr,
+    const int table_id,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const Executor* executor) {
+  if (!ExpressionRange::typeSupportsRange(expr->get_type_info())) {
+    return ExpressionRange::makeInvalidRange();
+  }
+  if (const auto constant = dynamic_cast<const Analyzer::Constant*>(expr)) {
+    return getExpressionRange(constant);
+  }
+  if (const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+    if (dynamic_cast<const Analyzer::Var*>(expr) || col_var->get_table_id() != table_id ||
+        col_var->get_rte_idx()) {
+      return ExpressionRange::makeInvalidRange();
+    }
+    return getFragmentColumnRange(col_var, fragment);
+  }
+  // the functions below are all null for a null argument
+  auto get_arg_range = [&](const Analyzer::Expr* arg) {
+    return getFragmentExpressionRange(arg, table_id, fragment, executor);
+  };
+  if (const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr)) {
+    const auto lhs = get_arg_range(bin_oper->get_left_operand());
+    const auto rhs = get_arg_range(bin_oper->get_right_operand());
+    if (lhs.getType() == ExpressionRangeType::Invalid ||
+        rhs.getType() == ExpressionRangeType::Invalid ||
+        lhs.getType() == ExpressionRangeType::Null ||
+        rhs.getType() == ExpressionRangeType::Null) {
+      return lhs.getType() == ExpressionRangeType::Null ||
+                     rhs.getType() == ExpressionRangeType::Null
+                 ? ExpressionRange::makeNullRange()
+                 : ExpressionRange::makeInvalidRange();
+    }
+    if (lhs.getType() != rhs.getType()) {
+      return ExpressionRange::makeInvalidRange();
+    }
+    switch (bin_oper->get_optype()) {
+      case kPLUS:
+        return lhs + rhs;
+      case kMINUS:
+        return lhs - rhs;
+      case kMULTIPLY:
+        return lhs * rhs;
+      default:
+        break;
+    }
+    return ExpressionRange::makeInvalidRange();
+  }
+  if (const auto u_oper = dynamic_cast<const Analyzer::UOper*>(expr)) {
+    if (u_oper->get_optype() != kCAST) {
+      return ExpressionRange::makeInvalidRange();
+    }
+    const auto operand = u_oper->get_operand();
+    if (dynamic_cast<const Analyzer::Constant*>(operand)) {
+      // string literals are cast to the dictionary of the column they're compared with
+      return getExpressionRange(u_oper, {}, executor);
+    }
+    const auto& ti = u_oper->get_type_info();
+    const auto& arg_ti = operand->get_type_info();
+    if (ti.is_string() || (arg_ti.is_fp() && !ti.is_fp()) ||
+        (arg_ti.is_integer() && ti.is_integer() && ti.get_size() < arg_ti.get_size()) ||
+        (arg_ti.is_decimal() && ti.is_decimal() && ti.get_scale() < arg_ti.get_scale())) {
+      // the range of the cast would miss the rounding or the overflow of the values
+      return ExpressionRange::makeInvalidRange();
+    }
+    const auto arg_range = get_arg_range(operand);
+    if (arg_range.getType() == ExpressionRangeType::Invalid ||
+        arg_range.getType() == ExpressionRangeType::Null) {
+      return arg_range;
+    }
+    return getCastRange(arg_range, arg_ti, ti);
+  }
+  if (const auto datetrunc_expr = dynamic_cast<const Analyzer::DatetruncExpr*>(expr)) {
+    const auto arg_range = get_arg_range(datetrunc_expr->get_from_expr());
+    if (arg_range.getType() == ExpressionRangeType::Null) {
+      return arg_range;
+    }
+    return getDatetruncRange(datetrunc_expr, arg_range);
+  }
+  if (const auto extract_expr = dynamic_cast<const Analyzer::ExtractExpr*>(expr)) {
+    const auto arg_range = get_arg_range(extract_expr->get_from_expr());
+    if (arg_range.getType() == ExpressionRangeType::Null) {
+      return arg_range;
+    }
+    return getExtractRange(extract_expr, arg_range);
+  }
+  return ExpressionRange::makeInvalidRange();
+}
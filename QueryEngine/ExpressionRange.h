@@ -311,6 +311,10 @@ ExpressionRange apply_simple_quals(
 class Executor;
 struct InputTableInfo;
 
+namespace Fragmenter_Namespace {
+class FragmentInfo;
+}  // namespace Fragmenter_Namespace
+
 ExpressionRange getLeafColumnRange(const Analyzer::ColumnVar*,
                                    const std::vector<InputTableInfo>&,
                                    const Executor*,
@@ -322,4 +326,23 @@ ExpressionRange getExpressionRange(
     const Executor*,
     boost::optional<std::list<std::shared_ptr<Analyzer::Expr>>> = boost::none);
 
+// The ranges of the functions of an argument of range `arg_range`.
+ExpressionRange getCastRange(const ExpressionRange& arg_range,
+                             const SQLTypeInfo& arg_ti,
+                             const SQLTypeInfo& ti);
+ExpressionRange getExtractRange(const Analyzer::ExtractExpr*,
+                                const ExpressionRange& arg_range);
+ExpressionRange getDatetruncRange(const Analyzer::DatetruncExpr*,
+                                  const ExpressionRange& arg_range);
+
+// The range of `expr` over the rows of one fragment of the table `table_id` at nest level
+// 0, from the stats of its chunks. Invalid if `expr` isn't made of columns of the table,
+// constants, arithmetic, casts, DATE_TRUNC and EXTRACT; null if the columns it reads
+// hold nothing but nulls in the fragment.
+ExpressionRange getFragmentExpressionRange(
+    const Analyzer::Expr*,
+    const int table_id,
+    const Fragmenter_Namespace::FragmentInfo&,
+    const Executor*);
+
 #endif  // QUERYENGINE_EXPRESSIONRANGE_H
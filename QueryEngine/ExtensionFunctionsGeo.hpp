@@ -105,6 +105,43 @@ DEVICE ALWAYS_INLINE double coord_y(int8_t* data,
   return decompressed_transformed_coord_y;
 }
 
+// Points the batched kernels decompress at a time, few enough for their coordinates to
+// stay in registers.
+constexpr int32_t kCoordBatchSize = 8;
+
+// Decompresses and transforms `num_points` points starting at coordinate `first_coord`
+// into xs and ys. The compression is checked once per batch rather than once per
+// coordinate, which leaves loops the compiler can vectorize.
+DEVICE ALWAYS_INLINE void decompress_coords_batch(int8_t* data,
+                                                  int32_t first_coord,
+                                                  int32_t num_points,
+                                                  int32_t ic,
+                                                  int32_t isr,
+                                                  int32_t osr,
+                                                  double* xs,
+                                                  double* ys) {
+  if (ic == COMPRESSION_GEOINT32) {
+    auto compressed_coords = reinterpret_cast<int32_t*>(data) + first_coord;
+    for (int32_t i = 0; i < num_points; i++) {
+      xs[i] = Geospatial::decompress_longitude_coord_geoint32(compressed_coords[2 * i]);
+      ys[i] =
+          Geospatial::decompress_lattitude_coord_geoint32(compressed_coords[2 * i + 1]);
+    }
+  } else {
+    auto double_coords = reinterpret_cast<double*>(data) + first_coord;
+    for (int32_t i = 0; i < num_points; i++) {
+      xs[i] = double_coords[2 * i];
+      ys[i] = double_coords[2 * i + 1];
+    }
+  }
+  if (isr == 4326 && osr == 900913) {
+    for (int32_t i = 0; i < num_points; i++) {
+      xs[i] = transform_coord(xs[i], isr, osr, true);
+      ys[i] = transform_coord(ys[i], isr, osr, false);
+    }
+  }
+}
+
 // Cartesian distance between points, squared
 DEVICE ALWAYS_INLINE double distance_point_point_squared(double p1x,
                                                          double p1y,
@@ -157,6 +194,28 @@ double distance_point_line(double px,
   return distance_point_point(px, py, projx, projy);
 }
 
+// Cartesian distance between a point and a line segment, squared. Same as
+// distance_point_line, without its branches so that it vectorizes, and without zeroing
+// the distances within the tolerance, which is left to the caller.
+DEVICE ALWAYS_INLINE double distance_point_line_squared(double px,
+                                                        double py,
+                                                        double l1x,
+                                                        double l1y,
+                                                        double l2x,
+                                                        double l2y) {
+  double dx = l2x - l1x;
+  double dy = l2y - l1y;
+  double length2 = dx * dx + dy * dy;
+  double dotprod = (px - l1x) * dx + (py - l1y) * dy;
+  // Segments shorter than the tolerance are points, as in distance_point_line
+  double k = length2 > TOLERANCE_DEFAULT * TOLERANCE_DEFAULT
+                 ? fmax(0.0, fmin(1.0, dotprod / length2))
+                 : 0.0;
+  double x = px - (l1x + k * dx);
+  double y = py - (l1y + k * dy);
+  return x * x + y * y;
+}
+
 // Given three colinear points p, q, r, the function checks if
 // point q lies on line segment 'pr'
 DEVICE ALWAYS_INLINE bool on_segment(double px,
@@ -410,6 +469,10 @@ double distance_ring_ring(int8_t* ring1,
 // chance of error. No intersections means P is outside, irrespective of main probe's
 // result.
 //
+// Slack of the per-batch filter of the edges of polygon_contains_point, well above the
+// tolerances of the exact tests it saves.
+constexpr double kEdgeFilterSlack = 0.000001;
+
 DEVICE
 bool polygon_contains_point(int8_t* poly,
                             int32_t poly_num_coords,
@@ -423,98 +486,141 @@ bool polygon_contains_point(int8_t* poly,
   bool horizontal_edge = false;
   bool yray_intersects = false;
 
-  double e1x = coord_x(poly, poly_num_coords - 2, ic1, isr1, osr);
-  double e1y = coord_y(poly, poly_num_coords - 1, ic1, isr1, osr);
-  for (int64_t i = 0; i < poly_num_coords; i += 2) {
-    double e2x = coord_x(poly, i, ic1, isr1, osr);
-    double e2y = coord_y(poly, i + 1, ic1, isr1, osr);
-
-    // Check if point sits on an edge.
-    if (tol_zero(distance_point_line(px, py, e1x, e1y, e2x, e2y))) {
-      return true;
-    }
+  // Edge j of a batch goes from point j to point j + 1, point 0 being the last point of
+  // the previous batch.
+  double xs[kCoordBatchSize + 1];
+  double ys[kCoordBatchSize + 1];
+  bool candidate_edges[kCoordBatchSize];
+  xs[0] = coord_x(poly, poly_num_coords - 2, ic1, isr1, osr);
+  ys[0] = coord_y(poly, poly_num_coords - 1, ic1, isr1, osr);
+  for (int32_t first_coord = 0; first_coord < poly_num_coords;
+       first_coord += 2 * kCoordBatchSize) {
+    int32_t batch_num_points = (poly_num_coords - first_coord) / 2;
+    if (batch_num_points > kCoordBatchSize) {
+      batch_num_points = kCoordBatchSize;
+    }
+    decompress_coords_batch(
+        poly, first_coord, batch_num_points, ic1, isr1, osr, xs + 1, ys + 1);
+
+    // Only the edges which come near the xray or the yray can intersect them or have P
+    // on them, the state of the probes below doesn't change on any other edge. Flag them
+    // in a pass over the whole batch, free of branches so that it vectorizes unlike the
+    // exact tests.
+    for (int32_t j = 0; j < batch_num_points; j++) {
+      bool below_x =
+          (xs[j] <= px + kEdgeFilterSlack) | (xs[j + 1] <= px + kEdgeFilterSlack);
+      bool above_x =
+          (px <= xs[j] + kEdgeFilterSlack) | (px <= xs[j + 1] + kEdgeFilterSlack);
+      bool below_y =
+          (ys[j] <= py + kEdgeFilterSlack) | (ys[j + 1] <= py + kEdgeFilterSlack);
+      bool above_y =
+          (py <= ys[j] + kEdgeFilterSlack) | (py <= ys[j + 1] + kEdgeFilterSlack);
+      bool near_xray = below_y & above_y & above_x;
+      bool near_yray = below_x & above_x & below_y;
+      candidate_edges[j] = near_xray | near_yray;
+    }
+
+    for (int32_t j = 0; j < batch_num_points; j++) {
+      if (!candidate_edges[j]) {
+        continue;
+      }
+      double e1x = xs[j];
+      double e1y = ys[j];
+      double e2x = xs[j + 1];
+      double e2y = ys[j + 1];
+
+      // Check if point sits on an edge.
+      if (tol_zero(distance_point_line(px, py, e1x, e1y, e2x, e2y))) {
+        return true;
+      }
 
-    // Before flipping the switch, check if xray hit a horizontal edge
-    // - If an edge lays on the xray, one of the previous edges touched it
-    //   so while moving horizontally we're in 'xray_touch' state
-    // - Last edge that touched xray at (e2x,e2y) didn't register intersection
-    // - Next edge that diverges from xray at (e1,e1y) will register intersection
-    // - Can have several horizontal edges, one after the other, keep moving though
-    //   in 'xray_touch' state without flipping the switch
-    horizontal_edge = (xray_touch != 0) && tol_eq(py, e1y) && tol_eq(py, e2y);
-
-    // Main probe: xray
-    // Overshoot the xray to detect an intersection if there is one.
-    double xray = fmax(e2x, e1x) + 1.0;
-    if (px <= xray &&        // Only check for intersection if the edge is on the right
-        !horizontal_edge &&  // Keep moving through horizontal edges
-        line_intersects_line(px,  // xray shooting from point p to the right
-                             py,
-                             xray,
-                             py,
-                             e1x,  // polygon edge
-                             e1y,
-                             e2x,
-                             e2y)) {
-      // Register intersection
-      result = !result;
-
-      // Adjust for special cases
-      if (xray_touch == 0) {
-        if (tol_zero(distance_point_line(e2x, e2y, px, py, xray + 1.0, py))) {
-          // Xray goes through the edge's second vertex, unregister intersection -
-          // that vertex will be crossed again when we look at the following edge(s)
-          result = !result;
-          // Enter the xray-touch state:
-          // (1) - xray was touched by the edge from above, (-1) from below
-          xray_touch = (e1y > py) ? 1 : -1;
-        }
-      } else {
-        // Previous edge touched the xray, intersection hasn't been registered,
-        // it has to be registered now if this edge continues across the xray.
-        if (xray_touch > 0) {
-          // Previous edge touched the xray from above
-          if (e2y <= py) {
-            // Current edge crosses under xray: intersection is already registered
-          } else {
-            // Current edge just touched the xray and pulled up: unregister intersection
+      // Before flipping the switch, check if xray hit a horizontal edge
+      // - If an edge lays on the xray, one of the previous edges touched it
+      //   so while moving horizontally we're in 'xray_touch' state
+      // - Last edge that touched xray at (e2x,e2y) didn't register intersection
+      // - Next edge that diverges from xray at (e1,e1y) will register intersection
+      // - Can have several horizontal edges, one after the other, keep moving though
+      //   in 'xray_touch' state without flipping the switch
+      // The edges in between which were skipped didn't touch the xray, the edge
+      // following one that touched it starts on it and is never skipped.
+      horizontal_edge = (xray_touch != 0) && tol_eq(py, e1y) && tol_eq(py, e2y);
+
+      // Main probe: xray
+      // Overshoot the xray to detect an intersection if there is one.
+      double xray = fmax(e2x, e1x) + 1.0;
+      if (px <= xray &&        // Only check for intersection if the edge is on the right
+          !horizontal_edge &&  // Keep moving through horizontal edges
+          line_intersects_line(px,  // xray shooting from point p to the right
+                               py,
+                               xray,
+                               py,
+                               e1x,  // polygon edge
+                               e1y,
+                               e2x,
+                               e2y)) {
+        // Register intersection
+        result = !result;
+
+        // Adjust for special cases
+        if (xray_touch == 0) {
+          if (tol_zero(distance_point_line(e2x, e2y, px, py, xray + 1.0, py))) {
+            // Xray goes through the edge's second vertex, unregister intersection -
+            // that vertex will be crossed again when we look at the following edge(s)
             result = !result;
+            // Enter the xray-touch state:
+            // (1) - xray was touched by the edge from above, (-1) from below
+            xray_touch = (e1y > py) ? 1 : -1;
           }
         } else {
-          // Previous edge touched the xray from below
-          if (e2y > py) {
-            // Current edge crosses over xray: intersection is already registered
+          // Previous edge touched the xray, intersection hasn't been registered,
+          // it has to be registered now if this edge continues across the xray.
+          if (xray_touch > 0) {
+            // Previous edge touched the xray from above
+            if (e2y <= py) {
+              // Current edge crosses under xray: intersection is already registered
+            } else {
+              // Current edge just touched the xray and pulled up: unregister
+              // intersection
+              result = !result;
+            }
           } else {
-            // Current edge just touched the xray and pulled down: unregister intersection
-            result = !result;
+            // Previous edge touched the xray from below
+            if (e2y > py) {
+              // Current edge crosses over xray: intersection is already registered
+            } else {
+              // Current edge just touched the xray and pulled down: unregister
+              // intersection
+              result = !result;
+            }
           }
+          // Exit the xray-touch state
+          xray_touch = 0;
         }
-        // Exit the xray-touch state
-        xray_touch = 0;
       }
-    }
 
-    // Redundancy: vertical yray down
-    // Main probe xray may hit multiple complex fragments which increases a chance of
-    // error. Perform a simple secondary check for edge intersections to see if point is
-    // outside.
-    if (!yray_intersects) {  // Continue checking on yray until intersection is found
-      double yray = fmin(e2y, e1y) - 1.0;
-      if (yray <= py) {  // Only check for yray intersection if point P is above the edge
-        yray_intersects = line_intersects_line(px,  // yray shooting from point P down
-                                               py,
-                                               px,
-                                               yray,
-                                               e1x,  // polygon edge
-                                               e1y,
-                                               e2x,
-                                               e2y);
+      // Redundancy: vertical yray down
+      // Main probe xray may hit multiple complex fragments which increases a chance of
+      // error. Perform a simple secondary check for edge intersections to see if point
+      // is outside.
+      if (!yray_intersects) {  // Continue checking on yray until intersection is found
+        double yray = fmin(e2y, e1y) - 1.0;
+        // Only check for yray intersection if point P is above the edge
+        if (yray <= py) {
+          yray_intersects = line_intersects_line(px,  // yray shooting from point P down
+                                                 py,
+                                                 px,
+                                                 yray,
+                                                 e1x,  // polygon edge
+                                                 e1y,
+                                                 e2x,
+                                                 e2y);
+        }
       }
     }
 
-    // Advance to the next vertex
-    e1x = e2x;
-    e1y = e2y;
+    // Advance to the next batch
+    xs[0] = xs[batch_num_points];
+    ys[0] = ys[batch_num_points];
   }
   if (!yray_intersects) {
     // yray has zero intersections - point is outside the polygon
@@ -1553,32 +1659,49 @@ DEVICE ALWAYS_INLINE double distance_point_linestring(int8_t* p,
     return distance_point_point(px, py, lx, ly);
   }
 
-  double l1x = coord_x(l, 0, ic2, isr2, osr);
-  double l1y = coord_y(l, 1, ic2, isr2, osr);
-  double l2x = coord_x(l, 2, ic2, isr2, osr);
-  double l2y = coord_y(l, 3, ic2, isr2, osr);
-
-  double dist = distance_point_line(px, py, l1x, l1y, l2x, l2y);
-  for (int32_t i = 4; i < l_num_coords; i += 2) {
-    l1x = l2x;  // advance one point
-    l1y = l2y;
-    l2x = coord_x(l, i, ic2, isr2, osr);
-    l2y = coord_y(l, i + 1, ic2, isr2, osr);
-    double ldist = distance_point_line(px, py, l1x, l1y, l2x, l2y);
-    if (dist > ldist) {
-      dist = ldist;
+  // Segment j of a batch goes from point j to point j + 1, point 0 being the last point
+  // of the previous batch. The distances are squared, the square root of the smallest
+  // one is taken at the end.
+  double xs[kCoordBatchSize + 1];
+  double ys[kCoordBatchSize + 1];
+  double dist2s[kCoordBatchSize];
+  xs[0] = coord_x(l, 0, ic2, isr2, osr);
+  ys[0] = coord_y(l, 1, ic2, isr2, osr);
+  // No segment is closer than its first point
+  double dist2 = (px - xs[0]) * (px - xs[0]) + (py - ys[0]) * (py - ys[0]);
+  for (int32_t first_coord = 2; first_coord < l_num_coords;
+       first_coord += 2 * kCoordBatchSize) {
+    int32_t batch_num_points = (l_num_coords - first_coord) / 2;
+    if (batch_num_points > kCoordBatchSize) {
+      batch_num_points = kCoordBatchSize;
+    }
+    decompress_coords_batch(
+        l, first_coord, batch_num_points, ic2, isr2, osr, xs + 1, ys + 1);
+    for (int32_t j = 0; j < batch_num_points; j++) {
+      dist2s[j] = distance_point_line_squared(px, py, xs[j], ys[j], xs[j + 1], ys[j + 1]);
+    }
+    for (int32_t j = 0; j < batch_num_points; j++) {
+      if (dist2 > dist2s[j]) {
+        dist2 = dist2s[j];
+      }
     }
+    // Advance to the next batch
+    xs[0] = xs[batch_num_points];
+    ys[0] = ys[batch_num_points];
   }
   if (l_num_coords > 4 && check_closed) {
     // Also check distance to the closing edge between the first and the last points
-    l1x = coord_x(l, 0, ic2, isr2, osr);
-    l1y = coord_y(l, 1, ic2, isr2, osr);
-    double ldist = distance_point_line(px, py, l1x, l1y, l2x, l2y);
-    if (dist > ldist) {
-      dist = ldist;
+    double l1x = coord_x(l, 0, ic2, isr2, osr);
+    double l1y = coord_y(l, 1, ic2, isr2, osr);
+    double ldist2 = distance_point_line_squared(px, py, l1x, l1y, xs[0], ys[0]);
+    if (dist2 > ldist2) {
+      dist2 = ldist2;
     }
   }
-  return dist;
+  if (tol_zero(dist2, TOLERANCE_DEFAULT * TOLERANCE_DEFAULT)) {
+    return 0.0;
+  }
+  return sqrt(dist2);
 }
 
 EXTENSION_NOINLINE
@@ -238,15 +238,6 @@ llvm::Value* CodeGenerator::codegenFunctionOper(
     throw QueryMustRunOnCpu();
   }
   auto ret_ty = ext_arg_type_to_llvm_type(ext_func_sig.getRet(), cgen_state_->context_);
-  const auto current_bb = cgen_state_->ir_builder_.GetInsertBlock();
-  for (auto it : cgen_state_->ext_call_cache_) {
-    if (*it.foper == *function_oper) {
-      auto inst = llvm::dyn_cast<llvm::Instruction>(it.lv);
-      if (inst && inst->getParent() == current_bb) {
-        return it.lv;
-      }
-    }
-  }
   std::vector<llvm::Value*> orig_arg_lvs;
   std::unordered_map<llvm::Value*, llvm::Value*> const_arr_size;
   for (size_t i = 0; i < function_oper->getArity(); ++i) {
@@ -336,8 +327,6 @@ llvm::Value* CodeGenerator::codegenFunctionOper(
     }
   }
 
-  cgen_state_->ext_call_cache_.push_back({function_oper, ext_call_nullcheck});
-
   return ext_call_nullcheck;
 }
 
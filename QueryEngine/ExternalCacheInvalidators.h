@@ -25,15 +25,19 @@
  */
 
 // Classes that are involved in needing a cache invalidated
+#include "IncrementalAggregateCache.h"
 #include "JoinHashTable/BaselineJoinHashTable.h"
 #include "JoinHashTable/JoinHashTable.h"
 #include "JoinHashTable/OverlapsJoinHashTable.h"
 
-using UpdateTriggeredCacheInvalidator =
-    CacheInvalidator<OverlapsJoinHashTable, BaselineJoinHashTable, JoinHashTable>;
+using UpdateTriggeredCacheInvalidator = CacheInvalidator<OverlapsJoinHashTable,
+                                                         BaselineJoinHashTable,
+                                                         JoinHashTable,
+                                                         IncrementalAggregateCache>;
 using DeleteTriggeredCacheInvalidator = UpdateTriggeredCacheInvalidator;
 
-// Note that this is functionally the same as the above two invalidators. The
+// Note that this is functionally the same as the above two invalidators, without the
+// incremental aggregates which don't depend on buffers being resident. The
 // JoinHashTableCacheInvalidator is a generic invalidator used during `clear_cpu` calls.
 // The above cache invalidators are specific invalidators called during update/delete and
 // will likely be extended in the future.
@@ -0,0 +1,376 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ExternalSort.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <numeric>
+#include <queue>
+
+#include <boost/filesystem.hpp>
+
+#include "DataMgr/DataMgr.h"
+#include "DataMgr/FileMgr/GlobalFileMgr.h"
+#include "QueryEngine/BufferCompaction.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "QueryEngine/ResultSet.h"
+
+bool g_enable_external_sort{true};
+size_t g_external_sort_threshold{size_t(4) << 30};  // 4GB
+
+namespace {
+
+// Records are read and written this many at a time.
+constexpr size_t kBlockRecords{4096};
+
+std::string io_error(const std::string& what, const std::string& scratch_dir) {
+  return "External sort failed to " + what + " in " + scratch_dir + ": " +
+         std::strerror(errno);
+}
+
+// The order of the rows given by their normalized keys, ties in their original order.
+std::vector<uint32_t> sort_run_rows(
+    const std::vector<packed_key_sort::SortColumn>& columns,
+    const size_t row_count) {
+  const auto keys = packed_key_sort::pack(columns);
+  if (keys) {
+    // the kernels already keep all the threads busy
+    return packed_key_sort::sort(*keys, 1);
+  }
+  std::vector<uint32_t> sorted_rows(row_count);
+  std::iota(sorted_rows.begin(), sorted_rows.end(), 0);
+  std::stable_sort(sorted_rows.begin(),
+                   sorted_rows.end(),
+                   [&columns](const uint32_t lhs, const uint32_t rhs) {
+                     for (const auto& column : columns) {
+                       const bool lhs_null = column.nulls[lhs];
+                       const bool rhs_null = column.nulls[rhs];
+                       if (lhs_null || rhs_null) {
+                         if (lhs_null == rhs_null) {
+                           continue;
+                         }
+                         return column.nulls_first ? lhs_null : rhs_null;
+                       }
+                       if (column.values[lhs] != column.values[rhs]) {
+                         return column.values[lhs] < column.values[rhs];
+                       }
+                     }
+                     return false;
+                   });
+  return sorted_rows;
+}
+
+}  // namespace
+
+ExternalSortBuffer::~ExternalSortBuffer() {
+  if (munmap(data_, size_)) {
+    LOG(WARNING) << "Failed to unmap the external sort output: " << std::strerror(errno);
+  }
+}
+
+// Buffered sequential reads of the records of a run.
+class ExternalSort::RunReader {
+ public:
+  RunReader(const Run& run, const size_t record_size, const std::string& scratch_dir)
+      : run_(run)
+      , record_size_(record_size)
+      , scratch_dir_(scratch_dir)
+      , block_(kBlockRecords * record_size) {
+    if (std::fseek(run_.file, 0, SEEK_SET)) {
+      throw std::runtime_error(io_error("rewind a run", scratch_dir_));
+    }
+    readBlock();
+  }
+
+  bool done() const { return block_pos_ == block_records_; }
+
+  const int8_t* current() const { return &block_[block_pos_ * record_size_]; }
+
+  void next() {
+    ++block_pos_;
+    if (block_pos_ == block_records_) {
+      readBlock();
+    }
+  }
+
+ private:
+  void readBlock() {
+    block_records_ = std::min(kBlockRecords, run_.row_count - records_read_);
+    block_pos_ = 0;
+    if (!block_records_) {
+      return;
+    }
+    if (std::fread(&block_[0], record_size_, block_records_, run_.file) !=
+        block_records_) {
+      throw std::runtime_error(io_error("read a run", scratch_dir_));
+    }
+    records_read_ += block_records_;
+  }
+
+  const Run& run_;
+  const size_t record_size_;
+  const std::string& scratch_dir_;
+  std::vector<int8_t> block_;
+  size_t block_records_{0};
+  size_t block_pos_{0};
+  size_t records_read_{0};
+};
+
+ExternalSort::ExternalSort(const std::list<Analyzer::OrderEntry>& order_entries,
+                           const size_t top_n,
+                           const std::string& scratch_dir)
+    : order_entries_(order_entries)
+    , top_n_(top_n)
+    , scratch_dir_(scratch_dir)
+    , key_bytes_(align_to_int64(order_entries.size() * (sizeof(uint64_t) + 1))) {
+  CHECK(!order_entries_.empty());
+  for (const auto& order_entry : order_entries_) {
+    nulls_first_.push_back(order_entry.nulls_first);
+  }
+}
+
+ExternalSort::~ExternalSort() {
+  for (const auto& run : runs_) {
+    std::fclose(run.file);
+  }
+}
+
+bool ExternalSort::isCandidate(const RelAlgExecutionUnit& ra_exe_unit,
+                               const std::vector<InputTableInfo>& query_infos,
+                               const bool is_agg,
+                               const ExecutionOptions& eo) {
+  const auto& sort_info = ra_exe_unit.sort_info;
+  if (!g_enable_external_sort || is_agg || eo.just_explain || eo.just_validate ||
+      eo.executor_type != ExecutorType::Native || ra_exe_unit.union_all ||
+      ra_exe_unit.estimator || sort_info.order_entries.empty() ||
+      sort_info.algorithm != SortAlgorithm::Default || query_infos.empty()) {
+    return false;
+  }
+  std::vector<TargetInfo> targets;
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    // variable length values live in the input buffers, not in the rows
+    if (target_expr->get_type_info().is_varlen()) {
+      return false;
+    }
+    targets.push_back(get_target_info(target_expr, g_bigint_count));
+  }
+  if (!ResultSet::canNormalizeSortKeys(targets, sort_info.order_entries)) {
+    return false;
+  }
+  const auto row_count = query_infos.front().info.getNumTuplesUpperBound();
+  // rows which would not fit in the memory limit of the query are spilled to disk
+  const auto threshold =
+      g_max_query_host_memory_bytes
+          ? std::min(g_external_sort_threshold, g_max_query_host_memory_bytes)
+          : g_external_sort_threshold;
+  return row_count * targets.size() * sizeof(int64_t) >= threshold;
+}
+
+std::unique_ptr<ExternalSort> ExternalSort::create(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const bool is_agg,
+    const bool allow_lazy_fetch,
+    Data_Namespace::DataMgr& data_mgr,
+    const ExecutionOptions& eo) {
+  if (!isCandidate(ra_exe_unit, query_infos, is_agg, eo) || allow_lazy_fetch ||
+      query_mem_desc.getQueryDescriptionType() != QueryDescriptionType::Projection ||
+      query_mem_desc.didOutputColumnar() || query_mem_desc.useStreamingTopN()) {
+    return nullptr;
+  }
+  const auto scratch_dir =
+      boost::filesystem::path(data_mgr.getGlobalFileMgr()->getBasePath()) / ".." /
+      "mapd_sort_scratch";
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(scratch_dir, ec);
+  if (ec) {
+    LOG(WARNING) << "Sorting in memory, failed to create the external sort directory "
+                 << scratch_dir << ": " << ec.message();
+    return nullptr;
+  }
+  const auto& sort_info = ra_exe_unit.sort_info;
+  const size_t top_n = sort_info.limit ? sort_info.limit + sort_info.offset : 0;
+  VLOG(1) << "Sorting the rows externally in " << scratch_dir;
+  return std::make_unique<ExternalSort>(
+      sort_info.order_entries, top_n, scratch_dir.string());
+}
+
+FILE* ExternalSort::createScratchFile(const std::string& prefix) const {
+  const auto path = boost::filesystem::unique_path(
+      boost::filesystem::path(scratch_dir_) / (prefix + "-%%%%-%%%%-%%%%-%%%%"));
+  auto file = std::fopen(path.c_str(), "w+b");
+  if (!file) {
+    throw std::runtime_error(io_error("create " + path.string(), scratch_dir_));
+  }
+  // The space is given back when the file is closed, even by a crash.
+  boost::filesystem::remove(path);
+  return file;
+}
+
+void ExternalSort::addRun(std::shared_ptr<ResultSet> result) {
+  CHECK(result);
+  auto timer = DEBUG_TIMER(__func__);
+  const auto columns = result->getNormalizedSortKeys(order_entries_);
+  const auto& permutation = result->getPermutationBuffer();
+  auto sorted_rows = sort_run_rows(columns, permutation.size());
+  CHECK_EQ(permutation.size(), sorted_rows.size());
+  if (top_n_ && sorted_rows.size() > top_n_) {
+    sorted_rows.resize(top_n_);
+  }
+  const auto& query_mem_desc = result->getQueryMemDesc();
+  const auto row_bytes = get_row_bytes(query_mem_desc);
+  {
+    std::lock_guard<std::mutex> lock(runs_mutex_);
+    if (!query_mem_desc_) {
+      targets_ = result->getTargetInfos();
+      query_mem_desc_ = std::make_unique<QueryMemoryDescriptor>(query_mem_desc);
+      target_init_vals_ = result->getTargetInitVals();
+    }
+    CHECK_EQ(row_bytes, get_row_bytes(*query_mem_desc_));
+  }
+
+  const auto record_size = key_bytes_ + row_bytes;
+  const auto buff = result->getStorage()->getUnderlyingBuffer();
+  const auto key_count = columns.size();
+  auto file = createScratchFile("run");
+  std::vector<int8_t> block(kBlockRecords * record_size);
+  for (size_t start = 0; start < sorted_rows.size(); start += kBlockRecords) {
+    const auto block_records = std::min(kBlockRecords, sorted_rows.size() - start);
+    for (size_t i = 0; i < block_records; ++i) {
+      const auto row_idx = sorted_rows[start + i];
+      auto record = &block[i * record_size];
+      auto values = reinterpret_cast<uint64_t*>(record);
+      auto nulls = record + key_count * sizeof(uint64_t);
+      for (size_t key_idx = 0; key_idx < key_count; ++key_idx) {
+        values[key_idx] = columns[key_idx].values[row_idx];
+        nulls[key_idx] = columns[key_idx].nulls[row_idx];
+      }
+      std::memcpy(record + key_bytes_,
+                  row_ptr_rowwise(buff, query_mem_desc, permutation[row_idx]),
+                  row_bytes);
+    }
+    if (std::fwrite(&block[0], record_size, block_records, file) != block_records) {
+      std::fclose(file);
+      throw std::runtime_error(io_error("write a run", scratch_dir_));
+    }
+  }
+  std::lock_guard<std::mutex> lock(runs_mutex_);
+  runs_.push_back({file, sorted_rows.size()});
+}
+
+bool ExternalSort::isBefore(const int8_t* lhs, const int8_t* rhs) const {
+  const auto key_count = nulls_first_.size();
+  const auto lhs_values = reinterpret_cast<const uint64_t*>(lhs);
+  const auto rhs_values = reinterpret_cast<const uint64_t*>(rhs);
+  const auto lhs_nulls = lhs + key_count * sizeof(uint64_t);
+  const auto rhs_nulls = rhs + key_count * sizeof(uint64_t);
+  for (size_t key_idx = 0; key_idx < key_count; ++key_idx) {
+    if (lhs_nulls[key_idx] || rhs_nulls[key_idx]) {
+      if (lhs_nulls[key_idx] == rhs_nulls[key_idx]) {
+        continue;
+      }
+      return nulls_first_[key_idx] ? lhs_nulls[key_idx] : rhs_nulls[key_idx];
+    }
+    if (lhs_values[key_idx] != rhs_values[key_idx]) {
+      return lhs_values[key_idx] < rhs_values[key_idx];
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<ResultSet> ExternalSort::merge(
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+    const Executor* executor) {
+  if (runs_.empty()) {
+    return nullptr;
+  }
+  auto timer = DEBUG_TIMER(__func__);
+  CHECK(query_mem_desc_);
+  size_t row_count{0};
+  for (const auto& run : runs_) {
+    row_count += run.row_count;
+  }
+  if (top_n_) {
+    row_count = std::min(row_count, top_n_);
+  }
+  const auto row_bytes = get_row_bytes(*query_mem_desc_);
+  const auto output_size = std::max(row_count * row_bytes, size_t(1));
+  auto output_file = createScratchFile("sorted");
+  const auto fd = fileno(output_file);
+  int8_t* output{nullptr};
+  if (!ftruncate(fd, output_size)) {
+    auto addr = mmap(nullptr, output_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    output = addr == MAP_FAILED ? nullptr : static_cast<int8_t*>(addr);
+  }
+  // the mapping outlives the file descriptor
+  std::fclose(output_file);
+  if (!output) {
+    throw std::runtime_error(io_error("map the sorted rows", scratch_dir_));
+  }
+  auto sorted_buffer = std::make_shared<ExternalSortBuffer>(output, output_size);
+
+  const auto record_size = key_bytes_ + row_bytes;
+  std::vector<std::unique_ptr<RunReader>> readers;
+  for (const auto& run : runs_) {
+    readers.emplace_back(std::make_unique<RunReader>(run, record_size, scratch_dir_));
+  }
+  // the best record on top, ties in the order of the runs
+  auto is_after = [this, &readers](const size_t lhs, const size_t rhs) {
+    const auto lhs_record = readers[lhs]->current();
+    const auto rhs_record = readers[rhs]->current();
+    if (isBefore(rhs_record, lhs_record)) {
+      return true;
+    }
+    return !isBefore(lhs_record, rhs_record) && lhs > rhs;
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(is_after)> heads(is_after);
+  for (size_t run_idx = 0; run_idx < readers.size(); ++run_idx) {
+    if (!readers[run_idx]->done()) {
+      heads.push(run_idx);
+    }
+  }
+  for (size_t row_idx = 0; row_idx < row_count; ++row_idx) {
+    CHECK(!heads.empty());
+    const auto run_idx = heads.top();
+    heads.pop();
+    auto& reader = *readers[run_idx];
+    std::memcpy(output + row_idx * row_bytes, reader.current() + key_bytes_, row_bytes);
+    reader.next();
+    if (!reader.done()) {
+      heads.push(run_idx);
+    }
+  }
+  for (const auto& run : runs_) {
+    std::fclose(run.file);
+  }
+  runs_.clear();
+
+  auto query_mem_desc = *query_mem_desc_;
+  query_mem_desc.setEntryCount(row_count);
+  auto result = std::make_shared<ResultSet>(
+      targets_, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, executor);
+  result->allocateStorage(output, target_init_vals_);
+  result->setExternallySorted(std::move(sorted_buffer));
+  return result;
+}
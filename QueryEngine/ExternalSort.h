@@ -0,0 +1,138 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ExternalSort.h
+ * @brief   ORDER BY of projections too large to sort in memory, as a merge of sorted
+ *          runs spilled to disk.
+ *
+ * The rows of each kernel are sorted by the normalized keys of the order entries as
+ * soon as the kernel finishes and written, keys first, to a run file in a scratch
+ * directory next to the data directory of the file manager. The runs are then merged
+ * in one streaming pass into a memory mapped file which backs the storage of the final
+ * result set, so that only the rows the client pages through are brought in memory.
+ * With a LIMIT, each run keeps and the merge produces only the first limit + offset
+ * rows. The scratch files are unlinked as soon as they are created, nothing is left
+ * behind if the server goes down during the query.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/Descriptors/QueryMemoryDescriptor.h"
+#include "QueryEngine/InputMetadata.h"
+#include "Shared/TargetInfo.h"
+
+extern bool g_enable_external_sort;
+extern size_t g_external_sort_threshold;
+
+namespace Analyzer {
+struct OrderEntry;
+}  // namespace Analyzer
+
+namespace Data_Namespace {
+class DataMgr;
+}  // namespace Data_Namespace
+
+class Executor;
+struct RelAlgExecutionUnit;
+class ResultSet;
+class RowSetMemoryOwner;
+
+// The merged rows mapped in memory, unmapped with the last result set holding them.
+class ExternalSortBuffer {
+ public:
+  ExternalSortBuffer(int8_t* data, const size_t size) : data_(data), size_(size) {}
+
+  ~ExternalSortBuffer();
+
+ private:
+  int8_t* data_;
+  const size_t size_;
+};
+
+class ExternalSort {
+ public:
+  ExternalSort(const std::list<Analyzer::OrderEntry>& order_entries,
+               const size_t top_n,
+               const std::string& scratch_dir);
+
+  ~ExternalSort();
+
+  /**
+   * Whether the ORDER BY of a projection work unit may be too large to sort in memory,
+   * judging by the size of its outer table. Checked before compilation: the targets of
+   * a work unit sorted externally can't be lazily fetched.
+   */
+  static bool isCandidate(const RelAlgExecutionUnit& ra_exe_unit,
+                          const std::vector<InputTableInfo>& query_infos,
+                          const bool is_agg,
+                          const ExecutionOptions& eo);
+
+  // An external sort for a compiled candidate work unit with row-wise output, nullptr
+  // if it doesn't qualify or the scratch directory can't be created.
+  static std::unique_ptr<ExternalSort> create(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::vector<InputTableInfo>& query_infos,
+      const QueryMemoryDescriptor& query_mem_desc,
+      const bool is_agg,
+      const bool allow_lazy_fetch,
+      Data_Namespace::DataMgr& data_mgr,
+      const ExecutionOptions& eo);
+
+  // Sorts the rows of a kernel and spills them as a run. Thread safe.
+  void addRun(std::shared_ptr<ResultSet> result);
+
+  // The merged rows, nullptr if no kernel returned a row.
+  std::shared_ptr<ResultSet> merge(std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+                                   const Executor* executor);
+
+ private:
+  struct Run {
+    FILE* file;
+    size_t row_count;
+  };
+
+  class RunReader;
+
+  FILE* createScratchFile(const std::string& prefix) const;
+
+  // Whether the record at `lhs` goes before the one at `rhs`.
+  bool isBefore(const int8_t* lhs, const int8_t* rhs) const;
+
+  const std::list<Analyzer::OrderEntry> order_entries_;
+  const size_t top_n_;
+  const std::string scratch_dir_;
+  std::vector<bool> nulls_first_;
+
+  std::mutex runs_mutex_;
+  std::vector<Run> runs_;
+  // layout of the rows, from the first run
+  std::vector<TargetInfo> targets_;
+  std::unique_ptr<QueryMemoryDescriptor> query_mem_desc_;
+  std::vector<int64_t> target_init_vals_;
+  // the keys of the run records, the row follows
+  size_t key_bytes_;
+};
@@ -22,6 +22,7 @@
 #include "ExtractFromTime.h"
 
 #ifndef __CUDACC__
+#include <algorithm>
 #include <cstdlib>  // abort()
 #endif
 
@@ -293,3 +294,88 @@ DEVICE int64_t ExtractFromTime(ExtractField field, const int64_t timeval) {
   abort();
 #endif
 }
+
+#ifndef __CUDACC__
+namespace {
+
+template <int64_t (*EXTRACT)(const int64_t)>
+void extract_batch(const int64_t* timevals, int64_t* out, const size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = EXTRACT(timevals[i]);
+  }
+}
+
+// (timeval mod PERIOD) / UNIT + BASE
+template <int64_t PERIOD, int64_t UNIT, int64_t BASE>
+void extract_fixed_batch(const int64_t* timevals, int64_t* out, const size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = unsigned_mod_branchless(timevals[i], PERIOD) / UNIT + BASE;
+  }
+}
+
+// The day of the week of timeval, with day 0 of the epoch being OFFSET.
+template <int64_t OFFSET, int64_t BASE>
+void extract_dow_batch(const int64_t* timevals, int64_t* out, const size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const int64_t days_past_epoch = floor_div_branchless(timevals[i], kSecsPerDay);
+    out[i] = unsigned_mod_branchless(days_past_epoch + OFFSET, kDaysPerWeek) + BASE;
+  }
+}
+
+}  // namespace
+
+void ExtractFromTimeBatch(ExtractField field,
+                          const int64_t* timevals,
+                          int64_t* out,
+                          const size_t count) {
+  switch (field) {
+    case kEPOCH:
+      std::copy(timevals, timevals + count, out);
+      return;
+    case kDATEEPOCH:
+      for (size_t i = 0; i < count; ++i) {
+        out[i] = timevals[i] - unsigned_mod_branchless(timevals[i], kSecsPerDay);
+      }
+      return;
+    case kQUARTERDAY:
+      return extract_fixed_batch<kSecsPerDay, kSecsPerQuarterDay, 1>(
+          timevals, out, count);
+    case kHOUR:
+      return extract_fixed_batch<kSecsPerDay, kSecsPerHour, 0>(timevals, out, count);
+    case kMINUTE:
+      return extract_fixed_batch<kSecsPerHour, kSecsPerMin, 0>(timevals, out, count);
+    case kSECOND:
+      return extract_fixed_batch<kSecsPerMin, 1, 0>(timevals, out, count);
+    case kMILLISECOND:
+      return extract_fixed_batch<kSecsPerMin * kMilliSecsPerSec, 1, 0>(
+          timevals, out, count);
+    case kMICROSECOND:
+      return extract_fixed_batch<kSecsPerMin * kMicroSecsPerSec, 1, 0>(
+          timevals, out, count);
+    case kNANOSECOND:
+      return extract_fixed_batch<kSecsPerMin * kNanoSecsPerSec, 1, 0>(
+          timevals, out, count);
+    case kDOW:
+      return extract_dow_batch<4, 0>(timevals, out, count);
+    case kISODOW:
+      return extract_dow_batch<3, 1>(timevals, out, count);
+    case kDAY:
+      return extract_batch<extract_day>(timevals, out, count);
+    case kWEEK:
+      return extract_batch<extract_week_monday>(timevals, out, count);
+    case kWEEK_SUNDAY:
+      return extract_batch<extract_week_sunday>(timevals, out, count);
+    case kWEEK_SATURDAY:
+      return extract_batch<extract_week_saturday>(timevals, out, count);
+    case kDOY:
+      return extract_batch<extract_day_of_year>(timevals, out, count);
+    case kMONTH:
+      return extract_batch<extract_month>(timevals, out, count);
+    case kQUARTER:
+      return extract_batch<extract_quarter>(timevals, out, count);
+    case kYEAR:
+      return extract_batch<extract_year>(timevals, out, count);
+  }
+  abort();
+}
+#endif
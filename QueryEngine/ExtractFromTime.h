@@ -17,6 +17,7 @@
 #ifndef QUERYENGINE_EXTRACTFROMTIME_H
 #define QUERYENGINE_EXTRACTFROMTIME_H
 
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include "Shared/funcannotations.h"
@@ -94,6 +95,14 @@ enum ExtractField {
 
 DEVICE int64_t ExtractFromTime(ExtractField field, const int64_t timeval);
 
+#ifndef __CUDACC__
+// ExtractFromTime over `count` values at once, see DateTruncateBatch.
+void ExtractFromTimeBatch(ExtractField field,
+                          const int64_t* timevals,
+                          int64_t* out,
+                          const size_t count);
+#endif
+
 // Return floor(dividend / divisor).
 // Assumes 0 < divisor.
 DEVICE inline int64_t floor_div(int64_t const dividend, int64_t const divisor) {
@@ -110,4 +119,18 @@ DEVICE inline int64_t unsigned_mod(int64_t const dividend, int64_t const divisor
   return mod;
 }
 
+#ifndef __CUDACC__
+// floor_div and unsigned_mod without a branch, for the batch loops meant to vectorize.
+inline int64_t floor_div_branchless(int64_t const dividend, int64_t const divisor) {
+  int64_t const quot = dividend / divisor;
+  int64_t const mod = dividend - quot * divisor;
+  return quot + (mod >> 63);
+}
+
+inline int64_t unsigned_mod_branchless(int64_t const dividend, int64_t const divisor) {
+  int64_t const mod = dividend % divisor;
+  return mod + ((mod >> 63) & divisor);
+}
+#endif
+
 #endif  // QUERYENGINE_EXTRACTFROMTIME_H
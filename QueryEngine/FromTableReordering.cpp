@@ -19,10 +19,14 @@
 #include "Execute.h"
 #include "RangeTableIndexVisitor.h"
 
+#include <cmath>
 #include <numeric>
+#include <optional>
 #include <queue>
 #include <regex>
 
+size_t g_join_order_dp_max_tables{10};
+
 namespace {
 
 using cost_t = unsigned;
@@ -235,6 +239,288 @@ std::vector<node_t> traverse_join_cost_graph(
   return input_permutation;
 }
 
+// The plans of all the sets of tables are kept, so the number of tables is bounded.
+constexpr size_t kMaxCostBasedTables{20};
+
+// Selectivities of the filters whose columns have no usable statistics.
+constexpr double kDefaultEqualitySelectivity{0.1};
+constexpr double kDefaultRangeSelectivity{1. / 3};
+constexpr double kDefaultFilterSelectivity{0.25};
+
+// Range of the values of a column across the chunk statistics of its table, if every
+// fragment has statistics for it.
+std::optional<std::pair<int64_t, int64_t>> get_column_stats_range(
+    const Analyzer::ColumnVar* col_var,
+    const InputTableInfo& table_info) {
+  const auto& ti = col_var->get_type_info();
+  if (table_info.table_id < 0 ||
+      !(ti.is_integer() || ti.is_decimal() || ti.is_time() || ti.is_boolean() ||
+        ti.is_dict_encoded_string())) {
+    return std::nullopt;
+  }
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  for (const auto& fragment : table_info.info.fragments) {
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+    const auto it = chunk_metadata_map.find(col_var->get_column_id());
+    if (it == chunk_metadata_map.end() || !it->second) {
+      return std::nullopt;
+    }
+    if (!it->second->numElements) {
+      continue;
+    }
+    min = std::min(min, extract_min_stat(it->second->chunkStats, ti));
+    max = std::max(max, extract_max_stat(it->second->chunkStats, ti));
+  }
+  if (min > max) {
+    return std::nullopt;
+  }
+  return std::make_pair(min, max);
+}
+
+double get_row_count(const InputTableInfo& table_info) {
+  return std::max(table_info.info.getNumTuplesUpperBound(), size_t(1));
+}
+
+// Statistics computed by ANALYZE TABLE for the column, if any.
+std::shared_ptr<const ColumnStatistics> get_column_statistics(
+    const Analyzer::ColumnVar* col_var,
+    const Catalog_Namespace::Catalog* cat) {
+  if (!cat || col_var->get_table_id() < 0) {
+    return nullptr;
+  }
+  return cat->getColumnStatistics(col_var->get_table_id(), col_var->get_column_id());
+}
+
+// Number of distinct values of a column, from its statistics if it has any or from the
+// rows of the result of an earlier step, otherwise bounded by the range of its values.
+// Bounded by the number of rows of its table.
+double get_column_ndv(const Analyzer::ColumnVar* col_var,
+                      const InputTableInfo& table_info,
+                      const Catalog_Namespace::Catalog* cat) {
+  const auto row_count = get_row_count(table_info);
+  const auto& fragments = table_info.info.fragments;
+  if (col_var->get_table_id() < 0 && fragments.size() == 1 &&
+      fragments.front().resultSet) {
+    const auto ndv = fragments.front().resultSet->getColumnNdvEstimate(
+        static_cast<size_t>(col_var->get_column_id()));
+    return std::min(row_count, std::max(1., static_cast<double>(ndv)));
+  }
+  if (const auto statistics = get_column_statistics(col_var, cat)) {
+    return std::min(row_count, std::max(1., static_cast<double>(statistics->getNdv())));
+  }
+  const auto range = get_column_stats_range(col_var, table_info);
+  if (!range) {
+    return row_count;
+  }
+  return std::min(row_count, static_cast<double>(range->second) - range->first + 1);
+}
+
+// Estimates the fraction of the rows of a table a filter on its columns keeps.
+double get_filter_selectivity(const Analyzer::Expr* qual,
+                              const InputTableInfo& table_info,
+                              const Catalog_Namespace::Catalog* cat) {
+  if (const auto u_oper = dynamic_cast<const Analyzer::UOper*>(qual)) {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(u_oper->get_operand());
+    const auto statistics = col_var ? get_column_statistics(col_var, cat) : nullptr;
+    if (u_oper->get_optype() == kISNULL && statistics) {
+      return statistics->getNullFraction();
+    }
+    return kDefaultFilterSelectivity;
+  }
+  if (const auto in_values = dynamic_cast<const Analyzer::InValues*>(qual)) {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(in_values->get_arg());
+    const auto value_count = in_values->get_value_list().size();
+    return std::min(1.,
+                    col_var ? value_count / get_column_ndv(col_var, table_info, cat)
+                            : value_count * kDefaultEqualitySelectivity);
+  }
+  const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual);
+  if (!bin_oper) {
+    return kDefaultFilterSelectivity;
+  }
+  auto optype = bin_oper->get_optype();
+  auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(bin_oper->get_left_operand());
+  auto constant = dynamic_cast<const Analyzer::Constant*>(bin_oper->get_right_operand());
+  if (!col_var) {
+    col_var = dynamic_cast<const Analyzer::ColumnVar*>(bin_oper->get_right_operand());
+    constant = dynamic_cast<const Analyzer::Constant*>(bin_oper->get_left_operand());
+    optype = COMMUTE_COMPARISON(optype);
+  }
+  if (!col_var || !constant || constant->get_is_null()) {
+    return kDefaultFilterSelectivity;
+  }
+  switch (optype) {
+    case kEQ:
+      return 1. / get_column_ndv(col_var, table_info, cat);
+    case kNE:
+      return 1. - 1. / get_column_ndv(col_var, table_info, cat);
+    case kLT:
+    case kLE:
+    case kGT:
+    case kGE: {
+      const auto& col_ti = col_var->get_type_info();
+      const auto& constant_ti = constant->get_type_info();
+      if (col_ti.is_string() || constant_ti.get_type() != col_ti.get_type() ||
+          constant_ti.get_scale() != col_ti.get_scale()) {
+        return kDefaultRangeSelectivity;
+      }
+      const auto statistics = get_column_statistics(col_var, cat);
+      if (statistics && !statistics->histogram_bounds.empty()) {
+        const auto& datum = constant->get_constval();
+        const double value =
+            col_ti.is_fp()
+                ? (col_ti.get_type() == kFLOAT ? datum.floatval : datum.doubleval)
+                : static_cast<double>(extract_from_datum(datum, constant_ti));
+        const auto fraction = statistics->getFractionBelow(value);
+        return (1. - statistics->getNullFraction()) *
+               (optype == kLT || optype == kLE ? fraction : 1. - fraction);
+      }
+      const auto range = get_column_stats_range(col_var, table_info);
+      if (!range) {
+        return kDefaultRangeSelectivity;
+      }
+      const auto value = extract_from_datum(constant->get_constval(), constant_ti);
+      const double below = (static_cast<double>(value) - range->first) /
+                           (static_cast<double>(range->second) - range->first + 1);
+      const auto fraction = std::min(1., std::max(0., below));
+      return optype == kLT || optype == kLE ? fraction : 1. - fraction;
+    }
+    default:
+      return kDefaultFilterSelectivity;
+  }
+}
+
+// Estimates the fraction of the pairs of rows of two tables a join qualifier keeps.
+double get_join_selectivity(const Analyzer::Expr* qual,
+                            const std::vector<InputTableInfo>& table_infos,
+                            const Catalog_Namespace::Catalog* cat) {
+  const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual);
+  if (!bin_oper || !IS_EQUIVALENCE(bin_oper->get_optype())) {
+    return kDefaultRangeSelectivity;
+  }
+  const auto lhs = dynamic_cast<const Analyzer::ColumnVar*>(bin_oper->get_left_operand());
+  const auto rhs =
+      dynamic_cast<const Analyzer::ColumnVar*>(bin_oper->get_right_operand());
+  if (!lhs || !rhs) {
+    return kDefaultEqualitySelectivity;
+  }
+  CHECK_LT(static_cast<size_t>(lhs->get_rte_idx()), table_infos.size());
+  CHECK_LT(static_cast<size_t>(rhs->get_rte_idx()), table_infos.size());
+  return 1. / std::max(get_column_ndv(lhs, table_infos[lhs->get_rte_idx()], cat),
+                       get_column_ndv(rhs, table_infos[rhs->get_rte_idx()], cat));
+}
+
+// Orders the inner tables of an inner join of up to g_join_order_dp_max_tables tables
+// by dynamic programming over the sets of tables joined so far. The outer table is the
+// one the traversal would start with. The cost of an order is the number of rows which
+// reach each of its hash join levels, estimated from the number of rows of the tables,
+// the selectivity of the filters on them and the number of distinct values of the join
+// columns, from the column statistics if the tables were analyzed or sampled from the
+// results of earlier steps. Tables are only added next to tables they have a qualifier
+// with. Returns nothing if the join has left or geo joins, or isn't connected.
+std::optional<std::vector<node_t>> get_cost_based_permutation(
+    const JoinQualsPerNestingLevel& left_deep_join_quals,
+    const std::vector<InputTableInfo>& table_infos,
+    const std::vector<std::map<node_t, cost_t>>& join_cost_graph,
+    const node_t outer,
+    const Catalog_Namespace::Catalog* cat) {
+  const size_t table_count = table_infos.size();
+  if (table_count < 3 ||
+      table_count > std::min(g_join_order_dp_max_tables, kMaxCostBasedTables)) {
+    return std::nullopt;
+  }
+  for (const auto& join_condition : left_deep_join_quals) {
+    if (join_condition.type != JoinType::INNER) {
+      return std::nullopt;
+    }
+  }
+  for (node_t lhs = 0; lhs < table_count; ++lhs) {
+    for (const auto& [rhs, cost] : join_cost_graph[lhs]) {
+      const auto reverse_it = join_cost_graph[rhs].find(lhs);
+      if (reverse_it == join_cost_graph[rhs].end() || reverse_it->second != cost) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  std::vector<double> table_rows(table_count);
+  for (node_t node = 0; node < table_count; ++node) {
+    table_rows[node] = get_row_count(table_infos[node]);
+  }
+  std::vector<std::vector<double>> join_selectivity(table_count,
+                                                    std::vector<double>(table_count, 1.));
+  AllRangeTableIndexVisitor visitor;
+  for (const auto& join_condition : left_deep_join_quals) {
+    for (const auto& qual : join_condition.quals) {
+      const auto qual_nest_levels = visitor.visit(qual.get());
+      if (qual_nest_levels.size() == 1) {
+        const auto node = *qual_nest_levels.begin();
+        CHECK_LT(static_cast<size_t>(node), table_count);
+        table_rows[node] *= get_filter_selectivity(qual.get(), table_infos[node], cat);
+      } else if (qual_nest_levels.size() == 2) {
+        const auto lhs = *qual_nest_levels.begin();
+        const auto rhs = *qual_nest_levels.rbegin();
+        const auto selectivity = get_join_selectivity(qual.get(), table_infos, cat);
+        join_selectivity[lhs][rhs] *= selectivity;
+        join_selectivity[rhs][lhs] *= selectivity;
+      }
+    }
+  }
+
+  // Sets of tables joined to the outer one are bit masks, the outer table isn't in them.
+  using table_set_t = uint32_t;
+  const table_set_t all_tables = ((table_set_t(1) << table_count) - 1) &
+                                 ~(table_set_t(1) << outer);
+  const auto contains = [](const table_set_t tables, const node_t node) {
+    return (tables >> node) & 1;
+  };
+  struct Plan {
+    double cost{std::numeric_limits<double>::infinity()};
+    double rows{0};
+    node_t last{0};
+  };
+  std::vector<Plan> plans(size_t(1) << table_count);
+  plans[0] = {0, std::max(table_rows[outer], 1.), outer};
+  for (table_set_t tables = 0; tables < plans.size(); ++tables) {
+    if (contains(tables, outer) || std::isinf(plans[tables].cost)) {
+      continue;
+    }
+    for (node_t node = 0; node < table_count; ++node) {
+      if (node == outer || contains(tables, node)) {
+        continue;
+      }
+      bool connected{false};
+      double rows = plans[tables].rows * table_rows[node];
+      for (node_t joined = 0; joined < table_count; ++joined) {
+        if (joined == outer || contains(tables, joined)) {
+          connected |= join_cost_graph[node].count(joined) > 0;
+          rows *= join_selectivity[node][joined];
+        }
+      }
+      if (!connected) {
+        continue;
+      }
+      auto& plan = plans[tables | (table_set_t(1) << node)];
+      const auto cost = plans[tables].cost + plans[tables].rows;
+      if (cost < plan.cost) {
+        plan = {cost, std::max(rows, 1.), node};
+      }
+    }
+  }
+  if (std::isinf(plans[all_tables].cost)) {
+    return std::nullopt;
+  }
+  std::vector<node_t> input_permutation;
+  for (table_set_t tables = all_tables; tables;
+       tables &= ~(table_set_t(1) << plans[tables].last)) {
+    input_permutation.push_back(plans[tables].last);
+  }
+  input_permutation.push_back(outer);
+  std::reverse(input_permutation.begin(), input_permutation.end());
+  return input_permutation;
+}
+
 }  // namespace
 
 std::vector<node_t> get_node_input_permutation(
@@ -249,6 +535,23 @@ std::vector<node_t> get_node_input_permutation(
     return table_infos[lhs_nest_level].info.getNumTuplesUpperBound() <
            table_infos[rhs_nest_level].info.getNumTuplesUpperBound();
   };
+  if (table_infos.size() >= 3 &&
+      table_infos.size() <= std::min(g_join_order_dp_max_tables, kMaxCostBasedTables)) {
+    std::vector<node_t> all_nest_levels(table_infos.size());
+    std::iota(all_nest_levels.begin(), all_nest_levels.end(), 0);
+    // Start with the table with most tuples, as the traversal does.
+    const auto outer =
+        *std::max_element(all_nest_levels.begin(), all_nest_levels.end(), compare_node);
+    const auto input_permutation =
+        get_cost_based_permutation(left_deep_join_quals,
+                                   table_infos,
+                                   join_cost_graph,
+                                   outer,
+                                   executor ? executor->getCatalog() : nullptr);
+    if (input_permutation) {
+      return *input_permutation;
+    }
+  }
   const auto compare_edge = [&compare_node](const TraversalEdge& lhs_edge,
                                             const TraversalEdge& rhs_edge) {
     // Only use the number of tuples as a tie-breaker, if costs are equal.
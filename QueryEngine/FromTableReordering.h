@@ -19,6 +19,10 @@
 #include "InputMetadata.h"
 #include "RelAlgExecutionUnit.h"
 
+// Inner joins of up to this many tables are ordered by their estimated cost rather than
+// by the traversal of their join graph, 0 disables it.
+extern size_t g_join_order_dp_max_tables;
+
 // Returns a FROM permutation for the given join qualifiers and table sizes.
 std::vector<size_t> get_node_input_permutation(
     const JoinQualsPerNestingLevel& left_deep_join_quals,
@@ -163,6 +163,188 @@ bool toWkb(WKB& wkb,
   return false;
 }
 
+// Builds the GEOS geometry of an argument straight from its coordinates, without the
+// OGR geometry and the WKB toWkb goes through. nullptr for anything it doesn't build,
+// which then goes through WKB.
+GEOSGeometry* toGeos(GEOSContextHandle_t context,
+                     int type,  // internal geometry type
+                     int8_t* coords,
+                     int64_t coords_size,
+                     int32_t* meta1,      // e.g. ring_sizes
+                     int64_t meta1_size,  // e.g. num_rings
+                     int32_t* meta2,      // e.g. rings (number of rings in each poly)
+                     int64_t meta2_size,  // e.g. num_polys
+                     int32_t ic) {        // input compression
+  // decompressed double coords
+  auto cv = Geospatial::decompress_coords<double, int32_t>(ic, coords, coords_size);
+  const auto num_points = static_cast<int64_t>(cv->size() / 2);
+  // Sequence of `count` points from point `first`, closed by repeating the first one if
+  // `close` is set.
+  auto make_coord_seq = [context, &cv](int64_t first, int64_t count, bool close) {
+    const auto size = count + (close ? 1 : 0);
+    auto seq = GEOSCoordSeq_create_r(context, size, 2);
+    if (seq) {
+      for (int64_t i = 0; i < size; i++) {
+        const auto point = first + (i == count ? 0 : i);
+        GEOSCoordSeq_setX_r(context, seq, i, (*cv)[2 * point]);
+        GEOSCoordSeq_setY_r(context, seq, i, (*cv)[2 * point + 1]);
+      }
+    }
+    return seq;
+  };
+  // Polygon of `num_rings` rings from ring `first_ring`, starting at point `first`.
+  auto make_polygon = [&](int64_t first, int64_t first_ring, int64_t num_rings) {
+    std::vector<GEOSGeometry*> rings;
+    for (int64_t r = first_ring; r < first_ring + num_rings; r++) {
+      // rings are stored open
+      rings.push_back(
+          GEOSGeom_createLinearRing_r(context, make_coord_seq(first, meta1[r], true)));
+      first += meta1[r];
+    }
+    return GEOSGeom_createPolygon_r(
+        context, rings.front(), rings.data() + 1, static_cast<unsigned>(num_rings - 1));
+  };
+
+  if (static_cast<SQLTypes>(type) == kPOINT) {
+    if (num_points != 1) {
+      return nullptr;
+    }
+    return GEOSGeom_createPoint_r(context, make_coord_seq(0, 1, false));
+  }
+  if (static_cast<SQLTypes>(type) == kLINESTRING) {
+    return GEOSGeom_createLineString_r(context, make_coord_seq(0, num_points, false));
+  }
+  // the ring sizes have to add up to the coords
+  int64_t ring_points = 0;
+  for (int64_t r = 0; r < meta1_size; r++) {
+    if (meta1[r] < 3) {
+      return nullptr;
+    }
+    ring_points += meta1[r];
+  }
+  if (meta1_size < 1 || ring_points != num_points) {
+    return nullptr;
+  }
+  if (static_cast<SQLTypes>(type) == kPOLYGON) {
+    return make_polygon(0, 0, meta1_size);
+  }
+  if (static_cast<SQLTypes>(type) == kMULTIPOLYGON) {
+    // Recognize GEOMETRYCOLLECTION EMPTY encoding, as toWkb does
+    if (meta1_size == 1 && meta2_size == 1) {
+      const std::vector<double> ecv = {0.0, 0.0, 0.00000012345, 0.0, 0.0, 0.00000012345};
+      if (*cv == ecv) {
+        return GEOSGeom_createEmptyCollection_r(context, GEOS_GEOMETRYCOLLECTION);
+      }
+    }
+    // the rings of the polys have to add up to the rings
+    int64_t poly_rings = 0;
+    for (int64_t p = 0; p < meta2_size; p++) {
+      if (meta2[p] < 1) {
+        return nullptr;
+      }
+      poly_rings += meta2[p];
+    }
+    if (meta2_size < 1 || poly_rings != meta1_size) {
+      return nullptr;
+    }
+    std::vector<GEOSGeometry*> polys;
+    int64_t first = 0;
+    int64_t first_ring = 0;
+    for (int64_t p = 0; p < meta2_size; p++) {
+      polys.push_back(make_polygon(first, first_ring, meta2[p]));
+      for (int64_t r = first_ring; r < first_ring + meta2[p]; r++) {
+        first += meta1[r];
+      }
+      first_ring += meta2[p];
+    }
+    return GEOSGeom_createCollection_r(
+        context, GEOS_MULTIPOLYGON, polys.data(), static_cast<unsigned>(meta2_size));
+  }
+  return nullptr;
+}
+
+// GEOS geometry of an argument, built through WKB if it is projected to the best planar
+// srid first or if toGeos doesn't build it.
+GEOSGeometry* make_geometry(GEOSContextHandle_t context,
+                            int type,
+                            int8_t* coords,
+                            int64_t coords_size,
+                            int32_t* meta1,
+                            int64_t meta1_size,
+                            int32_t* meta2,
+                            int64_t meta2_size,
+                            int32_t ic,
+                            int32_t* best_planar_srid_ptr) {
+  if (!best_planar_srid_ptr) {
+    auto g = toGeos(
+        context, type, coords, coords_size, meta1, meta1_size, meta2, meta2_size, ic);
+    if (g) {
+      return g;
+    }
+  }
+  WKB wkb{};
+  if (!toWkb(wkb,
+             type,
+             coords,
+             coords_size,
+             meta1,
+             meta1_size,
+             meta2,
+             meta2_size,
+             ic,
+             best_planar_srid_ptr)) {
+    return nullptr;
+  }
+  return GEOSGeomFromWKB_buf_r(context, wkb.data(), wkb.size());
+}
+
+// Copies the columns of a result into buffers, each one malloced, caller is responsible
+// for freeing.
+bool write_result(const std::vector<double>& coords,
+                  const std::vector<int32_t>& ring_sizes,
+                  const std::vector<int32_t>& poly_rings,
+                  int* result_type,
+                  int8_t** result_coords,
+                  int64_t* result_coords_size,
+                  int32_t** result_meta1,
+                  int64_t* result_meta1_size,
+                  int32_t** result_meta2,
+                  int64_t* result_meta2_size) {
+  // TODO: consider using a single buffer to hold all components,
+  // instead of allocating and registering each component buffer separately
+
+  *result_type = static_cast<int>(kMULTIPOLYGON);
+
+  *result_coords = nullptr;
+  int64_t size = coords.size() * sizeof(double);
+  if (size > 0) {
+    auto buf = checked_malloc(size);
+    std::memcpy(buf, coords.data(), size);
+    *result_coords = reinterpret_cast<int8_t*>(buf);
+  }
+  *result_coords_size = size;
+
+  *result_meta1 = nullptr;
+  size = ring_sizes.size() * sizeof(int32_t);
+  if (size > 0) {
+    auto buf = checked_malloc(size);
+    std::memcpy(buf, ring_sizes.data(), size);
+    *result_meta1 = reinterpret_cast<int32_t*>(buf);
+  }
+  *result_meta1_size = ring_sizes.size();
+
+  *result_meta2 = nullptr;
+  size = poly_rings.size() * sizeof(int32_t);
+  if (size > 0) {
+    auto buf = checked_malloc(size);
+    std::memcpy(buf, poly_rings.data(), size);
+    *result_meta2 = reinterpret_cast<int32_t*>(buf);
+  }
+  *result_meta2_size = poly_rings.size();
+
+  return true;
+}
+
 // Conversion form wkb to internal vector representation.
 // Each vector components is malloced, caller is reponsible for freeing.
 bool fromWkb(WKB& wkb,
@@ -216,39 +398,198 @@ bool fromWkb(WKB& wkb,
     return false;
   }
 
-  // TODO: consider using a single buffer to hold all components,
-  // instead of allocating and registering each component buffer separately
-
-  *result_type = static_cast<int>(kMULTIPOLYGON);
+  return write_result(coords,
+                      ring_sizes,
+                      poly_rings,
+                      result_type,
+                      result_coords,
+                      result_coords_size,
+                      result_meta1,
+                      result_meta1_size,
+                      result_meta2,
+                      result_meta2_size);
+}
 
-  *result_coords = nullptr;
-  int64_t size = coords.size() * sizeof(double);
-  if (size > 0) {
-    auto buf = checked_malloc(size);
-    std::memcpy(buf, coords.data(), size);
-    *result_coords = reinterpret_cast<int8_t*>(buf);
+// Appends a ring of a result to the columns the way getColumns of the geo types does:
+// open, exterior rings counterclockwise and interior rings clockwise. false for the
+// degenerate rings, which are left to fromWkb.
+bool append_ring(GEOSContextHandle_t context,
+                 const GEOSGeometry* ring,
+                 bool exterior,
+                 std::vector<double>& coords,
+                 std::vector<int32_t>& ring_sizes) {
+  const auto seq = ring ? GEOSGeom_getCoordSeq_r(context, ring) : nullptr;
+  unsigned int num_points = 0;
+  if (!seq || !GEOSCoordSeq_getSize_r(context, seq, &num_points)) {
+    return false;
   }
-  *result_coords_size = size;
-
-  *result_meta1 = nullptr;
-  size = ring_sizes.size() * sizeof(int32_t);
-  if (size > 0) {
-    auto buf = checked_malloc(size);
-    std::memcpy(buf, ring_sizes.data(), size);
-    *result_meta1 = reinterpret_cast<int32_t*>(buf);
+  std::vector<double> ring_coords(2 * num_points);
+  for (unsigned int i = 0; i < num_points; i++) {
+    if (!GEOSCoordSeq_getX_r(context, seq, i, &ring_coords[2 * i]) ||
+        !GEOSCoordSeq_getY_r(context, seq, i, &ring_coords[2 * i + 1])) {
+      return false;
+    }
   }
-  *result_meta1_size = ring_sizes.size();
+  // Store all rings as open rings
+  if (num_points > 0 && ring_coords[0] == ring_coords[2 * num_points - 2] &&
+      ring_coords[1] == ring_coords[2 * num_points - 1]) {
+    num_points--;
+    ring_coords.resize(2 * num_points);
+  }
+  if (num_points < 3) {
+    return false;
+  }
+  // twice the signed area, positive if the ring is counterclockwise
+  double area = 0.0;
+  for (unsigned int i = 0; i < num_points; i++) {
+    const auto j = (i + 1) % num_points;
+    area += ring_coords[2 * i] * ring_coords[2 * j + 1] -
+            ring_coords[2 * j] * ring_coords[2 * i + 1];
+  }
+  if (area == 0.0) {
+    return false;
+  }
+  if ((area > 0.0) == exterior) {
+    coords.insert(coords.end(), ring_coords.begin(), ring_coords.end());
+  } else {
+    // Reverse the winding order, the first point stays first
+    coords.push_back(ring_coords[0]);
+    coords.push_back(ring_coords[1]);
+    for (auto i = num_points - 1; i > 0; i--) {
+      coords.push_back(ring_coords[2 * i]);
+      coords.push_back(ring_coords[2 * i + 1]);
+    }
+  }
+  ring_sizes.push_back(num_points);
+  return true;
+}
 
-  *result_meta2 = nullptr;
-  size = poly_rings.size() * sizeof(int32_t);
-  if (size > 0) {
-    auto buf = checked_malloc(size);
-    std::memcpy(buf, poly_rings.data(), size);
-    *result_meta2 = reinterpret_cast<int32_t*>(buf);
+// Writes a result straight from its GEOS geometry, the same columns fromWkb writes from
+// its WKB. false for anything it doesn't write, which then goes through fromWkb.
+bool fromGeos(GEOSContextHandle_t context,
+              const GEOSGeometry* g,
+              int* result_type,
+              int8_t** result_coords,
+              int64_t* result_coords_size,
+              int32_t** result_meta1,
+              int64_t* result_meta1_size,
+              int32_t** result_meta2,
+              int64_t* result_meta2_size) {
+  std::vector<double> coords{};
+  std::vector<int32_t> ring_sizes{};
+  std::vector<int32_t> poly_rings{};
+  auto append_poly = [&](const GEOSGeometry* poly) {
+    const auto num_interior_rings = GEOSGetNumInteriorRings_r(context, poly);
+    if (num_interior_rings < 0 ||
+        !append_ring(
+            context, GEOSGetExteriorRing_r(context, poly), true, coords, ring_sizes)) {
+      return false;
+    }
+    for (int r = 0; r < num_interior_rings; r++) {
+      if (!append_ring(context,
+                       GEOSGetInteriorRingN_r(context, poly, r),
+                       false,
+                       coords,
+                       ring_sizes)) {
+        return false;
+      }
+    }
+    poly_rings.push_back(num_interior_rings + 1);
+    return true;
+  };
+
+  // Forcing MULTIPOLYGON result until we can handle any geo, as fromWkb does.
+  const auto is_empty = GEOSisEmpty_r(context, g);
+  const auto type = GEOSGeomTypeId_r(context, g);
+  if (is_empty == 1) {
+    coords = {0.0, 0.0, 0.00000012345, 0.0, 0.0, 0.00000012345};
+    ring_sizes.push_back(3);
+    poly_rings.push_back(1);
+  } else if (is_empty != 0) {
+    return false;
+  } else if (type == GEOS_POINT) {
+    const auto seq = GEOSGeom_getCoordSeq_r(context, g);
+    double x = 0.0;
+    double y = 0.0;
+    if (!seq || !GEOSCoordSeq_getX_r(context, seq, 0, &x) ||
+        !GEOSCoordSeq_getY_r(context, seq, 0, &y)) {
+      return false;
+    }
+    coords = {x, y, x + 0.0000001, y, x, y + 0.0000001};
+    ring_sizes.push_back(3);
+    poly_rings.push_back(ring_sizes.size());
+  } else if (type == GEOS_POLYGON) {
+    if (!append_poly(g)) {
+      return false;
+    }
+  } else if (type == GEOS_MULTIPOLYGON) {
+    const auto num_polys = GEOSGetNumGeometries_r(context, g);
+    if (num_polys < 1) {
+      return false;
+    }
+    for (int p = 0; p < num_polys; p++) {
+      const auto poly = GEOSGetGeometryN_r(context, g, p);
+      if (!poly || !append_poly(poly)) {
+        return false;
+      }
+    }
+  } else {
+    return false;
   }
-  *result_meta2_size = poly_rings.size();
+  return write_result(coords,
+                      ring_sizes,
+                      poly_rings,
+                      result_type,
+                      result_coords,
+                      result_coords_size,
+                      result_meta1,
+                      result_meta1_size,
+                      result_meta2,
+                      result_meta2_size);
+}
 
-  return true;
+// Writes the result of a GEOS operation, through WKB if it is back-projected from the
+// best planar srid or if fromGeos doesn't write it.
+bool write_geometry(GEOSContextHandle_t context,
+                    const GEOSGeometry* g,
+                    int* result_type,
+                    int8_t** result_coords,
+                    int64_t* result_coords_size,
+                    int32_t** result_meta1,
+                    int64_t* result_meta1_size,
+                    int32_t** result_meta2,
+                    int64_t* result_meta2_size,
+                    int32_t* best_planar_srid_ptr) {
+  if (!best_planar_srid_ptr && fromGeos(context,
+                                        g,
+                                        result_type,
+                                        result_coords,
+                                        result_coords_size,
+                                        result_meta1,
+                                        result_meta1_size,
+                                        result_meta2,
+                                        result_meta2_size)) {
+    return true;
+  }
+  size_t wkb_size = 0ULL;
+  auto wkb_buf = GEOSGeomToWKB_buf_r(context, g, &wkb_size);
+  if (!wkb_buf) {
+    return false;
+  }
+  WKB wkb(wkb_buf, wkb_buf + wkb_size);
+  free(wkb_buf);
+  if (wkb.empty()) {
+    return false;
+  }
+  return fromWkb(wkb,
+                 result_type,
+                 result_coords,
+                 result_coords_size,
+                 result_meta1,
+                 result_meta1_size,
+                 result_meta2,
+                 result_meta2_size,
+                 best_planar_srid_ptr);
 }
 
 GEOSGeometry* postprocess(GEOSContextHandle_t context, GEOSGeometry* g) {
@@ -303,40 +644,32 @@ extern "C" bool Geos_Wkb_Wkb(int op,
   // What if intersection is empty? Return null buffer pointers? Return false?
   // What if geos fails?
 
-  WKB wkb1{};
-  if (!toWkb(wkb1,
-             arg1_type,
-             arg1_coords,
-             arg1_coords_size,
-             arg1_meta1,
-             arg1_meta1_size,
-             arg1_meta2,
-             arg1_meta2_size,
-             arg1_ic,
-             nullptr)) {
-    return false;
-  }
-  WKB wkb2{};
-  if (!toWkb(wkb2,
-             arg2_type,
-             arg2_coords,
-             arg2_coords_size,
-             arg2_meta1,
-             arg2_meta1_size,
-             arg2_meta2,
-             arg2_meta2_size,
-             arg2_ic,
-             nullptr)) {
-    return false;
-  }
   auto status = false;
   auto context = create_context();
   if (!context) {
     return status;
   }
-  auto* g1 = GEOSGeomFromWKB_buf_r(context, wkb1.data(), wkb1.size());
+  auto* g1 = make_geometry(context,
+                           arg1_type,
+                           arg1_coords,
+                           arg1_coords_size,
+                           arg1_meta1,
+                           arg1_meta1_size,
+                           arg1_meta2,
+                           arg1_meta2_size,
+                           arg1_ic,
+                           nullptr);
   if (g1) {
-    auto* g2 = GEOSGeomFromWKB_buf_r(context, wkb2.data(), wkb2.size());
+    auto* g2 = make_geometry(context,
+                             arg2_type,
+                             arg2_coords,
+                             arg2_coords_size,
+                             arg2_meta1,
+                             arg2_meta1_size,
+                             arg2_meta2,
+                             arg2_meta2_size,
+                             arg2_ic,
+                             nullptr);
     if (g2) {
       GEOSGeometry* g = nullptr;
       if (static_cast<GeoBase::GeoOp>(op) == GeoBase::GeoOp::kINTERSECTION) {
@@ -348,21 +681,16 @@ extern "C" bool Geos_Wkb_Wkb(int op,
       }
       g = postprocess(context, g);
       if (g) {
-        size_t wkb_size = 0ULL;
-        auto wkb_buf = GEOSGeomToWKB_buf_r(context, g, &wkb_size);
-        if (wkb_buf && wkb_size > 0ULL) {
-          WKB wkb(wkb_buf, wkb_buf + wkb_size);
-          free(wkb_buf);
-          status = fromWkb(wkb,
-                           result_type,
-                           result_coords,
-                           result_coords_size,
-                           result_meta1,
-                           result_meta1_size,
-                           result_meta2,
-                           result_meta2_size,
-                           nullptr);
-        }
+        status = write_geometry(context,
+                                g,
+                                result_type,
+                                result_coords,
+                                result_coords_size,
+                                result_meta1,
+                                result_meta1_size,
+                                result_meta2,
+                                result_meta2_size,
+                                nullptr);
         GEOSGeom_destroy_r(context, g);
       }
       GEOSGeom_destroy_r(context, g2);
@@ -404,27 +732,22 @@ extern "C" bool Geos_Wkb_double(int op,
     // running geos operation, back-project the result to 4326
     best_planar_srid_ptr = &best_planar_srid;
   }
-  WKB wkb1{};
-  // Project to best planar srid before running certain geos ops
-  if (!toWkb(wkb1,
-             arg1_type,
-             arg1_coords,
-             arg1_coords_size,
-             arg1_meta1,
-             arg1_meta1_size,
-             arg1_meta2,
-             arg1_meta2_size,
-             arg1_ic,
-             best_planar_srid_ptr)) {
-    return false;
-  }
-
   auto status = false;
   auto context = create_context();
   if (!context) {
     return status;
   }
-  auto* g1 = GEOSGeomFromWKB_buf_r(context, wkb1.data(), wkb1.size());
+  // Project to best planar srid before running certain geos ops
+  auto* g1 = make_geometry(context,
+                           arg1_type,
+                           arg1_coords,
+                           arg1_coords_size,
+                           arg1_meta1,
+                           arg1_meta1_size,
+                           arg1_meta2,
+                           arg1_meta2_size,
+                           arg1_ic,
+                           best_planar_srid_ptr);
   if (g1) {
     GEOSGeometry* g = nullptr;
     if (static_cast<GeoBase::GeoOp>(op) == GeoBase::GeoOp::kBUFFER) {
@@ -433,22 +756,17 @@ extern "C" bool Geos_Wkb_double(int op,
     }
     g = postprocess(context, g);
     if (g) {
-      size_t wkb_size = 0ULL;
-      auto wkb_buf = GEOSGeomToWKB_buf_r(context, g, &wkb_size);
-      if (wkb_buf && wkb_size > 0ULL) {
-        WKB wkb(wkb_buf, wkb_buf + wkb_size);
-        free(wkb_buf);
-        // Back-project the result from planar to 4326 if necessary
-        status = fromWkb(wkb,
-                         result_type,
-                         result_coords,
-                         result_coords_size,
-                         result_meta1,
-                         result_meta1_size,
-                         result_meta2,
-                         result_meta2_size,
-                         best_planar_srid_ptr);
-      }
+      // Back-project the result from planar to 4326 if necessary
+      status = write_geometry(context,
+                              g,
+                              result_type,
+                              result_coords,
+                              result_coords_size,
+                              result_meta1,
+                              result_meta1_size,
+                              result_meta2,
+                              result_meta2_size,
+                              best_planar_srid_ptr);
       GEOSGeom_destroy_r(context, g);
     }
     GEOSGeom_destroy_r(context, g1);
@@ -473,17 +791,7 @@ extern "C" bool Geos_Wkb(int op,
                          int32_t arg_srid,
                          bool* result) {
 #ifndef __CUDACC__
-  WKB wkb1{};
-  if (!result || !toWkb(wkb1,
-                        arg_type,
-                        arg_coords,
-                        arg_coords_size,
-                        arg_meta1,
-                        arg_meta1_size,
-                        arg_meta2,
-                        arg_meta2_size,
-                        arg_ic,
-                        nullptr)) {
+  if (!result) {
     return false;
   }
 
@@ -492,7 +800,16 @@ extern "C" bool Geos_Wkb(int op,
   if (!context) {
     return status;
   }
-  auto* g1 = GEOSGeomFromWKB_buf_r(context, wkb1.data(), wkb1.size());
+  auto* g1 = make_geometry(context,
+                           arg_type,
+                           arg_coords,
+                           arg_coords_size,
+                           arg_meta1,
+                           arg_meta1_size,
+                           arg_meta2,
+                           arg_meta2_size,
+                           arg_ic,
+                           nullptr);
   if (g1) {
     if (static_cast<GeoBase::GeoOp>(op) == GeoBase::GeoOp::kISEMPTY) {
       *result = GEOSisEmpty_r(context, g1);
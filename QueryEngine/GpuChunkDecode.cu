@@ -0,0 +1,98 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DecodersImpl.h"
+#include "GpuChunkDecode.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+template <typename T>
+__global__ void decode_integer_chunk(T* dst,
+                                     const int8_t* src,
+                                     const integer_codecs::IntegerCodec codec,
+                                     const int64_t num_elems,
+                                     const int64_t null_val) {
+  const int64_t start = blockIdx.x * blockDim.x + threadIdx.x;
+  const int64_t step = blockDim.x * gridDim.x;
+  for (int64_t pos = start; pos < num_elems; pos += step) {
+    int64_t val{0};
+    switch (codec) {
+      case integer_codecs::IntegerCodec::FrameOfReference:
+        val = frame_of_reference_int_decode_gpu(src, null_val, pos);
+        break;
+      case integer_codecs::IntegerCodec::Delta:
+        val = delta_int_decode_gpu(src, integer_codecs::kDeltaBlockSize, pos);
+        break;
+      case integer_codecs::IntegerCodec::RunLength:
+        val = run_length_int_decode_gpu(src, pos);
+        break;
+    }
+    dst[pos] = static_cast<T>(val);
+  }
+}
+
+void check_cuda_error(const cudaError_t err) {
+  if (err != cudaSuccess) {
+    throw std::runtime_error(std::string("Chunk decode failed: ") +
+                             cudaGetErrorString(err));
+  }
+}
+
+template <typename T>
+void decode_integer_chunk_on_device_impl(int8_t* dst,
+                                         const int8_t* src,
+                                         const integer_codecs::IntegerCodec codec,
+                                         const size_t num_elems,
+                                         const int64_t null_val) {
+  int grid_size = -1;
+  int block_size = -1;
+  check_cuda_error(cudaOccupancyMaxPotentialBlockSize(
+      &grid_size, &block_size, decode_integer_chunk<T>));
+  decode_integer_chunk<T><<<grid_size, block_size>>>(
+      reinterpret_cast<T*>(dst), src, codec, num_elems, null_val);
+  check_cuda_error(cudaGetLastError());
+  check_cuda_error(cudaStreamSynchronize(0));
+}
+
+}  // namespace
+
+void decode_integer_chunk_on_device(int8_t* dst,
+                                    const int8_t* src,
+                                    const integer_codecs::IntegerCodec codec,
+                                    const size_t byte_width,
+                                    const size_t num_elems,
+                                    const int64_t null_val) {
+  switch (byte_width) {
+    case 1:
+      decode_integer_chunk_on_device_impl<int8_t>(dst, src, codec, num_elems, null_val);
+      break;
+    case 2:
+      decode_integer_chunk_on_device_impl<int16_t>(dst, src, codec, num_elems, null_val);
+      break;
+    case 4:
+      decode_integer_chunk_on_device_impl<int32_t>(dst, src, codec, num_elems, null_val);
+      break;
+    case 8:
+      decode_integer_chunk_on_device_impl<int64_t>(dst, src, codec, num_elems, null_val);
+      break;
+    default:
+      throw std::runtime_error("Chunk decode of an unsupported byte width " +
+                               std::to_string(byte_width));
+  }
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    GpuChunkDecode.h
+ * @brief   Decoding of the compressed copies of the chunks kept by the GPU buffer pools.
+ */
+
+#pragma once
+
+#include "DataMgr/IntegerCodecs.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Decodes the integer codec stream `src` to `num_elems` signed values of `byte_width`
+// bytes at `dst`, both in the memory of the current device, and waits for the decode.
+void decode_integer_chunk_on_device(int8_t* dst,
+                                    const int8_t* src,
+                                    const integer_codecs::IntegerCodec codec,
+                                    const size_t byte_width,
+                                    const size_t num_elems,
+                                    const int64_t null_val);
@@ -208,15 +208,17 @@ void init_group_by_buffer_on_device(int64_t* groups_buffer,
                                     const bool keyless,
                                     const int8_t warp_size,
                                     const size_t block_size_x,
-                                    const size_t grid_size_x) {
-  init_group_by_buffer_gpu<<<grid_size_x, block_size_x>>>(groups_buffer,
-                                                          init_vals,
-                                                          groups_buffer_entry_count,
-                                                          key_count,
-                                                          key_width,
-                                                          row_size_quad,
-                                                          keyless,
-                                                          warp_size);
+                                    const size_t grid_size_x,
+                                    CUstream_st* stream) {
+  init_group_by_buffer_gpu<<<grid_size_x, block_size_x, 0, stream>>>(
+      groups_buffer,
+      init_vals,
+      groups_buffer_entry_count,
+      key_count,
+      key_width,
+      row_size_quad,
+      keyless,
+      warp_size);
 }
 
 void init_columnar_group_by_buffer_on_device(int64_t* groups_buffer,
@@ -229,8 +231,9 @@ void init_columnar_group_by_buffer_on_device(int64_t* groups_buffer,
                                              const bool keyless,
                                              const int8_t key_size,
                                              const size_t block_size_x,
-                                             const size_t grid_size_x) {
-  init_columnar_group_by_buffer_gpu_wrapper<<<grid_size_x, block_size_x>>>(
+                                             const size_t grid_size_x,
+                                             CUstream_st* stream) {
+  init_columnar_group_by_buffer_gpu_wrapper<<<grid_size_x, block_size_x, 0, stream>>>(
       groups_buffer,
       init_vals,
       groups_buffer_entry_count,
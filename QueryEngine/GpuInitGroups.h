@@ -25,6 +25,8 @@
 #define GPUINITGROUPS_H
 #include <cstdint>
 
+struct CUstream_st;
+
 void init_group_by_buffer_on_device(int64_t* groups_buffer,
                                     const int64_t* init_vals,
                                     const uint32_t groups_buffer_entry_count,
@@ -34,7 +36,8 @@ void init_group_by_buffer_on_device(int64_t* groups_buffer,
                                     const bool keyless,
                                     const int8_t warp_size,
                                     const size_t block_size_x,
-                                    const size_t grid_size_x);
+                                    const size_t grid_size_x,
+                                    CUstream_st* stream = nullptr);
 
 void init_columnar_group_by_buffer_on_device(int64_t* groups_buffer,
                                              const int64_t* init_vals,
@@ -46,7 +49,8 @@ void init_columnar_group_by_buffer_on_device(int64_t* groups_buffer,
                                              const bool keyless,
                                              const int8_t key_size,
                                              const size_t block_size_x,
-                                             const size_t grid_size_x);
+                                             const size_t grid_size_x,
+                                             CUstream_st* stream = nullptr);
 
 void init_render_buffer_on_device(int64_t* render_buffer,
                                   const uint32_t qw_count,
@@ -15,6 +15,7 @@
  */
 
 #include "GpuSharedMemoryUtils.h"
+#include "Execute.h"
 #include "ResultSetReductionJIT.h"
 #include "RuntimeFunctions.h"
 
@@ -34,17 +35,21 @@ GpuSharedMemCodeBuilder::GpuSharedMemCodeBuilder(
   /**
    * This class currently works only with:
    * 1. row-wise output memory layout
-   * 2. GroupByPerfectHash
-   * 3. single-column group by
-   * 4. Keyless hash strategy (no redundant group column in the output buffer)
+   * 2. GroupByPerfectHash with the keyless hash strategy (no redundant group column in
+   * the output buffer), or GroupByBaselineHash
    *
-   * All conditions in 1, 3, and 4 can be easily relaxed if proper code is added to
+   * All conditions in 1 and 2 can be easily relaxed if proper code is added to
    * support them in the future.
    */
   CHECK(!query_mem_desc_.didOutputColumnar());
-  CHECK(query_mem_desc_.getQueryDescriptionType() ==
-        QueryDescriptionType::GroupByPerfectHash);
-  CHECK(query_mem_desc_.hasKeylessHash());
+  if (query_mem_desc_.getQueryDescriptionType() ==
+      QueryDescriptionType::GroupByPerfectHash) {
+    CHECK(query_mem_desc_.hasKeylessHash());
+  } else {
+    CHECK(query_mem_desc_.getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByBaselineHash);
+    CHECK(!query_mem_desc_.hasKeylessHash());
+  }
 }
 
 void GpuSharedMemCodeBuilder::codegen() {
@@ -89,6 +94,14 @@ void GpuSharedMemCodeBuilder::codegen() {
  * funcitons within this code with their agg_*_shared counterparts, which use atomics
  * operations and are used on the GPU.
  * 5. Once all threads are done, we return from the function.
+ *
+ * For baseline hash, every thread block builds its own partial hash table in the shared
+ * memory, and the entries are not at the same position in the global memory buffer.
+ * Instead of step 4, each thread skips its entry if it's empty, otherwise it finds (or
+ * claims) the entry of the same key in the global memory buffer with get_group_value
+ * and reduces the targets into it. If the global memory buffer is out of entries, the
+ * entry is dropped and the kernel reports ERR_OUT_OF_SLOTS through the error code
+ * buffer, the fourth argument.
  */
 void GpuSharedMemCodeBuilder::codegenReduction() {
   CHECK(reduction_func_);
@@ -102,6 +115,9 @@ void GpuSharedMemCodeBuilder::codegenReduction() {
   arg_it++;
   auto buffer_size = &*arg_it;
   buffer_size->setName("buffer_size");
+  arg_it++;
+  auto error_code = &*arg_it;
+  error_code->setName("error_code");
 
   auto bb_entry = llvm::BasicBlock::Create(context_, ".entry", reduction_func_);
   auto bb_body = llvm::BasicBlock::Create(context_, ".body", reduction_func_);
@@ -179,14 +195,26 @@ void GpuSharedMemCodeBuilder::codegenReduction() {
       }
     }
   }
-  const auto reduce_one_entry_idx_func = getFunction("reduce_one_entry_idx");
-  CHECK(reduce_one_entry_idx_func);
-
   // qmd_handles are only used with count distinct and baseline group by
   // serialized varlen buffer is only used with SAMPLE on varlen types, which we will
   // disable for current shared memory support.
   const auto null_ptr_ll =
       llvm::ConstantPointerNull::get(llvm::Type::getInt8PtrTy(context_, 0));
+  if (query_mem_desc_.getQueryDescriptionType() ==
+      QueryDescriptionType::GroupByBaselineHash) {
+    codegenBaselineReduction(ir_builder,
+                             dest_buffer_ptr,
+                             src_byte_stream,
+                             thread_idx,
+                             error_code,
+                             null_ptr_ll,
+                             bb_exit);
+    llvm::ReturnInst::Create(context_, bb_exit);
+    return;
+  }
+  const auto reduce_one_entry_idx_func = getFunction("reduce_one_entry_idx");
+  CHECK(reduce_one_entry_idx_func);
+
   const auto thread_idx_i32 = ir_builder.CreateCast(
       llvm::Instruction::CastOps::Trunc, thread_idx, get_int_type(32, context_));
   ir_builder.CreateCall(reduce_one_entry_idx_func,
@@ -202,6 +230,70 @@ void GpuSharedMemCodeBuilder::codegenReduction() {
   llvm::ReturnInst::Create(context_, bb_exit);
 }
 
+void GpuSharedMemCodeBuilder::codegenBaselineReduction(llvm::IRBuilder<>& ir_builder,
+                                                       llvm::Value* dest_buffer_ptr,
+                                                       llvm::Value* src_byte_stream,
+                                                       llvm::Value* thread_idx,
+                                                       llvm::Value* error_code,
+                                                       llvm::Value* null_ptr_ll,
+                                                       llvm::BasicBlock* bb_exit) {
+  const auto fixup_query_mem_desc =
+      ResultSet::fixupQueryMemoryDescriptor(query_mem_desc_);
+  auto bb_find_entry = llvm::BasicBlock::Create(context_, ".find_entry", reduction_func_);
+  auto bb_reduce_entry =
+      llvm::BasicBlock::Create(context_, ".reduce_entry", reduction_func_);
+  auto bb_out_of_slots =
+      llvm::BasicBlock::Create(context_, ".out_of_slots", reduction_func_);
+
+  const auto row_size_bytes =
+      ll_int(static_cast<size_t>(fixup_query_mem_desc.getRowWidth()), context_);
+  const auto src_row_ptr = ir_builder.CreateGEP(
+      src_byte_stream, ir_builder.CreateMul(row_size_bytes, thread_idx), "src_row_ptr");
+  const auto is_empty = ir_builder.CreateCall(
+      getFunction("is_empty_entry"), {src_row_ptr}, "is_src_entry_empty");
+  ir_builder.CreateCondBr(is_empty, bb_exit, bb_find_entry);
+
+  ir_builder.SetInsertPoint(bb_find_entry);
+  const auto key_count = fixup_query_mem_desc.getGroupbyColCount();
+  const auto key_width = fixup_query_mem_desc.getEffectiveKeyWidth();
+  const auto src_key_ptr = ir_builder.CreatePointerCast(
+      src_row_ptr, llvm::Type::getInt64PtrTy(context_), "src_key_ptr");
+  const auto dest_targets_ptr = ir_builder.CreateCall(
+      getFunction("get_group_value"),
+      {dest_buffer_ptr,
+       ll_int(static_cast<int32_t>(fixup_query_mem_desc.getEntryCount()), context_),
+       src_key_ptr,
+       ll_int(static_cast<int32_t>(key_count), context_),
+       ll_int(static_cast<int32_t>(key_width), context_),
+       ll_int(static_cast<int32_t>(query_mem_desc_.getRowSize() / sizeof(int64_t)),
+              context_),
+       llvm::ConstantPointerNull::get(llvm::Type::getInt64PtrTy(context_))},
+      "dest_targets_ptr");
+  const auto is_out_of_slots =
+      ir_builder.CreateIsNull(dest_targets_ptr, "is_dest_out_of_slots");
+  ir_builder.CreateCondBr(is_out_of_slots, bb_out_of_slots, bb_reduce_entry);
+
+  ir_builder.SetInsertPoint(bb_out_of_slots);
+  ir_builder.CreateCall(getFunction("record_error_code"),
+                        {ll_int(Executor::ERR_OUT_OF_SLOTS, context_), error_code});
+  ir_builder.CreateBr(bb_exit);
+
+  ir_builder.SetInsertPoint(bb_reduce_entry);
+  const auto src_targets_ptr = ir_builder.CreateGEP(
+      src_row_ptr,
+      ll_int(static_cast<size_t>(fixup_query_mem_desc.getColOffInBytes(0)), context_),
+      "src_targets_ptr");
+  ir_builder.CreateCall(
+      getFunction("reduce_one_entry"),
+      {ir_builder.CreatePointerCast(dest_targets_ptr, llvm::Type::getInt8PtrTy(context_)),
+       src_targets_ptr,
+       null_ptr_ll,
+       null_ptr_ll,
+       null_ptr_ll},
+      "");
+  ir_builder.CreateBr(bb_exit);
+}
+
 namespace {
 // given a particular destination ptr to the beginning of an entry, this function creates
 // proper cast for a specific slot index.
@@ -239,7 +331,8 @@ llvm::Value* codegen_smem_dest_slot_ptr(llvm::LLVMContext& context,
  * initialize the group by output buffer on the host. Similar to the reduction function,
  * it is assumed that there are at least as many threads as there are entries in the
  * buffer. Each entry is assigned to a single thread, and then all slots corresponding to
- * that entry are initialized with aggregate init values.
+ * that entry are initialized with aggregate init values. For baseline hash, the keys of
+ * the entry are set to the empty key first.
  */
 void GpuSharedMemCodeBuilder::codegenInitialization() {
   CHECK(init_func_);
@@ -247,7 +340,6 @@ void GpuSharedMemCodeBuilder::codegenInitialization() {
   // it should be removed in the future.
   auto fixup_query_mem_desc = ResultSet::fixupQueryMemoryDescriptor(query_mem_desc_);
   CHECK(!fixup_query_mem_desc.didOutputColumnar());
-  CHECK(fixup_query_mem_desc.hasKeylessHash());
   CHECK_GE(init_agg_values_.size(), targets_.size());
 
   auto bb_entry = llvm::BasicBlock::Create(context_, ".entry", init_func_);
@@ -276,6 +368,30 @@ void GpuSharedMemCodeBuilder::codegenInitialization() {
   const auto dest_byte_stream = ir_builder.CreatePointerCast(
       shared_mem_buffer, llvm::Type::getInt8PtrTy(context_), "dest_byte_stream");
 
+  if (!fixup_query_mem_desc.hasKeylessHash()) {
+    const auto key_width = fixup_query_mem_desc.getEffectiveKeyWidth();
+    CHECK(key_width == sizeof(int32_t) || key_width == sizeof(int64_t));
+    for (size_t key_idx = 0; key_idx < fixup_query_mem_desc.getGroupbyColCount();
+         ++key_idx) {
+      const auto key_byte_offset = ir_builder.CreateAdd(
+          byte_offset_ll, ll_int(key_idx * key_width, context_), "key_byte_offset");
+      const auto key_ptr = ir_builder.CreatePointerCast(
+          ir_builder.CreateGEP(dest_byte_stream, key_byte_offset),
+          key_width == sizeof(int32_t)
+              ? llvm::Type::getInt32PtrTy(context_, /*address_space=*/3)
+              : llvm::Type::getInt64PtrTy(context_, /*address_space=*/3),
+          "key_adr_" + std::to_string(key_idx));
+      ir_builder.CreateStore(key_width == sizeof(int32_t)
+                                 ? ll_int(static_cast<int32_t>(EMPTY_KEY_32), context_)
+                                 : ll_int(static_cast<int64_t>(EMPTY_KEY_64), context_),
+                             key_ptr);
+    }
+    // the slots start after the keys
+    byte_offset_ll = ir_builder.CreateAdd(
+        byte_offset_ll,
+        ll_int(static_cast<size_t>(fixup_query_mem_desc.getColOffInBytes(0)), context_));
+  }
+
   // each thread will be responsible for one
   const auto& col_slot_context = fixup_query_mem_desc.getColSlotContext();
   size_t init_agg_idx = 0;
@@ -329,6 +445,7 @@ llvm::Function* GpuSharedMemCodeBuilder::createReductionFunction() const {
   input_arguments.push_back(llvm::Type::getInt64PtrTy(context_));
   input_arguments.push_back(llvm::Type::getInt64PtrTy(context_));
   input_arguments.push_back(llvm::Type::getInt32Ty(context_));
+  input_arguments.push_back(llvm::Type::getInt32PtrTy(context_));  // error codes
 
   llvm::FunctionType* ft =
       llvm::FunctionType::get(llvm::Type::getVoidTy(context_), input_arguments, false);
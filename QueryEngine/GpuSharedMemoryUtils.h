@@ -35,7 +35,8 @@
 
 /**
  * This is a builder class for extra functions that are required to
- * support GPU shared memory usage for GroupByPerfectHash query types.
+ * support GPU shared memory usage for GroupByPerfectHash and GroupByBaselineHash query
+ * types.
  *
  * This class does not own its own LLVM module and uses a pointer to the
  * global module provided to it as an argument during construction
@@ -70,6 +71,17 @@ class GpuSharedMemCodeBuilder {
    * memory)
    */
   void codegenReduction();
+  /**
+   * Generates the body of the reduction for baseline hash: the entry of the thread is
+   * looked up by key in the global memory buffer instead of being at the same position
+   */
+  void codegenBaselineReduction(llvm::IRBuilder<>& ir_builder,
+                                llvm::Value* dest_buffer_ptr,
+                                llvm::Value* src_byte_stream,
+                                llvm::Value* thread_idx,
+                                llvm::Value* error_code,
+                                llvm::Value* null_ptr_ll,
+                                llvm::BasicBlock* bb_exit);
   /**
    * Generates code for the shared memory buffer initialization
    */
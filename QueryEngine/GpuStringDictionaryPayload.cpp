@@ -0,0 +1,157 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/GpuStringDictionaryPayload.h"
+
+#include "CudaMgr/CudaMgr.h"
+#include "Parser/ParserNode.h"
+#include "QueryEngine/CodeGenerator.h"
+#include "QueryEngine/Execute.h"
+#include "StringDictionary/StringDictionary.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+bool g_enable_gpu_dict_payload{false};
+
+namespace {
+
+struct CachedPayload {
+  std::weak_ptr<StringDictionary> dict;
+  std::shared_ptr<const GpuStringDictionaryPayload> payload;
+};
+
+std::mutex cache_mutex;
+std::unordered_map<const StringDictionary*, CachedPayload> cache;
+
+}  // namespace
+
+GpuStringDictionaryPayload::GpuStringDictionaryPayload(
+    const StringDictionary* dict,
+    const size_t generation,
+    CudaMgr_Namespace::CudaMgr* cuda_mgr)
+    : generation_(generation), cuda_mgr_(cuda_mgr) {
+#ifdef HAVE_CUDA
+  CHECK(cuda_mgr_);
+  const auto copy = [this](const int8_t* host_ptr,
+                           const size_t num_bytes,
+                           const int device_id) {
+    // a dictionary without strings still gets a valid pointer
+    auto device_ptr =
+        cuda_mgr_->allocateDeviceMem(std::max(num_bytes, size_t(1)), device_id);
+    if (num_bytes) {
+      cuda_mgr_->copyHostToDevice(device_ptr, host_ptr, num_bytes, device_id);
+    }
+    return device_ptr;
+  };
+  try {
+    // under the read lock of the dictionary, its storage can be remapped by an add
+    dict->visitStorage(generation_,
+                       [this, &copy](const int8_t* offsets,
+                                     const size_t offsets_size,
+                                     const int8_t* payload,
+                                     const size_t payload_size) {
+                         for (int device_id = 0;
+                              device_id < cuda_mgr_->getDeviceCount();
+                              ++device_id) {
+                           offsets_.push_back(copy(offsets, offsets_size, device_id));
+                           payloads_.push_back(copy(payload, payload_size, device_id));
+                         }
+                       });
+  } catch (...) {
+    for (auto device_ptr : offsets_) {
+      cuda_mgr_->freeDeviceMem(device_ptr);
+    }
+    for (auto device_ptr : payloads_) {
+      cuda_mgr_->freeDeviceMem(device_ptr);
+    }
+    throw;
+  }
+#else
+  CHECK(false);
+#endif  // HAVE_CUDA
+}
+
+GpuStringDictionaryPayload::~GpuStringDictionaryPayload() {
+  for (auto device_ptr : offsets_) {
+    cuda_mgr_->freeDeviceMem(device_ptr);
+  }
+  for (auto device_ptr : payloads_) {
+    cuda_mgr_->freeDeviceMem(device_ptr);
+  }
+}
+
+std::shared_ptr<const GpuStringDictionaryPayload> GpuStringDictionaryPayload::get(
+    const std::shared_ptr<StringDictionary>& dict,
+    const size_t generation,
+    CudaMgr_Namespace::CudaMgr* cuda_mgr) {
+  CHECK(dict);
+  std::lock_guard<std::mutex> cache_lock(cache_mutex);
+  // the copies of the dropped or replaced dictionaries
+  for (auto it = cache.begin(); it != cache.end();) {
+    if (it->second.dict.expired()) {
+      it = cache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  auto& cached = cache[dict.get()];
+  if (!cached.payload || cached.dict.lock() != dict ||
+      cached.payload->generation_ < generation) {
+    cached.payload =
+        std::make_shared<GpuStringDictionaryPayload>(dict.get(), generation, cuda_mgr);
+    cached.dict = dict;
+  }
+  return cached.payload;
+}
+
+void GpuStringDictionaryPayload::clearCache() {
+  std::lock_guard<std::mutex> cache_lock(cache_mutex);
+  cache.clear();
+}
+
+llvm::Value* GpuStringDictionaryPayload::codegen(llvm::Value* string_id,
+                                                 const int32_t null_val,
+                                                 Executor* executor) const {
+  AUTOMATIC_IR_METADATA(executor->cgen_state_.get());
+  CodeGenerator code_generator(executor);
+  // the address of the copy on each device, as the handles of InValuesBitmap
+  const auto codegen_handles = [&code_generator](const std::vector<int8_t*>& ptrs) {
+    std::vector<std::shared_ptr<const Analyzer::Constant>> constants_owned;
+    std::vector<const Analyzer::Constant*> constants;
+    for (const auto ptr : ptrs) {
+      const auto handle_literal = std::dynamic_pointer_cast<Analyzer::Constant>(
+          Parser::IntLiteral::analyzeValue(reinterpret_cast<int64_t>(ptr)));
+      CHECK(handle_literal);
+      constants_owned.push_back(handle_literal);
+      constants.push_back(handle_literal.get());
+    }
+    const auto handle_lvs =
+        code_generator.codegenHoistedConstants(constants, kENCODING_NONE, 0);
+    CHECK_EQ(size_t(1), handle_lvs.size());
+    return handle_lvs.front();
+  };
+  CHECK(!offsets_.empty());
+  auto cgen_state = executor->cgen_state_.get();
+  return cgen_state->emitCall(
+      "string_decompress_from_payload",
+      {string_id,
+       cgen_state->castToTypeIn(codegen_handles(offsets_), 64),
+       cgen_state->castToTypeIn(codegen_handles(payloads_), 64),
+       cgen_state->llInt(static_cast<int32_t>(generation_)),
+       cgen_state->llInt(null_val)});
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    GpuStringDictionaryPayload.h
+ * @brief   Copies of the offsets and the payload of a string dictionary on the GPUs, for
+ *          the kernels to decode the string ids of a dictionary-encoded column.
+ *
+ * The copies are made once for a dictionary and a generation and kept until the GPU
+ * memory is cleared or the dictionary is replaced, a query needing a later generation
+ * copies the dictionary again. They're allocated outside of the GPU buffer pool, one per
+ * device, and the kernels only read them.
+ */
+
+#pragma once
+
+#include <llvm/IR/Value.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+extern bool g_enable_gpu_dict_payload;
+
+namespace CudaMgr_Namespace {
+class CudaMgr;
+}  // namespace CudaMgr_Namespace
+
+class Executor;
+class StringDictionary;
+
+class GpuStringDictionaryPayload {
+ public:
+  GpuStringDictionaryPayload(const StringDictionary* dict,
+                             const size_t generation,
+                             CudaMgr_Namespace::CudaMgr* cuda_mgr);
+
+  ~GpuStringDictionaryPayload();
+
+  // The copies of the first `generation` strings of the dictionary, the cached ones if
+  // they hold as many strings. Throws CudaErrorException if a copy can't be allocated.
+  static std::shared_ptr<const GpuStringDictionaryPayload> get(
+      const std::shared_ptr<StringDictionary>& dict,
+      const size_t generation,
+      CudaMgr_Namespace::CudaMgr* cuda_mgr);
+
+  static void clearCache();
+
+  // The string of `string_id` packed as by string_decompress, 0 for null and the ids
+  // beyond the generation.
+  llvm::Value* codegen(llvm::Value* string_id,
+                       const int32_t null_val,
+                       Executor* executor) const;
+
+ private:
+  const size_t generation_;
+  CudaMgr_Namespace::CudaMgr* cuda_mgr_;
+  // per device
+  std::vector<int8_t*> offsets_;
+  std::vector<int8_t*> payloads_;
+};
@@ -35,8 +35,11 @@
 #include "DataMgr/BufferMgr/BufferMgr.h"
 #include "Execute.h"
 #include "QueryTemplateGenerator.h"
+#include "RoaringBitmap.h"
 #include "RuntimeFunctions.h"
+#include "SparseHll.h"
 #include "StreamingTopN.h"
+#include "TDigest.h"
 #include "TopKSort.h"
 #include "WindowContext.h"
 
@@ -48,6 +51,10 @@
 bool g_cluster{false};
 bool g_bigint_count{false};
 int g_hll_precision_bits{11};
+bool g_enable_sparse_hll{true};
+bool g_enable_roaring_count_distinct{true};
+bool g_enable_clustered_group_by{true};
+bool g_enable_packed_group_keys{false};
 extern size_t g_leaf_count;
 
 namespace {
@@ -419,6 +426,7 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
       break;
     }
   }
+  initPackedKey(*query_mem_desc);
   return query_mem_desc;
 }
 
@@ -507,6 +515,58 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
   }
 }
 
+void GroupByAndAggregate::initPackedKey(QueryMemoryDescriptor& query_mem_desc) const {
+  if (!g_enable_packed_group_keys || device_type_ != ExecutorDeviceType::CPU ||
+      query_mem_desc.getQueryDescriptionType() !=
+          QueryDescriptionType::GroupByBaselineHash ||
+      query_mem_desc.didOutputColumnar() || ra_exe_unit_.groupby_exprs.size() < 2) {
+    return;
+  }
+  // the two top bits are left clear, the packed key stays below the empty key
+  const int64_t max_bit_count = query_mem_desc.getEffectiveKeyWidth() * 8 - 2;
+  std::vector<PackedKeyComponent> components;
+  int64_t shift{0};
+  for (const auto& group_expr : ra_exe_unit_.groupby_exprs) {
+    // the unpacked columns hold the same null sentinel as the unpacked keys would
+    const auto& ti = group_expr->get_type_info();
+    const bool is_number = (ti.is_integer() || ti.is_decimal() || ti.is_time()) &&
+                           ti.get_compression() == kENCODING_NONE;
+    const bool is_dict_string = ti.is_string() &&
+                                ti.get_compression() == kENCODING_DICT &&
+                                ti.get_size() == sizeof(int32_t);
+    if (!is_number && !is_dict_string) {
+      return;
+    }
+    const auto uoper = dynamic_cast<const Analyzer::UOper*>(group_expr.get());
+    if (uoper && uoper->get_optype() == kUNNEST) {
+      return;
+    }
+    const auto col_range_info = getExprRangeInfo(group_expr.get());
+    if (col_range_info.hash_type_ != QueryDescriptionType::GroupByPerfectHash ||
+        col_range_info.bucket) {
+      return;
+    }
+    const auto cardinality = getBucketedCardinality(col_range_info);
+    int8_t bit_count{0};
+    while (bit_count < 63 && (int64_t(1) << bit_count) < cardinality) {
+      ++bit_count;
+    }
+    if (shift + bit_count > max_bit_count) {
+      return;
+    }
+    components.push_back({col_range_info.min,
+                          col_range_info.max + 1,
+                          inline_int_null_val(ti),
+                          col_range_info.has_nulls,
+                          static_cast<int8_t>(shift),
+                          bit_count});
+    shift += bit_count;
+  }
+  VLOG(1) << "Packing the " << components.size() << " group by columns into " << shift
+          << " bits";
+  query_mem_desc.setPackedKeyComponents(std::move(components));
+}
+
 void GroupByAndAggregate::addTransientStringLiterals() {
   addTransientStringLiterals(ra_exe_unit_, executor_, row_set_mem_owner_);
 }
@@ -630,7 +690,7 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
       CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::StdSet};
       int64_t bitmap_sz_bits{0};
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-        const auto error_rate = agg_expr->get_error_rate();
+        const auto error_rate = agg_expr->get_arg1();
         if (error_rate) {
           CHECK(error_rate->get_type_info().get_type() == kINT);
           CHECK_GE(error_rate->get_constval().intval, 1);
@@ -671,6 +731,26 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
           count_distinct_impl_type == CountDistinctImplType::StdSet) {
         throw WatchdogException("Cannot use a fast path for COUNT distinct");
       }
+      const bool is_group_by = !(ra_exe_unit_.groupby_exprs.size() == 1 &&
+                                 !ra_exe_unit_.groupby_exprs.front());
+      if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT &&
+          count_distinct_impl_type == CountDistinctImplType::Bitmap &&
+          g_enable_sparse_hll && is_group_by && device_type_ == ExecutorDeviceType::CPU) {
+        // Most groups of a group by usually see few distinct values, don't allocate the
+        // dense registers for all of them up front.
+        count_distinct_impl_type = CountDistinctImplType::SparseHll;
+      }
+      // A group by allocates a flat bitmap for every group, past one roaring bitmap
+      // container per group it's mostly zeros.
+      const int64_t MAX_GROUP_BY_BITMAP_BITS{8 * 64 * 1024L};
+      if (agg_info.agg_kind == kCOUNT && g_enable_roaring_count_distinct &&
+          device_type_ == ExecutorDeviceType::CPU &&
+          !(arg_ti.is_array() || arg_ti.is_geometry()) &&
+          (count_distinct_impl_type == CountDistinctImplType::StdSet ||
+           (count_distinct_impl_type == CountDistinctImplType::Bitmap && is_group_by &&
+            bitmap_sz_bits > MAX_GROUP_BY_BITMAP_BITS))) {
+        count_distinct_impl_type = CountDistinctImplType::RoaringBitmap;
+      }
       const auto sub_bitmap_count =
           get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit_, device_type_);
       count_distinct_descriptors.emplace_back(
@@ -1216,6 +1296,10 @@ std::tuple<llvm::Value*, llvm::Value*> GroupByAndAggregate::codegenGroupBy(
     CHECK(key_size_lv);
   }
 
+  const bool packed_key =
+      co.device_type == ExecutorDeviceType::CPU && query_mem_desc.hasPackedKey();
+  const auto& packed_key_components = query_mem_desc.getPackedKeyComponents();
+  llvm::Value* packed_key_lv{nullptr};
   int32_t subkey_idx = 0;
   CHECK(query_mem_desc.getGroupbyColCount() == ra_exe_unit_.groupby_exprs.size());
   for (const auto& group_expr : ra_exe_unit_.groupby_exprs) {
@@ -1233,7 +1317,7 @@ std::tuple<llvm::Value*, llvm::Value*> GroupByAndAggregate::codegenGroupBy(
             ? (query_mem_desc.isSingleColumnGroupByWithPerfectHash()
                    ? query_mem_desc.hasNulls()
                    : col_range_info.has_nulls)
-            : false;
+            : packed_key && packed_key_components[subkey_idx].has_nulls;
 
     const auto group_expr_lvs =
         executor_->groupByColumnCodegen(group_expr.get(),
@@ -1253,12 +1337,29 @@ std::tuple<llvm::Value*, llvm::Value*> GroupByAndAggregate::codegenGroupBy(
                                             group_expr_lv,
                                             group_expr_lvs.original_value,
                                             row_size_quad);
+    } else if (packed_key) {
+      // add the sub-key to the packed key, nulls were translated to max + 1
+      const auto& component = packed_key_components[subkey_idx++];
+      CHECK_EQ(translated_null_value, component.null_key);
+      const auto key_ty = group_expr_lv->getType();
+      const auto sub_key_lv = LL_BUILDER.CreateShl(
+          LL_BUILDER.CreateSub(group_expr_lv,
+                               llvm::ConstantInt::get(key_ty, component.min)),
+          llvm::ConstantInt::get(key_ty, component.shift));
+      packed_key_lv =
+          packed_key_lv ? LL_BUILDER.CreateOr(packed_key_lv, sub_key_lv) : sub_key_lv;
     } else {
       // store the sub-key to the buffer
       LL_BUILDER.CreateStore(group_expr_lv,
                              LL_BUILDER.CreateGEP(group_key, LL_INT(subkey_idx++)));
     }
   }
+  if (packed_key) {
+    // only the packed key is hashed and compared, the entry keeps a slot per column
+    CHECK(packed_key_lv);
+    LL_BUILDER.CreateStore(packed_key_lv, LL_BUILDER.CreateGEP(group_key, LL_INT(0)));
+    key_size_lv = LL_INT(int32_t(1));
+  }
   if (query_mem_desc.getQueryDescriptionType() ==
       QueryDescriptionType::GroupByPerfectHash) {
     CHECK(ra_exe_unit_.groupby_exprs.size() != 1);
@@ -1412,9 +1513,48 @@ GroupByAndAggregate::codegenMultiColumnBaselineHash(
   }
   if (query_mem_desc.didOutputColumnar()) {
     return std::make_tuple(groups_buffer, emitCall(func_name, func_args));
+  }
+  llvm::Value* row_ptr{nullptr};
+  if (co.device_type == ExecutorDeviceType::CPU && isGroupKeyClustered()) {
+    // consecutive rows mostly hit the same group, try it before hashing the key
+    const std::string clustered_func_name{co.with_dynamic_watchdog
+                                              ? "get_group_value_clustered_with_watchdog"
+                                              : "get_group_value_clustered"};
+    row_ptr = executor_->cgen_state_->emitExternalCall(
+        clustered_func_name, llvm::Type::getInt64PtrTy(LL_CONTEXT), func_args);
   } else {
-    return std::make_tuple(emitCall(func_name, func_args), nullptr);
+    row_ptr = emitCall(func_name, func_args);
+  }
+  if (co.device_type == ExecutorDeviceType::CPU && query_mem_desc.hasPackedKey()) {
+    // the aggregates of the entry start after the slots of all the columns, not after
+    // the packed key the lookup was given
+    const auto key_count = query_mem_desc.getGroupbyColCount();
+    const auto key_bytes = align_to_int64(key_count * key_width);
+    const auto packed_key_bytes = align_to_int64(key_width);
+    const auto agg_off_lv =
+        LL_INT(static_cast<int32_t>((key_bytes - packed_key_bytes) / sizeof(int64_t)));
+    row_ptr = LL_BUILDER.CreateSelect(LL_BUILDER.CreateIsNull(row_ptr),
+                                      row_ptr,
+                                      LL_BUILDER.CreateGEP(row_ptr, agg_off_lv));
+  }
+  return std::make_tuple(row_ptr, nullptr);
+}
+
+bool GroupByAndAggregate::isGroupKeyClustered() const {
+  if (!g_enable_clustered_group_by || ra_exe_unit_.groupby_exprs.empty()) {
+    return false;
+  }
+  const auto col_var =
+      dynamic_cast<const Analyzer::ColumnVar*>(ra_exe_unit_.groupby_exprs.front().get());
+  if (!col_var || col_var->get_rte_idx() != 0 || col_var->get_table_id() <= 0) {
+    return false;
   }
+  const auto catalog = executor_->getCatalog();
+  if (!catalog) {
+    return false;
+  }
+  const auto td = catalog->getMetadataForTable(col_var->get_table_id());
+  return td && td->sortedColumnId > 0 && td->sortedColumnId == col_var->get_column_id();
 }
 
 llvm::Function* GroupByAndAggregate::codegenPerfectHashFunction() {
@@ -1523,7 +1663,8 @@ llvm::Value* GroupByAndAggregate::codegenWindowRowPointer(
   AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
   const auto window_func_context =
       WindowProjectNodeContext::getActiveWindowFunctionContext(executor_);
-  if (window_func_context && window_function_is_aggregate(window_func->getKind())) {
+  if (window_func_context && window_function_is_aggregate(window_func->getKind()) &&
+      !window_function_is_rows_frame_aggregate(window_func)) {
     const int32_t row_size_quad = query_mem_desc.didOutputColumnar()
                                       ? 0
                                       : query_mem_desc.getRowSize() / sizeof(int64_t);
@@ -1717,6 +1858,118 @@ void GroupByAndAggregate::codegenEstimator(
            {bitmap, &*bitmap_size_lv, key_bytes, &*estimator_comp_bytes_lv});
 }
 
+namespace {
+
+// The entry of the last group found by a CPU kernel thread and the offset of the
+// aggregates in it, in quadwords.
+struct LastGroup {
+  const int64_t* groups_buffer{nullptr};
+  uint32_t entry_idx{0};
+  uint32_t agg_off{0};
+};
+
+thread_local LastGroup g_last_group;
+
+bool last_group_matches(const int64_t* groups_buffer,
+                        const uint32_t groups_buffer_entry_count,
+                        const int64_t* key,
+                        const uint32_t key_count,
+                        const uint32_t key_width,
+                        const uint32_t row_size_quad) {
+  if (g_last_group.groups_buffer != groups_buffer ||
+      g_last_group.entry_idx >= groups_buffer_entry_count) {
+    return false;
+  }
+  // the key is compared in place and never written: the buffer may have been reset
+  // since, an empty entry holds the empty key
+  const auto row_ptr = groups_buffer + g_last_group.entry_idx * row_size_quad;
+  return memcmp(row_ptr, key, key_count * key_width) == 0;
+}
+
+template <typename GET_GROUP_VALUE>
+int64_t* get_group_value_clustered_impl(GET_GROUP_VALUE get_group_value_fn,
+                                        int64_t* groups_buffer,
+                                        const uint32_t groups_buffer_entry_count,
+                                        const int64_t* key,
+                                        const uint32_t key_count,
+                                        const uint32_t key_width,
+                                        const uint32_t row_size_quad,
+                                        const int64_t* init_vals) {
+  if (last_group_matches(groups_buffer,
+                         groups_buffer_entry_count,
+                         key,
+                         key_count,
+                         key_width,
+                         row_size_quad)) {
+    return groups_buffer + g_last_group.entry_idx * row_size_quad + g_last_group.agg_off;
+  }
+  auto matching_group = get_group_value_fn(groups_buffer,
+                                           groups_buffer_entry_count,
+                                           key,
+                                           key_count,
+                                           key_width,
+                                           row_size_quad,
+                                           init_vals);
+  if (matching_group) {
+    const auto off = static_cast<uint32_t>(matching_group - groups_buffer);
+    g_last_group = {groups_buffer, off / row_size_quad, off % row_size_quad};
+  }
+  return matching_group;
+}
+
+}  // namespace
+
+extern "C" int64_t* get_group_value_clustered(int64_t* groups_buffer,
+                                              const uint32_t groups_buffer_entry_count,
+                                              const int64_t* key,
+                                              const uint32_t key_count,
+                                              const uint32_t key_width,
+                                              const uint32_t row_size_quad,
+                                              const int64_t* init_vals) {
+  return get_group_value_clustered_impl(get_group_value,
+                                        groups_buffer,
+                                        groups_buffer_entry_count,
+                                        key,
+                                        key_count,
+                                        key_width,
+                                        row_size_quad,
+                                        init_vals);
+}
+
+extern "C" int64_t* get_group_value_clustered_with_watchdog(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const int64_t* init_vals) {
+  return get_group_value_clustered_impl(get_group_value_with_watchdog,
+                                        groups_buffer,
+                                        groups_buffer_entry_count,
+                                        key,
+                                        key_count,
+                                        key_width,
+                                        row_size_quad,
+                                        init_vals);
+}
+
+extern "C" void agg_approximate_count_distinct_sparse(int64_t* agg, const int64_t key) {
+  reinterpret_cast<SparseHll*>(*agg)->update(key);
+}
+
+extern "C" void agg_count_distinct_roaring(int64_t* agg, const int64_t val) {
+  reinterpret_cast<RoaringBitmap*>(*agg)->add(val);
+}
+
+extern "C" void agg_count_distinct_roaring_skip_val(int64_t* agg,
+                                                    const int64_t val,
+                                                    const int64_t skip_val) {
+  if (val != skip_val) {
+    agg_count_distinct_roaring(agg, val);
+  }
+}
+
 extern "C" void agg_count_distinct(int64_t* agg, const int64_t val) {
   reinterpret_cast<std::set<int64_t>*>(*agg)->insert(val);
 }
@@ -1747,6 +2000,13 @@ void GroupByAndAggregate::codegenCountDistinct(
       query_mem_desc.getCountDistinctDescriptor(target_idx);
   CHECK(count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid);
   if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+    if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::SparseHll) {
+      CHECK(device_type == ExecutorDeviceType::CPU);
+      executor_->cgen_state_->emitExternalCall("agg_approximate_count_distinct_sparse",
+                                               llvm::Type::getVoidTy(LL_CONTEXT),
+                                               agg_args);
+      return;
+    }
     CHECK(count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap);
     agg_args.push_back(LL_INT(int32_t(count_distinct_descriptor.bitmap_sz_bits)));
     if (device_type == ExecutorDeviceType::GPU) {
@@ -1764,6 +2024,9 @@ void GroupByAndAggregate::codegenCountDistinct(
   if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap) {
     agg_fname += "_bitmap";
     agg_args.push_back(LL_INT(static_cast<int64_t>(count_distinct_descriptor.min_val)));
+  } else if (count_distinct_descriptor.impl_type_ ==
+             CountDistinctImplType::RoaringBitmap) {
+    agg_fname += "_roaring";
   }
   if (agg_info.skip_null_val) {
     auto null_lv = executor_->cgen_state_->castToTypeIn(
@@ -1798,6 +2061,43 @@ void GroupByAndAggregate::codegenCountDistinct(
   }
 }
 
+extern "C" void agg_approx_quantile(int64_t* agg, const double val) {
+  reinterpret_cast<TDigest*>(*agg)->add(val);
+}
+
+extern "C" void agg_approx_quantile_skip_val(int64_t* agg,
+                                             const double val,
+                                             const double skip_val) {
+  if (val != skip_val) {
+    agg_approx_quantile(agg, val);
+  }
+}
+
+void GroupByAndAggregate::codegenApproxQuantile(const Analyzer::Expr* target_expr,
+                                                std::vector<llvm::Value*>& agg_args,
+                                                const ExecutorDeviceType device_type) {
+  AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  const auto agg_info = get_target_info(target_expr, g_bigint_count);
+  const auto& arg_ti =
+      static_cast<const Analyzer::AggExpr*>(target_expr)->get_arg()->get_type_info();
+  // Decimals are added unscaled, the scale is applied to the quantile when it's read.
+  agg_args.back() = executor_->castToFP(
+      executor_->cgen_state_->castToTypeIn(agg_args.back(), 64));
+  std::string agg_fname{"agg_approx_quantile"};
+  if (agg_info.skip_null_val) {
+    const auto null_lv = executor_->castToFP(executor_->cgen_state_->castToTypeIn(
+        (arg_ti.is_fp()
+             ? static_cast<llvm::Value*>(executor_->cgen_state_->inlineFpNull(arg_ti))
+             : static_cast<llvm::Value*>(executor_->cgen_state_->inlineIntNull(arg_ti))),
+        64));
+    agg_fname += "_skip_val";
+    agg_args.push_back(null_lv);
+  }
+  executor_->cgen_state_->emitExternalCall(
+      agg_fname, llvm::Type::getVoidTy(LL_CONTEXT), agg_args);
+}
+
 llvm::Value* GroupByAndAggregate::getAdditionalLiteral(const int32_t off) {
   CHECK_LT(off, 0);
   const auto lit_buff_lv = get_arg_by_name(ROW_FUNC, "literals");
@@ -188,6 +188,10 @@ class GroupByAndAggregate {
   int64_t getShardedTopBucket(const ColRangeInfo& col_range_info,
                               const size_t shard_count) const;
 
+  // Packs the key of a CPU multi-column baseline hash group by into its first slot when
+  // the ranges of the columns fit in it.
+  void initPackedKey(QueryMemoryDescriptor& query_mem_desc) const;
+
   void addTransientStringLiterals();
 
   CountDistinctDescriptors initCountDistinctDescriptors();
@@ -227,6 +231,10 @@ class GroupByAndAggregate {
       const size_t key_width,
       const int32_t row_size_quad);
 
+  // Whether rows come clustered by group key: the first one is the column the outer
+  // table is sorted on.
+  bool isGroupKeyClustered() const;
+
   ColRangeInfo getColRangeInfo();
 
   ColRangeInfo getExprRangeInfo(const Analyzer::Expr* expr) const;
@@ -272,6 +280,10 @@ class GroupByAndAggregate {
                             const QueryMemoryDescriptor&,
                             const ExecutorDeviceType);
 
+  void codegenApproxQuantile(const Analyzer::Expr* target_expr,
+                             std::vector<llvm::Value*>& agg_args,
+                             const ExecutorDeviceType);
+
   llvm::Value* getAdditionalLiteral(const int32_t off);
 
   std::vector<llvm::Value*> codegenAggArg(const Analyzer::Expr* target_expr,
@@ -86,25 +86,35 @@ inline uint32_t count_zeros(T* M, size_t m) {
   return zeros;
 }
 
-template <class T>
-inline size_t hll_size(const T* M, const size_t bitmap_sz_bits) {
+// Estimate from the number of zero registers and the sum of 2^-M[i] over the registers,
+// which is all the sparse representation of SparseHll needs to know.
+inline size_t hll_size_from_sums(const size_t bitmap_sz_bits,
+                                 const uint32_t zeros,
+                                 const double harmonic_mean_denominator) {
   size_t m = 1 << bitmap_sz_bits;
 
-  uint32_t zeros = count_zeros(M, m);
-  double estimate = get_alpha_adjusted_estimate(m, M);
+  double estimate = (get_alpha(m) * m * m) * (1 / harmonic_mean_denominator);
   if (estimate <= 2.5 * m) {
     if (zeros != 0) {
       estimate = m * log(static_cast<double>(m) / zeros);
     }
   } else {
     if (bitmap_sz_bits == 14) {  // Apply LogLog-Beta adjustment only when p=14
-      estimate = get_beta_adjusted_estimate(m, zeros, M);
+      estimate = (get_alpha(m) * m * (m - zeros) *
+                  (1 / (get_beta(zeros) + harmonic_mean_denominator)));
     }
   }
   // No correction for large estimates since we're using 64-bit hashes.
   return estimate;
 }
 
+template <class T>
+inline size_t hll_size(const T* M, const size_t bitmap_sz_bits) {
+  size_t m = 1 << bitmap_sz_bits;
+  return hll_size_from_sums(
+      bitmap_sz_bits, count_zeros(M, m), get_harmonic_mean_denominator(M, m));
+}
+
 template <class T1, class T2>
 inline void hll_unify(T1* lhs, T2* rhs, const size_t m) {
   for (size_t r = 0; r < m; ++r) {
@@ -121,5 +131,6 @@ inline int hll_size_for_rate(const int err_percent) {
 }
 
 extern int g_hll_precision_bits;
+extern bool g_enable_sparse_hll;
 
 #endif  // QUERYENGINE_HYPERLOGLOG_H
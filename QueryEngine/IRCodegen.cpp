@@ -18,9 +18,12 @@
 #include "CodeGenerator.h"
 #include "Execute.h"
 #include "ExternalExecutor.h"
+#include "JoinHashTable/BandJoinTable.h"
 #include "MaxwellCodegenPatch.h"
 #include "RelAlgTranslator.h"
 
+#include <llvm/IR/Dominators.h>
+
 // Driver methods for the IR generation.
 
 std::vector<llvm::Value*> CodeGenerator::codegen(const Analyzer::Expr* expr,
@@ -30,6 +33,9 @@ std::vector<llvm::Value*> CodeGenerator::codegen(const Analyzer::Expr* expr,
   if (!expr) {
     return {posArg(expr)};
   }
+  if (const auto reused_lvs = findReusableExprValue(expr)) {
+    return *reused_lvs;
+  }
   auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr);
   if (bin_oper) {
     return {codegen(bin_oper, co)};
@@ -104,11 +110,11 @@ std::vector<llvm::Value*> CodeGenerator::codegen(const Analyzer::Expr* expr,
   }
   auto like_expr = dynamic_cast<const Analyzer::LikeExpr*>(expr);
   if (like_expr) {
-    return {codegen(like_expr, co)};
+    return recordReusableExprValue(expr, {codegen(like_expr, co)});
   }
   auto regexp_expr = dynamic_cast<const Analyzer::RegexpExpr*>(expr);
   if (regexp_expr) {
-    return {codegen(regexp_expr, co)};
+    return recordReusableExprValue(expr, {codegen(regexp_expr, co)});
   }
   auto likelihood_expr = dynamic_cast<const Analyzer::LikelihoodExpr*>(expr);
   if (likelihood_expr) {
@@ -125,8 +131,10 @@ std::vector<llvm::Value*> CodeGenerator::codegen(const Analyzer::Expr* expr,
   auto function_oper_with_custom_type_handling_expr =
       dynamic_cast<const Analyzer::FunctionOperWithCustomTypeHandling*>(expr);
   if (function_oper_with_custom_type_handling_expr) {
-    return {codegenFunctionOperWithCustomTypeHandling(
-        function_oper_with_custom_type_handling_expr, co)};
+    return recordReusableExprValue(
+        expr,
+        {codegenFunctionOperWithCustomTypeHandling(
+            function_oper_with_custom_type_handling_expr, co)});
   }
   auto array_oper_expr = dynamic_cast<const Analyzer::ArrayExpr*>(expr);
   if (array_oper_expr) {
@@ -134,15 +142,15 @@ std::vector<llvm::Value*> CodeGenerator::codegen(const Analyzer::Expr* expr,
   }
   auto geo_uop = dynamic_cast<const Analyzer::GeoUOper*>(expr);
   if (geo_uop) {
-    return {codegenGeoUOper(geo_uop, co)};
+    return recordReusableExprValue(expr, codegenGeoUOper(geo_uop, co));
   }
   auto geo_binop = dynamic_cast<const Analyzer::GeoBinOper*>(expr);
   if (geo_binop) {
-    return {codegenGeoBinOper(geo_binop, co)};
+    return recordReusableExprValue(expr, codegenGeoBinOper(geo_binop, co));
   }
   auto function_oper_expr = dynamic_cast<const Analyzer::FunctionOper*>(expr);
   if (function_oper_expr) {
-    return {codegenFunctionOper(function_oper_expr, co)};
+    return recordReusableExprValue(expr, {codegenFunctionOper(function_oper_expr, co)});
   }
   if (dynamic_cast<const Analyzer::OffsetInFragment*>(expr)) {
     return {posArg(nullptr)};
@@ -153,6 +161,65 @@ std::vector<llvm::Value*> CodeGenerator::codegen(const Analyzer::Expr* expr,
   abort();
 }
 
+namespace {
+
+// Function calls, geo operators and pattern matching are expensive enough to compute
+// them once per row when they appear several times in the targets, filters and group by
+// keys of a query.
+bool is_reusable_expr(const Analyzer::Expr* expr) {
+  return dynamic_cast<const Analyzer::FunctionOper*>(expr) ||
+         dynamic_cast<const Analyzer::GeoUOper*>(expr) ||
+         dynamic_cast<const Analyzer::GeoBinOper*>(expr) ||
+         dynamic_cast<const Analyzer::LikeExpr*>(expr) ||
+         dynamic_cast<const Analyzer::RegexpExpr*>(expr);
+}
+
+}  // namespace
+
+std::optional<std::vector<llvm::Value*>> CodeGenerator::findReusableExprValue(
+    const Analyzer::Expr* expr) {
+  if (!is_reusable_expr(expr) ||
+      WindowProjectNodeContext::getActiveWindowFunctionContext(executor())) {
+    return std::nullopt;
+  }
+  auto& ir_builder = cgen_state_->ir_builder_;
+  const auto current_bb = ir_builder.GetInsertBlock();
+  std::unique_ptr<llvm::DominatorTree> dominator_tree;
+  for (const auto& expr_value : cgen_state_->expr_value_cache_) {
+    if (expr_value.bb->getParent() != current_bb->getParent() ||
+        !(*expr_value.expr == *expr)) {
+      continue;
+    }
+    // The values are available after the code of the block generated so far.
+    if (expr_value.bb == current_bb) {
+      if (ir_builder.GetInsertPoint() == current_bb->end()) {
+        return expr_value.lvs;
+      }
+      continue;
+    }
+    if (!dominator_tree) {
+      // Blocks which are still being generated have no successors yet.
+      dominator_tree = std::make_unique<llvm::DominatorTree>(*current_bb->getParent());
+    }
+    if (dominator_tree->isReachableFromEntry(current_bb) &&
+        dominator_tree->dominates(expr_value.bb, current_bb)) {
+      return expr_value.lvs;
+    }
+  }
+  return std::nullopt;
+}
+
+std::vector<llvm::Value*> CodeGenerator::recordReusableExprValue(
+    const Analyzer::Expr* expr,
+    const std::vector<llvm::Value*>& lvs) {
+  if (!WindowProjectNodeContext::getActiveWindowFunctionContext(executor())) {
+    // Own a copy of the expression, it can be a temporary built during code generation.
+    cgen_state_->expr_value_cache_.push_back(
+        {expr->deep_copy(), cgen_state_->ir_builder_.GetInsertBlock(), lvs});
+  }
+  return lvs;
+}
+
 llvm::Value* CodeGenerator::codegen(const Analyzer::BinOper* bin_oper,
                                     const CompilationOptions& co) {
   AUTOMATIC_IR_METADATA(cgen_state_);
@@ -215,7 +282,17 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::SampleRatioExpr* expr,
                                                            "sample_ratio_nullcheck");
   }
   CHECK_EQ(input_expr->get_type_info().get_type(), kDOUBLE);
-  std::vector<llvm::Value*> args{double_lv[0], posArg(nullptr)};
+  // a fragment is kept by the row id of its first row, the same for all its rows
+  llvm::Value* row_key{nullptr};
+  if (expr->isPerFragment()) {
+    CHECK(!cgen_state_->frag_offsets_.empty());
+    row_key = cgen_state_->frag_offsets_.front()
+                  ? cgen_state_->frag_offsets_.front()
+                  : cgen_state_->llInt(int64_t(0));
+  } else {
+    row_key = posArg(nullptr);
+  }
+  std::vector<llvm::Value*> args{double_lv[0], row_key};
   auto ret = cgen_state_->emitCall("sample_ratio", args);
   if (nullcheck_codegen) {
     ret = nullcheck_codegen->finalize(ll_bool(false, cgen_state_->context_), ret);
@@ -291,7 +368,17 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
                                         column_cache,
                                         fail_reasons);
     };
-    const auto current_level_hash_table = build_cur_level_hash_table();
+    std::shared_ptr<JoinHashTableInterface> current_level_hash_table;
+    if (eo.force_loop_joins) {
+      fail_reasons.emplace_back("Loop join forced by a query hint");
+      if (current_level_join_conditions.type == JoinType::INNER) {
+        for (const auto& join_qual : current_level_join_conditions.quals) {
+          add_qualifier_to_execution_unit(ra_exe_unit, join_qual);
+        }
+      }
+    } else {
+      current_level_hash_table = build_cur_level_hash_table();
+    }
     const auto found_outer_join_matches_cb =
         [this, level_idx](llvm::Value* found_outer_join_matches) {
           CHECK_LT(level_idx, cgen_state_->outer_join_match_found_per_level_.size());
@@ -531,6 +618,24 @@ std::shared_ptr<JoinHashTableInterface> Executor::buildCurrentLevelHashTable(
       }
     }
   }
+  if (!current_level_hash_table &&
+      current_level_join_conditions.type == JoinType::INNER &&
+      co.device_type == ExecutorDeviceType::CPU) {
+    // the qualifiers were added to the filter above, the band join only narrows down
+    // the inner rows they are evaluated on
+    try {
+      current_level_hash_table = BandJoinTable::getInstance(
+          current_level_join_conditions.quals, query_infos, column_cache, this);
+    } catch (const HashJoinFail& e) {
+      fail_reasons.emplace_back(e.what());
+    } catch (const TooManyHashEntries& e) {
+      fail_reasons.emplace_back(e.what());
+    }
+    if (current_level_hash_table) {
+      plan_state_->join_info_.join_hash_tables_.push_back(current_level_hash_table);
+      plan_state_->join_info_.equi_join_tautologies_.push_back(nullptr);
+    }
+  }
   return current_level_hash_table;
 }
 
@@ -739,6 +844,17 @@ Executor::GroupColLLVMValue Executor::groupByColumnCodegen(
                   {group_key,
                    code_generator.posArg(arr_expr),
                    cgen_state_->llInt(log2_bytes(elem_ti.get_logical_size()))});
+    const auto ar_ret_ty =
+        elem_ti.is_fp()
+            ? (elem_ti.get_type() == kDOUBLE
+                   ? llvm::Type::getDoubleTy(cgen_state_->context_)
+                   : llvm::Type::getFloatTy(cgen_state_->context_))
+            : get_int_type(elem_ti.get_logical_size() * 8, cgen_state_->context_);
+    // the row is decoded once, the loop then loads the elements from the array buffer
+    const auto array_buff =
+        cgen_state_->emitExternalCall("array_buff",
+                                      llvm::PointerType::get(ar_ret_ty, 0),
+                                      {group_key, code_generator.posArg(arr_expr)});
     cgen_state_->ir_builder_.CreateBr(array_loop_head);
     cgen_state_->ir_builder_.SetInsertPoint(array_loop_head);
     CHECK(array_len);
@@ -755,23 +871,8 @@ Executor::GroupColLLVMValue Executor::groupByColumnCodegen(
     cgen_state_->ir_builder_.CreateStore(
         cgen_state_->ir_builder_.CreateAdd(array_idx, cgen_state_->llInt(int32_t(1))),
         array_idx_ptr);
-    auto array_at_fname = "array_at_" + numeric_type_name(elem_ti);
-    if (array_ti.get_size() < 0) {
-      if (array_ti.get_notnull()) {
-        array_at_fname = "notnull_" + array_at_fname;
-      }
-      array_at_fname = "varlen_" + array_at_fname;
-    }
-    const auto ar_ret_ty =
-        elem_ti.is_fp()
-            ? (elem_ti.get_type() == kDOUBLE
-                   ? llvm::Type::getDoubleTy(cgen_state_->context_)
-                   : llvm::Type::getFloatTy(cgen_state_->context_))
-            : get_int_type(elem_ti.get_logical_size() * 8, cgen_state_->context_);
-    group_key = cgen_state_->emitExternalCall(
-        array_at_fname,
-        ar_ret_ty,
-        {group_key, code_generator.posArg(arr_expr), array_idx});
+    group_key = cgen_state_->ir_builder_.CreateLoad(
+        cgen_state_->ir_builder_.CreateGEP(array_buff, array_idx));
     if (need_patch_unnest_double(
             elem_ti, isArchMaxwell(co.device_type), thread_mem_shared)) {
       key_to_cache = spillDoubleElement(group_key, ar_ret_ty);
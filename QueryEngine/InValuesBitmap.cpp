@@ -23,6 +23,7 @@
 #include "../Parser/ParserNode.h"
 #include "../Shared/checked_alloc.h"
 #include "GroupByAndAggregate.h"
+#include "InValuesHashSet.h"
 #include "Logger/Logger.h"
 #include "RuntimeFunctions.h"
 
@@ -82,6 +83,15 @@ InValuesBitmap::InValuesBitmap(const std::vector<int64_t>& values,
     throw FailedToCreateBitmap();
   }
   const auto bitmap_sz_bytes = bitmap_bits_to_bytes(bitmap_sz_bits);
+  // Few values over a wide range: a hash set of them is much smaller and touches fewer
+  // cache lines.
+  const size_t MIN_SPARSE_BITMAP_BYTES{1 << 20};
+  const auto hash_set_sz_bytes =
+      InValuesHashSet::getEntryCount(values.size()) * sizeof(int64_t);
+  if (static_cast<size_t>(bitmap_sz_bytes) > MIN_SPARSE_BITMAP_BYTES &&
+      static_cast<size_t>(bitmap_sz_bytes) > 8 * hash_set_sz_bytes) {
+    throw FailedToCreateBitmap();
+  }
   auto cpu_bitset = static_cast<int8_t*>(checked_calloc(bitmap_sz_bytes, 1));
   for (const auto value : values) {
     if (value == null_val) {
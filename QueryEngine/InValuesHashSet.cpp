@@ -0,0 +1,153 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "InValuesHashSet.h"
+#include "CodeGenerator.h"
+#include "Execute.h"
+#ifdef HAVE_CUDA
+#include "GpuMemUtils.h"
+#endif  // HAVE_CUDA
+#include "../Parser/ParserNode.h"
+#include "../Shared/checked_alloc.h"
+#include "Logger/Logger.h"
+#include "MurmurHash.h"
+
+InValuesHashSet::InValuesHashSet(const std::vector<int64_t>& values,
+                                 const int64_t null_val,
+                                 const Data_Namespace::MemoryLevel memory_level,
+                                 const int device_count,
+                                 Data_Namespace::DataMgr* data_mgr)
+    : rhs_has_null_(false)
+    , entry_count_(0)
+    , null_val_(null_val)
+    , memory_level_(memory_level)
+    , device_count_(device_count)
+    , data_mgr_(data_mgr) {
+#ifdef HAVE_CUDA
+  CHECK(memory_level_ == Data_Namespace::CPU_LEVEL ||
+        memory_level == Data_Namespace::GPU_LEVEL);
+#else
+  CHECK_EQ(Data_Namespace::CPU_LEVEL, memory_level_);
+#endif  // HAVE_CUDA
+  const auto null_count = std::count(values.begin(), values.end(), null_val);
+  rhs_has_null_ = null_count > 0;
+  if (values.size() == static_cast<size_t>(null_count)) {
+    return;
+  }
+  entry_count_ = getEntryCount(values.size() - null_count);
+  const auto hash_set_sz_bytes = entry_count_ * sizeof(int64_t);
+  auto cpu_hash_set = static_cast<int64_t*>(checked_malloc(hash_set_sz_bytes));
+  std::fill(cpu_hash_set, cpu_hash_set + entry_count_, null_val);
+  for (const auto value : values) {
+    if (value == null_val) {
+      continue;
+    }
+    auto slot = MurmurHash64A(&value, sizeof(int64_t), 0) & (entry_count_ - 1);
+    while (cpu_hash_set[slot] != null_val && cpu_hash_set[slot] != value) {
+      slot = (slot + 1) & (entry_count_ - 1);
+    }
+    cpu_hash_set[slot] = value;
+  }
+#ifdef HAVE_CUDA
+  if (memory_level_ == Data_Namespace::GPU_LEVEL) {
+    for (int device_id = 0; device_id < device_count_; ++device_id) {
+      gpu_buffers_.emplace_back(
+          CudaAllocator::allocGpuAbstractBuffer(data_mgr, hash_set_sz_bytes, device_id));
+      auto gpu_hash_set = gpu_buffers_.back()->getMemoryPtr();
+      copy_to_gpu(data_mgr,
+                  reinterpret_cast<CUdeviceptr>(gpu_hash_set),
+                  cpu_hash_set,
+                  hash_set_sz_bytes,
+                  device_id);
+      hash_sets_.push_back(gpu_hash_set);
+    }
+    free(cpu_hash_set);
+  } else {
+    hash_sets_.push_back(reinterpret_cast<int8_t*>(cpu_hash_set));
+  }
+#else
+  CHECK_EQ(1, device_count_);
+  hash_sets_.push_back(reinterpret_cast<int8_t*>(cpu_hash_set));
+#endif  // HAVE_CUDA
+}
+
+InValuesHashSet::~InValuesHashSet() {
+  if (hash_sets_.empty()) {
+    return;
+  }
+  if (memory_level_ == Data_Namespace::CPU_LEVEL) {
+    CHECK_EQ(size_t(1), hash_sets_.size());
+    free(hash_sets_.front());
+  } else {
+    CHECK(data_mgr_);
+    for (auto& gpu_buffer : gpu_buffers_) {
+      data_mgr_->free(gpu_buffer);
+    }
+  }
+}
+
+llvm::Value* InValuesHashSet::codegen(llvm::Value* needle, Executor* executor) const {
+  AUTOMATIC_IR_METADATA(executor->cgen_state_.get());
+  std::vector<std::shared_ptr<const Analyzer::Constant>> constants_owned;
+  std::vector<const Analyzer::Constant*> constants;
+  for (const auto hash_set : hash_sets_) {
+    const int64_t hash_set_handle = reinterpret_cast<int64_t>(hash_set);
+    const auto hash_set_handle_literal = std::dynamic_pointer_cast<Analyzer::Constant>(
+        Parser::IntLiteral::analyzeValue(hash_set_handle));
+    CHECK(hash_set_handle_literal);
+    CHECK_EQ(kENCODING_NONE, hash_set_handle_literal->get_type_info().get_compression());
+    constants_owned.push_back(hash_set_handle_literal);
+    constants.push_back(hash_set_handle_literal.get());
+  }
+  const auto needle_i64 = executor->cgen_state_->castToTypeIn(needle, 64);
+  const auto null_bool_val =
+      static_cast<int8_t>(inline_int_null_val(SQLTypeInfo(kBOOLEAN, false)));
+  if (hash_sets_.empty()) {
+    return executor->cgen_state_->emitCall("key_is_in_hash_set",
+                                           {executor->cgen_state_->llInt(int64_t(0)),
+                                            needle_i64,
+                                            executor->cgen_state_->llInt(int64_t(0)),
+                                            executor->cgen_state_->llInt(null_val_),
+                                            executor->cgen_state_->llInt(null_bool_val)});
+  }
+  CodeGenerator code_generator(executor);
+  const auto hash_set_handle_lvs =
+      code_generator.codegenHoistedConstants(constants, kENCODING_NONE, 0);
+  CHECK_EQ(size_t(1), hash_set_handle_lvs.size());
+  return executor->cgen_state_->emitCall(
+      "key_is_in_hash_set",
+      {executor->cgen_state_->castToTypeIn(hash_set_handle_lvs.front(), 64),
+       needle_i64,
+       executor->cgen_state_->llInt(static_cast<int64_t>(entry_count_)),
+       executor->cgen_state_->llInt(null_val_),
+       executor->cgen_state_->llInt(null_bool_val)});
+}
+
+bool InValuesHashSet::isEmpty() const {
+  return hash_sets_.empty();
+}
+
+bool InValuesHashSet::hasNull() const {
+  return rhs_has_null_;
+}
+
+size_t InValuesHashSet::getEntryCount(const size_t value_count) {
+  size_t entry_count = 2;
+  while (entry_count < 2 * value_count) {
+    entry_count <<= 1;
+  }
+  return entry_count;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../DataMgr/DataMgr.h"
+
+#include <llvm/IR/Value.h>
+
+#include <cstdint>
+#include <vector>
+
+class Executor;
+
+/**
+ * Key-only hash set of the right hand side of an IN over integers or dictionary ids,
+ * for the value sets an InValuesBitmap can't hold or would hold mostly empty. Keys are
+ * probed linearly in a power of two table at most half full, the null value marks the
+ * empty slots.
+ */
+class InValuesHashSet {
+ public:
+  InValuesHashSet(const std::vector<int64_t>& values,
+                  const int64_t null_val,
+                  const Data_Namespace::MemoryLevel memory_level,
+                  const int device_count,
+                  Data_Namespace::DataMgr* data_mgr);
+  ~InValuesHashSet();
+
+  llvm::Value* codegen(llvm::Value* needle, Executor* executor) const;
+
+  bool isEmpty() const;
+
+  bool hasNull() const;
+
+  size_t gpuBuffers() const { return gpu_buffers_.size(); }
+
+  static size_t getEntryCount(const size_t value_count);
+
+ private:
+  std::vector<Data_Namespace::AbstractBuffer*> gpu_buffers_;
+  std::vector<int8_t*> hash_sets_;
+  bool rhs_has_null_;
+  size_t entry_count_;
+  const int64_t null_val_;
+  const Data_Namespace::MemoryLevel memory_level_;
+  const int device_count_;
+  Data_Namespace::DataMgr* data_mgr_;
+};
@@ -39,16 +39,22 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::InValues* expr,
   }
   CHECK(result);
   if (co.hoist_literals) {  // TODO(alex): remove this constraint
-    auto in_vals_bitmap = createInValuesBitmap(expr, co);
-    if (in_vals_bitmap) {
-      if (in_vals_bitmap->isEmpty()) {
-        return in_vals_bitmap->hasNull()
-                   ? cgen_state_->inlineIntNull(SQLTypeInfo(kBOOLEAN, false))
-                   : result;
+    const auto values = getInValuesIntegers(expr);
+    if (values) {
+      const auto null_val = inline_int_null_val(in_arg->get_type_info());
+      if (std::all_of(values->begin(), values->end(), [null_val](const int64_t value) {
+            return value == null_val;
+          })) {
+        return values->empty()
+                   ? result
+                   : cgen_state_->inlineIntNull(SQLTypeInfo(kBOOLEAN, false));
       }
       CHECK_EQ(size_t(1), lhs_lvs.size());
-      return cgen_state_->addInValuesBitmap(in_vals_bitmap)
-          ->codegen(lhs_lvs.front(), executor());
+      try {
+        return codegenInValuesSet(*values, null_val, lhs_lvs.front(), co);
+      } catch (...) {
+        // fall back to comparisons with each value
+      }
     }
   }
   if (expr_ti.get_notnull()) {
@@ -85,13 +91,6 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::InIntegerSet* in_integer_set
         "IN subquery with many right-hand side values not supported when literal "
         "hoisting is disabled");
   }
-  auto in_vals_bitmap = std::make_unique<InValuesBitmap>(
-      in_integer_set->get_value_list(),
-      needle_null_val,
-      co.device_type == ExecutorDeviceType::GPU ? Data_Namespace::GPU_LEVEL
-                                                : Data_Namespace::CPU_LEVEL,
-      executor()->deviceCount(co.device_type),
-      &executor()->getCatalog()->getDataMgr());
   const auto& in_integer_set_ti = in_integer_set->get_type_info();
   CHECK(in_integer_set_ti.is_boolean());
   const auto lhs_lvs = codegen(in_arg, true, co);
@@ -104,19 +103,42 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::InIntegerSet* in_integer_set
   }
   CHECK(result);
   CHECK_EQ(size_t(1), lhs_lvs.size());
-  return cgen_state_->addInValuesBitmap(in_vals_bitmap)
-      ->codegen(lhs_lvs.front(), executor());
+  return codegenInValuesSet(
+      in_integer_set->get_value_list(), needle_null_val, lhs_lvs.front(), co);
+}
+
+llvm::Value* CodeGenerator::codegenInValuesSet(const std::vector<int64_t>& values,
+                                               const int64_t null_val,
+                                               llvm::Value* needle,
+                                               const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(cgen_state_);
+  const auto memory_level = co.device_type == ExecutorDeviceType::GPU
+                                ? Data_Namespace::GPU_LEVEL
+                                : Data_Namespace::CPU_LEVEL;
+  const auto device_count = executor()->deviceCount(co.device_type);
+  auto data_mgr = &executor()->getCatalog()->getDataMgr();
+  try {
+    auto in_vals_bitmap = std::make_unique<InValuesBitmap>(
+        values, null_val, memory_level, device_count, data_mgr);
+    return cgen_state_->addInValuesBitmap(in_vals_bitmap)->codegen(needle, executor());
+  } catch (const FailedToCreateBitmap&) {
+    VLOG(1) << "Looking up " << values.size() << " IN values in a hash set";
+  }
+  auto in_vals_hash_set = std::make_unique<InValuesHashSet>(
+      values, null_val, memory_level, device_count, data_mgr);
+  return cgen_state_->addInValuesHashSet(in_vals_hash_set)->codegen(needle, executor());
 }
 
-std::unique_ptr<InValuesBitmap> CodeGenerator::createInValuesBitmap(
-    const Analyzer::InValues* in_values,
-    const CompilationOptions& co) {
+std::optional<std::vector<int64_t>> CodeGenerator::getInValuesIntegers(
+    const Analyzer::InValues* in_values) {
   AUTOMATIC_IR_METADATA(cgen_state_);
   const auto& value_list = in_values->get_value_list();
   const auto val_count = value_list.size();
   const auto& ti = in_values->get_arg()->get_type_info();
-  if (!(ti.is_integer() || (ti.is_string() && ti.get_compression() == kENCODING_DICT))) {
-    return nullptr;
+  // decimals, dates and times are compared as the integers they are stored as
+  if (!(ti.is_integer() || ti.is_decimal() || ti.is_time() ||
+        (ti.is_string() && ti.get_compression() == kENCODING_DICT))) {
+    return std::nullopt;
   }
   const auto sdp =
       ti.is_string() ? executor()->getStringDictionaryProxy(
@@ -149,6 +171,16 @@ std::unique_ptr<InValuesBitmap> CodeGenerator::createInValuesBitmap(
           }
           const auto& in_val_ti = in_val->get_type_info();
           CHECK(in_val_ti == ti || get_nullable_type_info(in_val_ti) == ti);
+          if (ti.is_decimal() || ti.is_time()) {
+            // the integer of the constant must have the scale of the argument
+            const auto& const_ti = in_val_const->get_type_info();
+            if (!in_val_const->get_is_null() &&
+                (const_ti.get_type() != ti.get_type() ||
+                 const_ti.get_scale() != ti.get_scale() ||
+                 const_ti.get_dimension() != ti.get_dimension())) {
+              return false;
+            }
+          }
           if (ti.is_string()) {
             CHECK(sdp);
             const auto string_id =
@@ -177,7 +209,7 @@ std::unique_ptr<InValuesBitmap> CodeGenerator::createInValuesBitmap(
       success &= worker.get();
     }
     if (!success) {
-      return nullptr;
+      return std::nullopt;
     }
     if (worker_count > 1) {
       size_t total_val_count = 0;
@@ -189,17 +221,7 @@ std::unique_ptr<InValuesBitmap> CodeGenerator::createInValuesBitmap(
         values.insert(values.end(), vals.begin(), vals.end());
       }
     }
-    try {
-      return std::make_unique<InValuesBitmap>(values,
-                                              needle_null_val,
-                                              co.device_type == ExecutorDeviceType::GPU
-                                                  ? Data_Namespace::GPU_LEVEL
-                                                  : Data_Namespace::CPU_LEVEL,
-                                              executor()->deviceCount(co.device_type),
-                                              &executor()->getCatalog()->getDataMgr());
-    } catch (...) {
-      return nullptr;
-    }
+    return values;
   }
-  return nullptr;
+  return std::nullopt;
 }
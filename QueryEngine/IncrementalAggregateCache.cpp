@@ -0,0 +1,203 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/IncrementalAggregateCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Catalog/Catalog.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "QueryEngine/ResultSet.h"
+
+bool g_enable_incremental_aggregates{false};
+
+namespace {
+
+constexpr size_t kMaxCachedAggregates{64};
+// Larger buffers aren't worth a copy on every run which reuses them.
+constexpr size_t kMaxCachedAggregateBytes{size_t(256) << 20};
+
+// Aggregates whose partial results are in their slots only, without pointers to buffers
+// owned by the query.
+bool is_incremental_target(const Analyzer::Expr* target_expr, const bool is_group_by) {
+  const auto& target_ti = target_expr->get_type_info();
+  if (target_ti.is_varlen()) {
+    return false;
+  }
+  const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+  if (!agg_expr) {
+    // a group by key or an expression on them
+    return is_group_by;
+  }
+  const auto agg_arg = agg_expr->get_arg();
+  switch (agg_expr->get_aggtype()) {
+    case kCOUNT:
+      return !agg_expr->get_is_distinct();
+    case kAVG:
+    case kMIN:
+    case kMAX:
+    case kSUM:
+      return agg_arg && !agg_arg->get_type_info().is_varlen();
+    default:
+      return false;
+  }
+}
+
+bool is_incremental_work_unit(const RelAlgExecutionUnit& ra_exe_unit,
+                              const std::vector<InputTableInfo>& query_infos,
+                              const QueryMemoryDescriptor& query_mem_desc,
+                              const ExecutionOptions& eo) {
+  if (!g_enable_incremental_aggregates || eo.just_explain || eo.just_validate ||
+      eo.executor_type != ExecutorType::Native || !eo.outer_fragment_indices.empty()) {
+    return false;
+  }
+  const auto query_desc_type = query_mem_desc.getQueryDescriptionType();
+  if ((query_desc_type != QueryDescriptionType::NonGroupedAggregate &&
+       query_desc_type != QueryDescriptionType::GroupByPerfectHash) ||
+      query_mem_desc.useStreamingTopN()) {
+    return false;
+  }
+  if (ra_exe_unit.input_descs.size() != 1 || query_infos.size() != 1 ||
+      ra_exe_unit.input_descs.front().getSourceType() != InputSourceType::TABLE ||
+      ra_exe_unit.input_descs.front().getTableId() <= 0 ||
+      !ra_exe_unit.join_quals.empty() || ra_exe_unit.estimator ||
+      ra_exe_unit.union_all || ra_exe_unit.scan_limit ||
+      ra_exe_unit.sort_info.algorithm != SortAlgorithm::Default) {
+    return false;
+  }
+  const bool is_group_by = query_desc_type == QueryDescriptionType::GroupByPerfectHash;
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    if (!is_incremental_target(target_expr, is_group_by)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+std::vector<size_t> IncrementalAggregateCache::Plan::getFragmentsToScan() const {
+  std::vector<size_t> fragment_indices;
+  for (size_t i = getCachedFragmentCount(); i < outer_fragment_count; ++i) {
+    fragment_indices.push_back(i);
+  }
+  return fragment_indices;
+}
+
+IncrementalAggregateCache& IncrementalAggregateCache::instance() {
+  static IncrementalAggregateCache cache;
+  return cache;
+}
+
+IncrementalAggregateCache::IncrementalAggregateCache() : cache_(kMaxCachedAggregates) {}
+
+IncrementalAggregateCache::Plan IncrementalAggregateCache::getPlan(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const ExecutorDeviceType device_type,
+    const ExecutionOptions& eo,
+    const Catalog_Namespace::Catalog& cat) {
+  Plan plan;
+  if (!is_incremental_work_unit(ra_exe_unit, query_infos, query_mem_desc, eo)) {
+    return plan;
+  }
+  const auto td = cat.getMetadataForTable(query_infos.front().table_id, false);
+  if (!td || td->isView || td->nShards || td->maxFragRows <= 0 ||
+      td->storageType == StorageType::FOREIGN_TABLE) {
+    return plan;
+  }
+  // Appends only go to the last fragment, until it's full.
+  const auto& fragments = query_infos.front().info.fragments;
+  for (const auto& fragment : fragments) {
+    if (fragment.getNumTuples() < static_cast<size_t>(td->maxFragRows)) {
+      break;
+    }
+    plan.full_fragments.emplace_back(fragment.fragmentId, fragment.getNumTuples());
+  }
+  plan.outer_fragment_count = fragments.size();
+  plan.key = std::to_string(cat.getDatabaseId()) + ":" +
+             ra_exec_unit_desc_for_caching(ra_exe_unit);
+
+  std::shared_ptr<const Entry> cached;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto cached_ptr = cache_.get(plan.key);
+    if (cached_ptr) {
+      cached = *cached_ptr;
+    }
+  }
+  if (!cached || cached->device_type != device_type ||
+      !(cached->compiled_query_mem_desc == query_mem_desc) ||
+      cached->compiled_query_mem_desc.getEntryCount() != query_mem_desc.getEntryCount() ||
+      cached->fragments.size() > plan.full_fragments.size() ||
+      !std::equal(cached->fragments.begin(),
+                  cached->fragments.end(),
+                  plan.full_fragments.begin())) {
+    return plan;
+  }
+  plan.cached = cached;
+  return plan;
+}
+
+void IncrementalAggregateCache::put(const Plan& plan,
+                                    const QueryMemoryDescriptor& compiled_query_mem_desc,
+                                    const ExecutorDeviceType device_type,
+                                    const ResultSet& result) {
+  CHECK(plan.isEnabled());
+  const auto storage = result.getStorage();
+  if (!storage || plan.full_fragments.size() <= plan.getCachedFragmentCount()) {
+    return;
+  }
+  const auto& query_mem_desc = result.getQueryMemDesc();
+  const auto buffer_size = query_mem_desc.getBufferSizeBytes(result.getDeviceType());
+  if (buffer_size > kMaxCachedAggregateBytes) {
+    VLOG(1) << "Not caching aggregate buffer of " << buffer_size << " bytes";
+    return;
+  }
+  auto entry = std::make_shared<Entry>(Entry{compiled_query_mem_desc,
+                                             device_type,
+                                             query_mem_desc,
+                                             result.getTargetInfos(),
+                                             result.getTargetInitVals(),
+                                             std::vector<int8_t>(buffer_size),
+                                             plan.full_fragments});
+  std::memcpy(entry->buffer.data(), storage->getUnderlyingBuffer(), buffer_size);
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.put(plan.key, std::move(entry));
+}
+
+std::shared_ptr<ResultSet> IncrementalAggregateCache::toResultSet(
+    const Entry& entry,
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+    const Executor* executor) {
+  auto result = std::make_shared<ResultSet>(entry.targets,
+                                            entry.device_type,
+                                            entry.query_mem_desc,
+                                            row_set_mem_owner,
+                                            executor);
+  const auto storage = result->allocateStorage(entry.target_init_vals);
+  CHECK_EQ(entry.buffer.size(),
+           entry.query_mem_desc.getBufferSizeBytes(result->getDeviceType()));
+  std::memcpy(storage->getUnderlyingBuffer(), entry.buffer.data(), entry.buffer.size());
+  return result;
+}
+
+void IncrementalAggregateCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.clear();
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    IncrementalAggregateCache.h
+ * @brief   Partial aggregates of append-only tables, kept across queries so that a
+ *          repeated aggregate only scans the fragments appended since its last run.
+ *
+ * Fragments of an insert order table only grow until they are full, after which appends
+ * go to new fragments. The cache holds the aggregate buffer of the full fragments of the
+ * outer table, the fragments past them are scanned and reduced into a copy of it. Any
+ * UPDATE, DELETE, TRUNCATE or DROP clears the cache.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "QueryEngine/CacheInvalidator.h"
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/Descriptors/QueryMemoryDescriptor.h"
+#include "QueryEngine/InputMetadata.h"
+#include "Shared/TargetInfo.h"
+#include "StringDictionary/LruCache.hpp"
+
+extern bool g_enable_incremental_aggregates;
+
+namespace Catalog_Namespace {
+class Catalog;
+}
+
+class Executor;
+struct RelAlgExecutionUnit;
+class ResultSet;
+class RowSetMemoryOwner;
+
+class IncrementalAggregateCache {
+ public:
+  // {fragment id, tuple count} of the fragments an entry aggregates
+  using FragmentSizes = std::vector<std::pair<int, size_t>>;
+
+  struct Entry {
+    // the descriptor the work unit was compiled to, only the same one can be reduced
+    QueryMemoryDescriptor compiled_query_mem_desc;
+    ExecutorDeviceType device_type;
+    QueryMemoryDescriptor query_mem_desc;
+    std::vector<TargetInfo> targets;
+    std::vector<int64_t> target_init_vals;
+    std::vector<int8_t> buffer;
+    FragmentSizes fragments;
+  };
+
+  // What a work unit can reuse, empty key if it can't be maintained incrementally.
+  struct Plan {
+    std::string key;
+    std::shared_ptr<const Entry> cached;
+    // the full fragments of the outer table, the first ones are in `cached`
+    FragmentSizes full_fragments;
+    size_t outer_fragment_count{0};
+
+    bool isEnabled() const { return !key.empty(); }
+
+    size_t getCachedFragmentCount() const {
+      return cached ? cached->fragments.size() : 0;
+    }
+
+    // Outer fragments left to scan, all of them if nothing is cached.
+    std::vector<size_t> getFragmentsToScan() const;
+  };
+
+  static IncrementalAggregateCache& instance();
+
+  Plan getPlan(const RelAlgExecutionUnit& ra_exe_unit,
+               const std::vector<InputTableInfo>& query_infos,
+               const QueryMemoryDescriptor& query_mem_desc,
+               const ExecutorDeviceType device_type,
+               const ExecutionOptions& eo,
+               const Catalog_Namespace::Catalog& cat);
+
+  // Caches a copy of `result`, the aggregate of the full fragments of `plan`.
+  void put(const Plan& plan,
+           const QueryMemoryDescriptor& compiled_query_mem_desc,
+           const ExecutorDeviceType device_type,
+           const ResultSet& result);
+
+  // A result set holding a copy of the buffer of `entry`.
+  static std::shared_ptr<ResultSet> toResultSet(
+      const Entry& entry,
+      std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+      const Executor* executor);
+
+  void clear();
+
+  static auto yieldCacheInvalidator() -> std::function<void()> {
+    return []() -> void { IncrementalAggregateCache::instance().clear(); };
+  }
+
+ private:
+  IncrementalAggregateCache();
+
+  std::mutex mutex_;
+  LruCache<std::string, std::shared_ptr<const Entry>> cache_;
+};
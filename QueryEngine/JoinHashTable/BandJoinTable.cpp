@@ -0,0 +1,375 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/JoinHashTable/BandJoinTable.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "QueryEngine/CodeGenerator.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/JoinHashTable/JoinColumnIterator.h"
+#include "QueryEngine/JoinHashTable/JoinHashTable.h"
+#include "QueryEngine/RangeTableIndexVisitor.h"
+#include "Shared/SqlTypesLayout.h"
+
+bool g_enable_band_joins{false};
+
+extern bool g_cluster;
+
+namespace {
+
+void collect_conjuncts(const std::shared_ptr<Analyzer::Expr>& qual,
+                       std::vector<std::shared_ptr<Analyzer::BinOper>>& conjuncts) {
+  const auto bin_oper = std::dynamic_pointer_cast<Analyzer::BinOper>(qual);
+  if (!bin_oper) {
+    return;
+  }
+  if (bin_oper->get_optype() == kAND) {
+    collect_conjuncts(bin_oper->get_own_left_operand(), conjuncts);
+    collect_conjuncts(bin_oper->get_own_right_operand(), conjuncts);
+    return;
+  }
+  conjuncts.push_back(bin_oper);
+}
+
+// The column an operand of a comparison stands for, seen through a widening integer cast.
+std::shared_ptr<Analyzer::ColumnVar> get_bounded_column(
+    const std::shared_ptr<Analyzer::Expr>& operand) {
+  auto col_expr = operand;
+  const auto uoper = std::dynamic_pointer_cast<Analyzer::UOper>(operand);
+  if (uoper && uoper->get_optype() == kCAST) {
+    const auto& cast_ti = uoper->get_type_info();
+    const auto& operand_ti = uoper->get_operand()->get_type_info();
+    if (!cast_ti.is_integer() || !operand_ti.is_integer() ||
+        cast_ti.get_size() < operand_ti.get_size()) {
+      return nullptr;
+    }
+    col_expr = uoper->get_own_operand();
+  }
+  if (std::dynamic_pointer_cast<Analyzer::Var>(col_expr)) {
+    return nullptr;
+  }
+  return std::dynamic_pointer_cast<Analyzer::ColumnVar>(col_expr);
+}
+
+// True if the values of both types compare as the integers they are stored as.
+bool have_comparable_values(const SQLTypeInfo& lhs_ti, const SQLTypeInfo& rhs_ti) {
+  if (lhs_ti.is_integer() && rhs_ti.is_integer()) {
+    return true;
+  }
+  if (lhs_ti.is_decimal() && rhs_ti.is_decimal()) {
+    return lhs_ti.get_scale() == rhs_ti.get_scale();
+  }
+  if (lhs_ti.is_time() && rhs_ti.is_time()) {
+    return lhs_ti.get_type() == rhs_ti.get_type() &&
+           lhs_ti.get_dimension() == rhs_ti.get_dimension();
+  }
+  return false;
+}
+
+bool is_outer_expr(const Analyzer::Expr* expr, const int inner_rte_idx) {
+  AllRangeTableIndexVisitor visitor;
+  const auto rte_idx_set = visitor.visit(expr);
+  return rte_idx_set.empty() || *rte_idx_set.rbegin() < inner_rte_idx;
+}
+
+JoinColumnTypeInfo get_join_column_type_info(const SQLTypeInfo& ti) {
+  return JoinColumnTypeInfo{static_cast<size_t>(ti.get_size()),
+                            0,
+                            0,
+                            inline_fixed_encoding_null_val(ti),
+                            false,
+                            0,
+                            get_join_column_type_kind(ti)};
+}
+
+// The null sentinel of the decoded elements of a join column.
+int64_t get_decoded_null_val(const JoinColumnTypeInfo& type_info) {
+  if (type_info.column_type == SmallDate) {
+    return type_info.elem_sz == 4 ? NULL_INT : NULL_SMALLINT;
+  }
+  return type_info.null_val;
+}
+
+}  // namespace
+
+std::shared_ptr<BandJoinTable> BandJoinTable::getInstance(
+    const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
+    const std::vector<InputTableInfo>& query_infos,
+    ColumnCacheMap& column_cache,
+    Executor* executor) {
+  if (!g_enable_band_joins || g_cluster) {
+    return nullptr;
+  }
+  std::vector<std::shared_ptr<Analyzer::BinOper>> conjuncts;
+  int inner_rte_idx{0};
+  for (const auto& join_qual : join_quals) {
+    collect_conjuncts(join_qual, conjuncts);
+    MaxRangeTableIndexVisitor rte_idx_visitor;
+    inner_rte_idx = std::max(inner_rte_idx, rte_idx_visitor.visit(join_qual.get()));
+  }
+  if (!inner_rte_idx) {
+    return nullptr;
+  }
+  std::vector<Bound> lower_bounds;
+  std::vector<Bound> upper_bounds;
+  for (const auto& conjunct : conjuncts) {
+    const auto optype = conjunct->get_optype();
+    if (optype != kLT && optype != kLE && optype != kGT && optype != kGE) {
+      continue;
+    }
+    // the comparisons bound the inner column from below when it is on the greater side
+    bool inner_is_greater{optype == kGT || optype == kGE};
+    auto inner_col = get_bounded_column(conjunct->get_own_left_operand());
+    auto outer_expr = conjunct->get_own_right_operand();
+    if (!inner_col || inner_col->get_rte_idx() != inner_rte_idx) {
+      inner_is_greater = !inner_is_greater;
+      inner_col = get_bounded_column(conjunct->get_own_right_operand());
+      outer_expr = conjunct->get_own_left_operand();
+    }
+    if (!inner_col || inner_col->get_rte_idx() != inner_rte_idx ||
+        !is_outer_expr(outer_expr.get(), inner_rte_idx) ||
+        !have_comparable_values(inner_col->get_type_info(),
+                                outer_expr->get_type_info())) {
+      continue;
+    }
+    auto& bounds = inner_is_greater ? lower_bounds : upper_bounds;
+    bounds.push_back({inner_col, outer_expr, conjunct});
+  }
+  if (lower_bounds.empty() || upper_bounds.empty()) {
+    return nullptr;
+  }
+  // both bounds on the same column are used as they are, a lower bound on another column
+  // is widened to the sort column
+  for (const auto& lower : lower_bounds) {
+    for (const auto& upper : upper_bounds) {
+      if (*lower.inner_col == *upper.inner_col) {
+        auto table = std::shared_ptr<BandJoinTable>(
+            new BandJoinTable(lower, upper, query_infos, column_cache, executor));
+        table->reify();
+        return table;
+      }
+    }
+  }
+  const auto& upper = upper_bounds.front();
+  for (const auto& lower : lower_bounds) {
+    if (have_comparable_values(lower.inner_col->get_type_info(),
+                               upper.inner_col->get_type_info())) {
+      auto table = std::shared_ptr<BandJoinTable>(
+          new BandJoinTable(lower, upper, query_infos, column_cache, executor));
+      table->reify();
+      return table;
+    }
+  }
+  return nullptr;
+}
+
+BandJoinTable::BandJoinTable(const Bound& lower,
+                             const Bound& upper,
+                             const std::vector<InputTableInfo>& query_infos,
+                             ColumnCacheMap& column_cache,
+                             Executor* executor)
+    : sort_col_(upper.inner_col)
+    , lower_(lower)
+    , upper_(upper)
+    , query_infos_(query_infos)
+    , column_cache_(column_cache)
+    , executor_(executor) {}
+
+void BandJoinTable::reify() {
+  const auto& query_info = get_inner_query_info(getInnerTableId(), query_infos_).info;
+  if (query_info.getNumTuplesUpperBound() >
+      static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    throw TooManyHashEntries();
+  }
+  const auto catalog = executor_->getCatalog();
+  for (const auto col : {sort_col_.get(), lower_.inner_col.get()}) {
+    const auto cd =
+        get_column_descriptor_maybe(col->get_column_id(), col->get_table_id(), *catalog);
+    if (cd && cd->isVirtualCol) {
+      throw FailedToJoinOnVirtualColumn();
+    }
+  }
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
+  std::vector<std::shared_ptr<void>> malloc_owner;
+  const auto fetch_column = [&](const Analyzer::ColumnVar* col) {
+    return fetchJoinColumn(col,
+                           query_info.fragments,
+                           Data_Namespace::CPU_LEVEL,
+                           0,
+                           chunks_owner,
+                           nullptr,
+                           malloc_owner,
+                           executor_,
+                           &column_cache_);
+  };
+
+  const auto sort_column = fetch_column(sort_col_.get());
+  const auto sort_type_info = get_join_column_type_info(sort_col_->get_type_info());
+  const auto sort_null_val = get_decoded_null_val(sort_type_info);
+  std::vector<std::pair<int64_t, int32_t>> sorted_rows;
+  sorted_rows.reserve(sort_column.num_elems);
+  JoinColumnTyped sort_col{&sort_column, &sort_type_info};
+  for (auto item : sort_col.slice(0, 1)) {
+    // a null never satisfies the bounds
+    if (item.element != sort_null_val) {
+      sorted_rows.emplace_back(item.element, static_cast<int32_t>(item.index));
+    }
+  }
+  std::sort(sorted_rows.begin(), sorted_rows.end());
+
+  // the largest amount the lower bounded column exceeds the sort column by
+  int64_t lower_span{0};
+  if (!(*lower_.inner_col == *sort_col_)) {
+    const auto span_column = fetch_column(lower_.inner_col.get());
+    const auto span_type_info =
+        get_join_column_type_info(lower_.inner_col->get_type_info());
+    const auto span_null_val = get_decoded_null_val(span_type_info);
+    JoinColumnIterator sort_it(&sort_column, &sort_type_info, 0, 1);
+    JoinColumnIterator span_it(&span_column, &span_type_info, 0, 1);
+    for (; sort_it && span_it; ++sort_it, ++span_it) {
+      const auto sort_val = (*sort_it).element;
+      const auto span_val = (*span_it).element;
+      if (sort_val == sort_null_val || span_val == span_null_val) {
+        continue;
+      }
+      int64_t span{0};
+      if (__builtin_sub_overflow(span_val, sort_val, &span)) {
+        throw HashJoinFail("Band join bounds too far apart");
+      }
+      lower_span = std::max(lower_span, span);
+    }
+    layout_reason_ = "lower bound widened by " + std::to_string(lower_span);
+  }
+
+  const auto count = sorted_rows.size();
+  cpu_buff_.assign(2 + count + (count + 1) / 2, 0);
+  cpu_buff_[0] = count;
+  cpu_buff_[1] = lower_span;
+  auto row_ids = reinterpret_cast<int32_t*>(&cpu_buff_[2 + count]);
+  for (size_t i = 0; i < count; ++i) {
+    cpu_buff_[2 + i] = sorted_rows[i].first;
+    row_ids[i] = sorted_rows[i].second;
+  }
+  chargeHostMemory(executor_, cpu_buff_.size() * sizeof(int64_t));
+}
+
+int64_t BandJoinTable::getJoinHashBuffer(const ExecutorDeviceType device_type,
+                                         const int device_id) const noexcept {
+  if (device_type != ExecutorDeviceType::CPU) {
+    return 0;
+  }
+  CHECK_EQ(device_id, 0);
+  return reinterpret_cast<int64_t>(cpu_buff_.data());
+}
+
+size_t BandJoinTable::getJoinHashBufferSize(const ExecutorDeviceType device_type,
+                                            const int device_id) const noexcept {
+  if (device_type != ExecutorDeviceType::CPU) {
+    return 0;
+  }
+  return cpu_buff_.size() * sizeof(int64_t);
+}
+
+std::string BandJoinTable::toString(const ExecutorDeviceType device_type,
+                                    const int device_id,
+                                    bool raw) const {
+  const int64_t count = cpu_buff_.empty() ? 0 : cpu_buff_[0];
+  const int64_t lower_span = cpu_buff_.empty() ? 0 : cpu_buff_[1];
+  std::string txt = "band join on table " + std::to_string(getInnerTableId()) + ", " +
+                    std::to_string(count) + " sorted values, lower span " +
+                    std::to_string(lower_span);
+  if (raw) {
+    for (int64_t i = 0; i < count; ++i) {
+      txt += (i ? ", " : "\n") + std::to_string(cpu_buff_[2 + i]);
+    }
+  }
+  return txt;
+}
+
+DecodedJoinHashBufferSet BandJoinTable::toSet(const ExecutorDeviceType device_type,
+                                              const int device_id) const {
+  DecodedJoinHashBufferSet decoded;
+  if (device_type != ExecutorDeviceType::CPU || cpu_buff_.empty()) {
+    return decoded;
+  }
+  const auto count = cpu_buff_[0];
+  const auto row_ids = reinterpret_cast<const int32_t*>(&cpu_buff_[2 + count]);
+  for (int64_t i = 0; i < count; ++i) {
+    DecodedJoinHashBufferEntry entry{{cpu_buff_[2 + i]}, {}};
+    auto it = decoded.find(entry);
+    if (it != decoded.end()) {
+      entry.payload = it->payload;
+      decoded.erase(it);
+    }
+    entry.payload.insert(row_ids[i]);
+    decoded.insert(entry);
+  }
+  return decoded;
+}
+
+llvm::Value* BandJoinTable::codegenSlot(const CompilationOptions&, const size_t) {
+  UNREACHABLE();
+  return nullptr;
+}
+
+HashJoinMatchingSet BandJoinTable::codegenMatchingSet(const CompilationOptions& co,
+                                                      const size_t index) {
+  AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
+  CHECK(co.device_type == ExecutorDeviceType::CPU);
+  auto cgen_state = executor_->cgen_state_.get();
+  auto band_buff = JoinHashTable::codegenHashTableLoad(index, executor_);
+  if (!band_buff->getType()->isIntegerTy(64)) {
+    CHECK(band_buff->getType()->isPointerTy());
+    band_buff = cgen_state->ir_builder_.CreatePtrToInt(
+        band_buff, llvm::Type::getInt64Ty(cgen_state->context_));
+  }
+  const auto lower_idx_lv = cgen_state->emitCall(
+      "band_join_lower_idx",
+      {band_buff,
+       codegenBound(lower_.outer_expr.get(), co),
+       cgen_state->llInt(inline_int_null_val(lower_.outer_expr->get_type_info()))});
+  const auto upper_idx_lv = cgen_state->emitCall(
+      "band_join_upper_idx",
+      {band_buff,
+       codegenBound(upper_.outer_expr.get(), co),
+       cgen_state->llInt(inline_int_null_val(upper_.outer_expr->get_type_info()))});
+  const auto idx_diff_lv = cgen_state->ir_builder_.CreateSub(upper_idx_lv, lower_idx_lv);
+  const auto row_count_lv = cgen_state->ir_builder_.CreateSelect(
+      cgen_state->ir_builder_.CreateICmpSGT(idx_diff_lv, cgen_state->llInt(int64_t(0))),
+      idx_diff_lv,
+      cgen_state->llInt(int64_t(0)));
+  const auto rowid_base_i32 = cgen_state->ir_builder_.CreateIntToPtr(
+      cgen_state->emitCall("band_join_row_ids", {band_buff}),
+      llvm::Type::getInt32PtrTy(cgen_state->context_));
+  const auto rowid_ptr_i32 =
+      cgen_state->ir_builder_.CreateGEP(rowid_base_i32, lower_idx_lv);
+  return {rowid_ptr_i32, row_count_lv, lower_idx_lv};
+}
+
+size_t BandJoinTable::payloadBufferOff() const noexcept {
+  const size_t count = cpu_buff_.empty() ? 0 : cpu_buff_[0];
+  return (2 + count) * sizeof(int64_t);
+}
+
+llvm::Value* BandJoinTable::codegenBound(const Analyzer::Expr* bound,
+                                         const CompilationOptions& co) {
+  CodeGenerator code_generator(executor_);
+  const auto bound_lv = code_generator.codegen(bound, true, co).front();
+  return executor_->cgen_state_->castToTypeIn(bound_lv, 64);
+}
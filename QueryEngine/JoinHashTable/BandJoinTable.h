@@ -0,0 +1,122 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    BandJoinTable.h
+ * @brief   Sorted inner column of an inner join on range predicates, such as
+ *          a.ts BETWEEN b.lo AND b.hi, which has no equijoin qualifier for a hash table.
+ *
+ * The inner rows are sorted on a column the predicates bound from below and from above
+ * by expressions of the outer tables. Each outer row only iterates over the inner rows
+ * whose value lies between its bounds, found with two binary searches, instead of over
+ * the whole inner table. A bound on another inner column also bounds the sort column,
+ * offset by the widest difference between the two columns over the inner rows: the
+ * start of intervals a point must lie in is bounded by the point minus the widest
+ * interval. The predicates stay in the filter of the query, the candidate inner rows
+ * only need to include the matching ones.
+ *
+ * Built on the CPU only, GPU queries keep the loop join.
+ */
+
+#pragma once
+
+#include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
+
+#include <list>
+#include <memory>
+#include <vector>
+
+extern bool g_enable_band_joins;
+
+class Executor;
+struct InputTableInfo;
+
+class BandJoinTable : public JoinHashTableInterface {
+ public:
+  //! Makes a band join table from the qualifiers of an inner join, or returns nullptr if
+  //! they don't bound any column of the inner table from both sides.
+  static std::shared_ptr<BandJoinTable> getInstance(
+      const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals,
+      const std::vector<InputTableInfo>& query_infos,
+      ColumnCacheMap& column_cache,
+      Executor* executor);
+
+  int64_t getJoinHashBuffer(const ExecutorDeviceType device_type,
+                            const int device_id) const noexcept override;
+
+  size_t getJoinHashBufferSize(const ExecutorDeviceType device_type,
+                               const int device_id) const noexcept override;
+
+  std::string toString(const ExecutorDeviceType device_type,
+                       const int device_id = 0,
+                       bool raw = false) const override;
+
+  DecodedJoinHashBufferSet toSet(const ExecutorDeviceType device_type,
+                                 const int device_id) const override;
+
+  llvm::Value* codegenSlot(const CompilationOptions&, const size_t) override;
+
+  HashJoinMatchingSet codegenMatchingSet(const CompilationOptions&,
+                                         const size_t) override;
+
+  int getInnerTableId() const noexcept override { return sort_col_->get_table_id(); }
+
+  int getInnerTableRteIdx() const noexcept override { return sort_col_->get_rte_idx(); }
+
+  HashType getHashType() const noexcept override { return HashType::OneToMany; }
+
+  Data_Namespace::MemoryLevel getMemoryLevel() const noexcept override {
+    return Data_Namespace::CPU_LEVEL;
+  }
+
+  int getDeviceCount() const noexcept override { return 1; }
+
+  std::string getHashJoinType() const override { return "band"; }
+
+  size_t offsetBufferOff() const noexcept override { return 0; }
+
+  size_t countBufferOff() const noexcept override { return 0; }
+
+  size_t payloadBufferOff() const noexcept override;
+
+ private:
+  // An expression of the outer tables bounding an inner column, through the qualifier.
+  struct Bound {
+    std::shared_ptr<Analyzer::ColumnVar> inner_col;
+    std::shared_ptr<Analyzer::Expr> outer_expr;
+    std::shared_ptr<Analyzer::BinOper> qual;
+  };
+
+  BandJoinTable(const Bound& lower,
+                const Bound& upper,
+                const std::vector<InputTableInfo>& query_infos,
+                ColumnCacheMap& column_cache,
+                Executor* executor);
+
+  void reify();
+
+  llvm::Value* codegenBound(const Analyzer::Expr* bound, const CompilationOptions& co);
+
+  std::shared_ptr<Analyzer::ColumnVar> sort_col_;
+  Bound lower_;
+  Bound upper_;
+  const std::vector<InputTableInfo>& query_infos_;
+  ColumnCacheMap& column_cache_;
+  Executor* executor_;
+  // the count of the inner rows with a value, the span the lower bound is widened by, the
+  // sorted values, then the 32-bit ids of their rows
+  std::vector<int64_t> cpu_buff_;
+};
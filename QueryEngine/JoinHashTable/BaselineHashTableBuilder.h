@@ -23,6 +23,9 @@
 #include "QueryEngine/JoinHashTable/JoinHashTableGpuUtils.h"
 #include "Shared/thread_count.h"
 
+extern size_t g_hash_join_partition_threshold_bytes;
+extern size_t g_hash_join_partition_bytes;
+
 template <typename SIZE,
           class KEY_HANDLER,
           typename std::enable_if<sizeof(SIZE) == 4, SIZE>::type* = nullptr>
@@ -316,53 +319,93 @@ class BaselineJoinHashTableBuilder {
     for (auto& child : init_cpu_buff_threads) {
       child.get();
     }
+    int err = 0;
+    bool partitioned = false;
+    if constexpr (std::is_same<KEY_HANDLER, GenericKeyHandler>::value) {
+      const auto keys_size = entry_size * keyspace_entry_count;
+      if (keys_size > g_hash_join_partition_threshold_bytes) {
+        const auto partition_count =
+            std::max(keys_size / std::max(g_hash_join_partition_bytes, size_t(1)),
+                     size_t(1));
+        VLOG(1) << "Building CPU Join Hash Table in " << partition_count
+                << " partitions";
+        switch (key_component_width) {
+          case 4:
+            err = partitioned_fill_baseline_hash_join_buff_32(
+                cpu_hash_table_ptr,
+                keyspace_entry_count,
+                -1,
+                key_component_count,
+                layout == JoinHashTableInterface::HashType::OneToOne,
+                key_handler,
+                partition_count,
+                thread_count);
+            break;
+          case 8:
+            err = partitioned_fill_baseline_hash_join_buff_64(
+                cpu_hash_table_ptr,
+                keyspace_entry_count,
+                -1,
+                key_component_count,
+                layout == JoinHashTableInterface::HashType::OneToOne,
+                key_handler,
+                partition_count,
+                thread_count);
+            break;
+          default:
+            CHECK(false);
+        }
+        partitioned = true;
+      }
+    }
     std::vector<std::future<int>> fill_cpu_buff_threads;
-    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-      fill_cpu_buff_threads.emplace_back(
-          std::async(std::launch::async,
-                     [key_handler,
-                      keyspace_entry_count,
-                      &join_columns,
-                      key_component_count,
-                      key_component_width,
-                      layout,
-                      thread_idx,
-                      cpu_hash_table_ptr,
-                      thread_count] {
-                       switch (key_component_width) {
-                         case 4: {
-                           return fill_baseline_hash_join_buff<int32_t>(
-                               cpu_hash_table_ptr,
-                               keyspace_entry_count,
-                               -1,
-                               key_component_count,
-                               layout == JoinHashTableInterface::HashType::OneToOne,
-                               key_handler,
-                               join_columns[0].num_elems,
-                               thread_idx,
-                               thread_count);
-                           break;
+    if (!partitioned) {
+      for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+        fill_cpu_buff_threads.emplace_back(
+            std::async(std::launch::async,
+                       [key_handler,
+                        keyspace_entry_count,
+                        &join_columns,
+                        key_component_count,
+                        key_component_width,
+                        layout,
+                        thread_idx,
+                        cpu_hash_table_ptr,
+                        thread_count] {
+                         switch (key_component_width) {
+                           case 4: {
+                             return fill_baseline_hash_join_buff<int32_t>(
+                                 cpu_hash_table_ptr,
+                                 keyspace_entry_count,
+                                 -1,
+                                 key_component_count,
+                                 layout == JoinHashTableInterface::HashType::OneToOne,
+                                 key_handler,
+                                 join_columns[0].num_elems,
+                                 thread_idx,
+                                 thread_count);
+                             break;
+                           }
+                           case 8: {
+                             return fill_baseline_hash_join_buff<int64_t>(
+                                 cpu_hash_table_ptr,
+                                 keyspace_entry_count,
+                                 -1,
+                                 key_component_count,
+                                 layout == JoinHashTableInterface::HashType::OneToOne,
+                                 key_handler,
+                                 join_columns[0].num_elems,
+                                 thread_idx,
+                                 thread_count);
+                             break;
+                           }
+                           default:
+                             CHECK(false);
                          }
-                         case 8: {
-                           return fill_baseline_hash_join_buff<int64_t>(
-                               cpu_hash_table_ptr,
-                               keyspace_entry_count,
-                               -1,
-                               key_component_count,
-                               layout == JoinHashTableInterface::HashType::OneToOne,
-                               key_handler,
-                               join_columns[0].num_elems,
-                               thread_idx,
-                               thread_count);
-                           break;
-                         }
-                         default:
-                           CHECK(false);
-                       }
-                       return -1;
-                     }));
+                         return -1;
+                       }));
+      }
     }
-    int err = 0;
     for (auto& child : fill_cpu_buff_threads) {
       int partial_err = child.get();
       if (partial_err) {
@@ -375,7 +418,6 @@ class BaselineJoinHashTableBuilder {
     if (JoinHashTableInterface::layoutRequiresAdditionalBuffers(layout)) {
       auto one_to_many_buff = reinterpret_cast<int32_t*>(
           cpu_hash_table_ptr + keyspace_entry_count * entry_size);
-      init_hash_join_buff(one_to_many_buff, keyspace_entry_count, -1, 0, 1);
       switch (key_component_width) {
         case 4: {
           const auto composite_key_dict = reinterpret_cast<int32_t*>(cpu_hash_table_ptr);
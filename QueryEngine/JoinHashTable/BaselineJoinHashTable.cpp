@@ -28,9 +28,8 @@
 #include "QueryEngine/JoinHashTable/HashJoinKeyHandlers.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableGpuUtils.h"
 
-std::vector<std::pair<HashTableCacheKey, BaselineJoinHashTable::HashTableCacheValue>>
+HashTableCache<HashTableCacheKey, BaselineJoinHashTable::HashTableCacheValue>
     BaselineJoinHashTable::hash_table_cache_;
-std::mutex BaselineJoinHashTable::hash_table_cache_mutex_;
 
 //! Make hash table from an in-flight SQL query's parse tree etc.
 std::shared_ptr<BaselineJoinHashTable> BaselineJoinHashTable::getInstance(
@@ -631,6 +630,7 @@ int BaselineJoinHashTable::initHashTableForDevice(
     if (hash_table) {
       hash_tables_for_device_[device_id] = hash_table;
     } else {
+      const auto build_begin = timer_start();
       BaselineJoinHashTableBuilder builder(catalog_);
 
       const auto key_handler =
@@ -651,10 +651,16 @@ int BaselineJoinHashTable::initHashTableForDevice(
                                        getKeyComponentWidth(),
                                        getKeyComponentCount());
       hash_tables_for_device_[device_id] = builder.getHashTable();
+      if (hash_tables_for_device_[device_id]) {
+        chargeHostMemory(executor_,
+                         hash_tables_for_device_[device_id]->getHashTableBufferSize(
+                             ExecutorDeviceType::CPU));
+      }
 
       if (!err) {
         if (getInnerTableId() > 0) {
-          putHashTableOnCpuToCache(cache_key, hash_tables_for_device_[device_id]);
+          putHashTableOnCpuToCache(
+              cache_key, hash_tables_for_device_[device_id], timer_stop(build_begin));
         }
       }
     }
@@ -740,6 +746,7 @@ llvm::Value* BaselineJoinHashTable::codegenSlot(const CompilationOptions& co,
   const auto key_component_width = getKeyComponentWidth();
   CHECK(key_component_width == 4 || key_component_width == 8);
   auto key_buff_lv = codegenKey(co);
+  codegenProbePrefetch(index, co);
   const auto hash_ptr = hashPtr(index);
   const auto key_ptr_lv =
       LL_BUILDER.CreatePointerCast(key_buff_lv, llvm::Type::getInt8PtrTy(LL_CONTEXT));
@@ -758,6 +765,7 @@ HashJoinMatchingSet BaselineJoinHashTable::codegenMatchingSet(
   CHECK(key_component_width == 4 || key_component_width == 8);
   auto key_buff_lv = codegenKey(co);
   CHECK(getHashType() == JoinHashTableInterface::HashType::OneToMany);
+  codegenProbePrefetch(index, co);
   auto hash_ptr = JoinHashTable::codegenHashTableLoad(index, executor_);
   const auto composite_dict_ptr_type =
       llvm::Type::getIntNPtrTy(LL_CONTEXT, key_component_width * 8);
@@ -875,6 +883,57 @@ llvm::Value* BaselineJoinHashTable::codegenKey(const CompilationOptions& co) {
   return key_buff_lv;
 }
 
+void BaselineJoinHashTable::codegenProbePrefetch(const size_t index,
+                                                 const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
+  if (condition_->is_overlaps_oper() ||
+      memory_level_ != Data_Namespace::MemoryLevel::CPU_LEVEL) {
+    return;
+  }
+  const auto prefetch_pos_lv = JoinHashTable::codegenPrefetchPos(
+      getJoinHashBufferSize(ExecutorDeviceType::CPU, 0), co, executor_);
+  if (!prefetch_pos_lv) {
+    return;
+  }
+  const auto key_component_width = getKeyComponentWidth();
+  CodeGenerator code_generator(executor_);
+  std::vector<llvm::Value*> key_component_lvs;
+  for (const auto& inner_outer_pair : inner_outer_pairs_) {
+    const auto outer_col_var =
+        dynamic_cast<const Analyzer::ColumnVar*>(inner_outer_pair.second);
+    if (!outer_col_var) {
+      return;
+    }
+    const auto col_lv =
+        code_generator.codegenColumnAt(outer_col_var, prefetch_pos_lv, co);
+    if (!col_lv) {
+      return;
+    }
+    key_component_lvs.push_back(
+        LL_BUILDER.CreateSExt(col_lv, get_int_type(key_component_width * 8, LL_CONTEXT)));
+  }
+  const auto key_buff_lv =
+      LL_BUILDER.CreateAlloca(get_int_type(key_component_width * 8, LL_CONTEXT),
+                              LL_INT(key_component_lvs.size()));
+  for (size_t i = 0; i < key_component_lvs.size(); ++i) {
+    LL_BUILDER.CreateStore(key_component_lvs[i],
+                           LL_BUILDER.CreateGEP(key_buff_lv, LL_INT(i)));
+  }
+  const auto key_bytes = getKeyComponentCount() * key_component_width;
+  // one to one entries hold the key and the payload, one to many entries the key only
+  const auto entry_bytes =
+      getHashType() == JoinHashTableInterface::HashType::OneToOne
+          ? key_bytes + key_component_width
+          : key_bytes;
+  executor_->cgen_state_->emitCall(
+      "baseline_hash_join_prefetch",
+      {hashPtr(index),
+       LL_BUILDER.CreatePointerCast(key_buff_lv, llvm::Type::getInt8PtrTy(LL_CONTEXT)),
+       LL_INT(key_bytes),
+       LL_INT(entry_count_),
+       LL_INT(entry_bytes)});
+}
+
 llvm::Value* BaselineJoinHashTable::hashPtr(const size_t index) {
   AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
   auto hash_ptr = JoinHashTable::codegenHashTableLoad(index, executor_);
@@ -939,24 +998,20 @@ std::shared_ptr<BaselineHashTable> BaselineJoinHashTable::initHashTableOnCpuFrom
     const HashTableCacheKey& key) {
   auto timer = DEBUG_TIMER(__func__);
   VLOG(1) << "Checking CPU hash table cache.";
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  if (hash_table_cache_.size() == 0) {
-    VLOG(1) << "CPU hash table cache was empty.";
-  }
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      VLOG(1) << "Found a suitable hash table in the cache.";
-      return kv.second;
-    }
+  auto hash_table = hash_table_cache_.get(key);
+  if (hash_table) {
+    VLOG(1) << "Found a suitable hash table in the cache.";
+  } else {
+    VLOG(1) << hash_table_cache_.size()
+            << " hash tables found in cache. None were suitable for this query.";
   }
-  VLOG(1) << hash_table_cache_.size()
-          << " hash tables found in cache. None were suitable for this query.";
-  return nullptr;
+  return hash_table;
 }
 
 void BaselineJoinHashTable::putHashTableOnCpuToCache(
     const HashTableCacheKey& key,
-    std::shared_ptr<BaselineHashTable>& hash_table) {
+    std::shared_ptr<BaselineHashTable>& hash_table,
+    const int64_t build_time_ms) {
   for (auto chunk_key : key.chunk_keys) {
     CHECK_GE(chunk_key.size(), size_t(2));
     if (chunk_key[1] < 0) {
@@ -964,16 +1019,15 @@ void BaselineJoinHashTable::putHashTableOnCpuToCache(
     }
   }
 
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
   VLOG(1) << "Storing hash table in cache.";
-  for (auto& kv : hash_table_cache_) {
-    if (std::get<0>(kv) == key) {
-      auto& cached_hash_table = std::get<1>(kv);
-      cached_hash_table = hash_table;
-      return;
-    }
-  }
-  hash_table_cache_.emplace_back(key, hash_table);
+  CHECK(hash_table);
+  CHECK(!key.chunk_keys.empty());
+  const auto& inner_chunk_key = key.chunk_keys.front();
+  hash_table_cache_.put(key,
+                        hash_table,
+                        hash_table->getHashTableBufferSize(ExecutorDeviceType::CPU),
+                        {inner_chunk_key[0], inner_chunk_key[1]},
+                        build_time_ms);
 }
 
 std::pair<std::optional<size_t>, size_t>
@@ -987,14 +1041,9 @@ BaselineJoinHashTable::getApproximateTupleCountFromCache(
     }
   }
 
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      const auto hash_tables_for_device = kv.second;
-      CHECK(hash_tables_for_device);
-      return std::make_pair(hash_tables_for_device->getEntryCount() / 2,
-                            hash_tables_for_device->getEmittedKeysCount());
-    }
+  if (const auto hash_tables_for_device = hash_table_cache_.peek(key)) {
+    return std::make_pair(hash_tables_for_device->getEntryCount() / 2,
+                          hash_tables_for_device->getEmittedKeysCount());
   }
   return std::make_pair(std::nullopt, 0);
 }
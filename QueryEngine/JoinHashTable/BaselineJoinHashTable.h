@@ -33,6 +33,7 @@
 #include "QueryEngine/InputMetadata.h"
 #include "QueryEngine/JoinHashTable/BaselineHashTable.h"
 #include "QueryEngine/JoinHashTable/HashJoinRuntime.h"
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
 
 class Executor;
@@ -148,6 +149,10 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   int getDeviceCount() const noexcept override { return device_count_; };
 
+  std::string getHashJoinType() const override {
+    return !condition_->is_overlaps_oper() ? "keyed" : "geo";
+  }
+
   size_t offsetBufferOff() const noexcept override;
 
   size_t countBufferOff() const noexcept override;
@@ -157,34 +162,24 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
   static auto yieldCacheInvalidator() -> std::function<void()> {
     VLOG(1) << "Invalidate " << hash_table_cache_.size() << " cached baseline hashtable.";
     return []() -> void {
-      std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
       hash_table_cache_.clear();
       HashTypeCache::clear();
     };
   }
 
   static int8_t* getCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    CHECK(!hash_table_cache_.empty());
-    CHECK_LT(idx, hash_table_cache_.size());
-    auto hash_tables_for_device = hash_table_cache_.at(idx).second;
+    auto hash_tables_for_device = hash_table_cache_.at(idx);
     CHECK(hash_tables_for_device);
     return hash_tables_for_device->getCpuBuffer();
   }
 
   static size_t getEntryCntCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    CHECK(!hash_table_cache_.empty());
-    CHECK_LT(idx, hash_table_cache_.size());
-    auto hash_tables_for_device = hash_table_cache_.at(idx).second;
+    auto hash_tables_for_device = hash_table_cache_.at(idx);
     CHECK(hash_tables_for_device);
     return hash_tables_for_device->getEntryCount();
   }
 
-  static uint64_t getNumberOfCachedHashTables() {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    return hash_table_cache_.size();
-  }
+  static uint64_t getNumberOfCachedHashTables() { return hash_table_cache_.size(); }
 
   virtual ~BaselineJoinHashTable() {}
 
@@ -228,6 +223,8 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   virtual llvm::Value* codegenKey(const CompilationOptions&);
 
+  void codegenProbePrefetch(const size_t index, const CompilationOptions&);
+
   size_t shardCount() const;
 
   Data_Namespace::MemoryLevel getEffectiveMemoryLevel(
@@ -258,7 +255,8 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
       const HashTableCacheKey&);
 
   void putHashTableOnCpuToCache(const HashTableCacheKey&,
-                                std::shared_ptr<BaselineHashTable>& hash_table);
+                                std::shared_ptr<BaselineHashTable>& hash_table,
+                                const int64_t build_time_ms);
 
   std::pair<std::optional<size_t>, size_t> getApproximateTupleCountFromCache(
       const HashTableCacheKey&) const;
@@ -293,8 +291,7 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
 
   using HashTableCacheValue = std::shared_ptr<BaselineHashTable>;
 
-  static std::vector<std::pair<HashTableCacheKey, HashTableCacheValue>> hash_table_cache_;
-  static std::mutex hash_table_cache_mutex_;
+  static HashTableCache<HashTableCacheKey, HashTableCacheValue> hash_table_cache_;
 
   static const int ERR_FAILED_TO_FETCH_COLUMN{-3};
   static const int ERR_FAILED_TO_JOIN_ON_VIRTUAL_COLUMN{-4};
@@ -544,6 +544,109 @@ DEVICE int SUFFIX(fill_baseline_hash_join_buff)(int8_t* hash_buff,
   return 0;
 }
 
+#ifndef __CUDACC__
+/**
+ * Radix partitioned build of a keyed hash table. The keys are first scattered into
+ * partitions by the hash bits which select the region of the table they go to, then
+ * each thread inserts whole partitions. Compared to inserting the rows in their
+ * original order, the random writes of a thread stay within one cache sized region of
+ * the table at a time instead of spanning the whole table.
+ */
+template <typename T, typename FILL_HANDLER>
+int partitioned_fill_baseline_hash_join_buff(int8_t* hash_buff,
+                                             const int64_t entry_count,
+                                             const int32_t invalid_slot_val,
+                                             const size_t key_component_count,
+                                             const bool with_val_slot,
+                                             const FILL_HANDLER* f,
+                                             const size_t partition_count,
+                                             const int32_t cpu_thread_count) {
+  CHECK_GT(partition_count, size_t(0));
+  CHECK_GT(cpu_thread_count, 0);
+  const size_t key_size_in_bytes = key_component_count * sizeof(T);
+  const size_t hash_entry_size =
+      (key_component_count + (with_val_slot ? 1 : 0)) * sizeof(T);
+  // a partition holds the row id of each entry followed by its key
+  const size_t partition_entry_size = key_component_count + 1;
+  using Partitions = std::vector<std::vector<T>>;
+  std::vector<Partitions> partitions_per_thread(cpu_thread_count,
+                                                Partitions(partition_count));
+  const auto get_first_error = [](std::vector<std::future<int>>& threads) {
+    int err = 0;
+    for (auto& child : threads) {
+      const int partial_err = child.get();
+      if (partial_err) {
+        err = partial_err;
+      }
+    }
+    return err;
+  };
+
+  std::vector<std::future<int>> partition_threads;
+  for (int32_t thread_idx = 0; thread_idx < cpu_thread_count; ++thread_idx) {
+    partition_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      auto& partitions = partitions_per_thread[thread_idx];
+      auto key_buff_handler = [&](const int64_t entry_idx,
+                                  const T* key_scratch_buffer,
+                                  const size_t key_component_count) {
+        const uint32_t h =
+            MurmurHash1Impl(key_scratch_buffer, key_size_in_bytes, 0) % entry_count;
+        auto& partition = partitions[uint64_t(h) * partition_count / entry_count];
+        partition.push_back(static_cast<T>(entry_idx));
+        partition.insert(partition.end(),
+                         key_scratch_buffer,
+                         key_scratch_buffer + key_component_count);
+        return 0;
+      };
+      T key_scratch_buff[g_maximum_conditions_to_coalesce];
+      JoinColumnTuple cols(f->get_number_of_columns(),
+                           f->get_join_columns(),
+                           f->get_join_column_type_infos());
+      for (auto& it : cols.slice(thread_idx, cpu_thread_count)) {
+        const auto err =
+            (*f)(it.join_column_iterators, key_scratch_buff, key_buff_handler);
+        if (err) {
+          return err;
+        }
+      }
+      return 0;
+    }));
+  }
+  auto err = get_first_error(partition_threads);
+  if (err) {
+    return err;
+  }
+
+  std::vector<std::future<int>> fill_threads;
+  for (int32_t thread_idx = 0; thread_idx < cpu_thread_count; ++thread_idx) {
+    fill_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      for (size_t partition_idx = thread_idx; partition_idx < partition_count;
+           partition_idx += cpu_thread_count) {
+        for (const auto& partitions : partitions_per_thread) {
+          const auto& partition = partitions[partition_idx];
+          for (size_t i = 0; i < partition.size(); i += partition_entry_size) {
+            const auto err = write_baseline_hash_slot<T>(partition[i],
+                                                         hash_buff,
+                                                         entry_count,
+                                                         &partition[i + 1],
+                                                         key_component_count,
+                                                         with_val_slot,
+                                                         invalid_slot_val,
+                                                         key_size_in_bytes,
+                                                         hash_entry_size);
+            if (err) {
+              return err;
+            }
+          }
+        }
+      }
+      return 0;
+    }));
+  }
+  return get_first_error(fill_threads);
+}
+#endif  // __CUDACC__
+
 #undef mapd_cas
 
 #ifdef __CUDACC__
@@ -1745,6 +1848,106 @@ int overlaps_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                                cpu_thread_count);
 }
 
+int partitioned_fill_baseline_hash_join_buff_32(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count) {
+  return partitioned_fill_baseline_hash_join_buff<int32_t>(hash_buff,
+                                                           entry_count,
+                                                           invalid_slot_val,
+                                                           key_component_count,
+                                                           with_val_slot,
+                                                           key_handler,
+                                                           partition_count,
+                                                           cpu_thread_count);
+}
+
+int partitioned_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count) {
+  return partitioned_fill_baseline_hash_join_buff<int64_t>(hash_buff,
+                                                           entry_count,
+                                                           invalid_slot_val,
+                                                           key_component_count,
+                                                           with_val_slot,
+                                                           key_handler,
+                                                           partition_count,
+                                                           cpu_thread_count);
+}
+
+namespace {
+
+// Runs func(range_idx, start, end) on one contiguous range of [0, entry_count) per
+// thread. The ranges start on cache line boundaries, so threads never write to the same
+// line.
+template <typename FUNC>
+void for_each_entry_range(const int64_t entry_count,
+                          const size_t cpu_thread_count,
+                          FUNC func) {
+  constexpr int64_t entries_per_line = 64 / sizeof(int32_t);
+  const int64_t thread_count = std::max(cpu_thread_count, size_t(1));
+  const int64_t step =
+      (((entry_count + thread_count - 1) / thread_count + entries_per_line - 1) /
+       entries_per_line) *
+      entries_per_line;
+  std::vector<std::future<void>> range_threads;
+  for (int64_t start = 0; start < entry_count; start += step) {
+    range_threads.push_back(std::async(std::launch::async,
+                                       func,
+                                       range_threads.size(),
+                                       start,
+                                       std::min(start + step, entry_count)));
+  }
+  for (auto& child : range_threads) {
+    child.get();
+  }
+}
+
+// Exclusive prefix sum of the match counts into the positions of the entries with
+// matches, partitioned by thread: each range is summed, then scanned again from the
+// total of the ranges before it. The counts are reset for the row id pass.
+void compute_one_to_many_positions(int32_t* pos_buff,
+                                   int32_t* count_buff,
+                                   const int64_t hash_entry_count,
+                                   const size_t cpu_thread_count) {
+  std::vector<int32_t> range_sums(std::max(cpu_thread_count, size_t(1)), 0);
+  for_each_entry_range(
+      hash_entry_count,
+      cpu_thread_count,
+      [&](const size_t range_idx, const int64_t start, const int64_t end) {
+        range_sums[range_idx] = std::accumulate(count_buff + start, count_buff + end, 0);
+      });
+  int32_t sum = 0;
+  for (auto& range_sum : range_sums) {
+    std::swap(sum, range_sum);
+    sum += range_sum;
+  }
+  for_each_entry_range(
+      hash_entry_count,
+      cpu_thread_count,
+      [&](const size_t range_idx, const int64_t start, const int64_t end) {
+        int32_t pos = range_sums[range_idx];
+        for (int64_t i = start; i < end; ++i) {
+          if (count_buff[i]) {
+            pos_buff[i] = pos;
+            pos += count_buff[i];
+            count_buff[i] = 0;
+          }
+        }
+      });
+}
+
+}  // namespace
+
 template <typename T>
 void fill_one_to_many_baseline_hash_table(
     int32_t* buff,
@@ -1760,7 +1963,13 @@ void fill_one_to_many_baseline_hash_table(
     const size_t cpu_thread_count) {
   int32_t* pos_buff = buff;
   int32_t* count_buff = buff + hash_entry_count;
-  memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
+  for_each_entry_range(
+      hash_entry_count,
+      cpu_thread_count,
+      [&](const size_t range_idx, const int64_t start, const int64_t end) {
+        std::fill(pos_buff + start, pos_buff + end, invalid_slot_val);
+        std::fill(count_buff + start, count_buff + end, 0);
+      });
   std::vector<std::future<void>> counter_threads;
   for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
     if (join_buckets_per_key.size() > 0) {
@@ -1819,29 +2028,9 @@ void fill_one_to_many_baseline_hash_table(
     child.get();
   }
 
-  std::vector<int32_t> count_copy(hash_entry_count, 0);
   CHECK_GT(hash_entry_count, int64_t(0));
-  memcpy(&count_copy[1], count_buff, (hash_entry_count - 1) * sizeof(int32_t));
-  ::inclusive_scan(
-      count_copy.begin(), count_copy.end(), count_copy.begin(), cpu_thread_count);
-  std::vector<std::future<void>> pos_threads;
-  for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
-    pos_threads.push_back(std::async(
-        std::launch::async,
-        [&](const int thread_idx) {
-          for (int64_t i = thread_idx; i < hash_entry_count; i += cpu_thread_count) {
-            if (count_buff[i]) {
-              pos_buff[i] = count_copy[i];
-            }
-          }
-        },
-        cpu_thread_idx));
-  }
-  for (auto& child : pos_threads) {
-    child.get();
-  }
+  compute_one_to_many_positions(pos_buff, count_buff, hash_entry_count, cpu_thread_count);
 
-  memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
   std::vector<std::future<void>> rowid_threads;
   for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
     if (join_buckets_per_key.size() > 0) {
@@ -2007,10 +2196,12 @@ void approximate_distinct_tuples_overlaps(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_buckets_per_key,
-    const int thread_count) {
+    const int thread_count,
+    const int sample_stride) {
   CHECK_EQ(join_column_per_key.size(), join_buckets_per_key.size());
   CHECK_EQ(join_column_per_key.size(), type_info_per_key.size());
   CHECK(!join_column_per_key.empty());
+  CHECK_GE(sample_stride, 1);
 
   std::vector<std::future<void>> approx_distinct_threads;
   for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
@@ -2023,20 +2214,22 @@ void approximate_distinct_tuples_overlaps(
          hll_buffer_all_cpus,
          padded_size_bytes,
          thread_idx,
-         thread_count] {
+         thread_count,
+         sample_stride] {
           auto hll_buffer = hll_buffer_all_cpus + thread_idx * padded_size_bytes;
 
           const auto key_handler = OverlapsKeyHandler(
               join_buckets_per_key[0].bucket_sizes_for_dimension.size(),
               &join_column_per_key[0],
               join_buckets_per_key[0].bucket_sizes_for_dimension.data());
+          // the threads share every sample_stride-th row
           approximate_distinct_tuples_impl(hll_buffer,
                                            row_counts.data(),
                                            b,
                                            join_column_per_key[0].num_elems,
                                            &key_handler,
-                                           thread_idx,
-                                           thread_count);
+                                           thread_idx * sample_stride,
+                                           thread_count * sample_stride);
         }));
   }
   for (auto& child : approx_distinct_threads) {
@@ -297,6 +297,24 @@ int overlaps_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                              const int32_t cpu_thread_idx,
                                              const int32_t cpu_thread_count);
 
+int partitioned_fill_baseline_hash_join_buff_32(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count);
+
+int partitioned_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count);
+
 void fill_baseline_hash_join_buff_on_device_32(int8_t* hash_buff,
                                                const int64_t entry_count,
                                                const int32_t invalid_slot_val,
@@ -403,7 +421,8 @@ void approximate_distinct_tuples_overlaps(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_buckets_per_key,
-    const int thread_count);
+    const int thread_count,
+    const int sample_stride);
 
 void approximate_distinct_tuples_on_device(uint8_t* hll_buffer,
                                            const uint32_t b,
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
+
+#include <set>
+
+std::atomic<size_t> HashTableCacheBase::resident_bytes_{0};
+std::atomic<uint64_t> HashTableCacheBase::clock_{0};
+
+namespace {
+
+struct HashTableCacheRegistry {
+  std::set<HashTableCacheBase*> caches;
+  std::mutex mutex;
+};
+
+HashTableCacheRegistry& get_registry() {
+  static HashTableCacheRegistry registry;
+  return registry;
+}
+
+}  // namespace
+
+HashTableCacheBase::HashTableCacheBase() {
+  auto& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.caches.insert(this);
+}
+
+HashTableCacheBase::~HashTableCacheBase() {
+  auto& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.caches.erase(this);
+}
+
+HashTableCacheStatsMap HashTableCacheBase::getStats() {
+  HashTableCacheStatsMap stats;
+  auto& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (const auto cache : registry.caches) {
+    cache->addStats(stats);
+  }
+  return stats;
+}
+
+void HashTableCacheBase::enforceBudget() {
+  auto& registry = get_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  while (g_hash_table_cache_max_bytes && resident_bytes_ > g_hash_table_cache_max_bytes) {
+    HashTableCacheBase* oldest_cache{nullptr};
+    uint64_t oldest_use{0};
+    for (const auto cache : registry.caches) {
+      const auto last_use = cache->getOldestUse();
+      if (last_use && (!oldest_cache || *last_use < oldest_use)) {
+        oldest_cache = cache;
+        oldest_use = *last_use;
+      }
+    }
+    if (!oldest_cache) {
+      break;
+    }
+    oldest_cache->evictOldest();
+  }
+}
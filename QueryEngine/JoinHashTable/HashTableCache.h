@@ -0,0 +1,233 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "Logger/Logger.h"
+
+extern size_t g_hash_table_cache_max_bytes;
+
+// {database id, table id} of the inner table a cached hash table was built on
+using HashTableCacheTableKey = std::pair<int, int>;
+
+struct HashTableCacheStats {
+  size_t num_entries{0};
+  size_t resident_bytes{0};
+  int64_t builds{0};
+  int64_t hits{0};
+  int64_t evictions{0};
+  int64_t build_time_ms{0};
+  int64_t build_time_saved_ms{0};
+};
+
+using HashTableCacheStatsMap = std::map<HashTableCacheTableKey, HashTableCacheStats>;
+
+/**
+ * Common part of the CPU hash table caches. All the caches share one byte budget,
+ * g_hash_table_cache_max_bytes (no limit if 0): once their entries are over it, the
+ * least recently used entry across all of them is evicted.
+ *
+ * A cache must not hold its own lock while calling into this class.
+ */
+class HashTableCacheBase {
+ public:
+  virtual ~HashTableCacheBase();
+
+  // Statistics of every cache, summed up per inner table.
+  static HashTableCacheStatsMap getStats();
+
+  static size_t getResidentBytes() { return resident_bytes_; }
+
+ protected:
+  HashTableCacheBase();
+
+  static uint64_t tick() { return ++clock_; }
+
+  static void enforceBudget();
+
+  // Last use of the least recently used entry, if the cache is not empty.
+  virtual std::optional<uint64_t> getOldestUse() const = 0;
+
+  virtual void evictOldest() = 0;
+
+  virtual void addStats(HashTableCacheStatsMap& stats) const = 0;
+
+  static std::atomic<size_t> resident_bytes_;
+
+ private:
+  static std::atomic<uint64_t> clock_;
+};
+
+/**
+ * Hash tables built on CPU, kept across queries until the inner table changes or they
+ * are evicted. Keys only need operator==: there are few entries and lookups are linear,
+ * in insertion order.
+ */
+template <class CACHE_KEY, class CACHE_VALUE>
+class HashTableCache : public HashTableCacheBase {
+ public:
+  ~HashTableCache() override { clear(); }
+
+  CACHE_VALUE get(const CACHE_KEY& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = find(key);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+    it->last_use = tick();
+    auto& table_stats = stats_[it->table_key];
+    ++table_stats.hits;
+    table_stats.build_time_saved_ms += it->build_time_ms;
+    return it->value;
+  }
+
+  // Same as get(), without counting a use.
+  CACHE_VALUE peek(const CACHE_KEY& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = find(key);
+    return it == entries_.end() ? nullptr : it->value;
+  }
+
+  void put(const CACHE_KEY& key,
+           CACHE_VALUE value,
+           const size_t size_bytes,
+           const HashTableCacheTableKey& table_key,
+           const int64_t build_time_ms) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& table_stats = stats_[table_key];
+      ++table_stats.builds;
+      table_stats.build_time_ms += build_time_ms;
+      auto it = find(key);
+      if (it != entries_.end()) {
+        resident_bytes_ -= it->size_bytes;
+        entries_.erase(it);
+      }
+      if (g_hash_table_cache_max_bytes && size_bytes > g_hash_table_cache_max_bytes) {
+        VLOG(1) << "Not caching hash table of " << size_bytes
+                << " bytes, larger than the hash table cache";
+        return;
+      }
+      entries_.push_back(
+          {key, std::move(value), size_bytes, table_key, build_time_ms, tick()});
+      resident_bytes_ += size_bytes;
+    }
+    enforceBudget();
+  }
+
+  const CACHE_VALUE& at(const size_t idx) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_LT(idx, entries_.size());
+    return std::next(entries_.begin(), idx)->value;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  // Drops the entries, the statistics are kept.
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+      resident_bytes_ -= entry.size_bytes;
+    }
+    entries_.clear();
+  }
+
+ private:
+  struct Entry {
+    CACHE_KEY key;
+    CACHE_VALUE value;
+    size_t size_bytes;
+    HashTableCacheTableKey table_key;
+    int64_t build_time_ms;
+    uint64_t last_use;
+  };
+
+  using EntryIterator = typename std::list<Entry>::iterator;
+  using EntryConstIterator = typename std::list<Entry>::const_iterator;
+
+  EntryIterator find(const CACHE_KEY& key) {
+    return std::find_if(entries_.begin(), entries_.end(), [&key](const Entry& entry) {
+      return entry.key == key;
+    });
+  }
+
+  EntryConstIterator find(const CACHE_KEY& key) const {
+    return std::find_if(entries_.begin(), entries_.end(), [&key](const Entry& entry) {
+      return entry.key == key;
+    });
+  }
+
+  EntryConstIterator findOldest() const {
+    return std::min_element(
+        entries_.begin(), entries_.end(), [](const Entry& lhs, const Entry& rhs) {
+          return lhs.last_use < rhs.last_use;
+        });
+  }
+
+  std::optional<uint64_t> getOldestUse() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.empty()) {
+      return std::nullopt;
+    }
+    return findOldest()->last_use;
+  }
+
+  void evictOldest() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.empty()) {
+      return;
+    }
+    const auto it = findOldest();
+    VLOG(1) << "Evicting hash table of " << it->size_bytes << " bytes from the cache";
+    resident_bytes_ -= it->size_bytes;
+    ++stats_[it->table_key].evictions;
+    entries_.erase(it);
+  }
+
+  void addStats(HashTableCacheStatsMap& stats) const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& kv : stats_) {
+      auto& table_stats = stats[kv.first];
+      table_stats.builds += kv.second.builds;
+      table_stats.hits += kv.second.hits;
+      table_stats.evictions += kv.second.evictions;
+      table_stats.build_time_ms += kv.second.build_time_ms;
+      table_stats.build_time_saved_ms += kv.second.build_time_saved_ms;
+    }
+    for (const auto& entry : entries_) {
+      auto& table_stats = stats[entry.table_key];
+      ++table_stats.num_entries;
+      table_stats.resident_bytes += entry.size_bytes;
+    }
+  }
+
+  std::list<Entry> entries_;  // keys are not assignable
+  std::map<HashTableCacheTableKey, HashTableCacheStats> stats_;
+  mutable std::mutex mutex_;
+};
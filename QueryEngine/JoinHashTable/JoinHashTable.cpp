@@ -16,10 +16,13 @@
 
 #include "QueryEngine/JoinHashTable/JoinHashTable.h"
 
+#include <algorithm>
 #include <atomic>
 #include <future>
+#include <map>
 #include <numeric>
 #include <thread>
+#include <tuple>
 
 #include "Logger/Logger.h"
 #include "QueryEngine/CodeGenerator.h"
@@ -27,8 +30,15 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExpressionRewrite.h"
 #include "QueryEngine/JoinHashTable/HashJoinRuntime.h"
+#include "QueryEngine/JoinHashTable/JoinColumnIterator.h"
 #include "QueryEngine/RangeTableIndexVisitor.h"
 #include "QueryEngine/RuntimeFunctions.h"
+#include "Shared/checked_alloc.h"
+
+extern bool g_enable_join_fragment_pairing;
+extern size_t g_max_perfect_hash_entries_per_row;
+extern size_t g_hash_join_prefetch_distance;
+extern bool g_enable_shared_gpu_hash_tables;
 
 namespace {
 
@@ -257,10 +267,9 @@ size_t get_hash_entry_count(const ExpressionRange& col_range, const bool is_bw_e
 
 }  // namespace
 
-std::vector<std::pair<JoinHashTable::JoinHashTableCacheKey,
-                      std::shared_ptr<std::vector<int32_t>>>>
+HashTableCache<JoinHashTable::JoinHashTableCacheKey,
+               std::shared_ptr<std::vector<int32_t>>>
     JoinHashTable::join_hash_table_cache_;
-std::mutex JoinHashTable::join_hash_table_cache_mutex_;
 
 size_t get_shard_count(const Analyzer::BinOper* join_condition,
                        const Executor* executor) {
@@ -335,6 +344,97 @@ size_t get_shard_count(
              : 0;
 }
 
+namespace {
+
+std::optional<std::pair<int64_t, int64_t>> get_fragment_key_range(
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const Analyzer::ColumnVar* col) {
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  const auto chunk_meta_it = chunk_metadata_map.find(col->get_column_id());
+  if (chunk_meta_it == chunk_metadata_map.end()) {
+    return std::nullopt;
+  }
+  const auto& ti = col->get_type_info();
+  return std::make_pair(extract_min_stat(chunk_meta_it->second->chunkStats, ti),
+                        extract_max_stat(chunk_meta_it->second->chunkStats, ti));
+}
+
+// Pairs the inner fragments with the outer ones by the key ranges in their chunk
+// statistics and returns the inner fragments which can hold a match, if that leaves
+// some of them out. When both tables are sorted on the join key, each fragment only
+// overlaps a few of the other side.
+std::optional<std::vector<Fragmenter_Namespace::FragmentInfo>> get_joined_inner_fragments(
+    const Analyzer::BinOper* qual_bin_oper,
+    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+    const std::vector<InputTableInfo>& query_infos) {
+  if (!g_enable_join_fragment_pairing || qual_bin_oper->get_optype() != kEQ) {
+    return std::nullopt;
+  }
+  const auto inner_col = cols.first;
+  const auto outer_col = dynamic_cast<const Analyzer::ColumnVar*>(cols.second);
+  // Only the outer table is guaranteed to be scanned in full.
+  if (!outer_col || outer_col->get_rte_idx() != 0 || inner_col->get_table_id() <= 0 ||
+      outer_col->get_table_id() <= 0 || !inner_col->get_type_info().is_integer() ||
+      !outer_col->get_type_info().is_integer()) {
+    return std::nullopt;
+  }
+  const auto& inner_fragments =
+      get_inner_query_info(inner_col->get_table_id(), query_infos).info.fragments;
+  const auto& outer_fragments =
+      get_inner_query_info(outer_col->get_table_id(), query_infos).info.fragments;
+  std::vector<std::pair<int64_t, int64_t>> outer_ranges;
+  for (const auto& fragment : outer_fragments) {
+    const auto range = get_fragment_key_range(fragment, outer_col);
+    if (!range) {
+      return std::nullopt;
+    }
+    if (range->first <= range->second) {
+      outer_ranges.push_back(*range);
+    }
+  }
+  // merge the outer ranges, so that a sorted scan finds the one overlapping a key range
+  std::sort(outer_ranges.begin(), outer_ranges.end());
+  std::vector<std::pair<int64_t, int64_t>> merged_outer_ranges;
+  for (const auto& range : outer_ranges) {
+    if (!merged_outer_ranges.empty() &&
+        range.first <= merged_outer_ranges.back().second) {
+      auto& last_range = merged_outer_ranges.back();
+      last_range.second = std::max(last_range.second, range.second);
+    } else {
+      merged_outer_ranges.push_back(range);
+    }
+  }
+  std::vector<Fragmenter_Namespace::FragmentInfo> joined_inner_fragments;
+  for (const auto& fragment : inner_fragments) {
+    const auto range = get_fragment_key_range(fragment, inner_col);
+    if (!range) {
+      return std::nullopt;
+    }
+    // first outer range which ends at or after the start of the inner one
+    const auto it = std::lower_bound(
+        merged_outer_ranges.begin(),
+        merged_outer_ranges.end(),
+        range->first,
+        [](const std::pair<int64_t, int64_t>& outer_range, const int64_t key) {
+          return outer_range.second < key;
+        });
+    // null keys never match on kEQ, fragments of nulls only can be left out as well
+    if (range->first <= range->second && it != merged_outer_ranges.end() &&
+        it->first <= range->second) {
+      joined_inner_fragments.push_back(fragment);
+    }
+  }
+  if (joined_inner_fragments.empty() ||
+      joined_inner_fragments.size() == inner_fragments.size()) {
+    return std::nullopt;
+  }
+  VLOG(1) << "Building the hash table on " << joined_inner_fragments.size() << " of "
+          << inner_fragments.size() << " fragments of the inner table";
+  return joined_inner_fragments;
+}
+
+}  // namespace
+
 //! Make hash table from an in-flight SQL query's parse tree etc.
 std::shared_ptr<JoinHashTable> JoinHashTable::getInstance(
     const std::shared_ptr<Analyzer::BinOper> qual_bin_oper,
@@ -356,8 +456,20 @@ std::shared_ptr<JoinHashTable> JoinHashTable::getInstance(
   const auto inner_col = cols.first;
   CHECK(inner_col);
   const auto& ti = inner_col->get_type_info();
+  auto inner_fragments =
+      get_joined_inner_fragments(qual_bin_oper.get(), cols, query_infos);
   auto col_range =
       getExpressionRange(ti.is_string() ? cols.second : inner_col, query_infos, executor);
+  if (inner_fragments) {
+    // the key range of the fragments the hash table is built on only
+    auto joined_query_infos = query_infos;
+    for (auto& query_info : joined_query_infos) {
+      if (query_info.table_id == inner_col->get_table_id()) {
+        query_info.info.fragments = *inner_fragments;
+      }
+    }
+    col_range = getExpressionRange(inner_col, joined_query_infos, executor);
+  }
   if (col_range.getType() == ExpressionRangeType::Invalid) {
     throw HashJoinFail(
         "Could not compute range for the expressions involved in the equijoin");
@@ -400,16 +512,48 @@ std::shared_ptr<JoinHashTable> JoinHashTable::getInstance(
       col_range.getIntMax() >= std::numeric_limits<int64_t>::max()) {
     throw HashJoinFail("Cannot translate null value for kBW_EQ");
   }
+
+  // Pick the layout from the row count of the inner table and the key range up front,
+  // rather than finding out while building.
+  const auto& inner_query_info =
+      get_inner_query_info(inner_col->get_table_id(), query_infos).info;
+  size_t inner_row_count{0};
+  for (const auto& fragment :
+       inner_fragments ? *inner_fragments : inner_query_info.fragments) {
+    inner_row_count += fragment.getNumTuples();
+  }
+  const bool is_bw_eq = qual_bin_oper->get_optype() == kBW_EQ;
+  // A keyed hash table takes about two entries per inner row: past a few perfect hash
+  // entries per row, it is the smaller and more cache friendly of the two.
+  constexpr size_t min_sparse_entry_count{size_t(1) << 24};
+  if (g_max_perfect_hash_entries_per_row && !ti.is_string() && !is_bw_eq &&
+      bucketized_entry_count > min_sparse_entry_count &&
+      bucketized_entry_count / g_max_perfect_hash_entries_per_row > inner_row_count) {
+    throw TooManyHashEntries("Key range too sparse for a perfect hash table (" +
+                             std::to_string(bucketized_entry_count) + " entries for " +
+                             std::to_string(inner_row_count) + " rows)");
+  }
+  auto hash_type = preferred_hash_type;
+  std::string layout_reason;
+  if (hash_type == JoinHashTableInterface::HashType::OneToOne && !is_bw_eq &&
+      !col_range.hasNulls() && inner_row_count > bucketized_entry_count) {
+    // pigeonhole: some key has to repeat
+    hash_type = JoinHashTableInterface::HashType::OneToMany;
+    layout_reason = "more inner rows (" + std::to_string(inner_row_count) +
+                    ") than keys (" + std::to_string(bucketized_entry_count) + ")";
+  }
   auto join_hash_table =
       std::shared_ptr<JoinHashTable>(new JoinHashTable(qual_bin_oper,
                                                        inner_col,
                                                        query_infos,
                                                        memory_level,
-                                                       preferred_hash_type,
+                                                       hash_type,
                                                        col_range,
                                                        column_cache,
                                                        executor,
-                                                       device_count));
+                                                       device_count,
+                                                       std::move(inner_fragments)));
+  join_hash_table->layout_reason_ = layout_reason;
   try {
     join_hash_table->reify();
   } catch (const TableMustBeReplicated& e) {
@@ -491,6 +635,86 @@ std::vector<Fragmenter_Namespace::FragmentInfo> only_shards_for_device(
   return shards_for_device;
 }
 
+namespace {
+
+struct DictTranslationMapEntry {
+  int64_t inner_generation;
+  int64_t outer_generation;
+  std::shared_ptr<const std::vector<int32_t>> translation_map;
+};
+
+// {database id, inner dictionary id, outer dictionary id}
+using DictTranslationMapKey = std::tuple<int, int, int>;
+
+// Maps every id of the inner dictionary, up to its generation, to the id of the same
+// string in the outer dictionary or to INVALID_STR_ID. Built once per generation of the
+// two dictionaries and shared by all the joins on them.
+std::shared_ptr<const std::vector<int32_t>> get_dict_translation_map(
+    const DictTranslationMapKey& key,
+    const StringDictionaryProxy* sd_inner_proxy,
+    const StringDictionaryProxy* sd_outer_proxy,
+    const size_t max_entry_count) {
+  static std::mutex translation_map_cache_mutex;
+  static std::map<DictTranslationMapKey, DictTranslationMapEntry> translation_map_cache;
+  const auto inner_generation = sd_inner_proxy->getGeneration();
+  const auto outer_generation = sd_outer_proxy->getGeneration();
+  std::lock_guard<std::mutex> translation_map_cache_lock(translation_map_cache_mutex);
+  auto it = translation_map_cache.find(key);
+  if (it != translation_map_cache.end() &&
+      it->second.inner_generation == inner_generation &&
+      it->second.outer_generation == outer_generation) {
+    return it->second.translation_map;
+  }
+  const size_t entry_count = inner_generation >= 0
+                                 ? static_cast<size_t>(inner_generation)
+                                 : sd_inner_proxy->storageEntryCount();
+  if (entry_count > max_entry_count) {
+    return nullptr;
+  }
+  auto timer = DEBUG_TIMER(__func__);
+  auto translation_map = std::make_shared<std::vector<int32_t>>(entry_count);
+  const size_t thread_count = cpu_threads();
+  std::vector<std::future<void>> translation_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    translation_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      for (size_t inner_id = thread_idx; inner_id < entry_count;
+           inner_id += thread_count) {
+        (*translation_map)[inner_id] =
+            sd_outer_proxy->getIdOfString(sd_inner_proxy->getString(inner_id));
+      }
+    }));
+  }
+  for (auto& child : translation_threads) {
+    child.get();
+  }
+  VLOG(1) << "Built a translation map of " << entry_count << " dictionary ids";
+  translation_map_cache[key] = {inner_generation, outer_generation, translation_map};
+  return translation_map;
+}
+
+// Copies a single chunk join column built on the host to the device.
+JoinColumn copy_join_column_to_device(const JoinColumn& host_column,
+                                      DeviceAllocator* device_allocator) {
+  CHECK(device_allocator);
+  CHECK_EQ(host_column.num_chunks, size_t(1));
+  const auto& host_chunk =
+      *reinterpret_cast<const JoinChunk*>(host_column.col_chunks_buff);
+  const auto col_buff_sz =
+      std::max(host_chunk.num_elems, size_t(1)) * host_column.elem_sz;
+  auto device_col_buff = device_allocator->alloc(col_buff_sz);
+  device_allocator->copyToDevice(device_col_buff, host_chunk.col_buff, col_buff_sz);
+  const JoinChunk device_chunk{device_col_buff, host_chunk.num_elems};
+  auto device_col_chunks_buff = device_allocator->alloc(sizeof(JoinChunk));
+  device_allocator->copyToDevice(device_col_chunks_buff,
+                                 reinterpret_cast<const int8_t*>(&device_chunk),
+                                 sizeof(JoinChunk));
+  auto device_column = host_column;
+  device_column.col_chunks_buff = device_col_chunks_buff;
+  return device_column;
+}
+
+}  // namespace
+
 void JoinHashTable::reify() {
   auto timer = DEBUG_TIMER(__func__);
   CHECK_LT(0, device_count_);
@@ -506,19 +730,25 @@ void JoinHashTable::reify() {
       static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
     throw TooManyHashEntries();
   }
+  const auto& inner_fragments =
+      inner_fragments_ ? *inner_fragments_ : query_info.fragments;
+  dict_translation_map_ =
+      getDictTranslationMap(cols, query_info.getNumTuplesUpperBound());
 #ifdef HAVE_CUDA
   gpu_hash_table_buff_.resize(device_count_);
   gpu_hash_table_err_buff_.resize(device_count_);
 #endif  // HAVE_CUDA
   std::vector<std::future<void>> init_threads;
   const int shard_count = shardCount();
+  shared_gpu_hash_table_ = canShareGpuHashTable(shard_count);
+  const int build_device_count = shared_gpu_hash_table_ ? 1 : device_count_;
 
   try {
-    for (int device_id = 0; device_id < device_count_; ++device_id) {
+    for (int device_id = 0; device_id < build_device_count; ++device_id) {
       const auto fragments =
           shard_count
-              ? only_shards_for_device(query_info.fragments, device_id, device_count_)
-              : query_info.fragments;
+              ? only_shards_for_device(inner_fragments, device_id, device_count_)
+              : inner_fragments;
       init_threads.push_back(
           std::async(std::launch::async,
                      hash_type_ == JoinHashTableInterface::HashType::OneToOne
@@ -538,13 +768,14 @@ void JoinHashTable::reify() {
 
   } catch (const NeedsOneToManyHash& e) {
     hash_type_ = JoinHashTableInterface::HashType::OneToMany;
+    layout_reason_ = "duplicate inner keys";
     freeHashBufferMemory();
     init_threads.clear();
-    for (int device_id = 0; device_id < device_count_; ++device_id) {
+    for (int device_id = 0; device_id < build_device_count; ++device_id) {
       const auto fragments =
           shard_count
-              ? only_shards_for_device(query_info.fragments, device_id, device_count_)
-              : query_info.fragments;
+              ? only_shards_for_device(inner_fragments, device_id, device_count_)
+              : inner_fragments;
 
       init_threads.push_back(std::async(std::launch::async,
                                         &JoinHashTable::reifyOneToManyForDevice,
@@ -562,6 +793,25 @@ void JoinHashTable::reify() {
   }
 }
 
+// A hash table on all the inner rows is the same on every GPU, it is built on the first
+// one only when the others can read its memory.
+bool JoinHashTable::canShareGpuHashTable(const int shard_count) const {
+  if (!g_enable_shared_gpu_hash_tables || shard_count ||
+      memory_level_ != Data_Namespace::GPU_LEVEL || device_count_ < 2) {
+    return false;
+  }
+  const auto cuda_mgr = executor_->getCatalog()->getDataMgr().getCudaMgr();
+  if (!cuda_mgr) {
+    return false;
+  }
+  for (int device_id = 1; device_id < device_count_; ++device_id) {
+    if (!cuda_mgr->canAccessPeer(device_id, 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 JoinHashTable::~JoinHashTable() {
 #ifdef HAVE_CUDA
   CHECK(executor_);
@@ -601,10 +851,101 @@ ChunkKey JoinHashTable::genHashTableKey(
   }
   if (fragments.size() < 2) {
     hash_table_key.push_back(fragments.front().fragmentId);
+  } else if (inner_fragments_) {
+    for (const auto& fragment : fragments) {
+      hash_table_key.push_back(fragment.fragmentId);
+    }
   }
   return hash_table_key;
 }
 
+std::shared_ptr<const std::vector<int32_t>> JoinHashTable::getDictTranslationMap(
+    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+    const size_t inner_row_count) const {
+  const auto inner_col = cols.first;
+  const auto& ti = inner_col->get_type_info();
+  const auto outer_col = dynamic_cast<const Analyzer::ColumnVar*>(cols.second);
+  // Temporary tables may hold transient ids, translated nulls would match under
+  // IS NOT DISTINCT FROM and shards are assigned on the inner ids.
+  if (!ti.is_string() || ti.get_size() != 4 || isBitwiseEq() || shardCount() ||
+      !outer_col || inner_col->get_table_id() <= 0 || outer_col->get_table_id() <= 0 ||
+      !needs_dictionary_translation(inner_col, outer_col, executor_)) {
+    return nullptr;
+  }
+  CHECK_EQ(kENCODING_DICT, ti.get_compression());
+  const auto sd_inner_proxy = executor_->getStringDictionaryProxy(
+      inner_col->get_comp_param(), executor_->row_set_mem_owner_, true);
+  CHECK(sd_inner_proxy);
+  const auto sd_outer_proxy = executor_->getStringDictionaryProxy(
+      outer_col->get_comp_param(), executor_->row_set_mem_owner_, true);
+  CHECK(sd_outer_proxy);
+  // Translating a dictionary much larger than the table would cost more than
+  // translating the ids of the rows.
+  return get_dict_translation_map({executor_->getCatalog()->getCurrentDB().dbId,
+                                   inner_col->get_comp_param(),
+                                   outer_col->get_comp_param()},
+                                  sd_inner_proxy,
+                                  sd_outer_proxy,
+                                  std::max(inner_row_count, size_t(1) << 20));
+}
+
+JoinColumn JoinHashTable::translateInnerJoinColumn(
+    const JoinColumn& join_column,
+    const Analyzer::ColumnVar* inner_col,
+    std::vector<std::shared_ptr<void>>& malloc_owner) const {
+  auto timer = DEBUG_TIMER(__func__);
+  CHECK(dict_translation_map_);
+  const auto& translation_map = *dict_translation_map_;
+  const auto& ti = inner_col->get_type_info();
+  CHECK_EQ(ti.get_size(), 4);
+  const JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
+                                     col_range_.getIntMin(),
+                                     col_range_.getIntMax(),
+                                     inline_fixed_encoding_null_val(ti),
+                                     false,
+                                     col_range_.getIntMax() + 1,
+                                     get_join_column_type_kind(ti)};
+  auto translated_ids = reinterpret_cast<int32_t*>(
+      malloc_owner
+          .emplace_back(
+              checked_malloc(std::max(join_column.num_elems, size_t(1)) *
+                             sizeof(int32_t)),
+              free)
+          .get());
+  const size_t thread_count = cpu_threads();
+  std::vector<std::future<void>> translation_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    translation_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      JoinColumnTyped col{&join_column, &type_info};
+      for (auto item : col.slice(thread_idx, thread_count)) {
+        const auto elem = item.element;
+        auto translated_id = static_cast<int32_t>(type_info.null_val);
+        if (elem != type_info.null_val && elem >= 0 &&
+            elem < static_cast<int64_t>(translation_map.size())) {
+          const auto outer_id = translation_map[elem];
+          // strings the outer column can't hold never match, same as nulls
+          if (outer_id != StringDictionary::INVALID_STR_ID &&
+              outer_id >= type_info.min_val && outer_id <= type_info.max_val) {
+            translated_id = outer_id;
+          }
+        }
+        translated_ids[item.index] = translated_id;
+      }
+    }));
+  }
+  for (auto& child : translation_threads) {
+    child.get();
+  }
+  auto join_chunk = reinterpret_cast<JoinChunk*>(
+      malloc_owner.emplace_back(checked_malloc(sizeof(JoinChunk)), free).get());
+  *join_chunk = {reinterpret_cast<const int8_t*>(translated_ids), join_column.num_elems};
+  return {reinterpret_cast<const int8_t*>(join_chunk),
+          sizeof(JoinChunk),
+          1,
+          join_column.num_elems,
+          sizeof(int32_t)};
+}
+
 void JoinHashTable::reifyOneToOneForDevice(
     const std::vector<Fragmenter_Namespace::FragmentInfo>& fragments,
     const int device_id,
@@ -622,9 +963,11 @@ void JoinHashTable::reifyOneToOneForDevice(
   }
   CHECK(!inner_cd || !(inner_cd->isVirtualCol));
   // Since we don't have the string dictionary payloads on the GPU, we'll build
-  // the join hash table on the CPU and transfer it to the GPU.
+  // the join hash table on the CPU and transfer it to the GPU, unless the ids are
+  // translated on the CPU in bulk first.
   const auto effective_memory_level =
-      needs_dictionary_translation(inner_col, cols.second, executor_)
+      !dict_translation_map_ &&
+              needs_dictionary_translation(inner_col, cols.second, executor_)
           ? Data_Namespace::CPU_LEVEL
           : memory_level_;
   if (fragments.empty()) {
@@ -646,15 +989,21 @@ void JoinHashTable::reifyOneToOneForDevice(
   }
   std::vector<std::shared_ptr<void>> malloc_owner;
 
-  JoinColumn join_column = fetchJoinColumn(inner_col,
-                                           fragments,
-                                           effective_memory_level,
-                                           device_id,
-                                           chunks_owner,
-                                           device_allocator.get(),
-                                           malloc_owner,
-                                           executor_,
-                                           &column_cache_);
+  JoinColumn join_column = fetchJoinColumn(
+      inner_col,
+      fragments,
+      dict_translation_map_ ? Data_Namespace::CPU_LEVEL : effective_memory_level,
+      device_id,
+      chunks_owner,
+      device_allocator.get(),
+      malloc_owner,
+      executor_,
+      &column_cache_);
+  if (dict_translation_map_ && effective_memory_level == MemoryLevel::GPU_LEVEL) {
+    join_column = copy_join_column_to_device(
+        translateInnerJoinColumn(join_column, inner_col, malloc_owner),
+        device_allocator.get());
+  }
 
   initOneToOneHashTable(genHashTableKey(fragments, cols.second, inner_col),
                         join_column,
@@ -680,9 +1029,11 @@ void JoinHashTable::reifyOneToManyForDevice(
   }
   CHECK(!inner_cd || !(inner_cd->isVirtualCol));
   // Since we don't have the string dictionary payloads on the GPU, we'll build
-  // the join hash table on the CPU and transfer it to the GPU.
+  // the join hash table on the CPU and transfer it to the GPU, unless the ids are
+  // translated on the CPU in bulk first.
   const auto effective_memory_level =
-      needs_dictionary_translation(inner_col, cols.second, executor_)
+      !dict_translation_map_ &&
+              needs_dictionary_translation(inner_col, cols.second, executor_)
           ? Data_Namespace::CPU_LEVEL
           : memory_level_;
   if (fragments.empty()) {
@@ -702,15 +1053,21 @@ void JoinHashTable::reifyOneToManyForDevice(
   }
   std::vector<std::shared_ptr<void>> malloc_owner;
 
-  JoinColumn join_column = fetchJoinColumn(inner_col,
-                                           fragments,
-                                           effective_memory_level,
-                                           device_id,
-                                           chunks_owner,
-                                           device_allocator.get(),
-                                           malloc_owner,
-                                           executor_,
-                                           &column_cache_);
+  JoinColumn join_column = fetchJoinColumn(
+      inner_col,
+      fragments,
+      dict_translation_map_ ? Data_Namespace::CPU_LEVEL : effective_memory_level,
+      device_id,
+      chunks_owner,
+      device_allocator.get(),
+      malloc_owner,
+      executor_,
+      &column_cache_);
+  if (dict_translation_map_ && effective_memory_level == MemoryLevel::GPU_LEVEL) {
+    join_column = copy_join_column_to_device(
+        translateInnerJoinColumn(join_column, inner_col, malloc_owner),
+        device_allocator.get());
+  }
 
   initOneToManyHashTable(genHashTableKey(fragments, cols.second, inner_col),
                          join_column,
@@ -735,7 +1092,7 @@ void JoinHashTable::checkHashJoinReplicationConstraint(const int table_id) const
 }
 
 void JoinHashTable::initOneToOneHashTableOnCpu(
-    const JoinColumn& join_column,
+    const JoinColumn& inner_join_column,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
     const HashEntryInfo hash_entry_info,
     const int32_t hash_join_invalid_val) {
@@ -744,12 +1101,19 @@ void JoinHashTable::initOneToOneHashTableOnCpu(
   CHECK(inner_col);
   const auto& ti = inner_col->get_type_info();
   if (!cpu_hash_table_buff_) {
+    chargeHostMemory(executor_,
+                     hash_entry_info.getNormalizedHashEntryCount() * sizeof(int32_t));
     cpu_hash_table_buff_ = std::make_shared<std::vector<int32_t>>(
         hash_entry_info.getNormalizedHashEntryCount());
     const StringDictionaryProxy* sd_inner_proxy{nullptr};
     const StringDictionaryProxy* sd_outer_proxy{nullptr};
+    std::vector<std::shared_ptr<void>> malloc_owner;
+    const auto& join_column = dict_translation_map_
+                                  ? translateInnerJoinColumn(
+                                        inner_join_column, inner_col, malloc_owner)
+                                  : inner_join_column;
     const auto outer_col = dynamic_cast<const Analyzer::ColumnVar*>(cols.second);
-    if (ti.is_string() &&
+    if (ti.is_string() && !dict_translation_map_ &&
         (outer_col && !(inner_col->get_comp_param() == outer_col->get_comp_param()))) {
       CHECK_EQ(kENCODING_DICT, ti.get_compression());
       sd_inner_proxy = executor_->getStringDictionaryProxy(
@@ -825,7 +1189,7 @@ void JoinHashTable::initOneToOneHashTableOnCpu(
 }
 
 void JoinHashTable::initOneToManyHashTableOnCpu(
-    const JoinColumn& join_column,
+    const JoinColumn& inner_join_column,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
     const HashEntryInfo hash_entry_info,
     const int32_t hash_join_invalid_val) {
@@ -836,11 +1200,20 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
   if (cpu_hash_table_buff_) {
     return;
   }
+  std::vector<std::shared_ptr<void>> malloc_owner;
+  const auto& join_column =
+      dict_translation_map_
+          ? translateInnerJoinColumn(inner_join_column, inner_col, malloc_owner)
+          : inner_join_column;
+  chargeHostMemory(
+      executor_,
+      (2 * hash_entry_info.getNormalizedHashEntryCount() + join_column.num_elems) *
+          sizeof(int32_t));
   cpu_hash_table_buff_ = std::make_shared<std::vector<int32_t>>(
       2 * hash_entry_info.getNormalizedHashEntryCount() + join_column.num_elems);
   const StringDictionaryProxy* sd_inner_proxy{nullptr};
   const StringDictionaryProxy* sd_outer_proxy{nullptr};
-  if (ti.is_string()) {
+  if (ti.is_string() && !dict_translation_map_) {
     CHECK_EQ(kENCODING_DICT, ti.get_compression());
     sd_inner_proxy = executor_->getStringDictionaryProxy(
         inner_col->get_comp_param(), executor_->row_set_mem_owner_, true);
@@ -963,14 +1336,17 @@ void JoinHashTable::initOneToOneHashTable(
   const int32_t hash_join_invalid_val{-1};
   if (effective_memory_level == Data_Namespace::CPU_LEVEL) {
     CHECK(!chunk_key.empty());
-    initHashTableOnCpuFromCache(chunk_key, join_column.num_elems, cols);
-    {
-      std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      initOneToOneHashTableOnCpu(
-          join_column, cols, hash_entry_info, hash_join_invalid_val);
-    }
-    if (inner_col->get_table_id() > 0) {
-      putHashTableOnCpuToCache(chunk_key, join_column.num_elems, cols);
+    if (!initHashTableOnCpuFromCache(chunk_key, join_column.num_elems, cols)) {
+      const auto build_begin = timer_start();
+      {
+        std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
+        initOneToOneHashTableOnCpu(
+            join_column, cols, hash_entry_info, hash_join_invalid_val);
+      }
+      if (inner_col->get_table_id() > 0) {
+        putHashTableOnCpuToCache(
+            chunk_key, join_column.num_elems, cols, timer_stop(build_begin));
+      }
     }
     // Transfer the hash table on the GPU if we've only built it on CPU
     // but the query runs on GPU (join on dictionary encoded columns).
@@ -1097,14 +1473,17 @@ void JoinHashTable::initOneToManyHashTable(
 #endif
   const int32_t hash_join_invalid_val{-1};
   if (effective_memory_level == Data_Namespace::CPU_LEVEL) {
-    initHashTableOnCpuFromCache(chunk_key, join_column.num_elems, cols);
-    {
-      std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      initOneToManyHashTableOnCpu(
-          join_column, cols, hash_entry_info, hash_join_invalid_val);
-    }
-    if (inner_col->get_table_id() > 0) {
-      putHashTableOnCpuToCache(chunk_key, join_column.num_elems, cols);
+    if (!initHashTableOnCpuFromCache(chunk_key, join_column.num_elems, cols)) {
+      const auto build_begin = timer_start();
+      {
+        std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
+        initOneToManyHashTableOnCpu(
+            join_column, cols, hash_entry_info, hash_join_invalid_val);
+      }
+      if (inner_col->get_table_id() > 0) {
+        putHashTableOnCpuToCache(
+            chunk_key, join_column.num_elems, cols, timer_stop(build_begin));
+      }
     }
     // Transfer the hash table on the GPU if we've only built it on CPU
     // but the query runs on GPU (join on dictionary encoded columns).
@@ -1183,7 +1562,7 @@ void JoinHashTable::initOneToManyHashTable(
   }
 }
 
-void JoinHashTable::initHashTableOnCpuFromCache(
+bool JoinHashTable::initHashTableOnCpuFromCache(
     const ChunkKey& chunk_key,
     const size_t num_elements,
     const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols) {
@@ -1191,7 +1570,7 @@ void JoinHashTable::initHashTableOnCpuFromCache(
   CHECK_GE(chunk_key.size(), size_t(2));
   if (chunk_key[1] < 0) {
     // Do not cache hash tables over intermediate results
-    return;
+    return false;
   }
   const auto outer_col = dynamic_cast<const Analyzer::ColumnVar*>(cols.second);
   JoinHashTableCacheKey cache_key{col_range_,
@@ -1200,20 +1579,20 @@ void JoinHashTable::initHashTableOnCpuFromCache(
                                   num_elements,
                                   chunk_key,
                                   qual_bin_oper_->get_optype()};
-  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
-  for (const auto& kv : join_hash_table_cache_) {
-    if (kv.first == cache_key) {
-      std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      cpu_hash_table_buff_ = kv.second;
-      break;
-    }
+  auto cached_hash_table = join_hash_table_cache_.get(cache_key);
+  if (!cached_hash_table) {
+    return false;
   }
+  std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
+  cpu_hash_table_buff_ = cached_hash_table;
+  return true;
 }
 
 void JoinHashTable::putHashTableOnCpuToCache(
     const ChunkKey& chunk_key,
     const size_t num_elements,
-    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols) {
+    const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+    const int64_t build_time_ms) {
   CHECK_GE(chunk_key.size(), size_t(2));
   if (chunk_key[1] < 0) {
     // Do not cache hash tables over intermediate results
@@ -1226,13 +1605,12 @@ void JoinHashTable::putHashTableOnCpuToCache(
                                   num_elements,
                                   chunk_key,
                                   qual_bin_oper_->get_optype()};
-  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
-  for (const auto& kv : join_hash_table_cache_) {
-    if (kv.first == cache_key) {
-      return;
-    }
-  }
-  join_hash_table_cache_.emplace_back(cache_key, cpu_hash_table_buff_);
+  CHECK(cpu_hash_table_buff_);
+  join_hash_table_cache_.put(cache_key,
+                             cpu_hash_table_buff_,
+                             cpu_hash_table_buff_->size() * sizeof(int32_t),
+                             {chunk_key[0], chunk_key[1]},
+                             build_time_ms);
 }
 
 llvm::Value* JoinHashTable::codegenHashTableLoad(const size_t table_idx) {
@@ -1270,6 +1648,63 @@ llvm::Value* JoinHashTable::codegenHashTableLoad(const size_t table_idx,
   return hash_ptr;
 }
 
+llvm::Value* JoinHashTable::codegenPrefetchPos(const size_t hash_table_bytes,
+                                               const CompilationOptions& co,
+                                               Executor* executor) {
+  // Hash tables which fit the L2 cache don't pay for the prefetches.
+  constexpr size_t prefetch_min_bytes{size_t(1) << 20};
+  if (co.device_type != ExecutorDeviceType::CPU || !g_hash_join_prefetch_distance ||
+      hash_table_bytes < prefetch_min_bytes) {
+    return nullptr;
+  }
+  AUTOMATIC_IR_METADATA(executor->cgen_state_.get());
+  auto& ir_builder = executor->cgen_state_->ir_builder_;
+  CodeGenerator code_generator(executor);
+  const auto pos_lv = code_generator.posArg(nullptr);
+  const auto row_count_lv = ir_builder.CreateLoad(
+      get_arg_by_name(executor->cgen_state_->row_func_, "num_rows_per_scan"));
+  const auto prefetch_pos_lv = ir_builder.CreateAdd(
+      pos_lv, executor->cgen_state_->llInt(int64_t(g_hash_join_prefetch_distance)));
+  // past the end of the fragment, prefetch for the current row, which is harmless
+  return ir_builder.CreateSelect(
+      ir_builder.CreateICmpSLT(prefetch_pos_lv, row_count_lv), prefetch_pos_lv, pos_lv);
+}
+
+void JoinHashTable::codegenProbePrefetch(llvm::Value* hash_ptr,
+                                         const Analyzer::Expr* key_col,
+                                         const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
+  const auto key_col_var = dynamic_cast<const Analyzer::ColumnVar*>(key_col);
+  if (!key_col_var || shardCount() || isBitwiseEq() ||
+      key_col->get_type_info().get_type() == kDATE ||
+      memory_level_ != Data_Namespace::MemoryLevel::CPU_LEVEL) {
+    return;
+  }
+  const auto prefetch_pos_lv = codegenPrefetchPos(
+      getJoinHashBufferSize(ExecutorDeviceType::CPU, 0), co, executor_);
+  if (!prefetch_pos_lv) {
+    return;
+  }
+  CodeGenerator code_generator(executor_);
+  auto key_lv = code_generator.codegenColumnAt(key_col_var, prefetch_pos_lv, co);
+  if (!key_lv) {
+    return;
+  }
+  key_lv = executor_->cgen_state_->castToTypeIn(key_lv, 64);
+  std::vector<llvm::Value*> prefetch_args{
+      hash_ptr,
+      key_lv,
+      executor_->cgen_state_->llInt(col_range_.getIntMin()),
+      executor_->cgen_state_->llInt(col_range_.getIntMax())};
+  executor_->cgen_state_->emitCall("perfect_hash_join_prefetch", prefetch_args);
+  if (hash_type_ != JoinHashTableInterface::HashType::OneToOne) {
+    // the count of the key, its offset is in the entry just prefetched
+    prefetch_args[0] = executor_->cgen_state_->ir_builder_.CreateAdd(
+        hash_ptr, executor_->cgen_state_->llInt(int64_t(getComponentBufferSize())));
+    executor_->cgen_state_->emitCall("perfect_hash_join_prefetch", prefetch_args);
+  }
+}
+
 std::vector<llvm::Value*> JoinHashTable::getHashJoinArgs(llvm::Value* hash_ptr,
                                                          const Analyzer::Expr* key_col,
                                                          const int shard_count,
@@ -1348,6 +1783,7 @@ HashJoinMatchingSet JoinHashTable::codegenMatchingSet(const CompilationOptions&
         "FROM clause.");
   }
   auto hash_join_idx_args = getHashJoinArgs(pos_ptr, key_col, shard_count, co);
+  codegenProbePrefetch(pos_ptr, key_col, co);
   const int64_t sub_buff_size = getComponentBufferSize();
   const auto& key_col_ti = key_col->get_type_info();
 
@@ -1440,10 +1876,9 @@ int64_t JoinHashTable::getJoinHashBuffer(const ExecutorDeviceType device_type,
   if (device_type == ExecutorDeviceType::CPU) {
     return reinterpret_cast<int64_t>(&(*cpu_hash_table_buff_)[0]);
   } else {
-    return gpu_hash_table_buff_[device_id]
-               ? reinterpret_cast<CUdeviceptr>(
-                     gpu_hash_table_buff_[device_id]->getMemoryPtr())
-               : reinterpret_cast<CUdeviceptr>(nullptr);
+    const auto gpu_buffer = gpu_hash_table_buff_[shared_gpu_hash_table_ ? 0 : device_id];
+    return gpu_buffer ? reinterpret_cast<CUdeviceptr>(gpu_buffer->getMemoryPtr())
+                      : reinterpret_cast<CUdeviceptr>(nullptr);
   }
 #else
   CHECK(device_type == ExecutorDeviceType::CPU);
@@ -1462,9 +1897,8 @@ size_t JoinHashTable::getJoinHashBufferSize(const ExecutorDeviceType device_type
     return cpu_hash_table_buff_->size() *
            sizeof(decltype(cpu_hash_table_buff_)::element_type::value_type);
   } else {
-    return gpu_hash_table_buff_[device_id]
-               ? gpu_hash_table_buff_[device_id]->reservedSize()
-               : 0;
+    const auto gpu_buffer = gpu_hash_table_buff_[shared_gpu_hash_table_ ? 0 : device_id];
+    return gpu_buffer ? gpu_buffer->reservedSize() : 0;
   }
 #else
   CHECK(device_type == ExecutorDeviceType::CPU);
@@ -1569,6 +2003,7 @@ llvm::Value* JoinHashTable::codegenSlot(const CompilationOptions& co,
   CHECK(hash_ptr);
   const int shard_count = shardCount();
   const auto hash_join_idx_args = getHashJoinArgs(hash_ptr, key_col, shard_count, co);
+  codegenProbePrefetch(hash_ptr, key_col, co);
 
   const auto& key_col_ti = key_col->get_type_info();
   std::string fname((key_col_ti.get_type() == kDATE) ? "bucketized_hash_join_idx"s
@@ -1632,6 +2067,17 @@ bool JoinHashTable::isBitwiseEq() const {
   return qual_bin_oper_->get_optype() == kBW_EQ;
 }
 
+std::optional<std::pair<int64_t, int64_t>> JoinHashTable::getInnerKeyRange() const
+    noexcept {
+  // string keys are translated to the outer dictionary and bitwise equality matches
+  // nulls, the range does not bound the outer keys in either case
+  if (!col_var_->get_type_info().is_integer() || isBitwiseEq() ||
+      col_range_.getType() != ExpressionRangeType::Integer) {
+    return std::nullopt;
+  }
+  return std::make_pair(col_range_.getIntMin(), col_range_.getIntMax());
+}
+
 void JoinHashTable::freeHashBufferMemory() {
 #ifdef HAVE_CUDA
   freeHashBufferGpuMemory();
@@ -33,6 +33,7 @@
 #include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
 #include "QueryEngine/ExpressionRange.h"
 #include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
 
 #include <llvm/IR/Value.h>
@@ -86,6 +87,8 @@ class JoinHashTable : public JoinHashTableInterface {
     return col_var_.get()->get_rte_idx();
   };
 
+  std::optional<std::pair<int64_t, int64_t>> getInnerKeyRange() const noexcept override;
+
   HashType getHashType() const noexcept override { return hash_type_; }
 
   Data_Namespace::MemoryLevel getMemoryLevel() const noexcept override {
@@ -94,6 +97,8 @@ class JoinHashTable : public JoinHashTableInterface {
 
   int getDeviceCount() const noexcept override { return device_count_; };
 
+  std::string getHashJoinType() const override { return "perfect"; }
+
   size_t offsetBufferOff() const noexcept override;
 
   size_t countBufferOff() const noexcept override;
@@ -111,26 +116,23 @@ class JoinHashTable : public JoinHashTableInterface {
 
   static llvm::Value* codegenHashTableLoad(const size_t table_idx, Executor* executor);
 
+  //! Position of the outer row the CPU probes of a hash table of the given size
+  //! prefetch the entries of, or nullptr if they shouldn't prefetch.
+  static llvm::Value* codegenPrefetchPos(const size_t hash_table_bytes,
+                                         const CompilationOptions& co,
+                                         Executor* executor);
+
   static auto yieldCacheInvalidator() -> std::function<void()> {
     VLOG(1) << "Invalidate " << join_hash_table_cache_.size()
             << " cached baseline hashtable.";
-    return []() -> void {
-      std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-      join_hash_table_cache_.clear();
-    };
+    return []() -> void { join_hash_table_cache_.clear(); };
   }
 
   static const std::shared_ptr<std::vector<int32_t>>& getCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-    CHECK(!join_hash_table_cache_.empty());
-    CHECK_LT(idx, join_hash_table_cache_.size());
-    return join_hash_table_cache_.at(idx).second;
+    return join_hash_table_cache_.at(idx);
   }
 
-  static uint64_t getNumberOfCachedHashTables() {
-    std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-    return join_hash_table_cache_.size();
-  }
+  static uint64_t getNumberOfCachedHashTables() { return join_hash_table_cache_.size(); }
 
   virtual ~JoinHashTable();
 
@@ -143,7 +145,9 @@ class JoinHashTable : public JoinHashTableInterface {
                 const ExpressionRange& col_range,
                 ColumnCacheMap& column_cache,
                 Executor* executor,
-                const int device_count)
+                const int device_count,
+                std::optional<std::vector<Fragmenter_Namespace::FragmentInfo>>&&
+                    inner_fragments)
       : qual_bin_oper_(qual_bin_oper)
       , col_var_(std::dynamic_pointer_cast<Analyzer::ColumnVar>(col_var->deep_copy()))
       , query_infos_(query_infos)
@@ -151,6 +155,7 @@ class JoinHashTable : public JoinHashTableInterface {
       , hash_type_(preferred_hash_type)
       , hash_entry_count_(0)
       , col_range_(col_range)
+      , inner_fragments_(std::move(inner_fragments))
       , executor_(executor)
       , column_cache_(column_cache)
       , device_count_(device_count) {
@@ -164,6 +169,21 @@ class JoinHashTable : public JoinHashTableInterface {
       const Analyzer::ColumnVar* inner_col) const;
 
   void reify();
+
+  bool canShareGpuHashTable(const int shard_count) const;
+
+  // Bulk translation of the inner dictionary ids to the outer dictionary, if the join
+  // is on strings of two different dictionaries and it's worth it.
+  std::shared_ptr<const std::vector<int32_t>> getDictTranslationMap(
+      const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+      const size_t inner_row_count) const;
+
+  // The inner column with ids of the outer dictionary, on the host.
+  JoinColumn translateInnerJoinColumn(
+      const JoinColumn& join_column,
+      const Analyzer::ColumnVar* inner_col,
+      std::vector<std::shared_ptr<void>>& malloc_owner) const;
+
   void reifyOneToOneForDevice(
       const std::vector<Fragmenter_Namespace::FragmentInfo>& fragments,
       const int device_id,
@@ -185,21 +205,22 @@ class JoinHashTable : public JoinHashTableInterface {
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
       const Data_Namespace::MemoryLevel effective_memory_level,
       const int device_id);
-  void initHashTableOnCpuFromCache(
+  bool initHashTableOnCpuFromCache(
       const ChunkKey& chunk_key,
       const size_t num_elements,
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols);
   void putHashTableOnCpuToCache(
       const ChunkKey& chunk_key,
       const size_t num_elements,
-      const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols);
+      const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
+      const int64_t build_time_ms);
   void initOneToOneHashTableOnCpu(
-      const JoinColumn& join_column,
+      const JoinColumn& inner_join_column,
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
       const HashEntryInfo hash_entry_info,
       const int32_t hash_join_invalid_val);
   void initOneToManyHashTableOnCpu(
-      const JoinColumn& join_column,
+      const JoinColumn& inner_join_column,
       const std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*>& cols,
       const HashEntryInfo hash_entry_info,
       const int32_t hash_join_invalid_val);
@@ -215,6 +236,10 @@ class JoinHashTable : public JoinHashTableInterface {
                                             const int shard_count,
                                             const CompilationOptions& co);
 
+  void codegenProbePrefetch(llvm::Value* hash_ptr,
+                            const Analyzer::Expr* key_col,
+                            const CompilationOptions& co);
+
   bool isBitwiseEq() const;
 
   void freeHashBufferMemory();
@@ -235,7 +260,13 @@ class JoinHashTable : public JoinHashTableInterface {
   std::vector<Data_Namespace::AbstractBuffer*> gpu_hash_table_buff_;
   std::vector<Data_Namespace::AbstractBuffer*> gpu_hash_table_err_buff_;
 #endif
+  // the GPUs all read the hash table built on the first one, through peer access
+  bool shared_gpu_hash_table_{false};
   ExpressionRange col_range_;
+  // inner fragments the hash table is built on, if not all of them
+  std::optional<std::vector<Fragmenter_Namespace::FragmentInfo>> inner_fragments_;
+  // inner to outer dictionary ids, if the inner column is translated in bulk
+  std::shared_ptr<const std::vector<int32_t>> dict_translation_map_;
   Executor* executor_;
   ColumnCacheMap& column_cache_;
   const int device_count_;
@@ -255,10 +286,8 @@ class JoinHashTable : public JoinHashTableInterface {
     }
   };
 
-  static std::vector<
-      std::pair<JoinHashTableCacheKey, std::shared_ptr<std::vector<int32_t>>>>
+  static HashTableCache<JoinHashTableCacheKey, std::shared_ptr<std::vector<int32_t>>>
       join_hash_table_cache_;
-  static std::mutex join_hash_table_cache_mutex_;
 };
 
 // TODO(alex): Functions below need to be moved to a separate translation unit, they don't
@@ -27,6 +27,14 @@
 
 extern bool g_enable_overlaps_hashjoin;
 
+void JoinHashTableInterface::chargeHostMemory(const Executor* executor,
+                                              const size_t num_bytes) {
+  CHECK(executor);
+  if (const auto row_set_mem_owner = executor->getRowSetMemoryOwner()) {
+    row_set_mem_owner->addAllocatedBytes(num_bytes);
+  }
+}
+
 //! fetchJoinColumn() calls ColumnFetcher::makeJoinColumn(), then copies the
 //! JoinColumn's col_chunks_buff memory onto the GPU if required by the
 //! effective_memory_level parameter. The dev_buff_owner parameter will
@@ -251,6 +259,20 @@ std::string JoinHashTableInterface::toStringFlat32(const ExecutorDeviceType devi
   return toStringFlat<int32_t>(this, device_type, device_id);
 }
 
+std::string JoinHashTableInterface::getLayoutSummary() const {
+  std::string summary = getHashJoinType() + " " + getHashTypeString(getHashType()) +
+                        " hash table on table " + std::to_string(getInnerTableId());
+  if (getMemoryLevel() == Data_Namespace::MemoryLevel::GPU_LEVEL) {
+    summary += ", GPU (" + std::to_string(getDeviceCount()) + " devices)";
+  } else {
+    summary += ", CPU";
+  }
+  if (!layout_reason_.empty()) {
+    summary += ": " + layout_reason_;
+  }
+  return summary;
+}
+
 std::ostream& operator<<(std::ostream& os, const DecodedJoinHashBufferEntry& e) {
   os << "  {{";
   bool first = true;
@@ -508,7 +530,7 @@ std::shared_ptr<JoinHashTableInterface> JoinHashTableInterface::getInstance(
                                                    device_count,
                                                    column_cache,
                                                    executor);
-    } catch (TooManyHashEntries&) {
+    } catch (TooManyHashEntries& e) {
       const auto join_quals = coalesce_singleton_equi_join(qual_bin_oper);
       CHECK_EQ(join_quals.size(), size_t(1));
       const auto join_qual =
@@ -521,6 +543,7 @@ std::shared_ptr<JoinHashTableInterface> JoinHashTableInterface::getInstance(
                                                            device_count,
                                                            column_cache,
                                                            executor);
+      join_hash_table->layout_reason_ = e.what();
     }
   }
   CHECK(join_hash_table);
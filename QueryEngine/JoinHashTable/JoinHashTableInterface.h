@@ -18,6 +18,7 @@
 
 #include <llvm/IR/Value.h>
 #include <cstdint>
+#include <optional>
 #include <set>
 #include <string>
 
@@ -40,7 +41,8 @@ class TableMustBeReplicated : public std::runtime_error {
  public:
   TableMustBeReplicated(const std::string& table_name)
       : std::runtime_error("Hash join failed: Table '" + table_name +
-                           "' must be replicated.") {}
+                           "' must be replicated, or both tables sharded on the join "
+                           "key with the same shard count.") {}
 };
 
 class HashJoinFail : public std::runtime_error {
@@ -115,6 +117,12 @@ class JoinHashTableInterface {
 
   virtual int getInnerTableRteIdx() const noexcept = 0;
 
+  //! Bounds of the inner keys, if known. An inner join cannot match an outer row whose
+  //! key lies outside of them.
+  virtual std::optional<std::pair<int64_t, int64_t>> getInnerKeyRange() const noexcept {
+    return std::nullopt;
+  }
+
   enum class HashType : int { OneToOne, OneToMany, ManyToMany };
 
   virtual HashType getHashType() const noexcept = 0;
@@ -134,6 +142,12 @@ class JoinHashTableInterface {
 
   virtual int getDeviceCount() const noexcept = 0;
 
+  //! Perfect, keyed or geo.
+  virtual std::string getHashJoinType() const = 0;
+
+  //! Kind, layout and device of the hash table and why they were chosen, for EXPLAIN.
+  std::string getLayoutSummary() const;
+
   virtual size_t offsetBufferOff() const noexcept = 0;
 
   virtual size_t countBufferOff() const noexcept = 0;
@@ -207,6 +221,15 @@ class JoinHashTableInterface {
       const int device_count,
       ColumnCacheMap& column_cache,
       Executor* executor);
+
+ protected:
+  // Accounts the host memory of a hash table built for the query `executor` runs, throws
+  // QueryMemoryLimitExceeded past the memory limit of the query.
+  static void chargeHostMemory(const Executor* executor, const size_t num_bytes);
+
+  // Set when the layout differs from the preferred one or from the one the key types
+  // call for.
+  std::string layout_reason_;
 };  // class JoinHashTableInterface
 
 std::ostream& operator<<(std::ostream& os, const DecodedJoinHashBufferEntry& e);
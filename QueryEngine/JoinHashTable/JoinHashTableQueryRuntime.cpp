@@ -96,6 +96,35 @@ baseline_hash_join_idx_64(const int8_t* hash_buff,
   return baseline_hash_join_idx_impl<int64_t>(hash_buff, key, key_bytes, entry_count);
 }
 
+#ifndef __CUDACC__
+
+// Prefetches of the hash table entries probed for a row further ahead in the fragment,
+// so that the probes of the rows in between hide the latency of the cache misses.
+
+extern "C" ALWAYS_INLINE DEVICE void perfect_hash_join_prefetch(const int64_t hash_buff,
+                                                                const int64_t key,
+                                                                const int64_t min_key,
+                                                                const int64_t max_key) {
+  if (key >= min_key && key <= max_key) {
+    __builtin_prefetch(reinterpret_cast<const int32_t*>(hash_buff) + (key - min_key));
+  }
+}
+
+extern "C" ALWAYS_INLINE DEVICE void baseline_hash_join_prefetch(
+    const int8_t* hash_buff,
+    const int8_t* key,
+    const size_t key_bytes,
+    const size_t entry_count,
+    const size_t entry_bytes) {
+  if (!entry_count) {
+    return;
+  }
+  const uint32_t h = MurmurHash1(key, key_bytes, 0) % entry_count;
+  __builtin_prefetch(hash_buff + h * entry_bytes);
+}
+
+#endif  // __CUDACC__
+
 template <typename T>
 FORCE_INLINE DEVICE int64_t get_bucket_key_for_value_impl(const T value,
                                                           const double bucket_size) {
@@ -354,3 +383,56 @@ get_num_buckets_for_bounds(const int8_t* range_bytes,
 
   return num_buckets;
 }
+
+// A band join table holds the count of its sorted values, the span its lower bounds are
+// widened by, the sorted values and the ids of their rows, see BandJoinTable.
+
+// Index of the first sorted value not below `val`, or above it if `past_equal` is set.
+FORCE_INLINE DEVICE int64_t band_join_search(const int64_t* sorted_vals,
+                                             const int64_t count,
+                                             const int64_t val,
+                                             const bool past_equal) {
+  int64_t lo = 0;
+  int64_t hi = count;
+  while (lo < hi) {
+    const int64_t mid = lo + (hi - lo) / 2;
+    if (sorted_vals[mid] < val || (past_equal && sorted_vals[mid] == val)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+extern "C" ALWAYS_INLINE DEVICE int64_t band_join_lower_idx(const int64_t band_buff,
+                                                            const int64_t bound,
+                                                            const int64_t null_val) {
+  const auto header = reinterpret_cast<const int64_t*>(band_buff);
+  const auto count = header[0];
+  if (bound == null_val) {
+    return count;
+  }
+  const auto span = header[1];
+  const auto sorted_vals = header + 2;
+  // the lowest value plus the span doesn't overflow, the bound minus the span could
+  if (!count || bound <= sorted_vals[0] + span) {
+    return 0;
+  }
+  return band_join_search(sorted_vals, count, bound - span, false);
+}
+
+extern "C" ALWAYS_INLINE DEVICE int64_t band_join_upper_idx(const int64_t band_buff,
+                                                            const int64_t bound,
+                                                            const int64_t null_val) {
+  if (bound == null_val) {
+    return 0;
+  }
+  const auto header = reinterpret_cast<const int64_t*>(band_buff);
+  return band_join_search(header + 2, header[0], bound, true);
+}
+
+extern "C" ALWAYS_INLINE DEVICE int64_t band_join_row_ids(const int64_t band_buff) {
+  const auto header = reinterpret_cast<const int64_t*>(band_buff);
+  return reinterpret_cast<int64_t>(header + 2 + header[0]);
+}
@@ -170,31 +170,55 @@ void OverlapsJoinHashTable::reifyWithLayout(
             << overlaps_hashjoin_bucket_threshold_;
   } else {
     VLOG(1) << "Auto tuning for the overlaps hash table size:";
-    // TODO(jclay): Currently, joining on large poly sets
-    // will lead to lengthy construction times (and large hash tables)
-    // tune this to account for the characteristics of the data being joined.
+    // Candidate thresholds are tried on a sample of the inner rows. Finer buckets mean
+    // a larger table but fewer candidate rows to check per probe: keep the threshold
+    // with the cheapest build plus probe work among the ones which fit.
+    const auto inner_row_count =
+        columns_per_device.front().join_columns.front().num_elems;
+    const bool can_sample =
+        g_overlaps_auto_tuner_sample_rows && device_count_ == 1 &&
+        getEffectiveMemoryLevel(inner_outer_pairs_) == Data_Namespace::CPU_LEVEL;
+    const size_t sample_stride =
+        can_sample
+            ? std::max(inner_row_count / g_overlaps_auto_tuner_sample_rows, size_t(1))
+            : 1;
+    const auto outer_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(inner_outer_pairs_.front().second);
+    const auto outer_row_count =
+        outer_col ? get_inner_query_info(outer_col->get_table_id(), query_infos_)
+                        .info.getNumTuplesUpperBound()
+                  : query_info.getNumTuplesUpperBound();
     const double min_threshold{1e-5};
     const double max_threshold{1};
     double good_threshold{max_threshold};
+    double good_threshold_cost{std::numeric_limits<double>::max()};
     for (double threshold = max_threshold; threshold >= min_threshold;
          threshold /= 10.0) {
       overlaps_hashjoin_bucket_threshold_ = threshold;
       size_t entry_count;
       size_t emitted_keys_count;
       std::tie(entry_count, emitted_keys_count) =
-          calculateCounts(shard_count, query_info, columns_per_device);
+          calculateCounts(shard_count, query_info, columns_per_device, sample_stride);
       size_t hash_table_size = calculateHashTableSize(
           bucket_sizes_for_dimension_.size(), emitted_keys_count, entry_count);
       bucket_sizes_for_dimension_.clear();
+      // a probe checks about as many rows as the keys emitted per distinct bucket
+      const double candidates_per_probe =
+          static_cast<double>(emitted_keys_count) / std::max(entry_count / 2, size_t(1));
+      const double cost =
+          outer_row_count * candidates_per_probe + emitted_keys_count + entry_count;
       VLOG(1) << "Calculated bin threshold of " << std::fixed << threshold
               << " giving: entry count " << entry_count << " hash table size "
-              << hash_table_size;
-      if (hash_table_size <= g_overlaps_max_table_size_bytes) {
-        good_threshold = overlaps_hashjoin_bucket_threshold_;
-      } else {
+              << hash_table_size << " cost " << cost;
+      if (hash_table_size > g_overlaps_max_table_size_bytes) {
+        // finer buckets only make the table larger
         VLOG(1) << "Rejected bin threshold of " << std::fixed << threshold;
         break;
       }
+      if (cost < good_threshold_cost) {
+        good_threshold = threshold;
+        good_threshold_cost = cost;
+      }
     }
     overlaps_hashjoin_bucket_threshold_ = good_threshold;
     if (!cache_key_contains_intermediate_table(cache_key)) {
@@ -240,7 +264,8 @@ void OverlapsJoinHashTable::reifyWithLayout(
 std::pair<size_t, size_t> OverlapsJoinHashTable::calculateCounts(
     size_t shard_count,
     const Fragmenter_Namespace::TableInfo& query_info,
-    std::vector<BaselineJoinHashTable::ColumnsForDevice>& columns_per_device) {
+    std::vector<BaselineJoinHashTable::ColumnsForDevice>& columns_per_device,
+    const size_t sample_stride) {
   // re-compute bucket counts per device based on global bucket size
   CHECK_EQ(columns_per_device.size(), size_t(device_count_));
   for (int device_id = 0; device_id < device_count_; ++device_id) {
@@ -250,7 +275,10 @@ std::pair<size_t, size_t> OverlapsJoinHashTable::calculateCounts(
   }
   size_t tuple_count;
   size_t emitted_keys_count;
-  std::tie(tuple_count, emitted_keys_count) = approximateTupleCount(columns_per_device);
+  std::tie(tuple_count, emitted_keys_count) =
+      sample_stride > 1
+          ? approximateTupleCountOnCpu(columns_per_device.front(), sample_stride)
+          : approximateTupleCount(columns_per_device);
   const auto entry_count = 2 * std::max(tuple_count, size_t(1));
 
   return std::make_pair(
@@ -351,7 +379,6 @@ std::pair<size_t, size_t> OverlapsJoinHashTable::approximateTupleCount(
           ? ExecutorDeviceType::GPU
           : ExecutorDeviceType::CPU,
       1};
-  const auto padded_size_bytes = count_distinct_desc.bitmapPaddedSizeBytes();
 
   CHECK(!columns_per_device.empty() && !columns_per_device.front().join_columns.empty());
   // Number of keys must match dimension of buckets
@@ -369,30 +396,9 @@ std::pair<size_t, size_t> OverlapsJoinHashTable::approximateTupleCount(
               << ", emitted keys count: " << cached_count_info.second;
       return std::make_pair(*cached_count_info.first, cached_count_info.second);
     }
-    int thread_count = cpu_threads();
-    std::vector<uint8_t> hll_buffer_all_cpus(thread_count * padded_size_bytes);
-    auto hll_result = &hll_buffer_all_cpus[0];
-
-    std::vector<int32_t> num_keys_for_row;
     // TODO(adb): support multi-column overlaps join
     CHECK_EQ(columns_per_device.size(), 1u);
-    num_keys_for_row.resize(columns_per_device.front().join_columns[0].num_elems);
-
-    approximate_distinct_tuples_overlaps(hll_result,
-                                         num_keys_for_row,
-                                         count_distinct_desc.bitmap_sz_bits,
-                                         padded_size_bytes,
-                                         columns_per_device.front().join_columns,
-                                         columns_per_device.front().join_column_types,
-                                         columns_per_device.front().join_buckets,
-                                         thread_count);
-    for (int i = 1; i < thread_count; ++i) {
-      hll_unify(hll_result,
-                hll_result + i * padded_size_bytes,
-                1 << count_distinct_desc.bitmap_sz_bits);
-    }
-    return std::make_pair(hll_size(hll_result, count_distinct_desc.bitmap_sz_bits),
-                          num_keys_for_row.size() > 0 ? num_keys_for_row.back() : 0);
+    return approximateTupleCountOnCpu(columns_per_device.front(), 1);
   }
 #ifdef HAVE_CUDA
   auto& data_mgr = executor_->getCatalog()->getDataMgr();
@@ -493,6 +499,52 @@ std::pair<size_t, size_t> OverlapsJoinHashTable::approximateTupleCount(
 #endif  // HAVE_CUDA
 }
 
+std::pair<size_t, size_t> OverlapsJoinHashTable::approximateTupleCountOnCpu(
+    const ColumnsForDevice& columns_for_device,
+    const size_t sample_stride) const {
+  CHECK_GE(sample_stride, size_t(1));
+  CountDistinctDescriptor count_distinct_desc{
+      CountDistinctImplType::Bitmap, 0, 11, true, ExecutorDeviceType::CPU, 1};
+  const auto padded_size_bytes = count_distinct_desc.bitmapPaddedSizeBytes();
+  int thread_count = cpu_threads();
+  std::vector<uint8_t> hll_buffer_all_cpus(thread_count * padded_size_bytes);
+  auto hll_result = &hll_buffer_all_cpus[0];
+
+  const auto num_elems = columns_for_device.join_columns[0].num_elems;
+  std::vector<int32_t> num_keys_for_row;
+  num_keys_for_row.resize(num_elems);
+
+  approximate_distinct_tuples_overlaps(hll_result,
+                                       num_keys_for_row,
+                                       count_distinct_desc.bitmap_sz_bits,
+                                       padded_size_bytes,
+                                       columns_for_device.join_columns,
+                                       columns_for_device.join_column_types,
+                                       columns_for_device.join_buckets,
+                                       thread_count,
+                                       sample_stride);
+  for (int i = 1; i < thread_count; ++i) {
+    hll_unify(hll_result,
+              hll_result + i * padded_size_bytes,
+              1 << count_distinct_desc.bitmap_sz_bits);
+  }
+  const size_t tuple_count = hll_size(hll_result, count_distinct_desc.bitmap_sz_bits);
+  const size_t emitted_keys_count =
+      num_keys_for_row.size() > 0 ? num_keys_for_row.back() : 0;
+  if (sample_stride == 1 || num_elems == 0) {
+    return std::make_pair(tuple_count, emitted_keys_count);
+  }
+  // Scale the sample up to the whole column. Buckets shared with the rows left out are
+  // counted again, which overestimates the table rather than its probe cost.
+  const auto sample_rows = (num_elems + sample_stride - 1) / sample_stride;
+  const double scale = static_cast<double>(num_elems) / sample_rows;
+  const auto scaled_emitted_keys_count =
+      static_cast<size_t>(emitted_keys_count * scale);
+  return std::make_pair(
+      std::min(static_cast<size_t>(tuple_count * scale), scaled_emitted_keys_count),
+      scaled_emitted_keys_count);
+}
+
 size_t OverlapsJoinHashTable::getKeyComponentWidth() const {
   return 8;
 }
@@ -605,6 +657,7 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
     }
   }
   CHECK(layoutRequiresAdditionalBuffers(layout));
+  const auto build_begin = timer_start();
   const auto key_component_count = join_bucket_info[0].bucket_sizes_for_dimension.size();
 
   const auto key_handler =
@@ -624,9 +677,15 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
                                               getKeyComponentCount());
   CHECK(!hash_tables_for_device_.empty());
   hash_tables_for_device_[0] = builder.getHashTable();
+  if (hash_tables_for_device_[0]) {
+    chargeHostMemory(
+        executor_,
+        hash_tables_for_device_[0]->getHashTableBufferSize(ExecutorDeviceType::CPU));
+  }
 
   if (!err && getInnerTableId() > 0) {
-    putHashTableOnCpuToCache(cache_key, hash_tables_for_device_[0]);
+    putHashTableOnCpuToCache(
+        cache_key, hash_tables_for_device_[0], timer_stop(build_begin));
   }
   return err;
 }
@@ -79,7 +79,8 @@ class OverlapsJoinHashTable : public BaselineJoinHashTable {
   std::pair<size_t, size_t> calculateCounts(
       size_t shard_count,
       const Fragmenter_Namespace::TableInfo& query_info,
-      std::vector<BaselineJoinHashTable::ColumnsForDevice>& columns_per_device);
+      std::vector<BaselineJoinHashTable::ColumnsForDevice>& columns_per_device,
+      const size_t sample_stride = 1);
 
   size_t calculateHashTableSize(size_t number_of_dimensions,
                                 size_t emitted_keys_count,
@@ -98,6 +99,11 @@ class OverlapsJoinHashTable : public BaselineJoinHashTable {
   std::pair<size_t, size_t> approximateTupleCount(
       const std::vector<ColumnsForDevice>&) const override;
 
+  // Estimates the counts of the whole column from every sample_stride-th row.
+  std::pair<size_t, size_t> approximateTupleCountOnCpu(
+      const ColumnsForDevice& columns_for_device,
+      const size_t sample_stride) const;
+
   size_t getKeyComponentWidth() const override;
 
   size_t getKeyComponentCount() const override;
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/MultiGpuReduction.h"
+
+#include "CudaMgr/CudaMgr.h"
+#include "DataMgr/DataMgr.h"
+#include "QueryEngine/GpuRtConstants.h"
+#include "QueryEngine/GroupByAndAggregate.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "QueryEngine/ResultSet.h"
+#include "QueryEngine/SpeculativeTopN.h"
+#include "Shared/SqlTypesLayout.h"
+
+bool g_enable_multi_gpu_reduction{false};
+
+using multi_gpu_reduction::EntryLayout;
+using multi_gpu_reduction::SlotDesc;
+using multi_gpu_reduction::SlotOp;
+
+namespace {
+
+bool is_supported_layout(const RelAlgExecutionUnit& ra_exe_unit,
+                         const QueryMemoryDescriptor& query_mem_desc,
+                         const Catalog_Namespace::Catalog& cat) {
+  if (query_mem_desc.getQueryDescriptionType() !=
+          QueryDescriptionType::GroupByPerfectHash ||
+      query_mem_desc.didOutputColumnar() || !query_mem_desc.blocksShareMemory() ||
+      query_mem_desc.interleavedBins(ExecutorDeviceType::GPU) ||
+      query_mem_desc.useStreamingTopN() || !query_mem_desc.getEntryCount()) {
+    return false;
+  }
+  // the index buffer of the GPU sort goes before the buffer
+  if (query_mem_desc.sortOnGpu() && query_mem_desc.hasKeylessHash()) {
+    return false;
+  }
+  if (query_mem_desc.hasKeylessHash() ? query_mem_desc.getTargetIdxForKey() < 0
+                                      : query_mem_desc.getEffectiveKeyWidth() !=
+                                            sizeof(int64_t)) {
+    return false;
+  }
+  // the results of these are reduced differently
+  return !ra_exe_unit.estimator && !ra_exe_unit.union_all &&
+         !use_speculative_top_n(ra_exe_unit, query_mem_desc) &&
+         !GroupByAndAggregate::shard_count_for_top_groups(ra_exe_unit, cat);
+}
+
+// The slots of the targets, in the order ResultSetStorage::reduceOneSlot reduces them,
+// false if one of them can't be reduced on the device.
+bool get_slot_descs(const std::vector<TargetInfo>& targets,
+                    const QueryMemoryDescriptor& query_mem_desc,
+                    std::vector<SlotDesc>& slots) {
+  const auto target_init_vals = result_set::initialize_target_values_for_storage(targets);
+  const auto& col_slot_context = query_mem_desc.getColSlotContext();
+  for (size_t target_idx = 0; target_idx < targets.size(); ++target_idx) {
+    const auto& target_info = targets[target_idx];
+    const auto& slots_for_target = col_slot_context.getSlotsForCol(target_idx);
+    if (slots_for_target.empty() ||
+        (query_mem_desc.targetGroupbyIndicesSize() > 0 &&
+         query_mem_desc.getTargetGroupbyIndex(target_idx) >= 0)) {
+      continue;
+    }
+    const auto slot_idx = static_cast<size_t>(slots_for_target.front());
+    CHECK_LT(slot_idx, target_init_vals.size());
+    const auto chosen_bytes = result_set::get_width_for_slot(
+        slot_idx, takes_float_argument(target_info), query_mem_desc);
+    if (chosen_bytes != sizeof(int32_t) && chosen_bytes != sizeof(int64_t)) {
+      return false;
+    }
+    SlotDesc slot{static_cast<uint32_t>(query_mem_desc.getColOffInBytes(slot_idx)),
+                  chosen_bytes,
+                  get_compact_type(target_info).is_fp(),
+                  false,
+                  SlotOp::Project,
+                  target_init_vals[slot_idx]};
+    if (!target_info.is_agg) {
+      if (target_info.sql_type.is_varlen() || target_info.sql_type.is_geometry()) {
+        return false;
+      }
+      slots.push_back(slot);
+      continue;
+    }
+    if (is_distinct_target(target_info)) {
+      return false;
+    }
+    switch (target_info.agg_kind) {
+      case kCOUNT:
+        slot.op = SlotOp::Sum;
+        slot.is_fp = false;
+        break;
+      case kAVG:
+      case kSUM:
+        slot.op = SlotOp::Sum;
+        slot.skip_null = target_info.skip_null_val;
+        break;
+      case kMIN:
+        slot.op = SlotOp::Min;
+        slot.skip_null = target_info.skip_null_val;
+        break;
+      case kMAX:
+        slot.op = SlotOp::Max;
+        slot.skip_null = target_info.skip_null_val;
+        break;
+      default:
+        return false;
+    }
+    slots.push_back(slot);
+    if (target_info.agg_kind == kAVG) {
+      CHECK_EQ(size_t(2), slots_for_target.size());
+      // the count is as wide as the slot of the sum, as on the host
+      const auto count_bytes = query_mem_desc.getPaddedSlotWidthBytes(slot_idx);
+      if (count_bytes != sizeof(int32_t) && count_bytes != sizeof(int64_t)) {
+        return false;
+      }
+      slots.push_back(
+          {static_cast<uint32_t>(query_mem_desc.getColOffInBytes(slot_idx + 1)),
+           count_bytes,
+           false,
+           false,
+           SlotOp::Sum,
+           0});
+    }
+  }
+  return true;
+}
+
+#ifdef HAVE_CUDA
+// The copies between devices are queued on the default streams, the query kernels on
+// their own streams aren't waited for.
+void synchronize_default_stream(CudaMgr_Namespace::CudaMgr* cuda_mgr,
+                                const int device_id) {
+  cuda_mgr->setContext(device_id);
+  CHECK_EQ(cuStreamSynchronize(0), CUDA_SUCCESS);
+}
+#endif  // HAVE_CUDA
+
+}  // namespace
+
+MultiGpuReduction::MultiGpuReduction(const EntryLayout& layout,
+                                     const std::vector<SlotDesc>& slots,
+                                     const size_t buffer_size,
+                                     Data_Namespace::DataMgr* data_mgr)
+    : layout_(layout), slots_(slots), buffer_size_(buffer_size), data_mgr_(data_mgr) {}
+
+MultiGpuReduction::~MultiGpuReduction() {
+  for (auto buffer : {reduced_buffer_, slots_buffer_, staging_buffer_}) {
+    if (buffer) {
+      data_mgr_->free(buffer);
+    }
+  }
+}
+
+std::unique_ptr<MultiGpuReduction> MultiGpuReduction::create(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const Catalog_Namespace::Catalog& cat,
+    const size_t kernel_count) {
+#ifdef HAVE_CUDA
+  if (!g_enable_multi_gpu_reduction || kernel_count < 2 ||
+      !is_supported_layout(ra_exe_unit, query_mem_desc, cat)) {
+    return nullptr;
+  }
+  std::vector<SlotDesc> slots;
+  if (!get_slot_descs(target_exprs_to_infos(ra_exe_unit.target_exprs, query_mem_desc),
+                      query_mem_desc,
+                      slots) ||
+      slots.empty()) {
+    return nullptr;
+  }
+  EntryLayout layout{query_mem_desc.getEntryCount(), query_mem_desc.getRowSize(), 0};
+  if (query_mem_desc.hasKeylessHash()) {
+    // empty when the slot of the key still has its initial value, as on the host
+    const auto key_slot_idx = static_cast<size_t>(query_mem_desc.getTargetIdxForKey());
+    const auto target_init_vals = result_set::initialize_target_values_for_storage(
+        target_exprs_to_infos(ra_exe_unit.target_exprs, query_mem_desc));
+    CHECK_LT(key_slot_idx, target_init_vals.size());
+    layout.empty_offset =
+        static_cast<uint32_t>(query_mem_desc.getColOffInBytes(key_slot_idx));
+    layout.empty_width = query_mem_desc.getPaddedSlotWidthBytes(key_slot_idx);
+    layout.empty_val = target_init_vals[key_slot_idx];
+    if (layout.empty_width != sizeof(int32_t) && layout.empty_width != sizeof(int64_t)) {
+      return nullptr;
+    }
+  } else {
+    layout.key_bytes =
+        query_mem_desc.getGroupbyColCount() * query_mem_desc.getEffectiveKeyWidth();
+    layout.empty_offset = 0;
+    layout.empty_width = sizeof(int64_t);
+    layout.empty_val = EMPTY_KEY_64;
+  }
+  return std::make_unique<MultiGpuReduction>(
+      layout,
+      slots,
+      query_mem_desc.getBufferSizeBytes(ExecutorDeviceType::GPU),
+      &cat.getDataMgr());
+#else
+  return nullptr;
+#endif  // HAVE_CUDA
+}
+
+void MultiGpuReduction::reduce(const int8_t* group_by_buffer, const int device_id) {
+#ifdef HAVE_CUDA
+  auto cuda_mgr = data_mgr_->getCudaMgr();
+  CHECK(cuda_mgr);
+  std::lock_guard<std::mutex> reduce_lock(reduce_mutex_);
+  if (!reduced_buffer_) {
+    // the first buffer is the start of the reduction, on its device
+    reduced_buffer_ =
+        data_mgr_->alloc(Data_Namespace::GPU_LEVEL, device_id, buffer_size_);
+    slots_buffer_ = data_mgr_->alloc(
+        Data_Namespace::GPU_LEVEL, device_id, slots_.size() * sizeof(SlotDesc));
+    device_id_ = device_id;
+    cuda_mgr->copyHostToDevice(slots_buffer_->getMemoryPtr(),
+                               reinterpret_cast<const int8_t*>(slots_.data()),
+                               slots_.size() * sizeof(SlotDesc),
+                               device_id_);
+    cuda_mgr->copyDeviceToDevice(reduced_buffer_->getMemoryPtr(),
+                                 const_cast<int8_t*>(group_by_buffer),
+                                 buffer_size_,
+                                 device_id_,
+                                 device_id);
+    synchronize_default_stream(cuda_mgr, device_id_);
+    return;
+  }
+  auto src = group_by_buffer;
+  if (device_id != device_id_ && !cuda_mgr->canAccessPeer(device_id_, device_id)) {
+    if (!staging_buffer_) {
+      staging_buffer_ =
+          data_mgr_->alloc(Data_Namespace::GPU_LEVEL, device_id_, buffer_size_);
+    }
+    cuda_mgr->copyDeviceToDevice(staging_buffer_->getMemoryPtr(),
+                                 const_cast<int8_t*>(group_by_buffer),
+                                 buffer_size_,
+                                 device_id_,
+                                 device_id);
+    synchronize_default_stream(cuda_mgr, device_id);
+    synchronize_default_stream(cuda_mgr, device_id_);
+    src = staging_buffer_->getMemoryPtr();
+  }
+  cuda_mgr->setContext(device_id_);
+  CudaMgr_Namespace::GpuWorkTimer reduction_timer(
+      CudaMgr_Namespace::GpuWorkType::Reduction, nullptr);
+  reduce_group_by_buffer_on_device(
+      reduced_buffer_->getMemoryPtr(),
+      src,
+      layout_,
+      reinterpret_cast<const SlotDesc*>(slots_buffer_->getMemoryPtr()),
+      slots_.size());
+#else
+  CHECK(false);
+#endif  // HAVE_CUDA
+}
+
+void MultiGpuReduction::copyResultTo(ResultSet& results) const {
+  CHECK(reduced_buffer_);
+  const auto storage = results.getStorage();
+  CHECK(storage);
+  data_mgr_->getCudaMgr()->copyDeviceToHost(storage->getUnderlyingBuffer(),
+                                            reduced_buffer_->getMemoryPtr(),
+                                            buffer_size_,
+                                            device_id_);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    MultiGpuReduction.h
+ * @brief   Reduction of the group by buffers of the GPU kernels of a query on the GPU
+ *          which finished first, instead of on the host.
+ *
+ * The first kernel to finish copies its group by buffer to a buffer of its device, the
+ * buffers of the following kernels are reduced into it by a CUDA kernel as soon as they
+ * finish. A buffer on another GPU is read by the reduction through peer access when the
+ * two GPUs have it, over NVLink or PCIe, it is copied to the device of the reduced
+ * buffer first otherwise. Only the reduced buffer is copied to the host, into the
+ * storage of one of the results of the kernels, the others are left empty.
+ *
+ * Limited to the row-wise perfect hash group by buffers of SUM, COUNT, MIN, MAX and AVG
+ * aggregates, the layouts the GPU reduction of the shared memory buffers supports too.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "QueryEngine/MultiGpuReductionImpl.h"
+
+extern bool g_enable_multi_gpu_reduction;
+
+namespace Catalog_Namespace {
+class Catalog;
+}  // namespace Catalog_Namespace
+
+namespace Data_Namespace {
+class AbstractBuffer;
+class DataMgr;
+}  // namespace Data_Namespace
+
+struct RelAlgExecutionUnit;
+class QueryMemoryDescriptor;
+class ResultSet;
+
+class MultiGpuReduction {
+ public:
+  MultiGpuReduction(const multi_gpu_reduction::EntryLayout& layout,
+                    const std::vector<multi_gpu_reduction::SlotDesc>& slots,
+                    const size_t buffer_size,
+                    Data_Namespace::DataMgr* data_mgr);
+
+  ~MultiGpuReduction();
+
+  // A reduction for the group by kernels of a GPU work unit, nullptr if there's a single
+  // kernel or the layout of the buffers or one of the targets isn't supported.
+  static std::unique_ptr<MultiGpuReduction> create(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const QueryMemoryDescriptor& query_mem_desc,
+      const Catalog_Namespace::Catalog& cat,
+      const size_t kernel_count);
+
+  // Reduces the group by buffer a kernel left on `device_id`. Thread safe, throws
+  // OutOfMemory if the reduced buffer can't be allocated.
+  void reduce(const int8_t* group_by_buffer, const int device_id);
+
+  // Whether the results of the kernels are left empty, reduced on the GPU.
+  bool hasResult() const { return reduced_buffer_ != nullptr; }
+
+  // Copies the reduced buffer to the storage of a result of the kernels.
+  void copyResultTo(ResultSet& results) const;
+
+ private:
+  const multi_gpu_reduction::EntryLayout layout_;
+  const std::vector<multi_gpu_reduction::SlotDesc> slots_;
+  const size_t buffer_size_;
+  Data_Namespace::DataMgr* data_mgr_;
+
+  std::mutex reduce_mutex_;
+  int device_id_{-1};
+  Data_Namespace::AbstractBuffer* reduced_buffer_{nullptr};
+  // the slot descriptors, on the device of the reduced buffer
+  Data_Namespace::AbstractBuffer* slots_buffer_{nullptr};
+  // the copy of a buffer from a device without peer access
+  Data_Namespace::AbstractBuffer* staging_buffer_{nullptr};
+};
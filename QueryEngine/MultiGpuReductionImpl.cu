@@ -0,0 +1,169 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MultiGpuReductionImpl.h"
+
+#include <stdexcept>
+#include <string>
+
+using multi_gpu_reduction::EntryLayout;
+using multi_gpu_reduction::SlotDesc;
+using multi_gpu_reduction::SlotOp;
+
+namespace {
+
+template <typename T>
+__device__ T null_of(const int64_t null_val);
+
+template <>
+__device__ int32_t null_of<int32_t>(const int64_t null_val) {
+  return static_cast<int32_t>(null_val);
+}
+
+template <>
+__device__ int64_t null_of<int64_t>(const int64_t null_val) {
+  return null_val;
+}
+
+// the host reads the sentinel of a float from the low bytes of the initial value
+template <>
+__device__ float null_of<float>(const int64_t null_val) {
+  return __int_as_float(static_cast<int32_t>(null_val));
+}
+
+template <>
+__device__ double null_of<double>(const int64_t null_val) {
+  return __longlong_as_double(null_val);
+}
+
+template <typename T>
+__device__ void reduce_slot(int8_t* dest_ptr, const int8_t* src_ptr, const SlotDesc& slot) {
+  auto dest = reinterpret_cast<T*>(dest_ptr);
+  const auto src = *reinterpret_cast<const T*>(src_ptr);
+  if (slot.skip_null) {
+    const auto null_val = null_of<T>(slot.null_val);
+    if (src == null_val) {
+      return;
+    }
+    if (*dest == null_val) {
+      *dest = src;
+      return;
+    }
+  }
+  switch (slot.op) {
+    case SlotOp::Sum:
+      *dest += src;
+      break;
+    case SlotOp::Min:
+      *dest = src < *dest ? src : *dest;
+      break;
+    case SlotOp::Max:
+      *dest = src > *dest ? src : *dest;
+      break;
+    default:
+      break;
+  }
+}
+
+// The projected values of an entry are the same on every device, the first one set wins.
+template <typename T>
+__device__ void project_slot(int8_t* dest_ptr,
+                             const int8_t* src_ptr,
+                             const SlotDesc& slot) {
+  const auto src = *reinterpret_cast<const T*>(src_ptr);
+  if (src != static_cast<T>(slot.null_val)) {
+    *reinterpret_cast<T*>(dest_ptr) = src;
+  }
+}
+
+__device__ bool is_empty_entry(const int8_t* row_ptr, const EntryLayout& layout) {
+  const auto empty_ptr = row_ptr + layout.empty_offset;
+  if (layout.empty_width == 4) {
+    return *reinterpret_cast<const int32_t*>(empty_ptr) ==
+           static_cast<int32_t>(layout.empty_val);
+  }
+  return *reinterpret_cast<const int64_t*>(empty_ptr) == layout.empty_val;
+}
+
+__global__ void reduce_group_by_buffer(int8_t* dest,
+                                       const int8_t* src,
+                                       const EntryLayout layout,
+                                       const SlotDesc* slots,
+                                       const size_t slot_count) {
+  const size_t start = blockIdx.x * blockDim.x + threadIdx.x;
+  const size_t step = blockDim.x * gridDim.x;
+  for (size_t entry_idx = start; entry_idx < layout.entry_count; entry_idx += step) {
+    const auto src_row = src + entry_idx * layout.row_size;
+    if (is_empty_entry(src_row, layout)) {
+      continue;
+    }
+    auto dest_row = dest + entry_idx * layout.row_size;
+    if (layout.key_bytes && is_empty_entry(dest_row, layout)) {
+      for (size_t i = 0; i < layout.key_bytes / sizeof(int64_t); ++i) {
+        reinterpret_cast<int64_t*>(dest_row)[i] =
+            reinterpret_cast<const int64_t*>(src_row)[i];
+      }
+    }
+    for (size_t slot_idx = 0; slot_idx < slot_count; ++slot_idx) {
+      const auto& slot = slots[slot_idx];
+      const auto dest_ptr = dest_row + slot.offset;
+      const auto src_ptr = src_row + slot.offset;
+      if (slot.op == SlotOp::Project) {
+        if (slot.width == 4) {
+          project_slot<int32_t>(dest_ptr, src_ptr, slot);
+        } else {
+          project_slot<int64_t>(dest_ptr, src_ptr, slot);
+        }
+      } else if (slot.is_fp) {
+        if (slot.width == 4) {
+          reduce_slot<float>(dest_ptr, src_ptr, slot);
+        } else {
+          reduce_slot<double>(dest_ptr, src_ptr, slot);
+        }
+      } else {
+        if (slot.width == 4) {
+          reduce_slot<int32_t>(dest_ptr, src_ptr, slot);
+        } else {
+          reduce_slot<int64_t>(dest_ptr, src_ptr, slot);
+        }
+      }
+    }
+  }
+}
+
+void check_cuda_error(const cudaError_t err) {
+  if (err != cudaSuccess) {
+    throw std::runtime_error(std::string("Multi-GPU reduction failed: ") +
+                             cudaGetErrorString(err));
+  }
+}
+
+}  // namespace
+
+void reduce_group_by_buffer_on_device(int8_t* dest,
+                                      const int8_t* src,
+                                      const EntryLayout& layout,
+                                      const SlotDesc* slots,
+                                      const size_t slot_count) {
+  int grid_size = -1;
+  int block_size = -1;
+  check_cuda_error(cudaOccupancyMaxPotentialBlockSize(
+      &grid_size, &block_size, reduce_group_by_buffer));
+  reduce_group_by_buffer<<<grid_size, block_size>>>(
+      dest, src, layout, slots, slot_count);
+  check_cuda_error(cudaGetLastError());
+  check_cuda_error(cudaStreamSynchronize(0));
+}
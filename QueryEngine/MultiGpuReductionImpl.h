@@ -0,0 +1,65 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    MultiGpuReductionImpl.h
+ * @brief   Device side reduction of the row-wise perfect hash group by buffers of two
+ *          kernels.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace multi_gpu_reduction {
+
+enum class SlotOp : int8_t { Sum, Min, Max, Project };
+
+// How a slot of `src` is reduced into the same slot of `dest`, the way
+// ResultSetStorage::reduceOneSlot does on the host.
+struct SlotDesc {
+  uint32_t offset;  // in the row
+  int8_t width;     // 4 or 8 bytes
+  bool is_fp;
+  bool skip_null;
+  SlotOp op;
+  // the null sentinel skipped by the aggregates, the initial value of the projections
+  int64_t null_val;
+};
+
+struct EntryLayout {
+  size_t entry_count;
+  size_t row_size;
+  // the key columns at the start of the row, copied to `dest` when it doesn't have the
+  // entry yet, 0 for a keyless hash
+  size_t key_bytes;
+  // the entry is empty when the value at `empty_offset` in the row is `empty_val`
+  uint32_t empty_offset;
+  int8_t empty_width;
+  int64_t empty_val;
+};
+
+}  // namespace multi_gpu_reduction
+
+// Reduces the group by buffer `src` into `dest`, entry by entry. The slot descriptors
+// are in device memory, `src` can be the memory of a peer of the current device.
+// Waits for the reduction.
+void reduce_group_by_buffer_on_device(int8_t* dest,
+                                      const int8_t* src,
+                                      const multi_gpu_reduction::EntryLayout& layout,
+                                      const multi_gpu_reduction::SlotDesc* slots,
+                                      const size_t slot_count);
@@ -20,16 +20,19 @@
 #include "GpuSharedMemoryUtils.h"
 #include "LLVMFunctionAttributesUtil.h"
 #include "OutputBufferInitialization.h"
+#include "PersistentCodeCache.h"
 #include "QueryTemplateGenerator.h"
 
 #include "OSDependent/omnisci_path.h"
 #include "Shared/MathUtils.h"
+#include "Shared/measure.h"
 #include "StreamingTopN.h"
 
 #if LLVM_VERSION_MAJOR < 9
 static_assert(false, "LLVM Version >= 9 is required.");
 #endif
 
+#include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
@@ -45,12 +48,14 @@ static_assert(false, "LLVM Version >= 9 is required.");
 #include <llvm/Support/Casting.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/FormattedStream.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetRegistry.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/raw_os_ostream.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
@@ -61,12 +66,21 @@ static_assert(false, "LLVM Version >= 9 is required.");
 #include <llvm/Transforms/Utils.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Vectorize.h>
 
-#if LLVM_VERSION_MAJOR >= 11
-#include <llvm/Support/Host.h>
-#endif
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <set>
+#include <thread>
 
 float g_fraction_code_cache_to_evict = 0.2;
+size_t g_code_cache_max_bytes{size_t(1) << 30};
+bool g_enable_tiered_compilation{false};
+bool g_enable_cpu_vectorization{false};
+bool g_enable_udf_inlining{false};
+size_t g_tiered_compilation_max_input_rows{10000000};
+extern size_t g_cpu_interrupt_check_block_rows;
 
 std::unique_ptr<llvm::Module> udf_gpu_module;
 std::unique_ptr<llvm::Module> udf_cpu_module;
@@ -153,6 +167,17 @@ void show_defined(std::unique_ptr<llvm::Module>& module) {
   show_defined(module.get());
 }
 
+std::vector<std::string> get_host_cpu_attrs() {
+  std::vector<std::string> attrs;
+  llvm::StringMap<bool> cpu_features;
+  if (llvm::sys::getHostCPUFeatures(cpu_features)) {
+    for (const auto& feature : cpu_features) {
+      attrs.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+    }
+  }
+  return attrs;
+}
+
 #if defined(HAVE_CUDA) || !defined(WITH_JIT_DEBUG)
 void eliminate_dead_self_recursive_funcs(
     llvm::Module& M,
@@ -227,6 +252,23 @@ void optimize_ir(llvm::Function* query_func,
   pass_manager.add(llvm::createGlobalOptimizerPass());
 
   pass_manager.add(llvm::createLICMPass());
+  std::unique_ptr<llvm::TargetMachine> host_target_machine;
+  if (co.device_type == ExecutorDeviceType::CPU && g_enable_cpu_vectorization) {
+    // The vectorizers need the cost model of the host, without it they assume a target
+    // without vector registers and leave the scan loop alone.
+    auto init_err = llvm::InitializeNativeTarget();
+    CHECK(!init_err);
+    host_target_machine.reset(llvm::EngineBuilder()
+                                  .setMCPU(llvm::sys::getHostCPUName())
+                                  .setMAttrs(get_host_cpu_attrs())
+                                  .selectTarget());
+    CHECK(host_target_machine);
+    pass_manager.add(llvm::createTargetTransformInfoWrapperPass(
+        host_target_machine->getTargetIRAnalysis()));
+    pass_manager.add(llvm::createLoopVectorizePass());
+    pass_manager.add(llvm::createSLPVectorizerPass());
+    pass_manager.add(llvm::createInstructionCombiningPass());
+  }
   if (co.opt_level == ExecutorOptLevel::LoopStrengthReduction) {
     pass_manager.add(llvm::createLoopStrengthReducePass());
   }
@@ -234,6 +276,18 @@ void optimize_ir(llvm::Function* query_func,
 
   eliminate_dead_self_recursive_funcs(*module, live_funcs);
 }
+
+// Minimal pipeline for the baseline tier: only drop the unused runtime functions, which
+// would otherwise dominate the (unoptimized) code generation time.
+void optimize_ir_baseline(llvm::Module* module,
+                          llvm::legacy::PassManager& pass_manager,
+                          const std::unordered_set<llvm::Function*>& live_funcs) {
+  pass_manager.add(llvm::createAlwaysInlinerLegacyPass());
+  pass_manager.add(llvm::createGlobalDCEPass());
+  pass_manager.run(*module);
+
+  eliminate_dead_self_recursive_funcs(*module, live_funcs);
+}
 #endif
 
 }  // namespace
@@ -265,9 +319,135 @@ ExecutionEngineWrapper& ExecutionEngineWrapper::operator=(
     llvm::ExecutionEngine* execution_engine) {
   execution_engine_.reset(execution_engine);
   intel_jit_listener_ = nullptr;
+  code_size_ = 0;
   return *this;
 }
 
+namespace {
+
+// Everything besides the IR the native code depends on, for the persistent tier.
+std::string get_cpu_code_cache_target(const CompilationOptions& co) {
+  return llvm::sys::getProcessTriple() + "-" + llvm::sys::getHostCPUName().str() +
+         "-O" + std::to_string(static_cast<int>(co.opt_level)) +
+         (g_enable_cpu_vectorization ? "-V" : "");
+}
+
+#ifdef HAVE_CUDA
+// The image is a linked cubin, so loading it does not involve the JIT and the devices
+// can be set up concurrently.
+std::shared_ptr<GpuCompilationContext> load_cubin_on_all_devices(
+    const void* cubin,
+    const size_t cubin_size,
+    const std::string& func_name,
+    const CudaMgr_Namespace::CudaMgr* cuda_mgr) {
+  CHECK(cuda_mgr);
+  const auto device_count = cuda_mgr->getDeviceCount();
+  std::vector<std::future<std::unique_ptr<GpuDeviceCompilationContext>>> device_codes;
+  for (int device_id = 0; device_id < device_count; ++device_id) {
+    device_codes.push_back(std::async(
+        device_count > 1 ? std::launch::async : std::launch::deferred,
+        [cubin, &func_name, cuda_mgr, device_id] {
+          return std::make_unique<GpuDeviceCompilationContext>(
+              cubin, func_name, device_id, cuda_mgr, 0, nullptr, nullptr);
+        }));
+  }
+  auto gpu_compilation_context = std::make_shared<GpuCompilationContext>();
+  for (auto& device_code : device_codes) {
+    gpu_compilation_context->addDeviceCode(device_code.get());
+  }
+  gpu_compilation_context->setCodeSize(cubin_size * device_count);
+  return gpu_compilation_context;
+}
+
+std::string get_gpu_code_cache_target(const CudaMgr_Namespace::CudaMgr* cuda_mgr,
+                                      const unsigned block_size,
+                                      const CompilationOptions& co) {
+  CHECK(cuda_mgr);
+  return "nvptx64-nvidia-cuda-" +
+         CudaMgr_Namespace::CudaMgr::deviceArchToSM(cuda_mgr->getDeviceArch()) + "-B" +
+         std::to_string(block_size) + "-O" +
+         std::to_string(static_cast<int>(co.opt_level));
+}
+#endif
+
+/**
+ * Runs the optimizing compilations for work units whose first execution used baseline
+ * code, one at a time and off the query threads. A work unit is queued at most once per
+ * executor while its job is pending.
+ */
+class BackgroundCodegenQueue {
+ public:
+  using JobKey = std::pair<int, CodeCacheKey>;
+
+  static BackgroundCodegenQueue& instance() {
+    static BackgroundCodegenQueue queue;
+    return queue;
+  }
+
+  bool submit(const JobKey& key, std::function<void()> job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!pending_.insert(key).second) {
+        return false;
+      }
+      jobs_.emplace_back(key, std::move(job));
+    }
+    cv_.notify_one();
+    return true;
+  }
+
+  ~BackgroundCodegenQueue() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    cv_.notify_one();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+  }
+
+ private:
+  BackgroundCodegenQueue() : worker_([this] { run(); }) {}
+
+  void run() {
+    while (true) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return shutdown_ || !jobs_.empty(); });
+      if (shutdown_) {
+        // pending jobs are dropped, their modules are reclaimed with the process
+        return;
+      }
+      auto job = std::move(jobs_.front());
+      jobs_.pop_front();
+      lock.unlock();
+      try {
+        job.second();
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Background code generation failed: " << e.what();
+      }
+      lock.lock();
+      pending_.erase(job.first);
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::pair<JobKey, std::function<void()>>> jobs_;
+  std::set<JobKey> pending_;
+  bool shutdown_{false};
+  std::thread worker_;
+};
+
+// UDF modules are not covered by the server release, keep them out of the persistent
+// tier.
+bool use_persistent_code_cache() {
+  return g_enable_persistent_code_cache && !udf_cpu_module && !udf_gpu_module &&
+         !rt_udf_cpu_module && !rt_udf_gpu_module;
+}
+
+}  // namespace
+
 void verify_function_ir(const llvm::Function* func) {
   std::stringstream err_ss;
   llvm::raw_os_ostream err_os(err_ss);
@@ -281,12 +461,12 @@ void verify_function_ir(const llvm::Function* func) {
 }
 
 std::shared_ptr<CompilationContext> Executor::getCodeFromCache(const CodeCacheKey& key,
-                                                               const CodeCache& cache) {
-  auto it = cache.find(key);
-  if (it != cache.cend()) {
+                                                               CodeCache& cache) {
+  auto cached_code = cache.get(key);
+  if (cached_code) {
     delete cgen_state_->module_;
-    cgen_state_->module_ = it->second.second;
-    return it->second.first;
+    cgen_state_->module_ = cached_code->second;
+    return cached_code->first;
   }
   return {};
 }
@@ -294,10 +474,12 @@ std::shared_ptr<CompilationContext> Executor::getCodeFromCache(const CodeCacheKe
 void Executor::addCodeToCache(const CodeCacheKey& key,
                               std::shared_ptr<CompilationContext> compilation_context,
                               llvm::Module* module,
-                              CodeCache& cache) {
+                              CodeCache& cache,
+                              const int64_t compilation_time_ms) {
   cache.put(key,
             std::make_pair<std::shared_ptr<CompilationContext>, decltype(module)>(
-                std::move(compilation_context), std::move(module)));
+                std::move(compilation_context), std::move(module)),
+            compilation_time_ms);
 }
 
 namespace {
@@ -320,17 +502,62 @@ std::string assemblyForCPU(ExecutionEngineWrapper& execution_engine,
   return "Assembly for the CPU:\n" + std::string(code_str.str()) + "\nEnd of assembly";
 }
 
+// Measures the object file MCJIT loads, which is what the code cache accounts for.
+class ObjectSizeRecorder : public llvm::ObjectCache {
+ public:
+  explicit ObjectSizeRecorder(llvm::ObjectCache* next) : next_(next) {}
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef obj) override {
+    size_ = obj.getBufferSize();
+    if (next_) {
+      next_->notifyObjectCompiled(module, obj);
+    }
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override {
+    auto obj = next_ ? next_->getObject(module) : nullptr;
+    if (obj) {
+      size_ = obj->getBufferSize();
+    }
+    return obj;
+  }
+
+  size_t size() const { return size_; }
+
+ private:
+  llvm::ObjectCache* next_;
+  size_t size_{0};
+};
+
 }  // namespace
 
 ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
     llvm::Function* func,
     const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
+    const CompilationOptions& co,
+    const std::string& persistent_cache_key) {
   auto module = func->getParent();
+  std::unique_ptr<PersistentObjectCache> object_cache;
+  if (!persistent_cache_key.empty()) {
+    if (auto persistent_cache = PersistentCodeCache::get()) {
+      object_cache =
+          std::make_unique<PersistentObjectCache>(*persistent_cache, persistent_cache_key);
+    }
+  }
+  // the object file on disk was built from the optimized module, skip straight to
+  // loading it
+  const bool has_cached_object = object_cache && object_cache->hasObject();
   // run optimizations
 #ifndef WITH_JIT_DEBUG
-  llvm::legacy::PassManager pass_manager;
-  optimize_ir(func, module, pass_manager, live_funcs, co);
+  if (!has_cached_object) {
+    llvm::legacy::PassManager pass_manager;
+    if (co.opt_level == ExecutorOptLevel::Baseline) {
+      optimize_ir_baseline(module, pass_manager, live_funcs);
+    } else {
+      optimize_ir(func, module, pass_manager, live_funcs, co);
+    }
+  }
 #endif  // WITH_JIT_DEBUG
 
   auto init_err = llvm::InitializeNativeTarget();
@@ -348,24 +575,106 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
   llvm::TargetOptions to;
   to.EnableFastISel = true;
   eb.setTargetOptions(to);
-  if (co.opt_level == ExecutorOptLevel::ReductionJIT) {
+  if (g_enable_cpu_vectorization) {
+    // emit the vector instructions picked by the optimizer for the host
+    eb.setMCPU(llvm::sys::getHostCPUName());
+    eb.setMAttrs(get_host_cpu_attrs());
+  }
+  if (co.opt_level == ExecutorOptLevel::ReductionJIT ||
+      co.opt_level == ExecutorOptLevel::Baseline) {
     eb.setOptLevel(llvm::CodeGenOpt::None);
   }
 
   ExecutionEngineWrapper execution_engine(eb.create(), co);
   CHECK(execution_engine.get());
-  LOG(ASM) << assemblyForCPU(execution_engine, module);
+  if (!has_cached_object) {
+    LOG(ASM) << assemblyForCPU(execution_engine, module);
+  }
 
+  ObjectSizeRecorder object_size_recorder(object_cache.get());
+  execution_engine->setObjectCache(&object_size_recorder);
   execution_engine->finalizeObject();
+  execution_engine->setObjectCache(nullptr);
+  execution_engine.setCodeSize(object_size_recorder.size());
 
   return execution_engine;
 }
 
+namespace {
+
+// Bigger UDFs are still called, inlining them would mostly grow the scan loop.
+constexpr size_t kMaxInlinedUdfInstructions{256};
+
+// Lets the UDFs linked into a CPU module be inlined into the row function, so that their
+// per call setup on constant arguments can be hoisted out of the scan loop and the loop
+// vectorized over blocks of rows along with them. EXTENSION_NOINLINE only keeps the UDFs
+// callable by name, which inlining their calls doesn't change.
+void mark_udfs_always_inline(const llvm::Module& udf_module, llvm::Module& module) {
+  for (const auto& udf_func : udf_module) {
+    if (udf_func.isDeclaration()) {
+      continue;
+    }
+    auto func = module.getFunction(udf_func.getName());
+    if (!func || func->isDeclaration() ||
+        func->getInstructionCount() > kMaxInlinedUdfInstructions) {
+      continue;
+    }
+    func->removeFnAttr(llvm::Attribute::OptimizeNone);
+    func->removeFnAttr(llvm::Attribute::NoInline);
+    mark_function_always_inline(func);
+  }
+}
+
+// Declares the functions of a UDF module in a CPU query module, for the code generation
+// of their calls. The definitions are linked once the code isn't found in the cache.
+void declare_udf_functions(const llvm::Module& udf_module, llvm::Module& module) {
+  for (const auto& udf_func : udf_module) {
+    if (udf_func.isDeclaration() || udf_func.hasLocalLinkage()) {
+      continue;
+    }
+    if (module.getFunction(udf_func.getName())) {
+      LOG(ERROR) << "  Attempt to overwrite " << udf_func.getName().str() << " in "
+                 << module.getModuleIdentifier() << " from `"
+                 << udf_module.getModuleIdentifier() << "`";
+      throw std::runtime_error(
+          "link_udf_module: *** attempt to overwrite a runtime function with a UDF "
+          "function ***");
+    }
+    auto func = llvm::Function::Create(udf_func.getFunctionType(),
+                                       llvm::GlobalValue::ExternalLinkage,
+                                       udf_func.getName(),
+                                       module);
+    func->setAttributes(udf_func.getAttributes());
+  }
+}
+
+// Links the definitions of the UDFs a query calls, and of the functions they call, into
+// its module. The declarations of the other UDFs are dropped first, so that the whole UDF
+// module isn't copied into every query.
+void link_udf_definitions(const std::unique_ptr<llvm::Module>& udf_module,
+                          llvm::Module& module,
+                          CgenState* cgen_state) {
+  for (const auto& udf_func : *udf_module) {
+    auto func = module.getFunction(udf_func.getName());
+    if (func && func->isDeclaration() && func->use_empty()) {
+      func->eraseFromParent();
+    }
+  }
+  CodeGenerator::link_udf_module(
+      udf_module, module, cgen_state, llvm::Linker::Flags::LinkOnlyNeeded);
+  if (g_enable_udf_inlining) {
+    mark_udfs_always_inline(*udf_module, module);
+  }
+}
+
+}  // namespace
+
 std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
     llvm::Function* query_func,
     llvm::Function* multifrag_query_func,
     const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
+    const CompilationOptions& co,
+    const bool allow_baseline_tier) {
   auto module = multifrag_query_func->getParent();
   CodeCacheKey key{serialize_llvm_object(query_func),
                    serialize_llvm_object(cgen_state_->row_func_)};
@@ -379,6 +688,14 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
   if (cached_code) {
     return cached_code;
   }
+  auto clock_begin = timer_start();
+
+  if (is_udf_module_present(true)) {
+    link_udf_definitions(udf_cpu_module, *module, cgen_state_.get());
+  }
+  if (is_rt_udf_module_present(true)) {
+    link_udf_definitions(rt_udf_cpu_module, *module, cgen_state_.get());
+  }
 
   if (cgen_state_->needs_geos_) {
 #ifdef ENABLE_GEOS
@@ -405,8 +722,105 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
 #endif
   }
 
+  std::string persistent_cache_key;
+  if (use_persistent_code_cache()) {
+    persistent_cache_key =
+        PersistentCodeCache::makeKey(key, get_cpu_code_cache_target(co));
+  }
+
+  if (allow_baseline_tier && co.opt_level != ExecutorOptLevel::ReductionJIT) {
+    if (auto baseline_code = codegenCPUBaselineTier(key,
+                                                    query_func,
+                                                    multifrag_query_func,
+                                                    live_funcs,
+                                                    co,
+                                                    persistent_cache_key)) {
+      return baseline_code;
+    }
+  }
+
+  auto execution_engine = CodeGenerator::generateNativeCPUCode(
+      query_func, live_funcs, co, persistent_cache_key);
+  auto cpu_compilation_context =
+      std::make_shared<CpuCompilationContext>(std::move(execution_engine));
+  cpu_compilation_context->setFunctionPointer(multifrag_query_func);
+  addCodeToCache(
+      key, cpu_compilation_context, module, cpu_code_cache_, timer_stop(clock_begin));
+  return cpu_compilation_context;
+}
+
+std::shared_ptr<CompilationContext> Executor::codegenCPUBaselineTier(
+    const CodeCacheKey& key,
+    llvm::Function* query_func,
+    llvm::Function* multifrag_query_func,
+    const std::unordered_set<llvm::Function*>& live_funcs,
+    const CompilationOptions& co,
+    const std::string& persistent_cache_key) {
+  // The background job must not outlive the executor owning the code cache it fills.
+  std::weak_ptr<Executor> executor_ref;
+  {
+    mapd_shared_lock<mapd_shared_mutex> lock(executors_cache_mutex_);
+    auto it = executors_.find(executor_id_);
+    if (it == executors_.end() || it->second.get() != this) {
+      return nullptr;
+    }
+    executor_ref = it->second;
+  }
+
+  // Snapshot the unoptimized module for the optimizing tier before the baseline
+  // compilation takes ownership of it.
+  auto module = multifrag_query_func->getParent();
+  llvm::ValueToValueMapTy vmap;
+  auto optimized_module = llvm::CloneModule(*module, vmap).release();
+  auto optimized_query_func = llvm::cast<llvm::Function>(vmap[query_func]);
+  auto optimized_multifrag_query_func =
+      llvm::cast<llvm::Function>(vmap[multifrag_query_func]);
+  std::unordered_set<llvm::Function*> optimized_live_funcs;
+  for (const auto func : live_funcs) {
+    if (func && vmap.count(func)) {
+      optimized_live_funcs.insert(llvm::cast<llvm::Function>(vmap[func]));
+    }
+  }
+
+  auto optimize_job = [executor_ref,
+                       key,
+                       optimized_module,
+                       optimized_query_func,
+                       optimized_multifrag_query_func,
+                       optimized_live_funcs,
+                       co,
+                       persistent_cache_key]() {
+    // same lock order as the query threads, see RelAlgExecutor and executeWorkUnit
+    mapd_shared_lock<mapd_shared_mutex> execute_lock(execute_mutex_);
+    std::lock_guard<std::mutex> compilation_lock(compilation_mutex_);
+    auto executor = executor_ref.lock();
+    if (!executor) {
+      delete optimized_module;
+      return;
+    }
+    auto clock_begin = timer_start();
+    auto execution_engine = CodeGenerator::generateNativeCPUCode(
+        optimized_query_func, optimized_live_funcs, co, persistent_cache_key);
+    auto cpu_compilation_context =
+        std::make_shared<CpuCompilationContext>(std::move(execution_engine));
+    cpu_compilation_context->setFunctionPointer(optimized_multifrag_query_func);
+    const auto compilation_time_ms = timer_stop(clock_begin);
+    addCodeToCache(key,
+                   cpu_compilation_context,
+                   optimized_module,
+                   executor->cpu_code_cache_,
+                   compilation_time_ms);
+    VLOG(1) << "Installed optimized code for executor " << executor->executor_id_
+            << " after " << compilation_time_ms << " ms";
+  };
+  if (!BackgroundCodegenQueue::instance().submit({executor_id_, key}, optimize_job)) {
+    delete optimized_module;
+  }
+
+  auto baseline_co = co;
+  baseline_co.opt_level = ExecutorOptLevel::Baseline;
   auto execution_engine =
-      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co);
+      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, baseline_co);
   auto cpu_compilation_context =
       std::make_shared<CpuCompilationContext>(std::move(execution_engine));
   cpu_compilation_context->setFunctionPointer(multifrag_query_func);
@@ -518,7 +932,7 @@ declare i8 @thread_warp_idx(i8);
 declare i64* @init_shared_mem(i64*, i32);
 declare i64* @init_shared_mem_nop(i64*, i32);
 declare i64* @declare_dynamic_shared_memory();
-declare void @write_back_nop(i64*, i64*, i32);
+declare void @write_back_nop(i64*, i64*, i32, i32*);
 declare void @write_back_non_grouped_agg(i64*, i64*, i32);
 declare void @init_group_by_buffer_gpu(i64*, i64*, i32, i32, i32, i1, i8);
 declare i64* @get_group_value(i64*, i32, i64*, i32, i32, i32, i64*);
@@ -822,9 +1236,22 @@ std::shared_ptr<GpuCompilationContext> CodeGenerator::generateNativeGPUCode(
     llvm::Function* wrapper_func,
     const std::unordered_set<llvm::Function*>& live_funcs,
     const CompilationOptions& co,
-    const GPUTarget& gpu_target) {
+    const GPUTarget& gpu_target,
+    const std::string& persistent_cache_key) {
 #ifdef HAVE_CUDA
   auto module = func->getParent();
+  const auto func_name = wrapper_func->getName().str();
+  auto persistent_cache =
+      persistent_cache_key.empty() ? nullptr : PersistentCodeCache::get();
+  if (persistent_cache) {
+    auto cached_cubin = persistent_cache->load(persistent_cache_key);
+    if (cached_cubin) {
+      return load_cubin_on_all_devices(cached_cubin->getBufferStart(),
+                                       cached_cubin->getBufferSize(),
+                                       func_name,
+                                       gpu_target.cuda_mgr);
+    }
+  }
   /*
     `func` is one of the following generated functions:
     - `call_table_function(i8** %input_col_buffers, i64*
@@ -973,26 +1400,18 @@ std::shared_ptr<GpuCompilationContext> CodeGenerator::generateNativeGPUCode(
   LOG(PTX) << "PTX for the GPU:\n" << ptx << "\nEnd of PTX";
 
   auto cubin_result = ptx_to_cubin(ptx, gpu_target.block_size, gpu_target.cuda_mgr);
-  auto& option_keys = cubin_result.option_keys;
-  auto& option_values = cubin_result.option_values;
   auto cubin = cubin_result.cubin;
   auto link_state = cubin_result.link_state;
-  const auto num_options = option_keys.size();
-
-  auto func_name = wrapper_func->getName().str();
-  auto gpu_compilation_context = std::make_shared<GpuCompilationContext>();
-  for (int device_id = 0; device_id < gpu_target.cuda_mgr->getDeviceCount();
-       ++device_id) {
-    gpu_compilation_context->addDeviceCode(
-        std::make_unique<GpuDeviceCompilationContext>(cubin,
-                                                      func_name,
-                                                      device_id,
-                                                      gpu_target.cuda_mgr,
-                                                      num_options,
-                                                      &option_keys[0],
-                                                      &option_values[0]));
+  if (persistent_cache) {
+    persistent_cache->store(
+        persistent_cache_key,
+        llvm::StringRef(static_cast<const char*>(cubin), cubin_result.cubin_size));
   }
 
+  auto gpu_compilation_context =
+      load_cubin_on_all_devices(
+          cubin, cubin_result.cubin_size, func_name, gpu_target.cuda_mgr);
+
   checkCudaErrors(cuLinkDestroy(link_state));
   return gpu_compilation_context;
 #else
@@ -1022,6 +1441,7 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenGPU(
   if (cached_code) {
     return cached_code;
   }
+  auto clock_begin = timer_start();
 
   bool row_func_not_inlined = false;
   if (no_inline) {
@@ -1069,10 +1489,22 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenGPU(
     }
   }
 
+  std::string persistent_cache_key;
+  if (use_persistent_code_cache()) {
+    persistent_cache_key = PersistentCodeCache::makeKey(
+        key, get_gpu_code_cache_target(cuda_mgr, blockSize(), co));
+  }
+
   try {
     compilation_context = CodeGenerator::generateNativeGPUCode(
-        query_func, multifrag_query_func, live_funcs, co, gpu_target);
-    addCodeToCache(key, compilation_context, module, gpu_code_cache_);
+        query_func,
+        multifrag_query_func,
+        live_funcs,
+        co,
+        gpu_target,
+        persistent_cache_key);
+    addCodeToCache(
+        key, compilation_context, module, gpu_code_cache_, timer_stop(clock_begin));
   } catch (CudaMgr_Namespace::CudaErrorException& cuda_error) {
     if (cuda_error.getStatus() == CUDA_ERROR_OUT_OF_MEMORY) {
       // Thrown if memory not able to be allocated on gpu
@@ -1081,9 +1513,14 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenGPU(
                    << g_fraction_code_cache_to_evict * 100.
                    << "% of GPU code cache and re-trying.";
       gpu_code_cache_.evictFractionEntries(g_fraction_code_cache_to_evict);
-      compilation_context = CodeGenerator::generateNativeGPUCode(
-          query_func, multifrag_query_func, live_funcs, co, gpu_target);
-      addCodeToCache(key, compilation_context, module, gpu_code_cache_);
+      compilation_context = CodeGenerator::generateNativeGPUCode(query_func,
+                                                                 multifrag_query_func,
+                                                                 live_funcs,
+                                                                 co,
+                                                                 gpu_target,
+                                                                 persistent_cache_key);
+      addCodeToCache(
+          key, compilation_context, module, gpu_code_cache_, timer_stop(clock_begin));
     } else {
       throw;
     }
@@ -1174,6 +1611,10 @@ bool CodeGenerator::alwaysCloneRuntimeFunction(const llvm::Function* func) {
          func->getName() == "fixed_width_int_decode" ||
          func->getName() == "fixed_width_unsigned_decode" ||
          func->getName() == "diff_fixed_width_int_decode" ||
+         func->getName() == "bit_packed_code" ||
+         func->getName() == "frame_of_reference_int_decode" ||
+         func->getName() == "delta_int_decode" ||
+         func->getName() == "run_length_int_decode" ||
          func->getName() == "fixed_width_double_decode" ||
          func->getName() == "fixed_width_float_decode" ||
          func->getName() == "fixed_width_small_date_decode" ||
@@ -1286,6 +1727,23 @@ void bind_pos_placeholders(const std::string& pos_fn_name,
   }
 }
 
+// A single thread walks the fragment on CPU. With a constant stride the scan loop has a
+// canonical induction variable, which the loop vectorizer requires.
+void fold_cpu_pos_step(llvm::Function* query_func) {
+  std::vector<llvm::CallInst*> pos_step_calls;
+  for (auto& inst : llvm::instructions(query_func)) {
+    auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+    if (call && call->getCalledFunction() &&
+        call->getCalledFunction()->getName() == "pos_step_impl") {
+      pos_step_calls.push_back(call);
+    }
+  }
+  for (auto call : pos_step_calls) {
+    call->replaceAllUsesWith(llvm::ConstantInt::get(call->getType(), 1));
+    call->eraseFromParent();
+  }
+}
+
 void set_row_func_argnames(llvm::Function* row_func,
                            const size_t in_col_count,
                            const size_t agg_col_count,
@@ -1515,6 +1973,9 @@ std::vector<std::string> get_agg_fnames(const std::vector<Analyzer::Expr*>& targ
       case kAPPROX_COUNT_DISTINCT:
         result.emplace_back("agg_approximate_count_distinct");
         break;
+      case kAPPROX_QUANTILE:
+        result.emplace_back("agg_approx_quantile");
+        break;
       default:
         CHECK(false);
     }
@@ -1827,8 +2288,11 @@ void Executor::createErrorCheckControlFlow(
                                       interrupt_predicate,
                                       cgen_state_->llInt(int64_t(0LL)));
           } else {
-            // CPU path: run interrupt checker for every 64th row
-            auto interrupt_predicate = ir_builder.CreateAnd(pos, uint64_t(0x3f));
+            // CPU path: run interrupt checker once per block of rows, the scheduler
+            // checks it between kernels and the multi-fragment loop between fragments
+            const uint64_t block_rows =
+                uint64_t(1) << getExpOfTwo(g_cpu_interrupt_check_block_rows);
+            auto interrupt_predicate = ir_builder.CreateAnd(pos, block_rows - 1);
             call_check_interrupt_lv =
                 ir_builder.CreateICmp(llvm::ICmpInst::ICMP_EQ,
                                       interrupt_predicate,
@@ -2160,8 +2624,11 @@ bool is_gpu_shared_mem_supported(const QueryMemoryDescriptor* query_mem_desc_ptr
       return true;
     }
   }
-  if (query_mem_desc_ptr->getQueryDescriptionType() ==
-          QueryDescriptionType::GroupByPerfectHash &&
+  const bool is_baseline_hash = query_mem_desc_ptr->getQueryDescriptionType() ==
+                                QueryDescriptionType::GroupByBaselineHash;
+  if ((query_mem_desc_ptr->getQueryDescriptionType() ==
+           QueryDescriptionType::GroupByPerfectHash ||
+       (is_baseline_hash && g_enable_smem_baseline_group_by)) &&
       g_enable_smem_group_by) {
     /**
      * To simplify the implementation for practical purposes, we
@@ -2178,9 +2645,13 @@ bool is_gpu_shared_mem_supported(const QueryMemoryDescriptor* query_mem_desc_ptr
     // Fundamentally, we should use shared memory whenever the output buffer
     // is small enough so that we can fit it in the shared memory and yet expect
     // good occupancy.
-    // For now, we allow keyless, row-wise layout, and only for perfect hash
-    // group by operations.
-    if (query_mem_desc_ptr->hasKeylessHash() &&
+    // For now, we allow keyless, row-wise layout for perfect hash and row-wise layout
+    // for baseline hash group by operations. For baseline hash, the entry count comes
+    // from the estimated group count and each thread block builds a partial hash table
+    // with as many entries in shared memory: a block which runs out of entries there
+    // would run out of entries in the global memory buffer as well.
+    if ((is_baseline_hash ? !query_mem_desc_ptr->didOutputColumnar()
+                          : query_mem_desc_ptr->hasKeylessHash()) &&
         query_mem_desc_ptr->countDistinctDescriptorsLogicallyEmpty() &&
         !query_mem_desc_ptr->useStreamingTopN()) {
       const size_t shared_memory_threshold_bytes = std::min(
@@ -2287,6 +2758,19 @@ std::string serialize_llvm_metadata_footnotes(llvm::Function* query_func,
 }
 #endif  // NDEBUG
 
+// Small inputs execute faster than they optimize, run them with baseline code first.
+bool allow_baseline_tier(const std::vector<InputTableInfo>& query_infos,
+                         const ExecutionOptions& eo) {
+  if (!g_enable_tiered_compilation || eo.just_explain || eo.jit_debug) {
+    return false;
+  }
+  size_t input_rows{0};
+  for (const auto& query_info : query_infos) {
+    input_rows += query_info.info.getNumTuplesUpperBound();
+  }
+  return input_rows <= g_tiered_compilation_max_input_rows;
+}
+
 }  // namespace
 
 std::tuple<CompilationResult, std::unique_ptr<QueryMemoryDescriptor>>
@@ -2367,11 +2851,19 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
       const auto& count_distinct_descriptor =
           query_mem_desc->getCountDistinctDescriptor(i);
       if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::StdSet ||
+          count_distinct_descriptor.impl_type_ == CountDistinctImplType::SparseHll ||
+          count_distinct_descriptor.impl_type_ == CountDistinctImplType::RoaringBitmap ||
           (count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid &&
            !co.hoist_literals)) {
         throw QueryMustRunOnCpu();
       }
     }
+    // The t-digests of APPROX_QUANTILE live in host memory.
+    for (const auto target_expr : ra_exe_unit.target_exprs) {
+      if (is_approx_quantile_target(get_target_info(target_expr, g_bigint_count))) {
+        throw QueryMustRunOnCpu();
+      }
+    }
   }
 
   // Read the module template and target either CPU or GPU
@@ -2390,11 +2882,10 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
 
   if (co.device_type == ExecutorDeviceType::CPU) {
     if (is_udf_module_present(true)) {
-      CodeGenerator::link_udf_module(udf_cpu_module, *rt_module_copy, cgen_state_.get());
+      declare_udf_functions(*udf_cpu_module, *rt_module_copy);
     }
     if (is_rt_udf_module_present(true)) {
-      CodeGenerator::link_udf_module(
-          rt_udf_cpu_module, *rt_module_copy, cgen_state_.get());
+      declare_udf_functions(*rt_udf_cpu_module, *rt_module_copy);
     }
   } else {
     rt_module_copy->setDataLayout(get_gpu_data_layout());
@@ -2439,6 +2930,9 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
   bind_pos_placeholders("pos_start", true, query_func, cgen_state_->module_);
   bind_pos_placeholders("group_buff_idx", false, query_func, cgen_state_->module_);
   bind_pos_placeholders("pos_step", false, query_func, cgen_state_->module_);
+  if (co.device_type == ExecutorDeviceType::CPU && g_enable_cpu_vectorization) {
+    fold_cpu_pos_step(query_func);
+  }
 
   cgen_state_->query_func_ = query_func;
   cgen_state_->row_func_call_ = row_func_call;
@@ -2630,7 +3124,10 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
       optimize_ir(query_func, cgen_state_->module_, pass_manager, live_funcs, co);
 #endif  // WITH_JIT_DEBUG
     }
-    llvm_ir =
+    for (const auto& join_hash_table : plan_state_->join_info_.join_hash_tables_) {
+      llvm_ir += "; " + join_hash_table->getLayoutSummary() + "\n";
+    }
+    llvm_ir +=
         serialize_llvm_object(multifrag_query_func) + serialize_llvm_object(query_func) +
         serialize_llvm_object(cgen_state_->row_func_) +
         (cgen_state_->filter_func_ ? serialize_llvm_object(cgen_state_->filter_func_)
@@ -2664,7 +3161,11 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
   return std::make_tuple(
       CompilationResult{
           co.device_type == ExecutorDeviceType::CPU
-              ? optimizeAndCodegenCPU(query_func, multifrag_query_func, live_funcs, co)
+              ? optimizeAndCodegenCPU(query_func,
+                                      multifrag_query_func,
+                                      live_funcs,
+                                      co,
+                                      allow_baseline_tier(query_infos, eo))
               : optimizeAndCodegenGPU(query_func,
                                       multifrag_query_func,
                                       live_funcs,
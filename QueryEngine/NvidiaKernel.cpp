@@ -150,7 +150,7 @@ CubinResult ptx_to_cubin(const std::string& ptx,
   CHECK(cubin);
   CHECK_GT(cubinSize, size_t(0));
   VLOG(1) << "Generated GPU binary code size: " << cubinSize << " bytes";
-  return {cubin, option_keys, option_values, link_state};
+  return {cubin, cubinSize, option_keys, option_values, link_state};
 }
 #endif
 
@@ -173,11 +173,40 @@ GpuDeviceCompilationContext::GpuDeviceCompilationContext(const void* image,
   CHECK(module_);
   checkCudaErrors(cuModuleGetFunction(&kernel_, module_, kernel_name.c_str()));
 }
+
+void GpuDeviceCompilationContext::launchGraph(const std::vector<size_t>& layout,
+                                              CUgraph graph,
+                                              CUstream stream) {
+  // the parameters of the instance are those of the last update until it's launched
+  std::lock_guard<std::mutex> launch_graphs_lock(launch_graphs_mutex_);
+  auto it = launch_graphs_.find(layout);
+  if (it != launch_graphs_.end()) {
+    CUgraphNode error_node;
+    CUgraphExecUpdateResult update_result;
+    if (cuGraphExecUpdate(it->second, graph, &error_node, &update_result) !=
+        CUDA_SUCCESS) {
+      VLOG(1) << "Re-instantiating the launch graph of a kernel on device " << device_id_
+              << ", update result " << update_result;
+      checkCudaErrors(cuGraphExecDestroy(it->second));
+      launch_graphs_.erase(it);
+      it = launch_graphs_.end();
+    }
+  }
+  if (it == launch_graphs_.end()) {
+    CUgraphExec graph_exec;
+    checkCudaErrors(cuGraphInstantiate(&graph_exec, graph, nullptr, nullptr, 0));
+    it = launch_graphs_.emplace(layout, graph_exec).first;
+  }
+  checkCudaErrors(cuGraphLaunch(it->second, stream));
+}
 #endif  // HAVE_CUDA
 
 GpuDeviceCompilationContext::~GpuDeviceCompilationContext() {
 #ifdef HAVE_CUDA
   CHECK(cuda_mgr_);
+  for (auto& layout_and_graph : launch_graphs_) {
+    cuGraphExecDestroy(layout_and_graph.second);
+  }
   cuda_mgr_->unloadGpuModuleData(&module_, device_id_);
 #endif
 }
@@ -24,11 +24,14 @@
 #else
 #include "../Shared/nocuda.h"
 #endif  // HAVE_CUDA
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
 struct CubinResult {
   void* cubin;
+  size_t cubin_size;
   std::vector<CUjit_option> option_keys;
   std::vector<void*> option_values;
   CUlinkState link_state;
@@ -61,12 +64,22 @@ class GpuDeviceCompilationContext {
   CUfunction kernel() { return kernel_; }
   CUmodule module() { return module_; }
 
+#ifdef HAVE_CUDA
+  // Launches `graph`, the captured launches of the kernel for a layout of its fragments
+  // and buffers, on `stream`. The graph instantiated the first time the layout is seen
+  // is kept and only gets the parameters of the following captures.
+  void launchGraph(const std::vector<size_t>& layout, CUgraph graph, CUstream stream);
+#endif  // HAVE_CUDA
+
  private:
   CUmodule module_;
   CUfunction kernel_;
 #ifdef HAVE_CUDA
   const int device_id_;
   const CudaMgr_Namespace::CudaMgr* cuda_mgr_;
+
+  std::mutex launch_graphs_mutex_;
+  std::map<std::vector<size_t>, CUgraphExec> launch_graphs_;
 #endif  // HAVE_CUDA
 };
 
@@ -85,6 +98,16 @@ class GpuCompilationContext : public CompilationContext {
                                         device_context->module());
   }
 
+#ifdef HAVE_CUDA
+  void launchGraph(const size_t device_id,
+                   const std::vector<size_t>& layout,
+                   CUgraph graph,
+                   CUstream stream) const {
+    CHECK_LT(device_id, contexts_per_device_.size());
+    contexts_per_device_[device_id]->launchGraph(layout, graph, stream);
+  }
+#endif  // HAVE_CUDA
+
   std::vector<void*> getNativeFunctionPointers() const {
     std::vector<void*> fn_ptrs;
     for (auto& device_context : contexts_per_device_) {
@@ -94,7 +117,11 @@ class GpuCompilationContext : public CompilationContext {
     return fn_ptrs;
   }
 
+  void setCodeSize(const size_t code_size) { code_size_ = code_size; }
+  size_t getCodeSize() const override { return code_size_; }
+
  private:
+  size_t code_size_{0};
   std::vector<std::unique_ptr<GpuDeviceCompilationContext>> contexts_per_device_;
 };
 
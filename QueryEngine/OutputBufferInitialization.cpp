@@ -172,6 +172,7 @@ int64_t get_agg_initial_val(const SQLAgg agg,
     }
     case kCOUNT:
     case kAPPROX_COUNT_DISTINCT:
+    case kAPPROX_QUANTILE:  // handle of the t-digest, allocated per group
       return 0;
     case kMIN: {
       switch (byte_width) {
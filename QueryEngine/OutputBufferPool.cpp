@@ -0,0 +1,105 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/OutputBufferPool.h"
+
+#include <cstdlib>
+
+#include "Logger/Logger.h"
+#include "Shared/NumaUtils.h"
+#include "Shared/checked_alloc.h"
+
+bool g_enable_output_buffer_pool{true};
+size_t g_output_buffer_pool_max_idle_bytes{size_t(1) << 30};  // 1GB
+
+OutputBufferPool& OutputBufferPool::instance() {
+  static OutputBufferPool pool;
+  return pool;
+}
+
+OutputBufferPool::OutputBufferPool() : node_pools_(numa::get_num_nodes()) {
+  for (auto& node_pool : node_pools_) {
+    node_pool.free_buffers.resize(getSizeClass(kMaxPooledBytes) + 1);
+  }
+}
+
+size_t OutputBufferPool::getSizeClass(const size_t num_bytes) {
+  size_t size_class = 0;
+  while ((kMinPooledBytes << size_class) < num_bytes) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+OutputBufferPool::Buffer OutputBufferPool::acquire(const size_t num_bytes) {
+  if (num_bytes < kMinPooledBytes || num_bytes > kMaxPooledBytes) {
+    return {};
+  }
+  const auto size_class = getSizeClass(num_bytes);
+  const auto capacity = kMinPooledBytes << size_class;
+  const auto node = numa::get_current_node();
+  const size_t node_idx = node < 0 ? 0 : node % node_pools_.size();
+  auto& node_pool = node_pools_[node_idx];
+  {
+    std::lock_guard<std::mutex> lock(node_pool.mutex);
+    auto& free_buffers = node_pool.free_buffers[size_class];
+    if (!free_buffers.empty()) {
+      auto ptr = free_buffers.back();
+      free_buffers.pop_back();
+      idle_bytes_.fetch_sub(capacity);
+      hits_.fetch_add(1);
+      return {ptr, capacity, static_cast<int>(node_idx)};
+    }
+  }
+  misses_.fetch_add(1);
+  auto ptr = reinterpret_cast<int8_t*>(checked_malloc(capacity));
+  // not touched yet, its pages are placed on the node of the thread
+  numa::bind_memory_to_node(ptr, capacity, node);
+  return {ptr, capacity, static_cast<int>(node_idx)};
+}
+
+void OutputBufferPool::release(const Buffer& buffer) {
+  CHECK(buffer.ptr);
+  CHECK_LT(static_cast<size_t>(buffer.node), node_pools_.size());
+  if (idle_bytes_.fetch_add(buffer.capacity) + buffer.capacity >
+      g_output_buffer_pool_max_idle_bytes) {
+    idle_bytes_.fetch_sub(buffer.capacity);
+    free(buffer.ptr);
+    return;
+  }
+  auto& node_pool = node_pools_[buffer.node];
+  std::lock_guard<std::mutex> lock(node_pool.mutex);
+  node_pool.free_buffers[getSizeClass(buffer.capacity)].push_back(buffer.ptr);
+}
+
+OutputBufferPool::Stats OutputBufferPool::getStats() const {
+  return {idle_bytes_.load(), hits_.load(), misses_.load()};
+}
+
+void OutputBufferPool::clear() {
+  for (auto& node_pool : node_pools_) {
+    std::lock_guard<std::mutex> lock(node_pool.mutex);
+    for (size_t size_class = 0; size_class < node_pool.free_buffers.size();
+         ++size_class) {
+      auto& free_buffers = node_pool.free_buffers[size_class];
+      for (auto ptr : free_buffers) {
+        free(ptr);
+      }
+      idle_bytes_.fetch_sub(free_buffers.size() * (kMinPooledBytes << size_class));
+      free_buffers.clear();
+    }
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+extern bool g_enable_output_buffer_pool;
+extern size_t g_output_buffer_pool_max_idle_bytes;
+
+/**
+ * @brief Keeps the CPU output and group by buffers of finished queries for the next
+ * ones, so that a query at high QPS does not pay for malloc and for the page faults of
+ * fresh memory. The buffers are kept in power of two size classes, on the NUMA node of
+ * the thread which allocated them, and freed past g_output_buffer_pool_max_idle_bytes.
+ * They are handed out uninitialized.
+ */
+class OutputBufferPool {
+ public:
+  struct Buffer {
+    int8_t* ptr{nullptr};
+    size_t capacity{0};
+    int node{-1};
+  };
+
+  struct Stats {
+    size_t idle_bytes{0};
+    size_t hits{0};
+    size_t misses{0};
+  };
+
+  // Buffers outside of these sizes are not pooled.
+  static constexpr size_t kMinPooledBytes{size_t(1) << 16};
+  static constexpr size_t kMaxPooledBytes{size_t(1) << 30};
+
+  static OutputBufferPool& instance();
+
+  // A buffer of at least `num_bytes`, with a null ptr if the size is not pooled.
+  Buffer acquire(const size_t num_bytes);
+
+  void release(const Buffer& buffer);
+
+  Stats getStats() const;
+
+  // Frees the idle buffers.
+  void clear();
+
+ private:
+  OutputBufferPool();
+
+  static size_t getSizeClass(const size_t num_bytes);
+
+  struct NodePool {
+    std::mutex mutex;
+    // free buffers of each size class
+    std::vector<std::vector<int8_t*>> free_buffers;
+  };
+
+  std::vector<NodePool> node_pools_;
+  std::atomic<size_t> idle_bytes_{0};
+  std::atomic<size_t> hits_{0};
+  std::atomic<size_t> misses_{0};
+};
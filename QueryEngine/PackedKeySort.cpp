@@ -0,0 +1,194 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/PackedKeySort.h"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <numeric>
+
+#include "Logger/Logger.h"
+
+bool g_enable_packed_key_sort{true};
+
+namespace packed_key_sort {
+
+namespace {
+
+constexpr unsigned kDigitBits{8};
+constexpr size_t kBucketCount{size_t(1) << kDigitBits};
+constexpr size_t kMinRowsPerThread{size_t(1) << 16};
+
+// Runs f(chunk_idx, start, end) on `chunk_count` contiguous ranges of the rows.
+template <class F>
+void parallel_for_chunks(const size_t row_count, const size_t chunk_count, F f) {
+  if (chunk_count == 1) {
+    f(0, 0, row_count);
+    return;
+  }
+  const auto chunk_size = (row_count + chunk_count - 1) / chunk_count;
+  std::vector<std::future<void>> chunk_futures;
+  for (size_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+    const auto start = std::min(chunk_idx * chunk_size, row_count);
+    const auto end = std::min(start + chunk_size, row_count);
+    chunk_futures.emplace_back(std::async(std::launch::async, f, chunk_idx, start, end));
+  }
+  for (auto& chunk_future : chunk_futures) {
+    chunk_future.wait();
+  }
+  for (auto& chunk_future : chunk_futures) {
+    chunk_future.get();
+  }
+}
+
+// A stable counting sort pass on the digit at `shift`, skipped if all the rows have the
+// same digit. The histograms of the chunks are laid out bucket by bucket so that the
+// chunks scatter their rows in their original order.
+void sort_digit(std::vector<uint64_t>& keys,
+                std::vector<uint32_t>& idx,
+                std::vector<uint64_t>& keys_out,
+                std::vector<uint32_t>& idx_out,
+                std::vector<size_t>& histograms,
+                const unsigned shift,
+                const size_t chunk_count) {
+  const auto row_count = keys.size();
+  histograms.assign(chunk_count * kBucketCount, 0);
+  parallel_for_chunks(
+      row_count, chunk_count, [&](const size_t chunk_idx, size_t start, size_t end) {
+        auto histogram = &histograms[chunk_idx * kBucketCount];
+        for (size_t i = start; i < end; ++i) {
+          ++histogram[(keys[i] >> shift) & (kBucketCount - 1)];
+        }
+      });
+  for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    size_t bucket_count{0};
+    for (size_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+      bucket_count += histograms[chunk_idx * kBucketCount + bucket];
+    }
+    if (bucket_count == row_count) {
+      return;
+    }
+  }
+  size_t offset{0};
+  for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+    for (size_t chunk_idx = 0; chunk_idx < chunk_count; ++chunk_idx) {
+      auto& bucket_offset = histograms[chunk_idx * kBucketCount + bucket];
+      const auto bucket_count = bucket_offset;
+      bucket_offset = offset;
+      offset += bucket_count;
+    }
+  }
+  parallel_for_chunks(
+      row_count, chunk_count, [&](const size_t chunk_idx, size_t start, size_t end) {
+        auto offsets = &histograms[chunk_idx * kBucketCount];
+        for (size_t i = start; i < end; ++i) {
+          const auto pos = offsets[(keys[i] >> shift) & (kBucketCount - 1)]++;
+          keys_out[pos] = keys[i];
+          idx_out[pos] = idx[i];
+        }
+      });
+  keys.swap(keys_out);
+  idx.swap(idx_out);
+}
+
+}  // namespace
+
+std::optional<PackedKeys> pack(const std::vector<SortColumn>& columns) {
+  PackedKeys keys;
+  keys.row_count = columns.empty() ? 0 : columns.front().values.size();
+  // start a word with the first column
+  unsigned used_bits{64};
+  for (const auto& column : columns) {
+    CHECK_EQ(keys.row_count, column.values.size());
+    const bool has_nulls =
+        std::find(column.nulls.begin(), column.nulls.end(), 1) != column.nulls.end();
+    const auto is_null = [&column, has_nulls](const size_t i) {
+      return has_nulls && column.nulls[i];
+    };
+    auto min_value = std::numeric_limits<uint64_t>::max();
+    uint64_t max_value{0};
+    for (size_t i = 0; i < keys.row_count; ++i) {
+      if (!is_null(i)) {
+        min_value = std::min(min_value, column.values[i]);
+        max_value = std::max(max_value, column.values[i]);
+      }
+    }
+    if (min_value > max_value) {
+      // only nulls
+      min_value = max_value = 0;
+    }
+    const auto range = max_value - min_value;
+    if (has_nulls && range == std::numeric_limits<uint64_t>::max()) {
+      return std::nullopt;
+    }
+    // the nulls take the code before the first value or after the last one
+    const uint64_t max_code = has_nulls ? range + 1 : range;
+    const unsigned bits = max_code ? 64 - __builtin_clzll(max_code) : 0;
+    if (!bits) {
+      // all the rows are the same for this column
+      continue;
+    }
+    if (used_bits + bits > 64) {
+      keys.words.emplace_back(keys.row_count, 0);
+      keys.word_bits.push_back(0);
+      used_bits = 0;
+    }
+    auto& word = keys.words.back();
+    const uint64_t value_offset = has_nulls && column.nulls_first ? 1 : 0;
+    const uint64_t null_code = column.nulls_first ? 0 : range + 1;
+    for (size_t i = 0; i < keys.row_count; ++i) {
+      const auto code =
+          is_null(i) ? null_code : column.values[i] - min_value + value_offset;
+      word[i] = bits == 64 ? code : (word[i] << bits) | code;
+    }
+    used_bits += bits;
+    keys.word_bits.back() = used_bits;
+  }
+  return keys;
+}
+
+std::vector<uint32_t> sort(const PackedKeys& keys, const size_t thread_count) {
+  const auto row_count = keys.row_count;
+  CHECK_LE(row_count, size_t(std::numeric_limits<uint32_t>::max()));
+  std::vector<uint32_t> idx(row_count);
+  std::iota(idx.begin(), idx.end(), 0);
+  if (row_count < 2 || keys.words.empty()) {
+    return idx;
+  }
+  const auto chunk_count =
+      std::max(size_t(1), std::min(thread_count, row_count / kMinRowsPerThread));
+  std::vector<uint64_t> word_keys(row_count);
+  std::vector<uint64_t> keys_out(row_count);
+  std::vector<uint32_t> idx_out(row_count);
+  std::vector<size_t> histograms;
+  // least significant word first, each pass is stable
+  for (size_t word_idx = keys.words.size(); word_idx-- > 0;) {
+    const auto& word = keys.words[word_idx];
+    parallel_for_chunks(
+        row_count, chunk_count, [&](const size_t, size_t start, size_t end) {
+          for (size_t i = start; i < end; ++i) {
+            word_keys[i] = word[idx[i]];
+          }
+        });
+    for (unsigned shift = 0; shift < keys.word_bits[word_idx]; shift += kDigitBits) {
+      sort_digit(word_keys, idx, keys_out, idx_out, histograms, shift, chunk_count);
+    }
+  }
+  return idx;
+}
+
+}  // namespace packed_key_sort
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PackedKeySort.h
+ * @brief   Multi-column ORDER BY as a radix sort of normalized keys.
+ *
+ * Each ORDER BY column is turned into order preserving unsigned values, with the
+ * direction and the null ordering folded in. The columns are then rebased on their
+ * minimum and packed, most significant first, into as few 64-bit words as their ranges
+ * allow, so that a single LSD radix sort over the words orders the rows by all the
+ * columns at once. Digits which are the same for all the rows are skipped.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+extern bool g_enable_packed_key_sort;
+
+namespace packed_key_sort {
+
+// Order preserving unsigned value of a signed integer, reversed if `desc`.
+inline uint64_t normalize_int(const int64_t value, const bool desc) {
+  const auto normalized = static_cast<uint64_t>(value) ^ (uint64_t(1) << 63);
+  return desc ? ~normalized : normalized;
+}
+
+// Order preserving unsigned value of a double which isn't NaN, reversed if `desc`.
+inline uint64_t normalize_fp(const double value, const bool desc) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const auto normalized = (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+  return desc ? ~normalized : normalized;
+}
+
+struct SortColumn {
+  std::vector<uint64_t> values;  // normalized, see above
+  std::vector<int8_t> nulls;     // empty if the column has no null
+  bool nulls_first{false};
+};
+
+struct PackedKeys {
+  size_t row_count{0};
+  // most significant word first, each holds one value per row
+  std::vector<std::vector<uint64_t>> words;
+  // number of low bits of each word the rows can differ in
+  std::vector<unsigned> word_bits;
+};
+
+// std::nullopt if a column can't be packed: its range takes all 64 bits and it has nulls.
+std::optional<PackedKeys> pack(const std::vector<SortColumn>& columns);
+
+/**
+ * The rows ordered by their packed keys, ties in their original order. Large inputs are
+ * sorted on up to `thread_count` threads.
+ */
+std::vector<uint32_t> sort(const PackedKeys& keys, const size_t thread_count);
+
+}  // namespace packed_key_sort
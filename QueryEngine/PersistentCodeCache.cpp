@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/PersistentCodeCache.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#include "Logger/Logger.h"
+#include "MapDRelease.h"
+
+bool g_enable_persistent_code_cache{false};
+std::string g_persistent_code_cache_path;
+
+namespace {
+
+const std::string kCodeFileExtension{".code"};
+
+// Entries are laid out as <key size><key><code>.
+using KeySizeType = uint64_t;
+
+}  // namespace
+
+PersistentCodeCache::PersistentCodeCache(const std::string& path) : path_(path) {
+  boost::filesystem::create_directories(path_);
+}
+
+PersistentCodeCache* PersistentCodeCache::get() {
+  static std::once_flag init_flag;
+  static std::unique_ptr<PersistentCodeCache> cache;
+  if (!g_enable_persistent_code_cache) {
+    return nullptr;
+  }
+  std::call_once(init_flag, [] {
+    CHECK(!g_persistent_code_cache_path.empty());
+    try {
+      cache = std::make_unique<PersistentCodeCache>(g_persistent_code_cache_path);
+      LOG(INFO) << "Persistent code cache enabled at " << g_persistent_code_cache_path;
+    } catch (const boost::filesystem::filesystem_error& e) {
+      LOG(WARNING) << "Unable to use persistent code cache directory "
+                   << g_persistent_code_cache_path << ": " << e.what();
+    }
+  });
+  return cache.get();
+}
+
+std::string PersistentCodeCache::makeKey(const CodeCacheKey& key,
+                                         const std::string& target) {
+  std::ostringstream oss;
+  oss << MAPD_RELEASE << '\n' << target << '\n';
+  for (const auto& part : key) {
+    oss << part.size() << ':' << part;
+  }
+  return oss.str();
+}
+
+std::string PersistentCodeCache::getFileName(const std::string& key) const {
+  std::ostringstream oss;
+  oss << std::hex << std::setw(16) << std::setfill('0') << boost::hash_value(key)
+      << kCodeFileExtension;
+  return (boost::filesystem::path(path_) / oss.str()).string();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> PersistentCodeCache::load(
+    const std::string& key) const {
+  const auto file_name = getFileName(key);
+  std::ifstream in(file_name, std::ios::binary);
+  if (!in) {
+    return nullptr;
+  }
+  KeySizeType key_size{0};
+  in.read(reinterpret_cast<char*>(&key_size), sizeof(key_size));
+  if (!in || key_size != key.size()) {
+    return nullptr;
+  }
+  std::string stored_key(key_size, '\0');
+  in.read(&stored_key[0], key_size);
+  if (!in || stored_key != key) {
+    VLOG(1) << "Persistent code cache collision on " << file_name;
+    return nullptr;
+  }
+  std::string code((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  if (code.empty()) {
+    return nullptr;
+  }
+  VLOG(1) << "Loaded " << code.size() << " bytes of native code from " << file_name;
+  return llvm::MemoryBuffer::getMemBufferCopy(code, file_name);
+}
+
+void PersistentCodeCache::store(const std::string& key, llvm::StringRef code) const {
+  const auto file_name = getFileName(key);
+  // Write to a private file first so that readers never observe a partial entry.
+  const auto tmp_name =
+      boost::filesystem::unique_path(file_name + ".%%%%-%%%%-%%%%.tmp").string();
+  {
+    std::ofstream out(tmp_name, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      LOG(WARNING) << "Unable to write persistent code cache entry " << tmp_name;
+      return;
+    }
+    const KeySizeType key_size = key.size();
+    out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    out.write(key.data(), key.size());
+    out.write(code.data(), code.size());
+    if (!out) {
+      LOG(WARNING) << "Unable to write persistent code cache entry " << tmp_name;
+      boost::system::error_code ec;
+      boost::filesystem::remove(tmp_name, ec);
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_name, file_name, ec);
+  if (ec) {
+    LOG(WARNING) << "Unable to add persistent code cache entry " << file_name << ": "
+                 << ec.message();
+    boost::filesystem::remove(tmp_name, ec);
+  }
+}
+
+void PersistentObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                                 llvm::MemoryBufferRef obj) {
+  cache_.store(key_, obj.getBuffer());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> PersistentObjectCache::getObject(
+    const llvm::Module* module) {
+  return std::move(cached_object_);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PersistentCodeCache.h
+ * @brief   On-disk tier for generated code which survives server restarts.
+ *
+ * The in-memory CodeCache is consulted first. On a miss, the native code (CPU object
+ * files or GPU cubins) is looked up on disk using the same CodeCacheKey, extended with
+ * the server release and the compilation target. Entries carry their full key, so a
+ * hash collision can only ever produce a cache miss.
+ */
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <memory>
+#include <string>
+
+#include "QueryEngine/CodeCache.h"
+
+extern bool g_enable_persistent_code_cache;
+extern std::string g_persistent_code_cache_path;
+
+class PersistentCodeCache {
+ public:
+  explicit PersistentCodeCache(const std::string& path);
+
+  /**
+   * Returns the process wide cache, or nullptr if the persistent tier is disabled or
+   * its directory cannot be used.
+   */
+  static PersistentCodeCache* get();
+
+  /**
+   * Builds the persistent key for an in-memory key. `target` identifies everything the
+   * native code depends on besides the IR (triple, CPU or GPU architecture, options).
+   */
+  static std::string makeKey(const CodeCacheKey& key, const std::string& target);
+
+  std::unique_ptr<llvm::MemoryBuffer> load(const std::string& key) const;
+
+  void store(const std::string& key, llvm::StringRef code) const;
+
+  const std::string& getPath() const { return path_; }
+
+ private:
+  std::string getFileName(const std::string& key) const;
+
+  std::string path_;
+};
+
+/**
+ * Adapter handed to MCJIT while a single module is finalized: serves the object file for
+ * `key` if it is on disk and records the compiled object otherwise.
+ */
+class PersistentObjectCache : public llvm::ObjectCache {
+ public:
+  PersistentObjectCache(const PersistentCodeCache& cache, const std::string& key)
+      : cache_(cache), key_(key), cached_object_(cache.load(key)) {}
+
+  // If true, the module does not need to be optimized; MCJIT will skip code generation.
+  bool hasObject() const { return cached_object_ != nullptr; }
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef obj) override;
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+ private:
+  const PersistentCodeCache& cache_;
+  const std::string key_;
+  std::unique_ptr<llvm::MemoryBuffer> cached_object_;
+};
@@ -29,9 +29,11 @@ bool PlanState::isLazyFetchColumn(const Analyzer::Expr* target_expr) {
     auto cd = get_column_descriptor(do_not_fetch_column->get_column_id(),
                                     do_not_fetch_column->get_table_id(),
                                     *executor_->getCatalog());
-    if (cd->isVirtualCol) {
+    if (cd->isVirtualCol || (lazy_fetch_varlen_only_ && !cd->columnType.is_varlen())) {
       return false;
     }
+  } else if (lazy_fetch_varlen_only_) {
+    return false;
   }
   std::set<std::pair<int, int>> intersect;
   std::set_intersection(columns_to_fetch_.begin(),
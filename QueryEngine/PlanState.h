@@ -33,7 +33,9 @@ struct JoinInfo {
   std::vector<std::shared_ptr<Analyzer::BinOper>>
       equi_join_tautologies_;  // expressions we equi-join on are true by
                                // definition when using a hash join; we'll
-                               // fold them to true during code generation
+                               // fold them to true during code generation;
+                               // null for the band join tables, whose
+                               // qualifiers stay in the filter
   std::vector<std::shared_ptr<JoinHashTableInterface>> join_hash_tables_;
   std::unordered_set<size_t> sharded_range_table_indices_;
 };
@@ -44,10 +46,12 @@ struct PlanState {
   using DeletedColumnsMap = std::unordered_map<TableId, const ColumnDescriptor*>;
 
   PlanState(const bool allow_lazy_fetch,
+            const bool lazy_fetch_varlen_only,
             const std::vector<InputTableInfo>& query_infos,
             const DeletedColumnsMap& deleted_columns,
             const Executor* executor)
       : allow_lazy_fetch_(allow_lazy_fetch)
+      , lazy_fetch_varlen_only_(lazy_fetch_varlen_only)
       , join_info_({std::vector<std::shared_ptr<Analyzer::BinOper>>{}, {}})
       , deleted_columns_(deleted_columns)
       , query_infos_(query_infos)
@@ -59,6 +63,8 @@ struct PlanState {
   std::set<std::pair<TableId, ColumnId>> columns_to_fetch_;
   std::set<std::pair<TableId, ColumnId>> columns_to_not_fetch_;
   bool allow_lazy_fetch_;
+  // only the variable length columns of the catalog tables are fetched lazily
+  const bool lazy_fetch_varlen_only_;
   JoinInfo join_info_;
   const DeletedColumnsMap deleted_columns_;
   const std::vector<InputTableInfo>& query_infos_;
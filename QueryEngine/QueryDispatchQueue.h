@@ -16,21 +16,49 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <future>
+#include <map>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include "Logger/Logger.h"
 
 /**
  * QueryDispatchQueue maintains a list of pending queries and dispatches those queries as
- * Executors become available
+ * Executors become available.
+ *
+ * Pending queries are grouped into priority classes. System tasks are always dispatched
+ * first. Interactive and batch tasks share the workers in a weighted round robin, so that
+ * a long running batch query never delays more than `interactive_share` interactive
+ * queries and batch queries are never starved. Within a class, tasks are grouped by
+ * session key (typically the user name) and dispatched in weighted fair share order, so
+ * a single user submitting many queries cannot monopolize the executors.
  */
 class QueryDispatchQueue {
  public:
   using Task = std::packaged_task<void(size_t)>;
 
-  QueryDispatchQueue(const size_t parallel_executors_max) {
+  enum class Priority { System = 0, Interactive, Batch };
+  static constexpr size_t num_priority_classes = 3;
+
+  struct ClassStats {
+    Priority priority;
+    size_t queue_depth{0};
+    size_t dispatched_count{0};
+    double avg_wait_ms{0};
+    double max_wait_ms{0};
+  };
+
+  QueryDispatchQueue(const size_t parallel_executors_max,
+                     const size_t interactive_share = 4)
+      : interactive_share_(std::max(interactive_share, size_t(1))) {
     workers_.resize(parallel_executors_max);
     for (size_t i = 0; i < workers_.size(); i++) {
       // worker IDs are 1-indexed, leaving Executor 0 for non-dispatch queue worker tasks
@@ -41,9 +69,14 @@ class QueryDispatchQueue {
   /**
    * Submit a new task to the queue. Blocks until the task begins execution. The caller is
    * expected to maintain a copy of the shared_ptr which will be used to access results
-   * once the task runs.
+   * once the task runs. Tasks sharing a session key are fair-shared against other session
+   * keys of the same priority class in proportion to `session_weight`.
    */
-  void submit(std::shared_ptr<Task> task, const bool is_update_delete) {
+  void submit(std::shared_ptr<Task> task,
+              const bool is_update_delete,
+              const Priority priority = Priority::Interactive,
+              const std::string& session_key = "",
+              const double session_weight = 1.0) {
     if (workers_.size() == 1 && is_update_delete) {
       std::lock_guard<decltype(update_delete_mutex_)> update_delete_lock(
           update_delete_mutex_);
@@ -58,12 +91,58 @@ class QueryDispatchQueue {
     }
     std::unique_lock<decltype(queue_mutex_)> lock(queue_mutex_);
 
-    LOG(INFO) << "Dispatching query with " << queue_.size() << " queries in the queue.";
-    queue_.push(task);
+    LOG(INFO) << "Dispatching " << toString(priority) << " query with " << pendingCount()
+              << " queries in the queue.";
+    auto& priority_class = classes_[static_cast<size_t>(priority)];
+    auto& session_queue = priority_class.sessions[session_key];
+    if (session_queue.tasks.empty()) {
+      // a session (re)joining the class must not be credited for the time it was idle
+      session_queue.virtual_time =
+          std::max(session_queue.virtual_time, priority_class.virtual_clock);
+    }
+    session_queue.weight = session_weight > 0 ? session_weight : 1.0;
+    session_queue.tasks.push_back({task, std::chrono::steady_clock::now()});
     lock.unlock();
     cv_.notify_all();
   }
 
+  /**
+   * Returns a snapshot of queue depth and wait time for each priority class.
+   */
+  std::vector<ClassStats> getQueueStats() const {
+    std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
+    std::vector<ClassStats> ret;
+    for (size_t i = 0; i < num_priority_classes; i++) {
+      const auto& priority_class = classes_[i];
+      ClassStats stats;
+      stats.priority = static_cast<Priority>(i);
+      for (const auto& session : priority_class.sessions) {
+        stats.queue_depth += session.second.tasks.size();
+      }
+      stats.dispatched_count = priority_class.dispatched_count;
+      stats.avg_wait_ms = priority_class.dispatched_count
+                              ? priority_class.total_wait_ms /
+                                    static_cast<double>(priority_class.dispatched_count)
+                              : 0;
+      stats.max_wait_ms = priority_class.max_wait_ms;
+      ret.push_back(stats);
+    }
+    return ret;
+  }
+
+  static std::string toString(const Priority priority) {
+    switch (priority) {
+      case Priority::System:
+        return "SYSTEM";
+      case Priority::Interactive:
+        return "INTERACTIVE";
+      case Priority::Batch:
+        return "BATCH";
+    }
+    UNREACHABLE();
+    return "";
+  }
+
   ~QueryDispatchQueue() {
     {
       std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
@@ -76,22 +155,108 @@ class QueryDispatchQueue {
   }
 
  private:
+  struct PendingTask {
+    std::shared_ptr<Task> task;
+    std::chrono::steady_clock::time_point enqueue_time;
+  };
+
+  struct SessionQueue {
+    std::deque<PendingTask> tasks;
+    double virtual_time{0};
+    double weight{1.0};
+  };
+
+  struct PriorityClass {
+    std::map<std::string, SessionQueue> sessions;
+    double virtual_clock{0};
+    size_t dispatched_count{0};
+    double total_wait_ms{0};
+    double max_wait_ms{0};
+
+    bool empty() const { return sessions.empty(); }
+
+    // Pops the head task of the session with the smallest virtual time. Must be called
+    // with the queue mutex held on a non-empty class.
+    PendingTask pop() {
+      CHECK(!sessions.empty());
+      auto next = std::min_element(sessions.begin(),
+                                   sessions.end(),
+                                   [](const auto& lhs, const auto& rhs) {
+                                     return lhs.second.virtual_time <
+                                            rhs.second.virtual_time;
+                                   });
+      auto& session_queue = next->second;
+      CHECK(!session_queue.tasks.empty());
+      auto pending_task = session_queue.tasks.front();
+      session_queue.tasks.pop_front();
+      virtual_clock = session_queue.virtual_time;
+      session_queue.virtual_time += 1.0 / session_queue.weight;
+      if (session_queue.tasks.empty()) {
+        sessions.erase(next);
+      }
+
+      const auto wait_ms = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - pending_task.enqueue_time)
+                               .count();
+      dispatched_count++;
+      total_wait_ms += wait_ms;
+      max_wait_ms = std::max(max_wait_ms, wait_ms);
+      return pending_task;
+    }
+  };
+
+  size_t pendingCount() const {
+    size_t count{0};
+    for (const auto& priority_class : classes_) {
+      for (const auto& session : priority_class.sessions) {
+        count += session.second.tasks.size();
+      }
+    }
+    return count;
+  }
+
+  bool hasPendingTasks() const {
+    return std::any_of(classes_.begin(), classes_.end(), [](const auto& priority_class) {
+      return !priority_class.empty();
+    });
+  }
+
+  // Must be called with the queue mutex held while at least one task is pending.
+  PendingTask popNextTask() {
+    auto& system_class = classes_[static_cast<size_t>(Priority::System)];
+    if (!system_class.empty()) {
+      return system_class.pop();
+    }
+    auto& interactive_class = classes_[static_cast<size_t>(Priority::Interactive)];
+    auto& batch_class = classes_[static_cast<size_t>(Priority::Batch)];
+    if (!batch_class.empty() &&
+        (interactive_class.empty() || interactive_run_ >= interactive_share_)) {
+      interactive_run_ = 0;
+      return batch_class.pop();
+    }
+    CHECK(!interactive_class.empty());
+    if (!batch_class.empty()) {
+      // only count interactive dispatches which actually delayed a batch query
+      interactive_run_++;
+    }
+    return interactive_class.pop();
+  }
+
   void worker(const size_t worker_idx) {
     std::unique_lock<std::mutex> lock(queue_mutex_);
     while (true) {
-      cv_.wait(lock, [this] { return !queue_.empty() || threads_should_exit_; });
+      cv_.wait(lock, [this] { return hasPendingTasks() || threads_should_exit_; });
 
       if (threads_should_exit_) {
         return;
       }
 
-      if (!queue_.empty()) {
-        auto task = queue_.front();
-        queue_.pop();
+      if (hasPendingTasks()) {
+        auto task = popNextTask().task;
 
         LOG(INFO) << "Worker " << worker_idx
                   << " running query and returning control. There are now "
-                  << queue_.size() << " queries in the queue.";
+                  << pendingCount() << " queries in the queue.";
         // allow other threads to pick up tasks
         lock.unlock();
         CHECK(task);
@@ -103,12 +268,14 @@ class QueryDispatchQueue {
     }
   }
 
-  std::mutex queue_mutex_;
+  mutable std::mutex queue_mutex_;
   std::condition_variable cv_;
 
   std::mutex update_delete_mutex_;
 
   bool threads_should_exit_{false};
-  std::queue<std::shared_ptr<Task>> queue_;
+  const size_t interactive_share_;
+  size_t interactive_run_{0};
+  std::array<PriorityClass, num_priority_classes> classes_;
   std::vector<std::thread> workers_;
 };
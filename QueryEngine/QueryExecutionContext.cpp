@@ -16,16 +16,22 @@
 
 #include "QueryExecutionContext.h"
 #include "AggregateUtils.h"
+#include "CudaMgr/CudaMgr.h"
 #include "Descriptors/QueryMemoryDescriptor.h"
 #include "Execute.h"
 #include "GpuInitGroups.h"
 #include "InPlaceSort.h"
+#include "MultiGpuReduction.h"
 #include "QueryMemoryInitializer.h"
 #include "RelAlgExecutionUnit.h"
 #include "ResultSet.h"
+#include "ResultSetBufferAccessors.h"
 #include "SpeculativeTopN.h"
 #include "StreamingTopN.h"
 
+extern bool g_enable_gpu_kernel_streams;
+extern bool g_enable_gpu_launch_graphs;
+
 QueryExecutionContext::QueryExecutionContext(
     const RelAlgExecutionUnit& ra_exe_unit,
     const QueryMemoryDescriptor& query_mem_desc,
@@ -128,6 +134,41 @@ int64_t QueryExecutionContext::getAggInitValForIndex(const size_t index) const {
   return query_buffers_->getAggInitValForIndex(index);
 }
 
+namespace {
+
+// Fills the key slots of the groups of a packed key from the packed key in their first
+// slot, the results are laid out as if the key had not been packed then.
+void unpack_group_keys(ResultSet& rows) {
+  const auto& query_mem_desc = rows.getQueryMemDesc();
+  const auto& components = query_mem_desc.getPackedKeyComponents();
+  CHECK_EQ(components.size(), query_mem_desc.getGroupbyColCount());
+  const auto key_width = query_mem_desc.getEffectiveKeyWidth();
+  const int64_t empty_key = key_width == sizeof(int32_t) ? EMPTY_KEY_32 : EMPTY_KEY_64;
+  auto buff = rows.getStorage()->getUnderlyingBuffer();
+  for (size_t entry_idx = 0; entry_idx < query_mem_desc.getEntryCount(); ++entry_idx) {
+    const auto row_ptr = row_ptr_rowwise(buff, query_mem_desc, entry_idx);
+    const auto packed_key = read_int_from_buff(row_ptr, key_width);
+    if (packed_key == empty_key) {
+      continue;
+    }
+    for (size_t key_idx = 0; key_idx < components.size(); ++key_idx) {
+      const auto& component = components[key_idx];
+      const int64_t mask = (int64_t(1) << component.bit_count) - 1;
+      auto val = ((packed_key >> component.shift) & mask) + component.min;
+      if (component.has_nulls && val == component.null_key) {
+        val = component.null_val;
+      }
+      if (key_width == sizeof(int32_t)) {
+        reinterpret_cast<int32_t*>(row_ptr)[key_idx] = static_cast<int32_t>(val);
+      } else {
+        reinterpret_cast<int64_t*>(row_ptr)[key_idx] = val;
+      }
+    }
+  }
+}
+
+}  // namespace
+
 ResultSetPtr QueryExecutionContext::getRowSet(
     const RelAlgExecutionUnit& ra_exe_unit,
     const QueryMemoryDescriptor& query_mem_desc) const {
@@ -137,7 +178,11 @@ ResultSetPtr QueryExecutionContext::getRowSet(
   const auto group_by_buffers_size = query_buffers_->getNumBuffers();
   if (device_type_ == ExecutorDeviceType::CPU) {
     CHECK_EQ(size_t(1), group_by_buffers_size);
-    return groupBufferToResults(0);
+    auto rows = groupBufferToResults(0);
+    if (query_mem_desc_.hasPackedKey()) {
+      unpack_group_keys(*rows);
+    }
+    return rows;
   }
   size_t step{query_mem_desc_.threadsShareMemory() ? executor_->blockSize() : 1};
   for (size_t i = 0; i < group_by_buffers_size; i += step) {
@@ -158,6 +203,79 @@ ResultSetPtr QueryExecutionContext::groupBufferToResults(const size_t i) const {
 #ifdef HAVE_CUDA
 namespace {
 
+// The stream a kernel is launched on, the default stream unless there is a stream per
+// kernel or the launches are captured. The copies to the device keep going through the
+// default stream, which does not wait for the kernel: another kernel can upload its
+// columns in the meantime.
+class KernelStream {
+ public:
+  explicit KernelStream(const bool capture_launches) {
+    if (g_enable_gpu_kernel_streams || capture_launches) {
+      checkCudaErrors(cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING));
+    }
+    if (capture_launches) {
+      // the allocations and copies on the default stream still run when issued
+      checkCudaErrors(cuStreamBeginCapture(stream_, CU_STREAM_CAPTURE_MODE_RELAXED));
+      capturing_ = true;
+    }
+  }
+
+  ~KernelStream() {
+    if (capturing_) {
+      CUgraph graph{nullptr};
+      cuStreamEndCapture(stream_, &graph);
+      if (graph) {
+        cuGraphDestroy(graph);
+      }
+    }
+    if (stream_) {
+      cuStreamSynchronize(stream_);
+      cuStreamDestroy(stream_);
+    }
+  }
+
+  CUstream get() const { return stream_; }
+
+  // Launches the captured launches as a graph of the kernel, once the default stream is
+  // done with the copies they need. The graphs of the same layout are instantiated once.
+  void launchCaptured(const GpuCompilationContext* cu_functions,
+                      const int device_id,
+                      const std::vector<size_t>& layout) {
+    if (!capturing_) {
+      return;
+    }
+    CUgraph graph;
+    capturing_ = false;
+    checkCudaErrors(cuStreamEndCapture(stream_, &graph));
+    waitForDefaultStream();
+    cu_functions->launchGraph(device_id, layout, graph, stream_);
+    checkCudaErrors(cuGraphDestroy(graph));
+  }
+
+  // The kernel must see the copies its parameters and buffers went through so far.
+  void waitForDefaultStream() const {
+    if (!stream_ || capturing_) {
+      return;
+    }
+    CUevent copied;
+    checkCudaErrors(cuEventCreate(&copied, CU_EVENT_DISABLE_TIMING));
+    checkCudaErrors(cuEventRecord(copied, 0));
+    checkCudaErrors(cuStreamWaitEvent(stream_, copied, 0));
+    checkCudaErrors(cuEventDestroy(copied));
+  }
+
+  // The results are copied back through the default stream, once the kernel is done.
+  void synchronize() const {
+    if (stream_) {
+      checkCudaErrors(cuStreamSynchronize(stream_));
+    }
+  }
+
+ private:
+  CUstream stream_{nullptr};
+  bool capturing_{false};
+};
+
 int32_t aggregate_error_codes(const std::vector<int32_t>& error_codes) {
   // Check overflow / division by zero / interrupt first
   for (const auto err : error_codes) {
@@ -228,6 +346,21 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
   if (g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt) {
     cuEventRecord(start0, 0);
   }
+  // The launches are captured and replayed as a graph cached with the compiled kernel,
+  // unless they have to be timed or the kernel renders.
+  const bool capture_launches = g_enable_gpu_launch_graphs && !render_allocator_map &&
+                                !g_enable_dynamic_watchdog &&
+                                !g_enable_runtime_query_interrupt &&
+                                !g_enable_gpu_kernel_timing;
+  const std::vector<size_t> launch_layout{grid_size_x,
+                                          block_size_x,
+                                          shared_memory_size,
+                                          num_fragments,
+                                          num_tables,
+                                          hoist_literals,
+                                          is_group_by,
+                                          query_buffers_->getGroupByBuffersSize()};
+  KernelStream kernel_stream(capture_launches);
 
   if (g_enable_dynamic_watchdog) {
     initializeDynamicWatchdog(native_code.second, device_id);
@@ -275,7 +408,10 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
                                                             executor_->warpSize(),
                                                             can_sort_on_gpu,
                                                             output_columnar_,
-                                                            render_allocator);
+                                                            render_allocator,
+                                                            capture_launches
+                                                                ? kernel_stream.get()
+                                                                : nullptr);
     if (ra_exe_unit.use_bump_allocator) {
       const auto max_matched = static_cast<int32_t>(gpu_group_by_buffers.entry_count);
       copy_to_gpu(data_mgr,
@@ -299,38 +435,44 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
       VLOG(1) << "Device " << std::to_string(device_id)
               << ": launchGpuCode: group-by prepare: " << std::to_string(milliseconds0)
               << " ms";
-      cuEventRecord(start1, 0);
-    }
-
-    if (hoist_literals) {
-      checkCudaErrors(cuLaunchKernel(cu_func,
-                                     grid_size_x,
-                                     grid_size_y,
-                                     grid_size_z,
-                                     block_size_x,
-                                     block_size_y,
-                                     block_size_z,
-                                     shared_memory_size,
-                                     nullptr,
-                                     &param_ptrs[0],
-                                     nullptr));
-    } else {
-      param_ptrs.erase(param_ptrs.begin() + LITERALS);  // TODO(alex): remove
-      checkCudaErrors(cuLaunchKernel(cu_func,
-                                     grid_size_x,
-                                     grid_size_y,
-                                     grid_size_z,
-                                     block_size_x,
-                                     block_size_y,
-                                     block_size_z,
-                                     shared_memory_size,
-                                     nullptr,
-                                     &param_ptrs[0],
-                                     nullptr));
+      cuEventRecord(start1, kernel_stream.get());
+    }
+
+    kernel_stream.waitForDefaultStream();
+    {
+      CudaMgr_Namespace::GpuWorkTimer kernel_timer(CudaMgr_Namespace::GpuWorkType::Kernel,
+                                                   kernel_stream.get());
+      if (hoist_literals) {
+        checkCudaErrors(cuLaunchKernel(cu_func,
+                                       grid_size_x,
+                                       grid_size_y,
+                                       grid_size_z,
+                                       block_size_x,
+                                       block_size_y,
+                                       block_size_z,
+                                       shared_memory_size,
+                                       kernel_stream.get(),
+                                       &param_ptrs[0],
+                                       nullptr));
+      } else {
+        param_ptrs.erase(param_ptrs.begin() + LITERALS);  // TODO(alex): remove
+        checkCudaErrors(cuLaunchKernel(cu_func,
+                                       grid_size_x,
+                                       grid_size_y,
+                                       grid_size_z,
+                                       block_size_x,
+                                       block_size_y,
+                                       block_size_z,
+                                       shared_memory_size,
+                                       kernel_stream.get(),
+                                       &param_ptrs[0],
+                                       nullptr));
+      }
+      kernel_stream.launchCaptured(cu_functions, device_id, launch_layout);
     }
     if (g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt) {
       executor_->registerActiveModule(native_code.second, device_id);
-      cuEventRecord(stop1, 0);
+      cuEventRecord(stop1, kernel_stream.get());
       cuEventSynchronize(stop1);
       executor_->unregisterActiveModule(native_code.second, device_id);
       float milliseconds1 = 0;
@@ -340,6 +482,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
               << std::to_string(milliseconds1) << " ms";
       cuEventRecord(start2, 0);
     }
+    kernel_stream.synchronize();
 
     gpu_allocator_->copyFromDevice(reinterpret_cast<int8_t*>(error_codes.data()),
                                    reinterpret_cast<int8_t*>(err_desc),
@@ -408,6 +551,9 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
                   num_allocated_rows);
             }
           }
+        } else if (multi_gpu_reduction_) {
+          multi_gpu_reduction_->reduce(
+              reinterpret_cast<const int8_t*>(gpu_group_by_buffers.second), device_id);
         } else {
           query_buffers_->copyGroupByBuffersFromGpu(
               data_mgr,
@@ -469,39 +615,45 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
       cuEventElapsedTime(&milliseconds0, start0, stop0);
       VLOG(1) << "Device " << std::to_string(device_id)
               << ": launchGpuCode: prepare: " << std::to_string(milliseconds0) << " ms";
-      cuEventRecord(start1, 0);
-    }
-
-    if (hoist_literals) {
-      checkCudaErrors(cuLaunchKernel(cu_func,
-                                     grid_size_x,
-                                     grid_size_y,
-                                     grid_size_z,
-                                     block_size_x,
-                                     block_size_y,
-                                     block_size_z,
-                                     shared_memory_size,
-                                     nullptr,
-                                     &param_ptrs[0],
-                                     nullptr));
-    } else {
-      param_ptrs.erase(param_ptrs.begin() + LITERALS);  // TODO(alex): remove
-      checkCudaErrors(cuLaunchKernel(cu_func,
-                                     grid_size_x,
-                                     grid_size_y,
-                                     grid_size_z,
-                                     block_size_x,
-                                     block_size_y,
-                                     block_size_z,
-                                     shared_memory_size,
-                                     nullptr,
-                                     &param_ptrs[0],
-                                     nullptr));
+      cuEventRecord(start1, kernel_stream.get());
+    }
+
+    kernel_stream.waitForDefaultStream();
+    {
+      CudaMgr_Namespace::GpuWorkTimer kernel_timer(CudaMgr_Namespace::GpuWorkType::Kernel,
+                                                   kernel_stream.get());
+      if (hoist_literals) {
+        checkCudaErrors(cuLaunchKernel(cu_func,
+                                       grid_size_x,
+                                       grid_size_y,
+                                       grid_size_z,
+                                       block_size_x,
+                                       block_size_y,
+                                       block_size_z,
+                                       shared_memory_size,
+                                       kernel_stream.get(),
+                                       &param_ptrs[0],
+                                       nullptr));
+      } else {
+        param_ptrs.erase(param_ptrs.begin() + LITERALS);  // TODO(alex): remove
+        checkCudaErrors(cuLaunchKernel(cu_func,
+                                       grid_size_x,
+                                       grid_size_y,
+                                       grid_size_z,
+                                       block_size_x,
+                                       block_size_y,
+                                       block_size_z,
+                                       shared_memory_size,
+                                       kernel_stream.get(),
+                                       &param_ptrs[0],
+                                       nullptr));
+      }
+      kernel_stream.launchCaptured(cu_functions, device_id, launch_layout);
     }
 
     if (g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt) {
       executor_->registerActiveModule(native_code.second, device_id);
-      cuEventRecord(stop1, 0);
+      cuEventRecord(stop1, kernel_stream.get());
       cuEventSynchronize(stop1);
       executor_->unregisterActiveModule(native_code.second, device_id);
       float milliseconds1 = 0;
@@ -511,6 +663,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
               << " ms";
       cuEventRecord(start2, 0);
     }
+    kernel_stream.synchronize();
 
     copy_from_gpu(data_mgr,
                   &error_codes[0],
@@ -614,9 +767,8 @@ std::vector<int64_t*> QueryExecutionContext::launchCpuCode(
     flatened_frag_offsets.insert(
         flatened_frag_offsets.end(), offsets.begin(), offsets.end());
   }
-  int64_t rowid_lookup_num_rows{*error_code ? *error_code + 1 : 0};
-  auto num_rows_ptr =
-      rowid_lookup_num_rows ? &rowid_lookup_num_rows : &flatened_num_rows[0];
+  // the scan starts at row *error_code, the kernel bounds the outer row count for it
+  auto num_rows_ptr = &flatened_num_rows[0];
   int32_t total_matched_init{0};
 
   std::vector<int64_t> cmpt_val_buff;
@@ -717,10 +869,6 @@ std::vector<int64_t*> QueryExecutionContext::launchCpuCode(
     return {};
   }
 
-  if (rowid_lookup_num_rows && *error_code < 0) {
-    *error_code = 0;
-  }
-
   if (query_mem_desc_.useStreamingTopN()) {
     query_buffers_->applyStreamingTopNOffsetCpu(query_mem_desc_, ra_exe_unit);
   }
@@ -30,6 +30,7 @@
 
 class GpuCompilationContext;
 class CpuCompilationContext;
+class MultiGpuReduction;
 
 struct RelAlgExecutionUnit;
 class QueryMemoryDescriptor;
@@ -91,6 +92,12 @@ class QueryExecutionContext : boost::noncopyable {
 
   int64_t getAggInitValForIndex(const size_t index) const;
 
+  // The group by buffer is reduced on the GPU by `multi_gpu_reduction` rather than
+  // copied to the host.
+  void setMultiGpuReduction(MultiGpuReduction* multi_gpu_reduction) {
+    multi_gpu_reduction_ = multi_gpu_reduction;
+  }
+
  private:
 #ifdef HAVE_CUDA
   enum {
@@ -142,6 +149,7 @@ class QueryExecutionContext : boost::noncopyable {
   const bool output_columnar_;
   std::unique_ptr<QueryMemoryInitializer> query_buffers_;
   mutable std::unique_ptr<ResultSet> estimator_result_set_;
+  MultiGpuReduction* multi_gpu_reduction_{nullptr};
 
   friend class Executor;
 };
@@ -17,8 +17,39 @@
 #ifndef OMNISCI_QUERYHINT_H
 #define OMNISCI_QUERYHINT_H
 
+#include <cstddef>
+#include <optional>
+
+/**
+ * Hints given in the hint comment of a query, e.g. "cpu_mode, max_kernel_parallelism(4)",
+ * which override the server settings for the query:
+ *
+ * - cpu_mode / gpu_mode: run all the steps on CPU / on GPU if the server has GPUs,
+ *   overriding the session and the device cost model
+ * - hash_join: never fall back to loop joins
+ * - loop_join: join with nested loops rather than hash tables
+ * - columnar_output / rowwise_output: layout of the output buffers
+ * - max_kernel_parallelism(n): run at most n kernels of a step at a time
+ * - watchdog_off: disable the watchdog
+ * - dynamic_watchdog(ms): time limit of the dynamic watchdog, 0 disables it
+ * - gpu_input_mem_limit(fraction): fraction of the GPU memory the inputs may take before
+ *   running on CPU
+ * - disable_lazy_fetch: fetch all the projected columns up front
+ * - approximate(error) / approximate: compute non grouped aggregates over a sample of
+ *   the fragments which bounds their relative error, 0.01 if not given
+ */
 struct QueryHint {
   bool cpu_mode{false};
+  bool gpu_mode{false};
+  bool hash_join{false};
+  bool loop_join{false};
+  std::optional<bool> columnar_output;
+  size_t max_kernel_parallelism{0};
+  bool watchdog_off{false};
+  std::optional<unsigned> dynamic_watchdog_time_limit;
+  std::optional<double> gpu_input_mem_limit;
+  bool disable_lazy_fetch{false};
+  std::optional<double> approximate_error;
 };
 
 #endif  // OMNISCI_QUERYHINT_H
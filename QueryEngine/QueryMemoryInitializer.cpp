@@ -16,6 +16,7 @@
 
 #include "QueryMemoryInitializer.h"
 
+#include "CudaMgr/CudaMgr.h"
 #include "Execute.h"
 #include "GpuInitGroups.h"
 #include "GpuMemUtils.h"
@@ -69,7 +70,7 @@ int64_t* alloc_group_by_buffer(const size_t numBytes,
     auto render_allocator_ptr = render_allocator_map->getRenderAllocator(gpu_idx);
     return reinterpret_cast<int64_t*>(render_allocator_ptr->alloc(numBytes));
   } else {
-    return reinterpret_cast<int64_t*>(mem_owner->allocate(numBytes));
+    return reinterpret_cast<int64_t*>(mem_owner->allocateOutputBuffer(numBytes));
   }
 }
 
@@ -191,6 +192,7 @@ QueryMemoryInitializer::QueryMemoryInitializer(
 
   if (render_allocator_map || !query_mem_desc.isGroupBy()) {
     allocateCountDistinctBuffers(query_mem_desc, false, executor);
+    allocateTDigests(query_mem_desc, false, executor);
     if (render_info && render_info->useCudaBuffers()) {
       return;
     }
@@ -223,8 +225,8 @@ QueryMemoryInitializer::QueryMemoryInitializer(
   const auto group_buffers_count = !query_mem_desc.isGroupBy() ? 1 : num_buffers_;
   int64_t* group_by_buffer_template{nullptr};
   if (!query_mem_desc.lazyInitGroups(device_type) && group_buffers_count > 1) {
-    group_by_buffer_template =
-        reinterpret_cast<int64_t*>(row_set_mem_owner_->allocate(group_buffer_size));
+    group_by_buffer_template = reinterpret_cast<int64_t*>(
+        row_set_mem_owner_->allocateOutputBuffer(group_buffer_size));
     initGroupByBuffer(group_by_buffer_template,
                       ra_exe_unit,
                       query_mem_desc,
@@ -408,7 +410,9 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
   const size_t row_size{query_mem_desc.getRowSize()};
   const size_t col_base_off{query_mem_desc.getColOffInBytes(0)};
 
-  auto agg_bitmap_size = allocateCountDistinctBuffers(query_mem_desc, true, executor);
+  const auto count_distinct_descs =
+      allocateCountDistinctBuffers(query_mem_desc, true, executor);
+  const auto quantile_params = allocateTDigests(query_mem_desc, true, executor);
   auto buffer_ptr = reinterpret_cast<int8_t*>(groups_buffer);
 
   const auto query_mem_desc_fixedup =
@@ -424,7 +428,8 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
                          &buffer_ptr[col_base_off],
                          bin,
                          init_vals,
-                         agg_bitmap_size);
+                         count_distinct_descs,
+                         quantile_params);
       }
     }
     return;
@@ -438,7 +443,8 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
                      &buffer_ptr[col_base_off],
                      bin,
                      init_vals,
-                     agg_bitmap_size);
+                     count_distinct_descs,
+                     quantile_params);
   }
 }
 
@@ -463,7 +469,7 @@ void QueryMemoryInitializer::initColumnarGroups(
   CHECK(groups_buffer);
   for (const auto target_expr : executor->plan_state_->target_exprs_) {
     const auto agg_info = get_target_info(target_expr, g_bigint_count);
-    CHECK(!is_distinct_target(agg_info));
+    CHECK(!is_distinct_target(agg_info) && !is_approx_quantile_target(agg_info));
   }
   const int32_t agg_col_count = query_mem_desc.getSlotCount();
   auto buffer_ptr = reinterpret_cast<int8_t*>(groups_buffer);
@@ -519,18 +525,26 @@ void QueryMemoryInitializer::initColumnarGroups(
   }
 }
 
-void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query_mem_desc,
-                                              int8_t* row_ptr,
-                                              const size_t bin,
-                                              const std::vector<int64_t>& init_vals,
-                                              const std::vector<int64_t>& bitmap_sizes) {
+void QueryMemoryInitializer::initColumnPerRow(
+    const QueryMemoryDescriptor& query_mem_desc,
+    int8_t* row_ptr,
+    const size_t bin,
+    const std::vector<int64_t>& init_vals,
+    const std::vector<const CountDistinctDescriptor*>& count_distinct_descs,
+    const std::vector<QuantileParam>& quantile_params) {
   int8_t* col_ptr = row_ptr;
   size_t init_vec_idx = 0;
   for (size_t col_idx = 0; col_idx < query_mem_desc.getSlotCount();
        col_ptr += query_mem_desc.getNextColOffInBytes(col_ptr, bin, col_idx++)) {
-    const int64_t bm_sz{bitmap_sizes[col_idx]};
+    const auto count_distinct_desc = count_distinct_descs[col_idx];
     int64_t init_val{0};
-    if (!bm_sz || !query_mem_desc.isGroupBy()) {
+    if (quantile_params[col_idx] && query_mem_desc.isGroupBy()) {
+      CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
+               sizeof(int64_t));
+      init_val = reinterpret_cast<int64_t>(
+          row_set_mem_owner_->addTDigest(*quantile_params[col_idx]));
+      ++init_vec_idx;
+    } else if (!count_distinct_desc || !query_mem_desc.isGroupBy()) {
       if (query_mem_desc.getPaddedSlotWidthBytes(col_idx) > 0) {
         CHECK_LT(init_vec_idx, init_vals.size());
         init_val = init_vals[init_vec_idx++];
@@ -538,8 +552,7 @@ void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query
     } else {
       CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
                sizeof(int64_t));
-      init_val =
-          bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz) : allocateCountDistinctSet();
+      init_val = allocateCountDistinctBuffer(*count_distinct_desc);
       ++init_vec_idx;
     }
     switch (query_mem_desc.getPaddedSlotWidthBytes(col_idx)) {
@@ -593,14 +606,16 @@ void QueryMemoryInitializer::allocateCountDistinctGpuMem(
       row_set_mem_owner_->allocate(count_distinct_bitmap_mem_bytes_);
 }
 
-// deferred is true for group by queries; initGroups will allocate a bitmap
-// for each group slot
-std::vector<int64_t> QueryMemoryInitializer::allocateCountDistinctBuffers(
+// deferred is true for group by queries; initGroups will allocate a count distinct
+// buffer for each group slot, using the descriptors returned for the slots
+std::vector<const CountDistinctDescriptor*>
+QueryMemoryInitializer::allocateCountDistinctBuffers(
     const QueryMemoryDescriptor& query_mem_desc,
     const bool deferred,
     const Executor* executor) {
   const size_t agg_col_count{query_mem_desc.getSlotCount()};
-  std::vector<int64_t> agg_bitmap_size(deferred ? agg_col_count : 0);
+  std::vector<const CountDistinctDescriptor*> count_distinct_descs(
+      deferred ? agg_col_count : 0);
 
   CHECK_GE(agg_col_count, executor->plan_state_->target_exprs_.size());
   for (size_t target_idx = 0; target_idx < executor->plan_state_->target_exprs_.size();
@@ -620,25 +635,34 @@ std::vector<int64_t> QueryMemoryInitializer::allocateCountDistinctBuffers(
       const auto& count_distinct_desc =
           query_mem_desc.getCountDistinctDescriptor(target_idx);
       CHECK(count_distinct_desc.impl_type_ != CountDistinctImplType::Invalid);
-      if (count_distinct_desc.impl_type_ == CountDistinctImplType::Bitmap) {
-        const auto bitmap_byte_sz = count_distinct_desc.bitmapPaddedSizeBytes();
-        if (deferred) {
-          agg_bitmap_size[agg_col_idx] = bitmap_byte_sz;
-        } else {
-          init_agg_vals_[agg_col_idx] = allocateCountDistinctBitmap(bitmap_byte_sz);
-        }
+      if (deferred) {
+        count_distinct_descs[agg_col_idx] = &count_distinct_desc;
       } else {
-        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
-        if (deferred) {
-          agg_bitmap_size[agg_col_idx] = -1;
-        } else {
-          init_agg_vals_[agg_col_idx] = allocateCountDistinctSet();
-        }
+        init_agg_vals_[agg_col_idx] = allocateCountDistinctBuffer(count_distinct_desc);
       }
     }
   }
 
-  return agg_bitmap_size;
+  return count_distinct_descs;
+}
+
+int64_t QueryMemoryInitializer::allocateCountDistinctBuffer(
+    const CountDistinctDescriptor& count_distinct_desc) {
+  switch (count_distinct_desc.impl_type_) {
+    case CountDistinctImplType::Bitmap:
+      return allocateCountDistinctBitmap(count_distinct_desc.bitmapPaddedSizeBytes());
+    case CountDistinctImplType::StdSet:
+      return allocateCountDistinctSet();
+    case CountDistinctImplType::SparseHll:
+      CHECK_GT(count_distinct_desc.bitmap_sz_bits, 0);
+      return reinterpret_cast<int64_t>(
+          row_set_mem_owner_->addSparseHll(count_distinct_desc.bitmap_sz_bits));
+    case CountDistinctImplType::RoaringBitmap:
+      return reinterpret_cast<int64_t>(row_set_mem_owner_->addRoaringBitmap());
+    default:
+      CHECK(false);
+  }
+  return 0;
 }
 
 int64_t QueryMemoryInitializer::allocateCountDistinctBitmap(const size_t bitmap_byte_sz) {
@@ -660,6 +684,40 @@ int64_t QueryMemoryInitializer::allocateCountDistinctSet() {
   return reinterpret_cast<int64_t>(count_distinct_set);
 }
 
+// deferred is true for group by queries; initGroups will allocate a t-digest
+// for each group slot
+std::vector<QueryMemoryInitializer::QuantileParam>
+QueryMemoryInitializer::allocateTDigests(const QueryMemoryDescriptor& query_mem_desc,
+                                         const bool deferred,
+                                         const Executor* executor) {
+  const size_t slot_count = query_mem_desc.getSlotCount();
+  const size_t ntargets = executor->plan_state_->target_exprs_.size();
+  CHECK_GE(slot_count, ntargets);
+  std::vector<QuantileParam> quantile_params(deferred ? slot_count : 0);
+
+  for (size_t target_idx = 0; target_idx < ntargets; ++target_idx) {
+    const auto target_expr = executor->plan_state_->target_exprs_[target_idx];
+    const auto agg_info = get_target_info(target_expr, g_bigint_count);
+    if (!is_approx_quantile_target(agg_info)) {
+      continue;
+    }
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+    CHECK(agg_expr && agg_expr->get_arg1());
+    const auto q = agg_expr->get_arg1()->get_constval().doubleval;
+    const auto slot_idx = query_mem_desc.getSlotIndexForSingleSlotCol(target_idx);
+    CHECK_LT(static_cast<size_t>(slot_idx), slot_count);
+    CHECK_EQ(static_cast<size_t>(query_mem_desc.getLogicalSlotWidthBytes(slot_idx)),
+             sizeof(int64_t));
+    if (deferred) {
+      quantile_params[slot_idx] = q;
+    } else {
+      init_agg_vals_[slot_idx] =
+          reinterpret_cast<int64_t>(row_set_mem_owner_->addTDigest(q));
+    }
+  }
+  return quantile_params;
+}
+
 #ifdef HAVE_CUDA
 GpuGroupByBuffers QueryMemoryInitializer::prepareTopNHeapsDevBuffer(
     const QueryMemoryDescriptor& query_mem_desc,
@@ -667,7 +725,8 @@ GpuGroupByBuffers QueryMemoryInitializer::prepareTopNHeapsDevBuffer(
     const size_t n,
     const int device_id,
     const unsigned block_size_x,
-    const unsigned grid_size_x) {
+    const unsigned grid_size_x,
+    const CUstream init_stream) {
   CHECK(device_allocator_);
   const auto thread_count = block_size_x * grid_size_x;
   const auto total_buff_size =
@@ -696,6 +755,8 @@ GpuGroupByBuffers QueryMemoryInitializer::prepareTopNHeapsDevBuffer(
       (unsigned char)-1,
       thread_count * n * sizeof(int64_t));
 
+  CudaMgr_Namespace::GpuWorkTimer init_timer(CudaMgr_Namespace::GpuWorkType::Init,
+                                             init_stream);
   init_group_by_buffer_on_device(
       reinterpret_cast<int64_t*>(
           dev_buffer + streaming_top_n::get_rows_offset_of_heaps(n, thread_count)),
@@ -707,7 +768,8 @@ GpuGroupByBuffers QueryMemoryInitializer::prepareTopNHeapsDevBuffer(
       query_mem_desc.hasKeylessHash(),
       1,
       block_size_x,
-      grid_size_x);
+      grid_size_x,
+      init_stream);
 
   return {reinterpret_cast<CUdeviceptr>(dev_ptr), dev_buffer};
 }
@@ -723,7 +785,8 @@ GpuGroupByBuffers QueryMemoryInitializer::createAndInitializeGroupByBufferGpu(
     const int8_t warp_size,
     const bool can_sort_on_gpu,
     const bool output_columnar,
-    RenderAllocator* render_allocator) {
+    RenderAllocator* render_allocator,
+    const CUstream init_stream) {
   if (query_mem_desc.useStreamingTopN()) {
     if (render_allocator) {
       throw StreamingTopNNotSupportedInRenderQuery();
@@ -731,8 +794,13 @@ GpuGroupByBuffers QueryMemoryInitializer::createAndInitializeGroupByBufferGpu(
     const auto n = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
     CHECK(!output_columnar);
 
-    return prepareTopNHeapsDevBuffer(
-        query_mem_desc, init_agg_vals_dev_ptr, n, device_id, block_size_x, grid_size_x);
+    return prepareTopNHeapsDevBuffer(query_mem_desc,
+                                     init_agg_vals_dev_ptr,
+                                     n,
+                                     device_id,
+                                     block_size_x,
+                                     grid_size_x,
+                                     init_stream);
   }
 
   auto dev_group_by_buffers = create_dev_group_by_buffers(device_allocator_,
@@ -772,6 +840,8 @@ GpuGroupByBuffers QueryMemoryInitializer::createAndInitializeGroupByBufferGpu(
     const int8_t warp_count =
         query_mem_desc.interleavedBins(ExecutorDeviceType::GPU) ? warp_size : 1;
     for (size_t i = 0; i < getGroupByBuffersSize(); i += step) {
+      CudaMgr_Namespace::GpuWorkTimer init_timer(CudaMgr_Namespace::GpuWorkType::Init,
+                                                 init_stream);
       if (output_columnar) {
         init_columnar_group_by_buffer_on_device(
             reinterpret_cast<int64_t*>(group_by_dev_buffer),
@@ -784,7 +854,8 @@ GpuGroupByBuffers QueryMemoryInitializer::createAndInitializeGroupByBufferGpu(
             query_mem_desc.hasKeylessHash(),
             sizeof(int64_t),
             block_size_x,
-            grid_size_x);
+            grid_size_x,
+            init_stream);
       } else {
         init_group_by_buffer_on_device(reinterpret_cast<int64_t*>(group_by_dev_buffer),
                                        reinterpret_cast<int64_t*>(init_agg_vals_dev_ptr),
@@ -795,7 +866,8 @@ GpuGroupByBuffers QueryMemoryInitializer::createAndInitializeGroupByBufferGpu(
                                        query_mem_desc.hasKeylessHash(),
                                        warp_count,
                                        block_size_x,
-                                       grid_size_x);
+                                       grid_size_x,
+                                       init_stream);
       }
       group_by_dev_buffer += groups_buffer_size;
     }
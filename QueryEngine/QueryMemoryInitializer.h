@@ -25,6 +25,7 @@
 #include "Rendering/RenderAllocator.h"
 
 #include <memory>
+#include <optional>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -128,6 +129,9 @@ class QueryMemoryInitializer {
                                  const bool prepend_index_buffer) const;
 
  private:
+  // quantile of the APPROX_QUANTILE target of a slot, if any
+  using QuantileParam = std::optional<double>;
+
   void initGroupByBuffer(int64_t* buffer,
                          const RelAlgExecutionUnit& ra_exe_unit,
                          const QueryMemoryDescriptor& query_mem_desc,
@@ -147,30 +151,39 @@ class QueryMemoryInitializer {
                           const std::vector<int64_t>& init_vals,
                           const Executor* executor);
 
-  void initColumnPerRow(const QueryMemoryDescriptor& query_mem_desc,
-                        int8_t* row_ptr,
-                        const size_t bin,
-                        const std::vector<int64_t>& init_vals,
-                        const std::vector<int64_t>& bitmap_sizes);
+  void initColumnPerRow(
+      const QueryMemoryDescriptor& query_mem_desc,
+      int8_t* row_ptr,
+      const size_t bin,
+      const std::vector<int64_t>& init_vals,
+      const std::vector<const CountDistinctDescriptor*>& count_distinct_descs,
+      const std::vector<QuantileParam>& quantile_params);
 
   void allocateCountDistinctGpuMem(const QueryMemoryDescriptor& query_mem_desc);
 
-  std::vector<int64_t> allocateCountDistinctBuffers(
+  std::vector<const CountDistinctDescriptor*> allocateCountDistinctBuffers(
       const QueryMemoryDescriptor& query_mem_desc,
       const bool deferred,
       const Executor* executor);
 
+  int64_t allocateCountDistinctBuffer(const CountDistinctDescriptor& count_distinct_desc);
+
   int64_t allocateCountDistinctBitmap(const size_t bitmap_byte_sz);
 
   int64_t allocateCountDistinctSet();
 
+  std::vector<QuantileParam> allocateTDigests(const QueryMemoryDescriptor& query_mem_desc,
+                                              const bool deferred,
+                                              const Executor* executor);
+
 #ifdef HAVE_CUDA
   GpuGroupByBuffers prepareTopNHeapsDevBuffer(const QueryMemoryDescriptor& query_mem_desc,
                                               const CUdeviceptr init_agg_vals_dev_ptr,
                                               const size_t n,
                                               const int device_id,
                                               const unsigned block_size_x,
-                                              const unsigned grid_size_x);
+                                              const unsigned grid_size_x,
+                                              const CUstream init_stream);
 
   GpuGroupByBuffers createAndInitializeGroupByBufferGpu(
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -183,7 +196,8 @@ class QueryMemoryInitializer {
       const int8_t warp_size,
       const bool can_sort_on_gpu,
       const bool output_columnar,
-      RenderAllocator* render_allocator);
+      RenderAllocator* render_allocator,
+      const CUstream init_stream = nullptr);
 #endif
 
   size_t computeNumberOfBuffers(const QueryMemoryDescriptor& query_mem_desc,
@@ -25,6 +25,7 @@
 #include "RexVisitor.h"
 #include "Shared/sqldefs.h"
 
+#include <boost/lexical_cast.hpp>
 #include <rapidjson/error/en.h>
 #include <rapidjson/error/error.h>
 #include <rapidjson/stringbuffer.h>
@@ -1006,7 +1007,9 @@ std::unique_ptr<const RexAgg> parse_aggregate_expr(const rapidjson::Value& expr)
   const auto distinct = json_bool(field(expr, "distinct"));
   const auto agg_ti = parse_type(field(expr, "type"));
   const auto operands = indices_from_json_array(field(expr, "operands"));
-  if (operands.size() > 1 && (operands.size() != 2 || agg != kAPPROX_COUNT_DISTINCT)) {
+  if (operands.size() > 1 &&
+      (operands.size() != 2 ||
+       (agg != kAPPROX_COUNT_DISTINCT && agg != kAPPROX_QUANTILE))) {
     throw QueryNotSupported("Multiple arguments for aggregates aren't supported");
   }
   return std::unique_ptr<const RexAgg>(new RexAgg(agg, distinct, agg_ti, operands));
@@ -1195,44 +1198,116 @@ void bind_inputs(const std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept
   }
 }
 
+// Returns the single option of a hint, logs and ignores the hint if it isn't valid.
+template <typename T>
+std::optional<T> get_hint_option(const HintExplained& hint) {
+  const auto& options = hint.getListOptions();
+  if (options.size() != 1) {
+    LOG(WARNING) << "Ignoring the " << hint.getHintName()
+                 << " hint, which takes a single option";
+    return std::nullopt;
+  }
+  try {
+    const auto value = boost::lexical_cast<T>(options.front());
+    if (value >= 0) {
+      return value;
+    }
+  } catch (const boost::bad_lexical_cast&) {
+  }
+  LOG(WARNING) << "Ignoring the " << hint.getHintName() << " hint, invalid option "
+               << options.front();
+  return std::nullopt;
+}
+
+template <typename NODE>
+void collect_query_hints(const NODE& node, QueryHint& query_hints) {
+  for (const auto& [hint_name, flag] :
+       std::vector<std::pair<std::string, bool*>>{
+           {"cpu_mode", &query_hints.cpu_mode},
+           {"gpu_mode", &query_hints.gpu_mode},
+           {"hash_join", &query_hints.hash_join},
+           {"loop_join", &query_hints.loop_join},
+           {"watchdog_off", &query_hints.watchdog_off},
+           {"disable_lazy_fetch", &query_hints.disable_lazy_fetch}}) {
+    if (node.hasHintEnabled(hint_name)) {
+      *flag = true;
+    }
+  }
+  if (node.hasHintEnabled("columnar_output")) {
+    query_hints.columnar_output = true;
+  }
+  if (node.hasHintEnabled("rowwise_output")) {
+    query_hints.columnar_output = false;
+  }
+  if (node.hasHintEnabled("max_kernel_parallelism")) {
+    const auto parallelism =
+        get_hint_option<int64_t>(node.getHintInfo("max_kernel_parallelism"));
+    if (parallelism) {
+      query_hints.max_kernel_parallelism = static_cast<size_t>(*parallelism);
+    }
+  }
+  if (node.hasHintEnabled("dynamic_watchdog")) {
+    const auto time_limit =
+        get_hint_option<int64_t>(node.getHintInfo("dynamic_watchdog"));
+    if (time_limit) {
+      query_hints.dynamic_watchdog_time_limit = static_cast<unsigned>(*time_limit);
+    }
+  }
+  if (node.hasHintEnabled("gpu_input_mem_limit")) {
+    const auto& hint = node.getHintInfo("gpu_input_mem_limit");
+    const auto mem_limit = get_hint_option<double>(hint);
+    if (mem_limit && *mem_limit <= 1.) {
+      query_hints.gpu_input_mem_limit = *mem_limit;
+    } else if (mem_limit) {
+      LOG(WARNING) << "Ignoring the " << hint.getHintName()
+                   << " hint, the fraction is greater than 1";
+    }
+  }
+  if (node.hasHintEnabled("approximate")) {
+    const auto& hint = node.getHintInfo("approximate");
+    const auto error = hint.getListOptions().empty() ? std::make_optional(0.01)
+                                                      : get_hint_option<double>(hint);
+    if (error && *error > 0. && *error < 1.) {
+      query_hints.approximate_error = *error;
+    } else if (error) {
+      LOG(WARNING) << "Ignoring the " << hint.getHintName()
+                   << " hint, the relative error isn't between 0 and 1";
+    }
+  }
+}
+
 void handleQueryHint(const std::vector<std::shared_ptr<RelAlgNode>>& nodes,
                      RelAlgDagBuilder* dag_builder) noexcept {
   QueryHint query_hints;
   for (auto node : nodes) {
     const auto agg_node = std::dynamic_pointer_cast<RelAggregate>(node);
     if (agg_node) {
-      if (agg_node->hasHintEnabled("cpu_mode")) {
-        query_hints.cpu_mode = true;
-      }
+      collect_query_hints(*agg_node, query_hints);
     }
     const auto project_node = std::dynamic_pointer_cast<RelProject>(node);
     if (project_node) {
-      if (project_node->hasHintEnabled("cpu_mode")) {
-        query_hints.cpu_mode = true;
-      }
+      collect_query_hints(*project_node, query_hints);
     }
     const auto scan_node = std::dynamic_pointer_cast<RelScan>(node);
     if (scan_node) {
-      if (scan_node->hasHintEnabled("cpu_mode")) {
-        query_hints.cpu_mode = true;
-      }
+      collect_query_hints(*scan_node, query_hints);
     }
     const auto join_node = std::dynamic_pointer_cast<RelJoin>(node);
     if (join_node) {
-      if (join_node->hasHintEnabled("cpu_mode")) {
-        query_hints.cpu_mode = true;
-      }
+      collect_query_hints(*join_node, query_hints);
     }
     const auto compound_node = std::dynamic_pointer_cast<RelCompound>(node);
     if (compound_node) {
-      if (compound_node->hasHintEnabled("cpu_mode")) {
-        query_hints.cpu_mode = true;
-      }
+      collect_query_hints(*compound_node, query_hints);
     }
   }
   if (query_hints.cpu_mode) {
     VLOG(1) << "A user forces to run the query on the CPU execution mode";
   }
+  if (query_hints.hash_join && query_hints.loop_join) {
+    LOG(WARNING) << "Ignoring the conflicting hash_join and loop_join hints";
+    query_hints.hash_join = query_hints.loop_join = false;
+  }
   dag_builder->registerQueryHints(query_hints);
 }
 
@@ -2651,6 +2726,9 @@ void RelAlgDagBuilder::build(const rapidjson::Value& query_ast,
   coalesce_nodes(nodes_, left_deep_joins);
   CHECK(nodes_.back().use_count() == 1);
   create_left_deep_join(nodes_);
+  if (g_enable_common_subplan_elimination && !g_cluster) {
+    eliminate_common_subplans(nodes_);
+  }
 }
 
 void RelAlgDagBuilder::eachNode(
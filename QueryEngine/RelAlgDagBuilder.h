@@ -657,11 +657,11 @@ class HintExplained {
     inherit_paths_ = interit_paths;
   }
 
-  const std::vector<std::string>& getListOptions() { return list_options_; }
+  const std::vector<std::string>& getListOptions() const { return list_options_; }
 
-  const std::vector<int>& getInteritPath() { return inherit_paths_; }
+  const std::vector<int>& getInteritPath() const { return inherit_paths_; }
 
-  const std::unordered_map<std::string, std::string>& getKVOptions() {
+  const std::unordered_map<std::string, std::string>& getKVOptions() const {
     return kv_options_;
   }
 
@@ -19,8 +19,10 @@
 #include "QueryEngine/CalciteDeserializerUtils.h"
 #include "QueryEngine/CardinalityEstimator.h"
 #include "QueryEngine/ColumnFetcher.h"
+#include "QueryEngine/DeviceCostModel.h"
 #include "QueryEngine/EquiJoinCondition.h"
 #include "QueryEngine/ErrorHandling.h"
+#include "QueryEngine/ExpressionInterpreter.h"
 #include "QueryEngine/ExpressionRewrite.h"
 #include "QueryEngine/ExtensionFunctionsBinding.h"
 #include "QueryEngine/ExternalExecutor.h"
@@ -36,18 +38,22 @@
 #include "Shared/measure.h"
 #include "Shared/misc.h"
 #include "Shared/shard_key.h"
+#include "Shared/thread_count.h"
 
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
 #include <algorithm>
 #include <functional>
+#include <future>
 #include <numeric>
 
 bool g_skip_intermediate_count{true};
 extern bool g_enable_bump_allocator;
 bool g_enable_interop{false};
 bool g_enable_union{false};
+bool g_enable_parallel_union_branches{false};
+size_t g_group_by_partition_count{16};
 
 namespace {
 
@@ -198,14 +204,70 @@ size_t RelAlgExecutor::getOuterFragmentCount(const CompilationOptions& co,
   return 0;
 }
 
-ExecutionResult RelAlgExecutor::executeRelAlgQuery(const CompilationOptions& co,
-                                                   const ExecutionOptions& eo,
+namespace {
+
+CompilationOptions apply_query_hints(const CompilationOptions& co_in,
+                                     const QueryHint& query_hints,
+                                     const Catalog_Namespace::Catalog& cat) {
+  auto co = co_in;
+  if (query_hints.cpu_mode) {
+    co.device_type = ExecutorDeviceType::CPU;
+  } else if (query_hints.gpu_mode) {
+    if (cat.getDataMgr().gpusPresent()) {
+      co.device_type = ExecutorDeviceType::GPU;
+    } else {
+      LOG(WARNING) << "Ignoring the gpu_mode hint, the server has no GPU";
+    }
+  }
+  if (query_hints.dynamic_watchdog_time_limit) {
+    co.with_dynamic_watchdog = *query_hints.dynamic_watchdog_time_limit > 0;
+  }
+  if (query_hints.disable_lazy_fetch) {
+    co.allow_lazy_fetch = false;
+  }
+  return co;
+}
+
+ExecutionOptions apply_query_hints(const ExecutionOptions& eo,
+                                   const QueryHint& query_hints) {
+  const auto& time_limit = query_hints.dynamic_watchdog_time_limit;
+  ExecutionOptions eo_hinted{
+      query_hints.columnar_output.value_or(eo.output_columnar_hint),
+      eo.allow_multifrag,
+      eo.just_explain,
+      (eo.allow_loop_joins || query_hints.loop_join) && !query_hints.hash_join,
+      eo.with_watchdog && !query_hints.watchdog_off,
+      eo.jit_debug,
+      eo.just_validate,
+      time_limit ? *time_limit > 0 : eo.with_dynamic_watchdog,
+      time_limit && *time_limit > 0 ? *time_limit : eo.dynamic_watchdog_time_limit,
+      eo.find_push_down_candidates,
+      eo.just_calcite_explain,
+      query_hints.gpu_input_mem_limit.value_or(eo.gpu_input_mem_limit_percent),
+      eo.allow_runtime_query_interrupt,
+      eo.pending_query_interrupt_freq,
+      eo.executor_type,
+      eo.outer_fragment_indices,
+      eo.force_loop_joins || query_hints.loop_join,
+      query_hints.max_kernel_parallelism ? query_hints.max_kernel_parallelism
+                                         : eo.max_kernel_parallelism,
+      query_hints.approximate_error.value_or(eo.approximate_error)};
+  return eo_hinted;
+}
+
+}  // namespace
+
+ExecutionResult RelAlgExecutor::executeRelAlgQuery(const CompilationOptions& co_in,
+                                                   const ExecutionOptions& eo_in,
                                                    const bool just_explain_plan,
                                                    RenderInfo* render_info) {
   CHECK(query_dag_);
   auto timer = DEBUG_TIMER(__func__);
   INJECT_TIMER(executeRelAlgQuery);
 
+  const auto query_hints = query_dag_->getQueryHints();
+  const auto co = apply_query_hints(co_in, query_hints, cat_);
+  const auto eo = apply_query_hints(eo_in, query_hints);
   try {
     return executeRelAlgQueryNoRetry(co, eo, just_explain_plan, render_info);
   } catch (const QueryMustRunOnCpu&) {
@@ -516,7 +578,10 @@ QueryStepExecutionResult RelAlgExecutor::executeRelAlgQuerySingleStep(
             eo.allow_runtime_query_interrupt,
             eo.pending_query_interrupt_freq,
             eo.executor_type,
-        };
+            std::vector<size_t>(),
+            eo.force_loop_joins,
+            eo.max_kernel_parallelism,
+            eo.approximate_error};
         // Use subseq to avoid clearing existing temporary tables
         return {
             executeRelAlgSubSeq(temp_seq, std::make_pair(0, 1), co, eo_copy, nullptr, 0),
@@ -548,12 +613,76 @@ void RelAlgExecutor::prepareLeafExecution(
   }
   queue_time_ms_ = timer_stop(clock_begin);
   executor_->row_set_mem_owner_ =
-      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize(),
+                                          g_max_query_host_memory_bytes);
   executor_->table_generations_ = table_generations;
   executor_->agg_col_range_cache_ = agg_col_range;
   executor_->string_dictionary_generations_ = string_dictionary_generations;
 }
 
+namespace {
+
+// The branches of a union run on executors of their own, at most this many at a time.
+constexpr size_t kMaxParallelUnionBranches{8};
+// Above the ids of the unitary executor and of the dispatch queue workers.
+constexpr Executor::ExecutorId kUnionBranchExecutorIdBase{1 << 16};
+
+Executor::ExecutorId get_union_branch_executor_id(const Executor::ExecutorId executor_id,
+                                                  const size_t branch_idx) {
+  CHECK_LT(branch_idx, kMaxParallelUnionBranches);
+  return kUnionBranchExecutorIdBase + executor_id * kMaxParallelUnionBranches +
+         branch_idx;
+}
+
+/**
+ * Number of steps from step_idx on which are all inputs of the union step right after
+ * them and don't read each other's results, so that they can run at the same time. Zero
+ * if there are fewer than two such steps.
+ */
+size_t get_union_branch_step_count(const RaExecutionSequence& seq,
+                                   const size_t step_idx,
+                                   const size_t step_count) {
+  std::vector<const RelAlgNode*> branches;
+  for (size_t i = step_idx; i < step_count; ++i) {
+    const auto body = seq.getDescriptor(i)->getBody();
+    if (const auto logical_union = dynamic_cast<const RelLogicalUnion*>(body)) {
+      const bool independent_branches = std::all_of(
+          branches.begin(), branches.end(), [&branches, logical_union](auto branch) {
+            return logical_union->hasInput(branch) &&
+                   std::none_of(branches.begin(), branches.end(), [branch](auto other) {
+                     return branch->hasInput(other);
+                   });
+          });
+      return independent_branches && branches.size() > 1 ? branches.size() : 0;
+    }
+    if (body->isNop() ||
+        !shared::dynamic_castable_to_any<RelProject,
+                                         RelCompound,
+                                         RelAggregate,
+                                         RelFilter,
+                                         RelSort>(body)) {
+      return 0;
+    }
+    branches.push_back(body);
+  }
+  return 0;
+}
+
+void log_step_compilation_time(const RaExecutionSequence& seq, const size_t step_idx) {
+  const auto exec_desc = seq.getDescriptor(step_idx);
+  CHECK(exec_desc);
+  if (exec_desc->getBody()->isNop()) {
+    return;
+  }
+  const auto& rows = exec_desc->getResult().getRows();
+  if (rows) {
+    VLOG(1) << "Query step " << step_idx << " compiled in " << rows->getCompilationTime()
+            << " ms";
+  }
+}
+
+}  // namespace
+
 ExecutionResult RelAlgExecutor::executeRelAlgSeq(const RaExecutionSequence& seq,
                                                  const CompilationOptions& co,
                                                  const ExecutionOptions& eo,
@@ -572,9 +701,26 @@ ExecutionResult RelAlgExecutor::executeRelAlgSeq(const RaExecutionSequence& seq,
   time(&now_);
   CHECK(!seq.empty());
   const auto exec_desc_count = eo.just_explain ? size_t(1) : seq.size();
+  decltype(step_profiles_)().swap(step_profiles_);
 
   for (size_t i = 0; i < exec_desc_count; i++) {
+    if (g_enable_parallel_union_branches && !g_cluster && !g_enable_interop) {
+      const auto branch_count = get_union_branch_step_count(seq, i, exec_desc_count);
+      if (branch_count) {
+        executeUnionBranches(seq, {i, i + branch_count}, co, eo, queue_time_ms);
+        for (size_t j = i; j < i + branch_count; ++j) {
+          log_step_compilation_time(seq, j);
+          addStepResourceUsage(seq, j);
+          if (eo.profile_steps) {
+            addStepProfile(seq, j, -1);
+          }
+        }
+        i += branch_count - 1;
+        continue;
+      }
+    }
     VLOG(1) << "Executing query step " << i;
+    const auto step_clock_begin = timer_start();
     // only render on the last step
     try {
       executeRelAlgStep(seq,
@@ -603,11 +749,116 @@ ExecutionResult RelAlgExecutor::executeRelAlgSeq(const RaExecutionSequence& seq,
                         (i == exec_desc_count - 1) ? render_info : nullptr,
                         queue_time_ms);
     }
+    log_step_compilation_time(seq, i);
+    addStepResourceUsage(seq, i);
+    if (eo.profile_steps) {
+      addStepProfile(seq, i, timer_stop(step_clock_begin));
+    }
   }
 
   return seq.getDescriptor(exec_desc_count - 1)->getResult();
 }
 
+void RelAlgExecutor::addStepResourceUsage(const RaExecutionSequence& seq,
+                                          const size_t step_idx) {
+  const auto exec_desc = seq.getDescriptor(step_idx);
+  CHECK(exec_desc);
+  if (exec_desc->getBody()->isNop()) {
+    return;
+  }
+  const auto& rows = exec_desc->getResult().getRows();
+  if (!rows) {
+    return;
+  }
+  const auto& memory_usage = rows->getMemoryUsage();
+  query_state::ResourceUsage step_usage;
+  step_usage.num_steps = 1;
+  step_usage.ran_on_gpu = rows->getDeviceType() == ExecutorDeviceType::GPU;
+  step_usage.compilation_time_ms = rows->getCompilationTime();
+  step_usage.reduction_time_ms = rows->getReductionTime();
+  step_usage.cpu_bytes_scanned = memory_usage.cpu_bytes_scanned;
+  step_usage.gpu_bytes_scanned = memory_usage.gpu_bytes_scanned;
+  step_usage.peak_cpu_memory_bytes = memory_usage.cpu_working_set_bytes;
+  step_usage.peak_gpu_memory_bytes = memory_usage.gpu_working_set_bytes;
+  step_usage.peak_host_memory_bytes = memory_usage.host_bytes_held;
+  resource_usage_ += step_usage;
+}
+
+void RelAlgExecutor::addStepProfile(const RaExecutionSequence& seq,
+                                    const size_t step_idx,
+                                    const int64_t time_ms) {
+  const auto exec_desc = seq.getDescriptor(step_idx);
+  CHECK(exec_desc);
+  const auto body = exec_desc->getBody();
+  if (body->isNop()) {
+    return;
+  }
+  StepProfile profile{step_idx, body->toString(), time_ms};
+  // the inputs are tables, joins of them or the results of earlier steps
+  std::function<void(const RelAlgNode*)> add_input = [&](const RelAlgNode* input) {
+    if (const auto scan = dynamic_cast<const RelScan*>(input)) {
+      const auto table_info =
+          executor_->getTableInfo(scan->getTableDescriptor()->tableId);
+      profile.input_rows += table_info.getNumTuplesUpperBound();
+      profile.input_fragments += table_info.fragments.size();
+      return;
+    }
+    if (dynamic_cast<const RelLeftDeepInnerJoin*>(input) ||
+        dynamic_cast<const RelJoin*>(input)) {
+      for (size_t i = 0; i < input->inputCount(); ++i) {
+        add_input(input->getInput(i));
+      }
+      return;
+    }
+    const auto it = temporary_tables_.find(-static_cast<int>(input->getId()));
+    if (it != temporary_tables_.end() && it->second) {
+      profile.input_rows += it->second->rowCount();
+    }
+  };
+  for (size_t i = 0; i < body->inputCount(); ++i) {
+    add_input(body->getInput(i));
+  }
+  const auto& rows = exec_desc->getResult().getRows();
+  if (rows) {
+    profile.output_rows = rows->rowCount();
+    profile.compilation_time_ms = rows->getCompilationTime();
+    profile.queue_time_ms = rows->getQueueTime();
+    profile.device_type = rows->getDeviceType();
+    profile.kernel_perf_counters = rows->getKernelPerfCounters();
+    profile.kernel_gpu_timings = rows->getKernelGpuTimings();
+  }
+  step_profiles_.push_back(std::move(profile));
+}
+
+std::string RelAlgExecutor::getStepProfiles() const {
+  std::stringstream ss;
+  size_t tab_ctr = 0;
+  for (auto it = step_profiles_.rbegin(); it != step_profiles_.rend(); ++it) {
+    const auto tabs = std::string(tab_ctr++, '\t');
+    ss << tabs << std::to_string(it->step_idx + 1) << " : " << it->body << "\n";
+    ss << tabs << "  : time ";
+    if (it->time_ms < 0) {
+      ss << "shared with the other union branches";
+    } else {
+      ss << it->time_ms << " ms";
+    }
+    ss << ", rows in " << it->input_rows;
+    if (it->input_fragments) {
+      ss << " from " << it->input_fragments << " fragments";
+    }
+    ss << ", rows out " << it->output_rows << ", compilation " << it->compilation_time_ms
+       << " ms, queued " << it->queue_time_ms << " ms, on "
+       << (it->device_type == ExecutorDeviceType::GPU ? "GPU" : "CPU") << "\n";
+    if (g_enable_perf_counters) {
+      ss << tabs << "  : kernels " << it->kernel_perf_counters << "\n";
+    }
+    if (g_enable_gpu_kernel_timing && it->device_type == ExecutorDeviceType::GPU) {
+      ss << tabs << "  : on device " << it->kernel_gpu_timings << "\n";
+    }
+  }
+  return ss.str();
+}
+
 ExecutionResult RelAlgExecutor::executeRelAlgSubSeq(
     const RaExecutionSequence& seq,
     const std::pair<size_t, size_t> interval,
@@ -633,6 +884,73 @@ ExecutionResult RelAlgExecutor::executeRelAlgSubSeq(
   return seq.getDescriptor(interval.second - 1)->getResult();
 }
 
+void RelAlgExecutor::executeUnionBranches(const RaExecutionSequence& seq,
+                                          const std::pair<size_t, size_t> interval,
+                                          const CompilationOptions& co,
+                                          const ExecutionOptions& eo,
+                                          const int64_t queue_time_ms) {
+  auto timer = DEBUG_TIMER(__func__);
+  for (size_t first_step = interval.first; first_step < interval.second;
+       first_step += kMaxParallelUnionBranches) {
+    const auto last_step =
+        std::min(first_step + kMaxParallelUnionBranches, interval.second);
+    VLOG(1) << "Executing the union branches of query steps " << first_step << " to "
+            << last_step - 1 << " in parallel";
+    // Each branch runs on an executor of its own, with the caches of this query.
+    std::vector<std::shared_ptr<Executor>> branch_executors;
+    std::vector<std::unique_ptr<RelAlgExecutor>> branch_ra_executors;
+    for (size_t step_idx = first_step; step_idx < last_step; ++step_idx) {
+      auto executor = Executor::getExecutor(
+          get_union_branch_executor_id(executor_->executor_id_, step_idx - first_step));
+      executor->setCatalog(&cat_);
+      auto ra_executor =
+          std::make_unique<RelAlgExecutor>(executor.get(), cat_, query_state_);
+      ra_executor->prepareLeafExecution(executor_->agg_col_range_cache_,
+                                        executor_->string_dictionary_generations_,
+                                        executor_->table_generations_);
+      ra_executor->temporary_tables_ = temporary_tables_;
+      ra_executor->now_ = now_;
+      executor->temporary_tables_ = &ra_executor->temporary_tables_;
+      branch_executors.push_back(std::move(executor));
+      branch_ra_executors.push_back(std::move(ra_executor));
+    }
+    std::vector<std::future<void>> branch_futures;
+    for (size_t step_idx = first_step; step_idx < last_step; ++step_idx) {
+      const auto ra_executor = branch_ra_executors[step_idx - first_step].get();
+      branch_futures.emplace_back(std::async(
+          std::launch::async,
+          [ra_executor,
+           &seq,
+           step_idx,
+           &co,
+           &eo,
+           queue_time_ms,
+           parent_thread_id = logger::thread_id()] {
+            DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+            ra_executor->executeRelAlgStep(seq, step_idx, co, eo, nullptr, queue_time_ms);
+          }));
+    }
+    for (auto& branch_future : branch_futures) {
+      branch_future.wait();
+    }
+    for (auto& branch_future : branch_futures) {
+      branch_future.get();
+    }
+    for (size_t step_idx = first_step; step_idx < last_step; ++step_idx) {
+      auto& ra_executor = branch_ra_executors[step_idx - first_step];
+      const auto body = seq.getDescriptor(step_idx)->getBody();
+      const auto it = ra_executor->temporary_tables_.find(-body->getId());
+      CHECK(it != ra_executor->temporary_tables_.end());
+      addTemporaryTable(-body->getId(), it->second);
+      target_exprs_owned_.insert(target_exprs_owned_.end(),
+                                 ra_executor->target_exprs_owned_.begin(),
+                                 ra_executor->target_exprs_owned_.end());
+      // the results keep the memory owner of the branch alive
+      ra_executor->cleanupPostExecution();
+    }
+  }
+}
+
 void RelAlgExecutor::executeRelAlgStep(const RaExecutionSequence& seq,
                                        const size_t step_idx,
                                        const CompilationOptions& co,
@@ -666,7 +984,10 @@ void RelAlgExecutor::executeRelAlgStep(const RaExecutionSequence& seq,
       eo.allow_runtime_query_interrupt,
       eo.pending_query_interrupt_freq,
       eo.executor_type,
-      step_idx == 0 ? eo.outer_fragment_indices : std::vector<size_t>()};
+      step_idx == 0 ? eo.outer_fragment_indices : std::vector<size_t>(),
+      eo.force_loop_joins,
+      eo.max_kernel_parallelism,
+      eo.approximate_error};
 
   // Notify foreign tables to load prior to execution
   prepare_foreign_table_for_execution(*body, cat_.getDatabaseId(), query_state_);
@@ -708,9 +1029,14 @@ void RelAlgExecutor::executeRelAlgStep(const RaExecutionSequence& seq,
         // This optimization needs to be restricted in its application for UNION, which
         // can have 2 input nodes in which neither should restrict the count of the other.
         // However some non-UNION queries are measurably slower with this restriction, so
-        // it is only applied when g_enable_union is true.
+        // it is only applied to join inputs when g_enable_union is true. Other inputs
+        // must be the previous step, which isn't the case if they are shared by several
+        // nodes.
+        const auto input = project->getInput(0);
         bool const parent_check =
-            !g_enable_union || project->getInput(0)->getId() == prev_body->getId();
+            input->getId() == prev_body->getId() ||
+            (!g_enable_union && (dynamic_cast<const RelJoin*>(input) ||
+                                 dynamic_cast<const RelLeftDeepInnerJoin*>(input)));
         // If the previous node produced a reliable count, skip the pre-flight count
         if (parent_check && (dynamic_cast<const RelCompound*>(prev_body) ||
                              dynamic_cast<const RelLogicalValues*>(prev_body))) {
@@ -1488,7 +1814,10 @@ void RelAlgExecutor::executeUpdate(const RelAlgNode* node,
                                        cat_,
                                        executor_->row_set_mem_owner_,
                                        update_callback,
-                                       is_aggregate);
+                                       is_aggregate,
+                                       /*allow_parallel_fragments=*/
+                                       !update_params.isVarlenUpdateRequired() &&
+                                           !update_params.tableIsTemporary());
               update_params.finalizeTransaction();
             };
 
@@ -1592,7 +1921,9 @@ void RelAlgExecutor::executeDelete(const RelAlgNode* node,
                                    cat_,
                                    executor_->row_set_mem_owner_,
                                    delete_callback,
-                                   is_aggregate);
+                                   is_aggregate,
+                                   /*allow_parallel_fragments=*/
+                                   !delete_params.tableIsTemporary());
           delete_params.finalizeTransaction();
         };
 
@@ -1781,6 +2112,25 @@ std::shared_ptr<Analyzer::Expr> transform_to_inner(const Analyzer::Expr* expr) {
       col->get_type_info(), col->get_table_id(), col->get_column_id(), 1);
 }
 
+// Returns true iff the window functions sort the same partitions the same way.
+bool window_sort_match(const Analyzer::WindowFunction* lhs,
+                       const Analyzer::WindowFunction* rhs) {
+  const auto& lhs_collation = lhs->getCollation();
+  const auto& rhs_collation = rhs->getCollation();
+  if (!expr_list_match(lhs->getPartitionKeys(), rhs->getPartitionKeys()) ||
+      !expr_list_match(lhs->getOrderKeys(), rhs->getOrderKeys()) ||
+      lhs_collation.size() != rhs_collation.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs_collation.size(); ++i) {
+    if (lhs_collation[i].is_desc != rhs_collation[i].is_desc ||
+        lhs_collation[i].nulls_first != rhs_collation[i].nulls_first) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
@@ -1799,13 +2149,38 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
   }
   query_infos.push_back(query_infos.front());
   auto window_project_node_context = WindowProjectNodeContext::create(executor_);
+  // Window functions with the same partition keys share the partitions, those with the
+  // same order keys as well share the sort of the partitions, done by the first one.
+  std::vector<std::pair<size_t, const Analyzer::WindowFunction*>> window_funcs;
   for (size_t target_index = 0; target_index < ra_exe_unit.target_exprs.size();
        ++target_index) {
-    const auto& target_expr = ra_exe_unit.target_exprs[target_index];
-    const auto window_func = dynamic_cast<const Analyzer::WindowFunction*>(target_expr);
-    if (!window_func) {
-      continue;
+    const auto window_func = dynamic_cast<const Analyzer::WindowFunction*>(
+        ra_exe_unit.target_exprs[target_index]);
+    if (window_func) {
+      window_funcs.emplace_back(target_index, window_func);
     }
+  }
+  std::vector<int64_t> partitions_source(window_funcs.size(), -1);
+  std::vector<int64_t> sort_source(window_funcs.size(), -1);
+  std::vector<bool> retain_sort(window_funcs.size(), false);
+  for (size_t i = 0; i < window_funcs.size(); ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      if (partitions_source[i] < 0 &&
+          expr_list_match(window_funcs[i].second->getPartitionKeys(),
+                          window_funcs[j].second->getPartitionKeys())) {
+        partitions_source[i] = j;
+      }
+      if (window_sort_match(window_funcs[i].second, window_funcs[j].second)) {
+        sort_source[i] = j;
+        retain_sort[j] = true;
+        break;
+      }
+    }
+  }
+  std::vector<const WindowFunctionContext*> contexts;
+  for (size_t i = 0; i < window_funcs.size(); ++i) {
+    const auto target_index = window_funcs[i].first;
+    const auto window_func = window_funcs[i].second;
     // Always use baseline layout hash tables for now, make the expression a tuple.
     const auto& partition_keys = window_func->getPartitionKeys();
     std::shared_ptr<Analyzer::Expr> partition_key_tuple;
@@ -1826,14 +2201,24 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
                                     kONE,
                                     partition_key_tuple,
                                     transform_to_inner(partition_key_tuple.get()));
-    auto context = createWindowFunctionContext(window_func,
-                                               partition_key_cond,
-                                               ra_exe_unit,
-                                               query_infos,
-                                               co,
-                                               column_cache_map,
-                                               executor_->getRowSetMemoryOwner());
+    auto context = createWindowFunctionContext(
+        window_func,
+        partition_key_cond,
+        partitions_source[i] < 0 ? nullptr
+                                 : contexts[partitions_source[i]]->getPartitions(),
+        ra_exe_unit,
+        query_infos,
+        co,
+        column_cache_map,
+        executor_->getRowSetMemoryOwner());
+    if (retain_sort[i]) {
+      context->retainSortedPartitions();
+    }
+    if (sort_source[i] >= 0) {
+      context->setSortedPartitions(contexts[sort_source[i]]->getSortedPartitions());
+    }
     context->compute();
+    contexts.push_back(context.get());
     window_project_node_context->addWindowFunctionContext(std::move(context),
                                                           target_index);
   }
@@ -1842,6 +2227,7 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
 std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionContext(
     const Analyzer::WindowFunction* window_func,
     const std::shared_ptr<Analyzer::BinOper>& partition_key_cond,
+    const std::shared_ptr<JoinHashTableInterface>& partitions,
     const RelAlgExecutionUnit& ra_exe_unit,
     const std::vector<InputTableInfo>& query_infos,
     const CompilationOptions& co,
@@ -1850,22 +2236,25 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
   const auto memory_level = co.device_type == ExecutorDeviceType::GPU
                                 ? MemoryLevel::GPU_LEVEL
                                 : MemoryLevel::CPU_LEVEL;
-  const auto join_table_or_err =
-      executor_->buildHashTableForQualifier(partition_key_cond,
-                                            query_infos,
-                                            memory_level,
-                                            JoinHashTableInterface::HashType::OneToMany,
-                                            column_cache_map);
-  if (!join_table_or_err.fail_reason.empty()) {
-    throw std::runtime_error(join_table_or_err.fail_reason);
+  auto hash_table = partitions;
+  if (!hash_table) {
+    const auto join_table_or_err = executor_->buildHashTableForQualifier(
+        partition_key_cond,
+        query_infos,
+        memory_level,
+        JoinHashTableInterface::HashType::OneToMany,
+        column_cache_map);
+    if (!join_table_or_err.fail_reason.empty()) {
+      throw std::runtime_error(join_table_or_err.fail_reason);
+    }
+    hash_table = join_table_or_err.hash_table;
   }
-  CHECK(join_table_or_err.hash_table->getHashType() ==
-        JoinHashTableInterface::HashType::OneToMany);
+  CHECK(hash_table->getHashType() == JoinHashTableInterface::HashType::OneToMany);
   const auto& order_keys = window_func->getOrderKeys();
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
   const size_t elem_count = query_infos.front().info.fragments.front().getNumTuples();
   auto context = std::make_unique<WindowFunctionContext>(window_func,
-                                                         join_table_or_err.hash_table,
+                                                         hash_table,
                                                          elem_count,
                                                          co.device_type,
                                                          row_set_mem_owner);
@@ -1889,6 +2278,29 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
     CHECK_EQ(join_col_elem_count, elem_count);
     context->addOrderColumn(column, order_col.get(), chunks_owner);
   }
+  const auto& args = window_func->getArgs();
+  if (window_function_is_rows_frame_aggregate(window_func) && !args.empty()) {
+    const auto arg_col =
+        std::dynamic_pointer_cast<const Analyzer::ColumnVar>(args.front());
+    if (!arg_col || arg_col->get_type_info().is_varlen()) {
+      throw std::runtime_error(
+          "Only fixed length columns supported as arguments of framed aggregates");
+    }
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>> arg_chunks_owner;
+    const int8_t* column;
+    size_t arg_col_elem_count;
+    std::tie(column, arg_col_elem_count) =
+        ColumnFetcher::getOneColumnFragment(executor_,
+                                            *arg_col,
+                                            query_infos.front().info.fragments.front(),
+                                            memory_level,
+                                            0,
+                                            nullptr,
+                                            arg_chunks_owner,
+                                            column_cache_map);
+    CHECK_EQ(arg_col_elem_count, elem_count);
+    context->setAggregateArgumentColumn(column, arg_chunks_owner);
+  }
   return context;
 }
 
@@ -2464,7 +2876,10 @@ ExecutionResult RelAlgExecutor::executeSort(const RelSort* sort,
         eo.allow_runtime_query_interrupt,
         eo.pending_query_interrupt_freq,
         eo.executor_type,
-    };
+        std::vector<size_t>(),
+        eo.force_loop_joins,
+        eo.max_kernel_parallelism,
+      eo.approximate_error};
 
     groupby_exprs = source_work_unit.exe_unit.groupby_exprs;
     auto source_result = executeWorkUnit(source_work_unit,
@@ -2664,7 +3079,7 @@ RelAlgExecutionUnit decide_approx_count_distinct_implementation(
         get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit, device_type);
     int64_t approx_bitmap_sz_bits{0};
     const auto error_rate =
-        static_cast<Analyzer::AggExpr*>(target_expr)->get_error_rate();
+        static_cast<Analyzer::AggExpr*>(target_expr)->get_arg1();
     if (error_rate) {
       CHECK(error_rate->get_type_info().get_type() == kINT);
       CHECK_GE(error_rate->get_constval().intval, 1);
@@ -2717,12 +3132,86 @@ inline bool can_use_bump_allocator(const RelAlgExecutionUnit& ra_exe_unit,
 
 }  // namespace
 
+namespace {
+
+bool is_out_of_output_memory(const int32_t error_code) {
+  return error_code < 0 || error_code == Executor::ERR_OUT_OF_SLOTS ||
+         error_code == Executor::ERR_OUT_OF_CPU_MEM;
+}
+
+// The group by key to partition the groups on, as a BIGINT expression: the integer or
+// dictionary encoded string key with the widest range spreads the groups best.
+std::pair<std::shared_ptr<Analyzer::Expr>, std::shared_ptr<Analyzer::Expr>>
+get_group_by_partition_key(const RelAlgExecutionUnit& ra_exe_unit,
+                           const std::vector<InputTableInfo>& table_infos,
+                           Executor* executor) {
+  std::pair<std::shared_ptr<Analyzer::Expr>, std::shared_ptr<Analyzer::Expr>>
+      partition_key;
+  double partition_key_width{-1};
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    if (!groupby_expr) {
+      continue;
+    }
+    const auto& ti = groupby_expr->get_type_info();
+    std::shared_ptr<Analyzer::Expr> key;
+    if (ti.is_string() && ti.get_compression() == kENCODING_DICT) {
+      key = makeExpr<Analyzer::KeyForStringExpr>(groupby_expr);
+    } else if (ti.is_integer() || ti.is_decimal()) {
+      key = groupby_expr->deep_copy();
+    } else {
+      continue;
+    }
+    const auto range = getExpressionRange(groupby_expr.get(), table_infos, executor);
+    const double width = range.getType() == ExpressionRangeType::Integer
+                             ? static_cast<double>(range.getIntMax()) -
+                                   static_cast<double>(range.getIntMin())
+                             : std::numeric_limits<double>::max();
+    if (width > partition_key_width) {
+      partition_key = {key->add_cast(SQLTypeInfo(kBIGINT, false)), groupby_expr};
+      partition_key_width = width;
+    }
+  }
+  return partition_key;
+}
+
+// Keeps the rows of one partition of the groups: MOD(key, count) is negative for
+// negative keys, the null keys go to the first partition.
+std::shared_ptr<Analyzer::Expr> get_group_by_partition_qual(
+    const std::pair<std::shared_ptr<Analyzer::Expr>, std::shared_ptr<Analyzer::Expr>>&
+        partition_key,
+    const int64_t partition_count,
+    const int64_t partition_idx) {
+  const auto bigint_constant = [](const int64_t val) {
+    Datum d;
+    d.bigintval = val;
+    return makeExpr<Analyzer::Constant>(kBIGINT, false, d);
+  };
+  const auto key_mod = Parser::OperExpr::normalize(
+      kMODULO, kONE, partition_key.first, bigint_constant(partition_count));
+  auto qual = Parser::OperExpr::normalize(
+      kOR,
+      kONE,
+      Parser::OperExpr::normalize(kEQ, kONE, key_mod, bigint_constant(partition_idx)),
+      Parser::OperExpr::normalize(
+          kEQ, kONE, key_mod, bigint_constant(partition_idx - partition_count)));
+  if (partition_idx == 0 && !partition_key.second->get_type_info().get_notnull()) {
+    qual = Parser::OperExpr::normalize(
+        kOR,
+        kONE,
+        qual,
+        makeExpr<Analyzer::UOper>(kBOOLEAN, kISNULL, partition_key.second));
+  }
+  return qual;
+}
+
+}  // namespace
+
 ExecutionResult RelAlgExecutor::executeWorkUnit(
     const RelAlgExecutor::WorkUnit& work_unit,
     const std::vector<TargetMetaInfo>& targets_meta,
     const bool is_agg,
     const CompilationOptions& co_in,
-    const ExecutionOptions& eo,
+    const ExecutionOptions& eo_in,
     RenderInfo* render_info,
     const int64_t queue_time_ms,
     const std::optional<size_t> previous_count) {
@@ -2730,6 +3219,7 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
   auto timer = DEBUG_TIMER(__func__);
 
   auto co = co_in;
+  auto eo = eo_in;
   ColumnCacheMap column_cache;
   if (is_window_execution_unit(work_unit.exe_unit)) {
     if (!g_enable_window_functions) {
@@ -2768,9 +3258,34 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
   }
   const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
 
+  std::optional<device_cost_model::ScopedQueuedWork> queued_work;
+  const bool gpu_mode_hint = query_dag_ && query_dag_->getQueryHints().gpu_mode;
+  if (g_enable_device_cost_model && co.device_type == ExecutorDeviceType::GPU &&
+      !gpu_mode_hint && !render_info && !eo.just_explain) {
+    const auto cuda_mgr = cat_.getDataMgr().getCudaMgr();
+    const int gpu_count = cuda_mgr ? cuda_mgr->getDeviceCount() : 0;
+    const auto step_inputs = device_cost_model::get_step_inputs(
+        work_unit.exe_unit, table_infos, cat_, gpu_count);
+    co.device_type = device_cost_model::choose_device_type(step_inputs, gpu_count);
+    const int device_count =
+        co.device_type == ExecutorDeviceType::GPU ? gpu_count : cpu_threads();
+    queued_work.emplace(
+        co.device_type,
+        device_cost_model::estimate_step_ms(co.device_type, step_inputs, device_count));
+  }
+
   auto ra_exe_unit = decide_approx_count_distinct_implementation(
       work_unit.exe_unit, table_infos, executor_, co.device_type, target_exprs_owned_);
   auto max_groups_buffer_entry_guess = work_unit.max_groups_buffer_entry_guess;
+  // A projection of a small table is interpreted rather than compiled, neither the
+  // filtered count nor the projection pay for the code generation then.
+  if (eo.executor_type == ::ExecutorType::Native && !render_info && !eo.just_explain &&
+      expression_interpreter::can_interpret(
+          ra_exe_unit, table_infos, co.device_type, cat_)) {
+    VLOG(1) << "Interpreting the projection of "
+            << table_infos.front().info.getNumTuples() << " rows";
+    eo.executor_type = ::ExecutorType::Interpreter;
+  }
   if (is_window_execution_unit(ra_exe_unit)) {
     CHECK_EQ(table_infos.size(), size_t(1));
     CHECK_EQ(table_infos.front().info.fragments.size(), size_t(1));
@@ -2785,7 +3300,8 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
       if (can_use_bump_allocator(ra_exe_unit, co, eo) && !render_info) {
         ra_exe_unit.scan_limit = 0;
         ra_exe_unit.use_bump_allocator = true;
-      } else if (eo.executor_type == ::ExecutorType::Extern) {
+      } else if (eo.executor_type != ::ExecutorType::Native) {
+        // the external and the interpreted steps size their output to the rows projected
         ra_exe_unit.scan_limit = 0;
       } else if (!eo.just_explain) {
         const auto filter_count_all = getFilteredCountAll(work_unit, true, co, eo);
@@ -2802,6 +3318,7 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
                                                      executor_),
                          {}};
 
+  auto cache_key = ra_exec_unit_desc_for_caching(ra_exe_unit);
   auto execute_and_handle_errors =
       [&](const auto max_groups_buffer_entry_guess_in,
           const bool has_cardinality_estimation) -> ExecutionResult {
@@ -2822,6 +3339,23 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
                                          column_cache),
               targets_meta};
     } catch (const QueryExecutionError& e) {
+      if (is_agg && is_out_of_output_memory(e.getErrorCode()) &&
+          has_cardinality_estimation && !(eo.just_validate || eo.just_explain)) {
+        // The estimate was short of the groups which passed the filter. Size the next run
+        // of the query for twice as many, so it doesn't overflow and retry again.
+        executor_->addToCardinalityCache(cache_key, 2 * local_groups_buffer_entry_guess);
+      }
+      if (is_agg && is_out_of_output_memory(e.getErrorCode()) && !render_info) {
+        auto partitioned_result = executeGroupByInPartitions(
+            {ra_exe_unit, work_unit.body, local_groups_buffer_entry_guess},
+            targets_meta,
+            co,
+            eo,
+            queue_time_ms);
+        if (partitioned_result) {
+          return std::move(*partitioned_result);
+        }
+      }
       handlePersistentError(e.getErrorCode());
       return handleOutOfMemoryRetry(
           {ra_exe_unit, work_unit.body, local_groups_buffer_entry_guess},
@@ -2835,7 +3369,6 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
     }
   };
 
-  auto cache_key = ra_exec_unit_desc_for_caching(ra_exe_unit);
   try {
     auto cached_cardinality = executor_->getCachedCardinality(cache_key);
     auto card = cached_cardinality.second;
@@ -2857,10 +3390,11 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
           2 * std::min(groups_approx_upper_bound(table_infos),
                        getNDVEstimation(work_unit, e.range(), is_agg, co, eo));
       CHECK_GT(estimated_groups_buffer_entry_guess, size_t(0));
-      result = execute_and_handle_errors(estimated_groups_buffer_entry_guess, true);
+      // cached before the run, which grows the entry if the estimate overflows
       if (!(eo.just_validate || eo.just_explain)) {
         executor_->addToCardinalityCache(cache_key, estimated_groups_buffer_entry_guess);
       }
+      result = execute_and_handle_errors(estimated_groups_buffer_entry_guess, true);
     }
   }
 
@@ -2959,6 +3493,109 @@ bool RelAlgExecutor::isRowidLookup(const WorkUnit& work_unit) {
   return false;
 }
 
+std::optional<ExecutionResult> RelAlgExecutor::executeGroupByInPartitions(
+    const RelAlgExecutor::WorkUnit& work_unit,
+    const std::vector<TargetMetaInfo>& targets_meta,
+    const CompilationOptions& co,
+    const ExecutionOptions& eo,
+    const int64_t queue_time_ms) {
+  if (!g_group_by_partition_count || eo.just_validate || eo.just_explain) {
+    return std::nullopt;
+  }
+  const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
+  const auto partition_key =
+      get_group_by_partition_key(work_unit.exe_unit, table_infos, executor_);
+  if (!partition_key.first) {
+    return std::nullopt;
+  }
+  const auto co_cpu = CompilationOptions::makeCpuOnly(co);
+  const auto execute_partition = [&](const RelAlgExecutionUnit& ra_exe_unit) {
+    ColumnCacheMap column_cache;
+    size_t groups_buffer_entry_guess{0};
+    try {
+      return executor_->executeWorkUnit(groups_buffer_entry_guess,
+                                        true,
+                                        table_infos,
+                                        ra_exe_unit,
+                                        co_cpu,
+                                        eo,
+                                        cat_,
+                                        nullptr,
+                                        false,
+                                        column_cache);
+    } catch (const CardinalityEstimationRequired& e) {
+      const WorkUnit partition_work_unit{ra_exe_unit, work_unit.body, 0};
+      groups_buffer_entry_guess = 2 * std::min(groups_approx_upper_bound(table_infos),
+                                               getNDVEstimation(partition_work_unit,
+                                                                e.range(),
+                                                                true,
+                                                                co_cpu,
+                                                                eo));
+      CHECK_GT(groups_buffer_entry_guess, size_t(0));
+      return executor_->executeWorkUnit(groups_buffer_entry_guess,
+                                        true,
+                                        table_infos,
+                                        ra_exe_unit,
+                                        co_cpu,
+                                        eo,
+                                        cat_,
+                                        nullptr,
+                                        true,
+                                        column_cache);
+    }
+  };
+  // Each partition needs as many output slots as it has groups only, its results are
+  // appended to the ones of the previous partitions without a reduction since the
+  // partitions don't share groups.
+  for (size_t partition_count = g_group_by_partition_count;
+       partition_count <= 16 * g_group_by_partition_count;
+       partition_count *= 4) {
+    LOG(INFO) << "Running the group by in " << partition_count << " partitions on "
+              << partition_key.second->toString();
+    ResultSetPtr rows;
+    try {
+      for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+        auto partition_exe_unit = work_unit.exe_unit;
+        partition_exe_unit.quals.push_back(get_group_by_partition_qual(
+            partition_key, partition_count, partition_idx));
+        const auto ra_exe_unit =
+            decide_approx_count_distinct_implementation(partition_exe_unit,
+                                                        table_infos,
+                                                        executor_,
+                                                        co_cpu.device_type,
+                                                        target_exprs_owned_);
+        auto partition_rows = execute_partition(ra_exe_unit);
+        CHECK(partition_rows);
+        if (!rows) {
+          rows = partition_rows;
+          continue;
+        }
+        const auto& query_mem_desc = rows->getQueryMemDesc();
+        const auto& partition_query_mem_desc = partition_rows->getQueryMemDesc();
+        if (query_mem_desc.getQueryDescriptionType() !=
+                partition_query_mem_desc.getQueryDescriptionType() ||
+            query_mem_desc.didOutputColumnar() !=
+                partition_query_mem_desc.didOutputColumnar() ||
+            query_mem_desc.getRowSize() != partition_query_mem_desc.getRowSize()) {
+          LOG(WARNING) << "Group by partitions have different layouts, can't merge them";
+          return std::nullopt;
+        }
+        rows->append(*partition_rows);
+      }
+    } catch (const QueryExecutionError& e) {
+      if (!is_out_of_output_memory(e.getErrorCode())) {
+        throw;
+      }
+      LOG(WARNING) << "A group by partition ran out of output memory";
+      continue;
+    }
+    ExecutionResult result{rows, targets_meta};
+    result.setQueueTime(queue_time_ms);
+    return result;
+  }
+  return std::nullopt;
+}
+
 ExecutionResult RelAlgExecutor::handleOutOfMemoryRetry(
     const RelAlgExecutor::WorkUnit& work_unit,
     const std::vector<TargetMetaInfo>& targets_meta,
@@ -2999,7 +3636,10 @@ ExecutionResult RelAlgExecutor::handleOutOfMemoryRetry(
                                    false,
                                    eo.pending_query_interrupt_freq,
                                    eo.executor_type,
-                                   eo.outer_fragment_indices};
+                                   eo.outer_fragment_indices,
+                                   eo.force_loop_joins,
+                                   eo.max_kernel_parallelism,
+            eo.approximate_error};
 
   if (was_multifrag_kernel_launch) {
     try {
@@ -3060,6 +3700,21 @@ ExecutionResult RelAlgExecutor::handleOutOfMemoryRetry(
                                            column_cache),
                 targets_meta};
     } catch (const QueryExecutionError& e) {
+      // out of slots is retried with a larger guess first
+      const bool can_partition =
+          is_agg && is_out_of_output_memory(e.getErrorCode()) &&
+          (e.getErrorCode() >= 0 || g_enable_watchdog || iteration_ctr > 1);
+      if (can_partition) {
+        auto partitioned_result = executeGroupByInPartitions(
+            {ra_exe_unit_in, work_unit.body, max_groups_buffer_entry_guess},
+            targets_meta,
+            co_cpu,
+            eo_no_multifrag,
+            queue_time_ms);
+        if (partitioned_result) {
+          return std::move(*partitioned_result);
+        }
+      }
       // Ran out of slots
       if (e.getErrorCode() < 0) {
         // Even the conservative guess failed; it should only happen when we group
@@ -3137,6 +3792,8 @@ std::string RelAlgExecutor::getErrorMessageFromCode(const int32_t error_code) {
       return "Multiple distinct values encountered";
     case Executor::ERR_GEOS:
       return "Geos call failure";
+    case Executor::ERR_QUERY_MEMORY_LIMIT:
+      return "Query exceeded its host memory limit";
   }
   return "Other error: code " + std::to_string(error_code);
 }
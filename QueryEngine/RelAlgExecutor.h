@@ -157,12 +157,50 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
 
   static std::string getErrorMessageFromCode(const int32_t error_code);
 
+  // The steps of the last query run with ExecutionOptions::profile_steps, as a tree laid
+  // out like EXPLAIN PLAN.
+  std::string getStepProfiles() const;
+
+  // The resources used by the steps run so far, for the query history.
+  const query_state::ResourceUsage& getResourceUsage() const { return resource_usage_; }
+
  private:
+  struct StepProfile {
+    size_t step_idx;
+    std::string body;
+    // -1 for the union branches, which run at the same time
+    int64_t time_ms;
+    size_t input_rows{0};
+    size_t input_fragments{0};
+    size_t output_rows{0};
+    int64_t compilation_time_ms{0};
+    int64_t queue_time_ms{0};
+    ExecutorDeviceType device_type{ExecutorDeviceType::CPU};
+    // summed over the kernels, with g_enable_perf_counters
+    logger::PerfCounterValues kernel_perf_counters;
+    // summed over the kernels, with g_enable_gpu_kernel_timing
+    CudaMgr_Namespace::GpuTimings kernel_gpu_timings;
+  };
+
+  void addStepProfile(const RaExecutionSequence& seq,
+                      const size_t step_idx,
+                      const int64_t time_ms);
+
+  void addStepResourceUsage(const RaExecutionSequence& seq, const size_t step_idx);
+
   ExecutionResult executeRelAlgQueryNoRetry(const CompilationOptions& co,
                                             const ExecutionOptions& eo,
                                             const bool just_explain_plan,
                                             RenderInfo* render_info);
 
+  // Runs the steps in interval, which are independent branches of a union, at the same
+  // time on executors of their own.
+  void executeUnionBranches(const RaExecutionSequence& seq,
+                            const std::pair<size_t, size_t> interval,
+                            const CompilationOptions& co,
+                            const ExecutionOptions& eo,
+                            const int64_t queue_time_ms);
+
   void executeRelAlgStep(const RaExecutionSequence& seq,
                          const size_t step_idx,
                          const CompilationOptions&,
@@ -215,6 +253,7 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
   std::unique_ptr<WindowFunctionContext> createWindowFunctionContext(
       const Analyzer::WindowFunction* window_func,
       const std::shared_ptr<Analyzer::BinOper>& partition_key_cond,
+      const std::shared_ptr<JoinHashTableInterface>& partitions,
       const RelAlgExecutionUnit& ra_exe_unit,
       const std::vector<InputTableInfo>& query_infos,
       const CompilationOptions& co,
@@ -278,6 +317,13 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                           const CompilationOptions& co,
                           const ExecutionOptions& eo);
 
+  size_t runNDVEstimator(const WorkUnit& work_unit,
+                         const int64_t range,
+                         const bool is_agg,
+                         const CompilationOptions& co,
+                         const ExecutionOptions& eo,
+                         const std::vector<InputTableInfo>& table_infos);
+
   std::optional<size_t> getFilteredCountAll(const WorkUnit& work_unit,
                                             const bool is_agg,
                                             const CompilationOptions& co,
@@ -304,6 +350,15 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                                          const bool was_multifrag_kernel_launch,
                                          const int64_t queue_time_ms);
 
+  // Runs a group by aggregate whose result doesn't fit the output buffers on CPU, one
+  // partition of the groups at a time. Returns nullopt if its keys can't be partitioned.
+  std::optional<ExecutionResult> executeGroupByInPartitions(
+      const RelAlgExecutor::WorkUnit& work_unit,
+      const std::vector<TargetMetaInfo>& targets_meta,
+      const CompilationOptions& co,
+      const ExecutionOptions& eo,
+      const int64_t queue_time_ms);
+
   // Allows an out of memory error through if CPU retry is enabled. Otherwise, throws an
   // appropriate exception corresponding to the query error code.
   static void handlePersistentError(const int32_t error_code);
@@ -370,6 +425,8 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
   std::vector<std::shared_ptr<Analyzer::Expr>> target_exprs_owned_;  // TODO(alex): remove
   std::unordered_map<unsigned, AggregatedResult> leaf_results_;
   int64_t queue_time_ms_;
+  std::vector<StepProfile> step_profiles_;
+  query_state::ResourceUsage resource_usage_;
   static SpeculativeTopNBlacklist speculative_topn_blacklist_;
   static const size_t max_groups_buffer_entry_default_guess{16384};
 
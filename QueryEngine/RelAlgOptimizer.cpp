@@ -19,10 +19,14 @@
 #include "RexVisitor.h"
 #include "Visitors/RexSubQueryIdCollector.h"
 
+#include <algorithm>
 #include <numeric>
 #include <string>
+#include <typeinfo>
 #include <unordered_map>
 
+bool g_enable_common_subplan_elimination{true};
+
 namespace {
 
 class RexProjectInputRedirector : public RexDeepCopyVisitor {
@@ -87,6 +91,30 @@ class RexRebindInputsVisitor : public RexVisitor<void*> {
       visit(filter->getCondition());
       return;
     }
+    if (auto compound = dynamic_cast<const RelCompound*>(node)) {
+      if (auto filter_expr = compound->getFilterExpr()) {
+        visit(filter_expr);
+      }
+      for (size_t i = 0; i < compound->getScalarSourcesSize(); ++i) {
+        visit(compound->getScalarSource(i));
+      }
+      return;
+    }
+    if (auto join = dynamic_cast<const RelLeftDeepInnerJoin*>(node)) {
+      if (auto inner_condition = join->getInnerCondition()) {
+        visit(inner_condition);
+      }
+      for (size_t nesting_level = 1; nesting_level < join->inputCount();
+           ++nesting_level) {
+        if (auto outer_condition = join->getOuterCondition(nesting_level)) {
+          visit(outer_condition);
+        }
+      }
+      return;
+    }
+    if (dynamic_cast<const RelLogicalUnion*>(node)) {
+      return;
+    }
     CHECK(false);
   }
 
@@ -1748,3 +1776,416 @@ void simplify_sort(std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept {
   }
   nodes.swap(new_nodes);
 }
+
+namespace {
+
+// Appends the nodes reachable from node to order, inputs before their users.
+void collect_in_topological_order(const RelAlgNode* node,
+                                  std::unordered_set<const RelAlgNode*>& visited,
+                                  std::vector<const RelAlgNode*>& order) {
+  if (!visited.insert(node).second) {
+    return;
+  }
+  for (size_t i = 0; i < node->inputCount(); ++i) {
+    collect_in_topological_order(node->getInput(i), visited, order);
+  }
+  order.push_back(node);
+}
+
+std::vector<const RelAlgNode*> get_topological_order(const RelAlgNode* sink) {
+  std::unordered_set<const RelAlgNode*> visited;
+  std::vector<const RelAlgNode*> order;
+  collect_in_topological_order(sink, visited, order);
+  return order;
+}
+
+// The nodes the RexInputs of a node can refer to: its inputs, with the inputs of joins
+// taking the place of the joins.
+void collect_rex_input_sources(const RelAlgNode* node,
+                               std::vector<const RelAlgNode*>& sources) {
+  for (size_t i = 0; i < node->inputCount(); ++i) {
+    const auto input = node->getInput(i);
+    if (dynamic_cast<const RelJoin*>(input) ||
+        dynamic_cast<const RelLeftDeepInnerJoin*>(input)) {
+      collect_rex_input_sources(input, sources);
+    } else {
+      sources.push_back(input);
+    }
+  }
+}
+
+std::vector<const RelAlgNode*> get_rex_input_sources(const RelAlgNode* node) {
+  std::vector<const RelAlgNode*> sources;
+  collect_rex_input_sources(node, sources);
+  return sources;
+}
+
+// Structural comparison of two nodes with equivalent inputs. RexInputs are equal if they
+// refer to the same column of sources at the same position.
+class SubplanComparator {
+ public:
+  SubplanComparator(const RelAlgNode* lhs, const RelAlgNode* rhs)
+      : lhs_(lhs)
+      , rhs_(rhs)
+      , lhs_sources_(get_rex_input_sources(lhs))
+      , rhs_sources_(get_rex_input_sources(rhs)) {}
+
+  bool equalNodes() const {
+    if (typeid(*lhs_) != typeid(*rhs_) || lhs_->inputCount() != rhs_->inputCount() ||
+        lhs_sources_.size() != rhs_sources_.size()) {
+      return false;
+    }
+    if (auto lhs_scan = dynamic_cast<const RelScan*>(lhs_)) {
+      auto rhs_scan = static_cast<const RelScan*>(rhs_);
+      return lhs_scan->getTableDescriptor() == rhs_scan->getTableDescriptor() &&
+             lhs_scan->getFieldNames() == rhs_scan->getFieldNames();
+    }
+    if (auto lhs_project = dynamic_cast<const RelProject*>(lhs_)) {
+      auto rhs_project = static_cast<const RelProject*>(rhs_);
+      if (lhs_project->getFields() != rhs_project->getFields()) {
+        return false;
+      }
+      for (size_t i = 0; i < lhs_project->size(); ++i) {
+        if (!equalRex(lhs_project->getProjectAt(i), rhs_project->getProjectAt(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    if (auto lhs_filter = dynamic_cast<const RelFilter*>(lhs_)) {
+      auto rhs_filter = static_cast<const RelFilter*>(rhs_);
+      return equalRex(lhs_filter->getCondition(), rhs_filter->getCondition());
+    }
+    if (auto lhs_aggregate = dynamic_cast<const RelAggregate*>(lhs_)) {
+      auto rhs_aggregate = static_cast<const RelAggregate*>(rhs_);
+      if (lhs_aggregate->getGroupByCount() != rhs_aggregate->getGroupByCount() ||
+          lhs_aggregate->getFields() != rhs_aggregate->getFields() ||
+          lhs_aggregate->getAggExprsCount() != rhs_aggregate->getAggExprsCount()) {
+        return false;
+      }
+      for (size_t i = 0; i < lhs_aggregate->getAggExprsCount(); ++i) {
+        if (!equalAgg(lhs_aggregate->getAggExprs()[i].get(),
+                      rhs_aggregate->getAggExprs()[i].get())) {
+          return false;
+        }
+      }
+      return true;
+    }
+    if (auto lhs_compound = dynamic_cast<const RelCompound*>(lhs_)) {
+      return equalCompounds(lhs_compound, static_cast<const RelCompound*>(rhs_));
+    }
+    if (auto lhs_sort = dynamic_cast<const RelSort*>(lhs_)) {
+      return *lhs_sort == *static_cast<const RelSort*>(rhs_);
+    }
+    if (auto lhs_join = dynamic_cast<const RelJoin*>(lhs_)) {
+      auto rhs_join = static_cast<const RelJoin*>(rhs_);
+      return lhs_join->getJoinType() == rhs_join->getJoinType() &&
+             equalRex(lhs_join->getCondition(), rhs_join->getCondition());
+    }
+    if (auto lhs_join = dynamic_cast<const RelLeftDeepInnerJoin*>(lhs_)) {
+      auto rhs_join = static_cast<const RelLeftDeepInnerJoin*>(rhs_);
+      if (!equalRex(lhs_join->getInnerCondition(), rhs_join->getInnerCondition())) {
+        return false;
+      }
+      for (size_t nesting_level = 1; nesting_level < lhs_join->inputCount();
+           ++nesting_level) {
+        if (!equalRex(lhs_join->getOuterCondition(nesting_level),
+                      rhs_join->getOuterCondition(nesting_level))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    if (auto lhs_union = dynamic_cast<const RelLogicalUnion*>(lhs_)) {
+      return lhs_union->isAll() == static_cast<const RelLogicalUnion*>(rhs_)->isAll();
+    }
+    // Values, table functions and modify nodes are never considered equal.
+    return false;
+  }
+
+ private:
+  bool equalCompounds(const RelCompound* lhs, const RelCompound* rhs) const {
+    if (lhs->getGroupByCount() != rhs->getGroupByCount() ||
+        lhs->isAggregate() != rhs->isAggregate() ||
+        lhs->getFields() != rhs->getFields() ||
+        lhs->getScalarSourcesSize() != rhs->getScalarSourcesSize() ||
+        !equalRex(lhs->getFilterExpr(), rhs->getFilterExpr())) {
+      return false;
+    }
+    for (size_t i = 0; i < lhs->getScalarSourcesSize(); ++i) {
+      if (!equalRex(lhs->getScalarSource(i), rhs->getScalarSource(i))) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < lhs->size(); ++i) {
+      const auto lhs_agg = dynamic_cast<const RexAgg*>(lhs->getTargetExpr(i));
+      const auto rhs_agg = dynamic_cast<const RexAgg*>(rhs->getTargetExpr(i));
+      if (lhs_agg || rhs_agg) {
+        if (!lhs_agg || !rhs_agg || !equalAgg(lhs_agg, rhs_agg)) {
+          return false;
+        }
+        continue;
+      }
+      if (!equalRex(dynamic_cast<const RexScalar*>(lhs->getTargetExpr(i)),
+                    dynamic_cast<const RexScalar*>(rhs->getTargetExpr(i)))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool equalAgg(const RexAgg* lhs, const RexAgg* rhs) const {
+    if (lhs->getKind() != rhs->getKind() || lhs->isDistinct() != rhs->isDistinct() ||
+        !(lhs->getType() == rhs->getType()) || lhs->size() != rhs->size()) {
+      return false;
+    }
+    for (size_t i = 0; i < lhs->size(); ++i) {
+      if (lhs->getOperand(i) != rhs->getOperand(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool equalRex(const RexScalar* lhs, const RexScalar* rhs) const {
+    if (!lhs || !rhs) {
+      return lhs == rhs;
+    }
+    if (typeid(*lhs) != typeid(*rhs)) {
+      return false;
+    }
+    if (auto lhs_input = dynamic_cast<const RexInput*>(lhs)) {
+      auto rhs_input = static_cast<const RexInput*>(rhs);
+      const auto lhs_it = std::find(
+          lhs_sources_.begin(), lhs_sources_.end(), lhs_input->getSourceNode());
+      const auto rhs_it = std::find(
+          rhs_sources_.begin(), rhs_sources_.end(), rhs_input->getSourceNode());
+      return lhs_it != lhs_sources_.end() && rhs_it != rhs_sources_.end() &&
+             lhs_it - lhs_sources_.begin() == rhs_it - rhs_sources_.begin() &&
+             lhs_input->getIndex() == rhs_input->getIndex();
+    }
+    if (auto lhs_literal = dynamic_cast<const RexLiteral*>(lhs)) {
+      auto rhs_literal = static_cast<const RexLiteral*>(rhs);
+      return lhs_literal->getType() == rhs_literal->getType() &&
+             lhs_literal->getTargetType() == rhs_literal->getTargetType() &&
+             lhs_literal->getScale() == rhs_literal->getScale() &&
+             lhs_literal->getPrecision() == rhs_literal->getPrecision() &&
+             lhs_literal->getTypeScale() == rhs_literal->getTypeScale() &&
+             lhs_literal->getTypePrecision() == rhs_literal->getTypePrecision() &&
+             lhs_literal->toString() == rhs_literal->toString();
+    }
+    if (auto lhs_ref = dynamic_cast<const RexRef*>(lhs)) {
+      return lhs_ref->getIndex() == static_cast<const RexRef*>(rhs)->getIndex();
+    }
+    if (auto lhs_case = dynamic_cast<const RexCase*>(lhs)) {
+      auto rhs_case = static_cast<const RexCase*>(rhs);
+      if (lhs_case->branchCount() != rhs_case->branchCount() ||
+          !equalRex(lhs_case->getElse(), rhs_case->getElse())) {
+        return false;
+      }
+      for (size_t i = 0; i < lhs_case->branchCount(); ++i) {
+        if (!equalRex(lhs_case->getWhen(i), rhs_case->getWhen(i)) ||
+            !equalRex(lhs_case->getThen(i), rhs_case->getThen(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    if (dynamic_cast<const RexWindowFunctionOperator*>(lhs)) {
+      return false;
+    }
+    if (auto lhs_operator = dynamic_cast<const RexOperator*>(lhs)) {
+      auto rhs_operator = static_cast<const RexOperator*>(rhs);
+      if (lhs_operator->getOperator() != rhs_operator->getOperator() ||
+          !(lhs_operator->getType() == rhs_operator->getType()) ||
+          lhs_operator->size() != rhs_operator->size()) {
+        return false;
+      }
+      if (auto lhs_function = dynamic_cast<const RexFunctionOperator*>(lhs)) {
+        if (lhs_function->getName() !=
+            static_cast<const RexFunctionOperator*>(rhs)->getName()) {
+          return false;
+        }
+      }
+      for (size_t i = 0; i < lhs_operator->size(); ++i) {
+        if (!equalRex(lhs_operator->getOperand(i), rhs_operator->getOperand(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    // Subqueries are executed and reused on their own.
+    return false;
+  }
+
+  const RelAlgNode* lhs_;
+  const RelAlgNode* rhs_;
+  const std::vector<const RelAlgNode*> lhs_sources_;
+  const std::vector<const RelAlgNode*> rhs_sources_;
+};
+
+// Nodes whose result can be materialized once and read by several users.
+bool is_shareable(const RelAlgNode* node) {
+  return dynamic_cast<const RelCompound*>(node) ||
+         dynamic_cast<const RelProject*>(node) ||
+         dynamic_cast<const RelAggregate*>(node) ||
+         dynamic_cast<const RelFilter*>(node) || dynamic_cast<const RelSort*>(node) ||
+         dynamic_cast<const RelLogicalUnion*>(node);
+}
+
+std::unordered_map<const RelAlgNode*, std::unordered_set<const RelAlgNode*>> get_users(
+    const std::vector<const RelAlgNode*>& nodes) {
+  std::unordered_map<const RelAlgNode*, std::unordered_set<const RelAlgNode*>> users;
+  for (const auto node : nodes) {
+    for (size_t i = 0; i < node->inputCount(); ++i) {
+      users[node->getInput(i)].insert(node);
+    }
+  }
+  return users;
+}
+
+// Returns true if the users of duplicate can read original instead: a sort has to be the
+// only user of its input and no node can read the same source twice.
+bool can_redirect_users(
+    const RelAlgNode* duplicate,
+    const RelAlgNode* original,
+    const std::vector<const RelAlgNode*>& nodes,
+    const std::unordered_map<const RelAlgNode*, std::unordered_set<const RelAlgNode*>>&
+        users) {
+  for (const auto node : {duplicate, original}) {
+    const auto users_it = users.find(node);
+    CHECK(users_it != users.end());
+    for (const auto user : users_it->second) {
+      if (dynamic_cast<const RelSort*>(user)) {
+        return false;
+      }
+    }
+  }
+  for (const auto node : nodes) {
+    const auto sources = get_rex_input_sources(node);
+    if (std::find(sources.begin(), sources.end(), duplicate) != sources.end() &&
+        std::find(sources.begin(), sources.end(), original) != sources.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+/**
+ * Identical subtrees, e.g. the copies of a common table expression referenced several
+ * times, are executed once: the users of each copy are redirected to the first one,
+ * whose result then stays in the temporary tables for all of them.
+ */
+void eliminate_common_subplans(std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept {
+  if (nodes.empty()) {
+    return;
+  }
+  std::unordered_map<const RelAlgNode*, std::shared_ptr<RelAlgNode>> deconst_mapping;
+  for (const auto& node : nodes) {
+    if (!node) {
+      continue;
+    }
+    if (dynamic_cast<const RelModify*>(node.get()) ||
+        dynamic_cast<const RelTableFunction*>(node.get())) {
+      return;
+    }
+    if (auto target = dynamic_cast<const ModifyManipulationTarget*>(node.get())) {
+      if (target->isUpdateViaSelect() || target->isDeleteViaSelect()) {
+        return;
+      }
+    }
+    deconst_mapping.emplace(node.get(), node);
+  }
+  const auto sink = nodes.back().get();
+  const auto initial_order = get_topological_order(sink);
+  for (const auto node : initial_order) {
+    if (!deconst_mapping.count(node)) {
+      return;
+    }
+  }
+
+  // Group the nodes into classes of equivalent subtrees, bottom up.
+  std::unordered_map<const RelAlgNode*, const RelAlgNode*> class_of;
+  std::unordered_map<const RelAlgNode*, std::vector<const RelAlgNode*>> class_members;
+  std::unordered_map<std::string, std::vector<const RelAlgNode*>> classes_by_inputs;
+  for (const auto node : initial_order) {
+    std::string key = typeid(*node).name();
+    for (size_t i = 0; i < node->inputCount(); ++i) {
+      key += "," + std::to_string(class_of[node->getInput(i)]->getId());
+    }
+    auto& candidates = classes_by_inputs[key];
+    const RelAlgNode* node_class{node};
+    for (const auto candidate : candidates) {
+      if (SubplanComparator(candidate, node).equalNodes()) {
+        node_class = candidate;
+        break;
+      }
+    }
+    if (node_class == node) {
+      candidates.push_back(node);
+    }
+    class_of[node] = node_class;
+    class_members[node_class].push_back(node);
+  }
+
+  // Redirect the users of the copies top down, so that the largest copies are shared.
+  auto order = initial_order;
+  auto users = get_users(order);
+  for (auto it = initial_order.rbegin(); it != initial_order.rend(); ++it) {
+    const auto duplicate = *it;
+    if (duplicate == sink || !users.count(duplicate) || !is_shareable(duplicate)) {
+      continue;
+    }
+    const auto& members = class_members[class_of[duplicate]];
+    if (members.size() < 2) {
+      continue;
+    }
+    const RelAlgNode* original{nullptr};
+    for (const auto member : members) {
+      if (member != duplicate && users.count(member)) {
+        original = member;
+        break;
+      }
+    }
+    if (!original || !can_redirect_users(duplicate, original, order, users)) {
+      continue;
+    }
+    VLOG(1) << "Sharing the result of node " << original->getId() << " with the users of "
+            << duplicate->getId();
+    const auto old_input = deconst_mapping[duplicate];
+    const auto new_input = deconst_mapping[original];
+    RexRebindInputsVisitor rebind_inputs(duplicate, original);
+    for (const auto node : order) {
+      auto& user = deconst_mapping[node];
+      while (user->hasInput(duplicate)) {
+        user->RelAlgNode::replaceInput(old_input, new_input);
+      }
+      if (!dynamic_cast<const RelScan*>(node) &&
+          !dynamic_cast<const RelLogicalValues*>(node)) {
+        rebind_inputs.visitNode(node);
+      }
+    }
+    order = get_topological_order(sink);
+    users = get_users(order);
+  }
+
+  if (order.size() == initial_order.size()) {
+    return;
+  }
+  const std::unordered_set<const RelAlgNode*> live_nodes(order.begin(), order.end());
+  std::unordered_set<const RelAlgNode*> dead_nodes;
+  for (const auto node : initial_order) {
+    if (!live_nodes.count(node)) {
+      dead_nodes.insert(node);
+    }
+  }
+  std::vector<std::shared_ptr<RelAlgNode>> new_nodes;
+  for (const auto& node : nodes) {
+    if (node && !dead_nodes.count(node.get())) {
+      new_nodes.push_back(node);
+    }
+  }
+  nodes.swap(new_nodes);
+}
@@ -22,6 +22,8 @@
 #include <unordered_set>
 #include <vector>
 
+extern bool g_enable_common_subplan_elimination;
+
 class RelAlgNode;
 class RexSubQuery;
 
@@ -37,5 +39,6 @@ void hoist_filter_cond_to_cross_join(
 void simplify_sort(std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept;
 void sink_projected_boolean_expr_to_join(
     std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept;
+void eliminate_common_subplans(std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept;
 
 #endif  // QUERYENGINE_RELALGOPTIMIZER_H
@@ -216,6 +216,9 @@ bool is_agg_supported_for_type(const SQLAgg& agg_kind, const SQLTypeInfo& arg_ti
       !(arg_ti.is_number() || arg_ti.is_boolean() || arg_ti.is_time())) {
     return false;
   }
+  if (agg_kind == kAPPROX_QUANTILE && !arg_ti.is_number()) {
+    return false;
+  }
 
   return true;
 }
@@ -229,21 +232,35 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
   const bool is_distinct = rex->isDistinct();
   const bool takes_arg{rex->size() > 0};
   std::shared_ptr<Analyzer::Expr> arg_expr;
-  std::shared_ptr<Analyzer::Constant> err_rate;
+  std::shared_ptr<Analyzer::Constant> arg1;  // 2nd aggregate parameter
   if (takes_arg) {
     const auto operand = rex->getOperand(0);
     CHECK_LT(operand, scalar_sources.size());
     CHECK_LE(rex->size(), 2u);
     arg_expr = scalar_sources[operand];
     if (agg_kind == kAPPROX_COUNT_DISTINCT && rex->size() == 2) {
-      err_rate = std::dynamic_pointer_cast<Analyzer::Constant>(
+      arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
           scalar_sources[rex->getOperand(1)]);
-      if (!err_rate || err_rate->get_type_info().get_type() != kINT ||
-          err_rate->get_constval().intval < 1 || err_rate->get_constval().intval > 100) {
+      if (!arg1 || arg1->get_type_info().get_type() != kINT ||
+          arg1->get_constval().intval < 1 || arg1->get_constval().intval > 100) {
         throw std::runtime_error(
             "APPROX_COUNT_DISTINCT's second parameter should be SMALLINT literal between "
             "1 and 100");
       }
+    } else if (agg_kind == kAPPROX_QUANTILE) {
+      CHECK_EQ(rex->size(), 2u);
+      const auto quantile = std::dynamic_pointer_cast<Analyzer::Constant>(
+          scalar_sources[rex->getOperand(1)]);
+      if (quantile && quantile->get_type_info().is_number() && !quantile->get_is_null()) {
+        arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
+            quantile->deep_copy()->add_cast(SQLTypeInfo(kDOUBLE, true)));
+      }
+      if (!arg1 || arg1->get_constval().doubleval < 0 ||
+          arg1->get_constval().doubleval > 1) {
+        throw std::runtime_error(
+            "APPROX_QUANTILE's second parameter should be a numeric literal between 0 "
+            "and 1");
+      }
     }
     const auto& arg_ti = arg_expr->get_type_info();
     if (!is_agg_supported_for_type(agg_kind, arg_ti)) {
@@ -252,7 +269,7 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
     }
   }
   const auto agg_ti = get_agg_type(agg_kind, arg_expr.get());
-  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, err_rate);
+  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLiteral(
@@ -1200,7 +1217,8 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateSampleRatio(
     const auto& double_ti = SQLTypeInfo(kDOUBLE, arg_ti.get_notnull());
     arg = arg->add_cast(double_ti);
   }
-  return makeExpr<Analyzer::SampleRatioExpr>(arg);
+  return makeExpr<Analyzer::SampleRatioExpr>(
+      arg, rex_function->getName() == "SAMPLE_FRAGMENTS"sv);
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateCurrentUser(
@@ -1412,7 +1430,7 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateFunction(
   if (rex_function->getName() == "KEY_FOR_STRING"sv) {
     return translateKeyForString(rex_function);
   }
-  if (rex_function->getName() == "SAMPLE_RATIO"sv) {
+  if (func_resolve(rex_function->getName(), "SAMPLE_RATIO"sv, "SAMPLE_FRAGMENTS"sv)) {
     return translateSampleRatio(rex_function);
   }
   if (rex_function->getName() == "CURRENT_USER"sv) {
@@ -1660,14 +1678,99 @@ bool supported_upper_bound(const RexWindowFunctionOperator* rex_window_function)
   }
 }
 
+// Aggregates over a ROWS frame are evaluated per partition with segment trees, any
+// combination of unbounded, current row and constant offset bounds is supported.
+bool is_rows_frame_aggregate(const RexWindowFunctionOperator* rex_window_function) {
+  if (!rex_window_function->isRows()) {
+    return false;
+  }
+  switch (rex_window_function->getKind()) {
+    case SqlWindowFunctionKind::AVG:
+    case SqlWindowFunctionKind::MIN:
+    case SqlWindowFunctionKind::MAX:
+    case SqlWindowFunctionKind::SUM:
+    case SqlWindowFunctionKind::SUM_INTERNAL:
+    case SqlWindowFunctionKind::COUNT: {
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
 }  // namespace
 
+std::shared_ptr<Analyzer::RowsFrame> RelAlgTranslator::translateRowsFrame(
+    const RexWindowFunctionOperator* rex_window_function) const {
+  const auto translate_bound =
+      [this](const RexWindowFunctionOperator::RexWindowBound& window_bound,
+             bool& unbounded,
+             int64_t& offset) {
+        unbounded = window_bound.unbounded;
+        offset = 0;
+        if (window_bound.unbounded || window_bound.is_current_row) {
+          return;
+        }
+        CHECK(window_bound.offset);
+        const auto offset_expr = translateScalarRex(window_bound.offset.get());
+        const auto offset_constant =
+            std::dynamic_pointer_cast<const Analyzer::Constant>(offset_expr);
+        if (!offset_constant || offset_constant->get_is_null()) {
+          throw std::runtime_error("Frame offset must be a constant integer");
+        }
+        const auto& datum = offset_constant->get_constval();
+        switch (offset_constant->get_type_info().get_type()) {
+          case kTINYINT: {
+            offset = datum.tinyintval;
+            break;
+          }
+          case kSMALLINT: {
+            offset = datum.smallintval;
+            break;
+          }
+          case kINT: {
+            offset = datum.intval;
+            break;
+          }
+          case kBIGINT: {
+            offset = datum.bigintval;
+            break;
+          }
+          default: {
+            throw std::runtime_error("Frame offset must be a constant integer");
+          }
+        }
+        if (offset < 0) {
+          throw std::runtime_error("Frame offset must not be negative");
+        }
+        if (window_bound.preceding) {
+          offset = -offset;
+        }
+      };
+  auto rows_frame = std::make_shared<Analyzer::RowsFrame>();
+  translate_bound(rex_window_function->getLowerBound(),
+                  rows_frame->lower_unbounded,
+                  rows_frame->lower_offset);
+  translate_bound(rex_window_function->getUpperBound(),
+                  rows_frame->upper_unbounded,
+                  rows_frame->upper_offset);
+  if ((rows_frame->lower_unbounded && rex_window_function->getLowerBound().following) ||
+      (rows_frame->upper_unbounded && rex_window_function->getUpperBound().preceding)) {
+    throw std::runtime_error("Frame specification not supported");
+  }
+  return rows_frame;
+}
+
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
     const RexWindowFunctionOperator* rex_window_function) const {
-  if (!supported_lower_bound(rex_window_function->getLowerBound()) ||
-      !supported_upper_bound(rex_window_function) ||
-      ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) !=
-       rex_window_function->isRows())) {
+  std::shared_ptr<Analyzer::RowsFrame> rows_frame;
+  if (is_rows_frame_aggregate(rex_window_function)) {
+    rows_frame = translateRowsFrame(rex_window_function);
+  } else if (!supported_lower_bound(rex_window_function->getLowerBound()) ||
+             !supported_upper_bound(rex_window_function) ||
+             ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) !=
+              rex_window_function->isRows())) {
     throw std::runtime_error("Frame specification not supported");
   }
   std::vector<std::shared_ptr<Analyzer::Expr>> args;
@@ -1693,7 +1796,8 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
       args,
       partition_keys,
       order_keys,
-      translate_collation(rex_window_function->getCollation()));
+      translate_collation(rex_window_function->getCollation()),
+      rows_frame);
 }
 
 Analyzer::ExpressionPtrVector RelAlgTranslator::translateFunctionArgs(
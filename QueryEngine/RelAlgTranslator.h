@@ -142,6 +142,9 @@ class RelAlgTranslator {
   std::shared_ptr<Analyzer::Expr> translateWindowFunction(
       const RexWindowFunctionOperator*) const;
 
+  std::shared_ptr<Analyzer::RowsFrame> translateRowsFrame(
+      const RexWindowFunctionOperator*) const;
+
   Analyzer::ExpressionPtrVector translateFunctionArgs(const RexFunctionOperator*) const;
 
   std::shared_ptr<Analyzer::Expr> translateUnaryGeoFunction(
@@ -28,16 +28,21 @@
 #include "Execute.h"
 #include "GpuMemUtils.h"
 #include "InPlaceSort.h"
+#include "MurmurHash.h"
 #include "OutputBufferInitialization.h"
+#include "ResultSetSortImpl.h"
+#include "ResultSetSpool.h"
 #include "RuntimeFunctions.h"
 #include "Shared/SqlTypesLayout.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
 #include "Shared/threadpool.h"
+#include "TDigest.h"
 
 #include <algorithm>
 #include <bitset>
+#include <cmath>
 #include <future>
 #include <numeric>
 
@@ -329,6 +334,78 @@ void ResultSet::setCachedRowCount(const size_t row_count) const {
   cached_row_count_ = row_count;
 }
 
+namespace {
+
+constexpr size_t kNdvSampleSize{1 << 16};
+
+int64_t get_ndv_hash(const TargetValue& value) {
+  const auto scalar_value = boost::get<ScalarTargetValue>(&value);
+  if (!scalar_value) {
+    return 0;
+  }
+  if (const auto int_value = boost::get<int64_t>(scalar_value)) {
+    return *int_value;
+  }
+  if (const auto double_value = boost::get<double>(scalar_value)) {
+    return MurmurHash64A(double_value, sizeof(double), 0);
+  }
+  if (const auto float_value = boost::get<float>(scalar_value)) {
+    return MurmurHash64A(float_value, sizeof(float), 0);
+  }
+  const auto nullable_string = boost::get<NullableString>(scalar_value);
+  CHECK(nullable_string);
+  const auto str = boost::get<std::string>(nullable_string);
+  return str ? MurmurHash64A(str->data(), str->size(), 0) : 0;
+}
+
+}  // namespace
+
+void ResultSet::scaleSingleEntryAggregates(const double factor) {
+  CHECK(storage_);
+  CHECK(appended_storage_.empty());
+  storage_->scaleOneEntry(factor);
+}
+
+size_t ResultSet::getColumnNdvEstimate(const size_t col_idx) const {
+  CHECK_LT(col_idx, colCount());
+  std::lock_guard<std::mutex> lock(ndv_estimates_mutex_);
+  const auto it = ndv_estimates_.find(col_idx);
+  if (it != ndv_estimates_.end()) {
+    return it->second;
+  }
+  const size_t row_count = rowCount();
+  const size_t entry_count = entryCount();
+  std::vector<bool> targets_to_skip(colCount(), true);
+  targets_to_skip[col_idx] = false;
+  const size_t stride = std::max(entry_count / kNdvSampleSize, size_t(1));
+  std::unordered_map<int64_t, size_t> value_counts;
+  size_t sample_size{0};
+  for (size_t entry_idx = 0; entry_idx < entry_count; entry_idx += stride) {
+    const auto row = getRowAtNoTranslations(entry_idx, targets_to_skip);
+    if (row.empty()) {
+      continue;
+    }
+    CHECK_LT(col_idx, row.size());
+    ++value_counts[get_ndv_hash(row[col_idx])];
+    ++sample_size;
+  }
+  size_t ndv = value_counts.size();
+  if (stride > 1 && sample_size) {
+    // Guaranteed-error estimator: the values seen once in the sample stand for
+    // sqrt(rows / sample size) values each, the others are assumed to be all there are.
+    const auto singleton_count = std::count_if(
+        value_counts.begin(), value_counts.end(), [](const auto& value_count) {
+          return value_count.second == 1;
+        });
+    const auto estimate = std::sqrt(static_cast<double>(row_count) / sample_size) *
+                              singleton_count +
+                          (ndv - singleton_count);
+    ndv = std::min(std::max(static_cast<size_t>(estimate), ndv), row_count);
+  }
+  ndv_estimates_.emplace(col_idx, ndv);
+  return ndv;
+}
+
 size_t ResultSet::binSearchRowCount() const {
   if (!storage_) {
     return 0;
@@ -432,6 +509,14 @@ void ResultSet::addCompilationQueueTime(const int64_t compilation_queue_time) {
   timings_.compilation_queue_time += compilation_queue_time;
 }
 
+void ResultSet::addCompilationTime(const int64_t compilation_time) {
+  timings_.compilation_time += compilation_time;
+}
+
+void ResultSet::addReductionTime(const int64_t reduction_time) {
+  timings_.reduction_time += reduction_time;
+}
+
 int64_t ResultSet::getQueueTime() const {
   return timings_.executor_queue_time + timings_.kernel_queue_time +
          timings_.compilation_queue_time;
@@ -441,6 +526,85 @@ int64_t ResultSet::getRenderTime() const {
   return timings_.render_time;
 }
 
+int64_t ResultSet::getCompilationTime() const {
+  return timings_.compilation_time;
+}
+
+int64_t ResultSet::getReductionTime() const {
+  return timings_.reduction_time;
+}
+
+void ResultSet::setMemoryUsage(const QueryMemoryUsage& memory_usage) {
+  memory_usage_ = memory_usage;
+}
+
+const ResultSet::QueryMemoryUsage& ResultSet::getMemoryUsage() const {
+  return memory_usage_;
+}
+
+size_t ResultSet::spoolToDisk() {
+  if (!g_enable_result_spooling || !storage_ || !row_set_mem_owner_ ||
+      query_mem_desc_.getQueryDescriptionType() != QueryDescriptionType::Projection ||
+      query_mem_desc_.useStreamingTopN()) {
+    return 0;
+  }
+  // only the output buffers can be freed, the others belong to the arena of the query
+  std::vector<ResultSetStorage*> storages;
+  size_t total_bytes{0};
+  auto add_storage = [&](ResultSetStorage* storage) {
+    if (storage && storage->buff_is_provided_ &&
+        row_set_mem_owner_->hasOutputBuffer(storage->getUnderlyingBuffer())) {
+      storages.push_back(storage);
+      total_bytes += storage->query_mem_desc_.getBufferSizeBytes(device_type_);
+    }
+  };
+  add_storage(storage_.get());
+  for (auto& storage : appended_storage_) {
+    add_storage(storage.get());
+  }
+  if (total_bytes < g_result_spool_threshold_bytes) {
+    return 0;
+  }
+  auto timer = DEBUG_TIMER(__func__);
+  size_t spooled_bytes{0};
+  for (auto storage : storages) {
+    const auto num_bytes = storage->query_mem_desc_.getBufferSizeBytes(device_type_);
+    if (!num_bytes) {
+      continue;
+    }
+    std::unique_ptr<result_set::SpooledBuffer> spooled_buffer;
+    try {
+      spooled_buffer = std::make_unique<result_set::SpooledBuffer>(
+          storage->getUnderlyingBuffer(), num_bytes);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Keeping the result in memory: " << e.what();
+      break;
+    }
+    CHECK(row_set_mem_owner_->releaseOutputBuffer(storage->getUnderlyingBuffer()));
+    storage->buff_ = spooled_buffer->data();
+    spooled_buffers_.push_back(std::move(spooled_buffer));
+    spooled_bytes += num_bytes;
+  }
+  VLOG(1) << "Spooled " << spooled_bytes << " bytes of the result to disk";
+  return spooled_bytes;
+}
+
+void ResultSet::addKernelPerfCounters(const logger::PerfCounterValues& perf_counters) {
+  kernel_perf_counters_ += perf_counters;
+}
+
+const logger::PerfCounterValues& ResultSet::getKernelPerfCounters() const {
+  return kernel_perf_counters_;
+}
+
+void ResultSet::addKernelGpuTimings(const CudaMgr_Namespace::GpuTimings& gpu_timings) {
+  kernel_gpu_timings_ += gpu_timings;
+}
+
+const CudaMgr_Namespace::GpuTimings& ResultSet::getKernelGpuTimings() const {
+  return kernel_gpu_timings_;
+}
+
 void ResultSet::moveToBegin() const {
   crt_row_buff_idx_ = 0;
   fetched_so_far_ = 0;
@@ -474,7 +638,7 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
                      const size_t top_n) {
   auto timer = DEBUG_TIMER(__func__);
 
-  if (!storage_) {
+  if (!storage_ || external_sort_buffer_) {
     return;
   }
   CHECK_EQ(-1, cached_row_count_);
@@ -519,6 +683,10 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
 
   permutation_ = initPermutationBuffer(0, 1);
 
+  if (!use_heap && packedKeySort(order_entries)) {
+    return;
+  }
+
   auto compare = createComparator(order_entries, use_heap);
 
   if (use_heap) {
@@ -697,6 +865,121 @@ ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeCountDistinctCo
   return count_distinct_materialized_buffer;
 }
 
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::ResultSetComparator<
+    BUFFER_ITERATOR_TYPE>::materializeApproxQuantileColumns() {
+  for (const auto& order_entry : order_entries_) {
+    if (is_approx_quantile_target(result_set_->targets_[order_entry.tle_no - 1])) {
+      approx_quantile_materialized_buffers_.emplace_back(
+          materializeApproxQuantileColumn(order_entry));
+    }
+  }
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+std::vector<double>
+ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeApproxQuantileColumn(
+    const Analyzer::OrderEntry& order_entry) const {
+  std::vector<double> approx_quantile_materialized_buffer(
+      result_set_->query_mem_desc_.getEntryCount());
+  const size_t num_non_empty_entries = result_set_->permutation_.size();
+  const size_t worker_count = cpu_threads();
+  threadpool::FuturesThreadPool<void> thread_pool;
+  for (size_t i = 0,
+              start_entry = 0,
+              stride = (num_non_empty_entries + worker_count - 1) / worker_count;
+       i < worker_count && start_entry < num_non_empty_entries;
+       ++i, start_entry += stride) {
+    const auto end_entry = std::min(start_entry + stride, num_non_empty_entries);
+    thread_pool.spawn(
+        [this, &order_entry, &approx_quantile_materialized_buffer](const size_t start,
+                                                                   const size_t end) {
+          for (size_t i = start; i < end; ++i) {
+            const uint32_t permuted_idx = result_set_->permutation_[i];
+            const auto storage_lookup_result = result_set_->findStorage(permuted_idx);
+            const auto storage = storage_lookup_result.storage_ptr;
+            const auto off = storage_lookup_result.fixedup_entry_idx;
+            const auto value = buffer_itr_.getColumnInternal(
+                storage->buff_, off, order_entry.tle_no - 1, storage_lookup_result);
+            const auto t_digest = reinterpret_cast<const TDigest*>(value.i1);
+            approx_quantile_materialized_buffer[permuted_idx] =
+                t_digest ? t_digest->quantile() : NAN;
+          }
+        },
+        start_entry,
+        end_entry);
+  }
+  thread_pool.join();
+  return approx_quantile_materialized_buffer;
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::isFloatArgumentInput(
+    const Analyzer::OrderEntry& order_entry) const {
+  const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
+  const auto entry_ti = get_compact_type(agg_info);
+  bool float_argument_input = takes_float_argument(agg_info);
+  // Need to determine if the float value has been stored as float
+  // or if it has been compacted to a different (often larger 8 bytes)
+  // in distributed case the floats are actually 4 bytes
+  // TODO the above takes_float_argument() is widely used wonder if this problem
+  // exists elsewhere
+  if (entry_ti.get_type() == kFLOAT) {
+    const auto is_col_lazy =
+        !result_set_->lazy_fetch_info_.empty() &&
+        result_set_->lazy_fetch_info_[order_entry.tle_no - 1].is_lazily_fetched;
+    if (result_set_->query_mem_desc_.getPaddedSlotWidthBytes(order_entry.tle_no - 1) ==
+        sizeof(float)) {
+      float_argument_input =
+          result_set_->query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
+    }
+  }
+  return float_argument_input;
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::normalizeSortKeys(
+    const std::vector<uint32_t>& permutation,
+    const size_t start,
+    const size_t end,
+    std::vector<packed_key_sort::SortColumn>& columns) const {
+  CHECK_EQ(order_entries_.size(), columns.size());
+  auto column_it = columns.begin();
+  for (const auto& order_entry : order_entries_) {
+    const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
+    const auto entry_ti = get_compact_type(agg_info);
+    const bool float_argument_input = isFloatArgumentInput(order_entry);
+    auto& column = *column_it++;
+    for (size_t i = start; i < end; ++i) {
+      const auto storage_lookup_result = result_set_->findStorage(permutation[i]);
+      const auto v = buffer_itr_.getColumnInternal(
+          storage_lookup_result.storage_ptr->buff_,
+          storage_lookup_result.fixedup_entry_idx,
+          order_entry.tle_no - 1,
+          storage_lookup_result);
+      if (isNull(entry_ti, v, float_argument_input)) {
+        column.nulls[i] = 1;
+        continue;
+      }
+      if (v.isPair()) {
+        column.values[i] = packed_key_sort::normalize_fp(
+            pair_to_double({v.i1, v.i2}, entry_ti, float_argument_input),
+            order_entry.is_desc);
+      } else if (entry_ti.is_fp()) {
+        CHECK(v.isInt());
+        const double dval =
+            float_argument_input
+                ? *reinterpret_cast<const float*>(may_alias_ptr(&v.i1))
+                : *reinterpret_cast<const double*>(may_alias_ptr(&v.i1));
+        column.values[i] = packed_key_sort::normalize_fp(dval, order_entry.is_desc);
+      } else {
+        CHECK(v.isInt());
+        column.values[i] = packed_key_sort::normalize_int(v.i1, order_entry.is_desc);
+      }
+    }
+  }
+}
+
 template <typename BUFFER_ITERATOR_TYPE>
 bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
     const uint32_t lhs,
@@ -710,27 +993,13 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
   const auto fixedup_lhs = lhs_storage_lookup_result.fixedup_entry_idx;
   const auto fixedup_rhs = rhs_storage_lookup_result.fixedup_entry_idx;
   size_t materialized_count_distinct_buffer_idx{0};
+  size_t materialized_approx_quantile_buffer_idx{0};
 
   for (const auto& order_entry : order_entries_) {
     CHECK_GE(order_entry.tle_no, 1);
     const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
     const auto entry_ti = get_compact_type(agg_info);
-    bool float_argument_input = takes_float_argument(agg_info);
-    // Need to determine if the float value has been stored as float
-    // or if it has been compacted to a different (often larger 8 bytes)
-    // in distributed case the floats are actually 4 bytes
-    // TODO the above takes_float_argument() is widely used wonder if this problem
-    // exists elsewhere
-    if (entry_ti.get_type() == kFLOAT) {
-      const auto is_col_lazy =
-          !result_set_->lazy_fetch_info_.empty() &&
-          result_set_->lazy_fetch_info_[order_entry.tle_no - 1].is_lazily_fetched;
-      if (result_set_->query_mem_desc_.getPaddedSlotWidthBytes(order_entry.tle_no - 1) ==
-          sizeof(float)) {
-        float_argument_input =
-            result_set_->query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
-      }
-    }
+    const bool float_argument_input = isFloatArgumentInput(order_entry);
 
     const bool use_desc_cmp = use_heap_ ? !order_entry.is_desc : order_entry.is_desc;
 
@@ -748,6 +1017,28 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
       return use_desc_cmp ? lhs_sz > rhs_sz : lhs_sz < rhs_sz;
     }
 
+    if (UNLIKELY(is_approx_quantile_target(agg_info))) {
+      CHECK_LT(materialized_approx_quantile_buffer_idx,
+               approx_quantile_materialized_buffers_.size());
+      const auto& approx_quantile_materialized_buffer =
+          approx_quantile_materialized_buffers_[materialized_approx_quantile_buffer_idx];
+      const auto lhs_value = approx_quantile_materialized_buffer[lhs];
+      const auto rhs_value = approx_quantile_materialized_buffer[rhs];
+      ++materialized_approx_quantile_buffer_idx;
+      const bool lhs_is_null = std::isnan(lhs_value);
+      const bool rhs_is_null = std::isnan(rhs_value);
+      if (lhs_is_null && rhs_is_null) {
+        continue;
+      }
+      if (lhs_is_null || rhs_is_null) {
+        return (lhs_is_null == order_entry.nulls_first) != use_heap_;
+      }
+      if (lhs_value == rhs_value) {
+        continue;
+      }
+      return use_desc_cmp ? lhs_value > rhs_value : lhs_value < rhs_value;
+    }
+
     const auto lhs_v = buffer_itr_.getColumnInternal(lhs_storage->buff_,
                                                      fixedup_lhs,
                                                      order_entry.tle_no - 1,
@@ -849,6 +1140,128 @@ void ResultSet::sortPermutation(
   std::sort(permutation_.begin(), permutation_.end(), compare);
 }
 
+namespace {
+
+// Below this, sorting the permutation with the comparator is as fast.
+constexpr size_t kPackedKeySortMinEntries{10000};
+// The keys have to be copied to the device and the permutation back.
+constexpr size_t kPackedKeySortGpuMinEntries{size_t(1) << 22};
+
+}  // namespace
+
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::buildSortColumns(
+    const ResultSetComparator<BUFFER_ITERATOR_TYPE>& comparator,
+    std::vector<packed_key_sort::SortColumn>& columns) const {
+  const auto row_count = permutation_.size();
+  const size_t thread_count = std::max(
+      size_t(1), std::min(static_cast<size_t>(cpu_threads()), row_count / 100000));
+  const auto rows_per_thread = (row_count + thread_count - 1) / thread_count;
+  std::vector<std::future<void>> normalize_futures;
+  for (size_t start = 0; start < row_count; start += rows_per_thread) {
+    normalize_futures.emplace_back(std::async(
+        std::launch::async, [this, &comparator, &columns, start, rows_per_thread] {
+          comparator.normalizeSortKeys(
+              permutation_,
+              start,
+              std::min(start + rows_per_thread, permutation_.size()),
+              columns);
+        }));
+  }
+  for (auto& normalize_future : normalize_futures) {
+    normalize_future.wait();
+  }
+  for (auto& normalize_future : normalize_futures) {
+    normalize_future.get();
+  }
+}
+
+bool ResultSet::canNormalizeSortKeys(
+    const std::vector<TargetInfo>& targets,
+    const std::list<Analyzer::OrderEntry>& order_entries) {
+  for (const auto& order_entry : order_entries) {
+    CHECK_GE(order_entry.tle_no, 1);
+    CHECK_LE(static_cast<size_t>(order_entry.tle_no), targets.size());
+    const auto& agg_info = targets[order_entry.tle_no - 1];
+    const auto entry_ti = get_compact_type(agg_info);
+    // dictionary encoded strings are ordered by their string, not their id
+    if (is_distinct_target(agg_info) || is_approx_quantile_target(agg_info) ||
+        !(entry_ti.is_integer() || entry_ti.is_decimal() || entry_ti.is_fp() ||
+          entry_ti.is_boolean() || entry_ti.is_time())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<packed_key_sort::SortColumn> ResultSet::getNormalizedSortKeys(
+    const std::list<Analyzer::OrderEntry>& order_entries) {
+  CHECK(storage_);
+  CHECK(appended_storage_.empty());
+  CHECK(canNormalizeSortKeys(targets_, order_entries));
+  permutation_ = initPermutationBuffer(0, 1);
+  return makeSortColumns(order_entries);
+}
+
+std::vector<packed_key_sort::SortColumn> ResultSet::makeSortColumns(
+    const std::list<Analyzer::OrderEntry>& order_entries) const {
+  std::vector<packed_key_sort::SortColumn> columns(order_entries.size());
+  auto order_entry_it = order_entries.begin();
+  for (auto& column : columns) {
+    column.values.resize(permutation_.size());
+    column.nulls.resize(permutation_.size());
+    column.nulls_first = order_entry_it->nulls_first;
+    ++order_entry_it;
+  }
+  if (query_mem_desc_.didOutputColumnar()) {
+    buildSortColumns(
+        ResultSetComparator<ColumnWiseTargetAccessor>(order_entries, false, this),
+        columns);
+  } else {
+    buildSortColumns(
+        ResultSetComparator<RowWiseTargetAccessor>(order_entries, false, this), columns);
+  }
+  return columns;
+}
+
+bool ResultSet::packedKeySort(const std::list<Analyzer::OrderEntry>& order_entries) {
+  if (!g_enable_packed_key_sort || permutation_.size() < kPackedKeySortMinEntries ||
+      !canNormalizeSortKeys(targets_, order_entries)) {
+    return false;
+  }
+  auto timer = DEBUG_TIMER(__func__);
+  auto columns = makeSortColumns(order_entries);
+  const auto keys = packed_key_sort::pack(columns);
+  if (!keys) {
+    return false;
+  }
+  columns.clear();
+  std::vector<uint32_t> sorted_rows;
+#ifdef HAVE_CUDA
+  const auto data_mgr = getDataManager();
+  if (permutation_.size() >= kPackedKeySortGpuMinEntries && data_mgr &&
+      getGpuCount() > 0) {
+    try {
+      data_mgr->getCudaMgr()->setContext(0);
+      sorted_rows = packed_key_sort_on_gpu(keys->words, keys->row_count, data_mgr, 0);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Packed key sort failed on GPU, sorting on CPU: " << e.what();
+      sorted_rows.clear();
+    }
+  }
+#endif  // HAVE_CUDA
+  if (sorted_rows.empty()) {
+    sorted_rows = packed_key_sort::sort(*keys, cpu_threads());
+  }
+  CHECK_EQ(permutation_.size(), sorted_rows.size());
+  std::vector<uint32_t> permutation(permutation_.size());
+  for (size_t i = 0; i < sorted_rows.size(); ++i) {
+    permutation[i] = permutation_[sorted_rows[i]];
+  }
+  permutation_.swap(permutation);
+  return true;
+}
+
 void ResultSet::radixSortOnGpu(
     const std::list<Analyzer::OrderEntry>& order_entries) const {
   auto timer = DEBUG_TIMER(__func__);
@@ -949,15 +1362,22 @@ bool ResultSet::isDirectColumnarConversionPossible() const {
   } else if (query_mem_desc_.didOutputColumnar()) {
     return permutation_.empty() && (query_mem_desc_.getQueryDescriptionType() ==
                                         QueryDescriptionType::Projection ||
-                                    (query_mem_desc_.getQueryDescriptionType() ==
-                                         QueryDescriptionType::GroupByPerfectHash ||
-                                     query_mem_desc_.getQueryDescriptionType() ==
-                                         QueryDescriptionType::GroupByBaselineHash));
+                                    (appended_storage_.empty() &&
+                                     (query_mem_desc_.getQueryDescriptionType() ==
+                                          QueryDescriptionType::GroupByPerfectHash ||
+                                      query_mem_desc_.getQueryDescriptionType() ==
+                                          QueryDescriptionType::GroupByBaselineHash)));
   } else {
-    return permutation_.empty() && (query_mem_desc_.getQueryDescriptionType() ==
-                                        QueryDescriptionType::GroupByPerfectHash ||
-                                    query_mem_desc_.getQueryDescriptionType() ==
-                                        QueryDescriptionType::GroupByBaselineHash);
+    // the group by path only reads the entries of the main storage, row-wise projections
+    // go through it too, with their empty entries skipped like those of a hash table
+    return permutation_.empty() && appended_storage_.empty() &&
+           (query_mem_desc_.getQueryDescriptionType() ==
+                QueryDescriptionType::GroupByPerfectHash ||
+            query_mem_desc_.getQueryDescriptionType() ==
+                QueryDescriptionType::GroupByBaselineHash ||
+            (query_mem_desc_.getQueryDescriptionType() ==
+                 QueryDescriptionType::Projection &&
+             !drop_first_ && !keep_first_));
   }
 }
 
@@ -1002,12 +1422,15 @@ std::tuple<std::vector<bool>, size_t> ResultSet::getSupportedSingleSlotTargetBit
     const {
   CHECK(isDirectColumnarConversionPossible());
   auto [single_slot_targets, num_single_slot_targets] = getSingleSlotTargetBitmap();
+  const auto slot_idx_per_target_idx = getSlotIndicesForTargetIndices();
 
   for (size_t target_idx = 0; target_idx < single_slot_targets.size(); target_idx++) {
     const auto& target = targets_[target_idx];
     if (single_slot_targets[target_idx] &&
-        (is_distinct_target(target) ||
-         (target.is_agg && target.agg_kind == kSAMPLE && target.sql_type == kFLOAT))) {
+        (is_distinct_target(target) || is_approx_quantile_target(target) ||
+         (target.is_agg && target.agg_kind == kSAMPLE && target.sql_type == kFLOAT) ||
+         (query_mem_desc_.getQueryDescriptionType() == QueryDescriptionType::Projection &&
+          !isDirectProjectionTarget(target_idx, slot_idx_per_target_idx[target_idx])))) {
       single_slot_targets[target_idx] = false;
       num_single_slot_targets--;
     }
@@ -1016,6 +1439,31 @@ std::tuple<std::vector<bool>, size_t> ResultSet::getSupportedSingleSlotTargetBit
   return std::make_tuple(std::move(single_slot_targets), num_single_slot_targets);
 }
 
+/**
+ * Whether a target of a row-wise projection is stored the way it is read back: lazily
+ * fetched targets hold row ids, and floats in 8-byte slots or dates in days are widened,
+ * so those are decoded through the result set iterators instead.
+ */
+bool ResultSet::isDirectProjectionTarget(const size_t target_idx,
+                                         const size_t slot_idx) const {
+  if (!lazy_fetch_info_.empty() && lazy_fetch_info_[target_idx].is_lazily_fetched) {
+    return false;
+  }
+  const auto& target = targets_[target_idx];
+  if (get_compact_type(target).is_date_in_days()) {
+    return false;
+  }
+  const auto slot_width = query_mem_desc_.getPaddedSlotWidthBytes(slot_idx);
+  if (target.sql_type.is_fp()) {
+    return slot_width == static_cast<size_t>(target.sql_type.get_size());
+  }
+  if (target.sql_type.is_string()) {
+    // dictionary ids are written as 32-bit values whatever their encoding
+    return target.sql_type.get_size() == 4;
+  }
+  return true;
+}
+
 // returns the starting slot index for all targets in the result set
 std::vector<size_t> ResultSet::getSlotIndicesForTargetIndices() const {
   std::vector<size_t> slot_indices(targets_.size(), 0);
@@ -26,7 +26,10 @@
 #define QUERYENGINE_RESULTSET_H
 
 #include "CardinalityEstimator.h"
+#include "CudaMgr/CudaMgr.h"
 #include "DataMgr/Chunk/Chunk.h"
+#include "Logger/PerfCounters.h"
+#include "PackedKeySort.h"
 #include "ResultSetBufferAccessors.h"
 #include "ResultSetStorage.h"
 #include "TargetValue.h"
@@ -34,6 +37,8 @@
 #include <atomic>
 #include <functional>
 #include <list>
+#include <optional>
+#include <unordered_map>
 
 /*
  * Stores the underlying buffer and the meta-data for a result set. The buffer
@@ -87,6 +92,11 @@ struct OrderEntry;
 }  // namespace Analyzer
 
 class Executor;
+class ExternalSortBuffer;
+
+namespace result_set {
+class SpooledBuffer;
+}  // namespace result_set
 
 class ResultSet;
 
@@ -240,10 +250,33 @@ class ResultSet {
       const size_t index,
       const std::vector<bool>& targets_to_skip = {}) const;
 
+  // The row getNextRow(true, decimal_to_double) would return for the index, without
+  // moving the cursor, so that several threads can read the rows at once.
+  std::vector<TargetValue> getRowAtTranslated(
+      const size_t index,
+      const bool decimal_to_double,
+      const std::vector<bool>& targets_to_skip = {}) const;
+
   bool isRowAtEmpty(const size_t index) const;
 
   void sort(const std::list<Analyzer::OrderEntry>& order_entries, const size_t top_n);
 
+  // Whether sort() can order the rows by the normalized keys of the order entries.
+  static bool canNormalizeSortKeys(const std::vector<TargetInfo>& targets,
+                                   const std::list<Analyzer::OrderEntry>& order_entries);
+
+  /**
+   * Sets the permutation buffer to the non-empty entries and returns the normalized
+   * values of the order entries for each of them, for an external sort of the rows.
+   */
+  std::vector<packed_key_sort::SortColumn> getNormalizedSortKeys(
+      const std::list<Analyzer::OrderEntry>& order_entries);
+
+  // The rows are already sorted and held in `sorted_buffer`, sort() keeps their order.
+  void setExternallySorted(std::shared_ptr<ExternalSortBuffer> sorted_buffer) {
+    external_sort_buffer_ = std::move(sorted_buffer);
+  }
+
   void keepFirstN(const size_t n);
 
   void dropFirstN(const size_t n);
@@ -260,6 +293,24 @@ class ResultSet {
 
   void setCachedRowCount(const size_t row_count) const;
 
+  // Estimated number of distinct values of a column, from a sample of the rows taken the
+  // first time it's asked for. Exact if all the rows fit in the sample.
+  size_t getColumnNdvEstimate(const size_t col_idx) const;
+
+  // Scales the non distinct COUNT and SUM targets of a single entry aggregate, e.g. to
+  // extrapolate the aggregate of a sample of the fragments to the whole table.
+  void scaleSingleEntryAggregates(const double factor);
+
+  // Half widths of the confidence intervals of the targets of an approximate aggregate,
+  // without a value for the targets which aren't estimated. Empty if the result is exact.
+  void setApproximateErrorBounds(std::vector<std::optional<double>> error_bounds) {
+    approximate_error_bounds_ = std::move(error_bounds);
+  }
+
+  const std::vector<std::optional<double>>& getApproximateErrorBounds() const {
+    return approximate_error_bounds_;
+  }
+
   size_t entryCount() const;
 
   size_t getBufferSizeBytes(const ExecutorDeviceType device_type) const;
@@ -286,14 +337,52 @@ class ResultSet {
     int64_t render_time{0};
     int64_t compilation_queue_time{0};
     int64_t kernel_queue_time{0};
+    int64_t compilation_time{0};
+    int64_t reduction_time{0};
+  };
+
+  // Bytes of the chunks the kernels read and of the buffer pool working set of the
+  // kernels, by memory level.
+  struct QueryMemoryUsage {
+    size_t cpu_bytes_scanned{0};
+    size_t gpu_bytes_scanned{0};
+    size_t cpu_working_set_bytes{0};
+    size_t gpu_working_set_bytes{0};
+    // held by the RowSetMemoryOwner of the query: result buffers, strings, hash tables
+    size_t host_bytes_held{0};
   };
 
   void setQueueTime(const int64_t queue_time);
   void setKernelQueueTime(const int64_t kernel_queue_time);
   void addCompilationQueueTime(const int64_t compilation_queue_time);
+  void addCompilationTime(const int64_t compilation_time);
+  void addReductionTime(const int64_t reduction_time);
 
   int64_t getQueueTime() const;
   int64_t getRenderTime() const;
+  int64_t getCompilationTime() const;
+  int64_t getReductionTime() const;
+
+  void setMemoryUsage(const QueryMemoryUsage& memory_usage);
+  const QueryMemoryUsage& getMemoryUsage() const;
+
+  /**
+   * Moves the output buffers of a projection larger than g_result_spool_threshold_bytes
+   * to scratch files and frees them, the rows are then read back through mmap. For the
+   * results held while the client fetches them, before any other use of the buffers.
+   * Returns the bytes spooled.
+   */
+  size_t spoolToDisk();
+
+  // The hardware counters of the kernels which produced the rows, only collected with
+  // g_enable_perf_counters.
+  void addKernelPerfCounters(const logger::PerfCounterValues& perf_counters);
+  const logger::PerfCounterValues& getKernelPerfCounters() const;
+
+  // The device time of the GPU kernels which produced the rows and of their copies, only
+  // collected with g_enable_gpu_kernel_timing.
+  void addKernelGpuTimings(const CudaMgr_Namespace::GpuTimings& gpu_timings);
+  const CudaMgr_Namespace::GpuTimings& getKernelGpuTimings() const;
 
   void moveToBegin() const;
 
@@ -383,6 +472,8 @@ class ResultSet {
 
   std::tuple<std::vector<bool>, size_t> getSupportedSingleSlotTargetBitmap() const;
 
+  bool isDirectProjectionTarget(const size_t target_idx, const size_t slot_idx) const;
+
   std::vector<size_t> getSlotIndicesForTargetIndices() const;
 
   const std::vector<ColumnLazyFetchInfo>& getLazyFetchInfo() const {
@@ -605,6 +696,7 @@ class ResultSet {
         , result_set_(result_set)
         , buffer_itr_(result_set) {
       materializeCountDistinctColumns();
+      materializeApproxQuantileColumns();
     }
 
     void materializeCountDistinctColumns();
@@ -612,14 +704,31 @@ class ResultSet {
     std::vector<int64_t> materializeCountDistinctColumn(
         const Analyzer::OrderEntry& order_entry) const;
 
+    void materializeApproxQuantileColumns();
+
+    // NaN for the groups without a value
+    std::vector<double> materializeApproxQuantileColumn(
+        const Analyzer::OrderEntry& order_entry) const;
+
     bool operator()(const uint32_t lhs, const uint32_t rhs) const;
 
+    // Whether the value of the order entry is stored as a float.
+    bool isFloatArgumentInput(const Analyzer::OrderEntry& order_entry) const;
+
+    // Fills rows [start, end) of `columns`, one per order entry, with the normalized
+    // values of permutation[start, end).
+    void normalizeSortKeys(const std::vector<uint32_t>& permutation,
+                           const size_t start,
+                           const size_t end,
+                           std::vector<packed_key_sort::SortColumn>& columns) const;
+
     // TODO(adb): make order_entries_ a pointer
     const std::list<Analyzer::OrderEntry> order_entries_;
     const bool use_heap_;
     const ResultSet* result_set_;
     const BufferIteratorType buffer_itr_;
     std::vector<std::vector<int64_t>> count_distinct_materialized_buffers_;
+    std::vector<std::vector<double>> approx_quantile_materialized_buffers_;
   };
 
   std::function<bool(const uint32_t, const uint32_t)> createComparator(
@@ -649,6 +758,17 @@ class ResultSet {
 
   void sortPermutation(const std::function<bool(const uint32_t, const uint32_t)> compare);
 
+  // Sorts the permutation buffer as one radix sort of the order entries packed into
+  // normalized keys. False if the order entries can't be packed.
+  bool packedKeySort(const std::list<Analyzer::OrderEntry>& order_entries);
+
+  std::vector<packed_key_sort::SortColumn> makeSortColumns(
+      const std::list<Analyzer::OrderEntry>& order_entries) const;
+
+  template <typename BUFFER_ITERATOR_TYPE>
+  void buildSortColumns(const ResultSetComparator<BUFFER_ITERATOR_TYPE>& comparator,
+                        std::vector<packed_key_sort::SortColumn>& columns) const;
+
   std::vector<uint32_t> initPermutationBuffer(const size_t start, const size_t step);
 
   void parallelTop(const std::list<Analyzer::OrderEntry>& order_entries,
@@ -698,6 +818,9 @@ class ResultSet {
   std::vector<uint32_t> permutation_;
 
   QueryExecutionTimings timings_;
+  logger::PerfCounterValues kernel_perf_counters_;
+  CudaMgr_Namespace::GpuTimings kernel_gpu_timings_;
+  QueryMemoryUsage memory_usage_;
   const Executor* executor_;  // TODO(alex): remove
 
   std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_;
@@ -705,6 +828,8 @@ class ResultSet {
   // TODO(miyu): refine by using one buffer and
   //   setting offset instead of ptr in group by buffer.
   std::vector<std::vector<int8_t>> literal_buffers_;
+  std::shared_ptr<ExternalSortBuffer> external_sort_buffer_;
+  std::vector<std::unique_ptr<result_set::SpooledBuffer>> spooled_buffers_;
   const std::vector<ColumnLazyFetchInfo> lazy_fetch_info_;
   std::vector<std::vector<std::vector<const int8_t*>>> col_buffers_;
   std::vector<std::vector<std::vector<int64_t>>> frag_offsets_;
@@ -724,6 +849,9 @@ class ResultSet {
   const bool just_explain_;
   mutable std::atomic<int64_t> cached_row_count_;
   mutable std::mutex row_iteration_mutex_;
+  mutable std::mutex ndv_estimates_mutex_;
+  mutable std::unordered_map<size_t, size_t> ndv_estimates_;
+  std::vector<std::optional<double>> approximate_error_bounds_;
 
   // only used by geo
   mutable GeoReturnType geo_return_type_;
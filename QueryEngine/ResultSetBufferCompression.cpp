@@ -0,0 +1,208 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ResultSetBufferCompression.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/Descriptors/QueryMemoryDescriptor.h"
+#include "Shared/Compressor.h"
+
+bool g_enable_serialized_rows_compression{false};
+
+namespace result_set {
+
+namespace {
+
+struct FieldLayout {
+  // of the value of the first entry
+  size_t offset;
+  // between the values of consecutive entries
+  size_t stride;
+  size_t width;
+};
+
+std::vector<FieldLayout> get_field_layouts(const QueryMemoryDescriptor& query_mem_desc) {
+  std::vector<FieldLayout> fields;
+  const bool columnar = query_mem_desc.didOutputColumnar();
+  const size_t row_size = columnar ? 0 : query_mem_desc.getRowSize();
+  for (size_t key_idx = 0; key_idx < query_mem_desc.getKeyCount(); ++key_idx) {
+    if (columnar) {
+      const size_t width = query_mem_desc.groupColWidth(key_idx);
+      fields.push_back(
+          {query_mem_desc.getPrependedGroupColOffInBytes(key_idx), width, width});
+    } else {
+      const size_t width = query_mem_desc.getEffectiveKeyWidth();
+      fields.push_back({key_idx * width, row_size, width});
+    }
+  }
+  for (size_t slot_idx = 0; slot_idx < query_mem_desc.getSlotCount(); ++slot_idx) {
+    const size_t width = query_mem_desc.getPaddedSlotWidthBytes(slot_idx);
+    if (!width) {
+      continue;
+    }
+    fields.push_back(
+        {query_mem_desc.getColOffInBytes(slot_idx), columnar ? width : row_size, width});
+  }
+  return fields;
+}
+
+int64_t read_value(const int8_t* ptr, const size_t width) {
+  switch (width) {
+    case 1:
+      return *ptr;
+    case 2:
+      return *reinterpret_cast<const int16_t*>(ptr);
+    case 4:
+      return *reinterpret_cast<const int32_t*>(ptr);
+    case 8:
+      return *reinterpret_cast<const int64_t*>(ptr);
+    default:
+      CHECK(false) << "Unexpected field width " << width;
+  }
+  return 0;
+}
+
+// Narrower widths keep the low bytes of the value, which is all of it for any width the
+// value was read from.
+void write_value(int8_t* ptr, const size_t width, const uint64_t val) {
+  switch (width) {
+    case 1:
+      *reinterpret_cast<uint8_t*>(ptr) = val;
+      break;
+    case 2:
+      *reinterpret_cast<uint16_t*>(ptr) = val;
+      break;
+    case 4:
+      *reinterpret_cast<uint32_t*>(ptr) = val;
+      break;
+    case 8:
+      *reinterpret_cast<uint64_t*>(ptr) = val;
+      break;
+    default:
+      CHECK(false) << "Unexpected field width " << width;
+  }
+}
+
+uint64_t read_offset(const int8_t* ptr, const size_t width) {
+  switch (width) {
+    case 1:
+      return *reinterpret_cast<const uint8_t*>(ptr);
+    case 2:
+      return *reinterpret_cast<const uint16_t*>(ptr);
+    case 4:
+      return *reinterpret_cast<const uint32_t*>(ptr);
+    case 8:
+      return *reinterpret_cast<const uint64_t*>(ptr);
+    default:
+      CHECK(false) << "Unexpected field width " << width;
+  }
+  return 0;
+}
+
+int8_t get_encoded_width(const uint64_t max_offset, const size_t width) {
+  for (size_t encoded_width = 1; encoded_width < width; encoded_width *= 2) {
+    if (!(max_offset >> (8 * encoded_width))) {
+      return encoded_width;
+    }
+  }
+  return width;
+}
+
+}  // namespace
+
+std::vector<CompressedField> compress_buffer(const int8_t* buffer,
+                                             const QueryMemoryDescriptor& query_mem_desc) {
+  const size_t entry_count = query_mem_desc.getEntryCount();
+  auto compressor = BloscCompressor::getCompressor();
+  std::vector<CompressedField> compressed_fields;
+  for (const auto& field : get_field_layouts(query_mem_desc)) {
+    CompressedField compressed_field;
+    int64_t min_val{std::numeric_limits<int64_t>::max()};
+    int64_t max_val{std::numeric_limits<int64_t>::min()};
+    for (size_t entry_idx = 0; entry_idx < entry_count; ++entry_idx) {
+      const auto val =
+          read_value(buffer + field.offset + entry_idx * field.stride, field.width);
+      min_val = std::min(min_val, val);
+      max_val = std::max(max_val, val);
+    }
+    if (entry_count) {
+      compressed_field.min_val = min_val;
+      compressed_field.encoded_width = get_encoded_width(
+          static_cast<uint64_t>(max_val) - static_cast<uint64_t>(min_val), field.width);
+    } else {
+      compressed_field.encoded_width = field.width;
+    }
+    const size_t encoded_width = compressed_field.encoded_width;
+    std::string encoded(entry_count * encoded_width, 0);
+    for (size_t entry_idx = 0; entry_idx < entry_count; ++entry_idx) {
+      const auto val =
+          read_value(buffer + field.offset + entry_idx * field.stride, field.width);
+      write_value(reinterpret_cast<int8_t*>(&encoded[entry_idx * encoded_width]),
+                  encoded_width,
+                  static_cast<uint64_t>(val) - static_cast<uint64_t>(min_val));
+    }
+    std::string compressed(compressor->getScratchSpaceSize(encoded.size()), 0);
+    int64_t compressed_size{0};
+    try {
+      compressed_size =
+          compressor->compressShuffled(reinterpret_cast<const uint8_t*>(encoded.data()),
+                                       encoded.size(),
+                                       reinterpret_cast<uint8_t*>(&compressed[0]),
+                                       compressed.size(),
+                                       encoded_width);
+    } catch (const CompressionFailedError&) {
+    }
+    if (compressed_size > 0 && static_cast<size_t>(compressed_size) < encoded.size()) {
+      compressed.resize(compressed_size);
+      compressed_field.data = std::move(compressed);
+    } else {
+      compressed_field.data = std::move(encoded);
+    }
+    compressed_fields.push_back(std::move(compressed_field));
+  }
+  return compressed_fields;
+}
+
+void decompress_buffer(const std::vector<CompressedField>& fields,
+                       const QueryMemoryDescriptor& query_mem_desc,
+                       int8_t* buffer) {
+  const size_t entry_count = query_mem_desc.getEntryCount();
+  const auto field_layouts = get_field_layouts(query_mem_desc);
+  CHECK_EQ(fields.size(), field_layouts.size());
+  auto compressor = BloscCompressor::getCompressor();
+  for (size_t field_idx = 0; field_idx < fields.size(); ++field_idx) {
+    const auto& compressed_field = fields[field_idx];
+    const auto& field = field_layouts[field_idx];
+    const size_t encoded_width = compressed_field.encoded_width;
+    CHECK_LE(encoded_width, field.width);
+    const auto encoded =
+        compressor->decompress(compressed_field.data, entry_count * encoded_width);
+    CHECK_EQ(encoded.size(), entry_count * encoded_width);
+    for (size_t entry_idx = 0; entry_idx < entry_count; ++entry_idx) {
+      const auto offset = read_offset(
+          reinterpret_cast<const int8_t*>(&encoded[entry_idx * encoded_width]),
+          encoded_width);
+      write_value(buffer + field.offset + entry_idx * field.stride,
+                  field.width,
+                  static_cast<uint64_t>(compressed_field.min_val) + offset);
+    }
+  }
+}
+
+}  // namespace result_set
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ResultSetBufferCompression.h
+ * @brief   Columnar, compressed encoding of the output buffer of a result set, for the
+ *          serialized rows sent between the nodes of a cluster.
+ *
+ * The buffer is split into one field per group key and per slot, whether the buffer is
+ * row-wise or columnar. The values of a field are stored as offsets from the smallest
+ * value of the field, in the fewest bytes which hold the largest offset: string
+ * dictionary ids, small counts and keys of a narrow range take one or two bytes each.
+ * Each field is then compressed with the byte shuffle at that width. The descriptor of
+ * the buffer is sent along with the fields and gives their layout on the other end.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Whether the serialized rows are sent as compressed fields. All the nodes of a cluster
+// have to be started with the same value.
+extern bool g_enable_serialized_rows_compression;
+
+class QueryMemoryDescriptor;
+
+namespace result_set {
+
+// Mirrors TCompressedField of serialized_result_set.thrift.
+struct CompressedField {
+  // compressed offsets, or the offsets themselves when they didn't compress
+  std::string data;
+  int64_t min_val{0};
+  int8_t encoded_width{0};
+};
+
+std::vector<CompressedField> compress_buffer(const int8_t* buffer,
+                                             const QueryMemoryDescriptor& query_mem_desc);
+
+// Writes the fields back into a buffer laid out by query_mem_desc, the padding between
+// the fields is left as is.
+void decompress_buffer(const std::vector<CompressedField>& fields,
+                       const QueryMemoryDescriptor& query_mem_desc,
+                       int8_t* buffer);
+
+}  // namespace result_set
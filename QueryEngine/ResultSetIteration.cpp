@@ -33,6 +33,7 @@
 #include "Shared/SqlTypesLayout.h"
 #include "Shared/likely.h"
 #include "Shared/sqltypes.h"
+#include "TDigest.h"
 #include "TypePunning.h"
 
 #include <memory>
@@ -280,6 +281,18 @@ std::vector<TargetValue> ResultSet::getRowAtNoTranslations(
   return getRowAt(entry_idx, false, false, false, targets_to_skip);
 }
 
+std::vector<TargetValue> ResultSet::getRowAtTranslated(
+    const size_t logical_index,
+    const bool decimal_to_double,
+    const std::vector<bool>& targets_to_skip /* = {}*/) const {
+  if (logical_index >= entryCount()) {
+    return {};
+  }
+  const auto entry_idx =
+      permutation_.empty() ? logical_index : permutation_[logical_index];
+  return getRowAt(entry_idx, true, decimal_to_double, false, targets_to_skip);
+}
+
 bool ResultSet::isRowAtEmpty(const size_t logical_index) const {
   if (logical_index >= entryCount()) {
     return true;
@@ -653,6 +666,11 @@ int64_t ResultSet::lazyReadInt(const int64_t ival,
     if (col_lazy_fetch.is_lazily_fetched) {
       CHECK_LT(static_cast<size_t>(storage_lookup_result.storage_idx),
                col_buffers_.size());
+      if (ival < 0) {
+        // null row id of an outer join without a match
+        CHECK_EQ(-1, ival);
+        return 0;
+      }
       int64_t ival_copy = ival;
       auto& frag_col_buffers =
           getColumnFrag(static_cast<size_t>(storage_lookup_result.storage_idx),
@@ -1161,6 +1179,10 @@ ENTRY_TYPE ResultSet::getEntryAt(const size_t row_idx,
     } else {
       return getRowWiseBaselineEntryAt<ENTRY_TYPE>(row_idx, target_idx, slot_idx);
     }
+  } else if constexpr (QUERY_TYPE == QueryDescriptionType::Projection) {
+    // a row-wise projection entry is laid out as a perfect hash one, a key then slots
+    static_assert(!COLUMNAR_FORMAT);
+    return getRowWisePerfectHashEntryAt<ENTRY_TYPE>(row_idx, target_idx, slot_idx);
   } else {
     UNREACHABLE() << "Invalid query type is used";
     return 0;
@@ -1176,6 +1198,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T int32_t
@@ -1183,6 +1206,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T int16_t
@@ -1190,6 +1214,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T int8_t
@@ -1197,6 +1222,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T float
@@ -1204,6 +1230,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T double
@@ -1211,6 +1238,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #undef DEF_GET_ENTRY_AT
@@ -1336,6 +1364,14 @@ TargetValue ResultSet::makeVarlenTargetValue(const int8_t* ptr1,
     CHECK_LT(target_logical_idx, lazy_fetch_info_.size());
     const auto& col_lazy_fetch = lazy_fetch_info_[target_logical_idx];
     if (col_lazy_fetch.is_lazily_fetched) {
+      if (varlen_ptr < 0) {
+        // null row id of an outer join without a match
+        CHECK_EQ(-1, varlen_ptr);
+        if (target_info.sql_type.is_array()) {
+          return ArrayTargetValue(boost::optional<std::vector<ScalarTargetValue>>{});
+        }
+        return TargetValue(nullptr);
+      }
       const auto storage_idx = getStorageIndex(entry_buff_idx);
       CHECK_LT(storage_idx.first, col_buffers_.size());
       auto& frag_col_buffers =
@@ -1532,17 +1568,20 @@ TargetValue ResultSet::makeGeoTargetValue(const int8_t* geo_target_ptr,
     return varlen_buffer;
   };
 
-  if (separate_varlen_storage_valid_ && getCoordsDataPtr(geo_target_ptr) < 0) {
-    CHECK_EQ(-1, getCoordsDataPtr(geo_target_ptr));
-    return TargetValue(nullptr);
-  }
-
   const ColumnLazyFetchInfo* col_lazy_fetch = nullptr;
   if (!lazy_fetch_info_.empty()) {
     CHECK_LT(target_logical_idx, lazy_fetch_info_.size());
     col_lazy_fetch = &lazy_fetch_info_[target_logical_idx];
   }
 
+  // a null value, or the null row id of a lazily fetched column in an outer join
+  if ((separate_varlen_storage_valid_ ||
+       (col_lazy_fetch && col_lazy_fetch->is_lazily_fetched)) &&
+      getCoordsDataPtr(geo_target_ptr) < 0) {
+    CHECK_EQ(-1, getCoordsDataPtr(geo_target_ptr));
+    return TargetValue(nullptr);
+  }
+
   switch (target_info.sql_type.get_type()) {
     case kPOINT: {
       if (separate_varlen_storage_valid_ && !target_info.is_agg) {
@@ -1773,6 +1812,16 @@ TargetValue ResultSet::makeTargetValue(const int8_t* ptr,
       }
     }
   }
+  if (is_approx_quantile_target(target_info)) {
+    const auto t_digest = reinterpret_cast<const TDigest*>(ival);
+    const auto quantile = t_digest ? t_digest->quantile() : NAN;
+    if (std::isnan(quantile)) {
+      return NULL_DOUBLE;
+    }
+    // decimal arguments are added unscaled
+    const auto& arg_ti = target_info.agg_arg_type;
+    return arg_ti.is_decimal() ? quantile / exp_to_scale(arg_ti.get_scale()) : quantile;
+  }
   if (chosen_type.is_fp()) {
     switch (actual_compact_sz) {
       case 8: {
@@ -1942,6 +1991,16 @@ TargetValue ResultSet::getTargetValueFromBufferRowwise(
           // need to create a zero filled buffer for this remote_ptr
           const auto& count_distinct_desc =
               query_mem_desc_.count_distinct_descriptors_[target_logical_idx];
+          if (count_distinct_desc.impl_type_ == CountDistinctImplType::SparseHll) {
+            *count_distinct_ptr_ptr = reinterpret_cast<int64_t>(
+                row_set_mem_owner_->addSparseHll(count_distinct_desc.bitmap_sz_bits));
+            return int64_t(0);
+          }
+          if (count_distinct_desc.impl_type_ == CountDistinctImplType::RoaringBitmap) {
+            *count_distinct_ptr_ptr =
+                reinterpret_cast<int64_t>(row_set_mem_owner_->addRoaringBitmap());
+            return int64_t(0);
+          }
           const auto bitmap_byte_sz = count_distinct_desc.sub_bitmap_count == 1
                                           ? count_distinct_desc.bitmapSizeBytes()
                                           : count_distinct_desc.bitmapPaddedSizeBytes();
@@ -29,6 +29,7 @@
 #include "ResultSetReductionJIT.h"
 #include "RuntimeFunctions.h"
 #include "Shared/SqlTypesLayout.h"
+#include "TDigest.h"
 
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
@@ -36,17 +37,33 @@
 #include <llvm/ExecutionEngine/GenericValue.h>
 
 #include <algorithm>
+#include <cmath>
 #include <future>
 #include <numeric>
 
 extern bool g_enable_dynamic_watchdog;
 
-namespace {
-
-bool use_multithreaded_reduction(const size_t entry_count) {
+bool result_set::use_multithreaded_reduction(const size_t entry_count) {
   return entry_count > 100000;
 }
 
+void result_set::reduce_approx_quantile(int64_t* this_digest_handle,
+                                        const int64_t that_digest_handle) {
+  auto this_digest = reinterpret_cast<TDigest*>(*this_digest_handle);
+  const auto that_digest = reinterpret_cast<const TDigest*>(that_digest_handle);
+  // The digest of an entry copied from another buffer is shared with it.
+  if (!that_digest || this_digest == that_digest) {
+    return;
+  }
+  if (!this_digest) {
+    *this_digest_handle = that_digest_handle;
+    return;
+  }
+  this_digest->merge(*that_digest);
+}
+
+namespace {
+
 size_t get_row_qw_count(const QueryMemoryDescriptor& query_mem_desc) {
   const auto row_bytes = get_row_bytes(query_mem_desc);
   CHECK_EQ(size_t(0), row_bytes % 8);
@@ -233,7 +250,7 @@ void ResultSetStorage::reduce(const ResultSetStorage& that,
           "Projection of variable length targets with baseline hash group by is not yet "
           "supported in Distributed mode");
     }
-    if (use_multithreaded_reduction(that_entry_count)) {
+    if (result_set::use_multithreaded_reduction(that_entry_count)) {
       const size_t thread_count = cpu_threads();
       std::vector<std::future<void>> reduction_threads;
       for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
@@ -295,7 +312,7 @@ void ResultSetStorage::reduce(const ResultSetStorage& that,
     }
     return;
   }
-  if (use_multithreaded_reduction(entry_count)) {
+  if (result_set::use_multithreaded_reduction(entry_count)) {
     const size_t thread_count = cpu_threads();
     std::vector<std::future<void>> reduction_threads;
     for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
@@ -923,7 +940,7 @@ void ResultSetStorage::moveEntriesToBuffer(int8_t* new_buff,
   const auto row_qw_count = get_row_qw_count(query_mem_desc_);
   const auto key_byte_width = query_mem_desc_.getEffectiveKeyWidth();
 
-  if (use_multithreaded_reduction(query_mem_desc_.getEntryCount())) {
+  if (result_set::use_multithreaded_reduction(query_mem_desc_.getEntryCount())) {
     const size_t thread_count = cpu_threads();
     std::vector<std::future<void>> move_threads;
 
@@ -1185,6 +1202,40 @@ void ResultSetStorage::fillOneEntryColWise(const std::vector<int64_t>& entry) {
   }
 }
 
+void ResultSetStorage::scaleOneEntry(const double factor) {
+  CHECK_EQ(size_t(1), query_mem_desc_.getEntryCount());
+  const auto slot_count = query_mem_desc_.getBufferColSlotCount();
+  const auto key_count = query_mem_desc_.getGroupbyColCount();
+  auto this_buff = reinterpret_cast<int64_t*>(buff_);
+  size_t slot_idx{0};
+  for (const auto& agg_info : targets_) {
+    const auto crt_slot_idx = slot_idx;
+    slot_idx = advance_slot(slot_idx, agg_info, false);
+    if (!agg_info.is_agg || is_distinct_target(agg_info) ||
+        (agg_info.agg_kind != kCOUNT && agg_info.agg_kind != kSUM)) {
+      continue;
+    }
+    CHECK_LT(crt_slot_idx, target_init_vals_.size());
+    auto& slot =
+        this_buff[query_mem_desc_.didOutputColumnar()
+                      ? slot_offset_colwise(0, crt_slot_idx, key_count, 1)
+                      : slot_offset_rowwise(0, crt_slot_idx, key_count, slot_count)];
+    // the sum of no values is null
+    const auto init_val = target_init_vals_[crt_slot_idx];
+    if (init_val && slot == init_val) {
+      continue;
+    }
+    if (agg_info.sql_type.is_fp()) {
+      CHECK(!takes_float_argument(agg_info));
+      const double value =
+          *reinterpret_cast<const double*>(may_alias_ptr(&slot)) * factor;
+      slot = *reinterpret_cast<const int64_t*>(may_alias_ptr(&value));
+    } else {
+      slot = static_cast<int64_t>(std::llround(slot * factor));
+    }
+  }
+}
+
 void ResultSetStorage::initializeColWise() const {
   const auto key_count = query_mem_desc_.getGroupbyColCount();
   auto this_buff = reinterpret_cast<int64_t*>(buff_);
@@ -1464,6 +1515,12 @@ void ResultSetStorage::reduceOneSlot(
         AGGREGATE_ONE_COUNT(this_ptr1, that_ptr1, chosen_bytes);
         break;
       }
+      case kAPPROX_QUANTILE: {
+        CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+        result_set::reduce_approx_quantile(reinterpret_cast<int64_t*>(this_ptr1),
+                                           *reinterpret_cast<const int64_t*>(that_ptr1));
+        break;
+      }
       case kAVG: {
         // Ignore float argument compaction for count component for fear of its overflow
         AGGREGATE_ONE_COUNT(this_ptr2,
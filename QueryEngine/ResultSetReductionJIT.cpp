@@ -37,14 +37,14 @@ extern std::unique_ptr<llvm::Module> g_rt_module;
 
 CodeCache ResultSetReductionJIT::s_code_cache(10000);
 
+size_t g_reduction_interp_threshold{25};
+
 std::mutex ReductionCode::s_reduction_mutex;
 
 namespace {
 
 // Error code to be returned when the watchdog timer triggers during the reduction.
 const int32_t WATCHDOG_ERROR{-1};
-// Use the interpreter, not the JIT, for a number of entries lower than the threshold.
-const size_t INTERP_THRESHOLD{25};
 
 // Load the value stored at 'ptr' interpreted as 'ptr_type'.
 Value* emit_load(Value* ptr, Type ptr_type, Function* function) {
@@ -456,6 +456,12 @@ extern "C" void count_distinct_set_union_jit_rt(const int64_t new_set_handle,
       new_set_handle, old_set_handle, new_count_distinct_desc, old_count_distinct_desc);
 }
 
+extern "C" void approx_quantile_jit_rt(int8_t* old_digest_ptr,
+                                       const int64_t new_digest_handle) {
+  result_set::reduce_approx_quantile(reinterpret_cast<int64_t*>(old_digest_ptr),
+                                     new_digest_handle);
+}
+
 extern "C" void get_group_value_reduction_rt(int8_t* groups_buffer,
                                              const int8_t* key,
                                              const uint32_t key_count,
@@ -553,7 +559,7 @@ ReductionCode ResultSetReductionJIT::codegen() const {
   }
   reduceLoop(reduction_code);
   // For small result sets, avoid native code generation and use the interpreter instead.
-  if (query_mem_desc_.getEntryCount() < INTERP_THRESHOLD &&
+  if (query_mem_desc_.getEntryCount() < g_reduction_interp_threshold &&
       (!query_mem_desc_.getExecutor() || query_mem_desc_.blocksShareMemory())) {
     return reduction_code;
   }
@@ -1130,6 +1136,11 @@ void ResultSetReductionJIT::reduceOneAggregateSlot(Value* this_ptr1,
       emit_aggregate_one_count(this_ptr1, that_ptr1, chosen_bytes, ir_reduce_one_entry);
       break;
     }
+    case kAPPROX_QUANTILE: {
+      CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+      reduceOneApproxQuantileSlot(this_ptr1, that_ptr1, ir_reduce_one_entry);
+      break;
+    }
     case kAVG: {
       // Ignore float argument compaction for count component for fear of its overflow
       emit_aggregate_one_count(this_ptr2,
@@ -1195,6 +1206,18 @@ void ResultSetReductionJIT::reduceOneCountDistinctSlot(
       "");
 }
 
+void ResultSetReductionJIT::reduceOneApproxQuantileSlot(
+    Value* this_ptr1,
+    Value* that_ptr1,
+    Function* ir_reduce_one_entry) const {
+  const auto new_digest_handle = emit_load_i64(that_ptr1, ir_reduce_one_entry);
+  ir_reduce_one_entry->add<ExternalCall>(
+      "approx_quantile_jit_rt",
+      Type::Void,
+      std::vector<const Value*>{this_ptr1, new_digest_handle},
+      "");
+}
+
 ReductionCode ResultSetReductionJIT::finalizeReductionCode(
     ReductionCode reduction_code,
     const llvm::Function* ir_is_empty,
@@ -1268,11 +1291,15 @@ std::string ResultSetReductionJIT::cacheKey() const {
 ReductionCode GpuReductionHelperJIT::codegen() const {
   const auto hash_type = query_mem_desc_.getQueryDescriptionType();
   auto reduction_code = setup_functions_ir(hash_type);
-  CHECK(hash_type == QueryDescriptionType::GroupByPerfectHash);
   isEmpty(reduction_code);
-  reduceOneEntryNoCollisions(reduction_code);
-  reduceOneEntryNoCollisionsIdx(reduction_code);
-  reduceLoop(reduction_code);
+  if (hash_type == QueryDescriptionType::GroupByBaselineHash) {
+    reduceOneEntryBaseline(reduction_code);
+  } else {
+    CHECK(hash_type == QueryDescriptionType::GroupByPerfectHash);
+    reduceOneEntryNoCollisions(reduction_code);
+    reduceOneEntryNoCollisionsIdx(reduction_code);
+    reduceLoop(reduction_code);
+  }
   reduction_code.cgen_state.reset(new CgenState({}, false));
   auto cgen_state = reduction_code.cgen_state.get();
   std::unique_ptr<llvm::Module> module(runtime_module_shallow_copy(cgen_state));
@@ -1282,6 +1309,16 @@ ReductionCode GpuReductionHelperJIT::codegen() const {
   auto ir_is_empty = create_llvm_function(reduction_code.ir_is_empty.get(), cgen_state);
   auto ir_reduce_one_entry =
       create_llvm_function(reduction_code.ir_reduce_one_entry.get(), cgen_state);
+  if (hash_type == QueryDescriptionType::GroupByBaselineHash) {
+    std::unordered_map<const Function*, llvm::Function*> f;
+    f.emplace(reduction_code.ir_is_empty.get(), ir_is_empty);
+    f.emplace(reduction_code.ir_reduce_one_entry.get(), ir_reduce_one_entry);
+    translate_function(reduction_code.ir_is_empty.get(), ir_is_empty, reduction_code, f);
+    translate_function(
+        reduction_code.ir_reduce_one_entry.get(), ir_reduce_one_entry, reduction_code, f);
+    reduction_code.module = std::move(module);
+    return reduction_code;
+  }
   auto ir_reduce_one_entry_idx =
       create_llvm_function(reduction_code.ir_reduce_one_entry_idx.get(), cgen_state);
   auto ir_reduce_loop =
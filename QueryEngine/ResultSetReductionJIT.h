@@ -27,6 +27,10 @@
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Value.h>
 
+// Use the interpreter, not the JIT, to reduce result sets of fewer entries than this,
+// unless an executor is running them on blocks which don't share memory.
+extern size_t g_reduction_interp_threshold;
+
 struct ReductionCode {
   // Function which reduces 'that_buff' into 'this_buff', for rows between
   // [start_entry_index, end_entry_index).
@@ -78,15 +82,16 @@ class ResultSetReductionJIT {
   // Generate a function for the reduction of an entire result set chunk.
   void reduceLoop(const ReductionCode& reduction_code) const;
 
+  // Generate a function which reduces the targets of two rows given by their start
+  // pointer, for the baseline layout.
+  void reduceOneEntryBaseline(const ReductionCode& reduction_code) const;
+
  private:
   // Used to implement 'reduceOneEntryNoCollisions'.
   void reduceOneEntryTargetsNoCollisions(Function* ir_reduce_one_entry,
                                          Value* this_targets_start_ptr,
                                          Value* that_targets_start_ptr) const;
 
-  // Same as above, for the baseline layout.
-  void reduceOneEntryBaseline(const ReductionCode& reduction_code) const;
-
   // Same as above, for the baseline layout.
   void reduceOneEntryBaselineIdx(const ReductionCode& reduction_code) const;
 
@@ -120,6 +125,11 @@ class ResultSetReductionJIT {
                                   const size_t target_logical_idx,
                                   Function* ir_reduce_one_entry) const;
 
+  // Generate reduction code for an approximate quantile slot.
+  void reduceOneApproxQuantileSlot(Value* this_ptr1,
+                                   Value* that_ptr1,
+                                   Function* ir_reduce_one_entry) const;
+
   ReductionCode finalizeReductionCode(ReductionCode reduction_code,
                                       const llvm::Function* ir_is_empty,
                                       const llvm::Function* ir_reduce_one_entry,
@@ -146,16 +156,24 @@ class GpuReductionHelperJIT : public ResultSetReductionJIT {
                         const std::vector<int64_t>& target_init_vals)
       : ResultSetReductionJIT(query_mem_desc, targets, target_init_vals)
       , query_mem_desc_(query_mem_desc) {
-    CHECK(query_mem_desc_.getQueryDescriptionType() ==
-          QueryDescriptionType::GroupByPerfectHash);
     CHECK(!query_mem_desc_.didOutputColumnar());
-    CHECK(query_mem_desc_.hasKeylessHash());
+    if (query_mem_desc_.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByPerfectHash) {
+      CHECK(query_mem_desc_.hasKeylessHash());
+    } else {
+      CHECK(query_mem_desc_.getQueryDescriptionType() ==
+            QueryDescriptionType::GroupByBaselineHash);
+      CHECK(!query_mem_desc_.hasKeylessHash());
+    }
   }
   /**
    * generates code for perfect hash group by reduction: the following functions are
    * internally created: isEmpty, reduceOneEntryNoCollision (reduce for perfect hash),
    * reduceOneEntryNoCollissionsIdx(reduce one slot for perfect hash), and reduceLoop (the
    * outer loop).
+   * For baseline hash group by, only isEmpty and reduceOneEntryBaseline (reduce the
+   * targets of one entry) are created: finding the destination entry of a key is up to
+   * the caller.
    */
   virtual ReductionCode codegen() const;
 
@@ -6,6 +6,7 @@
 #include "SortUtils.cuh"
 
 #include <thrust/copy.h>
+#include <thrust/gather.h>
 #include <thrust/execution_policy.h>
 #include <thrust/host_vector.h>
 #include <thrust/sort.h>
@@ -430,3 +431,45 @@ template std::vector<uint32_t> baseline_sort<int64_t>(
     const size_t top_n,
     const size_t start,
     const size_t step);
+
+std::vector<uint32_t> packed_key_sort_on_gpu(
+    const std::vector<std::vector<uint64_t>>& key_words,
+    const size_t row_count,
+    Data_Namespace::DataMgr* data_mgr,
+    const int device_id) {
+  std::vector<uint32_t> sorted_rows(row_count);
+  if (row_count == 0) {
+    return sorted_rows;
+  }
+  ThrustAllocator thrust_allocator(data_mgr, device_id);
+  const auto dev_idx_buff = get_device_ptr<uint32_t>(row_count, thrust_allocator);
+  thrust::sequence(
+      thrust::device(thrust_allocator), dev_idx_buff, dev_idx_buff + row_count);
+  const auto dev_word = get_device_ptr<uint64_t>(row_count, thrust_allocator);
+  const auto dev_keys = get_device_ptr<uint64_t>(row_count, thrust_allocator);
+  // Least significant word first: thrust sorts integer keys with a stable radix sort,
+  // each pass keeps the order of the words already sorted on.
+  for (auto word_it = key_words.rbegin(); word_it != key_words.rend(); ++word_it) {
+    CHECK_EQ(row_count, word_it->size());
+    copy_to_gpu(data_mgr,
+                reinterpret_cast<CUdeviceptr>(dev_word.get()),
+                word_it->data(),
+                row_count * sizeof(uint64_t),
+                device_id);
+    thrust::gather(thrust::device(thrust_allocator),
+                   dev_idx_buff,
+                   dev_idx_buff + row_count,
+                   dev_word,
+                   dev_keys);
+    thrust::stable_sort_by_key(thrust::device(thrust_allocator),
+                               dev_keys,
+                               dev_keys + row_count,
+                               dev_idx_buff);
+  }
+  copy_from_gpu(data_mgr,
+                sorted_rows.data(),
+                reinterpret_cast<CUdeviceptr>(dev_idx_buff.get()),
+                row_count * sizeof(uint32_t),
+                device_id);
+  return sorted_rows;
+}
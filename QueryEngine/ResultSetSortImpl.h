@@ -20,6 +20,9 @@
 #include "../Shared/TargetInfo.h"
 #include "CompilationOptions.h"
 
+#include <cstdint>
+#include <vector>
+
 struct PodOrderEntry {
   int tle_no;       /* targetlist entry number: 1-based */
   bool is_desc;     /* true if order is DESC */
@@ -52,4 +55,14 @@ std::vector<uint32_t> baseline_sort(const ExecutorDeviceType device_type,
                                     const size_t start,
                                     const size_t step);
 
+/**
+ * Stable sort of the rows by their packed key words, most significant word first, on
+ * the GPU `device_id`. Returns the row indices in order, see packed_key_sort::sort().
+ */
+std::vector<uint32_t> packed_key_sort_on_gpu(
+    const std::vector<std::vector<uint64_t>>& key_words,
+    const size_t row_count,
+    Data_Namespace::DataMgr* data_mgr,
+    const int device_id);
+
 #endif  // QUERYENGINE_RESULTSETSORTIMPL_H
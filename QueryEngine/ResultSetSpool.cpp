@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ResultSetSpool.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "Logger/Logger.h"
+
+bool g_enable_result_spooling{false};
+size_t g_result_spool_threshold_bytes{size_t(1) << 30};
+std::string g_result_spool_path;
+
+namespace result_set {
+
+std::atomic<size_t> SpooledBuffer::spooled_bytes_{0};
+
+namespace {
+
+std::string get_error(const std::string& action) {
+  return "Could not " + action + " the result spool file: " + std::strerror(errno);
+}
+
+}  // namespace
+
+SpooledBuffer::SpooledBuffer(const int8_t* buff, const size_t num_bytes)
+    : ptr_(nullptr), num_bytes_(num_bytes) {
+  CHECK(buff);
+  CHECK_GT(num_bytes, size_t(0));
+  const auto dir = g_result_spool_path.empty()
+                       ? boost::filesystem::temp_directory_path()
+                       : boost::filesystem::path(g_result_spool_path);
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir, ec);
+  auto file_path = (dir / "omnisci_result_spool_XXXXXX").string();
+  std::vector<char> file_path_buff(file_path.begin(), file_path.end());
+  file_path_buff.push_back('\0');
+  const int fd = mkstemp(file_path_buff.data());
+  if (fd < 0) {
+    throw std::runtime_error(get_error("create"));
+  }
+  // the file goes away with the mapping, or right away on failure
+  unlink(file_path_buff.data());
+  size_t written{0};
+  while (written < num_bytes) {
+    const auto ret = write(fd, buff + written, num_bytes - written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const auto error = get_error("write");
+      close(fd);
+      throw std::runtime_error(error);
+    }
+    written += ret;
+  }
+  auto ptr = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if (ptr == MAP_FAILED) {
+    const auto error = get_error("map");
+    close(fd);
+    throw std::runtime_error(error);
+  }
+  close(fd);
+  ptr_ = reinterpret_cast<int8_t*>(ptr);
+  spooled_bytes_ += num_bytes_;
+}
+
+SpooledBuffer::~SpooledBuffer() {
+  munmap(ptr_, num_bytes_);
+  spooled_bytes_ -= num_bytes_;
+}
+
+}  // namespace result_set
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ResultSetSpool.h
+ * @brief   Spooling of the output buffers of large results held for the clients to
+ *          scratch files.
+ *
+ * A spooled buffer keeps its layout, row-wise or columnar, so the result set iterators
+ * read it through the mapping as they read memory. The mapping is copy-on-write and the
+ * file is unlinked once mapped, so the pages are clean page cache the kernel drops under
+ * memory pressure, and the file goes away with the mapping.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+extern bool g_enable_result_spooling;
+extern size_t g_result_spool_threshold_bytes;
+// the directory of the scratch files, the temporary directory of the system if empty
+extern std::string g_result_spool_path;
+
+namespace result_set {
+
+class SpooledBuffer {
+ public:
+  // Throws std::runtime_error if the file cannot be written or mapped.
+  SpooledBuffer(const int8_t* buff, const size_t num_bytes);
+
+  ~SpooledBuffer();
+
+  SpooledBuffer(const SpooledBuffer&) = delete;
+  SpooledBuffer& operator=(const SpooledBuffer&) = delete;
+
+  int8_t* data() const { return ptr_; }
+
+  size_t size() const { return num_bytes_; }
+
+  // bytes of all the buffers spooled and not yet freed
+  static size_t getSpooledBytes() { return spooled_bytes_.load(); }
+
+ private:
+  int8_t* ptr_;
+  const size_t num_bytes_;
+
+  static std::atomic<size_t> spooled_bytes_;
+};
+
+}  // namespace result_set
@@ -77,7 +77,8 @@ std::vector<int64_t> result_set::initialize_target_values_for_storage(
   std::vector<int64_t> target_init_vals;
   for (const auto& target_info : targets) {
     if (target_info.agg_kind == kCOUNT ||
-        target_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+        target_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        target_info.agg_kind == kAPPROX_QUANTILE) {
       target_init_vals.push_back(0);
       continue;
     }
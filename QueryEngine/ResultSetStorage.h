@@ -204,6 +204,8 @@ class ResultSetStorage {
 
   void fillOneEntryColWise(const std::vector<int64_t>& entry);
 
+  void scaleOneEntry(const double factor);
+
   void initializeRowWise() const;
 
   void initializeColWise() const;
@@ -242,6 +244,13 @@ int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch,
 
 void fill_empty_key(void* key_ptr, const size_t key_count, const size_t key_width);
 
+// Whether reducing a buffer of this many entries splits the entries over the CPU threads.
+bool use_multithreaded_reduction(const size_t entry_count);
+
+// Merges the t-digest of an APPROX_QUANTILE slot of another buffer into this one's.
+void reduce_approx_quantile(int64_t* this_digest_handle,
+                            const int64_t that_digest_handle);
+
 int8_t get_width_for_slot(const size_t target_slot_idx,
                           const bool float_argument_input,
                           const QueryMemoryDescriptor& query_mem_desc);
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/RoaringBitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+namespace {
+
+// Past this many values an array container would be larger than a bitmap container.
+constexpr size_t kMaxArraySize{4096};
+
+constexpr size_t kBitmapWords{(1 << 16) / 64};
+
+}  // namespace
+
+void RoaringBitmap::add(const int64_t value) {
+  const auto bits = static_cast<uint64_t>(value);
+  getContainer(bits >> 16).add(bits & 0xffff);
+}
+
+void RoaringBitmap::unite(const RoaringBitmap& that) {
+  if (&that == this) {
+    return;
+  }
+  for (const auto& kv : that.containers_) {
+    getContainer(kv.first).unite(kv.second);
+  }
+}
+
+size_t RoaringBitmap::cardinality() const {
+  size_t cardinality{0};
+  for (const auto& kv : containers_) {
+    cardinality += kv.second.cardinality();
+  }
+  return cardinality;
+}
+
+size_t RoaringBitmap::getBytes() const {
+  size_t bytes{0};
+  for (const auto& kv : containers_) {
+    // about the size of a map node
+    bytes += sizeof(kv) + 4 * sizeof(void*) + kv.second.getBytes();
+  }
+  return bytes;
+}
+
+RoaringBitmap::Container& RoaringBitmap::getContainer(const uint64_t high) {
+  if (last_container_ == containers_.end() || last_container_->first != high) {
+    last_container_ = containers_.try_emplace(high).first;
+  }
+  return last_container_->second;
+}
+
+void RoaringBitmap::Container::add(const uint16_t low) {
+  if (!isArray()) {
+    auto& word = bitmap_[low >> 6];
+    const uint64_t bit = uint64_t(1) << (low & 63);
+    cardinality_ += !(word & bit);
+    word |= bit;
+    return;
+  }
+  auto it = std::lower_bound(array_.begin(), array_.end(), low);
+  if (it != array_.end() && *it == low) {
+    return;
+  }
+  if (array_.size() == kMaxArraySize) {
+    toBitmap();
+    add(low);
+    return;
+  }
+  array_.insert(it, low);
+  ++cardinality_;
+}
+
+void RoaringBitmap::Container::unite(const Container& that) {
+  if (isArray() && that.isArray()) {
+    std::vector<uint16_t> united;
+    united.reserve(array_.size() + that.array_.size());
+    std::set_union(array_.begin(),
+                   array_.end(),
+                   that.array_.begin(),
+                   that.array_.end(),
+                   std::back_inserter(united));
+    array_.swap(united);
+    cardinality_ = array_.size();
+    if (array_.size() > kMaxArraySize) {
+      toBitmap();
+    }
+    return;
+  }
+  if (that.isArray()) {
+    for (const auto low : that.array_) {
+      add(low);
+    }
+    return;
+  }
+  toBitmap();
+  cardinality_ = 0;
+  for (size_t i = 0; i < kBitmapWords; ++i) {
+    bitmap_[i] |= that.bitmap_[i];
+    cardinality_ += std::bitset<64>(bitmap_[i]).count();
+  }
+}
+
+size_t RoaringBitmap::Container::getBytes() const {
+  return array_.capacity() * sizeof(uint16_t) + bitmap_.capacity() * sizeof(uint64_t);
+}
+
+void RoaringBitmap::Container::toBitmap() {
+  if (!isArray()) {
+    return;
+  }
+  bitmap_.resize(kBitmapWords);
+  for (const auto low : array_) {
+    bitmap_[low >> 6] |= uint64_t(1) << (low & 63);
+  }
+  array_.clear();
+  array_.shrink_to_fit();
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * Roaring bitmap (Chambi et al., "Better bitmap performance with Roaring bitmaps"), the
+ * set of an exact COUNT(DISTINCT) on CPU. Values are split in chunks of 2^16 by their
+ * high bits; the low bits of a chunk are kept in a sorted array while there are at
+ * most 4096 of them and in a 2^16 bits bitmap beyond that. Like the 64-bit version of
+ * CRoaring, the chunks are kept in a map since the high bits can take any value.
+ *
+ * Updates are not thread safe, a set belongs to one group of one kernel or reduction.
+ */
+class RoaringBitmap {
+ public:
+  RoaringBitmap() = default;
+
+  // last_container_ would point in the other map
+  RoaringBitmap(const RoaringBitmap&) = delete;
+  RoaringBitmap& operator=(const RoaringBitmap&) = delete;
+
+  void add(const int64_t value);
+
+  void unite(const RoaringBitmap& that);
+
+  size_t cardinality() const;
+
+  size_t getBytes() const;
+
+ private:
+  class Container {
+   public:
+    void add(const uint16_t low);
+
+    void unite(const Container& that);
+
+    size_t cardinality() const { return cardinality_; }
+
+    size_t getBytes() const;
+
+   private:
+    bool isArray() const { return bitmap_.empty(); }
+
+    void toBitmap();
+
+    uint32_t cardinality_{0};
+    std::vector<uint16_t> array_;  // sorted, empty once bitmap_ is used
+    std::vector<uint64_t> bitmap_;
+  };
+
+  Container& getContainer(const uint64_t high);
+
+  std::map<uint64_t, Container> containers_;  // by high bits
+  // the container of the last value added, values usually come in clusters
+  std::map<uint64_t, Container>::iterator last_container_{containers_.end()};
+};
@@ -356,6 +356,30 @@ extern "C" ALWAYS_INLINE int8_t bit_is_set(const int64_t bitset,
              : 0;
 }
 
+extern "C" ALWAYS_INLINE int8_t key_is_in_hash_set(const int64_t hash_set,
+                                                   const int64_t val,
+                                                   const int64_t entry_count,
+                                                   const int64_t null_val,
+                                                   const int8_t null_bool_val) {
+  if (val == null_val) {
+    return null_bool_val;
+  }
+  if (!hash_set) {
+    return 0;
+  }
+  // see InValuesHashSet; empty slots hold the null value and at least half are empty
+  const auto keys = reinterpret_cast<const int64_t*>(hash_set);
+  for (auto slot = MurmurHash64A(&val, sizeof(int64_t), 0) & (entry_count - 1);;
+       slot = (slot + 1) & (entry_count - 1)) {
+    if (keys[slot] == val) {
+      return 1;
+    }
+    if (keys[slot] == null_val) {
+      return 0;
+    }
+  }
+}
+
 extern "C" ALWAYS_INLINE int64_t agg_sum(int64_t* agg, const int64_t val) {
   const auto old = *agg;
   *agg += val;
@@ -961,7 +985,8 @@ extern "C" NEVER_INLINE const int64_t* init_shared_mem_nop(
 
 extern "C" NEVER_INLINE void write_back_nop(int64_t* dest,
                                             int64_t* src,
-                                            const int32_t sz) {
+                                            const int32_t sz,
+                                            int32_t* error_codes) {
   // the body is not really needed, just make sure the call is not optimized away
   assert(dest);
 }
@@ -1221,6 +1246,24 @@ extern "C" ALWAYS_INLINE uint64_t string_pack(const int8_t* ptr, const int32_t l
          (static_cast<const uint64_t>(len) << 48);
 }
 
+// The string of `string_id` in the copy of the offsets and the payload of a dictionary
+// on the GPU, see GpuStringDictionaryPayload.
+extern "C" ALWAYS_INLINE uint64_t
+string_decompress_from_payload(const int32_t string_id,
+                               const int64_t offsets,
+                               const int64_t payload,
+                               const int32_t str_count,
+                               const int32_t null_val) {
+  if (string_id == null_val || string_id < 0 || string_id >= str_count) {
+    return 0;
+  }
+  // the 48 bit offset and 16 bit size of StringDictionary::StringIdxEntry
+  const auto off_and_size = reinterpret_cast<const uint64_t*>(offsets)[string_id];
+  return string_pack(reinterpret_cast<const int8_t*>(payload) +
+                         (off_and_size & 0xffffffffffff),
+                     off_and_size >> 48);
+}
+
 #ifdef __clang__
 #include "../Utils/StringLike.cpp"
 #endif
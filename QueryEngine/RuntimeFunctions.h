@@ -128,6 +128,8 @@ extern "C" int64_t* get_group_value(int64_t* groups_buffer,
                                     const uint32_t row_size_quad,
                                     const int64_t* init_val = nullptr);
 
+extern "C" bool sample_ratio(const double proportion, const int64_t row_offset);
+
 enum RuntimeInterruptFlags { INT_CHECK = 0, INT_ABORT = -1, INT_RESET = -2 };
 
 extern "C" bool check_interrupt();
@@ -253,6 +255,17 @@ extern "C" int64_t fixed_width_small_date_decode_noinline(const int8_t* byte_str
                                                           const int64_t ret_null_val,
                                                           const int64_t pos);
 
+extern "C" int64_t frame_of_reference_int_decode_noinline(const int8_t* byte_stream,
+                                                          const int64_t null_val,
+                                                          const int64_t pos);
+
+extern "C" int64_t delta_int_decode_noinline(const int8_t* byte_stream,
+                                             const int32_t block_size,
+                                             const int64_t pos);
+
+extern "C" int64_t run_length_int_decode_noinline(const int8_t* byte_stream,
+                                                  const int64_t pos);
+
 extern "C" int8_t* extract_str_ptr_noinline(const uint64_t str_and_len);
 
 extern "C" int32_t extract_str_len_noinline(const uint64_t str_and_len);
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/SharedScan.h"
+
+#include <map>
+#include <mutex>
+
+#include "Logger/Logger.h"
+
+bool g_enable_shared_scans{false};
+
+namespace {
+
+struct TableScans {
+  size_t scan_count{0};
+  // the outer fragment the latest kernel of any scan of the table started on
+  size_t fragment_idx{0};
+};
+
+std::mutex table_scans_mutex;
+std::map<std::pair<int, int>, TableScans> table_scans;
+
+}  // namespace
+
+SharedScan::SharedScan(const int db_id, const int table_id)
+    : table_key_(db_id, table_id) {
+  std::lock_guard<std::mutex> lock(table_scans_mutex);
+  auto& scans = table_scans[table_key_];
+  if (scans.scan_count) {
+    start_fragment_ = scans.fragment_idx;
+    VLOG(1) << "Joining " << scans.scan_count << " scans of table " << table_key_.second
+            << " at fragment " << scans.fragment_idx;
+  }
+  ++scans.scan_count;
+}
+
+SharedScan::~SharedScan() {
+  std::lock_guard<std::mutex> lock(table_scans_mutex);
+  const auto it = table_scans.find(table_key_);
+  CHECK(it != table_scans.end());
+  CHECK_GT(it->second.scan_count, size_t(0));
+  if (!--it->second.scan_count) {
+    table_scans.erase(it);
+  }
+}
+
+void SharedScan::fragmentStarted(const size_t fragment_idx) {
+  std::lock_guard<std::mutex> lock(table_scans_mutex);
+  const auto it = table_scans.find(table_key_);
+  CHECK(it != table_scans.end());
+  it->second.fragment_idx = fragment_idx;
+}
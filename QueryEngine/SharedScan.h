@@ -0,0 +1,56 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    SharedScan.h
+ * @brief   Lines up the concurrent scans of a table on the same fragments.
+ *
+ * Every query step scanning a table registers a SharedScan for the duration of its
+ * kernels, and reports the outer fragment each of its kernels starts on. A step which
+ * starts while other steps scan the same table launches its kernels from the fragment
+ * those steps have reached, wrapping around to the fragments they had already passed,
+ * so the steps fetch the same chunks at about the same time, while they are still in
+ * the buffer pools and the caches, rather than each one streaming the whole table on
+ * its own.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+extern bool g_enable_shared_scans;
+
+class SharedScan {
+ public:
+  SharedScan(const int db_id, const int table_id);
+  ~SharedScan();
+
+  SharedScan(const SharedScan&) = delete;
+  SharedScan& operator=(const SharedScan&) = delete;
+
+  // The fragment the other scans of the table had reached when this one registered,
+  // nothing if there were none.
+  std::optional<size_t> getStartFragment() const { return start_fragment_; }
+
+  // Called by each kernel of the scan with its first outer fragment.
+  void fragmentStarted(const size_t fragment_idx);
+
+ private:
+  const std::pair<int, int> table_key_;
+  std::optional<size_t> start_fragment_;
+};
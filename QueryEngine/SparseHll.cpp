@@ -0,0 +1,139 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/SparseHll.h"
+
+#include <algorithm>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/HyperLogLog.h"
+#include "QueryEngine/HyperLogLogRank.h"
+#include "QueryEngine/MurmurHash.h"
+
+namespace {
+
+inline uint32_t sparse_entry(const uint32_t index, const uint8_t rank) {
+  return index << 8 | rank;
+}
+
+inline uint32_t sparse_index(const uint32_t entry) {
+  return entry >> 8;
+}
+
+inline uint8_t sparse_rank(const uint32_t entry) {
+  return entry & 0xff;
+}
+
+}  // namespace
+
+SparseHll::SparseHll(const uint32_t bitmap_sz_bits) : bitmap_sz_bits_(bitmap_sz_bits) {
+  CHECK_GT(bitmap_sz_bits_, uint32_t(0));
+  CHECK_LE(bitmap_sz_bits_, uint32_t(24));
+}
+
+void SparseHll::update(const int64_t key) {
+  const uint64_t hash = MurmurHash64A(&key, sizeof(key), 0);
+  const uint32_t index = hash >> (64 - bitmap_sz_bits_);
+  const uint8_t rank = get_rank(hash << bitmap_sz_bits_, 64 - bitmap_sz_bits_);
+  updateRegister(index, rank);
+}
+
+void SparseHll::merge(const SparseHll& that) {
+  CHECK_EQ(bitmap_sz_bits_, that.bitmap_sz_bits_);
+  if (&that == this) {
+    return;
+  }
+  if (that.isSparse()) {
+    if (isSparse()) {
+      mergeSparse(that.sparse_);
+      return;
+    }
+    for (const auto entry : that.sparse_) {
+      updateRegister(sparse_index(entry), sparse_rank(entry));
+    }
+    return;
+  }
+  toDense();
+  for (size_t i = 0; i < dense_.size(); ++i) {
+    dense_[i] = std::max(dense_[i], that.dense_[i]);
+  }
+}
+
+size_t SparseHll::cardinality() const {
+  if (!isSparse()) {
+    return hll_size(dense_.data(), bitmap_sz_bits_);
+  }
+  const uint32_t m = 1 << bitmap_sz_bits_;
+  const uint32_t zeros = m - sparse_.size();
+  double harmonic_mean_denominator = zeros;
+  for (const auto entry : sparse_) {
+    harmonic_mean_denominator += 1.0 / (1ULL << sparse_rank(entry));
+  }
+  return hll_size_from_sums(bitmap_sz_bits_, zeros, harmonic_mean_denominator);
+}
+
+void SparseHll::updateRegister(const uint32_t index, const uint8_t rank) {
+  if (!isSparse()) {
+    dense_[index] = std::max(dense_[index], static_cast<int8_t>(rank));
+    return;
+  }
+  const auto entry = sparse_entry(index, rank);
+  auto it = std::lower_bound(sparse_.begin(), sparse_.end(), sparse_entry(index, 0));
+  if (it != sparse_.end() && sparse_index(*it) == index) {
+    *it = std::max(*it, entry);
+    return;
+  }
+  if (sparse_.size() == getMaxSparseEntries()) {
+    toDense();
+    updateRegister(index, rank);
+    return;
+  }
+  sparse_.insert(it, entry);
+}
+
+void SparseHll::mergeSparse(const std::vector<uint32_t>& that_sparse) {
+  std::vector<uint32_t> merged;
+  merged.reserve(sparse_.size() + that_sparse.size());
+  auto this_it = sparse_.begin();
+  auto that_it = that_sparse.begin();
+  while (this_it != sparse_.end() && that_it != that_sparse.end()) {
+    if (sparse_index(*this_it) < sparse_index(*that_it)) {
+      merged.push_back(*this_it++);
+    } else if (sparse_index(*that_it) < sparse_index(*this_it)) {
+      merged.push_back(*that_it++);
+    } else {
+      merged.push_back(std::max(*this_it++, *that_it++));
+    }
+  }
+  merged.insert(merged.end(), this_it, sparse_.end());
+  merged.insert(merged.end(), that_it, that_sparse.end());
+  sparse_.swap(merged);
+  if (sparse_.size() > getMaxSparseEntries()) {
+    toDense();
+  }
+}
+
+void SparseHll::toDense() {
+  if (!isSparse()) {
+    return;
+  }
+  dense_.resize(size_t(1) << bitmap_sz_bits_);
+  for (const auto entry : sparse_) {
+    dense_[sparse_index(entry)] = sparse_rank(entry);
+  }
+  sparse_.clear();
+  sparse_.shrink_to_fit();
+}
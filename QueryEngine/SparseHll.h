@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * HyperLogLog registers of one group of APPROX_COUNT_DISTINCT on CPU. While few registers
+ * are set they're kept in the sparse representation of HLL++, the non-zero registers
+ * sorted by index; once those would take more memory than the 2^bitmap_sz_bits dense
+ * registers, the sketch switches to the dense ones. The estimate doesn't depend on the
+ * representation, it's the one of hll_size().
+ *
+ * Updates are not thread safe, a sketch belongs to one group of one kernel or reduction.
+ */
+class SparseHll {
+ public:
+  SparseHll(const uint32_t bitmap_sz_bits);
+
+  // Same hashing as agg_approximate_count_distinct().
+  void update(const int64_t key);
+
+  void merge(const SparseHll& that);
+
+  size_t cardinality() const;
+
+  bool isSparse() const { return dense_.empty(); }
+
+  size_t getBytes() const {
+    return sparse_.capacity() * sizeof(uint32_t) + dense_.capacity();
+  }
+
+ private:
+  void updateRegister(const uint32_t index, const uint8_t rank);
+
+  void mergeSparse(const std::vector<uint32_t>& that_sparse);
+
+  void toDense();
+
+  size_t getMaxSparseEntries() const {
+    return (size_t(1) << bitmap_sz_bits_) / sizeof(uint32_t);
+  }
+
+  const uint32_t bitmap_sz_bits_;
+  // index << 8 | rank of the non-zero registers, sorted; empty once dense_ is used
+  std::vector<uint32_t> sparse_;
+  std::vector<int8_t> dense_;
+};
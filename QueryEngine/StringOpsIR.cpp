@@ -74,7 +74,8 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::CharLengthExpr* expr,
     }
     str_lv.push_back(cgen_state_->emitCall("extract_str_ptr", {str_lv.front()}));
     str_lv.push_back(cgen_state_->emitCall("extract_str_len", {str_lv.front()}));
-    if (co.device_type == ExecutorDeviceType::GPU) {
+    if (co.device_type == ExecutorDeviceType::GPU &&
+        !decodesDictOnGpu(expr->get_arg(), co)) {
       throw QueryMustRunOnCpu();
     }
   }
@@ -162,7 +163,8 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::LikeExpr* expr,
     CHECK_EQ(size_t(1), str_lv.size());
     str_lv.push_back(cgen_state_->emitCall("extract_str_ptr", {str_lv.front()}));
     str_lv.push_back(cgen_state_->emitCall("extract_str_len", {str_lv.front()}));
-    if (co.device_type == ExecutorDeviceType::GPU) {
+    if (co.device_type == ExecutorDeviceType::GPU &&
+        !decodesDictOnGpu(expr->get_arg(), co)) {
       throw QueryMustRunOnCpu();
     }
   }
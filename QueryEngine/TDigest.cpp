@@ -0,0 +1,138 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/TDigest.h"
+
+#include <algorithm>
+#include <cmath>
+
+size_t g_approx_quantile_centroids{300};
+
+namespace {
+
+// Values buffered per centroid before they're merged.
+constexpr size_t kBufferFactor{4};
+
+}  // namespace
+
+TDigest::TDigest(const double q, const size_t compression)
+    : q_(q), compression_(std::max(compression, size_t(1))) {}
+
+void TDigest::add(const double value) {
+  buffer_.push_back({value, 1});
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+  if (buffer_.size() >= kBufferFactor * compression_) {
+    flush();
+  }
+}
+
+void TDigest::merge(const TDigest& that) {
+  buffer_.insert(buffer_.end(), that.centroids_.begin(), that.centroids_.end());
+  buffer_.insert(buffer_.end(), that.buffer_.begin(), that.buffer_.end());
+  min_ = std::min(min_, that.min_);
+  max_ = std::max(max_, that.max_);
+  if (buffer_.size() >= kBufferFactor * compression_) {
+    flush();
+  }
+}
+
+double TDigest::quantile() const {
+  std::vector<Centroid> merged;
+  if (!buffer_.empty()) {
+    merged = buffer_;
+    merged.insert(merged.end(), centroids_.begin(), centroids_.end());
+    merged = compress(std::move(merged));
+  }
+  const auto& centroids = buffer_.empty() ? centroids_ : merged;
+  if (centroids.empty()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  double total_weight{0};
+  for (const auto& centroid : centroids) {
+    total_weight += centroid.weight;
+  }
+  // Each centroid is assumed to hold half of its weight on either side of its mean, the
+  // quantile is interpolated between the two centroids around its rank.
+  const auto rank = std::min(std::max(q_, 0.), 1.) * total_weight;
+  const auto& first = centroids.front();
+  if (rank < first.weight / 2) {
+    return min_ + (first.mean - min_) * rank / (first.weight / 2);
+  }
+  double weight_so_far = first.weight / 2;
+  for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+    const auto& left = centroids[i];
+    const auto& right = centroids[i + 1];
+    const auto delta_weight = (left.weight + right.weight) / 2;
+    if (weight_so_far + delta_weight > rank) {
+      return left.mean + (right.mean - left.mean) * (rank - weight_so_far) / delta_weight;
+    }
+    weight_so_far += delta_weight;
+  }
+  const auto& last = centroids.back();
+  const auto rank_in_last = std::min(rank - weight_so_far, last.weight / 2);
+  return last.mean + (max_ - last.mean) * rank_in_last / (last.weight / 2);
+}
+
+void TDigest::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+  buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+  centroids_ = compress(std::move(buffer_));
+  buffer_.clear();
+}
+
+std::vector<TDigest::Centroid> TDigest::compress(std::vector<Centroid> points) const {
+  std::vector<Centroid> centroids;
+  if (points.empty()) {
+    return centroids;
+  }
+  std::sort(points.begin(), points.end(), [](const Centroid& lhs, const Centroid& rhs) {
+    return lhs.mean < rhs.mean;
+  });
+  double total_weight{0};
+  for (const auto& point : points) {
+    total_weight += point.weight;
+  }
+  // k1 scale function: a centroid can span one unit of k, which makes the centroids
+  // around the median the largest.
+  const auto delta = static_cast<double>(compression_);
+  const auto k = [delta](const double q) {
+    return delta / (2 * M_PI) * std::asin(2 * q - 1);
+  };
+  const auto k_inverse = [delta](const double k) {
+    const auto angle = std::min(std::max(k * 2 * M_PI / delta, -M_PI / 2), M_PI / 2);
+    return (std::sin(angle) + 1) / 2;
+  };
+  double weight_so_far{0};
+  auto weight_limit = total_weight * k_inverse(k(0) + 1);
+  auto current = points.front();
+  for (size_t i = 1; i < points.size(); ++i) {
+    const auto& point = points[i];
+    if (weight_so_far + current.weight + point.weight <= weight_limit) {
+      current.weight += point.weight;
+      current.mean += (point.mean - current.mean) * point.weight / current.weight;
+      continue;
+    }
+    weight_so_far += current.weight;
+    centroids.push_back(current);
+    weight_limit = total_weight * k_inverse(k(weight_so_far / total_weight) + 1);
+    current = point;
+  }
+  centroids.push_back(current);
+  return centroids;
+}
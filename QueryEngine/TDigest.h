@@ -0,0 +1,66 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+extern size_t g_approx_quantile_centroids;
+
+/**
+ * Merging t-digest (Dunning and Ertl, "Computing Extremely Accurate Quantiles Using
+ * t-Digests"), the state of APPROX_QUANTILE. Values are buffered, then merged into at
+ * most about `compression` centroids sorted by mean; the centroids near the tails hold
+ * fewer values than the ones around the median, which keeps the extreme quantiles
+ * accurate. Digests merge by combining their centroids, in any order.
+ *
+ * Updates are not thread safe, a digest belongs to one group of one kernel or reduction.
+ * quantile() doesn't modify the digest and can be called concurrently.
+ */
+class TDigest {
+ public:
+  TDigest(const double q, const size_t compression = g_approx_quantile_centroids);
+
+  void add(const double value);
+
+  void merge(const TDigest& that);
+
+  // The quantile the digest was created for, NaN if it holds no value.
+  double quantile() const;
+
+  double getQ() const { return q_; }
+
+  size_t getCentroidCount() const { return centroids_.size() + buffer_.size(); }
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  void flush();
+
+  std::vector<Centroid> compress(std::vector<Centroid> points) const;
+
+  const double q_;
+  const size_t compression_;
+  std::vector<Centroid> centroids_;
+  std::vector<Centroid> buffer_;
+  double min_{std::numeric_limits<double>::max()};
+  double max_{std::numeric_limits<double>::lowest()};
+};
@@ -16,11 +16,17 @@
 
 #include "QueryEngine/TableFunctions/TableFunctionExecutionContext.h"
 
+#include <future>
+#include <numeric>
+
 #include "Analyzer/Analyzer.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/TableFunctions/TableFunctionCompilationContext.h"
+#include "Shared/thread_count.h"
+
+extern size_t g_table_function_partition_rows;
 
 namespace {
 
@@ -57,7 +63,8 @@ size_t get_output_row_count(const TableFunctionExecutionUnit& exe_unit,
       allocated_output_row_count = exe_unit.output_buffer_size_param;
       break;
     }
-    case table_functions::OutputBufferSizeType::kUserSpecifiedRowMultiplier: {
+    case table_functions::OutputBufferSizeType::kUserSpecifiedRowMultiplier:
+    case table_functions::OutputBufferSizeType::kUserSpecifiedPartitionedRowMultiplier: {
       allocated_output_row_count =
           exe_unit.output_buffer_size_param * input_element_count;
       break;
@@ -69,6 +76,19 @@ size_t get_output_row_count(const TableFunctionExecutionUnit& exe_unit,
   return allocated_output_row_count;
 }
 
+// Number of partitions the input rows of a table function are split into on CPU, one
+// for the table functions which need all their input at once.
+size_t get_partition_count(const TableFunctionExecutionUnit& exe_unit,
+                           const size_t input_element_count) {
+  if (!exe_unit.table_func.hasPartitionableInput() ||
+      g_table_function_partition_rows == 0) {
+    return 1;
+  }
+  return std::max(std::min(static_cast<size_t>(cpu_threads()),
+                           input_element_count / g_table_function_partition_rows),
+                  size_t(1));
+}
+
 }  // namespace
 
 ResultSetPtr TableFunctionExecutionContext::execute(
@@ -196,10 +216,6 @@ ResultSetPtr TableFunctionExecutionContext::launchCpuCode(
     std::vector<const int8_t*>& col_buf_ptrs,
     const size_t elem_count,
     Executor* executor) {
-  // setup the inputs
-  const auto byte_stream_ptr = reinterpret_cast<const int8_t**>(col_buf_ptrs.data());
-  CHECK(byte_stream_ptr);
-
   // initialize output memory
   auto num_out_columns = exe_unit.target_exprs.size();
   QueryMemoryDescriptor query_mem_desc(
@@ -225,52 +241,103 @@ ResultSetPtr TableFunctionExecutionContext::launchCpuCode(
       executor);
 
   // setup the output
-  int64_t output_row_count = allocated_output_row_count;
   auto group_by_buffers_ptr = query_buffers->getGroupByBuffersPtr();
   CHECK(group_by_buffers_ptr);
 
   auto output_buffers_ptr = reinterpret_cast<int64_t*>(group_by_buffers_ptr[0]);
-  std::vector<int64_t*> output_col_buf_ptrs;
-  for (size_t i = 0; i < num_out_columns; i++) {
-    output_col_buf_ptrs.emplace_back(output_buffers_ptr + i * allocated_output_row_count);
-  }
 
-  // execute
-  const auto kernel_element_count = static_cast<int64_t>(elem_count);
-  const auto err = compilation_context->getFuncPtr()(byte_stream_ptr,
-                                                     &kernel_element_count,
-                                                     output_col_buf_ptrs.data(),
-                                                     &output_row_count);
-  if (err) {
-    throw std::runtime_error("Error executing table function: " + std::to_string(err));
+  // The input rows are split evenly between the partitions, each one writes its output
+  // rows to its own slice of the output columns.
+  const auto partition_count = get_partition_count(exe_unit, elem_count);
+  std::vector<size_t> input_row_offsets(partition_count + 1, elem_count);
+  std::vector<size_t> output_row_offsets(partition_count + 1, allocated_output_row_count);
+  for (size_t p = 0; p < partition_count; p++) {
+    input_row_offsets[p] = elem_count * p / partition_count;
+    output_row_offsets[p] = input_row_offsets[p] * exe_unit.output_buffer_size_param;
   }
-  if (exe_unit.table_func.hasNonUserSpecifiedOutputSizeConstant()) {
-    if (static_cast<size_t>(output_row_count) != allocated_output_row_count) {
-      throw std::runtime_error(
-          "Table function with constant sizing parameter must return " +
-          std::to_string(allocated_output_row_count) + " (got " +
-          std::to_string(output_row_count) + ")");
+  std::vector<size_t> input_elem_sizes;
+  for (const auto& input_expr : exe_unit.input_exprs) {
+    const auto& ti = input_expr->get_type_info();
+    // scalars are passed to all the partitions as they are
+    input_elem_sizes.push_back(ti.is_column() ? ti.get_elem_type().get_size() : 0);
+  }
+  CHECK_EQ(input_elem_sizes.size(), col_buf_ptrs.size());
+
+  std::vector<int64_t> output_row_counts(partition_count);
+  auto execute_partition = [&](const size_t p) {
+    std::vector<const int8_t*> partition_col_buf_ptrs;
+    for (size_t i = 0; i < col_buf_ptrs.size(); i++) {
+      partition_col_buf_ptrs.push_back(col_buf_ptrs[i] +
+                                       input_row_offsets[p] * input_elem_sizes[i]);
+    }
+    const auto output_row_capacity = output_row_offsets[p + 1] - output_row_offsets[p];
+    std::vector<int64_t*> output_col_buf_ptrs;
+    for (size_t i = 0; i < num_out_columns; i++) {
+      output_col_buf_ptrs.emplace_back(output_buffers_ptr +
+                                       i * allocated_output_row_count +
+                                       output_row_offsets[p]);
     }
+
+    // execute
+    int64_t output_row_count = output_row_capacity;
+    const auto kernel_element_count =
+        static_cast<int64_t>(input_row_offsets[p + 1] - input_row_offsets[p]);
+    const auto err = compilation_context->getFuncPtr()(
+        reinterpret_cast<const int8_t**>(partition_col_buf_ptrs.data()),
+        &kernel_element_count,
+        output_col_buf_ptrs.data(),
+        &output_row_count);
+    if (err) {
+      throw std::runtime_error("Error executing table function: " + std::to_string(err));
+    }
+    if (exe_unit.table_func.hasNonUserSpecifiedOutputSizeConstant()) {
+      if (static_cast<size_t>(output_row_count) != output_row_capacity) {
+        throw std::runtime_error(
+            "Table function with constant sizing parameter must return " +
+            std::to_string(output_row_capacity) + " (got " +
+            std::to_string(output_row_count) + ")");
+      }
+    } else {
+      if (output_row_count < 0 || (size_t)output_row_count > output_row_capacity) {
+        output_row_count = output_row_capacity;
+      }
+    }
+    output_row_counts[p] = output_row_count;
+  };
+  if (partition_count == 1) {
+    execute_partition(0);
   } else {
-    if (output_row_count < 0 || (size_t)output_row_count > allocated_output_row_count) {
-      output_row_count = allocated_output_row_count;
+    std::vector<std::future<void>> partition_threads;
+    for (size_t p = 0; p < partition_count; p++) {
+      partition_threads.push_back(std::async(std::launch::async, execute_partition, p));
+    }
+    for (auto& child : partition_threads) {
+      child.wait();
+    }
+    for (auto& child : partition_threads) {
+      child.get();
     }
   }
+  const auto output_row_count = std::accumulate(
+      output_row_counts.begin(), output_row_counts.end(), static_cast<int64_t>(0));
   // Update entry count, it may differ from allocated mem size
   query_buffers->getResultSet(0)->updateStorageEntryCount(output_row_count);
 
-  const size_t column_size = output_row_count * sizeof(int64_t);
-  const size_t allocated_column_size = allocated_output_row_count * sizeof(int64_t);
-
-  int8_t* src = reinterpret_cast<int8_t*>(output_buffers_ptr);
+  // Move the output of the partitions next to each other, nothing moves when there's a
+  // single partition filling all its allocated rows.
   int8_t* dst = reinterpret_cast<int8_t*>(output_buffers_ptr);
   for (size_t i = 0; i < num_out_columns; i++) {
-    if (src != dst) {
-      auto t = memmove(dst, src, column_size);
-      CHECK_EQ(dst, t);
+    for (size_t p = 0; p < partition_count; p++) {
+      auto src = reinterpret_cast<int8_t*>(output_buffers_ptr +
+                                           i * allocated_output_row_count +
+                                           output_row_offsets[p]);
+      const size_t partition_column_size = output_row_counts[p] * sizeof(int64_t);
+      if (src != dst) {
+        auto t = memmove(dst, src, partition_column_size);
+        CHECK_EQ(dst, t);
+      }
+      dst += partition_column_size;
     }
-    src += allocated_column_size;
-    dst += column_size;
   }
 
   return query_buffers->getResultSetOwned(0);
@@ -31,6 +31,7 @@ enum class OutputBufferSizeType {
   kConstant,
   kUserSpecifiedConstantParameter,
   kUserSpecifiedRowMultiplier,
+  kUserSpecifiedPartitionedRowMultiplier,
 };
 
 }  // namespace table_functions
\ No newline at end of file
@@ -117,6 +117,34 @@ EXTENSION_NOINLINE int32_t row_addsub(const int copy_multiplier,
   return output_row_count;
 }
 
+// Output rows depend only on their own input row, so the input may be partitioned.
+EXTENSION_NOINLINE int32_t row_repeater(const Column<double>& input_col,
+                                        int repeat_count,
+                                        Column<double>& output_col) {
+  int32_t output_row_count = repeat_count * input_col.getSize();
+  if (output_col.getSize() != output_row_count) {
+    return -1;
+  }
+
+#ifdef __CUDACC__
+  int32_t start = threadIdx.x + blockDim.x * blockIdx.x;
+  int32_t stop = static_cast<int32_t>(input_col.getSize());
+  int32_t step = blockDim.x * gridDim.x;
+#else
+  auto start = 0;
+  auto stop = input_col.getSize();
+  auto step = 1;
+#endif
+
+  for (auto i = start; i < stop; i += step) {
+    for (int c = 0; c < repeat_count; c++) {
+      output_col[i * repeat_count + c] = input_col[i];
+    }
+  }
+
+  return output_row_count;
+}
+
 EXTENSION_NOINLINE int32_t get_max_with_row_offset(const Column<int>& input_col,
                                                    Column<int>& output_max_col,
                                                    Column<int>& output_max_row_col) {
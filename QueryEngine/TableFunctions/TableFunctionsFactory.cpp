@@ -177,6 +177,13 @@ void TableFunctionsFactory::init() {
         std::vector<ExtArgumentType>{ExtArgumentType::ColumnInt32},
         // ExtArgumentType::Int32},
         std::vector<ExtArgumentType>{ExtArgumentType::Int32, ExtArgumentType::Int32});
+    TableFunctionsFactory::add(
+        "row_repeater",
+        TableFunctionOutputRowSizer{
+            OutputBufferSizeType::kUserSpecifiedPartitionedRowMultiplier, 2},
+        std::vector<ExtArgumentType>{ExtArgumentType::ColumnDouble,
+                                     ExtArgumentType::Int32},
+        std::vector<ExtArgumentType>{ExtArgumentType::Double});
   });
 }
 
@@ -55,6 +55,13 @@
       where <sizer value> is user-specified integer value as specified
       in the <sizer> argument position of the table function call.
 
+    + UserSpecifiedPartitionedRowMultiplier - same as
+      UserSpecifiedRowMultiplier, for table functions whose output
+      rows depend only on their own input row. The input columns may
+      be split into partitions which run in parallel on CPU, each one
+      writing at most <sizer value> * <size of its partition> rows,
+      and the outputs of the partitions are concatenated.
+
     + UserSpecifiedConstantParameter - the allocated column size will
       be user-specified integer value as specified in the <sizer>
       argument position of the table function call.
@@ -104,6 +111,8 @@ struct TableFunctionOutputRowSizer {
         return "kUserSpecifiedConstantParameter[" + std::to_string(val) + "]";
       case OutputBufferSizeType::kUserSpecifiedRowMultiplier:
         return "kUserSpecifiedRowMultiplier[" + std::to_string(val) + "]";
+      case OutputBufferSizeType::kUserSpecifiedPartitionedRowMultiplier:
+        return "kUserSpecifiedPartitionedRowMultiplier[" + std::to_string(val) + "]";
       case OutputBufferSizeType::kConstant:
         return "kConstant[" + std::to_string(val) + "]";
     }
@@ -178,7 +187,13 @@ class TableFunction {
   }
 
   bool hasUserSpecifiedOutputSizeMultiplier() const {
-    return output_sizer_.type == OutputBufferSizeType::kUserSpecifiedRowMultiplier;
+    return output_sizer_.type == OutputBufferSizeType::kUserSpecifiedRowMultiplier ||
+           hasPartitionableInput();
+  }
+
+  bool hasPartitionableInput() const {
+    return output_sizer_.type ==
+           OutputBufferSizeType::kUserSpecifiedPartitionedRowMultiplier;
   }
 
   OutputBufferSizeType getOutputRowSizeType() const { return output_sizer_.type; }
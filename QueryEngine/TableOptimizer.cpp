@@ -19,8 +19,14 @@
 #include "Analyzer/Analyzer.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/Execute.h"
+#include "Shared/File.h"
+#include "Shared/UpdelRoll.h"
 #include "Shared/scope.h"
 
+#include <boost/filesystem.hpp>
+
+extern bool g_cache_string_hash;
+
 TableOptimizer::TableOptimizer(const TableDescriptor* td,
                                Executor* executor,
                                const Catalog_Namespace::Catalog& cat)
@@ -110,6 +116,74 @@ inline ExecutionOptions get_execution_options() {
       false, false, false, false, false, false, false, false, 0, false, false, 0, false};
 }
 
+// Calls visitor with the CPU chunk of the column in every fragment of the tables.
+template <typename VISITOR>
+void visit_column_chunks(const Catalog_Namespace::Catalog& cat,
+                         const std::vector<const TableDescriptor*>& table_descriptors,
+                         const int column_id,
+                         VISITOR visitor) {
+  for (const auto td : table_descriptors) {
+    const auto cd = cat.getMetadataForColumn(td->tableId, column_id);
+    CHECK(cd);
+    CHECK(td->fragmenter);
+    const auto table_info = td->fragmenter->getFragmentsForQuery();
+    for (const auto& fragment_info : table_info.fragments) {
+      auto fragment = td->fragmenter->getFragmentInfo(fragment_info.fragmentId);
+      CHECK(fragment);
+      const auto& chunk_metadata_map = fragment->getChunkMetadataMapPhysical();
+      const auto chunk_meta_it = chunk_metadata_map.find(column_id);
+      CHECK(chunk_meta_it != chunk_metadata_map.end());
+      const ChunkKey chunk_key{
+          cat.getCurrentDB().dbId, td->tableId, column_id, fragment->fragmentId};
+      const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                                   &cat.getDataMgr(),
+                                                   chunk_key,
+                                                   Data_Namespace::CPU_LEVEL,
+                                                   0,
+                                                   chunk_meta_it->second->numBytes,
+                                                   chunk_meta_it->second->numElements);
+      visitor(td, cd, *fragment, chunk_key, chunk, chunk_meta_it->second->numElements);
+    }
+  }
+}
+
+template <typename T>
+void mark_referenced_string_ids(const int8_t* data,
+                                const size_t num_elems,
+                                std::vector<bool>& referenced) {
+  const auto string_ids = reinterpret_cast<const T*>(data);
+  for (size_t i = 0; i < num_elems; ++i) {
+    if (string_ids[i] != inline_int_null_value<T>()) {
+      CHECK_LT(static_cast<size_t>(string_ids[i]), referenced.size());
+      referenced[string_ids[i]] = true;
+    }
+  }
+}
+
+// Replaces the string ids by their ids in the compacted dictionary, returns the range of
+// the new ids and whether there are nulls.
+template <typename T>
+std::tuple<int64_t, int64_t, bool> remap_string_ids(int8_t* data,
+                                                    const size_t num_elems,
+                                                    const std::vector<int32_t>& id_map) {
+  int64_t min_id = std::numeric_limits<int64_t>::max();
+  int64_t max_id = std::numeric_limits<int64_t>::min();
+  bool has_nulls = false;
+  auto string_ids = reinterpret_cast<T*>(data);
+  for (size_t i = 0; i < num_elems; ++i) {
+    if (string_ids[i] == inline_int_null_value<T>()) {
+      has_nulls = true;
+      continue;
+    }
+    const auto new_id = id_map[string_ids[i]];
+    CHECK_GE(new_id, 0);
+    string_ids[i] = static_cast<T>(new_id);
+    min_id = std::min<int64_t>(min_id, new_id);
+    max_id = std::max<int64_t>(max_id, new_id);
+  }
+  return {min_id, max_id, has_nulls};
+}
+
 }  // namespace
 
 void TableOptimizer::recomputeMetadata() const {
@@ -347,3 +421,219 @@ void TableOptimizer::vacuumDeletedRows() const {
   cat_.vacuumDeletedRows(table_id);
   cat_.checkpoint(table_id);
 }
+
+void TableOptimizer::compactDictionaries() const {
+  {
+    INJECT_TIMER(compactDictionaries);
+    mapd_unique_lock<mapd_shared_mutex> lock(executor_->execute_mutex_);
+    if (g_cluster) {
+      throw std::runtime_error(
+          "Compacting dictionaries is not supported in distributed mode.");
+    }
+    const auto table_descriptors = cat_.getPhysicalTablesDescriptors(td_);
+    const auto cds = cat_.getAllColumnMetadataForTable(td_->tableId, false, false, false);
+    for (const auto cd : cds) {
+      if (!cd->columnType.is_dict_encoded_string()) {
+        continue;
+      }
+      const auto dd = cat_.getMetadataForDict(cd->columnType.get_comp_param(), true);
+      CHECK(dd);
+      if (dd->dictIsTemp || dd->refcount > 1) {
+        LOG(INFO) << "Skipping the dictionary of " << td_->tableName << "."
+                  << cd->columnName << ", it is shared or temporary";
+        continue;
+      }
+      compactDictionary(cd, dd, table_descriptors);
+    }
+    executor_->clearMetaInfoCache();
+  }
+  // the cached chunks and join hash tables have the ids of the replaced dictionaries
+  Executor::clearMemory(Data_Namespace::MemoryLevel::CPU_LEVEL);
+  if (cat_.getDataMgr().gpusPresent()) {
+    Executor::clearMemory(Data_Namespace::MemoryLevel::GPU_LEVEL);
+  }
+}
+
+std::map<int, ColumnStatistics> TableOptimizer::computeColumnStatistics() const {
+  INJECT_TIMER(computeColumnStatistics);
+  if (g_cluster) {
+    throw std::runtime_error(
+        "Computing column statistics is not supported in distributed mode.");
+  }
+  const auto table_descriptors = cat_.getPhysicalTablesDescriptors(td_);
+  const auto cds = cat_.getAllColumnMetadataForTable(td_->tableId, false, false, false);
+  std::map<int, ColumnStatistics> statistics;
+  for (const auto cd : cds) {
+    if (!ColumnStatistics::isSupported(cd->columnType)) {
+      continue;
+    }
+    ColumnStatisticsBuilder builder(cd->columnType);
+    visit_column_chunks(
+        cat_,
+        table_descriptors,
+        cd->columnId,
+        [this, &builder](const TableDescriptor* td,
+                         const ColumnDescriptor*,
+                         Fragmenter_Namespace::FragmentInfo& fragment,
+                         const ChunkKey&,
+                         const std::shared_ptr<Chunk_NS::Chunk>& chunk,
+                         const size_t num_elems) {
+          std::shared_ptr<Chunk_NS::Chunk> deleted_chunk;
+          if (const auto deleted_cd = cat_.getDeletedColumnIfRowsDeleted(td)) {
+            const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+            const auto chunk_meta_it = chunk_metadata_map.find(deleted_cd->columnId);
+            CHECK(chunk_meta_it != chunk_metadata_map.end());
+            const ChunkKey deleted_chunk_key{cat_.getCurrentDB().dbId,
+                                             td->tableId,
+                                             deleted_cd->columnId,
+                                             fragment.fragmentId};
+            deleted_chunk =
+                Chunk_NS::Chunk::getChunk(deleted_cd,
+                                          &cat_.getDataMgr(),
+                                          deleted_chunk_key,
+                                          Data_Namespace::CPU_LEVEL,
+                                          0,
+                                          chunk_meta_it->second->numBytes,
+                                          chunk_meta_it->second->numElements);
+            CHECK_EQ(chunk_meta_it->second->numElements, num_elems);
+          }
+          builder.addChunkValues(
+              chunk->getBuffer()->getMemoryPtr(),
+              num_elems,
+              deleted_chunk ? deleted_chunk->getBuffer()->getMemoryPtr() : nullptr);
+        });
+    statistics.emplace(cd->columnId, builder.build());
+  }
+  return statistics;
+}
+
+void TableOptimizer::compactDictionary(
+    const ColumnDescriptor* cd,
+    const DictDescriptor* dd,
+    const std::vector<const TableDescriptor*>& table_descriptors) const {
+  const auto string_dict = dd->stringDict;
+  CHECK(string_dict);
+  const auto str_count = string_dict->storageEntryCount();
+  const auto id_width = cd->columnType.get_size();
+  std::vector<bool> referenced(str_count);
+  visit_column_chunks(
+      cat_,
+      table_descriptors,
+      cd->columnId,
+      [id_width, &referenced](const TableDescriptor*,
+                              const ColumnDescriptor*,
+                              Fragmenter_Namespace::FragmentInfo&,
+                              const ChunkKey&,
+                              const std::shared_ptr<Chunk_NS::Chunk>& chunk,
+                              const size_t num_elems) {
+        const auto data = chunk->getBuffer()->getMemoryPtr();
+        switch (id_width) {
+          case 1:
+            mark_referenced_string_ids<uint8_t>(data, num_elems, referenced);
+            break;
+          case 2:
+            mark_referenced_string_ids<uint16_t>(data, num_elems, referenced);
+            break;
+          case 4:
+            mark_referenced_string_ids<int32_t>(data, num_elems, referenced);
+            break;
+          default:
+            CHECK(false);
+        }
+      });
+
+  // the referenced strings keep the order of their ids
+  std::vector<int32_t> id_map(str_count, StringDictionary::INVALID_STR_ID);
+  std::vector<std::string> strings;
+  for (size_t string_id = 0; string_id < str_count; ++string_id) {
+    if (referenced[string_id]) {
+      id_map[string_id] = strings.size();
+      strings.push_back(string_dict->getString(string_id));
+    }
+  }
+  if (strings.size() == str_count) {
+    return;
+  }
+  LOG(INFO) << "Compacting the dictionary of " << td_->tableName << "." << cd->columnName
+            << " from " << str_count << " to " << strings.size() << " strings";
+
+  const auto compacted_dict_folder = dd->dictFolderPath + "_compacted";
+  const auto replaced_dict_folder = dd->dictFolderPath + "_precompaction";
+  boost::filesystem::remove_all(compacted_dict_folder);
+  boost::filesystem::remove_all(replaced_dict_folder);
+  boost::filesystem::create_directory(compacted_dict_folder);
+  {
+    StringDictionary compacted_dict(
+        compacted_dict_folder, false, false, g_cache_string_hash);
+    std::vector<int32_t> compacted_ids(strings.size());
+    compacted_dict.getOrAddBulk(strings, compacted_ids.data());
+    CHECK_EQ(strings.size(), compacted_dict.storageEntryCount());
+    if (!compacted_dict.checkpoint()) {
+      throw std::runtime_error("Failed to checkpoint the compacted dictionary of " +
+                               cd->columnName);
+    }
+  }
+
+  UpdelRoll updel_roll;
+  updel_roll.catalog = &cat_;
+  updel_roll.logicalTableId = td_->tableId;
+  updel_roll.memoryLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
+  visit_column_chunks(
+      cat_,
+      table_descriptors,
+      cd->columnId,
+      [id_width, &id_map, &updel_roll](const TableDescriptor* td,
+                                       const ColumnDescriptor* physical_cd,
+                                       Fragmenter_Namespace::FragmentInfo& fragment,
+                                       const ChunkKey& chunk_key,
+                                       const std::shared_ptr<Chunk_NS::Chunk>& chunk,
+                                       const size_t num_elems) {
+        auto buffer = chunk->getBuffer();
+        const auto data = buffer->getMemoryPtr();
+        std::tuple<int64_t, int64_t, bool> id_stats;
+        switch (id_width) {
+          case 1:
+            id_stats = remap_string_ids<uint8_t>(data, num_elems, id_map);
+            break;
+          case 2:
+            id_stats = remap_string_ids<uint16_t>(data, num_elems, id_map);
+            break;
+          case 4:
+            id_stats = remap_string_ids<int32_t>(data, num_elems, id_map);
+            break;
+          default:
+            CHECK(false);
+        }
+        buffer->setUpdated();
+        const auto [min_id, max_id, has_nulls] = id_stats;
+        // widens the stats, recomputeMetadata() narrows them again
+        td->fragmenter->updateColumnMetadata(physical_cd,
+                                             fragment,
+                                             chunk,
+                                             has_nulls,
+                                             0,
+                                             0,
+                                             max_id,
+                                             min_id,
+                                             physical_cd->columnType,
+                                             updel_roll);
+        updel_roll.dirtyChunks.emplace(chunk.get(), chunk);
+        updel_roll.dirtyChunkeys.insert(chunk_key);
+      });
+
+  // the chunks with the new ids and the compacted dictionary are made durable by the
+  // checkpoint of the table
+  cat_.replaceDictionaryStorage(
+      dd->dictRef.dictId, compacted_dict_folder, replaced_dict_folder);
+  try {
+    updel_roll.commitUpdate();
+  } catch (...) {
+    // the epochs of the table were reset, put the dictionary of the old ids back
+    cat_.replaceDictionaryStorage(
+        dd->dictRef.dictId, replaced_dict_folder, compacted_dict_folder);
+    File_Namespace::renameForDelete(compacted_dict_folder);
+    cat_.getDataMgr().clearMemory(Data_Namespace::MemoryLevel::CPU_LEVEL);
+    throw;
+  }
+  File_Namespace::renameForDelete(replaced_dict_folder);
+}
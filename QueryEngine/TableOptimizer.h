@@ -51,7 +51,29 @@ class TableOptimizer {
    */
   void vacuumDeletedRows() const;
 
+  /**
+   * @brief Rebuilds the dictionaries of the string columns with only the strings the
+   * rows reference.
+   * Dictionaries only grow, the strings of deleted or updated rows stay in them. The
+   * referenced strings are copied to a new dictionary, in the order of their ids, and
+   * the chunks of the column are rewritten with the new ids before the new dictionary
+   * replaces the old one. Dictionaries shared with other columns are skipped. Rows
+   * which are deleted but not vacuumed still reference their strings.
+   */
+  void compactDictionaries() const;
+
+  /**
+   * @brief Computes the statistics of the columns of the table for the planner.
+   * Scans the chunks of the columns which can have statistics, see ColumnStatistics,
+   * skipping the deleted rows. Returns the statistics keyed by column id.
+   */
+  std::map<int, ColumnStatistics> computeColumnStatistics() const;
+
  private:
+  void compactDictionary(const ColumnDescriptor* cd,
+                         const DictDescriptor* dd,
+                         const std::vector<const TableDescriptor*>& table_descriptors) const;
+
   const TableDescriptor* td_;
   Executor* executor_;
   const Catalog_Namespace::Catalog& cat_;
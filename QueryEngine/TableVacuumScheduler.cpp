@@ -0,0 +1,237 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TableVacuumScheduler.h"
+
+#include "DataMgr/Chunk/Chunk.h"
+#include "LockMgr/LockMgr.h"
+#include "Logger/Logger.h"
+#include "Shared/UpdelRoll.h"
+
+#include <algorithm>
+#include <optional>
+
+bool g_enable_background_vacuum{false};
+float g_background_vacuum_deleted_ratio{0.2};
+size_t g_background_vacuum_mb_per_sec{0};
+
+namespace {
+
+struct FragmentToVacuum {
+  const TableDescriptor* shard;
+  ChunkKey deleted_chunk_key;
+  double deleted_ratio;
+};
+
+std::vector<uint64_t> get_deleted_offsets(const Catalog_Namespace::Catalog& catalog,
+                                          const TableDescriptor* shard,
+                                          const ChunkKey& deleted_chunk_key,
+                                          const ChunkMetadata& chunk_metadata) {
+  const auto cd = catalog.getMetadataForColumn(shard->tableId, deleted_chunk_key[2]);
+  CHECK(cd);
+  const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                               &catalog.getDataMgr(),
+                                               deleted_chunk_key,
+                                               Data_Namespace::MemoryLevel::CPU_LEVEL,
+                                               0,
+                                               chunk_metadata.numBytes,
+                                               chunk_metadata.numElements);
+  return shard->fragmenter->getVacuumOffsets(chunk);
+}
+
+void add_fragments_to_vacuum(const Catalog_Namespace::Catalog& catalog,
+                             const TableDescriptor* shard,
+                             std::vector<FragmentToVacuum>& fragments) {
+  const auto cd = catalog.getDeletedColumn(shard);
+  if (!cd) {
+    return;
+  }
+  ChunkMetadataVector chunk_metadata_vec;
+  catalog.getDataMgr().getChunkMetadataVecForKeyPrefix(
+      chunk_metadata_vec, {catalog.getCurrentDB().dbId, shard->tableId, cd->columnId});
+  for (const auto& [chunk_key, chunk_metadata] : chunk_metadata_vec) {
+    // only the fragments whose metadata shows a delete
+    if (chunk_metadata->chunkStats.max.tinyintval != 1 || !chunk_metadata->numElements) {
+      continue;
+    }
+    const auto deleted_count =
+        get_deleted_offsets(catalog, shard, chunk_key, *chunk_metadata).size();
+    const auto deleted_ratio =
+        static_cast<double>(deleted_count) / chunk_metadata->numElements;
+    if (deleted_ratio >= g_background_vacuum_deleted_ratio) {
+      fragments.push_back({shard, chunk_key, deleted_ratio});
+    }
+  }
+}
+
+// Returns the size of the fragment before the vacuum, nothing if it had no deleted rows
+// left.
+std::optional<size_t> vacuum_fragment(const Catalog_Namespace::Catalog& catalog,
+                                      const FragmentToVacuum& fragment) {
+  ChunkMetadataVector chunk_metadata_vec;
+  catalog.getDataMgr().getChunkMetadataVecForKeyPrefix(chunk_metadata_vec,
+                                                       fragment.deleted_chunk_key);
+  if (chunk_metadata_vec.empty()) {
+    return std::nullopt;
+  }
+  const auto deleted_offsets = get_deleted_offsets(catalog,
+                                                   fragment.shard,
+                                                   fragment.deleted_chunk_key,
+                                                   *chunk_metadata_vec.front().second);
+  if (deleted_offsets.empty()) {
+    return std::nullopt;
+  }
+  const auto fragmenter = fragment.shard->fragmenter;
+  const auto fragment_id = fragment.deleted_chunk_key[3];
+  size_t num_bytes{0};
+  for (const auto& [column_id, chunk_metadata] :
+       fragmenter->getFragmentInfo(fragment_id)->getChunkMetadataMapPhysical()) {
+    num_bytes += chunk_metadata->numBytes;
+  }
+
+  UpdelRoll updel_roll;
+  updel_roll.catalog = &catalog;
+  updel_roll.logicalTableId = catalog.getLogicalTableId(fragment.shard->tableId);
+  updel_roll.memoryLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
+  fragmenter->compactRows(&catalog,
+                          fragment.shard,
+                          fragment_id,
+                          deleted_offsets,
+                          updel_roll.memoryLevel,
+                          updel_roll);
+  updel_roll.commitUpdate();
+  return num_bytes;
+}
+
+}  // namespace
+
+void TableVacuumScheduler::start(std::atomic<bool>& is_program_running) {
+  if (!is_scheduler_running_) {
+    stop_requested_ = false;
+    scheduler_thread_ = std::thread([&is_program_running]() {
+      while (is_program_running) {
+        auto& sys_catalog = Catalog_Namespace::SysCatalog::instance();
+        for (const auto& catalog : sys_catalog.getCatalogsForAllDbs()) {
+          std::vector<std::string> table_names;
+          for (const auto td : catalog->getAllTableMetadata()) {
+            if (td->hasDeletedCol && !td->isView && td->shard < 0 &&
+                td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL &&
+                td->storageType != StorageType::FOREIGN_TABLE) {
+              table_names.push_back(td->tableName);
+            }
+          }
+          for (const auto& table_name : table_names) {
+            if (!is_program_running) {
+              return;
+            }
+            try {
+              vacuumTable(*catalog, table_name);
+            } catch (std::exception& e) {
+              LOG(ERROR) << "Background vacuum of table \"" << table_name
+                         << "\" resulted in an error. " << e.what();
+            }
+          }
+        }
+        if (!waitFor(thread_wait_duration_)) {
+          return;
+        }
+      }
+    });
+    is_scheduler_running_ = true;
+  }
+}
+
+void TableVacuumScheduler::stop() {
+  if (is_scheduler_running_) {
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex_);
+      stop_requested_ = true;
+    }
+    stop_cv_.notify_all();
+    scheduler_thread_.join();
+    is_scheduler_running_ = false;
+  }
+}
+
+size_t TableVacuumScheduler::vacuumTable(const Catalog_Namespace::Catalog& catalog,
+                                         const std::string& table_name) {
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          catalog, table_name);
+  const auto td = td_with_lock();
+  if (!td) {
+    throw std::runtime_error("Table " + table_name + " does not exist.");
+  }
+
+  std::vector<FragmentToVacuum> fragments;
+  {
+    const auto insert_data_lock =
+        lockmgr::InsertDataLockMgr::getWriteLockForTable(catalog, table_name);
+    for (const auto shard : catalog.getPhysicalTablesDescriptors(td)) {
+      add_fragments_to_vacuum(catalog, shard, fragments);
+    }
+  }
+  std::stable_sort(fragments.begin(),
+                   fragments.end(),
+                   [](const FragmentToVacuum& lhs, const FragmentToVacuum& rhs) {
+                     return lhs.deleted_ratio > rhs.deleted_ratio;
+                   });
+
+  size_t vacuumed_count{0};
+  for (const auto& fragment : fragments) {
+    const auto clock_begin = std::chrono::steady_clock::now();
+    std::optional<size_t> num_bytes;
+    {
+      // the fragments are vacuumed one at a time, loads can go on in between
+      const auto insert_data_lock =
+          lockmgr::InsertDataLockMgr::getWriteLockForTable(catalog, table_name);
+      num_bytes = vacuum_fragment(catalog, fragment);
+    }
+    if (!num_bytes) {
+      continue;
+    }
+    ++vacuumed_count;
+    if (g_background_vacuum_mb_per_sec) {
+      const std::chrono::milliseconds min_duration(
+          *num_bytes * 1000 / (g_background_vacuum_mb_per_sec * 1024 * 1024));
+      const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - clock_begin);
+      if (duration < min_duration && !waitFor(min_duration - duration)) {
+        break;
+      }
+    }
+  }
+  if (vacuumed_count) {
+    LOG(INFO) << "Vacuumed " << vacuumed_count << " fragments of table " << table_name;
+  }
+  return vacuumed_count;
+}
+
+void TableVacuumScheduler::setWaitDuration(int64_t duration_in_seconds) {
+  thread_wait_duration_ = std::chrono::seconds{duration_in_seconds};
+}
+
+bool TableVacuumScheduler::waitFor(const std::chrono::milliseconds duration) {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  return !stop_cv_.wait_for(lock, duration, [] { return stop_requested_; });
+}
+
+bool TableVacuumScheduler::is_scheduler_running_{false};
+bool TableVacuumScheduler::stop_requested_{false};
+std::mutex TableVacuumScheduler::stop_mutex_;
+std::condition_variable TableVacuumScheduler::stop_cv_;
+std::chrono::seconds TableVacuumScheduler::thread_wait_duration_{60};
+std::thread TableVacuumScheduler::scheduler_thread_;
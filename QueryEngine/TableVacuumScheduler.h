@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Catalog/Catalog.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+extern bool g_enable_background_vacuum;
+extern float g_background_vacuum_deleted_ratio;
+extern size_t g_background_vacuum_mb_per_sec;
+
+/**
+ * @brief Vacuums the deleted rows of tables in the background.
+ * OPTIMIZE TABLE ... WITH (VACUUM='TRUE') rewrites every fragment with deleted rows at
+ * once, with the table locked. The scheduler instead periodically reads the deleted
+ * column of the fragments whose metadata shows deleted rows, and vacuums the fragments
+ * with at least g_background_vacuum_deleted_ratio of their rows deleted, most deleted
+ * first. Each fragment is compacted and checkpointed on its own under the insert lock of
+ * the table, as the vacuum done by DELETE is, so loads and deletes go on between the
+ * fragments of a large table. The fragments are paced to rewrite at most
+ * g_background_vacuum_mb_per_sec, 0 doesn't limit the rate.
+ */
+class TableVacuumScheduler {
+ public:
+  static void start(std::atomic<bool>& is_program_running);
+  static void stop();
+
+  // Vacuums the fragments of the table over the deleted ratio, returns how many were.
+  static size_t vacuumTable(const Catalog_Namespace::Catalog& catalog,
+                            const std::string& table_name);
+
+  // for testing
+  static void setWaitDuration(int64_t duration_in_seconds);
+
+ private:
+  // Sleeps for `duration`, returns false if the scheduler is stopped meanwhile.
+  static bool waitFor(const std::chrono::milliseconds duration);
+
+  static bool is_scheduler_running_;
+  static bool stop_requested_;
+  static std::mutex stop_mutex_;
+  static std::condition_variable stop_cv_;
+  static std::chrono::seconds thread_wait_duration_;
+  static std::thread scheduler_thread_;
+};
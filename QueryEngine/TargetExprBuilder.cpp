@@ -67,6 +67,8 @@ std::vector<std::string> agg_fn_base_names(const TargetInfo& target_info) {
       return {"checked_single_agg_id"};
     case kSAMPLE:
       return {"agg_id"};
+    case kAPPROX_QUANTILE:
+      return {"agg_approx_quantile"};
     default:
       UNREACHABLE() << "Unrecognized agg kind: " << std::to_string(target_info.agg_kind);
   }
@@ -122,7 +124,8 @@ void TargetExprCodegen::codegen(
   if (window_row_ptr) {
     agg_out_ptr_w_idx =
         std::make_tuple(window_row_ptr, std::get<1>(agg_out_ptr_w_idx_in));
-    if (window_function_is_aggregate(window_func->getKind())) {
+    if (window_function_is_aggregate(window_func->getKind()) &&
+        !window_function_is_rows_frame_aggregate(window_func)) {
       out_row_idx = window_row_ptr;
     }
   }
@@ -338,6 +341,18 @@ void TargetExprCodegen::codegenAggregate(
       agg_col_ptr->setName("agg_col_ptr");
     }
 
+    if (is_approx_quantile_target(target_info)) {
+      CHECK_EQ(chosen_bytes, sizeof(int64_t));
+      std::vector<llvm::Value*> agg_args{
+          executor->castToIntPtrTyIn(is_group_by ? agg_col_ptr : agg_out_vec[slot_index],
+                                     64),
+          target_lvs[target_lv_idx]};
+      group_by_and_agg->codegenApproxQuantile(target_expr, agg_args, co.device_type);
+      ++slot_index;
+      ++target_lv_idx;
+      continue;
+    }
+
     const bool float_argument_input = takes_float_argument(target_info);
     const bool is_count_in_avg = target_info.agg_kind == kAVG && target_lv_idx == 1;
     // The count component of an average should never be compacted.
@@ -86,6 +86,7 @@ inline TAggKind::type agg_kind_to_thrift(const SQLAgg agg) {
     THRIFT_AGGKIND_CASE(APPROX_COUNT_DISTINCT)
     THRIFT_AGGKIND_CASE(SAMPLE)
     THRIFT_AGGKIND_CASE(SINGLE_VALUE)
+    THRIFT_AGGKIND_CASE(APPROX_QUANTILE)
     default:
       CHECK(false) << static_cast<int>(agg);
   }
@@ -108,6 +109,7 @@ inline SQLAgg agg_kind_from_thrift(const TAggKind::type agg) {
     UNTHRIFT_AGGKIND_CASE(APPROX_COUNT_DISTINCT)
     UNTHRIFT_AGGKIND_CASE(SAMPLE)
     UNTHRIFT_AGGKIND_CASE(SINGLE_VALUE)
+    UNTHRIFT_AGGKIND_CASE(APPROX_QUANTILE)
     default:
       CHECK(false) << static_cast<int>(agg);
   }
@@ -299,6 +301,8 @@ inline TCountDistinctImplType::type count_distinct_impl_type_to_thrift(
     THRIFT_COUNTDESCRIPTORIMPL_CASE(Invalid)
     THRIFT_COUNTDESCRIPTORIMPL_CASE(Bitmap)
     THRIFT_COUNTDESCRIPTORIMPL_CASE(StdSet)
+    THRIFT_COUNTDESCRIPTORIMPL_CASE(SparseHll)
+    THRIFT_COUNTDESCRIPTORIMPL_CASE(RoaringBitmap)
     default:
       CHECK(false);
   }
@@ -334,6 +338,8 @@ inline CountDistinctImplType count_distinct_impl_type_from_thrift(
     UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(Invalid)
     UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(Bitmap)
     UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(StdSet)
+    UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(SparseHll)
+    UNTHRIFT_COUNTDESCRIPTORIMPL_CASE(RoaringBitmap)
     default:
       CHECK(false);
   }
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/TopKGroupPruner.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <unordered_set>
+
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/ExpressionRange.h"
+#include "QueryEngine/MurmurHash.h"
+#include "QueryEngine/ResultSet.h"
+#include "QueryEngine/ResultSetBufferAccessors.h"
+#include "QueryEngine/RuntimeFunctions.h"
+#include "Shared/threadpool.h"
+
+bool g_enable_top_k_group_pruning{false};
+
+extern bool g_cluster;
+
+namespace {
+
+// Pruning is given up when more than this fraction of the groups are candidates, the
+// reduction would hardly get cheaper.
+constexpr size_t kMaxCandidateFraction{4};
+
+struct OrderTarget {
+  size_t slot_idx;
+  int8_t slot_width;
+  // 1 when the top groups have the largest values, -1 when they have the smallest
+  int64_t sign;
+  // the partials of a group add up to its value, the best one is its value otherwise
+  bool additive;
+  std::optional<int64_t> null_val;
+};
+
+bool is_prunable_layout(const ResultSet& rows) {
+  const auto& query_mem_desc = rows.getQueryMemDesc();
+  const auto query_type = query_mem_desc.getQueryDescriptionType();
+  return rows.getStorage() &&
+         (query_type == QueryDescriptionType::GroupByPerfectHash ||
+          query_type == QueryDescriptionType::GroupByBaselineHash) &&
+         !query_mem_desc.didOutputColumnar() && !query_mem_desc.hasKeylessHash() &&
+         !query_mem_desc.hasInterleavedBinsOnGpu() &&
+         (query_mem_desc.getEffectiveKeyWidth() == sizeof(int32_t) ||
+          query_mem_desc.getEffectiveKeyWidth() == sizeof(int64_t));
+}
+
+std::optional<OrderTarget> get_order_target(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const Executor* executor,
+    const ResultSet& rows) {
+  const auto& order_entry = ra_exe_unit.sort_info.order_entries.front();
+  if (order_entry.nulls_first) {
+    return std::nullopt;
+  }
+  const size_t target_idx = order_entry.tle_no - 1;
+  CHECK_LT(target_idx, ra_exe_unit.target_exprs.size());
+  const auto agg_expr =
+      dynamic_cast<const Analyzer::AggExpr*>(ra_exe_unit.target_exprs[target_idx]);
+  if (!agg_expr || agg_expr->get_is_distinct()) {
+    return std::nullopt;
+  }
+  const auto& target_ti = rows.getTargetInfos()[target_idx].sql_type;
+  if (!target_ti.is_integer() && !target_ti.is_decimal()) {
+    return std::nullopt;
+  }
+  const int64_t sign = order_entry.is_desc ? 1 : -1;
+  bool additive{false};
+  switch (agg_expr->get_aggtype()) {
+    case kCOUNT:
+      if (sign < 0) {
+        return std::nullopt;
+      }
+      additive = true;
+      break;
+    case kSUM: {
+      // the partial sums only bound the sums if no value goes against the order
+      const auto arg_range =
+          getExpressionRange(agg_expr->get_arg(), query_infos, executor);
+      if (arg_range.getType() != ExpressionRangeType::Integer ||
+          (sign > 0 ? arg_range.getIntMin() < 0 : arg_range.getIntMax() > 0)) {
+        return std::nullopt;
+      }
+      additive = true;
+      break;
+    }
+    case kMAX:
+      if (sign < 0) {
+        return std::nullopt;
+      }
+      break;
+    case kMIN:
+      if (sign > 0) {
+        return std::nullopt;
+      }
+      break;
+    default:
+      return std::nullopt;
+  }
+  const auto& query_mem_desc = rows.getQueryMemDesc();
+  const auto& slots = query_mem_desc.getColSlotContext().getSlotsForCol(target_idx);
+  if (slots.empty()) {
+    return std::nullopt;
+  }
+  const auto slot_idx = static_cast<size_t>(slots.front());
+  const auto slot_width = query_mem_desc.getPaddedSlotWidthBytes(slot_idx);
+  std::optional<int64_t> null_val;
+  if (agg_expr->get_aggtype() != kCOUNT) {
+    // the null sentinel of a compacted slot is not the one of the target type
+    if (slot_width != sizeof(int64_t)) {
+      return std::nullopt;
+    }
+    null_val = null_val_bit_pattern(target_ti, false);
+  } else if (slot_width != sizeof(int32_t) && slot_width != sizeof(int64_t)) {
+    return std::nullopt;
+  }
+  return OrderTarget{slot_idx, slot_width, sign, additive, null_val};
+}
+
+// Calls `func` with the row of every group of `rows`.
+void for_each_group(const ResultSet& rows, const std::function<void(int8_t*)>& func) {
+  const auto& query_mem_desc = rows.getQueryMemDesc();
+  const auto buff = rows.getStorage()->getUnderlyingBuffer();
+  const auto key_width = query_mem_desc.getEffectiveKeyWidth();
+  for (size_t entry_idx = 0; entry_idx < query_mem_desc.getEntryCount(); ++entry_idx) {
+    const auto row_ptr = row_ptr_rowwise(buff, query_mem_desc, entry_idx);
+    const bool is_empty =
+        key_width == sizeof(int32_t)
+            ? *reinterpret_cast<const int32_t*>(row_ptr) == EMPTY_KEY_32
+            : *reinterpret_cast<const int64_t*>(row_ptr) == EMPTY_KEY_64;
+    if (!is_empty) {
+      func(row_ptr);
+    }
+  }
+}
+
+// The partial of the group in `row_ptr`, negated for ASC so that larger is always better.
+std::optional<int64_t> get_partial(const int8_t* row_ptr,
+                                   const QueryMemoryDescriptor& query_mem_desc,
+                                   const OrderTarget& target) {
+  const auto val = read_int_from_buff(
+      row_ptr + query_mem_desc.getColOffInBytes(target.slot_idx), target.slot_width);
+  if ((target.null_val && val == *target.null_val) ||
+      val == std::numeric_limits<int64_t>::min()) {
+    return std::nullopt;
+  }
+  return target.sign * val;
+}
+
+uint64_t hash_key(const int8_t* row_ptr, const QueryMemoryDescriptor& query_mem_desc) {
+  return MurmurHash64A(row_ptr, get_key_bytes_rowwise(query_mem_desc), 0);
+}
+
+}  // namespace
+
+namespace top_k_groups {
+
+bool prune(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const Executor* executor,
+    std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& results_per_device) {
+  const auto& sort_info = ra_exe_unit.sort_info;
+  // the leaves of a cluster only hold some of the partials of a group
+  if (!g_enable_top_k_group_pruning || g_cluster || results_per_device.size() < 2 ||
+      ra_exe_unit.groupby_exprs.empty() || sort_info.order_entries.size() != 1 ||
+      !sort_info.limit || sort_info.algorithm == SortAlgorithm::StreamingTopN) {
+    return false;
+  }
+  for (const auto& result : results_per_device) {
+    if (!result.first || !is_prunable_layout(*result.first)) {
+      return false;
+    }
+  }
+  const auto& first = *results_per_device.front().first;
+  const auto target = get_order_target(ra_exe_unit, query_infos, executor, first);
+  if (!target) {
+    return false;
+  }
+  const size_t top_n = sort_info.limit + sort_info.offset;
+  const auto kernel_count = results_per_device.size();
+
+  // the n-th best partial of each kernel with n groups at least
+  std::vector<std::optional<int64_t>> kernel_thresholds(kernel_count);
+  std::vector<size_t> kernel_group_counts(kernel_count);
+  {
+    threadpool::FuturesThreadPool<void> thread_pool;
+    for (size_t kernel_idx = 0; kernel_idx < kernel_count; ++kernel_idx) {
+      thread_pool.spawn([&, kernel_idx] {
+        const auto& rows = *results_per_device[kernel_idx].first;
+        std::vector<int64_t> partials;
+        for_each_group(rows, [&](int8_t* row_ptr) {
+          ++kernel_group_counts[kernel_idx];
+          if (const auto partial =
+                  get_partial(row_ptr, rows.getQueryMemDesc(), *target)) {
+            partials.push_back(*partial);
+          }
+        });
+        if (partials.size() >= top_n) {
+          std::nth_element(partials.begin(),
+                           partials.begin() + (top_n - 1),
+                           partials.end(),
+                           std::greater<int64_t>());
+          kernel_thresholds[kernel_idx] = partials[top_n - 1];
+        }
+      });
+    }
+    thread_pool.join();
+  }
+  std::optional<int64_t> threshold;
+  for (const auto& kernel_threshold : kernel_thresholds) {
+    if (kernel_threshold && (!threshold || *kernel_threshold > *threshold)) {
+      threshold = kernel_threshold;
+    }
+  }
+  if (!threshold || (target->additive && *threshold <= 0)) {
+    return false;
+  }
+  // a group with all its partials below the cutoff ends up below the threshold
+  const int64_t divisor = static_cast<int64_t>(kernel_count);
+  const int64_t cutoff =
+      target->additive
+          ? *threshold / divisor + (*threshold % divisor != 0 ? 1 : 0)
+          : *threshold;
+
+  std::vector<std::vector<uint64_t>> kernel_candidates(kernel_count);
+  {
+    threadpool::FuturesThreadPool<void> thread_pool;
+    for (size_t kernel_idx = 0; kernel_idx < kernel_count; ++kernel_idx) {
+      thread_pool.spawn([&, kernel_idx] {
+        const auto& rows = *results_per_device[kernel_idx].first;
+        for_each_group(rows, [&](int8_t* row_ptr) {
+          const auto partial = get_partial(row_ptr, rows.getQueryMemDesc(), *target);
+          if (partial && *partial >= cutoff) {
+            kernel_candidates[kernel_idx].push_back(
+                hash_key(row_ptr, rows.getQueryMemDesc()));
+          }
+        });
+      });
+    }
+    thread_pool.join();
+  }
+  std::unordered_set<uint64_t> candidates;
+  for (const auto& hashes : kernel_candidates) {
+    candidates.insert(hashes.begin(), hashes.end());
+  }
+  const auto group_count =
+      std::accumulate(kernel_group_counts.begin(), kernel_group_counts.end(), size_t(0));
+  if (candidates.size() * kMaxCandidateFraction > group_count) {
+    VLOG(1) << "Not pruning the groups, " << candidates.size() << " candidates out of "
+            << group_count;
+    return false;
+  }
+
+  // groups with colliding key hashes are kept in every kernel alike, so that the values
+  // of all the groups left are complete
+  {
+    threadpool::FuturesThreadPool<void> thread_pool;
+    for (size_t kernel_idx = 0; kernel_idx < kernel_count; ++kernel_idx) {
+      thread_pool.spawn([&, kernel_idx] {
+        const auto& rows = *results_per_device[kernel_idx].first;
+        const auto& rows_query_mem_desc = rows.getQueryMemDesc();
+        for_each_group(rows, [&](int8_t* row_ptr) {
+          if (!candidates.count(hash_key(row_ptr, rows_query_mem_desc))) {
+            result_set::fill_empty_key(row_ptr,
+                                       rows_query_mem_desc.getGroupbyColCount(),
+                                       rows_query_mem_desc.getEffectiveKeyWidth());
+          }
+        });
+      });
+    }
+    thread_pool.join();
+  }
+  VLOG(1) << "Pruned " << group_count << " groups to " << candidates.size()
+          << " candidates for the top " << top_n;
+  return true;
+}
+
+}  // namespace top_k_groups
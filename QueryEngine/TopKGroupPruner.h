@@ -0,0 +1,54 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TopKGroupPruner.h
+ * @brief   Drops the groups of a GROUP BY ... ORDER BY aggregate LIMIT n query which
+ *          cannot be among its top n groups, before the kernel results are reduced.
+ *
+ * Each kernel holds the partial aggregates of its groups. When the partials of a group
+ * add up to its value (COUNT, SUM of values of the sign of the order) or the best of
+ * them is its value (MAX for DESC, MIN for ASC), the n-th best partial of any kernel
+ * bounds the n-th best value of the query. A group whose partials are all worse than
+ * that bound, divided by the number of kernels for the sums, cannot reach it. Such groups
+ * are marked empty in every kernel, so that only the candidates left are merged and
+ * sorted.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "QueryEngine/RelAlgExecutionUnit.h"
+
+extern bool g_enable_top_k_group_pruning;
+
+class Executor;
+struct InputTableInfo;
+
+namespace top_k_groups {
+
+// Returns true if groups of the results were marked empty, the results are left as they
+// are otherwise.
+bool prune(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const Executor* executor,
+    std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& results_per_device);
+
+}  // namespace top_k_groups
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/TopNFragmentPruner.h"
+
+#include <algorithm>
+
+#include "Catalog/ColumnDescriptor.h"
+#include "QueryEngine/ExecutionKernel.h"
+#include "QueryEngine/GroupByAndAggregate.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "QueryEngine/ResultSet.h"
+
+bool g_enable_top_n_fragment_pruning{true};
+
+namespace {
+
+// Chunk stats of dates are kept in days for some encodings, the rows hold seconds.
+bool is_prunable_sort_type(const SQLTypeInfo& ti) {
+  return ti.is_integer() || ti.get_type() == kTIMESTAMP || ti.get_type() == kTIME;
+}
+
+}  // namespace
+
+TopNFragmentPruner::TopNFragmentPruner(const size_t top_n,
+                                       const size_t target_idx,
+                                       const size_t target_count,
+                                       const SQLTypeInfo& target_ti,
+                                       const bool desc,
+                                       const bool nulls_first,
+                                       std::vector<FragmentRange> fragment_ranges)
+    : top_n_(top_n)
+    , target_idx_(target_idx)
+    , targets_to_skip_(target_count, true)
+    , target_ti_(target_ti)
+    , desc_(desc)
+    , nulls_first_(nulls_first)
+    , fragment_ranges_(std::move(fragment_ranges)) {
+  CHECK_GT(top_n_, size_t(0));
+  CHECK_LT(target_idx_, target_count);
+  targets_to_skip_[target_idx_] = false;
+}
+
+std::unique_ptr<TopNFragmentPruner> TopNFragmentPruner::create(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const std::unordered_map<int, const ColumnDescriptor*>& deleted_cols_map,
+    const ExecutionOptions& eo) {
+  if (!g_enable_top_n_fragment_pruning || !query_mem_desc.useStreamingTopN() ||
+      eo.just_explain || eo.executor_type != ExecutorType::Native ||
+      ra_exe_unit.union_all || ra_exe_unit.input_descs.empty() || query_infos.empty() ||
+      ra_exe_unit.input_descs.front().getSourceType() != InputSourceType::TABLE ||
+      ra_exe_unit.input_descs.front().getTableId() <= 0) {
+    return nullptr;
+  }
+  CHECK_EQ(size_t(1), ra_exe_unit.sort_info.order_entries.size());
+  const auto& order_entry = ra_exe_unit.sort_info.order_entries.front();
+  const size_t target_idx = order_entry.tle_no - 1;
+  CHECK_LT(target_idx, ra_exe_unit.target_exprs.size());
+  const auto sort_col =
+      dynamic_cast<const Analyzer::ColumnVar*>(ra_exe_unit.target_exprs[target_idx]);
+  const auto outer_table_id = ra_exe_unit.input_descs.front().getTableId();
+  if (!sort_col || sort_col->get_rte_idx() ||
+      sort_col->get_table_id() != outer_table_id ||
+      !is_prunable_sort_type(sort_col->get_type_info())) {
+    return nullptr;
+  }
+  CHECK_EQ(query_infos.front().table_id, outer_table_id);
+  const auto& col_ti = sort_col->get_type_info();
+  const auto deleted_cols_it = deleted_cols_map.find(outer_table_id);
+  const auto deleted_cd =
+      deleted_cols_it != deleted_cols_map.end() ? deleted_cols_it->second : nullptr;
+  const auto& fragments = query_infos.front().info.fragments;
+  std::vector<FragmentRange> fragment_ranges(fragments.size());
+  for (size_t frag_idx = 0; frag_idx < fragments.size(); ++frag_idx) {
+    const auto& chunk_metadata_map = fragments[frag_idx].getChunkMetadataMap();
+    const auto chunk_meta_it = chunk_metadata_map.find(sort_col->get_column_id());
+    if (chunk_meta_it == chunk_metadata_map.end()) {
+      // virtual rowid column
+      continue;
+    }
+    auto& range = fragment_ranges[frag_idx];
+    const auto& chunk_stats = chunk_meta_it->second->chunkStats;
+    range.valid = true;
+    range.has_nulls = chunk_stats.has_nulls;
+    range.min = extract_min_stat(chunk_stats, col_ti);
+    range.max = extract_max_stat(chunk_stats, col_ti);
+    range.has_values = range.min <= range.max;
+    if (!range.has_values && !range.has_nulls) {
+      // no usable stats
+      range.valid = false;
+      continue;
+    }
+    bool has_deleted_rows{false};
+    if (deleted_cd) {
+      const auto deleted_meta_it = chunk_metadata_map.find(deleted_cd->columnId);
+      has_deleted_rows = deleted_meta_it == chunk_metadata_map.end() ||
+                         deleted_meta_it->second->chunkStats.max.tinyintval == 1;
+    }
+    range.visible_tuples = has_deleted_rows ? 0 : fragments[frag_idx].getNumTuples();
+  }
+  auto pruner =
+      std::make_unique<TopNFragmentPruner>(ra_exe_unit.sort_info.offset +
+                                               ra_exe_unit.sort_info.limit,
+                                           target_idx,
+                                           ra_exe_unit.target_exprs.size(),
+                                           sort_col->get_type_info(),
+                                           order_entry.is_desc,
+                                           order_entry.nulls_first,
+                                           std::move(fragment_ranges));
+
+  // Without filters every visible row of a fragment is in the output: the fragments
+  // holding the first n rows when ordered by their worst value bound the threshold.
+  if (ra_exe_unit.simple_quals.empty() && ra_exe_unit.quals.empty() &&
+      ra_exe_unit.join_quals.empty() && ra_exe_unit.input_descs.size() == 1 &&
+      eo.outer_fragment_indices.empty()) {
+    std::vector<const FragmentRange*> countable_ranges;
+    for (const auto& range : pruner->fragment_ranges_) {
+      // nulls sorted last aren't within the worst value
+      if (range.valid && range.has_values && range.visible_tuples &&
+          (!range.has_nulls || pruner->nulls_first_)) {
+        countable_ranges.push_back(&range);
+      }
+    }
+    const bool desc = pruner->desc_;
+    std::sort(countable_ranges.begin(),
+              countable_ranges.end(),
+              [desc](const FragmentRange* lhs, const FragmentRange* rhs) {
+                return desc ? lhs->min > rhs->min : lhs->max < rhs->max;
+              });
+    size_t tuple_count{0};
+    for (const auto range : countable_ranges) {
+      tuple_count += range->visible_tuples;
+      if (tuple_count >= pruner->top_n_) {
+        pruner->updateThreshold(desc ? range->min : range->max);
+        break;
+      }
+    }
+  }
+  return pruner;
+}
+
+std::vector<size_t> TopNFragmentPruner::getFragmentsToScan() const {
+  std::vector<size_t> fragment_indices;
+  for (size_t frag_idx = 0; frag_idx < fragment_ranges_.size(); ++frag_idx) {
+    if (!canSkipFragment(frag_idx)) {
+      fragment_indices.push_back(frag_idx);
+    }
+  }
+  if (fragment_indices.size() == fragment_ranges_.size()) {
+    return {};
+  }
+  VLOG(1) << "Top " << top_n_ << " stats skip "
+          << fragment_ranges_.size() - fragment_indices.size() << " of "
+          << fragment_ranges_.size() << " fragments";
+  return fragment_indices;
+}
+
+void TopNFragmentPruner::orderKernels(
+    std::vector<std::unique_ptr<ExecutionKernel>>& kernels) const {
+  // nulls sorted first come before any value, unknown ranges go last
+  auto kernel_rank = [this](const ExecutionKernel& kernel) -> std::pair<int, int64_t> {
+    const auto& frag_list = kernel.getFragmentList();
+    if (frag_list.empty() || frag_list.front().fragment_ids.empty()) {
+      return {2, 0};
+    }
+    const auto frag_idx = frag_list.front().fragment_ids.front();
+    CHECK_LT(frag_idx, fragment_ranges_.size());
+    const auto& range = fragment_ranges_[frag_idx];
+    if (!range.valid) {
+      return {2, 0};
+    }
+    if (range.has_nulls && nulls_first_) {
+      return {0, 0};
+    }
+    if (!range.has_values) {
+      return {2, 0};
+    }
+    return {1, desc_ ? range.max : range.min};
+  };
+  std::vector<std::pair<std::pair<int, int64_t>, std::unique_ptr<ExecutionKernel>>>
+      ranked_kernels;
+  ranked_kernels.reserve(kernels.size());
+  for (auto& kernel : kernels) {
+    CHECK(kernel);
+    const auto rank = kernel_rank(*kernel);
+    ranked_kernels.emplace_back(rank, std::move(kernel));
+  }
+  std::stable_sort(ranked_kernels.begin(),
+                   ranked_kernels.end(),
+                   [this](const auto& lhs, const auto& rhs) {
+                     if (lhs.first.first != rhs.first.first) {
+                       return lhs.first.first < rhs.first.first;
+                     }
+                     return isBetter(lhs.first.second, rhs.first.second);
+                   });
+  kernels.clear();
+  for (auto& ranked_kernel : ranked_kernels) {
+    kernels.push_back(std::move(ranked_kernel.second));
+  }
+}
+
+bool TopNFragmentPruner::canSkip(const FragmentsList& frag_list) const {
+  if (frag_list.empty() || frag_list.front().fragment_ids.empty()) {
+    return false;
+  }
+  const auto& outer_frag_ids = frag_list.front().fragment_ids;
+  return std::all_of(outer_frag_ids.begin(),
+                     outer_frag_ids.end(),
+                     [this](const size_t frag_idx) { return canSkipFragment(frag_idx); });
+}
+
+void TopNFragmentPruner::addResult(const ResultSet& result) {
+  const auto null_val = inline_int_null_val(target_ti_);
+  std::vector<int64_t> values;
+  for (size_t i = 0; i < result.entryCount(); ++i) {
+    if (result.isRowAtEmpty(i)) {
+      continue;
+    }
+    const auto row = result.getRowAtNoTranslations(i, targets_to_skip_);
+    CHECK_LT(target_idx_, row.size());
+    const auto scalar_tv = boost::get<ScalarTargetValue>(&row[target_idx_]);
+    CHECK(scalar_tv);
+    const auto value = boost::get<int64_t>(scalar_tv);
+    CHECK(value);
+    if (*value != null_val) {
+      values.push_back(*value);
+    }
+  }
+  const auto is_better = [this](const int64_t lhs, const int64_t rhs) {
+    return isBetter(lhs, rhs);
+  };
+  std::lock_guard<std::mutex> lock(best_values_mutex_);
+  for (const auto value : values) {
+    if (best_values_.size() < top_n_) {
+      best_values_.push_back(value);
+      std::push_heap(best_values_.begin(), best_values_.end(), is_better);
+    } else if (isBetter(value, best_values_.front())) {
+      std::pop_heap(best_values_.begin(), best_values_.end(), is_better);
+      best_values_.back() = value;
+      std::push_heap(best_values_.begin(), best_values_.end(), is_better);
+    }
+  }
+  if (best_values_.size() == top_n_) {
+    updateThreshold(best_values_.front());
+  }
+}
+
+bool TopNFragmentPruner::canSkipFragment(const size_t frag_idx) const {
+  if (!has_threshold_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  CHECK_LT(frag_idx, fragment_ranges_.size());
+  const auto& range = fragment_ranges_[frag_idx];
+  if (!range.valid || (range.has_nulls && nulls_first_)) {
+    return false;
+  }
+  if (!range.has_values) {
+    // only nulls, sorted after the threshold
+    return true;
+  }
+  // strictly worse than top n rows, ties may still be returned
+  return isBetter(threshold_.load(std::memory_order_relaxed),
+                  desc_ ? range.max : range.min);
+}
+
+void TopNFragmentPruner::updateThreshold(const int64_t value) {
+  if (has_threshold_.load(std::memory_order_relaxed) &&
+      !isBetter(value, threshold_.load(std::memory_order_relaxed))) {
+    return;
+  }
+  threshold_.store(value, std::memory_order_relaxed);
+  has_threshold_.store(true, std::memory_order_release);
+}
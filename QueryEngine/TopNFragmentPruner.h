@@ -0,0 +1,120 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TopNFragmentPruner.h
+ * @brief   Skips the outer fragments of an ORDER BY ... LIMIT n projection which cannot
+ *          hold any of its top n rows.
+ *
+ * The sort values of a fragment lie within the chunk stats of the sort column. Once n
+ * rows at least as good as a threshold value are known, a fragment whose best value is
+ * worse than the threshold cannot contribute. The threshold is first derived from the
+ * stats and tuple counts when the work unit has no filter, then tightened with the rows
+ * of each kernel as it finishes. Kernels are launched in the order of the best value of
+ * their fragments, so that the threshold converges early.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/Descriptors/QueryFragmentDescriptor.h"
+#include "QueryEngine/InputMetadata.h"
+#include "Shared/sqltypes.h"
+
+extern bool g_enable_top_n_fragment_pruning;
+
+struct ColumnDescriptor;
+class ExecutionKernel;
+class QueryMemoryDescriptor;
+struct RelAlgExecutionUnit;
+class ResultSet;
+
+class TopNFragmentPruner {
+ public:
+  // Sort column stats of an outer fragment.
+  struct FragmentRange {
+    bool valid{false};
+    bool has_values{false};
+    bool has_nulls{false};
+    int64_t min{0};
+    int64_t max{0};
+    // rows which are all visible, zero if some may be deleted
+    size_t visible_tuples{0};
+  };
+
+  TopNFragmentPruner(const size_t top_n,
+                     const size_t target_idx,
+                     const size_t target_count,
+                     const SQLTypeInfo& target_ti,
+                     const bool desc,
+                     const bool nulls_first,
+                     std::vector<FragmentRange> fragment_ranges);
+
+  /**
+   * A pruner for streaming top n work units sorted on an integer or timestamp column of
+   * a physical outer table, nullptr for any other work unit. Fragments with deleted rows
+   * are found through the chunk stats of the deleted column of the table, if any.
+   */
+  static std::unique_ptr<TopNFragmentPruner> create(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const std::vector<InputTableInfo>& query_infos,
+      const QueryMemoryDescriptor& query_mem_desc,
+      const std::unordered_map<int, const ColumnDescriptor*>& deleted_cols_map,
+      const ExecutionOptions& eo);
+
+  // The outer fragments the stats alone can't skip, empty if none can be skipped.
+  std::vector<size_t> getFragmentsToScan() const;
+
+  // Stable sort of the kernels by the best sort value of their first outer fragment.
+  void orderKernels(std::vector<std::unique_ptr<ExecutionKernel>>& kernels) const;
+
+  // Whether none of the outer fragments in `frag_list` can hold top n rows.
+  bool canSkip(const FragmentsList& frag_list) const;
+
+  // Tightens the threshold with the sort values of the rows of a kernel.
+  void addResult(const ResultSet& result);
+
+ private:
+  bool isBetter(const int64_t lhs, const int64_t rhs) const {
+    return desc_ ? lhs > rhs : lhs < rhs;
+  }
+
+  bool canSkipFragment(const size_t frag_idx) const;
+
+  void updateThreshold(const int64_t value);
+
+  const size_t top_n_;
+  const size_t target_idx_;
+  std::vector<bool> targets_to_skip_;
+  const SQLTypeInfo target_ti_;
+  const bool desc_;
+  const bool nulls_first_;
+  const std::vector<FragmentRange> fragment_ranges_;
+
+  std::mutex best_values_mutex_;
+  // heap of the best top_n_ values seen, the worst of them first
+  std::vector<int64_t> best_values_;
+  std::atomic<bool> has_threshold_{false};
+  std::atomic<int64_t> threshold_{0};
+};
@@ -27,11 +27,15 @@
 #include <clang/Parse/ParseAST.h>
 #include <clang/Tooling/CommonOptionsParser.h>
 #include <clang/Tooling/Tooling.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/Support/Program.h>
 #include <llvm/Support/raw_ostream.h>
+#include <boost/functional/hash.hpp>
 #include <boost/process/search_path.hpp>
+#include <fstream>
 #include <iterator>
 #include <memory>
+#include <sstream>
 
 #if LLVM_VERSION_MAJOR >= 11
 #include <llvm/Support/Host.h>
@@ -39,6 +43,7 @@
 
 #include "Execute.h"
 #include "Logger/Logger.h"
+#include "MapDRelease.h"
 
 using namespace clang;
 using namespace clang::tooling;
@@ -210,6 +215,52 @@ std::string UdfCompiler::genCpuIrFilename(const char* udf_fileName) {
   return cpu_file_name;
 }
 
+std::string UdfCompiler::genCompilationKeyFilename(const char* udf_file_name) {
+  std::string key_file_name(removeFileExtension(udf_file_name));
+
+  key_file_name += "_udf.key";
+  return key_file_name;
+}
+
+std::string UdfCompiler::getCompilationKey() {
+  std::ifstream udf_file(udf_file_name_, std::ios::binary);
+  std::stringstream udf_source;
+  udf_source << udf_file.rdbuf();
+
+  std::ostringstream oss;
+  oss << MAPD_RELEASE << '\n' << LLVM_VERSION_STRING << '\n';
+  oss << clang_path_ << ' ' << boost::filesystem::file_size(clang_path_) << ' '
+      << boost::filesystem::last_write_time(clang_path_) << '\n';
+  for (const auto& option : clang_options_) {
+    oss << option << ' ';
+  }
+  oss << '\n';
+#ifdef HAVE_CUDA
+  oss << CudaMgr_Namespace::CudaMgr::deviceArchToSM(target_arch_) << '\n';
+#endif
+  oss << udf_source.str().size() << ' ' << std::hex
+      << boost::hash_value(udf_source.str()) << '\n';
+  return oss.str();
+}
+
+bool UdfCompiler::hasCompiledFiles(const std::string& compilation_key) {
+  std::vector<std::string> compiled_files{udf_ast_file_name_,
+                                          genCpuIrFilename(udf_file_name_.c_str())};
+#ifdef HAVE_CUDA
+  compiled_files.push_back(genGpuIrFilename(udf_file_name_.c_str()));
+#endif
+  for (const auto& compiled_file : compiled_files) {
+    if (!boost::filesystem::exists(compiled_file)) {
+      return false;
+    }
+  }
+  std::ifstream key_file(genCompilationKeyFilename(udf_file_name_.c_str()),
+                         std::ios::binary);
+  std::stringstream previous_key;
+  previous_key << key_file.rdbuf();
+  return key_file.is_open() && previous_key.str() == compilation_key;
+}
+
 int UdfCompiler::compileFromCommandLine(const std::vector<std::string>& command_line) {
   UdfClangDriver compiler_driver(clang_path_);
   auto the_driver(compiler_driver.getClangDriver());
@@ -416,6 +467,20 @@ int UdfCompiler::compileUdf() {
     return 1;
   }
 
+  const auto key_file_name = genCompilationKeyFilename(udf_file_name_.c_str());
+  const auto compilation_key = getCompilationKey();
+  if (hasCompiledFiles(compilation_key)) {
+    LOG(INFO) << "UDFCompiler reusing the files compiled from unchanged "
+              << udf_file_name_;
+    readCpuCompiledModule();
+#ifdef HAVE_CUDA
+    readGpuCompiledModule();
+#endif
+    return 0;
+  }
+  // a failed compilation must not leave the files of the previous one valid
+  boost::filesystem::remove(key_file_name);
+
   auto ast_result = parseToAst(udf_file_name_.c_str());
 
   if (ast_result == 0) {
@@ -447,5 +512,12 @@ int UdfCompiler::compileUdf() {
     return 1;
   }
 
+  std::ofstream key_file(key_file_name, std::ios::binary);
+  key_file << compilation_key;
+  if (!key_file) {
+    LOG(WARNING) << "Unable to write " << key_file_name
+                 << ", the UDF file will be compiled again at the next start";
+  }
+
   return 0;
 }
@@ -66,6 +66,11 @@ class UdfCompiler {
   int parseToAst(const char* file_name);
   std::string genGpuIrFilename(const char* udf_file_name);
   std::string genCpuIrFilename(const char* udf_file_name);
+  std::string genCompilationKeyFilename(const char* udf_file_name);
+  // Everything the compiled files depend on: the UDF source, the compiler and its options.
+  std::string getCompilationKey();
+  // Whether the AST and bitcode files were compiled from the same key by a previous run.
+  bool hasCompiledFiles(const std::string& compilation_key);
   int compileToGpuByteCode(const char* udf_file_name, bool cpu_mode);
   int compileToCpuByteCode(const char* udf_file_name);
   void replaceExtn(std::string& s, const std::string& new_ext);
@@ -16,6 +16,10 @@
 
 #include "QueryEngine/WindowContext.h"
 
+#include <atomic>
+#include <functional>
+#include <future>
+#include <limits>
 #include <numeric>
 
 #include "QueryEngine/Descriptors/CountDistinctDescriptor.h"
@@ -24,7 +28,10 @@
 #include "QueryEngine/ResultSetBufferAccessors.h"
 #include "QueryEngine/RuntimeFunctions.h"
 #include "QueryEngine/TypePunning.h"
+#include "QueryEngine/WindowSegmentTree.h"
+#include "Shared/DateConverters.h"
 #include "Shared/checked_alloc.h"
+#include "Shared/thread_count.h"
 
 WindowFunctionContext::WindowFunctionContext(
     const Analyzer::WindowFunction* window_func,
@@ -33,6 +40,7 @@ WindowFunctionContext::WindowFunctionContext(
     const ExecutorDeviceType device_type,
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner)
     : window_func_(window_func)
+    , aggregate_argument_(nullptr)
     , partitions_(partitions)
     , elem_count_(elem_count)
     , output_(nullptr)
@@ -54,8 +62,96 @@ void WindowFunctionContext::addOrderColumn(
   order_columns_.push_back(column);
 }
 
+void WindowFunctionContext::retainSortedPartitions() {
+  CHECK(!output_);
+  retained_sorted_partitions_ = std::make_shared<std::vector<int64_t>>(elem_count_);
+}
+
+void WindowFunctionContext::setSortedPartitions(
+    const std::shared_ptr<const std::vector<int64_t>>& sorted_partitions) {
+  CHECK(!output_);
+  CHECK(sorted_partitions);
+  CHECK_EQ(sorted_partitions->size(), elem_count_);
+  shared_sorted_partitions_ = sorted_partitions;
+}
+
+std::shared_ptr<const std::vector<int64_t>> WindowFunctionContext::getSortedPartitions()
+    const {
+  return retained_sorted_partitions_;
+}
+
+const std::shared_ptr<JoinHashTableInterface>& WindowFunctionContext::getPartitions()
+    const {
+  return partitions_;
+}
+
+void WindowFunctionContext::setAggregateArgumentColumn(
+    const int8_t* column,
+    const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
+  CHECK(window_function_is_rows_frame_aggregate(window_func_));
+  aggregate_argument_owner_ = chunks_owner;
+  aggregate_argument_ = column;
+}
+
 namespace {
 
+// Below this many rows per thread, the partitions are computed on one thread.
+constexpr size_t kMinRowsPerThread{size_t(1) << 16};
+// Number of tasks per thread the small partitions are grouped in.
+constexpr size_t kTasksPerThread{8};
+
+// Sorts [begin, end) on up to `thread_count` threads: the chunks of the range are sorted
+// concurrently, then merged pairwise.
+template <class Compare>
+void parallel_sort(int64_t* begin,
+                   int64_t* end,
+                   const Compare& compare,
+                   const size_t thread_count) {
+  const size_t size = end - begin;
+  if (thread_count < 2 || size < 2 * kMinRowsPerThread) {
+    std::sort(begin, end, compare);
+    return;
+  }
+  const auto chunk_size = (size + thread_count - 1) / thread_count;
+  std::vector<int64_t*> bounds;
+  for (size_t start = 0; start < size; start += chunk_size) {
+    bounds.push_back(begin + start);
+  }
+  bounds.push_back(end);
+  const auto wait_all = [](std::vector<std::future<void>>& futures) {
+    for (auto& future : futures) {
+      future.wait();
+    }
+    for (auto& future : futures) {
+      future.get();
+    }
+    futures.clear();
+  };
+  std::vector<std::future<void>> futures;
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    futures.emplace_back(std::async(std::launch::async, [&bounds, &compare, i] {
+      std::sort(bounds[i], bounds[i + 1], compare);
+    }));
+  }
+  wait_all(futures);
+  while (bounds.size() > 2) {
+    std::vector<int64_t*> merged_bounds;
+    for (size_t i = 0; i + 2 < bounds.size(); i += 2) {
+      futures.emplace_back(std::async(std::launch::async, [&bounds, &compare, i] {
+        std::inplace_merge(bounds[i], bounds[i + 1], bounds[i + 2], compare);
+      }));
+      merged_bounds.push_back(bounds[i]);
+    }
+    if (bounds.size() % 2 == 0) {
+      // odd number of chunks, the last one is merged in the next round
+      merged_bounds.push_back(bounds[bounds.size() - 2]);
+    }
+    merged_bounds.push_back(end);
+    wait_all(futures);
+    bounds.swap(merged_bounds);
+  }
+}
+
 // Converts the sorted indices to a mapping from row position to row number.
 std::vector<int64_t> index_to_row_number(const int64_t* index, const size_t index_size) {
   std::vector<int64_t> row_numbers(index_size);
@@ -272,14 +368,19 @@ void index_to_partition_end(
     const int64_t* index,
     const size_t index_size,
     const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
-  int64_t partition_end_handle = reinterpret_cast<int64_t>(partition_end);
+  // partitions computed concurrently may share the bytes at their boundaries
+  auto set_partition_end = [partition_end](const size_t pos) {
+    __atomic_fetch_or(const_cast<int8_t*>(partition_end) + (pos >> 3),
+                      static_cast<int8_t>(1 << (pos & 7)),
+                      __ATOMIC_RELAXED);
+  };
   for (size_t i = 0; i < index_size; ++i) {
     if (advance_current_rank(comparator, index, i)) {
-      agg_count_distinct_bitmap(&partition_end_handle, off + i - 1, 0);
+      set_partition_end(off + i - 1);
     }
   }
   CHECK(index_size);
-  agg_count_distinct_bitmap(&partition_end_handle, off + index_size - 1, 0);
+  set_partition_end(off + index_size - 1);
 }
 
 bool pos_is_set(const int64_t bitset, const int64_t pos) {
@@ -383,7 +484,8 @@ extern "C" void add_window_pending_output(void* pending_output, const int64_t ha
 // Returns true iff the aggregate window function requires special multiplicity handling
 // to ensure that peer rows have the same value for the window function.
 bool window_function_requires_peer_handling(const Analyzer::WindowFunction* window_func) {
-  if (!window_function_is_aggregate(window_func->getKind())) {
+  if (!window_function_is_aggregate(window_func->getKind()) ||
+      window_func->getRowsFrame()) {
     return false;
   }
   if (window_func->getOrderKeys().empty()) {
@@ -404,74 +506,84 @@ void WindowFunctionContext::compute() {
   CHECK(!output_);
   output_ = static_cast<int8_t*>(row_set_mem_owner_->allocate(
       elem_count_ * window_function_buffer_element_size(window_func_->getKind())));
-  if (window_function_is_aggregate(window_func_->getKind())) {
+  const bool is_rows_frame_aggregate =
+      window_function_is_rows_frame_aggregate(window_func_);
+  if (window_function_is_aggregate(window_func_->getKind()) &&
+      !is_rows_frame_aggregate) {
     fillPartitionStart();
     if (window_function_requires_peer_handling(window_func_)) {
       fillPartitionEnd();
     }
   }
   std::unique_ptr<int64_t[]> scratchpad(new int64_t[elem_count_]);
-  int64_t off = 0;
-  for (size_t i = 0; i < partitionCount(); ++i) {
-    auto partition_size = counts()[i];
-    if (partition_size == 0) {
+  const auto partition_count = partitionCount();
+  const size_t thread_count = std::max(
+      size_t(1),
+      std::min(static_cast<size_t>(cpu_threads()), elem_count_ / kMinRowsPerThread));
+  // A partition larger than the share of a thread is sorted on all the threads. The
+  // others are grouped in contiguous tasks of about the same size, which the threads
+  // take one at a time so that a few large partitions don't hold back the rest.
+  const size_t large_partition_size = elem_count_ / thread_count;
+  const size_t task_size =
+      std::max(kMinRowsPerThread, elem_count_ / (thread_count * kTasksPerThread));
+  std::vector<size_t> large_partitions;
+  std::vector<std::pair<size_t, size_t>> tasks;
+  size_t task_start{0};
+  size_t task_rows{0};
+  for (size_t i = 0; i < partition_count; ++i) {
+    const size_t partition_size = counts()[i];
+    if (thread_count > 1 && partition_size >= large_partition_size) {
+      if (task_start < i) {
+        tasks.emplace_back(task_start, i);
+      }
+      large_partitions.push_back(i);
+      task_start = i + 1;
+      task_rows = 0;
       continue;
     }
-    auto output_for_partition_buff = scratchpad.get() + offsets()[i];
-    std::iota(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              int64_t(0));
-    std::vector<Comparator> comparators;
-    const auto& order_keys = window_func_->getOrderKeys();
-    const auto& collation = window_func_->getCollation();
-    CHECK_EQ(order_keys.size(), collation.size());
-    for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
-         ++order_column_idx) {
-      auto order_column_buffer = order_columns_[order_column_idx];
-      const auto order_col =
-          dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
-      CHECK(order_col);
-      const auto& order_col_collation = collation[order_column_idx];
-      const auto asc_comparator = makeComparator(order_col,
-                                                 order_column_buffer,
-                                                 payload() + offsets()[i],
-                                                 order_col_collation.nulls_first);
-      auto comparator = asc_comparator;
-      if (order_col_collation.is_desc) {
-        comparator = [asc_comparator](const int64_t lhs, const int64_t rhs) {
-          return asc_comparator(rhs, lhs);
-        };
-      }
-      comparators.push_back(comparator);
-    }
-    const auto col_tuple_comparator = [&comparators](const int64_t lhs,
-                                                     const int64_t rhs) {
-      for (const auto& comparator : comparators) {
-        if (comparator(lhs, rhs)) {
-          return true;
-        }
+    task_rows += partition_size;
+    if (task_rows >= task_size) {
+      tasks.emplace_back(task_start, i + 1);
+      task_start = i + 1;
+      task_rows = 0;
+    }
+  }
+  if (task_start < partition_count) {
+    tasks.emplace_back(task_start, partition_count);
+  }
+  for (const auto partition_idx : large_partitions) {
+    sortAndComputePartition(partition_idx, scratchpad.get(), thread_count);
+  }
+  std::atomic<size_t> next_task{0};
+  const auto run_tasks = [this, &tasks, &next_task, &scratchpad] {
+    for (size_t task_idx = next_task++; task_idx < tasks.size(); task_idx = next_task++) {
+      for (size_t i = tasks[task_idx].first; i < tasks[task_idx].second; ++i) {
+        sortAndComputePartition(i, scratchpad.get(), 1);
       }
-      return false;
-    };
-    std::sort(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              col_tuple_comparator);
-    computePartition(output_for_partition_buff,
-                     partition_size,
-                     off,
-                     window_func_,
-                     col_tuple_comparator);
-    if (window_function_is_value(window_func_->getKind()) ||
-        window_function_is_aggregate(window_func_->getKind())) {
-      off += partition_size;
+    }
+  };
+  if (thread_count == 1) {
+    run_tasks();
+  } else {
+    std::vector<std::future<void>> task_futures;
+    for (size_t i = 0; i < std::min(thread_count, tasks.size()); ++i) {
+      task_futures.emplace_back(std::async(std::launch::async, run_tasks));
+    }
+    for (auto& task_future : task_futures) {
+      task_future.wait();
+    }
+    for (auto& task_future : task_futures) {
+      task_future.get();
     }
   }
   if (window_function_is_value(window_func_->getKind()) ||
       window_function_is_aggregate(window_func_->getKind())) {
-    CHECK_EQ(static_cast<size_t>(off), elem_count_);
+    CHECK_EQ(std::accumulate(counts(), counts() + partition_count, size_t(0)),
+             elem_count_);
   }
   auto output_i64 = reinterpret_cast<int64_t*>(output_);
-  if (window_function_is_aggregate(window_func_->getKind())) {
+  if (window_function_is_aggregate(window_func_->getKind()) &&
+      !is_rows_frame_aggregate) {
     std::copy(scratchpad.get(), scratchpad.get() + elem_count_, output_i64);
   } else {
     for (size_t i = 0; i < elem_count_; ++i) {
@@ -642,6 +754,69 @@ WindowFunctionContext::makeComparator(const Analyzer::ColumnVar* col_var,
   throw std::runtime_error("Type not supported yet");
 }
 
+void WindowFunctionContext::sortAndComputePartition(const size_t partition_idx,
+                                                    int64_t* scratchpad,
+                                                    const size_t sort_thread_count) {
+  const size_t partition_size = counts()[partition_idx];
+  if (partition_size == 0) {
+    return;
+  }
+  const size_t off = offsets()[partition_idx];
+  auto output_for_partition_buff = scratchpad + off;
+  std::vector<Comparator> comparators;
+  const auto& order_keys = window_func_->getOrderKeys();
+  const auto& collation = window_func_->getCollation();
+  CHECK_EQ(order_keys.size(), collation.size());
+  for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
+       ++order_column_idx) {
+    auto order_column_buffer = order_columns_[order_column_idx];
+    const auto order_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
+    CHECK(order_col);
+    const auto& order_col_collation = collation[order_column_idx];
+    const auto asc_comparator = makeComparator(order_col,
+                                               order_column_buffer,
+                                               payload() + off,
+                                               order_col_collation.nulls_first);
+    auto comparator = asc_comparator;
+    if (order_col_collation.is_desc) {
+      comparator = [asc_comparator](const int64_t lhs, const int64_t rhs) {
+        return asc_comparator(rhs, lhs);
+      };
+    }
+    comparators.push_back(comparator);
+  }
+  const auto col_tuple_comparator = [&comparators](const int64_t lhs,
+                                                   const int64_t rhs) {
+    for (const auto& comparator : comparators) {
+      if (comparator(lhs, rhs)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  if (shared_sorted_partitions_) {
+    std::copy(shared_sorted_partitions_->begin() + off,
+              shared_sorted_partitions_->begin() + off + partition_size,
+              output_for_partition_buff);
+  } else {
+    std::iota(output_for_partition_buff,
+              output_for_partition_buff + partition_size,
+              int64_t(0));
+    parallel_sort(output_for_partition_buff,
+                  output_for_partition_buff + partition_size,
+                  col_tuple_comparator,
+                  sort_thread_count);
+    if (retained_sorted_partitions_) {
+      std::copy(output_for_partition_buff,
+                output_for_partition_buff + partition_size,
+                retained_sorted_partitions_->begin() + off);
+    }
+  }
+  computePartition(
+      output_for_partition_buff, partition_size, off, window_func_, col_tuple_comparator);
+}
+
 void WindowFunctionContext::computePartition(
     int64_t* output_for_partition_buff,
     const size_t partition_size,
@@ -716,6 +891,10 @@ void WindowFunctionContext::computePartition(
     case SqlWindowFunctionKind::MAX:
     case SqlWindowFunctionKind::SUM:
     case SqlWindowFunctionKind::COUNT: {
+      if (window_func->getRowsFrame()) {
+        computeRowsFramePartition(output_for_partition_buff, partition_size, off);
+        break;
+      }
       const auto partition_row_offsets = payload() + off;
       if (window_function_requires_peer_handling(window_func)) {
         index_to_partition_end(
@@ -732,6 +911,217 @@ void WindowFunctionContext::computePartition(
   }
 }
 
+namespace {
+
+// Reads the integer, decimal, time or boolean value at the given row, widened to 64 bits
+// and with dates in seconds. Returns false for nulls.
+bool read_int_value(const int8_t* column,
+                    const SQLTypeInfo& ti,
+                    const int64_t row,
+                    int64_t& value) {
+  switch (ti.get_size()) {
+    case 8: {
+      value = reinterpret_cast<const int64_t*>(column)[row];
+      break;
+    }
+    case 4: {
+      value = reinterpret_cast<const int32_t*>(column)[row];
+      break;
+    }
+    case 2: {
+      value = reinterpret_cast<const int16_t*>(column)[row];
+      break;
+    }
+    case 1: {
+      value = reinterpret_cast<const int8_t*>(column)[row];
+      break;
+    }
+    default: {
+      LOG(FATAL) << "Invalid type size: " << ti.get_size();
+    }
+  }
+  if (value == inline_fixed_encoding_null_val(ti)) {
+    return false;
+  }
+  if (ti.is_date_in_days()) {
+    value = DateConverters::get_epoch_seconds_from_days(value);
+  }
+  return true;
+}
+
+// Reads the floating point value at the given row. Returns false for nulls.
+bool read_fp_value(const int8_t* column,
+                   const SQLTypeInfo& ti,
+                   const int64_t row,
+                   double& value) {
+  switch (ti.get_type()) {
+    case kFLOAT: {
+      value = reinterpret_cast<const float*>(column)[row];
+      break;
+    }
+    case kDOUBLE: {
+      value = reinterpret_cast<const double*>(column)[row];
+      break;
+    }
+    default: {
+      LOG(FATAL) << "Invalid float type";
+    }
+  }
+  return value != inline_fp_null_val(ti);
+}
+
+// The rows of the frame of the row at `pos`, as a [begin, end) range of positions in
+// the partition order. Empty if the frame lies outside of the partition.
+std::pair<size_t, size_t> get_rows_frame_range(const Analyzer::RowsFrame& rows_frame,
+                                               const size_t pos,
+                                               const size_t partition_size) {
+  const int64_t size = partition_size;
+  // the offsets may span the whole 64-bit range
+  const auto clamp_pos = [pos, size](const int64_t offset, const int64_t delta) {
+    const auto clamped_offset = std::min(std::max(offset, -size - 1), size);
+    return std::min(
+        std::max(static_cast<int64_t>(pos) + clamped_offset + delta, int64_t(0)), size);
+  };
+  const int64_t begin =
+      rows_frame.lower_unbounded ? 0 : clamp_pos(rows_frame.lower_offset, 0);
+  const int64_t end =
+      rows_frame.upper_unbounded ? size : clamp_pos(rows_frame.upper_offset, 1);
+  return {begin, std::max(begin, end)};
+}
+
+// The aggregate of the non-null values in the frame of every row, in the partition
+// order.
+template <class T, class AggOp>
+std::vector<T> aggregate_rows_frames(const Analyzer::RowsFrame& rows_frame,
+                                     const std::vector<T>& values,
+                                     const std::vector<int64_t>& non_null,
+                                     const T identity,
+                                     AggOp op) {
+  std::vector<T> leaves(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    leaves[i] = non_null[i] ? values[i] : identity;
+  }
+  const WindowSegmentTree<T, AggOp> tree(leaves, identity, op);
+  std::vector<T> aggregates(values.size());
+  for (size_t k = 0; k < values.size(); ++k) {
+    const auto frame_range = get_rows_frame_range(rows_frame, k, values.size());
+    aggregates[k] = tree.query(frame_range.first, frame_range.second);
+  }
+  return aggregates;
+}
+
+// Evaluates an aggregate over the ROWS frame of every row of a partition. The argument
+// `values` and their `non_null` markers are in the partition order, the result for the
+// row at position k goes to output[sorted_indices[k]], as an integer or a double.
+template <class T>
+void compute_rows_frame_aggregate(int64_t* output,
+                                  const std::vector<int64_t>& sorted_indices,
+                                  const std::vector<T>& values,
+                                  const std::vector<int64_t>& non_null,
+                                  const Analyzer::WindowFunction* window_func) {
+  const auto& rows_frame = *window_func->getRowsFrame();
+  const auto kind = window_func->getKind();
+  const auto counts = aggregate_rows_frames(
+      rows_frame, non_null, non_null, int64_t(0), std::plus<int64_t>());
+  if (kind == SqlWindowFunctionKind::COUNT) {
+    for (size_t k = 0; k < sorted_indices.size(); ++k) {
+      output[sorted_indices[k]] = counts[k];
+    }
+    return;
+  }
+  std::vector<T> aggregates;
+  switch (kind) {
+    case SqlWindowFunctionKind::MIN: {
+      aggregates = aggregate_rows_frames(
+          rows_frame,
+          values,
+          non_null,
+          std::numeric_limits<T>::max(),
+          [](const T lhs, const T rhs) { return std::min(lhs, rhs); });
+      break;
+    }
+    case SqlWindowFunctionKind::MAX: {
+      aggregates = aggregate_rows_frames(
+          rows_frame,
+          values,
+          non_null,
+          std::numeric_limits<T>::lowest(),
+          [](const T lhs, const T rhs) { return std::max(lhs, rhs); });
+      break;
+    }
+    case SqlWindowFunctionKind::AVG:
+    case SqlWindowFunctionKind::SUM: {
+      aggregates =
+          aggregate_rows_frames(rows_frame, values, non_null, T(0), std::plus<T>());
+      break;
+    }
+    default: {
+      LOG(FATAL) << "Invalid window function kind";
+    }
+  }
+  const auto& window_ti = window_func->get_type_info();
+  const auto& arg_ti = window_func->getArgs().front()->get_type_info();
+  const double avg_scale = arg_ti.is_decimal() ? exp_to_scale(arg_ti.get_scale()) : 1;
+  for (size_t k = 0; k < sorted_indices.size(); ++k) {
+    auto& output_slot = output[sorted_indices[k]];
+    auto& fp_output_slot = *reinterpret_cast<double*>(may_alias_ptr(&output_slot));
+    if (kind == SqlWindowFunctionKind::AVG) {
+      fp_output_slot = counts[k]
+                           ? static_cast<double>(aggregates[k]) / avg_scale / counts[k]
+                           : inline_fp_null_value<double>();
+    } else if (window_ti.is_fp()) {
+      fp_output_slot = counts[k] ? aggregates[k] : inline_fp_null_val(window_ti);
+    } else {
+      output_slot = counts[k] ? aggregates[k] : inline_int_null_val(window_ti);
+    }
+  }
+}
+
+}  // namespace
+
+void WindowFunctionContext::computeRowsFramePartition(int64_t* output_for_partition_buff,
+                                                      const size_t partition_size,
+                                                      const size_t off) const {
+  const std::vector<int64_t> sorted_indices(output_for_partition_buff,
+                                            output_for_partition_buff + partition_size);
+  const auto& args = window_func_->getArgs();
+  if (args.empty()) {
+    CHECK(window_func_->getKind() == SqlWindowFunctionKind::COUNT);
+    const auto& rows_frame = *window_func_->getRowsFrame();
+    for (size_t k = 0; k < partition_size; ++k) {
+      const auto frame_range = get_rows_frame_range(rows_frame, k, partition_size);
+      output_for_partition_buff[sorted_indices[k]] =
+          frame_range.second - frame_range.first;
+    }
+    return;
+  }
+  CHECK(aggregate_argument_);
+  const auto& arg_ti = args.front()->get_type_info();
+  const auto partition_row_offsets = payload() + off;
+  std::vector<int64_t> non_null(partition_size);
+  if (arg_ti.is_fp()) {
+    std::vector<double> values(partition_size);
+    for (size_t k = 0; k < partition_size; ++k) {
+      non_null[k] = read_fp_value(aggregate_argument_,
+                                  arg_ti,
+                                  partition_row_offsets[sorted_indices[k]],
+                                  values[k]);
+    }
+    compute_rows_frame_aggregate(
+        output_for_partition_buff, sorted_indices, values, non_null, window_func_);
+  } else {
+    std::vector<int64_t> values(partition_size);
+    for (size_t k = 0; k < partition_size; ++k) {
+      non_null[k] = read_int_value(aggregate_argument_,
+                                   arg_ti,
+                                   partition_row_offsets[sorted_indices[k]],
+                                   values[k]);
+    }
+    compute_rows_frame_aggregate(
+        output_for_partition_buff, sorted_indices, values, non_null, window_func_);
+  }
+}
+
 void WindowFunctionContext::fillPartitionStart() {
   CountDistinctDescriptor partition_start_bitmap{CountDistinctImplType::Bitmap,
                                                  0,
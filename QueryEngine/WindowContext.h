@@ -55,6 +55,14 @@ inline bool window_function_is_aggregate(const SqlWindowFunctionKind kind) {
   }
 }
 
+// Returns true for aggregate window functions over a ROWS frame. Those are computed
+// ahead of the projection and only read by it, like the rank functions.
+inline bool window_function_is_rows_frame_aggregate(
+    const Analyzer::WindowFunction* window_func) {
+  return window_function_is_aggregate(window_func->getKind()) &&
+         window_func->getRowsFrame();
+}
+
 class Executor;
 
 // Per-window function context which encapsulates the logic for computing the various
@@ -82,6 +90,27 @@ class WindowFunctionContext {
                       const Analyzer::ColumnVar* col_var,
                       const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
 
+  // Adds the buffer of the argument column of an aggregate over a ROWS frame and keeps
+  // ownership of it.
+  void setAggregateArgumentColumn(
+      const int8_t* column,
+      const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
+
+  // Keeps the sort of the partitions done by compute(), for the window functions with
+  // the same partition and order keys. Must be called before compute().
+  void retainSortedPartitions();
+
+  // Uses the sort of the partitions retained by the context of a window function with
+  // the same partitions and order keys, compute() then skips sorting them.
+  void setSortedPartitions(
+      const std::shared_ptr<const std::vector<int64_t>>& sorted_partitions);
+
+  // Returns the sort of the partitions retained by compute(), nullptr if not retained.
+  std::shared_ptr<const std::vector<int64_t>> getSortedPartitions() const;
+
+  // Returns the partitions specified by the window.
+  const std::shared_ptr<JoinHashTableInterface>& getPartitions() const;
+
   // Computes the window function result to be used during the actual projection query.
   void compute();
 
@@ -131,6 +160,12 @@ class WindowFunctionContext {
                                    const int32_t* partition_indices,
                                    const bool nulls_first);
 
+  // Sorts the rows of a partition in `scratchpad` on up to `sort_thread_count` threads,
+  // or copies their shared sort, and computes the window function over them.
+  void sortAndComputePartition(const size_t partition_idx,
+                               int64_t* scratchpad,
+                               const size_t sort_thread_count);
+
   void computePartition(
       int64_t* output_for_partition_buff,
       const size_t partition_size,
@@ -138,6 +173,12 @@ class WindowFunctionContext {
       const Analyzer::WindowFunction* window_func,
       const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator);
 
+  // Evaluates an aggregate over a ROWS frame for the partition rows sorted in
+  // `output_for_partition_buff`, reusing it as the output buffer.
+  void computeRowsFramePartition(int64_t* output_for_partition_buff,
+                                 const size_t partition_size,
+                                 const size_t off) const;
+
   void fillPartitionStart();
 
   void fillPartitionEnd();
@@ -155,8 +196,17 @@ class WindowFunctionContext {
   std::vector<std::vector<std::shared_ptr<Chunk_NS::Chunk>>> order_columns_owner_;
   // Order column buffers.
   std::vector<const int8_t*> order_columns_;
+  // Keeps ownership of the argument column of an aggregate over a ROWS frame.
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> aggregate_argument_owner_;
+  // Argument column buffer of an aggregate over a ROWS frame.
+  const int8_t* aggregate_argument_;
   // Hash table which contains the partitions specified by the window.
   std::shared_ptr<JoinHashTableInterface> partitions_;
+  // Sort of the rows of every partition, kept for the window functions with the same
+  // partition and order keys.
+  std::shared_ptr<std::vector<int64_t>> retained_sorted_partitions_;
+  // Sort of the rows of every partition, computed by another window function.
+  std::shared_ptr<const std::vector<int64_t>> shared_sorted_partitions_;
   // The number of elements in the table.
   size_t elem_count_;
   // The output of the window function.
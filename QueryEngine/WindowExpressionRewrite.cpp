@@ -41,6 +41,11 @@ bool matches_gt_bigint_zero(const Analyzer::BinOper* window_gt_zero) {
 bool window_sum_and_count_match(const Analyzer::WindowFunction* sum_window_expr,
                                 const Analyzer::WindowFunction* count_window_expr) {
   CHECK_EQ(count_window_expr->get_type_info().get_type(), kBIGINT);
+  const auto& sum_frame = sum_window_expr->getRowsFrame();
+  const auto& count_frame = count_window_expr->getRowsFrame();
+  if (!sum_frame != !count_frame || (sum_frame && !(*sum_frame == *count_frame))) {
+    return false;
+  }
   return expr_list_match(sum_window_expr->getArgs(), count_window_expr->getArgs());
 }
 
@@ -91,7 +96,8 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_sum_window(const Analyzer::Exp
                                             sum_window_expr->getArgs(),
                                             sum_window_expr->getPartitionKeys(),
                                             sum_window_expr->getOrderKeys(),
-                                            sum_window_expr->getCollation());
+                                            sum_window_expr->getCollation(),
+                                            sum_window_expr->getRowsFrame());
 }
 
 std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Expr* expr) {
@@ -121,7 +127,7 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Exp
                                sum_window_expr->get_type_info().get_type()) {
     return nullptr;
   }
-  if (!expr_list_match(sum_window_expr.get()->getArgs(), count_window->getArgs())) {
+  if (!window_sum_and_count_match(sum_window_expr.get(), count_window)) {
     return nullptr;
   }
   return makeExpr<Analyzer::WindowFunction>(SQLTypeInfo(kDOUBLE),
@@ -129,5 +135,6 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Exp
                                             sum_window_expr->getArgs(),
                                             sum_window_expr->getPartitionKeys(),
                                             sum_window_expr->getOrderKeys(),
-                                            sum_window_expr->getCollation());
+                                            sum_window_expr->getCollation(),
+                                            sum_window_expr->getRowsFrame());
 }
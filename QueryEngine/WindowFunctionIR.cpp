@@ -59,6 +59,22 @@ llvm::Value* Executor::codegenWindowFunction(const size_t target_index,
     case SqlWindowFunctionKind::MAX:
     case SqlWindowFunctionKind::SUM:
     case SqlWindowFunctionKind::COUNT: {
+      if (window_func->getRowsFrame()) {
+        // computed ahead of the projection, like the rank functions
+        const auto& window_func_ti = window_func->get_type_info();
+        const auto output_buff = cgen_state_->llInt(
+            reinterpret_cast<const int64_t>(window_func_context->output()));
+        if (!window_func_ti.is_fp()) {
+          return cgen_state_->emitCall("row_number_window_func",
+                                       {output_buff, code_generator.posArg(nullptr)});
+        }
+        const auto fp_val = cgen_state_->emitCall(
+            "percent_window_func", {output_buff, code_generator.posArg(nullptr)});
+        return window_func_ti.get_type() == kFLOAT
+                   ? cgen_state_->ir_builder_.CreateFPTrunc(
+                         fp_val, llvm::Type::getFloatTy(cgen_state_->context_))
+                   : fp_val;
+      }
       return codegenWindowFunctionAggregate(co);
     }
     default: {
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    WindowSegmentTree.h
+ * @brief   Range aggregates over the sorted rows of a window partition.
+ *
+ * The leaves of the tree are the values of the rows in the partition order, each inner
+ * node holds the aggregate of its two children. A frame spanning any number of rows is
+ * then aggregated from at most two nodes per level, in O(log n), instead of revisiting
+ * every row of the frame for every row of the partition.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "Logger/Logger.h"
+
+template <class T, class AggOp>
+class WindowSegmentTree {
+ public:
+  // `op` must be associative and `identity` its neutral element.
+  WindowSegmentTree(const std::vector<T>& leaves, const T identity, AggOp op)
+      : leaf_count_(leaves.size())
+      , nodes_(2 * leaves.size(), identity)
+      , identity_(identity)
+      , op_(op) {
+    std::copy(leaves.begin(), leaves.end(), nodes_.begin() + leaf_count_);
+    for (size_t i = leaf_count_; i-- > 1;) {
+      nodes_[i] = op_(nodes_[2 * i], nodes_[2 * i + 1]);
+    }
+  }
+
+  // The aggregate of the leaves in [begin, end), the identity for an empty range.
+  T query(size_t begin, size_t end) const {
+    CHECK_LE(end, leaf_count_);
+    T lhs_agg = identity_;
+    T rhs_agg = identity_;
+    for (begin += leaf_count_, end += leaf_count_; begin < end;
+         begin >>= 1, end >>= 1) {
+      if (begin & 1) {
+        lhs_agg = op_(lhs_agg, nodes_[begin++]);
+      }
+      if (end & 1) {
+        rhs_agg = op_(nodes_[--end], rhs_agg);
+      }
+    }
+    return op_(lhs_agg, rhs_agg);
+  }
+
+ private:
+  const size_t leaf_count_;
+  // nodes_[1] is the root, the children of node i are 2 * i and 2 * i + 1
+  std::vector<T> nodes_;
+  const T identity_;
+  const AggOp op_;
+};
@@ -0,0 +1,344 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorkingSetScheduler.h"
+
+#include "Catalog/Catalog.h"
+#include "DataMgr/Chunk/Chunk.h"
+#include "LockMgr/LockMgr.h"
+#include "Logger/Logger.h"
+#include "QueryEngine/Execute.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+
+bool g_enable_working_set_snapshot{false};
+size_t g_working_set_snapshot_interval_s{600};
+size_t g_working_set_warmup_mb_per_sec{0};
+
+namespace {
+
+constexpr int kSnapshotVersion{1};
+// How long the warm-up waits for the running queries before trying again.
+constexpr std::chrono::milliseconds kBusyRetryInterval{1000};
+
+struct WorkingSetChunk {
+  Data_Namespace::MemoryLevel memory_level;
+  int device_id;
+  ChunkKey chunk_key;  // of the column, for the data and the index of a varlen column
+};
+
+enum class LoadResult { kLoaded, kSkipped, kBusy, kPoolFull };
+
+// Loads the chunk to its pool if its table still has it, as of its current size.
+LoadResult load_chunk(const Catalog_Namespace::Catalog& catalog,
+                      const WorkingSetChunk& chunk,
+                      size_t& num_bytes) {
+  const auto& chunk_key = chunk.chunk_key;
+  const auto physical_td =
+      catalog.getMetadataForTable(chunk_key[CHUNK_KEY_TABLE_IDX], false);
+  if (!physical_td || physical_td->isView ||
+      physical_td->storageType == StorageType::FOREIGN_TABLE) {
+    return LoadResult::kSkipped;
+  }
+  // locked as a query on the table would be
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          catalog, catalog.getLogicalTableId(physical_td->tableId));
+  const auto data_lock = lockmgr::TableDataLockContainer<lockmgr::ReadLock>::acquire(
+      catalog.getDatabaseId(), td_with_lock());
+  const auto td = catalog.getMetadataForTable(chunk_key[CHUNK_KEY_TABLE_IDX]);
+  if (!td || !td->fragmenter) {
+    return LoadResult::kSkipped;
+  }
+  const auto cd =
+      catalog.getMetadataForColumn(td->tableId, chunk_key[CHUNK_KEY_COLUMN_IDX]);
+  if (!cd || cd->isVirtualCol) {
+    return LoadResult::kSkipped;
+  }
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  const auto fragment_it = std::find_if(
+      table_info.fragments.begin(),
+      table_info.fragments.end(),
+      [&chunk_key](const Fragmenter_Namespace::FragmentInfo& fragment) {
+        return fragment.fragmentId == chunk_key[CHUNK_KEY_FRAGMENT_IDX];
+      });
+  if (fragment_it == table_info.fragments.end()) {
+    return LoadResult::kSkipped;
+  }
+  const auto& chunk_metadata_map = fragment_it->getChunkMetadataMapPhysical();
+  const auto chunk_metadata_it = chunk_metadata_map.find(cd->columnId);
+  if (chunk_metadata_it == chunk_metadata_map.end()) {
+    return LoadResult::kSkipped;
+  }
+  const auto& chunk_metadata = *chunk_metadata_it->second;
+
+  auto& data_mgr = catalog.getDataMgr();
+  Chunk_NS::Chunk column_chunk(cd);
+  if (column_chunk.isChunkOnDevice(
+          &data_mgr, chunk_key, chunk.memory_level, chunk.device_id)) {
+    return LoadResult::kSkipped;
+  }
+  // the chunks the queries have loaded since the restart aren't evicted for it
+  if (data_mgr.getFreeBufferPoolBytes(chunk.memory_level, chunk.device_id) <
+      chunk_metadata.numBytes) {
+    return LoadResult::kPoolFull;
+  }
+  const bool is_loaded = Executor::runIfIdle([&] {
+    Chunk_NS::Chunk::getChunk(cd,
+                              &data_mgr,
+                              chunk_key,
+                              chunk.memory_level,
+                              chunk.device_id,
+                              chunk_metadata.numBytes,
+                              chunk_metadata.numElements);
+  });
+  if (!is_loaded) {
+    return LoadResult::kBusy;
+  }
+  num_bytes = chunk_metadata.numBytes;
+  return LoadResult::kLoaded;
+}
+
+std::vector<WorkingSetChunk> read_snapshot(const std::string& snapshot_path) {
+  std::vector<WorkingSetChunk> chunks;
+  std::ifstream snapshot(snapshot_path);
+  if (!snapshot) {
+    return chunks;
+  }
+  int version{0};
+  if (!(snapshot >> version) || version != kSnapshotVersion) {
+    LOG(WARNING) << "Ignoring the working set snapshot " << snapshot_path
+                 << " of an unknown version";
+    return chunks;
+  }
+  int memory_level{0};
+  int device_id{0};
+  ChunkKey chunk_key(CHUNK_KEY_FRAGMENT_IDX + 1);
+  while (snapshot >> memory_level >> device_id >> chunk_key[CHUNK_KEY_DB_IDX] >>
+         chunk_key[CHUNK_KEY_TABLE_IDX] >> chunk_key[CHUNK_KEY_COLUMN_IDX] >>
+         chunk_key[CHUNK_KEY_FRAGMENT_IDX]) {
+    if (memory_level != Data_Namespace::MemoryLevel::CPU_LEVEL &&
+        memory_level != Data_Namespace::MemoryLevel::GPU_LEVEL) {
+      continue;
+    }
+    chunks.push_back({static_cast<Data_Namespace::MemoryLevel>(memory_level),
+                      device_id,
+                      chunk_key});
+  }
+  return chunks;
+}
+
+}  // namespace
+
+void WorkingSetScheduler::start(std::atomic<bool>& is_program_running,
+                                const std::string& snapshot_path) {
+  if (!is_scheduler_running_) {
+    stop_requested_ = false;
+    is_warm_up_done_ = false;
+    snapshot_path_ = snapshot_path;
+    scheduler_thread_ = std::thread([&is_program_running, snapshot_path]() {
+      try {
+        warmUp(snapshot_path, is_program_running);
+      } catch (std::exception& e) {
+        LOG(ERROR) << "Loading the working set of the buffer pools resulted in an "
+                      "error. "
+                   << e.what();
+      }
+      if (!is_program_running) {
+        return;
+      }
+      // the snapshot isn't overwritten before its chunks are all back
+      is_warm_up_done_ = true;
+      while (is_program_running) {
+        if (!waitFor(thread_wait_duration_)) {
+          return;
+        }
+        try {
+          writeSnapshot(snapshot_path);
+        } catch (std::exception& e) {
+          LOG(ERROR) << "Saving the working set of the buffer pools resulted in an "
+                        "error. "
+                     << e.what();
+        }
+      }
+    });
+    is_scheduler_running_ = true;
+  }
+}
+
+void WorkingSetScheduler::stop() {
+  if (is_scheduler_running_) {
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex_);
+      stop_requested_ = true;
+    }
+    stop_cv_.notify_all();
+    scheduler_thread_.join();
+    is_scheduler_running_ = false;
+    if (is_warm_up_done_) {
+      try {
+        writeSnapshot(snapshot_path_);
+      } catch (std::exception& e) {
+        LOG(ERROR) << "Saving the working set of the buffer pools resulted in an error. "
+                   << e.what();
+      }
+    }
+  }
+}
+
+void WorkingSetScheduler::writeSnapshot(const std::string& snapshot_path) {
+  auto& data_mgr = Catalog_Namespace::SysCatalog::instance().getDataMgr();
+  // the chunks of each pool, hottest first
+  std::vector<std::vector<WorkingSetChunk>> pool_chunks;
+  for (const auto memory_level : {Data_Namespace::MemoryLevel::CPU_LEVEL,
+                                  Data_Namespace::MemoryLevel::GPU_LEVEL}) {
+    if (static_cast<size_t>(memory_level) >= data_mgr.levelSizes_.size()) {
+      continue;
+    }
+    for (int device_id = 0; device_id < data_mgr.levelSizes_[memory_level];
+         ++device_id) {
+      pool_chunks.emplace_back();
+      std::set<ChunkKey> column_chunk_keys;
+      for (auto chunk_key : data_mgr.getHotChunkKeys(memory_level, device_id)) {
+        if (chunk_key.size() <= CHUNK_KEY_FRAGMENT_IDX) {
+          continue;
+        }
+        chunk_key.resize(CHUNK_KEY_FRAGMENT_IDX + 1);
+        if (column_chunk_keys.insert(chunk_key).second) {
+          pool_chunks.back().push_back({memory_level, device_id, chunk_key});
+        }
+      }
+    }
+  }
+
+  // written aside, then moved over the snapshot in one go
+  const auto temp_path = snapshot_path + ".tmp";
+  std::ofstream snapshot(temp_path, std::ios::trunc);
+  snapshot << kSnapshotVersion << "\n";
+  size_t chunk_count{0};
+  // the n-th hottest chunks of all the pools before the (n + 1)-th ones
+  for (size_t rank = 0;; ++rank) {
+    bool has_chunks{false};
+    for (const auto& chunks : pool_chunks) {
+      if (rank >= chunks.size()) {
+        continue;
+      }
+      has_chunks = true;
+      const auto& chunk = chunks[rank];
+      snapshot << static_cast<int>(chunk.memory_level) << " " << chunk.device_id;
+      for (const auto key_part : chunk.chunk_key) {
+        snapshot << " " << key_part;
+      }
+      snapshot << "\n";
+      ++chunk_count;
+    }
+    if (!has_chunks) {
+      break;
+    }
+  }
+  snapshot.close();
+  if (!snapshot) {
+    throw std::runtime_error("Failed to write the working set snapshot " + temp_path);
+  }
+  boost::filesystem::rename(temp_path, snapshot_path);
+  VLOG(1) << "Saved a working set of " << chunk_count << " chunks to " << snapshot_path;
+}
+
+size_t WorkingSetScheduler::warmUp(const std::string& snapshot_path,
+                                   std::atomic<bool>& is_program_running) {
+  const auto chunks = read_snapshot(snapshot_path);
+  if (chunks.empty()) {
+    return 0;
+  }
+  std::map<int, std::shared_ptr<Catalog_Namespace::Catalog>> catalogs;
+  for (const auto& catalog :
+       Catalog_Namespace::SysCatalog::instance().getCatalogsForAllDbs()) {
+    catalogs[catalog->getDatabaseId()] = catalog;
+  }
+  auto& data_mgr = Catalog_Namespace::SysCatalog::instance().getDataMgr();
+  std::set<std::pair<Data_Namespace::MemoryLevel, int>> full_pools;
+  size_t loaded_count{0};
+  for (const auto& chunk : chunks) {
+    if (!is_program_running) {
+      break;
+    }
+    const auto pool = std::make_pair(chunk.memory_level, chunk.device_id);
+    const auto catalog_it = catalogs.find(chunk.chunk_key[CHUNK_KEY_DB_IDX]);
+    if (full_pools.count(pool) || catalog_it == catalogs.end() ||
+        static_cast<size_t>(chunk.memory_level) >= data_mgr.levelSizes_.size() ||
+        chunk.device_id >= data_mgr.levelSizes_[chunk.memory_level]) {
+      continue;
+    }
+    const auto clock_begin = std::chrono::steady_clock::now();
+    size_t num_bytes{0};
+    LoadResult result;
+    try {
+      while ((result = load_chunk(*catalog_it->second, chunk, num_bytes)) ==
+             LoadResult::kBusy) {
+        if (!waitFor(kBusyRetryInterval)) {
+          return loaded_count;
+        }
+      }
+    } catch (std::exception& e) {
+      // the table may have been dropped meanwhile
+      VLOG(1) << "Skipping a chunk of the working set: " << e.what();
+      continue;
+    }
+    if (result == LoadResult::kPoolFull) {
+      full_pools.insert(pool);
+      continue;
+    }
+    if (result != LoadResult::kLoaded) {
+      continue;
+    }
+    ++loaded_count;
+    if (g_working_set_warmup_mb_per_sec) {
+      const std::chrono::milliseconds min_duration(
+          num_bytes * 1000 / (g_working_set_warmup_mb_per_sec * 1024 * 1024));
+      const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - clock_begin);
+      if (duration < min_duration && !waitFor(min_duration - duration)) {
+        break;
+      }
+    }
+  }
+  LOG(INFO) << "Loaded " << loaded_count << " chunks of the working set of "
+            << chunks.size() << " chunks from " << snapshot_path;
+  return loaded_count;
+}
+
+void WorkingSetScheduler::setWaitDuration(int64_t duration_in_seconds) {
+  thread_wait_duration_ = std::chrono::seconds{duration_in_seconds};
+}
+
+bool WorkingSetScheduler::waitFor(const std::chrono::milliseconds duration) {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  return !stop_cv_.wait_for(lock, duration, [] { return stop_requested_; });
+}
+
+bool WorkingSetScheduler::is_scheduler_running_{false};
+bool WorkingSetScheduler::stop_requested_{false};
+std::atomic<bool> WorkingSetScheduler::is_warm_up_done_{false};
+std::string WorkingSetScheduler::snapshot_path_;
+std::mutex WorkingSetScheduler::stop_mutex_;
+std::condition_variable WorkingSetScheduler::stop_cv_;
+std::chrono::seconds WorkingSetScheduler::thread_wait_duration_{600};
+std::thread WorkingSetScheduler::scheduler_thread_;
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+extern bool g_enable_working_set_snapshot;
+extern size_t g_working_set_snapshot_interval_s;
+extern size_t g_working_set_warmup_mb_per_sec;
+
+/**
+ * @brief Saves the working set of the CPU and GPU buffer pools and loads it back after a
+ * restart, rather than letting the first queries refill the pools chunk by chunk.
+ * Every g_working_set_snapshot_interval_s and at shutdown, the keys of the chunks each
+ * pool holds are written to a snapshot file, the ones its eviction policy would keep the
+ * longest first. At startup, the chunks of the snapshot are loaded back in the
+ * background to the pools they were in, the hottest of every pool first. A chunk is only
+ * loaded while no query is running and into a pool with room for it, at
+ * g_working_set_warmup_mb_per_sec at most, 0 doesn't limit the rate.
+ */
+class WorkingSetScheduler {
+ public:
+  static void start(std::atomic<bool>& is_program_running,
+                    const std::string& snapshot_path);
+  static void stop();
+
+  // Writes the keys of the chunks held by the buffer pools to the snapshot file.
+  static void writeSnapshot(const std::string& snapshot_path);
+  // Loads the chunks of the snapshot file, returns how many were loaded.
+  static size_t warmUp(const std::string& snapshot_path,
+                       std::atomic<bool>& is_program_running);
+
+  // for testing
+  static void setWaitDuration(int64_t duration_in_seconds);
+
+ private:
+  // Sleeps for `duration`, returns false if the scheduler is stopped meanwhile.
+  static bool waitFor(const std::chrono::milliseconds duration);
+
+  static bool is_scheduler_running_;
+  static bool stop_requested_;
+  static std::atomic<bool> is_warm_up_done_;
+  static std::string snapshot_path_;
+  static std::mutex stop_mutex_;
+  static std::condition_variable stop_cv_;
+  static std::chrono::seconds thread_wait_duration_;
+  static std::thread scheduler_thread_;
+};
@@ -47,8 +47,10 @@ extern "C" __device__ const int64_t* init_shared_mem_nop(
   return groups_buffer;
 }
 
-extern "C" __device__ void write_back_nop(int64_t* dest, int64_t* src, const int32_t sz) {
-}
+extern "C" __device__ void write_back_nop(int64_t* dest,
+                                          int64_t* src,
+                                          const int32_t sz,
+                                          int32_t* error_codes) {}
 
 /*
  * Just declares and returns a dynamic shared memory pointer. Total size should be
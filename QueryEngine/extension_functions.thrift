@@ -44,6 +44,7 @@ enum TOutputBufferSizeType {
   kConstant,
   kUserSpecifiedConstantParameter,
   kUserSpecifiedRowMultiplier,
+  kUserSpecifiedPartitionedRowMultiplier,
 }
 
 struct TUserDefinedFunction {
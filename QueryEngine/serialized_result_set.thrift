@@ -23,7 +23,9 @@ struct TColSlotContext {
 enum TCountDistinctImplType {
   Invalid,
   Bitmap,
-  StdSet
+  StdSet,
+  SparseHll,
+  RoaringBitmap
 }
 
 struct TCountDistinctDescriptor {
@@ -54,7 +56,8 @@ struct TResultSetBufferDescriptor {
 }
 
 enum TAggKind {
-  AVG, MIN, MAX, SUM, COUNT, APPROX_COUNT_DISTINCT, SAMPLE, SINGLE_VALUE
+  AVG, MIN, MAX, SUM, COUNT, APPROX_COUNT_DISTINCT, SAMPLE, SINGLE_VALUE,
+  APPROX_QUANTILE
 }
 
 struct TTargetInfo {
@@ -77,6 +80,15 @@ struct TCountDistinctSet {
   3: i64 remote_ptr
 }
 
+/* The values of a group key or a slot of all the entries of a buffer, as offsets from
+   min_val of encoded_width bytes each, compressed unless that didn't make them
+   smaller. */
+struct TCompressedField {
+  1: binary data,
+  2: i64 min_val,
+  3: byte encoded_width
+}
+
 struct TSerializedRows {
   1: list<binary> buffers,
   2: list<i64> buffer_lengths,
@@ -87,5 +99,6 @@ struct TSerializedRows {
   7: list<i64> target_init_vals,
   8: list<binary> varlen_buffer,
   9: list<TCountDistinctSet> count_distinct_sets,
-  10: string explanation
+  10: string explanation,
+  11: optional list<list<TCompressedField>> compressed_buffers
 }
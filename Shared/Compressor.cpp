@@ -117,6 +117,68 @@ std::string BloscCompressor::compress(const std::string& buffer) {
   return buffer;
 }
 
+int64_t BloscCompressor::compressShuffled(const uint8_t* buffer,
+                                          const size_t buffer_size,
+                                          uint8_t* compressed_buffer,
+                                          const size_t compressed_buffer_size,
+                                          const size_t type_size) {
+  if (compressed_buffer_size < BLOSC_MIN_HEADER_LENGTH) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> compressor_lock_(compressor_lock);
+  const auto compressed_len = blosc_compress(5,
+                                             BLOSC_SHUFFLE,
+                                             type_size,
+                                             buffer_size,
+                                             buffer,
+                                             compressed_buffer,
+                                             compressed_buffer_size);
+  if (compressed_len < 0) {
+    throw CompressionFailedError(std::string("failed to compress buffer of length ") +
+                                 std::to_string(buffer_size));
+  }
+  return compressed_len;
+}
+
+int64_t BloscCompressor::compressFast(const uint8_t* buffer,
+                                      const size_t buffer_size,
+                                      uint8_t* compressed_buffer,
+                                      const size_t compressed_buffer_size,
+                                      const size_t type_size) {
+  if (compressed_buffer_size < BLOSC_MIN_HEADER_LENGTH) {
+    return 0;
+  }
+  const auto compressed_len = blosc_compress_ctx(1,
+                                                 BLOSC_SHUFFLE,
+                                                 type_size,
+                                                 buffer_size,
+                                                 buffer,
+                                                 compressed_buffer,
+                                                 compressed_buffer_size,
+                                                 BLOSC_LZ4_COMPNAME,
+                                                 /*blocksize=*/0,
+                                                 /*numinternalthreads=*/1);
+  if (compressed_len < 0) {
+    throw CompressionFailedError(std::string("failed to compress buffer of length ") +
+                                 std::to_string(buffer_size));
+  }
+  return compressed_len;
+}
+
+void BloscCompressor::decompressFast(const uint8_t* compressed_buffer,
+                                     uint8_t* decompressed_buffer,
+                                     const size_t decompressed_size) {
+  const auto decompressed_len = blosc_decompress_ctx(compressed_buffer,
+                                                     decompressed_buffer,
+                                                     decompressed_size,
+                                                     /*numinternalthreads=*/1);
+  if (decompressed_len < 0 ||
+      static_cast<size_t>(decompressed_len) != decompressed_size) {
+    throw CompressionFailedError(std::string("failed to decompress buffer of length ") +
+                                 std::to_string(decompressed_size));
+  }
+}
+
 size_t BloscCompressor::decompress(const uint8_t* compressed_buffer,
                                    uint8_t* decompressed_buffer,
                                    const size_t decompressed_size) {
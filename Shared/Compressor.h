@@ -57,6 +57,27 @@ class BloscCompressor {
                    const size_t min_compressor_bytes);
   std::string compress(const std::string& buffer);
 
+  // Compresses a buffer of values of type_size bytes, shuffling the bytes so that the
+  // bytes of the same significance of all the values are compressed together. Returns 0
+  // if the compressed buffer doesn't fit.
+  int64_t compressShuffled(const uint8_t* buffer,
+                           const size_t buffer_size,
+                           uint8_t* compressed_buffer,
+                           const size_t compressed_buffer_size,
+                           const size_t type_size);
+
+  // Same as compressShuffled(), with LZ4 rather than the codec of the compressor, on the
+  // calling thread and without serializing with the other compressions.
+  int64_t compressFast(const uint8_t* buffer,
+                       const size_t buffer_size,
+                       uint8_t* compressed_buffer,
+                       const size_t compressed_buffer_size,
+                       const size_t type_size);
+  // Decompresses a buffer of compressFast() on the calling thread.
+  void decompressFast(const uint8_t* compressed_buffer,
+                      uint8_t* decompressed_buffer,
+                      const size_t decompressed_size);
+
   size_t decompress(const uint8_t* compressed_buffer,
                     uint8_t* decompressed_buffer,
                     const size_t decompressed_size);
@@ -35,6 +35,13 @@
 
 namespace File_Namespace {
 
+/**
+ * @brief Returns the path of the data file with the given id and page size.
+ */
+std::string get_data_file_path(const std::string& base_path,
+                               const int file_id,
+                               const size_t page_size);
+
 FILE* create(const std::string& basePath,
              const int fileId,
              const size_t pageSize,
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/HugePages.h"
+
+#include "Logger/Logger.h"
+#include "Shared/checked_alloc.h"
+
+#include <sys/mman.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+std::string g_huge_pages{"none"};
+
+namespace huge_pages {
+
+namespace {
+
+constexpr size_t kHugePageBytes{size_t(2) << 20};
+constexpr size_t kGigaPageBytes{size_t(1) << 30};
+
+size_t round_up(const size_t num_bytes, const size_t alignment) {
+  return (num_bytes + alignment - 1) / alignment * alignment;
+}
+
+struct Mapping {
+  size_t num_bytes;
+  Mode mode;
+};
+
+struct Mappings {
+  std::mutex mutex;
+  std::unordered_map<void*, Mapping> mappings;
+  Stats stats;
+};
+
+Mappings& mappings() {
+  static Mappings mappings;
+  return mappings;
+}
+
+// lets deallocate() skip the lock when nothing is mapped
+std::atomic<size_t> num_mappings{0};
+
+void* map_transparent(const size_t num_bytes) {
+  // over-map by a huge page, then unmap the ends to align the start on a huge page
+  const size_t map_bytes = num_bytes + kHugePageBytes;
+  auto base = mmap(
+      nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    return nullptr;
+  }
+  const auto base_addr = reinterpret_cast<uintptr_t>(base);
+  const auto addr = round_up(base_addr, kHugePageBytes);
+  if (addr > base_addr) {
+    munmap(base, addr - base_addr);
+  }
+  if (base_addr + map_bytes > addr + num_bytes) {
+    munmap(reinterpret_cast<void*>(addr + num_bytes),
+           base_addr + map_bytes - addr - num_bytes);
+  }
+  auto ptr = reinterpret_cast<void*>(addr);
+#ifdef MADV_HUGEPAGE
+  if (madvise(ptr, num_bytes, MADV_HUGEPAGE)) {
+    static std::atomic<bool> warned{false};
+    if (!warned.exchange(true)) {
+      LOG(WARNING) << "Transparent huge pages are not available, CPU buffers will be "
+                      "backed by regular pages";
+    }
+  }
+#endif
+  return ptr;
+}
+
+void* map_hugetlb(const size_t num_bytes) {
+#ifdef MAP_HUGETLB
+  const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_1GB
+  if (num_bytes % kGigaPageBytes == 0) {
+    auto ptr = mmap(
+        nullptr, num_bytes, PROT_READ | PROT_WRITE, flags | MAP_HUGE_1GB, -1, 0);
+    if (ptr != MAP_FAILED) {
+      return ptr;
+    }
+  }
+#endif
+  auto ptr = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (ptr != MAP_FAILED) {
+    return ptr;
+  }
+#endif
+  return nullptr;
+}
+
+}  // namespace
+
+Mode parse_mode(const std::string& mode) {
+  if (mode == "none") {
+    return Mode::None;
+  }
+  if (mode == "transparent") {
+    return Mode::Transparent;
+  }
+  if (mode == "hugetlb") {
+    return Mode::HugeTlb;
+  }
+  throw std::runtime_error("Unknown huge pages mode " + mode +
+                           ", expected none, transparent or hugetlb.");
+}
+
+Mode get_mode() {
+  return parse_mode(g_huge_pages);
+}
+
+void* allocate(const size_t num_bytes) {
+  if (num_bytes < kMinAllocationBytes) {
+    return nullptr;
+  }
+  const auto mode = get_mode();
+  if (mode == Mode::None) {
+    return nullptr;
+  }
+  const auto map_bytes = round_up(num_bytes, kHugePageBytes);
+  void* ptr{nullptr};
+  auto mapped_mode = mode;
+  if (mode == Mode::HugeTlb) {
+    ptr = map_hugetlb(map_bytes);
+    if (!ptr) {
+      static std::atomic<bool> warned{false};
+      if (!warned.exchange(true)) {
+        LOG(WARNING) << "The hugetlb pool has no room for " << map_bytes
+                     << " bytes, falling back to transparent huge pages";
+      }
+      mapped_mode = Mode::Transparent;
+    }
+  }
+  if (!ptr) {
+    ptr = map_transparent(map_bytes);
+  }
+  if (!ptr) {
+    throw OutOfHostMemory(num_bytes);
+  }
+  auto& all = mappings();
+  std::lock_guard<std::mutex> lock(all.mutex);
+  all.mappings.emplace(ptr, Mapping{map_bytes, mapped_mode});
+  auto& mode_bytes = mapped_mode == Mode::HugeTlb ? all.stats.hugetlb_bytes
+                                                  : all.stats.transparent_bytes;
+  mode_bytes += map_bytes;
+  ++num_mappings;
+  return ptr;
+}
+
+bool deallocate(void* ptr) {
+  if (!num_mappings.load()) {
+    return false;
+  }
+  auto& all = mappings();
+  std::lock_guard<std::mutex> lock(all.mutex);
+  const auto it = all.mappings.find(ptr);
+  if (it == all.mappings.end()) {
+    return false;
+  }
+  const auto& mapping = it->second;
+  munmap(ptr, mapping.num_bytes);
+  auto& mode_bytes = mapping.mode == Mode::HugeTlb ? all.stats.hugetlb_bytes
+                                                   : all.stats.transparent_bytes;
+  mode_bytes -= mapping.num_bytes;
+  all.mappings.erase(it);
+  --num_mappings;
+  return true;
+}
+
+Stats get_stats() {
+  auto& all = mappings();
+  std::lock_guard<std::mutex> lock(all.mutex);
+  return all.stats;
+}
+
+}  // namespace huge_pages
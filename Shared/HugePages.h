@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    HugePages.h
+ * @brief   Huge page backing for the CPU buffer pool slabs and the large query arena
+ *          blocks, which are probed at random by scans and hash joins and miss the TLB
+ *          with 4KB pages.
+ *
+ * In the transparent mode the memory is mapped aligned to 2MB and advised with
+ * MADV_HUGEPAGE, for the kernel to back it with huge pages when it has them. In the
+ * hugetlb mode it is mapped from the preallocated pool of the kernel (vm.nr_hugepages),
+ * with 1GB pages for the allocations which are whole multiples of 1GB, and falls back to
+ * the transparent mode when the pool is short.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// none, transparent or hugetlb
+extern std::string g_huge_pages;
+
+namespace huge_pages {
+
+enum class Mode { None, Transparent, HugeTlb };
+
+// Throws on an unknown mode.
+Mode parse_mode(const std::string& mode);
+
+Mode get_mode();
+
+// Allocations under this size come from malloc.
+constexpr size_t kMinAllocationBytes{size_t(32) << 20};
+
+struct Stats {
+  // live bytes mapped in each mode
+  size_t transparent_bytes{0};
+  size_t hugetlb_bytes{0};
+};
+
+/**
+ * Maps `num_bytes` backed by huge pages in the configured mode, or returns nullptr if the
+ * mode is none or the size is under kMinAllocationBytes. Throws OutOfHostMemory if the
+ * mapping fails. The memory is not touched, so its pages are placed on first use.
+ */
+void* allocate(const size_t num_bytes);
+
+// Unmaps `ptr` if it was returned by allocate() and returns true, false otherwise.
+bool deallocate(void* ptr);
+
+Stats get_stats();
+
+}  // namespace huge_pages
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/LockContention.h"
+
+#include <map>
+#include <memory>
+#include <utility>
+
+bool g_enable_lock_contention_profiling{false};
+
+namespace lock_contention {
+
+namespace {
+
+void update_max(std::atomic<uint64_t>& max_value, const uint64_t value) {
+  auto current = max_value.load(std::memory_order_relaxed);
+  while (value > current &&
+         !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+struct Profiles {
+  std::mutex mutex;
+  std::map<std::pair<std::string, std::string>, std::unique_ptr<LockProfile>> profiles;
+};
+
+Profiles& profiles() {
+  static Profiles profiles;
+  return profiles;
+}
+
+}  // namespace
+
+void LockProfile::addAcquisition(const bool contended, const uint64_t wait_ns) {
+  acquisitions_.fetch_add(1, std::memory_order_relaxed);
+  if (contended) {
+    contended_.fetch_add(1, std::memory_order_relaxed);
+    wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+    update_max(max_wait_ns_, wait_ns);
+  }
+}
+
+void LockProfile::addHold(const uint64_t hold_ns) {
+  sampled_holds_.fetch_add(1, std::memory_order_relaxed);
+  hold_ns_.fetch_add(hold_ns, std::memory_order_relaxed);
+  update_max(max_hold_ns_, hold_ns);
+}
+
+void LockProfile::reset() {
+  for (auto counter : {&acquisitions_,
+                       &contended_,
+                       &wait_ns_,
+                       &max_wait_ns_,
+                       &sampled_holds_,
+                       &hold_ns_,
+                       &max_hold_ns_}) {
+    counter->store(0, std::memory_order_relaxed);
+  }
+}
+
+LockStats LockProfile::stats() const {
+  LockStats stats;
+  stats.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+  stats.contended = contended_.load(std::memory_order_relaxed);
+  stats.wait_ns = wait_ns_.load(std::memory_order_relaxed);
+  stats.max_wait_ns = max_wait_ns_.load(std::memory_order_relaxed);
+  stats.sampled_holds = sampled_holds_.load(std::memory_order_relaxed);
+  stats.hold_ns = hold_ns_.load(std::memory_order_relaxed);
+  stats.max_hold_ns = max_hold_ns_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+LockProfile& get_profile(const std::string& lock_class, const std::string& object) {
+  auto& all = profiles();
+  std::lock_guard<std::mutex> lock(all.mutex);
+  auto& profile = all.profiles[{lock_class, object}];
+  if (!profile) {
+    profile = std::make_unique<LockProfile>();
+  }
+  return *profile;
+}
+
+std::vector<LockStats> get_stats() {
+  std::vector<LockStats> all_stats;
+  auto& all = profiles();
+  std::lock_guard<std::mutex> lock(all.mutex);
+  for (const auto& [key, profile] : all.profiles) {
+    auto stats = profile->stats();
+    stats.lock_class = key.first;
+    stats.object = key.second;
+    all_stats.push_back(std::move(stats));
+  }
+  return all_stats;
+}
+
+void reset_profiles() {
+  auto& all = profiles();
+  std::lock_guard<std::mutex> lock(all.mutex);
+  for (auto& [key, profile] : all.profiles) {
+    profile->reset();
+  }
+}
+
+}  // namespace lock_contention
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    LockContention.h
+ * @brief   Wait and hold times of the table, catalog and dictionary locks.
+ *
+ * Acquisitions try the lock first and only read the clock when it is taken, so an
+ * uncontended acquisition costs one relaxed atomic increment. Hold times are sampled,
+ * one acquisition out of kHoldSampleInterval per thread.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern bool g_enable_lock_contention_profiling;
+
+namespace lock_contention {
+
+constexpr uint32_t kHoldSampleInterval{16};
+
+struct LockStats {
+  std::string lock_class;
+  // the table or the database the lock protects, empty if the class is profiled as one
+  std::string object;
+  uint64_t acquisitions{0};
+  // the acquisitions which had to wait
+  uint64_t contended{0};
+  uint64_t wait_ns{0};
+  uint64_t max_wait_ns{0};
+  uint64_t sampled_holds{0};
+  uint64_t hold_ns{0};
+  uint64_t max_hold_ns{0};
+};
+
+class LockProfile {
+ public:
+  void addAcquisition(const bool contended, const uint64_t wait_ns);
+
+  void addHold(const uint64_t hold_ns);
+
+  // The counters, without the names.
+  LockStats stats() const;
+
+  void reset();
+
+ private:
+  std::atomic<uint64_t> acquisitions_{0};
+  std::atomic<uint64_t> contended_{0};
+  std::atomic<uint64_t> wait_ns_{0};
+  std::atomic<uint64_t> max_wait_ns_{0};
+  std::atomic<uint64_t> sampled_holds_{0};
+  std::atomic<uint64_t> hold_ns_{0};
+  std::atomic<uint64_t> max_hold_ns_{0};
+};
+
+// The profile of the lock of `lock_class` protecting `object`, created on first use. The
+// reference stays valid for the life of the process.
+LockProfile& get_profile(const std::string& lock_class, const std::string& object = "");
+
+// The stats of every profile, ordered by class and object.
+std::vector<LockStats> get_stats();
+
+// for testing
+void reset_profiles();
+
+// Times how long a lock is held, for the sampled acquisitions.
+class HoldTimer {
+ public:
+  HoldTimer() = default;
+
+  HoldTimer(HoldTimer&& other) noexcept : profile_(other.profile_), begin_(other.begin_) {
+    other.profile_ = nullptr;
+  }
+
+  HoldTimer& operator=(HoldTimer&& other) noexcept {
+    if (this != &other) {
+      stop();
+      profile_ = other.profile_;
+      begin_ = other.begin_;
+      other.profile_ = nullptr;
+    }
+    return *this;
+  }
+
+  HoldTimer(const HoldTimer&) = delete;
+  HoldTimer& operator=(const HoldTimer&) = delete;
+
+  ~HoldTimer() { stop(); }
+
+  void start(LockProfile& profile) {
+    thread_local uint32_t acquisition_count{0};
+    if (++acquisition_count % kHoldSampleInterval == 0) {
+      profile_ = &profile;
+      begin_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  // Called right before the lock is released.
+  void stop() {
+    if (profile_) {
+      profile_->addHold(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - begin_)
+                            .count());
+      profile_ = nullptr;
+    }
+  }
+
+ private:
+  LockProfile* profile_{nullptr};
+  std::chrono::steady_clock::time_point begin_;
+};
+
+/**
+ * Locks `lock`, a std::unique_lock or std::shared_lock constructed with std::defer_lock,
+ * and records the acquisition in `profile` if g_enable_lock_contention_profiling is set.
+ */
+template <typename LOCK>
+void lock(LOCK& lock, LockProfile& profile, HoldTimer& hold_timer) {
+  if (!g_enable_lock_contention_profiling) {
+    lock.lock();
+    return;
+  }
+  if (lock.try_lock()) {
+    profile.addAcquisition(false, 0);
+  } else {
+    const auto begin = std::chrono::steady_clock::now();
+    lock.lock();
+    profile.addAcquisition(true,
+                           std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - begin)
+                               .count());
+  }
+  hold_timer.start(profile);
+}
+
+// A std::unique_lock or std::shared_lock which records its acquisition in a profile.
+template <typename LOCK>
+class ProfiledLock {
+ public:
+  template <typename MUTEX>
+  ProfiledLock(MUTEX& mutex, LockProfile& profile) : lock_(mutex, std::defer_lock) {
+    lock_contention::lock(lock_, profile, hold_timer_);
+  }
+
+  ~ProfiledLock() { hold_timer_.stop(); }
+
+  void unlock() {
+    hold_timer_.stop();
+    lock_.unlock();
+  }
+
+ private:
+  LOCK lock_;
+  HoldTimer hold_timer_;
+};
+
+}  // namespace lock_contention
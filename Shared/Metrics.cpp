@@ -0,0 +1,224 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/Metrics.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "Logger/Logger.h"
+
+namespace metrics {
+
+namespace {
+
+std::string escape_label_value(const std::string& value) {
+  std::string escaped;
+  for (const auto c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+void render_labels(std::ostream& os, const Labels& labels) {
+  if (labels.empty()) {
+    return;
+  }
+  os << '{';
+  for (size_t i = 0; i < labels.size(); ++i) {
+    os << (i ? "," : "") << labels[i].first << "=\""
+       << escape_label_value(labels[i].second) << '"';
+  }
+  os << '}';
+}
+
+std::string format_bound(const double bound) {
+  std::ostringstream oss;
+  oss << bound;
+  return oss.str();
+}
+
+// The lines of one metric name, its HELP and TYPE rendered once.
+struct RenderedFamily {
+  std::string help;
+  std::string type;
+  std::ostringstream lines;
+};
+
+}  // namespace
+
+Histogram::Histogram(const std::vector<double>& bounds)
+    : bounds_(bounds)
+    , bucket_counts_(std::make_unique<std::atomic<uint64_t>[]>(bounds.size() + 1)) {
+  CHECK(std::is_sorted(bounds_.begin(), bounds_.end()));
+  for (size_t i = 0; i <= bounds_.size(); ++i) {
+    bucket_counts_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void Histogram::observe(const double value) {
+  const auto bucket =
+      std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+  bucket_counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+  auto sum = sum_.load(std::memory_order_relaxed);
+  while (!sum_.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+  }
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::cumulativeCounts() const {
+  std::vector<uint64_t> counts(bounds_.size() + 1);
+  uint64_t total{0};
+  for (size_t i = 0; i < counts.size(); ++i) {
+    total += bucket_counts_[i].load(std::memory_order_relaxed);
+    counts[i] = total;
+  }
+  return counts;
+}
+
+const std::vector<double>& latency_ms_buckets() {
+  static const std::vector<double> buckets{
+      1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000, 60000};
+  return buckets;
+}
+
+Registry& Registry::instance() {
+  static Registry registry;
+  return registry;
+}
+
+Registry::Family& Registry::getFamily(const std::string& name,
+                                      const std::string& help,
+                                      const std::string& type) {
+  auto& family = families_[name];
+  if (family.type.empty()) {
+    family.help = help;
+    family.type = type;
+  }
+  CHECK_EQ(family.type, type) << "Metric " << name << " registered with another type";
+  return family;
+}
+
+Counter& Registry::counter(const std::string& name,
+                           const std::string& help,
+                           const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& counter = getFamily(name, help, "counter").counters[labels];
+  if (!counter) {
+    counter = std::make_unique<Counter>();
+  }
+  return *counter;
+}
+
+Histogram& Registry::histogram(const std::string& name,
+                               const std::string& help,
+                               const std::vector<double>& bounds,
+                               const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& histogram = getFamily(name, help, "histogram").histograms[labels];
+  if (!histogram) {
+    histogram = std::make_unique<Histogram>(bounds);
+  }
+  return *histogram;
+}
+
+int Registry::addCollector(Collector collector) {
+  std::lock_guard<std::mutex> lock(collectors_mutex_);
+  const auto collector_id = next_collector_id_++;
+  collectors_.emplace(collector_id, std::move(collector));
+  return collector_id;
+}
+
+void Registry::removeCollector(const int collector_id) {
+  std::lock_guard<std::mutex> lock(collectors_mutex_);
+  collectors_.erase(collector_id);
+}
+
+std::string Registry::render() const {
+  std::map<std::string, RenderedFamily> rendered;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [name, family] : families_) {
+      auto& rendered_family = rendered[name];
+      rendered_family.help = family.help;
+      rendered_family.type = family.type;
+      auto& os = rendered_family.lines;
+      os.precision(15);
+      for (const auto& [labels, counter] : family.counters) {
+        os << name;
+        render_labels(os, labels);
+        os << ' ' << counter->value() << '\n';
+      }
+      for (const auto& [labels, histogram] : family.histograms) {
+        const auto& bounds = histogram->bounds();
+        const auto counts = histogram->cumulativeCounts();
+        for (size_t i = 0; i < counts.size(); ++i) {
+          auto bucket_labels = labels;
+          bucket_labels.emplace_back(
+              "le", i < bounds.size() ? format_bound(bounds[i]) : "+Inf");
+          os << name << "_bucket";
+          render_labels(os, bucket_labels);
+          os << ' ' << counts[i] << '\n';
+        }
+        os << name << "_sum";
+        render_labels(os, labels);
+        os << ' ' << histogram->sum() << '\n';
+        os << name << "_count";
+        render_labels(os, labels);
+        os << ' ' << histogram->count() << '\n';
+      }
+    }
+  }
+  std::vector<Sample> samples;
+  {
+    std::lock_guard<std::mutex> lock(collectors_mutex_);
+    for (const auto& [collector_id, collector] : collectors_) {
+      try {
+        collector(samples);
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Collecting metrics failed: " << e.what();
+      }
+    }
+  }
+  for (const auto& sample : samples) {
+    auto& rendered_family = rendered[sample.name];
+    if (rendered_family.type.empty()) {
+      rendered_family.help = sample.help;
+      rendered_family.type = sample.type;
+    }
+    auto& os = rendered_family.lines;
+    os.precision(15);
+    os << sample.name;
+    render_labels(os, sample.labels);
+    os << ' ' << sample.value << '\n';
+  }
+  std::ostringstream oss;
+  for (const auto& [name, rendered_family] : rendered) {
+    oss << "# HELP " << name << ' ' << rendered_family.help << '\n';
+    oss << "# TYPE " << name << ' ' << rendered_family.type << '\n';
+    oss << rendered_family.lines.str();
+  }
+  return oss.str();
+}
+
+}  // namespace metrics
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    Metrics.h
+ * @brief   Counters and histograms of the engine internals, rendered in the Prometheus
+ *          text format for the metrics endpoint.
+ *
+ * Counters and histograms are looked up once in the registry, which takes a lock, and
+ * the reference is kept by the instrumented code: updating them only takes relaxed
+ * atomic operations. Values the engine already tracks elsewhere, like the depth of the
+ * dispatch queue, are read when the metrics are rendered through collectors.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace metrics {
+
+// name and value of each label, in the order they are rendered
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+class Counter {
+ public:
+  void inc(const uint64_t delta = 1) {
+    value_.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+class Histogram {
+ public:
+  // `bounds` are the increasing upper bounds of the buckets, the +Inf bucket is implied.
+  explicit Histogram(const std::vector<double>& bounds);
+
+  void observe(const double value);
+
+  const std::vector<double>& bounds() const { return bounds_; }
+
+  // The number of observations in each bucket and below, the last one for +Inf.
+  std::vector<uint64_t> cumulativeCounts() const;
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  double sum() const { return sum_.load(std::memory_order_relaxed); }
+
+ private:
+  const std::vector<double> bounds_;
+  // observations of each bucket alone, bounds_.size() + 1 of them
+  std::unique_ptr<std::atomic<uint64_t>[]> bucket_counts_;
+  std::atomic<uint64_t> count_{0};
+  std::atomic<double> sum_{0.};
+};
+
+// Bucket bounds for latencies in milliseconds, from 1 ms to about a minute.
+const std::vector<double>& latency_ms_buckets();
+
+// A value read by a collector when the metrics are rendered.
+struct Sample {
+  std::string name;
+  std::string help;
+  // "gauge" or "counter"
+  std::string type;
+  Labels labels;
+  double value;
+};
+
+class Registry {
+ public:
+  using Collector = std::function<void(std::vector<Sample>&)>;
+
+  static Registry& instance();
+
+  // The counter of `name` and `labels`, created on first use. The reference stays valid
+  // for the life of the process.
+  Counter& counter(const std::string& name,
+                   const std::string& help,
+                   const Labels& labels = {});
+
+  Histogram& histogram(const std::string& name,
+                       const std::string& help,
+                       const std::vector<double>& bounds,
+                       const Labels& labels = {});
+
+  // Returns an id for removeCollector, which has to be called before anything the
+  // collector refers to goes away.
+  int addCollector(Collector collector);
+
+  void removeCollector(const int collector_id);
+
+  // All the metrics in the Prometheus text exposition format, version 0.0.4.
+  std::string render() const;
+
+ private:
+  Registry() = default;
+
+  struct Family {
+    std::string help;
+    std::string type;
+    std::map<Labels, std::unique_ptr<Counter>> counters;
+    std::map<Labels, std::unique_ptr<Histogram>> histograms;
+  };
+
+  Family& getFamily(const std::string& name,
+                    const std::string& help,
+                    const std::string& type);
+
+  mutable std::mutex mutex_;  // guards families_
+  std::map<std::string, Family> families_;
+  // held while the collectors run, so that none is removed meanwhile
+  mutable std::mutex collectors_mutex_;
+  std::map<int, Collector> collectors_;
+  int next_collector_id_{0};
+};
+
+}  // namespace metrics
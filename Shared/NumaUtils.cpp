@@ -0,0 +1,112 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/NumaUtils.h"
+
+#include "Logger/Logger.h"
+
+#include <algorithm>
+
+#ifdef HAVE_NUMA
+#include <numa.h>
+#include <numaif.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+bool g_enable_numa_aware_buffer_pool{false};
+
+namespace numa {
+
+size_t get_num_nodes() {
+#ifdef HAVE_NUMA
+  static const size_t num_nodes = [] {
+    if (numa_available() < 0) {
+      return size_t(1);
+    }
+    return static_cast<size_t>(std::max(numa_num_configured_nodes(), 1));
+  }();
+  return g_enable_numa_aware_buffer_pool ? num_nodes : 1;
+#else
+  return 1;
+#endif
+}
+
+int get_node_for_fragment(const int fragment_id) {
+  const auto num_nodes = get_num_nodes();
+  if (num_nodes <= 1 || fragment_id < 0) {
+    return -1;
+  }
+  return fragment_id % num_nodes;
+}
+
+int get_current_node() {
+#ifdef HAVE_NUMA
+  if (get_num_nodes() <= 1) {
+    return -1;
+  }
+  const auto cpu = sched_getcpu();
+  return cpu < 0 ? -1 : numa_node_of_cpu(cpu);
+#else
+  return -1;
+#endif
+}
+
+bool bind_memory_to_node(void* ptr, const size_t num_bytes, const int node) {
+#ifdef HAVE_NUMA
+  if (node < 0 || get_num_nodes() <= 1) {
+    return false;
+  }
+  // mbind works on whole pages, only bind the pages entirely inside the range
+  const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto begin = (reinterpret_cast<uintptr_t>(ptr) + page_size - 1) & ~(page_size - 1);
+  const auto end = (reinterpret_cast<uintptr_t>(ptr) + num_bytes) & ~(page_size - 1);
+  if (end <= begin) {
+    return false;
+  }
+  unsigned long node_mask = 1UL << node;
+  if (mbind(reinterpret_cast<void*>(begin),
+            end - begin,
+            MPOL_PREFERRED,
+            &node_mask,
+            sizeof(node_mask) * 8,
+            MPOL_MF_MOVE) != 0) {
+    LOG(WARNING) << "Failed to bind " << num_bytes << " bytes to NUMA node " << node;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+ScopedThreadNodeBinding::ScopedThreadNodeBinding(const int node) : bound_(false) {
+#ifdef HAVE_NUMA
+  if (node >= 0 && get_num_nodes() > 1) {
+    bound_ = numa_run_on_node(node) == 0;
+  }
+#endif
+}
+
+ScopedThreadNodeBinding::~ScopedThreadNodeBinding() {
+#ifdef HAVE_NUMA
+  if (bound_) {
+    numa_run_on_node(-1);
+  }
+#endif
+}
+
+}  // namespace numa
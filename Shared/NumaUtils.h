@@ -0,0 +1,60 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file		NumaUtils.h
+ * @brief		Helpers for homing CPU buffer pool slabs and execution kernels on NUMA
+ *          nodes. All helpers degrade to no-ops when the build has no libnuma support,
+ *          the host has a single node, or the feature is disabled.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+extern bool g_enable_numa_aware_buffer_pool;
+
+namespace numa {
+
+/// Number of NUMA nodes used for placement, 1 when NUMA placement is disabled.
+size_t get_num_nodes();
+
+/// Node owning the chunks of the given fragment, or -1 when NUMA placement is disabled.
+int get_node_for_fragment(const int fragment_id);
+
+/// Node of the CPU the calling thread runs on, or -1 when NUMA placement is disabled.
+int get_current_node();
+
+/// Sets the preferred node of a not yet touched memory range. Returns false on failure.
+bool bind_memory_to_node(void* ptr, const size_t num_bytes, const int node);
+
+/**
+ * Restricts the calling thread to the CPUs of a NUMA node for the lifetime of the
+ * object, and lets it run anywhere again on destruction. A negative node is a no-op.
+ */
+class ScopedThreadNodeBinding {
+ public:
+  ScopedThreadNodeBinding(const int node);
+  ~ScopedThreadNodeBinding();
+
+  ScopedThreadNodeBinding(const ScopedThreadNodeBinding&) = delete;
+  ScopedThreadNodeBinding& operator=(const ScopedThreadNodeBinding&) = delete;
+
+ private:
+  bool bound_;
+};
+
+}  // namespace numa
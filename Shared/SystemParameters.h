@@ -31,6 +31,7 @@ struct SystemParameters {
   size_t calcite_max_mem = 1024;    // max memory for calcite jvm in MB
   int omnisci_server_port = 6274;   // default port omnisci_server runs on
   int calcite_port = 6279;          // default port for calcite server to run on
+  size_t calcite_servers = 1;       // calcite servers planning queries concurrently
   std::string ha_group_id;          // name of the HA group this server is in
   std::string ha_unique_server_id;  // name of the HA unique id for this server
   std::string ha_brokers;           // name of the HA broker
@@ -66,7 +67,10 @@ struct SystemParameters {
   size_t calcite_timeout =
       5000;  // calcite send/receive timeout (connect timeout hard coded to 2s)
   size_t calcite_keepalive = false;  // calcite keepalive connection
+  size_t calcite_plan_cache_size = 0;  // plans cached in front of calcite, 0 disables
   int num_executors = 1;
+  size_t dispatch_interactive_share =
+      4;  // interactive queries dispatched for every batch query when both are queued
 
   SystemParameters() : cuda_block_size(0), cuda_grid_size(0), calcite_max_mem(1024) {}
 };
@@ -23,6 +23,7 @@
 #include <type_traits>
 
 #include "Logger/Logger.h"
+#include "Logger/PerfCounters.h"
 
 extern bool g_enable_debug_timer;
 
@@ -71,6 +72,8 @@ struct InjectTimer {
       : description_(description), lineNum_(lineNum), func_(func) {
     if (g_enable_debug_timer) {
       start_ = timer_start();
+      has_perf_counters_ =
+          g_enable_perf_counters && logger::read_thread_perf_counters(perf_counters_);
       LOG(INFO) << "Timer start " << std::setfill(' ') << std::setw(35) << description_
                 << " " << std::setw(35) << func_ << ":" << std::setw(5) << lineNum_;
     }
@@ -78,9 +81,14 @@ struct InjectTimer {
 
   ~InjectTimer() {
     if (g_enable_debug_timer) {
+      std::ostringstream perf_counters;
+      logger::PerfCounterValues stop_counters;
+      if (has_perf_counters_ && logger::read_thread_perf_counters(stop_counters)) {
+        perf_counters << " " << stop_counters - perf_counters_;
+      }
       LOG(INFO) << "Timer end   " << std::setfill(' ') << std::setw(35) << description_
                 << " " << std::setw(35) << func_ << ":" << std::setw(5) << lineNum_
-                << " elapsed " << timer_stop(start_) << " ms";
+                << " elapsed " << timer_stop(start_) << " ms" << perf_counters.str();
     }
   }
 
@@ -89,6 +97,8 @@ struct InjectTimer {
   std::string func_;
 
   std::chrono::steady_clock::time_point start_;
+  bool has_perf_counters_{false};
+  logger::PerfCounterValues perf_counters_;
 };
 #define INJECT_TIMER(DESC) InjectTimer DESC(#DESC, __LINE__, __FUNCTION__)
 
@@ -76,7 +76,8 @@ enum SQLAgg {
   kCOUNT,
   kAPPROX_COUNT_DISTINCT,
   kSAMPLE,
-  kSINGLE_VALUE
+  kSINGLE_VALUE,
+  kAPPROX_QUANTILE
 };
 
 enum class SqlWindowFunctionKind {
@@ -129,6 +130,8 @@ inline std::string toString(const SQLAgg& kind) {
       return "SAMPLE";
     case kSINGLE_VALUE:
       return "SINGLE_VALUE";
+    case kAPPROX_QUANTILE:
+      return "APPROX_QUANTILE";
   }
   LOG(FATAL) << "Invalid aggregate kind: " << kind;
   return "";
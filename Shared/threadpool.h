@@ -20,9 +20,16 @@
 #include "tbb/task_group.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <future>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 namespace threadpool {
 
@@ -72,6 +79,81 @@ class FuturesThreadPool<T, std::enable_if_t<std::is_object<T>::value>>
   }
 };
 
+/**
+ * Fixed size pool of worker threads, each owning a deque of tasks. Tasks are distributed
+ * round robin over the deques as they are spawned. A worker pops tasks from the front of
+ * its own deque and, once that is drained, steals from the back of the other workers'
+ * deques, so a few long running tasks do not leave the remaining workers idle. Spawning
+ * tasks in decreasing order of cost gives the best balance.
+ */
+template <typename T, typename ENABLE = void>
+class WorkStealingThreadPool {
+ public:
+  WorkStealingThreadPool(const size_t num_workers = std::thread::hardware_concurrency())
+      : queues_(std::max(num_workers, size_t(1))) {}
+
+  template <class Function, class... Args>
+  void spawn(Function&& f, Args&&... args) {
+    auto& queue = queues_[num_tasks_++ % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.emplace_back([f, args...] { f(args...); });
+  }
+
+  void join() {
+    std::vector<std::future<void>> workers;
+    const size_t num_workers = std::min(queues_.size(), num_tasks_);
+    for (size_t worker_idx = 0; worker_idx < num_workers; ++worker_idx) {
+      workers.push_back(std::async(
+          std::launch::async, &WorkStealingThreadPool::work, this, worker_idx));
+    }
+    for (auto& worker : workers) {
+      worker.wait();
+    }
+    for (auto& worker : workers) {
+      worker.get();
+    }
+    num_tasks_ = 0;
+  }
+
+ private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool popOrSteal(const size_t worker_idx, std::function<void()>& task) {
+    {
+      auto& own_queue = queues_[worker_idx];
+      std::lock_guard<std::mutex> lock(own_queue.mutex);
+      if (!own_queue.tasks.empty()) {
+        task = std::move(own_queue.tasks.front());
+        own_queue.tasks.pop_front();
+        return true;
+      }
+    }
+    for (size_t i = 1; i < queues_.size(); ++i) {
+      auto& victim_queue = queues_[(worker_idx + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(victim_queue.mutex);
+      if (!victim_queue.tasks.empty()) {
+        task = std::move(victim_queue.tasks.back());
+        victim_queue.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(const size_t worker_idx) {
+    std::function<void()> task;
+    while (popOrSteal(worker_idx, task)) {
+      task();
+    }
+  }
+
+  std::vector<TaskQueue> queues_;
+  size_t num_tasks_{0};
+};
+
 #ifdef HAVE_TBB
 
 class TbbThreadPoolBase {
@@ -34,9 +34,12 @@
 
 #include "Logger/Logger.h"
 #include "OSDependent/omnisci_fs.h"
+#include "Shared/LockContention.h"
+#include "Shared/scope.h"
 #include "Shared/sqltypes.h"
 #include "Shared/thread_count.h"
 #include "StringDictionaryClient.h"
+#include "StringTrigramIndex.h"
 #include "Utils/Regexp.h"
 #include "Utils/StringLike.h"
 
@@ -48,6 +51,15 @@ namespace {
 
 const int SYSTEM_PAGE_SIZE = omnisci::get_page_size();
 
+// The dictionaries are profiled as one lock class.
+lock_contention::LockProfile& rw_mutex_profile() {
+  static auto& profile = lock_contention::get_profile("string_dictionary");
+  return profile;
+}
+
+using DictReadLock = lock_contention::ProfiledLock<mapd_shared_lock<mapd_shared_mutex>>;
+using DictWriteLock = lock_contention::ProfiledLock<mapd_unique_lock<mapd_shared_mutex>>;
+
 int checked_open(const char* path, const bool recover) {
   auto fd = omnisci::open(path, O_RDWR | O_CREAT | (recover ? O_APPEND : O_TRUNC), 0644);
   if (fd > 0) {
@@ -88,6 +100,9 @@ uint32_t rk_hash(const std::string_view& str) {
 }  // namespace
 
 bool g_enable_stringdict_parallel{false};
+bool g_enable_stringdict_trigram_index{false};
+bool g_enable_stringdict_lazy_load{false};
+size_t g_stringdict_remote_cache_entries{0};
 constexpr int32_t StringDictionary::INVALID_STR_ID;
 constexpr size_t StringDictionary::MAX_STRLEN;
 constexpr size_t StringDictionary::MAX_STRCOUNT;
@@ -121,10 +136,16 @@ StringDictionary::StringDictionary(const std::string& folder,
     offsets_path_ = (storage_path / boost::filesystem::path("DictOffsets")).string();
     const auto payload_path =
         (storage_path / boost::filesystem::path("DictPayload")).string();
+    hash_table_path_ = (storage_path / boost::filesystem::path("DictHashTable")).string();
     payload_fd_ = checked_open(payload_path.c_str(), recover);
     offset_fd_ = checked_open(offsets_path_.c_str(), recover);
     payload_file_size_ = omnisci::file_size(payload_fd_);
     offset_file_size_ = omnisci::file_size(offset_fd_);
+    if (!recover) {
+      // the table persisted for the truncated storage
+      boost::system::error_code ec;
+      boost::filesystem::remove(hash_table_path_, ec);
+    }
   }
   bool storage_is_empty = false;
   if (payload_file_size_ == 0) {
@@ -146,66 +167,82 @@ StringDictionary::StringDictionary(const std::string& folder,
       }
       const uint64_t str_count =
           storage_is_empty ? 0 : getNumStringsFromStorage(bytes / sizeof(StringIdxEntry));
-      collisions_ = 0;
-      // at this point we know the size of the StringDict we need to load
-      // so lets reallocate the vector to the correct size
-      const uint64_t max_entries =
-          std::max(round_up_p2(str_count * 2 + 1),
-                   round_up_p2(std::max(initial_capacity, static_cast<size_t>(1))));
-      std::vector<int32_t> new_str_ids(max_entries, INVALID_STR_ID);
-      string_id_hash_table_.swap(new_str_ids);
-      if (materialize_hashes_) {
-        std::vector<uint32_t> new_rk_hashes(max_entries / 2);
-        rk_hashes_.swap(new_rk_hashes);
-      }
-      // Bail early if we know we don't have strings to add (i.e. a new or empty
-      // dictionary)
-      if (str_count == 0) {
+      if (g_enable_stringdict_lazy_load && str_count > 0) {
+        // the strings are read from the mapped storage, the hash table is only needed
+        // to look them up and is loaded by the first lookup
+        const auto last_str_meta = offset_map_ + str_count - 1;
+        str_count_ = str_count;
+        payload_file_off_ = last_str_meta->off + last_str_meta->size;
+        initial_capacity_ = initial_capacity;
+        hash_table_loaded_ = false;
         return;
       }
+      DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
+      buildHashTableFromStorage(str_count, initial_capacity);
+    }
+  }
+}
 
-      unsigned string_id = 0;
-      mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-
-      uint32_t thread_inits = 0;
-      const auto thread_count = std::thread::hardware_concurrency();
-      const uint32_t items_per_thread = std::max<uint32_t>(
-          2000, std::min<uint32_t>(200000, (str_count / thread_count) + 1));
-      std::vector<std::future<std::vector<std::pair<uint32_t, unsigned int>>>>
-          dictionary_futures;
-      for (string_id = 0; string_id < str_count; string_id += items_per_thread) {
-        dictionary_futures.emplace_back(std::async(
-            std::launch::async, [string_id, str_count, items_per_thread, this] {
-              std::vector<std::pair<uint32_t, unsigned int>> hashVec;
-              for (uint32_t curr_id = string_id;
-                   curr_id < string_id + items_per_thread && curr_id < str_count;
-                   curr_id++) {
-                const auto recovered = getStringFromStorage(curr_id);
-                if (recovered.canary) {
-                  // hit the canary, recovery finished
-                  break;
-                } else {
-                  std::string temp(recovered.c_str_ptr, recovered.size);
-                  hashVec.emplace_back(std::make_pair(rk_hash(temp), temp.size()));
-                }
-              }
-              return hashVec;
-            }));
-        thread_inits++;
-        if (thread_inits % thread_count == 0) {
-          processDictionaryFutures(dictionary_futures);
-        }
-      }
-      // gather last few threads
-      if (dictionary_futures.size() != 0) {
-        processDictionaryFutures(dictionary_futures);
-      }
-      VLOG(1) << "Opened string dictionary " << folder << " # Strings: " << str_count_
-              << " Hash table size: " << string_id_hash_table_.size() << " Fill rate: "
-              << static_cast<double>(str_count_) * 100.0 / string_id_hash_table_.size()
-              << "% Collisions: " << collisions_;
+void StringDictionary::buildHashTableFromStorage(const size_t str_count,
+                                                 const size_t initial_capacity) {
+  str_count_ = 0;
+  payload_file_off_ = 0;
+  collisions_ = 0;
+  // at this point we know the size of the StringDict we need to load
+  // so lets reallocate the vector to the correct size
+  const uint64_t max_entries =
+      std::max(round_up_p2(str_count * 2 + 1),
+               round_up_p2(std::max(initial_capacity, static_cast<size_t>(1))));
+  std::vector<int32_t> new_str_ids(max_entries, INVALID_STR_ID);
+  string_id_hash_table_.swap(new_str_ids);
+  if (materialize_hashes_) {
+    std::vector<uint32_t> new_rk_hashes(max_entries / 2);
+    rk_hashes_.swap(new_rk_hashes);
+  }
+  // Bail early if we know we don't have strings to add (i.e. a new or empty
+  // dictionary)
+  if (str_count == 0) {
+    return;
+  }
+
+  unsigned string_id = 0;
+  uint32_t thread_inits = 0;
+  const auto thread_count = std::thread::hardware_concurrency();
+  const uint32_t items_per_thread = std::max<uint32_t>(
+      2000, std::min<uint32_t>(200000, (str_count / thread_count) + 1));
+  std::vector<std::future<std::vector<std::pair<uint32_t, unsigned int>>>>
+      dictionary_futures;
+  for (string_id = 0; string_id < str_count; string_id += items_per_thread) {
+    dictionary_futures.emplace_back(std::async(
+        std::launch::async, [string_id, str_count, items_per_thread, this] {
+          std::vector<std::pair<uint32_t, unsigned int>> hashVec;
+          for (uint32_t curr_id = string_id;
+               curr_id < string_id + items_per_thread && curr_id < str_count;
+               curr_id++) {
+            const auto recovered = getStringFromStorage(curr_id);
+            if (recovered.canary) {
+              // hit the canary, recovery finished
+              break;
+            } else {
+              std::string temp(recovered.c_str_ptr, recovered.size);
+              hashVec.emplace_back(std::make_pair(rk_hash(temp), temp.size()));
+            }
+          }
+          return hashVec;
+        }));
+    thread_inits++;
+    if (thread_inits % thread_count == 0) {
+      processDictionaryFutures(dictionary_futures);
     }
   }
+  // gather last few threads
+  if (dictionary_futures.size() != 0) {
+    processDictionaryFutures(dictionary_futures);
+  }
+  VLOG(1) << "Opened string dictionary " << offsets_path_ << " # Strings: " << str_count_
+          << " Hash table size: " << string_id_hash_table_.size() << " Fill rate: "
+          << static_cast<double>(str_count_) * 100.0 / string_id_hash_table_.size()
+          << "% Collisions: " << collisions_;
 }
 
 void StringDictionary::processDictionaryFutures(
@@ -260,7 +297,14 @@ size_t StringDictionary::getNumStringsFromStorage(const size_t storage_slots) co
 StringDictionary::StringDictionary(const LeafHostInfo& host, const DictRef dict_ref)
     : strings_cache_(nullptr)
     , client_(new StringDictionaryClient(host, dict_ref, true))
-    , client_no_timeout_(new StringDictionaryClient(host, dict_ref, false)) {}
+    , client_no_timeout_(new StringDictionaryClient(host, dict_ref, false)) {
+  if (g_stringdict_remote_cache_entries) {
+    remote_strings_cache_ = std::make_unique<LruCache<int32_t, std::string>>(
+        g_stringdict_remote_cache_entries);
+    remote_ids_cache_ = std::make_unique<LruCache<std::string, int32_t>>(
+        g_stringdict_remote_cache_entries);
+  }
+}
 
 StringDictionary::~StringDictionary() noexcept {
   free(CANARY_BUFFER);
@@ -286,9 +330,13 @@ StringDictionary::~StringDictionary() noexcept {
 
 int32_t StringDictionary::getOrAdd(const std::string& str) noexcept {
   if (client_) {
+    if (const auto cached_id = getRemoteCachedId(str)) {
+      return *cached_id;
+    }
     std::vector<int32_t> string_ids;
     client_->get_or_add_bulk(string_ids, std::vector<std::string>{str});
     CHECK_EQ(size_t(1), string_ids.size());
+    putRemoteCached(string_ids.front(), str);
     return string_ids.front();
   }
   return getOrAddImpl(str);
@@ -343,6 +391,60 @@ void StringDictionary::hashStrings(const std::vector<String>& string_vec,
                     });
 }
 
+/**
+ * Looks the input strings up under the read lock, which the concurrent loaders of the
+ * dictionary share, and fills in the ids of the strings it already holds and the nulls.
+ * Only the strings it returns, by index, are missing and need the write lock.
+ */
+template <class T, class String>
+std::vector<size_t> StringDictionary::getBulkExisting(
+    const std::vector<String>& input_strings,
+    const std::vector<uint32_t>& input_strings_rk_hashes,
+    T* output_string_ids,
+    const bool parallel) const noexcept {
+  CHECK_EQ(input_strings.size(), input_strings_rk_hashes.size());
+  std::vector<int8_t> is_missing(input_strings.size(), 0);
+  auto lookup = [&](const size_t begin, const size_t end) {
+    for (size_t input_string_idx = begin; input_string_idx < end; ++input_string_idx) {
+      const auto& input_string = input_strings[input_string_idx];
+      // Currently we make empty strings null
+      if (input_string.empty()) {
+        output_string_ids[input_string_idx] = inline_int_null_value<T>();
+        continue;
+      }
+      // TODO: Recover gracefully if an input string is too long
+      CHECK(input_string.size() <= MAX_STRLEN);
+      const auto bucket = computeBucket(input_strings_rk_hashes[input_string_idx],
+                                        input_string,
+                                        string_id_hash_table_);
+      if (string_id_hash_table_[bucket] != INVALID_STR_ID) {
+        output_string_ids[input_string_idx] = string_id_hash_table_[bucket];
+      } else {
+        is_missing[input_string_idx] = 1;
+      }
+    }
+  };
+  {
+    DictReadLock read_lock(rw_mutex_, rw_mutex_profile());
+    if (parallel) {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, input_strings.size()),
+                        [&lookup](const tbb::blocked_range<size_t>& r) {
+                          lookup(r.begin(), r.end());
+                        });
+    } else {
+      lookup(0, input_strings.size());
+    }
+  }
+  std::vector<size_t> missing_string_idxs;
+  for (size_t input_string_idx = 0; input_string_idx < is_missing.size();
+       ++input_string_idx) {
+    if (is_missing[input_string_idx]) {
+      missing_string_idxs.push_back(input_string_idx);
+    }
+  }
+  return missing_string_idxs;
+}
+
 template <class T, class String>
 void StringDictionary::getOrAddBulk(const std::vector<String>& input_strings,
                                     T* output_string_ids) {
@@ -355,49 +457,57 @@ void StringDictionary::getOrAddBulk(const std::vector<String>& input_strings,
     getOrAddBulkRemote(input_strings, output_string_ids);
     return;
   }
-  size_t out_idx{0};
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-
-  for (const auto& str : input_strings) {
-    if (str.empty()) {
-      output_string_ids[out_idx++] = inline_int_null_value<T>();
-      continue;
+  loadHashTable();
+  std::vector<uint32_t> input_strings_rk_hashes(input_strings.size());
+  for (size_t input_string_idx = 0; input_string_idx < input_strings.size();
+       ++input_string_idx) {
+    const auto& str = input_strings[input_string_idx];
+    if (!str.empty()) {
+      CHECK(str.size() <= MAX_STRLEN);
+      input_strings_rk_hashes[input_string_idx] = rk_hash(str);
     }
-    CHECK(str.size() <= MAX_STRLEN);
-    uint32_t bucket;
-    const uint32_t hash = rk_hash(str);
-    bucket = computeBucket(hash, str, string_id_hash_table_);
+  }
+  const auto missing_string_idxs = getBulkExisting(
+      input_strings, input_strings_rk_hashes, output_string_ids, false);
+  if (missing_string_idxs.empty()) {
+    return;
+  }
+  DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
+
+  for (const auto out_idx : missing_string_idxs) {
+    const auto& str = input_strings[out_idx];
+    const uint32_t hash = input_strings_rk_hashes[out_idx];
+    // another loader may have added it since the lookup
+    uint32_t bucket = computeBucket(hash, str, string_id_hash_table_);
     if (string_id_hash_table_[bucket] != INVALID_STR_ID) {
-      output_string_ids[out_idx++] = string_id_hash_table_[bucket];
+      output_string_ids[out_idx] = string_id_hash_table_[bucket];
       continue;
     }
     // need to add record to dictionary
     // check there is room
     if (str_count_ == static_cast<size_t>(max_valid_int_value<T>())) {
       log_encoding_error<T>(str);
-      output_string_ids[out_idx++] = inline_int_null_value<T>();
+      output_string_ids[out_idx] = inline_int_null_value<T>();
       continue;
     }
-    if (string_id_hash_table_[bucket] == INVALID_STR_ID) {
-      CHECK_LT(str_count_, MAX_STRCOUNT)
-          << "Maximum number (" << str_count_
-          << ") of Dictionary encoded Strings reached for this column, offset path "
-             "for column is  "
-          << offsets_path_;
-      if (fillRateIsHigh(str_count_)) {
-        // resize when more than 50% is full
-        increaseCapacity();
-        bucket = computeBucket(hash, str, string_id_hash_table_);
-      }
-      appendToStorage(str);
+    CHECK_LT(str_count_, MAX_STRCOUNT)
+        << "Maximum number (" << str_count_
+        << ") of Dictionary encoded Strings reached for this column, offset path "
+           "for column is  "
+        << offsets_path_;
+    if (fillRateIsHigh(str_count_)) {
+      // resize when more than 50% is full
+      increaseCapacity();
+      bucket = computeBucket(hash, str, string_id_hash_table_);
+    }
+    appendToStorage(str);
 
-      string_id_hash_table_[bucket] = static_cast<int32_t>(str_count_);
-      if (materialize_hashes_) {
-        rk_hashes_[str_count_] = hash;
-      }
-      ++str_count_;
+    string_id_hash_table_[bucket] = static_cast<int32_t>(str_count_);
+    if (materialize_hashes_) {
+      rk_hashes_[str_count_] = hash;
     }
-    output_string_ids[out_idx++] = string_id_hash_table_[bucket];
+    ++str_count_;
+    output_string_ids[out_idx] = string_id_hash_table_[bucket];
   }
   invalidateInvertedIndex();
 }
@@ -409,28 +519,26 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
     getOrAddBulkRemote(input_strings, output_string_ids);
     return;
   }
+  loadHashTable();
   // Run rk_hash on the input strings up front, and in parallel,
   // as the string hashing does not need to be behind the subsequent write_lock
   std::vector<uint32_t> input_strings_rk_hashes(input_strings.size());
   hashStrings(input_strings, input_strings_rk_hashes);
+  const auto missing_string_idxs = getBulkExisting(
+      input_strings, input_strings_rk_hashes, output_string_ids, true);
+  if (missing_string_idxs.empty()) {
+    return;
+  }
 
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
   size_t shadow_str_count =
       str_count_;  // Need to shadow str_count_ now with bulk add methods
   const size_t storage_high_water_mark = shadow_str_count;
   std::vector<size_t> string_memory_ids;
   size_t sum_new_string_lengths = 0;
-  string_memory_ids.reserve(input_strings.size());
-  size_t input_string_idx{0};
-  for (const auto& input_string : input_strings) {
-    // Currently we make empty strings null
-    if (input_string.empty()) {
-      output_string_ids[input_string_idx++] = inline_int_null_value<T>();
-      continue;
-    }
-    // TODO: Recover gracefully if an input string is too long
-    CHECK(input_string.size() <= MAX_STRLEN);
-
+  string_memory_ids.reserve(missing_string_idxs.size());
+  for (const auto input_string_idx : missing_string_idxs) {
+    const auto& input_string = input_strings[input_string_idx];
     if (fillRateIsHigh(shadow_str_count)) {
       // resize when more than 50% is full
       increaseCapacityFromStorageAndMemory(storage_high_water_mark,
@@ -450,16 +558,17 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
 
     // If the hash bucket is not empty, that is our string id
     // (computeBucketFromStorageAndMemory) already checked to ensure the input string and
-    // bucket string are equal)
+    // bucket string are equal). Another loader may have added it since the lookup, or it
+    // is repeated in the input.
     if (string_id_hash_table_[hash_bucket] != INVALID_STR_ID) {
-      output_string_ids[input_string_idx++] = string_id_hash_table_[hash_bucket];
+      output_string_ids[input_string_idx] = string_id_hash_table_[hash_bucket];
       continue;
     }
     // Did not find string, so need to add record to dictionary
     // First check there is room
     if (shadow_str_count == static_cast<size_t>(max_valid_int_value<T>())) {
       log_encoding_error<T>(input_string);
-      output_string_ids[input_string_idx++] = inline_int_null_value<T>();
+      output_string_ids[input_string_idx] = inline_int_null_value<T>();
       continue;
     }
     CHECK_LT(shadow_str_count, MAX_STRCOUNT)
@@ -474,7 +583,7 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
     if (materialize_hashes_) {
       rk_hashes_[shadow_str_count] = input_string_rk_hash;
     }
-    output_string_ids[input_string_idx++] = shadow_str_count++;
+    output_string_ids[input_string_idx] = shadow_str_count++;
   }
   appendToStorageBulk(input_strings, string_memory_ids, sum_new_string_lengths);
   str_count_ = shadow_str_count;
@@ -503,7 +612,31 @@ void StringDictionary::getOrAddBulkRemote(const std::vector<String>& string_vec,
                                           T* encoded_vec) {
   CHECK(client_no_timeout_);
   std::vector<int32_t> string_ids;
-  client_no_timeout_->get_or_add_bulk(string_ids, string_vec);
+  if (remote_ids_cache_) {
+    // only the strings which aren't cached go to the server, in a single request
+    string_ids.resize(string_vec.size());
+    std::vector<String> missing_strings;
+    std::vector<size_t> missing_string_idxs;
+    for (size_t i = 0; i < string_vec.size(); ++i) {
+      if (const auto cached_id = getRemoteCachedId(std::string(string_vec[i]))) {
+        string_ids[i] = *cached_id;
+      } else {
+        missing_strings.push_back(string_vec[i]);
+        missing_string_idxs.push_back(i);
+      }
+    }
+    if (!missing_strings.empty()) {
+      std::vector<int32_t> missing_string_ids;
+      client_no_timeout_->get_or_add_bulk(missing_string_ids, missing_strings);
+      CHECK_EQ(missing_strings.size(), missing_string_ids.size());
+      for (size_t i = 0; i < missing_strings.size(); ++i) {
+        string_ids[missing_string_idxs[i]] = missing_string_ids[i];
+        putRemoteCached(missing_string_ids[i], std::string(missing_strings[i]));
+      }
+    }
+  } else {
+    client_no_timeout_->get_or_add_bulk(string_ids, string_vec);
+  }
   size_t out_idx{0};
   for (size_t i = 0; i < string_ids.size(); ++i) {
     const auto string_id = string_ids[i];
@@ -540,10 +673,18 @@ template void StringDictionary::getOrAddBulkRemote(
     int32_t* encoded_vec);
 
 int32_t StringDictionary::getIdOfString(const std::string& str) const {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   if (client_) {
-    return client_->get(str);
-  }
+    if (const auto cached_id = getRemoteCachedId(str)) {
+      return *cached_id;
+    }
+    DictReadLock read_lock(rw_mutex_, rw_mutex_profile());
+    const auto string_id = client_->get(str);
+    putRemoteCached(string_id, str);
+    return string_id;
+  }
+  // the hash table is a cache of the storage, not part of the state of the dictionary
+  const_cast<StringDictionary*>(this)->loadHashTable();
+  DictReadLock read_lock(rw_mutex_, rw_mutex_profile());
   return getUnlocked(str);
 }
 
@@ -554,15 +695,49 @@ int32_t StringDictionary::getUnlocked(const std::string& str) const noexcept {
 }
 
 std::string StringDictionary::getString(int32_t string_id) const {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  DictReadLock read_lock(rw_mutex_, rw_mutex_profile());
   if (client_) {
+    if (auto cached_str = getRemoteCachedString(string_id)) {
+      return std::move(*cached_str);
+    }
     std::string ret;
     client_->get_string(ret, string_id);
+    putRemoteCached(string_id, ret);
     return ret;
   }
   return getStringUnlocked(string_id);
 }
 
+std::optional<int32_t> StringDictionary::getRemoteCachedId(const std::string& str) const {
+  if (!remote_ids_cache_) {
+    return std::nullopt;
+  }
+  std::lock_guard<std::mutex> remote_cache_lock(remote_cache_mutex_);
+  const auto string_id = remote_ids_cache_->get(str);
+  return string_id ? std::make_optional(*string_id) : std::nullopt;
+}
+
+std::optional<std::string> StringDictionary::getRemoteCachedString(
+    const int32_t string_id) const {
+  if (!remote_strings_cache_) {
+    return std::nullopt;
+  }
+  std::lock_guard<std::mutex> remote_cache_lock(remote_cache_mutex_);
+  const auto str = remote_strings_cache_->get(string_id);
+  return str ? std::make_optional(*str) : std::nullopt;
+}
+
+void StringDictionary::putRemoteCached(const int32_t string_id,
+                                       const std::string& str) const {
+  // the strings which aren't in the dictionary may be added later, and nulls
+  if (!remote_ids_cache_ || string_id < 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> remote_cache_lock(remote_cache_mutex_);
+  remote_ids_cache_->put(str, string_id);
+  remote_strings_cache_->put(string_id, str);
+}
+
 std::string StringDictionary::getStringUnlocked(int32_t string_id) const noexcept {
   CHECK_LT(string_id, static_cast<int32_t>(str_count_));
   return getStringChecked(string_id);
@@ -570,7 +745,7 @@ std::string StringDictionary::getStringUnlocked(int32_t string_id) const noexcep
 
 std::pair<char*, size_t> StringDictionary::getStringBytes(int32_t string_id) const
     noexcept {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  DictReadLock read_lock(rw_mutex_, rw_mutex_profile());
   CHECK(!client_);
   CHECK_LE(0, string_id);
   CHECK_LT(string_id, static_cast<int32_t>(str_count_));
@@ -578,13 +753,32 @@ std::pair<char*, size_t> StringDictionary::getStringBytes(int32_t string_id) con
 }
 
 size_t StringDictionary::storageEntryCount() const {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  DictReadLock read_lock(rw_mutex_, rw_mutex_profile());
   if (client_) {
     return client_->storage_entry_count();
   }
   return str_count_;
 }
 
+void StringDictionary::visitStorage(
+    const size_t str_count,
+    const std::function<void(const int8_t* offsets,
+                             const size_t offsets_size,
+                             const int8_t* payload,
+                             const size_t payload_size)>& visit) const {
+  DictReadLock read_lock(rw_mutex_, rw_mutex_profile());
+  CHECK(!client_);
+  CHECK_LE(str_count, str_count_);
+  static_assert(sizeof(StringIdxEntry) == sizeof(uint64_t));
+  // the strings are appended to the payload in the order of their ids
+  const size_t payload_size =
+      str_count ? offset_map_[str_count - 1].off + offset_map_[str_count - 1].size : 0;
+  visit(reinterpret_cast<const int8_t*>(offset_map_),
+        str_count * sizeof(StringIdxEntry),
+        reinterpret_cast<const int8_t*>(payload_map_),
+        payload_size);
+}
+
 namespace {
 
 bool is_like(const std::string& str,
@@ -616,7 +810,7 @@ std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
                                                const bool is_simple,
                                                const char escape,
                                                const size_t generation) const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
   if (client_) {
     return client_->get_like(pattern, icase, is_simple, escape, generation);
   }
@@ -631,18 +825,24 @@ std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
   CHECK_GT(worker_count, 0);
   std::vector<std::vector<int32_t>> worker_results(worker_count);
   CHECK_LE(generation, str_count_);
+  // only the strings with the trigrams of the pattern can match it
+  const auto candidates = getTrigramCandidates(
+      StringTrigramIndex::getLikeLiterals(pattern, is_simple, escape), generation);
+  const size_t scan_count = candidates ? candidates->size() : generation;
   for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
     workers.emplace_back([&worker_results,
                           &pattern,
-                          generation,
+                          &candidates,
+                          scan_count,
                           icase,
                           is_simple,
                           escape,
                           worker_idx,
                           worker_count,
                           this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
+      for (size_t scan_idx = worker_idx; scan_idx < scan_count;
+           scan_idx += worker_count) {
+        const size_t string_id = candidates ? (*candidates)[scan_idx] : scan_idx;
         const auto str = getStringUnlocked(string_id);
         if (is_like(str, pattern, icase, is_simple, escape)) {
           worker_results[worker_idx].push_back(string_id);
@@ -727,7 +927,7 @@ std::vector<int32_t> StringDictionary::getEquals(std::string pattern,
 std::vector<int32_t> StringDictionary::getCompare(const std::string& pattern,
                                                   const std::string& comp_operator,
                                                   const size_t generation) {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
   if (client_) {
     return client_->get_compare(pattern, comp_operator, generation);
   }
@@ -888,7 +1088,7 @@ bool is_regexp_like(const std::string& str,
 std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
                                                      const char escape,
                                                      const size_t generation) const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
   if (client_) {
     return client_->get_regexp_like(pattern, escape, generation);
   }
@@ -903,16 +1103,21 @@ std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
   CHECK_GT(worker_count, 0);
   std::vector<std::vector<int32_t>> worker_results(worker_count);
   CHECK_LE(generation, str_count_);
+  const auto candidates = getTrigramCandidates(
+      StringTrigramIndex::getRegexpLiterals(pattern), generation);
+  const size_t scan_count = candidates ? candidates->size() : generation;
   for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
     workers.emplace_back([&worker_results,
                           &pattern,
-                          generation,
+                          &candidates,
+                          scan_count,
                           escape,
                           worker_idx,
                           worker_count,
                           this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
+      for (size_t scan_idx = worker_idx; scan_idx < scan_count;
+           scan_idx += worker_count) {
+        const size_t string_id = candidates ? (*candidates)[scan_idx] : scan_idx;
         const auto str = getStringUnlocked(string_id);
         if (is_regexp_like(str, pattern, escape)) {
           worker_results[worker_idx].push_back(string_id);
@@ -933,7 +1138,7 @@ std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
 }
 
 std::shared_ptr<const std::vector<std::string>> StringDictionary::copyStrings() const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
   if (client_) {
     // TODO(miyu): support remote string dictionary
     throw std::runtime_error(
@@ -1050,16 +1255,17 @@ int32_t StringDictionary::getOrAddImpl(const std::string& str) noexcept {
     return inline_int_null_value<int32_t>();
   }
   CHECK(str.size() <= MAX_STRLEN);
+  loadHashTable();
   uint32_t bucket;
   const uint32_t hash = rk_hash(str);
   {
-    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    DictReadLock read_lock(rw_mutex_, rw_mutex_profile());
     bucket = computeBucket(hash, str, string_id_hash_table_);
     if (string_id_hash_table_[bucket] != INVALID_STR_ID) {
       return string_id_hash_table_[bucket];
     }
   }
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
   // need to recalculate the bucket in case it changed before
   // we got the lock
   bucket = computeBucket(hash, str, string_id_hash_table_);
@@ -1364,6 +1570,21 @@ void StringDictionary::invalidateInvertedIndex() noexcept {
   compare_cache_.invalidateInvertedIndex();
 }
 
+std::optional<std::vector<int32_t>> StringDictionary::getTrigramCandidates(
+    const std::vector<std::string>& literals,
+    const size_t generation) const {
+  if (!g_enable_stringdict_trigram_index) {
+    return std::nullopt;
+  }
+  if (!trigram_index_) {
+    trigram_index_ = std::make_unique<StringTrigramIndex>();
+  }
+  for (size_t string_id = trigram_index_->size(); string_id < str_count_; ++string_id) {
+    trigram_index_->add(getStringFromStorageFast(string_id));
+  }
+  return trigram_index_->getCandidates(literals, generation);
+}
+
 bool StringDictionary::checkpoint() noexcept {
   if (client_) {
     try {
@@ -1380,6 +1601,127 @@ bool StringDictionary::checkpoint() noexcept {
         (omnisci::msync((void*)payload_map_, payload_file_size_, /*async=*/false) == 0);
   ret = ret && (omnisci::fsync(offset_fd_) == 0);
   ret = ret && (omnisci::fsync(payload_fd_) == 0);
+  if (ret && g_enable_stringdict_lazy_load) {
+    DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
+    if (hash_table_loaded_ && str_count_ != persisted_str_count_ && writeHashTable()) {
+      persisted_str_count_ = str_count_;
+    }
+  }
+  return ret;
+}
+
+void StringDictionary::loadHashTable() {
+  if (hash_table_loaded_) {
+    return;
+  }
+  DictWriteLock write_lock(rw_mutex_, rw_mutex_profile());
+  if (hash_table_loaded_) {
+    return;
+  }
+  if (readHashTable()) {
+    VLOG(1) << "Loaded string dictionary hash table " << hash_table_path_
+            << " # Strings: " << str_count_;
+  } else {
+    buildHashTableFromStorage(str_count_, initial_capacity_);
+    // saves rebuilding it on the next start if the dictionary isn't checkpointed
+    if (writeHashTable()) {
+      persisted_str_count_ = str_count_;
+    }
+  }
+  hash_table_loaded_ = true;
+}
+
+namespace {
+
+struct HashTableHeader {
+  uint64_t str_count;
+  uint64_t table_size;
+  uint64_t rk_hashes_size;
+};
+
+}  // namespace
+
+bool StringDictionary::readHashTable() {
+  const auto fd = omnisci::open(hash_table_path_.c_str(), O_RDONLY, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  ScopeGuard close_fd = [fd] { omnisci::close(fd); };
+  HashTableHeader header;
+  if (omnisci::pread(fd, &header, sizeof(header), 0) !=
+          static_cast<int64_t>(sizeof(header)) ||
+      header.str_count != str_count_ || header.table_size <= str_count_ ||
+      (header.table_size & (header.table_size - 1)) ||
+      (materialize_hashes_ && header.rk_hashes_size <= str_count_)) {
+    LOG(INFO) << "String dictionary hash table " << hash_table_path_
+              << " is stale, rebuilding it";
+    return false;
+  }
+  std::vector<int32_t> string_id_hash_table(header.table_size);
+  const auto table_bytes = header.table_size * sizeof(int32_t);
+  std::vector<uint32_t> rk_hashes(materialize_hashes_ ? header.rk_hashes_size : 0);
+  const auto rk_hashes_bytes = rk_hashes.size() * sizeof(uint32_t);
+  if (omnisci::pread(fd, string_id_hash_table.data(), table_bytes, sizeof(header)) !=
+          static_cast<int64_t>(table_bytes) ||
+      omnisci::pread(
+          fd, rk_hashes.data(), rk_hashes_bytes, sizeof(header) + table_bytes) !=
+          static_cast<int64_t>(rk_hashes_bytes)) {
+    LOG(WARNING) << "String dictionary hash table " << hash_table_path_
+                 << " is truncated, rebuilding it";
+    return false;
+  }
+  string_id_hash_table_.swap(string_id_hash_table);
+  if (materialize_hashes_) {
+    rk_hashes_.swap(rk_hashes);
+  }
+  collisions_ = 0;
+  // the last string must be found where the table says it is
+  const int32_t last_string_id = str_count_ - 1;
+  const auto last_string = getStringFromStorageFast(last_string_id);
+  if (string_id_hash_table_[computeBucket(
+          rk_hash(last_string), last_string, string_id_hash_table_)] != last_string_id) {
+    LOG(WARNING) << "String dictionary hash table " << hash_table_path_
+                 << " doesn't match the strings, rebuilding it";
+    return false;
+  }
+  persisted_str_count_ = str_count_;
+  return true;
+}
+
+bool StringDictionary::writeHashTable() const noexcept {
+  if (isTemp_ || hash_table_path_.empty() || str_count_ == 0) {
+    return false;
+  }
+  // written aside and renamed, the table on disk is always complete
+  const auto tmp_path = hash_table_path_ + ".tmp";
+  const auto fd = omnisci::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    LOG(WARNING) << "Could not create the string dictionary hash table " << tmp_path;
+    return false;
+  }
+  const HashTableHeader header{str_count_,
+                               string_id_hash_table_.size(),
+                               materialize_hashes_ ? rk_hashes_.size() : 0};
+  auto write_all = [fd](const void* data, const size_t size) {
+    const auto write_return = write(fd, data, size);
+    return write_return >= 0 && static_cast<size_t>(write_return) == size;
+  };
+  bool ret = write_all(&header, sizeof(header)) &&
+             write_all(string_id_hash_table_.data(),
+                       header.table_size * sizeof(int32_t)) &&
+             write_all(rk_hashes_.data(), header.rk_hashes_size * sizeof(uint32_t)) &&
+             omnisci::fsync(fd) == 0;
+  omnisci::close(fd);
+  boost::system::error_code ec;
+  if (ret) {
+    boost::filesystem::rename(tmp_path, hash_table_path_, ec);
+    ret = !ec;
+  }
+  if (!ret) {
+    LOG(WARNING) << "Could not write the string dictionary hash table "
+                 << hash_table_path_;
+    boost::filesystem::remove(tmp_path, ec);
+  }
   return ret;
 }
 
@@ -21,16 +21,25 @@
 #include "DictRef.h"
 #include "DictionaryCache.hpp"
 #include "LeafHostInfo.h"
+#include "LruCache.hpp"
 
+#include <atomic>
+#include <functional>
 #include <future>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <vector>
 
 extern bool g_enable_stringdict_parallel;
+extern bool g_enable_stringdict_trigram_index;
+extern bool g_enable_stringdict_lazy_load;
+extern size_t g_stringdict_remote_cache_entries;
 
 class StringDictionaryClient;
+class StringTrigramIndex;
 
 class DictPayloadUnavailable : public std::runtime_error {
  public:
@@ -61,6 +70,14 @@ class StringDictionary {
   std::string getString(int32_t string_id) const;
   std::pair<char*, size_t> getStringBytes(int32_t string_id) const noexcept;
   size_t storageEntryCount() const;
+  // Calls `visit` under the read lock with the offsets of the first `str_count` strings,
+  // a 48 bit offset and a 16 bit size packed in 8 bytes each, and the payload they
+  // point into.
+  void visitStorage(const size_t str_count,
+                    const std::function<void(const int8_t* offsets,
+                                             const size_t offsets_size,
+                                             const int8_t* payload,
+                                             const size_t payload_size)>& visit) const;
 
   std::vector<int32_t> getLike(const std::string& pattern,
                                const bool icase,
@@ -139,6 +156,10 @@ class StringDictionary {
       std::vector<std::future<std::vector<std::pair<uint32_t, unsigned int>>>>&
           dictionary_futures);
   size_t getNumStringsFromStorage(const size_t storage_slots) const noexcept;
+  void buildHashTableFromStorage(const size_t str_count, const size_t initial_capacity);
+  void loadHashTable();
+  bool readHashTable();
+  bool writeHashTable() const noexcept;
   bool fillRateIsHigh(const size_t num_strings) const noexcept;
   void increaseCapacity() noexcept;
   template <class String>
@@ -153,6 +174,14 @@ class StringDictionary {
                    std::vector<uint32_t>& hashes) const noexcept;
   template <class T, class String>
   void getOrAddBulkRemote(const std::vector<String>& string_vec, T* encoded_vec);
+  template <class T, class String>
+  std::vector<size_t> getBulkExisting(const std::vector<String>& input_strings,
+                                      const std::vector<uint32_t>& input_strings_rk_hashes,
+                                      T* output_string_ids,
+                                      const bool parallel) const noexcept;
+  std::optional<int32_t> getRemoteCachedId(const std::string& str) const;
+  std::optional<std::string> getRemoteCachedString(const int32_t string_id) const;
+  void putRemoteCached(const int32_t string_id, const std::string& str) const;
   int32_t getUnlocked(const std::string& str) const noexcept;
   std::string getStringUnlocked(int32_t string_id) const noexcept;
   std::string getStringChecked(const int string_id) const noexcept;
@@ -189,6 +218,9 @@ class StringDictionary {
                           size_t& mem_size,
                           const size_t min_capacity_requested = 0) noexcept;
   void invalidateInvertedIndex() noexcept;
+  std::optional<std::vector<int32_t>> getTrigramCandidates(
+      const std::vector<std::string>& literals,
+      const size_t generation) const;
   std::vector<int32_t> getEquals(std::string pattern,
                                  std::string comp_operator,
                                  size_t generation);
@@ -213,6 +245,12 @@ class StringDictionary {
   size_t offset_file_size_;
   size_t payload_file_size_;
   size_t payload_file_off_;
+  // with lazy loading, the hash table is read from hash_table_path_ or rebuilt from the
+  // storage by the first lookup rather than by the constructor
+  std::string hash_table_path_;
+  std::atomic<bool> hash_table_loaded_{true};
+  size_t initial_capacity_{0};
+  size_t persisted_str_count_{0};
   mutable mapd_shared_mutex rw_mutex_;
   mutable std::map<std::tuple<std::string, bool, bool, char>, std::vector<int32_t>>
       like_cache_;
@@ -220,8 +258,15 @@ class StringDictionary {
   mutable std::map<std::string, int32_t> equal_cache_;
   mutable DictionaryCache<std::string, compare_cache_value_t> compare_cache_;
   mutable std::shared_ptr<std::vector<std::string>> strings_cache_;
+  // indexes the strings added since the last LIKE or REGEXP_LIKE lookup on the next one
+  mutable std::unique_ptr<StringTrigramIndex> trigram_index_;
   std::unique_ptr<StringDictionaryClient> client_;
   std::unique_ptr<StringDictionaryClient> client_no_timeout_;
+  // with a remote dictionary, the strings looked up or added through this one by id and
+  // the other way around, the id of a string never changes
+  mutable std::mutex remote_cache_mutex_;
+  mutable std::unique_ptr<LruCache<int32_t, std::string>> remote_strings_cache_;
+  mutable std::unique_ptr<LruCache<std::string, int32_t>> remote_ids_cache_;
 
   char* CANARY_BUFFER{nullptr};
   size_t canary_buffer_size = 0;
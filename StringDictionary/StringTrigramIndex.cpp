@@ -0,0 +1,183 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StringDictionary/StringTrigramIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// The case folding of ILIKE, the index serves both.
+char fold_case(const char c) {
+  return 'A' <= c && c <= 'Z' ? 'a' + (c - 'A') : c;
+}
+
+uint32_t get_trigram(const std::string_view str, const size_t pos) {
+  return static_cast<uint32_t>(static_cast<uint8_t>(fold_case(str[pos]))) << 16 |
+         static_cast<uint32_t>(static_cast<uint8_t>(fold_case(str[pos + 1]))) << 8 |
+         static_cast<uint32_t>(static_cast<uint8_t>(fold_case(str[pos + 2])));
+}
+
+std::vector<uint32_t> get_trigrams(const std::string_view str) {
+  std::vector<uint32_t> trigrams;
+  for (size_t pos = 0; pos + 3 <= str.size(); ++pos) {
+    trigrams.push_back(get_trigram(str, pos));
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+  return trigrams;
+}
+
+void add_literal(std::vector<std::string>& literals, std::string& literal) {
+  if (!literal.empty()) {
+    literals.push_back(literal);
+    literal.clear();
+  }
+}
+
+}  // namespace
+
+void StringTrigramIndex::add(const std::string_view str) {
+  const auto string_id = static_cast<int32_t>(indexed_count_++);
+  for (const auto trigram : get_trigrams(str)) {
+    postings_[trigram].push_back(string_id);
+  }
+}
+
+std::optional<std::vector<int32_t>> StringTrigramIndex::getCandidates(
+    const std::vector<std::string>& literals,
+    const size_t generation) const {
+  std::vector<uint32_t> trigrams;
+  for (const auto& literal : literals) {
+    const auto literal_trigrams = get_trigrams(literal);
+    trigrams.insert(trigrams.end(), literal_trigrams.begin(), literal_trigrams.end());
+  }
+  if (trigrams.empty()) {
+    return std::nullopt;
+  }
+  std::vector<const std::vector<int32_t>*> posting_lists;
+  for (const auto trigram : trigrams) {
+    const auto it = postings_.find(trigram);
+    if (it == postings_.end()) {
+      return std::vector<int32_t>{};
+    }
+    posting_lists.push_back(&it->second);
+  }
+  // from the shortest list, the intersection only gets shorter
+  std::sort(posting_lists.begin(),
+            posting_lists.end(),
+            [](const std::vector<int32_t>* lhs, const std::vector<int32_t>* rhs) {
+              return lhs->size() < rhs->size();
+            });
+  const auto& shortest = *posting_lists.front();
+  std::vector<int32_t> candidates(
+      shortest.begin(),
+      std::lower_bound(
+          shortest.begin(), shortest.end(), static_cast<int32_t>(generation)));
+  for (size_t i = 1; i < posting_lists.size() && !candidates.empty(); ++i) {
+    std::vector<int32_t> intersection;
+    std::set_intersection(candidates.begin(),
+                          candidates.end(),
+                          posting_lists[i]->begin(),
+                          posting_lists[i]->end(),
+                          std::back_inserter(intersection));
+    candidates.swap(intersection);
+  }
+  return candidates;
+}
+
+std::vector<std::string> StringTrigramIndex::getLikeLiterals(const std::string& pattern,
+                                                             const bool is_simple,
+                                                             const char escape) {
+  // a simple pattern is the substring to look for, without its wildcards
+  if (is_simple) {
+    return {pattern};
+  }
+  std::vector<std::string> literals;
+  std::string literal;
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const auto c = pattern[i];
+    if (c == escape && i + 1 < pattern.size()) {
+      literal += pattern[++i];
+    } else if (c == '%' || c == '_') {
+      add_literal(literals, literal);
+    } else {
+      literal += c;
+    }
+  }
+  add_literal(literals, literal);
+  return literals;
+}
+
+std::vector<std::string> StringTrigramIndex::getRegexpLiterals(
+    const std::string& pattern) {
+  if (pattern.find('|') != std::string::npos) {
+    return {};
+  }
+  const std::string operators{"\\.[](){}*+?^$"};
+  std::vector<std::string> literals;
+  std::string literal;
+  int group_depth{0};
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const auto c = pattern[i];
+    if (c == '\\') {
+      // an escaped character or a class, such as \d
+      add_literal(literals, literal);
+      ++i;
+      continue;
+    }
+    if (c == '[') {
+      add_literal(literals, literal);
+      // a closing bracket first is part of the set
+      for (i += 2; i < pattern.size() && pattern[i] != ']'; ++i) {
+      }
+      continue;
+    }
+    // the groups can be optional or repeated, their literals aren't required
+    if (c == '(') {
+      add_literal(literals, literal);
+      ++group_depth;
+      continue;
+    }
+    if (c == ')') {
+      group_depth = std::max(group_depth - 1, 0);
+      continue;
+    }
+    if (group_depth) {
+      continue;
+    }
+    if (c == '*' || c == '?' || c == '{') {
+      // the character before is optional
+      if (!literal.empty()) {
+        literal.pop_back();
+      }
+      add_literal(literals, literal);
+      if (c == '{') {
+        for (; i < pattern.size() && pattern[i] != '}'; ++i) {
+        }
+      }
+      continue;
+    }
+    if (operators.find(c) != std::string::npos) {
+      add_literal(literals, literal);
+      continue;
+    }
+    literal += c;
+  }
+  add_literal(literals, literal);
+  return literals;
+}
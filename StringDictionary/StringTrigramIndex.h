@@ -0,0 +1,62 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    StringTrigramIndex.h
+ * @brief   Inverted index of the case folded trigrams of the strings of a dictionary,
+ *          for the LIKE and REGEXP_LIKE lookups.
+ *
+ * A string can only match a pattern if it contains every trigram of the literals the
+ * pattern requires, the ids of such strings are the candidates which get matched
+ * against the pattern instead of the whole dictionary. The strings are indexed in the
+ * order of their ids, the posting lists are sorted.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class StringTrigramIndex {
+ public:
+  // Number of strings indexed, the next string added gets this id.
+  size_t size() const { return indexed_count_; }
+
+  void add(const std::string_view str);
+
+  // The ids below `generation` of the strings which contain every trigram of the
+  // literals, sorted. std::nullopt if the literals have no trigram to look up.
+  std::optional<std::vector<int32_t>> getCandidates(
+      const std::vector<std::string>& literals,
+      const size_t generation) const;
+
+  // The literals a string must contain to match a LIKE pattern.
+  static std::vector<std::string> getLikeLiterals(const std::string& pattern,
+                                                  const bool is_simple,
+                                                  const char escape);
+
+  // The literals a string must contain to match an extended regular expression, none
+  // for alternations.
+  static std::vector<std::string> getRegexpLiterals(const std::string& pattern);
+
+ private:
+  std::unordered_map<uint32_t, std::vector<int32_t>> postings_;
+  size_t indexed_count_{0};
+};
@@ -42,6 +42,7 @@ using namespace TestHelpers;
 using QR = QueryRunner::QueryRunner;
 
 extern bool g_test_drop_column_rollback;
+extern bool g_enable_catalog_snapshot_reads;
 
 namespace {
 
@@ -276,6 +277,35 @@ TEST(AlterColumnTest3, Add_col_to_sharded_table) {
   EXPECT_NO_THROW(run_query("insert into x values('0',0);"););
 }
 
+TEST(AlterColumnTest3, Lookups_by_id_after_add_and_drop) {
+  const auto save_snapshot_reads = g_enable_catalog_snapshot_reads;
+  ScopeGuard reset_state = [&save_snapshot_reads] {
+    g_enable_catalog_snapshot_reads = save_snapshot_reads;
+  };
+  g_enable_catalog_snapshot_reads = true;
+
+  auto& cat = QR::get()->getSession()->getCatalog();
+  EXPECT_NO_THROW(run_ddl_statement("drop table if exists t;"););
+  EXPECT_NO_THROW(run_ddl_statement("create table t(c1 int);"););
+  const auto td = cat.getMetadataForTable("t");
+  ASSERT_TRUE(td);
+  EXPECT_EQ(td, cat.getMetadataForTable(td->tableId));
+  ASSERT_FALSE(cat.getMetadataForColumn(td->tableId, "c2"));
+
+  // the lookups by id follow the columns added and dropped after they were first made
+  EXPECT_NO_THROW(run_ddl_statement("alter table t add column c2 int;"););
+  const auto cd = cat.getMetadataForColumn(td->tableId, "c2");
+  ASSERT_TRUE(cd);
+  const auto column_id = cd->columnId;
+  EXPECT_EQ(cd, cat.getMetadataForColumn(td->tableId, column_id));
+  EXPECT_NO_THROW(run_ddl_statement("alter table t drop column c2;"););
+  EXPECT_FALSE(cat.getMetadataForColumn(td->tableId, column_id));
+
+  const auto table_id = td->tableId;
+  EXPECT_NO_THROW(run_ddl_statement("drop table t;"););
+  EXPECT_FALSE(cat.getMetadataForTable(table_id));
+}
+
 void drop_columns(const bool rollback, const std::vector<std::string>&& dropped_columns) {
   g_test_drop_column_rollback = rollback;
   std::vector<std::string> drop_column_phrases;
@@ -516,6 +516,34 @@ TEST_F(ArrowIpcBasic, IpcGpu) {
   deallocate_df(data_frame, ExecutorDeviceType::GPU);
 }
 
+TEST_F(ArrowIpcBasic, IpcGpuPartitioned) {
+  if (g_cpu_only) {
+    LOG(ERROR) << "Test not valid in CPU mode.";
+    return;
+  }
+  std::vector<TDataFrame> data_frames;
+  EXPECT_THROW(g_client->sql_execute_gdf_partitioned(
+                   data_frames, g_session_id, "SELECT * FROM arrow_ipc_test;", {}, -1),
+               TOmniSciException);
+  EXPECT_THROW(
+      g_client->sql_execute_gdf_partitioned(
+          data_frames, g_session_id, "SELECT * FROM arrow_ipc_test;", {0, 0}, -1),
+      TOmniSciException);
+
+  g_client->sql_execute_gdf_partitioned(
+      data_frames, g_session_id, "SELECT x FROM arrow_ipc_test;", {0}, -1);
+  ASSERT_EQ(data_frames.size(), size_t(1));
+  ASSERT_TRUE(data_frames.front().sm_size > 0);
+#ifdef HAVE_CUDA
+  auto df = ArrowOutput(
+      data_frames.front(), ExecutorDeviceType::GPU, TArrowTransport::SHARED_MEMORY);
+  ASSERT_EQ(df.record_batch->num_rows(), 5);
+#else
+  ASSERT_TRUE(false) << "Test should be skipped in CPU-only mode!";
+#endif
+  deallocate_df(data_frames.front(), ExecutorDeviceType::GPU);
+}
+
 int main(int argc, char* argv[]) {
   int err = 0;
   TestHelpers::init_logger_stderr_only(argc, argv);
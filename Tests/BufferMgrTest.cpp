@@ -0,0 +1,329 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "DataMgr/BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
+#include "Shared/scope.h"
+
+#include <gtest/gtest.h>
+
+using namespace Buffer_Namespace;
+
+namespace {
+
+constexpr size_t kPageSize{512};
+constexpr size_t kChunkSize{2 * kPageSize};
+// a single slab holding four chunks
+constexpr size_t kPoolSize{4 * kChunkSize};
+
+int8_t chunk_byte(const ChunkKey& chunk_key) {
+  return static_cast<int8_t>(chunk_key[CHUNK_KEY_TABLE_IDX] * 16 + chunk_key[3]);
+}
+
+// Parent of the buffer pool serving chunks filled with chunk_byte().
+class PatternChunkMgr : public AbstractBufferMgr {
+ public:
+  PatternChunkMgr() : AbstractBufferMgr(0) {}
+
+  AbstractBuffer* createBuffer(const ChunkKey&, const size_t, const size_t) override {
+    UNREACHABLE();
+    return nullptr;
+  }
+  void deleteBuffer(const ChunkKey&, const bool) override {}
+  void deleteBuffersWithPrefix(const ChunkKey&, const bool) override {}
+  AbstractBuffer* getBuffer(const ChunkKey&, const size_t) override {
+    UNREACHABLE();
+    return nullptr;
+  }
+  void fetchBuffer(const ChunkKey& chunk_key,
+                   AbstractBuffer* dest_buffer,
+                   const size_t num_bytes) override {
+    ++num_fetches;
+    std::vector<int8_t> data(num_bytes, chunk_byte(chunk_key));
+    dest_buffer->append(data.data(), num_bytes, CPU_LEVEL, -1);
+    dest_buffer->clearDirtyBits();
+  }
+  AbstractBuffer* putBuffer(const ChunkKey&, AbstractBuffer*, const size_t) override {
+    UNREACHABLE();
+    return nullptr;
+  }
+  void getChunkMetadataVecForKeyPrefix(ChunkMetadataVector&, const ChunkKey&) override {}
+  bool isBufferOnDevice(const ChunkKey&) override { return true; }
+  std::string printSlabs() override { return ""; }
+  void clearSlabs() override {}
+  size_t getMaxSize() override { return 0; }
+  size_t getInUseSize() override { return 0; }
+  size_t getAllocated() override { return 0; }
+  bool isAllocationCapped() override { return false; }
+  void checkpoint() override {}
+  void checkpoint(const int, const int) override {}
+  void removeTableRelatedDS(const int, const int) override {}
+  AbstractBuffer* alloc(const size_t) override {
+    UNREACHABLE();
+    return nullptr;
+  }
+  void free(AbstractBuffer*) override {}
+  MgrType getMgrType() override { return PERSISTENT_STORAGE_MGR; }
+  std::string getStringMgrType() override { return ToString(PERSISTENT_STORAGE_MGR); }
+  size_t getNumChunks() override { return 0; }
+
+  size_t num_fetches{0};
+};
+
+class BufferMgrEvictionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    buffer_mgr_ = std::make_unique<CpuBufferMgr>(
+        0, kPoolSize, nullptr, kPoolSize, kPoolSize, kPageSize, &parent_mgr_);
+  }
+
+  void touch(const ChunkKey& chunk_key) {
+    buffer_mgr_->getBuffer(chunk_key, kChunkSize)->unPin();
+  }
+
+  // Reads the two chunks of a dimension table twice, then scans five chunks of a fact
+  // table once, the pool only holds four chunks.
+  void runDimensionAndScanQueries() {
+    for (int query = 0; query < 2; ++query) {
+      touch(dimension_chunk(0));
+      touch(dimension_chunk(1));
+    }
+    for (int fragment_id = 0; fragment_id < 5; ++fragment_id) {
+      touch(fact_chunk(fragment_id));
+    }
+  }
+
+  static ChunkKey dimension_chunk(const int fragment_id) {
+    return {1, 1, 1, fragment_id};
+  }
+  static ChunkKey fact_chunk(const int fragment_id) { return {1, 2, 1, fragment_id}; }
+
+  PatternChunkMgr parent_mgr_;
+  std::unique_ptr<CpuBufferMgr> buffer_mgr_;
+};
+
+class BufferMgrCompactionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    compaction_enabled_ = g_enable_buffer_pool_compaction;
+    g_enable_buffer_pool_compaction = true;
+  }
+
+  void TearDown() override { g_enable_buffer_pool_compaction = compaction_enabled_; }
+
+  // Fills num_slabs slabs of four chunks, then deletes the chunks of deleted_fragments.
+  void fillSlabs(const size_t num_slabs, const std::vector<int>& deleted_fragments) {
+    buffer_mgr_ = std::make_unique<CpuBufferMgr>(
+        0, num_slabs * kPoolSize, nullptr, kPoolSize, kPoolSize, kPageSize, &parent_mgr_);
+    for (size_t fragment_id = 0; fragment_id < 4 * num_slabs; ++fragment_id) {
+      buffer_mgr_->getBuffer(chunk(fragment_id), kChunkSize)->unPin();
+    }
+    for (const auto fragment_id : deleted_fragments) {
+      buffer_mgr_->deleteBuffer(chunk(fragment_id));
+    }
+  }
+
+  void expectChunkData(const ChunkKey& chunk_key, const size_t num_bytes) {
+    ASSERT_TRUE(buffer_mgr_->isBufferOnDevice(chunk_key));
+    auto buffer = buffer_mgr_->getBuffer(chunk_key, num_bytes);
+    const auto data = buffer->getMemoryPtr();
+    EXPECT_EQ(std::count(data, data + num_bytes, chunk_byte(chunk_key)),
+              static_cast<std::ptrdiff_t>(num_bytes));
+    buffer->unPin();
+  }
+
+  static ChunkKey chunk(const int fragment_id) { return {1, 1, 1, fragment_id}; }
+
+  bool compaction_enabled_;
+  PatternChunkMgr parent_mgr_;
+  std::unique_ptr<CpuBufferMgr> buffer_mgr_;
+};
+
+}  // namespace
+
+TEST_F(BufferMgrEvictionTest, LruEvictsReusedChunksForScan) {
+  buffer_mgr_->setEvictionPolicy(create_eviction_policy("lru"));
+  runDimensionAndScanQueries();
+  EXPECT_FALSE(buffer_mgr_->isBufferOnDevice(dimension_chunk(0)));
+  EXPECT_FALSE(buffer_mgr_->isBufferOnDevice(dimension_chunk(1)));
+  EXPECT_TRUE(buffer_mgr_->isBufferOnDevice(fact_chunk(4)));
+
+  const auto eviction_counts = buffer_mgr_->getTableEvictionCounts();
+  ASSERT_EQ(eviction_counts.size(), size_t(2));
+  EXPECT_EQ(eviction_counts.at({1, 1}).num_chunks, size_t(2));
+  EXPECT_EQ(eviction_counts.at({1, 1}).num_bytes, 2 * kChunkSize);
+  EXPECT_EQ(eviction_counts.at({1, 2}).num_chunks, size_t(1));
+}
+
+TEST_F(BufferMgrEvictionTest, ScanResistantPoliciesKeepReusedChunks) {
+  for (const auto policy : {"lru2", "2q"}) {
+    SetUp();
+    buffer_mgr_->setEvictionPolicy(create_eviction_policy(policy));
+    EXPECT_EQ(buffer_mgr_->getEvictionPolicyName(), policy);
+    runDimensionAndScanQueries();
+    EXPECT_TRUE(buffer_mgr_->isBufferOnDevice(dimension_chunk(0))) << policy;
+    EXPECT_TRUE(buffer_mgr_->isBufferOnDevice(dimension_chunk(1))) << policy;
+    // the scanned chunks went through the other two slots, oldest first
+    EXPECT_FALSE(buffer_mgr_->isBufferOnDevice(fact_chunk(2))) << policy;
+    EXPECT_TRUE(buffer_mgr_->isBufferOnDevice(fact_chunk(3))) << policy;
+    EXPECT_TRUE(buffer_mgr_->isBufferOnDevice(fact_chunk(4))) << policy;
+
+    const auto eviction_counts = buffer_mgr_->getTableEvictionCounts();
+    ASSERT_EQ(eviction_counts.size(), size_t(1)) << policy;
+    EXPECT_EQ(eviction_counts.at({1, 2}).num_chunks, size_t(3)) << policy;
+    EXPECT_EQ(eviction_counts.at({1, 2}).num_bytes, 3 * kChunkSize) << policy;
+  }
+}
+
+TEST_F(BufferMgrEvictionTest, SizeWeightEvictsLargeChunks) {
+  const auto size_weight = g_buffer_eviction_size_weight;
+  ScopeGuard reset_size_weight = [size_weight] {
+    g_buffer_eviction_size_weight = size_weight;
+  };
+  g_buffer_eviction_size_weight = 100;
+  buffer_mgr_->setEvictionPolicy(create_eviction_policy("lru"));
+  // a chunk of two slots read first, then two chunks of one slot
+  buffer_mgr_->getBuffer({1, 3, 1, 0}, 2 * kChunkSize)->unPin();
+  touch(dimension_chunk(0));
+  touch(dimension_chunk(1));
+  touch(dimension_chunk(0));
+  touch({1, 3, 1, 0});
+  touch(dimension_chunk(1));
+  // the large chunk was touched after the first small one, it goes anyway
+  touch(fact_chunk(0));
+  EXPECT_FALSE(buffer_mgr_->isBufferOnDevice({1, 3, 1, 0}));
+  EXPECT_TRUE(buffer_mgr_->isBufferOnDevice(dimension_chunk(0)));
+  EXPECT_TRUE(buffer_mgr_->isBufferOnDevice(dimension_chunk(1)));
+}
+
+TEST_F(BufferMgrCompactionTest, CompactSlabs) {
+  fillSlabs(1, {1});
+  EXPECT_EQ(buffer_mgr_->compactSlabs(), size_t(2));
+  const auto& segs = buffer_mgr_->getSlabSegments()[0];
+  ASSERT_EQ(segs.size(), size_t(4));
+  EXPECT_EQ(segs.back().mem_status, FREE);
+  EXPECT_EQ(segs.back().start_page, 6);
+  for (const auto fragment_id : {0, 2, 3}) {
+    expectChunkData(chunk(fragment_id), kChunkSize);
+  }
+  EXPECT_EQ(buffer_mgr_->compactSlabs(), size_t(0));
+}
+
+TEST_F(BufferMgrCompactionTest, AllocationCompactsSlab) {
+  fillSlabs(1, {1, 3});
+  // four free pages, in two runs of two
+  buffer_mgr_->getBuffer({1, 2, 1, 0}, 2 * kChunkSize)->unPin();
+  EXPECT_TRUE(buffer_mgr_->getTableEvictionCounts().empty());
+  expectChunkData(chunk(0), kChunkSize);
+  expectChunkData(chunk(2), kChunkSize);
+  expectChunkData({1, 2, 1, 0}, 2 * kChunkSize);
+}
+
+TEST_F(BufferMgrCompactionTest, AllocationMovesBuffersAcrossSlabs) {
+  fillSlabs(2, {1, 3, 5});
+  // no slab has the six free pages on its own
+  buffer_mgr_->getBuffer({1, 2, 1, 0}, 3 * kChunkSize)->unPin();
+  EXPECT_TRUE(buffer_mgr_->getTableEvictionCounts().empty());
+  for (const auto fragment_id : {0, 2, 4, 6, 7}) {
+    expectChunkData(chunk(fragment_id), kChunkSize);
+  }
+  expectChunkData({1, 2, 1, 0}, 3 * kChunkSize);
+}
+
+TEST_F(BufferMgrCompactionTest, PinnedBuffersStay) {
+  fillSlabs(1, {1, 3});
+  auto pinned_buffer = buffer_mgr_->getBuffer(chunk(2), kChunkSize);
+  ScopeGuard unpin = [pinned_buffer] { pinned_buffer->unPin(); };
+  EXPECT_EQ(buffer_mgr_->compactSlabs(), size_t(0));
+  // nothing to compact, so the allocation evicts
+  buffer_mgr_->getBuffer({1, 2, 1, 0}, 2 * kChunkSize)->unPin();
+  EXPECT_FALSE(buffer_mgr_->getTableEvictionCounts().empty());
+  expectChunkData(chunk(2), kChunkSize);
+}
+
+TEST_F(BufferMgrCompactionTest, DisabledCompactionEvicts) {
+  g_enable_buffer_pool_compaction = false;
+  fillSlabs(1, {1, 3});
+  buffer_mgr_->getBuffer({1, 2, 1, 0}, 2 * kChunkSize)->unPin();
+  EXPECT_FALSE(buffer_mgr_->getTableEvictionCounts().empty());
+}
+
+TEST_F(BufferMgrEvictionTest, CopyResidentBuffer) {
+  touch(dimension_chunk(0));
+  CpuBufferMgr peer_mgr(
+      0, kPoolSize, nullptr, kPoolSize, kPoolSize, kPageSize, &parent_mgr_);
+  auto dest_buffer = peer_mgr.createBuffer(dimension_chunk(0), kPageSize, kChunkSize);
+  // only as much of the chunk as the pool holds, and only the chunks it holds
+  EXPECT_FALSE(buffer_mgr_->copyResidentBuffer(
+      dimension_chunk(0), dest_buffer, 2 * kChunkSize));
+  EXPECT_FALSE(
+      buffer_mgr_->copyResidentBuffer(dimension_chunk(1), dest_buffer, kChunkSize));
+  ASSERT_TRUE(
+      buffer_mgr_->copyResidentBuffer(dimension_chunk(0), dest_buffer, kChunkSize));
+  ASSERT_EQ(dest_buffer->size(), kChunkSize);
+  const auto data = dest_buffer->getMemoryPtr();
+  EXPECT_TRUE(std::all_of(data, data + kChunkSize, [](const int8_t byte) {
+    return byte == chunk_byte(dimension_chunk(0));
+  }));
+  dest_buffer->unPin();
+}
+
+TEST_F(BufferMgrEvictionTest, CompressedChunkCache) {
+  const auto cache_bytes = g_cpu_compressed_chunk_cache_bytes;
+  ScopeGuard reset_cache_bytes = [cache_bytes] {
+    g_cpu_compressed_chunk_cache_bytes = cache_bytes;
+  };
+  g_cpu_compressed_chunk_cache_bytes = kChunkSize;
+  buffer_mgr_->setEvictionPolicy(create_eviction_policy("lru"));
+  for (int fragment_id = 0; fragment_id < 5; ++fragment_id) {
+    touch(fact_chunk(fragment_id));
+  }
+  ASSERT_FALSE(buffer_mgr_->isBufferOnDevice(fact_chunk(0)));
+  EXPECT_GT(buffer_mgr_->getCompressedChunkCacheSize(), size_t(0));
+
+  // the evicted chunk is decompressed rather than fetched from the parent
+  const auto num_fetches = parent_mgr_.num_fetches;
+  auto buffer = buffer_mgr_->getBuffer(fact_chunk(0), kChunkSize);
+  EXPECT_EQ(parent_mgr_.num_fetches, num_fetches);
+  ASSERT_EQ(buffer->size(), kChunkSize);
+  const auto data = buffer->getMemoryPtr();
+  EXPECT_TRUE(std::all_of(data, data + kChunkSize, [](const int8_t byte) {
+    return byte == chunk_byte(fact_chunk(0));
+  }));
+  buffer->unPin();
+
+  // the copies of the chunks of a table go with the table
+  buffer_mgr_->deleteBuffersWithPrefix({1, 2});
+  EXPECT_EQ(buffer_mgr_->getCompressedChunkCacheSize(), size_t(0));
+}
+
+TEST(BufferEvictionPolicy, UnknownPolicy) {
+  EXPECT_THROW(create_eviction_policy("mru"), std::runtime_error);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "DataMgr/ChunkBloomFilter.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <unordered_set>
+
+TEST(ChunkBloomFilter, Empty) {
+  const ChunkBloomFilter bloom_filter;
+  EXPECT_EQ(size_t(0), bloom_filter.valueCount());
+  for (int64_t val = -1000; val <= 1000; ++val) {
+    EXPECT_FALSE(bloom_filter.mayContain(val));
+  }
+}
+
+TEST(ChunkBloomFilter, NoFalseNegatives) {
+  std::mt19937_64 gen(42);
+  std::uniform_int_distribution<int64_t> dist(std::numeric_limits<int64_t>::min(),
+                                              std::numeric_limits<int64_t>::max());
+  ChunkBloomFilter bloom_filter;
+  std::vector<int64_t> values;
+  for (size_t i = 0; i < 50000; ++i) {
+    values.push_back(dist(gen));
+    bloom_filter.add(values.back());
+  }
+  // repeated values are counted, the encoder matches the count with the chunk size
+  bloom_filter.add(values.front());
+  EXPECT_EQ(values.size() + 1, bloom_filter.valueCount());
+  for (const auto val : values) {
+    ASSERT_TRUE(bloom_filter.mayContain(val));
+  }
+}
+
+TEST(ChunkBloomFilter, FalsePositiveRate) {
+  ChunkBloomFilter bloom_filter;
+  // dense dictionary ids, like those of a dictionary encoded column
+  std::unordered_set<int64_t> values;
+  for (int64_t val = 0; val < 100000; val += 2) {
+    bloom_filter.add(val);
+    values.insert(val);
+  }
+  size_t false_positives{0};
+  for (int64_t val = -100000; val < 200000; ++val) {
+    if (!values.count(val) && bloom_filter.mayContain(val)) {
+      ++false_positives;
+    }
+  }
+  EXPECT_LT(false_positives, size_t(250000 * 0.02));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "Utils/ChunkIter.h"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+ChunkIter make_fixed_width_iter(std::vector<int32_t>& values) {
+  ChunkIter it;
+  it.type_info = SQLTypeInfo(kINT, false);
+  it.skip = 1;
+  it.skip_size = sizeof(int32_t);
+  it.start_pos = it.current_pos = reinterpret_cast<int8_t*>(values.data());
+  it.end_pos = it.start_pos + values.size() * sizeof(int32_t);
+  it.second_buf = nullptr;
+  it.num_elems = values.size();
+  return it;
+}
+
+}  // namespace
+
+TEST(ChunkIterBatch, FixedWidth) {
+  std::vector<int32_t> values(1000);
+  std::iota(values.begin(), values.end(), -500);
+  auto it = make_fixed_width_iter(values);
+  ChunkBatch batch;
+  size_t elem_count{0};
+  while (ChunkIter_get_next_batch(&it, 64, &batch)) {
+    ASSERT_EQ(elem_count, batch.first_elem);
+    ASSERT_EQ(sizeof(int32_t), batch.elem_size);
+    ASSERT_LE(batch.num_elems, size_t(64));
+    // no copy, the batch points into the chunk
+    ASSERT_EQ(values.data() + elem_count, batch.valuesAs<int32_t>());
+    elem_count += batch.num_elems;
+  }
+  EXPECT_EQ(values.size(), elem_count);
+  EXPECT_EQ(size_t(0), batch.num_elems);
+
+  // the batches and the iteration one value at a time share the position
+  ChunkIter_reset(&it);
+  ASSERT_TRUE(ChunkIter_get_next_batch(&it, 10, &batch));
+  VarlenDatum vd;
+  bool is_end;
+  ChunkIter_get_next(&it, false, &vd, &is_end);
+  ASSERT_FALSE(is_end);
+  EXPECT_EQ(values[10], *reinterpret_cast<const int32_t*>(vd.pointer));
+}
+
+TEST(ChunkIterBatch, Varlen) {
+  const std::vector<std::string> strings{"foo", "", "barbaz", "x", "quux"};
+  std::string payload;
+  std::vector<StringOffsetT> offsets{0};
+  for (const auto& str : strings) {
+    payload += str;
+    offsets.push_back(payload.size());
+  }
+  ChunkIter it;
+  it.type_info = SQLTypeInfo(kTEXT, false);
+  it.skip = 1;
+  it.skip_size = -1;
+  it.start_pos = it.current_pos = reinterpret_cast<int8_t*>(offsets.data());
+  // the last offset is the end of the last string, not an element
+  it.end_pos = it.start_pos + (offsets.size() - 1) * sizeof(StringOffsetT);
+  it.second_buf = reinterpret_cast<int8_t*>(&payload[0]);
+  it.num_elems = strings.size();
+
+  std::vector<std::string> read_strings;
+  ChunkBatch batch;
+  while (ChunkIter_get_next_batch(&it, 2, &batch)) {
+    ASSERT_EQ(size_t(0), batch.elem_size);
+    ASSERT_EQ(read_strings.size(), batch.first_elem);
+    for (size_t i = 0; i < batch.num_elems; ++i) {
+      const auto str = reinterpret_cast<const char*>(batch.payload) + batch.offsets[i];
+      read_strings.emplace_back(str, batch.offsets[i + 1] - batch.offsets[i]);
+    }
+  }
+  EXPECT_EQ(strings, read_strings);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/CodeCache.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class FakeCompilationContext : public CompilationContext {
+ public:
+  FakeCompilationContext(const size_t code_size) : code_size_(code_size) {}
+
+  size_t getCodeSize() const override { return code_size_; }
+
+ private:
+  const size_t code_size_;
+};
+
+CodeCacheValWithModule make_code(const size_t code_size) {
+  return {std::make_shared<FakeCompilationContext>(code_size), nullptr};
+}
+
+}  // namespace
+
+TEST(CodeCache, BoundedByBytes) {
+  CodeCache cache(100, 1000);
+  cache.put({"a"}, make_code(399), 10);
+  cache.put({"b"}, make_code(399), 10);
+  auto stats = cache.getStats();
+  EXPECT_EQ(stats.num_entries, size_t(2));
+  EXPECT_EQ(stats.resident_bytes, size_t(800));
+
+  cache.put({"c"}, make_code(399), 10);
+  stats = cache.getStats();
+  EXPECT_EQ(stats.num_entries, size_t(2));
+  EXPECT_EQ(stats.resident_bytes, size_t(800));
+  EXPECT_EQ(stats.evictions, 1);
+  // ties go to the oldest entry
+  EXPECT_EQ(cache.get({"a"}), nullptr);
+  EXPECT_NE(cache.get({"c"}), nullptr);
+
+  // larger than the whole cache
+  cache.put({"d"}, make_code(2000), 10);
+  EXPECT_EQ(cache.get({"d"}), nullptr);
+  EXPECT_EQ(cache.getStats().num_entries, size_t(2));
+}
+
+TEST(CodeCache, CostAwareEviction) {
+  CodeCache cache(100, 1000);
+  // a giant module that was cheap to compile
+  cache.put({"giant"}, make_code(799), 10);
+  // small modules that were expensive to compile
+  cache.put({"small1"}, make_code(99), 100);
+  cache.put({"small2"}, make_code(99), 100);
+  cache.put({"small3"}, make_code(99), 100);
+  EXPECT_EQ(cache.get({"giant"}), nullptr);
+  EXPECT_NE(cache.get({"small1"}), nullptr);
+  EXPECT_NE(cache.get({"small2"}), nullptr);
+  EXPECT_NE(cache.get({"small3"}), nullptr);
+}
+
+TEST(CodeCache, FrequentEntriesSurvive) {
+  CodeCache cache(100, 300);
+  cache.put({"hot"}, make_code(99), 10);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_NE(cache.get({"hot"}), nullptr);
+  }
+  for (int i = 0; i < 10; ++i) {
+    cache.put({"cold" + std::to_string(i)}, make_code(94), 10);
+  }
+  EXPECT_NE(cache.get({"hot"}), nullptr);
+}
+
+TEST(CodeCache, BoundedByEntriesAndStats) {
+  CodeCache cache(2);
+  cache.put({"a"}, make_code(10));
+  cache.put({"b"}, make_code(10));
+  cache.put({"c"}, make_code(10));
+  EXPECT_EQ(cache.getStats().num_entries, size_t(2));
+  EXPECT_EQ(cache.get({"a"}), nullptr);
+  EXPECT_NE(cache.get({"b"}), nullptr);
+
+  // replacing an entry is not an eviction
+  cache.put({"b"}, make_code(20));
+  auto stats = cache.getStats();
+  EXPECT_EQ(stats.num_entries, size_t(2));
+  EXPECT_EQ(stats.resident_bytes, size_t(11 + 21));
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+
+  cache.evictFractionEntries(0.5);
+  EXPECT_EQ(cache.getStats().num_entries, size_t(1));
+  cache.clear();
+  stats = cache.getStats();
+  EXPECT_EQ(stats.num_entries, size_t(0));
+  EXPECT_EQ(stats.resident_bytes, size_t(0));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Catalog/ColumnStatistics.h"
+#include "Shared/InlineNullValues.h"
+#include "Tests/DBHandlerTestHelpers.h"
+#include "Tests/TestHelpers.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+TEST(ColumnStatisticsBuilder, IntegerChunk) {
+  std::vector<int32_t> values;
+  for (int32_t i = 0; i < 1000; ++i) {
+    values.push_back(i % 100);
+  }
+  values.push_back(inline_int_null_value<int32_t>());
+  std::vector<int8_t> deleted(values.size());
+  deleted[0] = 1;
+
+  ColumnStatisticsBuilder builder(SQLTypeInfo(kINT, false));
+  builder.addChunkValues(
+      reinterpret_cast<const int8_t*>(values.data()), values.size(), deleted.data());
+  const auto statistics = builder.build();
+  EXPECT_EQ(statistics.row_count, 1000);
+  EXPECT_EQ(statistics.null_count, 1);
+  EXPECT_NEAR(statistics.getNdv(), 100, 5);
+  ASSERT_EQ(statistics.histogram_bounds.size(), ColumnStatistics::kHistogramBuckets + 1);
+  EXPECT_EQ(statistics.histogram_bounds.front(), 0);
+  EXPECT_EQ(statistics.histogram_bounds.back(), 99);
+  EXPECT_NEAR(statistics.getFractionBelow(50), 0.5, 0.05);
+  EXPECT_EQ(statistics.getFractionBelow(-1), 0.);
+  EXPECT_EQ(statistics.getFractionBelow(100), 1.);
+
+  ColumnStatistics deserialized;
+  deserialized.deserializeSketch(statistics.serializeSketch());
+  deserialized.deserializeHistogram(statistics.serializeHistogram());
+  EXPECT_EQ(deserialized.ndv_sketch, statistics.ndv_sketch);
+  EXPECT_EQ(deserialized.histogram_bounds, statistics.histogram_bounds);
+}
+
+class AnalyzeTableTest : public DBHandlerTestFixture {
+ protected:
+  void SetUp() override {
+    DBHandlerTestFixture::SetUp();
+    sql("DROP TABLE IF EXISTS analyze_test");
+    sql("CREATE TABLE analyze_test(i INTEGER, d DATE, s TEXT, t TEXT ENCODING NONE)");
+    for (int i = 0; i < 10; ++i) {
+      sql("INSERT INTO analyze_test VALUES (" + std::to_string(i) + ", '2020-01-0" +
+          std::to_string(i % 3 + 1) + "', 's" + std::to_string(i % 2) + "', 't');");
+    }
+    sql("INSERT INTO analyze_test VALUES (NULL, NULL, NULL, NULL);");
+  }
+
+  void TearDown() override {
+    sql("DROP TABLE IF EXISTS analyze_test");
+    DBHandlerTestFixture::TearDown();
+  }
+
+  std::shared_ptr<const ColumnStatistics> getStatistics(const std::string& column_name) {
+    auto& cat = getCatalog();
+    const auto td = cat.getMetadataForTable("analyze_test");
+    CHECK(td);
+    const auto cd = cat.getMetadataForColumn(td->tableId, column_name);
+    CHECK(cd);
+    return cat.getColumnStatistics(td->tableId, cd->columnId);
+  }
+};
+
+TEST_F(AnalyzeTableTest, ComputeAndUpdate) {
+  if (isDistributedMode()) {
+    LOG(ERROR) << "Test not supported in distributed mode.";
+    return;
+  }
+  EXPECT_FALSE(getStatistics("i"));
+  sql("ANALYZE TABLE analyze_test;");
+
+  auto i_statistics = getStatistics("i");
+  ASSERT_TRUE(i_statistics);
+  EXPECT_EQ(i_statistics->row_count, 11);
+  EXPECT_EQ(i_statistics->null_count, 1);
+  EXPECT_EQ(i_statistics->getNdv(), size_t(10));
+  EXPECT_EQ(i_statistics->histogram_bounds.front(), 0);
+  EXPECT_EQ(i_statistics->histogram_bounds.back(), 9);
+
+  const auto d_statistics = getStatistics("d");
+  ASSERT_TRUE(d_statistics);
+  EXPECT_EQ(d_statistics->getNdv(), size_t(3));
+
+  const auto s_statistics = getStatistics("s");
+  ASSERT_TRUE(s_statistics);
+  EXPECT_EQ(s_statistics->getNdv(), size_t(2));
+
+  // none encoded strings have no statistics
+  EXPECT_FALSE(getStatistics("t"));
+
+  sql("INSERT INTO analyze_test VALUES (20, '2020-01-05', 's2', 't');");
+  i_statistics = getStatistics("i");
+  ASSERT_TRUE(i_statistics);
+  EXPECT_EQ(i_statistics->row_count, 12);
+  EXPECT_EQ(i_statistics->getNdv(), size_t(11));
+  EXPECT_EQ(i_statistics->histogram_bounds.back(), 20);
+  EXPECT_EQ(getStatistics("d")->getNdv(), size_t(4));
+
+  sql("UPDATE analyze_test SET i = 1 WHERE i = 20;");
+  EXPECT_FALSE(getStatistics("i"));
+}
+
+TEST_F(AnalyzeTableTest, Truncate) {
+  if (isDistributedMode()) {
+    LOG(ERROR) << "Test not supported in distributed mode.";
+    return;
+  }
+  sql("ANALYZE TABLE analyze_test;");
+  EXPECT_TRUE(getStatistics("i"));
+  sql("TRUNCATE TABLE analyze_test;");
+  EXPECT_FALSE(getStatistics("i"));
+}
+
+TEST_F(AnalyzeTableTest, GroupBy) {
+  if (isDistributedMode()) {
+    LOG(ERROR) << "Test not supported in distributed mode.";
+    return;
+  }
+  sql("ANALYZE TABLE analyze_test;");
+  sqlAndCompareResult(
+      "SELECT s, COUNT(*) FROM analyze_test WHERE s IS NOT NULL GROUP BY s ORDER BY s;",
+      {{"s0", i(5)}, {"s1", i(5)}});
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -171,7 +171,28 @@ TEST(Construct, Empty) {
 }
 
 // Projections:
-// TODO(Saman): add tests for Projections
+TEST(ProjectionRowWise, IntegerCols_64Slots) {
+  // non-aggregate targets of each integer width
+  std::vector<TargetInfo> target_infos =
+      generate_custom_agg_target_infos({1, 2, 4, 8, 4}, {}, {}, {});
+  auto query_mem_desc = projection_desc(target_infos, 8, 118);
+  for (auto is_parallel : {false, true}) {
+    for (auto step_size : {1, 2, 13, 67, 127}) {
+      test_columnar_conversion(target_infos, query_mem_desc, step_size, is_parallel);
+    }
+  }
+}
+
+TEST(ProjectionRowWise, IntegerCols_LogicalSlots) {
+  std::vector<TargetInfo> target_infos =
+      generate_custom_agg_target_infos({8, 4, 2, 1}, {}, {}, {});
+  auto query_mem_desc = projection_desc(target_infos, 1, 118);
+  for (auto is_parallel : {false, true}) {
+    for (auto step_size : {1, 3, 17, 33, 117}) {
+      test_columnar_conversion(target_infos, query_mem_desc, step_size, is_parallel);
+    }
+  }
+}
 
 // Perfect Hash:
 TEST(PerfectHashRowWise, OneCol_64Key_64Agg_wo_avg) {
@@ -19,7 +19,10 @@
 #include "../Catalog/Catalog.h"
 #include "../QueryEngine/Execute.h"
 #include "../QueryEngine/TableOptimizer.h"
+#include "../QueryEngine/TableVacuumScheduler.h"
+#include "../QueryEngine/WorkingSetScheduler.h"
 #include "../QueryRunner/QueryRunner.h"
+#include "../Shared/scope.h"
 
 #include <gtest/gtest.h>
 #include <string>
@@ -536,6 +539,110 @@ TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, SmallDateNarrowMax)
 TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, DeleteReset)
 TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, EncodedStringNull)
 
+TEST(BackgroundVacuum, DeletedRatio) {
+  const auto saved_ratio = g_background_vacuum_deleted_ratio;
+  ScopeGuard reset = [saved_ratio] {
+    g_background_vacuum_deleted_ratio = saved_ratio;
+    run_ddl_statement("DROP TABLE IF EXISTS vacuum_test;");
+  };
+  g_background_vacuum_deleted_ratio = 0.5;
+  run_ddl_statement("DROP TABLE IF EXISTS vacuum_test;");
+  run_ddl_statement("CREATE TABLE vacuum_test (x INT) WITH (FRAGMENT_SIZE=4);");
+  for (int i = 0; i < 12; i++) {
+    run_multiple_agg("INSERT INTO vacuum_test VALUES (" + std::to_string(i) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("DELETE FROM vacuum_test WHERE x = 0 OR (x >= 4 AND x < 7);",
+                   ExecutorDeviceType::CPU);
+
+  const auto cat = QR::get()->getCatalog();
+  // only the second fragment has enough deleted rows
+  EXPECT_EQ(size_t(1), TableVacuumScheduler::vacuumTable(*cat, "vacuum_test"));
+  EXPECT_EQ(size_t(0), TableVacuumScheduler::vacuumTable(*cat, "vacuum_test"));
+
+  const auto td = cat->getMetadataForTable("vacuum_test");
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  std::vector<size_t> physical_tuples;
+  for (const auto& fragment : table_info.fragments) {
+    physical_tuples.push_back(fragment.getPhysicalNumTuples());
+  }
+  EXPECT_EQ(std::vector<size_t>({4, 1, 4}), physical_tuples);
+  const auto rows = run_multiple_agg("SELECT COUNT(*), SUM(x) FROM vacuum_test;",
+                                     ExecutorDeviceType::CPU);
+  const auto row = rows->getNextRow(false, false);
+  ASSERT_EQ(size_t(2), row.size());
+  EXPECT_EQ(int64_t(8), TestHelpers::v<int64_t>(row[0]));
+  EXPECT_EQ(int64_t(66 - 15), TestHelpers::v<int64_t>(row[1]));
+}
+
+TEST(WorkingSet, SnapshotAndWarmUp) {
+  ScopeGuard drop_table = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS working_set_test;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS working_set_test;");
+  run_ddl_statement("CREATE TABLE working_set_test (x INT) WITH (FRAGMENT_SIZE=4);");
+  for (int i = 0; i < 8; i++) {
+    run_multiple_agg("INSERT INTO working_set_test VALUES (" + std::to_string(i) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("SELECT SUM(x) FROM working_set_test;", ExecutorDeviceType::CPU);
+
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable("working_set_test");
+  const auto cd = cat->getMetadataForColumn(td->tableId, "x");
+  const ChunkKey chunk_key{cat->getCurrentDB().dbId, td->tableId, cd->columnId, 1};
+  auto& data_mgr = cat->getDataMgr();
+  ASSERT_TRUE(data_mgr.isBufferOnDevice(chunk_key, MemoryLevel::CPU_LEVEL, 0));
+
+  const auto snapshot_path = std::string(BASE_PATH) + "/working_set_test";
+  ScopeGuard remove_snapshot = [&snapshot_path] { std::remove(snapshot_path.c_str()); };
+  WorkingSetScheduler::writeSnapshot(snapshot_path);
+  Executor::clearMemory(MemoryLevel::CPU_LEVEL);
+  ASSERT_FALSE(data_mgr.isBufferOnDevice(chunk_key, MemoryLevel::CPU_LEVEL, 0));
+  std::atomic<bool> is_program_running{true};
+  EXPECT_GT(WorkingSetScheduler::warmUp(snapshot_path, is_program_running), size_t(0));
+  EXPECT_TRUE(data_mgr.isBufferOnDevice(chunk_key, MemoryLevel::CPU_LEVEL, 0));
+}
+
+TEST(DictionaryCompaction, DropsUnreferencedStrings) {
+  ScopeGuard drop_table = [] { run_ddl_statement("DROP TABLE IF EXISTS dict_test;"); };
+  run_ddl_statement("DROP TABLE IF EXISTS dict_test;");
+  run_ddl_statement(
+      "CREATE TABLE dict_test (x INT, s TEXT ENCODING DICT(16)) WITH "
+      "(FRAGMENT_SIZE=4);");
+  for (int i = 0; i < 12; i++) {
+    run_multiple_agg("INSERT INTO dict_test VALUES (" + std::to_string(i) + ", 'str" +
+                         std::to_string(i) + "');",
+                     ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("DELETE FROM dict_test WHERE x < 8;", ExecutorDeviceType::CPU);
+
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable("dict_test");
+  const auto cd = cat->getMetadataForColumn(td->tableId, "s");
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+  TableOptimizer optimizer(td, executor.get(), *cat);
+  EXPECT_NO_THROW(optimizer.vacuumDeletedRows());
+  EXPECT_NO_THROW(optimizer.compactDictionaries());
+  EXPECT_NO_THROW(optimizer.recomputeMetadata());
+
+  const auto dd = cat->getMetadataForDict(cd->columnType.get_comp_param());
+  ASSERT_TRUE(dd);
+  EXPECT_EQ(size_t(4), dd->stringDict->storageEntryCount());
+  EXPECT_EQ("str8", dd->stringDict->getString(0));
+  for (const auto& [query, expected] :
+       std::vector<std::pair<std::string, int64_t>>{
+           {"SELECT COUNT(*) FROM dict_test WHERE s = 'str9';", 1},
+           {"SELECT COUNT(*) FROM dict_test WHERE s = 'str1';", 0},
+           {"SELECT COUNT(*) FROM dict_test WHERE s LIKE 'str1%';", 2},
+           {"SELECT SUM(x) FROM dict_test WHERE s >= 'str8';", 8 + 9}}) {
+    const auto rows = run_multiple_agg(query, ExecutorDeviceType::CPU);
+    const auto row = rows->getNextRow(false, false);
+    ASSERT_EQ(size_t(1), row.size());
+    EXPECT_EQ(expected, TestHelpers::v<int64_t>(row[0])) << query;
+  }
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
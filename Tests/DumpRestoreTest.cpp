@@ -190,6 +190,9 @@ void dump_restore(const bool migrate, const bool alter, const bool rollback) {
     dump_restore(migrate, alter, rollback, {});  // lz4
     dump_restore(migrate, alter, rollback, {"compression='gzip'"});
   }
+  if (!boost::process::search_path("zstd").string().empty()) {
+    dump_restore(migrate, alter, rollback, {"compression='zstd'"});
+  }
 }
 
 using DumpRestoreTest_Unsharded = DumpRestoreTest<1>;
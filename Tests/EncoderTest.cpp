@@ -23,6 +23,7 @@
 #include <boost/filesystem.hpp>
 
 #include "DataMgr/AbstractBuffer.h"
+#include "DataMgr/ChunkStatsKernels.h"
 #include "DataMgr/Encoder.h"
 #include "DataMgr/MemoryLevel.h"
 #include "Shared/DatumFetchers.h"
@@ -763,6 +764,46 @@ TYPED_TEST(FixedLengthArrayNoneEncoderUpdateStatsTest, TypedTest) {
   TestFixture::runTest();
 }
 
+TEST(ChunkStatsKernels, BlockStats) {
+  std::vector<int32_t> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i % 7 ? static_cast<int32_t>(i) - 500 : inline_int_null_value<int32_t>();
+  }
+  const auto stats = chunk_stats::compute_block_stats(
+      data.data(), data.size(), inline_int_null_value<int32_t>());
+  ASSERT_EQ(stats.min, -499);
+  ASSERT_EQ(stats.max, 498);
+  ASSERT_TRUE(stats.has_nulls);
+
+  const std::vector<double> nulls(10, inline_fp_null_value<double>());
+  const auto null_stats = chunk_stats::compute_block_stats(
+      nulls.data(), nulls.size(), inline_fp_null_value<double>());
+  ASSERT_FALSE(null_stats.hasValues());
+  ASSERT_TRUE(null_stats.has_nulls);
+}
+
+TEST(ChunkStatsKernels, EncodeBlock) {
+  const std::vector<int64_t> data{5, -3, inline_int_null_value<int16_t>(), 7};
+  std::vector<int16_t> encoded(data.size());
+  chunk_stats::BlockStats<int64_t> stats;
+  ASSERT_TRUE(chunk_stats::encode_block(data.data(), encoded.data(), data.size(), stats));
+  ASSERT_EQ(encoded, std::vector<int16_t>({5, -3, inline_int_null_value<int16_t>(), 7}));
+  ASSERT_EQ(stats.min, -3);
+  ASSERT_EQ(stats.max, 7);
+  ASSERT_TRUE(stats.has_nulls);
+
+  const std::vector<int64_t> overflow{1, int64_t(1) << 20};
+  ASSERT_FALSE(chunk_stats::encode_block(
+      overflow.data(), encoded.data(), overflow.size(), stats));
+}
+
+TEST_F(EncoderUpdateStatsTest, FixedLengthEncoderOverflow) {
+  // the values which don't fit are left out of the stats, as when encoded one by one
+  createEncoder(FixedLengthEncoderTraits<int64_t, int8_t>::getSqlType());
+  updateWithData(std::vector<int64_t>{-4, 1000, 9});
+  assertExpectedStats<int64_t>(-4, 9, false);
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
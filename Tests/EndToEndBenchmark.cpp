@@ -0,0 +1,676 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    EndToEndBenchmark.cpp
+ * @brief   Runs the queries of the Star Schema Benchmark or of a subset of TPC-H in
+ *          process, through QueryRunner, and reports their latency percentiles.
+ *
+ * The tables are generated at the given scale factor with the sizes and value domains of
+ * the benchmarks, from a fixed seed, so that runs of different releases see the same
+ * data. The data isn't the one of dbgen and the results aren't validated: this measures
+ * the engine, not the conformance to the benchmarks.
+ *
+ * EndToEndBenchmark --path <data dir> --suite ssb --scale-factor 1 --device cpu
+ *   --device gpu --iterations 10 [--cold] [--skip-load] [--json results.json]
+ */
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <tuple>
+
+#include "../ImportExport/Importer.h"
+#include "../Logger/Logger.h"
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/JoinHashTable/BaselineJoinHashTable.h"
+#include "../QueryEngine/JoinHashTable/JoinHashTable.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/measure.h"
+
+using QR = QueryRunner::QueryRunner;
+
+namespace {
+
+struct BenchmarkTable {
+  std::string name;
+  std::string ddl;
+  size_t row_count;
+  // the values of a row, as they would be read from a delimited file
+  std::function<std::vector<std::string>(const size_t row_idx, std::mt19937_64& rng)>
+      get_row;
+};
+
+struct BenchmarkQuery {
+  std::string name;
+  std::string sql;
+};
+
+struct BenchmarkSuite {
+  std::vector<BenchmarkTable> tables;
+  std::vector<BenchmarkQuery> queries;
+};
+
+constexpr size_t kLoadBatchRows{1000000};
+
+const std::vector<std::pair<std::string, std::string>> kNations{
+    {"ALGERIA", "AFRICA"},       {"ARGENTINA", "AMERICA"},
+    {"BRAZIL", "AMERICA"},       {"CANADA", "AMERICA"},
+    {"EGYPT", "MIDDLE EAST"},    {"ETHIOPIA", "AFRICA"},
+    {"FRANCE", "EUROPE"},        {"GERMANY", "EUROPE"},
+    {"INDIA", "ASIA"},           {"INDONESIA", "ASIA"},
+    {"IRAN", "MIDDLE EAST"},     {"IRAQ", "MIDDLE EAST"},
+    {"JAPAN", "ASIA"},           {"JORDAN", "MIDDLE EAST"},
+    {"KENYA", "AFRICA"},         {"MOROCCO", "AFRICA"},
+    {"MOZAMBIQUE", "AFRICA"},    {"PERU", "AMERICA"},
+    {"CHINA", "ASIA"},           {"ROMANIA", "EUROPE"},
+    {"SAUDI ARABIA", "MIDDLE EAST"}, {"VIETNAM", "ASIA"},
+    {"RUSSIA", "EUROPE"},        {"UNITED KINGDOM", "EUROPE"},
+    {"UNITED STATES", "AMERICA"}};
+const std::vector<std::string> kRegions{
+    "AFRICA", "AMERICA", "ASIA", "EUROPE", "MIDDLE EAST"};
+
+size_t uniform(std::mt19937_64& rng, const size_t lo, const size_t hi) {
+  return std::uniform_int_distribution<size_t>(lo, hi)(rng);
+}
+
+size_t scaled(const double scale_factor, const size_t rows_at_sf1) {
+  return std::max(size_t(1),
+                  static_cast<size_t>(std::llround(scale_factor * rows_at_sf1)));
+}
+
+// Days since 1970-01-01 of a date, and back, for the proleptic Gregorian calendar.
+int64_t days_from_civil(int64_t y, const unsigned m, const unsigned d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+std::tuple<int64_t, unsigned, unsigned> civil_from_days(int64_t z) {
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+  const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+  return {static_cast<int64_t>(yoe) + era * 400 + (m <= 2), m, d};
+}
+
+std::string date_string(const int64_t days) {
+  const auto [y, m, d] = civil_from_days(days);
+  std::ostringstream oss;
+  oss << y << '-' << std::setw(2) << std::setfill('0') << m << '-' << std::setw(2)
+      << std::setfill('0') << d;
+  return oss.str();
+}
+
+std::string money_string(const int64_t cents) {
+  std::ostringstream oss;
+  oss << cents / 100 << '.' << std::setw(2) << std::setfill('0') << std::abs(cents % 100);
+  return oss.str();
+}
+
+// SSB: the city of a nation is its name padded to 9 characters and a digit.
+std::string ssb_city(const std::string& nation, const size_t digit) {
+  auto city = nation.substr(0, 9);
+  city.resize(9, ' ');
+  return city + std::to_string(digit);
+}
+
+BenchmarkSuite make_ssb_suite(const double scale_factor) {
+  static const std::vector<std::string> kMonths{
+      "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  const auto first_day = days_from_civil(1992, 1, 1);
+  const auto day_count = days_from_civil(1999, 1, 1) - first_day;
+  const auto customer_count = scaled(scale_factor, 30000);
+  const auto supplier_count = scaled(scale_factor, 2000);
+  const auto part_count = scaled(
+      scale_factor, 200000 * (1 + std::max(0., std::floor(std::log2(scale_factor)))));
+  auto date_key = [](const int64_t days) {
+    const auto [y, m, d] = civil_from_days(days);
+    return y * 10000 + m * 100 + d;
+  };
+  auto location = [](const size_t key, std::mt19937_64& rng) {
+    const auto& [nation, region] = kNations[key % kNations.size()];
+    return std::vector<std::string>{std::to_string(key),
+                                    ssb_city(nation, uniform(rng, 0, 9)),
+                                    nation,
+                                    region};
+  };
+  BenchmarkSuite suite;
+  suite.tables.push_back(
+      {"dates",
+       "CREATE TABLE dates (d_datekey INT, d_year SMALLINT, d_yearmonthnum INT, "
+       "d_yearmonth TEXT ENCODING DICT(16), d_weeknuminyear SMALLINT);",
+       static_cast<size_t>(day_count),
+       [first_day, date_key](const size_t row_idx, std::mt19937_64&) {
+         const auto days = first_day + row_idx;
+         const auto [y, m, d] = civil_from_days(days);
+         const auto day_of_year = days - days_from_civil(y, 1, 1);
+         return std::vector<std::string>{std::to_string(date_key(days)),
+                                         std::to_string(y),
+                                         std::to_string(y * 100 + m),
+                                         kMonths[m - 1] + std::to_string(y),
+                                         std::to_string(day_of_year / 7 + 1)};
+       }});
+  suite.tables.push_back(
+      {"customer",
+       "CREATE TABLE customer (c_custkey INT, c_city TEXT ENCODING DICT(16), c_nation "
+       "TEXT ENCODING DICT(8), c_region TEXT ENCODING DICT(8));",
+       customer_count,
+       [location](const size_t row_idx, std::mt19937_64& rng) {
+         return location(row_idx + 1, rng);
+       }});
+  suite.tables.push_back(
+      {"supplier",
+       "CREATE TABLE supplier (s_suppkey INT, s_city TEXT ENCODING DICT(16), s_nation "
+       "TEXT ENCODING DICT(8), s_region TEXT ENCODING DICT(8));",
+       supplier_count,
+       [location](const size_t row_idx, std::mt19937_64& rng) {
+         return location(row_idx + 1, rng);
+       }});
+  suite.tables.push_back(
+      {"part",
+       "CREATE TABLE part (p_partkey INT, p_mfgr TEXT ENCODING DICT(8), p_category TEXT "
+       "ENCODING DICT(8), p_brand1 TEXT ENCODING DICT(16));",
+       part_count,
+       [](const size_t row_idx, std::mt19937_64& rng) {
+         const auto mfgr = "MFGR#" + std::to_string(uniform(rng, 1, 5));
+         const auto category = mfgr + std::to_string(uniform(rng, 1, 5));
+         return std::vector<std::string>{std::to_string(row_idx + 1),
+                                         mfgr,
+                                         category,
+                                         category + std::to_string(uniform(rng, 1, 40))};
+       }});
+  suite.tables.push_back(
+      {"lineorder",
+       "CREATE TABLE lineorder (lo_orderdate INT, lo_custkey INT, lo_partkey INT, "
+       "lo_suppkey INT, lo_quantity SMALLINT, lo_extendedprice INT, lo_discount "
+       "SMALLINT, lo_revenue INT, lo_supplycost INT);",
+       scaled(scale_factor, 6000000),
+       [=](const size_t, std::mt19937_64& rng) {
+         const auto quantity = uniform(rng, 1, 50);
+         const auto price = uniform(rng, 90000, 200000) / 100;
+         const auto extended_price = quantity * price;
+         const auto discount = uniform(rng, 0, 10);
+         return std::vector<std::string>{
+             std::to_string(date_key(first_day + uniform(rng, 0, day_count - 1))),
+             std::to_string(uniform(rng, 1, customer_count)),
+             std::to_string(uniform(rng, 1, part_count)),
+             std::to_string(uniform(rng, 1, supplier_count)),
+             std::to_string(quantity),
+             std::to_string(extended_price),
+             std::to_string(discount),
+             std::to_string(extended_price * (100 - discount) / 100),
+             std::to_string(price * 6 / 10)};
+       }});
+
+  suite.queries = {
+      {"Q1.1",
+       "SELECT SUM(lo_extendedprice * lo_discount) AS revenue FROM lineorder, dates "
+       "WHERE lo_orderdate = d_datekey AND d_year = 1993 AND lo_discount BETWEEN 1 AND 3 "
+       "AND lo_quantity < 25;"},
+      {"Q1.2",
+       "SELECT SUM(lo_extendedprice * lo_discount) AS revenue FROM lineorder, dates "
+       "WHERE lo_orderdate = d_datekey AND d_yearmonthnum = 199401 AND lo_discount "
+       "BETWEEN 4 AND 6 AND lo_quantity BETWEEN 26 AND 35;"},
+      {"Q1.3",
+       "SELECT SUM(lo_extendedprice * lo_discount) AS revenue FROM lineorder, dates "
+       "WHERE lo_orderdate = d_datekey AND d_weeknuminyear = 6 AND d_year = 1994 AND "
+       "lo_discount BETWEEN 5 AND 7 AND lo_quantity BETWEEN 26 AND 35;"},
+      {"Q2.1",
+       "SELECT SUM(lo_revenue), d_year, p_brand1 FROM lineorder, dates, part, supplier "
+       "WHERE lo_orderdate = d_datekey AND lo_partkey = p_partkey AND lo_suppkey = "
+       "s_suppkey AND p_category = 'MFGR#12' AND s_region = 'AMERICA' GROUP BY d_year, "
+       "p_brand1 ORDER BY d_year, p_brand1;"},
+      {"Q2.2",
+       "SELECT SUM(lo_revenue), d_year, p_brand1 FROM lineorder, dates, part, supplier "
+       "WHERE lo_orderdate = d_datekey AND lo_partkey = p_partkey AND lo_suppkey = "
+       "s_suppkey AND p_brand1 BETWEEN 'MFGR#2221' AND 'MFGR#2228' AND s_region = "
+       "'ASIA' GROUP BY d_year, p_brand1 ORDER BY d_year, p_brand1;"},
+      {"Q2.3",
+       "SELECT SUM(lo_revenue), d_year, p_brand1 FROM lineorder, dates, part, supplier "
+       "WHERE lo_orderdate = d_datekey AND lo_partkey = p_partkey AND lo_suppkey = "
+       "s_suppkey AND p_brand1 = 'MFGR#2239' AND s_region = 'EUROPE' GROUP BY d_year, "
+       "p_brand1 ORDER BY d_year, p_brand1;"},
+      {"Q3.1",
+       "SELECT c_nation, s_nation, d_year, SUM(lo_revenue) AS revenue FROM customer, "
+       "lineorder, supplier, dates WHERE lo_custkey = c_custkey AND lo_suppkey = "
+       "s_suppkey AND lo_orderdate = d_datekey AND c_region = 'ASIA' AND s_region = "
+       "'ASIA' AND d_year >= 1992 AND d_year <= 1997 GROUP BY c_nation, s_nation, "
+       "d_year ORDER BY d_year ASC, revenue DESC;"},
+      {"Q3.2",
+       "SELECT c_city, s_city, d_year, SUM(lo_revenue) AS revenue FROM customer, "
+       "lineorder, supplier, dates WHERE lo_custkey = c_custkey AND lo_suppkey = "
+       "s_suppkey AND lo_orderdate = d_datekey AND c_nation = 'UNITED STATES' AND "
+       "s_nation = 'UNITED STATES' AND d_year >= 1992 AND d_year <= 1997 GROUP BY "
+       "c_city, s_city, d_year ORDER BY d_year ASC, revenue DESC;"},
+      {"Q3.3",
+       "SELECT c_city, s_city, d_year, SUM(lo_revenue) AS revenue FROM customer, "
+       "lineorder, supplier, dates WHERE lo_custkey = c_custkey AND lo_suppkey = "
+       "s_suppkey AND lo_orderdate = d_datekey AND (c_city = 'UNITED KI1' OR c_city = "
+       "'UNITED KI5') AND (s_city = 'UNITED KI1' OR s_city = 'UNITED KI5') AND d_year "
+       ">= 1992 AND d_year <= 1997 GROUP BY c_city, s_city, d_year ORDER BY d_year "
+       "ASC, revenue DESC;"},
+      {"Q3.4",
+       "SELECT c_city, s_city, d_year, SUM(lo_revenue) AS revenue FROM customer, "
+       "lineorder, supplier, dates WHERE lo_custkey = c_custkey AND lo_suppkey = "
+       "s_suppkey AND lo_orderdate = d_datekey AND (c_city = 'UNITED KI1' OR c_city = "
+       "'UNITED KI5') AND (s_city = 'UNITED KI1' OR s_city = 'UNITED KI5') AND "
+       "d_yearmonth = 'Dec1997' GROUP BY c_city, s_city, d_year ORDER BY d_year ASC, "
+       "revenue DESC;"},
+      {"Q4.1",
+       "SELECT d_year, c_nation, SUM(lo_revenue - lo_supplycost) AS profit FROM dates, "
+       "customer, supplier, part, lineorder WHERE lo_custkey = c_custkey AND lo_suppkey "
+       "= s_suppkey AND lo_partkey = p_partkey AND lo_orderdate = d_datekey AND "
+       "c_region = 'AMERICA' AND s_region = 'AMERICA' AND (p_mfgr = 'MFGR#1' OR p_mfgr "
+       "= 'MFGR#2') GROUP BY d_year, c_nation ORDER BY d_year, c_nation;"},
+      {"Q4.2",
+       "SELECT d_year, s_nation, p_category, SUM(lo_revenue - lo_supplycost) AS profit "
+       "FROM dates, customer, supplier, part, lineorder WHERE lo_custkey = c_custkey "
+       "AND lo_suppkey = s_suppkey AND lo_partkey = p_partkey AND lo_orderdate = "
+       "d_datekey AND c_region = 'AMERICA' AND s_region = 'AMERICA' AND (d_year = 1997 "
+       "OR d_year = 1998) AND (p_mfgr = 'MFGR#1' OR p_mfgr = 'MFGR#2') GROUP BY d_year, "
+       "s_nation, p_category ORDER BY d_year, s_nation, p_category;"},
+      {"Q4.3",
+       "SELECT d_year, s_city, p_brand1, SUM(lo_revenue - lo_supplycost) AS profit FROM "
+       "dates, customer, supplier, part, lineorder WHERE lo_custkey = c_custkey AND "
+       "lo_suppkey = s_suppkey AND lo_partkey = p_partkey AND lo_orderdate = d_datekey "
+       "AND c_region = 'AMERICA' AND s_nation = 'UNITED STATES' AND (d_year = 1997 OR "
+       "d_year = 1998) AND p_category = 'MFGR#14' GROUP BY d_year, s_city, p_brand1 "
+       "ORDER BY d_year, s_city, p_brand1;"}};
+  return suite;
+}
+
+// The TPC-H queries which only need the tables below, with their substitution
+// parameters set to the validation values of the specification.
+BenchmarkSuite make_tpch_suite(const double scale_factor) {
+  static const std::vector<std::string> kSegments{
+      "AUTOMOBILE", "BUILDING", "FURNITURE", "HOUSEHOLD", "MACHINERY"};
+  static const std::vector<std::string> kPriorities{
+      "1-URGENT", "2-HIGH", "3-MEDIUM", "4-NOT SPECIFIED", "5-LOW"};
+  static const std::vector<std::string> kShipModes{
+      "REG AIR", "AIR", "RAIL", "SHIP", "TRUCK", "MAIL", "FOB"};
+  constexpr size_t kMaxLinesPerOrder{7};
+  const auto start_day = days_from_civil(1992, 1, 1);
+  const auto end_day = days_from_civil(1998, 12, 31) - 151;
+  const auto current_day = days_from_civil(1995, 6, 17);
+  const auto supplier_count = scaled(scale_factor, 10000);
+  const auto customer_count = scaled(scale_factor, 150000);
+  const auto order_count = scaled(scale_factor, 1500000);
+  // The order of a line item is derived from the row index alone, and its dates from
+  // the order, so that both tables are generated independently.
+  auto order_day = [start_day, end_day](const size_t order_idx) {
+    std::mt19937_64 order_rng(order_idx);
+    return start_day + static_cast<int64_t>(uniform(order_rng, 0, end_day - start_day));
+  };
+
+  BenchmarkSuite suite;
+  suite.tables.push_back({"region",
+                          "CREATE TABLE region (r_regionkey INT, r_name TEXT ENCODING "
+                          "DICT(8));",
+                          kRegions.size(),
+                          [](const size_t row_idx, std::mt19937_64&) {
+                            return std::vector<std::string>{std::to_string(row_idx),
+                                                            kRegions[row_idx]};
+                          }});
+  suite.tables.push_back(
+      {"nation",
+       "CREATE TABLE nation (n_nationkey INT, n_name TEXT ENCODING DICT(8), n_regionkey "
+       "INT);",
+       kNations.size(),
+       [](const size_t row_idx, std::mt19937_64&) {
+         const auto& [nation, region] = kNations[row_idx];
+         const auto region_key =
+             std::find(kRegions.begin(), kRegions.end(), region) - kRegions.begin();
+         return std::vector<std::string>{
+             std::to_string(row_idx), nation, std::to_string(region_key)};
+       }});
+  suite.tables.push_back(
+      {"supplier",
+       "CREATE TABLE supplier (s_suppkey INT, s_nationkey INT, s_acctbal "
+       "DECIMAL(12,2));",
+       supplier_count,
+       [](const size_t row_idx, std::mt19937_64& rng) {
+         return std::vector<std::string>{
+             std::to_string(row_idx + 1),
+             std::to_string(uniform(rng, 0, kNations.size() - 1)),
+             money_string(static_cast<int64_t>(uniform(rng, 0, 1099998)) - 99999)};
+       }});
+  suite.tables.push_back(
+      {"customer",
+       "CREATE TABLE customer (c_custkey INT, c_name TEXT ENCODING DICT(32), "
+       "c_nationkey INT, c_acctbal DECIMAL(12,2), c_mktsegment TEXT ENCODING DICT(8));",
+       customer_count,
+       [](const size_t row_idx, std::mt19937_64& rng) {
+         std::ostringstream name;
+         name << "Customer#" << std::setw(9) << std::setfill('0') << row_idx + 1;
+         return std::vector<std::string>{
+             std::to_string(row_idx + 1),
+             name.str(),
+             std::to_string(uniform(rng, 0, kNations.size() - 1)),
+             money_string(static_cast<int64_t>(uniform(rng, 0, 1099998)) - 99999),
+             kSegments[uniform(rng, 0, kSegments.size() - 1)]};
+       }});
+  suite.tables.push_back(
+      {"orders",
+       "CREATE TABLE orders (o_orderkey BIGINT, o_custkey INT, o_totalprice "
+       "DECIMAL(12,2), o_orderdate DATE, o_orderpriority TEXT ENCODING DICT(8), "
+       "o_shippriority INT);",
+       order_count,
+       [=](const size_t row_idx, std::mt19937_64& rng) {
+         return std::vector<std::string>{
+             std::to_string(row_idx + 1),
+             std::to_string(uniform(rng, 1, customer_count)),
+             money_string(uniform(rng, 100000, 50000000)),
+             date_string(order_day(row_idx)),
+             kPriorities[uniform(rng, 0, kPriorities.size() - 1)],
+             "0"};
+       }});
+  suite.tables.push_back(
+      {"lineitem",
+       "CREATE TABLE lineitem (l_orderkey BIGINT, l_suppkey INT, l_linenumber "
+       "SMALLINT, l_quantity DECIMAL(12,2), l_extendedprice DECIMAL(12,2), l_discount "
+       "DECIMAL(12,2), l_tax DECIMAL(12,2), l_returnflag TEXT ENCODING DICT(8), "
+       "l_linestatus TEXT ENCODING DICT(8), l_shipdate DATE, l_commitdate DATE, "
+       "l_receiptdate DATE, l_shipmode TEXT ENCODING DICT(8));",
+       order_count * kMaxLinesPerOrder,
+       [=](const size_t row_idx, std::mt19937_64& rng) {
+         const auto order_idx = row_idx / kMaxLinesPerOrder;
+         const auto orderdate = order_day(order_idx);
+         const auto quantity = uniform(rng, 1, 50);
+         const auto shipdate = orderdate + static_cast<int64_t>(uniform(rng, 1, 121));
+         const auto receiptdate = shipdate + static_cast<int64_t>(uniform(rng, 1, 30));
+         const auto returnflag =
+             receiptdate <= current_day ? (uniform(rng, 0, 1) ? "R" : "A") : "N";
+         return std::vector<std::string>{
+             std::to_string(order_idx + 1),
+             std::to_string(uniform(rng, 1, supplier_count)),
+             std::to_string(row_idx % kMaxLinesPerOrder + 1),
+             std::to_string(quantity),
+             money_string(quantity * uniform(rng, 90000, 200000)),
+             money_string(uniform(rng, 0, 10)),
+             money_string(uniform(rng, 0, 8)),
+             returnflag,
+             shipdate > current_day ? "O" : "F",
+             date_string(shipdate),
+             date_string(orderdate + static_cast<int64_t>(uniform(rng, 30, 90))),
+             date_string(receiptdate),
+             kShipModes[uniform(rng, 0, kShipModes.size() - 1)]};
+       }});
+
+  suite.queries = {
+      {"Q1",
+       "SELECT l_returnflag, l_linestatus, SUM(l_quantity) AS sum_qty, "
+       "SUM(l_extendedprice) AS sum_base_price, SUM(l_extendedprice * (1 - "
+       "l_discount)) AS sum_disc_price, SUM(l_extendedprice * (1 - l_discount) * (1 + "
+       "l_tax)) AS sum_charge, AVG(l_quantity) AS avg_qty, AVG(l_extendedprice) AS "
+       "avg_price, AVG(l_discount) AS avg_disc, COUNT(*) AS count_order FROM lineitem "
+       "WHERE l_shipdate <= DATE '1998-09-02' GROUP BY l_returnflag, l_linestatus "
+       "ORDER BY l_returnflag, l_linestatus;"},
+      {"Q3",
+       "SELECT l_orderkey, SUM(l_extendedprice * (1 - l_discount)) AS revenue, "
+       "o_orderdate, o_shippriority FROM customer, orders, lineitem WHERE c_mktsegment "
+       "= 'BUILDING' AND c_custkey = o_custkey AND l_orderkey = o_orderkey AND "
+       "o_orderdate < DATE '1995-03-15' AND l_shipdate > DATE '1995-03-15' GROUP BY "
+       "l_orderkey, o_orderdate, o_shippriority ORDER BY revenue DESC, o_orderdate "
+       "LIMIT 10;"},
+      {"Q5",
+       "SELECT n_name, SUM(l_extendedprice * (1 - l_discount)) AS revenue FROM "
+       "customer, orders, lineitem, supplier, nation, region WHERE c_custkey = "
+       "o_custkey AND l_orderkey = o_orderkey AND l_suppkey = s_suppkey AND c_nationkey "
+       "= s_nationkey AND s_nationkey = n_nationkey AND n_regionkey = r_regionkey AND "
+       "r_name = 'ASIA' AND o_orderdate >= DATE '1994-01-01' AND o_orderdate < DATE "
+       "'1995-01-01' GROUP BY n_name ORDER BY revenue DESC;"},
+      {"Q6",
+       "SELECT SUM(l_extendedprice * l_discount) AS revenue FROM lineitem WHERE "
+       "l_shipdate >= DATE '1994-01-01' AND l_shipdate < DATE '1995-01-01' AND "
+       "l_discount BETWEEN 0.05 AND 0.07 AND l_quantity < 24;"},
+      {"Q10",
+       "SELECT c_custkey, c_name, SUM(l_extendedprice * (1 - l_discount)) AS revenue, "
+       "c_acctbal, n_name FROM customer, orders, lineitem, nation WHERE c_custkey = "
+       "o_custkey AND l_orderkey = o_orderkey AND o_orderdate >= DATE '1993-10-01' AND "
+       "o_orderdate < DATE '1994-01-01' AND l_returnflag = 'R' AND c_nationkey = "
+       "n_nationkey GROUP BY c_custkey, c_name, c_acctbal, n_name ORDER BY revenue DESC "
+       "LIMIT 20;"},
+      {"Q12",
+       "SELECT l_shipmode, SUM(CASE WHEN o_orderpriority = '1-URGENT' OR "
+       "o_orderpriority = '2-HIGH' THEN 1 ELSE 0 END) AS high_line_count, SUM(CASE WHEN "
+       "o_orderpriority <> '1-URGENT' AND o_orderpriority <> '2-HIGH' THEN 1 ELSE 0 "
+       "END) AS low_line_count FROM orders, lineitem WHERE o_orderkey = l_orderkey AND "
+       "l_shipmode IN ('MAIL', 'SHIP') AND l_commitdate < l_receiptdate AND l_shipdate "
+       "< l_commitdate AND l_receiptdate >= DATE '1994-01-01' AND l_receiptdate < DATE "
+       "'1995-01-01' GROUP BY l_shipmode ORDER BY l_shipmode;"}};
+  return suite;
+}
+
+void load_table(const BenchmarkTable& table) {
+  QR::get()->runDDLStatement("DROP TABLE IF EXISTS " + table.name + ";");
+  QR::get()->runDDLStatement(table.ddl);
+  auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(table.name);
+  CHECK(td);
+  auto loader = QR::get()->getLoader(td);
+  CHECK(loader);
+  const auto& col_descs = loader->get_column_descs();
+  std::mt19937_64 rng(std::hash<std::string>()(table.name));
+  const auto load_ms = measure<>::execution([&]() {
+    for (size_t batch_start = 0; batch_start < table.row_count;
+         batch_start += kLoadBatchRows) {
+      const auto batch_end = std::min(batch_start + kLoadBatchRows, table.row_count);
+      std::vector<std::unique_ptr<import_export::TypedImportBuffer>> import_buffers;
+      for (const auto cd : col_descs) {
+        import_buffers.push_back(std::make_unique<import_export::TypedImportBuffer>(
+            cd, loader->getStringDict(cd)));
+      }
+      for (size_t row_idx = batch_start; row_idx < batch_end; ++row_idx) {
+        const auto values = table.get_row(row_idx, rng);
+        CHECK_EQ(values.size(), col_descs.size());
+        size_t col_idx = 0;
+        for (const auto cd : col_descs) {
+          import_buffers[col_idx]->add_value(
+              cd, values[col_idx], /*is_null=*/false, import_export::CopyParams());
+          ++col_idx;
+        }
+      }
+      loader->load(import_buffers, batch_end - batch_start);
+    }
+  });
+  std::cout << "Loaded " << table.row_count << " rows into " << table.name << " in "
+            << load_ms << " ms" << std::endl;
+}
+
+// Drops the data of the buffer pools, the compiled queries and the join hash tables.
+void clear_caches() {
+  QR::get()->clearCpuMemory();
+  if (QR::get()->gpusPresent()) {
+    QR::get()->clearGpuMemory();
+  }
+  Executor::nukeCacheOfExecutors();
+  JoinHashTable::yieldCacheInvalidator()();
+  BaselineJoinHashTable::yieldCacheInvalidator()();
+}
+
+struct QueryLatencies {
+  std::string query;
+  std::string device;
+  std::vector<double> latencies_ms;
+
+  // nearest rank
+  double percentile(const double p) const {
+    CHECK(!latencies_ms.empty());
+    auto sorted = latencies_ms;
+    std::sort(sorted.begin(), sorted.end());
+    const auto rank = static_cast<size_t>(std::ceil(p / 100. * sorted.size()));
+    return sorted[std::max(rank, size_t(1)) - 1];
+  }
+
+  double mean() const {
+    double sum{0};
+    for (const auto latency : latencies_ms) {
+      sum += latency;
+    }
+    return sum / latencies_ms.size();
+  }
+};
+
+void write_json(const std::string& path,
+                const std::string& suite,
+                const double scale_factor,
+                const bool cold,
+                const std::vector<QueryLatencies>& results) {
+  std::ofstream os(path);
+  os << "{\n  \"suite\": \"" << suite << "\",\n  \"scale_factor\": " << scale_factor
+     << ",\n  \"cold\": " << (cold ? "true" : "false") << ",\n  \"queries\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& result = results[i];
+    os << "    {\"query\": \"" << result.query << "\", \"device\": \"" << result.device
+       << "\", \"iterations\": " << result.latencies_ms.size()
+       << ", \"min_ms\": " << result.percentile(0) << ", \"p50_ms\": "
+       << result.percentile(50) << ", \"p90_ms\": " << result.percentile(90)
+       << ", \"p99_ms\": " << result.percentile(99)
+       << ", \"max_ms\": " << result.percentile(100) << ", \"mean_ms\": "
+       << result.mean() << ", \"latencies_ms\": [";
+    for (size_t j = 0; j < result.latencies_ms.size(); ++j) {
+      os << (j ? ", " : "") << result.latencies_ms[j];
+    }
+    os << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string db_path;
+  std::string suite_name{"ssb"};
+  double scale_factor{0.1};
+  size_t iterations{10};
+  std::vector<std::string> devices;
+  std::string json_path;
+
+  namespace po = boost::program_options;
+  po::options_description desc("Options");
+  desc.add_options()("help", "Print this help")(
+      "path", po::value<std::string>(&db_path)->required(), "Directory path to catalogs")(
+      "suite",
+      po::value<std::string>(&suite_name)->default_value(suite_name),
+      "Query set to run: ssb or tpch")(
+      "scale-factor",
+      po::value<double>(&scale_factor)->default_value(scale_factor),
+      "Scale factor of the generated tables")(
+      "iterations",
+      po::value<size_t>(&iterations)->default_value(iterations),
+      "Measured runs of each query")(
+      "device",
+      po::value<std::vector<std::string>>(&devices)->composing(),
+      "Device to run the queries on, cpu or gpu, can be repeated (cpu by default)")(
+      "cold",
+      "Clear the buffer pools, the code caches and the join hash tables before every "
+      "run, instead of running each query once unmeasured to warm them up")(
+      "skip-load",
+      "Query the tables loaded by a previous run instead of generating them")(
+      "json", po::value<std::string>(&json_path), "Write the latencies to this file");
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
+    if (vm.count("help")) {
+      std::cout << desc << std::endl;
+      return 0;
+    }
+    po::notify(vm);
+  } catch (po::error& err) {
+    std::cerr << err.what() << std::endl;
+    return 1;
+  }
+  if (suite_name != "ssb" && suite_name != "tpch") {
+    std::cerr << "Unknown suite " << suite_name << std::endl;
+    return 1;
+  }
+  if (devices.empty()) {
+    devices.emplace_back("cpu");
+  }
+  const bool cold = vm.count("cold");
+
+  logger::LogOptions log_options(argv[0]);
+  log_options.severity_ = logger::Severity::ERROR;
+  log_options.set_base_path(db_path);
+  logger::init(log_options);
+
+  QR::init(db_path.c_str());
+  const auto suite = suite_name == "ssb" ? make_ssb_suite(scale_factor)
+                                         : make_tpch_suite(scale_factor);
+  if (!vm.count("skip-load")) {
+    for (const auto& table : suite.tables) {
+      load_table(table);
+    }
+  }
+
+  std::vector<QueryLatencies> results;
+  for (const auto& device : devices) {
+    if (device != "cpu" && device != "gpu") {
+      std::cerr << "Unknown device " << device << std::endl;
+      return 1;
+    }
+    if (device == "gpu" && !QR::get()->gpusPresent()) {
+      std::cerr << "No GPU available, skipping the GPU runs" << std::endl;
+      continue;
+    }
+    const auto device_type =
+        device == "gpu" ? ExecutorDeviceType::GPU : ExecutorDeviceType::CPU;
+    for (const auto& query : suite.queries) {
+      QueryLatencies result{query.name, device, {}};
+      auto run = [&query, device_type]() {
+        return measure<std::chrono::microseconds>::execution([&]() {
+                 QR::get()->runSQL(query.sql, device_type, true, false);
+               }) /
+               1000.;
+      };
+      if (!cold) {
+        run();
+      }
+      for (size_t i = 0; i < iterations; ++i) {
+        if (cold) {
+          clear_caches();
+        }
+        result.latencies_ms.push_back(run());
+      }
+      std::cout << std::setw(6) << query.name << " " << device << std::fixed
+                << std::setprecision(2) << "  p50 " << result.percentile(50) << " ms"
+                << "  p90 " << result.percentile(90) << " ms"
+                << "  p99 " << result.percentile(99) << " ms"
+                << "  max " << result.percentile(100) << " ms" << std::endl;
+      results.push_back(std::move(result));
+    }
+  }
+  if (!json_path.empty()) {
+    write_json(json_path, suite_name, scale_factor, cold, results);
+  }
+  return 0;
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    EngineMicroBenchmarks.cpp
+ * @brief   Microbenchmarks of the hot paths of the engine, to catch regressions.
+ *
+ * Run with --benchmark_out=<file> --benchmark_out_format=json for machine readable
+ * results, as the microbenchmarks target does.
+ */
+
+#include "TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+
+#include <limits>
+#include <mutex>
+#include <random>
+
+#include "../DataMgr/FileMgr/GlobalFileMgr.h"
+#include "../ImportExport/DelimitedParserUtils.h"
+#include "../ImportExport/Importer.h"
+#include "../Logger/Logger.h"
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/JoinHashTable/BaselineJoinHashTable.h"
+#include "../QueryEngine/JoinHashTable/JoinHashTable.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryEngine/ResultSetReductionJIT.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/scope.h"
+#include "../StringDictionary/StringDictionary.h"
+#include "ResultSetTestUtils.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+extern bool g_cache_string_hash;
+
+using QR = QueryRunner::QueryRunner;
+
+namespace {
+
+std::once_flag setup_flag;
+void global_setup() {
+  TestHelpers::init_logger_stderr_only();
+  QR::init(BASE_PATH);
+}
+
+std::shared_ptr<ResultSet> run_query(const std::string& query_str) {
+  return QR::get()->runSQL(query_str,
+                           ExecutorDeviceType::CPU,
+                           /*hoist_literals=*/true,
+                           /*allow_loop_joins=*/false);
+}
+
+// Loads `row_count` rows of comma separated values made by `get_row` into `table_name`.
+void load_rows(const std::string& table_name,
+               const size_t row_count,
+               const std::function<std::vector<std::string>(const size_t)>& get_row) {
+  auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(table_name);
+  CHECK(td);
+  auto loader = QR::get()->getLoader(td);
+  CHECK(loader);
+  const auto& col_descs = loader->get_column_descs();
+  std::vector<std::unique_ptr<import_export::TypedImportBuffer>> import_buffers;
+  for (const auto cd : col_descs) {
+    import_buffers.push_back(std::make_unique<import_export::TypedImportBuffer>(
+        cd, loader->getStringDict(cd)));
+  }
+  for (size_t row_idx = 0; row_idx < row_count; ++row_idx) {
+    const auto values = get_row(row_idx);
+    CHECK_EQ(values.size(), col_descs.size());
+    size_t col_idx = 0;
+    for (const auto cd : col_descs) {
+      import_buffers[col_idx]->add_value(
+          cd, values[col_idx], /*is_null=*/false, import_export::CopyParams());
+      ++col_idx;
+    }
+  }
+  loader->load(import_buffers, row_count);
+}
+
+std::vector<std::string> make_strings(const size_t count, const size_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> char_dist('a', 'z');
+  std::uniform_int_distribution<size_t> length_dist(4, 24);
+  std::vector<std::string> strings(count);
+  for (auto& str : strings) {
+    str.resize(length_dist(rng));
+    for (auto& c : str) {
+      c = char_dist(rng);
+    }
+  }
+  return strings;
+}
+
+}  // namespace
+
+// StringDictionary
+
+static void StringDictionaryGetOrAddBulk(benchmark::State& state) {
+  const auto strings = make_strings(state.range(0), 1);
+  std::vector<int32_t> ids(strings.size());
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto string_dict =
+        std::make_unique<StringDictionary>(BASE_PATH, true, false, g_cache_string_hash);
+    state.ResumeTiming();
+    string_dict->getOrAddBulk(strings, ids.data());
+    benchmark::DoNotOptimize(ids.data());
+  }
+  state.SetItemsProcessed(state.iterations() * strings.size());
+}
+
+BENCHMARK(StringDictionaryGetOrAddBulk)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+static void StringDictionaryGetLike(benchmark::State& state) {
+  const auto strings = make_strings(state.range(0), 2);
+  StringDictionary string_dict(BASE_PATH, true, false, g_cache_string_hash);
+  std::vector<int32_t> ids(strings.size());
+  string_dict.getOrAddBulk(strings, ids.data());
+  const auto generation = string_dict.storageEntryCount();
+  const auto patterns = make_strings(1000, 3);
+  size_t pattern_idx = 0;
+  for (auto _ : state) {
+    // a pattern the dictionary hasn't cached the matches of yet
+    const auto pattern = "%" + patterns[pattern_idx % patterns.size()].substr(0, 3) +
+                         std::to_string(pattern_idx / patterns.size()) + "%";
+    ++pattern_idx;
+    benchmark::DoNotOptimize(
+        string_dict.getLike(pattern, false, false, '\\', generation));
+  }
+  state.SetItemsProcessed(state.iterations() * strings.size());
+}
+
+BENCHMARK(StringDictionaryGetLike)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+// Hash joins
+
+class HashJoinFixture : public benchmark::Fixture {
+ public:
+  static constexpr size_t kDimRows{10000};
+
+  void SetUp(const ::benchmark::State& state) override {
+    std::call_once(setup_flag, global_setup);
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS bench_join_fact;");
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS bench_join_dim;");
+    QR::get()->runDDLStatement(
+        "CREATE TABLE bench_join_fact (x INT, y INT) WITH (FRAGMENT_SIZE=1000000);");
+    QR::get()->runDDLStatement("CREATE TABLE bench_join_dim (x INT, y INT);");
+    load_rows("bench_join_fact", state.range(0), [](const size_t row_idx) {
+      return std::vector<std::string>{std::to_string(row_idx * 7 % kDimRows),
+                                      std::to_string(row_idx % 10)};
+    });
+    load_rows("bench_join_dim", kDimRows, [](const size_t row_idx) {
+      return std::vector<std::string>{std::to_string(row_idx),
+                                      std::to_string(row_idx % 10)};
+    });
+    run_query("SELECT COUNT(*) FROM bench_join_fact;");
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    JoinHashTable::yieldCacheInvalidator()();
+    BaselineJoinHashTable::yieldCacheInvalidator()();
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS bench_join_fact;");
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS bench_join_dim;");
+  }
+
+  void runJoin(benchmark::State& state, const std::string& query, const bool build) {
+    for (auto _ : state) {
+      if (build) {
+        state.PauseTiming();
+        JoinHashTable::yieldCacheInvalidator()();
+        BaselineJoinHashTable::yieldCacheInvalidator()();
+        state.ResumeTiming();
+      }
+      benchmark::DoNotOptimize(run_query(query));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+};
+
+// On the one column of a dense range, a perfect hash table.
+const std::string kPerfectJoinQuery{
+    "SELECT COUNT(*) FROM bench_join_fact f JOIN bench_join_dim d ON f.x = d.x;"};
+// On two columns, a baseline hash table.
+const std::string kBaselineJoinQuery{
+    "SELECT COUNT(*) FROM bench_join_fact f JOIN bench_join_dim d ON f.x = d.x AND "
+    "f.y = d.y;"};
+
+BENCHMARK_DEFINE_F(HashJoinFixture, PerfectBuildAndProbe)(benchmark::State& state) {
+  runJoin(state, kPerfectJoinQuery, true);
+}
+
+BENCHMARK_DEFINE_F(HashJoinFixture, PerfectProbe)(benchmark::State& state) {
+  runJoin(state, kPerfectJoinQuery, false);
+}
+
+BENCHMARK_DEFINE_F(HashJoinFixture, BaselineBuildAndProbe)(benchmark::State& state) {
+  runJoin(state, kBaselineJoinQuery, true);
+}
+
+BENCHMARK_DEFINE_F(HashJoinFixture, BaselineProbe)(benchmark::State& state) {
+  runJoin(state, kBaselineJoinQuery, false);
+}
+
+BENCHMARK_REGISTER_F(HashJoinFixture, PerfectBuildAndProbe)
+    ->Range(1 << 16, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(HashJoinFixture, PerfectProbe)
+    ->Range(1 << 16, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(HashJoinFixture, BaselineBuildAndProbe)
+    ->Range(1 << 16, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(HashJoinFixture, BaselineProbe)
+    ->Range(1 << 16, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+
+// Result set reduction
+
+static void ResultSetReduction(benchmark::State& state) {
+  const bool use_interpreter = state.range(1);
+  ScopeGuard reset_threshold = [orig = g_reduction_interp_threshold] {
+    g_reduction_interp_threshold = orig;
+  };
+  g_reduction_interp_threshold = use_interpreter ? std::numeric_limits<size_t>::max() : 0;
+  const auto target_infos =
+      generate_custom_agg_target_infos({8},
+                                       {kSUM, kCOUNT, kMIN, kMAX},
+                                       {kBIGINT, kBIGINT, kDOUBLE, kBIGINT},
+                                       {kBIGINT, kBIGINT, kDOUBLE, kBIGINT});
+  const auto query_mem_desc =
+      perfect_hash_one_col_desc(target_infos, 8, 0, state.range(0) - 1);
+  const auto row_set_mem_owner =
+      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<std::unique_ptr<ResultSet>> result_sets;
+    for (size_t i = 0; i < 2; ++i) {
+      result_sets.push_back(std::make_unique<ResultSet>(target_infos,
+                                                        ExecutorDeviceType::CPU,
+                                                        query_mem_desc,
+                                                        row_set_mem_owner,
+                                                        nullptr));
+      const auto storage = result_sets.back()->allocateStorage();
+      EvenNumberGenerator generator;
+      fill_storage_buffer(
+          storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 1);
+    }
+    std::vector<ResultSet*> storage_set{result_sets[0].get(), result_sets[1].get()};
+    ResultSetManager rs_manager;
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(rs_manager.reduce(storage_set));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(ResultSetReduction)
+    ->ArgNames({"entries", "interpreter"})
+    ->Ranges({{1 << 10, 1 << 20}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Delimited parser
+
+static void DelimitedParserGetRow(benchmark::State& state) {
+  const size_t row_count = state.range(0);
+  std::string buffer;
+  for (size_t row_idx = 0; row_idx < row_count; ++row_idx) {
+    buffer += std::to_string(row_idx) + ",\"quoted, text " + std::to_string(row_idx) +
+              "\"," + std::to_string(row_idx * 0.5) + ",2020-01-01 00:00:00\n";
+  }
+  import_export::CopyParams copy_params;
+  const bool is_array[4]{false, false, false, false};
+  std::vector<std::string_view> row;
+  for (auto _ : state) {
+    const char* buf_end = buffer.data() + buffer.size();
+    bool try_single_thread{false};
+    for (const char* p = buffer.data(); p < buf_end; ++p) {
+      row.clear();
+      std::vector<std::unique_ptr<char[]>> tmp_buffers;
+      p = import_export::delimited_parser::get_row(p,
+                                                   buf_end,
+                                                   buf_end,
+                                                   copy_params,
+                                                   is_array,
+                                                   row,
+                                                   tmp_buffers,
+                                                   try_single_thread);
+      benchmark::DoNotOptimize(row.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * row_count);
+  state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+BENCHMARK(DelimitedParserGetRow)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+// FileMgr
+
+class FileMgrFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    std::call_once(setup_flag, global_setup);
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS bench_file_mgr;");
+    QR::get()->runDDLStatement(
+        "CREATE TABLE bench_file_mgr (x BIGINT) WITH (FRAGMENT_SIZE=32000000);");
+    load_rows("bench_file_mgr", state.range(0), [](const size_t row_idx) {
+      return std::vector<std::string>{std::to_string(row_idx)};
+    });
+    auto cat = QR::get()->getCatalog();
+    const auto td = cat->getMetadataForTable("bench_file_mgr");
+    const auto cd = cat->getMetadataForColumn(td->tableId, "x");
+    chunk_key_ = {cat->getCurrentDB().dbId, td->tableId, cd->columnId, 0};
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS bench_file_mgr;");
+  }
+
+ protected:
+  ChunkKey chunk_key_;
+};
+
+// Reads all the pages of a chunk from its files, through the page cache of the OS.
+BENCHMARK_DEFINE_F(FileMgrFixture, ReadChunkPages)(benchmark::State& state) {
+  auto gfm = QR::get()->getCatalog()->getDataMgr().getGlobalFileMgr();
+  const auto num_bytes = gfm->getBuffer(chunk_key_)->size();
+  std::vector<int8_t> dest(num_bytes);
+  for (auto _ : state) {
+    gfm->getBuffer(chunk_key_)->read(dest.data(), num_bytes);
+    benchmark::DoNotOptimize(dest.data());
+  }
+  state.SetBytesProcessed(state.iterations() * num_bytes);
+}
+
+BENCHMARK_REGISTER_F(FileMgrFixture, ReadChunkPages)
+    ->Range(1 << 16, 1 << 22)
+    ->Unit(benchmark::kMillisecond);
+
+// Code generation
+
+class CodegenFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    std::call_once(setup_flag, global_setup);
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS bench_codegen;");
+    QR::get()->runDDLStatement(
+        "CREATE TABLE bench_codegen (x INT, y DOUBLE, str TEXT ENCODING DICT(32));");
+    load_rows("bench_codegen", 100, [](const size_t row_idx) {
+      return std::vector<std::string>{std::to_string(row_idx),
+                                      std::to_string(row_idx * 0.5),
+                                      "str" + std::to_string(row_idx % 10)};
+    });
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    QR::get()->runDDLStatement("DROP TABLE IF EXISTS bench_codegen;");
+  }
+
+  // The table is small enough for the time to be the one of compiling the query.
+  void compile(benchmark::State& state, const std::string& query) {
+    for (auto _ : state) {
+      state.PauseTiming();
+      Executor::nukeCacheOfExecutors();
+      state.ResumeTiming();
+      benchmark::DoNotOptimize(run_query(query));
+    }
+  }
+};
+
+BENCHMARK_DEFINE_F(CodegenFixture, Projection)(benchmark::State& state) {
+  compile(state, "SELECT x, y * 2 FROM bench_codegen WHERE x > 10;");
+}
+
+BENCHMARK_DEFINE_F(CodegenFixture, Aggregate)(benchmark::State& state) {
+  compile(state, "SELECT SUM(x), AVG(y), COUNT(*) FROM bench_codegen WHERE y < 20;");
+}
+
+BENCHMARK_DEFINE_F(CodegenFixture, GroupBy)(benchmark::State& state) {
+  compile(state,
+          "SELECT str, COUNT(*), MAX(y) FROM bench_codegen GROUP BY str ORDER BY str;");
+}
+
+BENCHMARK_DEFINE_F(CodegenFixture, CaseAndStrings)(benchmark::State& state) {
+  compile(state,
+          "SELECT CASE WHEN x % 2 = 0 THEN 'even' ELSE 'odd' END, COUNT(*) FROM "
+          "bench_codegen WHERE str LIKE 'str%' GROUP BY 1;");
+}
+
+BENCHMARK_DEFINE_F(CodegenFixture, SelfJoin)(benchmark::State& state) {
+  compile(state,
+          "SELECT COUNT(*) FROM bench_codegen a JOIN bench_codegen b ON a.x = b.x;");
+}
+
+BENCHMARK_REGISTER_F(CodegenFixture, Projection)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(CodegenFixture, Aggregate)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(CodegenFixture, GroupBy)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(CodegenFixture, CaseAndStrings)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(CodegenFixture, SelfJoin)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
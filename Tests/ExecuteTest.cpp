@@ -17,11 +17,14 @@
 #include "TestHelpers.h"
 
 #include "../ImportExport/Importer.h"
+#include "../LockMgr/LockMgr.h"
 #include "../Parser/parser.h"
 #include "../QueryEngine/ArrowResultSet.h"
 #include "../QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
+#include "../QueryEngine/DeviceCostModel.h"
 #include "../QueryEngine/Execute.h"
 #include "../QueryEngine/ResultSetReductionJIT.h"
+#include "../QueryEngine/SharedScan.h"
 #include "../QueryRunner/QueryRunner.h"
 #include "../Shared/StringTransform.h"
 #include "../Shared/scope.h"
@@ -62,11 +65,34 @@ extern bool g_enable_calcite_view_optimize;
 extern bool g_enable_bump_allocator;
 extern bool g_enable_interop;
 extern bool g_enable_union;
+extern bool g_enable_parallel_union_branches;
+extern bool g_enable_common_subplan_elimination;
 
 extern size_t g_leaf_count;
 extern bool g_cluster;
 
 extern bool g_is_test_env;
+extern bool g_enable_cpu_vectorization;
+extern bool g_enable_join_fragment_pairing;
+extern bool g_enable_lazy_fetch_through_outer_joins;
+extern bool g_enable_tree_reduction;
+extern size_t g_chunk_prefetch_window;
+extern bool g_enable_work_stealing_kernel_dispatch;
+extern bool g_enable_cpu_multifrag_kernels;
+extern bool g_enable_streaming_reduction;
+extern bool g_enable_delete_metadata_skipping;
+extern bool g_enable_parallel_fragment_updates;
+extern bool g_enable_inplace_string_updates;
+extern bool g_enable_nonblocking_fragment_drops;
+extern bool g_enable_column_page_sizing;
+extern size_t g_cpu_multifrag_kernel_min_rows;
+extern bool g_enable_expression_fragment_skipping;
+extern bool g_enable_expression_interpreter;
+extern bool g_enable_ndv_sampling;
+extern size_t g_ndv_sample_fragment_count;
+extern bool g_enable_top_k_group_pruning;
+extern bool g_enable_packed_group_keys;
+extern bool g_enable_band_joins;
 
 using QR = QueryRunner::QueryRunner;
 
@@ -798,6 +824,74 @@ TEST(Insert, DictBoundary) {
   }
 }
 
+TEST(Insert, MaxRowsWhileReading) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto save_nonblocking = g_enable_nonblocking_fragment_drops;
+  ScopeGuard reset_state = [&save_nonblocking] {
+    g_enable_nonblocking_fragment_drops = save_nonblocking;
+  };
+  g_enable_nonblocking_fragment_drops = true;
+
+  const auto dt = ExecutorDeviceType::CPU;
+  run_ddl_statement("DROP TABLE IF EXISTS max_rows_reading;");
+  run_ddl_statement(
+      "CREATE TABLE max_rows_reading (i INT) WITH (fragment_size = 2, max_rows = 4);");
+  for (int i = 1; i <= 4; ++i) {
+    run_multiple_agg("INSERT INTO max_rows_reading VALUES (" + std::to_string(i) + ");",
+                     dt);
+  }
+  {
+    // a query holding the table doesn't stall the inserts dropping its first fragment
+    auto& cat = QR::get()->getSession()->getCatalog();
+    const auto read_lock =
+        lockmgr::TableDataLockMgr::getReadLockForTable(cat, "max_rows_reading");
+    run_multiple_agg("INSERT INTO max_rows_reading VALUES (5);", dt);
+    run_multiple_agg("INSERT INTO max_rows_reading VALUES (6);", dt);
+  }
+  ASSERT_EQ(4,
+            v<int64_t>(run_simple_agg("SELECT count(*) FROM max_rows_reading;", dt)));
+  ASSERT_EQ(3, v<int64_t>(run_simple_agg("SELECT min(i) FROM max_rows_reading;", dt)));
+  run_multiple_agg("INSERT INTO max_rows_reading VALUES (7);", dt);
+  ASSERT_EQ(3,
+            v<int64_t>(run_simple_agg("SELECT count(*) FROM max_rows_reading;", dt)));
+  ASSERT_EQ(5, v<int64_t>(run_simple_agg("SELECT min(i) FROM max_rows_reading;", dt)));
+  run_ddl_statement("DROP TABLE max_rows_reading;");
+}
+
+TEST(Insert, ColumnPageSizing) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto save_page_sizing = g_enable_column_page_sizing;
+  ScopeGuard reset_state = [&save_page_sizing] {
+    g_enable_column_page_sizing = save_page_sizing;
+  };
+  g_enable_column_page_sizing = true;
+
+  const auto dt = ExecutorDeviceType::CPU;
+  run_ddl_statement("DROP TABLE IF EXISTS column_page_sizing;");
+  run_ddl_statement(
+      "CREATE TABLE column_page_sizing (b BOOLEAN, i INT, d DOUBLE, t TEXT ENCODING "
+      "NONE, a INT[]) WITH (fragment_size = 3);");
+  for (int i = 0; i < 10; ++i) {
+    const auto i_str = std::to_string(i);
+    run_multiple_agg("INSERT INTO column_page_sizing VALUES (" +
+                         std::string(i % 2 ? "'t'" : "'f'") + ", " + i_str + ", " +
+                         i_str + ".5, '" + i_str + "', {" + i_str + ", " + i_str + "});",
+                     dt);
+  }
+  ASSERT_EQ(45, v<int64_t>(run_simple_agg("SELECT sum(i) FROM column_page_sizing;", dt)));
+  ASSERT_EQ(50, v<double>(run_simple_agg("SELECT sum(d) FROM column_page_sizing;", dt)));
+  ASSERT_EQ(5,
+            v<int64_t>(run_simple_agg(
+                "SELECT count(*) FROM column_page_sizing WHERE b = 't';", dt)));
+  ASSERT_EQ(1,
+            v<int64_t>(run_simple_agg(
+                "SELECT count(*) FROM column_page_sizing WHERE t = '7';", dt)));
+  ASSERT_EQ(90,
+            v<int64_t>(run_simple_agg(
+                "SELECT sum(a[1] + a[2]) FROM column_page_sizing;", dt)));
+  run_ddl_statement("DROP TABLE column_page_sizing;");
+}
+
 TEST(KeyForString, KeyForString) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -989,6 +1083,35 @@ TEST(Select, NullGroupBy) {
   }
 }
 
+TEST(Select, VectorizedCpuFilterAndAggregation) {
+  const auto enable_cpu_vectorization = g_enable_cpu_vectorization;
+  ScopeGuard reset_cpu_vectorization = [&enable_cpu_vectorization] {
+    g_enable_cpu_vectorization = enable_cpu_vectorization;
+  };
+  g_enable_cpu_vectorization = true;
+  const auto dt = ExecutorDeviceType::CPU;
+  c("SELECT COUNT(*) FROM test WHERE x > 7;", dt);
+  c("SELECT COUNT(*) FROM test WHERE x = 7 AND y <> 42;", dt);
+  c("SELECT SUM(x + y) FROM test WHERE z > 100;", dt);
+  c("SELECT MIN(x), MAX(y), SUM(t) FROM test WHERE y > 41;", dt);
+  c("SELECT SUM(ff), COUNT(fn) FROM test WHERE x < 8;", dt);
+  c("SELECT COUNT(*) FROM test WHERE smallint_nulls IS NULL;", dt);
+}
+
+TEST(Select, StreamingReduction) {
+  const auto enable_streaming_reduction = g_enable_streaming_reduction;
+  ScopeGuard reset_streaming_reduction = [&enable_streaming_reduction] {
+    g_enable_streaming_reduction = enable_streaming_reduction;
+  };
+  g_enable_streaming_reduction = true;
+  const auto dt = ExecutorDeviceType::CPU;
+  c("SELECT COUNT(*), SUM(x), MIN(y), MAX(z), AVG(t) FROM test;", dt);
+  c("SELECT SUM(ff), COUNT(fn), AVG(dd) FROM test WHERE x < 8;", dt);
+  c("SELECT x, COUNT(*), SUM(y) FROM test GROUP BY x ORDER BY x;", dt);
+  c("SELECT x, y, MIN(z), MAX(t) FROM test GROUP BY x, y ORDER BY x, y;", dt);
+  c("SELECT COUNT(*) FROM test WHERE x > 100;", dt);
+}
+
 TEST(Select, FilterAndSimpleAggregation) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2246,6 +2369,172 @@ TEST(Select, ApproxCountDistinct) {
   }
 }
 
+TEST(Select, ApproxQuantile) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // x is 7 in 15 rows and 8 in 5, small inputs are kept exactly by the t-digest
+    ASSERT_EQ(7,
+              v<double>(run_simple_agg("SELECT APPROX_QUANTILE(x, 0) FROM test;", dt)));
+    ASSERT_EQ(7,
+              v<double>(run_simple_agg("SELECT APPROX_QUANTILE(x, 0.5) FROM test;", dt)));
+    ASSERT_EQ(8,
+              v<double>(run_simple_agg("SELECT APPROX_QUANTILE(x, 1) FROM test;", dt)));
+    ASSERT_EQ(
+        2.2, v<double>(run_simple_agg("SELECT APPROX_QUANTILE(d, 0.25) FROM test;", dt)));
+    ASSERT_NEAR(
+        111.1,
+        v<double>(run_simple_agg("SELECT APPROX_QUANTILE(dd, 0.25) FROM test;", dt)),
+        0.001);
+    // nulls are skipped
+    ASSERT_EQ(-2002.4,
+              v<double>(run_simple_agg("SELECT APPROX_QUANTILE(dn, 0) FROM test;", dt)));
+    ASSERT_EQ(
+        NULL_DOUBLE,
+        v<double>(run_simple_agg("SELECT APPROX_QUANTILE(x, 0.5) FROM test_empty;", dt)));
+    {
+      const auto rows = run_multiple_agg(
+          "SELECT x, APPROX_QUANTILE(d, 0.5) AS q FROM test GROUP BY x ORDER BY q DESC;",
+          dt);
+      ASSERT_EQ(size_t(2), rows->rowCount());
+      auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(8, v<int64_t>(crt_row[0]));
+      ASSERT_EQ(2.4, v<double>(crt_row[1]));
+      crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(7, v<int64_t>(crt_row[0]));
+      ASSERT_EQ(2.2, v<double>(crt_row[1]));
+    }
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_QUANTILE(x, 1.5) FROM test;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_QUANTILE(str, 0.5) FROM test;", dt),
+                 std::runtime_error);
+  }
+}
+
+TEST(Select, GroupBySortedColumn) {
+  run_ddl_statement("DROP TABLE IF EXISTS test_sorted_group_by;");
+  run_ddl_statement(
+      "CREATE TABLE test_sorted_group_by (k BIGINT, y INT, v INT) WITH "
+      "(sort_column='k');");
+  // the range of k is too wide for a perfect hash, each insert is sorted on its own
+  for (const auto& values : {"(10000000000, 1, 1), (1, 2, 2), (10000000000, 1, 3)",
+                             "(1, 2, 4), (-10000000000, 1, 5), (1, 3, 6)"}) {
+    run_multiple_agg("INSERT INTO test_sorted_group_by VALUES " + std::string(values) +
+                         ";",
+                     ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    const std::vector<std::vector<int64_t>> expected{
+        {-10000000000, 1, 1, 5}, {1, 2, 2, 6}, {1, 3, 1, 6}, {10000000000, 1, 2, 4}};
+    const auto rows = run_multiple_agg(
+        "SELECT k, y, COUNT(*), SUM(v) FROM test_sorted_group_by GROUP BY k, y ORDER BY "
+        "k, y;",
+        dt);
+    ASSERT_EQ(expected.size(), rows->rowCount());
+    for (const auto& expected_row : expected) {
+      const auto crt_row = rows->getNextRow(true, true);
+      for (size_t i = 0; i < expected_row.size(); ++i) {
+        ASSERT_EQ(expected_row[i], v<int64_t>(crt_row[i]));
+      }
+    }
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS test_sorted_group_by;");
+}
+
+TEST(Select, ZorderColumns) {
+  run_ddl_statement("DROP TABLE IF EXISTS test_zorder;");
+  run_ddl_statement(
+      "CREATE TABLE test_zorder (x INT, y INT, v INT) WITH (fragment_size=4, "
+      "zorder_columns='x, y');");
+  // a 4x4 grid in one insert, z-ordered into the four 2x2 squares of the grid
+  std::vector<std::string> values;
+  for (int i = 0; i < 16; ++i) {
+    const auto cell = (i * 7) % 16;
+    values.push_back("(" + std::to_string(cell / 4) + ", " + std::to_string(cell % 4) +
+                     ", " + std::to_string(cell) + ")");
+  }
+  run_multiple_agg(
+      "INSERT INTO test_zorder VALUES " + boost::algorithm::join(values, ", ") + ";",
+      ExecutorDeviceType::CPU);
+  auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("test_zorder");
+  CHECK(td);
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  ASSERT_EQ(size_t(4), table_info.fragments.size());
+  for (const auto& fragment : table_info.fragments) {
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+    for (const auto& column_name : {"x", "y"}) {
+      const auto cd = cat.getMetadataForColumn(td->tableId, column_name);
+      CHECK(cd);
+      const auto& stats = chunk_metadata_map.at(cd->columnId)->chunkStats;
+      ASSERT_EQ(1, stats.max.intval - stats.min.intval);
+    }
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(120),
+              v<int64_t>(run_simple_agg("SELECT SUM(v) FROM test_zorder;", dt)));
+    ASSERT_EQ(
+        int64_t(2),
+        v<int64_t>(run_simple_agg(
+            "SELECT COUNT(*) FROM test_zorder WHERE x = 2 AND y BETWEEN 1 AND 2;", dt)));
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS test_zorder;");
+}
+
+TEST(Select, IncrementalAggregates) {
+  const auto enable_incremental_aggregates = g_enable_incremental_aggregates;
+  ScopeGuard reset_incremental_aggregates = [&enable_incremental_aggregates] {
+    g_enable_incremental_aggregates = enable_incremental_aggregates;
+    run_ddl_statement("DROP TABLE IF EXISTS test_incremental_agg;");
+  };
+  g_enable_incremental_aggregates = true;
+  run_ddl_statement("DROP TABLE IF EXISTS test_incremental_agg;");
+  run_ddl_statement(
+      "CREATE TABLE test_incremental_agg (k INT, v INT) WITH (fragment_size=2, "
+      "vacuum='delayed');");
+  const auto insert = [](const std::string& values) {
+    run_multiple_agg("INSERT INTO test_incremental_agg VALUES " + values + ";",
+                     ExecutorDeviceType::CPU);
+  };
+  const auto check = [](const std::vector<std::vector<int64_t>>& expected_groups,
+                        const std::vector<int64_t>& expected_totals) {
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      // run twice, the second run reuses the aggregate of the full fragments
+      for (size_t run = 0; run < 2; ++run) {
+        const auto rows = run_multiple_agg(
+            "SELECT k, COUNT(*), SUM(v), MAX(v) FROM test_incremental_agg GROUP BY k "
+            "ORDER BY k;",
+            dt);
+        ASSERT_EQ(expected_groups.size(), rows->rowCount());
+        for (const auto& expected_row : expected_groups) {
+          const auto crt_row = rows->getNextRow(true, true);
+          for (size_t i = 0; i < expected_row.size(); ++i) {
+            ASSERT_EQ(expected_row[i], v<int64_t>(crt_row[i]));
+          }
+        }
+        const auto totals = run_multiple_agg(
+            "SELECT COUNT(*), SUM(v), MIN(v) FROM test_incremental_agg;", dt);
+        const auto crt_row = totals->getNextRow(true, true);
+        for (size_t i = 0; i < expected_totals.size(); ++i) {
+          ASSERT_EQ(expected_totals[i], v<int64_t>(crt_row[i]));
+        }
+      }
+    }
+  };
+  insert("(1, 10)");
+  insert("(3, 20)");
+  insert("(1, 30)");
+  check({{1, 2, 40, 30}, {3, 1, 20, 20}}, {3, 60, 10});
+  insert("(3, 5)");
+  insert("(2, 1)");
+  check({{1, 2, 40, 30}, {2, 1, 1, 1}, {3, 2, 25, 20}}, {5, 66, 1});
+  run_multiple_agg("DELETE FROM test_incremental_agg WHERE v = 30;",
+                   ExecutorDeviceType::CPU);
+  check({{1, 1, 10, 10}, {2, 1, 1, 1}, {3, 2, 25, 20}}, {4, 36, 1});
+}
+
 TEST(Select, ScanNoAggregation) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2410,6 +2699,807 @@ TEST(Select, OrderBy) {
   }
 }
 
+TEST(Select, TopNFragmentPruning) {
+  const auto enable_top_n_fragment_pruning = g_enable_top_n_fragment_pruning;
+  ScopeGuard reset_top_n_fragment_pruning = [&enable_top_n_fragment_pruning] {
+    g_enable_top_n_fragment_pruning = enable_top_n_fragment_pruning;
+    run_ddl_statement("DROP TABLE IF EXISTS test_top_n_pruning;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_top_n_pruning;");
+  run_ddl_statement(
+      "CREATE TABLE test_top_n_pruning (x INT, y INT) WITH (fragment_size=4);");
+  // disjoint ranges of x in the fragments, nulls in the last one
+  for (int i = 0; i < 16; ++i) {
+    run_multiple_agg("INSERT INTO test_top_n_pruning VALUES (" + std::to_string(i) +
+                         ", " + std::to_string(i % 3) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  for (int i = 0; i < 2; ++i) {
+    run_multiple_agg("INSERT INTO test_top_n_pruning VALUES (NULL, 1);",
+                     ExecutorDeviceType::CPU);
+  }
+  const auto null_val = static_cast<int64_t>(inline_int_null_value<int32_t>());
+  const auto check = [](const std::string& query,
+                        const std::vector<int64_t>& expected,
+                        const ExecutorDeviceType dt) {
+    const auto rows = run_multiple_agg(query, dt);
+    ASSERT_EQ(expected.size(), rows->rowCount()) << query;
+    for (const auto expected_x : expected) {
+      const auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(expected_x, v<int64_t>(crt_row[0])) << query;
+    }
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_pruning : {false, true}) {
+      g_enable_top_n_fragment_pruning = enable_pruning;
+      check("SELECT x, y FROM test_top_n_pruning ORDER BY x ASC NULLS LAST LIMIT 3;",
+            {0, 1, 2},
+            dt);
+      check("SELECT x, y FROM test_top_n_pruning ORDER BY x DESC NULLS LAST LIMIT 3;",
+            {15, 14, 13},
+            dt);
+      check("SELECT x, y FROM test_top_n_pruning ORDER BY x ASC NULLS FIRST LIMIT 3;",
+            {null_val, null_val, 0},
+            dt);
+      check(
+          "SELECT x, y FROM test_top_n_pruning ORDER BY x ASC NULLS LAST LIMIT 2 OFFSET "
+          "5;",
+          {5, 6},
+          dt);
+      check(
+          "SELECT x, y FROM test_top_n_pruning WHERE y = 1 ORDER BY x DESC NULLS LAST "
+          "LIMIT 3;",
+          {13, 10, 7},
+          dt);
+    }
+  }
+}
+
+TEST(Select, TopKGroupPruning) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_top_k_group_pruning = g_enable_top_k_group_pruning;
+  ScopeGuard reset_top_k_group_pruning = [&enable_top_k_group_pruning] {
+    g_enable_top_k_group_pruning = enable_top_k_group_pruning;
+    run_ddl_statement("DROP TABLE IF EXISTS test_top_k_groups;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_top_k_groups;");
+  run_ddl_statement(
+      "CREATE TABLE test_top_k_groups (x INT, y INT) WITH (fragment_size=8);");
+  // two large groups in every fragment, the other groups only hold a small value
+  for (int frag_idx = 0; frag_idx < 8; ++frag_idx) {
+    for (int i = 0; i < 6; ++i) {
+      run_multiple_agg("INSERT INTO test_top_k_groups VALUES (" +
+                           std::to_string(10 * frag_idx + i) + ", 1);",
+                       ExecutorDeviceType::CPU);
+    }
+    run_multiple_agg("INSERT INTO test_top_k_groups VALUES (1000, " +
+                         std::to_string(100 + frag_idx) + ");",
+                     ExecutorDeviceType::CPU);
+    run_multiple_agg("INSERT INTO test_top_k_groups VALUES (1001, " +
+                         std::to_string(50 + frag_idx) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  const auto check = [](const std::string& query,
+                        const std::vector<std::pair<int64_t, int64_t>>& expected,
+                        const ExecutorDeviceType dt) {
+    const auto rows = run_multiple_agg(query, dt);
+    ASSERT_EQ(expected.size(), rows->rowCount()) << query;
+    for (const auto& expected_row : expected) {
+      const auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(expected_row.first, v<int64_t>(crt_row[0])) << query;
+      ASSERT_EQ(expected_row.second, v<int64_t>(crt_row[1])) << query;
+    }
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_pruning : {false, true}) {
+      g_enable_top_k_group_pruning = enable_pruning;
+      check(
+          "SELECT x, SUM(y) AS s FROM test_top_k_groups GROUP BY x ORDER BY s DESC "
+          "NULLS LAST LIMIT 2;",
+          {{1000, 828}, {1001, 428}},
+          dt);
+      check(
+          "SELECT x, SUM(y) AS s FROM test_top_k_groups GROUP BY x ORDER BY s DESC "
+          "NULLS LAST LIMIT 1 OFFSET 1;",
+          {{1001, 428}},
+          dt);
+      check(
+          "SELECT x, MAX(y) AS m FROM test_top_k_groups GROUP BY x ORDER BY m DESC "
+          "NULLS LAST LIMIT 2;",
+          {{1000, 107}, {1001, 57}},
+          dt);
+      check(
+          "SELECT x, SUM(y) AS s FROM test_top_k_groups WHERE y < 100 GROUP BY x ORDER "
+          "BY s DESC NULLS LAST LIMIT 1;",
+          {{1001, 428}},
+          dt);
+      check(
+          "SELECT x, SUM(y - 60) AS s FROM test_top_k_groups GROUP BY x ORDER BY s "
+          "DESC NULLS LAST LIMIT 1;",
+          {{1000, 348}},
+          dt);
+    }
+  }
+}
+
+TEST(Select, PackedGroupKeys) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_packed_group_keys = g_enable_packed_group_keys;
+  ScopeGuard reset_packed_group_keys = [&enable_packed_group_keys] {
+    g_enable_packed_group_keys = enable_packed_group_keys;
+    run_ddl_statement("DROP TABLE IF EXISTS test_packed_group_keys;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_packed_group_keys;");
+  run_ddl_statement(
+      "CREATE TABLE test_packed_group_keys (a INT, b SMALLINT, c TEXT ENCODING "
+      "DICT(32));");
+  // the ranges are too wide for a perfect hash, their 26 bits fit in a 4 byte key
+  for (const auto& row : {"10000, 0, 'x'",
+                          "10000, 0, 'x'",
+                          "0, 1000, 'y'",
+                          "NULL, 5, 'x'",
+                          "5, NULL, NULL",
+                          "0, 1000, 'y'"}) {
+    run_multiple_agg(
+        "INSERT INTO test_packed_group_keys VALUES (" + std::string(row) + ");",
+        ExecutorDeviceType::CPU);
+  }
+  const auto null_int = static_cast<int64_t>(inline_int_null_value<int32_t>());
+  const auto null_smallint = static_cast<int64_t>(inline_int_null_value<int16_t>());
+  const std::vector<std::tuple<int64_t, int64_t, std::string, int64_t>> expected{
+      {0, 1000, "y", 2},
+      {5, null_smallint, "", 1},
+      {10000, 0, "x", 2},
+      {null_int, 5, "x", 1}};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_packed_keys : {false, true}) {
+      g_enable_packed_group_keys = enable_packed_keys;
+      const auto rows = run_multiple_agg(
+          "SELECT a, b, c, COUNT(*) FROM test_packed_group_keys GROUP BY a, b, c ORDER "
+          "BY a NULLS LAST, b NULLS LAST;",
+          dt);
+      ASSERT_EQ(expected.size(), rows->rowCount());
+      for (const auto& expected_row : expected) {
+        const auto crt_row = rows->getNextRow(true, true);
+        ASSERT_EQ(std::get<0>(expected_row), v<int64_t>(crt_row[0]));
+        ASSERT_EQ(std::get<1>(expected_row), v<int64_t>(crt_row[1]));
+        if (!std::get<2>(expected_row).empty()) {
+          ASSERT_EQ(std::get<2>(expected_row),
+                    boost::get<std::string>(v<NullableString>(crt_row[2])));
+        }
+        ASSERT_EQ(std::get<3>(expected_row), v<int64_t>(crt_row[3]));
+      }
+      ASSERT_EQ(int64_t(3),
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM (SELECT a, b, c FROM test_packed_group_keys "
+                    "WHERE c IS NOT NULL GROUP BY a, b, c);",
+                    dt)));
+    }
+  }
+}
+
+TEST(Select, BandJoins) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto enable_band_joins = g_enable_band_joins;
+  const auto trivial_loop_join_threshold = g_trivial_loop_join_threshold;
+  ScopeGuard reset_band_joins = [&enable_band_joins, &trivial_loop_join_threshold] {
+    g_enable_band_joins = enable_band_joins;
+    g_trivial_loop_join_threshold = trivial_loop_join_threshold;
+    run_ddl_statement("DROP TABLE IF EXISTS test_band_events;");
+    run_ddl_statement("DROP TABLE IF EXISTS test_band_windows;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_band_events;");
+  run_ddl_statement("DROP TABLE IF EXISTS test_band_windows;");
+  run_ddl_statement("CREATE TABLE test_band_events (ts INT) WITH (fragment_size=4);");
+  run_ddl_statement(
+      "CREATE TABLE test_band_windows (w_start INT, w_end INT, id INT) WITH "
+      "(fragment_size=4);");
+  for (int ts = 0; ts < 20; ++ts) {
+    run_multiple_agg("INSERT INTO test_band_events VALUES (" + std::to_string(ts) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("INSERT INTO test_band_events VALUES (NULL);",
+                   ExecutorDeviceType::CPU);
+  for (const auto& row : {"0, 4, 1", "3, 3, 2", "10, 15, 3", "NULL, 5, 4", "18, 30, 5"}) {
+    run_multiple_agg("INSERT INTO test_band_windows VALUES (" + std::string(row) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  const std::vector<std::pair<int64_t, int64_t>> expected{{1, 5}, {2, 1}, {3, 6}, {5, 2}};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_band : {false, true}) {
+      g_enable_band_joins = enable_band;
+      // the windows are the inner table, bounded through the widest window
+      ASSERT_EQ(int64_t(14),
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM test_band_events e, test_band_windows w WHERE "
+                    "e.ts BETWEEN w.w_start AND w.w_end;",
+                    dt)));
+      // the events are the inner table, bounded on both sides
+      ASSERT_EQ(int64_t(11),
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM test_band_windows w, test_band_events e WHERE "
+                    "e.ts >= w.w_start AND e.ts < w.w_end;",
+                    dt)));
+      const auto rows = run_multiple_agg(
+          "SELECT w.id, COUNT(*) FROM test_band_events e, test_band_windows w WHERE "
+          "e.ts BETWEEN w.w_start AND w.w_end GROUP BY w.id ORDER BY w.id;",
+          dt);
+      ASSERT_EQ(expected.size(), rows->rowCount());
+      for (const auto& expected_row : expected) {
+        const auto crt_row = rows->getNextRow(true, true);
+        ASSERT_EQ(expected_row.first, v<int64_t>(crt_row[0]));
+        ASSERT_EQ(expected_row.second, v<int64_t>(crt_row[1]));
+      }
+    }
+  }
+  // a band join doesn't need the loop join to be allowed
+  g_trivial_loop_join_threshold = 1;
+  const std::string band_query{
+      "SELECT COUNT(*) FROM test_band_events e, test_band_windows w WHERE e.ts BETWEEN "
+      "w.w_start AND w.w_end;"};
+  g_enable_band_joins = false;
+  EXPECT_ANY_THROW(run_multiple_agg(band_query, ExecutorDeviceType::CPU, false));
+  g_enable_band_joins = true;
+  EXPECT_NO_THROW(run_multiple_agg(band_query, ExecutorDeviceType::CPU, false));
+}
+
+TEST(Select, ExternalSort) {
+  const auto enable_external_sort = g_enable_external_sort;
+  const auto external_sort_threshold = g_external_sort_threshold;
+  ScopeGuard reset_external_sort = [&enable_external_sort, &external_sort_threshold] {
+    g_enable_external_sort = enable_external_sort;
+    g_external_sort_threshold = external_sort_threshold;
+    run_ddl_statement("DROP TABLE IF EXISTS test_external_sort;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_external_sort;");
+  run_ddl_statement(
+      "CREATE TABLE test_external_sort (x INT, y DOUBLE, z BIGINT) WITH "
+      "(fragment_size=3);");
+  for (int i = 0; i < 20; ++i) {
+    const auto x = i % 4 == 3 ? std::string("NULL") : std::to_string((i * 7) % 5);
+    run_multiple_agg("INSERT INTO test_external_sort VALUES (" + x + ", " +
+                         std::to_string((i % 3) - 1.5) + ", " + std::to_string(i) +
+                         ");",
+                     ExecutorDeviceType::CPU);
+  }
+  const auto sorted_rows = [](const std::string& query, const ExecutorDeviceType dt) {
+    const auto rows = run_multiple_agg(query, dt);
+    std::vector<std::vector<ScalarTargetValue>> result;
+    for (auto crt_row = rows->getNextRow(true, true); !crt_row.empty();
+         crt_row = rows->getNextRow(true, true)) {
+      result.emplace_back();
+      for (const auto& tv : crt_row) {
+        const auto scalar_tv = boost::get<ScalarTargetValue>(&tv);
+        CHECK(scalar_tv);
+        result.back().push_back(*scalar_tv);
+      }
+    }
+    return result;
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const auto& query : std::vector<std::string>{
+             "SELECT x, y, z FROM test_external_sort ORDER BY x NULLS FIRST, y DESC, z;",
+             "SELECT x, y, z FROM test_external_sort ORDER BY y, x DESC NULLS LAST, z;",
+             "SELECT z, x FROM test_external_sort WHERE z > 4 ORDER BY x, z DESC;",
+             "SELECT x, z FROM test_external_sort ORDER BY x, z LIMIT 5 OFFSET 3;",
+             "SELECT x, z FROM test_external_sort WHERE z < 0 ORDER BY x, z;"}) {
+      g_enable_external_sort = false;
+      const auto expected = sorted_rows(query, dt);
+      g_enable_external_sort = true;
+      g_external_sort_threshold = 0;
+      const auto actual = sorted_rows(query, dt);
+      ASSERT_EQ(expected, actual) << query;
+    }
+  }
+}
+
+TEST(Select, ChunkBloomFilters) {
+  const auto enable_chunk_bloom_filters = g_enable_chunk_bloom_filters;
+  ScopeGuard reset_chunk_bloom_filters = [&enable_chunk_bloom_filters] {
+    g_enable_chunk_bloom_filters = enable_chunk_bloom_filters;
+    run_ddl_statement("DROP TABLE IF EXISTS test_chunk_bloom_filters;");
+  };
+  g_enable_chunk_bloom_filters = true;
+  run_ddl_statement("DROP TABLE IF EXISTS test_chunk_bloom_filters;");
+  run_ddl_statement(
+      "CREATE TABLE test_chunk_bloom_filters (x INT, s TEXT ENCODING DICT(32), t "
+      "SMALLINT ENCODING FIXED(8)) WITH (fragment_size=4);");
+  // the strings are distinct across fragments
+  for (int i = 0; i < 16; ++i) {
+    run_multiple_agg("INSERT INTO test_chunk_bloom_filters VALUES (" +
+                         std::to_string(i) + ", 's" + std::to_string(i / 4) + "', " +
+                         std::to_string(i % 7) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_bloom_filters : {false, true}) {
+      g_enable_chunk_bloom_filters = enable_bloom_filters;
+      const auto count = [dt](const std::string& filter) {
+        return v<int64_t>(run_simple_agg(
+            "SELECT COUNT(*) FROM test_chunk_bloom_filters WHERE " + filter + ";", dt));
+      };
+      EXPECT_EQ(1, count("x = 5"));
+      EXPECT_EQ(0, count("x = 100"));
+      EXPECT_EQ(2, count("t = 3"));
+      EXPECT_EQ(4, count("s = 's2'"));
+      EXPECT_EQ(0, count("s = 'none'"));
+      EXPECT_EQ(2, count("x IN (1, 9, 100)"));
+      EXPECT_EQ(8, count("s IN ('s1', 's3', 'none')"));
+      EXPECT_EQ(1, count("s = 's1' AND x = 6"));
+      EXPECT_EQ(0, count("s = 's1' AND x = 9"));
+    }
+  }
+  // updated chunks drop their filter
+  g_enable_chunk_bloom_filters = true;
+  run_multiple_agg("UPDATE test_chunk_bloom_filters SET x = 100 WHERE x = 5;",
+                   ExecutorDeviceType::CPU);
+  EXPECT_EQ(1,
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM test_chunk_bloom_filters WHERE x = 100;",
+                ExecutorDeviceType::CPU)));
+  EXPECT_EQ(0,
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM test_chunk_bloom_filters WHERE x = 5;",
+                ExecutorDeviceType::CPU)));
+}
+
+TEST(Select, ExpressionFragmentSkipping) {
+  const auto enable_expression_fragment_skipping = g_enable_expression_fragment_skipping;
+  ScopeGuard reset_expression_fragment_skipping = [&enable_expression_fragment_skipping] {
+    g_enable_expression_fragment_skipping = enable_expression_fragment_skipping;
+    run_ddl_statement("DROP TABLE IF EXISTS test_expression_fragment_skipping;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_expression_fragment_skipping;");
+  run_ddl_statement(
+      "CREATE TABLE test_expression_fragment_skipping (x INT, y INT, d DECIMAL(10, 2), "
+      "s TEXT ENCODING DICT(32), t TIMESTAMP(0)) WITH (fragment_size=4);");
+  // every column grows with the fragments, the last fragment only holds nulls
+  for (int i = 0; i < 16; ++i) {
+    run_multiple_agg("INSERT INTO test_expression_fragment_skipping VALUES (" +
+                         std::to_string(i) + ", " + std::to_string(100 - i) + ", " +
+                         std::to_string(i) + ".25, 's" + std::to_string(i / 4) +
+                         "', '2020-01-0" + std::to_string(1 + i / 4) + " 0" +
+                         std::to_string(i % 4) + ":00:00');",
+                     ExecutorDeviceType::CPU);
+  }
+  for (int i = 0; i < 4; ++i) {
+    run_multiple_agg(
+        "INSERT INTO test_expression_fragment_skipping VALUES (NULL, NULL, NULL, NULL, "
+        "NULL);",
+        ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_skipping : {false, true}) {
+      g_enable_expression_fragment_skipping = enable_skipping;
+      const auto count = [dt](const std::string& filter) {
+        return v<int64_t>(run_simple_agg(
+            "SELECT COUNT(*) FROM test_expression_fragment_skipping WHERE " + filter +
+                ";",
+            dt));
+      };
+      EXPECT_EQ(3, count("x IN (1, 5, 9)"));
+      EXPECT_EQ(0, count("x IN (20, 30)"));
+      EXPECT_EQ(4, count("x = 8 OR y > 97"));
+      EXPECT_EQ(0, count("x = 30 OR y > 100"));
+      EXPECT_EQ(2, count("x + 1 BETWEEN 4 AND 5"));
+      EXPECT_EQ(1, count("x * 2 = 14"));
+      EXPECT_EQ(11, count("NOT (x < 5)"));
+      EXPECT_EQ(4, count("x IS NULL"));
+      EXPECT_EQ(16, count("x IS NOT NULL"));
+      EXPECT_EQ(1, count("d = 7.25"));
+      EXPECT_EQ(0, count("d > 15.25"));
+      EXPECT_EQ(1, count("CAST(x AS BIGINT) = 10"));
+      EXPECT_EQ(4, count("s = 's2' OR s = 'none'"));
+      EXPECT_EQ(8, count("s IN ('s1', 's3')"));
+      EXPECT_EQ(4, count("DATE_TRUNC(day, t) = '2020-01-03 00:00:00'"));
+      EXPECT_EQ(0, count("DATE_TRUNC(day, t) = '2020-01-09 00:00:00'"));
+      EXPECT_EQ(4, count("CAST(t AS DATE) = '2020-01-02'"));
+      EXPECT_EQ(4, count("EXTRACT(day FROM t) = 4"));
+      EXPECT_EQ(2, count("(x < 2 OR x > 13) AND y > 90"));
+    }
+  }
+}
+
+TEST(Select, SortedChunkIndexes) {
+  const auto enable_sorted_chunk_indexes = g_enable_sorted_chunk_indexes;
+  ScopeGuard reset_sorted_chunk_indexes = [&enable_sorted_chunk_indexes] {
+    g_enable_sorted_chunk_indexes = enable_sorted_chunk_indexes;
+    run_ddl_statement("DROP TABLE IF EXISTS test_sorted_chunk_indexes;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_sorted_chunk_indexes;");
+  run_ddl_statement(
+      "CREATE TABLE test_sorted_chunk_indexes (x INT, s TEXT ENCODING DICT(8), t "
+      "TIMESTAMP(0) ENCODING FIXED(32)) WITH (fragment_size=10);");
+  for (int i = 0; i < 25; ++i) {
+    run_multiple_agg("INSERT INTO test_sorted_chunk_indexes VALUES (" +
+                         std::to_string((i * 7) % 25) + ", 's" + std::to_string(i % 6) +
+                         "', '2020-01-01 00:00:" + std::to_string(10 + i) + "');",
+                     ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("INSERT INTO test_sorted_chunk_indexes VALUES (NULL, NULL, NULL);",
+                   ExecutorDeviceType::CPU);
+  const auto dt = ExecutorDeviceType::CPU;
+  const std::vector<std::string> queries{
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE x = 14;",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE x = 100;",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE x > 20;",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE 5 >= x;",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE x >= 3 AND x < 9;",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE x > 9 AND x < 3;",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE x IN (2, 11, 19);",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE s = 's4';",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE s = 'none';",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE s = 's1' AND x < 13;",
+      "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE t < '2020-01-01 00:00:17';",
+      "SELECT SUM(x) FROM test_sorted_chunk_indexes WHERE x BETWEEN 4 AND 17;",
+      "SELECT COUNT(DISTINCT s) FROM test_sorted_chunk_indexes WHERE x <= 12;",
+      "SELECT MIN(x) FROM test_sorted_chunk_indexes WHERE x >= 20;",
+      "SELECT x FROM test_sorted_chunk_indexes WHERE rowid = 13;"};
+  std::vector<int64_t> expected;
+  g_enable_sorted_chunk_indexes = false;
+  for (const auto& query : queries) {
+    expected.push_back(v<int64_t>(run_simple_agg(query, dt)));
+  }
+  g_enable_sorted_chunk_indexes = true;
+  // the second pass uses the indexes the first one built
+  for (size_t pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      EXPECT_EQ(expected[i], v<int64_t>(run_simple_agg(queries[i], dt))) << queries[i];
+    }
+  }
+  // updated chunks build their index again
+  run_multiple_agg("UPDATE test_sorted_chunk_indexes SET x = 100 WHERE x = 14;", dt);
+  EXPECT_EQ(1,
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE x = 100;", dt)));
+  EXPECT_EQ(0,
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM test_sorted_chunk_indexes WHERE x = 14;", dt)));
+}
+
+TEST(Select, GeoGridIndexes) {
+  const auto enable_geo_grid_indexes = g_enable_geo_grid_indexes;
+  ScopeGuard reset_geo_grid_indexes = [&enable_geo_grid_indexes] {
+    g_enable_geo_grid_indexes = enable_geo_grid_indexes;
+    run_ddl_statement("DROP TABLE IF EXISTS test_geo_grid_indexes;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_geo_grid_indexes;");
+  run_ddl_statement(
+      "CREATE TABLE test_geo_grid_indexes (id INT, poly POLYGON, mpoly MULTIPOLYGON) "
+      "WITH (fragment_size=10);");
+  // 5 by 5 squares of side 5, 10 apart
+  for (int i = 0; i < 25; ++i) {
+    const auto x0 = std::to_string(i % 5 * 10);
+    const auto y0 = std::to_string(i / 5 * 10);
+    const auto x1 = std::to_string(i % 5 * 10 + 5);
+    const auto y1 = std::to_string(i / 5 * 10 + 5);
+    const auto ring = "(" + x0 + " " + y0 + ", " + x1 + " " + y0 + ", " + x1 + " " + y1 +
+                      ", " + x0 + " " + y1 + ", " + x0 + " " + y0 + ")";
+    run_multiple_agg("INSERT INTO test_geo_grid_indexes VALUES (" + std::to_string(i) +
+                         ", 'POLYGON(" + ring + ")', 'MULTIPOLYGON((" + ring + "))');",
+                     ExecutorDeviceType::CPU);
+  }
+  const auto dt = ExecutorDeviceType::CPU;
+  const std::vector<std::string> queries{
+      "SELECT COUNT(*) FROM test_geo_grid_indexes WHERE ST_Contains(poly, ST_Point(12, "
+      "22));",
+      "SELECT COUNT(*) FROM test_geo_grid_indexes WHERE ST_Contains(poly, ST_Point(7, "
+      "7));",
+      "SELECT COUNT(*) FROM test_geo_grid_indexes WHERE ST_Contains(poly, ST_Point(500, "
+      "500));",
+      "SELECT COUNT(*) FROM test_geo_grid_indexes WHERE ST_Contains(poly, ST_Point(10, "
+      "0));",
+      "SELECT COUNT(*) FROM test_geo_grid_indexes WHERE ST_Intersects(poly, "
+      "ST_GeomFromText('POLYGON((0 0, 25 0, 25 25, 0 25, 0 0))'));",
+      "SELECT COUNT(*) FROM test_geo_grid_indexes WHERE ST_Contains(mpoly, ST_Point(41, "
+      "41));",
+      "SELECT SUM(id) FROM test_geo_grid_indexes WHERE ST_Within(ST_Point(3, 13), poly);",
+      "SELECT COUNT(*) FROM test_geo_grid_indexes WHERE ST_Contains(poly, ST_Point(12, "
+      "22)) AND id > 20;",
+      "SELECT COUNT(*) FROM test_geo_grid_indexes WHERE ST_Disjoint(poly, ST_Point(12, "
+      "22));"};
+  std::vector<int64_t> expected;
+  g_enable_geo_grid_indexes = false;
+  for (const auto& query : queries) {
+    expected.push_back(v<int64_t>(run_simple_agg(query, dt)));
+  }
+  EXPECT_EQ(1, expected[0]);
+  EXPECT_EQ(9, expected[4]);
+  EXPECT_EQ(5, expected[6]);
+  g_enable_geo_grid_indexes = true;
+  // the second pass uses the indexes the first one built
+  for (size_t pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      EXPECT_EQ(expected[i], v<int64_t>(run_simple_agg(queries[i], dt))) << queries[i];
+    }
+  }
+  // appended rows build the index of their fragment again
+  run_multiple_agg(
+      "INSERT INTO test_geo_grid_indexes VALUES (25, 'POLYGON((11 21, 13 21, 13 23, 11 "
+      "23, 11 21))', 'MULTIPOLYGON(((11 21, 13 21, 13 23, 11 23, 11 21)))');",
+      dt);
+  EXPECT_EQ(2, v<int64_t>(run_simple_agg(queries.front(), dt)));
+}
+
+TEST(Select, GeoFragmentBounds) {
+  const auto enable_expression_fragment_skipping = g_enable_expression_fragment_skipping;
+  ScopeGuard reset_expression_fragment_skipping = [&enable_expression_fragment_skipping] {
+    g_enable_expression_fragment_skipping = enable_expression_fragment_skipping;
+    run_ddl_statement("DROP TABLE IF EXISTS test_geo_fragment_bounds;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_geo_fragment_bounds;");
+  run_ddl_statement(
+      "CREATE TABLE test_geo_fragment_bounds (id INT, poly POLYGON) WITH "
+      "(fragment_size=5);");
+  // a row of squares of side 5, 10 apart
+  for (int i = 0; i < 10; ++i) {
+    const auto x0 = std::to_string(i * 10);
+    const auto x1 = std::to_string(i * 10 + 5);
+    run_multiple_agg("INSERT INTO test_geo_fragment_bounds VALUES (" +
+                         std::to_string(i) + ", 'POLYGON((" + x0 + " 0, " + x1 + " 0, " +
+                         x1 + " 5, " + x0 + " 5, " + x0 + " 0))');",
+                     ExecutorDeviceType::CPU);
+  }
+  auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("test_geo_fragment_bounds");
+  CHECK(td);
+  const auto bounds_cd = cat.getMetadataForColumn(td->tableId, "poly_bounds");
+  CHECK(bounds_cd);
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  ASSERT_EQ(size_t(2), table_info.fragments.size());
+  for (size_t frag_idx = 0; frag_idx < table_info.fragments.size(); ++frag_idx) {
+    const auto& chunk_metadata_map = table_info.fragments[frag_idx].getChunkMetadataMap();
+    const auto& geo_bounds = chunk_metadata_map.at(bounds_cd->columnId)->geoBounds;
+    ASSERT_TRUE(geo_bounds);
+    const double x0 = frag_idx * 50.;
+    EXPECT_EQ((std::array<double, 4>{x0, 0., x0 + 45., 5.}), *geo_bounds);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_skipping : {false, true}) {
+      g_enable_expression_fragment_skipping = enable_skipping;
+      const auto count = [dt](const std::string& filter) {
+        return v<int64_t>(run_simple_agg(
+            "SELECT COUNT(*) FROM test_geo_fragment_bounds WHERE " + filter + ";", dt));
+      };
+      EXPECT_EQ(1, count("ST_Contains(poly, ST_Point(12, 2))"));
+      EXPECT_EQ(1, count("ST_Contains(poly, ST_Point(72, 2))"));
+      EXPECT_EQ(0, count("ST_Contains(poly, ST_Point(47, 2))"));
+      EXPECT_EQ(0,
+                count("ST_Intersects(poly, ST_GeomFromText('POLYGON((200 200, 210 200, "
+                      "210 210, 200 210, 200 200))'))"));
+      EXPECT_EQ(2, count("ST_DWithin(poly, ST_Point(47, 2), 3)"));
+      EXPECT_EQ(9, count("NOT ST_Contains(poly, ST_Point(12, 2))"));
+      EXPECT_EQ(2,
+                count("ST_Contains(poly, ST_Point(12, 2)) OR ST_Contains(poly, "
+                      "ST_Point(72, 2))"));
+    }
+  }
+}
+
+TEST(Select, ChunkPrefetch) {
+  const auto chunk_prefetch_window = g_chunk_prefetch_window;
+  const auto enable_work_stealing = g_enable_work_stealing_kernel_dispatch;
+  ScopeGuard reset_chunk_prefetch = [&chunk_prefetch_window, &enable_work_stealing] {
+    g_chunk_prefetch_window = chunk_prefetch_window;
+    g_enable_work_stealing_kernel_dispatch = enable_work_stealing;
+    run_ddl_statement("DROP TABLE IF EXISTS test_chunk_prefetch;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_chunk_prefetch;");
+  run_ddl_statement(
+      "CREATE TABLE test_chunk_prefetch (x INT, s TEXT ENCODING DICT(32), t TEXT "
+      "ENCODING NONE) WITH (fragment_size=2);");
+  for (int i = 0; i < 40; ++i) {
+    const auto str = "'s" + std::to_string(i % 7) + "'";
+    run_multiple_agg("INSERT INTO test_chunk_prefetch VALUES (" + std::to_string(i) +
+                         ", " + str + ", " + str + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  const std::vector<std::string> queries{
+      "SELECT COUNT(*) FROM test_chunk_prefetch WHERE x > 5;",
+      "SELECT SUM(x) FROM test_chunk_prefetch WHERE s = 's3';",
+      "SELECT COUNT(DISTINCT s) FROM test_chunk_prefetch WHERE t <> 's1';",
+      "SELECT MAX(x) FROM (SELECT x FROM test_chunk_prefetch ORDER BY x LIMIT 30);"};
+  g_enable_work_stealing_kernel_dispatch = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const auto& query : queries) {
+      g_chunk_prefetch_window = 0;
+      const auto expected = v<int64_t>(run_simple_agg(query, dt));
+      for (const size_t window : {1, 4, 100}) {
+        g_chunk_prefetch_window = window;
+        EXPECT_EQ(expected, v<int64_t>(run_simple_agg(query, dt))) << query;
+      }
+    }
+  }
+}
+
+TEST(Select, CpuMultifragKernels) {
+  const auto enable_cpu_multifrag_kernels = g_enable_cpu_multifrag_kernels;
+  const auto cpu_multifrag_kernel_min_rows = g_cpu_multifrag_kernel_min_rows;
+  ScopeGuard reset_state = [enable_cpu_multifrag_kernels,
+                            cpu_multifrag_kernel_min_rows] {
+    g_enable_cpu_multifrag_kernels = enable_cpu_multifrag_kernels;
+    g_cpu_multifrag_kernel_min_rows = cpu_multifrag_kernel_min_rows;
+    run_ddl_statement("DROP TABLE IF EXISTS test_cpu_multifrag;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_cpu_multifrag;");
+  g_sqlite_comparator.query("DROP TABLE IF EXISTS test_cpu_multifrag;");
+  run_ddl_statement(
+      "CREATE TABLE test_cpu_multifrag (x INT, y INT, str TEXT ENCODING DICT(32)) WITH "
+      "(fragment_size=2);");
+  g_sqlite_comparator.query("CREATE TABLE test_cpu_multifrag (x INT, y INT, str TEXT);");
+  for (int i = 0; i < 41; ++i) {
+    const auto insert_query = "INSERT INTO test_cpu_multifrag VALUES(" +
+                              std::to_string(i % 9) + ", " +
+                              (i % 4 ? std::to_string(i) : "NULL") + ", 'str" +
+                              std::to_string(i % 5) + "');";
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+  g_enable_cpu_multifrag_kernels = true;
+  // kernels of a few fragments, then a single kernel for the whole table
+  for (const size_t min_rows : {5, 1000}) {
+    g_cpu_multifrag_kernel_min_rows = min_rows;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      c("SELECT COUNT(*), SUM(y), MIN(y), MAX(y) FROM test_cpu_multifrag WHERE x > 2;",
+        dt);
+      c("SELECT str, COUNT(*), SUM(y), AVG(y) FROM test_cpu_multifrag GROUP BY str "
+        "ORDER BY str;",
+        dt);
+      c("SELECT x, COUNT(DISTINCT str) FROM test_cpu_multifrag GROUP BY x ORDER BY x;",
+        dt);
+      c("SELECT a.str, COUNT(*) FROM test_cpu_multifrag a, test b WHERE a.x = b.x GROUP "
+        "BY a.str ORDER BY a.str;",
+        dt);
+    }
+  }
+}
+
+TEST(Select, SharedScans) {
+  {
+    SharedScan first_scan(1, 100);
+    EXPECT_FALSE(first_scan.getStartFragment());
+    first_scan.fragmentStarted(7);
+    SharedScan second_scan(1, 100);
+    ASSERT_TRUE(second_scan.getStartFragment());
+    EXPECT_EQ(*second_scan.getStartFragment(), size_t(7));
+    SharedScan other_table_scan(1, 101);
+    EXPECT_FALSE(other_table_scan.getStartFragment());
+  }
+  SharedScan scan_after(1, 100);
+  EXPECT_FALSE(scan_after.getStartFragment());
+
+  const auto enable_shared_scans = g_enable_shared_scans;
+  ScopeGuard reset_shared_scans = [enable_shared_scans] {
+    g_enable_shared_scans = enable_shared_scans;
+  };
+  g_enable_shared_scans = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*), SUM(x) FROM test WHERE y > 41;", dt);
+    c("SELECT x, COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+    c("SELECT x, y FROM test WHERE x < 8 ORDER BY x, y;", dt);
+  }
+}
+
+TEST(Select, TableSample) {
+  ScopeGuard drop_table = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS test_table_sample;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_table_sample;");
+  run_ddl_statement("CREATE TABLE test_table_sample (x INT) WITH (fragment_size=4);");
+  for (int i = 0; i < 400; ++i) {
+    run_multiple_agg("INSERT INTO test_table_sample VALUES (" + std::to_string(i) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  std::optional<int64_t> system_count;
+  std::optional<int64_t> bernoulli_count;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const auto method : {"SYSTEM", "BERNOULLI"}) {
+      const std::string sample_clause = std::string(" TABLESAMPLE ") + method;
+      ASSERT_EQ(400,
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM test_table_sample" + sample_clause + "(100);",
+                    dt)));
+      ASSERT_EQ(0,
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM test_table_sample" + sample_clause + "(0);",
+                    dt)));
+    }
+    // fragments are kept whole, the same ones on every device
+    const auto system_sample_count = v<int64_t>(run_simple_agg(
+        "SELECT COUNT(*) FROM test_table_sample TABLESAMPLE SYSTEM(50);", dt));
+    EXPECT_EQ(system_sample_count % 4, 0);
+    EXPECT_GT(system_sample_count, 100);
+    EXPECT_LT(system_sample_count, 300);
+    EXPECT_EQ(system_sample_count, system_count.value_or(system_sample_count));
+    system_count = system_sample_count;
+    EXPECT_EQ(system_sample_count,
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM (SELECT x FROM "
+                                        "test_table_sample TABLESAMPLE SYSTEM(50) "
+                                        "WHERE x >= 0);",
+                                        dt)));
+    const auto bernoulli_sample_count = v<int64_t>(run_simple_agg(
+        "SELECT COUNT(*) FROM test_table_sample TABLESAMPLE BERNOULLI(50);", dt));
+    EXPECT_GT(bernoulli_sample_count, 100);
+    EXPECT_LT(bernoulli_sample_count, 300);
+    EXPECT_EQ(bernoulli_sample_count, bernoulli_count.value_or(bernoulli_sample_count));
+    bernoulli_count = bernoulli_sample_count;
+    EXPECT_ANY_THROW(run_multiple_agg(
+        "SELECT COUNT(*) FROM test_table_sample a TABLESAMPLE SYSTEM(50), test b WHERE "
+        "a.x = b.x;",
+        dt));
+  }
+}
+
+TEST(Select, ApproximateAggregate) {
+  ScopeGuard drop_table = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS test_approximate;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS test_approximate;");
+  run_ddl_statement(
+      "CREATE TABLE test_approximate (x INT, y DOUBLE) WITH (fragment_size=4);");
+  for (int i = 0; i < 200; ++i) {
+    run_multiple_agg(
+        "INSERT INTO test_approximate VALUES (1, " + std::to_string(i % 4) + ");",
+        ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the fragments are alike, the first ones sampled are within the error
+    auto rows = run_multiple_agg(
+        "SELECT /*+ approximate(0.01), max_kernel_parallelism(1) */ COUNT(*), SUM(x), "
+        "SUM(y), AVG(y), MAX(y) FROM test_approximate;",
+        dt);
+    auto crt_row = rows->getNextRow(true, true);
+    ASSERT_EQ(crt_row.size(), size_t(5));
+    EXPECT_EQ(v<int64_t>(crt_row[0]), 200);
+    EXPECT_EQ(v<int64_t>(crt_row[1]), 200);
+    EXPECT_DOUBLE_EQ(v<double>(crt_row[2]), 300.);
+    EXPECT_DOUBLE_EQ(v<double>(crt_row[3]), 1.5);
+    EXPECT_DOUBLE_EQ(v<double>(crt_row[4]), 3.);
+    const auto& error_bounds = rows->getApproximateErrorBounds();
+    ASSERT_EQ(error_bounds.size(), size_t(5));
+    for (size_t i = 0; i < 4; ++i) {
+      ASSERT_TRUE(error_bounds[i]);
+      EXPECT_EQ(*error_bounds[i], 0.);
+    }
+    EXPECT_FALSE(error_bounds[4]);
+
+    // exact without the hint
+    rows = run_multiple_agg("SELECT COUNT(*), SUM(y) FROM test_approximate;", dt);
+    EXPECT_TRUE(rows->getApproximateErrorBounds().empty());
+
+    // group by and distinct aggregates aren't sampled
+    EXPECT_EQ(4,
+              v<int64_t>(run_simple_agg("SELECT /*+ approximate */ COUNT(DISTINCT y) "
+                                        "FROM test_approximate;",
+                                        dt)));
+    rows = run_multiple_agg(
+        "SELECT /*+ approximate */ y, COUNT(*) FROM test_approximate GROUP BY y ORDER "
+        "BY y;",
+        dt);
+    ASSERT_EQ(rows->rowCount(), size_t(4));
+    for (size_t i = 0; i < 4; ++i) {
+      crt_row = rows->getNextRow(true, true);
+      EXPECT_EQ(v<int64_t>(crt_row[1]), 50);
+    }
+  }
+}
+
 TEST(Select, VariableLengthOrderBy) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -5294,6 +6384,30 @@ TEST(Select, In) {
     c("SELECT COUNT(*) FROM test WHERE x IN (1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, "
       "14, 15, 16, 17, 18, 19, 20);",
       dt);
+    // too wide or too sparse for a bitmap, looked up in a hash set
+    c("SELECT COUNT(*) FROM test WHERE t IN (1001, 1002, -1000000000000, 1000000000000);",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE t NOT IN (1002, -1000000000000, 1000000000000, "
+      "1000000000001);",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE x IN (7, 100000000, 200000000, 300000000);", dt);
+    c("SELECT COUNT(*) FROM test WHERE y IN (42, 100000000, 200000000, 300000000) OR y "
+      "IS NULL;",
+      dt);
+    // decimals, dates and timestamps go through the same sets
+    c("SELECT COUNT(*) FROM test WHERE dd IN (111.1, 333.3, 5.55, 99999.99);", dt);
+    c("SELECT COUNT(*) FROM test WHERE dd NOT IN (111.1, 5.55, 99999.99, -1.01);", dt);
+    ASSERT_EQ(static_cast<int64_t>(g_num_rows + g_num_rows / 2),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM test WHERE o IN (DATE '1999-09-09', DATE "
+                  "'2000-01-01', DATE '1900-01-01', DATE '2030-01-01');",
+                  dt)));
+    ASSERT_EQ(static_cast<int64_t>(g_num_rows / 2),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM test WHERE m IN (TIMESTAMP '2014-12-14 "
+                  "22:23:15', TIMESTAMP '1970-01-01 00:00:00', TIMESTAMP '2100-01-01 "
+                  "00:00:00', TIMESTAMP '2014-12-14 22:23:16');",
+                  dt)));
   }
 }
 
@@ -5754,6 +6868,30 @@ TEST(Select, CastDecimalToDecimal) {
   }
 }
 
+TEST(Select, DecimalMultiplicationDownscale) {
+  // the product is computed on 128 bits on CPU only
+  const auto dt = ExecutorDeviceType::CPU;
+  // 222.2 * 10^8 squared doesn't fit in 64 bits, the product scaled down to 2 does
+  ASSERT_TRUE(approx_eq(
+      49372.84,
+      v<double>(run_simple_agg("SELECT CAST(CAST(dd AS DECIMAL(18, 8)) * CAST(dd AS "
+                               "DECIMAL(18, 8)) AS DECIMAL(18, 2)) FROM test WHERE x = 8 "
+                               "LIMIT 1;",
+                               dt))));
+  ASSERT_TRUE(approx_eq(
+      -49372.84,
+      v<double>(run_simple_agg("SELECT CAST(CAST(-dd AS DECIMAL(18, 8)) * CAST(dd AS "
+                               "DECIMAL(18, 8)) AS DECIMAL(18, 2)) FROM test WHERE x = 8 "
+                               "LIMIT 1;",
+                               dt))));
+  ASSERT_EQ(
+      0,
+      v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM test WHERE CAST(CAST(dd AS "
+                                "DECIMAL(18, 8)) * CAST(dd AS DECIMAL(18, 8)) AS "
+                                "DECIMAL(18, 2)) IS NULL;",
+                                dt)));
+}
+
 TEST(Select, ColumnWidths) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -7274,6 +8412,10 @@ TEST(Select, ArrayAnyAndAll) {
     ASSERT_EQ(2,
               v<int64_t>(run_simple_agg(
                   "SELECT COUNT(*) FROM array_test WHERE 'bb' = ANY arr_str;", dt)));
+    ASSERT_EQ(0,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM array_test WHERE 'not_a_tag' = ANY arr_str;",
+                  dt)));
     ASSERT_EQ(
         int64_t(g_array_test_row_count),
         v<int64_t>(run_simple_agg(
@@ -7463,6 +8605,42 @@ TEST(Select, GroupByPerfectHash) {
   SKIP_ON_AGGREGATOR(run_test(true));
 }
 
+TEST(Select, GroupByTreeReduction) {
+  const auto enable_tree_reduction = g_enable_tree_reduction;
+  ScopeGuard reset_state = [enable_tree_reduction] {
+    g_enable_tree_reduction = enable_tree_reduction;
+    run_ddl_statement("DROP TABLE IF EXISTS tree_reduction_test;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS tree_reduction_test;");
+  g_sqlite_comparator.query("DROP TABLE IF EXISTS tree_reduction_test;");
+  run_ddl_statement(
+      "CREATE TABLE tree_reduction_test (x INT, y INT, str TEXT ENCODING DICT(32)) WITH "
+      "(fragment_size=4);");
+  g_sqlite_comparator.query("CREATE TABLE tree_reduction_test (x INT, y INT, str TEXT);");
+  // an odd number of fragments, so that a level of the tree leaves one result unpaired
+  for (int i = 0; i < 43; ++i) {
+    const auto insert_query = "INSERT INTO tree_reduction_test VALUES(" +
+                              std::to_string(i % 7) + ", " +
+                              (i % 5 ? std::to_string(i) : "NULL") + ", 'str" +
+                              std::to_string(i % 3) + "');";
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+  for (const bool tree_reduction : {true, false}) {
+    g_enable_tree_reduction = tree_reduction;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      c("SELECT x, COUNT(*), SUM(y), MIN(y), MAX(y), AVG(y) FROM tree_reduction_test "
+        "GROUP BY x ORDER BY x;",
+        dt);
+      c("SELECT str, x, COUNT(DISTINCT y) FROM tree_reduction_test GROUP BY str, x "
+        "ORDER BY str, x;",
+        dt);
+      c("SELECT COUNT(*), SUM(y), COUNT(DISTINCT x) FROM tree_reduction_test;", dt);
+    }
+  }
+}
+
 TEST(Select, GroupByBaselineHash) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -7508,6 +8686,28 @@ TEST(Select, GroupByBaselineHash) {
   }
 }
 
+TEST(Select, GroupByBaselineHashSampledNDV) {
+  g_enable_ndv_sampling = true;
+  const auto sample_fragment_count = g_ndv_sample_fragment_count;
+  g_ndv_sample_fragment_count = 1;
+  ScopeGuard reset_ndv_sampling = [sample_fragment_count] {
+    g_enable_ndv_sampling = false;
+    g_ndv_sample_fragment_count = sample_fragment_count;
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // an estimate too small for the groups of the whole table must not lose any
+    c("SELECT cast(x1 as double) as key, COUNT(*), SUM(x2) FROM random_test GROUP BY "
+      "key ORDER BY key;",
+      dt);
+    c("SELECT x1, x2, x3, x4, COUNT(*) FROM random_test GROUP BY x1, x2, x3, x4 ORDER "
+      "BY x1, x2, x3, x4;",
+      dt);
+    c("SELECT cast(y as double) as key, COUNT(*) FROM test GROUP BY key ORDER BY key;",
+      dt);
+  }
+}
+
 TEST(Select, GroupByConstrainedByInQueryRewrite) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -7965,6 +9165,78 @@ TEST(Select, Subqueries) {
   }
 }
 
+TEST(Select, CommonSubplans) {
+  const auto enable_common_subplan_elimination = g_enable_common_subplan_elimination;
+  ScopeGuard reset_common_subplan_elimination = [&enable_common_subplan_elimination] {
+    g_enable_common_subplan_elimination = enable_common_subplan_elimination;
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_elimination : {false, true}) {
+      g_enable_common_subplan_elimination = enable_elimination;
+      c("WITH agg AS (SELECT x, SUM(y) AS s FROM test GROUP BY x) SELECT a.x, a.s, b.n "
+        "FROM agg a, (SELECT x, COUNT(*) AS n FROM agg GROUP BY x) b WHERE a.x = b.x "
+        "ORDER BY a.x;",
+        dt);
+      c("WITH agg AS (SELECT x, COUNT(*) AS n FROM test GROUP BY x) SELECT a.x, a.n, "
+        "b.n FROM agg a, agg b WHERE a.x = b.x ORDER BY a.x;",
+        dt);
+      c("WITH f AS (SELECT x, y FROM test WHERE y > 41) SELECT f1.x, COUNT(*) FROM f f1, "
+        "(SELECT x FROM f GROUP BY x) f2 WHERE f1.x = f2.x GROUP BY f1.x ORDER BY f1.x;",
+        dt);
+    }
+  }
+}
+
+TEST(Select, DeviceCostModel) {
+  using namespace device_cost_model;
+  // a small step doesn't pay for the launch on GPU
+  EXPECT_EQ(choose_device_type({1000, 0, 1}, 1), ExecutorDeviceType::CPU);
+  const StepInputs big_step{size_t(1) << 30, size_t(1) << 30, 1};
+  EXPECT_EQ(choose_device_type(big_step, 1), ExecutorDeviceType::GPU);
+  EXPECT_EQ(choose_device_type(big_step, 0), ExecutorDeviceType::CPU);
+  {
+    ScopedQueuedWork queued_work(ExecutorDeviceType::GPU, 1e6);
+    EXPECT_EQ(get_queued_work_us(ExecutorDeviceType::GPU), int64_t(1e9));
+    EXPECT_EQ(choose_device_type(big_step, 1), ExecutorDeviceType::CPU);
+  }
+  EXPECT_EQ(get_queued_work_us(ExecutorDeviceType::GPU), 0);
+
+  const auto enable_device_cost_model = g_enable_device_cost_model;
+  ScopeGuard reset_device_cost_model = [&enable_device_cost_model] {
+    g_enable_device_cost_model = enable_device_cost_model;
+  };
+  g_enable_device_cost_model = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM test WHERE x > 7;", dt);
+    c("SELECT x, SUM(y), COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+    c("SELECT a.x, COUNT(*) FROM test a, (SELECT x, MAX(y) AS y FROM test GROUP BY x) b "
+      "WHERE a.x = b.x GROUP BY a.x ORDER BY a.x;",
+      dt);
+  }
+}
+
+TEST(Select, Joins_IntermediateResultsOrder) {
+  const auto from_table_reordering = g_from_table_reordering;
+  ScopeGuard reset_from_table_reordering = [&from_table_reordering] {
+    g_from_table_reordering = from_table_reordering;
+  };
+  g_from_table_reordering = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the joins of the last step are ordered from the distinct values of the results
+    // of the subqueries
+    c("SELECT COUNT(*) FROM test a, (SELECT x, MAX(y) AS y FROM test GROUP BY x) b, "
+      "(SELECT y, COUNT(*) AS n FROM test GROUP BY y) c WHERE a.x = b.x AND b.y = c.y;",
+      dt);
+    c("SELECT a.x, SUM(c.n) FROM test a, (SELECT x, y FROM test WHERE x > 7) b, "
+      "(SELECT y, COUNT(*) AS n FROM test GROUP BY y) c WHERE a.x = b.x AND b.y = c.y "
+      "GROUP BY a.x ORDER BY a.x;",
+      dt);
+  }
+}
+
 TEST(Select, Joins_Arrays) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -8622,6 +9894,16 @@ TEST(Select, Joins_InnerJoin_Filters) {
       "c.str = a.str WHERE c.str = "
       "'foo';",
       dt);
+    // the inner key range skips outer fragments
+    c("SELECT COUNT(*) FROM test a JOIN (SELECT x FROM test_inner WHERE y < 50) b ON "
+      "a.x = b.x;",
+      dt);
+    c("SELECT a.x, COUNT(*) FROM test a JOIN (SELECT x FROM test_inner WHERE y < 50) b "
+      "ON a.x = b.x GROUP BY a.x ORDER BY a.x;",
+      dt);
+    c("SELECT COUNT(*) FROM test a JOIN (SELECT x FROM test_inner WHERE y > 50) b ON "
+      "a.x = b.x;",
+      dt);
     THROW_ON_AGGREGATOR(
         c("SELECT COUNT(*) FROM test t1 JOIN test t2 ON t1.x = t2.x WHERE t1.y > t2.y;",
           dt));  // test must be replicated
@@ -8632,6 +9914,173 @@ TEST(Select, Joins_InnerJoin_Filters) {
   }
 }
 
+TEST(Select, Joins_FragmentPairing) {
+  const auto enable_join_fragment_pairing_state = g_enable_join_fragment_pairing;
+  g_enable_join_fragment_pairing = true;
+  ScopeGuard reset_state = [&enable_join_fragment_pairing_state] {
+    g_enable_join_fragment_pairing = enable_join_fragment_pairing_state;
+    run_ddl_statement("DROP TABLE IF EXISTS sorted_join_outer;");
+    run_ddl_statement("DROP TABLE IF EXISTS sorted_join_inner;");
+  };
+  for (const std::string table : {"sorted_join_outer", "sorted_join_inner"}) {
+    const auto drop_query = "DROP TABLE IF EXISTS " + table + ";";
+    run_ddl_statement(drop_query);
+    g_sqlite_comparator.query(drop_query);
+    run_ddl_statement("CREATE TABLE " + table + "(k INT, v INT) WITH (fragment_size=4);");
+    g_sqlite_comparator.query("CREATE TABLE " + table + "(k INT, v INT);");
+  }
+  // tables loaded in key order, only a few inner fragments overlap the outer ones
+  const auto insert = [](const std::string& table, const int k, const int v) {
+    const auto insert_query = "INSERT INTO " + table + " VALUES(" + std::to_string(k) +
+                              ", " + std::to_string(v) + ");";
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  };
+  for (int k = 1; k <= 20; ++k) {
+    insert("sorted_join_outer", k, k % 3);
+  }
+  for (int k = 16; k <= 60; ++k) {
+    insert("sorted_join_inner", k, k);
+    if (k % 5 == 0) {
+      insert("sorted_join_inner", k, -k);
+    }
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM sorted_join_outer a JOIN sorted_join_inner b ON a.k = b.k;",
+      dt);
+    c("SELECT a.k, SUM(b.v) FROM sorted_join_outer a JOIN sorted_join_inner b ON a.k = "
+      "b.k GROUP BY a.k ORDER BY a.k;",
+      dt);
+    c("SELECT a.k, COUNT(b.v) FROM sorted_join_outer a LEFT JOIN sorted_join_inner b ON "
+      "a.k = b.k GROUP BY a.k ORDER BY a.k;",
+      dt);
+    c("SELECT COUNT(*) FROM sorted_join_inner a JOIN sorted_join_outer b ON a.k = b.k;",
+      dt);
+  }
+}
+
+TEST(Select, Joins_CrossDictionaryStrings) {
+  ScopeGuard reset_state = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS dict_join_outer;");
+    run_ddl_statement("DROP TABLE IF EXISTS dict_join_inner;");
+  };
+  for (const std::string table : {"dict_join_outer", "dict_join_inner"}) {
+    const auto drop_query = "DROP TABLE IF EXISTS " + table + ";";
+    run_ddl_statement(drop_query);
+    g_sqlite_comparator.query(drop_query);
+    run_ddl_statement("CREATE TABLE " + table +
+                      "(k INT, s TEXT ENCODING DICT(32)) WITH (fragment_size=4);");
+    g_sqlite_comparator.query("CREATE TABLE " + table + "(k INT, s TEXT);");
+  }
+  const auto insert = [](const std::string& table, const int k, const std::string& s) {
+    const auto insert_query =
+        "INSERT INTO " + table + " VALUES(" + std::to_string(k) + ", " + s + ");";
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  };
+  // the inner dictionary holds strings the outer one doesn't, added in another order
+  for (int k = 0; k < 12; ++k) {
+    insert("dict_join_outer", k, k % 4 ? "'s" + std::to_string(k % 6) + "'" : "NULL");
+  }
+  for (int k = 0; k < 20; ++k) {
+    insert("dict_join_inner", k, k % 5 ? "'s" + std::to_string(19 - k) + "'" : "NULL");
+  }
+  insert("dict_join_inner", 20, "'s3'");
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM dict_join_outer a JOIN dict_join_inner b ON a.s = b.s;", dt);
+    c("SELECT a.k, b.k FROM dict_join_outer a JOIN dict_join_inner b ON a.s = b.s ORDER "
+      "BY a.k, b.k;",
+      dt);
+    c("SELECT a.k, COUNT(b.k) FROM dict_join_outer a LEFT JOIN dict_join_inner b ON a.s "
+      "= b.s GROUP BY a.k ORDER BY a.k;",
+      dt);
+  }
+}
+
+TEST(Select, Joins_AdaptiveLayout) {
+  ScopeGuard reset_state = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS adaptive_join_sparse;");
+    run_ddl_statement("DROP TABLE IF EXISTS adaptive_join_dups;");
+  };
+  for (const std::string table : {"adaptive_join_sparse", "adaptive_join_dups"}) {
+    const auto drop_query = "DROP TABLE IF EXISTS " + table + ";";
+    run_ddl_statement(drop_query);
+    g_sqlite_comparator.query(drop_query);
+    run_ddl_statement("CREATE TABLE " + table + "(k INT, v INT);");
+    g_sqlite_comparator.query("CREATE TABLE " + table + "(k INT, v INT);");
+  }
+  const auto insert = [](const std::string& table, const int k, const int v) {
+    const auto insert_query = "INSERT INTO " + table + " VALUES(" + std::to_string(k) +
+                              ", " + std::to_string(v) + ");";
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  };
+  // a few keys spread over a range too wide for a perfect hash table to pay off
+  for (int i = 0; i < 4; ++i) {
+    insert("adaptive_join_sparse", i * 100000000 + 7, i);
+  }
+  // more rows than distinct keys, a one to many layout is needed up front
+  for (int i = 0; i < 12; ++i) {
+    insert("adaptive_join_dups", i % 3 ? 7 : 8, i);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT a.v, b.v FROM adaptive_join_dups a JOIN adaptive_join_sparse b ON a.k = "
+      "b.k ORDER BY a.v, b.v;",
+      dt);
+    c("SELECT a.v, b.v FROM adaptive_join_sparse a JOIN adaptive_join_dups b ON a.k = "
+      "b.k ORDER BY a.v, b.v;",
+      dt);
+    c("SELECT a.k, COUNT(*) FROM adaptive_join_dups a JOIN adaptive_join_dups b ON a.k "
+      "= b.k GROUP BY a.k ORDER BY a.k;",
+      dt);
+  }
+}
+
+TEST(Select, Joins_ProbePrefetch) {
+  ScopeGuard reset_state = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS prefetch_join_outer;");
+    run_ddl_statement("DROP TABLE IF EXISTS prefetch_join_inner;");
+  };
+  for (const std::string table : {"prefetch_join_outer", "prefetch_join_inner"}) {
+    const auto drop_query = "DROP TABLE IF EXISTS " + table + ";";
+    run_ddl_statement(drop_query);
+    g_sqlite_comparator.query(drop_query);
+    run_ddl_statement("CREATE TABLE " + table +
+                      "(k INT, v INT) WITH (fragment_size=32);");
+    g_sqlite_comparator.query("CREATE TABLE " + table + "(k INT, v INT);");
+  }
+  const auto insert = [](const std::string& table, const std::string& k, const int v) {
+    const auto insert_query =
+        "INSERT INTO " + table + " VALUES(" + k + ", " + std::to_string(v) + ");";
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  };
+  // the key range makes for a perfect hash table larger than the L2 cache, outer
+  // fragments hold more rows than the prefetch distance
+  for (int i = 0; i < 24; ++i) {
+    insert("prefetch_join_inner", std::to_string(i * 20000), i);
+    insert("prefetch_join_inner", std::to_string(i * 20000 + (i % 2)), i);
+  }
+  for (int i = 0; i < 100; ++i) {
+    insert("prefetch_join_outer", i % 9 ? std::to_string(i * 4800) : "NULL", i);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT a.v, b.v FROM prefetch_join_outer a JOIN prefetch_join_inner b ON a.k = "
+      "b.k ORDER BY a.v, b.v;",
+      dt);
+    c("SELECT a.v, COUNT(b.v) FROM prefetch_join_outer a LEFT JOIN prefetch_join_inner "
+      "b ON a.k = b.k GROUP BY a.v ORDER BY a.v;",
+      dt);
+    c("SELECT COUNT(*) FROM prefetch_join_outer a JOIN prefetch_join_inner b ON a.k = "
+      "b.k AND a.v <= b.v;",
+      dt);
+  }
+}
+
 TEST(Select, Joins_LeftOuterJoin) {
   const auto save_watchdog = g_enable_watchdog;
   ScopeGuard reset_watchdog_state = [&save_watchdog] {
@@ -8798,6 +10247,27 @@ TEST(Select, Joins_LeftOuterJoin) {
   }
 }
 
+TEST(Select, Joins_LeftOuterJoinLazyFetch) {
+  const auto save_lazy_fetch = g_enable_lazy_fetch_through_outer_joins;
+  ScopeGuard reset_lazy_fetch = [&save_lazy_fetch] {
+    g_enable_lazy_fetch_through_outer_joins = save_lazy_fetch;
+  };
+  g_enable_lazy_fetch_through_outer_joins = true;
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the rows of join_test with x = 9 have no match
+    THROW_ON_AGGREGATOR(c(
+        "SELECT a.x, b.real_str FROM join_test a LEFT JOIN test b ON a.x = b.x ORDER BY "
+        "a.x, b.real_str;",
+        dt));
+    THROW_ON_AGGREGATOR(c(
+        "SELECT a.x, a.str, b.real_str FROM join_test a LEFT JOIN test b ON a.x = b.x "
+        "WHERE a.y IS NULL ORDER BY a.x, b.real_str;",
+        dt));
+  }
+}
+
 TEST(Select, Joins_LeftJoin_Filters) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -9940,6 +11410,24 @@ TEST(Select, RuntimeFunctions) {
   }
 }
 
+TEST(Select, RepeatedExpressions) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT str, CASE WHEN str LIKE 'ba%' THEN 1 ELSE 0 END, CASE WHEN str LIKE 'ba%' "
+      "THEN 2 ELSE 3 END FROM test WHERE str LIKE 'ba%' OR str LIKE 'fo%' ORDER BY str;",
+      dt);
+    c("SELECT COUNT(*), SUM(CASE WHEN str LIKE '%a%' THEN x ELSE 0 END) FROM test WHERE "
+      "str LIKE '%a%' OR x > 7;",
+      dt);
+    ASSERT_FLOAT_EQ(
+        static_cast<double>(2 * g_num_rows),
+        v<double>(run_simple_agg(
+            "SELECT SUM(CASE WHEN SIN(x) * SIN(x) < 2 THEN SIN(x) * SIN(x) + COS(x) * "
+            "COS(x) ELSE 0 END) FROM test WHERE COS(x) * COS(x) <= 1.5;",
+            dt)));
+  }
+}
+
 TEST(Select, TextGroupBy) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -14624,6 +16112,57 @@ TEST(Update, Text) {
   g_enable_watchdog = save_watchdog;
 }
 
+TEST(Update, TextEncodingNoneInPlace) {
+  const auto save_watchdog = g_enable_watchdog;
+  const auto save_inplace = g_enable_inplace_string_updates;
+  ScopeGuard reset_state = [&save_watchdog, &save_inplace] {
+    g_enable_watchdog = save_watchdog;
+    g_enable_inplace_string_updates = save_inplace;
+  };
+  g_enable_watchdog = false;
+  g_enable_inplace_string_updates = true;
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+
+    run_ddl_statement("drop table if exists text_inplace;");
+    run_ddl_statement(build_create_table_statement("x int, t text encoding none",
+                                                   "text_inplace",
+                                                   {"", 0},
+                                                   {},
+                                                   2,
+                                                   g_use_temporary_tables,
+                                                   true,
+                                                   false));
+
+    run_multiple_agg("insert into text_inplace values (0, 'abc');", dt);
+    run_multiple_agg("insert into text_inplace values (1, 'defg');", dt);
+    run_multiple_agg("insert into text_inplace values (2, 'hij');", dt);
+
+    const auto rowid_0 =
+        v<int64_t>(run_simple_agg("select rowid from text_inplace where x = 0;", dt));
+    // the same lengths are overwritten in place, the row keeps its rowid
+    run_multiple_agg("update text_inplace set t = 'xyz' where x = 0;", dt);
+    ASSERT_EQ(
+        rowid_0,
+        v<int64_t>(run_simple_agg("select rowid from text_inplace where x = 0;", dt)));
+    // a longer string moves the row
+    run_multiple_agg("update text_inplace set t = 'longer' where x = 2;", dt);
+    ASSERT_EQ(int64_t(3),
+              v<int64_t>(run_simple_agg("select count(*) from text_inplace;", dt)));
+    ASSERT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "select count(*) from text_inplace where x = 0 and t = 'xyz';", dt)));
+    ASSERT_EQ(int64_t(1),
+              v<int64_t>(run_simple_agg(
+                  "select count(*) from text_inplace where x = 1 and t = 'defg';", dt)));
+    ASSERT_EQ(
+        int64_t(1),
+        v<int64_t>(run_simple_agg(
+            "select count(*) from text_inplace where x = 2 and t = 'longer';", dt)));
+  }
+}
+
 TEST(Update, TextINVariant) {
   const auto save_watchdog = g_enable_watchdog;
   ScopeGuard reset_watchdog_state = [&save_watchdog] {
@@ -16691,6 +18230,88 @@ TEST(Delete, ExtraFragment) {
   }
 }
 
+TEST(Delete, FragmentMetadataSkipping) {
+  const auto enable_delete_metadata_skipping = g_enable_delete_metadata_skipping;
+  ScopeGuard reset_delete_metadata_skipping = [&enable_delete_metadata_skipping] {
+    g_enable_delete_metadata_skipping = enable_delete_metadata_skipping;
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+
+    run_ddl_statement("DROP TABLE IF EXISTS delete_skipping;");
+    run_ddl_statement(build_create_table_statement("x int, str text",
+                                                   "delete_skipping",
+                                                   {"", 0},
+                                                   {},
+                                                   2,
+                                                   g_use_temporary_tables,
+                                                   true,
+                                                   false));
+    ScopeGuard drop_table = [] {
+      run_ddl_statement("DROP TABLE IF EXISTS delete_skipping;");
+    };
+
+    for (int i = 1; i <= 8; ++i) {
+      run_multiple_agg("INSERT INTO delete_skipping VALUES (" + std::to_string(i) +
+                           ", 'str" + std::to_string(i) + "');",
+                       ExecutorDeviceType::CPU);
+    }
+    // the first two fragments all deleted, one row of the third
+    run_multiple_agg("DELETE FROM delete_skipping WHERE x <= 5;", dt);
+
+    for (const bool enable_skipping : {true, false}) {
+      g_enable_delete_metadata_skipping = enable_skipping;
+      EXPECT_EQ(3,
+                v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM delete_skipping;", dt)));
+      EXPECT_EQ(21,
+                v<int64_t>(run_simple_agg("SELECT SUM(x) FROM delete_skipping;", dt)));
+      EXPECT_EQ(6, v<int64_t>(run_simple_agg("SELECT MIN(x) FROM delete_skipping;", dt)));
+      EXPECT_EQ(
+          0,
+          v<int64_t>(run_simple_agg(
+              "SELECT COUNT(*) FROM delete_skipping WHERE str = 'str3';", dt)));
+    }
+  }
+}
+
+TEST(Delete, ParallelFragments) {
+  const auto enable_parallel_fragment_updates = g_enable_parallel_fragment_updates;
+  ScopeGuard reset_parallel_fragment_updates = [&enable_parallel_fragment_updates] {
+    g_enable_parallel_fragment_updates = enable_parallel_fragment_updates;
+  };
+  for (const bool enable_parallel_updates : {true, false}) {
+    g_enable_parallel_fragment_updates = enable_parallel_updates;
+
+    run_ddl_statement("DROP TABLE IF EXISTS parallel_updates;");
+    run_ddl_statement(build_create_table_statement("x int, y int",
+                                                   "parallel_updates",
+                                                   {"", 0},
+                                                   {},
+                                                   4,
+                                                   g_use_temporary_tables,
+                                                   true,
+                                                   false));
+    ScopeGuard drop_table = [] {
+      run_ddl_statement("DROP TABLE IF EXISTS parallel_updates;");
+    };
+
+    for (int i = 1; i <= 64; ++i) {
+      run_multiple_agg("INSERT INTO parallel_updates VALUES (" + std::to_string(i) +
+                           ", 0);",
+                       ExecutorDeviceType::CPU);
+    }
+    const auto dt = ExecutorDeviceType::CPU;
+    run_multiple_agg("UPDATE parallel_updates SET y = x * 2 WHERE x > 8;", dt);
+    EXPECT_EQ(2 * (64 * 65 / 2 - 36),
+              v<int64_t>(run_simple_agg("SELECT SUM(y) FROM parallel_updates;", dt)));
+    run_multiple_agg("DELETE FROM parallel_updates WHERE MOD(x, 2) = 0;", dt);
+    EXPECT_EQ(32,
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM parallel_updates;", dt)));
+    EXPECT_EQ(32 * 32,
+              v<int64_t>(run_simple_agg("SELECT SUM(x) FROM parallel_updates;", dt)));
+  }
+}
+
 TEST(Delete, MultiDelete) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -17391,6 +19012,21 @@ TEST(Select, GeoSpatial_Projection) {
                     "from geospatial_test limit 1;",
                     dt)),
                 static_cast<double>(0.01));
+    ASSERT_NEAR(static_cast<double>(2.0),  // closest to a segment in the second batch
+                v<double>(run_simple_agg(
+                    "SELECT ST_Distance('POINT(10 3)', 'LINESTRING(0 0, 1 0, 2 0, 3 0, "
+                    "4 0, 5 0, 6 0, 7 0, 8 0, 9 0, 10 0, 10 1)') "
+                    "from geospatial_test limit 1;",
+                    dt)),
+                static_cast<double>(0.01));
+    ASSERT_NEAR(static_cast<double>(2.0),
+                v<double>(run_simple_agg(
+                    "SELECT ST_Distance(ST_GeomFromText('POINT(4 -3)'),"
+                    "ST_GeomFromText('POLYGON((0 -1, 1 -1, 2 -1, 3 -1, 4 -1, 5 -1, 6 -1, "
+                    "7 0, 8 -1, 9 2, 0 2, -1 0))')) "
+                    "from geospatial_test limit 1;",
+                    dt)),
+                static_cast<double>(0.01));
     ASSERT_NEAR(static_cast<double>(0.0),
                 v<double>(run_simple_agg("SELECT ST_Distance(ST_GeomFromText("
                                          "'POLYGON((2 2, -2 2, -2 -2, 2 -2, 2 2))'), "
@@ -18052,6 +19688,20 @@ TEST(Select, GeoSpatial_Projection) {
                   "ST_GeomFromText('POLYGON((0 -1, 2 1, 3 0, 5 2, 0 2, -1 0))'), "
                   "ST_GeomFromText('POINT(2 0)')) FROM geospatial_test limit 1;",
                   dt)));
+    ASSERT_EQ(static_cast<int64_t>(1),  // touch+leave across a batch of vertices
+              v<int64_t>(run_simple_agg(
+                  "SELECT ST_Contains("
+                  "ST_GeomFromText('POLYGON((0 -1, 1 -1, 2 -1, 3 -1, 4 -1, 5 -1, 6 -1, "
+                  "7 0, 8 -1, 9 2, 0 2, -1 0))'), "
+                  "ST_GeomFromText('POINT(0 0)')) FROM geospatial_test limit 1;",
+                  dt)));
+    ASSERT_EQ(static_cast<int64_t>(0),  // same polygon, point past its last batch
+              v<int64_t>(run_simple_agg(
+                  "SELECT ST_Contains("
+                  "ST_GeomFromText('POLYGON((0 -1, 1 -1, 2 -1, 3 -1, 4 -1, 5 -1, 6 -1, "
+                  "7 0, 8 -1, 9 2, 0 2, -1 0))'), "
+                  "ST_GeomFromText('POINT(10 0)')) FROM geospatial_test limit 1;",
+                  dt)));
 
     ASSERT_EQ(static_cast<int64_t>(1),  // polygon containing linestring
               v<int64_t>(run_simple_agg(
@@ -18607,6 +20257,19 @@ TEST(Select, GeoSpatial_Geos) {
             "FROM geospatial_test WHERE id = 2;",
             dt)),
         static_cast<double>(0.00001));
+    // ST_Difference cutting a hole: MULTIPOLYGON (((0 0,4 0,4 4,0 4),(1 1,1 2,2 2,2 1)))
+    ASSERT_NEAR(static_cast<double>(15.0),
+                v<double>(run_simple_agg(
+                    "SELECT ST_Area(ST_Difference('POLYGON((0 0,4 0,4 4,0 4))', "
+                    "'POLYGON((1 1,2 1,2 2,1 2))'));",
+                    dt)),
+                static_cast<double>(0.00001));
+    ASSERT_NEAR(static_cast<double>(0.5),
+                v<double>(run_simple_agg(
+                    "SELECT ST_Distance(ST_Difference('POLYGON((0 0,4 0,4 4,0 4))', "
+                    "'POLYGON((1 1,2 1,2 2,1 2))'), 'POINT(1.5 1.5)');",
+                    dt)),
+                static_cast<double>(0.00001));
     // ST_Buffer of poly, 0 width: MULTIPOLYGON (((0 0,3 0,0 3,0 0)))
     ASSERT_NEAR(static_cast<double>(4.5),
                 v<double>(run_simple_agg("SELECT ST_Area(ST_Buffer(poly, 0.0)) "
@@ -19836,6 +21499,36 @@ TEST(Select, WindowFunctionSum) {
   c(query + " NULLS FIRST;", query + ";", dt);
 }
 
+TEST(Select, WindowFunctionRowsFrame) {
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  for (const std::string frame_aggregate :
+       {"SUM(x) OVER (PARTITION BY y ORDER BY t ASC ROWS BETWEEN 2 PRECEDING AND "
+        "CURRENT ROW)",
+        "MIN(x) OVER (PARTITION BY y ORDER BY t ASC ROWS BETWEEN 1 PRECEDING AND 1 "
+        "FOLLOWING)",
+        "MAX(dd) OVER (PARTITION BY y ORDER BY t DESC ROWS BETWEEN CURRENT ROW AND 2 "
+        "FOLLOWING)",
+        "COUNT(x) OVER (PARTITION BY y ORDER BY t ASC ROWS BETWEEN UNBOUNDED PRECEDING "
+        "AND 1 PRECEDING)",
+        "AVG(x) OVER (PARTITION BY y ORDER BY t ASC ROWS BETWEEN 3 PRECEDING AND 1 "
+        "FOLLOWING)",
+        "SUM(f) OVER (ORDER BY t ASC ROWS BETWEEN 2 FOLLOWING AND UNBOUNDED FOLLOWING)",
+        "COUNT(*) OVER (ORDER BY t ASC ROWS BETWEEN 2 PRECEDING AND 2 FOLLOWING)"}) {
+    c("SELECT t, " + frame_aggregate + " w FROM test_window_func ORDER BY t ASC;", dt);
+  }
+}
+
+TEST(Select, WindowFunctionSharedSort) {
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  std::string part1 =
+      "SELECT t, ROW_NUMBER() OVER (PARTITION BY y ORDER BY t ASC) r1, LAG(x) OVER "
+      "(PARTITION BY y ORDER BY t ASC) l, SUM(x) OVER (PARTITION BY y ORDER BY t ASC "
+      "ROWS BETWEEN 1 PRECEDING AND CURRENT ROW) s, ROW_NUMBER() OVER (PARTITION BY y "
+      "ORDER BY t DESC) r2, RANK() OVER (PARTITION BY x ORDER BY t ASC) r3 FROM "
+      "test_window_func ORDER BY t ASC";
+  c(part1 + " NULLS FIRST;", part1 + ";", dt);
+}
+
 TEST(Select, WindowFunctionComplexExpressions) {
   const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
   {
@@ -20367,6 +22060,38 @@ TEST(Select, UnionAll) {
   g_enable_union = enable_union;
 }
 
+// Uses tables from import_union_all_tests().
+TEST(Select, UnionAllParallelBranches) {
+  bool enable_union = true;
+  std::swap(g_enable_union, enable_union);
+  bool enable_parallel_union_branches = true;
+  std::swap(g_enable_parallel_union_branches, enable_parallel_union_branches);
+  ScopeGuard reset_flags = [enable_union, enable_parallel_union_branches] {
+    g_enable_union = enable_union;
+    g_enable_parallel_union_branches = enable_parallel_union_branches;
+  };
+  for (auto dt : {ExecutorDeviceType::CPU /*, ExecutorDeviceType::GPU*/}) {
+    SKIP_NO_GPU();
+    c("SELECT a0, COUNT(*) AS n FROM union_all_a GROUP BY a0"
+      " UNION ALL"
+      " SELECT b0, COUNT(*) AS n FROM union_all_b GROUP BY b0"
+      " ORDER BY a0, n;",
+      dt);
+    c("SELECT a1, SUM(a0) AS s FROM union_all_a WHERE a0 < 116 GROUP BY a1"
+      " UNION ALL"
+      " SELECT b1, SUM(b0) AS s FROM union_all_b GROUP BY b1"
+      " UNION ALL"
+      " SELECT a1, MAX(a0) AS s FROM union_all_a GROUP BY a1"
+      " ORDER BY a1, s;",
+      dt);
+    c("SELECT a0, a1 FROM (SELECT a0, a1 FROM union_all_a ORDER BY a0 LIMIT 3)"
+      " UNION ALL"
+      " SELECT b0, b1 FROM (SELECT b0, b1 FROM union_all_b ORDER BY b0 LIMIT 4)"
+      " ORDER BY a0;",
+      dt);
+  }
+}
+
 TEST(Select, VariableLengthAggs) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -20495,6 +22220,40 @@ TEST(Select, Interop) {
   g_enable_interop = false;
 }
 
+TEST(Select, ExpressionInterpreter) {
+  SKIP_ALL_ON_AGGREGATOR();
+  g_enable_expression_interpreter = true;
+  ScopeGuard interpreter_guard = [] { g_enable_expression_interpreter = false; };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x, y, z, t FROM test WHERE x > 7 ORDER BY x, y, z, t;", dt);
+    c("SELECT x + y, y - z, x * t, t / x, t % x FROM test WHERE NOT b ORDER BY 1, 2, "
+      "3, 4, 5;",
+      dt);
+    c("SELECT x, d * 2, -f FROM test WHERE d > 2.5 OR f < 1.2 ORDER BY x, 2, 3;", dt);
+    c("SELECT x, str FROM test WHERE str = 'foo' OR str IS NULL ORDER BY x, str;", dt);
+    c("SELECT x, y FROM test WHERE str <> 'bar' AND x IN (7, 8) ORDER BY x, y;", dt);
+    c("SELECT x, y FROM test WHERE smallint_nulls IS NULL ORDER BY x, y;", dt);
+    c("SELECT x, dd + dd FROM test WHERE dd > 100.5 ORDER BY x, 2;", dt);
+    c("SELECT x, y FROM test WHERE str IN ('foo', 'baz', 'none') ORDER BY x, y;", dt);
+    c("SELECT x, y FROM test WHERE x = 8 ORDER BY y LIMIT 2;", dt);
+    ASSERT_EQ(22,
+              v<int64_t>(run_simple_agg(
+                  "SELECT EXTRACT(HOUR FROM m) AS h FROM test ORDER BY h DESC LIMIT 1;",
+                  dt)));
+    ASSERT_EQ(6,
+              v<int64_t>(run_simple_agg(
+                  "SELECT EXTRACT(DOW FROM m) AS w FROM test ORDER BY w DESC LIMIT 1;",
+                  dt)));
+    ASSERT_EQ(1418515200L,
+              v<int64_t>(run_simple_agg(
+                  "SELECT DATE_TRUNC(day, m) AS d FROM test ORDER BY d DESC LIMIT 1;",
+                  dt)));
+    EXPECT_THROW(run_multiple_agg("SELECT x / (x - 7) FROM test;", dt),
+                 std::runtime_error);
+  }
+}
+
 // Test https://github.com/omnisci/omniscidb/issues/463
 TEST(Select, LeftJoinDictionaryGenerationIssue463) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
@@ -20,9 +20,13 @@
  */
 
 #include <gtest/gtest.h>
+
+#include <fstream>
+
 #include "DBHandlerTestHelpers.h"
 #include "DataMgr/FileMgr/FileMgr.h"
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
+#include "Shared/scope.h"
 #include "TestHelpers.h"
 
 class FileMgrTest : public DBHandlerTestFixture {
@@ -138,6 +142,174 @@ TEST_F(FileMgrTest, putBuffer_append) {
   compareBuffersAndMetadata(source_buffer, file_buffer, 8);
 }
 
+TEST_F(FileMgrTest, readPages) {
+  AbstractBuffer* source_buffer =
+      dm->getChunkBuffer(chunk_key, Data_Namespace::MemoryLevel::CPU_LEVEL);
+  constexpr size_t num_bytes{20000};
+  std::vector<int8_t> source(num_bytes);
+  for (size_t i = 0; i < num_bytes; ++i) {
+    source[i] = static_cast<int8_t>(i * 7 + i / 251);
+  }
+  source_buffer->write(source.data(), num_bytes);
+  // a page size which doesn't divide the alignment of direct reads
+  auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, 0, 1000);
+  AbstractBuffer* file_buffer = file_mgr.putBuffer(chunk_key, source_buffer, num_bytes);
+  const auto enable_direct_file_reads = g_enable_direct_file_reads;
+  ScopeGuard reset_direct_file_reads = [enable_direct_file_reads] {
+    g_enable_direct_file_reads = enable_direct_file_reads;
+  };
+  for (const bool direct_reads : {false, true}) {
+    g_enable_direct_file_reads = direct_reads;
+    for (const auto& [offset, size] : std::vector<std::pair<size_t, size_t>>{
+             {0, num_bytes}, {0, 1}, {5, 970}, {970, 30}, {999, 12345}, {19999, 1}}) {
+      std::vector<int8_t> dst(size);
+      file_buffer->read(dst.data(), size, offset);
+      ASSERT_EQ(0, std::memcmp(dst.data(), source.data() + offset, size))
+          << "direct reads " << direct_reads << " offset " << offset << " size " << size;
+    }
+  }
+}
+
+TEST_F(FileMgrTest, varlenPageCompression) {
+  const auto enable_varlen_page_compression = g_enable_varlen_page_compression;
+  ScopeGuard reset_varlen_page_compression = [enable_varlen_page_compression] {
+    g_enable_varlen_page_compression = enable_varlen_page_compression;
+  };
+  g_enable_varlen_page_compression = true;
+  std::string source;
+  for (size_t i = 0; source.size() < 250000; ++i) {
+    source += "row " + std::to_string(i) + " level=INFO message=request served\n";
+  }
+  constexpr size_t page_size{65536};
+  auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, 0, page_size);
+  const ChunkKey text_chunk_key{file_mgr_key.first, file_mgr_key.second, 1000, 0, 1};
+  auto file_buffer = file_mgr.createBuffer(text_chunk_key, page_size);
+  file_buffer->initEncoder(SQLTypeInfo(kTEXT, false));
+  // the second append fills up the last page of the first one
+  auto src = reinterpret_cast<int8_t*>(source.data());
+  file_buffer->append(src, 100000);
+  file_buffer->append(src + 100000, source.size() - 100000);
+  const auto page_data_size = file_buffer->pageDataSize();
+  const auto multi_pages = file_buffer->getMultiPage();
+  ASSERT_EQ((source.size() + page_data_size - 1) / page_data_size, multi_pages.size());
+  for (size_t page_num = 0; page_num < multi_pages.size(); ++page_num) {
+    ASSERT_EQ(page_num < source.size() / page_data_size,
+              file_buffer->isCompressedPage(multi_pages[page_num].current()))
+        << "page " << page_num;
+  }
+  const auto check_reads = [&] {
+    for (const auto& [offset, size] : std::vector<std::pair<size_t, size_t>>{
+             {0, source.size()}, {5, 10}, {page_data_size - 3, 6}, {150000, 100000}}) {
+      std::vector<int8_t> dst(size);
+      file_buffer->read(dst.data(), size, offset);
+      ASSERT_EQ(0, std::memcmp(dst.data(), source.data() + offset, size))
+          << "offset " << offset << " size " << size;
+    }
+  };
+  check_reads();
+
+  // a compressed page written to is decompressed, then compressed again
+  const auto written = source.begin() + page_data_size + 10;
+  std::fill(written, written + 10, 'x');
+  file_buffer->write(src + page_data_size + 10, 10, page_data_size + 10);
+  ASSERT_TRUE(file_buffer->isCompressedPage(file_buffer->getMultiPage()[1].current()));
+  check_reads();
+}
+
+TEST_F(FileMgrTest, headerIndex) {
+  const auto enable_header_index_file = g_enable_header_index_file;
+  ScopeGuard reset_header_index_file = [enable_header_index_file] {
+    g_enable_header_index_file = enable_header_index_file;
+  };
+  g_enable_header_index_file = true;
+  // every insert checkpoints the table, which rewrites its index
+  for (int i = 0; i < 3; ++i) {
+    sql("INSERT INTO " + table_name + " VALUES(" + std::to_string(i) + ")");
+  }
+  auto table_file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+      gfm->getFileMgr(file_mgr_key.first, file_mgr_key.second));
+  ASSERT_TRUE(table_file_mgr);
+  const auto header_index_path = table_file_mgr->getFileMgrBasePath() + "/header_index";
+  const auto header_index_epoch = [&header_index_path] {
+    std::ifstream header_index(header_index_path, std::ios::binary);
+    int header[2];
+    header_index.read(reinterpret_cast<char*>(header), sizeof(header));
+    return header[1];
+  };
+  ASSERT_EQ(table_file_mgr->epoch() - 1, header_index_epoch());
+
+  // open the table from the index, then from the page headers
+  auto indexed_file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key);
+  g_enable_header_index_file = false;
+  auto scanned_file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key);
+  // the scan may change the pages the index describes
+  ASSERT_EQ(-1, header_index_epoch());
+
+  const ChunkKey table_key{file_mgr_key.first, file_mgr_key.second};
+  ChunkMetadataVector indexed_metadata;
+  ChunkMetadataVector scanned_metadata;
+  indexed_file_mgr.getChunkMetadataVecForKeyPrefix(indexed_metadata, table_key);
+  scanned_file_mgr.getChunkMetadataVecForKeyPrefix(scanned_metadata, table_key);
+  ASSERT_EQ(scanned_metadata.size(), indexed_metadata.size());
+  ASSERT_FALSE(indexed_metadata.empty());
+  for (size_t i = 0; i < indexed_metadata.size(); ++i) {
+    ASSERT_EQ(scanned_metadata[i].first, indexed_metadata[i].first);
+    ASSERT_EQ(*scanned_metadata[i].second, *indexed_metadata[i].second);
+  }
+  AbstractBuffer* indexed_buffer = indexed_file_mgr.getBuffer(chunk_key);
+  AbstractBuffer* scanned_buffer = scanned_file_mgr.getBuffer(chunk_key);
+  ASSERT_EQ(scanned_buffer->size(), indexed_buffer->size());
+  compareBuffersAndMetadata(scanned_buffer, indexed_buffer, indexed_buffer->size());
+
+  g_enable_header_index_file = true;
+  sql("INSERT INTO " + table_name + " VALUES(4)");
+  ASSERT_EQ(table_file_mgr->epoch() - 1, header_index_epoch());
+}
+
+TEST_F(FileMgrTest, parallelCheckpoint) {
+  const auto enable_parallel_checkpoint = g_enable_parallel_checkpoint;
+  ScopeGuard reset_parallel_checkpoint = [enable_parallel_checkpoint] {
+    g_enable_parallel_checkpoint = enable_parallel_checkpoint;
+  };
+  g_enable_parallel_checkpoint = true;
+  // every insert checkpoints the table
+  for (int i = 0; i < 3; ++i) {
+    sql("INSERT INTO " + table_name + " VALUES(" + std::to_string(i * 1000) + ")");
+  }
+  auto table_file_mgr = dynamic_cast<File_Namespace::FileMgr*>(
+      gfm->getFileMgr(file_mgr_key.first, file_mgr_key.second));
+  ASSERT_TRUE(table_file_mgr);
+
+  // the metadata pages written at the checkpoints, read back from the page headers
+  auto reopened_file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key);
+  ASSERT_EQ(table_file_mgr->epoch(), reopened_file_mgr.epoch());
+  const ChunkKey table_key{file_mgr_key.first, file_mgr_key.second};
+  ChunkMetadataVector checkpointed_metadata;
+  ChunkMetadataVector reopened_metadata;
+  table_file_mgr->getChunkMetadataVecForKeyPrefix(checkpointed_metadata, table_key);
+  reopened_file_mgr.getChunkMetadataVecForKeyPrefix(reopened_metadata, table_key);
+  ASSERT_EQ(checkpointed_metadata.size(), reopened_metadata.size());
+  ASSERT_FALSE(reopened_metadata.empty());
+  for (size_t i = 0; i < reopened_metadata.size(); ++i) {
+    ASSERT_EQ(checkpointed_metadata[i].first, reopened_metadata[i].first);
+    ASSERT_EQ(*checkpointed_metadata[i].second, *reopened_metadata[i].second);
+  }
+}
+
+TEST_F(FileMgrTest, tableEpochBeforeOpen) {
+  sql("INSERT INTO " + table_name + " VALUES(2)");
+  const auto [db_id, tb_id] = file_mgr_key;
+  const auto table_epoch = gfm->getTableEpoch(db_id, tb_id);
+  File_Namespace::GlobalFileMgr restarted_gfm(
+      0, gfm->getBasePath(), 0, gfm->getDefaultPageSize());
+  // from the epoch file, the table isn't open yet
+  ASSERT_EQ(table_epoch, restarted_gfm.getTableEpoch(db_id, tb_id));
+  ASSERT_EQ(size_t(0), restarted_gfm.getNumChunks());
+  ASSERT_TRUE(restarted_gfm.getFileMgr(db_id, tb_id));
+  ASSERT_EQ(table_epoch, restarted_gfm.getTableEpoch(db_id, tb_id));
+  ASSERT_EQ(gfm->getFileMgr(db_id, tb_id)->getNumChunks(), restarted_gfm.getNumChunks());
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -534,6 +534,57 @@ TEST_F(ForeignStorageCacheLRUTest, Reorder) {
   ASSERT_THROW(lru_alg.evictNextChunk(), NoEntryFoundException);
 }
 
+class ForeignStorageCacheTwoQueueTest : public testing::Test {};
+TEST_F(ForeignStorageCacheTwoQueueTest, Basic) {
+  TwoQueueEvictionAlgorithm two_queue_alg{};
+  two_queue_alg.touchChunk(chunk_key1);
+  two_queue_alg.touchChunk(chunk_key2);
+  two_queue_alg.touchChunk(chunk_key3);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key1);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key2);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key3);
+  ASSERT_THROW(two_queue_alg.evictNextChunk(), NoEntryFoundException);
+}
+
+TEST_F(ForeignStorageCacheTwoQueueTest, RepeatedTouchBeforeEvict) {
+  TwoQueueEvictionAlgorithm two_queue_alg{};
+  two_queue_alg.touchChunk(chunk_key1);
+  two_queue_alg.touchChunk(chunk_key2);
+  two_queue_alg.touchChunk(chunk_key1);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key1);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key2);
+  ASSERT_THROW(two_queue_alg.evictNextChunk(), NoEntryFoundException);
+}
+
+TEST_F(ForeignStorageCacheTwoQueueTest, ScanResistant) {
+  TwoQueueEvictionAlgorithm two_queue_alg{};
+  two_queue_alg.touchChunk(chunk_key1);
+  two_queue_alg.touchChunk(chunk_key2);
+  two_queue_alg.touchChunk(chunk_key3);
+  two_queue_alg.touchChunk(chunk_key4);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key1);
+  // Cached again while remembered, the chunk is kept over the ones used once
+  two_queue_alg.touchChunk(chunk_key1);
+  two_queue_alg.touchChunk(chunk_key5);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key2);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key3);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key4);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key5);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key1);
+  ASSERT_THROW(two_queue_alg.evictNextChunk(), NoEntryFoundException);
+}
+
+TEST_F(ForeignStorageCacheTwoQueueTest, RemoveChunk) {
+  TwoQueueEvictionAlgorithm two_queue_alg{};
+  two_queue_alg.touchChunk(chunk_key1);
+  two_queue_alg.touchChunk(chunk_key2);
+  two_queue_alg.touchChunk(chunk_key3);
+  two_queue_alg.removeChunk(chunk_key2);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key1);
+  ASSERT_EQ(two_queue_alg.evictNextChunk(), chunk_key3);
+  ASSERT_THROW(two_queue_alg.evictNextChunk(), NoEntryFoundException);
+}
+
 class ForeignStorageCacheFileTest : public testing::Test {
  protected:
   std::string cache_path_;
@@ -2113,6 +2113,63 @@ TEST_F(AppendRefreshTest, CSV_MissingFileArchive) {
   bf::remove_all(getDataFilesPath() + "append_tmp");
 }
 
+TEST_F(AppendRefreshTest, CSV_NonAppendRefreshOfNewFiles) {
+  std::string dir_path = getDataFilesPath() + "append_tmp/csv_dir_file";
+  bf::remove_all(getDataFilesPath() + "append_tmp");
+  recursive_copy(getDataFilesPath() + "append_before", getDataFilesPath() + "append_tmp");
+  // files modified within the last second are always scanned again
+  std::this_thread::sleep_for(std::chrono::seconds(2));
+
+  sql("CREATE FOREIGN TABLE " + default_name + " (i BIGINT) "s +
+      "SERVER omnisci_local_csv WITH (file_path = '" + dir_path +
+      "', fragment_size = '1');");
+  std::string select = "SELECT * FROM "s + default_name + " ORDER BY i;";
+  sqlAndCompareResult(select, {{i(1)}, {i(2)}});
+
+  // Only add files, the file read before is unchanged
+  for (const auto& file_name : {"one_row_3.csv", "two_row_4_5.csv"}) {
+    bf::copy_file(getDataFilesPath() + "append_after/csv_dir_file/" + file_name,
+                  dir_path + "/" + file_name);
+  }
+  size_t mdata_count = cache_->getNumMetadataAdded();
+  size_t chunk_count = cache_->getNumChunksAdded();
+  sql("REFRESH FOREIGN TABLES " + default_name + ";");
+
+  // Like an append, the new chunks and the last original chunk are updated
+  ASSERT_EQ(4U, cache_->getNumMetadataAdded() - mdata_count);
+  ASSERT_EQ(1U, cache_->getNumChunksAdded() - chunk_count);
+  ASSERT_TRUE(does_cache_contain_chunks(&getCatalog(), default_name, {{1, 0}, {1, 1}}));
+  sqlAndCompareResult(select, {{i(1)}, {i(2)}, {i(3)}, {i(4)}, {i(5)}});
+
+  bf::remove_all(getDataFilesPath() + "append_tmp");
+}
+
+TEST_F(AppendRefreshTest, CSV_NonAppendRefreshOfChangedFile) {
+  std::string dir_path = getDataFilesPath() + "append_tmp/csv_dir_file";
+  bf::remove_all(getDataFilesPath() + "append_tmp");
+  recursive_copy(getDataFilesPath() + "append_before", getDataFilesPath() + "append_tmp");
+  std::this_thread::sleep_for(std::chrono::seconds(2));
+
+  sql("CREATE FOREIGN TABLE " + default_name + " (i BIGINT) "s +
+      "SERVER omnisci_local_csv WITH (file_path = '" + dir_path +
+      "', fragment_size = '1');");
+  std::string select = "SELECT * FROM "s + default_name + " ORDER BY i;";
+  sqlAndCompareResult(select, {{i(1)}, {i(2)}});
+
+  // Change the file read before and add another one
+  bf::copy_file(getDataFilesPath() + "append_after/csv_dir_file/two_row_4_5.csv",
+                dir_path + "/two_row_1_2.csv",
+                bf::copy_option::overwrite_if_exists);
+  bf::copy_file(getDataFilesPath() + "append_after/csv_dir_file/one_row_3.csv",
+                dir_path + "/one_row_3.csv");
+  sql("REFRESH FOREIGN TABLES " + default_name + ";");
+
+  // All rows are scanned again
+  sqlAndCompareResult(select, {{i(3)}, {i(4)}, {i(5)}});
+
+  bf::remove_all(getDataFilesPath() + "append_tmp");
+}
+
 class FragmentSizesAppendRefreshTest : public AppendRefreshTest {};
 
 INSTANTIATE_TEST_SUITE_P(
@@ -361,6 +361,40 @@ TEST(Ordering, Triple) {
   }
 }
 
+TEST(Ordering, CostBased) {
+  // Star join, the filtered dimension table is probed first.
+  {
+    auto f1 = std::make_shared<Analyzer::ColumnVar>(SQLTypeInfo{kINT, true}, 0, 0, 0);
+    auto f2 = std::make_shared<Analyzer::ColumnVar>(SQLTypeInfo{kINT, true}, 0, 1, 0);
+    auto d1 = std::make_shared<Analyzer::ColumnVar>(SQLTypeInfo{kINT, true}, 1, 0, 1);
+    auto d2 = std::make_shared<Analyzer::ColumnVar>(SQLTypeInfo{kINT, true}, 2, 0, 2);
+    auto d2_filter =
+        std::make_shared<Analyzer::ColumnVar>(SQLTypeInfo{kINT, true}, 2, 1, 2);
+    Datum d;
+    d.intval = 42;
+    auto c = std::make_shared<Analyzer::Constant>(kINT, false, d);
+    auto op1 = std::make_shared<Analyzer::BinOper>(kBOOLEAN, kEQ, kONE, f1, d1);
+    auto op2 = std::make_shared<Analyzer::BinOper>(kBOOLEAN, kEQ, kONE, f2, d2);
+    auto filter = std::make_shared<Analyzer::BinOper>(kBOOLEAN, kEQ, kONE, d2_filter, c);
+
+    JoinCondition jc1{{op1}, JoinType::INNER};
+    JoinCondition jc2{{op2, filter}, JoinType::INNER};
+    JoinQualsPerNestingLevel nesting_levels;
+    nesting_levels.push_back(jc1);
+    nesting_levels.push_back(jc2);
+
+    size_t number_of_join_tables{3};
+    std::vector<InputTableInfo> viti(number_of_join_tables);
+    viti[0].info.setPhysicalNumTuples(1000);
+    viti[1].info.setPhysicalNumTuples(100);
+    viti[2].info.setPhysicalNumTuples(100);
+
+    auto input_permutation = get_node_input_permutation(nesting_levels, viti, nullptr);
+    decltype(input_permutation) expected_input_permutation{0, 2, 1};
+    ASSERT_EQ(expected_input_permutation, input_permutation);
+  }
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "DataMgr/GeoGridChunkIndex.h"
+#include "Shared/sqltypes.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+
+using Box = GeoGridChunkIndex::Box;
+
+const Box null_box{
+    NULL_ARRAY_DOUBLE, NULL_ARRAY_DOUBLE, NULL_ARRAY_DOUBLE, NULL_ARRAY_DOUBLE};
+
+bool intersects(const Box& a, const Box& b) {
+  return a[0] <= b[2] && b[0] <= a[2] && a[1] <= b[3] && b[1] <= a[3];
+}
+
+void check_row_ranges(const std::vector<Box>& boxes, const std::vector<Box>& probes) {
+  const GeoGridChunkIndex index(reinterpret_cast<const int8_t*>(boxes.data()),
+                                boxes.size());
+  ASSERT_EQ(boxes.size(), index.rowCount());
+  for (const auto& probe : probes) {
+    std::pair<size_t, size_t> expected{0, 0};
+    for (size_t row = 0; row < boxes.size(); ++row) {
+      const auto& box = boxes[row];
+      if (box[0] == NULL_ARRAY_DOUBLE || !intersects(box, probe)) {
+        continue;
+      }
+      expected = expected.first < expected.second
+                     ? std::make_pair(expected.first, row + 1)
+                     : std::make_pair(row, row + 1);
+    }
+    ASSERT_EQ(expected, index.getRowRange(probe))
+        << probe[0] << " " << probe[1] << " " << probe[2] << " " << probe[3];
+  }
+}
+
+}  // namespace
+
+TEST(GeoGridChunkIndex, RowRanges) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> coord(-100., 100.);
+  std::uniform_real_distribution<double> size(0., 5.);
+  std::vector<Box> boxes;
+  for (size_t i = 0; i < 500; ++i) {
+    const auto x = coord(gen);
+    const auto y = coord(gen);
+    boxes.push_back({x, y, x + size(gen), y + size(gen)});
+  }
+  // boxes covering most of the grid and null bounds
+  boxes[17] = {-90., -90., 90., 90.};
+  boxes[250] = null_box;
+  std::vector<Box> probes;
+  for (size_t i = 0; i < 200; ++i) {
+    const auto x = coord(gen);
+    const auto y = coord(gen);
+    probes.push_back({x, y, x, y});
+    probes.push_back({x, y, x + size(gen) * 4, y + size(gen) * 4});
+  }
+  probes.push_back({200., 200., 201., 201.});
+  probes.push_back({-1000., -1000., 1000., 1000.});
+  check_row_ranges(boxes, probes);
+}
+
+TEST(GeoGridChunkIndex, Degenerate) {
+  // points, all at the same place
+  const std::vector<Box> boxes(10, Box{1., 2., 1., 2.});
+  check_row_ranges(boxes, {{1., 2., 1., 2.}, {0., 0., 0.5, 0.5}, {0., 0., 3., 3.}});
+  // only null bounds
+  check_row_ranges(std::vector<Box>(3, null_box), {{0., 0., 1., 1.}});
+  check_row_ranges({}, {{0., 0., 1., 1.}});
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -128,8 +128,12 @@ void GpuReductionTester::codegenWrapperKernel() {
                                    "output_buffer_ptr");
   // call the reduction function
   CHECK(reduction_func_);
+  // perfect hash reductions never run out of slots, no error code buffer is needed
   std::vector<llvm::Value*> reduction_args{
-      output_buffer_ptr, smem_input_buffer_ptr, buffer_size};
+      output_buffer_ptr,
+      smem_input_buffer_ptr,
+      buffer_size,
+      llvm::ConstantPointerNull::get(llvm::Type::getInt32PtrTy(context_, address_space))};
   ir_builder.CreateCall(reduction_func_, reduction_args);
   ir_builder.CreateBr(bb_exit);
 
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
+#include "Shared/scope.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+using IntCache = HashTableCache<int, std::shared_ptr<std::vector<int32_t>>>;
+using LongCache = HashTableCache<int, std::shared_ptr<std::vector<int64_t>>>;
+
+const HashTableCacheTableKey table_a{1, 10};
+const HashTableCacheTableKey table_b{1, 20};
+
+template <class CACHE>
+void put(CACHE& cache,
+         const int key,
+         const size_t size_bytes,
+         const HashTableCacheTableKey& table_key = table_a,
+         const int64_t build_time_ms = 10) {
+  using Value = typename decltype(cache.get(key))::element_type;
+  cache.put(key, std::make_shared<Value>(), size_bytes, table_key, build_time_ms);
+}
+
+ScopeGuard set_max_bytes(const size_t max_bytes) {
+  const auto max_bytes_prev = g_hash_table_cache_max_bytes;
+  g_hash_table_cache_max_bytes = max_bytes;
+  return [max_bytes_prev] { g_hash_table_cache_max_bytes = max_bytes_prev; };
+}
+
+}  // namespace
+
+TEST(HashTableCache, HitsAndBuildTimeSaved) {
+  IntCache cache;
+  put(cache, 1, 100, table_a, 30);
+  put(cache, 2, 200, table_b, 5);
+  EXPECT_EQ(cache.size(), size_t(2));
+  EXPECT_NE(cache.get(1), nullptr);
+  EXPECT_NE(cache.get(1), nullptr);
+  EXPECT_EQ(cache.get(3), nullptr);
+  // peeking is not a use
+  EXPECT_NE(cache.peek(2), nullptr);
+
+  auto stats = HashTableCacheBase::getStats();
+  EXPECT_EQ(stats[table_a].builds, 1);
+  EXPECT_EQ(stats[table_a].hits, 2);
+  EXPECT_EQ(stats[table_a].build_time_ms, 30);
+  EXPECT_EQ(stats[table_a].build_time_saved_ms, 60);
+  EXPECT_EQ(stats[table_a].resident_bytes, size_t(100));
+  EXPECT_EQ(stats[table_b].hits, 0);
+  EXPECT_EQ(stats[table_b].num_entries, size_t(1));
+
+  // replacing an entry does not add up its size
+  put(cache, 2, 300, table_b, 5);
+  EXPECT_EQ(cache.size(), size_t(2));
+  EXPECT_EQ(HashTableCacheBase::getResidentBytes(), size_t(400));
+
+  // statistics outlive the entries
+  cache.clear();
+  EXPECT_EQ(HashTableCacheBase::getResidentBytes(), size_t(0));
+  stats = HashTableCacheBase::getStats();
+  EXPECT_EQ(stats[table_a].num_entries, size_t(0));
+  EXPECT_EQ(stats[table_a].hits, 2);
+  EXPECT_EQ(stats[table_b].builds, 2);
+}
+
+TEST(HashTableCache, BoundedByBytes) {
+  auto max_bytes_guard = set_max_bytes(1000);
+  IntCache cache;
+  put(cache, 1, 400);
+  put(cache, 2, 400);
+  ASSERT_NE(cache.get(1), nullptr);
+  put(cache, 3, 400);
+  // the least recently used entry goes first
+  EXPECT_EQ(cache.size(), size_t(2));
+  EXPECT_EQ(cache.get(2), nullptr);
+  EXPECT_NE(cache.get(1), nullptr);
+  EXPECT_NE(cache.get(3), nullptr);
+  EXPECT_EQ(HashTableCacheBase::getResidentBytes(), size_t(800));
+
+  // larger than the whole cache
+  put(cache, 4, 2000);
+  EXPECT_EQ(cache.get(4), nullptr);
+  EXPECT_EQ(cache.size(), size_t(2));
+}
+
+TEST(HashTableCache, BudgetSharedAcrossCaches) {
+  auto max_bytes_guard = set_max_bytes(1000);
+  IntCache perfect_cache;
+  LongCache baseline_cache;
+  put(perfect_cache, 1, 600);
+  put(baseline_cache, 1, 300);
+  ASSERT_NE(perfect_cache.get(1), nullptr);
+  put(baseline_cache, 2, 300);
+  // the baseline entry was used last a longer time ago
+  EXPECT_EQ(baseline_cache.get(1), nullptr);
+  EXPECT_NE(baseline_cache.get(2), nullptr);
+  EXPECT_NE(perfect_cache.get(1), nullptr);
+
+  put(perfect_cache, 2, 200);
+  EXPECT_EQ(baseline_cache.size(), size_t(0));
+  EXPECT_EQ(perfect_cache.size(), size_t(2));
+  EXPECT_EQ(HashTableCacheBase::getResidentBytes(), size_t(800));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
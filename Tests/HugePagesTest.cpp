@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "DataMgr/Allocators/ArenaAllocator.h"
+#include "Shared/HugePages.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+class HugePagesTest : public ::testing::Test {
+ protected:
+  void TearDown() override { g_huge_pages = "none"; }
+};
+
+TEST_F(HugePagesTest, ParseMode) {
+  EXPECT_EQ(huge_pages::Mode::None, huge_pages::parse_mode("none"));
+  EXPECT_EQ(huge_pages::Mode::Transparent, huge_pages::parse_mode("transparent"));
+  EXPECT_EQ(huge_pages::Mode::HugeTlb, huge_pages::parse_mode("hugetlb"));
+  EXPECT_THROW(huge_pages::parse_mode("2mb"), std::runtime_error);
+}
+
+TEST_F(HugePagesTest, Disabled) {
+  EXPECT_FALSE(huge_pages::allocate(huge_pages::kMinAllocationBytes));
+  int x;
+  EXPECT_FALSE(huge_pages::deallocate(&x));
+}
+
+TEST_F(HugePagesTest, SmallAllocation) {
+  g_huge_pages = "transparent";
+  EXPECT_FALSE(huge_pages::allocate(huge_pages::kMinAllocationBytes - 1));
+}
+
+TEST_F(HugePagesTest, Transparent) {
+  g_huge_pages = "transparent";
+  const auto bytes_before = huge_pages::get_stats().transparent_bytes;
+  // rounded up to a whole number of 2MB pages
+  const size_t num_bytes = huge_pages::kMinAllocationBytes + 1;
+  auto ptr = huge_pages::allocate(num_bytes);
+  ASSERT_TRUE(ptr);
+  EXPECT_EQ(uintptr_t(0), reinterpret_cast<uintptr_t>(ptr) % (size_t(2) << 20));
+  EXPECT_EQ(bytes_before + huge_pages::kMinAllocationBytes + (size_t(2) << 20),
+            huge_pages::get_stats().transparent_bytes);
+  std::memset(ptr, 1, num_bytes);
+  EXPECT_TRUE(huge_pages::deallocate(ptr));
+  EXPECT_EQ(bytes_before, huge_pages::get_stats().transparent_bytes);
+  EXPECT_FALSE(huge_pages::deallocate(ptr));
+}
+
+TEST_F(HugePagesTest, HugeTlb) {
+  g_huge_pages = "hugetlb";
+  const auto stats_before = huge_pages::get_stats();
+  auto ptr = huge_pages::allocate(huge_pages::kMinAllocationBytes);
+  ASSERT_TRUE(ptr);
+  // backed by the hugetlb pool, or by transparent huge pages when it is short
+  const auto stats = huge_pages::get_stats();
+  EXPECT_EQ(stats_before.transparent_bytes + stats_before.hugetlb_bytes +
+                huge_pages::kMinAllocationBytes,
+            stats.transparent_bytes + stats.hugetlb_bytes);
+  std::memset(ptr, 1, huge_pages::kMinAllocationBytes);
+  EXPECT_TRUE(huge_pages::deallocate(ptr));
+}
+
+TEST_F(HugePagesTest, ArenaBlocks) {
+  g_huge_pages = "transparent";
+  const auto bytes_before = huge_pages::get_stats().transparent_bytes;
+  {
+    Arena arena(huge_pages::kMinAllocationBytes);
+    auto ptr = arena.allocate(huge_pages::kMinAllocationBytes);
+    std::memset(ptr, 1, huge_pages::kMinAllocationBytes);
+    EXPECT_GT(huge_pages::get_stats().transparent_bytes, bytes_before);
+  }
+  EXPECT_EQ(bytes_before, huge_pages::get_stats().transparent_bytes);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <limits>
 #include <string>
+#include <tuple>
 
 #include <gtest/gtest.h>
 
@@ -569,6 +570,67 @@ TEST_F(ImportTestMiniSort, ctas_on_geo_point) {
   test_minisort_on_column_with_ctas("pt", {2, 3, 4, 5, 1});
 }
 
+class ImportTestUpsert : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists upsert_test;"));
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists sortab;"));
+  }
+
+  void TearDown() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists upsert_test;"));
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists sortab;"));
+  }
+};
+
+TEST_F(ImportTestUpsert, InPlace) {
+  SKIP_ALL_ON_AGGREGATOR();
+  ASSERT_NO_THROW(run_ddl_statement(
+      "create table upsert_test (k int, s text encoding dict(32), d double) with "
+      "(fragment_size=2);"));
+  ASSERT_NO_THROW(run_ddl_statement("insert into upsert_test values (1, 'uno', 1.0);"));
+  ASSERT_NO_THROW(run_ddl_statement("insert into upsert_test values (4, 'four', 4.0);"));
+  // the second copy only finds keys, among them those appended by the first
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_NO_THROW(run_ddl_statement(
+        "copy upsert_test from '../../Tests/Import/datafiles/upsert.csv' with "
+        "(header='false', upsert_key='k');"));
+    auto rows = run_query("SELECT k, s, d FROM upsert_test ORDER BY k;");
+    ASSERT_EQ(size_t(4), rows->rowCount());
+    const std::vector<std::tuple<int64_t, std::string, double>> expected{
+        {1, "one", 1.5}, {2, "deux", 2.25}, {3, "three", 3.5}, {4, "four", 4.0}};
+    for (const auto& [k, s, d] : expected) {
+      const auto row = rows->getNextRow(true, true);
+      ASSERT_EQ(size_t(3), row.size());
+      EXPECT_EQ(k, v<int64_t>(row[0]));
+      const auto ns = v<NullableString>(row[1]);
+      const auto str = boost::get<std::string>(&ns);
+      ASSERT_TRUE(str);
+      EXPECT_EQ(s, *str);
+      EXPECT_EQ(d, v<double>(row[2]));
+    }
+  }
+}
+
+TEST_F(ImportTestUpsert, VarlenColumns) {
+  SKIP_ALL_ON_AGGREGATOR();
+  ASSERT_NO_THROW(run_ddl_statement(std::string(create_table_mini_sort) + ";"));
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_NO_THROW(
+        run_ddl_statement("copy sortab from '../../Tests/Import/datafiles/mini_sort.txt' "
+                          "with (header='false', upsert_key='i');"));
+  }
+  check_minisort_on_expects("sortab", {5, 3, 1, 2, 4});
+}
+
+TEST_F(ImportTestUpsert, InvalidKey) {
+  ASSERT_NO_THROW(run_ddl_statement(
+      "create table upsert_test (k int, s text encoding none, d double);"));
+  EXPECT_ANY_THROW(
+      run_ddl_statement("copy upsert_test from '../../Tests/Import/datafiles/upsert.csv' "
+                        "with (header='false', upsert_key='s');"));
+}
+
 const char* create_table_mixed_varlen = R"(
     CREATE TABLE import_test_mixed_varlen(
       pt GEOMETRY(POINT),
@@ -1081,6 +1143,24 @@ TEST_F(ImportTest, One_csv_file) {
   EXPECT_TRUE(import_test_local("trip_data_9.csv", 100, 1.0));
 }
 
+TEST_F(ImportTest, Repeated_dict_strings) {
+  // the rows are alike, spread over the batches of the threads by the small buffers,
+  // and the second copy only finds strings the dictionaries already have
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_NO_THROW(run_ddl_statement(
+        "COPY trips FROM '../../Tests/Import/datafiles/trip_data_9.csv' WITH "
+        "(header='true', buffer_size=1024);"));
+  }
+  auto rows = run_query(
+      "SELECT COUNT(*), COUNT(DISTINCT medallion), COUNT(DISTINCT vendor_id) FROM trips "
+      "WHERE vendor_id = 'CMT' AND store_and_fwd_flag = 'N';");
+  const auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(size_t(3), crt_row.size());
+  EXPECT_EQ(int64_t(200), v<int64_t>(crt_row[0]));
+  EXPECT_EQ(int64_t(1), v<int64_t>(crt_row[1]));
+  EXPECT_EQ(int64_t(1), v<int64_t>(crt_row[2]));
+}
+
 TEST_F(ImportTest, array_including_quoted_fields) {
   EXPECT_TRUE(import_test_array_including_quoted_fields_local(
       "array_including_quoted_fields.csv", 2, "array_delimiter=','"));
@@ -2236,13 +2316,17 @@ TEST_F(ExportTest, CSV_Zip_Unimplemented) {
   RUN_TEST_ON_ALL_GEO_TYPES();
 }
 
-TEST_F(ExportTest, CSV_GZip_Unimplemented) {
+TEST_F(ExportTest, CSV_GZip) {
   SKIP_ALL_ON_AGGREGATOR();
   doCreateAndImport();
   auto run_test = [&](const std::string& geo_type) {
-    std::string exp_file = "query_export_test_geojson_" + geo_type + ".geojson";
-    EXPECT_THROW(doExport(exp_file, "CSV", "GZip", geo_type, WITH_ARRAYS, DEFAULT_SRID),
-                 std::runtime_error);
+    std::string req_file = "query_export_test_csv_" + geo_type + ".csv";
+    std::string exp_file = req_file + ".gz";
+    ASSERT_NO_THROW(
+        doExport(req_file, "CSV", "GZip", geo_type, WITH_ARRAYS, DEFAULT_SRID));
+    ASSERT_NO_THROW(doCompareText(exp_file, GZIPPED));
+    doImportAgainAndCompare(exp_file, "CSV", geo_type, WITH_ARRAYS);
+    removeExportedFile(exp_file);
   };
   RUN_TEST_ON_ALL_GEO_TYPES();
 }
@@ -2562,6 +2646,52 @@ TEST_F(ExportTest, Array_Null_Handling_NullField) {
                               ", array_null_handling='nullfield'"));
 }
 
+#ifdef ENABLE_IMPORT_PARQUET
+TEST_F(ExportTest, Parquet) {
+  SKIP_ALL_ON_AGGREGATOR();
+  ASSERT_NO_THROW(run_ddl_statement(
+      "CREATE TABLE query_export_test (col_int INTEGER, col_double DOUBLE, col_text "
+      "TEXT ENCODING DICT(32));"));
+  ASSERT_NO_THROW(run_ddl_statement(
+      "INSERT INTO query_export_test VALUES (1, 1.5, 'one');"));
+  ASSERT_NO_THROW(run_ddl_statement(
+      "INSERT INTO query_export_test VALUES (2, NULL, 'two');"));
+  ASSERT_NO_THROW(run_ddl_statement(
+      "INSERT INTO query_export_test VALUES (3, 3.5, NULL);"));
+  std::string exp_file = "query_export_test_parquet.parquet";
+  ASSERT_NO_THROW(
+      run_ddl_statement("COPY (SELECT col_int, col_double, col_text FROM "
+                        "query_export_test) TO '" +
+                        exp_file + "' WITH (file_type='Parquet');"));
+  ASSERT_NO_THROW(run_ddl_statement(
+      "CREATE TABLE query_export_test_reimport (col_int INTEGER, col_double DOUBLE, "
+      "col_text TEXT ENCODING DICT(32));"));
+  ASSERT_NO_THROW(run_ddl_statement("COPY query_export_test_reimport FROM '" BASE_PATH
+                                    "/mapd_export/" +
+                                    exp_file + "' WITH (parquet='true');"));
+  auto rows = run_query(
+      "SELECT COUNT(*), SUM(col_int), SUM(col_double), COUNT(col_text), "
+      "COUNT(DISTINCT col_text) FROM query_export_test_reimport;");
+  auto crt_row = rows->getNextRow(true, true);
+  CHECK_EQ(size_t(5), crt_row.size());
+  EXPECT_EQ(int64_t(3), v<int64_t>(crt_row[0]));
+  EXPECT_EQ(int64_t(6), v<int64_t>(crt_row[1]));
+  EXPECT_DOUBLE_EQ(5.0, v<double>(crt_row[2]));
+  EXPECT_EQ(int64_t(2), v<int64_t>(crt_row[3]));
+  EXPECT_EQ(int64_t(2), v<int64_t>(crt_row[4]));
+}
+
+TEST_F(ExportTest, Parquet_InvalidName) {
+  SKIP_ALL_ON_AGGREGATOR();
+  doCreateAndImport();
+  std::string exp_file = "query_export_test_parquet.csv";
+  EXPECT_THROW(
+      run_ddl_statement("COPY (SELECT col_integer FROM query_export_test) TO '" +
+                        exp_file + "' WITH (file_type='Parquet');"),
+      std::runtime_error);
+}
+#endif
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "DataMgr/IntegerCodecs.h"
+#include "QueryEngine/RuntimeFunctions.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+
+using namespace integer_codecs;
+
+namespace {
+
+constexpr int64_t kNull{std::numeric_limits<int64_t>::min()};
+
+int64_t decode(const IntegerCodec codec, const std::vector<int8_t>& stream, size_t pos) {
+  switch (codec) {
+    case IntegerCodec::FrameOfReference:
+      return frame_of_reference_int_decode_noinline(stream.data(), kNull, pos);
+    case IntegerCodec::Delta:
+      return delta_int_decode_noinline(stream.data(), kDeltaBlockSize, pos);
+    case IntegerCodec::RunLength:
+      return run_length_int_decode_noinline(stream.data(), pos);
+  }
+  return 0;
+}
+
+void check_round_trip(const std::vector<int64_t>& values) {
+  for (const auto codec :
+       {IntegerCodec::FrameOfReference, IntegerCodec::Delta, IntegerCodec::RunLength}) {
+    const auto stream = encode(codec, values, kNull);
+    ASSERT_EQ(encoded_size(codec, values, kNull), stream.size());
+    ASSERT_EQ(size_t(0), stream.size() % sizeof(int64_t));
+    for (size_t i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(values[i], decode(codec, stream, i))
+          << "codec " << static_cast<int>(codec) << " position " << i;
+    }
+  }
+}
+
+std::vector<int64_t> random_values(const size_t count,
+                                   const int64_t min,
+                                   const int64_t max,
+                                   const unsigned seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int64_t> dist(min, max);
+  std::vector<int64_t> values;
+  for (size_t i = 0; i < count; ++i) {
+    values.push_back(dist(gen));
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(IntegerCodecs, RoundTrip) {
+  check_round_trip({42});
+  check_round_trip({7, 7, 7, 7});
+  check_round_trip({kNull, kNull});
+  check_round_trip({3, kNull, -5, 1000, kNull});
+  check_round_trip(random_values(1000, -100, 100, 1));
+  check_round_trip(random_values(1000,
+                                 std::numeric_limits<int64_t>::min() + 1,
+                                 std::numeric_limits<int64_t>::max(),
+                                 2));
+  auto values = random_values(3000, 0, 1 << 20, 3);
+  values[10] = kNull;
+  values[2000] = kNull;
+  check_round_trip(values);
+}
+
+TEST(IntegerCodecs, SortedTimestamps) {
+  std::vector<int64_t> values;
+  int64_t epoch{1577836800};
+  for (const auto step : random_values(10000, 0, 3, 4)) {
+    epoch += step;
+    values.push_back(epoch);
+  }
+  check_round_trip(values);
+  // 3 bits per delta instead of 14 bits per offset from the minimum
+  EXPECT_LT(encoded_size(IntegerCodec::Delta, values, kNull),
+            encoded_size(IntegerCodec::FrameOfReference, values, kNull) / 2);
+  EXPECT_LT(encoded_size(IntegerCodec::Delta, values, kNull),
+            values.size() * sizeof(int64_t) / 8);
+  EXPECT_EQ(IntegerCodec::Delta, choose_codec(values, kNull));
+}
+
+TEST(IntegerCodecs, LowCardinality) {
+  const auto values = random_values(10000, 100, 107, 5);
+  check_round_trip(values);
+  EXPECT_EQ(IntegerCodec::FrameOfReference, choose_codec(values, kNull));
+  EXPECT_LE(encoded_size(IntegerCodec::FrameOfReference, values, kNull),
+            kHeaderSize + values.size() * 3 / 8 + sizeof(int64_t));
+}
+
+TEST(IntegerCodecs, Runs) {
+  std::vector<int64_t> values;
+  for (const auto val : random_values(100, -1000000, 1000000, 6)) {
+    values.insert(values.end(), 500, val);
+  }
+  values.insert(values.end(), 500, kNull);
+  check_round_trip(values);
+  EXPECT_EQ(IntegerCodec::RunLength, choose_codec(values, kNull));
+  EXPECT_EQ(kHeaderSize + 101 * sizeof(int64_t) + 51 * sizeof(int64_t),
+            encoded_size(IntegerCodec::RunLength, values, kNull));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
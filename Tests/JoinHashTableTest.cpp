@@ -35,6 +35,7 @@
 #include "QueryEngine/ResultSet.h"
 #include "QueryEngine/UDFCompiler.h"
 #include "QueryRunner/QueryRunner.h"
+#include "Shared/scope.h"
 #include "Shared/thread_count.h"
 #include "TestHelpers.h"
 
@@ -47,6 +48,9 @@ using namespace TestHelpers;
 
 using QR = QueryRunner::QueryRunner;
 
+extern size_t g_hash_join_partition_threshold_bytes;
+extern size_t g_hash_join_partition_bytes;
+
 namespace {
 ExecutorDeviceType g_device_type;
 }
@@ -458,6 +462,72 @@ TEST(Build, KeyedOneToMany) {
   }
 }
 
+TEST(Build, KeyedPartitioned) {
+  auto catalog = QR::get()->getCatalog();
+  CHECK(catalog);
+
+  auto executor = Executor::getExecutor(catalog->getCurrentDB().dbId);
+  CHECK(executor);
+  executor->setCatalog(catalog.get());
+
+  const auto partition_threshold_bytes = g_hash_join_partition_threshold_bytes;
+  const auto partition_bytes = g_hash_join_partition_bytes;
+  ScopeGuard reset_partitioning = [partition_threshold_bytes, partition_bytes] {
+    g_hash_join_partition_threshold_bytes = partition_threshold_bytes;
+    g_hash_join_partition_bytes = partition_bytes;
+  };
+  // a partition per hash entry
+  g_hash_join_partition_threshold_bytes = 0;
+  g_hash_join_partition_bytes = 1;
+
+  g_device_type = ExecutorDeviceType::CPU;
+  JoinHashTableCacheInvalidator::invalidateCaches();
+
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+
+    create table table1 (a1 integer, a2 integer);
+    create table table2 (b integer);
+
+    insert into table1 values (1, 11);
+    insert into table1 values (2, 12);
+    insert into table1 values (3, 13);
+    insert into table1 values (4, 14);
+
+    insert into table2 values (0);
+    insert into table2 values (1);
+    insert into table2 values (3);
+  )");
+
+  auto a1 = getSyntheticColumnVar("table1", "a1", 0, executor.get());
+  auto a2 = getSyntheticColumnVar("table1", "a2", 0, executor.get());
+  auto b = getSyntheticColumnVar("table2", "b", 1, executor.get());
+
+  using VE = std::vector<std::shared_ptr<Analyzer::Expr>>;
+  auto et1 = std::make_shared<Analyzer::ExpressionTuple>(VE{a1, a2});
+  auto et2 = std::make_shared<Analyzer::ExpressionTuple>(VE{b, b});
+  auto op = std::make_shared<Analyzer::BinOper>(kBOOLEAN, kEQ, kONE, et1, et2);
+
+  auto hash_table = buildKeyed(op);
+  EXPECT_EQ(hash_table->getHashType(), JoinHashTableInterface::HashType::OneToOne);
+  const DecodedJoinHashBufferSet s1 = {{{0, 0}, {0}}, {{1, 1}, {1}}, {{3, 3}, {2}}};
+  EXPECT_EQ(s1, hash_table->toSet(g_device_type, 0));
+
+  // duplicate keys still fall back to one-to-many
+  sql("insert into table2 values (3);");
+  JoinHashTableCacheInvalidator::invalidateCaches();
+  hash_table = buildKeyed(op);
+  EXPECT_EQ(hash_table->getHashType(), JoinHashTableInterface::HashType::OneToMany);
+  const DecodedJoinHashBufferSet s2 = {{{0}, {0}}, {{1}, {1}}, {{3}, {2, 3}}};
+  EXPECT_EQ(s2, hash_table->toSet(g_device_type, 0));
+
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+  )");
+}
+
 TEST(Build, GeoOneToMany1) {
   auto catalog = QR::get()->getCatalog();
   CHECK(catalog);
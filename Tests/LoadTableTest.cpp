@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
+#include "ImportExport/GroupCommit.h"
+#include "Shared/scope.h"
 #include "Tests/DBHandlerTestHelpers.h"
 #include "Tests/TestHelpers.h"
 
@@ -134,6 +138,76 @@ TEST_F(LoadTableTest, ColumnarNullGeoColumn) {
                       {{i(1), "s", "nns", "NULL", LINESTRING}});
 }
 
+TEST_F(LoadTableTest, GroupCommit) {
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  const auto saved_window = g_group_commit_window_ms;
+  ScopeGuard reset_window = [saved_window] { g_group_commit_window_ms = saved_window; };
+  g_group_commit_window_ms = 500;
+
+  auto& cat = getCatalog();
+  const auto td = cat.getMetadataForTable("load_test");
+  CHECK(td);
+  const auto epoch = cat.getTableEpoch(cat.getDatabaseId(), td->tableId);
+  constexpr int64_t kLoads{8};
+  std::vector<std::thread> loads;
+  for (int64_t load_idx = 0; load_idx < kLoads; ++load_idx) {
+    loads.emplace_back([&, load_idx] {
+      TStringRow row;
+      row.cols = {getSV(std::to_string(load_idx)), getSV("s"), getSV("nns")};
+      EXPECT_NO_THROW(handler->load_table(session, "load_test", {row}));
+    });
+  }
+  for (auto& load : loads) {
+    load.join();
+  }
+  sqlAndCompareResult("SELECT COUNT(*), SUM(i1) FROM load_test",
+                      {{kLoads, kLoads * (kLoads - 1) / 2}});
+  if (!isDistributedMode()) {
+    // the loads which joined the same commit were checkpointed at once
+    EXPECT_LT(cat.getTableEpoch(cat.getDatabaseId(), td->tableId), epoch + kLoads);
+  }
+}
+
+TEST_F(LoadTableTest, GroupCommitCoalesced) {
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  const auto saved_window = g_group_commit_window_ms;
+  const auto saved_coalesce_rows = g_group_commit_coalesce_rows;
+  ScopeGuard reset_window = [saved_window, saved_coalesce_rows] {
+    g_group_commit_window_ms = saved_window;
+    g_group_commit_coalesce_rows = saved_coalesce_rows;
+  };
+  g_group_commit_window_ms = 500;
+  g_group_commit_coalesce_rows = 100;
+
+  constexpr int64_t kLoads{8};
+  std::vector<std::thread> loads;
+  for (int64_t load_idx = 0; load_idx < kLoads; ++load_idx) {
+    loads.emplace_back([&, load_idx] {
+      TColumn i1_column;
+      i1_column.nulls = {false, false};
+      i1_column.data.int_col = {2 * load_idx, 2 * load_idx + 1};
+      TColumn s_column;
+      s_column.nulls = {false, true};
+      s_column.data.str_col = {"s" + std::to_string(load_idx), ""};
+      TColumn nns_column;
+      nns_column.nulls = {false, false};
+      nns_column.data.str_col = {"nns", "nns"};
+      EXPECT_NO_THROW(handler->load_table_binary_columnar(
+          session, "load_test", {i1_column, s_column, nns_column}));
+    });
+  }
+  for (auto& load : loads) {
+    load.join();
+  }
+  // the rows of every load were inserted, with their strings and nulls
+  sqlAndCompareResult(
+      "SELECT COUNT(*), SUM(i1), COUNT(s), COUNT(DISTINCT s) FROM load_test",
+      {{2 * kLoads, kLoads * (2 * kLoads - 1), kLoads, kLoads}});
+  sqlAndCompareResult("SELECT s FROM load_test WHERE i1 = 6", {{"s3"}});
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
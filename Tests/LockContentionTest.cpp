@@ -0,0 +1,111 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "Shared/LockContention.h"
+#include "Shared/mapd_shared_mutex.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+lock_contention::LockStats stats_of(const std::string& lock_class) {
+  for (const auto& stats : lock_contention::get_stats()) {
+    if (stats.lock_class == lock_class) {
+      return stats;
+    }
+  }
+  return {};
+}
+
+}  // namespace
+
+class LockContentionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    g_enable_lock_contention_profiling = true;
+    lock_contention::reset_profiles();
+  }
+
+  void TearDown() override { g_enable_lock_contention_profiling = false; }
+};
+
+TEST_F(LockContentionTest, Uncontended) {
+  mapd_shared_mutex mutex;
+  auto& profile = lock_contention::get_profile("test_uncontended");
+  for (uint32_t i = 0; i < lock_contention::kHoldSampleInterval; ++i) {
+    lock_contention::ProfiledLock<mapd_shared_lock<mapd_shared_mutex>> lock(mutex,
+                                                                            profile);
+  }
+  const auto stats = stats_of("test_uncontended");
+  EXPECT_EQ(uint64_t(lock_contention::kHoldSampleInterval), stats.acquisitions);
+  EXPECT_EQ(uint64_t(0), stats.contended);
+  EXPECT_EQ(uint64_t(0), stats.wait_ns);
+  // one acquisition of each thread out of kHoldSampleInterval is timed
+  EXPECT_EQ(uint64_t(1), stats.sampled_holds);
+}
+
+TEST_F(LockContentionTest, Contended) {
+  mapd_shared_mutex mutex;
+  auto& profile = lock_contention::get_profile("test_contended");
+  std::unique_lock<mapd_shared_mutex> held(mutex);
+  std::thread waiter([&mutex, &profile] {
+    lock_contention::ProfiledLock<mapd_unique_lock<mapd_shared_mutex>> lock(mutex,
+                                                                            profile);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  held.unlock();
+  waiter.join();
+  const auto stats = stats_of("test_contended");
+  EXPECT_EQ(uint64_t(1), stats.acquisitions);
+  EXPECT_EQ(uint64_t(1), stats.contended);
+  EXPECT_GE(stats.wait_ns, uint64_t(40'000'000));
+  EXPECT_EQ(stats.wait_ns, stats.max_wait_ns);
+}
+
+TEST_F(LockContentionTest, Disabled) {
+  g_enable_lock_contention_profiling = false;
+  std::mutex mutex;
+  auto& profile = lock_contention::get_profile("test_disabled");
+  {
+    lock_contention::ProfiledLock<std::unique_lock<std::mutex>> lock(mutex, profile);
+  }
+  EXPECT_EQ(uint64_t(0), stats_of("test_disabled").acquisitions);
+}
+
+TEST_F(LockContentionTest, SameProfile) {
+  EXPECT_EQ(&lock_contention::get_profile("test_class", "1,2"),
+            &lock_contention::get_profile("test_class", "1,2"));
+  EXPECT_NE(&lock_contention::get_profile("test_class", "1,2"),
+            &lock_contention::get_profile("test_class", "1,3"));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "Shared/Metrics.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool contains(const std::string& text, const std::string& line) {
+  return text.find(line + "\n") != std::string::npos;
+}
+
+}  // namespace
+
+TEST(Metrics, Counters) {
+  auto& registry = metrics::Registry::instance();
+  auto& counter = registry.counter(
+      "test_counter_total", "A test counter.", {{"level", "CPU"}, {"device", "0"}});
+  EXPECT_EQ(&counter,
+            &registry.counter("test_counter_total",
+                              "A test counter.",
+                              {{"level", "CPU"}, {"device", "0"}}));
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&counter] {
+      for (size_t j = 0; j < 1000; ++j) {
+        counter.inc();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(uint64_t(4000), counter.value());
+  const auto text = registry.render();
+  EXPECT_TRUE(contains(text, "# HELP test_counter_total A test counter."));
+  EXPECT_TRUE(contains(text, "# TYPE test_counter_total counter"));
+  EXPECT_TRUE(contains(text, "test_counter_total{level=\"CPU\",device=\"0\"} 4000"));
+}
+
+TEST(Metrics, Histograms) {
+  auto& histogram = metrics::Registry::instance().histogram(
+      "test_latency_ms", "A test histogram.", {1, 10});
+  histogram.observe(0.5);
+  histogram.observe(1);
+  histogram.observe(5);
+  histogram.observe(50);
+  EXPECT_EQ(uint64_t(4), histogram.count());
+  EXPECT_DOUBLE_EQ(56.5, histogram.sum());
+  EXPECT_EQ(std::vector<uint64_t>({2, 3, 4}), histogram.cumulativeCounts());
+  const auto text = metrics::Registry::instance().render();
+  EXPECT_TRUE(contains(text, "# TYPE test_latency_ms histogram"));
+  EXPECT_TRUE(contains(text, "test_latency_ms_bucket{le=\"1\"} 2"));
+  EXPECT_TRUE(contains(text, "test_latency_ms_bucket{le=\"10\"} 3"));
+  EXPECT_TRUE(contains(text, "test_latency_ms_bucket{le=\"+Inf\"} 4"));
+  EXPECT_TRUE(contains(text, "test_latency_ms_sum 56.5"));
+  EXPECT_TRUE(contains(text, "test_latency_ms_count 4"));
+}
+
+TEST(Metrics, Collectors) {
+  auto& registry = metrics::Registry::instance();
+  const auto collector_id = registry.addCollector([](auto& samples) {
+    samples.push_back(
+        {"test_queue_depth", "A test gauge.", "gauge", {{"name", "a\"b"}}, 3});
+    samples.push_back(
+        {"test_queue_depth", "A test gauge.", "gauge", {{"name", "c"}}, 1234567});
+  });
+  auto text = registry.render();
+  EXPECT_TRUE(contains(text, "# TYPE test_queue_depth gauge"));
+  EXPECT_TRUE(contains(text, "test_queue_depth{name=\"a\\\"b\"} 3"));
+  EXPECT_TRUE(contains(text, "test_queue_depth{name=\"c\"} 1234567"));
+  EXPECT_EQ(text.find("# TYPE test_queue_depth"),
+            text.rfind("# TYPE test_queue_depth"));
+  registry.removeCollector(collector_id);
+  text = registry.render();
+  EXPECT_EQ(std::string::npos, text.find("test_queue_depth"));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "QueryEngine/OutputBufferPool.h"
+
+#include <gtest/gtest.h>
+
+class OutputBufferPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override { OutputBufferPool::instance().clear(); }
+
+  void TearDown() override {
+    g_output_buffer_pool_max_idle_bytes = size_t(1) << 30;
+    OutputBufferPool::instance().clear();
+  }
+};
+
+TEST_F(OutputBufferPoolTest, Reuse) {
+  auto& pool = OutputBufferPool::instance();
+  const auto hits = pool.getStats().hits;
+  const auto buffer = pool.acquire(100000);
+  ASSERT_TRUE(buffer.ptr);
+  // rounded up to the size class
+  EXPECT_EQ(size_t(1) << 17, buffer.capacity);
+  pool.release(buffer);
+  EXPECT_EQ(buffer.capacity, pool.getStats().idle_bytes);
+
+  // any size of the class gets the same buffer back
+  const auto reused = pool.acquire(70000);
+  EXPECT_EQ(buffer.ptr, reused.ptr);
+  EXPECT_EQ(hits + 1, pool.getStats().hits);
+  EXPECT_EQ(size_t(0), pool.getStats().idle_bytes);
+  pool.release(reused);
+}
+
+TEST_F(OutputBufferPoolTest, NotPooled) {
+  auto& pool = OutputBufferPool::instance();
+  EXPECT_FALSE(pool.acquire(OutputBufferPool::kMinPooledBytes - 1).ptr);
+  EXPECT_FALSE(pool.acquire(OutputBufferPool::kMaxPooledBytes + 1).ptr);
+}
+
+TEST_F(OutputBufferPoolTest, MaxIdleBytes) {
+  auto& pool = OutputBufferPool::instance();
+  g_output_buffer_pool_max_idle_bytes = OutputBufferPool::kMinPooledBytes;
+  const auto first = pool.acquire(OutputBufferPool::kMinPooledBytes);
+  const auto second = pool.acquire(OutputBufferPool::kMinPooledBytes);
+  pool.release(first);
+  // over the limit, freed
+  pool.release(second);
+  EXPECT_EQ(OutputBufferPool::kMinPooledBytes, pool.getStats().idle_bytes);
+  pool.clear();
+  EXPECT_EQ(size_t(0), pool.getStats().idle_bytes);
+}
+
+TEST_F(OutputBufferPoolTest, ReturnedWithOwner) {
+  auto& pool = OutputBufferPool::instance();
+  {
+    RowSetMemoryOwner owner(/*arena_block_size=*/1 << 20);
+    auto ptr = owner.allocateOutputBuffer(OutputBufferPool::kMinPooledBytes);
+    ASSERT_TRUE(ptr);
+    EXPECT_EQ(OutputBufferPool::kMinPooledBytes, owner.getAllocatedBytes());
+    EXPECT_EQ(size_t(0), pool.getStats().idle_bytes);
+  }
+  EXPECT_EQ(OutputBufferPool::kMinPooledBytes, pool.getStats().idle_bytes);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/PackedKeySort.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+
+namespace {
+
+struct OrderColumn {
+  std::vector<int64_t> values;
+  std::vector<int8_t> nulls;
+  bool desc;
+  bool nulls_first;
+};
+
+packed_key_sort::SortColumn to_sort_column(const OrderColumn& order_column) {
+  packed_key_sort::SortColumn column;
+  for (const auto value : order_column.values) {
+    column.values.push_back(packed_key_sort::normalize_int(value, order_column.desc));
+  }
+  column.nulls = order_column.nulls;
+  column.nulls_first = order_column.nulls_first;
+  return column;
+}
+
+// The order a comparator based ORDER BY gives.
+std::vector<uint32_t> reference_sort(const std::vector<OrderColumn>& order_columns,
+                                     const size_t row_count) {
+  std::vector<uint32_t> idx(row_count);
+  std::iota(idx.begin(), idx.end(), 0);
+  std::stable_sort(idx.begin(), idx.end(), [&](const uint32_t lhs, const uint32_t rhs) {
+    for (const auto& column : order_columns) {
+      const bool lhs_null = !column.nulls.empty() && column.nulls[lhs];
+      const bool rhs_null = !column.nulls.empty() && column.nulls[rhs];
+      if (lhs_null || rhs_null) {
+        if (lhs_null == rhs_null) {
+          continue;
+        }
+        return column.nulls_first ? lhs_null : rhs_null;
+      }
+      const auto lhs_value = column.values[lhs];
+      const auto rhs_value = column.values[rhs];
+      if (lhs_value != rhs_value) {
+        return column.desc ? lhs_value > rhs_value : lhs_value < rhs_value;
+      }
+    }
+    return false;
+  });
+  return idx;
+}
+
+std::vector<uint32_t> packed_sort(const std::vector<OrderColumn>& order_columns,
+                                  const size_t thread_count) {
+  std::vector<packed_key_sort::SortColumn> columns;
+  for (const auto& order_column : order_columns) {
+    columns.push_back(to_sort_column(order_column));
+  }
+  const auto keys = packed_key_sort::pack(columns);
+  CHECK(keys);
+  return packed_key_sort::sort(*keys, thread_count);
+}
+
+OrderColumn make_column(const size_t row_count,
+                        const int64_t min_val,
+                        const int64_t max_val,
+                        const double null_ratio,
+                        const bool desc,
+                        const bool nulls_first,
+                        const unsigned seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int64_t> dist(min_val, max_val);
+  std::bernoulli_distribution null_dist(null_ratio);
+  OrderColumn column{{}, {}, desc, nulls_first};
+  for (size_t i = 0; i < row_count; ++i) {
+    column.values.push_back(dist(gen));
+    if (null_ratio > 0) {
+      column.nulls.push_back(null_dist(gen));
+    }
+  }
+  return column;
+}
+
+}  // namespace
+
+TEST(PackedKeySort, NormalizeFp) {
+  const std::vector<double> values{-std::numeric_limits<double>::infinity(),
+                                   -1e300,
+                                   -2.5,
+                                   -0.,
+                                   0.,
+                                   1e-300,
+                                   3.,
+                                   std::numeric_limits<double>::max()};
+  for (size_t i = 0; i + 1 < values.size(); ++i) {
+    EXPECT_LE(packed_key_sort::normalize_fp(values[i], false),
+              packed_key_sort::normalize_fp(values[i + 1], false));
+    EXPECT_GE(packed_key_sort::normalize_fp(values[i], true),
+              packed_key_sort::normalize_fp(values[i + 1], true));
+  }
+  EXPECT_LT(packed_key_sort::normalize_int(-1, false),
+            packed_key_sort::normalize_int(0, false));
+  EXPECT_LT(packed_key_sort::normalize_int(std::numeric_limits<int64_t>::min(), false),
+            packed_key_sort::normalize_int(std::numeric_limits<int64_t>::max(), false));
+}
+
+TEST(PackedKeySort, PacksNarrowColumnsInOneWord) {
+  const size_t row_count{1000};
+  std::vector<OrderColumn> order_columns{
+      make_column(row_count, -100, 100, 0, false, false, 1),
+      make_column(row_count, 0, 1, 0.1, true, true, 2),
+      make_column(row_count, 7, 7, 0, false, false, 3),
+      make_column(row_count, 1000, 1000000, 0.5, false, false, 4)};
+  std::vector<packed_key_sort::SortColumn> columns;
+  for (const auto& order_column : order_columns) {
+    columns.push_back(to_sort_column(order_column));
+  }
+  const auto keys = packed_key_sort::pack(columns);
+  ASSERT_TRUE(keys);
+  // 8 + 2 + 0 + 20 bits
+  ASSERT_EQ(size_t(1), keys->words.size());
+  EXPECT_EQ(30u, keys->word_bits.front());
+  EXPECT_EQ(reference_sort(order_columns, row_count), packed_sort(order_columns, 1));
+}
+
+TEST(PackedKeySort, MultipleWords) {
+  const size_t row_count{5000};
+  std::vector<OrderColumn> order_columns{
+      make_column(row_count, -1000, 1000, 0.05, true, false, 5),
+      make_column(row_count,
+                  std::numeric_limits<int64_t>::min(),
+                  std::numeric_limits<int64_t>::max(),
+                  0,
+                  false,
+                  false,
+                  6),
+      make_column(row_count, -(int64_t(1) << 40), int64_t(1) << 40, 0.2, false, true, 7)};
+  EXPECT_EQ(reference_sort(order_columns, row_count), packed_sort(order_columns, 1));
+}
+
+TEST(PackedKeySort, NullableFullRange) {
+  const size_t row_count{100};
+  std::vector<packed_key_sort::SortColumn> columns(1);
+  for (size_t i = 0; i < row_count; ++i) {
+    columns.front().values.push_back(i & 1 ? std::numeric_limits<uint64_t>::max() : 0);
+    columns.front().nulls.push_back(i % 3 == 0);
+  }
+  EXPECT_FALSE(packed_key_sort::pack(columns));
+}
+
+TEST(PackedKeySort, Parallel) {
+  const size_t row_count{500000};
+  std::vector<OrderColumn> order_columns{
+      make_column(row_count, 0, 50, 0.01, false, true, 8),
+      make_column(row_count, -(int64_t(1) << 50), int64_t(1) << 50, 0, true, false, 9)};
+  EXPECT_EQ(reference_sort(order_columns, row_count), packed_sort(order_columns, 8));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/PersistentCodeCache.h"
+
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+
+class PersistentCodeCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("omnisci_code_cache_test_%%%%-%%%%");
+  }
+
+  void TearDown() override { boost::filesystem::remove_all(path_); }
+
+  boost::filesystem::path path_;
+};
+
+}  // namespace
+
+TEST_F(PersistentCodeCacheTest, StoreAndLoad) {
+  PersistentCodeCache cache(path_.string());
+  const auto key = PersistentCodeCache::makeKey({"query_func", "row_func"}, "x86_64");
+  EXPECT_EQ(cache.load(key), nullptr);
+
+  const std::string code{"\x7f" "ELF\0binary", 11};
+  cache.store(key, code);
+  auto loaded = cache.load(key);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->getBuffer().str(), code);
+
+  // a fresh instance over the same directory, as after a restart
+  PersistentCodeCache restarted(path_.string());
+  loaded = restarted.load(key);
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_EQ(loaded->getBuffer().str(), code);
+}
+
+TEST_F(PersistentCodeCacheTest, KeyIncludesTarget) {
+  PersistentCodeCache cache(path_.string());
+  const CodeCacheKey key{"query_func", "row_func"};
+  cache.store(PersistentCodeCache::makeKey(key, "sm_70"), "cubin_70");
+  EXPECT_EQ(cache.load(PersistentCodeCache::makeKey(key, "sm_75")), nullptr);
+  EXPECT_EQ(cache.load(PersistentCodeCache::makeKey({"query_func"}, "sm_70")), nullptr);
+  // key parts are length prefixed, concatenations must not alias
+  EXPECT_NE(PersistentCodeCache::makeKey({"ab", "c"}, "t"),
+            PersistentCodeCache::makeKey({"a", "bc"}, "t"));
+}
+
+TEST_F(PersistentCodeCacheTest, ObjectCache) {
+  PersistentCodeCache cache(path_.string());
+  const auto key = PersistentCodeCache::makeKey({"multifrag_query"}, "x86_64");
+  {
+    PersistentObjectCache object_cache(cache, key);
+    EXPECT_FALSE(object_cache.hasObject());
+    EXPECT_EQ(object_cache.getObject(nullptr), nullptr);
+    const std::string obj{"object"};
+    object_cache.notifyObjectCompiled(nullptr, llvm::MemoryBufferRef(obj, "obj"));
+  }
+  PersistentObjectCache object_cache(cache, key);
+  EXPECT_TRUE(object_cache.hasObject());
+  auto obj = object_cache.getObject(nullptr);
+  ASSERT_NE(obj, nullptr);
+  EXPECT_EQ(obj->getBuffer().str(), "object");
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "DBHandlerTestHelpers.h"
+#include "DataMgr/PersistentStorageMgr/ColdStorage.h"
 #include "DataMgr/PersistentStorageMgr/MutableCachePersistentStorageMgr.h"
 #include "DataMgr/PersistentStorageMgr/PersistentStorageMgr.h"
 #include "DataMgrTestHelpers.h"
@@ -51,6 +52,68 @@ TEST_F(PersistentStorageMgrTest, MutableDiskCache_CustomPath) {
   ASSERT_EQ(psm.getDiskCache()->getGlobalFileMgr()->getBasePath(), cache_path_ + "/");
 }
 
+class ColdStorageTest : public testing::Test {
+ protected:
+  inline static const std::string index_path_ = "./test_cold_storage_index";
+  inline static const std::string objects_path_ = "./test_cold_storage_objects";
+  void SetUp() override {
+    boost::filesystem::create_directories(index_path_);
+    boost::filesystem::remove_all(objects_path_);
+  }
+  void TearDown() override {
+    boost::filesystem::remove_all(index_path_);
+    boost::filesystem::remove_all(objects_path_);
+  }
+};
+
+TEST_F(ColdStorageTest, OffloadFetchRemove) {
+  const ChunkKey chunk_key{1, 2, 3, 4};
+  std::vector<int32_t> values{7, -3, 12, 5};
+  ForeignStorageBuffer buffer;
+  buffer.initEncoder(SQLTypeInfo(kINT, false));
+  auto values_ptr = reinterpret_cast<int8_t*>(values.data());
+  buffer.getEncoder()->appendData(values_ptr, values.size(), buffer.getSqlType());
+  {
+    ColdStorage cold_storage(index_path_, "file://" + objects_path_);
+    cold_storage.uploadChunk(chunk_key, &buffer, 1024);
+    // not cold until committed
+    EXPECT_FALSE(cold_storage.hasChunk(chunk_key));
+    cold_storage.commitUploadedChunks();
+    EXPECT_TRUE(cold_storage.hasChunk(chunk_key));
+  }
+
+  // the index survives a restart
+  ColdStorage cold_storage(index_path_, objects_path_);
+  ASSERT_TRUE(cold_storage.hasChunk(chunk_key));
+  EXPECT_EQ(size_t(1024), cold_storage.getPageSize(chunk_key));
+  ChunkMetadataVector chunk_metadata_vec;
+  cold_storage.getChunkMetadataVecForKeyPrefix(chunk_metadata_vec, {1, 2});
+  ASSERT_EQ(size_t(1), chunk_metadata_vec.size());
+  const auto& chunk_metadata = chunk_metadata_vec[0].second;
+  EXPECT_EQ(chunk_key, chunk_metadata_vec[0].first);
+  EXPECT_EQ(values.size(), chunk_metadata->numElements);
+  EXPECT_EQ(values.size() * sizeof(int32_t), chunk_metadata->numBytes);
+  EXPECT_EQ(-3, chunk_metadata->chunkStats.min.intval);
+  EXPECT_EQ(12, chunk_metadata->chunkStats.max.intval);
+
+  ForeignStorageBuffer fetched_buffer;
+  cold_storage.fetchChunk(chunk_key, &fetched_buffer, 0);
+  ASSERT_EQ(buffer.size(), fetched_buffer.size());
+  EXPECT_EQ(0,
+            memcmp(buffer.getMemoryPtr(), fetched_buffer.getMemoryPtr(), buffer.size()));
+  ASSERT_TRUE(fetched_buffer.hasEncoder());
+  EXPECT_EQ(values.size(), fetched_buffer.getEncoder()->getNumElems());
+
+  cold_storage.setLocal(chunk_key);
+  EXPECT_EQ(std::vector<ChunkKey>{chunk_key}, cold_storage.takeLocalChunks({1, 2}));
+  EXPECT_TRUE(cold_storage.takeLocalChunks({1, 2}).empty());
+
+  cold_storage.removeChunks({chunk_key});
+  EXPECT_FALSE(cold_storage.hasChunk(chunk_key));
+  EXPECT_TRUE(boost::filesystem::is_empty(objects_path_));
+  EXPECT_EQ(size_t(0), ColdStorage(index_path_, objects_path_).getNumChunks());
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "Calcite/PlanTemplate.h"
+
+#include <gtest/gtest.h>
+
+using namespace plan_template;
+
+namespace {
+
+std::string make_plan(const std::string& str, const int64_t num, const int num_scale) {
+  const auto num_precision = std::to_string(std::to_string(num).size());
+  return R"({"rels":[{"id":"0","relOp":"LogicalFilter","condition":{"op":"AND",)"
+         R"("operands":[{"op":"=","operands":[{"input":0},{"literal":")" +
+         str + R"(","type":"CHAR","target_type":"CHAR","scale":-2147483648,)"
+         R"("precision":)" +
+         std::to_string(str.size()) + R"(,"type_scale":-2147483648,"type_precision":)" +
+         std::to_string(str.size()) +
+         R"(}]},{"op":">","operands":[{"input":1},{"literal":)" + std::to_string(num) +
+         R"(,"type":"DECIMAL","target_type":"DECIMAL","scale":)" +
+         std::to_string(num_scale) + R"(,"precision":)" + num_precision +
+         R"(,"type_scale":)" + std::to_string(num_scale) +
+         R"(,"type_precision":)" + num_precision + "}]}]}}]}";
+}
+
+}  // namespace
+
+TEST(PlanTemplate, Normalize) {
+  const auto a =
+      normalize_sql("SELECT  x\n FROM t -- comment\n WHERE s = 'abc' AND y > 1.50;");
+  const auto b = normalize_sql("SELECT x FROM t WHERE s = 'xyz' AND y > 2.25;");
+  ASSERT_TRUE(a && b);
+  EXPECT_NE(a->exact_key, b->exact_key);
+  EXPECT_EQ(a->template_key, b->template_key);
+  EXPECT_EQ(a->exact_key, "SELECT x FROM t WHERE s = 'abc' AND y > 1.50;");
+  ASSERT_EQ(a->literals.size(), size_t(2));
+  EXPECT_EQ(a->literals[0].string_value, "abc");
+  EXPECT_EQ(a->literals[1].unscaled_value, 150);
+  EXPECT_EQ(a->literals[1].precision, 3);
+  EXPECT_EQ(a->literals[1].scale, 2);
+
+  // different literal shapes are typed differently by Calcite
+  const auto c = normalize_sql("SELECT x FROM t WHERE s = 'ab' AND y > 2.25;");
+  const auto d = normalize_sql("SELECT x FROM t WHERE s = 'abc' AND y > 2.5;");
+  ASSERT_TRUE(c && d);
+  EXPECT_NE(a->template_key, c->template_key);
+  EXPECT_NE(a->template_key, d->template_key);
+
+  EXPECT_FALSE(normalize_sql("INSERT INTO t VALUES (1);"));
+  EXPECT_TRUE(normalize_sql(" with q AS (SELECT 1) SELECT * FROM q;"));
+}
+
+TEST(PlanTemplate, VerbatimLiterals) {
+  const auto check_verbatim = [](const std::string& sql) {
+    const auto normalized = normalize_sql(sql);
+    ASSERT_TRUE(normalized);
+    EXPECT_TRUE(normalized->literals.empty()) << sql;
+    EXPECT_EQ(normalized->exact_key, normalized->template_key) << sql;
+  };
+  check_verbatim("SELECT x FROM t LIMIT 10 OFFSET 5;");
+  check_verbatim("SELECT x FROM t WHERE d > DATE '2020-01-01';");
+  check_verbatim("SELECT x FROM t WHERE d > TIMESTAMP '2020-01-01 00:00:00';");
+  check_verbatim("SELECT x FROM t WHERE s = '';");
+  check_verbatim("SELECT x FROM t WHERE y > 1e10 AND z > 12345678901;");
+  check_verbatim("SELECT \"col 1\", `col 2` FROM t;");
+  check_verbatim("SELECT x /* hint */ FROM t1;");
+}
+
+TEST(PlanTemplate, Instantiate) {
+  const auto a = normalize_sql("SELECT x FROM t WHERE s = 'it''s' AND y > 1.50;");
+  const auto b = normalize_sql("SELECT x FROM t WHERE s = 'a/~b' AND y > 9.99;");
+  ASSERT_TRUE(a && b);
+  ASSERT_EQ(a->template_key, b->template_key);
+  EXPECT_EQ(a->literals[0].string_value, "it's");
+
+  const auto plan_a = make_plan("it's", 150, 2);
+  const auto nodes = find_literal_nodes(plan_a, *a);
+  ASSERT_TRUE(nodes);
+  EXPECT_EQ(nodes->size(), size_t(2));
+  EXPECT_EQ(instantiate_plan(plan_a, *nodes, *b), make_plan("a/~b", 999, 2));
+
+  // not every literal reaches the plan
+  EXPECT_FALSE(find_literal_nodes(make_plan("it's", 151, 2), *a));
+  // the same literal twice cannot be told apart
+  const auto e =
+      normalize_sql("SELECT x FROM t WHERE s = 'ab' AND z = 'ab' AND y > 1.50;");
+  ASSERT_TRUE(e);
+  EXPECT_FALSE(find_literal_nodes(make_plan("ab", 150, 2), *e));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Tests/DBHandlerTestHelpers.h"
+#include "Tests/TestHelpers.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+TQueryParam int_param(const int64_t value) {
+  TQueryParam param;
+  param.type = TDatumType::BIGINT;
+  param.value.val.int_val = value;
+  return param;
+}
+
+TQueryParam str_param(const std::string& value) {
+  TQueryParam param;
+  param.type = TDatumType::STR;
+  param.value.val.str_val = value;
+  return param;
+}
+
+}  // namespace
+
+class PreparedStatementTest : public DBHandlerTestFixture {
+ protected:
+  void SetUp() override {
+    DBHandlerTestFixture::SetUp();
+    sql("DROP TABLE IF EXISTS prepared_test");
+    sql("CREATE TABLE prepared_test(i INTEGER, s TEXT)");
+    for (int i = 0; i < 5; ++i) {
+      sql("INSERT INTO prepared_test VALUES (" + std::to_string(i) + ", 's" +
+          std::to_string(i) + "')");
+    }
+  }
+
+  void TearDown() override {
+    sql("DROP TABLE IF EXISTS prepared_test");
+    DBHandlerTestFixture::TearDown();
+  }
+};
+
+TEST_F(PreparedStatementTest, ExecuteWithParams) {
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  TPreparedStatement statement;
+  handler->prepare_statement(
+      statement,
+      session,
+      "SELECT i, s FROM prepared_test WHERE i >= ? AND s <> ? ORDER BY i;");
+  EXPECT_EQ(statement.param_count, 2);
+
+  TQueryResult result;
+  handler->execute_prepared(result,
+                            session,
+                            statement.statement_id,
+                            {int_param(2), str_param("s3")},
+                            true,
+                            "",
+                            -1,
+                            -1);
+  assertResultSetEqual({{i(2), "s2"}, {i(4), "s4"}}, result);
+
+  result = TQueryResult();
+  handler->execute_prepared(result,
+                            session,
+                            statement.statement_id,
+                            {int_param(-1), str_param("'s0' OR 1 = 1")},
+                            false,
+                            "",
+                            -1,
+                            -1);
+  assertResultSetEqual(
+      {{i(0), "s0"}, {i(1), "s1"}, {i(2), "s2"}, {i(3), "s3"}, {i(4), "s4"}}, result);
+
+  // the number of parameters must match the placeholders
+  EXPECT_THROW(handler->execute_prepared(result,
+                                         session,
+                                         statement.statement_id,
+                                         {int_param(2)},
+                                         true,
+                                         "",
+                                         -1,
+                                         -1),
+               TOmniSciException);
+}
+
+TEST_F(PreparedStatementTest, PlaceholdersInLiterals) {
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  TPreparedStatement statement;
+  handler->prepare_statement(
+      statement,
+      session,
+      "SELECT COUNT(*) FROM prepared_test WHERE s <> '?' -- ?\n AND i < ?;");
+  EXPECT_EQ(statement.param_count, 1);
+
+  TQueryResult result;
+  handler->execute_prepared(
+      result, session, statement.statement_id, {int_param(3)}, true, "", -1, -1);
+  assertResultSetEqual({{i(3)}}, result);
+}
+
+TEST_F(PreparedStatementTest, Close) {
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  TPreparedStatement statement;
+  handler->prepare_statement(
+      statement, session, "SELECT COUNT(*) FROM prepared_test WHERE i = ?;");
+  handler->close_prepared(session, statement.statement_id);
+  TQueryResult result;
+  EXPECT_THROW(
+      handler->execute_prepared(
+          result, session, statement.statement_id, {int_param(1)}, true, "", -1, -1),
+      TOmniSciException);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Tests/DBHandlerTestHelpers.h"
+#include "Tests/TestHelpers.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+class QueryCursorTest : public DBHandlerTestFixture {
+ protected:
+  void SetUp() override {
+    DBHandlerTestFixture::SetUp();
+    sql("DROP TABLE IF EXISTS cursor_test");
+    sql("CREATE TABLE cursor_test(i INTEGER, s TEXT)");
+    for (int i = 0; i < 5; ++i) {
+      sql("INSERT INTO cursor_test VALUES (" + std::to_string(i) + ", 's" +
+          std::to_string(i) + "')");
+    }
+  }
+
+  void TearDown() override {
+    sql("DROP TABLE IF EXISTS cursor_test");
+    DBHandlerTestFixture::TearDown();
+  }
+};
+
+TEST_F(QueryCursorTest, FetchPages) {
+  if (isDistributedMode()) {
+    LOG(ERROR) << "Test not supported in distributed mode.";
+    return;
+  }
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  for (const bool column_format : {true, false}) {
+    TQueryResult result;
+    handler->sql_execute_cursor(
+        result, session, "SELECT i, s FROM cursor_test ORDER BY i;", column_format, "", 2);
+    assertResultSetEqual({{i(0), "s0"}, {i(1), "s1"}}, result);
+    ASSERT_TRUE(result.__isset.cursor_id);
+    const auto cursor_id = result.cursor_id;
+
+    result = TQueryResult();
+    handler->fetch_cursor(result, session, cursor_id, 2);
+    assertResultSetEqual({{i(2), "s2"}, {i(3), "s3"}}, result);
+    ASSERT_TRUE(result.__isset.cursor_id);
+    EXPECT_EQ(result.cursor_id, cursor_id);
+
+    // the last page closes the cursor
+    result = TQueryResult();
+    handler->fetch_cursor(result, session, cursor_id, 2);
+    assertResultSetEqual({{i(4), "s4"}}, result);
+    EXPECT_FALSE(result.__isset.cursor_id);
+    EXPECT_THROW(handler->fetch_cursor(result, session, cursor_id, 2),
+                 TOmniSciException);
+  }
+}
+
+TEST_F(QueryCursorTest, AllRowsFirst) {
+  if (isDistributedMode()) {
+    LOG(ERROR) << "Test not supported in distributed mode.";
+    return;
+  }
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  TQueryResult result;
+  handler->sql_execute_cursor(
+      result, session, "SELECT COUNT(*) FROM cursor_test;", true, "", 10);
+  assertResultSetEqual({{i(5)}}, result);
+  EXPECT_FALSE(result.__isset.cursor_id);
+}
+
+TEST_F(QueryCursorTest, Close) {
+  if (isDistributedMode()) {
+    LOG(ERROR) << "Test not supported in distributed mode.";
+    return;
+  }
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  TQueryResult result;
+  handler->sql_execute_cursor(result, session, "SELECT i FROM cursor_test;", true, "", 1);
+  ASSERT_TRUE(result.__isset.cursor_id);
+  handler->close_cursor(session, result.cursor_id);
+  EXPECT_THROW(handler->fetch_cursor(result, session, result.cursor_id, 1),
+               TOmniSciException);
+}
+
+TEST_F(QueryCursorTest, WriteQuery) {
+  auto* handler = getDbHandlerAndSessionId().first;
+  auto& session = getDbHandlerAndSessionId().second;
+  TQueryResult result;
+  EXPECT_THROW(handler->sql_execute_cursor(
+                   result, session, "DELETE FROM cursor_test WHERE i = 0;", true, "", 1),
+               TOmniSciException);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/QueryDispatchQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <string>
+#include <vector>
+
+using Priority = QueryDispatchQueue::Priority;
+
+namespace {
+
+// Occupies the only worker of a single-worker queue until the returned promise is set,
+// so that subsequently submitted tasks accumulate in the queue.
+std::promise<void> block_worker(QueryDispatchQueue& queue) {
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::promise<void> started;
+  auto started_future = started.get_future();
+  auto blocker = std::make_shared<QueryDispatchQueue::Task>(
+      [released, &started](const size_t) {
+        started.set_value();
+        released.wait();
+      });
+  queue.submit(blocker, /*is_update_delete=*/false, Priority::System);
+  started_future.wait();
+  return release;
+}
+
+class ExecutionOrder {
+ public:
+  std::shared_ptr<QueryDispatchQueue::Task> makeTask(const std::string& name) {
+    auto task = std::make_shared<QueryDispatchQueue::Task>([this, name](const size_t) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      order_.push_back(name);
+    });
+    futures_.push_back(task->get_future());
+    return task;
+  }
+
+  std::vector<std::string> wait() {
+    for (auto& future : futures_) {
+      future.get();
+    }
+    return order_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> order_;
+  std::vector<std::future<void>> futures_;
+};
+
+}  // namespace
+
+TEST(QueryDispatchQueue, PriorityClasses) {
+  QueryDispatchQueue queue(1, /*interactive_share=*/2);
+  ExecutionOrder order;
+  auto release = block_worker(queue);
+  queue.submit(order.makeTask("b1"), false, Priority::Batch);
+  queue.submit(order.makeTask("b2"), false, Priority::Batch);
+  queue.submit(order.makeTask("i1"), false, Priority::Interactive);
+  queue.submit(order.makeTask("i2"), false, Priority::Interactive);
+  queue.submit(order.makeTask("i3"), false, Priority::Interactive);
+  queue.submit(order.makeTask("s1"), false, Priority::System);
+  release.set_value();
+  const std::vector<std::string> expected{"s1", "i1", "i2", "b1", "i3", "b2"};
+  EXPECT_EQ(order.wait(), expected);
+}
+
+TEST(QueryDispatchQueue, FairShareWithinClass) {
+  QueryDispatchQueue queue(1);
+  ExecutionOrder order;
+  auto release = block_worker(queue);
+  queue.submit(order.makeTask("a1"), false, Priority::Interactive, "alice");
+  queue.submit(order.makeTask("a2"), false, Priority::Interactive, "alice");
+  queue.submit(order.makeTask("a3"), false, Priority::Interactive, "alice");
+  queue.submit(order.makeTask("b1"), false, Priority::Interactive, "bob");
+  queue.submit(order.makeTask("b2"), false, Priority::Interactive, "bob");
+  release.set_value();
+  const std::vector<std::string> expected{"a1", "b1", "a2", "b2", "a3"};
+  EXPECT_EQ(order.wait(), expected);
+}
+
+TEST(QueryDispatchQueue, WeightedFairShare) {
+  QueryDispatchQueue queue(1);
+  ExecutionOrder order;
+  auto release = block_worker(queue);
+  for (size_t i = 1; i <= 4; i++) {
+    queue.submit(
+        order.makeTask("a" + std::to_string(i)), false, Priority::Batch, "alice", 2.0);
+  }
+  queue.submit(order.makeTask("b1"), false, Priority::Batch, "bob", 1.0);
+  queue.submit(order.makeTask("b2"), false, Priority::Batch, "bob", 1.0);
+  release.set_value();
+  const std::vector<std::string> expected{"a1", "b1", "a2", "a3", "b2", "a4"};
+  EXPECT_EQ(order.wait(), expected);
+}
+
+TEST(QueryDispatchQueue, QueueStats) {
+  QueryDispatchQueue queue(1);
+  ExecutionOrder order;
+  auto release = block_worker(queue);
+  queue.submit(order.makeTask("i1"), false, Priority::Interactive);
+  queue.submit(order.makeTask("b1"), false, Priority::Batch);
+  queue.submit(order.makeTask("b2"), false, Priority::Batch);
+
+  auto stats = queue.getQueueStats();
+  ASSERT_EQ(stats.size(), QueryDispatchQueue::num_priority_classes);
+  EXPECT_EQ(stats[static_cast<size_t>(Priority::System)].dispatched_count, size_t(1));
+  EXPECT_EQ(stats[static_cast<size_t>(Priority::Interactive)].queue_depth, size_t(1));
+  EXPECT_EQ(stats[static_cast<size_t>(Priority::Batch)].queue_depth, size_t(2));
+
+  release.set_value();
+  order.wait();
+  stats = queue.getQueueStats();
+  for (const auto& class_stats : stats) {
+    EXPECT_EQ(class_stats.queue_depth, size_t(0));
+  }
+  EXPECT_EQ(stats[static_cast<size_t>(Priority::Batch)].dispatched_count, size_t(2));
+  EXPECT_GE(stats[static_cast<size_t>(Priority::Batch)].max_wait_ms,
+            stats[static_cast<size_t>(Priority::Batch)].avg_wait_ms);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "ThriftHandler/QueryHistory.h"
+
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+namespace {
+
+QueryHistoryEntry make_entry(const std::string& query_str) {
+  QueryHistoryEntry entry;
+  entry.submitted = 1600000000;
+  entry.db_name = "omnisci";
+  entry.user_name = "admin";
+  entry.query_str = query_str;
+  entry.resource_usage.plan_hash = 42;
+  entry.resource_usage.num_steps = 2;
+  entry.resource_usage.ran_on_gpu = true;
+  entry.resource_usage.compilation_time_ms = 5;
+  entry.resource_usage.reduction_time_ms = 1;
+  entry.resource_usage.cpu_bytes_scanned = 1000;
+  entry.resource_usage.gpu_bytes_scanned = 2000;
+  entry.resource_usage.peak_cpu_memory_bytes = 3000;
+  entry.resource_usage.peak_gpu_memory_bytes = 4000;
+  entry.resource_usage.peak_host_memory_bytes = 5000;
+  entry.execution_time_ms = 10;
+  entry.total_time_ms = 20;
+  return entry;
+}
+
+class QueryHistoryTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    g_query_history_size = 3;
+    QueryHistory::clear();
+    file_path_ = (boost::filesystem::temp_directory_path() /
+                  boost::filesystem::unique_path("query_history_%%%%-%%%%"))
+                     .string();
+  }
+
+  void TearDown() override {
+    QueryHistory::clear();
+    g_query_history_size = 0;
+    boost::filesystem::remove(file_path_);
+  }
+
+  std::string file_path_;
+};
+
+}  // namespace
+
+TEST_F(QueryHistoryTest, KeepsMostRecent) {
+  for (const auto& query_str : {"q1", "q2", "q3", "q4", "q5"}) {
+    QueryHistory::add(make_entry(query_str));
+  }
+  const auto entries = QueryHistory::getEntries();
+  ASSERT_EQ(size_t(3), entries.size());
+  EXPECT_EQ("q3", entries[0].query_str);
+  EXPECT_EQ("q4", entries[1].query_str);
+  EXPECT_EQ("q5", entries[2].query_str);
+}
+
+TEST_F(QueryHistoryTest, DisabledKeepsNothing) {
+  g_query_history_size = 0;
+  QueryHistory::add(make_entry("q1"));
+  EXPECT_TRUE(QueryHistory::getEntries().empty());
+}
+
+TEST_F(QueryHistoryTest, PersistAndLoad) {
+  auto failed = make_entry("q2");
+  failed.error = "Exception: \"t\" not found";
+  QueryHistory::add(make_entry("q1"));
+  QueryHistory::add(failed);
+  QueryHistory::persist(file_path_);
+  QueryHistory::clear();
+  QueryHistory::add(make_entry("q3"));
+  QueryHistory::add(make_entry("q4"));
+
+  // the loaded entries come first and the oldest ones are dropped
+  QueryHistory::load(file_path_);
+  const auto entries = QueryHistory::getEntries();
+  ASSERT_EQ(size_t(3), entries.size());
+  EXPECT_EQ("q2", entries[0].query_str);
+  EXPECT_EQ("q3", entries[1].query_str);
+  EXPECT_EQ("q4", entries[2].query_str);
+
+  const auto& loaded = entries[0];
+  const auto expected = make_entry("q2");
+  EXPECT_EQ(expected.submitted, loaded.submitted);
+  EXPECT_EQ(expected.db_name, loaded.db_name);
+  EXPECT_EQ(expected.user_name, loaded.user_name);
+  EXPECT_EQ(failed.error, loaded.error);
+  EXPECT_EQ(expected.execution_time_ms, loaded.execution_time_ms);
+  EXPECT_EQ(expected.total_time_ms, loaded.total_time_ms);
+  const auto& usage = loaded.resource_usage;
+  EXPECT_EQ(expected.resource_usage.plan_hash, usage.plan_hash);
+  EXPECT_EQ(expected.resource_usage.num_steps, usage.num_steps);
+  EXPECT_TRUE(usage.ran_on_gpu);
+  EXPECT_EQ(expected.resource_usage.compilation_time_ms, usage.compilation_time_ms);
+  EXPECT_EQ(expected.resource_usage.reduction_time_ms, usage.reduction_time_ms);
+  EXPECT_EQ(expected.resource_usage.cpu_bytes_scanned, usage.cpu_bytes_scanned);
+  EXPECT_EQ(expected.resource_usage.gpu_bytes_scanned, usage.gpu_bytes_scanned);
+  EXPECT_EQ(expected.resource_usage.peak_cpu_memory_bytes, usage.peak_cpu_memory_bytes);
+  EXPECT_EQ(expected.resource_usage.peak_gpu_memory_bytes, usage.peak_gpu_memory_bytes);
+  EXPECT_EQ(expected.resource_usage.peak_host_memory_bytes, usage.peak_host_memory_bytes);
+}
+
+TEST_F(QueryHistoryTest, LoadMissingFile) {
+  QueryHistory::add(make_entry("q1"));
+  QueryHistory::load(file_path_);
+  EXPECT_EQ(size_t(1), QueryHistory::getEntries().size());
+}
+
+TEST(ResourceUsage, Accumulate) {
+  query_state::ResourceUsage total;
+  query_state::ResourceUsage step;
+  step.plan_hash = 7;
+  step.num_steps = 1;
+  step.compilation_time_ms = 3;
+  step.cpu_bytes_scanned = 100;
+  step.peak_cpu_memory_bytes = 500;
+  step.peak_host_memory_bytes = 300;
+  total += step;
+  step.plan_hash = 0;
+  step.ran_on_gpu = true;
+  step.peak_cpu_memory_bytes = 200;
+  step.peak_gpu_memory_bytes = 800;
+  total += step;
+  EXPECT_EQ(size_t(7), total.plan_hash);
+  EXPECT_EQ(size_t(2), total.num_steps);
+  EXPECT_TRUE(total.ran_on_gpu);
+  EXPECT_EQ(6, total.compilation_time_ms);
+  EXPECT_EQ(size_t(200), total.cpu_bytes_scanned);
+  EXPECT_EQ(size_t(500), total.peak_cpu_memory_bytes);
+  EXPECT_EQ(size_t(800), total.peak_gpu_memory_bytes);
+  EXPECT_EQ(size_t(300), total.peak_host_memory_bytes);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
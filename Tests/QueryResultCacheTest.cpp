@@ -0,0 +1,118 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Shared/scope.h"
+#include "Tests/DBHandlerTestHelpers.h"
+#include "Tests/TestHelpers.h"
+#include "ThriftHandler/QueryResultCache.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+TRowSet make_row_set(const int64_t value) {
+  TColumn column;
+  column.nulls = {false};
+  column.data.int_col = {value};
+  TRowSet row_set;
+  row_set.is_columnar = true;
+  row_set.columns = {column};
+  return row_set;
+}
+
+}  // namespace
+
+class QueryResultCacheTest : public DBHandlerTestFixture {
+ protected:
+  void SetUp() override {
+    DBHandlerTestFixture::SetUp();
+    saved_max_bytes_ = g_query_result_cache_max_bytes;
+    g_query_result_cache_max_bytes = 1 << 20;
+    QueryResultCache::instance().clear();
+    sql("DROP TABLE IF EXISTS result_cache_test");
+    sql("CREATE TABLE result_cache_test(i INTEGER)");
+  }
+
+  void TearDown() override {
+    sql("DROP TABLE IF EXISTS result_cache_test");
+    QueryResultCache::instance().clear();
+    g_query_result_cache_max_bytes = saved_max_bytes_;
+    DBHandlerTestFixture::TearDown();
+  }
+
+ private:
+  size_t saved_max_bytes_;
+};
+
+TEST_F(QueryResultCacheTest, PutAndGet) {
+  auto& cache = QueryResultCache::instance();
+  TRowSet row_set;
+  EXPECT_FALSE(cache.get("key", row_set));
+  cache.put("key", make_row_set(42), cache.getGeneration());
+  ASSERT_TRUE(cache.get("key", row_set));
+  ASSERT_EQ(row_set.columns.size(), size_t(1));
+  EXPECT_EQ(row_set.columns.front().data.int_col, std::vector<int64_t>{42});
+}
+
+TEST_F(QueryResultCacheTest, StaleGeneration) {
+  auto& cache = QueryResultCache::instance();
+  const auto generation = cache.getGeneration();
+  cache.clear();
+  // the row set was computed before the cache was cleared
+  cache.put("key", make_row_set(42), generation);
+  TRowSet row_set;
+  EXPECT_FALSE(cache.get("key", row_set));
+}
+
+TEST_F(QueryResultCacheTest, EvictLeastRecentlyUsed) {
+  auto& cache = QueryResultCache::instance();
+  g_query_result_cache_max_bytes = 1024;
+  for (int64_t i = 0; i < 64; ++i) {
+    cache.put(std::to_string(i), make_row_set(i), cache.getGeneration());
+  }
+  TRowSet row_set;
+  EXPECT_FALSE(cache.get("0", row_set));
+  EXPECT_TRUE(cache.get("63", row_set));
+}
+
+TEST_F(QueryResultCacheTest, WritesInvalidate) {
+  sql("INSERT INTO result_cache_test VALUES (1)");
+  sqlAndCompareResult("SELECT COUNT(*), SUM(i) FROM result_cache_test;", {{i(1), i(1)}});
+  sqlAndCompareResult("SELECT COUNT(*), SUM(i) FROM result_cache_test;", {{i(1), i(1)}});
+  sql("INSERT INTO result_cache_test VALUES (2)");
+  sqlAndCompareResult("SELECT COUNT(*), SUM(i) FROM result_cache_test;", {{i(2), i(3)}});
+  sql("TRUNCATE TABLE result_cache_test");
+  sql("INSERT INTO result_cache_test VALUES (5)");
+  sqlAndCompareResult("SELECT COUNT(*), SUM(i) FROM result_cache_test;", {{i(1), i(5)}});
+  sql("UPDATE result_cache_test SET i = 7");
+  sqlAndCompareResult("SELECT COUNT(*), SUM(i) FROM result_cache_test;", {{i(1), i(7)}});
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "QueryEngine/ResultSetSpool.h"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+TEST(ResultSetSpool, ReadBack) {
+  std::vector<int64_t> values(100000);
+  std::iota(values.begin(), values.end(), 0);
+  const auto num_bytes = values.size() * sizeof(int64_t);
+  const auto spooled_bytes = result_set::SpooledBuffer::getSpooledBytes();
+  {
+    result_set::SpooledBuffer spooled(reinterpret_cast<const int8_t*>(values.data()),
+                                      num_bytes);
+    EXPECT_EQ(num_bytes, spooled.size());
+    EXPECT_EQ(spooled_bytes + num_bytes, result_set::SpooledBuffer::getSpooledBytes());
+    const auto spooled_values = reinterpret_cast<int64_t*>(spooled.data());
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), spooled_values));
+    // copy-on-write, the writes of the sorts and of the entry count updates stay private
+    spooled_values[0] = -1;
+    EXPECT_EQ(-1, spooled_values[0]);
+  }
+  EXPECT_EQ(spooled_bytes, result_set::SpooledBuffer::getSpooledBytes());
+}
+
+TEST(ResultSetSpool, BadPath) {
+  const auto spool_path = g_result_spool_path;
+  g_result_spool_path = "/proc/no_such_dir";
+  int64_t value{1};
+  EXPECT_THROW(
+      result_set::SpooledBuffer(reinterpret_cast<const int8_t*>(&value), sizeof(value)),
+      std::runtime_error);
+  g_result_spool_path = spool_path;
+}
+
+TEST(ResultSetSpool, ReleaseOutputBuffer) {
+  for (const bool pooled : {false, true}) {
+    const auto enable_pool = g_enable_output_buffer_pool;
+    g_enable_output_buffer_pool = pooled;
+    RowSetMemoryOwner owner(/*arena_block_size=*/1 << 20);
+    const size_t num_bytes{1 << 20};
+    auto ptr = owner.allocateOutputBuffer(num_bytes);
+    auto arena_ptr = owner.allocate(64);
+    EXPECT_TRUE(owner.hasOutputBuffer(ptr));
+    EXPECT_FALSE(owner.hasOutputBuffer(arena_ptr));
+    EXPECT_EQ(num_bytes + 64, owner.getAllocatedBytes());
+
+    EXPECT_FALSE(owner.releaseOutputBuffer(arena_ptr));
+    EXPECT_TRUE(owner.releaseOutputBuffer(ptr));
+    EXPECT_FALSE(owner.hasOutputBuffer(ptr));
+    EXPECT_EQ(size_t(64), owner.getAllocatedBytes());
+    g_enable_output_buffer_pool = enable_pool;
+  }
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
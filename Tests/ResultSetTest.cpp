@@ -26,6 +26,7 @@
 #include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ResultSet.h"
+#include "QueryEngine/ResultSetBufferCompression.h"
 #include "QueryEngine/ResultSetReductionJIT.h"
 #include "QueryEngine/RuntimeFunctions.h"
 #include "StringDictionary/StringDictionary.h"
@@ -1560,6 +1561,53 @@ TEST(Iterate, BaselineHashColumnar) {
   test_iterate(target_infos, query_mem_desc);
 }
 
+namespace {
+
+void test_compress_buffer(const std::vector<TargetInfo>& target_infos,
+                          const QueryMemoryDescriptor& query_mem_desc) {
+  const auto buffer_size = query_mem_desc.getBufferSizeBytes(ExecutorDeviceType::CPU);
+  std::vector<int8_t> buffer(buffer_size, 0);
+  EvenNumberGenerator generator;
+  fill_storage_buffer(buffer.data(), target_infos, query_mem_desc, generator, 2);
+  const auto fields = result_set::compress_buffer(buffer.data(), query_mem_desc);
+  size_t compressed_size{0};
+  for (const auto& field : fields) {
+    compressed_size += field.data.size();
+  }
+  ASSERT_LT(compressed_size, buffer_size);
+  std::vector<int8_t> decompressed_buffer(buffer_size, 0);
+  result_set::decompress_buffer(fields, query_mem_desc, decompressed_buffer.data());
+  ASSERT_EQ(buffer, decompressed_buffer);
+}
+
+}  // namespace
+
+TEST(CompressBuffer, PerfectHashOneCol) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  test_compress_buffer(target_infos, query_mem_desc);
+}
+
+TEST(CompressBuffer, PerfectHashOneColColumnar32) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 4, 0, 99);
+  query_mem_desc.setOutputColumnar(true);
+  test_compress_buffer(target_infos, query_mem_desc);
+}
+
+TEST(CompressBuffer, BaselineHash) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  test_compress_buffer(target_infos, query_mem_desc);
+}
+
+TEST(CompressBuffer, BaselineHashColumnar) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setOutputColumnar(true);
+  test_compress_buffer(target_infos, query_mem_desc);
+}
+
 TEST(Reduce, PerfectHashOneCol) {
   const auto target_infos = generate_test_target_infos();
   const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
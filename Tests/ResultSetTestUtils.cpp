@@ -457,6 +457,14 @@ void fill_storage_buffer(int8_t* buff,
       }
       break;
     }
+    case QueryDescriptionType::Projection: {
+      // a row-wise projection entry is a key followed by the slots, like a perfect hash
+      // one, and is empty if the key is
+      CHECK(!query_mem_desc.didOutputColumnar());
+      fill_storage_buffer_perfect_hash_rowwise(
+          buff, target_infos, query_mem_desc, generator, step);
+      break;
+    }
     default:
       CHECK(false);
   }
@@ -604,6 +612,21 @@ QueryMemoryDescriptor baseline_hash_two_col_desc(
   return query_mem_desc;
 }
 
+QueryMemoryDescriptor projection_desc(const std::vector<TargetInfo>& target_infos,
+                                      const int8_t num_bytes,
+                                      const size_t entry_count) {
+  QueryMemoryDescriptor query_mem_desc(
+      QueryDescriptionType::Projection, 0, 0, false, {8});
+  for (const auto& target_info : target_infos) {
+    CHECK(!target_info.is_agg);
+    const auto slot_bytes =
+        std::max(num_bytes, static_cast<int8_t>(target_info.sql_type.get_size()));
+    query_mem_desc.addColSlotInfo({std::make_tuple(slot_bytes, slot_bytes)});
+  }
+  query_mem_desc.setEntryCount(entry_count);
+  return query_mem_desc;
+}
+
 void fill_one_entry_baseline(int64_t* value_slots,
                              const int64_t v,
                              const std::vector<TargetInfo>& target_infos,
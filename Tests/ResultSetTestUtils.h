@@ -166,6 +166,10 @@ QueryMemoryDescriptor baseline_hash_two_col_desc(
     const std::vector<TargetInfo>& target_infos,
     const int8_t num_bytes);
 
+QueryMemoryDescriptor projection_desc(const std::vector<TargetInfo>& target_infos,
+                                      const int8_t num_bytes,
+                                      const size_t entry_count);
+
 size_t get_slot_count(const std::vector<TargetInfo>& target_infos);
 
 std::unordered_map<size_t, size_t> get_slot_to_target_mapping(
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/RoaringBitmap.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+
+namespace {
+
+// Values spread over [min_val, min_val + range), with duplicates.
+std::vector<int64_t> make_values(const size_t count,
+                                 const int64_t min_val,
+                                 const int64_t range,
+                                 const unsigned seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int64_t> dist(min_val, min_val + range - 1);
+  std::vector<int64_t> values(count);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(RoaringBitmap, Cardinality) {
+  // dense and sparse chunks, negative values and values across chunks
+  for (const int64_t min_val : {int64_t(0), int64_t(-100000), int64_t(1) << 40}) {
+    for (const int64_t range : {int64_t(100), int64_t(1) << 16, int64_t(1) << 34}) {
+      const auto values = make_values(200000, min_val, range, 1);
+      RoaringBitmap bitmap;
+      for (const auto value : values) {
+        bitmap.add(value);
+      }
+      const std::set<int64_t> expected(values.begin(), values.end());
+      EXPECT_EQ(bitmap.cardinality(), expected.size())
+          << "min " << min_val << ", range " << range;
+    }
+  }
+  RoaringBitmap empty;
+  EXPECT_EQ(empty.cardinality(), size_t(0));
+}
+
+TEST(RoaringBitmap, Unite) {
+  // array and bitmap containers, united in every combination
+  for (const size_t count : {10, 5000, 100000}) {
+    std::set<int64_t> expected;
+    std::vector<RoaringBitmap> bitmaps(4);
+    for (size_t i = 0; i < bitmaps.size(); ++i) {
+      const auto values = make_values((i + 1) * count, -1000, 1 << 18, i);
+      for (const auto value : values) {
+        bitmaps[i].add(value);
+      }
+      expected.insert(values.begin(), values.end());
+    }
+    RoaringBitmap united;
+    for (const auto& bitmap : bitmaps) {
+      united.unite(bitmap);
+      united.unite(united);
+    }
+    EXPECT_EQ(united.cardinality(), expected.size()) << count << " values";
+  }
+}
+
+TEST(RoaringBitmap, Size) {
+  RoaringBitmap bitmap;
+  for (int64_t value = 0; value < 1000; ++value) {
+    bitmap.add(value * 1000000);
+  }
+  // a flat bitmap over the same range would take about 125 MB
+  EXPECT_LT(bitmap.getBytes(), size_t(256 * 1000));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
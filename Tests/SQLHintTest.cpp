@@ -77,6 +77,51 @@ TEST(CPU_MODE, ForceToCPUMode) {
   QR::get()->runDDLStatement(drop_table_ddl);
 }
 
+TEST(QueryHint, ExecutionHints) {
+  const auto create_table_ddl = "CREATE TABLE SQL_HINT_DUMMY(key int)";
+  const auto drop_table_ddl = "DROP TABLE IF EXISTS SQL_HINT_DUMMY";
+  QR::get()->runDDLStatement(drop_table_ddl);
+  QR::get()->runDDLStatement(create_table_ddl);
+  QR::get()->runSQL("INSERT INTO SQL_HINT_DUMMY VALUES (1);", ExecutorDeviceType::CPU);
+  QR::get()->runSQL("INSERT INTO SQL_HINT_DUMMY VALUES (2);", ExecutorDeviceType::CPU);
+
+  auto query_hints = QR::get()->getParsedQueryHintofQuery(
+      "SELECT /*+ loop_join, columnar_output, max_kernel_parallelism(2), "
+      "dynamic_watchdog(0), gpu_input_mem_limit(0.5), disable_lazy_fetch */ * FROM "
+      "SQL_HINT_DUMMY");
+  EXPECT_TRUE(query_hints.loop_join);
+  EXPECT_FALSE(query_hints.hash_join);
+  ASSERT_TRUE(query_hints.columnar_output);
+  EXPECT_TRUE(*query_hints.columnar_output);
+  EXPECT_EQ(query_hints.max_kernel_parallelism, size_t(2));
+  ASSERT_TRUE(query_hints.dynamic_watchdog_time_limit);
+  EXPECT_EQ(*query_hints.dynamic_watchdog_time_limit, 0u);
+  ASSERT_TRUE(query_hints.gpu_input_mem_limit);
+  EXPECT_EQ(*query_hints.gpu_input_mem_limit, 0.5);
+  EXPECT_TRUE(query_hints.disable_lazy_fetch);
+
+  // invalid options are ignored
+  query_hints = QR::get()->getParsedQueryHintofQuery(
+      "SELECT /*+ max_kernel_parallelism(-1), gpu_input_mem_limit(2) */ * FROM "
+      "SQL_HINT_DUMMY");
+  EXPECT_EQ(query_hints.max_kernel_parallelism, size_t(0));
+  EXPECT_FALSE(query_hints.gpu_input_mem_limit);
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const auto hints : {"loop_join", "hash_join", "max_kernel_parallelism(1)"}) {
+      const auto rows = run_query("SELECT /*+ " + std::string(hints) +
+                                      " */ COUNT(*) FROM SQL_HINT_DUMMY a, "
+                                      "SQL_HINT_DUMMY b WHERE a.key = b.key;",
+                                  dt);
+      const auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(crt_row.size(), size_t(1));
+      EXPECT_EQ(TestHelpers::v<int64_t>(crt_row[0]), 2);
+    }
+  }
+  QR::get()->runDDLStatement(drop_table_ddl);
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
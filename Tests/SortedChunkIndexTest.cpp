@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "DataMgr/SortedChunkIndex.h"
+#include "Shared/sqltypes.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+
+template <class T>
+void check_row_ranges(const std::vector<T>& values, const SQLTypeInfo& ti) {
+  const SortedChunkIndex index(
+      reinterpret_cast<const int8_t*>(values.data()), values.size(), ti);
+  ASSERT_EQ(values.size(), index.rowCount());
+  for (int64_t lo = -3; lo <= 12; ++lo) {
+    for (int64_t hi = lo - 1; hi <= 12; ++hi) {
+      std::pair<size_t, size_t> expected{0, 0};
+      for (size_t row = 0; row < values.size(); ++row) {
+        const int64_t val = values[row];
+        if (val < lo || val > hi) {
+          continue;
+        }
+        expected = expected.first < expected.second
+                       ? std::make_pair(expected.first, row + 1)
+                       : std::make_pair(row, row + 1);
+      }
+      ASSERT_EQ(expected, index.getRowRange(lo, hi)) << lo << " " << hi;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(SortedChunkIndex, RowRanges) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(-2, 10);
+  std::vector<int32_t> values;
+  for (size_t i = 0; i < 200; ++i) {
+    values.push_back(dist(gen));
+  }
+  check_row_ranges(values, SQLTypeInfo(kINT, false));
+  check_row_ranges(std::vector<int64_t>(values.begin(), values.end()),
+                   SQLTypeInfo(kBIGINT, false));
+  SQLTypeInfo fixed_ti(kINT, false);
+  fixed_ti.set_compression(kENCODING_FIXED);
+  fixed_ti.set_comp_param(16);
+  fixed_ti.set_size(2);
+  check_row_ranges(std::vector<int16_t>(values.begin(), values.end()), fixed_ti);
+}
+
+TEST(SortedChunkIndex, SmallDictionaryIds) {
+  SQLTypeInfo dict_ti(kTEXT, false, kENCODING_DICT);
+  dict_ti.set_comp_param(1);
+  dict_ti.set_size(1);
+  // ids past 127 are stored unsigned
+  const std::vector<uint8_t> ids{3, 200, 7, 200, 254, 3};
+  const SortedChunkIndex index(
+      reinterpret_cast<const int8_t*>(ids.data()), ids.size(), dict_ti);
+  EXPECT_EQ(std::make_pair(size_t(1), size_t(4)), index.getRowRange(200, 200));
+  EXPECT_EQ(std::make_pair(size_t(4), size_t(5)), index.getRowRange(254, 254));
+  EXPECT_EQ(std::make_pair(size_t(0), size_t(6)), index.getRowRange(3, 3));
+  EXPECT_EQ(std::make_pair(size_t(0), size_t(0)), index.getRowRange(-56, -56));
+}
+
+TEST(SortedChunkIndex, CanIndex) {
+  EXPECT_TRUE(SortedChunkIndex::canIndex(SQLTypeInfo(kSMALLINT, false)));
+  EXPECT_TRUE(SortedChunkIndex::canIndex(SQLTypeInfo(kTIMESTAMP, false)));
+  EXPECT_TRUE(SortedChunkIndex::canIndex(SQLTypeInfo(kTEXT, false, kENCODING_DICT)));
+  EXPECT_FALSE(SortedChunkIndex::canIndex(SQLTypeInfo(kTEXT, false, kENCODING_NONE)));
+  EXPECT_FALSE(SortedChunkIndex::canIndex(SQLTypeInfo(kDOUBLE, false)));
+  EXPECT_FALSE(
+      SortedChunkIndex::canIndex(SQLTypeInfo(kDATE, false, kENCODING_DATE_IN_DAYS)));
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/HyperLogLog.h"
+#include "QueryEngine/HyperLogLogRank.h"
+#include "QueryEngine/MurmurHash.h"
+#include "QueryEngine/SparseHll.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// The dense registers agg_approximate_count_distinct() fills on CPU.
+class DenseHll {
+ public:
+  DenseHll(const uint32_t bitmap_sz_bits)
+      : bitmap_sz_bits_(bitmap_sz_bits), registers_(1 << bitmap_sz_bits) {}
+
+  void update(const int64_t key) {
+    const uint64_t hash = MurmurHash64A(&key, sizeof(key), 0);
+    const uint32_t index = hash >> (64 - bitmap_sz_bits_);
+    const uint8_t rank = get_rank(hash << bitmap_sz_bits_, 64 - bitmap_sz_bits_);
+    registers_[index] = std::max(registers_[index], static_cast<int8_t>(rank));
+  }
+
+  size_t cardinality() const { return hll_size(registers_.data(), bitmap_sz_bits_); }
+
+ private:
+  const uint32_t bitmap_sz_bits_;
+  std::vector<int8_t> registers_;
+};
+
+}  // namespace
+
+TEST(SparseHll, SameEstimateAsDense) {
+  for (const uint32_t bitmap_sz_bits : {4, 11, 14}) {
+    for (const int64_t count : {0, 1, 10, 100, 500, 1000, 100000}) {
+      SparseHll sparse(bitmap_sz_bits);
+      DenseHll dense(bitmap_sz_bits);
+      for (int64_t key = 0; key < count; ++key) {
+        sparse.update(key);
+        dense.update(key);
+      }
+      EXPECT_NEAR(sparse.cardinality(), dense.cardinality(), 1)
+          << bitmap_sz_bits << " bits, " << count << " keys";
+    }
+  }
+}
+
+TEST(SparseHll, SwitchesToDense) {
+  const uint32_t bitmap_sz_bits{11};
+  SparseHll sketch(bitmap_sz_bits);
+  for (int64_t key = 0; key < 100; ++key) {
+    sketch.update(key);
+    sketch.update(key);
+  }
+  EXPECT_TRUE(sketch.isSparse());
+  EXPECT_LT(sketch.getBytes(), size_t(1) << bitmap_sz_bits);
+  for (int64_t key = 0; key < 10000; ++key) {
+    sketch.update(key);
+  }
+  EXPECT_FALSE(sketch.isSparse());
+  EXPECT_NEAR(sketch.cardinality(), 10000, 10000 * 0.05);
+}
+
+TEST(SparseHll, Merge) {
+  const uint32_t bitmap_sz_bits{11};
+  for (const int64_t count : {10, 400, 1000, 100000}) {
+    // sparse and dense sketches, merged in every combination
+    std::vector<SparseHll> sketches(4, SparseHll(bitmap_sz_bits));
+    DenseHll dense(bitmap_sz_bits);
+    for (int64_t key = 0; key < count; ++key) {
+      sketches[key % sketches.size()].update(key);
+      dense.update(key);
+    }
+    for (int64_t key = 0; key < 10000; ++key) {
+      sketches.back().update(-key);
+      dense.update(-key);
+    }
+    SparseHll merged(bitmap_sz_bits);
+    for (const auto& sketch : sketches) {
+      merged.merge(sketch);
+      merged.merge(merged);
+    }
+    EXPECT_NEAR(merged.cardinality(), dense.cardinality(), 1) << count << " keys";
+  }
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
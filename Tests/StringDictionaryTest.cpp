@@ -16,10 +16,14 @@
 
 #include "TestHelpers.h"
 
+#include "../Shared/scope.h"
 #include "../StringDictionary/StringDictionary.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <limits>
+#include <thread>
+#include <tuple>
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -101,6 +105,152 @@ TEST(StringDictionary, RecoverMany) {
   }
 }
 
+TEST(StringDictionary, LazyLoad) {
+  ScopeGuard reset_lazy_load = [orig = g_enable_stringdict_lazy_load] {
+    g_enable_stringdict_lazy_load = orig;
+  };
+  g_enable_stringdict_lazy_load = true;
+  const int num_strings{1000};
+  {
+    StringDictionary string_dict(BASE_PATH, false, false, g_cache_string_hash);
+    for (int i = 0; i < num_strings; ++i) {
+      ASSERT_EQ(i, string_dict.getOrAdd(std::to_string(i)));
+    }
+    ASSERT_TRUE(string_dict.checkpoint());
+  }
+  // the hash table persisted by the checkpoint
+  {
+    StringDictionary string_dict(BASE_PATH, false, true, g_cache_string_hash);
+    ASSERT_EQ(static_cast<size_t>(num_strings), string_dict.storageEntryCount());
+    ASSERT_EQ(std::to_string(num_strings - 1), string_dict.getString(num_strings - 1));
+    for (int i = 0; i < num_strings; ++i) {
+      ASSERT_EQ(i, string_dict.getIdOfString(std::to_string(i)));
+    }
+    ASSERT_EQ(num_strings, string_dict.getOrAdd(std::to_string(num_strings)));
+  }
+  // the string added without a checkpoint makes the persisted table stale
+  StringDictionary string_dict(BASE_PATH, false, true, g_cache_string_hash);
+  ASSERT_EQ(static_cast<size_t>(num_strings + 1), string_dict.storageEntryCount());
+  for (int i = 0; i <= num_strings; ++i) {
+    ASSERT_EQ(i, string_dict.getOrAdd(std::to_string(i)));
+  }
+  ASSERT_EQ(num_strings + 1, string_dict.getOrAdd(std::to_string(num_strings + 1)));
+}
+
+TEST(StringDictionary, VisitStorage) {
+  StringDictionary string_dict(BASE_PATH, true, false, g_cache_string_hash);
+  const std::vector<std::string> strings{"foo", "a", "barbaz", "qux"};
+  for (size_t i = 0; i < strings.size(); ++i) {
+    ASSERT_EQ(static_cast<int32_t>(i), string_dict.getOrAdd(strings[i]));
+  }
+  // the first three strings, decoded as the GPU kernels do
+  string_dict.visitStorage(3,
+                           [&strings](const int8_t* offsets,
+                                      const size_t offsets_size,
+                                      const int8_t* payload,
+                                      const size_t payload_size) {
+                             ASSERT_EQ(3 * sizeof(uint64_t), offsets_size);
+                             ASSERT_EQ(size_t(10), payload_size);
+                             for (size_t i = 0; i < 3; ++i) {
+                               const auto off_and_size =
+                                   reinterpret_cast<const uint64_t*>(offsets)[i];
+                               ASSERT_EQ(strings[i],
+                                         std::string(reinterpret_cast<const char*>(
+                                                         payload) +
+                                                         (off_and_size & 0xffffffffffff),
+                                                     off_and_size >> 48));
+                             }
+                           });
+}
+
+TEST(StringDictionary, ConcurrentBulkAdds) {
+  StringDictionary string_dict(BASE_PATH, true, false, g_cache_string_hash);
+  const size_t num_threads{4};
+  const int shared_count{10000};
+  const int own_count{1000};
+  std::vector<std::vector<std::string>> strings(num_threads);
+  std::vector<std::vector<int32_t>> ids(num_threads);
+  for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+    // the strings of all the threads, in a different order, and their own ones
+    for (int i = 0; i < shared_count; ++i) {
+      strings[thread_idx].push_back(
+          std::to_string((i * 7919 + thread_idx * 1237) % shared_count));
+    }
+    for (int i = 0; i < own_count; ++i) {
+      strings[thread_idx].push_back(std::to_string(thread_idx) + "_" +
+                                    std::to_string(i));
+    }
+    ids[thread_idx].resize(strings[thread_idx].size());
+  }
+  std::vector<std::thread> loaders;
+  for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+    loaders.emplace_back([&string_dict, &strings, &ids, thread_idx] {
+      // in batches, a batch either finds a string or adds it
+      const size_t batch_size{1000};
+      for (size_t begin = 0; begin < strings[thread_idx].size(); begin += batch_size) {
+        const auto end = std::min(begin + batch_size, strings[thread_idx].size());
+        const std::vector<std::string> batch(strings[thread_idx].begin() + begin,
+                                             strings[thread_idx].begin() + end);
+        string_dict.getOrAddBulk(batch, &ids[thread_idx][begin]);
+      }
+    });
+  }
+  for (auto& loader : loaders) {
+    loader.join();
+  }
+  ASSERT_EQ(static_cast<size_t>(shared_count + num_threads * own_count),
+            string_dict.storageEntryCount());
+  for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+    for (size_t i = 0; i < strings[thread_idx].size(); ++i) {
+      ASSERT_EQ(strings[thread_idx][i], string_dict.getString(ids[thread_idx][i]));
+    }
+  }
+}
+
+TEST(StringDictionary, TrigramIndexLookups) {
+  std::vector<std::string> strings;
+  for (int i = 0; i < 20000; ++i) {
+    strings.push_back(std::to_string(i));
+  }
+  strings.insert(strings.end(), {"Foo123", "fOO456bar", "foo_bar", "barfoo"});
+  auto get_like_and_regexp_like = [&strings](const bool use_index) {
+    ScopeGuard reset_index = [orig = g_enable_stringdict_trigram_index] {
+      g_enable_stringdict_trigram_index = orig;
+    };
+    g_enable_stringdict_trigram_index = use_index;
+    StringDictionary string_dict(BASE_PATH, true, false, g_cache_string_hash);
+    std::vector<int32_t> ids(strings.size());
+    string_dict.getOrAddBulk(strings, ids.data());
+    const auto generation = string_dict.storageEntryCount();
+    std::vector<std::vector<int32_t>> results;
+    for (const auto& [pattern, icase, is_simple] :
+         std::vector<std::tuple<std::string, bool, bool>>{{"%12_4%", false, false},
+                                                          {"1%99", false, false},
+                                                          {"234", false, true},
+                                                          {"foo", true, true},
+                                                          {"%foo\\_bar%", false, false},
+                                                          {"%45%bar", true, false},
+                                                          {"%1%", false, false}}) {
+      results.push_back(
+          string_dict.getLike(pattern, icase, is_simple, '\\', generation));
+    }
+    for (const auto& pattern : {"1[0-9]*5", "(12)?345.*", "19+9", "a|1", "f.o.*"}) {
+      results.push_back(string_dict.getRegexpLike(pattern, '\\', generation));
+    }
+    for (auto& result : results) {
+      std::sort(result.begin(), result.end());
+    }
+    return results;
+  };
+  const auto scanned = get_like_and_regexp_like(false);
+  const auto indexed = get_like_and_regexp_like(true);
+  ASSERT_EQ(scanned.size(), indexed.size());
+  for (size_t i = 0; i < scanned.size(); ++i) {
+    ASSERT_EQ(scanned[i], indexed[i]) << "pattern " << i;
+  }
+  ASSERT_FALSE(scanned.front().empty());
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
 
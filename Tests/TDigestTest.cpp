@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/TDigest.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+std::vector<double> make_normal_values(const size_t count) {
+  std::mt19937 gen(42);
+  std::normal_distribution<double> dist(0, 1);
+  std::vector<double> values(count);
+  std::generate(values.begin(), values.end(), [&] { return dist(gen); });
+  return values;
+}
+
+double exact_quantile(std::vector<double> values, const double q) {
+  std::sort(values.begin(), values.end());
+  return values[static_cast<size_t>(q * (values.size() - 1))];
+}
+
+}  // namespace
+
+TEST(TDigest, Empty) {
+  TDigest digest(0.5);
+  EXPECT_TRUE(std::isnan(digest.quantile()));
+}
+
+TEST(TDigest, SmallInputs) {
+  TDigest one(0.5);
+  one.add(7);
+  EXPECT_EQ(one.quantile(), 7);
+
+  TDigest median(0.5);
+  for (int i = 1; i <= 5; ++i) {
+    median.add(i);
+  }
+  EXPECT_EQ(median.quantile(), 3);
+
+  TDigest min(0), max(1);
+  for (int i = 1; i <= 100; ++i) {
+    min.add(i);
+    max.add(i);
+  }
+  EXPECT_EQ(min.quantile(), 1);
+  EXPECT_EQ(max.quantile(), 100);
+}
+
+TEST(TDigest, Accuracy) {
+  const auto values = make_normal_values(1000000);
+  for (const double q : {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999}) {
+    TDigest digest(q);
+    for (const auto value : values) {
+      digest.add(value);
+    }
+    EXPECT_LE(digest.getCentroidCount(), 5 * g_approx_quantile_centroids);
+    EXPECT_NEAR(digest.quantile(), exact_quantile(values, q), 0.01) << "q = " << q;
+  }
+}
+
+TEST(TDigest, Merge) {
+  const auto values = make_normal_values(100000);
+  const size_t num_digests{8};
+  std::vector<TDigest> digests(num_digests, TDigest(0.9));
+  for (size_t i = 0; i < values.size(); ++i) {
+    digests[i % num_digests].add(values[i]);
+  }
+  TDigest merged(0.9);
+  for (const auto& digest : digests) {
+    merged.merge(digest);
+  }
+  EXPECT_NEAR(merged.quantile(), exact_quantile(values, 0.9), 0.01);
+  // merging an empty digest changes nothing
+  const auto quantile = merged.quantile();
+  merged.merge(TDigest(0.9));
+  EXPECT_EQ(merged.quantile(), quantile);
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
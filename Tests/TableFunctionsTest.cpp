@@ -28,6 +28,7 @@
 using QR = QueryRunner::QueryRunner;
 
 extern bool g_enable_table_functions;
+extern size_t g_table_function_partition_rows;
 namespace {
 
 inline void run_ddl_statement(const std::string& stmt) {
@@ -234,6 +235,39 @@ TEST_F(TableFunctions, GroupByInAndOut) {
   }
 }
 
+TEST_F(TableFunctions, PartitionedInput) {
+  auto check_result = [](const auto rows, const size_t copies) {
+    ASSERT_EQ(rows->rowCount(), size_t(5 * copies));
+    for (size_t i = 0; i < 5 * copies; i++) {
+      auto crt_row = rows->getNextRow(false, false);
+      ASSERT_NEAR(TestHelpers::v<double>(crt_row[0]), (i / copies) * 1.1, 1e-6);
+    }
+  };
+
+  const auto partition_rows_state = g_table_function_partition_rows;
+  for (const size_t partition_rows : {size_t(0), size_t(1), size_t(2)}) {
+    g_table_function_partition_rows = partition_rows;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      {
+        const auto rows = run_multiple_agg(
+            "SELECT out0 FROM TABLE(row_repeater(cursor(SELECT d FROM tf_test), 1)) "
+            "ORDER BY out0;",
+            dt);
+        check_result(rows, 1);
+      }
+      {
+        const auto rows = run_multiple_agg(
+            "SELECT out0 FROM TABLE(row_repeater(cursor(SELECT d FROM tf_test), 3)) "
+            "ORDER BY out0;",
+            dt);
+        check_result(rows, 3);
+      }
+    }
+  }
+  g_table_function_partition_rows = partition_rows_state;
+}
+
 TEST_F(TableFunctions, Unsupported) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
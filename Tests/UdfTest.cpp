@@ -20,6 +20,8 @@
 #include <boost/filesystem/operations.hpp>
 #include <csignal>
 #include <exception>
+#include <fstream>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -32,6 +34,7 @@
 #include "QueryEngine/ResultSet.h"
 #include "QueryEngine/UDFCompiler.h"
 #include "QueryRunner/QueryRunner.h"
+#include "Shared/scope.h"
 #include "TestHelpers.h"
 
 #ifndef BASE_PATH
@@ -43,6 +46,9 @@ using namespace TestHelpers;
 
 using QR = QueryRunner::QueryRunner;
 
+extern bool g_enable_cpu_vectorization;
+extern bool g_enable_udf_inlining;
+
 #define SKIP_NO_GPU()                                        \
   if (skip_tests(dt)) {                                      \
     CHECK(dt == ExecutorDeviceType::GPU);                    \
@@ -91,6 +97,10 @@ std::string get_udf_ast_filename() {
   return udf_file_name_base + ".ast";
 }
 
+std::string get_udf_key_filename() {
+  return udf_file_name_base + "_udf.key";
+}
+
 bool skip_tests(const ExecutorDeviceType device_type) {
 #ifdef HAVE_CUDA
   return device_type == ExecutorDeviceType::GPU && !QR::get()->gpusPresent();
@@ -150,6 +160,11 @@ class SQLTestEnv : public ::testing::Environment {
       boost::filesystem::remove(udf_ast_file);
     }
 
+    boost::filesystem::path udf_key_file(get_udf_key_filename());
+    if (boost::filesystem::exists(udf_key_file)) {
+      boost::filesystem::remove(udf_key_file);
+    }
+
     QR::reset();
   }
 };
@@ -190,6 +205,28 @@ TEST_F(UDFCompilerTest, CompileTest) {
   // LOG(FATAL) which stops the process and does not return
 }
 
+TEST_F(UDFCompilerTest, CompiledFilesReuse) {
+  auto read_key_file = [] {
+    std::ifstream key_file(get_udf_key_filename());
+    return std::string(std::istreambuf_iterator<char>(key_file),
+                       std::istreambuf_iterator<char>());
+  };
+
+  UdfCompiler compiler(getUdfFileName(), g_device_arch);
+  ASSERT_EQ(compiler.compileUdf(), 0);
+  const auto compilation_key = read_key_file();
+  ASSERT_FALSE(compilation_key.empty());
+  // unchanged, the compiled files are read again
+  ASSERT_EQ(compiler.compileUdf(), 0);
+  ASSERT_EQ(read_key_file(), compilation_key);
+
+  std::vector<std::string> udf_compiler_options{std::string("-D UDF_COMPILER_OPTION")};
+  UdfCompiler option_compiler(
+      getUdfFileName(), g_device_arch, std::string(""), udf_compiler_options);
+  ASSERT_EQ(option_compiler.compileUdf(), 0);
+  ASSERT_NE(read_key_file(), compilation_key);
+}
+
 TEST_F(UDFCompilerTest, CompilerOptionTest) {
   UdfCompiler compiler(getUdfFileName(), g_device_arch);
   auto compile_result = compiler.compileUdf();
@@ -526,6 +563,36 @@ TEST_F(UDFCompilerTest, UdfQuery) {
   run_ddl_statement("DROP TABLE geo_mpoly;");
 }
 
+TEST_F(UDFCompilerTest, InlinedUdfQuery) {
+  const auto enable_cpu_vectorization = g_enable_cpu_vectorization;
+  const auto enable_udf_inlining = g_enable_udf_inlining;
+  ScopeGuard reset_flags = [enable_cpu_vectorization, enable_udf_inlining] {
+    g_enable_cpu_vectorization = enable_cpu_vectorization;
+    g_enable_udf_inlining = enable_udf_inlining;
+  };
+  g_enable_cpu_vectorization = true;
+  g_enable_udf_inlining = true;
+
+  run_ddl_statement("DROP TABLE IF EXISTS udf_inline_test;");
+  run_ddl_statement("CREATE TABLE udf_inline_test (x BIGINT, y BIGINT);");
+  for (int i = 0; i < 10; i++) {
+    run_multiple_agg("INSERT INTO udf_inline_test VALUES (" + std::to_string(3 * i) +
+                         ", " + std::to_string(i) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+
+  const auto dt = ExecutorDeviceType::CPU;
+  ASSERT_EQ(90,
+            v<int64_t>(run_simple_agg(
+                "SELECT SUM(udf_range_int(x, y)) FROM udf_inline_test;", dt)));
+  ASSERT_EQ(4,
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM udf_inline_test WHERE udf_range_int(x, y) > 10;",
+                dt)));
+
+  run_ddl_statement("DROP TABLE udf_inline_test;");
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
@@ -15,6 +15,7 @@
  */
 
 #include "Shared/Intervals.h"
+#include "Shared/threadpool.h"
 #include "TestHelpers.h"
 #include "Utils/Regexp.h"
 #include "Utils/StringLike.h"
@@ -172,6 +173,41 @@ TEST(Utils, Regexp) {
   ASSERT_TRUE(regexp_like("hello [", 7, ".*\\[.*", 6, '\\'));
 }
 
+TEST(Shared, WorkStealingThreadPool) {
+  constexpr int num_tasks = 1000;
+  for (size_t num_workers : {1, 3, 16}) {
+    std::array<std::atomic<int>, num_tasks> visits;
+    std::for_each(visits.begin(), visits.end(), [](auto& v) { v = 0; });
+    threadpool::WorkStealingThreadPool<void> thread_pool(num_workers);
+    for (int i = 0; i < num_tasks; ++i) {
+      // skew the task costs so that some workers finish early and steal
+      thread_pool.spawn(
+          [&visits](const int task_idx) {
+            if (task_idx % 97 == 0) {
+              std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            ++visits[task_idx];
+          },
+          i);
+    }
+    thread_pool.join();
+    for (const auto& v : visits) {
+      EXPECT_EQ(v, 1);
+    }
+  }
+}
+
+TEST(Shared, WorkStealingThreadPoolException) {
+  threadpool::WorkStealingThreadPool<void> thread_pool(2);
+  std::atomic<int> completed{0};
+  thread_pool.spawn([] { throw std::runtime_error("kernel failed"); });
+  for (int i = 0; i < 10; ++i) {
+    thread_pool.spawn([&completed] { ++completed; });
+  }
+  EXPECT_THROW(thread_pool.join(), std::runtime_error);
+  EXPECT_EQ(completed, 10);
+}
+
 int main(int argc, char* argv[]) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
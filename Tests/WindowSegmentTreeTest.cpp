@@ -0,0 +1,112 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "QueryEngine/WindowSegmentTree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace {
+
+std::vector<int64_t> make_values(const size_t count, const unsigned seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int64_t> dist(-1000, 1000);
+  std::vector<int64_t> values;
+  for (size_t i = 0; i < count; ++i) {
+    values.push_back(dist(gen));
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(WindowSegmentTree, AllRanges) {
+  for (size_t count = 0; count <= 33; ++count) {
+    const auto values = make_values(count, count);
+    const WindowSegmentTree<int64_t, std::plus<int64_t>> sum_tree(
+        values, 0, std::plus<int64_t>());
+    const auto min_op = [](const int64_t lhs, const int64_t rhs) {
+      return std::min(lhs, rhs);
+    };
+    const WindowSegmentTree<int64_t, decltype(min_op)> min_tree(
+        values, std::numeric_limits<int64_t>::max(), min_op);
+    for (size_t begin = 0; begin <= count; ++begin) {
+      for (size_t end = begin; end <= count; ++end) {
+        int64_t sum{0};
+        int64_t min{std::numeric_limits<int64_t>::max()};
+        for (size_t i = begin; i < end; ++i) {
+          sum += values[i];
+          min = std::min(min, values[i]);
+        }
+        EXPECT_EQ(sum, sum_tree.query(begin, end));
+        EXPECT_EQ(min, min_tree.query(begin, end));
+      }
+    }
+  }
+}
+
+TEST(WindowSegmentTree, KeepsOrder) {
+  const std::vector<std::string> leaves{"a", "b", "c", "d", "e", "f", "g"};
+  const WindowSegmentTree<std::string, std::plus<std::string>> concat_tree(
+      leaves, "", std::plus<std::string>());
+  EXPECT_EQ("abcdefg", concat_tree.query(0, leaves.size()));
+  EXPECT_EQ("bcde", concat_tree.query(1, 5));
+  EXPECT_EQ("fg", concat_tree.query(5, 7));
+  EXPECT_EQ("", concat_tree.query(3, 3));
+}
+
+TEST(WindowSegmentTree, SlidingFrames) {
+  const size_t count{100000};
+  const auto values = make_values(count, 42);
+  const WindowSegmentTree<int64_t, std::plus<int64_t>> sum_tree(
+      values, 0, std::plus<int64_t>());
+  // ROWS BETWEEN 10 PRECEDING AND 5 FOLLOWING
+  int64_t running_sum{0};
+  for (size_t i = 0; i < std::min(count, size_t(6)); ++i) {
+    running_sum += values[i];
+  }
+  for (size_t k = 0; k < count; ++k) {
+    const size_t begin = k >= 10 ? k - 10 : 0;
+    const size_t end = std::min(count, k + 6);
+    ASSERT_EQ(running_sum, sum_tree.query(begin, end));
+    if (k + 6 < count) {
+      running_sum += values[k + 6];
+    }
+    if (k >= 10) {
+      running_sum -= values[k - 10];
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
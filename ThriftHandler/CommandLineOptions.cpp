@@ -21,10 +21,13 @@
 #include <iostream>
 
 #include "CommandLineOptions.h"
+#include "DataMgr/BufferMgr/BufferMgr.h"
 #include "LeafHostInfo.h"
 #include "MapDRelease.h"
 #include "QueryEngine/GroupByAndAggregate.h"
 #include "Shared/Compressor.h"
+#include "Shared/HugePages.h"
+#include "Shared/NumaUtils.h"
 #include "StringDictionary/StringDictionary.h"
 #include "Utils/DdlUtils.h"
 
@@ -36,12 +39,56 @@ bool g_enable_thrift_logs{false};
 
 extern bool g_use_table_device_offset;
 extern float g_fraction_code_cache_to_evict;
+extern size_t g_code_cache_max_bytes;
+extern bool g_enable_persistent_code_cache;
+extern std::string g_persistent_code_cache_path;
+extern bool g_enable_tiered_compilation;
+extern bool g_enable_cpu_vectorization;
+extern bool g_enable_udf_inlining;
+extern size_t g_tiered_compilation_max_input_rows;
+extern bool g_enable_expression_interpreter;
+extern size_t g_expression_interpreter_max_input_rows;
 extern bool g_cache_string_hash;
 
 extern int64_t g_large_ndv_threshold;
 extern size_t g_large_ndv_multiplier;
+extern bool g_enable_ndv_sampling;
+extern size_t g_ndv_sample_fragment_count;
 extern int64_t g_bitmap_memory_limit;
 extern bool g_enable_calcite_ddl_parser;
+extern bool g_enable_admission_control;
+extern size_t g_admission_control_timeout_ms;
+extern bool g_enable_work_stealing_kernel_dispatch;
+extern bool g_enable_gpu_kernel_streams;
+extern bool g_enable_gpu_launch_graphs;
+extern bool g_enable_cpu_multifrag_kernels;
+extern bool g_enable_streaming_reduction;
+extern bool g_enable_delete_metadata_skipping;
+extern bool g_enable_parallel_fragment_updates;
+extern bool g_enable_inplace_string_updates;
+extern bool g_enable_nonblocking_fragment_drops;
+extern bool g_enable_column_page_sizing;
+extern bool g_enable_top_k_group_pruning;
+extern bool g_enable_catalog_snapshot_reads;
+extern bool g_enable_parallel_catalog_loading;
+extern bool g_enable_serialized_rows_compression;
+extern size_t g_cpu_multifrag_kernel_min_rows;
+extern bool g_enable_shared_scans;
+extern bool g_enable_parallel_union_branches;
+extern bool g_enable_gpu_dict_payload;
+extern bool g_enable_pipelined_import;
+extern int g_metrics_port;
+extern bool g_enable_perf_counters;
+extern bool g_enable_gpu_kernel_timing;
+extern size_t g_query_history_size;
+extern size_t g_query_history_persist_interval_s;
+extern size_t g_max_query_host_memory_bytes;
+extern bool g_enable_lock_contention_profiling;
+extern bool g_enable_output_buffer_pool;
+extern size_t g_output_buffer_pool_max_idle_bytes;
+extern bool g_enable_result_spooling;
+extern size_t g_result_spool_threshold_bytes;
+extern std::string g_result_spool_path;
 
 unsigned connect_timeout{20000};
 unsigned recv_timeout{300000};
@@ -79,11 +126,23 @@ void CommandLineOptions::fillOptions() {
                           po::value<size_t>(&system_parameters.calcite_max_mem)
                               ->default_value(system_parameters.calcite_max_mem),
                           "Max memory available to calcite JVM.");
+  help_desc.add_options()(
+      "calcite-plan-cache-size",
+      po::value<size_t>(&system_parameters.calcite_plan_cache_size)
+          ->default_value(system_parameters.calcite_plan_cache_size),
+      "Number of relational algebra plans cached in front of Calcite, keyed by the "
+      "normalized query text. Set to 0 to disable the cache.");
   if (!dist_v5_) {
     help_desc.add_options()("calcite-port",
                             po::value<int>(&system_parameters.calcite_port)
                                 ->default_value(system_parameters.calcite_port),
                             "Calcite port number.");
+    help_desc.add_options()(
+        "calcite-servers",
+        po::value<size_t>(&system_parameters.calcite_servers)
+            ->default_value(system_parameters.calcite_servers),
+        "Number of Calcite servers planning queries concurrently, on consecutive ports "
+        "from calcite-port. Each server runs a JVM of calcite-max-mem.");
   }
   help_desc.add_options()("config",
                           po::value<std::string>(&system_parameters.config_file),
@@ -129,6 +188,66 @@ void CommandLineOptions::fillOptions() {
                               ->default_value(g_enable_debug_timer)
                               ->implicit_value(true),
                           "Enable debug timer logging.");
+  help_desc.add_options()(
+      "enable-perf-counters",
+      po::value<bool>(&g_enable_perf_counters)
+          ->default_value(g_enable_perf_counters)
+          ->implicit_value(true),
+      "Collect the cycles, instructions, last level cache misses and branch misses of "
+      "the debug timers and of the query kernels from the hardware performance "
+      "counters, and report them in the debug timer logs and EXPLAIN ANALYZE.");
+  help_desc.add_options()(
+      "enable-gpu-kernel-timing",
+      po::value<bool>(&g_enable_gpu_kernel_timing)
+          ->default_value(g_enable_gpu_kernel_timing)
+          ->implicit_value(true),
+      "Time the GPU kernels, the group by buffer initialization and the multi-GPU "
+      "reduction on the devices with CUDA events, and account the bytes copied to and "
+      "from the GPUs. Reported in EXPLAIN ANALYZE and the metrics.");
+  help_desc.add_options()(
+      "enable-lock-contention-profiling",
+      po::value<bool>(&g_enable_lock_contention_profiling)
+          ->default_value(g_enable_lock_contention_profiling)
+          ->implicit_value(true),
+      "Count the acquisitions of the table, catalog and string dictionary locks and "
+      "time the waits for them and, sampled, how long they are held. Reported in the "
+      "metrics and SHOW LOCK CONTENTION.");
+  help_desc.add_options()(
+      "enable-output-buffer-pool",
+      po::value<bool>(&g_enable_output_buffer_pool)
+          ->default_value(g_enable_output_buffer_pool)
+          ->implicit_value(true),
+      "Reuse the CPU output and group by buffers of finished queries instead of "
+      "allocating fresh ones.");
+  help_desc.add_options()(
+      "output-buffer-pool-max-idle-bytes",
+      po::value<size_t>(&g_output_buffer_pool_max_idle_bytes)
+          ->default_value(g_output_buffer_pool_max_idle_bytes),
+      "Bytes of unused output buffers kept for reuse, the rest is freed.");
+  help_desc.add_options()(
+      "huge-pages",
+      po::value<std::string>(&g_huge_pages)->default_value(g_huge_pages),
+      "Back the CPU buffer pool slabs and the large query arena blocks with huge pages, "
+      "for fewer TLB misses in scans and hash join probes: none, transparent (2MB "
+      "pages advised with madvise) or hugetlb (2MB or 1GB pages from the pool reserved "
+      "with vm.nr_hugepages, falling back to transparent when it is short).");
+  help_desc.add_options()(
+      "enable-result-spooling",
+      po::value<bool>(&g_enable_result_spooling)
+          ->default_value(g_enable_result_spooling)
+          ->implicit_value(true),
+      "Move the rows of the large projections kept for the clients to fetch with "
+      "fetch_cursor to scratch files, and read them back through mmap.");
+  help_desc.add_options()(
+      "result-spool-threshold-bytes",
+      po::value<size_t>(&g_result_spool_threshold_bytes)
+          ->default_value(g_result_spool_threshold_bytes),
+      "Bytes of output buffers past which a result kept for a client is spooled.");
+  help_desc.add_options()(
+      "result-spool-path",
+      po::value<std::string>(&g_result_spool_path)->default_value(g_result_spool_path),
+      "Directory of the result spool files, omnisci_result_spool in the data directory "
+      "by default.");
   help_desc.add_options()("enable-dynamic-watchdog",
                           po::value<bool>(&enable_dynamic_watchdog)
                               ->default_value(enable_dynamic_watchdog)
@@ -169,6 +288,13 @@ void CommandLineOptions::fillOptions() {
           ->implicit_value(0.5),
       "A frequency of checking the request of running query "
       "interrupt from user (0.0 (less frequent) ~ (more frequent) 1.0).");
+  help_desc.add_options()(
+      "cpu-interrupt-check-block-rows",
+      po::value<size_t>(&g_cpu_interrupt_check_block_rows)
+          ->default_value(g_cpu_interrupt_check_block_rows),
+      "Number of rows a CPU kernel scans between two checks of the running query "
+      "interrupt, rounded down to a power of two. The kernels also check it between "
+      "their fragments.");
   help_desc.add_options()("use-estimator-result-cache",
                           po::value<bool>(&use_estimator_result_cache)
                               ->default_value(use_estimator_result_cache)
@@ -217,6 +343,26 @@ void CommandLineOptions::fillOptions() {
                               ->default_value(g_from_table_reordering)
                               ->implicit_value(true),
                           "Enable automatic table reordering in FROM clause.");
+  help_desc.add_options()(
+      "join-order-dp-max-tables",
+      po::value<size_t>(&g_join_order_dp_max_tables)
+          ->default_value(g_join_order_dp_max_tables),
+      "Order inner joins of up to this many tables by their estimated cost when FROM "
+      "table reordering is enabled, 0 disables it (at most 20).");
+  help_desc.add_options()(
+      "enable-common-subplan-elimination",
+      po::value<bool>(&g_enable_common_subplan_elimination)
+          ->default_value(g_enable_common_subplan_elimination)
+          ->implicit_value(true),
+      "Execute identical subtrees of a query, e.g. common table expressions referenced "
+      "several times, only once.");
+  help_desc.add_options()(
+      "enable-device-cost-model",
+      po::value<bool>(&g_enable_device_cost_model)
+          ->default_value(g_enable_device_cost_model)
+          ->implicit_value(true),
+      "Choose CPU or GPU for each step of a query running on GPU from the estimated "
+      "transfers, work and queued work on the devices.");
   help_desc.add_options()("gpu-buffer-mem-bytes",
                           po::value<size_t>(&system_parameters.gpu_buffer_mem_bytes)
                               ->default_value(system_parameters.gpu_buffer_mem_bytes),
@@ -232,11 +378,246 @@ void CommandLineOptions::fillOptions() {
           ->default_value(g_hll_precision_bits)
           ->implicit_value(g_hll_precision_bits),
       "Number of bits used from the hash value used to specify the bucket number.");
+  help_desc.add_options()(
+      "enable-sparse-hll",
+      po::value<bool>(&g_enable_sparse_hll)
+          ->default_value(g_enable_sparse_hll)
+          ->implicit_value(true),
+      "Keep the APPROX_COUNT_DISTINCT registers of CPU group by queries sparse while few "
+      "of them are set.");
+  help_desc.add_options()(
+      "enable-roaring-count-distinct",
+      po::value<bool>(&g_enable_roaring_count_distinct)
+          ->default_value(g_enable_roaring_count_distinct)
+          ->implicit_value(true),
+      "Use roaring bitmaps for the exact COUNT(DISTINCT) of CPU queries instead of "
+      "std::set, or of flat bitmaps wider than 512K bits in group by queries.");
+  help_desc.add_options()(
+      "enable-clustered-group-by",
+      po::value<bool>(&g_enable_clustered_group_by)
+          ->default_value(g_enable_clustered_group_by)
+          ->implicit_value(true),
+      "Check the group of the previous row first in CPU baseline hash group by queries "
+      "whose first key is the column the table is sorted on.");
+  help_desc.add_options()(
+      "enable-packed-group-keys",
+      po::value<bool>(&g_enable_packed_group_keys)
+          ->default_value(g_enable_packed_group_keys)
+          ->implicit_value(true),
+      "Pack the keys of CPU multi-column baseline hash group by queries into one word "
+      "when the ranges of the columns fit, only the word is hashed and compared then.");
+  help_desc.add_options()(
+      "enable-band-joins",
+      po::value<bool>(&g_enable_band_joins)
+          ->default_value(g_enable_band_joins)
+          ->implicit_value(true),
+      "Sort the inner table of CPU inner joins on range predicates without an equijoin "
+      "qualifier, each outer row iterates only over the inner rows in its range then.");
+  help_desc.add_options()(
+      "enable-incremental-aggregates",
+      po::value<bool>(&g_enable_incremental_aggregates)
+          ->default_value(g_enable_incremental_aggregates)
+          ->implicit_value(true),
+      "Keep the aggregates of the full fragments of single table aggregate queries, so "
+      "that running them again only scans the fragments appended since.");
+  help_desc.add_options()(
+      "enable-packed-key-sort",
+      po::value<bool>(&g_enable_packed_key_sort)
+          ->default_value(g_enable_packed_key_sort)
+          ->implicit_value(true),
+      "Sort ORDER BY results on numeric columns as a radix sort of their packed keys.");
+  help_desc.add_options()(
+      "enable-top-n-fragment-pruning",
+      po::value<bool>(&g_enable_top_n_fragment_pruning)
+          ->default_value(g_enable_top_n_fragment_pruning)
+          ->implicit_value(true),
+      "Skip the fragments of ORDER BY ... LIMIT queries whose sort column stats are past "
+      "the top rows already found.");
+  help_desc.add_options()(
+      "enable-top-k-group-pruning",
+      po::value<bool>(&g_enable_top_k_group_pruning)
+          ->default_value(g_enable_top_k_group_pruning)
+          ->implicit_value(true),
+      "Drop the groups of GROUP BY ... ORDER BY aggregate LIMIT queries which cannot be "
+      "among the top groups before reducing the results of the kernels.");
+  help_desc.add_options()(
+      "enable-external-sort",
+      po::value<bool>(&g_enable_external_sort)
+          ->default_value(g_enable_external_sort)
+          ->implicit_value(true),
+      "Sort the rows of large ORDER BY projections as sorted runs spilled to disk and "
+      "merged.");
+  help_desc.add_options()(
+      "external-sort-threshold",
+      po::value<size_t>(&g_external_sort_threshold)
+          ->default_value(g_external_sort_threshold),
+      "Estimated size in bytes of the rows of an ORDER BY projection above which they "
+      "are sorted externally.");
+  help_desc.add_options()(
+      "max-query-host-memory",
+      po::value<size_t>(&g_max_query_host_memory_bytes)
+          ->default_value(g_max_query_host_memory_bytes),
+      "Bytes of host memory a query may hold for its results, strings and hash tables "
+      "before it is cancelled, 0 for no limit. ORDER BY projections whose rows would not "
+      "fit are sorted externally.");
+  help_desc.add_options()(
+      "enable-chunk-bloom-filters",
+      po::value<bool>(&g_enable_chunk_bloom_filters)
+          ->default_value(g_enable_chunk_bloom_filters)
+          ->implicit_value(true),
+      "Keep Bloom filters of the values appended to integer and dictionary encoded "
+      "chunks, to skip the fragments equality and IN filters can't match.");
+  help_desc.add_options()(
+      "enable-sorted-chunk-indexes",
+      po::value<bool>(&g_enable_sorted_chunk_indexes)
+          ->default_value(g_enable_sorted_chunk_indexes)
+          ->implicit_value(true),
+      "Index the integer and dictionary encoded chunks filtered by equality, IN or range "
+      "filters the first time they are queried, so that CPU kernels only scan the rows "
+      "those filters can match. Costs 12 bytes of host memory per indexed row.");
+  help_desc.add_options()(
+      "enable-geo-grid-indexes",
+      po::value<bool>(&g_enable_geo_grid_indexes)
+          ->default_value(g_enable_geo_grid_indexes)
+          ->implicit_value(true),
+      "Index the bounds of the polygon chunks filtered by ST_Contains or ST_Intersects "
+      "against a constant geometry the first time they are queried, so that CPU kernels "
+      "only scan the rows whose bounds overlap it.");
+  help_desc.add_options()(
+      "chunk-prefetch-window",
+      po::value<size_t>(&g_chunk_prefetch_window)->default_value(g_chunk_prefetch_window),
+      "Number of kernels past those running whose chunks are read into the CPU buffer "
+      "pool in the background while the running ones compute, 0 disables prefetching.");
+  help_desc.add_options()(
+      "arrow-result-batch-entries",
+      po::value<size_t>(&g_arrow_result_batch_entries)
+          ->default_value(g_arrow_result_batch_entries),
+      "Number of result set entries per Arrow record batch of results serialized on the "
+      "CPU by sql_execute_df, which are converted and serialized one batch at a time, "
+      "0 converts the whole result into a single batch.");
+  help_desc.add_options()(
+      "query-result-cache-max-bytes",
+      po::value<size_t>(&g_query_result_cache_max_bytes)
+          ->default_value(g_query_result_cache_max_bytes),
+      "Bytes of the row sets of read queries kept to return them again while the tables "
+      "they read are unchanged, 0 disables the cache.");
+  help_desc.add_options()(
+      "cursor-ttl-seconds",
+      po::value<size_t>(&g_cursor_ttl_seconds)->default_value(g_cursor_ttl_seconds),
+      "Seconds a cursor opened by sql_execute_cursor, and the result set it pins, is "
+      "kept without rows being fetched from it.");
+  help_desc.add_options()(
+      "enable-direct-file-reads",
+      po::value<bool>(&g_enable_direct_file_reads)
+          ->default_value(g_enable_direct_file_reads)
+          ->implicit_value(true),
+      "Read the consecutive pages of a chunk with one positional read of the data file, "
+      "bypassing the page cache with O_DIRECT where the file system supports it.");
+  help_desc.add_options()(
+      "enable-header-index-file",
+      po::value<bool>(&g_enable_header_index_file)
+          ->default_value(g_enable_header_index_file)
+          ->implicit_value(true),
+      "Write the page map and the metadata of the chunks of a table to an index file at "
+      "every checkpoint and open tables from it at startup, instead of reading the "
+      "header of every page of their data files.");
+  help_desc.add_options()(
+      "enable-parallel-checkpoint",
+      po::value<bool>(&g_enable_parallel_checkpoint)
+          ->default_value(g_enable_parallel_checkpoint)
+          ->implicit_value(true),
+      "Write the metadata pages of the chunks changed since the last checkpoint of a "
+      "table and sync its data files from several threads, the epoch is still written "
+      "once all of them are on disk.");
+  help_desc.add_options()(
+      "enable-varlen-page-compression",
+      po::value<bool>(&g_enable_varlen_page_compression)
+          ->default_value(g_enable_varlen_page_compression)
+          ->implicit_value(true),
+      "Compress the full data pages of none encoded string and array columns with LZ4 "
+      "on disk. Reads only decompress the pages they overlap, chunks are held "
+      "decompressed in the buffer pools.");
+  help_desc.add_options()(
+      "group-commit-window-ms",
+      po::value<size_t>(&g_group_commit_window_ms)
+          ->default_value(g_group_commit_window_ms),
+      "Milliseconds a load into a table waits for concurrent loads into the same table "
+      "to checkpoint them all at once, 0 checkpoints every load on its own.");
+  help_desc.add_options()(
+      "group-commit-coalesce-rows",
+      po::value<size_t>(&g_group_commit_coalesce_rows)
+          ->default_value(g_group_commit_coalesce_rows),
+      "With a group commit window, loads of fewer rows than this into the same table "
+      "are inserted together in a single append once the window is over or as many rows "
+      "are buffered, 0 inserts every load on its own.");
+  help_desc.add_options()(
+      "enable-background-vacuum",
+      po::value<bool>(&g_enable_background_vacuum)
+          ->default_value(g_enable_background_vacuum)
+          ->implicit_value(true),
+      "Periodically vacuum the deleted rows of the fragments of tables, one fragment at "
+      "a time.");
+  help_desc.add_options()("background-vacuum-deleted-ratio",
+                          po::value<float>(&g_background_vacuum_deleted_ratio)
+                              ->default_value(g_background_vacuum_deleted_ratio),
+                          "Fraction of the rows of a fragment which must be deleted for "
+                          "the background vacuum to rewrite it.");
+  help_desc.add_options()("background-vacuum-mb-per-sec",
+                          po::value<size_t>(&g_background_vacuum_mb_per_sec)
+                              ->default_value(g_background_vacuum_mb_per_sec),
+                          "Maximum rate at which the background vacuum rewrites "
+                          "fragments, 0 doesn't limit it.");
+  help_desc.add_options()(
+      "enable-expression-fragment-skipping",
+      po::value<bool>(&g_enable_expression_fragment_skipping)
+          ->default_value(g_enable_expression_fragment_skipping)
+          ->implicit_value(true),
+      "Skip the fragments for which the ranges of the values of their chunks show that "
+      "no row passes a filter made of comparisons, IN lists, AND, OR and NOT.");
+  help_desc.add_options()(
+      "cold-storage-url",
+      po::value<std::string>(&g_cold_storage_url)->default_value(g_cold_storage_url),
+      "Object store of the cold storage tier, an s3://bucket/prefix url or a directory. "
+      "Empty disables the tier.");
+  help_desc.add_options()(
+      "cold-storage-fragment-age-days",
+      po::value<size_t>(&g_cold_storage_fragment_age_days)
+          ->default_value(g_cold_storage_fragment_age_days),
+      "Offload to the cold storage in the background the fragments whose DATE and "
+      "TIMESTAMP columns are all older than this many days, 0 doesn't offload them.");
   if (!dist_v5_) {
     help_desc.add_options()("http-port",
                             po::value<int>(&http_port)->default_value(http_port),
                             "HTTP port number.");
+    help_desc.add_options()(
+        "nonblocking-port",
+        po::value<int>(&nonblocking_port)->default_value(nonblocking_port),
+        "Also serve the binary protocol over framed transport on this port, from a "
+        "non-blocking server whose idle connections don't hold a thread. 0 doesn't "
+        "serve it.");
   }
+  help_desc.add_options()(
+      "nonblocking-server-threads",
+      po::value<size_t>(&nonblocking_server_threads)
+          ->default_value(nonblocking_server_threads),
+      "Number of threads processing the requests of the non-blocking server. Requests "
+      "past the executors wait in the dispatch queue, the threads left serve the other "
+      "calls.");
+  help_desc.add_options()(
+      "metrics-port",
+      po::value<int>(&g_metrics_port)->default_value(g_metrics_port),
+      "Serve the metrics of the buffer pools, caches, dispatch queue and execution "
+      "kernels in the Prometheus text format on GET /metrics of this port, 0 doesn't "
+      "serve them.");
+  help_desc.add_options()(
+      "query-history-size",
+      po::value<size_t>(&g_query_history_size)->default_value(g_query_history_size),
+      "Number of the most recent queries kept with the resources they used, for SHOW "
+      "QUERY HISTORY. The history is saved in the data directory. 0 disables it.");
+  help_desc.add_options()("query-history-persist-interval",
+                          po::value<size_t>(&g_query_history_persist_interval_s)
+                              ->default_value(g_query_history_persist_interval_s),
+                          "Interval in seconds at which the query history is saved.");
   help_desc.add_options()(
       "idle-session-duration",
       po::value<int>(&idle_session_duration)->default_value(idle_session_duration),
@@ -267,6 +648,85 @@ void CommandLineOptions::fillOptions() {
       po::value<size_t>(&g_overlaps_max_table_size_bytes)
           ->default_value(g_overlaps_max_table_size_bytes),
       "The maximum size in bytes of the hash table for an overlaps hash join.");
+  help_desc.add_options()(
+      "overlaps-auto-tuner-sample-rows",
+      po::value<size_t>(&g_overlaps_auto_tuner_sample_rows)
+          ->default_value(g_overlaps_auto_tuner_sample_rows),
+      "Number of inner rows sampled to compare the bucket sizes of an overlaps hash "
+      "join. Set to 0 to use all the rows.");
+  help_desc.add_options()(
+      "hash-join-partition-threshold-bytes",
+      po::value<size_t>(&g_hash_join_partition_threshold_bytes)
+          ->default_value(g_hash_join_partition_threshold_bytes),
+      "Keyed CPU hash tables larger than this many bytes are built in radix partitions.");
+  help_desc.add_options()(
+      "hash-join-partition-bytes",
+      po::value<size_t>(&g_hash_join_partition_bytes)
+          ->default_value(g_hash_join_partition_bytes),
+      "Target size in bytes of a partition of a radix partitioned hash table build.");
+  help_desc.add_options()(
+      "hash-table-cache-max-bytes",
+      po::value<size_t>(&g_hash_table_cache_max_bytes)
+          ->default_value(g_hash_table_cache_max_bytes),
+      "Size limit in bytes of the join hash tables cached on CPU across queries. The "
+      "least recently used tables are evicted first. Set to 0 for no limit.");
+  help_desc.add_options()(
+      "enable-join-fragment-pairing",
+      po::value<bool>(&g_enable_join_fragment_pairing)
+          ->default_value(g_enable_join_fragment_pairing)
+          ->implicit_value(true),
+      "Build perfect join hash tables only on the inner fragments whose key range, from "
+      "the chunk statistics, overlaps a fragment of the outer table. Pays off when both "
+      "tables are sorted on the join key.");
+  help_desc.add_options()(
+      "enable-lazy-fetch-through-outer-joins",
+      po::value<bool>(&g_enable_lazy_fetch_through_outer_joins)
+          ->default_value(g_enable_lazy_fetch_through_outer_joins)
+          ->implicit_value(true),
+      "Carry only the row ids of the none encoded string, array and geo columns "
+      "projected by left joins and read their values from the tables when the rows are "
+      "returned. Such columns of the outer joined tables can be projected then.");
+  help_desc.add_options()(
+      "enable-shared-gpu-hash-tables",
+      po::value<bool>(&g_enable_shared_gpu_hash_tables)
+          ->default_value(g_enable_shared_gpu_hash_tables)
+          ->implicit_value(true),
+      "Build the perfect join hash tables of replicated inner tables on the first GPU "
+      "only, the other GPUs read them through peer access. Needs "
+      "--enable-gpu-peer-access.");
+  help_desc.add_options()(
+      "max-perfect-hash-entries-per-row",
+      po::value<size_t>(&g_max_perfect_hash_entries_per_row)
+          ->default_value(g_max_perfect_hash_entries_per_row),
+      "Build a keyed join hash table instead of a perfect one when the key range of the "
+      "inner table needs more than this many entries per inner row, and more than 16M "
+      "entries. Set to 0 to always build a perfect hash table when possible.");
+  help_desc.add_options()(
+      "hash-join-prefetch-distance",
+      po::value<size_t>(&g_hash_join_prefetch_distance)
+          ->default_value(g_hash_join_prefetch_distance),
+      "How many rows ahead CPU hash join probes prefetch the hash table entries of the "
+      "outer rows, for hash tables larger than the CPU caches. Set to 0 to disable.");
+  help_desc.add_options()(
+      "enable-tree-reduction",
+      po::value<bool>(&g_enable_tree_reduction)
+          ->default_value(g_enable_tree_reduction)
+          ->implicit_value(true),
+      "Merge the results of the devices of a query pairwise, in parallel, instead of all "
+      "into the first one, when their buffers are too small to be reduced in parallel.");
+  help_desc.add_options()(
+      "group-by-partition-count",
+      po::value<size_t>(&g_group_by_partition_count)
+          ->default_value(g_group_by_partition_count),
+      "Number of partitions of the groups a group by query which runs out of output "
+      "buffer slots or CPU memory is retried in, one partition at a time on CPU. Set to "
+      "0 to disable.");
+  help_desc.add_options()(
+      "approx-quantile-centroids",
+      po::value<size_t>(&g_approx_quantile_centroids)
+          ->default_value(g_approx_quantile_centroids),
+      "Compression of the t-digests of APPROX_QUANTILE, about the number of centroids "
+      "each group keeps. Larger is more accurate and uses more memory.");
   if (!dist_v5_) {
     help_desc.add_options()("port,p",
                             po::value<int>(&system_parameters.omnisci_server_port)
@@ -337,6 +797,11 @@ void CommandLineOptions::fillOptions() {
       "disk-cache-size-limit",
       po::value<std::size_t>(&(disk_cache_config.size_limit)),
       "Specify the maximum size of the the disk cache per table in bytes.");
+  help_desc.add_options()(
+      "disk-cache-eviction-policy",
+      po::value<std::string>(&(disk_cache_eviction_policy))->default_value("lru"),
+      "Specify the eviction policy of the disk cache.  Valid options are 'lru', and "
+      "'2q', which keeps the chunks used repeatedly when a table is scanned once.");
 #endif  // ENABLE_FSI
   help_desc.add_options()(
       "enable-interoperability",
@@ -366,6 +831,27 @@ void CommandLineOptions::fillOptions() {
           ->default_value(g_enable_stringdict_parallel)
           ->implicit_value(true),
       "Allow StringDictionary to parallelize loads using multiple threads");
+  help_desc.add_options()(
+      "stringdict-trigram-index",
+      po::value<bool>(&g_enable_stringdict_trigram_index)
+          ->default_value(g_enable_stringdict_trigram_index)
+          ->implicit_value(true),
+      "Keep a trigram index of the strings of the dictionaries, LIKE and REGEXP_LIKE "
+      "then only match the strings which contain the literals of the pattern.");
+  help_desc.add_options()(
+      "stringdict-lazy-load",
+      po::value<bool>(&g_enable_stringdict_lazy_load)
+          ->default_value(g_enable_stringdict_lazy_load)
+          ->implicit_value(true),
+      "Open the dictionaries without building their hash tables, the first lookup in a "
+      "dictionary reads the table persisted by its last checkpoint or rebuilds it.");
+  help_desc.add_options()(
+      "stringdict-remote-cache-entries",
+      po::value<size_t>(&g_stringdict_remote_cache_entries)
+          ->default_value(g_stringdict_remote_cache_entries),
+      "Number of strings of each remote dictionary of a leaf whose ids are cached, in "
+      "both directions, and not requested from the dictionary server again. 0 disables "
+      "the cache.");
   help_desc.add_options()("log-user-origin",
                           po::value<bool>(&log_user_origin)
                               ->default_value(log_user_origin)
@@ -411,6 +897,12 @@ void CommandLineOptions::fillAdvancedOptions() {
                                po::value<int>(&system_parameters.num_executors)
                                    ->default_value(system_parameters.num_executors),
                                "Number of executors to run in parallel.");
+  developer_desc.add_options()(
+      "dispatch-interactive-share",
+      po::value<size_t>(&system_parameters.dispatch_interactive_share)
+          ->default_value(system_parameters.dispatch_interactive_share),
+      "Number of interactive queries dispatched ahead of each waiting batch query "
+      "(update, delete, insert-select) when executors are saturated.");
   developer_desc.add_options()(
       "gpu-shared-mem-threshold",
       po::value<size_t>(&g_gpu_smem_threshold)->default_value(g_gpu_smem_threshold),
@@ -428,6 +920,13 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(g_enable_smem_non_grouped_agg)
           ->implicit_value(true),
       "Enable using GPU shared memory for non-grouped aggregate queries.");
+  developer_desc.add_options()(
+      "enable-shared-mem-baseline-group-by",
+      po::value<bool>(&g_enable_smem_baseline_group_by)
+          ->default_value(g_enable_smem_baseline_group_by)
+          ->implicit_value(true),
+      "Enable using GPU shared memory for baseline hash GROUP BY queries whose output "
+      "buffer fits in it.");
   developer_desc.add_options()("enable-direct-columnarization",
                                po::value<bool>(&g_enable_direct_columnarization)
                                    ->default_value(g_enable_direct_columnarization)
@@ -451,6 +950,12 @@ void CommandLineOptions::fillAdvancedOptions() {
                                    ->default_value(g_enable_table_functions)
                                    ->implicit_value(true),
                                "Enable experimental table functions support.");
+  developer_desc.add_options()(
+      "table-function-partition-rows",
+      po::value<size_t>(&g_table_function_partition_rows)
+          ->default_value(g_table_function_partition_rows),
+      "Minimum input rows per partition of the table functions which run their input "
+      "in parallel partitions on CPU, 0 to never partition.");
   developer_desc.add_options()(
       "jit-debug-ir",
       po::value<bool>(&jit_debug)->default_value(jit_debug)->implicit_value(true),
@@ -470,6 +975,143 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(g_use_tbb_pool)
           ->implicit_value(true),
       "Enable a new thread pool implementation for queuing kernels for execution.");
+  developer_desc.add_options()(
+      "enable-work-stealing-kernel-dispatch",
+      po::value<bool>(&g_enable_work_stealing_kernel_dispatch)
+          ->default_value(g_enable_work_stealing_kernel_dispatch)
+          ->implicit_value(true),
+      "Dispatch execution kernels, largest fragments first, to a fixed pool of worker "
+      "threads which steal pending kernels from each other instead of starting one "
+      "thread per kernel.");
+  developer_desc.add_options()(
+      "enable-gpu-kernel-streams",
+      po::value<bool>(&g_enable_gpu_kernel_streams)
+          ->default_value(g_enable_gpu_kernel_streams)
+          ->implicit_value(true),
+      "Launch each GPU kernel on its own CUDA stream, the columns of the next kernel on "
+      "a device are then uploaded while the current kernel runs.");
+  developer_desc.add_options()(
+      "enable-gpu-launch-graphs",
+      po::value<bool>(&g_enable_gpu_launch_graphs)
+          ->default_value(g_enable_gpu_launch_graphs)
+          ->implicit_value(true),
+      "Capture the group by buffer initialization and the kernel launch of a GPU query "
+      "step into a CUDA graph, instantiated once per compiled kernel and fragment "
+      "layout and replayed with the parameters of the following runs.");
+  developer_desc.add_options()(
+      "enable-cpu-multifrag-kernels",
+      po::value<bool>(&g_enable_cpu_multifrag_kernels)
+          ->default_value(g_enable_cpu_multifrag_kernels)
+          ->implicit_value(true),
+      "Scan several small fragments per CPU kernel into one output buffer for "
+      "aggregate queries.");
+  developer_desc.add_options()(
+      "cpu-multifrag-kernel-min-rows",
+      po::value<size_t>(&g_cpu_multifrag_kernel_min_rows)
+          ->default_value(g_cpu_multifrag_kernel_min_rows),
+      "Number of rows CPU kernels of several fragments are batched up to, unless fewer "
+      "are needed to keep all the CPU threads busy.");
+  developer_desc.add_options()(
+      "enable-streaming-reduction",
+      po::value<bool>(&g_enable_streaming_reduction)
+          ->default_value(g_enable_streaming_reduction)
+          ->implicit_value(true),
+      "Reduce the output buffers of CPU aggregate kernels into each other as the kernels "
+      "finish, rather than once all of them are done.");
+  developer_desc.add_options()(
+      "enable-delete-metadata-skipping",
+      po::value<bool>(&g_enable_delete_metadata_skipping)
+          ->default_value(g_enable_delete_metadata_skipping)
+          ->implicit_value(true),
+      "Skip the fragments whose rows are all deleted and don't fetch the delete column "
+      "of the fragments without deleted rows, as shown by the chunk metadata.");
+  developer_desc.add_options()(
+      "enable-parallel-fragment-updates",
+      po::value<bool>(&g_enable_parallel_fragment_updates)
+          ->default_value(g_enable_parallel_fragment_updates)
+          ->implicit_value(true),
+      "Apply the UPDATE and DELETE statements to several fragments of a table at a "
+      "time, unless the update rewrites variable length columns.");
+  developer_desc.add_options()(
+      "enable-inplace-string-updates",
+      po::value<bool>(&g_enable_inplace_string_updates)
+          ->default_value(g_enable_inplace_string_updates)
+          ->implicit_value(true),
+      "Overwrite the none encoded strings changed by an UPDATE in place when they keep "
+      "their length, rather than deleting and appending their rows again.");
+  developer_desc.add_options()(
+      "enable-nonblocking-fragment-drops",
+      po::value<bool>(&g_enable_nonblocking_fragment_drops)
+          ->default_value(g_enable_nonblocking_fragment_drops)
+          ->implicit_value(true),
+      "Leave the chunks of the fragments dropped by max_rows to a later insert when the "
+      "table is being read, rather than waiting for its queries to finish.");
+  developer_desc.add_options()(
+      "enable-column-page-sizing",
+      po::value<bool>(&g_enable_column_page_sizing)
+          ->default_value(g_enable_column_page_sizing)
+          ->implicit_value(true),
+      "Size the pages of the new chunks of a table without a page size by the width of "
+      "their column, from 256KB for the narrow columns to 8MB for the variable length "
+      "ones.");
+  developer_desc.add_options()(
+      "enable-catalog-snapshot-reads",
+      po::value<bool>(&g_enable_catalog_snapshot_reads)
+          ->default_value(g_enable_catalog_snapshot_reads)
+          ->implicit_value(true),
+      "Look tables and columns up by id in a copy of the catalog maps made after each "
+      "change, rather than under the catalog read lock.");
+  developer_desc.add_options()(
+      "enable-parallel-catalog-loading",
+      po::value<bool>(&g_enable_parallel_catalog_loading)
+          ->default_value(g_enable_parallel_catalog_loading)
+          ->implicit_value(true),
+      "Load the catalogs of the databases side by side when all of them are needed, as by "
+      "the background vacuum, cold storage and foreign table refresh.");
+  developer_desc.add_options()(
+      "enable-serialized-rows-compression",
+      po::value<bool>(&g_enable_serialized_rows_compression)
+          ->default_value(g_enable_serialized_rows_compression)
+          ->implicit_value(true),
+      "Send the result sets exchanged between the nodes as compressed columns, must be "
+      "the same on all the nodes of the cluster.");
+  developer_desc.add_options()(
+      "enable-shared-scans",
+      po::value<bool>(&g_enable_shared_scans)
+          ->default_value(g_enable_shared_scans)
+          ->implicit_value(true),
+      "Start the kernels of a query step from the fragment the concurrent scans of the "
+      "same table have reached, so they share the chunks they fetch.");
+  developer_desc.add_options()(
+      "enable-parallel-union-branches",
+      po::value<bool>(&g_enable_parallel_union_branches)
+          ->default_value(g_enable_parallel_union_branches)
+          ->implicit_value(true),
+      "Run the steps of the branches of a UNION ALL at the same time, each on an "
+      "executor of its own.");
+  developer_desc.add_options()(
+      "enable-multi-gpu-reduction",
+      po::value<bool>(&g_enable_multi_gpu_reduction)
+          ->default_value(g_enable_multi_gpu_reduction)
+          ->implicit_value(true),
+      "Reduce the perfect hash group by buffers of the GPU kernels of a query on a GPU, "
+      "reading the buffers of the other GPUs through peer access when it is enabled. "
+      "Only the reduced buffer is copied to the host.");
+  developer_desc.add_options()(
+      "enable-pipelined-import",
+      po::value<bool>(&g_enable_pipelined_import)
+          ->default_value(g_enable_pipelined_import)
+          ->implicit_value(true),
+      "Load the rows the threads of a delimited import parsed on a writer thread, for "
+      "the threads to parse their next rows meanwhile instead of waiting for the load.");
+  developer_desc.add_options()(
+      "enable-gpu-dict-payload",
+      po::value<bool>(&g_enable_gpu_dict_payload)
+          ->default_value(g_enable_gpu_dict_payload)
+          ->implicit_value(true),
+      "Copy the offsets and the payload of a string dictionary to the GPUs once per "
+      "generation, for LIKE and CHAR_LENGTH on a dictionary-encoded column to run on the "
+      "GPU instead of falling back to the CPU.");
   developer_desc.add_options()(
       "skip-intermediate-count",
       po::value<bool>(&g_skip_intermediate_count)
@@ -547,6 +1189,62 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(g_fraction_code_cache_to_evict),
       "Percentage of the GPU code cache to evict if an out of memory error is "
       "encountered while attempting to place generated code on the GPU.");
+  developer_desc.add_options()(
+      "code-cache-max-bytes",
+      po::value<size_t>(&g_code_cache_max_bytes)->default_value(g_code_cache_max_bytes),
+      "Size limit in bytes of the native code cached by each executor, separately for "
+      "CPU and GPU code. Set to 0 to limit the caches by number of entries only.");
+  developer_desc.add_options()(
+      "enable-persistent-code-cache",
+      po::value<bool>(&g_enable_persistent_code_cache)
+          ->default_value(g_enable_persistent_code_cache)
+          ->implicit_value(true),
+      "Keep generated CPU and GPU code on disk so that it can be reused across server "
+      "restarts.");
+  developer_desc.add_options()(
+      "persistent-code-cache-path",
+      po::value<std::string>(&g_persistent_code_cache_path),
+      "Directory for the persistent code cache. Defaults to "
+      "<data dir>/omnisci_code_cache.");
+  developer_desc.add_options()(
+      "enable-tiered-compilation",
+      po::value<bool>(&g_enable_tiered_compilation)
+          ->default_value(g_enable_tiered_compilation)
+          ->implicit_value(true),
+      "Run the first execution of a CPU query with quickly generated, unoptimized code "
+      "and compile the optimized code in the background for later executions.");
+  developer_desc.add_options()(
+      "tiered-compilation-max-input-rows",
+      po::value<size_t>(&g_tiered_compilation_max_input_rows)
+          ->default_value(g_tiered_compilation_max_input_rows),
+      "Largest number of input rows for a query step to start with unoptimized code "
+      "when tiered compilation is enabled.");
+  developer_desc.add_options()(
+      "enable-expression-interpreter",
+      po::value<bool>(&g_enable_expression_interpreter)
+          ->default_value(g_enable_expression_interpreter)
+          ->implicit_value(true),
+      "Interpret the filters and the targets of the CPU projections of small tables "
+      "instead of generating code for them.");
+  developer_desc.add_options()(
+      "expression-interpreter-max-input-rows",
+      po::value<size_t>(&g_expression_interpreter_max_input_rows)
+          ->default_value(g_expression_interpreter_max_input_rows),
+      "Largest number of rows of a table for its projections to be interpreted.");
+  developer_desc.add_options()(
+      "enable-cpu-vectorization",
+      po::value<bool>(&g_enable_cpu_vectorization)
+          ->default_value(g_enable_cpu_vectorization)
+          ->implicit_value(true),
+      "Optimize CPU code for the host instruction set and run the LLVM loop and SLP "
+      "vectorizers over the scan loop.");
+  developer_desc.add_options()(
+      "enable-udf-inlining",
+      po::value<bool>(&g_enable_udf_inlining)
+          ->default_value(g_enable_udf_inlining)
+          ->implicit_value(true),
+      "Inline the small UDFs into the CPU scan loop instead of calling them once per "
+      "row.");
 
   developer_desc.add_options()("ssl-cert",
                                po::value<std::string>(&system_parameters.ssl_cert_file)
@@ -621,6 +1319,19 @@ void CommandLineOptions::fillAdvancedOptions() {
   developer_desc.add_options()(
       "large-ndv-multiplier",
       po::value<size_t>(&g_large_ndv_multiplier)->default_value(g_large_ndv_multiplier));
+  developer_desc.add_options()(
+      "enable-ndv-sampling",
+      po::value<bool>(&g_enable_ndv_sampling)
+          ->default_value(g_enable_ndv_sampling)
+          ->implicit_value(true),
+      "Estimate the number of groups of a group by from a sample of the fragments of "
+      "its table first, running the estimator over the whole table only if the groups "
+      "of the sample repeat too little.");
+  developer_desc.add_options()(
+      "ndv-sample-fragment-count",
+      po::value<size_t>(&g_ndv_sample_fragment_count)
+          ->default_value(g_ndv_sample_fragment_count),
+      "Number of fragments in the sample of enable-ndv-sampling.");
   developer_desc.add_options()(
       "bitmap-memory-limit",
       po::value<int64_t>(&g_bitmap_memory_limit)->default_value(g_bitmap_memory_limit),
@@ -641,6 +1352,130 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(g_enable_calcite_ddl_parser)
           ->implicit_value(true),
       "Enable using Calcite for supported DDL parsing when available.");
+  developer_desc.add_options()(
+      "enable-admission-control",
+      po::value<bool>(&g_enable_admission_control)
+          ->default_value(g_enable_admission_control)
+          ->implicit_value(true),
+      "Hold back query steps until the CPU/GPU buffer pools can cover their estimated "
+      "input, output buffer and join hash table memory.");
+  developer_desc.add_options()(
+      "admission-control-timeout-ms",
+      po::value<size_t>(&g_admission_control_timeout_ms)
+          ->default_value(g_admission_control_timeout_ms),
+      "Maximum time (in milliseconds) a query step waits for a buffer pool reservation "
+      "before it is admitted without one.");
+  developer_desc.add_options()(
+      "enable-numa-aware-buffer-pool",
+      po::value<bool>(&g_enable_numa_aware_buffer_pool)
+          ->default_value(g_enable_numa_aware_buffer_pool)
+          ->implicit_value(true),
+      "Home CPU buffer pool slabs on NUMA nodes, place chunks on the node selected by "
+      "their fragment id and run CPU kernels on the node owning their fragments. "
+      "Requires a build with libnuma.");
+  developer_desc.add_options()(
+      "buffer-eviction-policy",
+      po::value<std::string>(&g_buffer_eviction_policy)
+          ->default_value(g_buffer_eviction_policy),
+      "Policy ranking the CPU and GPU buffer pool chunks for eviction: lru, lru2 "
+      "(LRU-K with K = 2) or 2q. lru2 and 2q evict the chunks touched once, as by a "
+      "large one-off scan, before the chunks touched again.");
+  developer_desc.add_options()(
+      "buffer-eviction-disk-refetch-cost",
+      po::value<float>(&g_buffer_eviction_disk_refetch_cost)
+          ->default_value(g_buffer_eviction_disk_refetch_cost),
+      "Cost of fetching back an evicted GPU buffer pool chunk which is not in the CPU "
+      "buffer pool, relative to one which is. The ages of the chunks are divided by "
+      "their cost when ranking them for eviction, 1 ignores where chunks come from.");
+  developer_desc.add_options()(
+      "buffer-eviction-size-weight",
+      po::value<float>(&g_buffer_eviction_size_weight)
+          ->default_value(g_buffer_eviction_size_weight),
+      "Makes the large chunks look older when ranking them for eviction, the age of a "
+      "chunk filling a whole slab is multiplied by 1 + this weight. 0 ignores sizes.");
+  developer_desc.add_options()(
+      "enable-buffer-pool-compaction",
+      po::value<bool>(&g_enable_buffer_pool_compaction)
+          ->default_value(g_enable_buffer_pool_compaction)
+          ->implicit_value(true),
+      "When an allocation finds no contiguous free pages in the CPU or GPU buffer pool, "
+      "move unpinned buffers within and across slabs to gather free pages before "
+      "evicting chunks.");
+  developer_desc.add_options()(
+      "buffer-pool-compaction-interval-s",
+      po::value<size_t>(&g_buffer_pool_compaction_interval_s)
+          ->default_value(g_buffer_pool_compaction_interval_s),
+      "Compact the slabs of the CPU and GPU buffer pools in the background every this "
+      "many seconds, while no query runs. 0 disables the background compaction.");
+  developer_desc.add_options()(
+      "enable-working-set-snapshot",
+      po::value<bool>(&g_enable_working_set_snapshot)
+          ->default_value(g_enable_working_set_snapshot)
+          ->implicit_value(true),
+      "Save the keys of the hottest chunks of the CPU and GPU buffer pools periodically "
+      "and at shutdown, and load the chunks back in the background at startup, while no "
+      "query runs.");
+  developer_desc.add_options()(
+      "working-set-snapshot-interval-s",
+      po::value<size_t>(&g_working_set_snapshot_interval_s)
+          ->default_value(g_working_set_snapshot_interval_s),
+      "Seconds between the saves of the working set of the buffer pools.");
+  developer_desc.add_options()(
+      "working-set-warmup-mb-per-sec",
+      po::value<size_t>(&g_working_set_warmup_mb_per_sec)
+          ->default_value(g_working_set_warmup_mb_per_sec),
+      "Maximum rate at which the working set is loaded back at startup, 0 doesn't limit "
+      "it.");
+  developer_desc.add_options()(
+      "pinned-host-staging-pool-mb",
+      po::value<size_t>(&g_pinned_host_staging_pool_mb)
+          ->default_value(g_pinned_host_staging_pool_mb),
+      "Size in MB of the pool of pinned host buffers the copies from pageable host "
+      "memory to the GPUs are staged through. 0 copies from pageable memory directly.");
+  developer_desc.add_options()(
+      "enable-pinned-cpu-buffer-pool",
+      po::value<bool>(&g_enable_pinned_cpu_buffer_pool)
+          ->default_value(g_enable_pinned_cpu_buffer_pool)
+          ->implicit_value(true),
+      "Pin the slabs of the CPU buffer pool, the chunks are then copied to the GPUs "
+      "without staging. The pinned memory cannot be swapped out.");
+  developer_desc.add_options()(
+      "cpu-compressed-chunk-cache-bytes",
+      po::value<size_t>(&g_cpu_compressed_chunk_cache_bytes)
+          ->default_value(g_cpu_compressed_chunk_cache_bytes),
+      "Bytes of memory holding an LZ4 compressed copy of the chunks evicted from the CPU "
+      "buffer pool, an evicted chunk is then decompressed from its copy rather than "
+      "read from disk. 0 disables the compressed copies.");
+  developer_desc.add_options()(
+      "enable-gpu-peer-access",
+      po::value<bool>(&g_enable_gpu_peer_access)
+          ->default_value(g_enable_gpu_peer_access)
+          ->implicit_value(true),
+      "Enable the peer access between the GPUs linked by NVLink or PCIe, a chunk "
+      "missing from the buffer pool of a GPU is then copied from another GPU which "
+      "holds it rather than from the host.");
+  developer_desc.add_options()(
+      "enable-gpu-compressed-chunks",
+      po::value<bool>(&g_enable_gpu_compressed_chunks)
+          ->default_value(g_enable_gpu_compressed_chunks)
+          ->implicit_value(true),
+      "Keep a compressed copy of the integer chunks promoted to the GPUs, an evicted "
+      "chunk is then decoded on the GPU from its copy rather than copied from the "
+      "host.");
+  developer_desc.add_options()(
+      "gpu-compressed-chunk-max-ratio",
+      po::value<float>(&g_gpu_compressed_chunk_max_ratio)
+          ->default_value(g_gpu_compressed_chunk_max_ratio),
+      "Largest compressed to decoded size ratio of the chunks kept compressed on "
+      "the GPUs.");
+  developer_desc.add_options()(
+      "enable-gpu-managed-memory-fallback",
+      po::value<bool>(&g_enable_gpu_managed_memory_fallback)
+          ->default_value(g_enable_gpu_managed_memory_fallback)
+          ->implicit_value(true),
+      "Allocate the join hash tables and group by buffers which don't fit in the GPU "
+      "buffer pool in CUDA managed memory, up to the size of the pool again, instead "
+      "of running the query on the CPU.");
 }
 
 namespace {
@@ -764,6 +1599,26 @@ void CommandLineOptions::validate() {
   }
 
   LOG(INFO) << " Debug Timer is set to " << g_enable_debug_timer;
+  LOG(INFO) << " Hardware performance counters are set to " << g_enable_perf_counters;
+  LOG(INFO) << " GPU kernel timing is set to " << g_enable_gpu_kernel_timing;
+  LOG(INFO) << " Lock contention profiling is set to "
+            << g_enable_lock_contention_profiling;
+  if (g_max_query_host_memory_bytes) {
+    LOG(INFO) << " Queries may hold up to " << g_max_query_host_memory_bytes
+              << " bytes of host memory";
+  }
+
+  // throws on an unknown mode
+  huge_pages::parse_mode(g_huge_pages);
+  LOG(INFO) << " Huge pages are set to " << g_huge_pages;
+  LOG(INFO) << " Result spooling is set to " << g_enable_result_spooling;
+
+  // throws on an unknown policy
+  Buffer_Namespace::create_eviction_policy(g_buffer_eviction_policy);
+  if (g_buffer_eviction_disk_refetch_cost <= 0) {
+    throw std::runtime_error("buffer-eviction-disk-refetch-cost must be positive.");
+  }
+  LOG(INFO) << " Buffer eviction policy is set to " << g_buffer_eviction_policy;
 
   LOG(INFO) << " Maximum Idle session duration " << idle_session_duration;
 
@@ -798,11 +1653,32 @@ void CommandLineOptions::validate() {
               << "}.  Defaulted to disk cache disabled";
   }
 
+  if (disk_cache_eviction_policy == "lru") {
+    disk_cache_config.eviction_policy = DiskCacheEvictionPolicy::lru;
+  } else if (disk_cache_eviction_policy == "2q") {
+    disk_cache_config.eviction_policy = DiskCacheEvictionPolicy::two_queue;
+    LOG(INFO) << "Disk cache uses the 2Q eviction policy";
+  } else {
+    disk_cache_config.eviction_policy = DiskCacheEvictionPolicy::lru;
+    LOG(INFO) << "Non-recognized value for disk-cache-eviction-policy {"
+              << disk_cache_eviction_policy << "}.  Defaulted to lru";
+  }
+
   if (disk_cache_config.path.empty()) {
     disk_cache_config.path = base_path + "/omnisci_disk_cache";
   }
   ddl_utils::FilePathBlacklist::addToBlacklist(disk_cache_config.path);
 
+  if (g_persistent_code_cache_path.empty()) {
+    g_persistent_code_cache_path = base_path + "/omnisci_code_cache";
+  }
+  ddl_utils::FilePathBlacklist::addToBlacklist(g_persistent_code_cache_path);
+
+  if (g_result_spool_path.empty()) {
+    g_result_spool_path = base_path + "/omnisci_result_spool";
+  }
+  ddl_utils::FilePathBlacklist::addToBlacklist(g_result_spool_path);
+
   ddl_utils::FilePathBlacklist::addToBlacklist("/etc/passwd");
   ddl_utils::FilePathBlacklist::addToBlacklist("/etc/shadow");
 
@@ -974,6 +1850,7 @@ boost::optional<int> CommandLineOptions::parse_command_line(
   LOG(INFO) << " calcite JVM max memory  " << system_parameters.calcite_max_mem;
   LOG(INFO) << " OmniSci Server Port  " << system_parameters.omnisci_server_port;
   LOG(INFO) << " OmniSci Calcite Port  " << system_parameters.calcite_port;
+  LOG(INFO) << " Calcite servers  " << system_parameters.calcite_servers;
   LOG(INFO) << " Enable Calcite view optimize "
             << system_parameters.enable_calcite_view_optimize;
 
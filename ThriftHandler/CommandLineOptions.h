@@ -44,6 +44,9 @@ class CommandLineOptions {
     fillAdvancedOptions();
   }
   int http_port = 6278;
+  // port of the non-blocking server of the framed binary protocol, 0 if not served
+  int nonblocking_port = 0;
+  size_t nonblocking_server_threads = 64;
   size_t reserved_gpu_mem = 384 * 1024 * 1024;
   std::string base_path;
   DiskCacheConfig disk_cache_config;
@@ -81,6 +84,7 @@ class CommandLineOptions {
   unsigned pending_query_interrupt_freq = 1000;  // in milliseconds
   unsigned dynamic_watchdog_time_limit = 10000;
   std::string disk_cache_level = "";
+  std::string disk_cache_eviction_policy = "";
 
   /**
    * Can be used to override the number of gpus detected on the system
@@ -163,21 +167,79 @@ extern bool g_enable_columnar_output;
 extern bool g_enable_overlaps_hashjoin;
 extern bool g_enable_hashjoin_many_to_many;
 extern size_t g_overlaps_max_table_size_bytes;
+extern size_t g_overlaps_auto_tuner_sample_rows;
+extern size_t g_hash_join_partition_threshold_bytes;
+extern size_t g_hash_join_partition_bytes;
+extern size_t g_hash_table_cache_max_bytes;
+extern bool g_enable_join_fragment_pairing;
+extern bool g_enable_lazy_fetch_through_outer_joins;
+extern bool g_enable_shared_gpu_hash_tables;
+extern size_t g_max_perfect_hash_entries_per_row;
+extern size_t g_hash_join_prefetch_distance;
+extern bool g_enable_tree_reduction;
+extern size_t g_group_by_partition_count;
+extern size_t g_approx_quantile_centroids;
+extern bool g_enable_roaring_count_distinct;
+extern bool g_enable_clustered_group_by;
+extern bool g_enable_packed_group_keys;
+extern bool g_enable_band_joins;
+extern bool g_enable_incremental_aggregates;
+extern bool g_enable_packed_key_sort;
+extern bool g_enable_top_n_fragment_pruning;
+extern bool g_enable_external_sort;
+extern size_t g_external_sort_threshold;
+extern bool g_enable_chunk_bloom_filters;
+extern bool g_enable_sorted_chunk_indexes;
+extern bool g_enable_geo_grid_indexes;
+extern size_t g_chunk_prefetch_window;
+extern bool g_enable_direct_file_reads;
+extern bool g_enable_header_index_file;
+extern bool g_enable_parallel_checkpoint;
+extern bool g_enable_varlen_page_compression;
+extern size_t g_group_commit_window_ms;
+extern size_t g_group_commit_coalesce_rows;
+extern bool g_enable_background_vacuum;
+extern float g_background_vacuum_deleted_ratio;
+extern size_t g_background_vacuum_mb_per_sec;
+extern bool g_enable_expression_fragment_skipping;
+extern std::string g_cold_storage_url;
+extern size_t g_cold_storage_fragment_age_days;
+extern size_t g_buffer_pool_compaction_interval_s;
+extern bool g_enable_working_set_snapshot;
+extern size_t g_working_set_snapshot_interval_s;
+extern size_t g_working_set_warmup_mb_per_sec;
+extern size_t g_pinned_host_staging_pool_mb;
+extern bool g_enable_pinned_cpu_buffer_pool;
+extern size_t g_cpu_compressed_chunk_cache_bytes;
+extern bool g_enable_gpu_peer_access;
+extern bool g_enable_gpu_compressed_chunks;
+extern bool g_enable_multi_gpu_reduction;
+extern float g_gpu_compressed_chunk_max_ratio;
+extern bool g_enable_gpu_managed_memory_fallback;
 extern bool g_strip_join_covered_quals;
 extern size_t g_constrained_by_in_threshold;
 extern size_t g_big_group_threshold;
 extern bool g_enable_window_functions;
 extern bool g_enable_table_functions;
+extern size_t g_table_function_partition_rows;
 extern size_t g_max_memory_allocation_size;
 extern double g_bump_allocator_step_reduction;
 extern bool g_enable_direct_columnarization;
 extern bool g_enable_runtime_query_interrupt;
 extern unsigned g_pending_query_interrupt_freq;
 extern double g_running_query_interrupt_freq;
+extern size_t g_cpu_interrupt_check_block_rows;
 extern size_t g_gpu_smem_threshold;
 extern bool g_enable_smem_non_grouped_agg;
 extern bool g_enable_smem_grouped_non_count_agg;
+extern bool g_enable_smem_baseline_group_by;
 extern bool g_use_estimator_result_cache;
+extern size_t g_arrow_result_batch_entries;
+extern size_t g_join_order_dp_max_tables;
+extern size_t g_query_result_cache_max_bytes;
+extern size_t g_cursor_ttl_seconds;
+extern bool g_enable_common_subplan_elimination;
+extern bool g_enable_device_cost_model;
 
 extern int64_t g_omni_kafka_seek;
 extern size_t g_leaf_count;
@@ -24,6 +24,8 @@
 #include "DBHandler.h"
 #include "DistributedLoader.h"
 #include "QueryEngine/UDFCompiler.h"
+#include "QueryHistory.h"
+#include "QueryResultCache.h"
 #include "TokenCompletionHints.h"
 
 #ifdef HAVE_PROFILER
@@ -47,6 +49,7 @@
 #include "Geospatial/GDAL.h"
 #include "Geospatial/Transforms.h"
 #include "Geospatial/Types.h"
+#include "ImportExport/GroupCommit.h"
 #include "ImportExport/Importer.h"
 #include "LockMgr/LockMgr.h"
 #include "OSDependent/omnisci_hostname.h"
@@ -59,11 +62,17 @@
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/JoinFilterPushDown.h"
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
 #include "QueryEngine/JsonAccessors.h"
+#include "QueryEngine/OutputBufferPool.h"
 #include "QueryEngine/QueryDispatchQueue.h"
+#include "QueryEngine/ResultSetSpool.h"
 #include "QueryEngine/TableFunctions/TableFunctionsFactory.h"
 #include "QueryEngine/TableOptimizer.h"
 #include "QueryEngine/ThriftSerializers.h"
+#include "Shared/Compressor.h"
+#include "Shared/HugePages.h"
+#include "Shared/LockContention.h"
 #include "Shared/StringTransform.h"
 #include "Shared/import_helpers.h"
 #include "Shared/mapd_shared_mutex.h"
@@ -92,6 +101,7 @@
 #include <memory>
 #include <random>
 #include <regex>
+#include <set>
 #include <string>
 #include <thread>
 #include <typeinfo>
@@ -172,6 +182,8 @@ SessionMap::iterator DBHandler::get_session_it_unsafe(
 extern std::unique_ptr<std::string> g_libgeos_so_filename;
 #endif
 
+size_t g_cursor_ttl_seconds{300};
+
 DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
                      const std::vector<LeafHostInfo>& string_leaves,
                      const std::string& base_data_path,
@@ -219,7 +231,8 @@ DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
     , system_parameters_(system_parameters)
     , legacy_syntax_(legacy_syntax)
     , dispatch_queue_(
-          std::make_unique<QueryDispatchQueue>(system_parameters.num_executors))
+          std::make_unique<QueryDispatchQueue>(system_parameters.num_executors,
+                                               system_parameters.dispatch_interactive_share))
     , super_user_rights_(false)
     , idle_session_duration_(idle_session_duration * 60)
     , max_session_duration_(max_session_duration * 60)
@@ -389,9 +402,199 @@ DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
     LOG(INFO) << "Overriding default geos library with '" + *g_libgeos_so_filename + "'";
   }
 #endif
-}
 
-DBHandler::~DBHandler() {}
+  metrics_collector_id_ = metrics::Registry::instance().addCollector(
+      [this](std::vector<metrics::Sample>& samples) { collectMetrics(samples); });
+}
+
+DBHandler::~DBHandler() {
+  metrics::Registry::instance().removeCollector(metrics_collector_id_);
+}
+
+void DBHandler::collectMetrics(std::vector<metrics::Sample>& samples) const {
+  for (const auto& class_stats : dispatch_queue_->getQueueStats()) {
+    const metrics::Labels labels{
+        {"priority_class", QueryDispatchQueue::toString(class_stats.priority)}};
+    samples.push_back({"omnisci_dispatch_queue_depth",
+                       "Queries waiting in the dispatch queue.",
+                       "gauge",
+                       labels,
+                       double(class_stats.queue_depth)});
+    samples.push_back({"omnisci_dispatch_queue_dispatched_total",
+                       "Queries dispatched to an executor.",
+                       "counter",
+                       labels,
+                       double(class_stats.dispatched_count)});
+    samples.push_back({"omnisci_dispatch_queue_avg_wait_ms",
+                       "Average time the dispatched queries waited, in milliseconds.",
+                       "gauge",
+                       labels,
+                       double(class_stats.avg_wait_ms)});
+    samples.push_back({"omnisci_dispatch_queue_max_wait_ms",
+                       "Longest time a dispatched query waited, in milliseconds.",
+                       "gauge",
+                       labels,
+                       double(class_stats.max_wait_ms)});
+  }
+  for (const auto& code_cache : Executor::getCodeCacheStatus()) {
+    const metrics::Labels labels{
+        {"executor_id", std::to_string(code_cache.executor_id)},
+        {"device_type",
+         code_cache.device_type == ExecutorDeviceType::GPU ? "GPU" : "CPU"}};
+    samples.push_back({"omnisci_code_cache_entries",
+                       "Compiled queries in the code cache.",
+                       "gauge",
+                       labels,
+                       double(code_cache.stats.num_entries)});
+    samples.push_back({"omnisci_code_cache_resident_bytes",
+                       "Bytes of the compiled queries in the code cache.",
+                       "gauge",
+                       labels,
+                       double(code_cache.stats.resident_bytes)});
+    samples.push_back({"omnisci_code_cache_hits_total",
+                       "Compilations served by the code cache.",
+                       "counter",
+                       labels,
+                       double(code_cache.stats.hits)});
+    samples.push_back({"omnisci_code_cache_misses_total",
+                       "Compilations not found in the code cache.",
+                       "counter",
+                       labels,
+                       double(code_cache.stats.misses)});
+    samples.push_back({"omnisci_code_cache_evictions_total",
+                       "Compiled queries evicted from the code cache.",
+                       "counter",
+                       labels,
+                       double(code_cache.stats.evictions)});
+  }
+  for (const auto& [table_key, stats] : HashTableCacheBase::getStats()) {
+    const metrics::Labels labels{{"db_id", std::to_string(table_key.first)},
+                                 {"table_id", std::to_string(table_key.second)}};
+    samples.push_back({"omnisci_join_hash_table_cache_entries",
+                       "Join hash tables cached for the table.",
+                       "gauge",
+                       labels,
+                       double(stats.num_entries)});
+    samples.push_back({"omnisci_join_hash_table_cache_resident_bytes",
+                       "Bytes of the join hash tables cached for the table.",
+                       "gauge",
+                       labels,
+                       double(stats.resident_bytes)});
+    samples.push_back({"omnisci_join_hash_table_cache_builds_total",
+                       "Join hash tables built for the table.",
+                       "counter",
+                       labels,
+                       double(stats.builds)});
+    samples.push_back({"omnisci_join_hash_table_cache_hits_total",
+                       "Join hash tables of the table served by the cache.",
+                       "counter",
+                       labels,
+                       double(stats.hits)});
+    samples.push_back({"omnisci_join_hash_table_cache_evictions_total",
+                       "Join hash tables of the table evicted from the cache.",
+                       "counter",
+                       labels,
+                       double(stats.evictions)});
+  }
+  if (g_enable_output_buffer_pool) {
+    const auto pool_stats = OutputBufferPool::instance().getStats();
+    samples.push_back({"omnisci_output_buffer_pool_idle_bytes",
+                       "Bytes of unused output buffers kept for reuse.",
+                       "gauge",
+                       {},
+                       double(pool_stats.idle_bytes)});
+    samples.push_back({"omnisci_output_buffer_pool_hits_total",
+                       "Output buffers reused from the pool.",
+                       "counter",
+                       {},
+                       double(pool_stats.hits)});
+    samples.push_back({"omnisci_output_buffer_pool_misses_total",
+                       "Output buffers allocated because none was free in the pool.",
+                       "counter",
+                       {},
+                       double(pool_stats.misses)});
+  }
+  if (g_enable_result_spooling) {
+    samples.push_back({"omnisci_result_spool_bytes",
+                       "Bytes of the results kept for clients spooled to disk.",
+                       "gauge",
+                       {},
+                       double(result_set::SpooledBuffer::getSpooledBytes())});
+  }
+  if (huge_pages::get_mode() != huge_pages::Mode::None) {
+    const auto huge_page_stats = huge_pages::get_stats();
+    samples.push_back({"omnisci_huge_page_bytes",
+                       "CPU buffers backed by huge pages.",
+                       "gauge",
+                       {{"mode", "transparent"}},
+                       double(huge_page_stats.transparent_bytes)});
+    samples.push_back({"omnisci_huge_page_bytes",
+                       "CPU buffers backed by huge pages.",
+                       "gauge",
+                       {{"mode", "hugetlb"}},
+                       double(huge_page_stats.hugetlb_bytes)});
+  }
+  if (g_enable_lock_contention_profiling) {
+    for (const auto& stats : lock_contention::get_stats()) {
+      const metrics::Labels labels{{"lock_class", stats.lock_class},
+                                   {"object", stats.object}};
+      samples.push_back({"omnisci_lock_acquisitions_total",
+                         "Acquisitions of the lock.",
+                         "counter",
+                         labels,
+                         double(stats.acquisitions)});
+      samples.push_back({"omnisci_lock_contended_total",
+                         "Acquisitions of the lock which had to wait.",
+                         "counter",
+                         labels,
+                         double(stats.contended)});
+      samples.push_back({"omnisci_lock_wait_ms_total",
+                         "Time spent waiting for the lock, in milliseconds.",
+                         "counter",
+                         labels,
+                         stats.wait_ns / 1e6});
+      samples.push_back({"omnisci_lock_max_wait_ms",
+                         "Longest wait for the lock, in milliseconds.",
+                         "gauge",
+                         labels,
+                         stats.max_wait_ns / 1e6});
+      samples.push_back({"omnisci_lock_avg_hold_ms",
+                         "Average time the lock was held, sampled, in milliseconds.",
+                         "gauge",
+                         labels,
+                         stats.sampled_holds ? stats.hold_ns / 1e6 / stats.sampled_holds
+                                             : 0.});
+      samples.push_back({"omnisci_lock_max_hold_ms",
+                         "Longest sampled time the lock was held, in milliseconds.",
+                         "gauge",
+                         labels,
+                         stats.max_hold_ns / 1e6});
+    }
+  }
+  const auto disk_cache = data_mgr_->getPersistentStorageMgr()->getDiskCache();
+  if (disk_cache) {
+    samples.push_back({"omnisci_foreign_storage_cache_hits_total",
+                       "Chunks of foreign tables served by the disk cache.",
+                       "counter",
+                       {},
+                       double(disk_cache->getNumChunkHits())});
+    samples.push_back({"omnisci_foreign_storage_cache_misses_total",
+                       "Chunks of foreign tables not found in the disk cache.",
+                       "counter",
+                       {},
+                       double(disk_cache->getNumChunkMisses())});
+  }
+  for (const auto& cat : Catalog_Namespace::Catalog::getLoadedCatalogs()) {
+    const auto db_id = std::to_string(cat->getCurrentDB().dbId);
+    for (const auto& [dict_id, dict_size] : cat->getLoadedDictionarySizes()) {
+      samples.push_back({"omnisci_string_dictionary_entries",
+                         "Strings of the dictionaries loaded in memory.",
+                         "gauge",
+                         {{"db_id", db_id}, {"dict_id", std::to_string(dict_id)}},
+                         double(dict_size)});
+    }
+  }
+}
 
 void DBHandler::parser_with_error_handler(
     const std::string& query_str,
@@ -598,6 +801,20 @@ void DBHandler::disconnect_impl(const SessionMap::iterator& session_it,
   sessions_.erase(session_it);
   write_lock.unlock();
 
+  {
+    std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+    for (auto it = cursors_.begin(); it != cursors_.end();) {
+      it = it->second->session_id == session_id ? cursors_.erase(it) : std::next(it);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> statements_lock(prepared_statements_mutex_);
+    for (auto it = prepared_statements_.begin(); it != prepared_statements_.end();) {
+      it = it->second.session_id == session_id ? prepared_statements_.erase(it)
+                                               : std::next(it);
+    }
+  }
+
   if (render_handler_) {
     render_handler_->disconnect(session_id);
   }
@@ -692,6 +909,43 @@ void DBHandler::get_server_status(TServerStatus& _return, const TSessionId& sess
   _return.start_time = start_time_;
   _return.edition = MAPD_EDITION;
   _return.host_name = omnisci::get_hostname();
+  CHECK(dispatch_queue_);
+  for (const auto& class_stats : dispatch_queue_->getQueueStats()) {
+    TDispatchQueueStatus queue_status;
+    queue_status.priority_class = QueryDispatchQueue::toString(class_stats.priority);
+    queue_status.queue_depth = class_stats.queue_depth;
+    queue_status.dispatched_count = class_stats.dispatched_count;
+    queue_status.avg_wait_ms = class_stats.avg_wait_ms;
+    queue_status.max_wait_ms = class_stats.max_wait_ms;
+    _return.dispatch_queue_status.push_back(queue_status);
+  }
+  for (const auto& code_cache : Executor::getCodeCacheStatus()) {
+    TCodeCacheStatus code_cache_status;
+    code_cache_status.executor_id = code_cache.executor_id;
+    code_cache_status.device_type = code_cache.device_type == ExecutorDeviceType::GPU
+                                        ? TDeviceType::GPU
+                                        : TDeviceType::CPU;
+    code_cache_status.num_entries = code_cache.stats.num_entries;
+    code_cache_status.resident_bytes = code_cache.stats.resident_bytes;
+    code_cache_status.max_bytes = code_cache.stats.max_bytes;
+    code_cache_status.hits = code_cache.stats.hits;
+    code_cache_status.misses = code_cache.stats.misses;
+    code_cache_status.evictions = code_cache.stats.evictions;
+    _return.code_cache_status.push_back(code_cache_status);
+  }
+  for (const auto& kv : HashTableCacheBase::getStats()) {
+    TJoinHashTableCacheStatus hash_table_cache_status;
+    hash_table_cache_status.db_id = kv.first.first;
+    hash_table_cache_status.table_id = kv.first.second;
+    hash_table_cache_status.num_entries = kv.second.num_entries;
+    hash_table_cache_status.resident_bytes = kv.second.resident_bytes;
+    hash_table_cache_status.builds = kv.second.builds;
+    hash_table_cache_status.hits = kv.second.hits;
+    hash_table_cache_status.evictions = kv.second.evictions;
+    hash_table_cache_status.build_time_ms = kv.second.build_time_ms;
+    hash_table_cache_status.build_time_saved_ms = kv.second.build_time_saved_ms;
+    _return.join_hash_table_cache_status.push_back(hash_table_cache_status);
+  }
 }
 
 void DBHandler::get_status(std::vector<TServerStatus>& _return,
@@ -987,6 +1241,31 @@ TDatum DBHandler::value_to_thrift(const TargetValue& tv, const SQLTypeInfo& ti)
   return datum;
 }
 
+namespace {
+
+void add_query_history_entry(const query_state::QueryState& query_state,
+                             const int64_t execution_time_ms,
+                             const int64_t total_time_ms,
+                             const std::string& error) {
+  if (!g_query_history_size) {
+    return;
+  }
+  QueryHistoryEntry entry;
+  entry.submitted = std::time(nullptr) - total_time_ms / 1000;
+  if (const auto& session_data = query_state.getSessionData()) {
+    entry.db_name = session_data->db_name;
+    entry.user_name = session_data->user_name;
+  }
+  entry.query_str = query_state.getQueryStr();
+  entry.resource_usage = query_state.getResourceUsage();
+  entry.execution_time_ms = execution_time_ms;
+  entry.total_time_ms = total_time_ms;
+  entry.error = error;
+  QueryHistory::add(std::move(entry));
+}
+
+}  // namespace
+
 void DBHandler::sql_execute(TQueryResult& _return,
                             const TSessionId& session,
                             const std::string& query_str,
@@ -1075,9 +1354,17 @@ void DBHandler::sql_execute(TQueryResult& _return,
         _return.execution_time_ms,
         "total_time_ms",  // BE-3420 - Redundant with duration field
         stdlog.duration<std::chrono::milliseconds>());
+    add_query_history_entry(*query_state,
+                            _return.execution_time_ms,
+                            stdlog.duration<std::chrono::milliseconds>(),
+                            "");
     VLOG(1) << "Table Schema Locks:\n" << lockmgr::TableSchemaLockMgr::instance();
     VLOG(1) << "Table Data Locks:\n" << lockmgr::TableDataLockMgr::instance();
   } catch (const std::exception& e) {
+    add_query_history_entry(*query_state,
+                            _return.execution_time_ms,
+                            stdlog.duration<std::chrono::milliseconds>(),
+                            e.what());
     if (strstr(e.what(), "java.lang.NullPointerException")) {
       THROW_MAPD_EXCEPTION(std::string("Exception: ") +
                            "query failed from broken view or other schema related issue");
@@ -1092,6 +1379,198 @@ void DBHandler::sql_execute(TQueryResult& _return,
   }
 }
 
+namespace {
+
+size_t row_set_row_count(const TRowSet& row_set) {
+  if (!row_set.is_columnar) {
+    return row_set.rows.size();
+  }
+  if (!row_set.compressed_columns.empty()) {
+    return row_set.compressed_columns.front().row_count;
+  }
+  return row_set.columns.empty() ? 0 : row_set.columns.front().nulls.size();
+}
+
+}  // namespace
+
+void DBHandler::sql_execute_cursor(TQueryResult& _return,
+                                   const TSessionId& session,
+                                   const std::string& query_str,
+                                   const bool column_format,
+                                   const std::string& nonce,
+                                   const int32_t first_n) {
+  auto session_ptr = get_session_ptr(session);
+  auto query_state = create_query_state(session_ptr, query_str);
+  auto stdlog = STDLOG(session_ptr, query_state);
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  stdlog.appendNameValuePairs("nonce", nonce);
+
+  if (first_n < 0) {
+    THROW_MAPD_EXCEPTION("The number of rows to return first must be set");
+  }
+  if (leaf_aggregator_.leafCount() > 0) {
+    THROW_MAPD_EXCEPTION("Cursors are not supported in distributed mode");
+  }
+  ParserWrapper pw{strip(query_str)};
+  if (pw.getQueryType() != ParserWrapper::QueryType::Read) {
+    THROW_MAPD_EXCEPTION("Cursors can only be opened on SELECT queries");
+  }
+  auto cursor = std::make_unique<QueryCursor>();
+  try {
+    _return.total_time_ms = measure<>::execution([&]() {
+      sql_execute_impl(_return,
+                       query_state->createQueryStateProxy(),
+                       column_format,
+                       nonce,
+                       session_ptr->get_executor_device_type(),
+                       first_n,
+                       -1,
+                       cursor.get());
+    });
+  } catch (const std::exception& e) {
+    THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+  }
+  stdlog.appendNameValuePairs("execution_time_ms", _return.execution_time_ms);
+  if (cursor->rows) {
+    cursor->session_id = session;
+    cursor->query_str = query_str;
+    cursor->fetched_count = row_set_row_count(_return.row_set);
+    keep_cursor(_return, "", std::move(cursor));
+  }
+}
+
+void DBHandler::fetch_cursor(TQueryResult& _return,
+                             const TSessionId& session,
+                             const std::string& cursor_id,
+                             const int32_t n) {
+  auto session_ptr = get_session_ptr(session);
+  auto stdlog = STDLOG(session_ptr, "cursor_id", cursor_id);
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+
+  if (n < 0) {
+    THROW_MAPD_EXCEPTION("The number of rows to fetch can't be negative");
+  }
+  auto cursor = take_cursor(session, cursor_id);
+  auto query_state = create_query_state(session_ptr, cursor->query_str);
+  _return.query_type = TQueryType::READ;
+  try {
+    _return.total_time_ms = measure<>::execution([&]() {
+      convert_rows(_return,
+                   query_state->createQueryStateProxy(),
+                   cursor->targets,
+                   *cursor->rows,
+                   cursor->column_format,
+                   n,
+                   -1);
+    });
+  } catch (const std::exception& e) {
+    THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+  }
+  cursor->fetched_count += row_set_row_count(_return.row_set);
+  keep_cursor(_return, cursor_id, std::move(cursor));
+}
+
+void DBHandler::close_cursor(const TSessionId& session, const std::string& cursor_id) {
+  auto stdlog = STDLOG(get_session_ptr(session), "cursor_id", cursor_id);
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  take_cursor(session, cursor_id);
+}
+
+std::unique_ptr<DBHandler::QueryCursor> DBHandler::take_cursor(
+    const TSessionId& session,
+    const std::string& cursor_id) {
+  std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+  expire_cursors_unsafe();
+  // a cursor being fetched from is not in cursors_ either
+  const auto it = cursors_.find(cursor_id);
+  if (it == cursors_.end() || it->second->session_id != session) {
+    THROW_MAPD_EXCEPTION("Cursor " + cursor_id + " does not exist or is in use");
+  }
+  auto cursor = std::move(it->second);
+  cursors_.erase(it);
+  return cursor;
+}
+
+void DBHandler::keep_cursor(TQueryResult& _return,
+                            std::string cursor_id,
+                            std::unique_ptr<QueryCursor> cursor) {
+  if (cursor->fetched_count >= cursor->row_count) {
+    return;
+  }
+  // the rows may wait long for the client, keep them off the memory of the server
+  cursor->rows->spoolToDisk();
+  std::lock_guard<std::mutex> cursors_lock(cursors_mutex_);
+  expire_cursors_unsafe();
+  while (cursor_id.empty() || cursors_.count(cursor_id)) {
+    cursor_id = generate_random_string(32);
+  }
+  cursor->last_used = std::chrono::steady_clock::now();
+  cursors_.emplace(cursor_id, std::move(cursor));
+  _return.__set_cursor_id(cursor_id);
+}
+
+void DBHandler::expire_cursors_unsafe() {
+  const auto expired_before =
+      std::chrono::steady_clock::now() - std::chrono::seconds(g_cursor_ttl_seconds);
+  for (auto it = cursors_.begin(); it != cursors_.end();) {
+    it = it->second->last_used < expired_before ? cursors_.erase(it) : std::next(it);
+  }
+}
+
+void DBHandler::prepare_statement(TPreparedStatement& _return,
+                                  const TSessionId& session,
+                                  const std::string& query) {
+  auto stdlog = STDLOG(get_session_ptr(session));
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  auto statement = std::make_shared<const PreparedStatement>(query);
+  std::lock_guard<std::mutex> statements_lock(prepared_statements_mutex_);
+  std::string statement_id;
+  while (statement_id.empty() || prepared_statements_.count(statement_id)) {
+    statement_id = generate_random_string(32);
+  }
+  prepared_statements_.emplace(statement_id, SessionStatement{session, statement});
+  _return.statement_id = statement_id;
+  _return.param_count = statement->getParamCount();
+}
+
+void DBHandler::execute_prepared(TQueryResult& _return,
+                                 const TSessionId& session,
+                                 const std::string& statement_id,
+                                 const std::vector<TQueryParam>& params,
+                                 const bool column_format,
+                                 const std::string& nonce,
+                                 const int32_t first_n,
+                                 const int32_t at_most_n) {
+  std::shared_ptr<const PreparedStatement> statement;
+  {
+    std::lock_guard<std::mutex> statements_lock(prepared_statements_mutex_);
+    const auto it = prepared_statements_.find(statement_id);
+    if (it == prepared_statements_.end() || it->second.session_id != session) {
+      THROW_MAPD_EXCEPTION("Prepared statement " + statement_id + " does not exist");
+    }
+    statement = it->second.statement;
+  }
+  std::string query_str;
+  try {
+    query_str = statement->bind(params);
+  } catch (const std::exception& e) {
+    THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+  }
+  sql_execute(_return, session, query_str, column_format, nonce, first_n, at_most_n);
+}
+
+void DBHandler::close_prepared(const TSessionId& session,
+                               const std::string& statement_id) {
+  auto stdlog = STDLOG(get_session_ptr(session), "statement_id", statement_id);
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  std::lock_guard<std::mutex> statements_lock(prepared_statements_mutex_);
+  const auto it = prepared_statements_.find(statement_id);
+  if (it == prepared_statements_.end() || it->second.session_id != session) {
+    THROW_MAPD_EXCEPTION("Prepared statement " + statement_id + " does not exist");
+  }
+  prepared_statements_.erase(it);
+}
+
 void DBHandler::sql_execute_df(TDataFrame& _return,
                                const TSessionId& session,
                                const std::string& query_str,
@@ -1099,10 +1578,30 @@ void DBHandler::sql_execute_df(TDataFrame& _return,
                                const int32_t device_id,
                                const int32_t first_n,
                                const TArrowTransport::type transport_method) {
+  std::vector<TDataFrame> data_frames;
+  sql_execute_df_impl(data_frames,
+                      session,
+                      query_str,
+                      device_type,
+                      {device_id},
+                      first_n,
+                      transport_method);
+  CHECK_EQ(data_frames.size(), size_t(1));
+  _return = std::move(data_frames.front());
+}
+
+void DBHandler::sql_execute_df_impl(std::vector<TDataFrame>& _return,
+                                    const TSessionId& session,
+                                    const std::string& query_str,
+                                    const TDeviceType::type device_type,
+                                    const std::vector<int32_t>& device_ids,
+                                    const int32_t first_n,
+                                    const TArrowTransport::type transport_method) {
   auto session_ptr = get_session_ptr(session);
   auto query_state = create_query_state(session_ptr, query_str);
   auto stdlog = STDLOG(session_ptr, query_state);
 
+  CHECK(!device_ids.empty());
   if (device_type == TDeviceType::GPU) {
     const auto executor_device_type = session_ptr->get_executor_device_type();
     if (executor_device_type != ExecutorDeviceType::GPU) {
@@ -1112,12 +1611,14 @@ void DBHandler::sql_execute_df(TDataFrame& _return,
     if (!data_mgr_->gpusPresent()) {
       THROW_MAPD_EXCEPTION(std::string("Exception: no GPU is available in this server"));
     }
-    if (device_id < 0 || device_id >= data_mgr_->getCudaMgr()->getDeviceCount()) {
-      THROW_MAPD_EXCEPTION(
-          std::string("Exception: invalid device_id or unavailable GPU with this ID"));
+    for (const auto device_id : device_ids) {
+      if (device_id < 0 || device_id >= data_mgr_->getCudaMgr()->getDeviceCount()) {
+        THROW_MAPD_EXCEPTION(
+            std::string("Exception: invalid device_id or unavailable GPU with this ID"));
+      }
     }
   }
-  _return.execution_time_ms = 0;
+  int64_t execution_time_ms{0};
 
   mapd_shared_lock<mapd_shared_mutex> executeReadLock(
       *legacylockmgr::LockMgr<mapd_shared_mutex, bool>::getMutex(
@@ -1129,7 +1630,7 @@ void DBHandler::sql_execute_df(TDataFrame& _return,
         !(pw.getExplainType() == ParserWrapper::ExplainType::Other)) {
       std::string query_ra;
       lockmgr::LockedTableDescriptors locks;
-      _return.execution_time_ms += measure<>::execution([&]() {
+      execution_time_ms += measure<>::execution([&]() {
         TPlanResult result;
         std::tie(result, locks) = parse_to_ra(query_state->createQueryStateProxy(),
                                               query_str,
@@ -1148,9 +1649,12 @@ void DBHandler::sql_execute_df(TDataFrame& _return,
                          *session_ptr,
                          device_type == TDeviceType::CPU ? ExecutorDeviceType::CPU
                                                          : ExecutorDeviceType::GPU,
-                         static_cast<size_t>(device_id),
+                         device_ids,
                          first_n,
                          transport_method);
+      for (auto& data_frame : _return) {
+        data_frame.execution_time_ms += execution_time_ms;
+      }
       return;
     }
   } catch (std::exception& e) {
@@ -1175,6 +1679,28 @@ void DBHandler::sql_execute_gdf(TDataFrame& _return,
                  TArrowTransport::SHARED_MEMORY);
 }
 
+void DBHandler::sql_execute_gdf_partitioned(std::vector<TDataFrame>& _return,
+                                            const TSessionId& session,
+                                            const std::string& query_str,
+                                            const std::vector<int32_t>& device_ids,
+                                            const int32_t first_n) {
+  auto stdlog = STDLOG(get_session_ptr(session));
+  if (device_ids.empty()) {
+    THROW_MAPD_EXCEPTION("Exception: no device to partition the result across");
+  }
+  if (std::set<int32_t>(device_ids.begin(), device_ids.end()).size() !=
+      device_ids.size()) {
+    THROW_MAPD_EXCEPTION("Exception: a device can only hold one partition");
+  }
+  sql_execute_df_impl(_return,
+                      session,
+                      query_str,
+                      TDeviceType::GPU,
+                      device_ids,
+                      first_n,
+                      TArrowTransport::SHARED_MEMORY);
+}
+
 // For now we have only one user of a data frame in all cases.
 void DBHandler::deallocate_df(const TSessionId& session,
                               const TDataFrame& df,
@@ -1466,7 +1992,9 @@ TQueryResult DBHandler::validate_rel_alg(const std::string& query_ra,
                         executor_index);
       });
   CHECK(dispatch_queue_);
-  dispatch_queue_->submit(execute_rel_alg_task, /*is_update_delete=*/false);
+  dispatch_queue_->submit(execute_rel_alg_task,
+                          /*is_update_delete=*/false,
+                          QueryDispatchQueue::Priority::System);
   auto result_future = execute_rel_alg_task->get_future();
   result_future.get();
   return result;
@@ -2320,6 +2848,16 @@ void DBHandler::get_memory(std::vector<TNodeMemoryInfo>& _return,
       md.is_free = gpu.memStatus == Buffer_Namespace::MemStatus::FREE;
       nodeInfo.node_memory_data.push_back(md);
     }
+    nodeInfo.eviction_policy = memInfo.evictionPolicy;
+    for (const auto& [table_key, counts] : memInfo.tableEvictionCounts) {
+      TTableEvictionCounts table_counts;
+      table_counts.db_id = table_key[CHUNK_KEY_DB_IDX];
+      table_counts.table_id = table_key[CHUNK_KEY_TABLE_IDX];
+      table_counts.num_chunks = counts.num_chunks;
+      table_counts.num_bytes = counts.num_bytes;
+      nodeInfo.table_eviction_counts.push_back(table_counts);
+    }
+    nodeInfo.huge_page_bytes = memInfo.hugePageBytes;
     _return.push_back(nodeInfo);
   }
   if (leaf_aggregator_.leafCount() > 0) {
@@ -2362,6 +2900,15 @@ void DBHandler::set_execution_mode(const TSessionId& session,
   DBHandler::set_execution_mode_nolock(session_it->second.get(), mode);
 }
 
+void DBHandler::set_column_encoding(const TSessionId& session,
+                                    const TColumnEncoding::type encoding) {
+  auto stdlog = STDLOG(get_session_ptr(session));
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  mapd_unique_lock<mapd_shared_mutex> write_lock(sessions_mutex_);
+  auto session_it = get_session_it_unsafe(session, write_lock);
+  session_it->second->set_compressed_columns(encoding == TColumnEncoding::COMPRESSED);
+}
+
 namespace {
 
 void check_table_not_sharded(const TableDescriptor* td) {
@@ -2431,7 +2978,7 @@ void DBHandler::load_table_binary(const TSessionId& session,
     }
     auto insert_data_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(
         session_ptr->getCatalog(), table_name);
-    loader->load(import_buffers, rows.size());
+    load_rows(*loader, import_buffers, rows.size(), std::move(insert_data_lock));
   } catch (const std::exception& e) {
     THROW_MAPD_EXCEPTION("Exception: " + std::string(e.what()));
   }
@@ -2480,6 +3027,19 @@ DBHandler::prepare_columnar_loader(
   return std::move(td_with_lock);
 }
 
+void DBHandler::load_rows(
+    import_export::Loader& loader,
+    const std::vector<std::unique_ptr<import_export::TypedImportBuffer>>& import_buffers,
+    const size_t row_count,
+    lockmgr::WriteLock&& insert_data_lock) {
+  if (g_group_commit_window_ms && !leaf_aggregator_.leafCount()) {
+    import_export::load_with_group_commit(
+        loader, import_buffers, row_count, std::move(insert_data_lock));
+  } else {
+    loader.load(import_buffers, row_count);
+  }
+}
+
 void DBHandler::load_table_binary_columnar(const TSessionId& session,
                                            const std::string& table_name,
                                            const std::vector<TColumn>& cols) {
@@ -2566,7 +3126,7 @@ void DBHandler::load_table_binary_columnar(const TSessionId& session,
         << ". Issue at column : " << (col_idx + 1) << ". Import aborted";
     THROW_MAPD_EXCEPTION(oss.str());
   }
-  loader->load(import_buffers, numRows);
+  load_rows(*loader, import_buffers, numRows, std::move(insert_data_lock));
 }
 
 using RecordBatchVector = std::vector<std::shared_ptr<arrow::RecordBatch>>;
@@ -2657,7 +3217,7 @@ void DBHandler::load_table_binary_arrow(const TSessionId& session,
     // other import paths
     THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
   }
-  loader->load(import_buffers, numRows);
+  load_rows(*loader, import_buffers, numRows, std::move(insert_data_lock));
 }
 
 void DBHandler::load_table(const TSessionId& session,
@@ -2773,7 +3333,7 @@ void DBHandler::load_table(const TSessionId& session,
     }
     auto insert_data_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(
         session_ptr->getCatalog(), table_name);
-    loader->load(import_buffers, rows_completed);
+    load_rows(*loader, import_buffers, rows_completed, std::move(insert_data_lock));
   } catch (const std::exception& e) {
     THROW_MAPD_EXCEPTION("Exception: " + std::string(e.what()));
   }
@@ -4409,6 +4969,8 @@ void DBHandler::import_table_status(TImportStatus& _return,
   _return.rows_completed = is.rows_completed;
   _return.rows_estimated = is.rows_estimated;
   _return.rows_rejected = is.rows_rejected;
+  _return.parse_ms = is.parse_ms;
+  _return.load_ms = is.load_ms;
 }
 
 void DBHandler::get_first_geo_file_in_archive(std::string& _return,
@@ -4725,7 +5287,8 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
     const bool just_validate,
     const bool find_push_down_candidates,
     const ExplainInfo& explain_info,
-    const std::optional<size_t> executor_index) const {
+    const std::optional<size_t> executor_index,
+    QueryCursor* cursor) const {
   query_state::Timer timer = query_state_proxy.createTimer(__func__);
 
   VLOG(1) << "Table Schema Locks:\n" << lockmgr::TableSchemaLockMgr::instance();
@@ -4767,6 +5330,7 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
                          system_parameters_.gpu_input_mem_limit,
                          g_enable_runtime_query_interrupt,
                          g_pending_query_interrupt_freq};
+  eo.profile_steps = explain_info.explain_analyze;
   ExecutionResult result{std::make_shared<ResultSet>(std::vector<TargetInfo>{},
                                                      ExecutorDeviceType::CPU,
                                                      QueryMemoryDescriptor(),
@@ -4778,14 +5342,24 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
   });
   // reduce execution time by the time spent during queue waiting
   _return.execution_time_ms -= result.getRows()->getQueueTime();
+  auto resource_usage = ra_executor.getResourceUsage();
+  resource_usage.plan_hash = std::hash<std::string>{}(query_ra);
+  resource_usage.queue_time_ms = result.getRows()->getQueueTime();
+  query_state_proxy.getQueryState().addResourceUsage(resource_usage);
   VLOG(1) << cat.getDataMgr().getSystemMemoryUsage();
   const auto& filter_push_down_info = result.getPushedDownFilterInfo();
   if (!filter_push_down_info.empty()) {
     return filter_push_down_info;
   }
-  if (explain_info.justExplain()) {
+  if (explain_info.explain_analyze) {
+    convert_explain(_return, ResultSet(ra_executor.getStepProfiles()), column_format);
+  } else if (explain_info.justExplain()) {
     convert_explain(_return, *result.getRows(), column_format);
   } else if (!explain_info.justCalciteExplain()) {
+    if (cursor) {
+      // counting the rows moves the iteration of the result set back to its beginning
+      cursor->row_count = result.getRows()->rowCount();
+    }
     convert_rows(_return,
                  timer.createQueryStateProxy(),
                  result.getTargetsMeta(),
@@ -4793,16 +5367,21 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
                  column_format,
                  first_n,
                  at_most_n);
+    if (cursor) {
+      cursor->targets = result.getTargetsMeta();
+      cursor->rows = result.getRows();
+      cursor->column_format = column_format;
+    }
   }
   return {};
 }
 
-void DBHandler::execute_rel_alg_df(TDataFrame& _return,
+void DBHandler::execute_rel_alg_df(std::vector<TDataFrame>& _return,
                                    const std::string& query_ra,
                                    QueryStateProxy query_state_proxy,
                                    const Catalog_Namespace::SessionInfo& session_info,
                                    const ExecutorDeviceType device_type,
-                                   const size_t device_id,
+                                   const std::vector<int32_t>& device_ids,
                                    const int32_t first_n,
                                    const TArrowTransport::type transport_method) const {
   const auto& cat = session_info.getCatalog();
@@ -4845,35 +5424,45 @@ void DBHandler::execute_rel_alg_df(TDataFrame& _return,
                                                      nullptr,
                                                      nullptr),
                          {}};
-  _return.execution_time_ms += measure<>::execution(
+  int64_t execution_time_ms = measure<>::execution(
       [&]() { result = ra_executor.executeRelAlgQuery(co, eo, false, nullptr); });
-  _return.execution_time_ms -= result.getRows()->getQueueTime();
+  execution_time_ms -= result.getRows()->getQueueTime();
   const auto rs = result.getRows();
   const auto converter =
       std::make_unique<ArrowResultSetConverter>(rs,
                                                 data_mgr_,
                                                 device_type,
-                                                device_id,
+                                                device_ids.front(),
                                                 getTargetNames(result.getTargetsMeta()),
                                                 first_n,
                                                 ArrowTransport(transport_method));
-  ArrowResult arrow_result;
-  _return.arrow_conversion_time_ms +=
-      measure<>::execution([&] { arrow_result = converter->getArrowResult(); });
-  _return.sm_handle =
-      std::string(arrow_result.sm_handle.begin(), arrow_result.sm_handle.end());
-  _return.sm_size = arrow_result.sm_size;
-  _return.df_handle =
-      std::string(arrow_result.df_handle.begin(), arrow_result.df_handle.end());
-  _return.df_buffer =
-      std::string(arrow_result.df_buffer.begin(), arrow_result.df_buffer.end());
-  if (device_type == ExecutorDeviceType::GPU) {
-    std::lock_guard<std::mutex> map_lock(handle_to_dev_ptr_mutex_);
-    CHECK(!ipc_handle_to_dev_ptr_.count(_return.df_handle));
-    ipc_handle_to_dev_ptr_.insert(
-        std::make_pair(_return.df_handle, arrow_result.serialized_cuda_handle));
+  std::vector<ArrowResult> arrow_results;
+  const auto arrow_conversion_time_ms = measure<>::execution([&] {
+    arrow_results = device_ids.size() > 1
+                        ? converter->getArrowPartitions(device_ids)
+                        : std::vector<ArrowResult>{converter->getArrowResult()};
+  });
+  CHECK_EQ(arrow_results.size(), device_ids.size());
+  for (const auto& arrow_result : arrow_results) {
+    TDataFrame data_frame;
+    data_frame.execution_time_ms = execution_time_ms;
+    data_frame.arrow_conversion_time_ms = arrow_conversion_time_ms;
+    data_frame.sm_handle =
+        std::string(arrow_result.sm_handle.begin(), arrow_result.sm_handle.end());
+    data_frame.sm_size = arrow_result.sm_size;
+    data_frame.df_handle =
+        std::string(arrow_result.df_handle.begin(), arrow_result.df_handle.end());
+    data_frame.df_buffer =
+        std::string(arrow_result.df_buffer.begin(), arrow_result.df_buffer.end());
+    if (device_type == ExecutorDeviceType::GPU) {
+      std::lock_guard<std::mutex> map_lock(handle_to_dev_ptr_mutex_);
+      CHECK(!ipc_handle_to_dev_ptr_.count(data_frame.df_handle));
+      ipc_handle_to_dev_ptr_.insert(
+          std::make_pair(data_frame.df_handle, arrow_result.serialized_cuda_handle));
+    }
+    data_frame.df_size = arrow_result.df_size;
+    _return.push_back(std::move(data_frame));
   }
-  _return.df_size = arrow_result.df_size;
 }
 
 std::vector<TargetMetaInfo> DBHandler::getTargetMetaInfo(
@@ -4907,6 +5496,60 @@ std::vector<std::string> DBHandler::getTargetNames(
   return names;
 }
 
+namespace {
+
+// Packs the values of a column of scalars into a single buffer and compresses it, the
+// layout is described along with TCompressedColumn.
+TCompressedColumn compress_column(const TColumn& column) {
+  const size_t row_count = column.nulls.size();
+  std::string buffer(column.nulls.begin(), column.nulls.end());
+  const auto append = [&buffer](const void* data, const size_t size) {
+    buffer.append(reinterpret_cast<const char*>(data), size);
+  };
+  if (!column.data.int_col.empty()) {
+    CHECK_EQ(column.data.int_col.size(), row_count);
+    append(column.data.int_col.data(), row_count * sizeof(int64_t));
+  } else if (!column.data.real_col.empty()) {
+    CHECK_EQ(column.data.real_col.size(), row_count);
+    append(column.data.real_col.data(), row_count * sizeof(double));
+  } else if (!column.data.str_col.empty()) {
+    CHECK_EQ(column.data.str_col.size(), row_count);
+    std::vector<int64_t> offsets{0};
+    offsets.reserve(row_count + 1);
+    for (const auto& str : column.data.str_col) {
+      offsets.push_back(offsets.back() + str.size());
+    }
+    append(offsets.data(), offsets.size() * sizeof(int64_t));
+    for (const auto& str : column.data.str_col) {
+      buffer.append(str);
+    }
+  }
+
+  TCompressedColumn compressed_column;
+  compressed_column.data_size = buffer.size();
+  compressed_column.row_count = row_count;
+  auto compressor = BloscCompressor::getCompressor();
+  std::string compressed(compressor->getScratchSpaceSize(buffer.size()), 0);
+  int64_t compressed_size{0};
+  try {
+    compressed_size = compressor->compress(reinterpret_cast<const uint8_t*>(buffer.data()),
+                                           buffer.size(),
+                                           reinterpret_cast<uint8_t*>(&compressed[0]),
+                                           compressed.size(),
+                                           0);
+  } catch (const CompressionFailedError&) {
+  }
+  if (compressed_size > 0 && static_cast<size_t>(compressed_size) < buffer.size()) {
+    compressed.resize(compressed_size);
+    compressed_column.data = std::move(compressed);
+  } else {
+    compressed_column.data = std::move(buffer);
+  }
+  return compressed_column;
+}
+
+}  // namespace
+
 void DBHandler::convert_rows(TQueryResult& _return,
                              QueryStateProxy query_state_proxy,
                              const std::vector<TargetMetaInfo>& targets,
@@ -4935,8 +5578,25 @@ void DBHandler::convert_rows(TQueryResult& _return,
         value_to_thrift_column(agg_result, targets[i].get_type_info(), tcolumns[i]);
       }
     }
-    for (size_t i = 0; i < results.colCount(); ++i) {
-      _return.row_set.columns.push_back(tcolumns[i]);
+    const auto session_info = query_state_proxy.getQueryState().getConstSessionInfo();
+    const bool compress_columns =
+        session_info && session_info->get_compressed_columns() &&
+        std::none_of(targets.begin(), targets.end(), [](const TargetMetaInfo& target) {
+          return target.get_type_info().is_array() ||
+                 target.get_type_info().is_geometry();
+        });
+    if (compress_columns) {
+      std::vector<TCompressedColumn> compressed_columns;
+      compressed_columns.reserve(tcolumns.size());
+      for (auto& tcolumn : tcolumns) {
+        compressed_columns.push_back(compress_column(tcolumn));
+        tcolumn = TColumn();
+      }
+      _return.row_set.__set_compressed_columns(compressed_columns);
+    } else {
+      for (size_t i = 0; i < results.colCount(); ++i) {
+        _return.row_set.columns.push_back(tcolumns[i]);
+      }
     }
   } else {
     _return.row_set.is_columnar = false;
@@ -5065,13 +5725,60 @@ void DBHandler::check_and_invalidate_sessions(Parser::DDLStmt* ddl) {
   }
 }
 
+namespace {
+
+// Key of the row set of a read query in the QueryResultCache, empty if the row set can't
+// be cached: the query reads tables whose epochs don't track their contents or calls
+// functions of the current time.
+std::string query_result_cache_key(const Catalog_Namespace::SessionInfo& session_info,
+                                   const lockmgr::LockedTableDescriptors& locks,
+                                   const std::string& query_ra,
+                                   const bool column_format,
+                                   const ExecutorDeviceType executor_device_type,
+                                   const int32_t first_n,
+                                   const int32_t at_most_n) {
+  if (!g_query_result_cache_max_bytes || g_cluster || locks.empty()) {
+    return "";
+  }
+  const auto query_ra_upper = to_upper(query_ra);
+  if (query_ra_upper.find("NOW") != std::string::npos ||
+      query_ra_upper.find("CURRENT_") != std::string::npos) {
+    return "";
+  }
+  const auto& cat = session_info.getCatalog();
+  const auto db_id = cat.getCurrentDB().dbId;
+  std::string key = std::to_string(db_id) + ":" +
+                    session_info.get_currentUser().userName + ":" +
+                    std::to_string(column_format) + ":" +
+                    std::to_string(static_cast<int>(executor_device_type)) + ":" +
+                    std::to_string(first_n) + ":" + std::to_string(at_most_n) + ":" +
+                    std::to_string(session_info.get_compressed_columns()) + ":";
+  for (const auto& lock : locks) {
+    const auto td = (*lock)();
+    CHECK(td);
+    if (td->isView || table_is_temporary(td) ||
+        td->storageType == StorageType::FOREIGN_TABLE) {
+      return "";
+    }
+    for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+      key += std::to_string(physical_td->tableId) + "@" +
+             std::to_string(cat.getDataMgr().getTableEpoch(db_id, physical_td->tableId)) +
+             ",";
+    }
+  }
+  return key + ":" + query_ra;
+}
+
+}  // namespace
+
 void DBHandler::sql_execute_impl(TQueryResult& _return,
                                  QueryStateProxy query_state_proxy,
                                  const bool column_format,
                                  const std::string& nonce,
                                  const ExecutorDeviceType executor_device_type,
                                  const int32_t first_n,
-                                 const int32_t at_most_n) {
+                                 const int32_t at_most_n,
+                                 QueryCursor* cursor) {
   if (leaf_handler_) {
     leaf_handler_->flush_queue();
   }
@@ -5117,6 +5824,15 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
       break;
     }
   }
+  if (pw.getQueryType() != ParserWrapper::QueryType::Read) {
+    // writes which don't move the epochs of the tables forward may be running
+    QueryResultCache::instance().clear();
+  }
+  ScopeGuard clear_query_result_cache = [&pw] {
+    if (pw.getQueryType() != ParserWrapper::QueryType::Read) {
+      QueryResultCache::instance().clear();
+    }
+  };
   if (pw.isCalcitePathPermissable(read_only_)) {
     // run DDL before the locks as DDL statements should handle their own locking
     if (pw.isCalciteDdl()) {
@@ -5171,10 +5887,30 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
          &query_ra,
          &query_str,
          &locks,
+         &session_ptr,
+         cursor,
          column_format,
          executor_device_type,
          first_n,
          at_most_n](const size_t executor_index) {
+          // a cached row set has no result set for a cursor to fetch the rest of
+          const auto cache_key =
+              cursor || explain_info.justExplain() ||
+                      explain_info.justCalciteExplain() || explain_info.explain_analyze
+                  ? std::string()
+                  : query_result_cache_key(*session_ptr,
+                                           locks,
+                                           query_ra,
+                                           column_format,
+                                           executor_device_type,
+                                           first_n,
+                                           at_most_n);
+          auto& query_result_cache = QueryResultCache::instance();
+          const auto cache_generation = query_result_cache.getGeneration();
+          if (!cache_key.empty() && query_result_cache.get(cache_key, _return.row_set)) {
+            VLOG(1) << "Returning the cached row set of the query";
+            return;
+          }
           filter_push_down_requests = execute_rel_alg(
               _return,
               query_state_proxy,
@@ -5184,9 +5920,10 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
               first_n,
               at_most_n,
               /*just_validate=*/false,
-              g_enable_filter_push_down && !g_cluster,
+              g_enable_filter_push_down && !g_cluster && !explain_info.explain_analyze,
               explain_info,
-              executor_index);
+              executor_index,
+              cursor);
           if (explain_info.justCalciteExplain() && filter_push_down_requests.empty()) {
             // we only reach here if filter push down was enabled, but no filter
             // push down candidate was found
@@ -5202,7 +5939,8 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
                                                   at_most_n,
                                                   explain_info.justExplain(),
                                                   explain_info.justCalciteExplain(),
-                                                  filter_push_down_requests);
+                                                  filter_push_down_requests,
+                                                  cursor);
           } else if (explain_info.justCalciteExplain() &&
                      filter_push_down_requests.empty()) {
             // return the ra as the result:
@@ -5215,15 +5953,26 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
                     .first.plan_result;
             convert_explain(_return, ResultSet(query_ra), true);
           }
+          if (!cache_key.empty()) {
+            query_result_cache.put(cache_key, _return.row_set, cache_generation);
+          }
         });
+    const bool is_update_delete = pw.getDMLType() == ParserWrapper::DMLType::Update ||
+                                  pw.getDMLType() == ParserWrapper::DMLType::Delete;
+    const auto priority = explain_info.justExplain() || explain_info.justCalciteExplain()
+                              ? QueryDispatchQueue::Priority::System
+                              : pw.getQueryType() == ParserWrapper::QueryType::Read
+                                    ? QueryDispatchQueue::Priority::Interactive
+                                    : QueryDispatchQueue::Priority::Batch;
     CHECK(dispatch_queue_);
     dispatch_queue_->submit(execute_rel_alg_task,
-                            pw.getDMLType() == ParserWrapper::DMLType::Update ||
-                                pw.getDMLType() == ParserWrapper::DMLType::Delete);
+                            is_update_delete,
+                            priority,
+                            session_ptr->get_currentUser().userName);
     auto result_future = execute_rel_alg_task->get_future();
     result_future.get();
     return;
-  } else if (pw.is_optimize || pw.is_validate) {
+  } else if (pw.is_optimize || pw.is_analyze || pw.is_validate) {
     // Get the Stmt object
     DBHandler::parser_with_error_handler(query_str, parse_trees);
 
@@ -5257,11 +6006,48 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
         if (optimize_stmt->shouldVacuumDeletedRows()) {
           optimizer.vacuumDeletedRows();
         }
+        if (optimize_stmt->shouldCompactDictionaries()) {
+          optimizer.compactDictionaries();
+        }
         optimizer.recomputeMetadata();
       });
 
       return;
     }
+    if (pw.is_analyze) {
+      const auto analyze_stmt =
+          dynamic_cast<Parser::AnalyzeTableStmt*>(parse_trees.front().get());
+      CHECK(analyze_stmt);
+
+      _return.execution_time_ms += measure<>::execution([&]() {
+        const auto td_with_lock =
+            lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+                cat, analyze_stmt->getTableName());
+        const auto td = td_with_lock();
+
+        if (!td || !user_can_access_table(
+                       *session_ptr, td, AccessPrivileges::SELECT_FROM_TABLE)) {
+          throw std::runtime_error("Table " + analyze_stmt->getTableName() +
+                                   " does not exist.");
+        }
+        if (td->isView || table_is_temporary(td) ||
+            td->storageType == StorageType::FOREIGN_TABLE) {
+          throw std::runtime_error(
+              "ANALYZE TABLE command is only supported on physical tables.");
+        }
+
+        // the statistics are updated by inserts and dropped by updates
+        auto data_lock =
+            lockmgr::TableDataLockMgr::getWriteLockForTable(cat, td->tableName);
+
+        auto executor = Executor::getExecutor(
+            Executor::UNITARY_EXECUTOR_ID, "", "", system_parameters_);
+        const TableOptimizer optimizer(td, executor.get(), cat);
+        cat.setColumnStatistics(td->tableId, optimizer.computeColumnStatistics());
+      });
+
+      return;
+    }
     if (pw.is_validate) {
       // check user is superuser
       if (!session_ptr->get_currentUser().isSuper) {
@@ -5389,7 +6175,8 @@ void DBHandler::execute_rel_alg_with_filter_push_down(
     const int32_t at_most_n,
     const bool just_explain,
     const bool just_calcite_explain,
-    const std::vector<PushedDownFilterInfo>& filter_push_down_requests) {
+    const std::vector<PushedDownFilterInfo>& filter_push_down_requests,
+    QueryCursor* cursor) {
   // collecting the selected filters' info to be sent to Calcite:
   std::vector<TFilterPushDownInfo> filter_push_down_info;
   for (const auto& req : filter_push_down_requests) {
@@ -5427,7 +6214,9 @@ void DBHandler::execute_rel_alg_with_filter_push_down(
                   at_most_n,
                   /*just_validate=*/false,
                   /*find_push_down_candidates=*/false,
-                  explain_info);
+                  explain_info,
+                  std::nullopt,
+                  cursor);
 }
 
 void DBHandler::execute_distributed_copy_statement(
@@ -5771,6 +6560,7 @@ void DBHandler::set_table_epoch(const TSessionId& session,
     throw std::runtime_error("Only superuser can set_table_epoch");
   }
   auto& cat = session_ptr->getCatalog();
+  QueryResultCache::instance().clear();
 
   if (leaf_aggregator_.leafCount() > 0) {
     return leaf_aggregator_.set_table_epochLeaf(*session_ptr, db_id, table_id, new_epoch);
@@ -5789,6 +6579,7 @@ void DBHandler::set_table_epoch_by_name(const TSessionId& session,
     throw std::runtime_error("Only superuser can set_table_epoch");
   }
   auto& cat = session_ptr->getCatalog();
+  QueryResultCache::instance().clear();
   auto td = cat.getMetadataForTable(
       table_name,
       false);  // don't populate fragmenter on this call since we only want metadata
@@ -5870,6 +6661,7 @@ void DBHandler::set_table_epochs(const TSessionId& session,
       THROW_MAPD_EXCEPTION("Only super users can set table epochs");
     }
   }
+  QueryResultCache::instance().clear();
   std::vector<Catalog_Namespace::TableEpochInfo> table_epochs_vector;
   for (const auto& table_epoch : table_epochs) {
     table_epochs_vector.emplace_back(
@@ -6025,6 +6817,9 @@ table_functions::OutputBufferSizeType mapfrom(const TOutputBufferSizeType::type&
       return table_functions::OutputBufferSizeType::kUserSpecifiedConstantParameter;
     case TOutputBufferSizeType::kUserSpecifiedRowMultiplier:
       return table_functions::OutputBufferSizeType::kUserSpecifiedRowMultiplier;
+    case TOutputBufferSizeType::kUserSpecifiedPartitionedRowMultiplier:
+      return table_functions::OutputBufferSizeType::
+          kUserSpecifiedPartitionedRowMultiplier;
   }
   UNREACHABLE();
   return table_functions::OutputBufferSizeType{};
@@ -6143,6 +6938,173 @@ void DBHandler::getUserSessions(const Catalog_Namespace::SessionInfo& session_in
   }
 }
 
+void DBHandler::getCodeCacheStatus(const Catalog_Namespace::SessionInfo& session_info,
+                                   TQueryResult& _return) {
+  if (!session_info.get_currentUser().isSuper) {
+    throw std::runtime_error(
+        "SHOW CODE CACHE failed, because it can only be executed by super user.");
+  }
+  const std::vector<std::string> col_names{"executor_id",
+                                           "device_type",
+                                           "num_entries",
+                                           "resident_bytes",
+                                           "max_bytes",
+                                           "hits",
+                                           "misses",
+                                           "evictions"};
+
+  // Make columns for TQueryResult
+  TRowDescriptor row_desc;
+  for (const auto& col : col_names) {
+    TColumnType columnType;
+    columnType.col_name = col;
+    columnType.col_type.type = TDatumType::STR;
+    row_desc.push_back(columnType);
+    _return.row_set.columns.emplace_back(TColumn());
+  }
+  _return.row_set.row_desc = row_desc;
+  _return.row_set.is_columnar = true;
+
+  for (const auto& code_cache : Executor::getCodeCacheStatus()) {
+    const std::vector<std::string> row{
+        std::to_string(code_cache.executor_id),
+        code_cache.device_type == ExecutorDeviceType::GPU ? "GPU" : "CPU",
+        std::to_string(code_cache.stats.num_entries),
+        std::to_string(code_cache.stats.resident_bytes),
+        std::to_string(code_cache.stats.max_bytes),
+        std::to_string(code_cache.stats.hits),
+        std::to_string(code_cache.stats.misses),
+        std::to_string(code_cache.stats.evictions)};
+    for (size_t i = 0; i < row.size(); ++i) {
+      _return.row_set.columns[i].data.str_col.emplace_back(row[i]);
+      _return.row_set.columns[i].nulls.push_back(false);
+    }
+  }
+}
+
+void DBHandler::getQueryHistory(const Catalog_Namespace::SessionInfo& session_info,
+                                TQueryResult& _return) {
+  if (!g_query_history_size) {
+    throw std::runtime_error(
+        "SHOW QUERY HISTORY failed, because the query history is disabled.");
+  }
+  const std::vector<std::string> col_names{"submitted",
+                                           "db_name",
+                                           "user_name",
+                                           "query_str",
+                                           "plan_hash",
+                                           "device_type",
+                                           "num_steps",
+                                           "queue_time_ms",
+                                           "compilation_time_ms",
+                                           "execution_time_ms",
+                                           "reduction_time_ms",
+                                           "total_time_ms",
+                                           "cpu_bytes_scanned",
+                                           "gpu_bytes_scanned",
+                                           "peak_cpu_memory_bytes",
+                                           "peak_gpu_memory_bytes",
+                                           "host_memory_bytes",
+                                           "error"};
+
+  // Make columns for TQueryResult
+  TRowDescriptor row_desc;
+  for (const auto& col : col_names) {
+    TColumnType columnType;
+    columnType.col_name = col;
+    columnType.col_type.type = TDatumType::STR;
+    row_desc.push_back(columnType);
+    _return.row_set.columns.emplace_back(TColumn());
+  }
+  _return.row_set.row_desc = row_desc;
+  _return.row_set.is_columnar = true;
+
+  // users other than super users only see their own queries
+  const auto& current_user = session_info.get_currentUser();
+  for (const auto& entry : QueryHistory::getEntries()) {
+    if (!current_user.isSuper && entry.user_name != current_user.userName) {
+      continue;
+    }
+    const auto& usage = entry.resource_usage;
+    std::stringstream tss;
+    tss << std::put_time(std::localtime(&entry.submitted), "%F %T");
+    const std::vector<std::string> row{
+        tss.str(),
+        entry.db_name,
+        entry.user_name,
+        entry.query_str,
+        std::to_string(usage.plan_hash),
+        usage.ran_on_gpu ? "GPU" : "CPU",
+        std::to_string(usage.num_steps),
+        std::to_string(usage.queue_time_ms),
+        std::to_string(usage.compilation_time_ms),
+        std::to_string(entry.execution_time_ms),
+        std::to_string(usage.reduction_time_ms),
+        std::to_string(entry.total_time_ms),
+        std::to_string(usage.cpu_bytes_scanned),
+        std::to_string(usage.gpu_bytes_scanned),
+        std::to_string(usage.peak_cpu_memory_bytes),
+        std::to_string(usage.peak_gpu_memory_bytes),
+        std::to_string(usage.peak_host_memory_bytes),
+        entry.error};
+    for (size_t i = 0; i < row.size(); ++i) {
+      _return.row_set.columns[i].data.str_col.emplace_back(row[i]);
+      _return.row_set.columns[i].nulls.push_back(false);
+    }
+  }
+}
+
+void DBHandler::getLockContention(const Catalog_Namespace::SessionInfo& session_info,
+                                  TQueryResult& _return) {
+  if (!session_info.get_currentUser().isSuper) {
+    throw std::runtime_error(
+        "SHOW LOCK CONTENTION failed, because it can only be executed by super user.");
+  } else if (!g_enable_lock_contention_profiling) {
+    throw std::runtime_error(
+        "SHOW LOCK CONTENTION failed, because lock contention profiling is disabled.");
+  }
+  const std::vector<std::string> col_names{"lock_class",
+                                           "object",
+                                           "acquisitions",
+                                           "contended",
+                                           "total_wait_us",
+                                           "max_wait_us",
+                                           "avg_hold_us",
+                                           "max_hold_us"};
+
+  // Make columns for TQueryResult
+  TRowDescriptor row_desc;
+  for (const auto& col : col_names) {
+    TColumnType columnType;
+    columnType.col_name = col;
+    columnType.col_type.type = TDatumType::STR;
+    row_desc.push_back(columnType);
+    _return.row_set.columns.emplace_back(TColumn());
+  }
+  _return.row_set.row_desc = row_desc;
+  _return.row_set.is_columnar = true;
+
+  for (const auto& stats : lock_contention::get_stats()) {
+    if (!stats.acquisitions) {
+      continue;
+    }
+    const std::vector<std::string> row{
+        stats.lock_class,
+        stats.object,
+        std::to_string(stats.acquisitions),
+        std::to_string(stats.contended),
+        std::to_string(stats.wait_ns / 1000),
+        std::to_string(stats.max_wait_ns / 1000),
+        std::to_string(stats.sampled_holds ? stats.hold_ns / 1000 / stats.sampled_holds
+                                           : 0),
+        std::to_string(stats.max_hold_ns / 1000)};
+    for (size_t i = 0; i < row.size(); ++i) {
+      _return.row_set.columns[i].data.str_col.emplace_back(row[i]);
+      _return.row_set.columns[i].nulls.push_back(false);
+    }
+  }
+}
+
 void DBHandler::getQueries(const Catalog_Namespace::SessionInfo& session_info,
                            TQueryResult& _return) {
   if (!session_info.get_currentUser().isSuper) {
@@ -6261,6 +7223,12 @@ void DBHandler::executeDdl(
     getUserSessions(*session_ptr, _return);
   } else if (executor.isShowQueries()) {
     getQueries(*session_ptr, _return);
+  } else if (executor.isShowCodeCache()) {
+    getCodeCacheStatus(*session_ptr, _return);
+  } else if (executor.isShowQueryHistory()) {
+    getQueryHistory(*session_ptr, _return);
+  } else if (executor.isShowLockContention()) {
+    getLockContention(*session_ptr, _return);
   } else if (executor.isKillQuery()) {
     interruptQuery(*session_ptr, executor.getTargetQuerySessionToKill());
   } else {
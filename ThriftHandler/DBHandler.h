@@ -48,6 +48,7 @@
 #include "QueryEngine/QueryDispatchQueue.h"
 #include "QueryEngine/TableGenerations.h"
 #include "Shared/StringTransform.h"
+#include "Shared/Metrics.h"
 #include "Shared/SystemParameters.h"
 #include "Shared/mapd_shared_mutex.h"
 #include "Shared/mapd_shared_ptr.h"
@@ -56,6 +57,7 @@
 #include "StringDictionary/StringDictionaryClient.h"
 #include "ThriftHandler/ConnectionInfo.h"
 #include "ThriftHandler/DistributedValidate.h"
+#include "ThriftHandler/PreparedStatement.h"
 #include "ThriftHandler/QueryState.h"
 #include "ThriftHandler/RenderHandler.h"
 
@@ -76,6 +78,7 @@
 #include <boost/program_options.hpp>
 #include <boost/regex.hpp>
 #include <boost/tokenizer.hpp>
+#include <chrono>
 #include <cmath>
 #include <csignal>
 #include <fstream>
@@ -274,6 +277,35 @@ class DBHandler : public OmniSciIf {
                    const std::string& nonce,
                    const int32_t first_n,
                    const int32_t at_most_n) override;
+  // Returns the first first_n rows of the result of a SELECT query, and if it has more
+  // rows, the id of a cursor fetch_cursor returns them from without executing the query
+  // again. Cursors not used for g_cursor_ttl_seconds are closed.
+  void sql_execute_cursor(TQueryResult& _return,
+                          const TSessionId& session,
+                          const std::string& query,
+                          const bool column_format,
+                          const std::string& nonce,
+                          const int32_t first_n) override;
+  void fetch_cursor(TQueryResult& _return,
+                    const TSessionId& session,
+                    const std::string& cursor_id,
+                    const int32_t n) override;
+  void close_cursor(const TSessionId& session, const std::string& cursor_id) override;
+  // Prepares a statement with `?` placeholders, which execute_prepared runs with the
+  // parameters bound to them until close_prepared or the end of the session.
+  void prepare_statement(TPreparedStatement& _return,
+                         const TSessionId& session,
+                         const std::string& query) override;
+  void execute_prepared(TQueryResult& _return,
+                        const TSessionId& session,
+                        const std::string& statement_id,
+                        const std::vector<TQueryParam>& params,
+                        const bool column_format,
+                        const std::string& nonce,
+                        const int32_t first_n,
+                        const int32_t at_most_n) override;
+  void close_prepared(const TSessionId& session,
+                      const std::string& statement_id) override;
   void get_completion_hints(std::vector<TCompletionHint>& hints,
                             const TSessionId& session,
                             const std::string& sql,
@@ -291,6 +323,14 @@ class DBHandler : public OmniSciIf {
                        const std::string& query,
                        const int32_t device_id,
                        const int32_t first_n) override;
+  // Returns the result as a data frame per device of device_ids, each with a partition
+  // of the rows, rather than all of them on a single device. Each data frame is
+  // deallocated on its own device.
+  void sql_execute_gdf_partitioned(std::vector<TDataFrame>& _return,
+                                   const TSessionId& session,
+                                   const std::string& query,
+                                   const std::vector<int32_t>& device_ids,
+                                   const int32_t first_n) override;
   void deallocate_df(const TSessionId& session,
                      const TDataFrame& df,
                      const TDeviceType::type device_type,
@@ -303,6 +343,8 @@ class DBHandler : public OmniSciIf {
 
   void set_execution_mode(const TSessionId& session,
                           const TExecuteMode::type mode) override;
+  void set_column_encoding(const TSessionId& session,
+                           const TColumnEncoding::type encoding) override;
   void render_vega(TRenderResult& _return,
                    const TSessionId& session,
                    const int64_t widget_id,
@@ -383,6 +425,13 @@ class DBHandler : public OmniSciIf {
       std::unique_ptr<import_export::Loader>* loader,
       std::vector<std::unique_ptr<import_export::TypedImportBuffer>>* import_buffers);
 
+  // Loads and checkpoints the rows, in a group commit when enabled, see GroupCommit.h.
+  void load_rows(import_export::Loader& loader,
+                 const std::vector<std::unique_ptr<import_export::TypedImportBuffer>>&
+                     import_buffers,
+                 const size_t row_count,
+                 lockmgr::WriteLock&& insert_data_lock);
+
   void load_table_binary_columnar(const TSessionId& session,
                                   const std::string& table_name,
                                   const std::vector<TColumn>& cols) override;
@@ -550,6 +599,10 @@ class DBHandler : public OmniSciIf {
 
   std::unique_ptr<QueryDispatchQueue> dispatch_queue_;
 
+  // Adds the dispatch queue, cache and dictionary statistics to the metrics endpoint.
+  void collectMetrics(std::vector<metrics::Sample>& samples) const;
+  int metrics_collector_id_;
+
   template <typename... ARGS>
   std::shared_ptr<query_state::QueryState> create_query_state(ARGS&&... args) {
     return query_states_.create(std::forward<ARGS>(args)...);
@@ -628,13 +681,36 @@ class DBHandler : public OmniSciIf {
       const SystemParameters system_parameters,
       bool check_privileges = true);
 
+  // The result set of a query opened by sql_execute_cursor, the rows past those returned
+  // so far are converted by fetch_cursor.
+  struct QueryCursor {
+    std::string session_id;
+    std::string query_str;
+    std::vector<TargetMetaInfo> targets;
+    std::shared_ptr<ResultSet> rows;
+    bool column_format{false};
+    size_t row_count{0};
+    size_t fetched_count{0};
+    std::chrono::steady_clock::time_point last_used;
+  };
+
   void sql_execute_impl(TQueryResult& _return,
                         QueryStateProxy,
                         const bool column_format,
                         const std::string& nonce,
                         const ExecutorDeviceType executor_device_type,
                         const int32_t first_n,
-                        const int32_t at_most_n);
+                        const int32_t at_most_n,
+                        QueryCursor* cursor = nullptr);
+
+  // Removes the cursor from cursors_ while its rows are fetched or for good.
+  std::unique_ptr<QueryCursor> take_cursor(const TSessionId& session,
+                                           const std::string& cursor_id);
+  // Keeps the cursor for the next fetch_cursor if it has rows left.
+  void keep_cursor(TQueryResult& _return,
+                   std::string cursor_id,
+                   std::unique_ptr<QueryCursor> cursor);
+  void expire_cursors_unsafe();
 
   bool user_can_access_table(const Catalog_Namespace::SessionInfo&,
                              const TableDescriptor* td,
@@ -657,7 +733,8 @@ class DBHandler : public OmniSciIf {
       const bool just_validate,
       const bool find_push_down_candidates,
       const ExplainInfo& explain_info,
-      const std::optional<size_t> executor_index = std::nullopt) const;
+      const std::optional<size_t> executor_index = std::nullopt,
+      QueryCursor* cursor = nullptr) const;
 
   void execute_rel_alg_with_filter_push_down(
       TQueryResult& _return,
@@ -669,14 +746,25 @@ class DBHandler : public OmniSciIf {
       const int32_t at_most_n,
       const bool just_explain,
       const bool just_calcite_explain,
-      const std::vector<PushedDownFilterInfo>& filter_push_down_requests);
+      const std::vector<PushedDownFilterInfo>& filter_push_down_requests,
+      QueryCursor* cursor = nullptr);
 
-  void execute_rel_alg_df(TDataFrame& _return,
+  void sql_execute_df_impl(std::vector<TDataFrame>& _return,
+                           const TSessionId& session,
+                           const std::string& query_str,
+                           const TDeviceType::type device_type,
+                           const std::vector<int32_t>& device_ids,
+                           const int32_t first_n,
+                           const TArrowTransport::type transport_method);
+
+  // Returns a data frame per device of device_ids, partitioning the rows of a GPU
+  // result if there is more than one.
+  void execute_rel_alg_df(std::vector<TDataFrame>& _return,
                           const std::string& query_ra,
                           QueryStateProxy query_state_proxy,
                           const Catalog_Namespace::SessionInfo& session_info,
                           const ExecutorDeviceType device_type,
-                          const size_t device_id,
+                          const std::vector<int32_t>& device_ids,
                           const int32_t first_n,
                           const TArrowTransport::type transport_method) const;
 
@@ -773,6 +861,16 @@ class DBHandler : public OmniSciIf {
   query_state::QueryStates query_states_;
   SessionMap sessions_;
 
+  std::mutex cursors_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<QueryCursor>> cursors_;
+
+  struct SessionStatement {
+    std::string session_id;
+    std::shared_ptr<const PreparedStatement> statement;
+  };
+  std::mutex prepared_statements_mutex_;
+  std::unordered_map<std::string, SessionStatement> prepared_statements_;
+
   bool super_user_rights_;           // default is "false"; setting to "true"
                                      // ignores passwd checks in "connect(..)"
                                      // method
@@ -866,6 +964,15 @@ class DBHandler : public OmniSciIf {
   void getUserSessions(const Catalog_Namespace::SessionInfo& session_info,
                        TQueryResult& _return);
 
+  void getCodeCacheStatus(const Catalog_Namespace::SessionInfo& session_info,
+                          TQueryResult& _return);
+
+  void getQueryHistory(const Catalog_Namespace::SessionInfo& session_info,
+                       TQueryResult& _return);
+
+  void getLockContention(const Catalog_Namespace::SessionInfo& session_info,
+                         TQueryResult& _return);
+
   // this function returns a set of queries queued in the DB
   // that belongs to the same DB in the caller's session
   void getQueries(const Catalog_Namespace::SessionInfo& session_info,
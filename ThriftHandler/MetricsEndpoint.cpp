@@ -0,0 +1,146 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MetricsEndpoint.h"
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+#include "Logger/Logger.h"
+#include "Shared/Metrics.h"
+
+int g_metrics_port{0};
+
+namespace {
+
+// how often the endpoint checks whether it is stopped while no scraper connects
+constexpr int kPollTimeoutMs{200};
+constexpr size_t kMaxRequestBytes{8192};
+
+void send_all(const int fd, const std::string& data) {
+  size_t sent{0};
+  while (sent < data.size()) {
+    const auto ret = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (ret <= 0) {
+      return;
+    }
+    sent += ret;
+  }
+}
+
+std::string make_response(const std::string& status,
+                          const std::string& content_type,
+                          const std::string& body) {
+  return "HTTP/1.1 " + status + "\r\nContent-Type: " + content_type +
+         "\r\nContent-Length: " + std::to_string(body.size()) +
+         "\r\nConnection: close\r\n\r\n" + body;
+}
+
+}  // namespace
+
+void MetricsEndpoint::start(std::atomic<bool>& is_program_running) {
+  if (is_endpoint_running_) {
+    return;
+  }
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    LOG(ERROR) << "Metrics endpoint disabled, could not create a socket: "
+               << std::strerror(errno);
+    return;
+  }
+  const int reuse_addr{1};
+  ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse_addr, sizeof(reuse_addr));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(g_metrics_port);
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      ::listen(listen_fd_, SOMAXCONN) < 0) {
+    LOG(ERROR) << "Metrics endpoint disabled, could not listen on port "
+               << g_metrics_port << ": " << std::strerror(errno);
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return;
+  }
+  stop_requested_ = false;
+  endpoint_thread_ = std::thread([&is_program_running]() {
+    while (is_program_running && !stop_requested_) {
+      pollfd listen_poll{listen_fd_, POLLIN, 0};
+      if (::poll(&listen_poll, 1, kPollTimeoutMs) <= 0) {
+        continue;
+      }
+      const auto client_fd = ::accept(listen_fd_, nullptr, nullptr);
+      if (client_fd < 0) {
+        continue;
+      }
+      try {
+        serve(client_fd);
+      } catch (std::exception& e) {
+        LOG(ERROR) << "Serving the metrics resulted in an error. " << e.what();
+      }
+      ::close(client_fd);
+    }
+  });
+  is_endpoint_running_ = true;
+  LOG(INFO) << "Serving metrics on port " << g_metrics_port;
+}
+
+void MetricsEndpoint::stop() {
+  if (is_endpoint_running_) {
+    stop_requested_ = true;
+    endpoint_thread_.join();
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    is_endpoint_running_ = false;
+  }
+}
+
+void MetricsEndpoint::serve(const int client_fd) {
+  // a scraper which stops sending would otherwise hold up the endpoint
+  timeval timeout{1, 0};
+  ::setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < kMaxRequestBytes) {
+    const auto ret = ::recv(client_fd, buffer, sizeof(buffer), 0);
+    if (ret <= 0) {
+      break;
+    }
+    request.append(buffer, ret);
+  }
+  const auto request_line = request.substr(0, request.find("\r\n"));
+  if (request_line.rfind("GET /metrics ", 0) == 0 ||
+      request_line.rfind("GET /metrics?", 0) == 0) {
+    send_all(client_fd,
+             make_response("200 OK",
+                           "text/plain; version=0.0.4; charset=utf-8",
+                           metrics::Registry::instance().render()));
+  } else {
+    send_all(client_fd, make_response("404 Not Found", "text/plain", "Not Found\n"));
+  }
+}
+
+bool MetricsEndpoint::is_endpoint_running_{false};
+std::atomic<bool> MetricsEndpoint::stop_requested_{false};
+int MetricsEndpoint::listen_fd_{-1};
+std::thread MetricsEndpoint::endpoint_thread_;
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+extern int g_metrics_port;
+
+/**
+ * @brief Serves the metrics of the registry in the Prometheus text format on
+ * GET /metrics of g_metrics_port, for scrapers. Requests are answered one at a time on a
+ * thread of its own, away from the thrift servers.
+ */
+class MetricsEndpoint {
+ public:
+  static void start(std::atomic<bool>& is_program_running);
+  static void stop();
+
+ private:
+  static void serve(const int client_fd);
+
+  static bool is_endpoint_running_;
+  static std::atomic<bool> stop_requested_;
+  static int listen_fd_;
+  static std::thread endpoint_thread_;
+};
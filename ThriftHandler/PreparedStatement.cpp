@@ -0,0 +1,164 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PreparedStatement.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/regex.hpp>
+
+namespace {
+
+std::string quote(const std::string& str) {
+  return '\'' + boost::replace_all_copy(str, "'", "''") + '\'';
+}
+
+std::string get_sql_type_name(const TDatumType::type type) {
+  switch (type) {
+    case TDatumType::TINYINT:
+      return "TINYINT";
+    case TDatumType::SMALLINT:
+      return "SMALLINT";
+    case TDatumType::INT:
+      return "INTEGER";
+    case TDatumType::BIGINT:
+      return "BIGINT";
+    case TDatumType::FLOAT:
+      return "FLOAT";
+    case TDatumType::DOUBLE:
+      return "DOUBLE";
+    case TDatumType::DECIMAL:
+      return "DECIMAL";
+    case TDatumType::STR:
+      return "TEXT";
+    case TDatumType::BOOL:
+      return "BOOLEAN";
+    case TDatumType::DATE:
+      return "DATE";
+    case TDatumType::TIME:
+      return "TIME";
+    case TDatumType::TIMESTAMP:
+      return "TIMESTAMP";
+    default:
+      throw std::runtime_error("Parameters of type " +
+                               std::to_string(static_cast<int>(type)) +
+                               " are not supported");
+  }
+}
+
+std::string to_literal(const TQueryParam& param) {
+  const auto type_name = get_sql_type_name(param.type);
+  // an untyped NULL is rejected by Calcite in most places
+  if (param.value.is_null) {
+    return "CAST(NULL AS " + type_name + ")";
+  }
+  const auto& val = param.value.val;
+  switch (param.type) {
+    case TDatumType::TINYINT:
+    case TDatumType::SMALLINT:
+    case TDatumType::INT:
+    case TDatumType::BIGINT: {
+      // parenthesized, a negative value after a minus would start a comment
+      return val.int_val < 0 ? '(' + std::to_string(val.int_val) + ')'
+                             : std::to_string(val.int_val);
+    }
+    case TDatumType::FLOAT:
+    case TDatumType::DOUBLE: {
+      if (!std::isfinite(val.real_val)) {
+        throw std::runtime_error("Parameters must be finite numbers");
+      }
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%.17g", val.real_val);
+      std::string literal{buf};
+      // written without a fraction, the value would be an integer literal
+      if (literal.find_first_of(".e") == std::string::npos) {
+        literal += ".0";
+      }
+      return literal[0] == '-' ? '(' + literal + ')' : literal;
+    }
+    case TDatumType::DECIMAL: {
+      static const boost::regex decimal_regex{R"(-?\d+(\.\d+)?)"};
+      if (!boost::regex_match(val.str_val, decimal_regex)) {
+        throw std::runtime_error("Invalid decimal parameter " + val.str_val);
+      }
+      return val.str_val[0] == '-' ? '(' + val.str_val + ')' : val.str_val;
+    }
+    case TDatumType::STR:
+      return quote(val.str_val);
+    case TDatumType::BOOL:
+      return val.int_val ? "TRUE" : "FALSE";
+    default:
+      // DATE, TIME and TIMESTAMP
+      return type_name + ' ' + quote(val.str_val);
+  }
+}
+
+}  // namespace
+
+PreparedStatement::PreparedStatement(const std::string& query_str)
+    : query_str_(query_str) {
+  std::string segment;
+  for (size_t i = 0; i < query_str.size(); ++i) {
+    const char c = query_str[i];
+    const char next = i + 1 < query_str.size() ? query_str[i + 1] : '\0';
+    size_t end = i;
+    if (c == '\'' || c == '"') {
+      // a quote in a string literal or quoted identifier is doubled
+      end = i + 1;
+      while (end < query_str.size()) {
+        if (query_str[end] == c) {
+          if (end + 1 < query_str.size() && query_str[end + 1] == c) {
+            end += 2;
+            continue;
+          }
+          break;
+        }
+        ++end;
+      }
+    } else if (c == '-' && next == '-') {
+      end = query_str.find('\n', i);
+    } else if (c == '/' && next == '*') {
+      end = query_str.find("*/", i + 2);
+      end = end == std::string::npos ? end : end + 1;
+    } else if (c == '?') {
+      segments_.push_back(std::move(segment));
+      segment.clear();
+      continue;
+    }
+    end = std::min(end, query_str.size() - 1);
+    segment.append(query_str, i, end - i + 1);
+    i = end;
+  }
+  segments_.push_back(std::move(segment));
+}
+
+std::string PreparedStatement::bind(const std::vector<TQueryParam>& params) const {
+  if (params.size() != getParamCount()) {
+    throw std::runtime_error("The statement has " + std::to_string(getParamCount()) +
+                             " parameters, " + std::to_string(params.size()) +
+                             " were bound");
+  }
+  std::string query_str = segments_.front();
+  for (size_t i = 0; i < params.size(); ++i) {
+    query_str += to_literal(params[i]);
+    query_str += segments_[i + 1];
+  }
+  return query_str;
+}
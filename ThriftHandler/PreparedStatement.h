@@ -0,0 +1,51 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PreparedStatement.h
+ * @brief   Statements prepared with `?` placeholders, executed with bound parameters.
+ *
+ * The placeholders are located once, when the statement is prepared. Binding replaces
+ * each of them by a literal of the type of its parameter. The literals of a query are
+ * hoisted out of its generated code, so that executions with other values hit the code
+ * cache, and with the Calcite plan cache enabled, executions whose literals have the
+ * same shape reuse the plan of the first one instead of being planned again.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gen-cpp/omnisci_types.h"
+
+class PreparedStatement {
+ public:
+  explicit PreparedStatement(const std::string& query_str);
+
+  const std::string& getQueryStr() const { return query_str_; }
+
+  size_t getParamCount() const { return segments_.size() - 1; }
+
+  // The query with the parameters in place of the placeholders, in order. Throws if the
+  // number of parameters doesn't match or if a parameter can't be written as a literal.
+  std::string bind(const std::vector<TQueryParam>& params) const;
+
+ private:
+  std::string query_str_;
+  // the text before, between and after the placeholders
+  std::vector<std::string> segments_;
+};
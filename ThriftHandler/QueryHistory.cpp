@@ -0,0 +1,255 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryHistory.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "Logger/Logger.h"
+
+size_t g_query_history_size{0};
+size_t g_query_history_persist_interval_s{60};
+
+namespace {
+
+// One line of JSON per entry.
+std::string to_json(const QueryHistoryEntry& entry) {
+  const auto& usage = entry.resource_usage;
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("submitted");
+  writer.Int64(entry.submitted);
+  writer.Key("db_name");
+  writer.String(entry.db_name.c_str(), entry.db_name.size());
+  writer.Key("user_name");
+  writer.String(entry.user_name.c_str(), entry.user_name.size());
+  writer.Key("query_str");
+  writer.String(entry.query_str.c_str(), entry.query_str.size());
+  writer.Key("plan_hash");
+  writer.Uint64(usage.plan_hash);
+  writer.Key("num_steps");
+  writer.Uint64(usage.num_steps);
+  writer.Key("ran_on_gpu");
+  writer.Bool(usage.ran_on_gpu);
+  writer.Key("queue_time_ms");
+  writer.Int64(usage.queue_time_ms);
+  writer.Key("compilation_time_ms");
+  writer.Int64(usage.compilation_time_ms);
+  writer.Key("execution_time_ms");
+  writer.Int64(entry.execution_time_ms);
+  writer.Key("reduction_time_ms");
+  writer.Int64(usage.reduction_time_ms);
+  writer.Key("total_time_ms");
+  writer.Int64(entry.total_time_ms);
+  writer.Key("cpu_bytes_scanned");
+  writer.Uint64(usage.cpu_bytes_scanned);
+  writer.Key("gpu_bytes_scanned");
+  writer.Uint64(usage.gpu_bytes_scanned);
+  writer.Key("peak_cpu_memory_bytes");
+  writer.Uint64(usage.peak_cpu_memory_bytes);
+  writer.Key("peak_gpu_memory_bytes");
+  writer.Uint64(usage.peak_gpu_memory_bytes);
+  writer.Key("host_memory_bytes");
+  writer.Uint64(usage.peak_host_memory_bytes);
+  writer.Key("error");
+  writer.String(entry.error.c_str(), entry.error.size());
+  writer.EndObject();
+  return {buffer.GetString(), buffer.GetSize()};
+}
+
+bool from_json(const std::string& line, QueryHistoryEntry& entry) {
+  rapidjson::Document doc;
+  if (doc.Parse(line.c_str()).HasParseError() || !doc.IsObject()) {
+    return false;
+  }
+  auto get_int64 = [&doc](const char* name) -> int64_t {
+    return doc.HasMember(name) && doc[name].IsInt64() ? doc[name].GetInt64() : 0;
+  };
+  auto get_uint64 = [&doc](const char* name) -> uint64_t {
+    return doc.HasMember(name) && doc[name].IsUint64() ? doc[name].GetUint64() : 0;
+  };
+  auto get_string = [&doc](const char* name) -> std::string {
+    return doc.HasMember(name) && doc[name].IsString() ? doc[name].GetString() : "";
+  };
+  auto& usage = entry.resource_usage;
+  entry.submitted = get_int64("submitted");
+  entry.db_name = get_string("db_name");
+  entry.user_name = get_string("user_name");
+  entry.query_str = get_string("query_str");
+  usage.plan_hash = get_uint64("plan_hash");
+  usage.num_steps = get_uint64("num_steps");
+  usage.ran_on_gpu = doc.HasMember("ran_on_gpu") && doc["ran_on_gpu"].IsBool() &&
+                     doc["ran_on_gpu"].GetBool();
+  usage.queue_time_ms = get_int64("queue_time_ms");
+  usage.compilation_time_ms = get_int64("compilation_time_ms");
+  entry.execution_time_ms = get_int64("execution_time_ms");
+  usage.reduction_time_ms = get_int64("reduction_time_ms");
+  entry.total_time_ms = get_int64("total_time_ms");
+  usage.cpu_bytes_scanned = get_uint64("cpu_bytes_scanned");
+  usage.gpu_bytes_scanned = get_uint64("gpu_bytes_scanned");
+  usage.peak_cpu_memory_bytes = get_uint64("peak_cpu_memory_bytes");
+  usage.peak_gpu_memory_bytes = get_uint64("peak_gpu_memory_bytes");
+  usage.peak_host_memory_bytes = get_uint64("host_memory_bytes");
+  entry.error = get_string("error");
+  return true;
+}
+
+}  // namespace
+
+void QueryHistory::start(std::atomic<bool>& is_program_running,
+                         const std::string& file_path) {
+  if (is_persistence_running_) {
+    return;
+  }
+  file_path_ = file_path;
+  try {
+    load(file_path_);
+  } catch (std::exception& e) {
+    LOG(ERROR) << "Loading the query history from " << file_path_
+               << " resulted in an error. " << e.what();
+  }
+  stop_requested_ = false;
+  persistence_thread_ = std::thread([&is_program_running]() {
+    while (is_program_running &&
+           waitFor(std::chrono::seconds(g_query_history_persist_interval_s))) {
+      try {
+        persist(file_path_);
+      } catch (std::exception& e) {
+        LOG(ERROR) << "Writing the query history to " << file_path_
+                   << " resulted in an error. " << e.what();
+      }
+    }
+  });
+  is_persistence_running_ = true;
+}
+
+void QueryHistory::stop() {
+  if (is_persistence_running_) {
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex_);
+      stop_requested_ = true;
+    }
+    stop_cv_.notify_all();
+    persistence_thread_.join();
+    is_persistence_running_ = false;
+    try {
+      persist(file_path_);
+    } catch (std::exception& e) {
+      LOG(ERROR) << "Writing the query history to " << file_path_
+                 << " resulted in an error. " << e.what();
+    }
+  }
+}
+
+void QueryHistory::add(QueryHistoryEntry entry) {
+  if (!g_query_history_size) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(entries_mutex_);
+  if (entries_.capacity() != g_query_history_size) {
+    entries_.set_capacity(g_query_history_size);
+  }
+  entries_.push_back(std::move(entry));
+  changed_ = true;
+}
+
+std::vector<QueryHistoryEntry> QueryHistory::getEntries() {
+  std::lock_guard<std::mutex> lock(entries_mutex_);
+  return {entries_.begin(), entries_.end()};
+}
+
+void QueryHistory::clear() {
+  std::lock_guard<std::mutex> lock(entries_mutex_);
+  entries_.clear();
+  changed_ = true;
+}
+
+void QueryHistory::load(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file) {
+    return;
+  }
+  std::vector<QueryHistoryEntry> loaded_entries;
+  std::string line;
+  while (std::getline(file, line)) {
+    QueryHistoryEntry entry;
+    if (from_json(line, entry)) {
+      loaded_entries.push_back(std::move(entry));
+    } else {
+      LOG(WARNING) << "Skipping a malformed entry of the query history in " << file_path;
+    }
+  }
+  std::lock_guard<std::mutex> lock(entries_mutex_);
+  entries_.set_capacity(g_query_history_size);
+  // the entries of earlier runs come before the ones added since the start
+  std::vector<QueryHistoryEntry> current_entries(entries_.begin(), entries_.end());
+  entries_.clear();
+  for (auto& entry : loaded_entries) {
+    entries_.push_back(std::move(entry));
+  }
+  for (auto& entry : current_entries) {
+    entries_.push_back(std::move(entry));
+  }
+}
+
+// The entries are written to a temporary file renamed over the previous one, so that a
+// crash while writing leaves the previous history.
+void QueryHistory::persist(const std::string& file_path) {
+  std::vector<std::string> lines;
+  {
+    std::lock_guard<std::mutex> lock(entries_mutex_);
+    if (!changed_) {
+      return;
+    }
+    for (const auto& entry : entries_) {
+      lines.push_back(to_json(entry));
+    }
+    changed_ = false;
+  }
+  const auto tmp_file_path = file_path + ".tmp";
+  std::ofstream file(tmp_file_path, std::ios::trunc);
+  for (const auto& line : lines) {
+    file << line << '\n';
+  }
+  file.close();
+  if (!file || std::rename(tmp_file_path.c_str(), file_path.c_str())) {
+    // written again on the next try
+    std::lock_guard<std::mutex> lock(entries_mutex_);
+    changed_ = true;
+    throw std::runtime_error("Could not write " + file_path);
+  }
+}
+
+bool QueryHistory::waitFor(const std::chrono::seconds duration) {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  return !stop_cv_.wait_for(lock, duration, [] { return stop_requested_; });
+}
+
+boost::circular_buffer<QueryHistoryEntry> QueryHistory::entries_;
+bool QueryHistory::changed_{false};
+std::mutex QueryHistory::entries_mutex_;
+std::string QueryHistory::file_path_;
+bool QueryHistory::is_persistence_running_{false};
+bool QueryHistory::stop_requested_{false};
+std::mutex QueryHistory::stop_mutex_;
+std::condition_variable QueryHistory::stop_cv_;
+std::thread QueryHistory::persistence_thread_;
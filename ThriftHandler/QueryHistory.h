@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <boost/circular_buffer.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ThriftHandler/QueryState.h"
+
+extern size_t g_query_history_size;
+extern size_t g_query_history_persist_interval_s;
+
+struct QueryHistoryEntry {
+  std::time_t submitted{0};
+  std::string db_name;
+  std::string user_name;
+  std::string query_str;
+  query_state::ResourceUsage resource_usage;
+  int64_t execution_time_ms{0};
+  int64_t total_time_ms{0};
+  // empty if the query succeeded
+  std::string error;
+};
+
+/**
+ * @brief The last g_query_history_size queries run through sql_execute, with the
+ * resources they used, for SHOW QUERY HISTORY. Once started, the history is loaded from
+ * its file and written back to it every g_query_history_persist_interval_s if it
+ * changed, and when stopped, so it survives restarts.
+ */
+class QueryHistory {
+ public:
+  static void start(std::atomic<bool>& is_program_running, const std::string& file_path);
+  static void stop();
+
+  static void add(QueryHistoryEntry entry);
+
+  // oldest first
+  static std::vector<QueryHistoryEntry> getEntries();
+
+  // for testing
+  static void clear();
+  static void load(const std::string& file_path);
+  static void persist(const std::string& file_path);
+
+ private:
+  // Sleeps for `duration`, returns false if the history is stopped meanwhile.
+  static bool waitFor(const std::chrono::seconds duration);
+
+  static boost::circular_buffer<QueryHistoryEntry> entries_;
+  static bool changed_;
+  static std::mutex entries_mutex_;
+
+  static std::string file_path_;
+  static bool is_persistence_running_;
+  static bool stop_requested_;
+  static std::mutex stop_mutex_;
+  static std::condition_variable stop_cv_;
+  static std::thread persistence_thread_;
+};
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryResultCache.h"
+
+#include "Logger/Logger.h"
+
+size_t g_query_result_cache_max_bytes{0};
+
+namespace {
+
+size_t datum_bytes(const TDatum& datum) {
+  size_t bytes = sizeof(TDatum) + datum.val.str_val.size();
+  for (const auto& elem : datum.val.arr_val) {
+    bytes += datum_bytes(elem);
+  }
+  return bytes;
+}
+
+size_t column_bytes(const TColumn& column) {
+  size_t bytes = sizeof(TColumn) + column.nulls.size() +
+                 column.data.int_col.size() * sizeof(int64_t) +
+                 column.data.real_col.size() * sizeof(double);
+  for (const auto& str : column.data.str_col) {
+    bytes += sizeof(str) + str.size();
+  }
+  for (const auto& arr : column.data.arr_col) {
+    bytes += column_bytes(arr);
+  }
+  return bytes;
+}
+
+size_t row_set_bytes(const TRowSet& row_set) {
+  size_t bytes = sizeof(TRowSet) + row_set.row_desc.size() * sizeof(TColumnType);
+  for (const auto& row : row_set.rows) {
+    bytes += sizeof(TRow);
+    for (const auto& datum : row.cols) {
+      bytes += datum_bytes(datum);
+    }
+  }
+  for (const auto& column : row_set.columns) {
+    bytes += column_bytes(column);
+  }
+  for (const auto& column : row_set.compressed_columns) {
+    bytes += sizeof(TCompressedColumn) + column.data.size();
+  }
+  return bytes;
+}
+
+}  // namespace
+
+QueryResultCache& QueryResultCache::instance() {
+  static QueryResultCache cache;
+  return cache;
+}
+
+uint64_t QueryResultCache::getGeneration() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return generation_;
+}
+
+bool QueryResultCache::get(const std::string& key, TRowSet& row_set) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second.first);
+  row_set = it->second.first->second;
+  return true;
+}
+
+void QueryResultCache::put(const std::string& key,
+                           const TRowSet& row_set,
+                           const uint64_t generation) {
+  const auto bytes = row_set_bytes(row_set);
+  const auto max_bytes = g_query_result_cache_max_bytes;
+  if (bytes > max_bytes) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (generation != generation_ || index_.count(key)) {
+    return;
+  }
+  evictOver(max_bytes - bytes);
+  entries_.emplace_front(key, row_set);
+  index_.emplace(key, std::make_pair(entries_.begin(), bytes));
+  resident_bytes_ += bytes;
+  VLOG(1) << "Cached the " << bytes << " bytes row set of a query, "
+          << resident_bytes_ << " bytes of row sets cached";
+}
+
+void QueryResultCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generation_;
+  evictOver(0);
+}
+
+void QueryResultCache::evictOver(const size_t max_bytes) {
+  while (resident_bytes_ > max_bytes) {
+    CHECK(!entries_.empty());
+    const auto it = index_.find(entries_.back().first);
+    CHECK(it != index_.end());
+    CHECK_GE(resident_bytes_, it->second.second);
+    resident_bytes_ -= it->second.second;
+    index_.erase(it);
+    entries_.pop_back();
+  }
+}
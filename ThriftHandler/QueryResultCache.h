@@ -0,0 +1,66 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "gen-cpp/omnisci_types.h"
+
+extern size_t g_query_result_cache_max_bytes;
+
+/**
+ * Row sets of the read queries returned by sql_execute, keyed by their plan, the epochs
+ * of the tables they read and the options they were returned with. The entries use at
+ * most g_query_result_cache_max_bytes (the cache is disabled if 0), the least recently
+ * used entry is evicted first.
+ *
+ * Writes which don't move the epochs of the tables forward, e.g. truncating or dropping
+ * and creating a table again, clear the cache. A row set computed while the cache was
+ * cleared is not cached.
+ */
+class QueryResultCache {
+ public:
+  static QueryResultCache& instance();
+
+  // Must be read before the query executes and passed to put along with its row set.
+  uint64_t getGeneration() const;
+
+  bool get(const std::string& key, TRowSet& row_set);
+
+  void put(const std::string& key, const TRowSet& row_set, const uint64_t generation);
+
+  void clear();
+
+ private:
+  QueryResultCache() {}
+
+  using LruList = std::list<std::pair<std::string, TRowSet>>;
+
+  void evictOver(const size_t max_bytes);
+
+  mutable std::mutex mutex_;
+  uint64_t generation_{0};
+  size_t resident_bytes_{0};
+  // most recently used first
+  LruList entries_;
+  std::unordered_map<std::string, std::pair<LruList::iterator, size_t>> index_;
+};
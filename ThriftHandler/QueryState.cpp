@@ -50,6 +50,23 @@ SessionData::SessionData(
     , user_name(session_info->get_currentUser().userName)
     , public_session_id(session_info->get_public_session_id()) {}
 
+ResourceUsage& ResourceUsage::operator+=(ResourceUsage const& other) {
+  if (other.plan_hash) {
+    plan_hash = other.plan_hash;
+  }
+  num_steps += other.num_steps;
+  ran_on_gpu |= other.ran_on_gpu;
+  queue_time_ms += other.queue_time_ms;
+  compilation_time_ms += other.compilation_time_ms;
+  reduction_time_ms += other.reduction_time_ms;
+  cpu_bytes_scanned += other.cpu_bytes_scanned;
+  gpu_bytes_scanned += other.gpu_bytes_scanned;
+  peak_cpu_memory_bytes = std::max(peak_cpu_memory_bytes, other.peak_cpu_memory_bytes);
+  peak_gpu_memory_bytes = std::max(peak_gpu_memory_bytes, other.peak_gpu_memory_bytes);
+  peak_host_memory_bytes = std::max(peak_host_memory_bytes, other.peak_host_memory_bytes);
+  return *this;
+}
+
 std::atomic<query_state::Id> QueryState::s_next_id{0};
 
 QueryState::QueryState(
@@ -110,6 +127,16 @@ void QueryState::logCallStack(std::stringstream& ss) {
   logCallStack(ss, 1, events_.end());
 }
 
+void QueryState::addResourceUsage(ResourceUsage const& resource_usage) {
+  std::lock_guard<std::mutex> lock(resource_usage_mutex_);
+  resource_usage_ += resource_usage;
+}
+
+ResourceUsage QueryState::getResourceUsage() const {
+  std::lock_guard<std::mutex> lock(resource_usage_mutex_);
+  return resource_usage_;
+}
+
 Timer QueryStateProxy::createTimer(char const* event_name) {
   return query_state_.createTimer(event_name, parent_);
 }
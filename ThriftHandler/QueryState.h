@@ -121,6 +121,27 @@ struct SessionData {
 
 class Timer;
 
+// The resources used by the steps a query ran, for the query history.
+struct ResourceUsage {
+  size_t plan_hash{0};
+  size_t num_steps{0};
+  bool ran_on_gpu{false};
+  int64_t queue_time_ms{0};
+  int64_t compilation_time_ms{0};
+  int64_t reduction_time_ms{0};
+  size_t cpu_bytes_scanned{0};
+  size_t gpu_bytes_scanned{0};
+  // the largest buffer pool working set of a step
+  size_t peak_cpu_memory_bytes{0};
+  size_t peak_gpu_memory_bytes{0};
+  // the most host memory allocated for the results and hash tables of a step
+  size_t peak_host_memory_bytes{0};
+
+  // Sums the times and the bytes scanned, keeps the largest working sets and the last
+  // plan hash.
+  ResourceUsage& operator+=(const ResourceUsage& other);
+};
+
 class QueryState : public std::enable_shared_from_this<QueryState> {
   static std::atomic<Id> s_next_id;
   Id const id_;
@@ -129,6 +150,8 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   Events events_;
   mutable std::mutex events_mutex_;
   std::atomic<bool> logged_;
+  ResourceUsage resource_usage_;
+  mutable std::mutex resource_usage_mutex_;
   void logCallStack(std::stringstream&, unsigned const depth, Events::iterator parent);
 
   // Only shared_ptr instances are allowed due to call to shared_from_this().
@@ -156,6 +179,8 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   inline bool isLogged() const { return logged_.load(); }
   void logCallStack(std::stringstream&);
   inline void setLogged(bool logged) { logged_.store(logged); }
+  void addResourceUsage(ResourceUsage const& resource_usage);
+  ResourceUsage getResourceUsage() const;
   friend class QueryStates;
 };
 
@@ -22,6 +22,9 @@
 #include "ChunkIter.h"
 
 #include <cstdlib>
+#ifndef __CUDACC__
+#include <algorithm>
+#endif
 
 DEVICE static void decompress(const SQLTypeInfo& ti,
                               int8_t* compressed,
@@ -329,3 +332,31 @@ DEVICE void ChunkIter_get_nth_point_coords(ChunkIter* it,
   }
   result->is_null = is_null;
 }
+
+#ifndef __CUDACC__
+bool ChunkIter_get_next_batch(ChunkIter* it, const size_t max_elems, ChunkBatch* batch) {
+  assert(it->skip == 1);
+  const size_t pos_size =
+      it->skip_size > 0 ? static_cast<size_t>(it->skip_size) : sizeof(StringOffsetT);
+  if (it->current_pos >= it->end_pos || !max_elems) {
+    batch->num_elems = 0;
+    return false;
+  }
+  const size_t remaining = (it->end_pos - it->current_pos) / pos_size;
+  batch->first_elem = (it->current_pos - it->start_pos) / pos_size;
+  batch->num_elems = std::min(remaining, max_elems);
+  if (it->skip_size > 0) {
+    batch->elem_size = pos_size;
+    batch->values = it->current_pos;
+    batch->offsets = nullptr;
+    batch->payload = nullptr;
+  } else {
+    batch->elem_size = 0;
+    batch->values = nullptr;
+    batch->offsets = reinterpret_cast<const StringOffsetT*>(it->current_pos);
+    batch->payload = it->second_buf;
+  }
+  it->current_pos += batch->num_elems * pos_size;
+  return true;
+}
+#endif
@@ -62,4 +62,36 @@ DEVICE void ChunkIter_get_nth_point_coords(ChunkIter* it,
                                            int nth,
                                            ArrayDatum* vd,
                                            bool* is_end);
+
+#ifndef __CUDACC__
+/**
+ * @brief Consecutive elements of a chunk, pointing into its buffers.
+ *
+ * The values of a fixed width chunk are as stored: compressed, and with the null
+ * sentinels of the type. The elements of a varlen chunk are described by num_elems + 1
+ * offsets into the payload, also as stored: a string of length zero is null, and the
+ * offset after a null array is negative (see ChunkIter_get_nth_varlen).
+ */
+struct ChunkBatch {
+  // index of the first element from the start of the iterator
+  size_t first_elem{0};
+  size_t num_elems{0};
+  // width of the fixed width values, 0 for a varlen chunk
+  size_t elem_size{0};
+  const int8_t* values{nullptr};
+  const StringOffsetT* offsets{nullptr};
+  const int8_t* payload{nullptr};
+
+  template <typename T>
+  const T* valuesAs() const {
+    assert(sizeof(T) == elem_size);
+    return reinterpret_cast<const T*>(values);
+  }
+};
+
+// @brief get the next at most max_elems elements without copying them, and move the
+// iterator past them. Returns false at the end of the chunk. The iterator must not skip
+// elements.
+bool ChunkIter_get_next_batch(ChunkIter* it, const size_t max_elems, ChunkBatch* batch);
+#endif
 #endif  // _CHUNK_ITER_H_
@@ -26,7 +26,29 @@
 
 #ifndef __CUDACC__
 #include <boost/regex.hpp>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// The pattern of a REGEXP is a literal, so the rows of a query all pass the same one.
+// Each thread keeps the last pattern it compiled, instead of compiling it for every row.
+const boost::regex& get_compiled_regex(const char* pattern, const int32_t pat_len) {
+  thread_local std::string cached_pattern;
+  thread_local std::unique_ptr<boost::regex> cached_regex;
+  const std::string_view pattern_view(pattern, pat_len);
+  if (!cached_regex || cached_pattern != pattern_view) {
+    // compile first, a pattern which throws must not replace the cached one
+    auto re = std::make_unique<boost::regex>(pattern, pat_len, boost::regex::extended);
+    cached_regex = std::move(re);
+    cached_pattern.assign(pattern, pat_len);
+  }
+  return *cached_regex;
+}
+
+}  // namespace
 #endif
 
 /*
@@ -46,7 +68,7 @@ extern "C" DEVICE bool regexp_like(const char* str,
 #ifndef __CUDACC__
   bool result;
   try {
-    boost::regex re(pattern, pat_len, boost::regex::extended);
+    const auto& re = get_compiled_regex(pattern, pat_len);
     boost::cmatch what;
     result = boost::regex_match(str, str + str_len, what, re);
   } catch (std::runtime_error& error) {
@@ -25,6 +25,10 @@
 
 #include "StringLike.h"
 
+#ifndef __CUDACC__
+#include <cstring>
+#endif
+
 enum LikeStatus {
   kLIKE_TRUE,
   kLIKE_FALSE,
@@ -40,10 +44,30 @@ DEVICE static int inline lowercase(char c) {
   return c;
 }
 
+// On CPU, the simple patterns are searched with memchr on the first pattern character,
+// which libc vectorizes, instead of trying a match at every position of the string.
 extern "C" DEVICE bool string_like_simple(const char* str,
                                           const int32_t str_len,
                                           const char* pattern,
                                           const int32_t pat_len) {
+#ifndef __CUDACC__
+  if (pat_len <= 0) {
+    return true;
+  }
+  const char* s = str;
+  const char* last = str + str_len - pat_len;
+  while (s <= last) {
+    s = static_cast<const char*>(memchr(s, pattern[0], last - s + 1));
+    if (!s) {
+      return false;
+    }
+    if (memcmp(s + 1, pattern + 1, pat_len - 1) == 0) {
+      return true;
+    }
+    ++s;
+  }
+  return false;
+#else
   int i, j;
   int search_len = str_len - pat_len + 1;
   for (i = 0; i < search_len; ++i) {
@@ -54,6 +78,7 @@ extern "C" DEVICE bool string_like_simple(const char* str,
     }
   }
   return false;
+#endif
 }
 
 extern "C" DEVICE bool string_ilike_simple(const char* str,
@@ -63,6 +88,10 @@ extern "C" DEVICE bool string_ilike_simple(const char* str,
   int i, j;
   int search_len = str_len - pat_len + 1;
   for (i = 0; i < search_len; ++i) {
+    // the pattern is lowercase, skip the positions whose first character can't match
+    if (pat_len > 0 && pattern[0] != lowercase(str[i])) {
+      continue;
+    }
     for (j = 0; j < pat_len && pattern[j] == lowercase(str[j + i]); ++j) {
     }
     if (j >= pat_len) {
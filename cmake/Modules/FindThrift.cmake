@@ -55,6 +55,22 @@ find_library(Thrift_LIBRARY
 
 get_filename_component(Thrift_LIBRARY_DIR ${Thrift_LIBRARY} DIRECTORY)
 
+# the non-blocking server and the libevent it runs on are optional
+find_library(Thrift_NB_LIBRARY
+  NAMES thriftnb
+  HINTS
+  ${Thrift_LIBRARY_DIR})
+find_library(Libevent_LIBRARY
+  NAMES event
+  HINTS
+  ENV LD_LIBRARY_PATH
+  ENV DYLD_LIBRARY_PATH
+  PATHS
+  /usr/lib
+  /usr/local/lib
+  /usr/local/homebrew/lib
+  /opt/local/lib)
+
 find_program(Thrift_EXECUTABLE
   NAMES thrift
   HINTS
@@ -89,6 +105,10 @@ if(Thrift_USE_STATIC_LIBS)
   set(Thrift_LIBRARIES ${Thrift_LIBRARIES} ${OPENSSL_LIBRARIES})
 endif()
 
+if(Thrift_NB_LIBRARY AND Libevent_LIBRARY)
+  set(Thrift_NB_LIBRARIES ${Thrift_NB_LIBRARY} ${Libevent_LIBRARY})
+endif()
+
 set(Thrift_LIBRARY_DIRS ${Thrift_LIBRARY_DIR})
 set(Thrift_INCLUDE_DIRS ${Thrift_LIBRARY_DIR}/../include)
 
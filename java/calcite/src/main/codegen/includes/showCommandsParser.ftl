@@ -73,3 +73,52 @@ SqlDdl SqlShowQueries(Span s) :
         return new SqlShowQueries(s.end(this));
     }
 }
+
+/*
+ * Show generated code cache statistics using the following syntax:
+ *
+ * SHOW CODE CACHE
+ */
+
+SqlDdl SqlShowCodeCache(Span s) :
+{
+}
+{
+    <SHOW> <CODE> <CACHE>
+    {
+        return new SqlShowCodeCache(s.end(this));
+    }
+}
+
+/*
+ * Show the recently run queries and the resources they used using the following syntax:
+ *
+ * SHOW QUERY HISTORY
+ */
+
+SqlDdl SqlShowQueryHistory(Span s) :
+{
+}
+{
+    <SHOW> <QUERY> <HISTORY>
+    {
+        return new SqlShowQueryHistory(s.end(this));
+    }
+}
+
+/*
+ * Show the acquisitions and the wait and hold times of the locks using the following
+ * syntax:
+ *
+ * SHOW LOCK CONTENTION
+ */
+
+SqlDdl SqlShowLockContention(Span s) :
+{
+}
+{
+    <SHOW> <LOCK> <CONTENTION>
+    {
+        return new SqlShowLockContention(s.end(this));
+    }
+}
@@ -88,6 +88,7 @@ import org.apache.calcite.sql.SqlNode;
 import org.apache.calcite.sql.SqlNodeList;
 import org.apache.calcite.sql.SqlNumericLiteral;
 import org.apache.calcite.sql.SqlOrderBy;
+import org.apache.calcite.sql.SqlSampleSpec;
 import org.apache.calcite.sql.SqlSelect;
 import org.apache.calcite.sql.SqlUnresolvedFunction;
 import org.apache.calcite.sql.SqlUpdate;
@@ -909,6 +910,8 @@ public final class MapDParser {
       throw ex;
     }
 
+    rewriteTableSamples(parseR);
+
     if (!legacy_syntax) {
       return parseR;
     }
@@ -943,6 +946,66 @@ public final class MapDParser {
     return parseR;
   }
 
+  // Rewrites "FROM t TABLESAMPLE BERNOULLI(p)" to a SAMPLE_RATIO(p / 100) filter, which
+  // keeps the rows by a hash of their position, and "FROM t TABLESAMPLE SYSTEM(p)" to a
+  // SAMPLE_FRAGMENTS(p / 100) filter, which keeps whole fragments and lets the executor
+  // skip the others without reading them.
+  private void rewriteTableSamples(SqlNode node) {
+    node.accept(new SqlBasicVisitor<Void>() {
+      @Override
+      public Void visit(SqlCall call) {
+        if (call instanceof SqlSelect) {
+          rewriteTableSample((SqlSelect) call);
+        }
+        return super.visit(call);
+      }
+    });
+  }
+
+  private void rewriteTableSample(SqlSelect select_node) {
+    SqlNode from = select_node.getFrom();
+    if (from == null) {
+      return;
+    }
+    if (from.getKind() != SqlKind.TABLESAMPLE) {
+      if (from.getKind() == SqlKind.JOIN && hasTableSample((SqlJoin) from)) {
+        throw new CalciteException(
+                "TABLESAMPLE is only supported on the only table of a FROM clause",
+                null);
+      }
+      return;
+    }
+    SqlCall sample_call = (SqlCall) from;
+    SqlSampleSpec sample_spec = SqlLiteral.sampleValue(sample_call.operand(1));
+    if (!(sample_spec instanceof SqlSampleSpec.SqlTableSampleSpec)) {
+      throw new CalciteException("Only BERNOULLI and SYSTEM table samples are supported",
+              null);
+    }
+    SqlSampleSpec.SqlTableSampleSpec table_sample_spec =
+            (SqlSampleSpec.SqlTableSampleSpec) sample_spec;
+    SqlParserPos pos = sample_call.getParserPosition();
+    SqlNode fraction = SqlLiteral.createApproxNumeric(
+            String.valueOf(table_sample_spec.getSamplePercentage()), pos);
+    SqlNode sample_filter = table_sample_spec.isBernoulli()
+            ? new MapDSqlOperatorTable.SampleRatio().createCall(pos, fraction)
+            : new MapDSqlOperatorTable.SampleFragments().createCall(pos, fraction);
+    SqlNode where = select_node.getWhere();
+    select_node.setFrom(sample_call.operand(0));
+    select_node.setWhere(where == null
+                    ? sample_filter
+                    : SqlStdOperatorTable.AND.createCall(pos, where, sample_filter));
+  }
+
+  private boolean hasTableSample(SqlJoin join) {
+    for (SqlNode side : new SqlNode[] {join.getLeft(), join.getRight()}) {
+      if (side.getKind() == SqlKind.TABLESAMPLE
+              || (side.getKind() == SqlKind.JOIN && hasTableSample((SqlJoin) side))) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   private void desugar(SqlSelect select_node, RelDataTypeFactory typeFactory) {
     desugar(select_node, null, typeFactory);
   }
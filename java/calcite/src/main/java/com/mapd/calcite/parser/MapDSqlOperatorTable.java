@@ -184,6 +184,7 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     opTab.addOperator(new CharLength());
     opTab.addOperator(new KeyForString());
     opTab.addOperator(new SampleRatio());
+    opTab.addOperator(new SampleFragments());
     opTab.addOperator(new ArrayLength());
     opTab.addOperator(new PgILike());
     opTab.addOperator(new RegexpLike());
@@ -230,6 +231,7 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     opTab.addOperator(new CastToGeography());
     opTab.addOperator(new OffsetInFragment());
     opTab.addOperator(new ApproxCountDistinct());
+    opTab.addOperator(new ApproxQuantile());
     opTab.addOperator(new MapDAvg());
     opTab.addOperator(new Sample());
     opTab.addOperator(new LastSample());
@@ -752,6 +754,24 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     }
   }
 
+  // Keeps the rows of a fraction of the fragments, TABLESAMPLE SYSTEM is rewritten to it.
+  public static class SampleFragments extends SqlFunction {
+    public SampleFragments() {
+      super("SAMPLE_FRAGMENTS",
+              SqlKind.OTHER_FUNCTION,
+              null,
+              null,
+              OperandTypes.family(SqlTypeFamily.NUMERIC),
+              SqlFunctionCategory.SYSTEM);
+    }
+
+    @Override
+    public RelDataType inferReturnType(SqlOperatorBinding opBinding) {
+      final RelDataTypeFactory typeFactory = opBinding.getTypeFactory();
+      return typeFactory.createSqlType(SqlTypeName.BOOLEAN);
+    }
+  }
+
   public static class ArrayLength extends SqlFunction {
     public ArrayLength() {
       super("ARRAY_LENGTH",
@@ -1812,6 +1832,25 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     }
   }
 
+  static class ApproxQuantile extends SqlAggFunction {
+    ApproxQuantile() {
+      super("APPROX_QUANTILE",
+              null,
+              SqlKind.OTHER_FUNCTION,
+              null,
+              null,
+              OperandTypes.family(SqlTypeFamily.NUMERIC, SqlTypeFamily.NUMERIC),
+              SqlFunctionCategory.SYSTEM);
+    }
+
+    @Override
+    public RelDataType inferReturnType(SqlOperatorBinding opBinding) {
+      final RelDataTypeFactory typeFactory = opBinding.getTypeFactory();
+      return typeFactory.createTypeWithNullability(
+              typeFactory.createSqlType(SqlTypeName.DOUBLE), true);
+    }
+  }
+
   static class MapDAvg extends SqlAggFunction {
     MapDAvg() {
       super("AVG",
@@ -11,6 +11,18 @@ public class OmniSciHintStrategyTable {
   }
 
   static HintStrategyTable createHintStrategies(HintStrategyTable.Builder builder) {
-    return builder.hintStrategy("cpu_mode", HintPredicates.SET_VAR).build();
+    return builder.hintStrategy("cpu_mode", HintPredicates.SET_VAR)
+            .hintStrategy("gpu_mode", HintPredicates.SET_VAR)
+            .hintStrategy("hash_join", HintPredicates.SET_VAR)
+            .hintStrategy("loop_join", HintPredicates.SET_VAR)
+            .hintStrategy("columnar_output", HintPredicates.SET_VAR)
+            .hintStrategy("rowwise_output", HintPredicates.SET_VAR)
+            .hintStrategy("max_kernel_parallelism", HintPredicates.SET_VAR)
+            .hintStrategy("watchdog_off", HintPredicates.SET_VAR)
+            .hintStrategy("dynamic_watchdog", HintPredicates.SET_VAR)
+            .hintStrategy("gpu_input_mem_limit", HintPredicates.SET_VAR)
+            .hintStrategy("disable_lazy_fetch", HintPredicates.SET_VAR)
+            .hintStrategy("approximate", HintPredicates.SET_VAR)
+            .build();
   }
 }
@@ -87,6 +87,17 @@ struct TColumn {
   2: list<bool> nulls
 }
 
+/* The values of a column of a result set as a single buffer, blosc compressed unless it
+   did not shrink, in which case data_size equals the size of data. The buffer holds a
+   null flag byte per row, then the values of the column in the TColumnData member a
+   TColumn would hold them in: 8 byte int_col or real_col values per row, or row_count + 1
+   8 byte offsets of the str_col strings followed by their bytes. */
+struct TCompressedColumn {
+  1: binary data,
+  2: i64 data_size,
+  3: i64 row_count
+}
+
 struct TStringRow {
   1: list<TStringValue> cols
 }
@@ -121,6 +132,7 @@ struct TRowSet {
   2: list<TRow> rows
   3: list<TColumn> columns
   4: bool is_columnar
+  5: optional list<TCompressedColumn> compressed_columns
 }
 
 enum TQueryType {
@@ -131,6 +143,11 @@ enum TQueryType {
   SCHEMA_WRITE
 }
 
+enum TColumnEncoding {
+  THRIFT,
+  COMPRESSED
+}
+
 enum TArrowTransport {
   SHARED_MEMORY,
   WIRE
@@ -144,6 +161,17 @@ struct TQueryResult {
   5: string debug
   6: bool success=true
   7: TQueryType query_type=TQueryType.UNKNOWN
+  8: optional string cursor_id
+}
+
+struct TQueryParam {
+  1: common.TDatumType type
+  2: TDatum value
+}
+
+struct TPreparedStatement {
+  1: string statement_id
+  2: i32 param_count
 }
 
 struct TDataFrame {
@@ -206,6 +234,8 @@ struct TImportStatus {
   2: i64 rows_completed
   3: i64 rows_estimated
   4: i64 rows_rejected
+  5: i64 parse_ms
+  6: i64 load_ms
 }
 
 struct TFrontendView {
@@ -227,6 +257,37 @@ struct TDashboard {
   8: bool is_dash_shared
 }
 
+struct TDispatchQueueStatus {
+  1: string priority_class
+  2: i64 queue_depth
+  3: i64 dispatched_count
+  4: double avg_wait_ms
+  5: double max_wait_ms
+}
+
+struct TCodeCacheStatus {
+  1: i64 executor_id
+  2: common.TDeviceType device_type
+  3: i64 num_entries
+  4: i64 resident_bytes
+  5: i64 max_bytes
+  6: i64 hits
+  7: i64 misses
+  8: i64 evictions
+}
+
+struct TJoinHashTableCacheStatus {
+  1: i32 db_id
+  2: i32 table_id
+  3: i64 num_entries
+  4: i64 resident_bytes
+  5: i64 builds
+  6: i64 hits
+  7: i64 evictions
+  8: i64 build_time_ms
+  9: i64 build_time_saved_ms
+}
+
 struct TServerStatus {
   1: bool read_only
   2: string version
@@ -236,6 +297,9 @@ struct TServerStatus {
   6: string host_name
   7: bool poly_rendering_enabled
   8: TRole role
+  9: list<TDispatchQueueStatus> dispatch_queue_status
+  10: list<TCodeCacheStatus> code_cache_status
+  11: list<TJoinHashTableCacheStatus> join_hash_table_cache_status
 }
 
 struct TPixel {
@@ -292,6 +356,13 @@ struct TMemoryData {
   7: bool is_free
 }
 
+struct TTableEvictionCounts {
+  1: i32 db_id
+  2: i32 table_id
+  3: i64 num_chunks
+  4: i64 num_bytes
+}
+
 struct TNodeMemoryInfo {
   1: string host_name
   2: i64 page_size
@@ -299,6 +370,9 @@ struct TNodeMemoryInfo {
   4: i64 num_pages_allocated
   5: bool is_allocation_capped
   6: list<TMemoryData> node_memory_data
+  7: string eviction_policy
+  8: list<TTableEvictionCounts> table_eviction_counts
+  9: i64 huge_page_bytes
 }
 
 struct TTableMeta {
@@ -547,13 +621,21 @@ service OmniSci {
   TSessionInfo get_session_info(1: TSessionId session) throws (1: TOmniSciException e)
   # query, render
   TQueryResult sql_execute(1: TSessionId session, 2: string query 3: bool column_format, 4: string nonce, 5: i32 first_n = -1, 6: i32 at_most_n = -1) throws (1: TOmniSciException e)
+  TQueryResult sql_execute_cursor(1: TSessionId session, 2: string query 3: bool column_format, 4: string nonce, 5: i32 first_n) throws (1: TOmniSciException e)
+  TQueryResult fetch_cursor(1: TSessionId session, 2: string cursor_id, 3: i32 n) throws (1: TOmniSciException e)
+  void close_cursor(1: TSessionId session, 2: string cursor_id) throws (1: TOmniSciException e)
+  TPreparedStatement prepare_statement(1: TSessionId session, 2: string query) throws (1: TOmniSciException e)
+  TQueryResult execute_prepared(1: TSessionId session, 2: string statement_id, 3: list<TQueryParam> params, 4: bool column_format, 5: string nonce, 6: i32 first_n = -1, 7: i32 at_most_n = -1) throws (1: TOmniSciException e)
+  void close_prepared(1: TSessionId session, 2: string statement_id) throws (1: TOmniSciException e)
   TDataFrame sql_execute_df(1: TSessionId session, 2: string query 3: common.TDeviceType device_type 4: i32 device_id = 0 5: i32 first_n = -1 6: TArrowTransport transport_method) throws (1: TOmniSciException e)
   TDataFrame sql_execute_gdf(1: TSessionId session, 2: string query 3: i32 device_id = 0, 4: i32 first_n = -1) throws (1: TOmniSciException e)
+  list<TDataFrame> sql_execute_gdf_partitioned(1: TSessionId session, 2: string query 3: list<i32> device_ids, 4: i32 first_n = -1) throws (1: TOmniSciException e)
   void deallocate_df(1: TSessionId session, 2: TDataFrame df, 3: common.TDeviceType device_type, 4: i32 device_id = 0) throws (1: TOmniSciException e)
   void interrupt(1: TSessionId query_session, 2: TSessionId interrupt_session) throws (1: TOmniSciException e)
   TRowDescriptor sql_validate(1: TSessionId session, 2: string query) throws (1: TOmniSciException e)
   list<completion_hints.TCompletionHint> get_completion_hints(1: TSessionId session, 2:string sql, 3:i32 cursor) throws (1: TOmniSciException e)
   void set_execution_mode(1: TSessionId session, 2: TExecuteMode mode) throws (1: TOmniSciException e)
+  void set_column_encoding(1: TSessionId session, 2: TColumnEncoding encoding) throws (1: TOmniSciException e)
   TRenderResult render_vega(1: TSessionId session, 2: i64 widget_id, 3: string vega_json, 4: i32 compression_level, 5: string nonce) throws (1: TOmniSciException e)
   TPixelTableRowResult get_result_row_for_pixel(1: TSessionId session, 2: i64 widget_id, 3: TPixel pixel, 4: map<string, list<string>> table_col_names, 5: bool column_format, 6: i32 pixelRadius, 7: string nonce) throws (1: TOmniSciException e)
   # dashboards